@@ -0,0 +1,18 @@
+#
+# SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+# Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+#
+
+# benchmark.m4 - Detect Google Benchmark package
+#
+
+##########################
+# Checking benchmark library
+#
+AC_DEFUN([CHECK_BENCHMARK_LIB],
+[
+# The library is optional, tests/benchmarks is built only when it is found
+PKG_CHECK_MODULES([BENCHMARK], [benchmark], [have_benchmark=yes], [have_benchmark=no])
+AM_CONDITIONAL([HAVE_BENCHMARK], [test "x$have_benchmark" = "xyes"])
+])
@@ -77,3 +77,34 @@ else
         [AC_MSG_ERROR([profiling support requested but not present])])
 fi
 ])
+
+##########################
+# USDT probes support
+#
+AC_DEFUN([PROF_USDT_SETUP],
+[
+AC_ARG_ENABLE([usdt],
+    AS_HELP_STRING([--disable-usdt],
+                   [Disable the USDT probes of the packet paths (default=auto)]),
+    [],
+    [enable_usdt=auto])
+
+prj_cv_usdt=0
+AS_IF([test "x$enable_usdt" != xno],
+    [AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+unsigned short xlio_check_semaphore __attribute__((section(".probes")));]],
+         [[if (xlio_check_semaphore) { STAP_PROBEV(xlio, check, 1); }]])],
+         [prj_cv_usdt=1])
+    ])
+
+AC_MSG_CHECKING([for USDT probes support])
+if test "$prj_cv_usdt" -ne 0; then
+    AC_DEFINE_UNQUOTED([DEFINED_USDT], [1], [Define USDT probes support])
+    AC_MSG_RESULT([yes])
+else
+    AS_IF([test "x$enable_usdt" = xyes],
+        [AC_MSG_ERROR([USDT probes requested but sys/sdt.h is not present])],
+        [AC_MSG_RESULT([no])])
+fi
+])
@@ -0,0 +1,1549 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/*
+ * XLIO Ultra API Benchmark
+ *
+ * Throughput and latency benchmark of the XLIO Ultra API. The same scenarios run over POSIX
+ * sockets, with or without libxlio preloaded, to compare the APIs on the same hardware.
+ *
+ * Build: gcc -O2 -o examples/xlio_ultra_api_bench examples/xlio_ultra_api_bench.c -libverbs
+ *        -lpthread
+ *
+ * Usage (help)  : ./examples/xlio_ultra_api_bench --help
+ * Usage (server): LD_PRELOAD=libxlio.so ./examples/xlio_ultra_api_bench -s -i 192.168.1.100 -g 4
+ * Usage (client): LD_PRELOAD=libxlio.so ./examples/xlio_ultra_api_bench -c -i 192.168.1.100 -g 4
+ *
+ * Code Structure
+ * ====================
+ *  - Benchmark protocol, common to both APIs
+ *  - XLIO Ultra API backend: a polling group per thread
+ *  - POSIX backend: an epoll instance per thread, busy polled
+ *  - Latency histogram and reports
+ *  - Utility functions
+ *
+ * Every thread runs a group of connections and is pinned to a CPU of --cpus. Group N of the
+ * client connects to port + N of the server, so both sides must run the same number of groups.
+ *
+ * Benchmark Protocol
+ * ====================
+ * A client connection starts with a bench_hello which tells the server how many messages
+ * of msg_size bytes it answers with a single message:
+ *  - pingpong: one message is answered with one message
+ *  - burst: a burst of --batch messages is answered with one message
+ *  - stream: no answer, the client sends batches of --batch messages within --window bytes
+ * The client measures the time from the first message of a round to the answer. The message
+ * contents are not inspected, the TX buffer is static and shared by all the sends.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <mellanox/xlio_extra.h>
+#include <infiniband/verbs.h>
+
+enum bench_api { API_ULTRA, API_POSIX };
+
+enum bench_mode { MODE_PINGPONG, MODE_STREAM, MODE_BURST };
+
+enum bench_phase { PHASE_WARMUP, PHASE_RUN, PHASE_STOP };
+
+/* Application configuration */
+struct bench_config {
+    bool is_server;
+    const char *ip; /* Server IP: bind address (server) or destination (client) */
+    const char *client_ip; /* Local IP to bind client sockets to */
+    unsigned short port; /* Port of the first group */
+    enum bench_api api;
+    enum bench_mode mode;
+    int groups; /* Threads, each with its own polling group or epoll instance */
+    int conns; /* Client connections per group */
+    size_t msg_size;
+    int batch; /* Messages per flush (stream) or per round (burst) */
+    size_t window; /* Stream bytes in flight per connection */
+    int duration; /* Measured seconds, the server runs until interrupted by default */
+    int warmup; /* Seconds before the measurement */
+    int cpus[CPU_SETSIZE];
+    int cpus_num;
+    bool json;
+};
+
+#define BENCH_HELLO_MAGIC 0x58424e43U /* XBNC */
+
+/* First bytes of a client connection */
+struct bench_hello {
+    uint32_t magic;
+    uint32_t reply_every; /* Messages answered with one message, 0 for no answer */
+    uint32_t msg_size;
+    uint32_t reserved;
+};
+
+/*
+ * Latency histogram
+ *
+ * Log-linear buckets as in HdrHistogram: the values below HIST_SUB_COUNT come with their own
+ * bucket, and every power of two above is split into HIST_HALF_COUNT buckets. The error of a
+ * recorded value is below 1 / HIST_HALF_COUNT.
+ */
+#define HIST_SUB_BITS   8
+#define HIST_SUB_COUNT  (1U << HIST_SUB_BITS)
+#define HIST_HALF_COUNT (HIST_SUB_COUNT / 2U)
+#define HIST_BUCKETS    (HIST_SUB_COUNT + (64U - HIST_SUB_BITS) * HIST_HALF_COUNT)
+
+struct bench_hist {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+struct bench_group;
+
+/* A connection, or the listening socket of a server group */
+struct bench_conn {
+    struct bench_group *group;
+    struct bench_conn *next;
+    xlio_socket_t sock; /* Ultra API */
+    int fd; /* POSIX, -1 once closed */
+    bool is_listen;
+    bool established;
+    bool destroyed;
+
+    /* Server: the hello received so far */
+    struct bench_hello hello;
+    size_t hello_len;
+
+    uint64_t rx_unit; /* Bytes of a round: answered by the server, awaited by the client */
+    uint64_t rx_acc; /* Bytes received towards the next rx_unit */
+    uint64_t tx_pending; /* POSIX: bytes not written yet */
+    uint64_t tx_inflight; /* Ultra API: zero copy bytes without a completion */
+    uint64_t round_start_ns;
+    bool epollout;
+};
+
+/* Counters of a group, written by its thread only */
+struct bench_counters {
+    uint64_t tx_bytes;
+    uint64_t rx_bytes;
+    uint64_t rounds;
+};
+
+struct bench_group {
+    int idx;
+    int cpu; /* -1 if not pinned */
+    pthread_t thread;
+    int rc;
+
+    struct bench_conn *conns;
+    int sockets_num; /* Ultra API sockets created, including the listening one */
+    int terminated_num;
+
+    /* Static TX buffer, registered for the first protection domain of the group */
+    char *tx_buf;
+    size_t tx_buf_size;
+    struct ibv_pd *pd;
+    struct ibv_mr *mr;
+    xlio_poll_group_t xgroup;
+
+    /* POSIX */
+    int epfd;
+    char *rx_buf;
+
+    bool measuring;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    struct bench_counters counters;
+    struct bench_counters base; /* Counters at the measurement start */
+    struct bench_hist hist;
+};
+
+/* Default configuration */
+static struct bench_config g_config = {
+    .is_server = false,
+    .ip = NULL,
+    .client_ip = NULL,
+    .port = 8080,
+    .api = API_ULTRA,
+    .mode = MODE_PINGPONG,
+    .groups = 1,
+    .conns = 1,
+    .msg_size = 64,
+    .batch = 1,
+    .window = 1U << 20U,
+    .duration = -1, /* 10 seconds for the client, until interrupted for the server */
+    .warmup = 2,
+    .cpus_num = 0,
+    .json = false,
+};
+
+static struct xlio_api_t *g_api;
+static struct bench_group *g_groups;
+static volatile int g_phase = PHASE_WARMUP;
+static volatile bool g_quit;
+static volatile bool g_failed;
+
+#define POSIX_RX_BUF_SIZE (64U * 1024U)
+#define POSIX_EVENTS_MAX  64
+#define NSEC_PER_SEC      1000000000ULL
+
+static const char *api_names[] = {"ultra", "posix"};
+static const char *mode_names[] = {"pingpong", "stream", "burst"};
+
+static uint64_t now_ns(void);
+static void counter_add(uint64_t *counter, uint64_t val);
+static uint64_t counter_get(const uint64_t *counter);
+static void hist_record(struct bench_hist *hist, uint64_t val);
+static int parse_command_line(int argc, char **argv);
+
+/* ========================================================================== *
+ *                             Benchmark Protocol                             *
+ * ========================================================================== */
+
+static uint32_t reply_every(void)
+{
+    switch (g_config.mode) {
+    case MODE_PINGPONG:
+        return 1U;
+    case MODE_BURST:
+        return (uint32_t)g_config.batch;
+    default:
+        return 0U;
+    }
+}
+
+static int ultra_send_msgs(struct bench_conn *conn, uint64_t num);
+static int posix_send_msgs(struct bench_conn *conn, uint64_t num);
+
+static int conn_send_msgs(struct bench_conn *conn, uint64_t num)
+{
+    return g_config.api == API_ULTRA ? ultra_send_msgs(conn, num) : posix_send_msgs(conn, num);
+}
+
+/* Starts the measurement of a group once the warmup is over */
+static void group_check_phase(struct bench_group *group)
+{
+    if (!group->measuring && g_phase == PHASE_RUN) {
+        group->measuring = true;
+        group->start_ns = now_ns();
+        group->base = group->counters;
+    }
+}
+
+static void client_start_round(struct bench_conn *conn)
+{
+    if (g_phase == PHASE_STOP) {
+        return;
+    }
+    conn->round_start_ns = now_ns();
+    conn_send_msgs(conn, reply_every());
+}
+
+/* The client connection is established and the hello is sent */
+static void client_established(struct bench_conn *conn)
+{
+    conn->established = true;
+    conn->rx_unit = g_config.msg_size;
+    if (g_config.mode != MODE_STREAM) {
+        client_start_round(conn);
+    }
+}
+
+static void client_rx(struct bench_conn *conn, size_t len)
+{
+    struct bench_group *group = conn->group;
+
+    counter_add(&group->counters.rx_bytes, len);
+    conn->rx_acc += len;
+    while (conn->rx_acc >= conn->rx_unit) {
+        conn->rx_acc -= conn->rx_unit;
+        counter_add(&group->counters.rounds, 1U);
+        if (group->measuring && g_phase == PHASE_RUN) {
+            hist_record(&group->hist, now_ns() - conn->round_start_ns);
+        }
+        client_start_round(conn);
+    }
+}
+
+static void server_rx(struct bench_conn *conn, const char *data, size_t len)
+{
+    struct bench_group *group = conn->group;
+    uint64_t replies = 0;
+
+    if (conn->hello_len < sizeof(conn->hello)) {
+        size_t part = sizeof(conn->hello) - conn->hello_len;
+
+        part = part < len ? part : len;
+        memcpy((char *)&conn->hello + conn->hello_len, data, part);
+        conn->hello_len += part;
+        len -= part;
+        if (conn->hello_len < sizeof(conn->hello)) {
+            return;
+        }
+        if (conn->hello.magic != BENCH_HELLO_MAGIC || !conn->hello.msg_size ||
+            conn->hello.msg_size > group->tx_buf_size) {
+            fprintf(stderr, "Group %d: unexpected hello, the peer isn't a benchmark client\n",
+                    group->idx);
+            conn->hello.reply_every = 0;
+        }
+        conn->rx_unit = (uint64_t)conn->hello.reply_every * conn->hello.msg_size;
+    }
+
+    counter_add(&group->counters.rx_bytes, len);
+    if (!conn->rx_unit) {
+        return;
+    }
+    conn->rx_acc += len;
+    while (conn->rx_acc >= conn->rx_unit) {
+        conn->rx_acc -= conn->rx_unit;
+        ++replies;
+    }
+    if (replies) {
+        counter_add(&group->counters.rounds, replies);
+        conn_send_msgs(conn, replies);
+    }
+}
+
+/* Message size of the answers, the server learns it from the hello of the connection */
+static size_t conn_msg_size(const struct bench_conn *conn)
+{
+    return g_config.is_server ? conn->hello.msg_size : g_config.msg_size;
+}
+
+static int group_init_tx_buf(struct bench_group *group)
+{
+    struct bench_hello hello = {
+        .magic = BENCH_HELLO_MAGIC,
+        .reply_every = reply_every(),
+        .msg_size = (uint32_t)g_config.msg_size,
+        .reserved = 0,
+    };
+    size_t size = g_config.msg_size;
+
+    if (g_config.api == API_POSIX) {
+        size *= (size_t)g_config.batch;
+    }
+    /* The server answers with the message size of its clients */
+    if (g_config.is_server && size < 1U << 20U) {
+        size = 1U << 20U;
+    }
+    size = size > sizeof(hello) ? size : sizeof(hello);
+
+    group->tx_buf = calloc(1, size);
+    if (!group->tx_buf) {
+        fprintf(stderr, "Failed to allocate %zu bytes TX buffer\n", size);
+        return -1;
+    }
+    group->tx_buf_size = size;
+    memcpy(group->tx_buf, &hello, sizeof(hello));
+    return 0;
+}
+
+static struct bench_conn *group_add_conn(struct bench_group *group)
+{
+    struct bench_conn *conn = calloc(1, sizeof(*conn));
+
+    if (conn) {
+        conn->group = group;
+        conn->fd = -1;
+        conn->next = group->conns;
+        group->conns = conn;
+    }
+    return conn;
+}
+
+static void group_free_conns(struct bench_group *group)
+{
+    while (group->conns) {
+        struct bench_conn *conn = group->conns;
+
+        group->conns = conn->next;
+        free(conn);
+    }
+}
+
+static void fill_addr(struct sockaddr_in *addr, const char *ip, unsigned short port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    if (!ip || inet_aton(ip, &addr->sin_addr) == 0) {
+        addr->sin_addr.s_addr = INADDR_ANY;
+    }
+}
+
+/* ========================================================================== *
+ *                           XLIO Ultra API Backend                           *
+ * ========================================================================== */
+
+static int ultra_register_tx_buf(struct bench_group *group, xlio_socket_t sock)
+{
+    struct ibv_pd *pd;
+
+    if (group->mr) {
+        return 0;
+    }
+    /* For simplicity, a single protection domain per group is supported */
+    pd = g_api->xlio_socket_get_pd(sock);
+    if (!pd) {
+        fprintf(stderr, "Group %d: failed to get protection domain from socket\n", group->idx);
+        return -1;
+    }
+    group->mr = ibv_reg_mr(pd, group->tx_buf, group->tx_buf_size, IBV_ACCESS_LOCAL_WRITE);
+    if (!group->mr) {
+        fprintf(stderr, "Group %d: failed to register TX buffer\n", group->idx);
+        return -1;
+    }
+    group->pd = pd;
+    return 0;
+}
+
+static int ultra_send(struct bench_conn *conn, size_t len, unsigned flags)
+{
+    struct bench_group *group = conn->group;
+    struct xlio_socket_send_attr attr = {
+        .flags = flags,
+        .mkey = group->mr->lkey,
+        .userdata_op = (uintptr_t)len, /* Returned by the completion for the window */
+    };
+    int rc;
+
+    rc = g_api->xlio_socket_send(conn->sock, group->tx_buf, len, &attr);
+    if (rc != 0) {
+        fprintf(stderr, "Group %d: failed to send: %s\n", group->idx, strerror(errno));
+        return rc;
+    }
+    conn->tx_inflight += len;
+    return 0;
+}
+
+/* Sends the messages from the static buffer and flushes them at once */
+static int ultra_send_msgs(struct bench_conn *conn, uint64_t num)
+{
+    size_t msg_size = conn_msg_size(conn);
+    uint64_t sent = 0;
+
+    if (conn->destroyed) {
+        return -1;
+    }
+    while (sent < num && ultra_send(conn, msg_size, 0) == 0) {
+        ++sent;
+    }
+    g_api->xlio_socket_flush(conn->sock);
+    counter_add(&conn->group->counters.tx_bytes, sent * msg_size);
+    return sent == num ? 0 : -1;
+}
+
+static void ultra_stream_fill(struct bench_group *group)
+{
+    uint64_t burst = (uint64_t)g_config.batch * g_config.msg_size;
+
+    for (struct bench_conn *conn = group->conns; conn; conn = conn->next) {
+        while (conn->established && !conn->destroyed &&
+               conn->tx_inflight + burst <= g_config.window) {
+            if (ultra_send_msgs(conn, (uint64_t)g_config.batch) != 0) {
+                break;
+            }
+        }
+    }
+}
+
+static void ultra_destroy(struct bench_conn *conn)
+{
+    if (!conn->destroyed) {
+        conn->destroyed = true;
+        conn->established = false;
+        if (g_api->xlio_socket_destroy(conn->sock) != 0) {
+            fprintf(stderr, "Group %d: failed to destroy socket\n", conn->group->idx);
+            /* No termination event is coming */
+            ++conn->group->terminated_num;
+        }
+    }
+}
+
+static void ultra_event_cb(xlio_socket_t sock, uintptr_t userdata_sq, int event, int value)
+{
+    struct bench_conn *conn = (struct bench_conn *)userdata_sq;
+    struct bench_group *group = conn->group;
+
+    switch (event) {
+    case XLIO_SOCKET_EVENT_ESTABLISHED:
+        /* The accepted connections come through ultra_accept_cb() */
+        if (g_config.is_server) {
+            break;
+        }
+        if (ultra_register_tx_buf(group, sock) != 0 ||
+            ultra_send(conn, sizeof(struct bench_hello), 0) != 0) {
+            g_failed = true;
+            g_quit = true;
+            break;
+        }
+        client_established(conn);
+        break;
+
+    case XLIO_SOCKET_EVENT_TERMINATED:
+        ++group->terminated_num;
+        break;
+
+    case XLIO_SOCKET_EVENT_CLOSED:
+        if (!g_config.is_server && g_phase != PHASE_STOP) {
+            fprintf(stderr, "Group %d: connection closed by the server\n", group->idx);
+            g_failed = true;
+        }
+        ultra_destroy(conn);
+        break;
+
+    case XLIO_SOCKET_EVENT_ERROR:
+        fprintf(stderr, "Group %d: socket error: %s\n", group->idx, strerror(value));
+        if (!g_config.is_server) {
+            g_failed = true;
+            g_quit = true;
+        }
+        ultra_destroy(conn);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void ultra_comp_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op)
+{
+    struct bench_conn *conn = (struct bench_conn *)userdata_sq;
+
+    (void)sock;
+    conn->tx_inflight -= (uint64_t)userdata_op;
+}
+
+static void ultra_rx_cb(xlio_socket_t sock, uintptr_t userdata_sq, void *data, size_t len,
+                        struct xlio_buf *buf)
+{
+    struct bench_conn *conn = (struct bench_conn *)userdata_sq;
+
+    if (g_config.is_server) {
+        server_rx(conn, data, len);
+    } else {
+        client_rx(conn, len);
+    }
+    g_api->xlio_socket_buf_free(sock, buf);
+}
+
+static void ultra_accept_cb(xlio_socket_t sock, xlio_socket_t parent, uintptr_t parent_userdata_sq)
+{
+    struct bench_group *group = ((struct bench_conn *)parent_userdata_sq)->group;
+    struct bench_conn *conn = group_add_conn(group);
+
+    (void)parent;
+    ++group->sockets_num;
+    if (!conn || g_api->xlio_socket_update(sock, 0, (uintptr_t)conn) != 0 ||
+        ultra_register_tx_buf(group, sock) != 0) {
+        fprintf(stderr, "Group %d: failed to set up an accepted connection\n", group->idx);
+        if (g_api->xlio_socket_destroy(sock) != 0) {
+            fprintf(stderr, "Group %d: failed to destroy socket\n", group->idx);
+            ++group->terminated_num;
+        }
+        if (conn) {
+            conn->destroyed = true;
+        }
+        return;
+    }
+    conn->sock = sock;
+    conn->established = true;
+}
+
+static int ultra_create_socket(struct bench_group *group, struct bench_conn *conn)
+{
+    struct xlio_socket_attr attr = {
+        .flags = 0,
+        .domain = AF_INET,
+        .group = group->xgroup,
+        .userdata_sq = (uintptr_t)conn,
+    };
+
+    if (g_api->xlio_socket_create(&attr, &conn->sock) != 0) {
+        fprintf(stderr, "Group %d: failed to create socket: %s\n", group->idx, strerror(errno));
+        conn->destroyed = true;
+        return -1;
+    }
+    ++group->sockets_num;
+    return 0;
+}
+
+static int ultra_group_setup(struct bench_group *group)
+{
+    struct xlio_poll_group_attr group_attr = {
+        .flags = 0,
+        .socket_event_cb = ultra_event_cb,
+        .socket_comp_cb = ultra_comp_cb,
+        .socket_rx_cb = ultra_rx_cb,
+        .socket_accept_cb = ultra_accept_cb,
+    };
+    unsigned short port = (unsigned short)(g_config.port + group->idx);
+    struct sockaddr_in addr;
+    struct bench_conn *conn;
+
+    if (g_api->xlio_poll_group_create(&group_attr, &group->xgroup) != 0) {
+        fprintf(stderr, "Group %d: failed to create polling group: %s\n", group->idx,
+                strerror(errno));
+        return -1;
+    }
+
+    if (g_config.is_server) {
+        conn = group_add_conn(group);
+        if (!conn || ultra_create_socket(group, conn) != 0) {
+            return -1;
+        }
+        conn->is_listen = true;
+        fill_addr(&addr, g_config.ip, port);
+        if (g_api->xlio_socket_bind(conn->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            g_api->xlio_socket_listen(conn->sock) != 0) {
+            fprintf(stderr, "Group %d: failed to listen on port %u: %s\n", group->idx, port,
+                    strerror(errno));
+            return -1;
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < g_config.conns; ++i) {
+        conn = group_add_conn(group);
+        if (!conn || ultra_create_socket(group, conn) != 0) {
+            return -1;
+        }
+        if (g_config.client_ip) {
+            fill_addr(&addr, g_config.client_ip, 0);
+            if (g_api->xlio_socket_bind(conn->sock, (struct sockaddr *)&addr, sizeof(addr)) !=
+                0) {
+                fprintf(stderr, "Group %d: failed to bind to %s: %s\n", group->idx,
+                        g_config.client_ip, strerror(errno));
+                return -1;
+            }
+        }
+        fill_addr(&addr, g_config.ip, port);
+        if (g_api->xlio_socket_connect(conn->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            fprintf(stderr, "Group %d: failed to connect to %s:%u: %s\n", group->idx,
+                    g_config.ip, port, strerror(errno));
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void ultra_group_cleanup(struct bench_group *group)
+{
+    if (!group->xgroup) {
+        return;
+    }
+    for (struct bench_conn *conn = group->conns; conn; conn = conn->next) {
+        ultra_destroy(conn);
+    }
+    while (group->terminated_num < group->sockets_num) {
+        g_api->xlio_poll_group_poll(group->xgroup);
+    }
+    if (g_api->xlio_poll_group_destroy(group->xgroup) != 0) {
+        fprintf(stderr, "Group %d: failed to destroy polling group\n", group->idx);
+    }
+    group->xgroup = 0;
+}
+
+static int ultra_group_run(struct bench_group *group)
+{
+    int rc = ultra_group_setup(group);
+
+    while (rc == 0 && g_phase != PHASE_STOP) {
+        g_api->xlio_poll_group_poll(group->xgroup);
+        if (g_config.mode == MODE_STREAM && !g_config.is_server) {
+            ultra_stream_fill(group);
+        }
+        group_check_phase(group);
+    }
+    group->end_ns = now_ns();
+    ultra_group_cleanup(group);
+    return rc;
+}
+
+/* ========================================================================== *
+ *                               POSIX Backend                                *
+ * ========================================================================== */
+
+static void posix_close(struct bench_conn *conn)
+{
+    if (conn->fd >= 0) {
+        epoll_ctl(conn->group->epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+        close(conn->fd);
+        conn->fd = -1;
+        conn->established = false;
+    }
+}
+
+static void posix_set_epollout(struct bench_conn *conn, bool enable)
+{
+    struct epoll_event ev = {.events = EPOLLIN | (enable ? EPOLLOUT : 0U), .data.ptr = conn};
+
+    if (conn->epollout != enable) {
+        conn->epollout = enable;
+        epoll_ctl(conn->group->epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+    }
+}
+
+/* Writes the pending bytes until the socket is full */
+static void posix_flush(struct bench_conn *conn)
+{
+    struct bench_group *group = conn->group;
+
+    while (conn->tx_pending) {
+        size_t len = conn->tx_pending < group->tx_buf_size ? conn->tx_pending : group->tx_buf_size;
+        ssize_t rc = send(conn->fd, group->tx_buf, len, MSG_NOSIGNAL);
+
+        if (rc < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                posix_set_epollout(conn, true);
+            } else if (errno != EINTR) {
+                fprintf(stderr, "Group %d: failed to send: %s\n", group->idx, strerror(errno));
+                posix_close(conn);
+            }
+            return;
+        }
+        conn->tx_pending -= (uint64_t)rc;
+        counter_add(&group->counters.tx_bytes, (uint64_t)rc);
+    }
+    if (g_config.mode != MODE_STREAM || g_config.is_server) {
+        posix_set_epollout(conn, false);
+    }
+}
+
+/* The batch of messages is written with a single send() when the socket has room */
+static int posix_send_msgs(struct bench_conn *conn, uint64_t num)
+{
+    if (conn->fd < 0) {
+        return -1;
+    }
+    conn->tx_pending += num * conn_msg_size(conn);
+    posix_flush(conn);
+    return conn->fd >= 0 ? 0 : -1;
+}
+
+static int posix_add(struct bench_conn *conn, int fd, uint32_t events)
+{
+    struct epoll_event ev = {.events = events, .data.ptr = conn};
+    int one = 1;
+
+    conn->fd = fd;
+    conn->epollout = (events & EPOLLOUT) != 0;
+    if (!conn->is_listen) {
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0 ||
+        epoll_ctl(conn->group->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        fprintf(stderr, "Group %d: failed to add socket: %s\n", conn->group->idx,
+                strerror(errno));
+        posix_close(conn);
+        return -1;
+    }
+    return 0;
+}
+
+static int posix_connect(struct bench_group *group, struct bench_conn *conn)
+{
+    unsigned short port = (unsigned short)(g_config.port + group->idx);
+    struct sockaddr_in addr;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        fprintf(stderr, "Group %d: failed to create socket: %s\n", group->idx, strerror(errno));
+        return -1;
+    }
+    if (g_config.client_ip) {
+        fill_addr(&addr, g_config.client_ip, 0);
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            fprintf(stderr, "Group %d: failed to bind to %s: %s\n", group->idx,
+                    g_config.client_ip, strerror(errno));
+            close(fd);
+            return -1;
+        }
+    }
+    fill_addr(&addr, g_config.ip, port);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        send(fd, group->tx_buf, sizeof(struct bench_hello), MSG_NOSIGNAL) !=
+            (ssize_t)sizeof(struct bench_hello)) {
+        fprintf(stderr, "Group %d: failed to connect to %s:%u: %s\n", group->idx, g_config.ip,
+                port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    if (posix_add(conn, fd, EPOLLIN | (g_config.mode == MODE_STREAM ? EPOLLOUT : 0U)) != 0) {
+        return -1;
+    }
+    client_established(conn);
+    return 0;
+}
+
+static int posix_group_setup(struct bench_group *group)
+{
+    unsigned short port = (unsigned short)(g_config.port + group->idx);
+    struct sockaddr_in addr;
+    struct bench_conn *conn;
+    int one = 1;
+    int fd;
+
+    group->epfd = epoll_create1(0);
+    group->rx_buf = malloc(POSIX_RX_BUF_SIZE);
+    if (group->epfd < 0 || !group->rx_buf) {
+        fprintf(stderr, "Group %d: failed to create epoll instance\n", group->idx);
+        return -1;
+    }
+
+    if (!g_config.is_server) {
+        for (int i = 0; i < g_config.conns; ++i) {
+            conn = group_add_conn(group);
+            if (!conn || posix_connect(group, conn) != 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    conn = group_add_conn(group);
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (!conn || fd < 0) {
+        fprintf(stderr, "Group %d: failed to create socket: %s\n", group->idx, strerror(errno));
+        return -1;
+    }
+    conn->is_listen = true;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    fill_addr(&addr, g_config.ip, port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 1024) != 0) {
+        fprintf(stderr, "Group %d: failed to listen on port %u: %s\n", group->idx, port,
+                strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return posix_add(conn, fd, EPOLLIN);
+}
+
+static void posix_accept(struct bench_conn *listen_conn)
+{
+    struct bench_group *group = listen_conn->group;
+    struct bench_conn *conn;
+    int fd;
+
+    while ((fd = accept(listen_conn->fd, NULL, NULL)) >= 0) {
+        conn = group_add_conn(group);
+        if (!conn) {
+            close(fd);
+            continue;
+        }
+        if (posix_add(conn, fd, EPOLLIN) == 0) {
+            conn->established = true;
+        }
+    }
+}
+
+static void posix_recv(struct bench_conn *conn)
+{
+    struct bench_group *group = conn->group;
+    ssize_t rc = recv(conn->fd, group->rx_buf, POSIX_RX_BUF_SIZE, 0);
+
+    if (rc > 0) {
+        if (g_config.is_server) {
+            server_rx(conn, group->rx_buf, (size_t)rc);
+        } else {
+            client_rx(conn, (size_t)rc);
+        }
+    } else if (rc == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        if (!g_config.is_server && g_phase != PHASE_STOP) {
+            fprintf(stderr, "Group %d: connection closed by the server\n", group->idx);
+            g_failed = true;
+        }
+        posix_close(conn);
+    }
+}
+
+static int posix_group_run(struct bench_group *group)
+{
+    struct epoll_event events[POSIX_EVENTS_MAX];
+    uint64_t burst = (uint64_t)g_config.batch * g_config.msg_size;
+    int rc = posix_group_setup(group);
+
+    while (rc == 0 && g_phase != PHASE_STOP) {
+        /* Busy polling, as the Ultra API groups do */
+        int num = epoll_wait(group->epfd, events, POSIX_EVENTS_MAX, 0);
+
+        for (int i = 0; i < num; ++i) {
+            struct bench_conn *conn = events[i].data.ptr;
+
+            if (conn->is_listen) {
+                posix_accept(conn);
+                continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && conn->fd >= 0) {
+                posix_recv(conn);
+            }
+            if ((events[i].events & EPOLLOUT) && conn->fd >= 0) {
+                if (!conn->tx_pending && g_config.mode == MODE_STREAM && !g_config.is_server) {
+                    conn->tx_pending = burst;
+                }
+                posix_flush(conn);
+            }
+        }
+        group_check_phase(group);
+    }
+    group->end_ns = now_ns();
+
+    for (struct bench_conn *conn = group->conns; conn; conn = conn->next) {
+        posix_close(conn);
+    }
+    if (group->epfd >= 0) {
+        close(group->epfd);
+    }
+    free(group->rx_buf);
+    return rc;
+}
+
+/* ========================================================================== *
+ *                            Threads and Reports                             *
+ * ========================================================================== */
+
+static void *group_thread(void *arg)
+{
+    struct bench_group *group = arg;
+
+    if (group->cpu >= 0) {
+        cpu_set_t cpuset;
+
+        CPU_ZERO(&cpuset);
+        CPU_SET(group->cpu, &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+            fprintf(stderr, "Group %d: failed to pin the thread to CPU %d\n", group->idx,
+                    group->cpu);
+        }
+    }
+
+    if (group_init_tx_buf(group) == 0) {
+        group->rc = g_config.api == API_ULTRA ? ultra_group_run(group) : posix_group_run(group);
+    } else {
+        group->rc = -1;
+    }
+    if (group->rc != 0) {
+        g_failed = true;
+        g_quit = true;
+    }
+
+    if (group->mr) {
+        ibv_dereg_mr(group->mr);
+    }
+    free(group->tx_buf);
+    group_free_conns(group);
+    return NULL;
+}
+
+static unsigned hist_index(uint64_t val)
+{
+    unsigned shift;
+
+    if (val < HIST_SUB_COUNT) {
+        return (unsigned)val;
+    }
+    shift = (unsigned)(63 - __builtin_clzll(val)) - (HIST_SUB_BITS - 1U);
+    return HIST_SUB_COUNT + (shift - 1U) * HIST_HALF_COUNT +
+        (unsigned)((val >> shift) - HIST_HALF_COUNT);
+}
+
+/* Highest value of the bucket */
+static uint64_t hist_value(unsigned idx)
+{
+    unsigned shift;
+    uint64_t sub;
+
+    if (idx < HIST_SUB_COUNT) {
+        return idx;
+    }
+    shift = (idx - HIST_SUB_COUNT) / HIST_HALF_COUNT + 1U;
+    sub = (idx - HIST_SUB_COUNT) % HIST_HALF_COUNT + HIST_HALF_COUNT;
+    return (sub << shift) + ((1ULL << shift) - 1U);
+}
+
+static void hist_record(struct bench_hist *hist, uint64_t val)
+{
+    ++hist->counts[hist_index(val)];
+    if (!hist->total++ || val < hist->min) {
+        hist->min = val;
+    }
+    hist->max = val > hist->max ? val : hist->max;
+    hist->sum += val;
+}
+
+static void hist_merge(struct bench_hist *to, const struct bench_hist *from)
+{
+    if (!from->total) {
+        return;
+    }
+    for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+        to->counts[i] += from->counts[i];
+    }
+    to->min = (!to->total || from->min < to->min) ? from->min : to->min;
+    to->max = from->max > to->max ? from->max : to->max;
+    to->total += from->total;
+    to->sum += from->sum;
+}
+
+static uint64_t hist_percentile(const struct bench_hist *hist, double percentile)
+{
+    double rank = percentile / 100.0 * (double)hist->total;
+    uint64_t target = (uint64_t)rank;
+    uint64_t seen = 0;
+
+    /* The smallest value with at least the percentile of the rounds at or below it */
+    if ((double)target < rank || !target) {
+        ++target;
+    }
+    for (unsigned i = 0; i < HIST_BUCKETS; ++i) {
+        seen += hist->counts[i];
+        if (seen >= target) {
+            uint64_t val = hist_value(i);
+            return val < hist->max ? val : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+static const double g_percentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+#define PERCENTILES_NUM (sizeof(g_percentiles) / sizeof(g_percentiles[0]))
+
+struct bench_rates {
+    double seconds;
+    double tx_msgs;
+    double tx_gbps;
+    double rx_msgs;
+    double rx_gbps;
+    double rounds;
+};
+
+static struct bench_rates group_rates(const struct bench_group *group)
+{
+    struct bench_rates rates = {0};
+    double msg_size = (double)g_config.msg_size;
+
+    if (!group->measuring || group->end_ns <= group->start_ns) {
+        return rates;
+    }
+    rates.seconds = (double)(group->end_ns - group->start_ns) / NSEC_PER_SEC;
+    rates.tx_msgs = (double)(group->counters.tx_bytes - group->base.tx_bytes) / msg_size;
+    rates.rx_msgs = (double)(group->counters.rx_bytes - group->base.rx_bytes) / msg_size;
+    rates.tx_gbps = rates.tx_msgs * msg_size * 8.0 / 1e9 / rates.seconds;
+    rates.rx_gbps = rates.rx_msgs * msg_size * 8.0 / 1e9 / rates.seconds;
+    rates.tx_msgs /= rates.seconds;
+    rates.rx_msgs /= rates.seconds;
+    rates.rounds = (double)(group->counters.rounds - group->base.rounds) / rates.seconds;
+    return rates;
+}
+
+static void print_text_summary(const struct bench_hist *hist)
+{
+    struct bench_rates total = {0};
+
+    printf("\n%-6s %-4s %12s %10s %12s %10s %12s\n", "group", "cpu", "tx msg/s", "tx Gbit/s",
+           "rx msg/s", "rx Gbit/s", "rounds/s");
+    for (int i = 0; i < g_config.groups; ++i) {
+        struct bench_rates rates = group_rates(&g_groups[i]);
+
+        printf("%-6d %-4d %12.0f %10.3f %12.0f %10.3f %12.0f\n", i, g_groups[i].cpu,
+               rates.tx_msgs, rates.tx_gbps, rates.rx_msgs, rates.rx_gbps, rates.rounds);
+        total.tx_msgs += rates.tx_msgs;
+        total.tx_gbps += rates.tx_gbps;
+        total.rx_msgs += rates.rx_msgs;
+        total.rx_gbps += rates.rx_gbps;
+        total.rounds += rates.rounds;
+    }
+    printf("%-11s %12.0f %10.3f %12.0f %10.3f %12.0f\n", "total", total.tx_msgs, total.tx_gbps,
+           total.rx_msgs, total.rx_gbps, total.rounds);
+
+    if (!hist->total) {
+        return;
+    }
+    printf("\nLatency (usec) of %llu rounds: min %.3f avg %.3f", (unsigned long long)hist->total,
+           hist->min / 1e3, (double)hist->sum / hist->total / 1e3);
+    for (size_t i = 0; i < PERCENTILES_NUM; ++i) {
+        printf(" p%g %.3f", g_percentiles[i], hist_percentile(hist, g_percentiles[i]) / 1e3);
+    }
+    printf(" max %.3f\n", hist->max / 1e3);
+}
+
+static void print_json_summary(const struct bench_hist *hist)
+{
+    printf("{\"api\": \"%s\", \"mode\": \"%s\", \"role\": \"%s\", \"groups\": %d, "
+           "\"connections\": %d, \"msg_size\": %zu, \"batch\": %d,\n",
+           api_names[g_config.api], mode_names[g_config.mode],
+           g_config.is_server ? "server" : "client", g_config.groups, g_config.conns,
+           g_config.msg_size, g_config.batch);
+    printf(" \"groups_stats\": [");
+    for (int i = 0; i < g_config.groups; ++i) {
+        struct bench_rates rates = group_rates(&g_groups[i]);
+
+        printf("%s\n  {\"group\": %d, \"cpu\": %d, \"seconds\": %.3f, \"tx_msgs_per_sec\": %.0f, "
+               "\"tx_gbps\": %.3f, \"rx_msgs_per_sec\": %.0f, \"rx_gbps\": %.3f, "
+               "\"rounds_per_sec\": %.0f}",
+               i ? "," : "", i, g_groups[i].cpu, rates.seconds, rates.tx_msgs, rates.tx_gbps,
+               rates.rx_msgs, rates.rx_gbps, rates.rounds);
+    }
+    printf("],\n \"latency_usec\": {\"rounds\": %llu", (unsigned long long)hist->total);
+    if (hist->total) {
+        printf(", \"min\": %.3f, \"avg\": %.3f", hist->min / 1e3,
+               (double)hist->sum / hist->total / 1e3);
+        for (size_t i = 0; i < PERCENTILES_NUM; ++i) {
+            printf(", \"p%g\": %.3f", g_percentiles[i],
+                   hist_percentile(hist, g_percentiles[i]) / 1e3);
+        }
+        printf(", \"max\": %.3f", hist->max / 1e3);
+    }
+    printf("}}\n");
+}
+
+static void print_summary(void)
+{
+    struct bench_hist *hist = calloc(1, sizeof(*hist));
+
+    if (!hist) {
+        fprintf(stderr, "Failed to allocate the latency histogram\n");
+        return;
+    }
+    for (int i = 0; i < g_config.groups; ++i) {
+        hist_merge(hist, &g_groups[i].hist);
+    }
+    if (g_config.json) {
+        print_json_summary(hist);
+    } else {
+        print_text_summary(hist);
+    }
+    free(hist);
+}
+
+/* Prints the rates of the last second, the counters are read while the groups update them */
+static void print_interval(int second, struct bench_counters *prev)
+{
+    struct bench_counters curr = {0};
+    double msg_size = (double)g_config.msg_size;
+
+    for (int i = 0; i < g_config.groups; ++i) {
+        curr.tx_bytes += counter_get(&g_groups[i].counters.tx_bytes);
+        curr.rx_bytes += counter_get(&g_groups[i].counters.rx_bytes);
+        curr.rounds += counter_get(&g_groups[i].counters.rounds);
+    }
+    /* The JSON output stays parsable */
+    if (!g_config.json) {
+        printf("%4ds %-7s tx %12.0f msg/s %8.3f Gbit/s  rx %12.0f msg/s %8.3f Gbit/s  "
+               "%10llu rounds/s\n",
+               second, g_phase == PHASE_WARMUP ? "warmup" : "",
+               (curr.tx_bytes - prev->tx_bytes) / msg_size,
+               (curr.tx_bytes - prev->tx_bytes) * 8.0 / 1e9,
+               (curr.rx_bytes - prev->rx_bytes) / msg_size,
+               (curr.rx_bytes - prev->rx_bytes) * 8.0 / 1e9,
+               (unsigned long long)(curr.rounds - prev->rounds));
+        fflush(stdout);
+    }
+    *prev = curr;
+}
+
+static void run_reporter(void)
+{
+    struct bench_counters prev = {0};
+    int duration = g_config.duration;
+    int second = 0;
+
+    if (duration < 0) {
+        duration = g_config.is_server ? 0 : 10;
+    }
+    if (!g_config.warmup) {
+        g_phase = PHASE_RUN;
+    }
+    while (!g_quit) {
+        sleep(1);
+        print_interval(++second, &prev);
+        if (g_phase == PHASE_WARMUP && second >= g_config.warmup) {
+            g_phase = PHASE_RUN;
+        } else if (duration && second >= g_config.warmup + duration) {
+            break;
+        }
+    }
+    g_phase = PHASE_STOP;
+}
+
+static void signal_handler(int sig)
+{
+    (void)sig;
+    g_quit = true;
+}
+
+int main(int argc, char **argv)
+{
+    struct sigaction sa;
+    int started = 0;
+
+    if (parse_command_line(argc, argv) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (g_config.api == API_ULTRA) {
+        struct xlio_init_attr init_attr = {
+            .flags = 0, .memory_cb = NULL, .memory_alloc = NULL, .memory_free = NULL};
+
+        g_api = xlio_get_api();
+        if (!g_api || !(g_api->cap_mask & XLIO_EXTRA_API_XLIO_ULTRA)) {
+            fprintf(stderr, "XLIO Ultra API not available. Ensure libxlio is preloaded.\n");
+            return EXIT_FAILURE;
+        }
+        if (g_api->xlio_init_ex(&init_attr) != 0) {
+            fprintf(stderr, "Failed to initialize XLIO: %s\n", strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    g_groups = calloc((size_t)g_config.groups, sizeof(*g_groups));
+    if (!g_groups) {
+        fprintf(stderr, "Failed to allocate %d groups\n", g_config.groups);
+        return EXIT_FAILURE;
+    }
+
+    if (!g_config.json) {
+        printf("%s %s over %s API: %d groups, %d connections per group, %zu bytes messages, "
+               "batch %d\n",
+               g_config.is_server ? "Server" : "Client", mode_names[g_config.mode],
+               api_names[g_config.api], g_config.groups, g_config.conns, g_config.msg_size,
+               g_config.batch);
+    }
+    for (int i = 0; i < g_config.groups; ++i) {
+        g_groups[i].idx = i;
+        g_groups[i].epfd = -1;
+        g_groups[i].cpu = g_config.cpus_num ? g_config.cpus[i % g_config.cpus_num] : -1;
+        if (pthread_create(&g_groups[i].thread, NULL, group_thread, &g_groups[i]) != 0) {
+            fprintf(stderr, "Failed to create the thread of group %d\n", i);
+            g_failed = true;
+            break;
+        }
+        ++started;
+    }
+
+    if (!g_failed) {
+        run_reporter();
+    }
+    g_phase = PHASE_STOP;
+    for (int i = 0; i < started; ++i) {
+        pthread_join(g_groups[i].thread, NULL);
+    }
+    print_summary();
+
+    if (g_config.api == API_ULTRA && g_api->xlio_exit() != 0) {
+        fprintf(stderr, "Failed to finalize XLIO\n");
+    }
+    free(g_groups);
+    return g_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ========================================================================== *
+ *                             Utility Functions                              *
+ * ========================================================================== */
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/* The counters have a single writer, the reporter reads them concurrently */
+static void counter_add(uint64_t *counter, uint64_t val)
+{
+    __atomic_store_n(counter, *counter + val, __ATOMIC_RELAXED);
+}
+
+static uint64_t counter_get(const uint64_t *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+/* Parses a CPU list such as "0,2,4-7" */
+static int parse_cpus(const char *str)
+{
+    char *end;
+
+    g_config.cpus_num = 0;
+    while (*str) {
+        long first = strtol(str, &end, 10);
+        long last = first;
+
+        if (end == str) {
+            return -1;
+        }
+        if (*end == '-') {
+            str = end + 1;
+            last = strtol(str, &end, 10);
+            if (end == str) {
+                return -1;
+            }
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE ||
+            g_config.cpus_num + (last - first + 1) > CPU_SETSIZE) {
+            return -1;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            g_config.cpus[g_config.cpus_num++] = (int)cpu;
+        }
+        if (*end == ',') {
+            ++end;
+        } else if (*end) {
+            return -1;
+        }
+        str = end;
+    }
+    return g_config.cpus_num ? 0 : -1;
+}
+
+static void print_usage(const char *program_name)
+{
+    printf("Usage: %s [OPTIONS]\n", program_name);
+    printf("\nMode Selection (required):\n");
+    printf("  -s, --server              Run in server mode\n");
+    printf("  -c, --client              Run in client mode\n");
+    printf("\nConnection Options:\n");
+    printf("  -i, --ip <IP>             Server IP address (required for client mode)\n");
+    printf("  -p, --port <PORT>         Port of the first group, group N uses PORT+N "
+           "(default: 8080)\n");
+    printf("  -I, --client-ip <IP>      Local IP address to bind client sockets to\n");
+    printf("  -a, --api <API>           ultra or posix (default: ultra)\n");
+    printf("  -g, --groups <NUM>        Threads, each with its own polling group (default: 1)\n");
+    printf("  -C, --cpus <LIST>         CPUs to pin the groups to, e.g. 0,2,4-7\n");
+    printf("\nClient Options:\n");
+    printf("  -m, --mode <MODE>         pingpong, stream or burst (default: pingpong)\n");
+    printf("  -n, --connections <NUM>   Connections per group (default: 1)\n");
+    printf("  -l, --msg-size <BYTES>    Message size, the server reports the messages of this\n"
+           "                            size too (default: 64)\n");
+    printf("  -b, --batch <NUM>         Messages per flush in stream mode and per round in burst\n"
+           "                            mode (default: 1)\n");
+    printf("  -W, --window <BYTES>      Stream bytes in flight per connection (default: 1M)\n");
+    printf("  -d, --duration <SECONDS>  Measurement time, 0 = until interrupted (default: 10 for\n"
+           "                            the client, 0 for the server)\n");
+    printf("  -w, --warmup <SECONDS>    Time before the measurement (default: 2)\n");
+    printf("\nGeneral Options:\n");
+    printf("  -j, --json                Print the summary in the JSON format\n");
+    printf("  -h, --help                Show this help message\n");
+    printf("\nExamples:\n");
+    printf("  Server:     LD_PRELOAD=install/lib/libxlio.so %s -s -i 192.168.1.100 -g 2 -C 2,4\n",
+           program_name);
+    printf("  Client:     LD_PRELOAD=install/lib/libxlio.so %s -c -i 192.168.1.100 -g 2 -C 2,4 "
+           "-n 8\n",
+           program_name);
+    printf("  POSIX:      LD_PRELOAD=install/lib/libxlio.so %s -c -i 192.168.1.100 -a posix\n",
+           program_name);
+}
+
+static int parse_positive(const char *str, long max, long *val)
+{
+    char *end;
+
+    errno = 0;
+    *val = strtol(str, &end, 10);
+    if (errno || end == str || *end || *val < 0 || *val > max) {
+        return -1;
+    }
+    return 0;
+}
+
+static int parse_command_line(int argc, char **argv)
+{
+    static struct option long_options[] = {{"server", no_argument, NULL, 's'},
+                                           {"client", no_argument, NULL, 'c'},
+                                           {"ip", required_argument, NULL, 'i'},
+                                           {"port", required_argument, NULL, 'p'},
+                                           {"client-ip", required_argument, NULL, 'I'},
+                                           {"api", required_argument, NULL, 'a'},
+                                           {"mode", required_argument, NULL, 'm'},
+                                           {"groups", required_argument, NULL, 'g'},
+                                           {"connections", required_argument, NULL, 'n'},
+                                           {"msg-size", required_argument, NULL, 'l'},
+                                           {"batch", required_argument, NULL, 'b'},
+                                           {"window", required_argument, NULL, 'W'},
+                                           {"duration", required_argument, NULL, 'd'},
+                                           {"warmup", required_argument, NULL, 'w'},
+                                           {"cpus", required_argument, NULL, 'C'},
+                                           {"json", no_argument, NULL, 'j'},
+                                           {"help", no_argument, NULL, 'h'},
+                                           {NULL, 0, NULL, 0}};
+    bool mode_specified = false;
+    struct in_addr addr;
+    int option;
+    long val;
+
+    while ((option = getopt_long(argc, argv, "sci:p:I:a:m:g:n:l:b:W:d:w:C:jh", long_options,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 's':
+        case 'c':
+            if (mode_specified) {
+                fprintf(stderr, "Error: Cannot specify both server and client modes\n");
+                return -1;
+            }
+            g_config.is_server = option == 's';
+            mode_specified = true;
+            break;
+        case 'i':
+            g_config.ip = optarg;
+            break;
+        case 'p':
+            if (parse_positive(optarg, 65535, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid port number: %s\n", optarg);
+                return -1;
+            }
+            g_config.port = (unsigned short)val;
+            break;
+        case 'I':
+            g_config.client_ip = optarg;
+            break;
+        case 'a':
+            if (strcmp(optarg, "ultra") == 0) {
+                g_config.api = API_ULTRA;
+            } else if (strcmp(optarg, "posix") == 0) {
+                g_config.api = API_POSIX;
+            } else {
+                fprintf(stderr, "Error: Invalid API: %s\n", optarg);
+                return -1;
+            }
+            break;
+        case 'm':
+            if (strcmp(optarg, "pingpong") == 0) {
+                g_config.mode = MODE_PINGPONG;
+            } else if (strcmp(optarg, "stream") == 0) {
+                g_config.mode = MODE_STREAM;
+            } else if (strcmp(optarg, "burst") == 0) {
+                g_config.mode = MODE_BURST;
+            } else {
+                fprintf(stderr, "Error: Invalid mode: %s\n", optarg);
+                return -1;
+            }
+            break;
+        case 'g':
+            if (parse_positive(optarg, 4096, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid number of groups: %s\n", optarg);
+                return -1;
+            }
+            g_config.groups = (int)val;
+            break;
+        case 'n':
+            if (parse_positive(optarg, 4096, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid number of connections: %s\n", optarg);
+                return -1;
+            }
+            g_config.conns = (int)val;
+            break;
+        case 'b':
+            if (parse_positive(optarg, 4096, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid batch: %s\n", optarg);
+                return -1;
+            }
+            g_config.batch = (int)val;
+            break;
+        case 'l':
+            if (parse_positive(optarg, 1L << 20, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid message size (1 to 1048576): %s\n", optarg);
+                return -1;
+            }
+            g_config.msg_size = (size_t)val;
+            break;
+        case 'W':
+            if (parse_positive(optarg, 1L << 30, &val) != 0 || !val) {
+                fprintf(stderr, "Error: Invalid window: %s\n", optarg);
+                return -1;
+            }
+            g_config.window = (size_t)val;
+            break;
+        case 'd':
+            if (parse_positive(optarg, 86400, &val) != 0) {
+                fprintf(stderr, "Error: Invalid duration: %s\n", optarg);
+                return -1;
+            }
+            g_config.duration = (int)val;
+            break;
+        case 'w':
+            if (parse_positive(optarg, 86400, &val) != 0) {
+                fprintf(stderr, "Error: Invalid warmup: %s\n", optarg);
+                return -1;
+            }
+            g_config.warmup = (int)val;
+            break;
+        case 'C':
+            if (parse_cpus(optarg) != 0) {
+                fprintf(stderr, "Error: Invalid CPU list: %s\n", optarg);
+                return -1;
+            }
+            break;
+        case 'j':
+            g_config.json = true;
+            break;
+        case 'h':
+            print_usage(argv[0]);
+            return -1;
+        default:
+            fprintf(stderr, "Use --help for usage information.\n");
+            return -1;
+        }
+    }
+
+    if (optind < argc) {
+        fprintf(stderr, "Error: Unexpected argument: %s\n", argv[optind]);
+        return -1;
+    }
+    if (!mode_specified) {
+        fprintf(stderr, "Error: Must specify either --server (-s) or --client (-c) mode\n");
+        print_usage(argv[0]);
+        return -1;
+    }
+    if (!g_config.is_server && (!g_config.ip || !*g_config.ip)) {
+        fprintf(stderr, "Error: Client mode requires server IP address (--ip)\n");
+        return -1;
+    }
+    if ((g_config.ip && inet_aton(g_config.ip, &addr) == 0) ||
+        (g_config.client_ip && inet_aton(g_config.client_ip, &addr) == 0)) {
+        fprintf(stderr, "Error: Invalid IP address\n");
+        return -1;
+    }
+    if ((int)g_config.port + g_config.groups - 1 > 65535) {
+        fprintf(stderr, "Error: The ports of the groups exceed 65535\n");
+        return -1;
+    }
+    if (g_config.mode == MODE_STREAM &&
+        (size_t)g_config.batch * g_config.msg_size > g_config.window) {
+        fprintf(stderr, "Error: A batch of messages doesn't fit the window\n");
+        return -1;
+    }
+    if (g_config.is_server) {
+        /* The warmup and the message size are defined by the clients */
+        g_config.warmup = 0;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/*
+ * XLIO Ultra API Coroutines Example
+ *
+ * The ping-pong scenario of xlio_ultra_api_bench written with the C++20 coroutine adapter
+ * (mellanox/xlio_coro.h): the server echoes the data of each connection, the client sends
+ * the messages zero-copy from a registered buffer and measures the round trip time.
+ *
+ * Build: g++ -std=c++20 -O2 -o examples/xlio_ultra_api_coro examples/xlio_ultra_api_coro.cpp
+ *        -libverbs
+ *
+ * Usage (server): LD_PRELOAD=libxlio.so ./examples/xlio_ultra_api_coro -s -i 192.168.1.100
+ * Usage (client): LD_PRELOAD=libxlio.so ./examples/xlio_ultra_api_coro -c -i 192.168.1.100
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <getopt.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <vector>
+
+#include <mellanox/xlio_coro.h>
+#include <infiniband/verbs.h>
+
+using namespace xlio_coro;
+
+struct app_config {
+    bool is_server = false;
+    const char *ip = nullptr;
+    unsigned short port = 8080;
+    size_t msg_size = 64U;
+    unsigned iterations = 100000U;
+};
+
+static app_config g_config;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static struct sockaddr_in make_addr()
+{
+    struct sockaddr_in addr = {};
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(g_config.port);
+    inet_pton(AF_INET, g_config.ip, &addr.sin_addr);
+    return addr;
+}
+
+/*
+ * Server: a coroutine per connection echoes the received buffers. The RX buffers are
+ * owned by XLIO, so the echo copies them with the inline send.
+ */
+static task<void> echo_session(stream_socket sock)
+{
+    for (;;) {
+        buf_view buf = co_await sock.recv();
+        if (!buf) {
+            break;
+        }
+        int rc = sock.send_inline(buf.data(), buf.size());
+        if (rc) {
+            fprintf(stderr, "send failed: %s\n", strerror(rc));
+            break;
+        }
+        // The buffer returns to XLIO here, when the view goes out of scope
+    }
+}
+
+static task<void> server(executor &ex)
+{
+    struct sockaddr_in addr = make_addr();
+    stream_socket listener;
+    int rc = ex.create_socket(AF_INET, listener);
+
+    if (!rc) {
+        rc = listener.bind(reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+    }
+    if (!rc) {
+        rc = listener.listen();
+    }
+    if (rc) {
+        fprintf(stderr, "Failed to listen: %s\n", strerror(rc));
+        co_return;
+    }
+    printf("Listening on %s:%u\n", g_config.ip, g_config.port);
+
+    for (;;) {
+        stream_socket peer;
+        rc = co_await listener.accept(peer);
+        if (rc) {
+            fprintf(stderr, "accept failed: %s\n", strerror(rc));
+            co_return;
+        }
+        ex.spawn(echo_session(std::move(peer)));
+    }
+}
+
+/*
+ * Client: each iteration awaits the zero-copy completion of the message and the complete
+ * echo, so a single message is in flight as in the ping-pong mode of the benchmark.
+ */
+static task<void> client(executor &ex)
+{
+    struct sockaddr_in addr = make_addr();
+    stream_socket sock;
+    std::vector<uint64_t> rtt;
+    int rc = ex.create_socket(AF_INET, sock);
+
+    if (!rc) {
+        rc = co_await sock.connect(reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+    }
+    if (rc) {
+        fprintf(stderr, "Failed to connect: %s\n", strerror(rc));
+        co_return;
+    }
+
+    struct ibv_pd *pd = ex.api()->xlio_socket_get_pd(sock.native_handle());
+    std::vector<char> msg(g_config.msg_size, 'x');
+    struct ibv_mr *mr = pd ? ibv_reg_mr(pd, msg.data(), msg.size(), IBV_ACCESS_LOCAL_WRITE)
+                           : nullptr;
+    if (!mr) {
+        fprintf(stderr, "Failed to register the TX buffer\n");
+        co_return;
+    }
+
+    rtt.reserve(g_config.iterations);
+    for (unsigned i = 0; i < g_config.iterations; ++i) {
+        uint64_t start = now_ns();
+        size_t received = 0U;
+
+        rc = co_await sock.send(msg.data(), msg.size(), mr->lkey);
+        while (!rc && received < msg.size()) {
+            buf_view buf = co_await sock.recv();
+            if (!buf) {
+                rc = sock.error() ? sock.error() : ECONNRESET;
+                break;
+            }
+            received += buf.size();
+        }
+        if (rc) {
+            fprintf(stderr, "Iteration %u failed: %s\n", i, strerror(rc));
+            break;
+        }
+        rtt.push_back(now_ns() - start);
+    }
+
+    sock.close();
+    ibv_dereg_mr(mr);
+    if (!rtt.empty()) {
+        std::sort(rtt.begin(), rtt.end());
+        uint64_t sum = 0U;
+        for (uint64_t val : rtt) {
+            sum += val;
+        }
+        printf("%zu round trips of %zu bytes: avg %.2f us, p50 %.2f us, p99 %.2f us, "
+               "max %.2f us\n",
+               rtt.size(), g_config.msg_size, sum / 1000.0 / rtt.size(),
+               rtt[rtt.size() / 2U] / 1000.0, rtt[rtt.size() * 99U / 100U] / 1000.0,
+               rtt.back() / 1000.0);
+    }
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [-s | -c] -i <ip> [options]\n"
+           "  -s            Server mode\n"
+           "  -c            Client mode\n"
+           "  -i <ip>       Server IPv4 address\n"
+           "  -p <port>     Server port (default 8080)\n"
+           "  -l <bytes>    Message size (default 64)\n"
+           "  -n <count>    Number of round trips of the client (default 100000)\n"
+           "  -h            Show this message\n",
+           prog);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "sci:p:l:n:h")) != -1) {
+        switch (opt) {
+        case 's':
+            g_config.is_server = true;
+            break;
+        case 'c':
+            g_config.is_server = false;
+            break;
+        case 'i':
+            g_config.ip = optarg;
+            break;
+        case 'p':
+            g_config.port = static_cast<unsigned short>(atoi(optarg));
+            break;
+        case 'l':
+            g_config.msg_size = strtoul(optarg, nullptr, 0);
+            break;
+        case 'n':
+            g_config.iterations = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (!g_config.ip || !g_config.msg_size) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    struct xlio_api_t *api = xlio_get_api();
+    if (!api || !(api->cap_mask & XLIO_EXTRA_API_XLIO_ULTRA)) {
+        fprintf(stderr, "XLIO Ultra API not available. Ensure libxlio is preloaded.\n");
+        return 1;
+    }
+    struct xlio_init_attr init_attr = {};
+    if (api->xlio_init_ex(&init_attr)) {
+        fprintf(stderr, "Failed to initialize XLIO: %s\n", strerror(errno));
+        return 1;
+    }
+
+    {
+        executor ex(api);
+        if (ex.error()) {
+            fprintf(stderr, "Failed to create a polling group: %s\n", strerror(ex.error()));
+            return 1;
+        }
+        ex.spawn(g_config.is_server ? server(ex) : client(ex));
+        ex.run();
+    }
+
+    api->xlio_exit();
+    return 0;
+}
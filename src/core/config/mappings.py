@@ -10,11 +10,18 @@ config_mapping = {
     "core.daemon.enable": "XLIO_SERVICE_ENABLE",
     "core.exception_handling.mode": "XLIO_EXCEPTION_HANDLING",
     "core.quick_init": "XLIO_QUICK_START",
+    "core.resources.buffer_pool_shrink_msec": "XLIO_BUFFER_POOL_SHRINK_MSEC",
     "core.resources.external_memory_limit": "XLIO_MEMORY_LIMIT_USER",
     "core.resources.heap_metadata_block_size": "XLIO_HEAP_METADATA_BLOCK",
     "core.resources.hugepages.enable": "XLIO_MEM_ALLOC_TYPE",
+    "core.resources.hugepages.fork_slices": "XLIO_HUGEPAGE_FORK_SLICES",
+    "core.resources.hugepages.persistent_file": "XLIO_HUGEPAGE_PERSISTENT_FILE",
+    "core.resources.hugepages.prefault_threads": "XLIO_HUGEPAGE_PREFAULT_THREADS",
+    "core.resources.hugepages.queues": "XLIO_HUGEPAGE_QUEUES",
     "core.resources.hugepages.size": "XLIO_HUGEPAGE_SIZE",
     "core.resources.memory_limit": "XLIO_MEMORY_LIMIT",
+    "core.resources.rx_pool_low_watermark": "XLIO_RX_POOL_LOW_WATERMARK",
+    "core.resources.rx_socket_bufs_max": "XLIO_RX_SOCKET_BUFS_MAX",
     "core.signals.sigint.exit": "XLIO_HANDLE_SIGINTR",
     "core.signals.sigsegv.backtrace": "XLIO_HANDLE_SIGSEGV",
     "core.syscall.allow_privileged_sockopt": "XLIO_ALLOW_PRIVILEGED_SOCK_OPT",
@@ -23,6 +30,7 @@ config_mapping = {
     "core.syscall.dup2_close_fd": "XLIO_CLOSE_ON_DUP2",
     "core.syscall.fork_support": "XLIO_FORK",
     "core.syscall.sendfile_cache_limit": "XLIO_ZC_CACHE_THRESHOLD",
+    "core.syscall.sendfile_cache_max_files": "XLIO_ZC_CACHE_MAX_FILES",
     
     # network section
     "network.multicast.mc_flowtag_acceleration": "XLIO_MC_FORCE_FLOWTAG",
@@ -31,37 +39,68 @@ config_mapping = {
     "network.neighbor.arp.uc_delay_msec": "XLIO_NEIGH_UC_ARP_DELAY_MSEC",
     "network.neighbor.arp.uc_retries": "XLIO_NEIGH_UC_ARP_QUATA",
     "network.neighbor.errors_before_reset": "XLIO_NEIGH_NUM_ERR_RETRIES",
+    "network.neighbor.preresolve": "XLIO_NEIGH_PRERESOLVE",
+    "network.neighbor.refresh_msec": "XLIO_NEIGH_REFRESH_MSEC",
     "network.neighbor.update_interval_msec": "XLIO_NETLINK_TIMER",
     "network.protocols.ip.mtu": "XLIO_MTU",
+    "network.protocols.ip.path_cache_size": "XLIO_PATH_CACHE_SIZE",
+    "network.protocols.tcp.ack_adaptive": "XLIO_TCP_ACK_ADAPTIVE",
+    "network.protocols.tcp.ack_coalesce": "XLIO_TCP_ACK_COALESCE",
     "network.protocols.tcp.congestion_control": "XLIO_TCP_CC_ALGO",
+    "network.protocols.tcp.cork_timeout_msec": "XLIO_TCP_CORK_TIMEOUT_MSEC",
+    "network.protocols.tcp.ecn": "XLIO_TCP_ECN",
+    "network.protocols.tcp.fastopen": "XLIO_TCP_FASTOPEN",
     "network.protocols.tcp.linger_0": "XLIO_TCP_ABORT_ON_CLOSE",
+    "network.protocols.tcp.moderate_rcvbuf": "XLIO_TCP_MODERATE_RCVBUF",
     "network.protocols.tcp.mss": "XLIO_MSS",
+    "network.protocols.tcp.mtu_probing": "XLIO_TCP_MTU_PROBING",
     "network.protocols.tcp.nodelay.byte_threshold": "XLIO_TCP_NODELAY_TRESHOLD",
     "network.protocols.tcp.nodelay.enable": "XLIO_TCP_NODELAY",
     "network.protocols.tcp.push": "XLIO_TCP_PUSH_FLAG",
     "network.protocols.tcp.quickack": "XLIO_TCP_QUICKACK",
+    "network.protocols.tcp.rack": "XLIO_TCP_RACK",
+    "network.protocols.tcp.sack": "XLIO_TCP_SACK",
+    "network.protocols.tcp.socket_pool_size": "XLIO_TCP_SOCKET_POOL_SIZE",
+    "network.protocols.tcp.syncookies": "XLIO_TCP_SYNCOOKIES",
     "network.protocols.tcp.timer_msec": "XLIO_TCP_TIMER_RESOLUTION_MSEC",
+    "network.protocols.tcp.timer_park_idle": "XLIO_TCP_TIMER_PARK_IDLE",
     "network.protocols.tcp.timestamps": "XLIO_TCP_TIMESTAMP_OPTION",
+    "network.protocols.tcp.timewait_compact": "XLIO_TCP_TIMEWAIT_COMPACT",
     "network.protocols.tcp.wmem": "XLIO_TCP_SEND_BUFFER_SIZE",
+    "network.protocols.tcp.wmem_autotune_limit": "XLIO_TCP_SEND_BUFFER_AUTOTUNE_LIMIT",
+    "network.protocols.udp.dst_cache_size": "XLIO_UDP_DST_CACHE_SIZE",
     "network.timing.hw_ts_conversion": "XLIO_HW_TS_CONVERSION",
     
     # hardware_features section
+    "hardware_features.implicit_odp": "XLIO_IMPLICIT_ODP",
+    "hardware_features.mpwqe.enable": "XLIO_TX_MPWQE",
+    "hardware_features.mpwqe.max_pkt_size": "XLIO_TX_MPWQE_MAX_PKT_SIZE",
+    "hardware_features.rx_cqe_compression": "XLIO_RX_CQE_COMPRESSION",
+    "hardware_features.striding_rq.auto_geometry": "XLIO_STRQ_AUTO_GEOMETRY",
     "hardware_features.striding_rq.enable": "XLIO_STRQ",
     "hardware_features.striding_rq.stride_size": "XLIO_STRQ_STRIDE_SIZE_BYTES",
     "hardware_features.striding_rq.strides_num": "XLIO_STRQ_NUM_STRIDES",
     "hardware_features.tcp.lro": "XLIO_LRO",
     "hardware_features.tcp.tls_offload.dek_cache_max_size": "XLIO_HIGH_WMARK_DEK_CACHE_SIZE",
     "hardware_features.tcp.tls_offload.dek_cache_min_size": "XLIO_LOW_WMARK_DEK_CACHE_SIZE",
+    "hardware_features.tcp.tls_offload.dek_pool_size": "XLIO_UTLS_DEK_POOL_SIZE",
     "hardware_features.tcp.tls_offload.rx_enable": "XLIO_UTLS_RX",
+    "hardware_features.tcp.tls_offload.tx_coalesce_size": "XLIO_UTLS_TX_COALESCE_SIZE",
     "hardware_features.tcp.tls_offload.tx_enable": "XLIO_UTLS_TX",
     "hardware_features.tcp.tso.enable": "XLIO_TSO",
     "hardware_features.tcp.tso.max_size": "XLIO_TSO_MAX_SIZE",
     
     # performance section
     "performance.buffers.batching_mode": "XLIO_BUFFER_BATCHING_MODE",
+    "performance.buffers.group_cache.batch_size": "XLIO_GROUP_BUF_CACHE_BATCH",
+    "performance.buffers.group_cache.max_size": "XLIO_GROUP_BUF_CACHE_SIZE",
     "performance.buffers.rx.buf_size": "XLIO_RX_BUF_SIZE",
+    "performance.buffers.rx.compact_max_size": "XLIO_RX_COMPACT_MAX_SIZE",
+    "performance.buffers.rx.compact_threshold": "XLIO_RX_COMPACT_THRESHOLD",
     "performance.buffers.rx.prefetch_before_poll": "XLIO_RX_PREFETCH_BYTES_BEFORE_POLL",
+    "performance.buffers.rx.prefetch_depth": "XLIO_RX_PREFETCH_DEPTH",
     "performance.buffers.rx.prefetch_size": "XLIO_RX_PREFETCH_BYTES",
+    "performance.buffers.rx.waitall_placement_min": "XLIO_RX_WAITALL_PLACEMENT_MIN",
     "performance.buffers.tcp_segments.pool_batch_size": "XLIO_TX_SEGS_POOL_BATCH_TCP",
     "performance.buffers.tcp_segments.ring_batch_size": "XLIO_TX_SEGS_RING_BATCH_TCP",
     "performance.buffers.tcp_segments.socket_batch_size": "XLIO_TX_SEGS_BATCH_TCP",
@@ -70,6 +109,7 @@ config_mapping = {
     "performance.completion_queue.interrupt_moderation.adaptive_change_frequency_msec": "XLIO_CQ_AIM_INTERVAL_MSEC",
     "performance.completion_queue.interrupt_moderation.adaptive_count": "XLIO_CQ_AIM_MAX_COUNT",
     "performance.completion_queue.interrupt_moderation.adaptive_interrupt_per_sec": "XLIO_CQ_AIM_INTERRUPTS_RATE_PER_SEC",
+    "performance.completion_queue.interrupt_moderation.adaptive_target_latency_usec": "XLIO_CQ_AIM_TARGET_LATENCY_USEC",
     "performance.completion_queue.interrupt_moderation.adaptive_period_usec": "XLIO_CQ_AIM_MAX_PERIOD_USEC",
     "performance.completion_queue.interrupt_moderation.enable": "XLIO_CQ_MODERATION_ENABLE",
     "performance.completion_queue.interrupt_moderation.packet_count": "XLIO_CQ_MODERATION_COUNT",
@@ -78,7 +118,9 @@ config_mapping = {
     "performance.completion_queue.periodic_drain_max_cqes": "XLIO_PROGRESS_ENGINE_WCE_MAX",
     "performance.completion_queue.periodic_drain_msec": "XLIO_PROGRESS_ENGINE_INTERVAL",
     "performance.completion_queue.rx_drain_rate_nsec": "XLIO_RX_CQ_DRAIN_RATE_NSEC",
+    "performance.gro_flush_usec": "XLIO_GRO_FLUSH_USEC",
     "performance.max_gro_streams": "XLIO_GRO_STREAMS_MAX",
+    "performance.polling.adaptive": "XLIO_POLL_ADAPTIVE",
     "performance.override_rcvbuf_limit": "XLIO_RX_BYTES_MIN",
     "performance.polling.blocking_rx_poll_usec": "XLIO_RX_POLL",
     "performance.polling.iomux.poll_os_ratio": "XLIO_SELECT_POLL_OS_RATIO",
@@ -92,30 +134,48 @@ config_mapping = {
     "performance.polling.rx_poll_on_tx_tcp": "XLIO_RX_POLL_ON_TX_TCP",
     "performance.polling.skip_cq_on_rx": "XLIO_SKIP_POLL_IN_RX",
     "performance.polling.yield_on_poll": "XLIO_RX_POLL_YIELD",
+    "performance.rings.bond_warm_standby": "XLIO_RING_BOND_WARM_STANDBY",
+    "performance.rings.core_pool_size": "XLIO_RING_CORE_POOL_SIZE",
     "performance.rings.max_per_interface": "XLIO_RING_LIMIT_PER_INTERFACE",
+    "performance.rings.numa_aware": "XLIO_RING_NUMA_AWARE",
+    "performance.rings.precreate_threads": "XLIO_RING_PRECREATE_THREADS",
     "performance.rings.rx.allocation_logic": "XLIO_RING_ALLOCATION_LOGIC_RX",
+    "performance.rings.rx.header_split_size": "XLIO_RX_HDR_SPLIT_SIZE",
     "performance.rings.rx.migration_ratio": "XLIO_RING_MIGRATION_RATIO_RX",
     "performance.rings.rx.post_batch_size": "XLIO_RX_WRE_BATCHING",
     "performance.rings.rx.ring_elements_count": "XLIO_RX_WRE",
+    "performance.rings.rx.shared_elements_count": "XLIO_RX_WRE_SHARED",
     "performance.rings.rx.spare_buffers": "XLIO_QP_COMPENSATION_LEVEL",
     "performance.rings.rx.spare_strides": "XLIO_STRQ_STRIDES_COMPENSATION_LEVEL",
     "performance.rings.tx.allocation_logic": "XLIO_RING_ALLOCATION_LOGIC_TX",
+    "performance.rings.tx.bf_burst": "XLIO_TX_BF_BURST",
     "performance.rings.tx.completion_batch_size": "XLIO_TX_WRE_BATCHING",
     "performance.rings.tx.max_inline_size": "XLIO_TX_MAX_INLINE",
     "performance.rings.tx.max_on_device_memory": "XLIO_RING_DEV_MEM_TX",
     "performance.rings.tx.migration_ratio": "XLIO_RING_MIGRATION_RATIO_TX",
+    "performance.rings.tx.per_priority": "XLIO_RING_PER_PRIORITY_TX",
     "performance.rings.tx.ring_elements_count": "XLIO_TX_WRE",
+    "performance.rings.tx.shared_on_device_memory": "XLIO_RING_DEV_MEM_TX_SHARED",
+    "performance.rings.tx.sw_pacing": "XLIO_TX_SW_PACING",
     "performance.rings.tx.tcp_buffer_batch": "XLIO_TX_BUFS_BATCH_TCP",
     "performance.rings.tx.udp_buffer_batch": "TX_BUFS_BATCH_UDP",
     "performance.steering_rules.disable_flowtag": "XLIO_DISABLE_FLOW_TAG",
     "performance.steering_rules.tcp.2t_rules": "XLIO_TCP_2T_RULES",
     "performance.steering_rules.tcp.3t_rules": "XLIO_TCP_3T_RULES",
+    "performance.steering_rules.tcp.deferred_rules_msec": "XLIO_TCP_DEFERRED_RULES_MSEC",
     "performance.steering_rules.udp.3t_rules": "XLIO_UDP_3T_RULES",
     "performance.steering_rules.udp.only_mc_l2_rules": "XLIO_ETH_MC_L2_ONLY_RULES",
+    "performance.steering_rules.udp.reuseport_buckets": "XLIO_UDP_REUSEPORT_BUCKETS",
     "performance.threading.cpu_affinity": "XLIO_INTERNAL_THREAD_AFFINITY",
     "performance.threading.cpuset": "XLIO_INTERNAL_THREAD_CPUSET",
     "performance.threading.internal_handler.behavior": "XLIO_TCP_CTL_THREAD",
     "performance.threading.internal_handler.timer_msec": "XLIO_TIMER_RESOLUTION_MSEC",
+    "performance.threading.worker_cpu_affinity": "XLIO_WORKER_THREADS_AFFINITY",
+    "performance.threading.worker_idle_block_usec": "XLIO_WORKER_THREADS_IDLE_BLOCK_USEC",
+    "performance.threading.worker_idle_pause_usec": "XLIO_WORKER_THREADS_IDLE_PAUSE_USEC",
+    "performance.threading.worker_listen_buckets": "XLIO_WORKER_THREADS_LISTEN_BUCKETS",
+    "performance.threading.worker_park_msec": "XLIO_WORKER_THREADS_PARK_MSEC",
+    "performance.threading.worker_placement": "XLIO_WORKER_THREADS_PLACEMENT",
     "performance.threading.worker_threads": "XLIO_WORKER_THREADS",
     "performance.threading.mutex_over_spinlock": "XLIO_MULTILOCK",
     
@@ -132,16 +192,23 @@ config_mapping = {
     
     # monitor section
     "monitor.exit_report": "XLIO_PRINT_REPORT",
+    "monitor.log.async": "XLIO_LOG_ASYNC",
     "monitor.log.colors": "XLIO_LOG_COLORS",
     "monitor.log.details": "XLIO_LOG_DETAILS",
     "monitor.log.file_path": "XLIO_LOG_FILE",
     "monitor.log.level": "XLIO_TRACELEVEL",
+    "monitor.log.rate_limit": "XLIO_LOG_RATE_LIMIT",
     "monitor.stats.cpu_usage": "XLIO_CPU_USAGE_STATS",
     "monitor.stats.fd_num": "XLIO_STATS_FD_NUM",
     "monitor.stats.file_path": "XLIO_STATS_FILE",
+    "monitor.stats.latency_hist": "XLIO_STATS_LATENCY_HIST",
+    "monitor.stats.lock_profiling": "XLIO_STATS_LOCK_PROFILING",
     "monitor.stats.shmem_dir": "XLIO_STATS_SHMEM_DIR",
+    "monitor.stats.trace_ring_events": "XLIO_STATS_TRACE_RING_EVENTS",
+    "monitor.stats.mirror_ring_slots": "XLIO_STATS_MIRROR_RING_SLOTS",
     
     # profiles section
+    "profiles.auto": "XLIO_AUTO_PROFILE",
     "profiles.spec": "XLIO_SPEC",
 
 } 
@@ -11,11 +11,13 @@
 #include <errno.h>
 #include <string.h>
 
+#include <chrono>
 #include <mutex>
 
 #include "vlogger/vlogger.h"
 #include "ib_ctx_handler_collection.h"
 #include "util/hugepage_mgr.h"
+#include "util/utils.h"
 #include "util/vtypes.h"
 #include "xlio.h"
 
@@ -47,6 +49,8 @@ xlio_allocator::xlio_allocator(alloc_t alloc_func, free_t free_func)
     m_data = nullptr;
     m_size = 0;
     m_page_size = 0;
+    m_persistent_fd = -1;
+    m_fork_slice = false;
     m_memalloc = alloc_func;
     m_memfree = free_func;
     if (m_memalloc) {
@@ -149,6 +153,39 @@ void *xlio_allocator::alloc_huge(size_t size)
     return m_data;
 }
 
+void *xlio_allocator::alloc_persistent(size_t size, const char *path)
+{
+    __log_info_dbg("Allocating %zu bytes in persistent huge tlb file %s", size, path);
+
+    if (m_data) {
+        return nullptr;
+    }
+
+    size_t actual_size = size;
+    m_data = g_hugepage_mgr.alloc_hugepages_persistent(path, actual_size, m_page_size,
+                                                       m_persistent_fd);
+    if (m_data) {
+        m_type = ALLOC_TYPE_HUGEPAGES;
+        m_size = actual_size;
+    }
+    return m_data;
+}
+
+void *xlio_allocator::alloc_fork_slice(size_t size)
+{
+    if (m_data) {
+        return nullptr;
+    }
+
+    m_data = g_hugepage_mgr.claim_fork_slice(size, m_page_size);
+    if (m_data) {
+        m_type = ALLOC_TYPE_HUGEPAGES;
+        m_size = size;
+        m_fork_slice = true;
+    }
+    return m_data;
+}
+
 void *xlio_allocator::alloc_posix_memalign(size_t size, size_t align)
 {
     int rc = posix_memalign(&m_data, align, size);
@@ -183,7 +220,17 @@ void xlio_allocator::dealloc()
 
     switch (m_type) {
     case ALLOC_TYPE_HUGEPAGES:
+        if (m_fork_slice) {
+            g_hugepage_mgr.release_fork_slice(m_data);
+            m_fork_slice = false;
+            break;
+        }
         g_hugepage_mgr.dealloc_hugepages(m_data, m_size);
+        if (m_persistent_fd >= 0) {
+            // The file keeps the hugepages for the next run
+            close(m_persistent_fd);
+            m_persistent_fd = -1;
+        }
         break;
     case ALLOC_TYPE_ANON:
         free(m_data);
@@ -481,13 +528,23 @@ bool xlio_heap::expand(size_t size /*=0*/)
     }
     size = size ?: safe_mce_sys().heap_metadata_block;
 
+    auto start = std::chrono::steady_clock::now();
+    auto allocated = start;
+
     if (!m_p_alloc_func && !m_b_hw) {
         block = new xlio_allocator_hw(ALLOC_TYPE_PREFER_HUGE);
     } else {
         block = new xlio_allocator_hw(m_p_alloc_func, m_p_free_func);
     }
 
-    data = block ? block->alloc(size) : nullptr;
+    if (block && m_b_hw && safe_mce_sys().ring_numa_aware) {
+        // The buffers are shared by all the rings, place them close to the devices
+        numa_preferred_scope numa_scope(g_p_ib_ctx_handler_collection->get_numa_node());
+        data = alloc_block(block, size);
+    } else {
+        data = block ? alloc_block(block, size) : nullptr;
+    }
+    allocated = std::chrono::steady_clock::now();
     if (m_b_hw && data) {
         if (!block->register_memory(nullptr)) {
             data = nullptr;
@@ -496,6 +553,13 @@ bool xlio_heap::expand(size_t size /*=0*/)
     if (!data) {
         goto error;
     }
+    __log_info_dbg("Heap block of %zu bytes: allocated in %lld usec, registered in %lld usec",
+                   size,
+                   (long long)std::chrono::duration_cast<std::chrono::microseconds>(allocated - start)
+                       .count(),
+                   (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - allocated)
+                       .count());
 
     m_blocks.push_back(block);
     m_latest_offset = 0;
@@ -513,12 +577,33 @@ error:
     return false;
 }
 
+void *xlio_heap::alloc_block(xlio_allocator_hw *block, size_t size)
+{
+    void *data = nullptr;
+
+    // A forked child takes the pages faulted in by the parent, only the registration is left
+    if (m_b_hw && !m_p_alloc_func && m_blocks.empty() && safe_mce_sys().hugepage_fork_slices) {
+        data = block->alloc_fork_slice(size);
+    }
+    // Only the internal buffers memory survives a restart, it is allocated once
+    if (!data && m_b_hw && !m_p_alloc_func && m_blocks.empty() &&
+        safe_mce_sys().hugepage_persistent_file[0]) {
+        data = block->alloc_persistent(size, safe_mce_sys().hugepage_persistent_file);
+    }
+    return data ?: block->alloc(size);
+}
+
 void *xlio_heap::alloc(size_t &size)
 {
     std::lock_guard<decltype(m_lock)> lock(m_lock);
 
     size_t actual_size = (size + s_pagesize - 1) & ~(s_pagesize - 1U);
-    void *data = nullptr;
+    void *data = alloc_free_range(actual_size);
+
+    if (data) {
+        size = actual_size;
+        return data;
+    }
 
 repeat:
     if (actual_size + m_latest_offset <= m_blocks.back()->size()) {
@@ -536,6 +621,114 @@ repeat:
     return data;
 }
 
+size_t xlio_heap::get_free_size()
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    if (!m_b_hw) {
+        return SIZE_MAX;
+    }
+    size_t size = m_blocks.back()->size() - m_latest_offset;
+    for (const auto &range : m_free_ranges) {
+        size += range.second;
+    }
+    return size;
+}
+
+size_t xlio_heap::page_size(const void *data)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(data);
+    for (auto &block : m_blocks) {
+        uintptr_t block_start = reinterpret_cast<uintptr_t>(block->data());
+        if (addr >= block_start && addr < block_start + block->size()) {
+            return block->page_size() ?: s_pagesize;
+        }
+    }
+    return s_pagesize;
+}
+
+void *xlio_heap::alloc_free_range(size_t size)
+{
+    for (auto iter = m_free_ranges.begin(); iter != m_free_ranges.end(); ++iter) {
+        if (iter->second >= size) {
+            uintptr_t addr = iter->first;
+            size_t left = iter->second - size;
+
+            m_free_ranges.erase(iter);
+            if (left) {
+                m_free_ranges[addr + size] = left;
+            }
+            return reinterpret_cast<void *>(addr);
+        }
+    }
+    return nullptr;
+}
+
+void xlio_heap::free(void *data, size_t size)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(data);
+
+    if (!data || !size) {
+        return;
+    }
+    release_pages(data, size);
+
+    auto next = m_free_ranges.lower_bound(addr);
+    if (next != m_free_ranges.end() && next->first == addr + size) {
+        size += next->second;
+        next = m_free_ranges.erase(next);
+    }
+    if (next != m_free_ranges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == addr) {
+            addr = prev->first;
+            size += prev->second;
+            m_free_ranges.erase(prev);
+        }
+    }
+
+    uintptr_t latest = reinterpret_cast<uintptr_t>(m_blocks.back()->data());
+    if (addr >= latest && addr + size == latest + m_latest_offset) {
+        // Give the range back to the latest block
+        m_latest_offset -= size;
+    } else {
+        m_free_ranges[addr] = size;
+    }
+    m_n_frees.fetch_add(1U, std::memory_order_relaxed);
+}
+
+void xlio_heap::release_pages(void *data, size_t size)
+{
+    /*
+     * Registered memory is pinned by the device and can't be released while the region
+     * exists. The memory of the external allocator belongs to the user.
+     */
+    if (m_b_hw || m_p_alloc_func) {
+        return;
+    }
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(data);
+    for (auto &block : m_blocks) {
+        uintptr_t block_start = reinterpret_cast<uintptr_t>(block->data());
+        if (start < block_start || start + size > block_start + block->size()) {
+            continue;
+        }
+        // Hugepages can only be released as a whole
+        size_t page_size = block->page_size() ?: s_pagesize;
+        uintptr_t from = (start + page_size - 1) & ~(page_size - 1U);
+        uintptr_t to = (start + size) & ~(page_size - 1U);
+        if (to > from && madvise(reinterpret_cast<void *>(from), to - from, MADV_DONTNEED)) {
+            __log_info_dbg("madvise(MADV_DONTNEED) failed: addr=%p size=%zu errno=%d",
+                           reinterpret_cast<void *>(from), (size_t)(to - from), errno);
+        }
+        break;
+    }
+}
+
 bool xlio_heap::register_memory(ib_ctx_handler *p_ib_ctx_h)
 {
     std::lock_guard<decltype(m_lock)> lock(m_lock);
@@ -579,6 +772,11 @@ void *xlio_allocator_heap::alloc_and_reg_mr(size_t &size, ib_ctx_handler *p_ib_c
     return m_p_heap->is_hw() ? alloc(size) : nullptr;
 }
 
+void xlio_allocator_heap::free(void *data, size_t size)
+{
+    m_p_heap->free(data, size);
+}
+
 bool xlio_allocator_heap::register_memory(ib_ctx_handler *p_ib_ctx_h)
 {
     return m_p_heap->register_memory(p_ib_ctx_h);
@@ -10,6 +10,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <map>
 #include <vector>
 #include <unordered_map>
 
@@ -30,6 +32,8 @@ public:
     void *alloc_aligned(size_t size, size_t align);
 
     void *alloc_huge(size_t size);
+    void *alloc_persistent(size_t size, const char *path);
+    void *alloc_fork_slice(size_t size);
     void *alloc_posix_memalign(size_t size, size_t align);
     void *alloc_malloc(size_t size);
 
@@ -47,6 +51,10 @@ protected:
     void *m_data;
     size_t m_size;
     size_t m_page_size;
+    // Keeps the lock of the persistent hugepages file
+    int m_persistent_fd;
+    // The memory is a fork slice of the parent, it isn't unmapped
+    bool m_fork_slice;
 
 private:
     alloc_t m_memalloc;
@@ -90,19 +98,32 @@ public:
     static void finalize();
 
     void *alloc(size_t &size);
+    void free(void *data, size_t size);
     bool register_memory(ib_ctx_handler *p_ib_ctx_h);
     uint32_t find_lkey_by_ib_ctx(ib_ctx_handler *p_ib_ctx_h) const;
 
     bool is_hw() const { return m_b_hw; }
+    /* Page size of the block which holds the memory */
+    size_t page_size(const void *data);
+    /* Memory which can still be allocated, SIZE_MAX if the heap grows on demand */
+    size_t get_free_size();
+    /* Changes every time memory is returned to the heap */
+    uint64_t get_free_generation() const { return m_n_frees.load(std::memory_order_relaxed); }
 
 private:
     xlio_heap(alloc_t alloc_func, free_t free_func, bool hw);
     ~xlio_heap();
     bool expand(size_t size = 0);
+    void *alloc_block(xlio_allocator_hw *block, size_t size);
+    void *alloc_free_range(size_t size);
+    void release_pages(void *data, size_t size);
 
     lock_mutex m_lock;
     std::vector<xlio_allocator_hw *> m_blocks;
     unsigned long m_latest_offset;
+    // Returned ranges by address, adjacent ranges are merged
+    std::map<uintptr_t, size_t> m_free_ranges;
+    std::atomic<uint64_t> m_n_frees {0};
 
     bool m_b_hw;
     alloc_t m_p_alloc_func;
@@ -117,12 +138,17 @@ public:
 
     void *alloc(size_t &size);
     void *alloc_and_reg_mr(size_t &size, ib_ctx_handler *p_ib_ctx_h);
+    /* Returns a range obtained with alloc(), the size is the one alloc() reported */
+    void free(void *data, size_t size);
     bool register_memory(ib_ctx_handler *p_ib_ctx_h);
     uint32_t find_lkey_by_ib_ctx(ib_ctx_handler *p_ib_ctx_h) const;
+    uint64_t get_free_generation() const { return m_p_heap->get_free_generation(); }
+    size_t get_free_size() { return m_p_heap->get_free_size(); }
+    size_t page_size(const void *data) { return m_p_heap->page_size(data); }
 
 private:
     xlio_heap *m_p_heap;
-    /* Currently we don't support free, so no need to track allocated blocks */
+    /* The users track their allocations, the heap only keeps the returned ranges */
 };
 
 #endif /* _XLIO_DEV_ALLOCATOR_H_ */
@@ -8,14 +8,21 @@
 #include "buffer_pool.h"
 
 #include <stdlib.h>
+#include <algorithm>
 
 #include "utils/bullseye.h"
 #include "vlogger/vlogger.h"
 #include "util/sys_vars.h"
+#include "util/instrumentation.h"
 #include "proto/mem_buf_desc.h"
+#include "event/event_handler_manager.h"
 
 #define MODULE_NAME "bpool"
 
+extern global_stats_t g_global_stat_static;
+// See description at the xlio_memory_pressure_cb_t definition.
+xlio_memory_pressure_cb_t g_user_memory_pressure_cb = nullptr;
+
 // A pointer to differentiate between g_buffer_pool_rx_stride and g_buffer_pool_rx_rwqe
 // and create an abstraction to the layers above device layer for cases when Striding RQ is on/off.
 // When Striding RQ is on, it points to g_buffer_pool_rx_stride since the upper layers work with
@@ -31,6 +38,10 @@ buffer_pool *g_buffer_pool_rx_stride = nullptr;
 // This buffer-pool holds the actual buffers for receive WQEs.
 buffer_pool *g_buffer_pool_rx_rwqe = nullptr;
 
+// This buffer-pool holds the small header buffers for RX header split.
+// Each regular RQ WQE scatters the first bytes of a packet into such a buffer.
+buffer_pool *g_buffer_pool_rx_hdr = nullptr;
+
 // This buffer-pool holds the actual buffers for send WQEs.
 buffer_pool *g_buffer_pool_tx = nullptr;
 
@@ -48,6 +59,13 @@ inline void buffer_pool::put_buffer_helper(mem_buf_desc_t *buff)
     }
 #endif
 
+    if (unlikely(buff->m_flags & mem_buf_desc_t::RX_HDR) && this != g_buffer_pool_rx_hdr) {
+        // Header split buffers can be freed through the generic RX pool pointer.
+        buff->p_next_desc = nullptr;
+        g_buffer_pool_rx_hdr->put_buffers_thread_safe(buff);
+        return;
+    }
+
     if (buff->lwip_pbuf.desc.attr == PBUF_DESC_STRIDE) {
         mem_buf_desc_t *rwqe = reinterpret_cast<mem_buf_desc_t *>(buff->lwip_pbuf.desc.mdesc);
         if (buff->rx.strides_num == rwqe->add_ref_count(-buff->rx.strides_num)) { // Is last stride.
@@ -67,32 +85,44 @@ inline void buffer_pool::put_buffer_helper(mem_buf_desc_t *buff)
 bool buffer_pool::expand(size_t count)
 {
     mem_buf_desc_t *desc;
-    size_t size = m_buf_size * count;
+    size_t data_size = m_buf_size * count;
+    size_t desc_size;
     uint8_t *data_ptr = nullptr;
     uint8_t *desc_ptr;
 
     __log_info_dbg("Expanding %s%s pool", m_buf_size ? "" : "zcopy ",
                    m_p_bpool_stat->is_rx ? "Rx" : "Tx");
 
-    if (size && m_buf_size) {
-        data_ptr = (uint8_t *)m_allocator_data.alloc(size);
+    if (data_size && m_buf_size) {
+        data_ptr = (uint8_t *)m_allocator_data.alloc(data_size);
         if (!data_ptr) {
             return false;
         }
         // Allocator can allocate more than requested.
-        count = size / m_buf_size;
+        count = data_size / m_buf_size;
+    } else {
+        data_size = 0;
     }
 
-    size = count * sizeof(mem_buf_desc_t);
-    desc_ptr = (uint8_t *)m_allocator_metadata.alloc(size);
+    desc_size = count * sizeof(mem_buf_desc_t);
+    desc_ptr = (uint8_t *)m_allocator_metadata.alloc(desc_size);
     if (!desc_ptr) {
+        m_allocator_data.free(data_ptr, data_size);
         return false;
     }
     if (!data_ptr) {
         // Utilize all allocated memory for zerocopy descriptors.
-        count = size / sizeof(mem_buf_desc_t);
+        count = desc_size / sizeof(mem_buf_desc_t);
     }
 
+    chunk new_chunk = {reinterpret_cast<mem_buf_desc_t *>(desc_ptr), count, data_ptr, data_size,
+                       desc_size, false};
+    m_chunks.insert(std::upper_bound(m_chunks.begin(), m_chunks.end(), new_chunk,
+                                     [](const chunk &a, const chunk &b) {
+                                         return a.descs < b.descs;
+                                     }),
+                    new_chunk);
+
     for (size_t i = 0; i < count; ++i) {
         pbuf_type type = (m_buf_size == 0 && m_p_bpool_stat->is_tx) ? PBUF_ZEROCOPY : PBUF_RAM;
         desc = new (desc_ptr) mem_buf_desc_t(data_ptr, m_buf_size, type);
@@ -104,9 +134,97 @@ bool buffer_pool::expand(size_t count)
     }
     m_n_buffers_created += count;
     m_p_bpool_stat->n_buffer_pool_created = m_n_buffers_created;
+    XLIO_TRACE(bpool_expand, this, count, m_n_buffers_created, m_p_bpool_stat->is_rx);
+    XLIO_TRACE_RING(TRACE_EVENT_BPOOL_EXPAND, this, count);
     return true;
 }
 
+size_t buffer_pool::find_chunk(mem_buf_desc_t *buff) const
+{
+    auto iter = std::upper_bound(
+        m_chunks.begin(), m_chunks.end(), buff,
+        [](mem_buf_desc_t *desc, const chunk &item) { return desc < item.descs; });
+
+    if (iter == m_chunks.begin() || buff >= std::prev(iter)->descs + std::prev(iter)->count) {
+        return m_chunks.size();
+    }
+    return static_cast<size_t>(std::prev(iter) - m_chunks.begin());
+}
+
+void buffer_pool::shrink(size_t count)
+{
+    std::vector<size_t> n_free(m_chunks.size(), 0U);
+    std::vector<bool> release(m_chunks.size(), false);
+    size_t n_released = 0;
+
+    // A chunk can be released only if all its buffers are in the pool
+    for (mem_buf_desc_t *buff = m_p_head; buff; buff = buff->p_next_desc) {
+        size_t idx = find_chunk(buff);
+        if (idx < m_chunks.size()) {
+            ++n_free[idx];
+        }
+    }
+    for (size_t i = m_chunks.size(); i > 0; --i) {
+        const chunk &item = m_chunks[i - 1];
+        if (!item.fixed && n_free[i - 1] == item.count && n_released + item.count <= count) {
+            release[i - 1] = true;
+            n_released += item.count;
+        }
+    }
+    if (!n_released) {
+        return;
+    }
+
+    mem_buf_desc_t **tail = &m_p_head;
+    for (mem_buf_desc_t *buff = m_p_head; buff; buff = buff->p_next_desc) {
+        size_t idx = find_chunk(buff);
+        if (idx >= m_chunks.size() || !release[idx]) {
+            *tail = buff;
+            tail = &buff->p_next_desc;
+        }
+    }
+    *tail = nullptr;
+
+    size_t n_chunks = 0;
+    for (size_t i = 0; i < m_chunks.size(); ++i) {
+        if (release[i]) {
+            m_allocator_data.free(m_chunks[i].data, m_chunks[i].data_size);
+            m_allocator_metadata.free(m_chunks[i].descs, m_chunks[i].desc_size);
+        } else {
+            m_chunks[n_chunks++] = m_chunks[i];
+        }
+    }
+    m_chunks.resize(n_chunks);
+
+    m_n_buffers -= n_released;
+    m_n_buffers_created -= n_released;
+    m_p_bpool_stat->n_buffer_pool_size -= n_released;
+    m_p_bpool_stat->n_buffer_pool_created = m_n_buffers_created;
+    ++m_n_shrinks;
+    __log_info_dbg("Shrunk %s%s pool by %zu buffers, %zu buffers left", m_buf_size ? "" : "zcopy ",
+                   m_p_bpool_stat->is_rx ? "Rx" : "Tx", n_released, m_n_buffers_created);
+}
+
+void buffer_pool::handle_timer_expired(void *user_data)
+{
+    NOT_IN_USE(user_data);
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    /*
+     * The buffers which stayed free during the whole period are not needed. Keep a pool
+     * expansion worth of them, so the steady load doesn't shrink and grow the pool.
+     */
+    bool expanded = m_n_period_expands != m_p_bpool_stat->n_buffer_pool_expands;
+    size_t unused = m_n_buffers_low > m_compensation_level ? m_n_buffers_low - m_compensation_level
+                                                           : 0U;
+
+    m_n_buffers_low = m_n_buffers;
+    m_n_period_expands = m_p_bpool_stat->n_buffer_pool_expands;
+    if (!expanded && unused) {
+        shrink(unused);
+    }
+}
+
 /**
  * Free-callback function to free a 'struct pbuf_custom_ref', called by pbuf_free.
  */
@@ -130,6 +248,14 @@ buffer_pool::buffer_pool(buffer_pool_type type, size_t buf_size, alloc_t alloc_f
     , m_n_buffers_created(0)
     , m_p_head(nullptr)
     , m_b_degraded(false)
+    , m_degraded_generation(0)
+    , m_n_buffers_low(0)
+    , m_n_period_expands(0)
+    , m_n_shrinks(0)
+    , m_timer_handle(nullptr)
+    , m_low_watermark(0)
+    , m_n_buffers_left(0)
+    , m_b_pressure(false)
     , m_allocator_data(m_buf_size ? xlio_allocator_heap(alloc_func, free_func, true)
                                   : xlio_allocator_heap(false))
     , m_allocator_metadata(false)
@@ -162,11 +288,24 @@ buffer_pool::buffer_pool(buffer_pool_type type, size_t buf_size, alloc_t alloc_f
             throw_xlio_exception("Failed to allocate buffers");
         }
     }
+    for (auto &item : m_chunks) {
+        item.fixed = true;
+    }
+    m_n_buffers_low = m_n_buffers;
+
+    if (safe_mce_sys().buffer_pool_shrink_msec && g_p_event_handler_manager) {
+        m_timer_handle = g_p_event_handler_manager->register_timer_event(
+            safe_mce_sys().buffer_pool_shrink_msec, this, PERIODIC_TIMER, nullptr);
+    }
     print_val_tbl();
 }
 
 buffer_pool::~buffer_pool()
 {
+    if (m_timer_handle) {
+        g_p_event_handler_manager->unregister_timer_event(this, m_timer_handle);
+        m_timer_handle = nullptr;
+    }
     __log_info_dbg("count %lu, missing %lu", m_n_buffers, m_n_buffers_created - m_n_buffers);
     xlio_stats_instance_remove_bpool_block(m_p_bpool_stat);
 }
@@ -192,10 +331,11 @@ void buffer_pool::print_report(vlog_levels_t log_level /*=VLOG_DEBUG*/)
     vlog_printf(log_level, "Buffer pool %p (%s%s):\n", this, m_p_bpool_stat->is_rx ? "Rx" : "Tx",
                 m_buf_size ? "" : ", zcopy");
     vlog_printf(log_level, "  Buffers: %zu created, %zu free\n", m_n_buffers_created, m_n_buffers);
-    vlog_printf(log_level, "  Memory consumption: %s (%s per buffer), expanded %u times\n",
+    vlog_printf(log_level,
+                "  Memory consumption: %s (%s per buffer), expanded %u times, shrunk %u times\n",
                 option_size::to_str(m_buf_size * m_n_buffers_created, str1, sizeof(str1)),
                 option_size::to_str(m_buf_size, str2, sizeof(str2)),
-                m_p_bpool_stat->n_buffer_pool_expands);
+                m_p_bpool_stat->n_buffer_pool_expands, m_n_shrinks);
     vlog_printf(log_level, "  Requests: %u unsatisfied buffer requests\n",
                 m_p_bpool_stat->n_buffer_pool_no_bufs);
 }
@@ -204,7 +344,7 @@ void buffer_pool::print_report(vlog_levels_t log_level /*=VLOG_DEBUG*/)
 void buffer_pool::print_full_report(vlog_levels_t log_level, bool print_only_critical /*=false*/)
 {
     std::vector<buffer_pool *> pools = {g_buffer_pool_rx_rwqe, g_buffer_pool_rx_stride,
-                                        g_buffer_pool_tx, g_buffer_pool_zc};
+                                        g_buffer_pool_rx_hdr, g_buffer_pool_tx, g_buffer_pool_zc};
     bool is_error = false;
 
     for (auto &pool : pools) {
@@ -226,16 +366,62 @@ void buffer_pool::print_full_report(vlog_levels_t log_level, bool print_only_cri
 bool buffer_pool::get_buffers_thread_safe(descq_t &pDeque, ring_slave *desc_owner, size_t count,
                                           uint32_t lkey)
 {
-    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    m_lock.lock();
+    bool ret = get_buffers(pDeque, desc_owner, count, lkey);
+
+    if (unlikely(m_low_watermark) && update_pressure()) {
+        bool pressure = m_b_pressure;
+        size_t left = m_n_buffers_left;
+
+        // The application is allowed to return buffers from the callback
+        m_lock.unlock();
+        __log_info_dbg("Memory pressure %s: %zu %s buffers left", pressure ? "started" : "ended",
+                       left, m_p_bpool_stat->is_rx ? "Rx" : "Tx");
+        if (g_user_memory_pressure_cb) {
+            g_user_memory_pressure_cb(pressure, left);
+        }
+        return ret;
+    }
+    m_lock.unlock();
+    return ret;
+}
 
+// Returns true if the memory pressure started or ended, called under the pool lock.
+bool buffer_pool::update_pressure()
+{
+    // The heap isn't checked while enough free buffers are in the pool
+    if (m_n_buffers >= (m_b_pressure ? m_low_watermark * 2U : m_low_watermark)) {
+        m_n_buffers_left = m_n_buffers;
+    } else {
+        size_t heap_bufs = m_allocator_data.get_free_size() / m_buf_size;
+        m_n_buffers_left = m_n_buffers + std::min(heap_bufs, SIZE_MAX - m_n_buffers);
+    }
+
+    if (!m_b_pressure && m_n_buffers_left < m_low_watermark) {
+        ++g_global_stat_static.n_rx_pool_pressure_events;
+        m_b_pressure = true;
+        return true;
+    }
+    if (m_b_pressure && m_n_buffers_left >= m_low_watermark * 2U) {
+        m_b_pressure = false;
+        return true;
+    }
+    return false;
+}
+
+bool buffer_pool::get_buffers(descq_t &pDeque, ring_slave *desc_owner, size_t count,
+                              uint32_t lkey)
+{
     mem_buf_desc_t *head;
 
     __log_info_funcall("requested %lu, present %lu, created %lu", count, m_n_buffers,
                        m_n_buffers_created);
 
-    if (unlikely(m_n_buffers < count) && !m_b_degraded) {
+    if (unlikely(m_n_buffers < count) &&
+        (!m_b_degraded || m_degraded_generation != m_allocator_data.get_free_generation())) {
         bool result = expand(std::max<size_t>(m_compensation_level, count));
         m_b_degraded = !result;
+        m_degraded_generation = m_allocator_data.get_free_generation();
         m_p_bpool_stat->n_buffer_pool_expands += !!result;
     }
     if (unlikely(m_n_buffers < count)) {
@@ -249,6 +435,7 @@ bool buffer_pool::get_buffers_thread_safe(descq_t &pDeque, ring_slave *desc_owne
 
     // pop buffers from the list
     m_n_buffers -= count;
+    m_n_buffers_low = std::min(m_n_buffers_low, m_n_buffers);
     m_p_bpool_stat->n_buffer_pool_size -= count;
     while (count-- > 0) {
         // Remove from list
@@ -481,3 +668,86 @@ size_t buffer_pool::get_free_count()
 {
     return m_n_buffers;
 }
+
+void buffer_pool::add_cache_stats(uint32_t hits, uint32_t misses)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    m_p_bpool_stat->n_buffer_pool_cache_hits += hits;
+    m_p_bpool_stat->n_buffer_pool_cache_misses += misses;
+}
+
+buffer_pool_cache::buffer_pool_cache(buffer_pool *pool, size_t batch, size_t max_size)
+    : m_pool(pool)
+    , m_batch(std::min(batch, max_size))
+    , m_max_size(max_size)
+{
+}
+
+buffer_pool_cache::~buffer_pool_cache()
+{
+    spill(m_cache.size());
+    flush_stats();
+}
+
+bool buffer_pool_cache::get_buffers(descq_t &pDeque, ring_slave *desc_owner, size_t count,
+                                    uint32_t lkey)
+{
+    if (unlikely(m_cache.size() < count)) {
+        size_t missing = count - m_cache.size();
+
+        ++m_n_misses;
+        // Try a full batch first and fall back to the exact amount if the pool is short.
+        if (!m_pool->get_buffers_thread_safe(m_cache, nullptr, std::max(m_batch, missing), 0U) &&
+            (m_batch <= missing ||
+             !m_pool->get_buffers_thread_safe(m_cache, nullptr, missing, 0U))) {
+            flush_stats();
+            return false;
+        }
+        flush_stats();
+    } else {
+        ++m_n_hits;
+    }
+
+    while (count-- > 0) {
+        mem_buf_desc_t *buff = m_cache.get_and_pop_back();
+        buff->lkey = lkey;
+        buff->p_desc_owner = desc_owner;
+        pDeque.push_back(buff);
+    }
+
+    return true;
+}
+
+void buffer_pool_cache::put_buffers(descq_t *buffers, size_t count)
+{
+    for (size_t amount = std::min(count, buffers->size()); amount > 0; amount--) {
+        m_cache.push_back(buffers->get_and_pop_back());
+    }
+
+    if (unlikely(m_cache.size() > m_max_size)) {
+        // Keep half of the cache to absorb the next burst without touching the pool.
+        spill(m_cache.size() - m_max_size / 2);
+        flush_stats();
+    }
+}
+
+void buffer_pool_cache::spill(size_t count)
+{
+    descq_t spill_list;
+
+    // The oldest buffers are at the front, the hot ones are reused from the back.
+    while (count-- > 0 && !m_cache.empty()) {
+        spill_list.push_back(m_cache.get_and_pop_front());
+    }
+    if (!spill_list.empty()) {
+        m_pool->put_buffers_thread_safe(&spill_list, spill_list.size());
+    }
+}
+
+void buffer_pool_cache::flush_stats()
+{
+    if (m_n_hits || m_n_misses) {
+        m_pool->add_cache_stats(m_n_hits, m_n_misses);
+        m_n_hits = m_n_misses = 0U;
+    }
+}
@@ -7,7 +7,9 @@
 #ifndef BUFFER_POOL_H
 #define BUFFER_POOL_H
 
+#include <vector>
 #include "utils/lock_wrapper.h"
+#include "event/timer_handler.h"
 #include "util/xlio_stats.h"
 #include "proto/mem_buf_desc.h"
 #include "dev/allocator.h"
@@ -35,7 +37,7 @@ inline static void free_lwip_pbuf(struct pbuf *lwip_pbuf)
     if (p_desc->m_flags & mem_buf_desc_t::ZCOPY) {
         p_desc->tx.zc.callback(p_desc);
     }
-    p_desc->m_flags = 0;
+    p_desc->m_flags &= mem_buf_desc_t::RX_HDR;
     lwip_pbuf->flags = 0;
     lwip_pbuf->ref = 0;
     lwip_pbuf->desc.attr = PBUF_DESC_NONE;
@@ -43,8 +45,11 @@ inline static void free_lwip_pbuf(struct pbuf *lwip_pbuf)
 
 /**
  * A buffer pool which internally sorts the buffers.
+ *
+ * Every expansion adds a chunk of buffers. With XLIO_BUFFER_POOL_SHRINK_MSEC, the pool
+ * returns the chunks not needed during the whole period to the heap.
  */
-class buffer_pool {
+class buffer_pool : public timer_handler {
 public:
     buffer_pool(buffer_pool_type type, size_t buf_size, alloc_t alloc_func = nullptr,
                 free_t free_func = nullptr);
@@ -89,12 +94,39 @@ public:
      */
     size_t get_free_count();
 
+    /**
+     * Account requests served by a buffer_pool_cache in front of the pool.
+     */
+    void add_cache_stats(uint32_t hits, uint32_t misses);
+
+    /**
+     * Signal a memory pressure when less buffers than the watermark can be provided.
+     */
+    void set_low_watermark(size_t watermark) { m_low_watermark = watermark; }
+    bool is_under_pressure() const { return m_b_pressure; }
+
+    void handle_timer_expired(void *user_data) override;
+
 private:
+    struct chunk {
+        mem_buf_desc_t *descs;
+        size_t count;
+        void *data;
+        size_t data_size;
+        size_t desc_size;
+        // The initial chunks are never released
+        bool fixed;
+    };
+
     /**
      * Add a buffer to the pool
      */
     inline void put_buffer_helper(mem_buf_desc_t *buff);
     bool expand(size_t count);
+    void shrink(size_t count);
+    size_t find_chunk(mem_buf_desc_t *buff) const;
+    bool get_buffers(descq_t &pDeque, ring_slave *desc_owner, size_t count, uint32_t lkey);
+    bool update_pressure();
 
     void buffersPanic();
     void put_buffers(descq_t *buffers, size_t count);
@@ -109,8 +141,23 @@ private:
     size_t m_n_buffers_created;
     mem_buf_desc_t *m_p_head;
 
-    // After an allocation failure, don't try to expand the pool anymore.
+    // After an allocation failure, don't try to expand the pool until memory is returned
+    // to the heap.
     bool m_b_degraded;
+    uint64_t m_degraded_generation;
+
+    // Sorted by the descriptors address
+    std::vector<chunk> m_chunks;
+    // Lowest number of free buffers and number of expansions in the shrink period
+    size_t m_n_buffers_low;
+    uint32_t m_n_period_expands;
+    uint32_t m_n_shrinks;
+    void *m_timer_handle;
+
+    // Memory pressure state, the pressure ends when twice the watermark is left
+    size_t m_low_watermark;
+    size_t m_n_buffers_left;
+    bool m_b_pressure;
 
     bpool_stats_t *m_p_bpool_stat;
     bpool_stats_t m_bpool_stat_static;
@@ -118,9 +165,47 @@ private:
     xlio_allocator_heap m_allocator_metadata;
 };
 
+/**
+ * Lock-free magazine of free buffers in front of a global buffer pool.
+ * The cache refills from and spills to the global pool in batches, so the pool lock
+ * is taken once per batch. The cache has no internal locking and its owner must
+ * serialize all the accesses.
+ */
+class buffer_pool_cache {
+public:
+    buffer_pool_cache(buffer_pool *pool, size_t batch, size_t max_size);
+    ~buffer_pool_cache();
+
+    /**
+     * Get buffers from the cache, refill the cache from the global pool if needed.
+     * Same semantics as buffer_pool::get_buffers_thread_safe().
+     */
+    bool get_buffers(descq_t &pDeque, ring_slave *desc_owner, size_t count, uint32_t lkey);
+
+    /**
+     * Return buffers to the cache, spill the cache to the global pool over the limit.
+     * Same semantics as buffer_pool::put_buffers_thread_safe().
+     */
+    void put_buffers(descq_t *buffers, size_t count);
+
+    size_t size() const { return m_cache.size(); }
+
+private:
+    void spill(size_t count);
+    void flush_stats();
+
+    buffer_pool *m_pool;
+    descq_t m_cache;
+    size_t m_batch;
+    size_t m_max_size;
+    uint32_t m_n_hits = 0U;
+    uint32_t m_n_misses = 0U;
+};
+
 extern buffer_pool *g_buffer_pool_rx_ptr;
 extern buffer_pool *g_buffer_pool_rx_stride;
 extern buffer_pool *g_buffer_pool_rx_rwqe;
+extern buffer_pool *g_buffer_pool_rx_hdr;
 extern buffer_pool *g_buffer_pool_tx;
 extern buffer_pool *g_buffer_pool_zc;
 
@@ -24,6 +24,7 @@
 #include "ring_simple.h"
 
 #include "core/dev/net_device_table_mgr.h"
+#include "event/poll_group.h"
 
 #define MODULE_NAME "cq_mgr_rx"
 
@@ -42,6 +43,9 @@
                         ##log_args);                                                               \
     } while (0)
 
+// Polls between two samples of the RQ consumption with a shared RX WRE budget
+#define RX_WR_SHARED_ADAPT_POLLS 1024U
+
 atomic_t cq_mgr_rx::m_n_cq_id_counter_rx = ATOMIC_INIT(1);
 
 uint64_t cq_mgr_rx::m_n_global_sn_rx = 0;
@@ -54,12 +58,19 @@ cq_mgr_rx::cq_mgr_rx(ring_simple *p_ring, ib_ctx_handler *p_ib_ctx_handler, int
     , m_p_cq_stat(&m_cq_stat_static) // use local copy of stats by default
     , m_n_sysvar_rx_prefetch_bytes_before_poll(safe_mce_sys().rx_prefetch_bytes_before_poll)
     , m_n_sysvar_rx_prefetch_bytes(safe_mce_sys().rx_prefetch_bytes)
+    , m_n_sysvar_rx_prefetch_depth(safe_mce_sys().rx_prefetch_depth)
     , m_p_ib_ctx_handler(p_ib_ctx_handler)
     , m_n_sysvar_rx_num_wr_to_post_recv(safe_mce_sys().rx_num_wr_to_post_recv)
     , m_comp_event_channel(p_comp_event_channel)
-    , m_n_sysvar_qp_compensation_level(safe_mce_sys().qp_compensation_level)
+    // With a shared RX WRE budget the spare buffers follow the initial RQ depth
+    , m_n_sysvar_qp_compensation_level(
+          safe_mce_sys().rx_num_wr_shared
+              ? std::min(safe_mce_sys().qp_compensation_level,
+                         safe_mce_sys().rx_num_wr_to_post_recv * 2U)
+              : safe_mce_sys().qp_compensation_level)
     , m_rx_lkey(g_buffer_pool_rx_rwqe->find_lkey_by_ib_ctx_thread_safe(m_p_ib_ctx_handler))
     , m_b_sysvar_cq_keep_qp_full(safe_mce_sys().cq_keep_qp_full)
+    , m_b_rx_wr_shared(safe_mce_sys().rx_num_wr_shared > 0U)
 {
     BULLSEYE_EXCLUDE_BLOCK_START
     if (m_rx_lkey == LKEY_ERROR) {
@@ -68,6 +79,7 @@ cq_mgr_rx::cq_mgr_rx(ring_simple *p_ring, ib_ctx_handler *p_ib_ctx_handler, int
     BULLSEYE_EXCLUDE_BLOCK_END
 
     memset(&m_cq_stat_static, 0, sizeof(m_cq_stat_static));
+    memset(&m_cqe_zip, 0, sizeof(m_cqe_zip));
 
     m_rx_queue.set_id("cq_mgr_rx (%p) : m_rx_queue", this);
     m_rx_pool.set_id("cq_mgr_rx (%p) : m_rx_pool", this);
@@ -102,6 +114,24 @@ void cq_mgr_rx::configure(int cq_size)
     attr.comp_mask = IBV_CQ_INIT_ATTR_MASK_FLAGS;
     attr.flags = IBV_CREATE_CQ_ATTR_IGNORE_OVERRUN;
 
+    if (safe_mce_sys().rx_cqe_compression) {
+        struct mlx5dv_context dv_attr;
+
+        // Mini CQEs carry the byte count and checksum, the rest is taken from the title CQE.
+        memset(&dv_attr, 0, sizeof(dv_attr));
+        dv_attr.comp_mask = MLX5DV_CONTEXT_MASK_CQE_COMPRESION;
+        if (!mlx5dv_query_device(context, &dv_attr) &&
+            (dv_attr.comp_mask & MLX5DV_CONTEXT_MASK_CQE_COMPRESION) &&
+            dv_attr.cqe_comp_caps.max_num &&
+            (dv_attr.cqe_comp_caps.supported_format & MLX5DV_CQE_RES_FORMAT_CSUM)) {
+            dvattr.comp_mask |= MLX5DV_CQ_INIT_ATTR_MASK_COMPRESSED_CQE;
+            dvattr.cqe_comp_res_format = MLX5DV_CQE_RES_FORMAT_CSUM;
+        }
+        cq_logdbg("RX CQE compression: %s",
+                  (dvattr.comp_mask & MLX5DV_CQ_INIT_ATTR_MASK_COMPRESSED_CQE) ? "enabled"
+                                                                               : "disabled");
+    }
+
     struct ibv_cq_ex *cq_ex = mlx5dv_create_cq(context, &attr, &dvattr);
     m_p_ibv_cq = ibv_cq_ex_to_cq(cq_ex);
     BULLSEYE_EXCLUDE_BLOCK_START
@@ -180,6 +210,7 @@ void cq_mgr_rx::add_hqrx(hw_queue_rx *hqrx_ptr)
     }
 
     VALGRIND_MAKE_MEM_DEFINED(&m_mlx5_cq, sizeof(m_mlx5_cq));
+    m_cqe_zip.left = 0U;
     cq_logfunc("hqrx_ptr=%p m_mlx5_cq.dbrec=%p m_mlx5_cq.cq_buf=%p", hqrx_ptr, m_mlx5_cq.dbrec,
                m_mlx5_cq.cq_buf);
 
@@ -192,6 +223,15 @@ void cq_mgr_rx::add_hqrx(hw_queue_rx *hqrx_ptr)
 
     // Initial fill of receiver work requests
     uint32_t hqrx_wr_num = hqrx_ptr->get_rx_max_wr_num();
+    if (m_b_rx_wr_shared) {
+        // The ring always keeps its initial elements, more are taken while it is busy
+        hqrx_wr_num = std::min(hqrx_wr_num, m_n_sysvar_rx_num_wr_to_post_recv * 2U);
+        m_rx_wr_target = m_p_ib_ctx_handler->rx_wr_shared_reserve(hqrx_wr_num, true);
+        m_rx_wr_surplus = 0U;
+        m_rx_wr_polls = 0U;
+        m_rx_wr_tail_mark = hqrx_ptr->m_rq_data.tail;
+    }
+    const uint32_t hqrx_wr_planned = hqrx_wr_num;
     cq_logdbg("Trying to push %d WRE to allocated hqrx (%p)", hqrx_wr_num, hqrx_ptr);
     while (hqrx_wr_num) {
         uint32_t n_num_mem_bufs = m_n_sysvar_rx_num_wr_to_post_recv;
@@ -211,7 +251,7 @@ void cq_mgr_rx::add_hqrx(hw_queue_rx *hqrx_ptr)
         hqrx_ptr->post_recv_buffers(&temp_desc_list, temp_desc_list.size());
         if (!temp_desc_list.empty()) {
             cq_logdbg("hqrx_ptr post recv is already full (push=%d, planned=%d)",
-                      hqrx_ptr->get_rx_max_wr_num() - hqrx_wr_num, hqrx_ptr->get_rx_max_wr_num());
+                      hqrx_wr_planned - hqrx_wr_num, hqrx_wr_planned);
             g_buffer_pool_rx_rwqe->put_buffers_thread_safe(&temp_desc_list, temp_desc_list.size());
             break;
         }
@@ -219,7 +259,7 @@ void cq_mgr_rx::add_hqrx(hw_queue_rx *hqrx_ptr)
     }
 
     cq_logdbg("Successfully post_recv hqrx with %d new Rx buffers (planned=%d)",
-              hqrx_ptr->get_rx_max_wr_num() - hqrx_wr_num, hqrx_ptr->get_rx_max_wr_num());
+              hqrx_wr_planned - hqrx_wr_num, hqrx_wr_planned);
 
     m_debt = 0;
 }
@@ -238,6 +278,21 @@ void cq_mgr_rx::del_hqrx(hw_queue_rx *hqrx_ptr)
     clean_cq();
     m_hqrx_ptr = nullptr;
     m_debt = 0;
+    if (m_rx_wr_target) {
+        m_p_ib_ctx_handler->rx_wr_shared_release(m_rx_wr_target);
+        m_rx_wr_target = 0U;
+        m_rx_wr_surplus = 0U;
+    }
+}
+
+void cq_mgr_rx::start_cqe_zip(struct xlio_mlx5_cqe *cqe)
+{
+    // The title holds the fields shared by the session and the number of mini CQEs
+    // in the byte count.
+    memcpy(&m_cqe_zip.title, cqe, sizeof(m_cqe_zip.title));
+    m_cqe_zip.left = ntohl(cqe->byte_cnt);
+    m_cqe_zip.pos = 0U;
+    ++m_p_cq_stat->n_rx_cqe_zip_sessions;
 }
 
 void cq_mgr_rx::lro_update_hdr(struct xlio_mlx5_cqe *cqe, mem_buf_desc_t *p_rx_wc_buf_desc)
@@ -300,14 +355,19 @@ bool cq_mgr_rx::request_more_buffers()
 
     // Assume locked!
     // Add an additional free buffer descs to RX cq mgr
-    bool res = g_buffer_pool_rx_rwqe->get_buffers_thread_safe(
-        m_rx_pool, m_p_ring, m_n_sysvar_qp_compensation_level, m_rx_lkey);
+    poll_group *grp = m_p_ring->get_poll_group();
+    buffer_pool_cache *cache = grp ? grp->get_rx_buf_cache() : nullptr;
+    bool res = cache ? cache->get_buffers(m_rx_pool, m_p_ring, m_n_sysvar_qp_compensation_level,
+                                          m_rx_lkey)
+                     : g_buffer_pool_rx_rwqe->get_buffers_thread_safe(
+                           m_rx_pool, m_p_ring, m_n_sysvar_qp_compensation_level, m_rx_lkey);
     if (!res) {
         cq_logfunc("Out of mem_buf_desc from RX free pool for internal object pool");
         return false;
     };
 
     m_p_cq_stat->n_buffer_pool_len = m_rx_pool.size();
+    m_p_ring->update_numa_stats();
     return true;
 }
 
@@ -318,8 +378,15 @@ void cq_mgr_rx::return_extra_buffers()
     }
     int buff_to_rel = m_rx_pool.size() - m_n_sysvar_qp_compensation_level;
 
-    cq_logfunc("releasing %d buffers to global rx pool", buff_to_rel);
-    g_buffer_pool_rx_rwqe->put_buffers_thread_safe(&m_rx_pool, buff_to_rel);
+    poll_group *grp = m_p_ring->get_poll_group();
+    buffer_pool_cache *cache = grp ? grp->get_rx_buf_cache() : nullptr;
+    if (cache) {
+        cq_logfunc("releasing %d buffers to group rx cache", buff_to_rel);
+        cache->put_buffers(&m_rx_pool, buff_to_rel);
+    } else {
+        cq_logfunc("releasing %d buffers to global rx pool", buff_to_rel);
+        g_buffer_pool_rx_rwqe->put_buffers_thread_safe(&m_rx_pool, buff_to_rel);
+    }
     m_p_cq_stat->n_buffer_pool_len = m_rx_pool.size();
 }
 
@@ -351,13 +418,18 @@ mem_buf_desc_t *cq_mgr_rx::cqe_process_rx(mem_buf_desc_t *p_mem_buf_desc, enum b
 bool cq_mgr_rx::compensate_qp_poll_success(mem_buf_desc_t *buff_cur)
 {
     // Assume locked!!!
+    if (unlikely(m_rx_wr_surplus)) {
+        rx_wr_shared_skip();
+    }
     // Compensate QP for all completions that we found
     if (m_rx_pool.size() || request_more_buffers()) {
         size_t buffers = std::min<size_t>(m_debt, m_rx_pool.size());
         m_hqrx_ptr->post_recv_buffers(&m_rx_pool, buffers);
         m_debt -= buffers;
         m_p_cq_stat->n_buffer_pool_len = m_rx_pool.size();
-    } else if (m_b_sysvar_cq_keep_qp_full || m_debt >= (int)m_hqrx_ptr->m_rx_num_wr) {
+    } else if (m_debt > 0 &&
+               (m_b_sysvar_cq_keep_qp_full || m_debt >= (int)m_hqrx_ptr->m_rx_num_wr) &&
+               !(buff_cur->m_flags & mem_buf_desc_t::RX_HDR)) {
         m_p_cq_stat->n_rx_sw_pkt_drops++;
         m_hqrx_ptr->post_recv_buffer(buff_cur);
         --m_debt;
@@ -370,6 +442,12 @@ bool cq_mgr_rx::compensate_qp_poll_success(mem_buf_desc_t *buff_cur)
 void cq_mgr_rx::compensate_qp_poll_failed()
 {
     // Assume locked!!!
+    if (unlikely(m_b_rx_wr_shared)) {
+        rx_wr_shared_adapt();
+        if (m_rx_wr_surplus) {
+            rx_wr_shared_skip();
+        }
+    }
     // Compensate QP for all completions debt
     if (m_debt) {
         if (likely(m_rx_pool.size() || request_more_buffers())) {
@@ -381,6 +459,39 @@ void cq_mgr_rx::compensate_qp_poll_failed()
     }
 }
 
+// Grows a busy RQ from the budget of the device and shrinks an idle one. The RQ consumption is
+// sampled every RX_WR_SHARED_ADAPT_POLLS polls. A grown RQ is filled by the next compensation,
+// a shrunk one leaves the next completions not reposted.
+void cq_mgr_rx::rx_wr_shared_adapt()
+{
+    if (++m_rx_wr_polls < RX_WR_SHARED_ADAPT_POLLS || !m_hqrx_ptr) {
+        return;
+    }
+    m_rx_wr_polls = 0U;
+
+    uint32_t tail = m_hqrx_ptr->m_rq_data.tail;
+    uint32_t used = tail - m_rx_wr_tail_mark;
+    m_rx_wr_tail_mark = tail;
+
+    const uint32_t max_wr = m_hqrx_ptr->get_rx_max_wr_num();
+    const uint32_t min_wr = std::min(max_wr, m_n_sysvar_rx_num_wr_to_post_recv * 2U);
+    if (used >= m_rx_wr_target / 2U && m_rx_wr_target < max_wr && !m_rx_wr_surplus) {
+        uint32_t grow = m_p_ib_ctx_handler->rx_wr_shared_reserve(
+            std::min(m_rx_wr_target, max_wr - m_rx_wr_target), false);
+        if (grow) {
+            m_rx_wr_target += grow;
+            m_debt += grow;
+            cq_logdbg("RQ grows by %u WRE to %u", grow, m_rx_wr_target);
+        }
+    } else if (used < m_rx_wr_target / 8U && m_rx_wr_target > min_wr) {
+        uint32_t shrink = std::min(m_rx_wr_target / 2U, m_rx_wr_target - min_wr);
+        m_rx_wr_target -= shrink;
+        m_rx_wr_surplus += shrink;
+        m_p_ib_ctx_handler->rx_wr_shared_release(shrink);
+        cq_logdbg("RQ shrinks by %u WRE to %u", shrink, m_rx_wr_target);
+    }
+}
+
 void cq_mgr_rx::reclaim_recv_buffer_helper(mem_buf_desc_t *buff)
 {
     if (buff->dec_ref_count() <= 1 && (buff->lwip_pbuf.ref-- <= 1)) {
@@ -396,6 +507,14 @@ void cq_mgr_rx::reclaim_recv_buffer_helper(mem_buf_desc_t *buff)
                 temp->p_prev_desc = nullptr;
                 temp->reset_ref_count();
                 free_lwip_pbuf(&temp->lwip_pbuf);
+                if (unlikely(temp->m_flags & mem_buf_desc_t::RX_HDR)) {
+                    if (m_hqrx_ptr) {
+                        m_hqrx_ptr->return_rx_hdr_buffer(temp);
+                    } else {
+                        g_buffer_pool_rx_hdr->put_buffers_thread_safe(temp);
+                    }
+                    continue;
+                }
                 m_rx_pool.push_back(temp);
             }
             m_p_cq_stat->n_buffer_pool_len = m_rx_pool.size();
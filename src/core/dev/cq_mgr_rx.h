@@ -38,6 +38,9 @@ class ring_simple;
 /* Get CQE owner bit. */
 #define MLX5_CQE_OWNER(op_own) ((op_own)&MLX5_CQE_OWNER_MASK)
 
+/* Get CQE format. */
+#define MLX5_CQE_FORMAT(op_own) (((op_own) >> 2) & 0x3)
+
 class cq_mgr_rx {
     friend class ring; // need to expose the m_n_global_sn_rx only to ring
     friend class ring_simple; // need to expose the m_n_global_sn_rx only to ring
@@ -88,6 +91,29 @@ public:
     virtual int poll_and_process_element_rx(uint64_t *p_cq_poll_sn,
                                             void *pv_fd_ready_array = nullptr) = 0;
 
+    /**
+     * Maximum number of CQEs processed by a single poll_and_process_element_rx() call.
+     * Zero restores the configured default value.
+     */
+    void set_poll_budget(uint32_t budget)
+    {
+        m_n_sysvar_cq_poll_batch_max = budget ? budget : safe_mce_sys().cq_poll_batch_max;
+    }
+    uint32_t get_poll_budget() const { return m_n_sysvar_cq_poll_batch_max; }
+    // CQEs polled since the creation, the early returns of a poll don't count
+    uint64_t get_polled_cqes() const { return m_n_polled_cqes; }
+
+    /**
+     * Hint that a poll has something to process, read without the ring lock.
+     * The CQ owner bit is peeked without consuming the CQE. Completions debt
+     * the QP couldn't be compensated for also needs a poll to refill the RQ.
+     */
+    bool has_rx_work()
+    {
+        return m_cqe_zip.left || !m_rx_queue.empty() || check_cqe() ||
+            m_debt >= static_cast<int>(m_n_sysvar_rx_num_wr_to_post_recv);
+    }
+
     /**
      * This will check if the cq was drained, and if it wasn't it will drain it.
      * @param restart - In case of restart - don't process any buffer
@@ -128,9 +154,21 @@ protected:
     inline void process_recv_buffer(mem_buf_desc_t *buff, void *pv_fd_ready_array = nullptr);
 
     inline void update_global_sn_rx(uint64_t &cq_poll_sn, uint32_t rettotal);
+    // Accounts a poll which returned CQEs, poll_start_tsc is taken at its first CQE
+    inline void update_poll_stats(uint32_t rx_polled, tscval_t poll_start_tsc);
 
+    inline struct xlio_mlx5_cqe *get_cqe(uint32_t ci);
     inline struct xlio_mlx5_cqe *check_cqe(void);
 
+    /**
+     * Consume the next CQE. Compressed sessions are expanded one mini CQE per call
+     * into a copy of the title CQE.
+     * @return CQE to process or nullptr if the CQ is empty.
+     */
+    inline struct xlio_mlx5_cqe *poll_cqe(void);
+    inline struct xlio_mlx5_cqe *decompress_cqe(void);
+    void start_cqe_zip(struct xlio_mlx5_cqe *cqe);
+
     mem_buf_desc_t *cqe_process_rx(mem_buf_desc_t *p_mem_buf_desc, enum buff_status_e status);
 
     virtual void reclaim_recv_buffer_helper(mem_buf_desc_t *buff);
@@ -153,23 +191,39 @@ protected:
     ring_simple *m_p_ring;
     bool m_b_is_rx_hw_csum_on = false;
     int m_debt = 0;
-    const uint32_t m_n_sysvar_cq_poll_batch_max;
+    uint32_t m_n_sysvar_cq_poll_batch_max;
+    uint64_t m_n_polled_cqes = 0U;
     const uint32_t m_n_sysvar_progress_engine_wce_max;
     cq_stats_t *m_p_cq_stat;
     mem_buf_desc_t *m_p_next_rx_desc_poll = nullptr;
     uint32_t m_n_sysvar_rx_prefetch_bytes_before_poll;
     const uint32_t m_n_sysvar_rx_prefetch_bytes;
+    const uint32_t m_n_sysvar_rx_prefetch_depth;
     size_t m_sz_transport_header = ETH_HDR_LEN;
     ib_ctx_handler *m_p_ib_ctx_handler;
     const uint32_t m_n_sysvar_rx_num_wr_to_post_recv;
     descq_t m_rx_pool;
 
+    // CQE compression session state
+    struct {
+        xlio_mlx5_cqe title; // Title CQE updated with the current mini CQE
+        xlio_mlx5_mini_cqe8 mini[XLIO_MLX5_MINI_CQE_ARRAY_SIZE];
+        uint32_t left; // Mini CQEs not consumed yet
+        uint32_t pos; // Index of the next mini CQE in the session
+    } m_cqe_zip;
+
 private:
     struct ibv_comp_channel *m_comp_event_channel;
     bool m_b_notification_armed = false;
     const uint32_t m_n_sysvar_qp_compensation_level;
     const uint32_t m_rx_lkey;
     const bool m_b_sysvar_cq_keep_qp_full;
+    const bool m_b_rx_wr_shared;
+    // Elastic RQ depth within the budget of the device, see rx_wr_shared_adapt()
+    uint32_t m_rx_wr_target = 0U; // Buffers the RQ holds, reserved from the device
+    uint32_t m_rx_wr_surplus = 0U; // Completions not reposted to shrink the RQ
+    uint32_t m_rx_wr_tail_mark = 0U; // RQ tail at the last adaptation
+    uint32_t m_rx_wr_polls = 0U; // Polls since the last adaptation
     cq_stats_t m_cq_stat_static;
     static atomic_t m_n_cq_id_counter_rx;
 
@@ -178,6 +232,14 @@ private:
 
     // returns safe_mce_sys().qp_compensation_level buffers to global pool
     void return_extra_buffers() __attribute__((noinline));
+
+    void rx_wr_shared_adapt() __attribute__((noinline));
+    void rx_wr_shared_skip()
+    {
+        uint32_t skip = std::min<uint32_t>(m_rx_wr_surplus, std::max(m_debt, 0));
+        m_debt -= skip;
+        m_rx_wr_surplus -= skip;
+    }
 };
 
 inline void cq_mgr_rx::update_global_sn_rx(uint64_t &cq_poll_sn, uint32_t num_polled_cqes)
@@ -201,12 +263,25 @@ inline void cq_mgr_rx::update_global_sn_rx(uint64_t &cq_poll_sn, uint32_t num_po
     cq_poll_sn = m_n_global_sn_rx;
 }
 
+inline void cq_mgr_rx::update_poll_stats(uint32_t rx_polled, tscval_t poll_start_tsc)
+{
+    tscval_t now;
+
+    gettimeoftsc(&now);
+    m_n_polled_cqes += rx_polled;
+    m_p_cq_stat->n_rx_poll_tsc += now - poll_start_tsc;
+    ++m_p_cq_stat->n_rx_poll_cqes_hist[cq_poll_hist_bucket(rx_polled)];
+}
+
+inline struct xlio_mlx5_cqe *cq_mgr_rx::get_cqe(uint32_t ci)
+{
+    return (struct xlio_mlx5_cqe *)(((uint8_t *)m_mlx5_cq.cq_buf) +
+                                    ((ci & (m_mlx5_cq.cqe_count - 1)) << m_mlx5_cq.cqe_size_log));
+}
+
 inline struct xlio_mlx5_cqe *cq_mgr_rx::check_cqe(void)
 {
-    struct xlio_mlx5_cqe *cqe =
-        (struct xlio_mlx5_cqe *)(((uint8_t *)m_mlx5_cq.cq_buf) +
-                                 ((m_mlx5_cq.cq_ci & (m_mlx5_cq.cqe_count - 1))
-                                  << m_mlx5_cq.cqe_size_log));
+    struct xlio_mlx5_cqe *cqe = get_cqe(m_mlx5_cq.cq_ci);
     // CQE ownership is defined by Owner bit in the CQE.
     // The value indicating SW ownership is flipped every time CQ wraps around.
     if (likely((MLX5_CQE_OPCODE(cqe->op_own)) != MLX5_CQE_INVALID) &&
@@ -217,4 +292,45 @@ inline struct xlio_mlx5_cqe *cq_mgr_rx::check_cqe(void)
     return nullptr;
 }
 
+inline struct xlio_mlx5_cqe *cq_mgr_rx::decompress_cqe(void)
+{
+    uint32_t idx = m_cqe_zip.pos & (XLIO_MLX5_MINI_CQE_ARRAY_SIZE - 1);
+
+    if (idx == 0U) {
+        // The first mini CQE array follows the title, the next ones start every 8 CQEs.
+        memcpy(m_cqe_zip.mini, get_cqe(m_mlx5_cq.cq_ci + (m_cqe_zip.pos ? 0U : 1U)),
+               sizeof(m_cqe_zip.mini));
+    }
+    m_cqe_zip.title.byte_cnt = m_cqe_zip.mini[idx].byte_cnt;
+    m_cqe_zip.title.csum = m_cqe_zip.mini[idx].csum;
+
+    // The session leaves stale CQEs in the ring, which must not look valid after a wrap around.
+    get_cqe(m_mlx5_cq.cq_ci)->op_own = MLX5_CQE_INVALID << 4;
+    ++m_mlx5_cq.cq_ci;
+    ++m_cqe_zip.pos;
+    --m_cqe_zip.left;
+    ++m_p_cq_stat->n_rx_cqe_zip_packets;
+
+    return &m_cqe_zip.title;
+}
+
+inline struct xlio_mlx5_cqe *cq_mgr_rx::poll_cqe(void)
+{
+    if (unlikely(m_cqe_zip.left)) {
+        return decompress_cqe();
+    }
+
+    struct xlio_mlx5_cqe *cqe = check_cqe();
+    if (likely(cqe)) {
+        rmb();
+        if (unlikely(MLX5_CQE_FORMAT(cqe->op_own) == XLIO_MLX5_CQE_FORMAT_COMPRESSED)) {
+            start_cqe_zip(cqe);
+            return decompress_cqe();
+        }
+        ++m_mlx5_cq.cq_ci;
+    }
+
+    return cqe;
+}
+
 #endif // CQ_MGR_H
@@ -9,6 +9,8 @@
 #if defined(DEFINED_DIRECT_VERBS)
 
 #include <util/valgrind.h>
+#include <util/instrumentation.h>
+#include <util/coarse_clock.h>
 #include "cq_mgr_rx_inl.h"
 #include "hw_queue_rx.h"
 #include "ring_simple.h"
@@ -24,6 +26,8 @@
 #define cq_logpanic   __log_info_panic
 #define cq_logfuncall __log_info_funcall
 
+#define RX_PREFETCH_AHEAD_HDR_BYTES 128U
+
 cq_mgr_rx_regrq::cq_mgr_rx_regrq(ring_simple *p_ring, ib_ctx_handler *p_ib_ctx_handler,
                                  uint32_t cq_size, struct ibv_comp_channel *p_comp_event_channel)
     : cq_mgr_rx(p_ring, p_ib_ctx_handler, cq_size, p_comp_event_channel)
@@ -58,6 +62,34 @@ cq_mgr_rx_regrq::~cq_mgr_rx_regrq()
     cq_logdbg("Destroying CQ REGRQ");
 }
 
+/*
+ * The RQ is consumed in order, so the descriptors of the next packets are known before their
+ * completions arrive. Prefetch the descriptor 'depth' packets ahead and the header of the packet
+ * half way, whose descriptor was prefetched by an earlier call and so is cheap to dereference.
+ */
+inline void cq_mgr_rx_regrq::prefetch_rx_ahead()
+{
+    uint32_t depth = m_n_sysvar_rx_prefetch_depth;
+    uint32_t tail = m_hqrx_ptr->m_rq_data.tail;
+    uint32_t posted = m_hqrx_ptr->m_rq_data.head - tail;
+    uint32_t mask = m_hqrx_ptr->m_rx_num_wr - 1;
+    uint32_t half = (depth + 1) / 2;
+
+    if (depth < posted) {
+        prefetch((void *)m_hqrx_ptr->m_rq_wqe_idx_to_wrid[(tail + depth) & mask]);
+    }
+    if (half < posted) {
+        uint32_t index = (tail + half) & mask;
+        mem_buf_desc_t *desc = unlikely(m_hqrx_ptr->m_rx_hdr_size)
+            ? m_hqrx_ptr->m_rq_wqe_idx_to_hdr[index]
+            : (mem_buf_desc_t *)m_hqrx_ptr->m_rq_wqe_idx_to_wrid[index];
+        if (likely(desc)) {
+            // L2, L3 and L4 headers
+            prefetch_range(desc->p_buffer, RX_PREFETCH_AHEAD_HDR_BYTES);
+        }
+    }
+}
+
 mem_buf_desc_t *cq_mgr_rx_regrq::poll(enum buff_status_e &status)
 {
     mem_buf_desc_t *buff = nullptr;
@@ -76,13 +108,17 @@ mem_buf_desc_t *cq_mgr_rx_regrq::poll(enum buff_status_e &status)
             return nullptr;
         }
     }
-    xlio_mlx5_cqe *cqe = check_cqe();
+    xlio_mlx5_cqe *cqe = poll_cqe();
     if (likely(cqe)) {
-        ++m_mlx5_cq.cq_ci;
-        rmb();
+        if (unlikely(m_hqrx_ptr->m_rx_hdr_size)) {
+            m_rx_hot_buffer = rx_hdr_split(cqe, m_rx_hot_buffer);
+        }
         cqe_to_mem_buff_desc(cqe, m_rx_hot_buffer, status);
 
         ++m_hqrx_ptr->m_rq_data.tail;
+        if (m_n_sysvar_rx_prefetch_depth) {
+            prefetch_rx_ahead();
+        }
 
         buff = m_rx_hot_buffer;
         m_rx_hot_buffer = nullptr;
@@ -96,6 +132,40 @@ mem_buf_desc_t *cq_mgr_rx_regrq::poll(enum buff_status_e &status)
     return buff;
 }
 
+mem_buf_desc_t *cq_mgr_rx_regrq::rx_hdr_split(struct xlio_mlx5_cqe *cqe,
+                                             mem_buf_desc_t *p_rx_wc_buf_desc)
+{
+    uint32_t index = m_hqrx_ptr->m_rq_data.tail & (m_hqrx_ptr->m_rx_num_wr - 1);
+    mem_buf_desc_t *hdr = m_hqrx_ptr->m_rq_wqe_idx_to_hdr[index];
+
+    if (unlikely(!hdr)) {
+        // The WQE was posted without a header buffer.
+        return p_rx_wc_buf_desc;
+    }
+    m_hqrx_ptr->m_rq_wqe_idx_to_hdr[index] = nullptr;
+
+    uint8_t opcode = MLX5_CQE_OPCODE(cqe->op_own);
+    bool is_ok = (opcode == MLX5_CQE_RESP_SEND || opcode == MLX5_CQE_RESP_SEND_IMM ||
+                  opcode == MLX5_CQE_RESP_SEND_INV);
+    uint32_t hdr_size = m_hqrx_ptr->m_rx_hdr_size;
+
+    if (is_ok && ntohl(cqe->byte_cnt) <= hdr_size) {
+        // The packet fits the header buffer, deliver it and repost the RX buffer.
+        hdr->p_prev_desc = p_rx_wc_buf_desc->p_prev_desc;
+        p_rx_wc_buf_desc->p_prev_desc = nullptr;
+        m_rx_pool.push_back(p_rx_wc_buf_desc);
+        m_p_cq_stat->n_buffer_pool_len = m_rx_pool.size();
+        return hdr;
+    }
+
+    if (is_ok) {
+        // The payload was scattered after the reserved room, make the packet contiguous.
+        memcpy(p_rx_wc_buf_desc->p_buffer, hdr->p_buffer, hdr_size);
+    }
+    m_hqrx_ptr->return_rx_hdr_buffer(hdr);
+    return p_rx_wc_buf_desc;
+}
+
 void cq_mgr_rx_regrq::cqe_to_mem_buff_desc(struct xlio_mlx5_cqe *cqe,
                                            mem_buf_desc_t *p_rx_wc_buf_desc,
                                            enum buff_status_e &status)
@@ -119,6 +189,7 @@ void cq_mgr_rx_regrq::cqe_to_mem_buff_desc(struct xlio_mlx5_cqe *cqe,
         p_rx_wc_buf_desc->rx.timestamps.hw_raw = ntohll(cqe->timestamp);
         uint32_t sop_rxdrop_qpn_flowtag_h_byte = ntohl(cqe->sop_rxdrop_qpn_flowtag);
         p_rx_wc_buf_desc->rx.flow_tag_id = sop_rxdrop_qpn_flowtag_h_byte & 0x00FFFFFF;
+        p_rx_wc_buf_desc->rx.rss_hash = ntohl(cqe->rx_hash_res);
         m_p_cq_stat->n_rx_hw_pkt_drops += sop_rxdrop_qpn_flowtag_h_byte >> 24;
         p_rx_wc_buf_desc->rx.is_sw_csum_need =
             !(m_b_is_rx_hw_csum_on && (cqe->hds_ip_ext & MLX5_CQE_L4_OK) &&
@@ -262,10 +333,14 @@ int cq_mgr_rx_regrq::poll_and_process_element_rx(uint64_t *p_cq_poll_sn, void *p
 
     buff_status_e status = BS_OK;
     uint32_t rx_polled = 0;
+    tscval_t poll_start_tsc = 0;
     while (rx_polled < m_n_sysvar_cq_poll_batch_max) {
         mem_buf_desc_t *buff = poll(status);
         if (buff) {
-            ++rx_polled;
+            if (!rx_polled++) {
+                gettimeoftsc(&poll_start_tsc);
+                coarse_clock_update(poll_start_tsc);
+            }
             if (cqe_process_rx(buff, status)) {
                 if ((++m_debt < (int)m_n_sysvar_rx_num_wr_to_post_recv) ||
                     !compensate_qp_poll_success(buff)) {
@@ -283,12 +358,21 @@ int cq_mgr_rx_regrq::poll_and_process_element_rx(uint64_t *p_cq_poll_sn, void *p
     }
 
     update_global_sn_rx(*p_cq_poll_sn, rx_polled);
+    XLIO_TRACE(cq_rx_poll, this, rx_polled);
+    if (rx_polled) {
+        XLIO_TRACE_RING(TRACE_EVENT_CQ_POLL, this, rx_polled);
+    }
 
     if (likely(rx_polled > 0)) {
-        m_p_ring->m_gro_mgr.flush_all(pv_fd_ready_array);
+        m_p_cq_stat->n_rx_gro_held += m_p_ring->m_gro_mgr.flush_poll_end(
+            pv_fd_ready_array, rx_polled < m_n_sysvar_cq_poll_batch_max);
+        update_poll_stats(rx_polled, poll_start_tsc);
         return static_cast<int>(m_n_sysvar_cq_poll_batch_max - rx_polled);
     }
 
+    // The aggregates kept open by the previous poll
+    m_p_ring->m_gro_mgr.flush_all(pv_fd_ready_array);
+    ++m_p_cq_stat->n_rx_empty_polls;
     compensate_qp_poll_failed();
     return -1;
 }
@@ -26,6 +26,8 @@ protected:
     mem_buf_desc_t *poll(enum buff_status_e &status);
     inline void cqe_to_mem_buff_desc(struct xlio_mlx5_cqe *cqe, mem_buf_desc_t *p_rx_wc_buf_desc,
                                      enum buff_status_e &status);
+    mem_buf_desc_t *rx_hdr_split(struct xlio_mlx5_cqe *cqe, mem_buf_desc_t *p_rx_wc_buf_desc);
+    inline void prefetch_rx_ahead();
 };
 
 #endif // CQ_MGR_MLX5_H
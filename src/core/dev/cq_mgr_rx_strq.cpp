@@ -9,6 +9,8 @@
 #if defined(DEFINED_DIRECT_VERBS)
 
 #include <util/valgrind.h>
+#include <util/instrumentation.h>
+#include <util/coarse_clock.h>
 #include "cq_mgr_rx_inl.h"
 #include "hw_queue_rx.h"
 #include "ring_simple.h"
@@ -36,8 +38,11 @@ cq_mgr_rx_strq::cq_mgr_rx_strq(ring_simple *p_ring, ib_ctx_handler *p_ib_ctx_han
     , _stride_size_bytes(stride_size_bytes)
     , _strides_num(strides_num)
     , _wqe_buff_size_bytes(strides_num * stride_size_bytes)
+    , _b_sysvar_auto_geometry(safe_mce_sys().strq_auto_geometry)
 {
     cq_logfunc("");
+    m_p_cq_stat->n_rx_stride_size = stride_size_bytes;
+    m_p_cq_stat->n_rx_strides_per_rwqe = strides_num;
     m_n_sysvar_rx_prefetch_bytes_before_poll =
         std::min(m_n_sysvar_rx_prefetch_bytes_before_poll, stride_size_bytes);
 
@@ -161,10 +166,8 @@ mem_buf_desc_t *cq_mgr_rx_strq::poll(enum buff_status_e &status, mem_buf_desc_t
                  ((m_mlx5_cq.cq_ci & (m_mlx5_cq.cqe_count - 1)) << m_mlx5_cq.cqe_size_log));
     }
 
-    xlio_mlx5_cqe *cqe = check_cqe();
+    xlio_mlx5_cqe *cqe = poll_cqe();
     if (likely(cqe)) {
-        ++m_mlx5_cq.cq_ci;
-        rmb();
 
         bool is_filler = false;
         bool is_wqe_complete = strq_cqe_to_mem_buff_desc(cqe, status, is_filler);
@@ -183,6 +186,14 @@ mem_buf_desc_t *cq_mgr_rx_strq::poll(enum buff_status_e &status, mem_buf_desc_t
             m_p_cq_stat->n_rx_stride_count += _hot_buffer_stride->rx.strides_num;
             m_p_cq_stat->n_rx_max_stirde_per_packet = std::max(
                 m_p_cq_stat->n_rx_max_stirde_per_packet, _hot_buffer_stride->rx.strides_num);
+            if (_b_sysvar_auto_geometry) {
+                ++_size_hist[strq_geometry::size_to_bucket(_hot_buffer_stride->sz_data)];
+                if (unlikely(++_size_hist_count >= STRQ_GEOMETRY_FLUSH_PACKETS)) {
+                    strq_geometry::add_samples(_size_hist);
+                    memset(_size_hist, 0, sizeof(_size_hist));
+                    _size_hist_count = 0U;
+                }
+            }
             buff_stride = _hot_buffer_stride;
             _hot_buffer_stride = nullptr;
         } else if (status != BS_CQE_INVALID) {
@@ -230,6 +241,7 @@ inline bool cq_mgr_rx_strq::strq_cqe_to_mem_buff_desc(struct xlio_mlx5_cqe *cqe,
         _hot_buffer_stride->rx.timestamps.hw_raw = ntohll(cqe->timestamp);
         uint32_t sop_rxdrop_qpn_flowtag_h_byte = ntohl(cqe->sop_rxdrop_qpn_flowtag);
         _hot_buffer_stride->rx.flow_tag_id = sop_rxdrop_qpn_flowtag_h_byte & 0x00FFFFFF;
+        _hot_buffer_stride->rx.rss_hash = ntohl(cqe->rx_hash_res);
         m_p_cq_stat->n_rx_hw_pkt_drops += sop_rxdrop_qpn_flowtag_h_byte >> 24;
         _hot_buffer_stride->rx.is_sw_csum_need =
             !(m_b_is_rx_hw_csum_on && (cqe->hds_ip_ext & MLX5_CQE_L4_OK) &&
@@ -426,6 +438,7 @@ int cq_mgr_rx_strq::poll_and_process_element_rx(uint64_t *p_cq_poll_sn, void *pv
 
     buff_status_e status = BS_OK;
     uint32_t rx_polled = 0;
+    tscval_t poll_start_tsc = 0;
     while (rx_polled < m_n_sysvar_cq_poll_batch_max) {
         mem_buf_desc_t *buff = nullptr;
         mem_buf_desc_t *buff_wqe = poll(status, buff);
@@ -435,7 +448,10 @@ int cq_mgr_rx_strq::poll_and_process_element_rx(uint64_t *p_cq_poll_sn, void *pv
         }
 
         if (buff) {
-            ++rx_polled;
+            if (!rx_polled++) {
+                gettimeoftsc(&poll_start_tsc);
+                coarse_clock_update(poll_start_tsc);
+            }
             if (cqe_process_rx(buff, status)) {
                 process_recv_buffer(buff, pv_fd_ready_array);
             }
@@ -445,12 +461,21 @@ int cq_mgr_rx_strq::poll_and_process_element_rx(uint64_t *p_cq_poll_sn, void *pv
     }
 
     update_global_sn_rx(*p_cq_poll_sn, rx_polled);
+    XLIO_TRACE(cq_rx_poll, this, rx_polled);
+    if (rx_polled) {
+        XLIO_TRACE_RING(TRACE_EVENT_CQ_POLL, this, rx_polled);
+    }
 
     if (likely(rx_polled > 0)) {
-        m_p_ring->m_gro_mgr.flush_all(pv_fd_ready_array);
+        m_p_cq_stat->n_rx_gro_held += m_p_ring->m_gro_mgr.flush_poll_end(
+            pv_fd_ready_array, rx_polled < m_n_sysvar_cq_poll_batch_max);
+        update_poll_stats(rx_polled, poll_start_tsc);
         return static_cast<int>(m_n_sysvar_cq_poll_batch_max - rx_polled);
     }
 
+    // The aggregates kept open by the previous poll
+    m_p_ring->m_gro_mgr.flush_all(pv_fd_ready_array);
+    ++m_p_cq_stat->n_rx_empty_polls;
     compensate_qp_poll_failed();
     return -1;
 }
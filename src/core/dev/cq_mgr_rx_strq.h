@@ -10,6 +10,7 @@
 #include <config.h>
 #include <vector>
 #include "cq_mgr_rx.h"
+#include "strq_geometry.h"
 
 class cq_mgr_rx_strq : public cq_mgr_rx {
 public:
@@ -50,6 +51,9 @@ private:
     const uint32_t _strides_num;
     const uint32_t _wqe_buff_size_bytes;
     uint32_t _current_wqe_consumed_bytes = 0U;
+    const bool _b_sysvar_auto_geometry;
+    uint32_t _size_hist_count = 0U;
+    uint32_t _size_hist[STRQ_GEOMETRY_BUCKETS] = {};
 };
 
 #endif
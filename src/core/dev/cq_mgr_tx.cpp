@@ -8,6 +8,7 @@
 #include <util/valgrind.h>
 #include <sock/sock-redirect.h>
 #include <sock/sock-app.h>
+#include <sock/tx_ts_sink.h>
 #include <iomanip>
 #include "ring_simple.h"
 #include "hw_queue_tx.h"
@@ -28,6 +29,18 @@ atomic_t cq_mgr_tx::m_n_cq_id_counter_tx = ATOMIC_INIT(1);
 
 uint64_t cq_mgr_tx::m_n_global_sn_tx = 0U;
 
+bool cq_mgr_tx::is_tx_ts_cqe(const struct xlio_mlx5_cqe *cqe) const
+{
+    if (likely(!m_hqtx_ptr->m_tx_ts_inflight)) {
+        return false;
+    }
+    rmb();
+    const mem_buf_desc_t *buf =
+        m_hqtx_ptr->m_sq_wqe_idx_to_prop[ntohs(cqe->wqe_counter) & (m_hqtx_ptr->m_tx_num_wr - 1)]
+            .buf;
+    return buf && (buf->m_flags & mem_buf_desc_t::TX_TIMESTAMP);
+}
+
 cq_mgr_tx::cq_mgr_tx(ring_simple *p_ring, ib_ctx_handler *p_ib_ctx_handler, int cq_size,
                      ibv_comp_channel *p_comp_event_channel)
     : m_p_ring(p_ring)
@@ -222,7 +235,7 @@ int cq_mgr_tx::poll_and_process_element_tx(uint64_t *p_cq_poll_sn)
             m_hqtx_ptr->m_sq_wqe_idx_to_prop[index].buf->m_flags |= mem_buf_desc_t::HAD_CQE_ERROR;
         }
 
-        handle_sq_wqe_prop(index);
+        handle_sq_wqe_prop(index, ntohll(cqe->timestamp));
         ret = 1;
     }
     update_global_sn_tx(*p_cq_poll_sn, num_polled_cqes);
@@ -248,11 +261,13 @@ void cq_mgr_tx::log_cqe_error(struct xlio_mlx5_cqe *cqe, uint16_t wqe_index, uin
     }
 }
 
-void cq_mgr_tx::handle_sq_wqe_prop(unsigned index)
+void cq_mgr_tx::handle_sq_wqe_prop(unsigned index, uint64_t hw_timestamp)
 {
-    sq_wqe_prop *p = &m_hqtx_ptr->m_sq_wqe_idx_to_prop[index];
+    sq_wqe_prop *const p_completed = &m_hqtx_ptr->m_sq_wqe_idx_to_prop[index];
+    sq_wqe_prop *p = p_completed;
     sq_wqe_prop *prev;
     unsigned credits = 0;
+    unsigned mpwqe_bufs = 0;
 
     /*
      * TX completions can be signalled for a set of WQEs as an optimization.
@@ -265,10 +280,23 @@ void cq_mgr_tx::handle_sq_wqe_prop(unsigned index)
      * We keep index of the last completed WQE and stop processing the list
      * when we reach the index. This condition is checked in
      * is_sq_wqe_prop_valid().
+     *
+     * Only the WQE of the CQE has a HW timestamp. A timestamped WQE is signaled and
+     * get_cqe_tx() stops at its CQE, so it's always the one unless the SQ is flushed.
      */
 
     do {
         if (p->buf) {
+            if (unlikely(p->buf->m_flags & mem_buf_desc_t::TX_TIMESTAMP)) {
+                struct timespec systime;
+                const bool valid = (p == p_completed);
+
+                if (valid) {
+                    m_p_ring->convert_hw_time_to_system_time(hw_timestamp, &systime);
+                }
+                tx_ts_sink::release(p->buf, valid ? &systime : nullptr);
+                --m_hqtx_ptr->m_tx_ts_inflight;
+            }
             m_p_ring->mem_buf_desc_return_single_locked(p->buf);
         }
         if (p->ti) {
@@ -283,11 +311,16 @@ void cq_mgr_tx::handle_sq_wqe_prop(unsigned index)
             }
         }
         credits += p->credits;
+        mpwqe_bufs += p->mpwqe_bufs;
 
         prev = p;
         p = p->next;
     } while (prev != m_hqtx_ptr->m_last_sq_wqe_prop_to_complete);
 
+    if (mpwqe_bufs) {
+        // MPWQEs complete in order, so the oldest queued buffers belong to the completed WQEs.
+        m_hqtx_ptr->mpwqe_release_bufs(mpwqe_bufs);
+    }
     m_p_ring->return_tx_pool_to_global_pool();
     m_hqtx_ptr->credits_return(credits);
     m_hqtx_ptr->m_last_sq_wqe_prop_to_complete =
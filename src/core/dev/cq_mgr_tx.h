@@ -50,7 +50,8 @@ public:
 private:
     std::string wqe_to_hexstring(uint16_t wqe_index, uint32_t credits) const;
     void log_cqe_error(struct xlio_mlx5_cqe *cqe, uint16_t wqe_index, uint32_t credits) const;
-    void handle_sq_wqe_prop(unsigned index);
+    void handle_sq_wqe_prop(unsigned index, uint64_t hw_timestamp);
+    bool is_tx_ts_cqe(const struct xlio_mlx5_cqe *cqe) const;
 
     void get_cq_event(int count = 1) { xlio_ib_mlx5_get_cq_event(&m_mlx5_cq, count); };
 
@@ -113,6 +114,10 @@ inline struct xlio_mlx5_cqe *cq_mgr_tx::get_cqe_tx(uint32_t &num_polled_cqes)
             // This is likely an error CQE. Return it explicitly to log the errors.
             break;
         }
+        if (unlikely(is_tx_ts_cqe(cqe))) {
+            // Only the returned CQE is processed, and the timestamp is the one of its WQE.
+            break;
+        }
         cqe = (struct xlio_mlx5_cqe *)(((uint8_t *)m_mlx5_cq.cq_buf) +
                                        ((m_mlx5_cq.cq_ci & (m_mlx5_cq.cqe_count - 1))
                                         << m_mlx5_cq.cqe_size_log));
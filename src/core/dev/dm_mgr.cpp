@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <algorithm>
+#include <mutex>
 #include "dm_mgr.h"
 #include "vlogger/vlogger.h"
 #include "proto/mem_buf_desc.h"
@@ -15,6 +17,8 @@
 #define DM_MEMORY_MASK_8          7
 #define DM_MEMORY_MASK_64         63
 #define DM_ALIGN_SIZE(size, mask) ((size + mask) & (~mask))
+// Halve the weights of the shared pool clients once their sum reaches this number of sends
+#define DM_WEIGHT_DECAY_THRESHOLD (1U << 16)
 
 #undef MODULE_NAME
 #define MODULE_NAME "dm_mgr"
@@ -26,13 +30,146 @@
 #define dm_logdbg  __log_info_dbg
 #define dm_logfunc __log_info_func
 
+dm_pool::dm_pool()
+    : m_lock("dm_pool")
+    , m_p_dm_mr(nullptr)
+    , m_p_ibv_dm(nullptr)
+    , m_n_chunks(0)
+    , m_total_weight(0) {};
+
+dm_pool::~dm_pool()
+{
+    release_resources();
+}
+
+/*
+ * Allocate the On Device Memory shared by the rings of the device
+ */
+bool dm_pool::allocate_resources(ib_ctx_handler *ib_ctx)
+{
+    size_t allocation_size = DM_ALIGN_SIZE(safe_mce_sys().ring_dev_mem_tx, (DM_CHUNK_SIZE - 1));
+    xlio_ibv_alloc_dm_attr dm_attr;
+    xlio_ibv_reg_mr_in mr_in;
+
+    allocation_size = std::min(allocation_size, ib_ctx->get_on_device_memory_size());
+    allocation_size -= allocation_size % DM_CHUNK_SIZE;
+    if (!allocation_size) {
+        return false;
+    }
+
+    memset(&dm_attr, 0, sizeof(dm_attr));
+    dm_attr.length = allocation_size;
+    m_p_ibv_dm = xlio_ibv_alloc_dm(ib_ctx->get_ibv_context(), &dm_attr);
+    if (!m_p_ibv_dm) {
+        VLOG_PRINTF_ONCE_THEN_DEBUG(VLOG_WARNING,
+                                    "Not enough memory on device to allocate a shared %lu bytes "
+                                    "buffer, continue working without on Device Memory usage\n",
+                                    allocation_size);
+        errno = 0;
+        return false;
+    }
+
+    memset(&mr_in, 0, sizeof(mr_in));
+    xlio_ibv_init_dm_mr(mr_in, ib_ctx->get_ibv_pd(), allocation_size, m_p_ibv_dm);
+    m_p_dm_mr = xlio_ibv_reg_dm_mr(&mr_in);
+    if (!m_p_dm_mr) {
+        xlio_ibv_free_dm(m_p_ibv_dm);
+        m_p_ibv_dm = nullptr;
+        dm_logerr("ibv_free_dm error - dm_mr registration failed, %d %m", errno);
+        return false;
+    }
+
+    m_n_chunks = allocation_size / DM_CHUNK_SIZE;
+    for (uint32_t i = m_n_chunks; i > 0; --i) {
+        m_free_chunks.push_back(i - 1);
+    }
+
+    dm_logdbg("Shared device memory allocation completed successfully! device[%s] bytes[%zu] "
+              "chunks[%u] dm_mr lkey[%d]",
+              ib_ctx->get_ibv_device()->name, allocation_size, m_n_chunks, m_p_dm_mr->lkey);
+
+    return true;
+}
+
+void dm_pool::release_resources()
+{
+    if (m_p_dm_mr) {
+        if (ibv_dereg_mr(m_p_dm_mr)) {
+            dm_logerr("ibv_dereg_mr failed, %d %m", errno);
+        }
+        m_p_dm_mr = nullptr;
+    }
+
+    if (m_p_ibv_dm) {
+        if (xlio_ibv_free_dm(m_p_ibv_dm)) {
+            dm_logerr("ibv_free_dm failed %d %m", errno);
+        }
+        m_p_ibv_dm = nullptr;
+    }
+}
+
+void dm_pool::register_client(dm_mgr *client)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    client->m_weight = 0;
+    m_clients.push_back(client);
+}
+
+void dm_pool::unregister_client(dm_mgr *client)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    m_total_weight -= client->m_weight;
+    m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), client), m_clients.end());
+}
+
+/*
+ * Give a free chunk to the client unless it already holds its quota.
+ * The quota is the client share of the recent sends of all the clients and at least one chunk.
+ */
+bool dm_pool::get_chunk(dm_mgr *client, uint32_t &chunk)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    client->m_weight += client->m_demand;
+    m_total_weight += client->m_demand;
+    client->m_demand = 0;
+    if (m_total_weight >= DM_WEIGHT_DECAY_THRESHOLD) {
+        m_total_weight = 0;
+        for (dm_mgr *cur : m_clients) {
+            cur->m_weight /= 2;
+            m_total_weight += cur->m_weight;
+        }
+    }
+
+    size_t quota = m_total_weight ? m_n_chunks * client->m_weight / m_total_weight : 0;
+    quota = std::max<size_t>(quota, 1U);
+    client->m_allocation = quota * DM_CHUNK_SIZE;
+
+    if (client->m_chunks.size() >= quota || m_free_chunks.empty()) {
+        return false;
+    }
+    chunk = m_free_chunks.back();
+    m_free_chunks.pop_back();
+    return true;
+}
+
+void dm_pool::put_chunk(uint32_t chunk)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    m_free_chunks.push_back(chunk);
+}
+
 dm_mgr::dm_mgr()
     : m_p_dm_mr(nullptr)
     , m_p_ibv_dm(nullptr)
     , m_p_ring_stat(nullptr)
     , m_allocation(0)
     , m_used(0)
-    , m_head(0) {};
+    , m_head(0)
+    , m_completion_threshold(DM_COMPLETION_THRESHOLD)
+    , m_p_dm_pool(nullptr)
+    , m_demand(0)
+    , m_weight(0) {};
 
 /*
  * Allocate dev_mem resources
@@ -53,6 +190,17 @@ bool dm_mgr::allocate_resources(ib_ctx_handler *ib_ctx, ring_stats_t *ring_stats
         return false;
     }
 
+    if (safe_mce_sys().ring_dev_mem_tx_shared) {
+        m_p_dm_pool = ib_ctx->get_dm_pool();
+        if (!m_p_dm_pool) {
+            return false;
+        }
+        m_p_dm_pool->register_client(this);
+        m_allocation = DM_CHUNK_SIZE;
+        m_completion_threshold = DM_CHUNK_SIZE / 2;
+        return true;
+    }
+
     // Allocate on device memory buffer
     memset(&dm_attr, 0, sizeof(dm_attr));
     dm_attr.length = allocation_size;
@@ -100,6 +248,14 @@ bool dm_mgr::allocate_resources(ib_ctx_handler *ib_ctx, ring_stats_t *ring_stats
  */
 void dm_mgr::release_resources()
 {
+    if (m_p_dm_pool) {
+        while (!m_chunks.empty()) {
+            release_chunk();
+        }
+        m_p_dm_pool->unregister_client(this);
+        m_p_dm_pool = nullptr;
+    }
+
     if (m_p_dm_mr) {
         if (ibv_dereg_mr(m_p_dm_mr)) {
             dm_logerr("ibv_dereg_mr failed, %d %m", errno);
@@ -173,6 +329,10 @@ void dm_mgr::release_resources()
 bool dm_mgr::copy_data(struct mlx5_wqe_data_seg *seg, uint8_t *src, uint32_t length,
                        mem_buf_desc_t *buff)
 {
+    if (m_p_dm_pool) {
+        return copy_data_shared(seg, src, length, buff);
+    }
+
     xlio_ibv_memcpy_dm_attr memcpy_attr;
     uint32_t length_aligned_8 = DM_ALIGN_SIZE(length, DM_MEMORY_MASK_8);
     size_t continuous_left = 0;
@@ -243,6 +403,11 @@ dev_mem_oob:
  */
 void dm_mgr::release_data(mem_buf_desc_t *buff)
 {
+    if (m_p_dm_pool) {
+        release_data_shared(buff);
+        return;
+    }
+
     m_used -= buff->tx.dev_mem_length;
     buff->tx.dev_mem_length = 0;
 
@@ -250,5 +415,92 @@ void dm_mgr::release_data(mem_buf_desc_t *buff)
                buff, buff->tx.dev_mem_length, m_head, m_used);
 }
 
+/*
+ * Copy data into a chunk of the shared On Device Memory.
+ *
+ * Data is written sequentially into the last held chunk. When it does not fit, a new chunk is
+ * taken from the pool and the rest of the previous one is left unused. Since the completions
+ * release the data in the order it was written, the first held chunk is returned to the pool
+ * when all its data is released. The last chunk is kept and refilled.
+ */
+bool dm_mgr::copy_data_shared(struct mlx5_wqe_data_seg *seg, uint8_t *src, uint32_t length,
+                              mem_buf_desc_t *buff)
+{
+    xlio_ibv_memcpy_dm_attr memcpy_attr;
+    uint32_t length_aligned_8 = DM_ALIGN_SIZE(length, DM_MEMORY_MASK_8);
+    uint32_t chunk;
+
+    buff->tx.dev_mem_length = 0;
+    ++m_demand;
+
+    if (unlikely(length_aligned_8 > DM_CHUNK_SIZE)) {
+        goto dev_mem_oob;
+    }
+
+    if (!m_chunks.empty() && !m_chunks.back().used) {
+        // All the data is released, refill the only held chunk from its beginning
+        m_head = 0;
+    }
+
+    if (m_chunks.empty() || m_head + length_aligned_8 > DM_CHUNK_SIZE) {
+        if (!m_p_dm_pool->get_chunk(this, chunk)) {
+            goto dev_mem_oob;
+        }
+        m_chunks.push_back({chunk, 0U});
+        m_head = 0;
+        m_p_ring_stat->n_tx_dev_mem_allocated = m_chunks.size() * DM_CHUNK_SIZE;
+    }
+
+    memset(&memcpy_attr, 0, sizeof(memcpy_attr));
+    xlio_ibv_init_memcpy_dm(memcpy_attr, src, m_chunks.back().index * DM_CHUNK_SIZE + m_head,
+                            length_aligned_8);
+    if (xlio_ibv_memcpy_dm(m_p_dm_pool->get_ibv_dm(), &memcpy_attr)) {
+        dm_logfunc("Failed to memcopy data into the memic buffer %m");
+        return false;
+    }
+
+    seg->lkey = htonl(m_p_dm_pool->get_lkey());
+    seg->addr = htonll(m_chunks.back().index * DM_CHUNK_SIZE + m_head);
+    m_head += length_aligned_8;
+    m_chunks.back().used += length_aligned_8;
+    m_used += length_aligned_8;
+    buff->tx.dev_mem_length = length_aligned_8;
+
+    m_p_ring_stat->n_tx_dev_mem_pkt_count++;
+    m_p_ring_stat->n_tx_dev_mem_byte_count += length;
+
+    return true;
+
+dev_mem_oob:
+    dm_logfunc("Send OOB! Buffer[%p] length[%d] chunks[%zu] quota[%zu] used[%zu]", buff, length,
+               m_chunks.size(), m_allocation / DM_CHUNK_SIZE, m_used);
+
+    m_p_ring_stat->n_tx_dev_mem_oob++;
+
+    return false;
+}
+
+void dm_mgr::release_data_shared(mem_buf_desc_t *buff)
+{
+    dm_chunk &first = m_chunks.front();
+
+    first.used -= buff->tx.dev_mem_length;
+    m_used -= buff->tx.dev_mem_length;
+    buff->tx.dev_mem_length = 0;
+
+    // Keep the chunk being filled
+    if (!first.used && m_chunks.size() > 1) {
+        release_chunk();
+    }
+}
+
+void dm_mgr::release_chunk()
+{
+    m_used -= m_chunks.front().used;
+    m_p_dm_pool->put_chunk(m_chunks.front().index);
+    m_chunks.pop_front();
+    m_p_ring_stat->n_tx_dev_mem_allocated = m_chunks.size() * DM_CHUNK_SIZE;
+}
+
 #endif /* DEFINED_IBV_DM */
 #endif /* DEFINED_DIRECT_VERBS */
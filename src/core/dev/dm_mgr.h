@@ -7,8 +7,11 @@
 #ifndef DM_MGR_H
 #define DM_MGR_H
 
+#include <deque>
+#include <vector>
 #include "ib/base/verbs_extra.h"
 #include "util/xlio_stats.h"
+#include "utils/lock_wrapper.h"
 
 class mem_buf_desc_t;
 class ib_ctx_handler;
@@ -17,6 +20,40 @@ class ib_ctx_handler;
 #if defined(DEFINED_IBV_DM)
 
 #define DM_COMPLETION_THRESHOLD 8192
+#define DM_CHUNK_SIZE           8192
+
+class dm_mgr;
+
+/*
+ * On Device Memory shared by all the TX rings of an ib_ctx_handler.
+ * The memory is split into chunks of DM_CHUNK_SIZE bytes which the rings take while sending.
+ * The number of chunks a ring may hold follows its share of the recent On Device Memory
+ * sends of all the rings, so the memory goes to the rings which send small packets.
+ */
+class dm_pool {
+public:
+    dm_pool();
+    ~dm_pool();
+    bool allocate_resources(ib_ctx_handler *ib_ctx);
+    void register_client(dm_mgr *client);
+    void unregister_client(dm_mgr *client);
+    bool get_chunk(dm_mgr *client, uint32_t &chunk);
+    void put_chunk(uint32_t chunk);
+    xlio_ibv_dm *get_ibv_dm() const { return m_p_ibv_dm; }
+    uint32_t get_lkey() const { return m_p_dm_mr->lkey; }
+    bool is_valid() const { return m_p_dm_mr; }
+
+private:
+    void release_resources();
+
+    lock_spin m_lock;
+    struct ibv_mr *m_p_dm_mr;
+    xlio_ibv_dm *m_p_ibv_dm;
+    std::vector<uint32_t> m_free_chunks;
+    std::vector<dm_mgr *> m_clients;
+    uint32_t m_n_chunks;
+    uint64_t m_total_weight; // Sum of the clients weights
+};
 
 class dm_mgr {
 public:
@@ -28,16 +65,35 @@ public:
     void release_data(mem_buf_desc_t *buff);
     inline bool is_completion_need() const
     {
-        return m_allocation - m_used < DM_COMPLETION_THRESHOLD;
+        return m_used + m_completion_threshold > m_allocation;
     };
 
 private:
+    bool copy_data_shared(struct mlx5_wqe_data_seg *seg, uint8_t *src, uint32_t length,
+                          mem_buf_desc_t *buff);
+    void release_data_shared(mem_buf_desc_t *buff);
+    void release_chunk();
+
+    struct dm_chunk {
+        uint32_t index;
+        uint32_t used; // Bytes of the chunk not released yet
+    };
+
     struct ibv_mr *m_p_dm_mr;
     xlio_ibv_dm *m_p_ibv_dm;
     ring_stats_t *m_p_ring_stat;
     size_t m_allocation; // Size of device memory buffer (bytes)
     size_t m_used; // Next available index inside the buffer
     size_t m_head; // Device memory used bytes
+    size_t m_completion_threshold;
+
+    // Shared On Device Memory, m_allocation is the quota and m_head the offset in the last chunk
+    dm_pool *m_p_dm_pool;
+    std::deque<dm_chunk> m_chunks; // Held chunks in the order they are filled
+    uint64_t m_demand; // Sends since the last chunk request
+    uint64_t m_weight; // Decayed count of the sends, protected by the pool lock
+
+    friend class dm_pool;
 };
 
 #else
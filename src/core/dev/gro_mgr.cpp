@@ -4,14 +4,16 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include "utils/clock.h"
 #include "dev/gro_mgr.h"
 #include "dev/rfs_uc_tcp_gro.h"
 
 #define MODULE_NAME "gro_mgr"
 
-gro_mgr::gro_mgr(uint32_t flow_max, uint32_t buf_max)
+gro_mgr::gro_mgr(uint32_t flow_max, uint32_t buf_max, uint32_t flush_usec)
     : m_n_flow_max(flow_max)
     , m_n_buf_max(buf_max)
+    , m_flush_tsc(get_tsc_rate_per_second() * flush_usec / USEC_PER_SEC)
     , m_n_flow_count(0)
 {
     m_p_rfs_arr = new rfs_uc_tcp_gro *[flow_max];
@@ -38,6 +40,16 @@ bool gro_mgr::reserve_stream(rfs_uc_tcp_gro *rfs_uc_tcp_gro)
     return true;
 }
 
+void gro_mgr::remove_stream(rfs_uc_tcp_gro *rfs_uc_tcp_gro)
+{
+    for (uint32_t i = 0; i < m_n_flow_count; i++) {
+        if (m_p_rfs_arr[i] == rfs_uc_tcp_gro) {
+            m_p_rfs_arr[i] = m_p_rfs_arr[--m_n_flow_count];
+            return;
+        }
+    }
+}
+
 bool gro_mgr::is_stream_max()
 {
     return (m_n_flow_count >= m_n_flow_max);
@@ -50,3 +62,26 @@ void gro_mgr::flush_all(void *pv_fd_ready_array)
     }
     m_n_flow_count = 0;
 }
+
+uint32_t gro_mgr::flush_poll_end(void *pv_fd_ready_array, bool drained)
+{
+    if (drained || !m_flush_tsc || !m_n_flow_count) {
+        flush_all(pv_fd_ready_array);
+        return 0U;
+    }
+
+    tscval_t now;
+    uint32_t kept = 0U;
+
+    gettimeoftsc(&now);
+    for (uint32_t i = 0; i < m_n_flow_count; i++) {
+        rfs_uc_tcp_gro *p_rfs = m_p_rfs_arr[i];
+        if (p_rfs->is_expired(now, m_flush_tsc)) {
+            p_rfs->flush(pv_fd_ready_array);
+        } else {
+            m_p_rfs_arr[kept++] = p_rfs;
+        }
+    }
+    m_n_flow_count = kept;
+    return kept;
+}
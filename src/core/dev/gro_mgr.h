@@ -8,6 +8,7 @@
 #define GRO_MGR_H_
 
 #include <stdint.h>
+#include "utils/rdtsc.h"
 
 #define MAX_AGGR_BYTE_PER_STREAM 0xFFFF
 #define MAX_GRO_BUFS             32
@@ -16,17 +17,24 @@ class rfs_uc_tcp_gro;
 
 class gro_mgr {
 public:
-    gro_mgr(uint32_t flow_max, uint32_t buf_max);
+    gro_mgr(uint32_t flow_max, uint32_t buf_max, uint32_t flush_usec = 0U);
     bool reserve_stream(rfs_uc_tcp_gro *rfs_uc_tcp_gro);
+    void remove_stream(rfs_uc_tcp_gro *rfs_uc_tcp_gro);
     bool is_stream_max();
     inline uint32_t get_buf_max() { return m_n_buf_max; }
     inline uint32_t get_byte_max() { return MAX_AGGR_BYTE_PER_STREAM; }
+    inline tscval_t get_flush_tsc() const { return m_flush_tsc; }
     void flush_all(void *pv_fd_ready_array);
+    /* The flush at the end of a CQ poll. A poll which didn't drain the CQ keeps the aggregates
+     * younger than the flush deadline open for the next poll. Returns the number kept open.
+     */
+    uint32_t flush_poll_end(void *pv_fd_ready_array, bool drained);
     virtual ~gro_mgr();
 
 private:
     const uint32_t m_n_flow_max;
     const uint32_t m_n_buf_max;
+    const tscval_t m_flush_tsc; // 0 to flush at the end of every poll
 
     uint32_t m_n_flow_count;
 
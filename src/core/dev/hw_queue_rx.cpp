@@ -13,6 +13,7 @@
 #include "dev/rfs_rule.h"
 #include "dev/cq_mgr_rx_regrq.h"
 #include "dev/cq_mgr_rx_strq.h"
+#include "dev/strq_geometry.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "hw_queue_rx"
@@ -38,6 +39,22 @@ hw_queue_rx::hw_queue_rx(ring_simple *ring, ib_ctx_handler *ib_ctx,
 {
     hwqrx_logfunc("");
 
+    if (safe_mce_sys().enable_striding_rq) {
+        m_strq_stride_size = safe_mce_sys().strq_stride_size_bytes;
+        m_strq_strides_num = safe_mce_sys().strq_stride_num_per_rwqe;
+        if (safe_mce_sys().strq_auto_geometry) {
+            strq_geometry::pick(m_strq_stride_size, m_strq_strides_num);
+        }
+        hwqrx_logdbg("Striding RQ geometry: %u strides of %u bytes", m_strq_strides_num,
+                     m_strq_stride_size);
+    }
+
+    if (safe_mce_sys().rx_hdr_split_size && !m_p_ring->is_lro()) {
+        // LRO sessions are scattered by HW, keep them in a single buffer.
+        m_rx_hdr_size = safe_mce_sys().rx_hdr_split_size;
+        m_rx_hdr_lkey = g_buffer_pool_rx_hdr->find_lkey_by_ib_ctx_thread_safe(ib_ctx);
+    }
+
     if (!configure_rq(rx_comp_event_channel)) {
         throw_xlio_exception("Failed to create RQ");
     }
@@ -57,6 +74,11 @@ hw_queue_rx::~hw_queue_rx()
         m_rq_wqe_idx_to_wrid = nullptr;
     }
 
+    delete[] m_rq_wqe_idx_to_hdr;
+    if (!m_rx_hdr_pool.empty()) {
+        g_buffer_pool_rx_hdr->put_buffers_thread_safe(&m_rx_hdr_pool, m_rx_hdr_pool.size());
+    }
+
     if (m_p_cq_mgr_rx) {
         delete m_p_cq_mgr_rx;
         m_p_cq_mgr_rx = nullptr;
@@ -99,6 +121,8 @@ bool hw_queue_rx::configure_rq(ibv_comp_channel *rx_comp_event_channel)
     if (safe_mce_sys().enable_striding_rq) {
         m_rx_sge = 2U; // Striding-RQ needs a reserved segment.
         m_strq_wqe_reserved_seg = 1U;
+    } else if (m_rx_hdr_size) {
+        m_rx_sge = 2U; // Header buffer followed by the RX buffer.
     }
 
     m_ibv_rx_wr_array = new ibv_recv_wr[m_n_sysvar_rx_num_wr_to_post_recv];
@@ -161,6 +185,15 @@ void hw_queue_rx::release_rx_buffers()
     int total_ret = m_curr_rx_wr;
     if (m_curr_rx_wr) {
         hwqrx_logdbg("Returning %d pending post_recv buffers to CQ owner", m_curr_rx_wr);
+        if (m_rq_wqe_idx_to_hdr) {
+            for (uint32_t i = 1U; i <= m_curr_rx_wr; ++i) {
+                uint32_t index = (m_rq_wqe_counter - i) & (m_rx_num_wr - 1);
+                if (m_rq_wqe_idx_to_hdr[index]) {
+                    return_rx_hdr_buffer(m_rq_wqe_idx_to_hdr[index]);
+                    m_rq_wqe_idx_to_hdr[index] = nullptr;
+                }
+            }
+        }
         while (m_curr_rx_wr) {
             // Cleaning unposted buffers. Unposted buffers are not attached to any strides.
             --m_curr_rx_wr;
@@ -263,13 +296,54 @@ rfs_rule *hw_queue_rx::create_rfs_rule(dpcp::match_params &match_value,
 void hw_queue_rx::post_recv_buffer(mem_buf_desc_t *p_mem_buf_desc)
 {
     uint32_t index = (m_curr_rx_wr * m_rx_sge) + m_strq_wqe_reserved_seg;
-    m_ibv_rx_sg_array[index].addr = (uintptr_t)p_mem_buf_desc->p_buffer;
-    m_ibv_rx_sg_array[index].length = p_mem_buf_desc->sz_buffer;
+    uint32_t offset = 0U;
+
+    if (unlikely(m_rx_hdr_size)) {
+        mem_buf_desc_t *hdr = get_rx_hdr_buffer();
+        m_rq_wqe_idx_to_hdr[m_rq_wqe_counter & (m_rx_num_wr - 1)] = hdr;
+        // Without a header buffer the zero length SGE is skipped by xlio_raw_post_recv().
+        m_ibv_rx_sg_array[index].length = 0U;
+        if (likely(hdr)) {
+            m_ibv_rx_sg_array[index].addr = (uintptr_t)hdr->p_buffer;
+            m_ibv_rx_sg_array[index].length = m_rx_hdr_size;
+            m_ibv_rx_sg_array[index].lkey = hdr->lkey;
+            // The header is copied in front of the payload if the packet doesn't fit.
+            offset = m_rx_hdr_size;
+        }
+        ++index;
+    }
+
+    m_ibv_rx_sg_array[index].addr = (uintptr_t)p_mem_buf_desc->p_buffer + offset;
+    m_ibv_rx_sg_array[index].length = p_mem_buf_desc->sz_buffer - offset;
     m_ibv_rx_sg_array[index].lkey = p_mem_buf_desc->lkey;
 
     post_recv_buffer_rq(p_mem_buf_desc);
 }
 
+mem_buf_desc_t *hw_queue_rx::get_rx_hdr_buffer()
+{
+    if (unlikely(m_rx_hdr_pool.empty())) {
+        if (!g_buffer_pool_rx_hdr->get_buffers_thread_safe(m_rx_hdr_pool, m_p_ring,
+                                                           m_n_sysvar_rx_num_wr_to_post_recv,
+                                                           m_rx_hdr_lkey)) {
+            return nullptr;
+        }
+    }
+
+    mem_buf_desc_t *hdr = m_rx_hdr_pool.get_and_pop_front();
+    hdr->m_flags |= mem_buf_desc_t::RX_HDR;
+    return hdr;
+}
+
+void hw_queue_rx::return_rx_hdr_buffer(mem_buf_desc_t *p_mem_buf_desc)
+{
+    m_rx_hdr_pool.push_back(p_mem_buf_desc);
+    if (unlikely(m_rx_hdr_pool.size() > m_n_sysvar_rx_num_wr_to_post_recv * 2U)) {
+        g_buffer_pool_rx_hdr->put_buffers_thread_safe(&m_rx_hdr_pool,
+                                                      m_n_sysvar_rx_num_wr_to_post_recv);
+    }
+}
+
 void hw_queue_rx::post_recv_buffer_rq(mem_buf_desc_t *p_mem_buf_desc)
 {
     if (m_n_sysvar_rx_prefetch_bytes_before_poll) {
@@ -389,6 +463,10 @@ bool hw_queue_rx::init_rx_cq_mgr_prepare()
         return false;
     }
 
+    if (m_rx_hdr_size) {
+        m_rq_wqe_idx_to_hdr = new mem_buf_desc_t *[m_rx_num_wr]();
+    }
+
     return true;
 }
 
@@ -399,10 +477,8 @@ cq_mgr_rx *hw_queue_rx::init_rx_cq_mgr(struct ibv_comp_channel *p_rx_comp_event_
     }
 
     if (safe_mce_sys().enable_striding_rq) {
-        return new cq_mgr_rx_strq(m_p_ring, m_p_ib_ctx_handler,
-                                  safe_mce_sys().strq_stride_num_per_rwqe * m_rx_num_wr,
-                                  safe_mce_sys().strq_stride_size_bytes,
-                                  safe_mce_sys().strq_stride_num_per_rwqe, p_rx_comp_event_channel);
+        return new cq_mgr_rx_strq(m_p_ring, m_p_ib_ctx_handler, m_strq_strides_num * m_rx_num_wr,
+                                  m_strq_stride_size, m_strq_strides_num, p_rx_comp_event_channel);
     }
 
     return new cq_mgr_rx_regrq(m_p_ring, m_p_ib_ctx_handler, m_rx_num_wr, p_rx_comp_event_channel);
@@ -475,9 +551,9 @@ dpcp::tir *hw_queue_rx::create_tir(bool is_tls /*=false*/)
     tir_attr.inline_rqn = m_rq_data.rqn;
     tir_attr.transport_domain = m_p_ib_ctx_handler->get_dpcp_adapter()->get_td();
 
-    if (m_p_ring->m_lro.cap && m_p_ring->m_lro.max_payload_sz) {
+    if (m_p_ring->is_lro()) {
         tir_attr.flags |= dpcp::TIR_ATTR_LRO;
-        tir_attr.lro.timeout_period_usecs = XLIO_MLX5_PARAMS_LRO_TIMEOUT;
+        tir_attr.lro.timeout_period_usecs = m_p_ring->m_lro.timeout_period;
         tir_attr.lro.enable_mask = 3; // Bitmask for IPv4 and IPv6 support
         tir_attr.lro.max_msg_sz = m_p_ring->m_lro.max_payload_sz >> 8;
     }
@@ -525,8 +601,8 @@ bool hw_queue_rx::prepare_rq(uint32_t cqn)
     dpcp::status rc = dpcp::DPCP_OK;
 
     if (safe_mce_sys().enable_striding_rq) {
-        rqattrs.buf_stride_sz = safe_mce_sys().strq_stride_size_bytes;
-        rqattrs.buf_stride_num = safe_mce_sys().strq_stride_num_per_rwqe;
+        rqattrs.buf_stride_sz = m_strq_stride_size;
+        rqattrs.buf_stride_num = m_strq_strides_num;
 
         // Striding-RQ WQE format is as of Shared-RQ (PRM, page 381, wq_type).
         // In this case the WQE minimum size is 2 * 16, and the first segment is reserved.
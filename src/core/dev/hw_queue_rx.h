@@ -61,6 +61,8 @@ private:
 
     bool init_rx_cq_mgr_prepare();
     void post_recv_buffer_rq(mem_buf_desc_t *p_mem_buf_desc);
+    mem_buf_desc_t *get_rx_hdr_buffer();
+    void return_rx_hdr_buffer(mem_buf_desc_t *p_mem_buf_desc);
     void put_tls_tir_in_cache(xlio_tir *tir);
     bool prepare_rq(uint32_t cqn);
     bool configure_rq(ibv_comp_channel *rx_comp_event_channel);
@@ -94,12 +96,18 @@ private:
                                            // this WR_ID is received
     mem_buf_desc_t *m_p_prev_rx_desc_pushed = nullptr;
     uint64_t *m_rq_wqe_idx_to_wrid = nullptr;
+    mem_buf_desc_t **m_rq_wqe_idx_to_hdr = nullptr; // Header buffers, if header split is on
+    descq_t m_rx_hdr_pool;
     uint64_t m_rq_wqe_counter = 0U;
     uint32_t m_curr_rx_wr = 0U;
     uint32_t m_strq_wqe_reserved_seg = 0U;
+    uint32_t m_strq_stride_size = 0U;
+    uint32_t m_strq_strides_num = 0U;
     uint32_t m_n_sysvar_rx_num_wr_to_post_recv;
     uint32_t m_rx_num_wr;
     uint32_t m_rx_sge = 1U;
+    uint32_t m_rx_hdr_size = 0U;
+    uint32_t m_rx_hdr_lkey = 0U;
     const uint32_t m_n_sysvar_rx_prefetch_bytes_before_poll;
     uint16_t m_vlan;
 };
@@ -10,8 +10,10 @@
 #include "dev/hw_queue_tx.h"
 #include "dev/ring_simple.h"
 #include "dev/cq_mgr_rx_regrq.h"
+#include "dev/tls_dek_pool.h"
 #include "proto/tls.h"
 #include "util/valgrind.h"
+#include "util/instrumentation.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "hw_queue_tx"
@@ -96,6 +98,7 @@ hw_queue_tx::hw_queue_tx(ring_simple *ring, const slave_data_t *slave, const uin
     , m_p_ib_ctx_handler(slave->p_ib_ctx)
     , m_n_sysvar_tx_num_wr_to_signal(safe_mce_sys().tx_num_wr_to_signal)
     , m_tx_num_wr(tx_num_wr)
+    , m_p_ring_stat(ring->m_p_ring_stat.get())
     , m_port_num(slave->port_num)
 {
     hwqtx_logfunc("");
@@ -240,6 +243,17 @@ int hw_queue_tx::configure(const slave_data_t *slave)
                  m_mlx5_qp.cap.max_send_wr, m_mlx5_qp.cap.max_send_sge,
                  m_mlx5_qp.cap.max_inline_data);
 
+    if (safe_mce_sys().enable_mpwqe && safe_mce_sys().mpwqe_max_pkt_size) {
+        struct mlx5dv_context dv_attr;
+
+        memset(&dv_attr, 0, sizeof(dv_attr));
+        if (!mlx5dv_query_device(m_p_ib_ctx_handler->get_ibv_context(), &dv_attr) &&
+            (dv_attr.flags & MLX5DV_CONTEXT_FLAGS_ENHANCED_MPW)) {
+            m_mpwqe_max_pkt_size = safe_mce_sys().mpwqe_max_pkt_size;
+        }
+        hwqtx_logdbg("Enhanced MPWQE: %s", m_mpwqe_max_pkt_size ? "enabled" : "disabled");
+    }
+
 #if defined(DEFINED_ROCE_LAG)
     if (slave && slave->lag_tx_port_affinity > 0) {
         struct mlx5dv_context attr_out;
@@ -280,10 +294,15 @@ void hw_queue_tx::up()
     modify_queue_to_ready_state();
 
     init_device_memory();
+    select_send_to_wire();
 }
 
 void hw_queue_tx::down()
 {
+    // Post the deferred WQEs, so their buffers are released with the flushed completions.
+    m_b_db_deferred = false;
+    flush_doorbell(false);
+
     if (m_dm_enabled) {
         m_dm_mgr.release_resources();
     }
@@ -325,13 +344,18 @@ void hw_queue_tx::send_wqe(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr
      *   signal for such work requests.
      * - First call of send() should do completion. It means that
      *   m_n_unsignaled_count must be zero for this time.
+     * - TX_TIMESTAMP packets need their own CQE, it carries the HW timestamp.
      */
-    const bool request_comp = (p_mem_buf_desc->m_flags & mem_buf_desc_t::ZCOPY);
+    const bool request_comp =
+        (p_mem_buf_desc->m_flags & (mem_buf_desc_t::ZCOPY | mem_buf_desc_t::TX_TIMESTAMP));
     const bool skip_tx_poll = (attr & XLIO_TX_SKIP_POLL);
 
     hwqtx_logfunc("VERBS send, unsignaled_count: %d", m_n_unsignaled_count);
 
     send_to_wire(p_send_wqe, attr, request_comp, tis, credits);
+    if (unlikely(p_mem_buf_desc->m_flags & mem_buf_desc_t::TX_TIMESTAMP)) {
+        ++m_tx_ts_inflight;
+    }
 
     if (!skip_tx_poll && is_signal_requested_for_last_wqe()) {
         uint64_t dummy_poll_sn = 0;
@@ -423,6 +447,16 @@ void hw_queue_tx::init_queue()
     m_sq_free_credits = std::min(m_tx_num_wr, old_wr_val);
     hwqtx_logdbg("SQ total credits: %u", m_sq_free_credits);
 
+    m_bf_burst = 0U;
+    if (safe_mce_sys().tx_bf_burst && m_mlx5_qp.bf.size &&
+        is_bf(m_p_ib_ctx_handler->get_ibv_context())) {
+        m_bf_burst = safe_mce_sys().tx_bf_burst;
+        // The SQ is considered idle while it holds no more than a burst of the largest BF WQEs
+        m_bf_max_inflight = m_bf_burst * (m_mlx5_qp.bf.size / WQEBB);
+        hwqtx_logdbg("BlueFlame burst: %u WQEs, buffer size: %u", m_bf_burst,
+                     m_mlx5_qp.bf.size);
+    }
+
     /* Maximum BF inlining consists of:
      * - CTRL:
      *   - 1st WQEBB is mostly used for CTRL and ETH segment (where ETH header is inlined)
@@ -445,6 +479,10 @@ void hw_queue_tx::init_queue()
         m_last_sq_wqe_prop_to_complete = m_sq_wqe_idx_to_prop;
         m_sq_wqe_prop_last = nullptr;
     }
+    if (m_mpwqe_max_pkt_size && m_mpwqe_bufs.empty()) {
+        // Every packet takes at least one credit, so the SQ size bounds the in-flight packets.
+        m_mpwqe_bufs.resize(m_tx_num_wr);
+    }
 
     hwqtx_logfunc("m_tx_num_wr=%d max_inline_data: %d m_sq_wqe_idx_to_prop=%p", m_tx_num_wr,
                   get_max_inline_data(), m_sq_wqe_idx_to_prop);
@@ -474,9 +512,106 @@ cq_mgr_tx *hw_queue_tx::init_tx_cq_mgr()
                          m_p_ring->get_tx_comp_event_channel());
 }
 
+inline bool hw_queue_tx::is_bf_burst(unsigned num) const
+{
+    /* A busy SQ is fetched by the HW anyway, so the BlueFlame copy would only cost CPU time.
+     * The credits of the WQEs being rung are already taken, so they are counted in flight.
+     */
+    uint32_t in_flight = m_tx_num_wr - std::min<uint32_t>(m_sq_free_credits, m_tx_num_wr);
+
+    return num <= m_bf_burst && in_flight <= m_bf_max_inflight;
+}
+
+inline unsigned hw_queue_tx::bf_burst_copy(struct xlio_mlx5_wqe_ctrl_seg *ctrl, unsigned num)
+{
+    uint8_t *sq_start = reinterpret_cast<uint8_t *>(m_mlx5_qp.sq.buf);
+    unsigned i;
+
+    for (i = 0; i < num; ++i) {
+        uint8_t *wqe = reinterpret_cast<uint8_t *>(ctrl);
+        uint32_t index = (ntohl(ctrl->opmod_idx_opcode) >> 8U) & (m_tx_num_wr - 1U);
+        uint32_t size =
+            align_to_WQEBB_up(ntohl(ctrl->qpn_ds) & MLX5_WQE_CTRL_DS_MASK) * MLX5_SEND_WQE_DS;
+
+        // A WQE which wraps or doesn't fit the BF buffer is left to the regular doorbell
+        if (unlikely(!size || size > m_mlx5_qp.bf.size || wqe + size > m_sq_wqes_end ||
+                     index != static_cast<uint32_t>(wqe - sq_start) / WQEBB)) {
+            break;
+        }
+
+        volatile uint64_t *dst =
+            reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(m_mlx5_qp.bf.reg) +
+                                         m_bf_offset);
+        const uint64_t *src = reinterpret_cast<const uint64_t *>(wqe);
+        for (uint32_t n = 0; n < size / sizeof(uint64_t); ++n) {
+            dst[n] = src[n];
+        }
+        // Each BF write must leave the WC buffers before the next one starts
+        wc_wmb();
+        m_bf_offset ^= m_mlx5_qp.bf.size;
+
+        wqe += size;
+        ctrl = reinterpret_cast<struct xlio_mlx5_wqe_ctrl_seg *>(wqe < m_sq_wqes_end ? wqe
+                                                                                     : sq_start);
+    }
+    m_p_ring_stat->n_tx_bf_wqes += i;
+    return i;
+}
+
+inline void hw_queue_tx::write_doorbell(struct xlio_mlx5_wqe_ctrl_seg *first, unsigned num,
+                                        struct xlio_mlx5_wqe_ctrl_seg *last)
+{
+    XLIO_TRACE(ring_doorbell, this, m_sq_wqe_counter);
+    XLIO_TRACE_RING(TRACE_EVENT_DOORBELL, this, m_sq_wqe_counter);
+    ++m_p_ring_stat->n_tx_doorbells;
+    // Make sure that descriptors are written before
+    // updating doorbell record and ringing the doorbell
+    wmb();
+    *m_mlx5_qp.sq.dbrec = htonl(m_sq_wqe_counter);
+
+    // This wc_wmb ensures ordering between DB record and BF copy
+    wc_wmb();
+
+    /* The HW takes a single WQE per BlueFlame write, so a burst is a sequence of writes after
+     * the DB record update. If a WQE can't be copied, the regular doorbell of the last WQE
+     * makes the HW fetch the rest.
+     */
+    if (m_bf_burst && is_bf_burst(num) && likely(bf_burst_copy(first, num) == num)) {
+        return;
+    }
+
+    uint64_t *dst = reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(m_mlx5_qp.bf.reg) +
+                                                 m_bf_offset);
+    *dst = *reinterpret_cast<uint64_t *>(last);
+
+    /* Use wc_wmb() to ensure write combining buffers are flushed out
+     * of the running CPU.
+     * sfence instruction affects only the WC buffers of the CPU that executes it
+     */
+    wc_wmb();
+    if (m_bf_burst) {
+        m_bf_offset ^= m_mlx5_qp.bf.size;
+    }
+}
+
+uint32_t hw_queue_tx::calc_signal_interval() const
+{
+    /* XLIO_TX_WRE_BATCHING is the upper bound. A shallow SQ means low rate, so signal
+     * sooner to reclaim buffers before the socket sndbuf looks full. A deep SQ keeps
+     * enough WQEs outstanding to use the full batch and save TX CQEs.
+     */
+    uint32_t in_flight = m_tx_num_wr - std::min<uint32_t>(m_sq_free_credits, m_tx_num_wr);
+    uint32_t interval = std::min(std::max(in_flight / 4U, 1U), m_n_sysvar_tx_num_wr_to_signal);
+
+    // The ring is running out of TX buffers, return the in-flight ones sooner.
+    if (unlikely(m_p_ring->m_tx_pool.size() < m_n_sysvar_tx_num_wr_to_signal)) {
+        interval = std::max(interval / 2U, 1U);
+    }
+    return interval;
+}
+
 inline void hw_queue_tx::ring_doorbell(uint8_t num_wqebb, bool skip_comp /*=false*/)
 {
-    uint64_t *dst = (uint64_t *)m_mlx5_qp.bf.reg;
     uint64_t *src = reinterpret_cast<uint64_t *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *ctrl = reinterpret_cast<struct xlio_mlx5_wqe_ctrl_seg *>(src);
 
@@ -486,7 +621,9 @@ inline void hw_queue_tx::ring_doorbell(uint8_t num_wqebb, bool skip_comp /*=fals
     if (!skip_comp && is_completion_need()) {
         ctrl->fm_ce_se |= MLX5_WQE_CTRL_CQ_UPDATE;
     }
+    ++m_p_ring_stat->n_tx_wqes;
     if (ctrl->fm_ce_se & MLX5_WQE_CTRL_CQ_UPDATE) {
+        ++m_p_ring_stat->n_tx_wqes_signaled;
         set_unsignaled_count();
     } else {
         dec_unsignaled_count();
@@ -498,20 +635,37 @@ inline void hw_queue_tx::ring_doorbell(uint8_t num_wqebb, bool skip_comp /*=fals
 
     m_sq_wqe_counter = (m_sq_wqe_counter + num_wqebb) & 0xFFFF;
 
-    // Make sure that descriptors are written before
-    // updating doorbell record and ringing the doorbell
-    wmb();
-    *m_mlx5_qp.sq.dbrec = htonl(m_sq_wqe_counter);
+    if (m_b_db_deferred) {
+        // The doorbell record covers all the WQEs, so ringing with the last one is enough.
+        if (!m_db_deferred_num) {
+            m_db_deferred_first = ctrl;
+        }
+        m_db_deferred_ctrl = ctrl;
+        ++m_db_deferred_num;
+        return;
+    }
+    write_doorbell(ctrl, 1U, ctrl);
+}
 
-    // This wc_wmb ensures ordering between DB record and BF copy
-    wc_wmb();
-    *dst = *src;
+unsigned hw_queue_tx::flush_doorbell(bool request_comp)
+{
+    mpwqe_close();
 
-    /* Use wc_wmb() to ensure write combining buffers are flushed out
-     * of the running CPU.
-     * sfence instruction affects only the WC buffers of the CPU that executes it
-     */
-    wc_wmb();
+    unsigned num = m_db_deferred_num;
+
+    if (num) {
+        // The WQE is not rung yet, so it's safe to update the control segment.
+        if (request_comp && !(m_db_deferred_ctrl->fm_ce_se & MLX5_WQE_CTRL_CQ_UPDATE)) {
+            m_db_deferred_ctrl->fm_ce_se |= MLX5_WQE_CTRL_CQ_UPDATE;
+            ++m_p_ring_stat->n_tx_wqes_signaled;
+            set_unsignaled_count();
+        }
+        write_doorbell(m_db_deferred_first, num, m_db_deferred_ctrl);
+        m_db_deferred_first = nullptr;
+        m_db_deferred_ctrl = nullptr;
+        m_db_deferred_num = 0U;
+    }
+    return num;
 }
 
 inline int hw_queue_tx::fill_inl_segment(sg_array &sga, uint8_t *cur_seg, uint8_t *data_addr,
@@ -532,7 +686,7 @@ inline int hw_queue_tx::fill_inl_segment(sg_array &sga, uint8_t *cur_seg, uint8_
 }
 
 //! Fill WQE dynamically, based on amount of free WQEBB in SQ
-inline uint8_t hw_queue_tx::fill_wqe(xlio_ibv_send_wr *pswr)
+template <bool DM> inline uint8_t hw_queue_tx::fill_wqe(xlio_ibv_send_wr *pswr)
 {
     // control segment is mostly filled by preset after previous packet
     // we always inline ETH header
@@ -630,7 +784,7 @@ inline uint8_t hw_queue_tx::fill_wqe(xlio_ibv_send_wr *pswr)
         // Data is bigger than max to inline we inlined only ETH header + uint from IP (18
         // bytes) the rest will be in data pointer segment adding data seg with pointer if there
         // still data to transfer
-        wqe_size = fill_wqe_send(pswr);
+        wqe_size = fill_wqe_send<DM>(pswr);
     } else {
         // Support XLIO_IBV_WR_SEND_TSO operation
         wqe_size = fill_wqe_lso(pswr, data_len);
@@ -643,7 +797,7 @@ inline uint8_t hw_queue_tx::fill_wqe(xlio_ibv_send_wr *pswr)
     return wqebbs;
 }
 
-inline int hw_queue_tx::fill_wqe_send(xlio_ibv_send_wr *pswr)
+template <bool DM> inline int hw_queue_tx::fill_wqe_send(xlio_ibv_send_wr *pswr)
 {
     struct mlx5_wqe_eth_seg *eseg;
     struct mlx5_wqe_data_seg *dseg;
@@ -667,7 +821,7 @@ inline int hw_queue_tx::fill_wqe_send(xlio_ibv_send_wr *pswr)
         if (likely(pswr->sg_list[i].length)) {
             dseg->byte_count = htonl(pswr->sg_list[i].length);
             /* Try to copy data to On Device Memory in first */
-            if (!(m_dm_enabled &&
+            if (!(DM &&
                   m_dm_mgr.copy_data(dseg, (uint8_t *)((uintptr_t)pswr->sg_list[i].addr),
                                      pswr->sg_list[i].length, (mem_buf_desc_t *)pswr->wr_id))) {
                 dseg->lkey = htonl(pswr->sg_list[i].lkey);
@@ -753,13 +907,33 @@ inline int hw_queue_tx::fill_wqe_lso(xlio_ibv_send_wr *pswr, int data_len)
     return wqe_size;
 }
 
+void hw_queue_tx::select_send_to_wire()
+{
+    if (m_dm_enabled) {
+        m_send_to_wire[0] = &hw_queue_tx::send_to_wire_tmpl<true, false>;
+        m_send_to_wire[1] = &hw_queue_tx::send_to_wire_tmpl<true, true>;
+    } else {
+        m_send_to_wire[0] = &hw_queue_tx::send_to_wire_tmpl<false, false>;
+        m_send_to_wire[1] = &hw_queue_tx::send_to_wire_tmpl<false, true>;
+    }
+}
+
 //! Send one RAW packet
-void hw_queue_tx::send_to_wire(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
-                               bool request_comp, xlio_tis *tis, unsigned credits)
+template <bool DM, bool TIS>
+void hw_queue_tx::send_to_wire_tmpl(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                                    bool request_comp, xlio_tis *tis, unsigned credits)
 {
     struct xlio_mlx5_wqe_ctrl_seg *ctrl = nullptr;
     struct mlx5_wqe_eth_seg *eseg = nullptr;
-    uint32_t tisn = tis ? tis->get_tisn() : 0;
+    uint32_t tisn = TIS ? tis->get_tisn() : 0;
+
+    XLIO_TRACE(send_to_wire, this, attr, p_send_wqe->num_sge,
+               p_send_wqe->num_sge ? p_send_wqe->sg_list[0].length : 0U);
+    if (!TIS && is_mpwqe_eligible(p_send_wqe, request_comp, nullptr)) {
+        mpwqe_add(p_send_wqe, attr, credits);
+        return;
+    }
+    mpwqe_close();
 
     ctrl = (struct xlio_mlx5_wqe_ctrl_seg *)m_sq_wqe_hot;
     eseg = (struct mlx5_wqe_eth_seg *)((uint8_t *)m_sq_wqe_hot + sizeof(*ctrl));
@@ -783,8 +957,8 @@ void hw_queue_tx::send_to_wire(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_a
     eseg->rsvd2 = 0;
     eseg->cs_flags = (uint8_t)(attr & (XLIO_TX_PACKET_L3_CSUM | XLIO_TX_PACKET_L4_CSUM) & 0xff);
 
-    submit_wqe(reinterpret_cast<mem_buf_desc_t *>(p_send_wqe->wr_id), credits, fill_wqe(p_send_wqe),
-               tis, false);
+    submit_wqe(reinterpret_cast<mem_buf_desc_t *>(p_send_wqe->wr_id), credits,
+               fill_wqe<DM>(p_send_wqe), tis, false);
 }
 
 inline void hw_queue_tx::submit_wqe(mem_buf_desc_t *buf, unsigned credits, uint8_t wqebbs,
@@ -795,6 +969,7 @@ inline void hw_queue_tx::submit_wqe(mem_buf_desc_t *buf, unsigned credits, uint8
         .buf = buf,
         .credits = credits,
         .wqebbs = wqebbs,
+        .mpwqe_bufs = 0U,
         .ti = ti,
         .next = m_sq_wqe_prop_last,
     };
@@ -818,6 +993,90 @@ inline void hw_queue_tx::submit_wqe(mem_buf_desc_t *buf, unsigned credits, uint8
         buf);
 }
 
+inline bool hw_queue_tx::is_mpwqe_eligible(xlio_ibv_send_wr *p_send_wqe, bool request_comp,
+                                           xlio_tis *tis)
+{
+    /* Packing makes sense only when the packets are not rung one by one. Each packet must be
+     * described with a single data segment, and packets which require a completion or a TIS
+     * are sent with a regular WQE.
+     */
+    return m_b_db_deferred && m_mpwqe_max_pkt_size && !request_comp && !tis &&
+        p_send_wqe->num_sge == 1 && xlio_send_wr_opcode(*p_send_wqe) == XLIO_IBV_WR_SEND &&
+        p_send_wqe->sg_list[0].length <= m_mpwqe_max_pkt_size;
+}
+
+inline void hw_queue_tx::mpwqe_add(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                                   unsigned credits)
+{
+    mem_buf_desc_t *buf = reinterpret_cast<mem_buf_desc_t *>(p_send_wqe->wr_id);
+    uint8_t cs_flags = (uint8_t)(attr & (XLIO_TX_PACKET_L3_CSUM | XLIO_TX_PACKET_L4_CSUM) & 0xff);
+
+    // The eth segment and so the checksum offload flags are shared by the session packets.
+    if (m_mpwqe_ds &&
+        (m_mpwqe_cs_flags != cs_flags || m_mpwqe_pkts >= XLIO_MLX5_PARAMS_MPWQE_MAX_PKTS)) {
+        mpwqe_submit();
+    }
+
+    if (!m_mpwqe_ds) {
+        struct xlio_mlx5_wqe_ctrl_seg *ctrl = &m_sq_wqe_hot->ctrl.ctrl;
+
+        memset(m_sq_wqe_hot, 0, sizeof(struct mlx5_wqe_ctrl_seg) + OCTOWORD);
+        ctrl->opmod_idx_opcode =
+            htonl(((m_sq_wqe_counter & 0xffff) << 8) | XLIO_MLX5_OPCODE_ENHANCED_MPSW);
+        m_sq_wqe_hot->eseg.cs_flags = cs_flags;
+
+        // No inline header, so the eth segment takes a single octoword.
+        m_mpwqe_dseg = reinterpret_cast<struct mlx5_wqe_data_seg *>(
+            (uint8_t *)m_sq_wqe_hot + sizeof(struct mlx5_wqe_ctrl_seg) + OCTOWORD);
+        m_mpwqe_ds = 2U;
+        m_mpwqe_cs_flags = cs_flags;
+        m_mpwqe_buf = buf;
+    } else {
+        m_mpwqe_bufs[m_mpwqe_bufs_head++ & (m_mpwqe_bufs.size() - 1)] = buf;
+    }
+
+    if (unlikely((uintptr_t)m_mpwqe_dseg >= (uintptr_t)m_sq_wqes_end)) {
+        m_mpwqe_dseg = reinterpret_cast<struct mlx5_wqe_data_seg *>(m_sq_wqes);
+    }
+    m_mpwqe_dseg->byte_count = htonl(p_send_wqe->sg_list[0].length);
+    m_mpwqe_dseg->lkey = htonl(p_send_wqe->sg_list[0].lkey);
+    m_mpwqe_dseg->addr = htonll((uintptr_t)p_send_wqe->sg_list[0].addr);
+    ++m_mpwqe_dseg;
+
+    ++m_mpwqe_ds;
+    ++m_mpwqe_pkts;
+    // Each packet reserved at least one WQEBB, which is more than its data segment takes.
+    m_mpwqe_credits += credits;
+}
+
+void hw_queue_tx::mpwqe_submit()
+{
+    uint8_t wqebbs = static_cast<uint8_t>(align_to_WQEBB_up(m_mpwqe_ds) / 4);
+    uint16_t extra_bufs = m_mpwqe_pkts - 1U;
+
+    m_sq_wqe_hot->ctrl.data[1] = htonl((m_mlx5_qp.qpn << 8) | m_mpwqe_ds);
+    submit_wqe(m_mpwqe_buf, m_mpwqe_credits, wqebbs, nullptr, false);
+    m_sq_wqe_prop_last->mpwqe_bufs = extra_bufs;
+    ++m_p_ring_stat->n_tx_mpwqe_sessions;
+    m_p_ring_stat->n_tx_mpwqe_pkts += m_mpwqe_pkts;
+
+    hwqtx_logfunc("MPWQE posted: packets=%u ds=%u wqebbs=%u", m_mpwqe_pkts, m_mpwqe_ds, wqebbs);
+
+    m_mpwqe_ds = 0U;
+    m_mpwqe_pkts = 0U;
+    m_mpwqe_credits = 0U;
+    m_mpwqe_buf = nullptr;
+    m_mpwqe_dseg = nullptr;
+}
+
+void hw_queue_tx::mpwqe_release_bufs(unsigned nr)
+{
+    while (nr--) {
+        m_p_ring->mem_buf_desc_return_single_locked(
+            m_mpwqe_bufs[m_mpwqe_bufs_tail++ & (m_mpwqe_bufs.size() - 1)]);
+    }
+}
+
 std::unique_ptr<xlio_tis> hw_queue_tx::create_tis(uint32_t flags)
 {
     dpcp::adapter *adapter = m_p_ib_ctx_handler->get_dpcp_adapter();
@@ -845,82 +1104,40 @@ std::unique_ptr<xlio_tis> hw_queue_tx::create_tis(uint32_t flags)
 }
 
 #if defined(DEFINED_UTLS)
-std::unique_ptr<dpcp::tls_dek> hw_queue_tx::get_new_tls_dek(const void *key,
-                                                            uint32_t key_size_bytes)
-{
-    dpcp::tls_dek *_dek = nullptr;
-    dpcp::adapter *adapter = m_p_ib_ctx_handler->get_dpcp_adapter();
-    if (likely(adapter)) {
-        dpcp::status status;
-        struct dpcp::dek_attr dek_attr;
-        memset(&dek_attr, 0, sizeof(dek_attr));
-        dek_attr.key_blob = (void *)key;
-        dek_attr.key_blob_size = key_size_bytes;
-        dek_attr.key_size = key_size_bytes;
-        dek_attr.pd_id = adapter->get_pd();
-        status = adapter->create_tls_dek(dek_attr, _dek);
-        if (unlikely(status != dpcp::DPCP_OK)) {
-            hwqtx_logwarn("Failed to create new DEK, status: %d", status);
-            if (_dek) {
-                delete _dek;
-                _dek = nullptr;
-            }
-        }
-    }
-
-    return std::unique_ptr<dpcp::tls_dek>(_dek);
-}
-
 std::unique_ptr<dpcp::tls_dek> hw_queue_tx::get_tls_dek(const void *key, uint32_t key_size_bytes)
 {
-    dpcp::status status;
+    dpcp::tls_dek *_dek = nullptr;
     dpcp::adapter *adapter = m_p_ib_ctx_handler->get_dpcp_adapter();
 
     if (unlikely(!adapter)) {
         return std::unique_ptr<dpcp::tls_dek>(nullptr);
     }
 
-    // If the amount of available DEKs in m_dek_put_cache is smaller than
-    // low-watermark we continue to create new DEKs. This is to avoid situations
-    // where one DEKs is returned and then fetched in a throttlling manner
-    // causing too frequent crypto-sync.
-    // It is also possible that crypto-sync may have higher impact with higher number
-    // of active connections.
-    if (unlikely(!m_p_ring->tls_sync_dek_supported()) ||
-        (unlikely(m_tls_dek_get_cache.empty()) &&
-         (m_tls_dek_put_cache.size() <= safe_mce_sys().utls_low_wmark_dek_cache_size))) {
-        return get_new_tls_dek(key, key_size_bytes);
-    }
-
-    if (unlikely(m_tls_dek_get_cache.empty())) {
-        hwqtx_logdbg("Empty DEK get cache. Swapping caches and do Sync-Crypto. Put-Cache size: %zu",
-                     m_tls_dek_put_cache.size());
-
-        status = adapter->sync_crypto_tls();
-        if (unlikely(status != dpcp::DPCP_OK)) {
-            hwqtx_logwarn("Failed to flush DEK HW cache, status: %d", status);
-            return get_new_tls_dek(key, key_size_bytes);
+    // A DEK is reused only if the device can synchronize the DEKs
+    if (likely(m_p_ring->tls_sync_dek_supported())) {
+        if (unlikely(!m_p_tls_dek_pool)) {
+            m_p_tls_dek_pool = m_p_ib_ctx_handler->get_tls_dek_pool();
         }
-
-        m_tls_dek_get_cache.swap(m_tls_dek_put_cache);
+        return m_p_tls_dek_pool->get_dek(key, key_size_bytes);
     }
 
-    std::unique_ptr<dpcp::tls_dek> out_dek(std::move(m_tls_dek_get_cache.front()));
-    m_tls_dek_get_cache.pop_front();
-
+    dpcp::status status;
     struct dpcp::dek_attr dek_attr;
     memset(&dek_attr, 0, sizeof(dek_attr));
-    dek_attr.key_blob = const_cast<void *>(key);
+    dek_attr.key_blob = (void *)key;
     dek_attr.key_blob_size = key_size_bytes;
     dek_attr.key_size = key_size_bytes;
     dek_attr.pd_id = adapter->get_pd();
-    status = out_dek->modify(dek_attr);
+    status = adapter->create_tls_dek(dek_attr, _dek);
     if (unlikely(status != dpcp::DPCP_OK)) {
-        hwqtx_logwarn("Failed to modify DEK, status: %d", status);
-        out_dek.reset(nullptr);
+        hwqtx_logwarn("Failed to create new DEK, status: %d", status);
+        if (_dek) {
+            delete _dek;
+            _dek = nullptr;
+        }
     }
 
-    return out_dek;
+    return std::unique_ptr<dpcp::tls_dek>(_dek);
 }
 
 void hw_queue_tx::put_tls_dek(std::unique_ptr<dpcp::tls_dek> &&tls_dek_obj)
@@ -928,10 +1145,11 @@ void hw_queue_tx::put_tls_dek(std::unique_ptr<dpcp::tls_dek> &&tls_dek_obj)
     if (!tls_dek_obj) {
         return;
     }
-    // We don't allow unlimited DEK cache to avoid system DEK starvation.
-    if (likely(m_p_ring->tls_sync_dek_supported()) &&
-        m_tls_dek_put_cache.size() < safe_mce_sys().utls_high_wmark_dek_cache_size) {
-        m_tls_dek_put_cache.emplace_back(std::forward<std::unique_ptr<dpcp::tls_dek>>(tls_dek_obj));
+    if (likely(m_p_ring->tls_sync_dek_supported())) {
+        if (unlikely(!m_p_tls_dek_pool)) {
+            m_p_tls_dek_pool = m_p_ib_ctx_handler->get_tls_dek_pool();
+        }
+        m_p_tls_dek_pool->put_dek(std::forward<std::unique_ptr<dpcp::tls_dek>>(tls_dek_obj));
     }
 }
 
@@ -955,16 +1173,20 @@ xlio_tis *hw_queue_tx::tls_context_setup_tx(const xlio_tls_info *info)
     }
 
     tis->assign_dek(std::move(dek_obj));
+    assert(!tis->m_released);
+
+    /* The params are posted with the 1st record, see tls_context_post_tx(). */
+    return tis.release();
+}
+
+void hw_queue_tx::tls_context_post_tx(const xlio_tls_info *info, xlio_tis *tis)
+{
     uint32_t tisn = tis->get_tisn();
 
-    tls_post_static_params_wqe(tis.get(), info, tisn, tis->get_dek_id(), 0, false, true);
-    tls_post_progress_params_wqe(tis.get(), tisn, 0, false, true);
+    tls_post_static_params_wqe(tis, info, tisn, tis->get_dek_id(), 0, false, true);
+    tls_post_progress_params_wqe(tis, tisn, 0, false, true);
     /* The 1st post after TLS configuration must be with fence. */
     m_b_fence_needed = true;
-
-    assert(!tis->m_released);
-
-    return tis.release();
 }
 
 void hw_queue_tx::tls_context_resync_tx(const xlio_tls_info *info, xlio_tis *tis, bool skip_static)
@@ -1059,6 +1281,7 @@ inline void hw_queue_tx::tls_post_static_params_wqe(xlio_ti *ti, const struct xl
                                                     uint32_t tis_tir_number, uint32_t key_id,
                                                     uint32_t resync_tcp_sn, bool fence, bool is_tx)
 {
+    mpwqe_close();
     struct mlx5_set_tls_static_params_wqe *wqe =
         reinterpret_cast<struct mlx5_set_tls_static_params_wqe *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *cseg = &wqe->ctrl.ctrl;
@@ -1157,6 +1380,7 @@ inline void hw_queue_tx::tls_post_progress_params_wqe(xlio_ti *ti, uint32_t tis_
                                                       uint32_t next_record_tcp_sn, bool fence,
                                                       bool is_tx)
 {
+    mpwqe_close();
     struct mlx5_set_tls_progress_params_wqe *wqe =
         reinterpret_cast<struct mlx5_set_tls_progress_params_wqe *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *cseg = &wqe->ctrl.ctrl;
@@ -1184,6 +1408,7 @@ inline void hw_queue_tx::tls_post_progress_params_wqe(xlio_ti *ti, uint32_t tis_
 inline void hw_queue_tx::tls_get_progress_params_wqe(xlio_ti *ti, uint32_t tirn, void *buf,
                                                      uint32_t lkey)
 {
+    mpwqe_close();
     struct mlx5_get_tls_progress_params_wqe *wqe =
         reinterpret_cast<struct mlx5_get_tls_progress_params_wqe *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *cseg = &wqe->ctrl.ctrl;
@@ -1255,6 +1480,7 @@ void hw_queue_tx::destroy_tis_cache(void) {};
 
 void hw_queue_tx::post_nop_fence(void)
 {
+    mpwqe_close();
     struct mlx5_wqe *wqe = reinterpret_cast<struct mlx5_wqe *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *cseg = &wqe->ctrl;
 
@@ -1270,6 +1496,7 @@ void hw_queue_tx::post_nop_fence(void)
 void hw_queue_tx::post_dump_wqe(xlio_tis *tis, void *addr, uint32_t len, uint32_t lkey,
                                 bool is_first)
 {
+    mpwqe_close();
     struct mlx5_dump_wqe *wqe = reinterpret_cast<struct mlx5_dump_wqe *>(m_sq_wqe_hot);
     struct xlio_mlx5_wqe_ctrl_seg *cseg = &wqe->ctrl.ctrl;
     struct mlx5_wqe_data_seg *dseg = &wqe->data;
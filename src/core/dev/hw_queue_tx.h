@@ -23,6 +23,7 @@
 
 struct slave_data_t;
 struct xlio_tls_info;
+class tls_dek_pool;
 
 enum {
     SQ_CREDITS_UMR = 3U,
@@ -44,6 +45,8 @@ struct sq_wqe_prop {
     unsigned credits;
     /* Size of the WQE in WQEBBs. */
     uint8_t wqebbs;
+    /* Number of packets of a multi-packet WQE held in the MPWQE buffer queue besides buf. */
+    uint16_t mpwqe_bufs;
     /* Transport interface (TIS/TIR) current WQE holds reference to. */
     xlio_ti *ti;
     struct sq_wqe_prop *next;
@@ -81,6 +84,7 @@ public:
 
 #ifdef DEFINED_UTLS
     xlio_tis *tls_context_setup_tx(const xlio_tls_info *info);
+    void tls_context_post_tx(const xlio_tls_info *info, xlio_tis *tis);
     xlio_tir *tls_create_tir(bool cached);
     int tls_context_setup_rx(xlio_tir *tir, const xlio_tls_info *info, uint32_t next_record_tcp_sn,
                              xlio_comp_cb_t callback, void *callback_arg);
@@ -98,11 +102,16 @@ public:
     void post_dump_wqe(xlio_tis *tis, void *addr, uint32_t len, uint32_t lkey, bool first);
 
 #if defined(DEFINED_UTLS)
-    std::unique_ptr<dpcp::tls_dek> get_new_tls_dek(const void *key, uint32_t key_size_bytes);
     std::unique_ptr<dpcp::tls_dek> get_tls_dek(const void *key, uint32_t key_size_bytes);
     void put_tls_dek(std::unique_ptr<dpcp::tls_dek> &&dek_obj);
 #endif
 
+    /* Doorbell batching. In the deferred mode WQEs are posted to the SQ, but the doorbell is
+     * rung once by flush_doorbell() for all of them. Returns the number of posted WQEs.
+     */
+    void set_doorbell_deferred(bool deferred) { m_b_db_deferred = deferred; }
+    unsigned flush_doorbell(bool request_comp);
+
     void credits_return(unsigned credits) { m_sq_free_credits += credits; }
 
     bool credits_get(unsigned credits)
@@ -184,9 +193,23 @@ private:
     void put_tls_tis_in_cache(xlio_tis *tis);
 
     void send_to_wire(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr, bool request_comp,
-                      xlio_tis *tis, unsigned credits);
+                      xlio_tis *tis, unsigned credits)
+    {
+        (this->*m_send_to_wire[!!tis])(p_send_wqe, attr, request_comp, tis, credits);
+    }
+    // Specializations for the device memory state of the queue and the presence of a TIS
+    template <bool DM, bool TIS>
+    void send_to_wire_tmpl(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                           bool request_comp, xlio_tis *tis, unsigned credits);
+    void select_send_to_wire();
 
-    void set_unsignaled_count(void) { m_n_unsignaled_count = m_n_sysvar_tx_num_wr_to_signal - 1; }
+    uint32_t calc_signal_interval() const;
+
+    void set_unsignaled_count(void)
+    {
+        m_n_signal_interval = calc_signal_interval();
+        m_n_unsignaled_count = m_n_signal_interval - 1;
+    }
 
     bool is_completion_need() const
     {
@@ -195,7 +218,7 @@ private:
 
     bool is_signal_requested_for_last_wqe()
     {
-        return m_n_unsignaled_count == m_n_sysvar_tx_num_wr_to_signal - 1;
+        return m_n_unsignaled_count == m_n_signal_interval - 1;
     }
 
     void dec_unsignaled_count(void)
@@ -221,12 +244,32 @@ private:
 
     inline void submit_wqe(mem_buf_desc_t *buf, unsigned credits, uint8_t wqebbs, xlio_ti *ti,
                            bool skip_comp);
-    inline uint8_t fill_wqe(xlio_ibv_send_wr *p_send_wqe);
-    inline int fill_wqe_send(xlio_ibv_send_wr *pswr);
+    template <bool DM> inline uint8_t fill_wqe(xlio_ibv_send_wr *p_send_wqe);
+    template <bool DM> inline int fill_wqe_send(xlio_ibv_send_wr *pswr);
     inline int fill_wqe_lso(xlio_ibv_send_wr *pswr, int data_len);
     inline int fill_inl_segment(sg_array &sga, uint8_t *cur_seg, uint8_t *data_addr,
                                 int max_inline_len, int inline_len);
     inline void ring_doorbell(uint8_t num_wqebb, bool skip_comp = false);
+    inline void write_doorbell(struct xlio_mlx5_wqe_ctrl_seg *first, unsigned num,
+                               struct xlio_mlx5_wqe_ctrl_seg *last);
+    inline bool is_bf_burst(unsigned num) const;
+    inline unsigned bf_burst_copy(struct xlio_mlx5_wqe_ctrl_seg *ctrl, unsigned num);
+
+    /* Enhanced multi-packet WQE. While the doorbell is deferred, small packets are appended to
+     * an open MPWQE session in the hot WQE as pointer data segments. The session is posted when
+     * it's full, before any other WQE and by flush_doorbell().
+     */
+    inline bool is_mpwqe_eligible(xlio_ibv_send_wr *p_send_wqe, bool request_comp, xlio_tis *tis);
+    inline void mpwqe_add(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                          unsigned credits);
+    inline void mpwqe_close()
+    {
+        if (unlikely(m_mpwqe_ds)) {
+            mpwqe_submit();
+        }
+    }
+    void mpwqe_submit();
+    void mpwqe_release_bufs(unsigned nr);
 
     struct xlio_rate_limit_t m_rate_limit;
     xlio_ib_mlx5_qp_t m_mlx5_qp;
@@ -257,19 +300,55 @@ private:
     uint32_t m_tx_num_wr;
     unsigned m_sq_free_credits = 0U;
     uint32_t m_n_unsignaled_count = 0U;
+    uint32_t m_n_signal_interval = 1U; // Current number of WQEs per completion signal
+    ring_stats_t *m_p_ring_stat;
     int m_sq_wqe_hot_index = 0;
     uint16_t m_sq_wqe_counter = 0U;
     uint8_t m_port_num;
+    // Posted TX_TIMESTAMP WQEs, cq_mgr_tx looks for their CQEs only while there are any
+    uint32_t m_tx_ts_inflight = 0U;
     bool m_b_fence_needed = false;
+    bool m_b_db_deferred = false;
+    unsigned m_db_deferred_num = 0U;
+    // Control segments of the first and the last WQEs posted in the deferred doorbell mode
+    struct xlio_mlx5_wqe_ctrl_seg *m_db_deferred_first = nullptr;
+    struct xlio_mlx5_wqe_ctrl_seg *m_db_deferred_ctrl = nullptr;
+    /* BlueFlame burst, m_bf_burst is zero when disabled. The two halves of the BlueFlame
+     * register are written alternately, m_bf_offset selects the next one.
+     */
+    uint32_t m_bf_burst = 0U;
+    uint32_t m_bf_max_inflight = 0U;
+    uint32_t m_bf_offset = 0U;
+
+    // Open MPWQE session state, m_mpwqe_ds is zero when there is no session
+    uint32_t m_mpwqe_max_pkt_size = 0U;
+    uint8_t m_mpwqe_ds = 0U;
+    uint8_t m_mpwqe_cs_flags = 0U;
+    uint16_t m_mpwqe_pkts = 0U;
+    unsigned m_mpwqe_credits = 0U;
+    mem_buf_desc_t *m_mpwqe_buf = nullptr;
+    struct mlx5_wqe_data_seg *m_mpwqe_dseg = nullptr;
+    /* Buffers of the MPWQE packets except for the first one, which is stored in sq_wqe_prop.
+     * The queue is released in order by the TX completions.
+     */
+    std::vector<mem_buf_desc_t *> m_mpwqe_bufs;
+    uint32_t m_mpwqe_bufs_head = 0U;
+    uint32_t m_mpwqe_bufs_tail = 0U;
     bool m_dm_enabled = false;
     dm_mgr m_dm_mgr;
 
+    typedef void (hw_queue_tx::*send_to_wire_t)(xlio_ibv_send_wr *, xlio_wr_tx_packet_attr, bool,
+                                                xlio_tis *, unsigned);
+    // Indexed by the presence of a TIS, selected when the device memory state is known
+    send_to_wire_t m_send_to_wire[2] = {&hw_queue_tx::send_to_wire_tmpl<false, false>,
+                                        &hw_queue_tx::send_to_wire_tmpl<false, true>};
+
     // TIS cache. Protected by ring tx lock. TODO Move to ring.
     std::vector<xlio_tis *> m_tls_tis_cache;
 
 #if defined(DEFINED_UTLS)
-    std::list<std::unique_ptr<dpcp::tls_dek>> m_tls_dek_get_cache;
-    std::list<std::unique_ptr<dpcp::tls_dek>> m_tls_dek_put_cache;
+    // Shared by the rings of the device
+    tls_dek_pool *m_p_tls_dek_pool = nullptr;
 #endif
 };
 
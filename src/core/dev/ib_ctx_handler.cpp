@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <algorithm>
 #include <array>
 #include <mutex>
 #include <cinttypes>
@@ -13,7 +14,11 @@
 #include "vlogger/vlogger.h"
 #include <util/sys_vars.h>
 #include "dev/ib_ctx_handler.h"
+#include "dev/allocator.h"
+#include "dev/dm_mgr.h"
+#include "dev/tls_dek_pool.h"
 #include "ib/base/verbs_extra.h"
+#include "ib/mlx5/ib_mlx5.h"
 #include "dev/time_converter_ib_ctx.h"
 #include "dev/time_converter_ptp.h"
 #include "dev/time_converter_rtc.h"
@@ -36,6 +41,7 @@ ib_ctx_handler::ib_ctx_handler(struct ib_ctx_handler_desc *desc)
     , m_on_device_memory(0)
     , m_removed(false)
     , m_lock_umr("spin_lock_umr")
+    , m_lock_dm_pool("spin_lock_dm_pool")
     , m_p_ctx_time_converter(nullptr)
     , m_str {}
 {
@@ -56,6 +62,10 @@ ib_ctx_handler::ib_ctx_handler(struct ib_ctx_handler_desc *desc)
     }
     VALGRIND_MAKE_MEM_DEFINED(m_p_ibv_pd, sizeof(struct ibv_pd));
 
+    if (safe_mce_sys().hugepage_queues) {
+        set_queue_allocators();
+    }
+
     m_p_ibv_device_attr = new xlio_ibv_device_attr_ex();
     if (!m_p_ibv_device_attr) {
         ibch_logpanic("ibv device %p attr allocation failure (ibv context %p) (errno=%d %m)",
@@ -73,6 +83,8 @@ ib_ctx_handler::ib_ctx_handler(struct ib_ctx_handler_desc *desc)
     // update device memory capabilities
     m_on_device_memory = xlio_ibv_dm_size(m_p_ibv_device_attr);
 
+    m_numa_node = get_ib_device_numa_node(get_ibname());
+
 #ifdef DEFINED_IBV_PACKET_PACING_CAPS
     if (xlio_is_pacing_caps_supported(m_p_ibv_device_attr)) {
         m_pacing_caps.rate_limit_min = m_p_ibv_device_attr->packet_pacing_caps.qp_rate_limit_min;
@@ -80,6 +92,10 @@ ib_ctx_handler::ib_ctx_handler(struct ib_ctx_handler_desc *desc)
     }
 #endif // DEFINED_IBV_PACKET_PACING_CAPS
 
+    if (safe_mce_sys().implicit_odp) {
+        implicit_odp_reg();
+    }
+
     g_p_event_handler_manager->register_ibverbs_event(m_p_ibv_context->async_fd, this,
                                                       m_p_ibv_context, 0);
 
@@ -110,6 +126,16 @@ ib_ctx_handler::~ib_ctx_handler()
     // are still associated with the PD m_p_ibv_pd
     BULLSEYE_EXCLUDE_BLOCK_START
 
+#if defined(DEFINED_DIRECT_VERBS) && defined(DEFINED_IBV_DM)
+    delete m_p_dm_pool;
+    m_p_dm_pool = nullptr;
+#endif /* DEFINED_DIRECT_VERBS && DEFINED_IBV_DM */
+
+#if defined(DEFINED_UTLS)
+    delete m_p_tls_dek_pool;
+    m_p_tls_dek_pool = nullptr;
+#endif /* DEFINED_UTLS */
+
     mr_map_lkey_t::iterator iter;
     while ((iter = m_mr_map_lkey.begin()) != m_mr_map_lkey.end()) {
         mem_dereg(iter->first);
@@ -134,9 +160,130 @@ ib_ctx_handler::~ib_ctx_handler()
         m_p_ibv_context = nullptr;
     }
 
+    // Buffers of the queues which weren't destroyed
+    for (const auto &buf : m_queue_bufs) {
+        m_p_queue_heap->free(buf.first, buf.second);
+    }
+    m_queue_bufs.clear();
+    delete m_p_queue_heap;
+    m_p_queue_heap = nullptr;
+
     BULLSEYE_EXCLUDE_BLOCK_END
 }
 
+/*
+ * rdma-core takes the CQ and QP buffers of the context from the XLIO heap, which is
+ * backed by hugepages when they are available. The queues of the DPCP objects use
+ * their own memory.
+ */
+void ib_ctx_handler::set_queue_allocators()
+{
+    struct mlx5dv_ctx_allocators allocators = {};
+
+    m_p_queue_heap = new xlio_allocator_heap(false);
+    allocators.alloc = queue_buf_alloc_cb;
+    allocators.free = queue_buf_free_cb;
+    allocators.data = this;
+
+    int rc = mlx5dv_set_context_attr(m_p_ibv_context, MLX5DV_CTX_ATTR_BUF_ALLOCATORS, &allocators);
+    if (rc) {
+        ibch_logwarn("Couldn't set the queue buffer allocators on %s (rc=%d), "
+                     "rdma-core allocates the queues",
+                     get_ibname(), rc);
+        delete m_p_queue_heap;
+        m_p_queue_heap = nullptr;
+    }
+}
+
+void *ib_ctx_handler::alloc_queue_buf(size_t size)
+{
+    size_t actual_size = size;
+
+    // The heap hands out page aligned ranges, as the device requires
+    void *buf = m_p_queue_heap->alloc(actual_size);
+    if (!buf) {
+        ibch_logwarn("Couldn't allocate a queue buffer of %zu bytes", size);
+        return nullptr;
+    }
+    memset(buf, 0, actual_size);
+
+    size_t page_size = m_p_queue_heap->page_size(buf);
+    std::lock_guard<decltype(m_lock_queue_bufs)> lock(m_lock_queue_bufs);
+    m_queue_bufs[buf] = actual_size;
+    if (!m_queue_page_size || page_size < m_queue_page_size) {
+        m_queue_page_size = page_size;
+    }
+    ibch_logdbg("Queue buffer %p of %zu bytes on %zu bytes pages", buf, size, page_size);
+    return buf;
+}
+
+void ib_ctx_handler::free_queue_buf(void *ptr)
+{
+    size_t size = 0U;
+
+    {
+        std::lock_guard<decltype(m_lock_queue_bufs)> lock(m_lock_queue_bufs);
+        auto iter = m_queue_bufs.find(ptr);
+        if (iter == m_queue_bufs.end()) {
+            return;
+        }
+        size = iter->second;
+        m_queue_bufs.erase(iter);
+    }
+    m_p_queue_heap->free(ptr, size);
+}
+
+// Takes up to count elements from the shared budget, a forced reservation may exceed it
+uint32_t ib_ctx_handler::rx_wr_shared_reserve(uint32_t count, bool force)
+{
+    if (force) {
+        m_rx_wr_shared_used.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    const uint32_t budget = safe_mce_sys().rx_num_wr_shared;
+    uint32_t used = m_rx_wr_shared_used.load(std::memory_order_relaxed);
+    uint32_t granted;
+    do {
+        granted = (used < budget ? std::min(count, budget - used) : 0U);
+        if (!granted) {
+            return 0U;
+        }
+    } while (!m_rx_wr_shared_used.compare_exchange_weak(used, used + granted,
+                                                        std::memory_order_relaxed));
+    return granted;
+}
+
+#if defined(DEFINED_DIRECT_VERBS) && defined(DEFINED_IBV_DM)
+dm_pool *ib_ctx_handler::get_dm_pool()
+{
+    std::lock_guard<decltype(m_lock_dm_pool)> lock(m_lock_dm_pool);
+
+    // Allocate once, a failed allocation is not retried by every ring
+    if (!m_dm_pool_allocated) {
+        m_dm_pool_allocated = true;
+        m_p_dm_pool = new dm_pool();
+        if (!m_p_dm_pool->allocate_resources(this)) {
+            delete m_p_dm_pool;
+            m_p_dm_pool = nullptr;
+        }
+    }
+    return m_p_dm_pool;
+}
+#endif /* DEFINED_DIRECT_VERBS && DEFINED_IBV_DM */
+
+#if defined(DEFINED_UTLS)
+tls_dek_pool *ib_ctx_handler::get_tls_dek_pool()
+{
+    std::lock_guard<decltype(m_lock_tls_dek_pool)> lock(m_lock_tls_dek_pool);
+
+    if (!m_p_tls_dek_pool) {
+        m_p_tls_dek_pool = new tls_dek_pool(this);
+    }
+    return m_p_tls_dek_pool;
+}
+#endif /* DEFINED_UTLS */
+
 void ib_ctx_handler::set_str()
 {
     char str_x[512] = {0};
@@ -167,6 +314,10 @@ void ib_ctx_handler::set_str()
     sprintf(str_x, " on_device_memory: %zu", m_on_device_memory);
     strcat(m_str, str_x);
 
+    str_x[0] = '\0';
+    sprintf(str_x, " numa_node: %d", m_numa_node);
+    strcat(m_str, str_x);
+
     str_x[0] = '\0';
     sprintf(str_x, " packet_pacing_caps: min rate %u, max rate %u", m_pacing_caps.rate_limit_min,
             m_pacing_caps.rate_limit_max);
@@ -450,20 +601,69 @@ uint32_t ib_ctx_handler::user_mem_reg(void *addr, size_t length, uint64_t access
     uint32_t lkey;
 
     auto iter = m_user_mem_lkey_map.find(addr);
-    if (iter != m_user_mem_lkey_map.end()) {
-        lkey = iter->second;
+    if (iter != m_user_mem_lkey_map.end() && iter->second.second >= length) {
+        lkey = iter->second.first;
     } else {
+        // A shorter registration of the address may still be in use, it's kept registered
         lkey = mem_reg(addr, length, access);
         if (lkey == LKEY_ERROR) {
             ibch_logerr("Can't register user memory addr %p len %lx", addr, length);
         } else {
-            m_user_mem_lkey_map[addr] = lkey;
+            m_user_mem_lkey_map[addr] = {lkey, length};
         }
     }
 
     return lkey;
 }
 
+void ib_ctx_handler::implicit_odp_reg()
+{
+#ifdef DEFINED_IBV_DEVICE_ATTR_EX
+    if (!(m_p_ibv_device_attr->odp_caps.general_caps & IBV_ODP_SUPPORT_IMPLICIT)) {
+        ibch_logdbg("dev:%s implicit ODP is not supported", get_ibname());
+        return;
+    }
+
+    // Implicit ODP region is registered with a null address and the maximal length
+    struct ibv_mr *mr = ibv_reg_mr(m_p_ibv_pd, nullptr, SIZE_MAX,
+                                   XLIO_IBV_ACCESS_LOCAL_WRITE | IBV_ACCESS_ON_DEMAND);
+    VALGRIND_MAKE_MEM_DEFINED(mr, sizeof(ibv_mr));
+    if (!mr) {
+        ibch_logwarn("dev:%s implicit ODP registration failed (errno=%d %m)", get_ibname(), errno);
+        return;
+    }
+    // The region is released with the rest of the registrations in the destructor
+    m_mr_map_lkey[mr->lkey] = mr;
+    m_odp_lkey = mr->lkey;
+    ibch_logdbg("dev:%s implicit ODP lkey=%u pd=%p", get_ibname(), m_odp_lkey, m_p_ibv_pd);
+#else
+    ibch_logdbg("dev:%s implicit ODP requires extended device attributes", get_ibname());
+#endif /* DEFINED_IBV_DEVICE_ATTR_EX */
+}
+
+uint32_t ib_ctx_handler::user_mkey_reg(void *addr, size_t length)
+{
+    std::lock_guard<decltype(m_lock_umr)> lock(m_lock_umr);
+
+    uint32_t lkey = mem_reg(addr, length, XLIO_IBV_ACCESS_LOCAL_WRITE);
+    if (lkey != LKEY_ERROR) {
+        m_user_mkeys.insert(lkey);
+    }
+    return lkey;
+}
+
+bool ib_ctx_handler::user_mkey_dereg(uint32_t lkey)
+{
+    std::lock_guard<decltype(m_lock_umr)> lock(m_lock_umr);
+
+    // Don't let the application deregister internal memory.
+    if (m_user_mkeys.erase(lkey) == 0) {
+        return false;
+    }
+    mem_dereg(lkey);
+    return true;
+}
+
 void ib_ctx_handler::set_flow_tag_capability(bool flow_tag_capability)
 {
     m_flow_tag_enabled = flow_tag_capability;
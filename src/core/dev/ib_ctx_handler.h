@@ -8,16 +8,23 @@
 #define IB_CTX_HANDLER_H
 
 #include <infiniband/verbs.h>
+#include <atomic>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "event/event_handler_ibverbs.h"
 #include "dev/time_converter.h"
 #include "ib/base/verbs_extra.h"
 #include "utils/lock_wrapper.h"
+#include "util/vtypes.h"
 #include <mellanox/dpcp.h>
 
 typedef std::unordered_map<uint32_t, struct ibv_mr *> mr_map_lkey_t;
 
+class dm_pool;
+class tls_dek_pool;
+class xlio_allocator_heap;
+
 struct pacing_caps_t {
     uint32_t rate_limit_min;
     uint32_t rate_limit_max;
@@ -61,6 +68,12 @@ public:
     void mem_dereg(uint32_t lkey);
     struct ibv_mr *get_mem_reg(uint32_t lkey);
     uint32_t user_mem_reg(void *addr, size_t length, uint64_t access);
+    // Registration handles owned by the application (Ultra API xlio_mem_register)
+    uint32_t user_mkey_reg(void *addr, size_t length);
+    bool user_mkey_dereg(uint32_t lkey);
+    // Implicit ODP region covering the whole address space, LKEY_ERROR if not in use
+    uint32_t get_odp_lkey() const { return m_odp_lkey; }
+    bool is_odp_lkey(uint32_t lkey) const { return lkey == m_odp_lkey && lkey != LKEY_ERROR; }
     bool is_removed() { return m_removed; }
     void set_ctx_time_converter_status(ts_conversion_mode_t conversion_mode);
     void set_flow_tag_capability(bool flow_tag_capability);
@@ -69,7 +82,22 @@ public:
     bool get_burst_capability() { return m_pacing_caps.burst; }
     bool is_packet_pacing_supported(uint32_t rate = 1);
     size_t get_on_device_memory_size() { return m_on_device_memory; }
+    // RX WQEs posted by the RQs of the device, see performance.rings.rx.shared_elements_count
+    uint32_t rx_wr_shared_reserve(uint32_t count, bool force);
+    void rx_wr_shared_release(uint32_t count)
+    {
+        m_rx_wr_shared_used.fetch_sub(count, std::memory_order_relaxed);
+    }
+    // On Device Memory shared by the rings, allocated on the first call
+    dm_pool *get_dm_pool();
+#if defined(DEFINED_UTLS)
+    // DEKs shared by the rings, created on the first call
+    tls_dek_pool *get_tls_dek_pool();
+#endif /* DEFINED_UTLS */
     uint32_t get_max_sq_wqebbs() { return m_max_sq_wqebbs; }
+    // Smallest page size of the CQ/QP buffers from the XLIO heap, 0 if rdma-core allocates them
+    size_t get_queue_page_size() const { return m_queue_page_size; }
+    int get_numa_node() const { return m_numa_node; }
     bool is_active(int port_num);
     bool is_mlx4() { return is_mlx4(get_ibname()); }
     static bool is_mlx4(const char *dev) { return strncmp(dev, "mlx4", 4) == 0; }
@@ -85,6 +113,18 @@ public:
 
 private:
     void handle_event_device_fatal();
+    void implicit_odp_reg();
+    void set_queue_allocators();
+    void *alloc_queue_buf(size_t size);
+    void free_queue_buf(void *ptr);
+    static void *queue_buf_alloc_cb(size_t size, void *priv_data)
+    {
+        return static_cast<ib_ctx_handler *>(priv_data)->alloc_queue_buf(size);
+    }
+    static void queue_buf_free_cb(void *ptr, void *priv_data)
+    {
+        static_cast<ib_ctx_handler *>(priv_data)->free_queue_buf(ptr);
+    }
     ibv_device *m_p_ibv_device; // HCA handle
     struct ibv_context *m_p_ibv_context = nullptr;
     dpcp::adapter *m_p_adapter;
@@ -93,12 +133,29 @@ private:
     bool m_flow_tag_enabled;
     pacing_caps_t m_pacing_caps;
     size_t m_on_device_memory;
+    std::atomic<uint32_t> m_rx_wr_shared_used {0U};
     uint32_t m_max_sq_wqebbs = 0U;
+    int m_numa_node = -1;
     bool m_removed;
     lock_spin m_lock_umr;
+    lock_spin m_lock_dm_pool;
+    dm_pool *m_p_dm_pool = nullptr;
+    bool m_dm_pool_allocated = false;
+#if defined(DEFINED_UTLS)
+    lock_mutex m_lock_tls_dek_pool {"lock_tls_dek_pool"};
+    tls_dek_pool *m_p_tls_dek_pool = nullptr;
+#endif /* DEFINED_UTLS */
+    uint32_t m_odp_lkey = LKEY_ERROR;
+    // The CQ/QP buffers rdma-core took from the heap, by address with their size
+    xlio_allocator_heap *m_p_queue_heap = nullptr;
+    lock_spin m_lock_queue_bufs {"lock_queue_bufs"};
+    std::unordered_map<void *, size_t> m_queue_bufs;
+    size_t m_queue_page_size = 0U;
     time_converter *m_p_ctx_time_converter;
     mr_map_lkey_t m_mr_map_lkey;
-    std::unordered_map<void *, uint32_t> m_user_mem_lkey_map;
+    // The user memory registrations by their address, with their length
+    std::unordered_map<void *, std::pair<uint32_t, size_t>> m_user_mem_lkey_map;
+    std::unordered_set<uint32_t> m_user_mkeys;
 
     char m_str[255];
 };
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <mutex>
 #include <vector>
 
 #include "utils/bullseye.h"
@@ -93,6 +94,7 @@ void check_flow_steering_log_num_mgm_entry_size()
 }
 
 ib_ctx_handler_collection::ib_ctx_handler_collection()
+    : m_lock("ib_ctx_handler_collection")
 {
     ibchc_logdbg("");
 
@@ -165,6 +167,7 @@ void ib_ctx_handler_collection::update_tbl(const char *ifa_name)
             ibchc_logerr("failed allocating new ib_ctx_handler (errno=%d %m)", errno);
             continue;
         }
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
         m_ib_ctx_map[p_ib_ctx_handler->get_ibv_device()] = p_ib_ctx_handler;
     }
 
@@ -212,6 +215,7 @@ ib_ctx_handler *ib_ctx_handler_collection::get_ib_ctx(const char *ifa_name)
         }
     }
 
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
     for (ib_ctx_iter = m_ib_ctx_map.begin(); ib_ctx_iter != m_ib_ctx_map.end(); ib_ctx_iter++) {
         if (check_device_name_ib_name(ifa_name, ib_ctx_iter->second->get_ibname())) {
             return ib_ctx_iter->second;
@@ -221,9 +225,40 @@ ib_ctx_handler *ib_ctx_handler_collection::get_ib_ctx(const char *ifa_name)
     return nullptr;
 }
 
+ib_ctx_handler *ib_ctx_handler_collection::get_ib_ctx_by_pd(struct ibv_pd *pd)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    if (!pd) {
+        return m_ib_ctx_map.size() == 1U ? m_ib_ctx_map.begin()->second : nullptr;
+    }
+    for (const auto &ib_ctx_key_val : m_ib_ctx_map) {
+        if (ib_ctx_key_val.second->get_ibv_pd() == pd) {
+            return ib_ctx_key_val.second;
+        }
+    }
+    return nullptr;
+}
+
+int ib_ctx_handler_collection::get_numa_node()
+{
+    int node = -1;
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    for (const auto &ib_ctx_key_val : m_ib_ctx_map) {
+        int dev_node = ib_ctx_key_val.second->get_numa_node();
+        if (dev_node < 0 || (node >= 0 && node != dev_node)) {
+            return -1;
+        }
+        node = dev_node;
+    }
+    return node;
+}
+
 void ib_ctx_handler_collection::del_ib_ctx(ib_ctx_handler *ib_ctx)
 {
     if (ib_ctx) {
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
         ib_context_map_t::iterator ib_ctx_iter = m_ib_ctx_map.find(ib_ctx->get_ibv_device());
         if (ib_ctx_iter != m_ib_ctx_map.end()) {
             delete ib_ctx_iter->second;
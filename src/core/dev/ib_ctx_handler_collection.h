@@ -9,6 +9,7 @@
 
 #include <unordered_map>
 
+#include "utils/lock_wrapper.h"
 #include "ib/base/verbs_extra.h"
 #include "ib_ctx_handler.h"
 
@@ -27,10 +28,16 @@ public:
         return (m_ib_ctx_map.size() ? &m_ib_ctx_map : NULL);
     }
     ib_ctx_handler *get_ib_ctx(const char *ifa_name);
+    // Device of the protection domain, NULL pd selects the device only if it is the single one
+    ib_ctx_handler *get_ib_ctx_by_pd(struct ibv_pd *pd);
+    // NUMA node shared by all the devices, -1 if unknown or the devices are on different nodes
+    int get_numa_node();
     void del_ib_ctx(ib_ctx_handler *ib_ctx);
 
 private:
     ib_context_map_t m_ib_ctx_map;
+    // Protects the map against the walkers of the other threads, e.g. the Ultra API calls
+    lock_mutex m_lock;
 };
 
 extern ib_ctx_handler_collection *g_p_ib_ctx_handler_collection;
@@ -9,7 +9,12 @@
 #include <sys/types.h>
 #include <ifaddrs.h>
 #include <sys/epoll.h>
+#include <sched.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <system_error>
+#include <thread>
 
 #include "utils/bullseye.h"
 #include "vlogger/vlogger.h"
@@ -37,7 +42,11 @@
 
 net_device_table_mgr *g_p_net_device_table_mgr = nullptr;
 
-enum net_device_table_mgr_timers { RING_PROGRESS_ENGINE_TIMER, RING_ADAPT_CQ_MODERATION_TIMER };
+enum net_device_table_mgr_timers {
+    RING_PROGRESS_ENGINE_TIMER,
+    RING_ADAPT_CQ_MODERATION_TIMER,
+    RING_DEFERRED_RULES_TIMER
+};
 
 net_device_table_mgr::net_device_table_mgr()
     : cache_table_mgr<int, net_device_val *>("net_device_table_mgr")
@@ -115,6 +124,14 @@ net_device_table_mgr::net_device_table_mgr()
                                                         (void *)RING_ADAPT_CQ_MODERATION_TIMER);
     }
 
+    if (safe_mce_sys().tcp_deferred_rules_msec) {
+        ndtm_logdbg("registering timer for deferred steering rules with %d msec intervales",
+                    safe_mce_sys().tcp_deferred_rules_msec);
+        g_p_event_handler_manager->register_timer_event(safe_mce_sys().tcp_deferred_rules_msec,
+                                                        this, PERIODIC_TIMER,
+                                                        (void *)RING_DEFERRED_RULES_TIMER);
+    }
+
     ndtm_logdbg("Done");
 }
 
@@ -533,6 +550,17 @@ void net_device_table_mgr::global_ring_adapt_cq_moderation()
     }
 }
 
+void net_device_table_mgr::global_ring_flush_deferred_rules()
+{
+    ndtm_logfuncall("");
+
+    net_device_map_index_t::iterator net_dev_iter;
+    for (net_dev_iter = m_net_device_map_index.begin();
+         m_net_device_map_index.end() != net_dev_iter; net_dev_iter++) {
+        net_dev_iter->second->ring_flush_deferred_rules();
+    }
+}
+
 void net_device_table_mgr::handle_timer_expired(void *user_data)
 {
     int timer_type = (uint64_t)user_data;
@@ -543,6 +571,9 @@ void net_device_table_mgr::handle_timer_expired(void *user_data)
     case RING_ADAPT_CQ_MODERATION_TIMER:
         global_ring_adapt_cq_moderation();
         break;
+    case RING_DEFERRED_RULES_TIMER:
+        global_ring_flush_deferred_rules();
+        break;
     default:
         ndtm_logerr("unrecognized timer %d", timer_type);
     }
@@ -574,6 +605,105 @@ void net_device_table_mgr::get_net_devices(local_dev_vector &vec)
     }
 }
 
+std::vector<ring_precreated_t>
+net_device_table_mgr::precreate_rings(const std::vector<resource_allocation_key> &keys)
+{
+    std::vector<ring_precreated_t> tasks;
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        // The rings look their device up in the table, it can't be locked meanwhile
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
+        for (auto iter : m_net_device_map_index) {
+            for (const resource_allocation_key &key : keys) {
+                tasks.push_back({iter.second, key, nullptr});
+            }
+        }
+    }
+
+    std::atomic<size_t> next(0U);
+    auto create = [&]() {
+        size_t i;
+        while ((i = next.fetch_add(1U, std::memory_order_relaxed)) < tasks.size()) {
+            tasks[i].p_ring = tasks[i].p_ndev->reserve_ring(&tasks[i].key);
+        }
+    };
+
+    size_t threads = std::min<size_t>(safe_mce_sys().ring_precreate_threads, tasks.size());
+    std::vector<std::thread> workers;
+    try {
+        for (size_t i = 1U; i < threads; ++i) {
+            workers.emplace_back(create);
+        }
+    } catch (const std::system_error &) {
+        // The calling thread creates the rest
+    }
+    create();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                               [](const ring_precreated_t &task) { return !task.p_ring; }),
+                tasks.end());
+    ndtm_logdbg("Precreated %zu rings with %zu threads in %lld usec", tasks.size(),
+                workers.size() + 1U,
+                (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+    return tasks;
+}
+
+void net_device_table_mgr::precreate_socket_rings()
+{
+    // The keys of the TCP sockets, see sockinfo_tcp
+    bool use_locks =
+        safe_mce_sys().tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS;
+    ring_logic_t logics[] = {safe_mce_sys().ring_allocation_logic_rx,
+                             safe_mce_sys().ring_allocation_logic_tx};
+    std::vector<resource_allocation_key> keys;
+    cpu_set_t cpuset;
+
+    if (sched_getaffinity(0, sizeof(cpuset), &cpuset) != 0) {
+        CPU_ZERO(&cpuset);
+    }
+    for (ring_logic_t logic : logics) {
+        resource_allocation_key key(logic, use_locks);
+
+        switch (logic) {
+        case RING_LOGIC_PER_INTERFACE:
+            key.set_user_id_key(0U);
+            keys.push_back(key);
+            break;
+        case RING_LOGIC_PER_CORE:
+        case RING_LOGIC_PER_CORE_ATTACH_THREADS:
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &cpuset)) {
+                    key.set_user_id_key(cpu);
+                    keys.push_back(key);
+                }
+            }
+            break;
+        case RING_LOGIC_PER_CORE_POOL:
+            for (uint32_t i = 0; i < g_cpu_manager.get_core_pool_size(); ++i) {
+                key.set_user_id_key(i);
+                keys.push_back(key);
+            }
+            break;
+        default:
+            ndtm_logdbg("The rings of the allocation logic %d can't be precreated", logic);
+            break;
+        }
+    }
+    // The RX and TX logics are usually the same
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys.erase(std::remove(keys.begin() + i + 1U, keys.end(), keys[i]), keys.end());
+    }
+    if (!keys.empty()) {
+        precreate_rings(keys);
+    }
+}
+
 void net_device_table_mgr::del_link_event(const netlink_link_info *info)
 {
     ndtm_logdbg("netlink event: RTM_DELLINK if_index: %d", info->ifindex);
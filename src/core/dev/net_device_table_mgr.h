@@ -25,6 +25,13 @@ typedef std::unordered_map<int, net_device_val *> net_device_map_index_t;
 typedef std::list<std::reference_wrapper<const ip_data>> local_ip_list_t;
 typedef std::vector<std::reference_wrapper<const net_device_val>> local_dev_vector;
 
+// A ring created ahead of its sockets on a device, reserved once with the key
+struct ring_precreated_t {
+    net_device_val *p_ndev;
+    resource_allocation_key key;
+    ring *p_ring;
+};
+
 class net_device_table_mgr : public cache_table_mgr<int, net_device_val *>, public observer {
 public:
     net_device_table_mgr();
@@ -67,6 +74,7 @@ public:
     int global_ring_drain_and_procces();
 
     void global_ring_adapt_cq_moderation();
+    void global_ring_flush_deferred_rules();
 
     void global_ring_wakeup();
 
@@ -87,6 +95,21 @@ public:
 
     void get_net_devices(local_dev_vector &vec);
 
+    /**
+     * Create the rings of the keys on all the devices before the first sockets use them.
+     * The rings are created by performance.rings.precreate_threads threads, the CQs and QPs
+     * of the rings of a device are created in parallel too. Each ring is reserved once,
+     * the caller releases the reservations it doesn't keep.
+     */
+    std::vector<ring_precreated_t>
+    precreate_rings(const std::vector<resource_allocation_key> &keys);
+
+    /*
+     * Precreate the rings of the socket API sockets, which are known in advance for the
+     * per interface and per core allocation logics. The rings are kept until the exit.
+     */
+    void precreate_socket_rings();
+
     void increase_closed_rings_rx_cq_drop_counter(uint64_t count)
     {
         m_closed_rings_rx_cq_drop_counter_lock.lock();
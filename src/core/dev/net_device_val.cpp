@@ -48,6 +48,7 @@ ring_alloc_logic_attr::ring_alloc_logic_attr()
     : m_ring_alloc_logic(RING_LOGIC_PER_THREAD)
     , m_use_locks(true)
     , m_user_id_key(0)
+    , m_tx_priority(0)
 {
     init();
 }
@@ -56,6 +57,7 @@ ring_alloc_logic_attr::ring_alloc_logic_attr(ring_logic_t ring_logic, bool use_l
     : m_ring_alloc_logic(ring_logic)
     , m_use_locks(use_locks)
     , m_user_id_key(0)
+    , m_tx_priority(0)
 {
     init();
 }
@@ -65,6 +67,7 @@ ring_alloc_logic_attr::ring_alloc_logic_attr(const ring_alloc_logic_attr &other)
     , m_ring_alloc_logic(other.m_ring_alloc_logic)
     , m_use_locks(other.m_use_locks)
     , m_user_id_key(other.m_user_id_key)
+    , m_tx_priority(other.m_tx_priority)
 {
 }
 
@@ -88,6 +91,7 @@ void ring_alloc_logic_attr::init()
     HASH_ITER(m_ring_alloc_logic, size_t);
     HASH_ITER(m_user_id_key, uint64_t);
     HASH_ITER(m_use_locks, bool);
+    HASH_ITER(m_tx_priority, uint32_t);
 
     m_hash = h;
 #undef HASH_ITER
@@ -109,6 +113,14 @@ void ring_alloc_logic_attr::set_user_id_key(uint64_t user_id_key)
     }
 }
 
+void ring_alloc_logic_attr::set_tx_priority(uint32_t tx_priority)
+{
+    if (m_tx_priority != tx_priority) {
+        m_tx_priority = tx_priority;
+        init();
+    }
+}
+
 void ring_alloc_logic_attr::set_use_locks(bool use_locks)
 {
     if (m_use_locks != use_locks) {
@@ -123,6 +135,9 @@ const std::string ring_alloc_logic_attr::to_str() const
 
     ss << "allocation logic " << m_ring_alloc_logic << " key " << m_user_id_key << " use locks "
        << !!m_use_locks;
+    if (m_tx_priority) {
+        ss << " tx priority " << m_tx_priority;
+    }
 
     return ss.str();
 }
@@ -897,7 +912,7 @@ uint64_t net_device_val::get_accumulative_rx_cq_drop_counter()
 ring *net_device_val::reserve_ring(resource_allocation_key *key)
 {
     nd_logfunc("");
-    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    std::unique_lock<decltype(m_lock)> lock(m_lock);
     key = ring_key_redirection_reserve(key);
     ring *the_ring = nullptr;
     rings_hash_map_t::iterator ring_iter = m_h_ring_map.find(key);
@@ -906,8 +921,26 @@ ring *net_device_val::reserve_ring(resource_allocation_key *key)
         nd_logdbg("Creating new RING for %s", key->to_str().c_str());
         // Copy key since we keep pointer and socket can die so map will lose pointer
         resource_allocation_key *new_key = new resource_allocation_key(*key);
-        the_ring = create_ring(new_key);
+        if (m_bond == NO_BOND) {
+            /*
+             * Creating the CQs and QPs takes long, the rings of other keys don't wait for it.
+             * The ring of a concurrent reservation with the same key wins.
+             */
+            lock.unlock();
+            the_ring = create_ring(new_key);
+            lock.lock();
+            if (m_h_ring_map.find(new_key) != m_h_ring_map.end()) {
+                delete the_ring;
+                delete new_key;
+                ring_iter = m_h_ring_map.find(key);
+                ADD_RING_REF_CNT;
+                return THE_RING;
+            }
+        } else {
+            the_ring = create_ring(new_key);
+        }
         if (!the_ring) {
+            delete new_key;
             return nullptr;
         }
         m_h_ring_map[new_key] = std::make_pair(the_ring, 0); // each ring is born with ref_count = 0
@@ -1152,6 +1185,20 @@ void net_device_val::ring_adapt_cq_moderation()
     }
 }
 
+void net_device_val::ring_flush_deferred_rules()
+{
+    nd_logfuncall();
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    rings_hash_map_t::iterator ring_iter;
+    for (ring_iter = m_h_ring_map.begin(); ring_iter != m_h_ring_map.end(); ring_iter++) {
+        if (THE_RING->is_ultra_ring()) {
+            continue;
+        }
+        THE_RING->flush_deferred_rules();
+    }
+}
+
 void net_device_val::register_to_ibverbs_events(event_handler_ibverbs *handler)
 {
     for (size_t i = 0; i < m_slaves.size(); i++) {
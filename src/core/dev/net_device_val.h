@@ -36,15 +36,18 @@ public:
     void set_ring_alloc_logic(ring_logic_t logic);
     void set_user_id_key(uint64_t user_id_key);
     void set_use_locks(bool use_locks);
+    void set_tx_priority(uint32_t tx_priority);
     const std::string to_str() const;
     inline ring_logic_t get_ring_alloc_logic() { return m_ring_alloc_logic; }
     inline uint64_t get_user_id_key() { return m_user_id_key; }
     inline bool get_use_locks() { return m_use_locks; }
+    inline uint32_t get_tx_priority() { return m_tx_priority; }
 
     bool operator==(const ring_alloc_logic_attr &other) const
     {
         return (m_ring_alloc_logic == other.m_ring_alloc_logic &&
-                m_user_id_key == other.m_user_id_key && m_use_locks == other.m_use_locks);
+                m_user_id_key == other.m_user_id_key && m_use_locks == other.m_use_locks &&
+                m_tx_priority == other.m_tx_priority);
     }
 
     bool operator!=(const ring_alloc_logic_attr &other) const { return !(*this == other); }
@@ -56,6 +59,7 @@ public:
             m_user_id_key = other.m_user_id_key;
             m_hash = other.m_hash;
             m_use_locks = other.m_use_locks;
+            m_tx_priority = other.m_tx_priority;
         }
         return *this;
     }
@@ -74,6 +78,8 @@ private:
     bool m_use_locks;
     /* Either user_idx or key as defined in ring_logic_t */
     uint64_t m_user_id_key;
+    /* Socket priority of a TX ring, see performance.rings.tx.per_priority */
+    uint32_t m_tx_priority;
     void init();
 };
 
@@ -220,6 +226,7 @@ public:
     int global_ring_request_notification(uint64_t poll_sn_rx, uint64_t poll_sn_tx);
     int ring_drain_and_proccess();
     void ring_adapt_cq_moderation();
+    void ring_flush_deferred_rules();
     L2_address *get_l2_address() { return m_p_L2_addr; };
     L2_address *get_br_address() { return m_p_br_addr; };
     inline bond_type get_is_bond() { return m_bond; }
@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "dev/pacing_wheel.h"
+
+#include <sched.h>
+#include <algorithm>
+#include <mutex>
+
+#define MODULE_NAME "pacing_wheel"
+
+pacing_wheel g_pacing_wheel;
+
+pacing_wheel::pacing_wheel()
+    : m_lock("pacing_wheel")
+    , m_slots(PACING_WHEEL_SLOTS)
+{
+}
+
+void pacing_wheel::schedule(client *p_client, tscval_t release_tsc)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    if (unlikely(!m_slot_tsc)) {
+        m_slot_tsc = std::max<tscval_t>(
+            1U, get_tsc_rate_per_second() * PACING_WHEEL_SLOT_USEC / 1000000U);
+    }
+    if (!m_n_count && !m_b_processing) {
+        tscval_t now;
+        gettimeoftsc(&now);
+        m_cur_tick = now / m_slot_tsc;
+    }
+    if (p_client->m_pacing_slot >= 0) {
+        remove_no_lock(p_client);
+    }
+    schedule_no_lock(p_client, release_tsc / m_slot_tsc);
+}
+
+void pacing_wheel::cancel(client *p_client)
+{
+    m_lock.lock();
+    while (m_p_releasing == p_client) {
+        m_lock.unlock();
+        sched_yield();
+        m_lock.lock();
+    }
+    if (p_client->m_pacing_slot >= 0) {
+        remove_no_lock(p_client);
+    }
+    m_lock.unlock();
+}
+
+void pacing_wheel::process_expired()
+{
+    tscval_t now;
+
+    if (m_lock.trylock()) {
+        // Another thread is releasing the senders
+        return;
+    }
+    if (m_b_processing || !m_slot_tsc) {
+        // Recursion from the TX path of a released sender
+        m_lock.unlock();
+        return;
+    }
+    m_b_processing = true;
+
+    gettimeoftsc(&now);
+    uint64_t now_tick = now / m_slot_tsc;
+    if (now_tick >= m_cur_tick + PACING_WHEEL_SLOTS) {
+        // Every slot has expired, visit each of them once
+        m_cur_tick = now_tick - PACING_WHEEL_SLOTS + 1;
+    }
+
+    while (m_cur_tick <= now_tick && m_n_count) {
+        client_list_t &slot = m_slots[m_cur_tick % PACING_WHEEL_SLOTS];
+        while (!slot.empty()) {
+            client *p_client = slot.front();
+            remove_no_lock(p_client);
+
+            m_p_releasing = p_client;
+            m_lock.unlock();
+            bool released = p_client->handle_pacing_release();
+            m_lock.lock();
+            m_p_releasing = nullptr;
+
+            if (!released && p_client->m_pacing_slot < 0) {
+                schedule_no_lock(p_client, m_cur_tick + 1);
+            }
+        }
+        ++m_cur_tick;
+    }
+
+    m_b_processing = false;
+    m_lock.unlock();
+}
+
+void pacing_wheel::schedule_no_lock(client *p_client, uint64_t tick)
+{
+    // The slot being processed is never extended, otherwise it may be visited forever
+    uint64_t first = m_b_processing ? m_cur_tick + 1 : m_cur_tick;
+    tick = std::min(std::max(tick, first), first + PACING_WHEEL_SLOTS - 2);
+
+    m_slots[tick % PACING_WHEEL_SLOTS].push_back(p_client);
+    p_client->m_pacing_slot = static_cast<int>(tick % PACING_WHEEL_SLOTS);
+    ++m_n_count;
+}
+
+void pacing_wheel::remove_no_lock(client *p_client)
+{
+    m_slots[p_client->m_pacing_slot].erase(p_client);
+    p_client->m_pacing_slot = -1;
+    --m_n_count;
+}
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef PACING_WHEEL_H_
+#define PACING_WHEEL_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "utils/lock_wrapper.h"
+#include "utils/rdtsc.h"
+#include "util/xlio_list.h"
+
+#define PACING_WHEEL_SLOT_USEC 10
+#define PACING_WHEEL_SLOTS     1024
+
+/**
+ * Timer wheel of the software paced senders.
+ *
+ * A paced sender which ran out of tokens schedules itself for the time its bucket is
+ * refilled. The rings drive the wheel from their polling paths and release the senders
+ * whose slot expired. A release further than the wheel horizon lands on the last slot,
+ * the sender reschedules itself on release. The slots are intrusive lists, scheduling
+ * never allocates.
+ *
+ * A release runs in whichever thread drives the wheel: a ring poll of any socket, an
+ * epoll_wait() or the internal thread timer. The client serializes itself, e.g. a TCP
+ * socket only tries its lock and is retried on the next slot if the lock is busy.
+ */
+class pacing_wheel {
+public:
+    class client {
+    public:
+        virtual ~client() {}
+
+        /* Called without the wheel lock. Return false to be retried on the next slot. */
+        virtual bool handle_pacing_release() = 0;
+
+        static inline size_t pacing_node_offset(void)
+        {
+            return NODE_OFFSET(client, m_pacing_node);
+        }
+
+    private:
+        list_node<client, client::pacing_node_offset> m_pacing_node;
+        int m_pacing_slot = -1;
+
+        friend class pacing_wheel;
+    };
+
+    pacing_wheel();
+
+    void schedule(client *p_client, tscval_t release_tsc);
+    /* Waits for a release in progress, the client can be destroyed after the call. */
+    void cancel(client *p_client);
+
+    void process()
+    {
+        if (m_n_count.load(std::memory_order_relaxed)) {
+            process_expired();
+        }
+    }
+
+private:
+    typedef xlio_list_t<client, client::pacing_node_offset> client_list_t;
+
+    void process_expired();
+    void schedule_no_lock(client *p_client, uint64_t tick);
+    void remove_no_lock(client *p_client);
+
+    lock_spin m_lock;
+    std::vector<client_list_t> m_slots;
+    std::atomic<uint32_t> m_n_count {0};
+    tscval_t m_slot_tsc = 0;
+    uint64_t m_cur_tick = 0;
+    client *m_p_releasing = nullptr;
+    bool m_b_processing = false;
+};
+
+extern pacing_wheel g_pacing_wheel;
+
+#endif /* PACING_WHEEL_H_ */
@@ -228,7 +228,7 @@ bool rfs::del_sink(sockinfo *p_sink)
     return false;
 }
 
-bool rfs::attach_flow(sockinfo *sink)
+bool rfs::attach_flow(sockinfo *sink, bool defer_rule)
 {
     bool ret;
     int filter_counter = 1;
@@ -237,16 +237,19 @@ bool rfs::attach_flow(sockinfo *sink)
     prepare_filter_attach(filter_counter, filter_iter);
 
     // We also check if this is the FIRST sink so we need to call ibv_attach_flow
-    if ((m_n_sinks_list_entries == 0) && (!m_b_tmp_is_attached) && (filter_counter == 1)) {
-        if (!create_flow()) {
-            return false;
-        }
-        filter_keep_attached(filter_iter);
-        if (if_secondary_rule_needed()) {
-            prepare_flow_spec_secondary_rule();
+    if ((m_n_sinks_list_entries == 0) && (!m_b_tmp_is_attached) && (!m_b_rule_deferred) &&
+        (filter_counter == 1)) {
+        if (defer_rule && !m_p_rule_filter) {
+            rfs_logdbg("Deferring RFS flow creation, Flow: %s", m_flow_tuple.to_str().c_str());
+            m_b_rule_deferred = true;
+        } else {
             if (!create_flow()) {
                 return false;
             }
+            filter_keep_attached(filter_iter);
+            if (!create_extra_flows()) {
+                return false;
+            }
         }
     } else {
         rfs_logdbg("rfs: Joining existing flow");
@@ -291,12 +294,27 @@ bool rfs::detach_flow(sockinfo *sink, rfs_rule **rule_extract)
 
     // We also need to check if this is the LAST sink so we need to call ibv_attach_flow
     if ((m_n_sinks_list_entries == 0) && (filter_counter == 0)) {
-        ret = destroy_flow(rule_extract);
+        if (m_b_rule_deferred) {
+            // The HW rule was never created
+            m_b_rule_deferred = false;
+        } else {
+            ret = destroy_flow(rule_extract);
+        }
     }
 
     return ret;
 }
 
+bool rfs::create_deferred_flow()
+{
+    if (!m_b_rule_deferred) {
+        return true;
+    }
+    m_b_rule_deferred = false;
+
+    return create_flow() && create_extra_flows();
+}
+
 #ifdef DEFINED_UTLS
 
 rfs_rule *rfs::create_rule(xlio_tir *tir, const flow_tuple &flow_spec)
@@ -351,8 +369,8 @@ bool rfs::create_flow()
     }
 
     if (m_rfs_flow) {
-        // if m_rfs_flow exists then this is secondary rule , assign to m_rfs_rule_secondary
-        m_rfs_rule_secondary = rfs_flow;
+        // if m_rfs_flow exists then this is an extra rule of the same flow
+        m_rfs_rules_extra.push_back(rfs_flow);
     } else {
         m_rfs_flow = rfs_flow;
     }
@@ -366,9 +384,30 @@ bool rfs::create_flow()
     return true;
 }
 
+bool rfs::create_extra_flows()
+{
+    uint32_t extra_rules = get_extra_rules_num();
+    dpcp::match_params match_value = m_match_value;
+
+    for (uint32_t i = 0; i < extra_rules; ++i) {
+        prepare_flow_spec_extra_rule(i);
+        if (!create_flow()) {
+            m_match_value = match_value;
+            return false;
+        }
+    }
+    // The first rule is created again after a detach
+    m_match_value = match_value;
+    return true;
+}
+
 bool rfs::destroy_flow(rfs_rule **rule_extract)
 {
     int n_rx_steering_rules = 0;
+    // The rules of the closed TCP connections are destroyed in batches with the deferred rules
+    bool retire = !rule_extract && safe_mce_sys().tcp_deferred_rules_msec && !m_p_rule_filter &&
+        m_flow_tuple.get_protocol() == PROTO_TCP && m_flow_tuple.is_5_tuple() &&
+        !m_p_ring->get_parent()->is_ultra_ring();
     if (unlikely(!m_rfs_flow)) {
         rfs_logdbg("Destroy RFS flow failed, RFS flow was not created. "
                    "This is OK for MC same ip diff port scenario. Tag: %" PRIu32
@@ -379,17 +418,23 @@ bool rfs::destroy_flow(rfs_rule **rule_extract)
             // We extract the HW rule instead of deleting it. The rule must be either reused
             // or destroyed explicitly by the caller.
             *rule_extract = m_rfs_flow;
+        } else if (retire) {
+            m_p_ring->retire_rule(m_rfs_flow);
         } else {
             delete m_rfs_flow;
         }
         m_rfs_flow = nullptr;
         n_rx_steering_rules++;
     }
-    if (m_rfs_rule_secondary) {
-        delete m_rfs_rule_secondary;
-        m_rfs_rule_secondary = nullptr;
+    for (rfs_rule *rule : m_rfs_rules_extra) {
+        if (retire) {
+            m_p_ring->retire_rule(rule);
+        } else {
+            delete rule;
+        }
         n_rx_steering_rules++;
     }
+    m_rfs_rules_extra.clear();
 
     m_b_tmp_is_attached = false;
     rfs_logdbg("Destroy RFS flow succeeded, Tag: %" PRIu32 ", Flow: %s", m_flow_tag_id,
@@ -64,10 +64,13 @@ public:
      * An ibv_detach is called when the last receiver sink is deleted from the registered list
      *
      */
-    bool attach_flow(sockinfo *sink); // Add a sink. If this is the first sink --> map the sink
-                                      // and attach flow to QP
+    // Add a sink. If this is the first sink --> map the sink and attach flow to QP.
+    // With defer_rule the HW rule is created later by create_deferred_flow().
+    bool attach_flow(sockinfo *sink, bool defer_rule = false);
     // Delete a sink. If this is the last sink --> delete it and detach flow from QP
     bool detach_flow(sockinfo *sink, rfs_rule **rule_extract);
+    bool create_deferred_flow();
+    bool is_rule_deferred() const { return m_b_rule_deferred; }
 #ifdef DEFINED_UTLS
     rfs_rule *create_rule(xlio_tir *tir,
                           const flow_tuple &flow_spec); // Create a duplicate rule which points to
@@ -77,8 +80,9 @@ public:
     uint32_t get_num_of_sinks() const { return m_n_sinks_list_entries; }
     virtual bool rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array) = 0;
     virtual void prepare_flow_spec_worker_thread_mode() = 0;
-    virtual void prepare_flow_spec_secondary_rule() = 0;
-    virtual bool if_secondary_rule_needed() = 0;
+    // The rules of the buckets after the first one, see calculate_listen_buckets()
+    virtual uint32_t get_extra_rules_num() = 0;
+    virtual void prepare_flow_spec_extra_rule(uint32_t index) = 0;
 
 protected:
     flow_tuple m_flow_tuple;
@@ -101,13 +105,16 @@ protected:
     uint16_t m_priority = 3U;
 
     bool m_b_tmp_is_attached; // Only temporary, while ibcm calls attach_flow with no sinks...
+    bool m_b_rule_deferred = false; // HW rule creation is postponed, see create_deferred_flow()
 
     dpcp::match_params m_match_value;
     dpcp::match_params m_match_mask;
 
-    rfs_rule *m_rfs_rule_secondary = nullptr; // Second rule for odd number of xlio threads
+    // Rules of the additional buckets of a listen RSS child and the second nginx worker rule
+    std::vector<rfs_rule *> m_rfs_rules_extra;
 
     bool create_flow(); // Attach flow to all queues
+    bool create_extra_flows();
     bool destroy_flow(rfs_rule **rule_extract); // Detach flow from all queues
     bool add_sink(sockinfo *p_sink);
     bool del_sink(sockinfo *p_sink);
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <algorithm>
 #include "utils/bullseye.h"
 #include "util/utils.h"
+#include "util/instrumentation.h"
 #include "dev/rfs_mc.h"
 #include "dev/ring_simple.h"
 #include "sock/sockinfo.h"
@@ -59,12 +61,20 @@ void rfs_mc::prepare_flow_spec()
 
 bool rfs_mc::rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array)
 {
+    XLIO_TRACE(rfs_dispatch, this, p_rx_wc_buf_desc, m_n_sinks_list_entries);
+    XLIO_TRACE_RING(TRACE_EVENT_RFS_DISPATCH, this, m_n_sinks_list_entries);
+    if (m_n_sinks_list_entries > 1U) {
+        return rx_dispatch_fanout(p_rx_wc_buf_desc, pv_fd_ready_array);
+    }
+
     // Dispatching: Notify new packet to all registered receivers
     p_rx_wc_buf_desc->reset_ref_count();
     p_rx_wc_buf_desc->inc_ref_count();
 
     for (uint32_t i = 0; i < m_n_sinks_list_entries; ++i) {
-        if (m_sinks_list[i]) {
+        if (m_sinks_list[i] &&
+            likely(!m_sinks_list[i]->is_rx_over_limit() ||
+                   !m_sinks_list[i]->rx_over_limit_drop(p_rx_wc_buf_desc))) {
             m_sinks_list[i]->rx_input_cb(p_rx_wc_buf_desc, pv_fd_ready_array);
         }
     }
@@ -78,3 +88,42 @@ bool rfs_mc::rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_re
     // Reuse this data buffer & mem_buf_desc
     return false;
 }
+
+// Delivers a datagram to many sockets of the group. A reference for every socket is preset with a
+// single store instead of an atomic increment per socket, and the unused ones are released with
+// a single atomic at the end. The epoll sets are notified once per set, after all the sockets.
+bool rfs_mc::rx_dispatch_fanout(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array)
+{
+    rx_fanout fanout = {pv_fd_ready_array, 0U, m_fanout_epoll_ready};
+
+    // The extra reference is held by the dispatch until all the sockets are served
+    p_rx_wc_buf_desc->set_ref_count(static_cast<int>(m_n_sinks_list_entries) + 1);
+
+    for (uint32_t i = 0; i < m_n_sinks_list_entries; ++i) {
+        sockinfo *si = m_sinks_list[i];
+        if (si && likely(!si->is_rx_over_limit() || !si->rx_over_limit_drop(p_rx_wc_buf_desc))) {
+            si->rx_input_cb_fanout(p_rx_wc_buf_desc, fanout);
+        }
+    }
+
+    if (!m_fanout_epoll_ready.empty()) {
+        std::sort(m_fanout_epoll_ready.begin(), m_fanout_epoll_ready.end(),
+                  [](const std::pair<epfd_info *, sockinfo *> &a,
+                     const std::pair<epfd_info *, sockinfo *> &b) { return a.first < b.first; });
+        size_t first = 0;
+        for (size_t i = 1; i <= m_fanout_epoll_ready.size(); ++i) {
+            if (i == m_fanout_epoll_ready.size() ||
+                m_fanout_epoll_ready[i].first != m_fanout_epoll_ready[first].first) {
+                m_fanout_epoll_ready[first].first->insert_epoll_events_cb(
+                    &m_fanout_epoll_ready[first], i - first, EPOLLIN);
+                first = i;
+            }
+        }
+        m_fanout_epoll_ready.clear();
+    }
+
+    // The readers may have released their references already, the buffer is reused when none
+    // is left
+    int unused = static_cast<int>(m_n_sinks_list_entries - fanout.refs_used) + 1;
+    return p_rx_wc_buf_desc->add_ref_count(-unused) > unused;
+}
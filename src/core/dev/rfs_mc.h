@@ -9,6 +9,8 @@
 
 #include "dev/rfs.h"
 
+class epfd_info;
+
 /**
  * @class rfs_mc
  *
@@ -25,11 +27,17 @@ public:
     virtual bool rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc,
                                     void *pv_fd_ready_array) override;
     virtual void prepare_flow_spec_worker_thread_mode() override {}
-    virtual void prepare_flow_spec_secondary_rule() override {}
-    virtual bool if_secondary_rule_needed() override { return false; }
+    virtual uint32_t get_extra_rules_num() override { return 0U; }
+    virtual void prepare_flow_spec_extra_rule(uint32_t) override {}
 
 protected:
     void prepare_flow_spec() override;
+
+private:
+    bool rx_dispatch_fanout(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array);
+
+    // Sockets to report to their epoll sets, kept to reuse the storage between the datagrams
+    std::vector<std::pair<epfd_info *, sockinfo *>> m_fanout_epoll_ready;
 };
 
 #endif /* RFS_MC_H */
@@ -56,6 +56,9 @@ void rfs_uc::prepare_flow_spec()
         // Set priority of 5-tuple to be higher than 3-tuple
         // to make sure 5-tuple have higher priority.
         m_priority = 1;
+    } else if (m_flow_tuple.get_protocol() == PROTO_UDP && m_steering_index >= 0) {
+        // UDP socket of a SO_REUSEPORT group
+        prepare_flow_spec_udp_reuseport();
     } else if (safe_mce_sys().worker_threads != 0) {
         // TCP listen socket - Threads mode
         prepare_flow_spec_worker_thread_mode();
@@ -103,54 +106,69 @@ void rfs_uc::prepare_flow_spec_worker_thread_mode()
         return;
     }
 
-    int entity_context_pow2 = entity_context_manager::calculate_entity_context_pow2();
+    int buckets = entity_context_manager::calculate_listen_buckets();
 
-    m_match_mask.src_port =
-        static_cast<uint16_t>((entity_context_pow2 * MCE_DEFAULT_SRC_PORT_STRIDE) - 2);
+    // The first rule matches the bucket of the steering index
+    m_match_mask.src_port = static_cast<uint16_t>((buckets * MCE_DEFAULT_SRC_PORT_STRIDE) - 2);
     m_match_value.src_port = static_cast<uint16_t>(m_steering_index * MCE_DEFAULT_SRC_PORT_STRIDE);
 
     m_priority = 2;
-    rfs_logdbg("src_port_stride: %d workers_num %d \n", MCE_DEFAULT_SRC_PORT_STRIDE,
-               entity_context_pow2);
+    rfs_logdbg("src_port_stride: %d buckets %d \n", MCE_DEFAULT_SRC_PORT_STRIDE, buckets);
 }
 
-void rfs_uc::prepare_flow_spec_secondary_rule()
+void rfs_uc::prepare_flow_spec_udp_reuseport()
 {
+    // The first socket keeps the 3 tuple rule below the buckets, it gets the free buckets
+    if (m_steering_index == 0) {
+        return;
+    }
 
-    int src_port = safe_mce_sys().worker_threads + m_steering_index;
+    int buckets = static_cast<int>(safe_mce_sys().udp_reuseport_buckets);
 
-    // We use the same m_match_mask as the first rule.
-    m_match_value.src_port = static_cast<uint16_t>(src_port * MCE_DEFAULT_SRC_PORT_STRIDE);
+    m_match_mask.src_port = static_cast<uint16_t>((buckets * MCE_DEFAULT_SRC_PORT_STRIDE) - 2);
+    m_match_value.src_port = static_cast<uint16_t>(m_steering_index * MCE_DEFAULT_SRC_PORT_STRIDE);
 
-    rfs_logdbg("secondary rule src_port_stride: %d workers_num %d \n", MCE_DEFAULT_SRC_PORT_STRIDE,
-               safe_mce_sys().worker_threads);
+    m_priority = 2;
+    rfs_logdbg("reuseport bucket %d of %d", m_steering_index, buckets);
 }
 
-bool rfs_uc::if_secondary_rule_needed()
+void rfs_uc::prepare_flow_spec_extra_rule(uint32_t index)
 {
+    int bucket = m_steering_index + (index + 1) * safe_mce_sys().worker_threads;
 
-    if (safe_mce_sys().worker_threads == 0) {
-        return false;
-    }
+    // We use the same m_match_mask as the first rule.
+    m_match_value.src_port = static_cast<uint16_t>(bucket * MCE_DEFAULT_SRC_PORT_STRIDE);
 
-    if (m_steering_index < 0 || !m_flow_tuple.is_3_tuple()) {
-        return false;
+    rfs_logdbg("extra rule src_port_stride: %d bucket %d \n", MCE_DEFAULT_SRC_PORT_STRIDE,
+               bucket);
+}
+
+uint32_t rfs_uc::get_extra_rules_num()
+{
+    if (safe_mce_sys().worker_threads == 0 || m_flow_tuple.get_protocol() == PROTO_UDP) {
+        return 0U;
     }
 
-    int entity_context_pow2 = entity_context_manager::calculate_entity_context_pow2();
-    if (safe_mce_sys().worker_threads == entity_context_pow2) {
-        return false;
+    if (m_steering_index < 0 || !m_flow_tuple.is_3_tuple()) {
+        return 0U;
     }
 
-    // Only certain rss_child listen sockets/workers get the secondary rule to balance load
-    return (m_steering_index < (entity_context_pow2 % safe_mce_sys().worker_threads));
+    // The listen RSS children own the same number of buckets, up to one
+    int buckets = entity_context_manager::calculate_listen_child_buckets(m_steering_index);
+    return buckets > 1 ? static_cast<uint32_t>(buckets - 1) : 0U;
 }
 
 bool rfs_uc::rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array)
 {
+    XLIO_TRACE(rfs_dispatch, this, p_rx_wc_buf_desc, m_n_sinks_list_entries);
+    XLIO_TRACE_RING(TRACE_EVENT_RFS_DISPATCH, this, m_n_sinks_list_entries);
     p_rx_wc_buf_desc->reset_ref_count();
     for (uint32_t i = 0; i < m_n_sinks_list_entries; ++i) {
         if (likely(m_sinks_list[i])) {
+            if (unlikely(m_sinks_list[i]->is_rx_over_limit()) &&
+                m_sinks_list[i]->rx_over_limit_drop(p_rx_wc_buf_desc)) {
+                continue;
+            }
             bool consumed = m_sinks_list[i]->rx_input_cb(p_rx_wc_buf_desc, pv_fd_ready_array);
             if (consumed) {
                 // The sink will be responsible to return the buffer to CQ for reuse
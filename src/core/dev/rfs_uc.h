@@ -25,13 +25,14 @@ public:
     virtual bool rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc,
                                     void *pv_fd_ready_array) override;
     virtual void prepare_flow_spec_worker_thread_mode() override;
-    virtual void prepare_flow_spec_secondary_rule() override;
-    virtual bool if_secondary_rule_needed() override;
+    virtual uint32_t get_extra_rules_num() override;
+    virtual void prepare_flow_spec_extra_rule(uint32_t index) override;
 
 protected:
     virtual void prepare_flow_spec() override;
+    void prepare_flow_spec_udp_reuseport();
 
-    // RSS child listen socket - Threads mode parameter
+    // RSS child listen socket - Threads mode parameter, or the bucket of a UDP reuseport socket
     int m_steering_index = -1; // -1 means not a rss_child listen socket
 };
 
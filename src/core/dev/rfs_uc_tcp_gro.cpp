@@ -30,9 +30,10 @@ inline bool ipv4_check(const struct iphdr &p_ip_h)
     return (p_ip_h.ihl == IP_H_LEN_NO_OPTIONS);
 }
 
+// The flow label is compared to the one of the stream, as the extension headers aren't parsed
 inline bool ipv6_check(const struct ip6_hdr &p_ip6_h)
 {
-    return (likely(0U == ipv6_get_flowid(p_ip6_h)) && likely(p_ip6_h.ip6_nxt == IPPROTO_TCP));
+    return likely(p_ip6_h.ip6_nxt == IPPROTO_TCP);
 }
 
 rfs_uc_tcp_gro::rfs_uc_tcp_gro(flow_tuple *flow_spec_5t, ring_slave *p_ring,
@@ -56,6 +57,17 @@ rfs_uc_tcp_gro::rfs_uc_tcp_gro(flow_tuple *flow_spec_5t, ring_slave *p_ring,
     memset(&m_gro_desc, 0, sizeof(m_gro_desc));
 }
 
+rfs_uc_tcp_gro::~rfs_uc_tcp_gro()
+{
+    /* With a flush deadline an aggregate may outlive the poll. The sinks are gone, so the
+     * flush returns its buffers to the ring.
+     */
+    if (m_b_reserved) {
+        m_p_gro_mgr->remove_stream(this);
+    }
+    flush_gro_desc(nullptr);
+}
+
 bool rfs_uc_tcp_gro::rx_dispatch_packet(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info,
                                         void *pv_fd_ready_array /* = NULL */)
 {
@@ -64,6 +76,7 @@ bool rfs_uc_tcp_gro::rx_dispatch_packet(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_in
     struct tcphdr *p_tcp_h = p_rx_pkt_mem_buf_desc_info->rx.tcp.p_tcp_h;
     uint16_t explicit_hdr_len; // L3 header size is not included in IPv6 payload field.
     uint16_t tot_len;
+    uint32_t flow_label = 0U;
 
     if (!m_b_active) {
         if (!m_b_reserved && m_p_gro_mgr->is_stream_max()) {
@@ -91,6 +104,7 @@ bool rfs_uc_tcp_gro::rx_dispatch_packet(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_in
 
         // For IPv6 we keep tracking in GRO the tot-len without the header size.
         tot_len = ntohs(p_ip6_h->ip6_plen);
+        flow_label = ipv6_get_flowid(*p_ip6_h);
     }
 
     if (unlikely(!tcp_check(p_rx_pkt_mem_buf_desc_info, p_tcp_h))) {
@@ -98,13 +112,20 @@ bool rfs_uc_tcp_gro::rx_dispatch_packet(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_in
     }
 
     if (unlikely(!m_b_active)) {
+        // A pushed segment has nothing to wait for
+        if (p_tcp_h->psh) {
+            goto out;
+        }
         if (!m_b_reserved) {
             m_b_reserved = m_p_gro_mgr->reserve_stream(this);
         }
         init_gro_desc(p_rx_pkt_mem_buf_desc_info, tot_len, p_tcp_h);
+        m_gro_desc.flow_label = flow_label;
         m_b_active = true;
     } else {
-        if ((ntohl(p_tcp_h->seq) != m_gro_desc.next_seq) || !timestamp_check(p_tcp_h)) {
+        if ((ntohl(p_tcp_h->seq) != m_gro_desc.next_seq) ||
+            p_tcp_h->doff != m_gro_desc.p_tcp_h->doff || flow_label != m_gro_desc.flow_label ||
+            !timestamp_check(p_tcp_h)) {
             goto out;
         }
 
@@ -117,9 +138,9 @@ bool rfs_uc_tcp_gro::rx_dispatch_packet(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_in
         }
 
         /* Flush gro packet immediately in case
-         * total number of agreggated packets exceeds limit
+         * total number of agreggated packets exceeds limit or the sender pushed the data
          */
-        if (m_gro_desc.buf_count >= m_n_buf_max) {
+        if (m_gro_desc.buf_count >= m_n_buf_max || m_gro_desc.psh) {
             flush_gro_desc(pv_fd_ready_array);
         }
     }
@@ -153,6 +174,7 @@ bool rfs_uc_tcp_gro::add_packet(mem_buf_desc_t *mem_buf_desc, void *payload_ptr,
     m_gro_desc.next_seq += mem_buf_desc->rx.sz_payload;
     m_gro_desc.wnd = p_tcp_h->window;
     m_gro_desc.ack = p_tcp_h->ack_seq;
+    m_gro_desc.psh = p_tcp_h->psh;
 
     uint32_t *topt;
     if (m_gro_desc.ts_present) {
@@ -200,6 +222,7 @@ void rfs_uc_tcp_gro::flush_gro_desc(void *pv_fd_ready_array)
         }
         m_gro_desc.p_tcp_h->ack_seq = m_gro_desc.ack;
         m_gro_desc.p_tcp_h->window = m_gro_desc.wnd;
+        m_gro_desc.p_tcp_h->psh = m_gro_desc.psh;
 
         if (m_gro_desc.ts_present) {
             tcphdr_ts *p_tcp_ts_h = (tcphdr_ts *)m_gro_desc.p_tcp_h;
@@ -251,6 +274,10 @@ void rfs_uc_tcp_gro::init_gro_desc(mem_buf_desc_t *mem_buf_desc, uint16_t ip_tot
     m_gro_desc.ack = p_tcp_h->ack_seq;
     m_gro_desc.next_seq = ntohl(p_tcp_h->seq) + mem_buf_desc->rx.sz_payload;
     m_gro_desc.wnd = p_tcp_h->window;
+    m_gro_desc.psh = false;
+    if (m_p_gro_mgr->get_flush_tsc()) {
+        gettimeoftsc(&m_gro_desc.tsc_first);
+    }
     m_gro_desc.ts_present = 0;
     if (p_tcp_h->doff == TCP_H_LEN_TIMESTAMP) {
         uint32_t *topt = (uint32_t *)(p_tcp_h + 1);
@@ -304,12 +331,15 @@ bool rfs_uc_tcp_gro::timestamp_check(tcphdr *p_tcp_h)
 
         topt++;
 
-        if (ntohl(*topt) < ntohl(m_gro_desc.tsval)) {
+        // The merged segment carries the first TSval, a later segment must not go back
+        if (static_cast<int32_t>(ntohl(*topt) - ntohl(m_gro_desc.tsval)) < 0) {
+            return false;
         }
 
         topt++;
 
-        if (*topt == 0) {
+        // It carries the last TSecr, which must not go back either
+        if (*topt == 0 || static_cast<int32_t>(ntohl(*topt) - ntohl(m_gro_desc.tsecr)) < 0) {
             return false;
         }
     }
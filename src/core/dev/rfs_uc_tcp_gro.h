@@ -9,6 +9,7 @@
 
 #include "dev/rfs_uc.h"
 #include <netinet/tcp.h>
+#include "utils/rdtsc.h"
 
 #define IP_H_LEN_NO_OPTIONS    5
 #define IP6_H_LEN_BYTES_NO_EXT 40
@@ -26,8 +27,11 @@ struct gro_mem_buf_desc {
     uint32_t ts_present;
     uint32_t tsval;
     uint32_t tsecr;
+    uint32_t flow_label; // IPv6 only
+    tscval_t tsc_first; // Arrival of the first segment, taken with a flush deadline only
     uint16_t ip_tot_len;
     uint16_t wnd;
+    bool psh;
 } typedef gro_mem_buf_desc_t;
 
 class gro_mgr;
@@ -44,10 +48,15 @@ public:
     rfs_uc_tcp_gro(flow_tuple *flow_spec_5t, ring_slave *p_ring,
                    rfs_rule_filter *rule_filter = nullptr, uint32_t flow_tag_id = 0,
                    int steering_index = -1);
+    virtual ~rfs_uc_tcp_gro();
 
     virtual bool rx_dispatch_packet(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array);
 
     void flush(void *pv_fd_ready_array);
+    bool is_expired(tscval_t now, tscval_t flush_tsc) const
+    {
+        return !m_b_active || now - m_gro_desc.tsc_first >= flush_tsc;
+    }
 
 private:
     inline void flush_gro_desc(void *pv_fd_ready_array);
@@ -89,7 +89,17 @@ public:
     // @return Zero - Not drained, Positive - Drained with packets, Negative - No packets.
     virtual int poll_and_process_element_tx(uint64_t *p_cq_poll_sn) = 0;
 
+    // Cheap hint checked before an RX poll, false only if the poll would find nothing to do.
+    virtual bool has_rx_work() { return true; }
+
+    // Aggregate of the socket latency histograms, nullptr if the ring has no own statistics.
+    virtual lat_hists_t *get_lat_hists() { return nullptr; }
+    // Aggregate of the TCP loss statistics of the sockets, nullptr likewise.
+    virtual tcp_loss_stats_t *get_tcp_loss_stats() { return nullptr; }
+
     virtual void adapt_cq_moderation() = 0;
+    /* Install the steering rules postponed by attach_flow(), called by the internal thread. */
+    virtual void flush_deferred_rules() {}
     virtual void mem_buf_desc_return_single_to_owner_tx(mem_buf_desc_t *p_mem_buf_desc) = 0;
     virtual void mem_buf_desc_return_single_multi_ref(mem_buf_desc_t *p_mem_buf_desc,
                                                       unsigned ref) = 0;
@@ -145,6 +155,11 @@ public:
         NOT_IN_USE(tir);
         return NULL;
     }
+    virtual void tls_context_post_tx(const xlio_tls_info *info, xlio_tis *tis)
+    {
+        NOT_IN_USE(info);
+        NOT_IN_USE(tis);
+    }
     virtual void tls_context_resync_tx(const xlio_tls_info *info, xlio_tis *tis, bool skip_static)
     {
         NOT_IN_USE(info);
@@ -199,6 +214,16 @@ public:
     }
     virtual void credits_return(unsigned credits) { NOT_IN_USE(credits); }
 
+    // Doorbell batching, the doorbell of all the sends in between is rung once by the end call.
+    virtual void tx_doorbell_batch_begin() {}
+    virtual void tx_doorbell_batch_end() {}
+
+    // Maximum number of RX CQEs processed by a single poll, zero means the default budget.
+    virtual void set_rx_poll_budget(uint32_t budget) { NOT_IN_USE(budget); }
+
+    // Ultra API filter of the received packets, called before the steering. nullptr removes it.
+    virtual void set_rx_filter(xlio_rx_filter_cb_t cb) { NOT_IN_USE(cb); }
+
     struct tcp_seg *get_tcp_segs(uint32_t num);
     void put_tcp_segs(struct tcp_seg *seg);
 
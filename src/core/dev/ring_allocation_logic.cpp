@@ -6,6 +6,9 @@
 
 #include "dev/ring_allocation_logic.h"
 
+#include <mutex>
+#include <vector>
+
 #define MODULE_NAME "ral"
 
 #undef MODULE_HDR_INFO
@@ -68,6 +71,9 @@ uint64_t ring_allocation_logic::calc_res_key_by_logic()
     case RING_LOGIC_PER_CORE_ATTACH_THREADS:
         res_key = sched_getcpu();
         break;
+    case RING_LOGIC_PER_CORE_POOL:
+        res_key = g_cpu_manager.get_core_pool_ring(sched_getcpu());
+        break;
         BULLSEYE_EXCLUDE_BLOCK_START
     case RING_LOGIC_PER_OBJECT:
         res_key = reinterpret_cast<uint64_t>(m_source.m_object);
@@ -148,6 +154,20 @@ bool ring_allocation_logic::should_migrate_ring()
     return true;
 }
 
+void ring_allocation_logic::expect_migration()
+{
+    if (m_ring_migration_ratio < 0) {
+        return;
+    }
+
+    uint64_t new_id = calc_res_key_by_logic();
+    if (new_id != m_res_key.get_user_id_key()) {
+        // The candidate passes its stability rounds with the next check from the same thread
+        m_migration_candidate = new_id;
+        m_migration_try_count = CANDIDATE_STABILITY_ROUNDS;
+    }
+}
+
 const std::string ring_allocation_logic::to_str() const
 {
     std::stringstream ss;
@@ -176,6 +196,61 @@ void cpu_manager::reset()
     memset(m_cpu_thread_count, 0, sizeof(m_cpu_thread_count));
 }
 
+static int read_cpu_topology(int cpu, const char *name)
+{
+    char path[128];
+    int val = -1;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+    FILE *file = fopen(path, "r");
+    if (file) {
+        if (fscanf(file, "%d", &val) != 1) {
+            val = -1;
+        }
+        fclose(file);
+    }
+    return val;
+}
+
+void cpu_manager::init_core_pool()
+{
+    std::lock_guard<cpu_manager> lock(*this);
+
+    if (m_core_pool_ready.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // The physical cores by the package and the core id, in the order of their first CPU
+    std::vector<std::pair<int, int>> cores;
+    cpu_set_t cpuset;
+
+    if (sched_getaffinity(0, sizeof(cpuset), &cpuset) != 0) {
+        CPU_ZERO(&cpuset);
+    }
+    for (int cpu = 0; cpu < MAX_CPU; ++cpu) {
+        m_cpu_core[cpu] = -1;
+        if (!CPU_ISSET(cpu, &cpuset)) {
+            continue;
+        }
+        std::pair<int, int> core(read_cpu_topology(cpu, "physical_package_id"),
+                                 read_cpu_topology(cpu, "core_id"));
+        if (core.second < 0) {
+            // No topology, every CPU is a core
+            core = std::make_pair(-1, cpu);
+        }
+        auto iter = std::find(cores.begin(), cores.end(), core);
+        m_cpu_core[cpu] = static_cast<int>(iter - cores.begin());
+        if (iter == cores.end()) {
+            cores.push_back(core);
+        }
+    }
+
+    m_core_pool_size = safe_mce_sys().ring_core_pool_size
+        ?: std::max<uint32_t>(static_cast<uint32_t>(cores.size()), 1U);
+    __log_dbg("Core pool of %u rings for %zu physical cores", m_core_pool_size, cores.size());
+    m_core_pool_ready.store(true, std::memory_order_release);
+}
+
 int cpu_manager::reserve_cpu_for_thread(pthread_t tid, int suggested_cpu /* = NO_CPU */)
 {
     lock();
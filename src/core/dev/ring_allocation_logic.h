@@ -7,6 +7,9 @@
 #ifndef RING_ALLOCATION_LOGIC_H_
 #define RING_ALLOCATION_LOGIC_H_
 
+#include <algorithm>
+#include <atomic>
+
 #include "utils/bullseye.h"
 #include "vlogger/vlogger.h"
 #include "dev/net_device_table_mgr.h"
@@ -92,11 +95,14 @@ public:
     resource_allocation_key *get_key() { return &m_res_key; }
 
     bool should_migrate_ring();
+    /* Another ring of the object migrated to the current thread, follow on the next check */
+    void expect_migration();
     bool is_logic_support_migration()
     {
         return m_ring_migration_ratio > 0 &&
-            m_res_key.get_ring_alloc_logic() >= RING_LOGIC_PER_THREAD &&
-            m_res_key.get_ring_alloc_logic() < RING_LOGIC_PER_OBJECT;
+            ((m_res_key.get_ring_alloc_logic() >= RING_LOGIC_PER_THREAD &&
+              m_res_key.get_ring_alloc_logic() < RING_LOGIC_PER_OBJECT) ||
+             m_res_key.get_ring_alloc_logic() == RING_LOGIC_PER_CORE_POOL);
     }
     uint64_t calc_res_key_by_logic();
     inline ring_logic_t get_alloc_logic_type() { return m_res_key.get_ring_alloc_logic(); }
@@ -151,8 +157,34 @@ public:
     void reset();
     int reserve_cpu_for_thread(pthread_t tid, int suggested_cpu = NO_CPU);
 
+    /*
+     * The ring of a CPU in the core pool logic. The CPUs the process may run on are numbered by
+     * their physical core, the hyperthreads of a core get the same ring.
+     */
+    uint32_t get_core_pool_ring(int cpu)
+    {
+        if (!m_core_pool_ready.load(std::memory_order_acquire)) {
+            init_core_pool();
+        }
+        int core = (cpu >= 0 && cpu < MAX_CPU && m_cpu_core[cpu] >= 0) ? m_cpu_core[cpu]
+                                                                          : std::max(cpu, 0);
+        return static_cast<uint32_t>(core) % m_core_pool_size;
+    }
+    uint32_t get_core_pool_size()
+    {
+        if (!m_core_pool_ready.load(std::memory_order_acquire)) {
+            init_core_pool();
+        }
+        return m_core_pool_size;
+    }
+
 private:
+    void init_core_pool();
+
     int m_cpu_thread_count[MAX_CPU];
+    int m_cpu_core[MAX_CPU];
+    uint32_t m_core_pool_size = 1U;
+    std::atomic<bool> m_core_pool_ready {false};
 };
 
 #endif /* RING_ALLOCATION_LOGIC_H_ */
@@ -7,6 +7,7 @@
 #include "ring_bond.h"
 #include "sock/sockinfo.h"
 #include "dev/ring_simple.h"
+#include "utils/rdtsc.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "ring_bond"
@@ -130,6 +131,9 @@ void ring_bond::restart()
 
     ring_logdbg("*** ring restart! ***");
 
+    tscval_t start_tsc;
+    gettimeoftsc(&start_tsc);
+
     m_lock_ring_rx.lock();
     m_lock_ring_tx.lock();
 
@@ -167,7 +171,11 @@ void ring_bond::restart()
                 m_bond_rings[i]->m_active = true;
             } else {
                 ring_logdbg("ring %d not active", i);
-                if (slaves[j]->lag_tx_port_affinity != 1) {
+                /* With the warm standby the queues of the backup slaves stay up,
+                 * so the failover is only the switch of m_xmit_rings below
+                 */
+                if (slaves[j]->lag_tx_port_affinity != 1 &&
+                    !safe_mce_sys().ring_bond_warm_standby) {
                     /* coverity[sleep] */
                     tmp_ring->stop_active_queue_tx();
                     /* coverity[sleep] */
@@ -210,10 +218,18 @@ void ring_bond::restart()
         }
     }
 
+    tscval_t end_tsc;
+    gettimeoftsc(&end_tsc);
+    uint32_t failover_usec = static_cast<uint32_t>(
+        (end_tsc - start_tsc) * 1000000U / std::max<tscval_t>(get_tsc_rate_per_second(), 1U));
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        m_bond_rings[i]->update_failover_stats(failover_usec);
+    }
+
     m_lock_ring_tx.unlock();
     m_lock_ring_rx.unlock();
 
-    ring_logdbg("*** ring restart done! ***");
+    ring_logdbg("*** ring restart done in %u usec! ***", failover_usec);
 }
 
 void ring_bond::adapt_cq_moderation()
@@ -231,6 +247,19 @@ void ring_bond::adapt_cq_moderation()
     m_lock_ring_rx.unlock();
 }
 
+void ring_bond::flush_deferred_rules()
+{
+    if (m_lock_ring_rx.trylock()) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        m_bond_rings[i]->flush_deferred_rules();
+    }
+
+    m_lock_ring_rx.unlock();
+}
+
 mem_buf_desc_t *ring_bond::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbuf_type type,
                                           int n_num_mem_bufs /* default = 1 */,
                                           bool tx_skip_poll /* default = false */)
@@ -739,6 +768,42 @@ int ring_bond::modify_ratelimit(struct xlio_rate_limit_t &rate_limit)
     return 0;
 }
 
+void ring_bond::tx_doorbell_batch_begin()
+{
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        if (m_bond_rings[i]) {
+            m_bond_rings[i]->tx_doorbell_batch_begin();
+        }
+    }
+}
+
+void ring_bond::tx_doorbell_batch_end()
+{
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        if (m_bond_rings[i]) {
+            m_bond_rings[i]->tx_doorbell_batch_end();
+        }
+    }
+}
+
+void ring_bond::set_rx_poll_budget(uint32_t budget)
+{
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        if (m_bond_rings[i]) {
+            m_bond_rings[i]->set_rx_poll_budget(budget);
+        }
+    }
+}
+
+void ring_bond::set_rx_filter(xlio_rx_filter_cb_t cb)
+{
+    for (uint32_t i = 0; i < m_bond_rings.size(); i++) {
+        if (m_bond_rings[i]) {
+            m_bond_rings[i]->set_rx_filter(cb);
+        }
+    }
+}
+
 uint32_t ring_bond::get_max_inline_data()
 {
     return m_max_inline_data;
@@ -36,6 +36,7 @@ public:
                                             void *pv_fd_ready_array = nullptr);
     virtual int poll_and_process_element_tx(uint64_t *p_cq_poll_sn);
     virtual void adapt_cq_moderation();
+    virtual void flush_deferred_rules();
     virtual bool reclaim_recv_buffers(descq_t *rx_reuse);
     virtual bool reclaim_recv_buffers(mem_buf_desc_t *rx_reuse_lst);
     virtual void mem_buf_rx_release(mem_buf_desc_t *p_mem_buf_desc);
@@ -64,6 +65,10 @@ public:
                                        const ip_address &src_ip, const ip_address &dst_ip,
                                        uint16_t src_port, uint16_t dst_port);
     virtual int modify_ratelimit(struct xlio_rate_limit_t &rate_limit);
+    virtual void tx_doorbell_batch_begin();
+    virtual void tx_doorbell_batch_end();
+    virtual void set_rx_poll_budget(uint32_t budget);
+    virtual void set_rx_filter(xlio_rx_filter_cb_t cb);
     /* XXX TODO We have to support ring_bond for zerocopy. */
     virtual uint32_t get_tx_user_lkey(void *addr, size_t length)
     {
@@ -9,7 +9,14 @@
 
 #include "util/valgrind.h"
 #include "util/sg_array.h"
+#include "util/trace_ring.h"
+#include "util/pkt_mirror.h"
+#include "utils/rdtsc.h"
 #include "sock/fd_collection.h"
+#include "event/poll_group.h"
+#include "dev/pacing_wheel.h"
+#include "dev/tls_dek_pool.h"
+#include "sock/tx_ts_sink.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "ring_simple"
@@ -36,6 +43,21 @@
 /** inlining functions can only help if they are implemented before their usage **/
 /**/
 
+inline void ring_simple::update_odp_stats(const xlio_ibv_send_wr *p_send_wqe)
+{
+    uint64_t odp_bytes = 0;
+
+    for (int i = 0; i < p_send_wqe->num_sge; ++i) {
+        if (m_p_ib_ctx->is_odp_lkey(p_send_wqe->sg_list[i].lkey)) {
+            odp_bytes += p_send_wqe->sg_list[i].length;
+        }
+    }
+    if (odp_bytes) {
+        ++m_p_ring_stat->n_tx_odp_pkt_count;
+        m_p_ring_stat->n_tx_odp_byte_count += odp_bytes;
+    }
+}
+
 inline void ring_simple::send_status_handler(int ret, xlio_ibv_send_wr *p_send_wqe)
 {
     BULLSEYE_EXCLUDE_BLOCK_START
@@ -50,10 +72,19 @@ inline void ring_simple::send_status_handler(int ret, xlio_ibv_send_wr *p_send_w
         sg_array sga(p_send_wqe->sg_list, p_send_wqe->num_sge);
         m_p_ring_stat->n_tx_byte_count += sga.length();
         ++m_p_ring_stat->n_tx_pkt_count;
+        if (unlikely(m_p_ib_ctx->get_odp_lkey() != LKEY_ERROR)) {
+            update_odp_stats(p_send_wqe);
+        }
 
         // Decrease counter in order to keep track of how many missing buffers we have when
         // doing ring->restart() and then drain_tx_buffers_to_buffer_pool()
         m_missing_buf_ref_count--;
+        mem_buf_desc_t *p_desc = (mem_buf_desc_t *)(p_send_wqe->wr_id);
+        if (unlikely(p_desc->m_flags & mem_buf_desc_t::TX_CHAIN)) {
+            for (p_desc = p_desc->p_next_desc; p_desc; p_desc = p_desc->p_next_desc) {
+                m_missing_buf_ref_count--;
+            }
+        }
     }
     BULLSEYE_EXCLUDE_BLOCK_END
 }
@@ -61,7 +92,7 @@ inline void ring_simple::send_status_handler(int ret, xlio_ibv_send_wr *p_send_w
 ring_simple::ring_simple(int if_index, ring *parent, bool use_locks)
     : ring_slave(if_index, parent, use_locks)
     , m_lock_ring_tx_buf_wait("ring:lock_tx_buf_wait")
-    , m_gro_mgr(safe_mce_sys().gro_streams_max, MAX_GRO_BUFS)
+    , m_gro_mgr(safe_mce_sys().gro_streams_max, MAX_GRO_BUFS, safe_mce_sys().gro_flush_usec)
 {
     net_device_val *p_ndev = g_p_net_device_table_mgr->get_net_device_val(m_parent->get_if_index());
     BULLSEYE_EXCLUDE_BLOCK_START
@@ -100,7 +131,15 @@ ring_simple::ring_simple(int if_index, ring *parent, bool use_locks)
     memset(&m_lro, 0, sizeof(m_lro));
 
     m_vlan = p_ndev->get_vlan();
-    create_resources();
+
+    m_numa_node = m_p_ib_ctx->get_numa_node();
+    m_p_ring_stat->n_numa_node = m_numa_node;
+    {
+        // Queues and ring objects are placed on the node of the device instead of the caller's
+        numa_preferred_scope numa_scope(safe_mce_sys().ring_numa_aware ? m_numa_node : -1);
+        create_resources();
+    }
+    m_p_ring_stat->n_queue_page_size = static_cast<uint32_t>(m_p_ib_ctx->get_queue_page_size());
 }
 
 ring_simple::~ring_simple()
@@ -283,6 +322,25 @@ void ring_simple::create_resources()
                      : safe_mce_sys().rx_buf_size);
             m_lro.max_payload_sz =
                 std::min(actual_buf_size, XLIO_MLX5_PARAMS_LRO_PAYLOAD_SIZE) / 256U * 256U;
+
+            /* Use the longest supported period within the default timeout,
+             * otherwise the shortest supported one.
+             */
+            m_lro.timeout_period = XLIO_MLX5_PARAMS_LRO_TIMEOUT;
+            uint8_t longest = 0U;
+            uint8_t shortest = 0U;
+            for (int i = 0; i < XLIO_MLX5_PARAMS_LRO_TIMEOUT_ARRAY_SIZE; i++) {
+                uint8_t period = m_lro.timer_supported_periods[i];
+                if (period && period <= XLIO_MLX5_PARAMS_LRO_TIMEOUT && period > longest) {
+                    longest = period;
+                }
+                if (period && (!shortest || period < shortest)) {
+                    shortest = period;
+                }
+            }
+            if (longest || shortest) {
+                m_lro.timeout_period = longest ? longest : shortest;
+            }
         }
     }
     ring_logdbg("ring attributes: m_lro = %d", m_lro.cap);
@@ -294,6 +352,7 @@ void ring_simple::create_resources()
                 m_lro.timer_supported_periods[0], m_lro.timer_supported_periods[1],
                 m_lro.timer_supported_periods[2], m_lro.timer_supported_periods[3]);
     ring_logdbg("ring attributes: m_lro:max_payload_sz = %d", m_lro.max_payload_sz);
+    ring_logdbg("ring attributes: m_lro:timeout_period = %d", m_lro.timeout_period);
 
 #ifdef DEFINED_UTLS
     {
@@ -307,6 +366,11 @@ void ring_simple::create_resources()
         ring_logdbg("ring attributes: m_tls:tls_tx = %d", m_tls.tls_tx);
         ring_logdbg("ring attributes: m_tls:tls_rx = %d", m_tls.tls_rx);
         ring_logdbg("ring attributes: m_tls:tls_synchronize_dek = %d", m_tls.tls_synchronize_dek);
+        // The first ring fills the pool ahead of the TLS connections
+        if (m_tls.tls_tx && m_tls.tls_synchronize_dek && safe_mce_sys().enable_utls_tx &&
+            safe_mce_sys().utls_dek_pool_size) {
+            m_p_ib_ctx->get_tls_dek_pool();
+        }
     }
 #endif /* DEFINED_UTLS */
 
@@ -365,13 +429,17 @@ void ring_simple::create_resources()
     if (safe_mce_sys().cq_moderation_enable) {
         modify_cq_moderation(safe_mce_sys().cq_moderation_period_usec,
                              safe_mce_sys().cq_moderation_count);
+        if (safe_mce_sys().cq_aim_interval_msec != MCE_CQ_ADAPTIVE_MODERATION_DISABLED) {
+            m_cq_moderation_info.target_latency_usec = safe_mce_sys().cq_aim_target_latency_usec;
+        }
     }
 
     /* For RoCE LAG device income data is processed by single ring only
      * Consider using ring related slave with lag_tx_port_affinity = 1
      * even if slave is not active
      */
-    if (p_slave->active || (p_slave->lag_tx_port_affinity == 1)) {
+    if (p_slave->active || (p_slave->lag_tx_port_affinity == 1) ||
+        safe_mce_sys().ring_bond_warm_standby) {
         start_active_queue_tx();
         start_active_queue_rx();
     }
@@ -396,23 +464,49 @@ int ring_simple::request_notification(cq_type_t cq_type, uint64_t poll_sn)
     return ret;
 }
 
-int ring_simple::poll_and_process_element_rx(uint64_t *p_cq_poll_sn,
-                                             void *pv_fd_ready_array /*NULL*/)
+template <typename Lock>
+int ring_simple::poll_and_process_element_rx_tmpl(uint64_t *p_cq_poll_sn, void *pv_fd_ready_array)
 {
     int ret = 0; // CQ was not drained.
-    if (!m_lock_ring_rx.trylock()) {
+
+    g_pacing_wheel.process();
+    if (!Lock::trylock(m_lock_ring_rx)) {
+        uint64_t polled = m_p_cq_mgr_rx->get_polled_cqes();
         ret = m_p_cq_mgr_rx->poll_and_process_element_rx(p_cq_poll_sn, pv_fd_ready_array);
-        m_lock_ring_rx.unlock();
+        flush_pending_acks();
+        if (ret >= 0) {
+            uint32_t cqes = static_cast<uint32_t>(m_p_cq_mgr_rx->get_polled_cqes() - polled);
+            m_p_ring_stat->n_rx_poll_cqes += cqes;
+            m_p_ring_stat->n_rx_poll_budget_hits += (ret == 0);
+            if (unlikely(m_cq_moderation_info.target_latency_usec) && cqes) {
+                record_rx_burst(cqes);
+            }
+        }
+        Lock::unlock(m_lock_ring_rx);
+    } else {
+        XLIO_TRACE_RING(TRACE_EVENT_LOCK_BUSY, this, 0U);
     }
     return ret;
 }
 
+int ring_simple::poll_and_process_element_rx(uint64_t *p_cq_poll_sn,
+                                             void *pv_fd_ready_array /*NULL*/)
+{
+    return m_b_use_locks
+        ? poll_and_process_element_rx_tmpl<ring_lock_policy_real>(p_cq_poll_sn, pv_fd_ready_array)
+        : poll_and_process_element_rx_tmpl<ring_lock_policy_none>(p_cq_poll_sn, pv_fd_ready_array);
+}
+
 int ring_simple::poll_and_process_element_tx(uint64_t *p_cq_poll_sn)
 {
     int ret = 0; // CQ was not drained - If trylock fails.
+
+    g_pacing_wheel.process();
     if (!m_lock_ring_tx.trylock()) {
         ret = m_p_cq_mgr_tx->poll_and_process_element_tx(p_cq_poll_sn);
         m_lock_ring_tx.unlock();
+    } else {
+        XLIO_TRACE_RING(TRACE_EVENT_LOCK_BUSY, this, 1U);
     }
     return ret;
 }
@@ -422,6 +516,7 @@ void ring_simple::wait_for_notification_and_process_element(uint64_t *p_cq_poll_
 {
     m_lock_ring_rx.lock();
     m_p_cq_mgr_rx->wait_for_notification_and_process_element(p_cq_poll_sn, pv_fd_ready_array);
+    flush_pending_acks();
     ++m_p_ring_stat->n_rx_interrupt_received;
     m_lock_ring_rx.unlock();
 }
@@ -488,21 +583,26 @@ void ring_simple::mem_buf_desc_return_single_locked(mem_buf_desc_t *buff)
 int ring_simple::drain_and_proccess()
 {
     int ret = 0;
-    RING_TRY_LOCK_RUN_AND_UPDATE_RET(m_lock_ring_rx, m_p_cq_mgr_rx->drain_and_proccess());
+    if (!m_lock_ring_rx.trylock()) {
+        ret = m_p_cq_mgr_rx->drain_and_proccess();
+        flush_pending_acks();
+        m_lock_ring_rx.unlock();
+    } else {
+        errno = EAGAIN;
+    }
     return ret;
 }
 
-mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbuf_type type,
-                                            int n_num_mem_bufs /* default = 1 */,
-                                            bool tx_skip_poll /* default = false */)
+template <typename Lock>
+mem_buf_desc_t *ring_simple::mem_buf_tx_get_tmpl(bool b_block, pbuf_type type, int n_num_mem_bufs,
+                                                 bool tx_skip_poll)
 {
-    NOT_IN_USE(id);
     mem_buf_desc_t *buff_list = nullptr;
     uint64_t poll_sn = 0;
 
     ring_logfuncall("n_num_mem_bufs=%d", n_num_mem_bufs);
 
-    m_lock_ring_tx.lock();
+    Lock::lock(m_lock_ring_tx);
     buff_list = get_tx_buffers(type, n_num_mem_bufs);
     while (!buff_list) {
         int ret = -1;
@@ -519,10 +619,10 @@ mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbu
 
             // Only a single thread should block on next Tx cqe event, hence the dedicated lock!
             /* coverity[double_unlock] coverity[unlock] TODO: RM#1049980 */
-            m_lock_ring_tx.unlock();
-            m_lock_ring_tx_buf_wait.lock();
+            Lock::unlock(m_lock_ring_tx);
+            Lock::lock(m_lock_ring_tx_buf_wait);
             /* coverity[double_lock] TODO: RM#1049980 */
-            m_lock_ring_tx.lock();
+            Lock::lock(m_lock_ring_tx);
 
             // poll once more (in the hope that we get a few freed tx mem_buf_desc)
             buff_list = get_tx_buffers(type, n_num_mem_bufs);
@@ -543,22 +643,22 @@ mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbu
                     // Now it is time to release the ring lock (for restart events to be handled
                     // while this thread block on CQ channel)
                     /* coverity[double_unlock] coverity[unlock] TODO: RM#1049980 */
-                    m_lock_ring_tx.unlock();
+                    Lock::unlock(m_lock_ring_tx);
 
                     ret = SYSCALL(poll, &poll_fd, 1, 100);
                     if (ret == 0) {
-                        m_lock_ring_tx_buf_wait.unlock();
+                        Lock::unlock(m_lock_ring_tx_buf_wait);
                         /* coverity[double_lock] TODO: RM#1049980 */
-                        m_lock_ring_tx.lock();
+                        Lock::lock(m_lock_ring_tx);
                         buff_list = get_tx_buffers(type, n_num_mem_bufs);
                         continue;
                     } else if (ret < 0) {
                         ring_logdbg("failed blocking on cq_mgr_tx (errno=%d %m)", errno);
-                        m_lock_ring_tx_buf_wait.unlock();
+                        Lock::unlock(m_lock_ring_tx_buf_wait);
                         return nullptr;
                     }
                     /* coverity[double_lock] TODO: RM#1049980 */
-                    m_lock_ring_tx.lock();
+                    Lock::lock(m_lock_ring_tx);
 
                     // Find the correct cq_mgr_tx from the CQ event,
                     // It might not be the active_cq object since we have a single TX CQ comp
@@ -577,13 +677,13 @@ mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbu
                 buff_list = get_tx_buffers(type, n_num_mem_bufs);
             }
             /* coverity[double_unlock] TODO: RM#1049980 */
-            m_lock_ring_tx.unlock();
-            m_lock_ring_tx_buf_wait.unlock();
+            Lock::unlock(m_lock_ring_tx);
+            Lock::unlock(m_lock_ring_tx_buf_wait);
             /* coverity[double_lock] TODO: RM#1049980 */
-            m_lock_ring_tx.lock();
+            Lock::lock(m_lock_ring_tx);
         } else {
             // get out on non blocked socket
-            m_lock_ring_tx.unlock();
+            Lock::unlock(m_lock_ring_tx);
             return nullptr;
         }
     }
@@ -594,10 +694,20 @@ mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbu
     m_missing_buf_ref_count += n_num_mem_bufs;
 
     /* coverity[double_unlock] TODO: RM#1049980 */
-    m_lock_ring_tx.unlock();
+    Lock::unlock(m_lock_ring_tx);
     return buff_list;
 }
 
+mem_buf_desc_t *ring_simple::mem_buf_tx_get(ring_user_id_t id, bool b_block, pbuf_type type,
+                                            int n_num_mem_bufs /* default = 1 */,
+                                            bool tx_skip_poll /* default = false */)
+{
+    NOT_IN_USE(id);
+    return m_b_use_locks
+        ? mem_buf_tx_get_tmpl<ring_lock_policy_real>(b_block, type, n_num_mem_bufs, tx_skip_poll)
+        : mem_buf_tx_get_tmpl<ring_lock_policy_none>(b_block, type, n_num_mem_bufs, tx_skip_poll);
+}
+
 int ring_simple::mem_buf_tx_release(mem_buf_desc_t *p_mem_buf_desc_list, bool b_accounting,
                                     bool trylock /*=false*/)
 {
@@ -623,6 +733,42 @@ void ring_simple::mem_buf_rx_release(mem_buf_desc_t *p_mem_buf_desc)
     reclaim_recv_buffers(p_mem_buf_desc);
 }
 
+/*
+ * Copies a sent frame to the mirror ring: the inline headers of a TSO WQE and the SGEs, which are
+ * still owned by the sender. The timestamp is taken at the post, the TX completion comes later.
+ */
+void ring_simple::mirror_tx_packet(const xlio_ibv_send_wr *p_send_wqe)
+{
+    // More SGEs than the snap length needs aren't copied
+    struct iovec iov[8];
+    int iovcnt = 0;
+    size_t wire_len = 0U;
+
+    if (xlio_send_wr_opcode(*p_send_wqe) == XLIO_IBV_WR_TSO) {
+        iov[iovcnt++] = {p_send_wqe->tso.hdr, p_send_wqe->tso.hdr_sz};
+        wire_len += p_send_wqe->tso.hdr_sz;
+    }
+    for (int i = 0; i < p_send_wqe->num_sge; ++i) {
+        if (iovcnt < static_cast<int>(ARRAY_SIZE(iov))) {
+            iov[iovcnt++] = {reinterpret_cast<void *>(p_send_wqe->sg_list[i].addr),
+                             p_send_wqe->sg_list[i].length};
+        }
+        wire_len += p_send_wqe->sg_list[i].length;
+    }
+    if (!iovcnt) {
+        return;
+    }
+
+    size_t snap_len = pkt_mirror_select(PKT_MIRROR_DIR_TX, iov[0].iov_base, iov[0].iov_len);
+    if (snap_len) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        pkt_mirror_write(PKT_MIRROR_DIR_TX, static_cast<uint32_t>(get_if_index()),
+                         ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec, 0U, iov, iovcnt, snap_len,
+                         wire_len);
+    }
+}
+
 /* note that this function is inline, so keep it above the functions using it */
 inline int ring_simple::send_buffer(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
                                     xlio_tis *tis)
@@ -634,10 +780,16 @@ inline int ring_simple::send_buffer(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_pac
         (!is_set(attr, XLIO_TX_SKIP_POLL) &&
          is_available_qp_wr(is_set(attr, XLIO_TX_PACKET_BLOCK), credits))) {
         m_hqtx->send_wqe(p_send_wqe, attr, tis, credits);
+        if (unlikely(g_p_pkt_mirror)) {
+            mirror_tx_packet(p_send_wqe);
+        }
     } else {
         ring_logdbg("Silent packet drop, SQ is full!");
         ret = -1;
-        reinterpret_cast<mem_buf_desc_t *>(p_send_wqe->wr_id)->p_next_desc = nullptr;
+        mem_buf_desc_t *p_desc = reinterpret_cast<mem_buf_desc_t *>(p_send_wqe->wr_id);
+        if (likely(!(p_desc->m_flags & mem_buf_desc_t::TX_CHAIN))) {
+            p_desc->p_next_desc = nullptr;
+        }
         ++m_p_ring_stat->n_tx_dropped_wqes;
     }
     return ret;
@@ -659,16 +811,25 @@ void ring_simple::send_ring_buffer(ring_user_id_t id, xlio_ibv_send_wr *p_send_w
     send_status_handler(ret, p_send_wqe);
 }
 
-int ring_simple::send_lwip_buffer(ring_user_id_t id, xlio_ibv_send_wr *p_send_wqe,
-                                  xlio_wr_tx_packet_attr attr, xlio_tis *tis)
+template <typename Lock>
+int ring_simple::send_lwip_buffer_tmpl(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                                       xlio_tis *tis)
 {
-    NOT_IN_USE(id);
-    std::lock_guard<decltype(m_lock_ring_tx)> lock(m_lock_ring_tx);
+    Lock::lock(m_lock_ring_tx);
     int ret = send_buffer(p_send_wqe, attr, tis);
     send_status_handler(ret, p_send_wqe);
+    Lock::unlock(m_lock_ring_tx);
     return ret;
 }
 
+int ring_simple::send_lwip_buffer(ring_user_id_t id, xlio_ibv_send_wr *p_send_wqe,
+                                  xlio_wr_tx_packet_attr attr, xlio_tis *tis)
+{
+    NOT_IN_USE(id);
+    return m_b_use_locks ? send_lwip_buffer_tmpl<ring_lock_policy_real>(p_send_wqe, attr, tis)
+                         : send_lwip_buffer_tmpl<ring_lock_policy_none>(p_send_wqe, attr, tis);
+}
+
 /*
  * called under m_lock_ring_tx lock
  */
@@ -679,6 +840,9 @@ bool ring_simple::is_available_qp_wr(bool b_block, unsigned credits)
 
     // TODO credits_get() does TX polling. Call current method only for bocking mode?
 
+    // Deferred WQEs can't complete, ring the doorbell to get the credits back.
+    flush_tx_doorbell();
+
     do {
         // Try to poll once in the hope that we get space in SQ
         m_p_cq_mgr_tx->poll_and_process_element_tx(&poll_sn);
@@ -765,6 +929,46 @@ void ring_simple::inc_cq_moderation_stats()
     ++m_cq_moderation_info.packets;
 }
 
+static inline uint32_t cq_aim_hist_bucket(uint64_t value)
+{
+    return value ? std::min<uint32_t>(63U - __builtin_clzll(value), CQ_AIM_HIST_BUCKETS - 1U) : 0U;
+}
+
+// Returns the lower bound of the bucket which holds the given percentile.
+static uint32_t cq_aim_hist_percentile(const uint32_t *hist, uint32_t percent)
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < CQ_AIM_HIST_BUCKETS; ++i) {
+        total += hist[i];
+    }
+
+    uint64_t threshold = (total * percent + 99U) / 100U;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < CQ_AIM_HIST_BUCKETS; ++i) {
+        sum += hist[i];
+        if (sum >= threshold && sum) {
+            return 1U << i;
+        }
+    }
+    return 0U;
+}
+
+// Call under m_lock_ring_rx lock
+void ring_simple::record_rx_burst(uint32_t packets)
+{
+    static const tscval_t tsc_per_usec =
+        std::max<tscval_t>(get_tsc_rate_per_second() / 1000000U, 1U);
+    tscval_t now;
+
+    gettimeoftsc(&now);
+    if (m_cq_moderation_info.last_burst_tsc) {
+        uint64_t gap_usec = (now - m_cq_moderation_info.last_burst_tsc) / tsc_per_usec;
+        ++m_cq_moderation_info.gap_hist[cq_aim_hist_bucket(gap_usec)];
+    }
+    m_cq_moderation_info.last_burst_tsc = now;
+    ++m_cq_moderation_info.burst_hist[cq_aim_hist_bucket(packets)];
+}
+
 // call under m_lock_ring_tx lock
 mem_buf_desc_t *ring_simple::get_tx_buffers(pbuf_type type, uint32_t n_num_mem_bufs)
 {
@@ -821,14 +1025,25 @@ void ring_simple::return_to_global_pool()
         int return_bufs = m_tx_pool.size() / 2;
         m_tx_num_bufs -= return_bufs;
         m_p_ring_stat->n_tx_num_bufs = m_tx_num_bufs;
-        g_buffer_pool_tx->put_buffers_thread_safe(&m_tx_pool, return_bufs);
+        buffer_pool_cache *cache = m_p_group ? m_p_group->get_tx_buf_cache(PBUF_RAM) : nullptr;
+        if (cache) {
+            cache->put_buffers(&m_tx_pool, return_bufs);
+        } else {
+            g_buffer_pool_tx->put_buffers_thread_safe(&m_tx_pool, return_bufs);
+        }
     }
     if (unlikely(m_zc_pool.size() > (m_zc_num_bufs / 2) &&
                  m_zc_num_bufs >= RING_TX_BUFS_COMPENSATE * 2)) {
         int return_bufs = m_zc_pool.size() / 2;
         m_zc_num_bufs -= return_bufs;
         m_p_ring_stat->n_zc_num_bufs = m_zc_num_bufs;
-        g_buffer_pool_zc->put_buffers_thread_safe(&m_zc_pool, return_bufs);
+        buffer_pool_cache *cache =
+            m_p_group ? m_p_group->get_tx_buf_cache(PBUF_ZEROCOPY) : nullptr;
+        if (cache) {
+            cache->put_buffers(&m_zc_pool, return_bufs);
+        } else {
+            g_buffer_pool_zc->put_buffers_thread_safe(&m_zc_pool, return_bufs);
+        }
     }
 }
 
@@ -843,6 +1058,10 @@ int ring_simple::put_tx_buffer_helper(mem_buf_desc_t *buff)
     if (buff->tx.dev_mem_length) {
         m_hqtx->dm_release_data(buff);
     }
+    if (unlikely(buff->m_flags & mem_buf_desc_t::TX_TIMESTAMP)) {
+        // The WQE wasn't posted or completed, there is no timestamp to report
+        tx_ts_sink::release(buff, nullptr);
+    }
 
     // Potential race, ref is protected here by ring_tx lock, and in dst_entry_tcp &
     // sockinfo_tcp by tcp lock
@@ -854,10 +1073,18 @@ int ring_simple::put_tx_buffer_helper(mem_buf_desc_t *buff)
 
     if (buff->lwip_pbuf.ref == 0) {
         descq_t &pool = buff->lwip_pbuf.type == PBUF_ZEROCOPY ? m_zc_pool : m_tx_pool;
+        mem_buf_desc_t *chain =
+            (buff->m_flags & mem_buf_desc_t::TX_CHAIN) ? buff->p_next_desc : nullptr;
+        int freed = 1;
         buff->p_next_desc = nullptr;
         free_lwip_pbuf(&buff->lwip_pbuf);
         pool.push_back(buff);
-        return 1;
+        while (unlikely(chain)) {
+            mem_buf_desc_t *next = chain->p_next_desc;
+            freed += put_tx_buffer_helper(chain);
+            chain = next;
+        }
+        return freed;
     }
     return 0;
 }
@@ -870,6 +1097,12 @@ int ring_simple::put_tx_buffers(mem_buf_desc_t *buff_list)
 
     while (buff_list) {
         mem_buf_desc_t *next = buff_list->p_next_desc;
+        if (unlikely(buff_list->m_flags & mem_buf_desc_t::TX_CHAIN)) {
+            // A chained buffer releases the rest of the list itself
+            for (; next; next = next->p_next_desc) {
+                count++;
+            }
+        }
         freed += put_tx_buffer_helper(buff_list);
         count++;
         buff_list = next;
@@ -955,6 +1188,12 @@ void ring_simple::adapt_cq_moderation()
         return;
     }
 
+    if (m_cq_moderation_info.target_latency_usec) {
+        adapt_cq_moderation_latency(interval_packets, missed_rounds);
+        m_lock_ring_rx.unlock();
+        return;
+    }
+
     uint32_t avg_packet_rate =
         (interval_packets * 1000) / (safe_mce_sys().cq_aim_interval_msec * (1 + missed_rounds));
 
@@ -970,6 +1209,44 @@ void ring_simple::adapt_cq_moderation()
     m_lock_ring_rx.unlock();
 }
 
+// Call under m_lock_ring_rx lock
+void ring_simple::adapt_cq_moderation_latency(uint64_t interval_packets, uint32_t missed_rounds)
+{
+    uint32_t target = m_cq_moderation_info.target_latency_usec;
+    uint64_t interval_usec =
+        safe_mce_sys().cq_aim_interval_msec * 1000ULL * (1 + missed_rounds);
+    uint32_t gap_usec = cq_aim_hist_percentile(m_cq_moderation_info.gap_hist, 50U);
+    uint32_t burst = cq_aim_hist_percentile(m_cq_moderation_info.burst_hist, 90U);
+    uint32_t target_frames =
+        static_cast<uint32_t>(std::min<uint64_t>(interval_packets * target / interval_usec,
+                                                 safe_mce_sys().cq_aim_max_count));
+    uint32_t count;
+
+    if (gap_usec >= target) {
+        // Sparse bursts, raise the interrupt as soon as a typical burst arrived.
+        count = burst;
+    } else {
+        // Back to back bursts, coalesce what arrives within the target latency.
+        count = std::max(target_frames, burst);
+    }
+    count = std::min(std::max(count, 1U), safe_mce_sys().cq_aim_max_count);
+    uint32_t period = std::min(target, safe_mce_sys().cq_aim_max_period_usec);
+
+    // Halve the history, so a few last rounds drive the decision and bursts don't cause
+    // oscillations.
+    for (uint32_t i = 0; i < CQ_AIM_HIST_BUCKETS; ++i) {
+        m_cq_moderation_info.gap_hist[i] /= 2U;
+        m_cq_moderation_info.burst_hist[i] /= 2U;
+    }
+
+    m_p_ring_stat->n_rx_cq_moderation_gap_usec = gap_usec;
+    m_p_ring_stat->n_rx_cq_moderation_burst = burst;
+    m_p_ring_stat->n_rx_cq_moderation_target_frames = target_frames;
+    ++m_p_ring_stat->n_rx_cq_moderation_decisions;
+
+    modify_cq_moderation(period, count);
+}
+
 void ring_simple::start_active_queue_tx()
 {
     m_lock_ring_tx.lock();
@@ -1046,25 +1323,38 @@ int ring_simple::modify_ratelimit(struct xlio_rate_limit_t &rate_limit)
 
 uint32_t ring_simple::get_tx_user_lkey(void *addr, size_t length)
 {
-    uint32_t lkey;
+    uint32_t lkey = m_p_ib_ctx->get_odp_lkey();
+
+    if (lkey != LKEY_ERROR) {
+        // The implicit ODP region covers any user buffer
+        return lkey;
+    }
 
     /*
-     * Current implementation supports a ring registration cache where addr is the key.
-     *
-     * The mode is used for send zerocopy.
+     * A ring registration cache of the pages of the user buffers, used by the send zerocopy.
+     * A buffer within the pages of a previous registration reuses its lkey, so the buffers
+     * sent again at other offsets aren't registered again.
      *
-     * TODO The mode doesnn't support memory deregistration.
+     * TODO The mode doesn't support memory deregistration.
      */
-    auto iter = m_user_lkey_map.find(addr);
-    if (iter != m_user_lkey_map.end()) {
-        lkey = iter->second;
+    static const uintptr_t page_mask = (uintptr_t)(sysconf(_SC_PAGESIZE) ?: 4096U) - 1U;
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t end = start + length;
+    std::lock_guard<decltype(m_lock_ring_tx)> lock(m_lock_ring_tx);
+
+    auto iter = m_user_lkey_map.upper_bound(start);
+    if (iter != m_user_lkey_map.begin() && std::prev(iter)->second.end >= end) {
+        return std::prev(iter)->second.lkey;
+    }
+
+    start &= ~page_mask;
+    end = (end + page_mask) & ~page_mask;
+    lkey = m_p_ib_ctx->user_mem_reg(reinterpret_cast<void *>(start), end - start,
+                                    XLIO_IBV_ACCESS_LOCAL_WRITE);
+    if (lkey == LKEY_ERROR) {
+        ring_logerr("Can't register user memory addr %p len %lx", addr, length);
     } else {
-        lkey = m_p_ib_ctx->user_mem_reg(addr, length, XLIO_IBV_ACCESS_LOCAL_WRITE);
-        if (lkey == LKEY_ERROR) {
-            ring_logerr("Can't register user memory addr %p len %lx", addr, length);
-        } else {
-            m_user_lkey_map[addr] = lkey;
-        }
+        m_user_lkey_map[start] = {end, lkey};
     }
     return lkey;
 }
@@ -9,6 +9,7 @@
 
 #include "ring_slave.h"
 
+#include <map>
 #include <mutex>
 #include <unordered_map>
 
@@ -17,12 +18,20 @@
 #include "dev/hw_queue_rx.h"
 #include "dev/net_device_table_mgr.h"
 
+#define CQ_AIM_HIST_BUCKETS 16U
+
 struct cq_moderation_info {
     uint32_t period;
     uint32_t count;
     uint64_t packets;
     uint64_t prev_packets;
     uint32_t missed_rounds;
+
+    // Target latency mode history, log2 buckets decayed on every adaptation round
+    uint32_t target_latency_usec;
+    tscval_t last_burst_tsc;
+    uint32_t gap_hist[CQ_AIM_HIST_BUCKETS]; // Gap between RX bursts in usec
+    uint32_t burst_hist[CQ_AIM_HIST_BUCKETS]; // RX burst size in packets
 };
 
 /**
@@ -41,6 +50,10 @@ public:
     int poll_and_process_element_rx(uint64_t *p_cq_poll_sn,
                                     void *pv_fd_ready_array = nullptr) override;
     int poll_and_process_element_tx(uint64_t *p_cq_poll_sn) override;
+    bool has_rx_work() override
+    {
+        return m_p_cq_mgr_rx->has_rx_work() || !m_pending_acks.empty();
+    }
     void adapt_cq_moderation() override;
     bool reclaim_recv_buffers(descq_t *rx_reuse) override;
     bool reclaim_recv_buffers(mem_buf_desc_t *rx_reuse_lst) override;
@@ -98,6 +111,7 @@ public:
         return m_tx_lkey;
     }
     bool is_tso(void) override;
+    bool is_lro(void) const override { return m_lro.cap && m_lro.max_payload_sz; }
 
     struct ibv_comp_channel *get_tx_comp_event_channel() { return m_p_tx_comp_event_channel; }
     void modify_cq_moderation(uint32_t period, uint32_t count);
@@ -122,12 +136,16 @@ public:
         if (likely(tis != NULL)) {
             ++m_p_ring_stat->n_tx_tls_contexts;
         }
+        return tis;
+    }
+    void tls_context_post_tx(const xlio_tls_info *info, xlio_tis *tis) override
+    {
+        std::lock_guard<decltype(m_lock_ring_tx)> lock(m_lock_ring_tx);
+        m_hqtx->tls_context_post_tx(info, tis);
 
         /* Do polling to speedup handling of the completion. */
         uint64_t dummy_poll_sn = 0;
         m_p_cq_mgr_tx->poll_and_process_element_tx(&dummy_poll_sn);
-
-        return tis;
     }
     xlio_tir *tls_create_tir(bool cached) override
     {
@@ -235,6 +253,30 @@ public:
         m_hqtx->credits_return(credits);
     }
 
+    // Batches may nest, e.g. sendmmsg() callers on different sockets sharing the ring.
+    void tx_doorbell_batch_begin() override
+    {
+        std::lock_guard<decltype(m_lock_ring_tx)> lock(m_lock_ring_tx);
+        if (m_tx_db_batch_depth++ == 0U) {
+            m_hqtx->set_doorbell_deferred(true);
+        }
+    }
+
+    void tx_doorbell_batch_end() override
+    {
+        std::lock_guard<decltype(m_lock_ring_tx)> lock(m_lock_ring_tx);
+        if (m_tx_db_batch_depth && --m_tx_db_batch_depth == 0U) {
+            m_hqtx->set_doorbell_deferred(false);
+            flush_tx_doorbell();
+        }
+    }
+
+    void set_rx_poll_budget(uint32_t budget) override
+    {
+        std::lock_guard<decltype(m_lock_ring_rx)> lock(m_lock_ring_rx);
+        m_p_cq_mgr_rx->set_poll_budget(budget);
+    }
+
     friend class cq_mgr_rx;
     friend class cq_mgr_rx_regrq;
     friend class cq_mgr_rx_strq;
@@ -250,18 +292,38 @@ protected:
     void create_resources();
     virtual void init_tx_buffers(uint32_t count);
     void inc_cq_moderation_stats() override;
+    void record_rx_burst(uint32_t packets);
+    void adapt_cq_moderation_latency(uint64_t interval_packets, uint32_t missed_rounds);
     inline void set_tx_num_wr(uint32_t num_wr) { m_tx_num_wr = num_wr; }
     inline uint32_t get_tx_num_wr() { return m_tx_num_wr; }
     inline uint32_t get_mtu() { return m_mtu; }
 
 private:
+    // The hot paths, with a lock policy of ring_slave.h
+    template <typename Lock>
+    int poll_and_process_element_rx_tmpl(uint64_t *p_cq_poll_sn, void *pv_fd_ready_array);
+    template <typename Lock>
+    mem_buf_desc_t *mem_buf_tx_get_tmpl(bool b_block, pbuf_type type, int n_num_mem_bufs,
+                                        bool tx_skip_poll);
+    template <typename Lock>
+    int send_lwip_buffer_tmpl(xlio_ibv_send_wr *p_send_wqe, xlio_wr_tx_packet_attr attr,
+                              xlio_tis *tis);
     inline void send_status_handler(int ret, xlio_ibv_send_wr *p_send_wqe);
+    void mirror_tx_packet(const xlio_ibv_send_wr *p_send_wqe);
+    inline void update_odp_stats(const xlio_ibv_send_wr *p_send_wqe);
     inline mem_buf_desc_t *get_tx_buffers(pbuf_type type, uint32_t n_num_mem_bufs);
     inline int put_tx_buffer_helper(mem_buf_desc_t *buff);
     inline int put_tx_buffers(mem_buf_desc_t *buff_list);
     inline int put_tx_single_buffer(mem_buf_desc_t *buff);
     inline void return_to_global_pool();
     bool is_available_qp_wr(bool b_block, unsigned credits);
+    inline void flush_tx_doorbell()
+    {
+        unsigned num = m_hqtx->flush_doorbell(true);
+        if (num > 1U) {
+            m_p_ring_stat->n_tx_db_saved += num - 1U;
+        }
+    }
     void save_l2_address(const L2_address *p_l2_addr)
     {
         delete_l2_address();
@@ -282,13 +344,19 @@ protected:
     struct cq_moderation_info m_cq_moderation_info;
     cq_mgr_rx *m_p_cq_mgr_rx = nullptr;
     cq_mgr_tx *m_p_cq_mgr_tx = nullptr;
-    std::unordered_map<void *, uint32_t> m_user_lkey_map;
+    // The user pages registered for the send zerocopy, by their start address
+    struct user_mem_range {
+        uintptr_t end;
+        uint32_t lkey;
+    };
+    std::map<uintptr_t, user_mem_range> m_user_lkey_map;
 
 private:
     lock_mutex m_lock_ring_tx_buf_wait;
     uint32_t m_tx_num_bufs = 0U;
     uint32_t m_zc_num_bufs = 0U;
     uint32_t m_tx_num_wr = 0U;
+    uint32_t m_tx_db_batch_depth = 0U;
     uint32_t m_missing_buf_ref_count = 0U;
     uint32_t m_tx_lkey = 0U; // this is the registered memory lkey for a given specific device for
                              // the buffer pool use
@@ -339,6 +407,9 @@ private:
         /* Array of supported LRO timer periods in microseconds. */
         uint8_t timer_supported_periods[4];
 
+        /* LRO timer period in microseconds selected from timer_supported_periods */
+        uint8_t timeout_period;
+
         /* Maximum length of TCP payload for LRO
          * It is calculated from max_msg_sz_mode and safe_mce_sys().rx_buf_size
          */
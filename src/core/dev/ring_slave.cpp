@@ -10,9 +10,13 @@
 #include "proto/ip_frag.h"
 #include "dev/rfs_mc.h"
 #include "dev/rfs_uc_tcp_gro.h"
+#include "dev/rfs_rule.h"
 #include "sock/fd_collection.h"
+#include "event/poll_group.h"
 #include "sock/sockinfo_tcp.h"
+#include "sock/sockinfo_udp.h"
 #include "proto/tls.h"
+#include "util/pkt_mirror.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "ring_slave"
@@ -42,6 +46,7 @@ ring_slave::ring_slave(int if_index, ring *parent, bool use_locks)
     , m_flow_tag_enabled(false)
     , m_b_sysvar_eth_mc_l2_only_rules(safe_mce_sys().eth_mc_l2_only_rules)
     , m_b_sysvar_mc_force_flowtag(safe_mce_sys().mc_force_flowtag)
+    , m_b_use_locks(use_locks)
     , padding {}
 {
     net_device_val *p_ndev = nullptr;
@@ -67,6 +72,7 @@ ring_slave::ring_slave(int if_index, ring *parent, bool use_locks)
 
     // use local copy of stats by default
     memset(m_p_ring_stat.get(), 0, sizeof(ring_stats_t));
+    m_p_ring_stat->n_numa_node = m_numa_node;
     if (m_parent != this) {
         m_p_ring_stat->p_ring_master = m_parent;
     }
@@ -135,6 +141,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
 {
     rfs *p_rfs;
     rfs *p_tmp_rfs = nullptr;
+    bool defer_rule = false;
 
     if (!sink) {
         return false;
@@ -185,8 +192,11 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
                     new rfs_rule_filter(m_ring.m_udp_uc_dst_port_attach_map, rule_key, udp_3t_only);
             }
             try {
-                p_tmp_rfs =
-                    new (std::nothrow) rfs_uc(&flow_spec_5t, &m_ring, dst_port_filter, flow_tag_id);
+                sockinfo_udp *udp_si = dynamic_cast<sockinfo_udp *>(sink);
+                int steering_index = udp_si ? udp_si->get_reuseport_slot() : -1;
+
+                p_tmp_rfs = new (std::nothrow)
+                    rfs_uc(&flow_spec_5t, &m_ring, dst_port_filter, flow_tag_id, steering_index);
             } catch (xlio_exception &e) {
                 ring_logerr("%s", e.message.c_str());
                 return false;
@@ -210,9 +220,16 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
         }
     } else if (flow_spec_5t.is_udp_mc()) {
         KEY2T key_udp_mc(flow_spec_5t.get_dst_ip(), flow_spec_5t.get_dst_port());
-        sock_addr rule_key(flow_spec_5t.get_family(), &flow_spec_5t.get_dst_ip(), 0U);
+        // L2 rules match the MC MAC only, so groups mapping to the same MAC share a rule
+        ip_address l2_mc_grp =
+            create_multicast_mac_group(flow_spec_5t.get_dst_ip(), flow_spec_5t.get_family());
+        sock_addr rule_key(flow_spec_5t.get_family(), &l2_mc_grp, 0U);
         if (flow_tag_id) {
-            if (m_ring.m_b_sysvar_mc_force_flowtag || !sink->flow_in_reuse()) {
+            if (m_ring.m_b_sysvar_eth_mc_l2_only_rules) {
+                // A shared L2 rule can't tag the packets with the flow tag of a single socket
+                flow_tag_id = FLOW_TAG_MASK;
+                ring_logdbg("MC flow tag for socketinfo=%p is disabled: L2 only rules", sink);
+            } else if (m_ring.m_b_sysvar_mc_force_flowtag || !sink->flow_in_reuse()) {
                 ring_logdbg("MC flow tag ID=%d for socketinfo=%p is enabled: force_flowtag=%d, "
                             "SO_REUSEADDR | SO_REUSEPORT=%d",
                             flow_tag_id, sink, m_ring.m_b_sysvar_mc_force_flowtag,
@@ -314,7 +331,8 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
                     steering_index = tcp_si->get_listen_context()->get_steering_index();
                 }
 
-                if (safe_mce_sys().gro_streams_max) {
+                // Software GRO is redundant when the adapter already coalesces the stream.
+                if (safe_mce_sys().gro_streams_max && !m_ring.is_lro()) {
                     p_tmp_rfs = new (std::nothrow) rfs_uc_tcp_gro(
                         &flow_spec_5t, &m_ring, dst_port_filter, flow_tag_id, steering_index);
                 } else {
@@ -334,6 +352,13 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
 
             p_rfs = p_tmp_rfs;
             sink->set_rfs_ptr(p_rfs);
+
+            // The listener 3T rule already steers this flow to the ring, where the 5T rfs is
+            // found in the flow table. So the HW rule can wait for the batch installation.
+            defer_rule = safe_mce_sys().tcp_deferred_rules_msec && !dst_port_filter &&
+                flow_spec_5t.is_5_tuple() && !m_ring.m_parent->is_ultra_ring() &&
+                m_flow_tcp_map.find(KEY4T(flow_spec_5t.get_dst_ip(), ip_address::any_addr(),
+                                          flow_spec_5t.get_dst_port(), 0)) != end(m_flow_tcp_map);
 #if defined(DEFINED_NGINX) || defined(DEFINED_ENVOY)
             if (g_p_app->type == APP_NONE || !g_p_app->add_second_4t_rule)
 #endif
@@ -350,12 +375,16 @@ bool steering_handler<KEY4T, KEY2T, HDR>::attach_flow(flow_tuple &flow_spec_5t,
     }
     BULLSEYE_EXCLUDE_BLOCK_END
 
-    bool ret = p_rfs->attach_flow(sink);
+    bool ret = p_rfs->attach_flow(sink, defer_rule);
     if (ret) {
+        if (p_rfs->is_rule_deferred()) {
+            m_ring.m_deferred_rules.push_back(p_rfs);
+        }
         if (flow_tag_id && (flow_tag_id != FLOW_TAG_MASK)) {
             // A flow with FlowTag was attached succesfully, check stored rfs for fast path be
             // tag_id
             sink->set_flow_tag(flow_tag_id);
+            m_ring.flow_tag_attach(flow_tag_id, sink, p_rfs);
             ring_logdbg("flow_tag: %d registration is done!", flow_tag_id);
         }
     } else {
@@ -418,6 +447,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::detach_flow(flow_tuple &flow_spec_5t,
 
         p_rfs = itr->second;
         p_rfs->detach_flow(sink, rule_extract);
+        m_ring.flow_tag_detach(sink, p_rfs);
         if (!keep_in_map) {
             m_ring.m_udp_uc_dst_port_attach_map.erase(
                 m_ring.m_udp_uc_dst_port_attach_map.find(rule_key));
@@ -431,7 +461,9 @@ bool steering_handler<KEY4T, KEY2T, HDR>::detach_flow(flow_tuple &flow_spec_5t,
     } else if (flow_spec_5t.is_udp_mc()) {
         int keep_in_map = 1;
         KEY2T key_udp_mc(flow_spec_5t.get_dst_ip(), flow_spec_5t.get_dst_port());
-        sock_addr rule_key(flow_spec_5t.get_family(), &flow_spec_5t.get_dst_ip(), 0U);
+        ip_address l2_mc_grp =
+            create_multicast_mac_group(flow_spec_5t.get_dst_ip(), flow_spec_5t.get_family());
+        sock_addr rule_key(flow_spec_5t.get_family(), &l2_mc_grp, 0U);
         if (m_ring.m_b_sysvar_eth_mc_l2_only_rules) {
             auto l2_mc_iter = m_ring.m_l2_mc_ip_attach_map.find(rule_key);
             BULLSEYE_EXCLUDE_BLOCK_START
@@ -453,6 +485,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::detach_flow(flow_tuple &flow_spec_5t,
         BULLSEYE_EXCLUDE_BLOCK_END
         p_rfs = itr->second;
         p_rfs->detach_flow(sink, rule_extract);
+        m_ring.flow_tag_detach(sink, p_rfs);
         if (!keep_in_map) {
             m_ring.m_l2_mc_ip_attach_map.erase(m_ring.m_l2_mc_ip_attach_map.find(rule_key));
         }
@@ -489,6 +522,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::detach_flow(flow_tuple &flow_spec_5t,
 
         p_rfs = itr->second;
         p_rfs->detach_flow(sink, rule_extract);
+        m_ring.flow_tag_detach(sink, p_rfs);
         if (!keep_in_map) {
             m_ring.m_tcp_dst_port_attach_map.erase(m_ring.m_tcp_dst_port_attach_map.find(rule_key));
         }
@@ -496,6 +530,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::detach_flow(flow_tuple &flow_spec_5t,
             BULLSEYE_EXCLUDE_BLOCK_START
             m_flow_tcp_map.erase(itr);
             BULLSEYE_EXCLUDE_BLOCK_END
+            m_ring.cancel_deferred_rule(p_rfs);
             delete p_rfs;
         }
         BULLSEYE_EXCLUDE_BLOCK_START
@@ -512,6 +547,13 @@ bool ring_slave::detach_flow(flow_tuple &flow_spec_5t, sockinfo *sink, rfs_rule
 {
     std::lock_guard<decltype(m_lock_ring_rx)> lock(m_lock_ring_rx);
 
+    // The caller takes over the HW rule, or the listener 3T rule which serves the pending
+    // flows is going away. In both cases the pending 5T rules must exist.
+    if (unlikely(!m_deferred_rules.empty()) && (rule_extract || flow_spec_5t.is_3_tuple())) {
+        install_deferred_rules();
+    }
+    cancel_pending_ack(sink);
+
     return (flow_spec_5t.get_family() == AF_INET
                 ? m_steering_ipv4.detach_flow(flow_spec_5t, sink, rule_extract)
                 : m_steering_ipv6.detach_flow(flow_spec_5t, sink, rule_extract));
@@ -549,6 +591,80 @@ static inline bool check_rx_packet(sockinfo *si, mem_buf_desc_t *p_rx_wc_buf_des
     return si->rx_input_cb(p_rx_wc_buf_desc, fd_ready_array);
 }
 
+// Locates the headers of a packet for the Ultra API filter and returns the filter verdict
+int ring_slave::rx_filter_packet(mem_buf_desc_t *p_rx_wc_buf_desc)
+{
+    const uint8_t *frame = p_rx_wc_buf_desc->p_buffer;
+    size_t len = p_rx_wc_buf_desc->sz_data;
+    size_t l3_offset = ETH_HDR_LEN;
+    size_t l4_offset = 0U;
+    uint16_t h_proto = 0U;
+    struct xlio_rx_filter_pkt pkt = {
+        frame, nullptr, nullptr, static_cast<uint32_t>(len), 0U, AF_UNSPEC, 0U};
+
+    if (likely(len >= ETH_HDR_LEN)) {
+        h_proto = reinterpret_cast<const struct ethhdr *>(frame)->h_proto;
+    }
+    if (h_proto == htons(ETH_P_8021Q) && len >= ETH_VLAN_HDR_LEN) {
+        const struct vlanhdr *p_vlan_hdr =
+            reinterpret_cast<const struct vlanhdr *>(frame + ETH_HDR_LEN);
+        pkt.vlan_id = ntohs(p_vlan_hdr->h_vlan_TCI) & VLAN_VID_MASK;
+        h_proto = p_vlan_hdr->h_vlan_encapsulated_proto;
+        l3_offset = ETH_VLAN_HDR_LEN;
+    }
+
+    if (h_proto == htons(ETH_P_IP) && len >= l3_offset + sizeof(struct iphdr)) {
+        const struct iphdr *p_ip_h = reinterpret_cast<const struct iphdr *>(frame + l3_offset);
+        pkt.l3_hdr = p_ip_h;
+        pkt.l3_family = AF_INET;
+        pkt.l4_proto = p_ip_h->protocol;
+        // Only the first fragment carries the transport header
+        if (!(p_ip_h->frag_off & htons(IP_OFFMASK))) {
+            l4_offset = l3_offset + p_ip_h->ihl * 4U;
+        }
+    } else if (h_proto == htons(ETH_P_IPV6) && len >= l3_offset + sizeof(struct ip6_hdr)) {
+        const struct ip6_hdr *p_ip_h6 = reinterpret_cast<const struct ip6_hdr *>(frame + l3_offset);
+        pkt.l3_hdr = p_ip_h6;
+        pkt.l3_family = AF_INET6;
+        pkt.l4_proto = p_ip_h6->ip6_nxt;
+        l4_offset = l3_offset + sizeof(struct ip6_hdr);
+    }
+    // At least the ports and the length of UDP, the smallest transport header
+    if (l4_offset && len >= l4_offset + sizeof(struct udphdr)) {
+        pkt.l4_hdr = frame + l4_offset;
+    }
+
+    return m_rx_filter_cb(reinterpret_cast<xlio_poll_group_t>(m_parent->get_poll_group()), &pkt,
+                          p_rx_wc_buf_desc->to_xlio_buf());
+}
+
+// Copies a received packet to the mirror ring, with the NIC timestamp if it can be converted
+void ring_slave::mirror_rx_packet(mem_buf_desc_t *p_rx_wc_buf_desc)
+{
+    size_t snap_len = pkt_mirror_select(PKT_MIRROR_DIR_RX, p_rx_wc_buf_desc->p_buffer,
+                                        p_rx_wc_buf_desc->sz_data);
+    if (!snap_len) {
+        return;
+    }
+
+    struct iovec iov = {p_rx_wc_buf_desc->p_buffer, p_rx_wc_buf_desc->sz_data};
+    struct timespec ts = {0, 0};
+    uint8_t flags = 0U;
+    ib_ctx_handler *p_ib_ctx = get_ctx(0);
+
+    if (p_ib_ctx && p_rx_wc_buf_desc->rx.timestamps.hw_raw) {
+        p_ib_ctx->convert_hw_time_to_system_time(p_rx_wc_buf_desc->rx.timestamps.hw_raw, &ts);
+    }
+    if (ts.tv_sec) {
+        flags |= PKT_MIRROR_FLAG_HW_TS;
+    } else {
+        clock_gettime(CLOCK_REALTIME, &ts);
+    }
+    pkt_mirror_write(PKT_MIRROR_DIR_RX, static_cast<uint32_t>(get_if_index()),
+                     ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec, flags, &iov, 1, snap_len,
+                     p_rx_wc_buf_desc->sz_data);
+}
+
 // All CQ wce come here for some basic sanity checks and then are distributed to the correct ring
 // handler Return values: false = Reuse this data buffer & mem_buf_desc
 bool ring_slave::rx_process_buffer(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array)
@@ -580,16 +696,35 @@ bool ring_slave::rx_process_buffer(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd
     m_p_ring_stat->n_rx_tls_auth_fail += !!(p_rx_wc_buf_desc->rx.tls_decrypted == TLS_RX_AUTH_FAIL);
 #endif /* DEFINED_UTLS */
 
+    if (unlikely(g_p_pkt_mirror)) {
+        mirror_rx_packet(p_rx_wc_buf_desc);
+    }
+
+    if (unlikely(m_rx_filter_cb)) {
+        int verdict = rx_filter_packet(p_rx_wc_buf_desc);
+        if (verdict == XLIO_RX_FILTER_DROP) {
+            ++m_p_ring_stat->n_rx_filter_drops;
+            return false;
+        }
+        if (verdict == XLIO_RX_FILTER_REDIRECT) {
+            // The reference is released by xlio_poll_group_buf_free().
+            p_rx_wc_buf_desc->inc_ref_count();
+            ++m_p_ring_stat->n_rx_filter_redirects;
+            return true;
+        }
+    }
+
     // This is an internal function (within ring and 'friends'). No need for lock mechanism.
     if (likely(m_flow_tag_enabled && p_rx_wc_buf_desc->rx.flow_tag_id &&
                p_rx_wc_buf_desc->rx.flow_tag_id != FLOW_TAG_MASK &&
                !p_rx_wc_buf_desc->rx.is_sw_csum_need)) {
         sockinfo *si = nullptr;
-        // trying to get sockinfo per flow_tag_id-1 as it was incremented at attach
-        // to allow mapping sockfd=0
-        assert(g_p_fd_collection);
-        si = static_cast<sockinfo *>(
-            g_p_fd_collection->get_sockfd(p_rx_wc_buf_desc->rx.flow_tag_id - 1));
+        rfs *p_rfs = nullptr;
+        // Single load from the ring local map, the flow tables aren't touched
+        if (likely(p_rx_wc_buf_desc->rx.flow_tag_id < m_flow_tag_map.size())) {
+            si = m_flow_tag_map[p_rx_wc_buf_desc->rx.flow_tag_id].sink;
+            p_rfs = m_flow_tag_map[p_rx_wc_buf_desc->rx.flow_tag_id].p_rfs;
+        }
         if (likely(si) && si->is_xlio_socket() &&
             unlikely(si->get_poll_group() == nullptr ||
                      si->get_poll_group() != this->get_poll_group())) {
@@ -659,12 +794,17 @@ bool ring_slave::rx_process_buffer(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd
                              p_tcp_h->fin ? "F" : "", ntohl(p_tcp_h->seq), ntohl(p_tcp_h->ack_seq),
                              ntohs(p_tcp_h->window), p_rx_wc_buf_desc->rx.sz_payload);
 
-                return si->get_rfs_ptr()->rx_dispatch_packet(p_rx_wc_buf_desc, pv_fd_ready_array);
+                return p_rfs->rx_dispatch_packet(p_rx_wc_buf_desc, pv_fd_ready_array);
             }
 
             if (likely(protocol == IPPROTO_UDP)) {
                 struct udphdr *p_udp_h = (struct udphdr *)((uint8_t *)p_ip_h + ip_hdr_len);
 
+                p_rx_wc_buf_desc->rx.sz_payload = ntohs(p_udp_h->len) - sizeof(struct udphdr);
+                if (unlikely(si->is_rx_over_limit()) && si->rx_over_limit_drop(p_rx_wc_buf_desc)) {
+                    return false;
+                }
+
                 // Update the L3 and L4 info
                 p_rx_wc_buf_desc->rx.src.set_ip_port(family, saddr, p_udp_h->source);
                 p_rx_wc_buf_desc->rx.dst.set_ip_port(family, daddr, p_udp_h->dest);
@@ -672,7 +812,6 @@ bool ring_slave::rx_process_buffer(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd
                 // Update packet descriptor with datagram base address and length
                 p_rx_wc_buf_desc->rx.frag.iov_base = (uint8_t *)p_udp_h + sizeof(struct udphdr);
                 p_rx_wc_buf_desc->rx.frag.iov_len = ip_payload_len - sizeof(struct udphdr);
-                p_rx_wc_buf_desc->rx.sz_payload = ntohs(p_udp_h->len) - sizeof(struct udphdr);
 
                 p_rx_wc_buf_desc->rx.udp.ifindex = m_parent->get_if_index();
                 p_rx_wc_buf_desc->rx.n_frags = 1;
@@ -962,8 +1101,11 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
         // Add ip fragment packet to out fragment manager
         mem_buf_desc_t *new_buf = nullptr;
         int ret = -1;
-        if (g_p_ip_frag_manager) {
-            ret = g_p_ip_frag_manager->add_frag(p_ip_h, p_rx_wc_buf_desc, &new_buf);
+        if (unlikely(!m_ring.m_p_ip_frag)) {
+            m_ring.m_p_ip_frag.reset(new (std::nothrow) ip_frag_manager());
+        }
+        if (m_ring.m_p_ip_frag) {
+            ret = m_ring.m_p_ip_frag->add_frag(p_ip_h, p_rx_wc_buf_desc, &new_buf);
         }
         if (ret < 0) { // Finished with error
             return false;
@@ -1002,6 +1144,16 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
         p_rx_wc_buf_desc->rx.frag.iov_base = (uint8_t *)p_udp_h + sizeof(struct udphdr);
         p_rx_wc_buf_desc->rx.frag.iov_len = payload_len - sizeof(struct udphdr);
 
+        // Update the L3/L4 info
+        p_rx_wc_buf_desc->rx.src.set_ip_port(hdr_get_family(p_ip_h), hdr_get_saddr(p_ip_h),
+                                             p_udp_h->source);
+        p_rx_wc_buf_desc->rx.dst.set_ip_port(hdr_get_family(p_ip_h), hdr_get_daddr(p_ip_h),
+                                             p_udp_h->dest);
+
+        // Start fetching the flow table entry while the datagram is validated
+        KEY4T key_5t(p_rx_wc_buf_desc->rx.dst, p_rx_wc_buf_desc->rx.src);
+        size_t key_5t_hash = m_flow_udp_uc_map.prefetch(key_5t);
+
         if (p_rx_wc_buf_desc->rx.is_sw_csum_need && p_udp_h->check &&
             compute_udp_checksum_rx(p_ip_h, p_udp_h, p_rx_wc_buf_desc)) {
             return false; // false udp checksum
@@ -1012,11 +1164,6 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
                      ", payload_sz=%zu, csum=%#x",
                      ntohs(p_udp_h->source), ntohs(p_udp_h->dest), sz_payload, p_udp_h->check);
 
-        // Update the L3/L4 info
-        p_rx_wc_buf_desc->rx.src.set_ip_port(hdr_get_family(p_ip_h), hdr_get_saddr(p_ip_h),
-                                             p_udp_h->source);
-        p_rx_wc_buf_desc->rx.dst.set_ip_port(hdr_get_family(p_ip_h), hdr_get_daddr(p_ip_h),
-                                             p_udp_h->dest);
         p_rx_wc_buf_desc->rx.sz_payload = sz_payload;
 
         // Update the protocol info
@@ -1024,8 +1171,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
 
         // Find the relevant hash map and pass the packet to the rfs for dispatching
         if (!p_rx_wc_buf_desc->rx.dst.is_mc()) { // This is UDP UC packet
-            auto itr =
-                m_flow_udp_uc_map.find(KEY4T(p_rx_wc_buf_desc->rx.dst, p_rx_wc_buf_desc->rx.src));
+            auto itr = m_flow_udp_uc_map.find(key_5t, key_5t_hash);
 
             // If we didn't find a match for 5T, look for a match with 3T
             if (unlikely(itr == end(m_flow_udp_uc_map))) {
@@ -1049,6 +1195,16 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
         // Get the tcp header pointer + tcp payload size
         struct tcphdr *p_tcp_h = (struct tcphdr *)((uint8_t *)p_ip_h + hdr_data.ip_hdr_len);
 
+        // Update the L3/L4 info
+        p_rx_wc_buf_desc->rx.src.set_ip_port(hdr_get_family(p_ip_h), hdr_get_saddr(p_ip_h),
+                                             p_tcp_h->source);
+        p_rx_wc_buf_desc->rx.dst.set_ip_port(hdr_get_family(p_ip_h), hdr_get_daddr(p_ip_h),
+                                             p_tcp_h->dest);
+
+        // Start fetching the flow table entry while the segment is validated
+        KEY4T key_5t(p_rx_wc_buf_desc->rx.dst, p_rx_wc_buf_desc->rx.src);
+        size_t key_5t_hash = m_flow_tcp_map.prefetch(key_5t);
+
         if (p_rx_wc_buf_desc->rx.is_sw_csum_need &&
             compute_tcp_checksum(p_ip_h, (unsigned short *)p_tcp_h,
                                  csum_hdr_len(p_ip_h, hdr_data))) {
@@ -1066,12 +1222,6 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
         // Update packet descriptor with datagram base address and length
         p_rx_wc_buf_desc->rx.frag.iov_base = (uint8_t *)p_tcp_h + sizeof(struct tcphdr);
         p_rx_wc_buf_desc->rx.frag.iov_len = payload_len - sizeof(struct tcphdr);
-
-        // Update the L3/L4 info
-        p_rx_wc_buf_desc->rx.src.set_ip_port(hdr_get_family(p_ip_h), hdr_get_saddr(p_ip_h),
-                                             p_tcp_h->source);
-        p_rx_wc_buf_desc->rx.dst.set_ip_port(hdr_get_family(p_ip_h), hdr_get_daddr(p_ip_h),
-                                             p_tcp_h->dest);
         p_rx_wc_buf_desc->rx.sz_payload = sz_payload;
 
         // Update the protocol info
@@ -1079,7 +1229,7 @@ bool steering_handler<KEY4T, KEY2T, HDR>::rx_process_buffer_no_flow_id(
         p_rx_wc_buf_desc->rx.tcp.p_tcp_h = p_tcp_h;
 
         // Find the relevant hash map and pass the packet to the rfs for dispatching
-        auto itr = m_flow_tcp_map.find(KEY4T(p_rx_wc_buf_desc->rx.dst, p_rx_wc_buf_desc->rx.src));
+        auto itr = m_flow_tcp_map.find(key_5t, key_5t_hash);
 
         // If we didn't find a match for 5T, look for a match with 3T
         if (unlikely(itr == end(m_flow_tcp_map))) {
@@ -1131,8 +1281,119 @@ void steering_handler<KEY4T, KEY2T, HDR>::flow_del_all_rfs()
 
 void ring_slave::flow_del_all_rfs()
 {
+    m_flow_tag_map.clear();
+    m_deferred_rules.clear();
     m_steering_ipv4.flow_del_all_rfs();
     m_steering_ipv6.flow_del_all_rfs();
+    destroy_retired_rules();
+}
+
+void ring_slave::flush_deferred_rules()
+{
+    std::vector<rfs_rule *> retired_rules;
+
+    if (m_lock_ring_rx.trylock()) {
+        return; // Try again in the next round
+    }
+
+    install_deferred_rules();
+    retired_rules.swap(m_retired_rules);
+    m_lock_ring_rx.unlock();
+
+    // The pollers of the ring don't wait for the destruction of the rules
+    if (!retired_rules.empty()) {
+        ring_logdbg("Destroying %zu retired steering rules", retired_rules.size());
+        for (rfs_rule *rule : retired_rules) {
+            delete rule;
+        }
+    }
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::destroy_retired_rules()
+{
+    for (rfs_rule *rule : m_retired_rules) {
+        delete rule;
+    }
+    m_retired_rules.clear();
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::install_deferred_rules()
+{
+    if (m_deferred_rules.empty()) {
+        return;
+    }
+
+    uint32_t failed = 0U;
+
+    ring_logdbg("Installing %zu deferred steering rules", m_deferred_rules.size());
+    for (rfs *p_rfs : m_deferred_rules) {
+        if (unlikely(!p_rfs->create_deferred_flow())) {
+            ++failed;
+        }
+    }
+    if (unlikely(failed)) {
+        ring_logwarn("Failed to install %" PRIu32 " of %zu deferred steering rules", failed,
+                     m_deferred_rules.size());
+        m_p_ring_stat->n_rx_steering_rule_fails += failed;
+    }
+    m_deferred_rules.clear();
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::cancel_deferred_rule(rfs *p_rfs)
+{
+    if (!m_deferred_rules.empty()) {
+        auto iter = std::find(m_deferred_rules.begin(), m_deferred_rules.end(), p_rfs);
+        if (iter != m_deferred_rules.end()) {
+            *iter = m_deferred_rules.back();
+            m_deferred_rules.pop_back();
+        }
+    }
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::send_pending_acks()
+{
+    for (sockinfo_tcp *si : m_pending_acks) {
+        si->flush_coalesced_ack();
+    }
+    m_pending_acks.clear();
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::cancel_pending_ack(sockinfo *sink)
+{
+    if (!m_pending_acks.empty()) {
+        auto iter = std::find(m_pending_acks.begin(), m_pending_acks.end(), sink);
+        if (iter != m_pending_acks.end()) {
+            (*iter)->cancel_coalesced_ack();
+            *iter = m_pending_acks.back();
+            m_pending_acks.pop_back();
+        }
+    }
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::flow_tag_attach(uint32_t flow_tag_id, sockinfo *sink, rfs *p_rfs)
+{
+    if (flow_tag_id >= m_flow_tag_map.size()) {
+        // Tags are derived from the fds, so the map stays dense
+        size_t size = std::max<size_t>(m_flow_tag_map.size() * 2, 64U);
+        m_flow_tag_map.resize(std::max<size_t>(size, flow_tag_id + 1), {nullptr, nullptr});
+    }
+    m_flow_tag_map[flow_tag_id] = {sink, p_rfs};
+}
+
+// Call under m_lock_ring_rx lock
+void ring_slave::flow_tag_detach(sockinfo *sink, rfs *p_rfs)
+{
+    uint32_t flow_tag_id = sink->get_flow_tag_val();
+    if (flow_tag_id < m_flow_tag_map.size() && m_flow_tag_map[flow_tag_id].sink == sink &&
+        m_flow_tag_map[flow_tag_id].p_rfs == p_rfs) {
+        m_flow_tag_map[flow_tag_id] = {nullptr, nullptr};
+    }
 }
 
 bool ring_slave::request_more_tx_buffers(pbuf_type type, uint32_t count, uint32_t lkey)
@@ -1141,7 +1402,10 @@ bool ring_slave::request_more_tx_buffers(pbuf_type type, uint32_t count, uint32_
 
     ring_logfuncall("Allocating additional %d buffers for internal use", count);
 
-    if (type == PBUF_ZEROCOPY) {
+    buffer_pool_cache *cache = m_p_group ? m_p_group->get_tx_buf_cache(type) : nullptr;
+    if (cache) {
+        res = cache->get_buffers(type == PBUF_ZEROCOPY ? m_zc_pool : m_tx_pool, this, count, lkey);
+    } else if (type == PBUF_ZEROCOPY) {
         res = g_buffer_pool_zc->get_buffers_thread_safe(m_zc_pool, this, count, lkey);
     } else {
         res = g_buffer_pool_tx->get_buffers_thread_safe(m_tx_pool, this, count, lkey);
@@ -1150,6 +1414,7 @@ bool ring_slave::request_more_tx_buffers(pbuf_type type, uint32_t count, uint32_
         ring_logfunc("Out of mem_buf_desc from TX free pool for internal object pool");
         return false;
     }
+    update_numa_stats();
 
     return true;
 }
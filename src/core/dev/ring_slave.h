@@ -9,10 +9,15 @@
 
 #include "ring.h"
 #include <memory>
+#include <vector>
 #include "dev/net_device_table_mgr.h"
 #include "util/sock_addr.h"
+#include "util/flow_table.h"
 
 class rfs;
+class rfs_rule;
+class sockinfo_tcp;
+class ip_frag_manager;
 struct iphdr;
 struct ip6_hdr;
 
@@ -235,8 +240,8 @@ public:
 #endif /* DEFINED_UTLS */
 
 private:
-    typedef std::unordered_map<KEY4T, rfs *> flow_spec_4t_map;
-    typedef std::unordered_map<KEY2T, rfs *> flow_spec_2t_map;
+    typedef flow_table<KEY4T, rfs *> flow_spec_4t_map;
+    typedef flow_table<KEY2T, rfs *> flow_spec_2t_map;
 
     flow_spec_4t_map m_flow_tcp_map;
     flow_spec_4t_map m_flow_udp_uc_map;
@@ -245,6 +250,23 @@ private:
     ring_slave &m_ring;
 };
 
+/*
+ * The lock policies of the hot paths of a ring, selected by the use_locks of its construction.
+ * A ring owned by a single thread runs these paths without the ring locks, without even the
+ * virtual calls of the dummy lock.
+ */
+struct ring_lock_policy_real {
+    template <typename L> static int lock(L &l) { return l.lock(); }
+    template <typename L> static int trylock(L &l) { return l.trylock(); }
+    template <typename L> static int unlock(L &l) { return l.unlock(); }
+};
+
+struct ring_lock_policy_none {
+    template <typename L> static int lock(L &) { return 0; }
+    template <typename L> static int trylock(L &) { return 0; }
+    template <typename L> static int unlock(L &) { return 0; }
+};
+
 class ring_slave : public ring {
 public:
     ring_slave(int if_index, ring *parent, bool use_locks);
@@ -261,10 +283,22 @@ public:
                                        const ip_address &src_ip, const ip_address &dst_ip,
                                        uint16_t src_port, uint16_t dst_port);
     virtual bool is_up() = 0;
+    virtual void flush_deferred_rules();
+    // Call under m_lock_ring_rx lock, the rule is destroyed by the next flush_deferred_rules()
+    void retire_rule(rfs_rule *rule) { m_retired_rules.push_back(rule); }
     virtual void inc_tx_retransmissions_stats(ring_user_id_t id);
     bool rx_process_buffer(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array);
     virtual void inc_cq_moderation_stats() = 0;
 
+    void set_rx_filter(xlio_rx_filter_cb_t cb) override
+    {
+        std::lock_guard<decltype(m_lock_ring_rx)> lock(m_lock_ring_rx);
+        m_rx_filter_cb = cb;
+    }
+
+    /* TCP segments are coalesced by the adapter (hardware LRO) on this ring. */
+    virtual bool is_lro(void) const { return false; }
+
     virtual bool attach_flow(flow_tuple &flow_spec_5t, sockinfo *sink, bool force_5t = false);
     virtual bool detach_flow(flow_tuple &flow_spec_5t, sockinfo *sink, rfs_rule **rule_extract);
 
@@ -273,8 +307,28 @@ public:
     rfs_rule *tls_rx_create_rule(const flow_tuple &flow_spec_5t, xlio_tir *tir);
 #endif /* DEFINED_UTLS */
 
+    /* The socket sends its coalesced ACK at the end of the poll. Call under m_lock_ring_rx. */
+    void add_pending_ack(sockinfo_tcp *si) { m_pending_acks.push_back(si); }
+
     transport_type_t get_transport_type() const { return m_transport_type; }
 
+    lat_hists_t *get_lat_hists() override { return &m_p_ring_stat->lat_hists; }
+    tcp_loss_stats_t *get_tcp_loss_stats() override { return &m_p_ring_stat->tcp_loss; }
+
+    void update_failover_stats(uint32_t usec)
+    {
+        ++m_p_ring_stat->n_bond_failovers;
+        m_p_ring_stat->n_bond_failover_usec = usec;
+    }
+
+    /* Account an internal buffers allocation requested from a CPU of a remote NUMA node. */
+    void update_numa_stats()
+    {
+        if (m_numa_node >= 0 && get_current_numa_node() != m_numa_node) {
+            ++m_p_ring_stat->n_numa_cross_allocs;
+        }
+    }
+
     bool m_active; /* State indicator */
 
     virtual mem_buf_desc_t *mem_buf_tx_get(ring_user_id_t id, bool b_block, pbuf_type type,
@@ -284,6 +338,23 @@ public:
 protected:
     bool request_more_tx_buffers(pbuf_type type, uint32_t count, uint32_t lkey);
     void flow_del_all_rfs();
+    void flow_tag_attach(uint32_t flow_tag_id, sockinfo *sink, rfs *p_rfs);
+    void flow_tag_detach(sockinfo *sink, rfs *p_rfs);
+    void install_deferred_rules();
+    void cancel_deferred_rule(rfs *p_rfs);
+    void destroy_retired_rules();
+    void send_pending_acks();
+    void cancel_pending_ack(sockinfo *sink);
+    int rx_filter_packet(mem_buf_desc_t *p_rx_wc_buf_desc);
+    void mirror_rx_packet(mem_buf_desc_t *p_rx_wc_buf_desc);
+
+    // Call under m_lock_ring_rx lock, at the end of a poll of the RX CQ
+    void flush_pending_acks()
+    {
+        if (!m_pending_acks.empty()) {
+            send_pending_acks();
+        }
+    }
 
     steering_handler<flow_spec_4t_key_ipv4, flow_spec_2t_key_ipv4, iphdr> m_steering_ipv4;
     steering_handler<flow_spec_4t_key_ipv6, flow_spec_2t_key_ipv6, ip6_hdr> m_steering_ipv6;
@@ -296,6 +367,21 @@ protected:
     rule_filter_map_t m_tcp_dst_port_attach_map;
     rule_filter_map_t m_udp_uc_dst_port_attach_map;
 
+    // Flow tag to the attached socket and its rfs, so tagged packets skip the flow tables.
+    // Indexed by the flow tag and protected by m_lock_ring_rx.
+    struct flow_tag_entry {
+        sockinfo *sink;
+        rfs *p_rfs;
+    };
+    std::vector<flow_tag_entry> m_flow_tag_map;
+    // 5T rules waiting for the batch installation, protected by m_lock_ring_rx
+    std::vector<rfs *> m_deferred_rules;
+    // HW rules of the closed 5T flows waiting for the batch destruction, protected by
+    // m_lock_ring_rx. They are destroyed after the lock is released.
+    std::vector<rfs_rule *> m_retired_rules;
+    // Sockets with an ACK coalesced during the current poll, protected by m_lock_ring_rx
+    std::vector<sockinfo_tcp *> m_pending_acks;
+
     multilock m_lock_ring_rx;
     mutable multilock m_lock_ring_tx;
 
@@ -303,15 +389,21 @@ protected:
     descq_t m_zc_pool;
     transport_type_t m_transport_type; /* transport ETH/IB */
     std::unique_ptr<ring_stats_t> m_p_ring_stat;
+    // IP reassembly of this ring, created on the first fragment, protected by m_lock_ring_rx
+    std::unique_ptr<ip_frag_manager> m_p_ip_frag;
+    // Ultra API filter of the received packets, protected by m_lock_ring_rx
+    xlio_rx_filter_cb_t m_rx_filter_cb = nullptr;
+    int m_numa_node = -1; // NUMA node of the device, -1 if unknown
     uint16_t m_vlan;
     bool m_flow_tag_enabled;
     const bool m_b_sysvar_eth_mc_l2_only_rules;
     const bool m_b_sysvar_mc_force_flowtag;
+    const bool m_b_use_locks;
 
     template <typename KEY4T, typename KEY2T, typename HDR> friend class steering_handler;
 
 private:
-    uint8_t padding[58] = {}; // make class size up to a whole cache line
+    uint8_t padding[29] = {}; // make class size up to a whole cache line
 };
 
 static_assert(sizeof(ring_slave) % 64 == 0, "ring_slave size is not a multiple of cache line size");
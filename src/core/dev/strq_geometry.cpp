@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <cinttypes>
+#include "dev/strq_geometry.h"
+#include "vlogger/vlogger.h"
+#include "util/sys_vars.h"
+#include "proto/mem_buf_desc.h"
+
+#define MODULE_NAME "strq_geometry"
+
+/* Minimal number of packets to trust the distribution */
+#define STRQ_GEOMETRY_MIN_PACKETS 16384U
+/* Size accounted for the packets above 8192 bytes */
+#define STRQ_GEOMETRY_JUMBO_SIZE 9216U
+
+std::atomic<uint64_t> strq_geometry::s_hist[STRQ_GEOMETRY_BUCKETS];
+
+void strq_geometry::add_samples(const uint32_t *hist)
+{
+    for (uint32_t i = 0; i < STRQ_GEOMETRY_BUCKETS; ++i) {
+        if (hist[i]) {
+            s_hist[i].fetch_add(hist[i], std::memory_order_relaxed);
+        }
+    }
+}
+
+void strq_geometry::pick(uint32_t &stride_size, uint32_t &strides_num)
+{
+    uint64_t hist[STRQ_GEOMETRY_BUCKETS];
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < STRQ_GEOMETRY_BUCKETS; ++i) {
+        hist[i] = s_hist[i].load(std::memory_order_relaxed);
+        total += hist[i];
+    }
+    if (total < STRQ_GEOMETRY_MIN_PACKETS) {
+        return;
+    }
+
+    // Every stride costs its bytes and a descriptor, pick the cheapest stride size
+    const uint64_t wqe_size = static_cast<uint64_t>(stride_size) * strides_num;
+    uint64_t best_cost = UINT64_MAX;
+    uint32_t best_size = stride_size;
+
+    for (uint32_t size = STRQ_MIN_STRIDE_SIZE_BYTES; size <= STRQ_MAX_STRIDE_SIZE_BYTES;
+         size *= 2U) {
+        uint64_t num = wqe_size / size;
+        if (num < STRQ_MIN_STRIDES_NUM || num > STRQ_MAX_STRIDES_NUM) {
+            continue;
+        }
+        uint64_t cost = 0;
+        for (uint32_t i = 0; i < STRQ_GEOMETRY_BUCKETS; ++i) {
+            uint64_t pkt_size =
+                i < STRQ_GEOMETRY_BUCKETS - 1U ? (64U << i) : STRQ_GEOMETRY_JUMBO_SIZE;
+            uint64_t strides = (pkt_size + size - 1U) / size;
+            cost += hist[i] * strides * (size + sizeof(mem_buf_desc_t));
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_size = size;
+        }
+    }
+
+    vlog_printf(VLOG_DEBUG, MODULE_NAME ": %" PRIu64 " packets observed, stride size %u -> %u\n",
+                total, stride_size, best_size);
+    strides_num = static_cast<uint32_t>(wqe_size / best_size);
+    stride_size = best_size;
+}
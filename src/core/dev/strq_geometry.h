@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef STRQ_GEOMETRY_H
+#define STRQ_GEOMETRY_H
+
+#include <stdint.h>
+#include <atomic>
+
+/* Packet size classes: up to 64, 128, ... 8192 bytes and above */
+#define STRQ_GEOMETRY_BUCKETS 9
+/* Packets accumulated by a CQ before they are published */
+#define STRQ_GEOMETRY_FLUSH_PACKETS 1024U
+
+/**
+ * Process wide distribution of the packet sizes received by the striding RQs.
+ *
+ * The CQs accumulate a local histogram and publish it from time to time. A new ring picks
+ * its stride size from the distribution, keeping the configured WQE buffer size.
+ */
+class strq_geometry {
+public:
+    static uint32_t size_to_bucket(uint32_t size)
+    {
+        if (size <= 64U) {
+            return 0U;
+        }
+        uint32_t bucket = (31U - __builtin_clz(size - 1U)) - 5U;
+        return bucket < STRQ_GEOMETRY_BUCKETS ? bucket : STRQ_GEOMETRY_BUCKETS - 1U;
+    }
+
+    static void add_samples(const uint32_t *hist);
+
+    /* Adjusts the configured geometry, unchanged if not enough packets were observed */
+    static void pick(uint32_t &stride_size, uint32_t &strides_num);
+
+private:
+    static std::atomic<uint64_t> s_hist[STRQ_GEOMETRY_BUCKETS];
+};
+
+#endif /* STRQ_GEOMETRY_H */
@@ -7,9 +7,11 @@
 #ifndef TIME_CONVERTER_H
 #define TIME_CONVERTER_H
 
+#include <atomic>
 #include <unordered_map>
 #include <infiniband/verbs.h>
 
+#include "utils/clock.h"
 #include "util/sys_vars.h"
 #include "sock/cleanable_obj.h"
 #include "event/timer_handler.h"
@@ -32,6 +34,65 @@ public:
     }
 };
 
+/**
+ * Linear model of a free running clock in nanoseconds.
+ *
+ * The internal thread publishes a new reference point and rate under a sequence lock,
+ * the readers convert without locks with a multiply and shift instead of divisions.
+ */
+class time_converter_model {
+public:
+    static constexpr unsigned SHIFT = 32U;
+
+    /* Single writer */
+    void update(uint64_t base_clock, uint64_t base_ns, uint64_t clock_hz)
+    {
+        uint64_t mult = clock_hz ? (static_cast<uint64_t>(NSEC_PER_SEC) << SHIFT) / clock_hz : 0;
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_base_clock.store(base_clock, std::memory_order_relaxed);
+        m_base_ns.store(base_ns, std::memory_order_relaxed);
+        m_mult.store(mult, std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /* Returns 0 if the model is not set */
+    uint64_t to_ns(uint64_t clock) const
+    {
+        uint64_t base_clock, base_ns, mult;
+        uint32_t seq;
+
+        do {
+            seq = m_seq.load(std::memory_order_acquire);
+            base_clock = m_base_clock.load(std::memory_order_relaxed);
+            base_ns = m_base_ns.load(std::memory_order_relaxed);
+            mult = m_mult.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1U) || seq != m_seq.load(std::memory_order_relaxed));
+
+        if (!mult) {
+            return 0;
+        }
+        // The reference point may be taken after the packet arrived
+        if (clock >= base_clock) {
+            return base_ns +
+                static_cast<uint64_t>((static_cast<unsigned __int128>(clock - base_clock) * mult) >>
+                                      SHIFT);
+        }
+        return base_ns -
+            static_cast<uint64_t>((static_cast<unsigned __int128>(base_clock - clock) * mult) >>
+                                  SHIFT);
+    }
+
+private:
+    std::atomic<uint32_t> m_seq {0};
+    std::atomic<uint64_t> m_base_clock {0};
+    std::atomic<uint64_t> m_base_ns {0};
+    std::atomic<uint64_t> m_mult {0};
+};
+
 class time_converter : public timer_handler, public cleanable_obj {
 public:
     time_converter()
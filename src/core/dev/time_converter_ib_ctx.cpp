@@ -29,12 +29,10 @@ time_converter_ib_ctx::time_converter_ib_ctx(struct ibv_context *ctx,
                                              ts_conversion_mode_t ctx_time_converter_mode,
                                              uint64_t hca_core_clock)
     : m_p_ibv_context(ctx)
-    , m_ctx_parmeters_id(0)
 {
 #ifdef DEFINED_IBV_CQ_TIMESTAMP
     if (ctx_time_converter_mode != TS_CONVERSION_MODE_DISABLE) {
-        ctx_timestamping_params_t *current_parameters_set =
-            &m_ctx_convert_parmeters[m_ctx_parmeters_id];
+        ctx_timestamping_params_t *current_parameters_set = &m_ctx_convert_parameters;
 
         m_converter_status = TS_CONVERSION_MODE_RAW;
         current_parameters_set->hca_core_clock = hca_core_clock * USEC_PER_SEC;
@@ -52,6 +50,7 @@ time_converter_ib_ctx::time_converter_ib_ctx(struct ibv_context *ctx,
                     UPDATE_HW_TIMER_PERIOD_MS, this, PERIODIC_TIMER, nullptr);
             }
         }
+        update_model();
     }
 #else
     NOT_IN_USE(hca_core_clock);
@@ -76,7 +75,17 @@ void time_converter_ib_ctx::handle_timer_expired(void *user_data)
 
 uint64_t time_converter_ib_ctx::get_hca_core_clock()
 {
-    return m_ctx_convert_parmeters[m_ctx_parmeters_id].hca_core_clock;
+    return m_ctx_convert_parameters.hca_core_clock;
+}
+
+void time_converter_ib_ctx::update_model()
+{
+    const ctx_timestamping_params_t &params = m_ctx_convert_parameters;
+
+    // sync_hw_clock and sync_systime are zero in TS_CONVERSION_MODE_RAW
+    m_model.update(params.sync_hw_clock,
+                   params.sync_systime.tv_sec * NSEC_PER_SEC + params.sync_systime.tv_nsec,
+                   params.hca_core_clock);
 }
 
 #ifdef DEFINED_IBV_CQ_TIMESTAMP
@@ -116,8 +125,7 @@ bool time_converter_ib_ctx::sync_clocks(struct timespec *st, uint64_t *hw_clock)
 
 void time_converter_ib_ctx::fix_hw_clock_deviation()
 {
-    ctx_timestamping_params_t *current_parameters_set =
-        &m_ctx_convert_parmeters[m_ctx_parmeters_id];
+    ctx_timestamping_params_t *current_parameters_set = &m_ctx_convert_parameters;
 
     if (!current_parameters_set->hca_core_clock) {
         return;
@@ -125,8 +133,6 @@ void time_converter_ib_ctx::fix_hw_clock_deviation()
 
     struct timespec current_time, diff_systime;
     uint64_t diff_hw_time, diff_systime_nano, estimated_hw_time, hw_clock;
-    int next_id = (m_ctx_parmeters_id + 1) % 2;
-    ctx_timestamping_params_t *next_parameters_set = &m_ctx_convert_parmeters[next_id];
     int64_t deviation_hw;
 
     if (!sync_clocks(&current_time, &hw_clock)) {
@@ -153,11 +159,11 @@ void time_converter_ib_ctx::fix_hw_clock_deviation()
         return;
     }
 
-    next_parameters_set->hca_core_clock = (diff_hw_time * NSEC_PER_SEC) / diff_systime_nano;
-    next_parameters_set->sync_hw_clock = hw_clock;
-    next_parameters_set->sync_systime = current_time;
+    current_parameters_set->hca_core_clock = (diff_hw_time * NSEC_PER_SEC) / diff_systime_nano;
+    current_parameters_set->sync_hw_clock = hw_clock;
+    current_parameters_set->sync_systime = current_time;
 
-    m_ctx_parmeters_id = next_id;
+    update_model();
 }
 
 #else
@@ -174,38 +180,14 @@ bool time_converter_ib_ctx::sync_clocks(struct timespec *ts, uint64_t *hw_clock)
 
 #endif
 
-inline void time_converter_ib_ctx::calculate_delta(struct timespec &hw_to_timespec,
-                                                   uint64_t hca_core_clock, uint64_t hw_time_diff)
-{
-    hw_to_timespec.tv_sec = hw_time_diff / hca_core_clock;
-    hw_time_diff -= hw_to_timespec.tv_sec * hca_core_clock;
-    hw_to_timespec.tv_nsec = (hw_time_diff * NSEC_PER_SEC) / hca_core_clock;
-}
-
 void time_converter_ib_ctx::convert_hw_time_to_system_time(uint64_t hwtime,
                                                            struct timespec *systime)
 {
-
-    ctx_timestamping_params_t *current_parameters_set =
-        &m_ctx_convert_parmeters[m_ctx_parmeters_id];
-    if (current_parameters_set->hca_core_clock && hwtime) {
-
-        struct timespec hw_to_timespec, sync_systime;
-        uint64_t hca_core_clock, sync_hw_clock;
-
-        // sync_hw_clock should be zero when m_conversion_mode is CONVERSION_MODE_RAW_OR_FAIL or
-        // CONVERSION_MODE_DISABLE
-        hca_core_clock = current_parameters_set->hca_core_clock;
-        sync_hw_clock = current_parameters_set->sync_hw_clock;
-        sync_systime = current_parameters_set->sync_systime;
-
-        // Handle case in which the reference point occurred after the packet has been arrived.
-        if (hwtime > sync_hw_clock) {
-            calculate_delta(hw_to_timespec, hca_core_clock, hwtime - sync_hw_clock);
-            ts_add(&sync_systime, &hw_to_timespec, systime);
-        } else {
-            calculate_delta(hw_to_timespec, hca_core_clock, sync_hw_clock - hwtime);
-            ts_sub(&sync_systime, &hw_to_timespec, systime);
+    if (hwtime) {
+        uint64_t ns = m_model.to_ns(hwtime);
+        if (ns) {
+            systime->tv_sec = ns / NSEC_PER_SEC;
+            systime->tv_nsec = ns % NSEC_PER_SEC;
         }
     }
 }
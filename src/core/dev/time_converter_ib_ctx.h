@@ -24,12 +24,12 @@ public:
 
 private:
     struct ibv_context *m_p_ibv_context;
-    ctx_timestamping_params_t m_ctx_convert_parmeters[2];
-    int m_ctx_parmeters_id;
+    // Updated by the internal thread only
+    ctx_timestamping_params_t m_ctx_convert_parameters;
+    time_converter_model m_model;
 
     void fix_hw_clock_deviation();
-    inline void calculate_delta(struct timespec &hw_to_timespec, uint64_t hca_core_clock,
-                                uint64_t hw_time_diff);
+    void update_model();
     bool sync_clocks(struct timespec *st, uint64_t *hw_clock);
 };
 
@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <mutex>
+#include "tls_dek_pool.h"
+#include "vlogger/vlogger.h"
+#include "dev/ib_ctx_handler.h"
+#include "event/event_handler_manager.h"
+#include "util/sys_vars.h"
+
+#if defined(DEFINED_UTLS)
+
+#define MODULE_NAME "tls_dek_pool"
+
+#define dek_pool_logwarn __log_info_warn
+#define dek_pool_logdbg  __log_info_dbg
+
+#define TLS_DEK_POOL_REFILL_MSEC  10
+#define TLS_DEK_POOL_REFILL_BATCH 64U
+// Key of the DEKs created ahead, replaced by the modification
+#define TLS_DEK_POOL_KEY_SIZE 16U
+
+tls_dek_pool::tls_dek_pool(ib_ctx_handler *ib_ctx)
+    : m_p_ib_ctx(ib_ctx)
+    , m_lock("tls_dek_pool")
+    , m_pool_size(safe_mce_sys().utls_dek_pool_size)
+    , m_timer_handle(nullptr)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    if (m_pool_size) {
+        refill(m_pool_size);
+        m_timer_handle = g_p_event_handler_manager->register_timer_event(
+            TLS_DEK_POOL_REFILL_MSEC, this, PERIODIC_TIMER, nullptr);
+    }
+    dek_pool_logdbg("DEK pool of %s: %zu DEKs", m_p_ib_ctx->get_ibname(), m_get_cache.size());
+}
+
+tls_dek_pool::~tls_dek_pool()
+{
+    if (m_timer_handle) {
+        g_p_event_handler_manager->unregister_timer_event(this, m_timer_handle);
+        m_timer_handle = nullptr;
+    }
+    print_stats();
+}
+
+std::unique_ptr<dpcp::tls_dek> tls_dek_pool::create_dek(const void *key, uint32_t key_size_bytes)
+{
+    dpcp::tls_dek *_dek = nullptr;
+    dpcp::adapter *adapter = m_p_ib_ctx->get_dpcp_adapter();
+    if (unlikely(!adapter)) {
+        return std::unique_ptr<dpcp::tls_dek>(nullptr);
+    }
+
+    struct dpcp::dek_attr dek_attr;
+    memset(&dek_attr, 0, sizeof(dek_attr));
+    dek_attr.key_blob = const_cast<void *>(key);
+    dek_attr.key_blob_size = key_size_bytes;
+    dek_attr.key_size = key_size_bytes;
+    dek_attr.pd_id = adapter->get_pd();
+
+    auto start = std::chrono::steady_clock::now();
+    dpcp::status status = adapter->create_tls_dek(dek_attr, _dek);
+    uint64_t nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    ++m_stats.n_create;
+    m_stats.create_nsec_total += nsec;
+    m_stats.create_nsec_max = std::max(m_stats.create_nsec_max, nsec);
+    if (unlikely(status != dpcp::DPCP_OK)) {
+        dek_pool_logwarn("Failed to create new DEK, status: %d", status);
+        ++m_stats.n_create_fail;
+        delete _dek;
+        _dek = nullptr;
+    }
+    return std::unique_ptr<dpcp::tls_dek>(_dek);
+}
+
+std::unique_ptr<dpcp::tls_dek> tls_dek_pool::get_dek(const void *key, uint32_t key_size_bytes)
+{
+    dpcp::adapter *adapter = m_p_ib_ctx->get_dpcp_adapter();
+    std::unique_ptr<dpcp::tls_dek> out_dek;
+
+    if (unlikely(!adapter)) {
+        return out_dek;
+    }
+
+    {
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+        // Below the low watermark the DEKs are still created, a crypto-sync per a few
+        // released DEKs would be too frequent.
+        if (m_get_cache.empty() &&
+            m_put_cache.size() > safe_mce_sys().utls_low_wmark_dek_cache_size) {
+            dek_pool_logdbg("Empty DEK get cache. Sync-Crypto for %zu DEKs", m_put_cache.size());
+            dpcp::status status = adapter->sync_crypto_tls();
+            if (likely(status == dpcp::DPCP_OK)) {
+                ++m_stats.n_crypto_sync;
+                m_get_cache.splice(m_get_cache.end(), m_put_cache);
+            } else {
+                dek_pool_logwarn("Failed to flush DEK HW cache, status: %d", status);
+            }
+        }
+        if (!m_get_cache.empty()) {
+            out_dek = std::move(m_get_cache.front());
+            m_get_cache.pop_front();
+            ++m_stats.n_pool_hit;
+        } else {
+            ++m_stats.n_pool_miss;
+        }
+    }
+
+    if (!out_dek) {
+        return create_dek(key, key_size_bytes);
+    }
+
+    struct dpcp::dek_attr dek_attr;
+    memset(&dek_attr, 0, sizeof(dek_attr));
+    dek_attr.key_blob = const_cast<void *>(key);
+    dek_attr.key_blob_size = key_size_bytes;
+    dek_attr.key_size = key_size_bytes;
+    dek_attr.pd_id = adapter->get_pd();
+    dpcp::status status = out_dek->modify(dek_attr);
+    if (unlikely(status != dpcp::DPCP_OK)) {
+        dek_pool_logwarn("Failed to modify DEK, status: %d", status);
+        out_dek.reset(nullptr);
+    }
+    return out_dek;
+}
+
+void tls_dek_pool::put_dek(std::unique_ptr<dpcp::tls_dek> &&dek)
+{
+    if (!dek) {
+        return;
+    }
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    // We don't allow unlimited DEK cache to avoid system DEK starvation.
+    if (m_put_cache.size() < safe_mce_sys().utls_high_wmark_dek_cache_size) {
+        m_put_cache.emplace_back(std::move(dek));
+    }
+}
+
+void tls_dek_pool::refill(size_t max_num)
+{
+    static const uint8_t s_key[TLS_DEK_POOL_KEY_SIZE] = {0};
+
+    for (size_t i = 0; i < max_num; ++i) {
+        {
+            std::lock_guard<decltype(m_lock)> lock(m_lock);
+            if (m_get_cache.size() >= m_pool_size) {
+                return;
+            }
+        }
+        // Without the lock, the creation is a firmware command
+        std::unique_ptr<dpcp::tls_dek> dek = create_dek(s_key, sizeof(s_key));
+        if (!dek) {
+            return;
+        }
+
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
+        m_get_cache.emplace_back(std::move(dek));
+        ++m_stats.n_refill;
+    }
+}
+
+void tls_dek_pool::handle_timer_expired(void *user_data)
+{
+    NOT_IN_USE(user_data);
+    refill(TLS_DEK_POOL_REFILL_BATCH);
+}
+
+void tls_dek_pool::print_stats()
+{
+    dek_pool_logdbg("DEK pool of %s: %u / %u [hit/miss], %u refilled, %u failed, %u crypto-syncs, "
+                    "creation %" PRIu64 " / %" PRIu64 " nsec [avg/max]",
+                    m_p_ib_ctx->get_ibname(), m_stats.n_pool_hit, m_stats.n_pool_miss,
+                    m_stats.n_refill, m_stats.n_create_fail, m_stats.n_crypto_sync,
+                    m_stats.n_create ? m_stats.create_nsec_total / m_stats.n_create : 0U,
+                    m_stats.create_nsec_max);
+}
+
+#endif /* DEFINED_UTLS */
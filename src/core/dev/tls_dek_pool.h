@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TLS_DEK_POOL_H
+#define TLS_DEK_POOL_H
+
+#include <list>
+#include <memory>
+#include "event/timer_handler.h"
+#include "utils/lock_wrapper.h"
+#include <mellanox/dpcp.h>
+
+#if defined(DEFINED_UTLS)
+
+class ib_ctx_handler;
+
+struct tls_dek_pool_stats {
+    uint32_t n_pool_hit; // Taken from the pool and modified with the key
+    uint32_t n_pool_miss; // Created on the TLS setup, the pool was empty
+    uint32_t n_refill; // Created ahead by the refill
+    uint32_t n_create; // All the creations, their latency is measured
+    uint32_t n_create_fail;
+    uint32_t n_crypto_sync;
+    uint64_t create_nsec_total;
+    uint64_t create_nsec_max;
+};
+
+/**
+ * DEKs of an ib_ctx_handler shared by its rings, for the devices which synchronize the DEKs.
+ *
+ * A new TLS connection modifies a free DEK with its key instead of the slow creation. The
+ * released DEKs may stay in the HW cache, they are reused after a single crypto-sync once
+ * there are more than the low watermark of them. With utls_dek_pool_size set, the pool is
+ * filled with as many new DEKs on the creation and the internal thread keeps it filled.
+ */
+class tls_dek_pool : public timer_handler {
+public:
+    tls_dek_pool(ib_ctx_handler *ib_ctx);
+    ~tls_dek_pool() override;
+
+    std::unique_ptr<dpcp::tls_dek> get_dek(const void *key, uint32_t key_size_bytes);
+    void put_dek(std::unique_ptr<dpcp::tls_dek> &&dek);
+
+    void handle_timer_expired(void *user_data) override;
+
+    struct tls_dek_pool_stats m_stats;
+
+private:
+    std::unique_ptr<dpcp::tls_dek> create_dek(const void *key, uint32_t key_size_bytes);
+    void refill(size_t max_num);
+    void print_stats();
+
+    ib_ctx_handler *m_p_ib_ctx;
+    lock_mutex m_lock;
+    // Modified with a new key as they are
+    std::list<std::unique_ptr<dpcp::tls_dek>> m_get_cache;
+    // Released, a crypto-sync moves them to m_get_cache
+    std::list<std::unique_ptr<dpcp::tls_dek>> m_put_cache;
+    size_t m_pool_size;
+    void *m_timer_handle;
+};
+
+#endif /* DEFINED_UTLS */
+#endif /* TLS_DEK_POOL_H */
@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <limits.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <sys/time.h>
 #include "utils/bullseye.h"
 #include "utils/clock.h"
 #include "vlogger/vlogger.h"
 #include "core/util/sys_vars.h"
 #include "core/util/utils.h"
+#include "core/util/trace_ring.h"
 #include "delta_timer.h"
 #include "timer_handler.h"
 
@@ -30,7 +33,6 @@
 
 timer::timer()
 {
-    m_list_head = nullptr;
     int ret = gettime(&m_ts_last);
     if (ret) {
         tmr_logerr("gettime() returned with value %d and error (errno %d %m)", ret, errno);
@@ -39,16 +41,12 @@ timer::timer()
 
 timer::~timer()
 {
-    timer_node_t *iter = m_list_head;
-    timer_node_t *to_free = nullptr;
     tmr_logfunc("");
-    m_list_head = nullptr;
-    // free all the list
-    while (iter) {
-        to_free = iter;
-        iter = iter->next;
-        free(to_free);
-    }
+    // free all the wheel
+    m_wheel.for_each([this](timer_node_t *node) {
+        m_wheel.remove(node);
+        free(node);
+    });
 }
 
 void timer::add_new_timer(unsigned int timeout_msec, timer_node_t *node, timer_handler *handler,
@@ -66,21 +64,17 @@ void timer::add_new_timer(unsigned int timeout_msec, timer_node_t *node, timer_h
     }
     BULLSEYE_EXCLUDE_BLOCK_END
 
-    insert_to_list(node);
+    m_wheel.add(node, timeout_msec);
+    tmr_logfuncall("insert new node to wheel (handler %p, timer %d, expiry %lu)", node->handler,
+                   node->orig_time_msec, node->expiry_msec);
     return;
 }
 
 void timer::remove_timer(timer_node_t *node, timer_handler *handler)
 {
-    // Look for handler in the list if node wasen't indicated
+    // Look for handler in the wheel if node wasen't indicated
     if (!node) {
-        node = m_list_head;
-        while (node) {
-            if (node->handler == handler) { // node found
-                break;
-            }
-            node = node->next;
-        }
+        node = m_wheel.find_if([handler](timer_node_t *iter) { return iter->handler == handler; });
     }
 
     // Here we MUST have a valid node pointer
@@ -96,48 +90,24 @@ void timer::remove_timer(timer_node_t *node, timer_handler *handler)
     node->req_type = INVALID_TIMER;
 
     // Remove & Free node
-    remove_from_list(node);
+    m_wheel.remove(node);
     free(node);
     return;
 }
 
 void timer::remove_all_timers(timer_handler *handler)
 {
-    timer_node_t *node = m_list_head;
-    timer_node_t *node_tmp = nullptr;
-
-    // Look for handler in the list if node wasen't indicated
-    while (node) {
-        if (node->handler == handler) { // node found
-            node_tmp = node;
-            node = node->next;
-            // Here we MUST have a valid node pointer
-            BULLSEYE_EXCLUDE_BLOCK_START
-            if (IS_NODE_INVALID(node_tmp) || (node_tmp->handler != handler)) {
-                tmr_logfunc("bad <node,handler> combo for removale (%p,%p)", node_tmp, handler);
-                continue;
-            }
-            BULLSEYE_EXCLUDE_BLOCK_END
-            // Invalidate node before freeing it
-            node_tmp->handler = nullptr;
-            node_tmp->req_type = INVALID_TIMER;
-            remove_from_list(node_tmp);
-            // Remove & Free node
-            free(node_tmp);
-            // coverity[assigned_pointer:FALSE] /* Turn off coverity check,intended assign*/
-            node_tmp = nullptr;
-        } else {
-            node = node->next;
+    m_wheel.for_each([this, handler](timer_node_t *node) {
+        if (node->handler == handler) {
+            remove_timer(node, handler);
         }
-    }
-
-    return;
+    });
 }
 
 int timer::update_timeout()
 {
     int ret = 0, delta_msec = 0;
-    timer_node_t *list_tmp = nullptr;
+    int64_t next_msec;
     struct timespec ts_now, ts_delta;
 
     ret = gettime(&ts_now);
@@ -151,44 +121,32 @@ int timer::update_timeout()
     ts_sub(&ts_now, &m_ts_last, &ts_delta);
     delta_msec = ts_to_msec(&ts_delta);
 
-    // Save 'now' as 'last'
+    // Save 'now' as 'last' and move the wheel
     if (delta_msec > 0) {
         m_ts_last = ts_now;
+        m_wheel.advance(delta_msec);
     }
 
-    // empty list -> unlimited timeout
-    if (!m_list_head) {
+    // empty wheel -> unlimited timeout
+    next_msec = m_wheel.next_timeout();
+    if (next_msec < 0) {
         tmr_logfunc("elapsed time: %d msec", delta_msec);
         ret = INFINITE_TIMEOUT;
-        goto out;
-    }
-
-    // Check for timeout!
-    list_tmp = m_list_head;
-    while (delta_msec > 0 && list_tmp) {
-        tmr_logfuncall("updating list node %p with elapsed time: %d msec", list_tmp, delta_msec);
-        if ((int)list_tmp->delta_time_msec > delta_msec) {
-            list_tmp->delta_time_msec -= delta_msec;
-            break;
-        } else {
-            delta_msec -= list_tmp->delta_time_msec;
-            list_tmp->delta_time_msec = 0;
-        }
-        list_tmp = list_tmp->next;
+    } else {
+        ret = (int)std::min<int64_t>(next_msec, INT_MAX);
     }
 
-    ret = m_list_head->delta_time_msec;
-
-out:
     tmr_logfuncall("next timeout: %d msec", ret);
     return ret;
 }
 
 void timer::process_registered_timers()
 {
-    timer_node_t *iter = m_list_head;
-    timer_node_t *next_iter;
-    while (iter && (iter->delta_time_msec == 0)) {
+    // Only the batch expired so far, a periodic timer of 0 msec runs on the next call
+    size_t expired_num = m_wheel.expired_num();
+    timer_node_t *iter;
+
+    while (expired_num-- && (iter = m_wheel.pop_expired())) {
         tmr_logfuncall("timer expired on %p", iter->handler);
 
         /* Special check is need to protect
@@ -199,17 +157,16 @@ void timer::process_registered_timers()
          */
         if (iter->handler && !iter->lock_timer.trylock() &&
             (1 == iter->lock_timer.is_locked_by_me())) {
+            XLIO_TRACE_RING(TRACE_EVENT_TIMER_BEGIN, iter->handler, 0U);
             iter->handler->handle_timer_expired(iter->user_data);
+            XLIO_TRACE_RING(TRACE_EVENT_TIMER_END, iter->handler, 0U);
             iter->lock_timer.unlock();
         }
-        next_iter = iter->next;
 
         switch (iter->req_type) {
         case PERIODIC_TIMER:
             // re-insert
-            remove_from_list(iter);
-            iter->prev = iter->next = nullptr;
-            insert_to_list(iter);
+            m_wheel.add(iter, iter->orig_time_msec);
             break;
 
         case ONE_SHOT_TIMER:
@@ -224,21 +181,16 @@ void timer::process_registered_timers()
             break;
         }
         BULLSEYE_EXCLUDE_BLOCK_END
-        iter = next_iter;
     }
 }
 
 void timer::process_registered_timers_uncond()
 {
-    timer_node_t *iter = m_list_head;
-    timer_node_t *next_iter;
-    while (iter) {
+    m_wheel.for_each([this](timer_node_t *iter) {
         tmr_logfuncall("timer executed on %p", iter->handler);
 
         iter->handler->handle_timer_expired(iter->user_data);
 
-        next_iter = iter->next;
-
         switch (iter->req_type) {
         case PERIODIC_TIMER:
             break;
@@ -255,71 +207,7 @@ void timer::process_registered_timers_uncond()
             break;
         }
         BULLSEYE_EXCLUDE_BLOCK_END
-        iter = next_iter;
-    }
-}
-
-// insert allocated node to the list
-void timer::insert_to_list(timer_node_t *new_node)
-{
-    unsigned int tmp_delta;
-    timer_node_t *iter;
-    timer_node_t *prev;
-
-    if (!m_list_head) { // first node in the list
-        new_node->delta_time_msec = new_node->orig_time_msec; // time from now
-        new_node->next = nullptr;
-        new_node->prev = nullptr;
-        m_list_head = new_node;
-        tmr_logfuncall("insert first node to list (handler %p, timer %d, delta time %d)",
-                       new_node->handler, new_node->orig_time_msec, new_node->delta_time_msec);
-        return;
-    }
-    // else: need to find the correct place in the list
-    tmp_delta = new_node->orig_time_msec;
-    iter = m_list_head;
-    prev = nullptr;
-
-    while (iter && tmp_delta >= iter->delta_time_msec) {
-        tmp_delta = tmp_delta - iter->delta_time_msec;
-        prev = iter;
-        iter = iter->next;
-    }
-
-    new_node->delta_time_msec = tmp_delta;
-    new_node->next = iter;
-    new_node->prev = prev;
-    if (prev) {
-        prev->next = new_node;
-    } else { // first node in the list
-        m_list_head = new_node;
-    }
-    // update the delta time for the next element
-    if (new_node->next) {
-        new_node->next->delta_time_msec =
-            new_node->next->delta_time_msec - new_node->delta_time_msec;
-        new_node->next->prev = new_node;
-    }
-    tmr_logfuncall("insert new node to list  (handler %p, timer %d, delta time %d)",
-                   new_node->handler, new_node->orig_time_msec, new_node->delta_time_msec);
-}
-
-// remove timer from list (without free)
-// called after timer expired (as part of unregister timer, or while reregister periodic timer)
-void timer::remove_from_list(timer_node_t *node)
-{
-    // remove from the list
-    if (node->prev) { // not the first element in list
-        node->prev->next = node->next;
-    } else {
-        m_list_head = node->next;
-    }
-    if (node->next) { // not the last element in list
-        node->next->delta_time_msec = node->next->delta_time_msec + node->delta_time_msec;
-        node->next->prev = node->prev;
-    }
-    tmr_logfuncall("removed node from list (handler %p, timer %d, delta time %d)", node->handler,
-                   node->orig_time_msec, node->delta_time_msec);
+    });
 }
 
 const char *timer_req_type_str(timer_req_type_t type)
@@ -342,11 +230,9 @@ const char *timer_req_type_str(timer_req_type_t type)
 #if 0
 void timer::debug_print_list()
 {
-	timer_node_t* iter = m_list_head;
 	tmr_logdbg("");
-	while (iter) {
-		tmr_logdbg("node %p timer %d",iter, iter->delta_time_msec);
-		iter = iter->next;
-	}
+	m_wheel.for_each([](timer_node_t* iter) {
+		tmr_logdbg("node %p timer %d expiry %lu",iter, iter->orig_time_msec, iter->expiry_msec);
+	});
 }
 #endif
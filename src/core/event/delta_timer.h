@@ -9,6 +9,7 @@
 
 #include <time.h>
 #include "utils/lock_wrapper.h"
+#include "timer_wheel.h"
 
 #define INFINITE_TIMEOUT (-1)
 
@@ -26,8 +27,8 @@ enum timer_req_type_t {
 };
 
 struct timer_node_t {
-    /* delta time from the previous node (millisec) */
-    unsigned int delta_time_msec;
+    /* expiry on the wheel clock (millisec) */
+    uint64_t expiry_msec;
     /* the orig timer requested (saved in order to re-register periodic timers) */
     unsigned int orig_time_msec;
     /* control thread-safe access to handler. Recursive because unregister_timer_event()
@@ -39,9 +40,11 @@ struct timer_node_t {
     timer_handler *handler;
     void *user_data;
     timer_req_type_t req_type;
+    /* wheel slot the node is linked to */
+    uint16_t wheel_slot;
     struct timer_node_t *next;
     struct timer_node_t *prev;
-}; // used by the list
+}; // used by the wheel
 
 class timer {
 public:
@@ -52,15 +55,15 @@ public:
     void add_new_timer(unsigned int timeout, timer_node_t *node, timer_handler *handler,
                        void *user_data, timer_req_type_t req_type);
 
-    // remove timer from list and free it.
+    // remove timer from the wheel and free it.
     // called for stopping (unregistering) a timer
     void remove_timer(timer_node_t *node, timer_handler *handler);
 
-    // remove all timers from list and free it.
+    // remove all timers from the wheel and free them.
     // called for stopping (unregistering) all timers
     void remove_all_timers(timer_handler *handler);
 
-    // update the timeout in first element in the list
+    // move the wheel by the elapsed time
     // return the timeout needed. (or INFINITE_TIMEOUT if there's no timeout)
     int update_timeout();
 
@@ -72,10 +75,7 @@ public:
     void debug_print_list();
 
 private:
-    void insert_to_list(timer_node_t *node);
-    void remove_from_list(timer_node_t *node);
-
-    timer_node_t *m_list_head;
+    timer_wheel<timer_node_t> m_wheel;
     timespec m_ts_last;
 };
 
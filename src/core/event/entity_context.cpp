@@ -35,6 +35,11 @@
 #include "entity_context.h"
 #include "vlogger/vlogger.h"
 #include "sock/sockinfo_tcp.h"
+#include "entity_context_manager.h"
+#include "util/sys_vars.h"
+#include "utils/asm.h"
+
+#include <sys/eventfd.h>
 
 using namespace std::chrono;
 
@@ -48,13 +53,28 @@ using namespace std::chrono;
 
 entity_context::entity_context(size_t index)
     : poll_group(xlio_poll_group_attr {XLIO_GROUP_FLAG_SAFE | XLIO_GROUP_FLAG_DIRTY, nullptr,
-                                       entity_context_comp_cb, nullptr, nullptr})
+                                       entity_context_comp_cb, nullptr, nullptr,
+                                       sizeof(xlio_poll_group_attr), nullptr, nullptr, 0U, 0U,
+                                       nullptr, nullptr, nullptr, 0U, 0U})
     , m_index(index)
     , m_prev_proc_time(steady_clock::now())
+    , m_park_msec(safe_mce_sys().worker_park_msec)
+    , m_idle_pause_usec(safe_mce_sys().worker_idle_pause_usec)
+    , m_idle_block_usec(safe_mce_sys().worker_idle_block_usec)
+    , m_may_sleep(m_park_msec || m_idle_block_usec)
 {
     memset(&m_stats, 0, sizeof(m_stats));
     xlio_stats_instance_create_ent_ctx_block(&m_stats);
 
+    if (m_idle_block_usec) {
+        m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeup_fd < 0) {
+            ctx_logwarn("Failed to create the wakeup fd (errno=%d), blocking is disabled", errno);
+        } else {
+            set_wakeup_fd(m_wakeup_fd);
+        }
+    }
+
     get_event_handler()->do_tasks(); // Update last_taken_time
 
     ctx_logdbg("Entity Context created");
@@ -63,27 +83,32 @@ entity_context::entity_context(size_t index)
 entity_context::~entity_context()
 {
     xlio_stats_instance_remove_ent_ctx_block(&m_stats);
+    if (m_wakeup_fd >= 0) {
+        SYSCALL(close, m_wakeup_fd);
+    }
 
     ctx_logdbg("Entity Context destroyed");
 }
 
 void entity_context::process()
 {
-    auto ts = steady_clock::now();
+    auto ts = event_handler_manager_local::coarse_now();
     (!m_last_poll_hit ? m_stats.idle_time : m_stats.hit_poll_time) +=
         duration_cast<nanoseconds>(get_event_handler()->last_taken_time() - m_prev_proc_time)
             .count();
-    (!m_last_job_size ? m_stats.idle_time : m_stats.job_proc_time) +=
+    size_t last_job_size = m_last_job_size.load(std::memory_order_relaxed);
+    (!last_job_size ? m_stats.idle_time : m_stats.job_proc_time) +=
         duration_cast<nanoseconds>(ts - get_event_handler()->last_taken_time()).count();
     m_prev_proc_time = ts;
 
     m_last_poll_hit = poll();
 
+    size_t connects = process_connects();
     auto &jobs = m_job_queue.get_all();
     for (auto &job : jobs) {
         switch (job.job_id) {
         case JOB_TYPE_SOCK_ADD_AND_CONNECT:
-            connect_socket_job(job);
+            connect_socket(job.sock);
             break;
         case JOB_TYPE_SOCK_ADD_AND_LISTEN:
             listen_socket_job(job);
@@ -91,6 +116,9 @@ void entity_context::process()
         case JOB_TYPE_SOCK_TX:
             tx_data_job(job);
             break;
+        case JOB_TYPE_SOCK_TX_ZCOPY:
+            tx_zcopy_job(job);
+            break;
         case JOB_TYPE_SOCK_RX_DATA_RECVD:
             rx_data_recvd_job(job);
             break;
@@ -107,20 +135,191 @@ void entity_context::process()
     m_stats.job_queue_hits += (jobs.size() ? 1 : 0);
     m_stats.job_queue_size_max =
         std::max(m_stats.job_queue_size_max, static_cast<uint32_t>(jobs.size()));
-    m_last_job_size = jobs.size();
+    m_last_job_size.store(jobs.size() + connects, std::memory_order_relaxed);
+
+    bool idle = !m_last_poll_hit && jobs.empty() && !connects;
+    if (idle) {
+        steal_connects();
+    }
     jobs.clear();
 
     flush();
+
+    if (m_may_sleep || m_idle_pause_usec) {
+        idle_policy(ts, idle);
+    }
+}
+
+/*
+ * The idle states from the lowest latency: polling, polling with a CPU pause between the polls,
+ * blocking on the CQ notifications and, without sockets, parking until a job.
+ * A context enters a state after being idle for its configured time, any progress returns it to
+ * the polling.
+ */
+void entity_context::idle_policy(event_handler_manager_local::time_point ts, bool idle)
+{
+    if (!idle) {
+        m_idle = false;
+        return;
+    }
+    if (!m_idle) {
+        m_idle = true;
+        m_idle_since = ts;
+        return;
+    }
+
+    auto idle_time = ts - m_idle_since;
+    if (m_park_msec && idle_time >= milliseconds(m_park_msec) && !has_sockets()) {
+        auto start = steady_clock::now();
+        park();
+        m_stats.idle_block_time += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    } else if (m_idle_block_usec && m_wakeup_fd >= 0 &&
+               idle_time >= microseconds(m_idle_block_usec)) {
+        block();
+    } else if (m_idle_pause_usec && idle_time >= microseconds(m_idle_pause_usec)) {
+        pause();
+    }
+}
+
+void entity_context::pause()
+{
+    auto start = steady_clock::now();
+
+#if defined(__x86_64__)
+    static const bool s_waitpkg = cpu_has_waitpkg();
+    if (s_waitpkg) {
+        unsigned long long tsc;
+        gettimeoftsc(&tsc);
+        cpu_tpause(tsc + ENTITY_CONTEXT_TPAUSE_CYCLES);
+    } else
+#endif
+    {
+        for (int i = 0; i < ENTITY_CONTEXT_PAUSE_NUM; ++i) {
+            cpu_relax();
+        }
+    }
+    m_stats.idle_pause_time += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+void entity_context::block()
+{
+    auto start = steady_clock::now();
+
+    m_blocked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // The jobs queued before the flag was visible stay in the batch for the next iteration
+    if (m_job_queue.get_all().empty() && !get_pending_connects()) {
+        // Limited for a stop request, the TCP timers limit it further
+        if (wait(ENTITY_CONTEXT_PARK_CHECK_MSEC) > 0) {
+            m_idle = false;
+        }
+    }
+    m_blocked.store(false, std::memory_order_relaxed);
+
+    m_stats.idle_block_time += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+void entity_context::unblock()
+{
+    uint64_t val = 1U;
+    if (SYSCALL(write, m_wakeup_fd, &val, sizeof(val)) < 0 && errno != EAGAIN) {
+        ctx_logdbg("Failed to write the wakeup fd (errno=%d)", errno);
+    }
+}
+
+void entity_context::park()
+{
+    std::unique_lock<std::mutex> lock(m_park_mutex);
+
+    m_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // The jobs queued before the flag was visible stay in the batch for the next iteration
+    if (m_job_queue.get_all().empty() && !get_pending_connects()) {
+        ctx_logdbg("Entity Context parked");
+        m_park_cond.wait_for(lock, milliseconds(ENTITY_CONTEXT_PARK_CHECK_MSEC),
+                             [this] { return !m_parked.load(std::memory_order_relaxed); });
+    }
+    m_parked.store(false, std::memory_order_relaxed);
+}
+
+void entity_context::unpark()
+{
+    std::lock_guard<std::mutex> lock(m_park_mutex);
+    m_parked.store(false, std::memory_order_relaxed);
+    m_park_cond.notify_one();
+}
+
+void entity_context::add_connect_job(sockinfo *sock)
+{
+    {
+        std::lock_guard<lock_spin> guard(m_connect_lock);
+        m_connect_pending.push_back(sock);
+        m_connect_pending_num.store(m_connect_pending.size(), std::memory_order_relaxed);
+    }
+    wake_up();
+}
+
+size_t entity_context::process_connects()
+{
+    if (!get_pending_connects()) {
+        return 0U;
+    }
+
+    m_connect_lock.lock();
+    m_connect_batch.swap(m_connect_pending);
+    m_connect_pending_num.store(0U, std::memory_order_relaxed);
+    m_connect_lock.unlock();
+
+    for (sockinfo *sock : m_connect_batch) {
+        connect_socket(sock);
+    }
+    size_t num = m_connect_batch.size();
+    m_connect_batch.clear();
+    return num;
+}
+
+bool entity_context::give_connects(std::vector<sockinfo *> &out)
+{
+    // The owner or another thief holds the lock, the connections are being taken anyway
+    if (m_connect_lock.trylock()) {
+        return false;
+    }
+
+    // The oldest connections first, the owner keeps the rest
+    size_t num = m_connect_pending.size() - m_connect_pending.size() / 2U;
+    out.insert(out.end(), m_connect_pending.begin(), m_connect_pending.begin() + num);
+    m_connect_pending.erase(m_connect_pending.begin(), m_connect_pending.begin() + num);
+    m_connect_pending_num.store(m_connect_pending.size(), std::memory_order_relaxed);
+    m_connect_lock.unlock();
+
+    m_sockets_load.fetch_sub(num, std::memory_order_relaxed);
+    return num;
+}
+
+void entity_context::steal_connects()
+{
+    entity_context *victim = entity_context_manager::instance()->get_steal_victim(this);
+    if (!victim || !victim->give_connects(m_connect_batch)) {
+        return;
+    }
+
+    m_sockets_load.fetch_add(m_connect_batch.size(), std::memory_order_relaxed);
+    m_stats.socket_num_stolen += m_connect_batch.size();
+    for (sockinfo *sock : m_connect_batch) {
+        ctx_logdbg("Socket taken over from context %zu (sock: %p)", victim->get_index(), sock);
+        connect_socket(sock);
+    }
+    m_connect_batch.clear();
 }
 
 void entity_context::add_job(const job_desc &job)
 {
     m_job_queue.insert_job(job);
+    wake_up();
 }
 
-void entity_context::connect_socket_job(const job_desc &job)
+void entity_context::connect_socket(sockinfo *sock)
 {
-    sockinfo *sock = job.sock;
     if (sock->get_protocol() == PROTO_TCP) {
         sock->set_entity_context(this);
         add_socket(reinterpret_cast<sockinfo_tcp *>(sock));
@@ -141,10 +340,20 @@ void entity_context::tx_data_job(const job_desc &job)
     job.sock->tx_thread_commit(job.buf, job.offset, job.tot_size, job.flags);
 }
 
+void entity_context::tx_zcopy_job(const job_desc &job)
+{
+    if (unlikely(!job.zc_op || !job.sock || job.sock->get_protocol() != PROTO_TCP)) {
+        ctx_logwarn("Invalid zero copy TX job");
+        return;
+    }
+    reinterpret_cast<sockinfo_tcp *>(job.sock)->tx_zcopy_thread_commit(job.zc_op);
+}
+
 void entity_context::add_incoming_socket(sockinfo *sock)
 {
     if (sock->get_protocol() == PROTO_TCP) {
         ++m_stats.socket_num_added;
+        inc_sockets_load();
         add_socket(reinterpret_cast<sockinfo_tcp *>(sock));
     }
 }
@@ -200,6 +409,7 @@ void entity_context::close_socket_job(const job_desc &job)
             --m_stats.listen_rsschild_num;
         } else {
             ++m_stats.socket_num_removed;
+            m_sockets_load.fetch_sub(1U, std::memory_order_relaxed);
         }
         // Use poll_group::close_socket_helper which handles :
         // - remove_socket(si)
@@ -212,11 +422,15 @@ void entity_context::close_socket_job(const job_desc &job)
 void entity_context::entity_context_comp_cb(xlio_socket_t sock, uintptr_t userdata_sq,
                                             uintptr_t userdata_op)
 {
-    mem_buf_desc_t *buf = reinterpret_cast<mem_buf_desc_t *>(userdata_op);
-
-    NOT_IN_USE(sock);
     NOT_IN_USE(userdata_sq);
 
+    if (userdata_op & ENTITY_CONTEXT_ZCOPY_TAG) {
+        reinterpret_cast<sockinfo_tcp *>(sock)->tx_zcopy_complete(
+            reinterpret_cast<tx_zcopy_op *>(userdata_op & ~ENTITY_CONTEXT_ZCOPY_TAG));
+        return;
+    }
+
+    mem_buf_desc_t *buf = reinterpret_cast<mem_buf_desc_t *>(userdata_op);
     if (buf->lwip_pbuf.ref > 1) {
         // Optimization to reduce the number of ring locks.
         --buf->lwip_pbuf.ref;
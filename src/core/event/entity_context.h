@@ -35,6 +35,9 @@
 #ifndef ENTITY_CONTEXT_H
 #define ENTITY_CONTEXT_H
 
+#include <mutex>
+#include <condition_variable>
+
 #include "event/poll_group.h"
 #include "event/job_queue.h"
 #include "util/xlio_stats.h"
@@ -43,6 +46,23 @@
 class sockinfo;
 class mem_buf_desc_t;
 
+// Zero copy send of the application memory, see xlio_api_t::send_zcopy()
+struct tx_zcopy_op {
+    uintptr_t userdata;
+    uint32_t mkey;
+    uint32_t iovcnt;
+    struct iovec *iov; // Allocated after the operation
+};
+
+// Marks the zero copy operations in the completions, the buffer descriptors are aligned
+#define ENTITY_CONTEXT_ZCOPY_TAG 1UL
+
+// Longest sleep of a parked context, a stop request is noticed within it
+#define ENTITY_CONTEXT_PARK_CHECK_MSEC 100
+// Length of an idle pause, about a microsecond
+#define ENTITY_CONTEXT_TPAUSE_CYCLES 2000U
+#define ENTITY_CONTEXT_PAUSE_NUM     32
+
 class entity_context : public poll_group {
 public:
     enum job_type {
@@ -50,7 +70,8 @@ public:
         JOB_TYPE_SOCK_TX,
         JOB_TYPE_SOCK_RX_DATA_RECVD,
         JOB_TYPE_SOCK_ADD_AND_LISTEN,
-        JOB_TYPE_SOCK_CLOSE
+        JOB_TYPE_SOCK_CLOSE,
+        JOB_TYPE_SOCK_TX_ZCOPY
     };
 
     enum job_flag {
@@ -61,7 +82,10 @@ public:
         job_type job_id;
         int flags;
         sockinfo *sock;
-        mem_buf_desc_t *buf;
+        union {
+            mem_buf_desc_t *buf;
+            tx_zcopy_op *zc_op; // JOB_TYPE_SOCK_TX_ZCOPY
+        };
         uint32_t offset;
         uint32_t tot_size;
     };
@@ -73,12 +97,58 @@ public:
     void process();
     void add_job(const job_desc &job);
 
+    // Sockets owned, including the distributed ones not added yet, and the jobs of the last
+    // batch. A heavy connection queues more jobs. Read by the distributing threads.
+    size_t get_load() const
+    {
+        return m_sockets_load.load(std::memory_order_relaxed) +
+            m_last_job_size.load(std::memory_order_relaxed);
+    }
+    void inc_sockets_load() { m_sockets_load.fetch_add(1U, std::memory_order_relaxed); }
+
+    // New connections are kept apart from the job queue, an idle context can take them over.
+    // The socket has no context before its connect job, so the later jobs of the socket go
+    // to the context which connected it and the order per socket remains.
+    void add_connect_job(sockinfo *sock);
+    size_t get_pending_connects() const
+    {
+        return m_connect_pending_num.load(std::memory_order_relaxed);
+    }
+    // Moves half of the pending connections to the stealing context, fails if contended.
+    bool give_connects(std::vector<sockinfo *> &out);
+
+    // A context without sockets and jobs parks its thread, see XLIO_WORKER_THREADS_PARK_MSEC,
+    // and an idle one blocks on the CQ notifications, see XLIO_WORKER_THREADS_IDLE_BLOCK_USEC.
+    // The producers wake it up after queueing new work.
+    void wake_up()
+    {
+        if (m_may_sleep) {
+            // Pairs with the fences of park() and block(), either the job is seen or the flag
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (unlikely(m_parked.load(std::memory_order_relaxed))) {
+                unpark();
+            }
+            if (unlikely(m_blocked.load(std::memory_order_relaxed))) {
+                unblock();
+            }
+        }
+    }
+    void unpark();
+
     // Called only by the XLIO thread executing this context.
     void add_incoming_socket(sockinfo *sock);
 
 private:
-    void connect_socket_job(const job_desc &job);
+    size_t process_connects();
+    void steal_connects();
+    void idle_policy(event_handler_manager_local::time_point ts, bool idle);
+    void park();
+    void block();
+    void unblock();
+    void pause();
+    void connect_socket(sockinfo *sock);
     void tx_data_job(const job_desc &job);
+    void tx_zcopy_job(const job_desc &job);
     void rx_data_recvd_job(const job_desc &job);
     void listen_socket_job(const job_desc &job);
     void close_socket_job(const job_desc &job);
@@ -88,9 +158,25 @@ private:
 
     job_queue<job_desc> m_job_queue;
     size_t m_index;
-    size_t m_last_job_size = 0U;
+    std::atomic<size_t> m_last_job_size {0U};
+    std::atomic<size_t> m_sockets_load {0U};
+    lock_spin m_connect_lock;
+    std::vector<sockinfo *> m_connect_pending;
+    std::vector<sockinfo *> m_connect_batch;
+    std::atomic<size_t> m_connect_pending_num {0U};
     event_handler_manager_local::time_point m_prev_proc_time;
     bool m_last_poll_hit = false;
+    bool m_idle = false;
+    event_handler_manager_local::time_point m_idle_since;
+    const uint32_t m_park_msec;
+    const uint32_t m_idle_pause_usec;
+    const uint32_t m_idle_block_usec;
+    const bool m_may_sleep;
+    int m_wakeup_fd = -1;
+    std::atomic<bool> m_parked {false};
+    std::atomic<bool> m_blocked {false};
+    std::mutex m_park_mutex;
+    std::condition_variable m_park_cond;
     entity_context_stats_t m_stats;
 };
 
@@ -87,9 +87,44 @@ entity_context_manager::~entity_context_manager()
 
 void entity_context_manager::distribute_socket(sockinfo *si, entity_context::job_type jobtype)
 {
-    uint16_t next_idx = m_next_distribute.fetch_add(1U) % safe_mce_sys().worker_threads;
-    m_entity_contexts[next_idx]->add_job(
-        entity_context::job_desc {jobtype, 0, si, nullptr, 0U, 0U});
+    size_t workers = m_entity_contexts.size();
+    size_t next_idx = m_next_distribute.fetch_add(1U) % workers;
+
+    if (g_hot_sys_var.worker_placement == WORKER_PLACEMENT_LEAST_LOADED) {
+        // Start at the round robin position, the equally loaded workers take turns
+        size_t min_load = m_entity_contexts[next_idx]->get_load();
+        for (size_t i = 1U; i < workers && min_load; ++i) {
+            size_t idx = (next_idx + i) % workers;
+            size_t load = m_entity_contexts[idx]->get_load();
+            if (load < min_load) {
+                min_load = load;
+                next_idx = idx;
+            }
+        }
+    }
+
+    m_entity_contexts[next_idx]->inc_sockets_load();
+    if (jobtype == entity_context::JOB_TYPE_SOCK_ADD_AND_CONNECT) {
+        m_entity_contexts[next_idx]->add_connect_job(si);
+    } else {
+        m_entity_contexts[next_idx]->add_job(
+            entity_context::job_desc {jobtype, 0, si, nullptr, 0U, 0U});
+    }
+}
+
+entity_context *entity_context_manager::get_steal_victim(const entity_context *thief) const
+{
+    entity_context *victim = nullptr;
+    size_t max_pending = ENTITY_CONTEXT_STEAL_MIN_PENDING - 1U;
+
+    for (entity_context *ctx : m_entity_contexts) {
+        size_t pending = ctx->get_pending_connects();
+        if (ctx != thief && pending > max_pending) {
+            max_pending = pending;
+            victim = ctx;
+        }
+    }
+    return victim;
 }
 
 void entity_context_manager::distribute_listen_socket(sockinfo_tcp *si)
@@ -121,3 +156,24 @@ int entity_context_manager::calculate_entity_context_pow2()
 
     return pow2;
 }
+
+int entity_context_manager::calculate_listen_buckets()
+{
+    int buckets = calculate_entity_context_pow2();
+
+    while (buckets && buckets < static_cast<int>(safe_mce_sys().worker_listen_buckets)) {
+        buckets <<= 1;
+    }
+    return buckets;
+}
+
+int entity_context_manager::calculate_listen_child_buckets(int child_index)
+{
+    int worker_threads = safe_mce_sys().worker_threads;
+    int buckets = calculate_listen_buckets();
+
+    if (child_index < 0 || child_index >= worker_threads) {
+        return 0;
+    }
+    return (buckets - 1 - child_index) / worker_threads + 1;
+}
@@ -42,6 +42,9 @@
 class sockinfo;
 class sockinfo_tcp;
 
+// A context processes its new connections every iteration, a backlog means it is busy
+#define ENTITY_CONTEXT_STEAL_MIN_PENDING 2U
+
 class entity_context_manager {
 public:
     entity_context_manager();
@@ -54,10 +57,18 @@ public:
 
     void distribute_socket(sockinfo *si, entity_context::job_type jobtype);
     void distribute_listen_socket(sockinfo_tcp *si);
+    // The context with the longest backlog of new connections, if it is behind
+    entity_context *get_steal_victim(const entity_context *thief) const;
 
     const std::vector<entity_context *> &get_all_contexts() const { return m_entity_contexts; }
 
     static int calculate_entity_context_pow2();
+    /*
+     * The source port buckets of a listen socket, a power of 2. The listen RSS child n owns
+     * the buckets n, n + worker_threads, n + 2 * worker_threads and so on.
+     */
+    static int calculate_listen_buckets();
+    static int calculate_listen_child_buckets(int child_index);
 
 private:
     static entity_context_manager *s_p_entity_context_manager;
@@ -18,6 +18,7 @@
 #include "event_handler_rdma_cm.h"
 #include "core/sock/sockinfo_tcp.h"
 #include "core/util/instrumentation.h"
+#include "core/util/coarse_clock.h"
 
 #define MODULE_NAME "evh:"
 
@@ -760,6 +761,9 @@ void event_handler_manager::statistics_print(dump_type_t dump_type, int fd, vlog
         case DUMP_NEIGH:
             // Not implemented yet
             break;
+        case DUMP_TRACE:
+            trace_ring_dump(safe_mce_sys().stats_shmem_dirname);
+            break;
         default:
             evh_logdbg("Impossible statistics dump request (type=%d).", dump_type);
         }
@@ -889,6 +893,8 @@ void *event_handler_manager::thread_loop()
     poll_fd.events = POLLIN | POLLPRI;
     poll_fd.revents = 0;
     while (m_b_continue_running) {
+        coarse_clock_tick();
+
         // update timer and get timeout
         timeout_msec = m_timer.update_timeout();
         if (timeout_msec == 0) {
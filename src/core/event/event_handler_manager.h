@@ -11,7 +11,7 @@
 #include <deque>
 #include "vlogger/vlogger.h"
 #include "utils/lock_wrapper.h"
-#include "core/util/wakeup_pipe.h"
+#include "core/util/wakeup_eventfd.h"
 #include "core/netlink/netlink_wrapper.h"
 #include "core/infra/subject_observer.h"
 #include "core/event/command.h"
@@ -155,7 +155,7 @@ typedef std::map<timer_handler *, void *> timer_list_t;
 ** All registered objects must implememtn the event_handler class which is the registered callback
 *function.
 */
-class event_handler_manager : public wakeup_pipe {
+class event_handler_manager : public wakeup_eventfd {
 public:
     event_handler_manager(bool internal_thread_mode = true);
     ~event_handler_manager();
@@ -6,26 +6,63 @@
 
 #include "event_handler_manager_local.h"
 #include "util/sys_vars.h"
+#include "util/coarse_clock.h"
 #include "xlio.h"
 
 using namespace std::chrono;
 
-thread_local event_handler_manager_local g_event_handler_manager_local;
+thread_local event_handler_manager_local g_event_handler_manager_local(true);
 
-event_handler_manager_local::event_handler_manager_local()
+event_handler_manager_local::event_handler_manager_local(bool thread_bound)
     : event_handler_manager(false)
+    , m_thread_bound(thread_bound)
+    , m_owner_thread(pthread_self())
+    , m_remote_lock("event_handler_manager_local")
+    , m_remote_pending(false)
 {
 }
 
 void event_handler_manager_local::post_new_reg_action(reg_action_t &reg_action)
 {
+    if (unlikely(m_thread_bound && !pthread_equal(pthread_self(), m_owner_thread))) {
+        // The timers belong to the owner thread, it runs the action on its next tasks
+        std::lock_guard<decltype(m_remote_lock)> lock(m_remote_lock);
+        m_remote_actions.push_back(reg_action);
+        m_remote_pending.store(true, std::memory_order_release);
+        return;
+    }
+
     // For thread local event handler registration can be immediate.
     handle_registration_action(reg_action);
 }
 
+void event_handler_manager_local::process_remote_actions()
+{
+    std::deque<reg_action_t> actions;
+
+    if (likely(!m_remote_pending.load(std::memory_order_acquire))) {
+        return;
+    }
+
+    m_remote_lock.lock();
+    actions.swap(m_remote_actions);
+    m_remote_pending.store(false, std::memory_order_relaxed);
+    m_remote_lock.unlock();
+
+    for (reg_action_t &reg_action : actions) {
+        handle_registration_action(reg_action);
+    }
+}
+
+event_handler_manager_local::time_point event_handler_manager_local::coarse_now()
+{
+    // steady_clock is CLOCK_MONOTONIC, the base of the coarse clock
+    return time_point(duration_cast<steady_clock::duration>(nanoseconds(coarse_clock_update())));
+}
+
 void event_handler_manager_local::do_tasks()
 {
-    m_last_taken_time = steady_clock::now();
+    m_last_taken_time = coarse_now();
     if (likely(safe_mce_sys().tcp_timer_resolution_msec >
                duration_cast<milliseconds>(m_last_taken_time - m_last_run_time).count())) {
         return;
@@ -38,6 +75,7 @@ void event_handler_manager_local::do_tasks()
 
 void event_handler_manager_local::do_tasks_for_thread_local()
 {
+    process_remote_actions();
     m_timer.process_registered_timers_uncond();
 
     while (!m_close_postponed_sockets.empty()) {
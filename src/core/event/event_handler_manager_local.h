@@ -7,7 +7,10 @@
 #ifndef THREAD_LOCAL_EVENT_HANDLER_H
 #define THREAD_LOCAL_EVENT_HANDLER_H
 
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <pthread.h>
 
 #include "event_handler_manager.h"
 #include "sock/sockinfo.h"
@@ -16,17 +19,21 @@ class event_handler_manager_local : public event_handler_manager {
 public:
     typedef std::chrono::steady_clock::time_point time_point;
 
-    event_handler_manager_local();
+    // A thread bound manager runs the registrations of the other threads in its own do_tasks()
+    event_handler_manager_local(bool thread_bound = false);
 
     void add_close_postponed_socket(sockinfo *sock);
     void do_tasks();
     const time_point &last_taken_time() { return m_last_taken_time; }
+    // Refreshes the coarse clock of the thread for a new poll pass, see coarse_clock.h
+    static time_point coarse_now();
 
 protected:
     virtual void post_new_reg_action(reg_action_t &reg_action) override;
 
 private:
     void do_tasks_for_thread_local();
+    void process_remote_actions();
 
     time_point m_last_run_time;
     time_point m_last_taken_time;
@@ -38,6 +45,13 @@ private:
     // guaranteed to be unused for half open sockets as application does not receive the fd for such
     // sockets.
     xlio_list_t<sockinfo, sockinfo::socket_fd_list_node_offset> m_close_postponed_sockets;
+
+    bool m_thread_bound;
+    pthread_t m_owner_thread;
+    // Registrations posted by the other threads, e.g. a socket closed out of its owner thread
+    lock_spin m_remote_lock;
+    std::deque<reg_action_t> m_remote_actions;
+    std::atomic<bool> m_remote_pending;
 };
 
 extern thread_local event_handler_manager_local g_event_handler_manager_local;
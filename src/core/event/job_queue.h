@@ -37,8 +37,32 @@
 
 #include <vector>
 #include <atomic>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include "utils/lock_wrapper.h"
+#include "util/spsc_ring.h"
 
+#define JOB_QUEUE_PRODUCER_RING 256U
+#define JOB_QUEUE_PRODUCERS_MAX 64U
+
+// Unique id of a queue, the ids aren't reused so a stale per thread cache entry is never hit
+inline uint32_t job_queue_next_id()
+{
+    static std::atomic<uint32_t> s_next_id {0U};
+    return s_next_id.fetch_add(1U, std::memory_order_relaxed);
+}
+
+/**
+ * Multi producer single consumer job queue.
+ *
+ * Every producer thread owns a single producer ring of the queue, so an insert writes only
+ * the producer cache lines and takes no lock. A full ring spills to the locked overflow of the
+ * producer until the consumer takes it, which keeps the order of the jobs of a producer.
+ * The producers past JOB_QUEUE_PRODUCERS_MAX share a locked vector. A thread releases its
+ * rings when it exits and a new producer thread takes a released ring before it allocates one,
+ * so JOB_QUEUE_PRODUCERS_MAX bounds the concurrent producers only.
+ */
 template <typename T> class job_queue {
 public:
     typedef std::vector<T> queue_type;
@@ -49,36 +73,162 @@ public:
 
     queue_type &get_all();
 
+    // Producer rings allocated so far
+    uint32_t producers_num() const
+    {
+        return std::min(m_producers_num.load(std::memory_order_relaxed), JOB_QUEUE_PRODUCERS_MAX);
+    }
+
 private:
-    queue_type m_queue_insert;
+    struct producer {
+        spsc_ring<T, JOB_QUEUE_PRODUCER_RING> ring;
+        std::atomic<bool> overflow_pending {false};
+        queue_type overflow;
+        lock_spin overflow_lock;
+        // Owned by a live thread, the ring has a single producer at a time
+        std::atomic<bool> in_use {true};
+    };
+
+    // The rings of a thread, indexed by the queue id. A queue destroyed first leaves its
+    // rings to the thread until it exits.
+    struct thread_producers {
+        std::vector<std::shared_ptr<producer>> rings;
+
+        ~thread_producers()
+        {
+            for (auto &p : rings) {
+                if (p) {
+                    p->in_use.store(false, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    producer *get_producer();
+    std::shared_ptr<producer> acquire_producer();
+    void fetch_locked(lock_spin &lock, queue_type &queue, std::atomic<bool> &pending);
+
+    std::atomic<producer *> m_producers[JOB_QUEUE_PRODUCERS_MAX];
+    // Written before the ring is published in m_producers
+    std::shared_ptr<producer> m_owners[JOB_QUEUE_PRODUCERS_MAX];
+    std::atomic<uint32_t> m_producers_num {0U};
+    std::atomic<bool> m_shared_pending {false};
+    queue_type m_queue_shared;
     queue_type m_queue_fetch;
     lock_spin m_queue_lock;
+    const uint32_t m_id;
 };
 
-template <typename T> job_queue<T>::job_queue()
+template <typename T>
+job_queue<T>::job_queue()
+    : m_id(job_queue_next_id())
 {
-    m_queue_insert.reserve(32);
+    for (auto &p : m_producers) {
+        p.store(nullptr, std::memory_order_relaxed);
+    }
     m_queue_fetch.reserve(32);
 }
 
-// Should be called only from the producer.
+// Takes a ring released by an exited thread or allocates a new one.
+template <typename T>
+std::shared_ptr<typename job_queue<T>::producer> job_queue<T>::acquire_producer()
+{
+    uint32_t num = producers_num();
+
+    for (uint32_t i = 0; i < num; ++i) {
+        producer *p = m_producers[i].load(std::memory_order_acquire);
+        bool in_use = false;
+        if (p && !p->in_use.load(std::memory_order_relaxed) &&
+            p->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+            return m_owners[i];
+        }
+    }
+    if (m_producers_num.load(std::memory_order_relaxed) >= JOB_QUEUE_PRODUCERS_MAX) {
+        return nullptr;
+    }
+    uint32_t idx = m_producers_num.fetch_add(1U, std::memory_order_relaxed);
+    if (idx >= JOB_QUEUE_PRODUCERS_MAX) {
+        return nullptr;
+    }
+
+    m_owners[idx] = std::make_shared<producer>();
+    m_producers[idx].store(m_owners[idx].get(), std::memory_order_release);
+    return m_owners[idx];
+}
+
+template <typename T> typename job_queue<T>::producer *job_queue<T>::get_producer()
+{
+    static thread_local thread_producers s_thread;
+    std::vector<std::shared_ptr<producer>> &rings = s_thread.rings;
+
+    if (likely(m_id < rings.size() && rings[m_id])) {
+        return rings[m_id].get();
+    }
+    std::shared_ptr<producer> p = acquire_producer();
+    if (!p) {
+        return nullptr;
+    }
+    if (m_id >= rings.size()) {
+        rings.resize(m_id + 1U);
+    }
+    rings[m_id] = std::move(p);
+    return rings[m_id].get();
+}
+
+// Can be called from multiple producers.
 template <typename T> void job_queue<T>::insert_job(const T &job)
 {
+    producer *p = get_producer();
+
+    if (likely(p)) {
+        if (likely(!p->overflow_pending.load(std::memory_order_relaxed)) && p->ring.push(job)) {
+            return;
+        }
+        std::lock_guard<decltype(p->overflow_lock)> lock(p->overflow_lock);
+        p->overflow.push_back(job);
+        p->overflow_pending.store(true, std::memory_order_release);
+        return;
+    }
+
     std::lock_guard<decltype(m_queue_lock)> lock(m_queue_lock);
-    m_queue_insert.push_back(job);
+    m_queue_shared.push_back(job);
+    m_shared_pending.store(true, std::memory_order_release);
 }
 
-// Should be called only from a single consumer.
+template <typename T>
+void job_queue<T>::fetch_locked(lock_spin &lock, queue_type &queue, std::atomic<bool> &pending)
+{
+    std::lock_guard<lock_spin> guard(lock);
+    m_queue_fetch.insert(m_queue_fetch.end(), queue.begin(), queue.end());
+    queue.clear();
+    pending.store(false, std::memory_order_relaxed);
+}
+
+// Should be called only from a single consumer. The new jobs are appended to the returned
+// batch, the consumer clears it once processed.
 template <typename T> typename job_queue<T>::queue_type &job_queue<T>::get_all()
 {
-    // Avoid heavy lock activity in case of busy loop and empty queue.
-    std::atomic_thread_fence(std::memory_order::memory_order_acquire);
-    if (m_queue_insert.size() <= 0U) {
-        return m_queue_fetch;
+    uint32_t num =
+        std::min(m_producers_num.load(std::memory_order_acquire), JOB_QUEUE_PRODUCERS_MAX);
+    T job;
+
+    for (uint32_t i = 0; i < num; ++i) {
+        producer *p = m_producers[i].load(std::memory_order_acquire);
+        if (!p) {
+            continue;
+        }
+        while (p->ring.pop(job)) {
+            m_queue_fetch.push_back(job);
+        }
+        // The ring jobs precede the overflow ones, the producer skips the ring while pending
+        if (p->overflow_pending.load(std::memory_order_acquire)) {
+            fetch_locked(p->overflow_lock, p->overflow, p->overflow_pending);
+        }
     }
 
-    std::lock_guard<decltype(m_queue_lock)> lock(m_queue_lock);
-    m_queue_insert.swap(m_queue_fetch);
+    if (m_shared_pending.load(std::memory_order_acquire)) {
+        fetch_locked(m_queue_lock, m_queue_shared, m_shared_pending);
+    }
     return m_queue_fetch;
 }
 
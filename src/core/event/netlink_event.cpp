@@ -63,6 +63,14 @@ const std::string route_nl_event::to_str() const
     return std::string(outstr);
 }
 
+const std::string route_nl_batch_event::to_str() const
+{
+    char outstr[TOSTR_MAX_SIZE];
+
+    sprintf(outstr, "%s. ROUTE BATCH: CHANGES=%zu", event::to_str().c_str(), m_changes.size());
+    return std::string(outstr);
+}
+
 neigh_nl_event::neigh_nl_event(struct nlmsghdr *hdr, struct rtnl_neigh *neigh, void *notifier)
     : netlink_event(hdr, notifier)
     , m_neigh_info(nullptr)
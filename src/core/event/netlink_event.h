@@ -13,6 +13,7 @@
 #include <linux/rtnetlink.h>
 
 #include <string>
+#include <vector>
 
 #include "core/event/event.h"
 #include "core/netlink/neigh_info.h"
@@ -102,6 +103,35 @@ private:
     netlink_route_info *m_route_info;
 };
 
+/*
+ * Route changes received in one read of the netlink channel, in the order of the messages.
+ * The observers get the whole batch in one notification.
+ */
+class route_nl_batch_event : public event {
+public:
+    struct change {
+        uint16_t nl_type;
+        route_val val;
+    };
+
+    route_nl_batch_event(void *notifier)
+        : event(notifier)
+    {
+    }
+
+    virtual ~route_nl_batch_event() {}
+
+    virtual const std::string to_str() const;
+
+    void add(uint16_t nl_type, const route_val &val) { m_changes.push_back({nl_type, val}); }
+    void clear() { m_changes.clear(); }
+    bool empty() const { return m_changes.empty(); }
+    const std::vector<change> &get_changes() const { return m_changes; }
+
+private:
+    std::vector<change> m_changes;
+};
+
 class link_nl_event : public netlink_event {
 public:
     link_nl_event(struct nlmsghdr *hdr, struct rtnl_link *rt_link, void *notifier);
@@ -7,10 +7,12 @@
 #include "config.h"
 #include "poll_group.h"
 
+#include "dev/buffer_pool.h"
 #include "dev/net_device_table_mgr.h"
 #include "dev/net_device_val.h"
 #include "dev/ring.h"
 #include "event/event_handler_manager_local.h"
+#include "sock/sock-redirect.h"
 #include "sock/sockinfo_tcp.h"
 
 #define MODULE_NAME "group:"
@@ -20,6 +22,10 @@
 #define grp_logwarn  __log_warn
 #define grp_loginfo  __log_info
 #define grp_logdbg   __log_dbg
+#define grp_logfunc  __log_func
+
+#define GRP_WAIT_EPFD_EVENT_MAX 16
+#define GRP_WAIT_SPIN_MIN       16
 
 /*
  * Collection of the groups to destroy leftovers in the library destructor.
@@ -34,26 +40,79 @@ poll_group::poll_group(const struct xlio_poll_group_attr &attr)
     , m_socket_comp_cb(attr.socket_comp_cb)
     , m_socket_rx_cb(attr.socket_rx_cb)
     , m_socket_accept_cb(attr.socket_accept_cb)
+    , m_socket_rx_batch_cb(attr.socket_rx_batch_cb)
+    , m_socket_accept_batch_cb(attr.socket_accept_batch_cb)
+    , m_socket_comp_batch_cb(attr.socket_comp_batch_cb)
+    , m_socket_tx_ts_cb(attr.socket_tx_ts_cb)
+    , m_rx_cb_timing(safe_mce_sys().stats_latency_hist)
+    , m_dgram_tx_deferred(safe_mce_sys().enable_mpwqe && safe_mce_sys().mpwqe_max_pkt_size &&
+                          (attr.flags & (XLIO_GROUP_FLAG_DIRTY | XLIO_GROUP_FLAG_SAFE)) ==
+                              XLIO_GROUP_FLAG_DIRTY)
     , m_group_flags(attr.flags)
+    , m_wait_spin(safe_mce_sys().rx_poll_num)
+    , m_accept_pool_size(attr.accept_pool_size)
+    , m_ring_poll_budget(attr.ring_poll_budget)
+    , m_rx_filter_cb(attr.rx_filter_cb)
+    , m_flush_budget(attr.flush_budget)
+    , m_rx_queues(std::max(attr.rx_queues, 1U))
 {
     /*
      * In the best case, we expect a single ring per group. Reserve two elements for a scenario
      * with two network interfaces and when the both interfaces are used by the sockets.
      * More complex scenarios will be covered with re-allocation.
      */
-    m_rings.reserve(2);
+    m_rings.reserve(2U * m_rx_queues);
 
     m_event_handler = std::make_unique<event_handler_manager_local>();
     m_tcp_timers = std::make_unique<tcp_timers_collection>(1U);
     m_tcp_timers->set_group(this);
 
+    memset(&m_stats, 0, sizeof(m_stats));
+    xlio_stats_instance_create_poll_group_block(&m_stats);
+
+    /*
+     * The caches are lock-free and rely on the group serialization. A group with
+     * XLIO_GROUP_FLAG_SAFE allows concurrent TX, so it uses the global pools directly.
+     */
+    size_t cache_size = safe_mce_sys().group_buf_cache_size;
+    if (cache_size && !(m_group_flags & XLIO_GROUP_FLAG_SAFE)) {
+        size_t batch = safe_mce_sys().group_buf_cache_batch;
+        m_rx_buf_cache =
+            std::make_unique<buffer_pool_cache>(g_buffer_pool_rx_rwqe, batch, cache_size);
+        m_tx_buf_cache = std::make_unique<buffer_pool_cache>(g_buffer_pool_tx, batch, cache_size);
+        if (g_buffer_pool_zc) {
+            m_zc_buf_cache =
+                std::make_unique<buffer_pool_cache>(g_buffer_pool_zc, batch, cache_size);
+        }
+    }
+
     s_poll_groups_lock.lock();
     s_poll_groups.push_back(this);
     s_poll_groups_lock.unlock();
 
+    if (safe_mce_sys().ring_precreate_threads && g_p_net_device_table_mgr) {
+        precreate_rings();
+    }
+
     grp_logdbg("Polling group %p created", this);
 }
 
+void poll_group::precreate_rings()
+{
+    // The keys of the sockets of the group, see sockinfo_tcp::set_xlio_socket() and accept_clone()
+    std::vector<resource_allocation_key> keys;
+    for (unsigned i = 0; i < m_rx_queues; ++i) {
+        keys.emplace_back(RING_LOGIC_PER_USER_ID, !!(m_group_flags & XLIO_GROUP_FLAG_SAFE));
+        keys.back().set_user_id_key(reinterpret_cast<uint64_t>(this) + i);
+    }
+
+    for (ring_precreated_t &precreated : g_p_net_device_table_mgr->precreate_rings(keys)) {
+        // The group keeps its own reference
+        add_ring(precreated.p_ring, &precreated.key);
+        precreated.p_ndev->release_ring(&precreated.key);
+    }
+}
+
 /**
  * @brief Destructor for poll_group class
  *
@@ -64,9 +123,12 @@ poll_group::poll_group(const struct xlio_poll_group_attr &attr)
 // coverity[UNCAUGHT_EXCEPT]
 poll_group::~poll_group()
 {
+    // Complete the in-flight migrations, so the sockets are destroyed with the group.
+    process_migrate_inbox();
+
     //destroy all pending to remove sockets
     while (!m_pending_to_remove_lst.empty()) {
-        sockinfo_tcp *si = m_pending_to_remove_lst.front();
+        sockinfo *si = m_pending_to_remove_lst.front();
         m_pending_to_remove_lst.pop_front();
         si->clean_socket_obj();
     }
@@ -78,10 +140,31 @@ poll_group::~poll_group()
     }
     s_poll_groups_lock.unlock();
 
+    // The connections are not reported to the user and are closed with the rest sockets.
+    m_accept_batch.clear();
+    release_accept_pool();
+    for (auto &item : m_conn_pools) {
+        release_conn_pool(item.second, false);
+    }
+    m_conn_pools.clear();
+    ring_tx_doorbells();
+
     while (!m_sockets_list.empty()) {
-        sockinfo_tcp *si = dynamic_cast<sockinfo_tcp *>(m_sockets_list.front());
-        if (likely(si)) {
-            close_socket(si, true);
+        close_socket(m_sockets_list.front(), true);
+    }
+
+    /*
+     * A ring can outlive the group if it's referenced by somebody else. Detach the rings,
+     * so they don't access the group buffer caches after the group is destroyed, and restore
+     * the group settings to the defaults.
+     */
+    for (ring *rng : m_rings) {
+        rng->set_poll_group(nullptr);
+        if (m_ring_poll_budget) {
+            rng->set_rx_poll_budget(0U);
+        }
+        if (m_rx_filter_cb) {
+            rng->set_rx_filter(nullptr);
         }
     }
 
@@ -91,6 +174,13 @@ poll_group::~poll_group()
     }
     m_rings_ref.clear();
 
+    if (m_epfd >= 0) {
+        SYSCALL(close, m_epfd);
+        m_epfd = -1;
+    }
+
+    xlio_stats_instance_remove_poll_group_block(&m_stats);
+
     grp_logdbg("Polling group %p destroyed", this);
 }
 
@@ -115,16 +205,50 @@ void poll_group::fork_nullify()
 
 int poll_group::update(const struct xlio_poll_group_attr *attr)
 {
-    if (m_group_flags != attr->flags) {
-        // Runtime flags change is not supported for now.
+    if (m_group_flags != attr->flags || m_rx_queues != std::max(attr->rx_queues, 1U)) {
+        // Runtime flags and RX queues change is not supported for now.
         errno = EINVAL;
         return -1;
     }
 
+    // Pending batches must be delivered with the callback they were collected for.
+    if (!m_accept_batch.empty()) {
+        flush_accept_batch();
+    }
+    flush_rx_batches();
+    flush_comp_batches();
+
     m_socket_event_cb = attr->socket_event_cb;
     m_socket_comp_cb = attr->socket_comp_cb;
     m_socket_rx_cb = attr->socket_rx_cb;
     m_socket_accept_cb = attr->socket_accept_cb;
+    m_socket_rx_batch_cb = attr->socket_rx_batch_cb;
+    m_socket_accept_batch_cb = attr->socket_accept_batch_cb;
+    m_socket_comp_batch_cb = attr->socket_comp_batch_cb;
+    m_socket_tx_ts_cb = attr->socket_tx_ts_cb;
+
+    if (m_accept_pool_size != attr->accept_pool_size) {
+        m_accept_pool_size = attr->accept_pool_size;
+        // Shrinking is lazy, the pool doesn't grow over the new size.
+        m_accept_pool_refill = true;
+    }
+
+    if (m_ring_poll_budget != attr->ring_poll_budget) {
+        m_ring_poll_budget = attr->ring_poll_budget;
+        for (ring *rng : m_rings) {
+            rng->set_rx_poll_budget(m_ring_poll_budget);
+        }
+    }
+
+    if (m_rx_filter_cb != attr->rx_filter_cb) {
+        m_rx_filter_cb = attr->rx_filter_cb;
+        for (ring *rng : m_rings) {
+            rng->set_rx_filter(m_rx_filter_cb);
+        }
+    }
+
+    // The sockets left over the old budget are flushed by the next poll()
+    m_flush_budget = attr->flush_budget;
 
     return 0;
 }
@@ -135,23 +259,195 @@ bool poll_group::poll()
         slow_path_run();
         m_is_slow_path = false;
     }
+    if (unlikely(m_migrate_inbox.load(std::memory_order_relaxed))) {
+        process_migrate_inbox();
+    }
+    if (unlikely(m_dirty_flush_pending)) {
+        // Continue the flush which was limited by the budget, the doorbells are rung below.
+        defer_tx_doorbells();
+        flush_dirty_sockets(m_dirty_flush_pending);
+    }
+    if (unlikely(m_tx_db_deferred)) {
+        // The user didn't flush the group, don't hold the deferred datagrams any longer.
+        ring_tx_doorbells();
+    }
+
+    /*
+     * Rings are polled round-robin starting from a different ring in each pass. Together with
+     * the per ring CQE budget, a busy ring can't starve the others within a pass.
+     */
+    const size_t rings_nr = m_rings.size();
+    size_t idx = m_ring_poll_next < rings_nr ? m_ring_poll_next : 0U;
+    m_ring_poll_next = idx + 1U;
 
     int empty_poll = -1;
-    for (ring *rng : m_rings) {
+    for (size_t i = 0; i < rings_nr; ++i, ++idx) {
+        ring *rng = m_rings[idx < rings_nr ? idx : idx - rings_nr];
         uint64_t sn = 0;
         empty_poll = std::max(empty_poll, rng->poll_and_process_element_tx(&sn));
         sn = 0;
         empty_poll = std::max(empty_poll, rng->poll_and_process_element_rx(&sn));
     }
+    if (!m_accept_batch.empty()) {
+        flush_accept_batch();
+    }
+    if (!m_rx_batch_sockets.empty() || !m_rx_batch_sockets_high.empty()) {
+        flush_rx_batches();
+    }
     m_event_handler->do_tasks();
+    // After the timers, so the completions found by them are reported in this pass
+    if (!m_comp_batch_sockets.empty()) {
+        flush_comp_batches();
+    }
+    if (unlikely(m_accept_pool_refill)) {
+        refill_accept_pool();
+    }
+    if (unlikely(m_conn_pool_refill)) {
+        refill_conn_pools();
+    }
+
+    ++m_stats.n_poll_iterations;
+    m_stats.n_poll_empty += (empty_poll < 0);
 
     return !!(empty_poll + 1);
 }
 
+int poll_group::wait(int timeout_ms)
+{
+    const int spin_max = safe_mce_sys().rx_poll_num;
+
+    /*
+     * Spin phase. Under load the events arrive within the budget and the group never sleeps.
+     * The budget is doubled on success and halved on an idle phase, so an idle group quickly
+     * reaches the minimal budget and an active group returns to the full busy polling.
+     * rx_poll_num=-1 disables sleeping, the call degrades to busy polling until an event or
+     * the timeout.
+     */
+    const bool spin_deadline = spin_max < 0 && timeout_ms >= 0;
+    tscval_t deadline = 0;
+    if (spin_deadline) {
+        gettimeoftsc(&deadline);
+        deadline += get_tsc_rate_per_second() * static_cast<tscval_t>(timeout_ms) / 1000U;
+    }
+    for (int i = 0; spin_max < 0 || i < m_wait_spin; ++i) {
+        if (poll()) {
+            m_wait_spin = std::min(std::max(m_wait_spin, GRP_WAIT_SPIN_MIN / 2) * 2, spin_max);
+            return 1;
+        }
+        if (spin_deadline) {
+            tscval_t now;
+            gettimeoftsc(&now);
+            if (now >= deadline) {
+                // The whole timeout is spent, the blocking path has nothing left to wait
+                timeout_ms = 0;
+                break;
+            }
+        }
+    }
+    m_wait_spin = std::max(m_wait_spin / 2, std::min(GRP_WAIT_SPIN_MIN, spin_max));
+
+    if (timeout_ms == 0) {
+        return 0;
+    }
+
+    if (unlikely(m_epfd < 0)) {
+        m_epfd = SYSCALL(epoll_create, 128);
+        if (m_epfd < 0) {
+            grp_logerr("Failed to create epoll fd for group %p (errno=%d)", this, errno);
+            return -1;
+        }
+        for (ring *rng : m_rings) {
+            add_ring_to_epfd(rng);
+        }
+        if (m_wakeup_fd >= 0) {
+            epoll_event ev = {EPOLLIN, {nullptr}};
+            ev.data.fd = m_wakeup_fd;
+            if (unlikely(SYSCALL(epoll_ctl, m_epfd, EPOLL_CTL_ADD, m_wakeup_fd, &ev))) {
+                grp_logerr("Failed to add wakeup fd to group epfd (errno=%d)", errno);
+            }
+        }
+    }
+
+    if (!arm_rings()) {
+        // Completions arrived after the last poll, don't go to sleep.
+        poll();
+        return 1;
+    }
+
+    // TCP timers are driven by the polling, so limit the sleep by the timer resolution.
+    int sleep_ms = timeout_ms;
+    if (has_sockets()) {
+        int timer_ms = static_cast<int>(safe_mce_sys().tcp_timer_resolution_msec);
+        sleep_ms = (sleep_ms < 0) ? timer_ms : std::min(sleep_ms, timer_ms);
+    }
+
+    epoll_event events[GRP_WAIT_EPFD_EVENT_MAX];
+    int ret = SYSCALL(epoll_wait, m_epfd, events, GRP_WAIT_EPFD_EVENT_MAX, sleep_ms);
+    if (ret < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < ret; ++i) {
+        if (events[i].data.fd == m_wakeup_fd) {
+            uint64_t val;
+            // Non blocking, the value only wakes up the sleep
+            if (SYSCALL(read, m_wakeup_fd, &val, sizeof(val)) < 0 && errno != EAGAIN) {
+                grp_logdbg("Failed to read the wakeup fd (errno=%d)", errno);
+            }
+            continue;
+        }
+        cq_channel_info *p_cq_ch_info = g_p_fd_collection->get_cq_channel_fd(events[i].data.fd);
+        if (p_cq_ch_info) {
+            ring *p_ring = p_cq_ch_info->get_ring();
+            if (p_ring) {
+                uint64_t poll_sn = 0;
+                p_ring->wait_for_notification_and_process_element(&poll_sn);
+            }
+        }
+    }
+    grp_logfunc("Group %p woke up with %d events", this, ret);
+
+    // Single polling pass delivers the batches, runs the timers and drains the rest.
+    bool progress = poll();
+
+    return (ret > 0 || progress) ? 1 : 0;
+}
+
+bool poll_group::arm_rings()
+{
+    for (ring *rng : m_rings) {
+        uint64_t sn = 0;
+        if (rng->poll_and_process_element_rx(&sn) >= 0) {
+            return false;
+        }
+        // Non-zero return value means that there are new completions since the poll.
+        if (rng->request_notification(CQT_RX, sn) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void poll_group::add_ring_to_epfd(ring *rng)
+{
+    epoll_event ev = {0, {nullptr}};
+    ev.events = EPOLLIN;
+    size_t num_ring_rx_fds;
+    int *ring_rx_fds_array = rng->get_rx_channel_fds(num_ring_rx_fds);
+
+    for (size_t i = 0; i < num_ring_rx_fds; i++) {
+        ev.data.fd = ring_rx_fds_array[i];
+        if (unlikely(SYSCALL(epoll_ctl, m_epfd, EPOLL_CTL_ADD, ev.data.fd, &ev))) {
+            grp_logerr("Failed to add cq channel fd to group epfd (errno=%d)", errno);
+        }
+    }
+}
+
 void poll_group::slow_path_run()
 {
+    ++m_stats.n_slow_path_runs;
     for (auto &iter : m_slow_path_sockets) {
-        sockinfo_tcp *si = iter.second;
+        sockinfo *si = iter.second;
 
         switch (iter.first) {
         case POLL_GROUP_SOCKET_CLOSE:
@@ -168,20 +464,430 @@ void poll_group::slow_path_run()
     m_slow_path_sockets.clear();
 }
 
+void poll_group::migrate_socket(sockinfo_tcp *si)
+{
+    m_migrate_lock.lock();
+    si->set_migrate_next(m_migrate_inbox.load(std::memory_order_relaxed));
+    si->set_migrate_group(this);
+    m_migrate_inbox.store(si, std::memory_order_release);
+    m_migrate_lock.unlock();
+}
+
+void poll_group::cancel_migrate(sockinfo_tcp *si)
+{
+    m_migrate_lock.lock();
+    if (si->get_migrate_group() == this) {
+        sockinfo_tcp *prev = m_migrate_inbox.load(std::memory_order_relaxed);
+
+        if (prev == si) {
+            m_migrate_inbox.store(si->get_migrate_next(), std::memory_order_relaxed);
+        } else {
+            while (prev->get_migrate_next() != si) {
+                prev = prev->get_migrate_next();
+            }
+            prev->set_migrate_next(si->get_migrate_next());
+        }
+        si->set_migrate_next(nullptr);
+        si->set_migrate_group(nullptr);
+    }
+    m_migrate_lock.unlock();
+}
+
+void poll_group::process_migrate_inbox()
+{
+    sockinfo_tcp *fifo = nullptr;
+
+    /*
+     * Restore the submission order. The sockets taken out of the inbox can't be cancelled
+     * anymore, the user must not destroy them until the migration event.
+     */
+    m_migrate_lock.lock();
+    sockinfo_tcp *list = m_migrate_inbox.exchange(nullptr, std::memory_order_acquire);
+    while (list) {
+        sockinfo_tcp *next = list->get_migrate_next();
+        list->set_migrate_next(fifo);
+        list->set_migrate_group(nullptr);
+        fifo = list;
+        list = next;
+    }
+    m_migrate_lock.unlock();
+
+    while (fifo) {
+        sockinfo_tcp *si = fifo;
+        fifo = si->get_migrate_next();
+        si->set_migrate_next(nullptr);
+
+        int rc = si->attach_xlio_group(this);
+        grp_logdbg("Socket %p migrated to group %p (rc=%d)", si, this, rc);
+        if (rc == 0) {
+            si->xlio_socket_event(XLIO_SOCKET_EVENT_MIGRATED, 0);
+        } else {
+            // The failed socket is left detached, report the error through this group.
+            m_socket_event_cb(reinterpret_cast<xlio_socket_t>(si), si->get_xlio_socket_userdata(),
+                              XLIO_SOCKET_EVENT_ERROR, errno);
+        }
+    }
+}
+
+void poll_group::deliver_rx_batch(sockinfo *si)
+{
+    std::vector<xlio_rx_batch_entry> batch;
+    tscval_t start = 0;
+    tscval_t end = 0;
+
+    /*
+     * The callback can detach or migrate the socket, remove_socket() must see an empty batch
+     * then, otherwise, the buffers are delivered and freed twice.
+     */
+    batch.swap(si->get_xlio_rx_batch());
+    if (unlikely(m_rx_cb_timing)) {
+        gettimeoftsc(&start);
+    }
+    m_socket_rx_batch_cb(reinterpret_cast<xlio_socket_t>(si), si->get_xlio_socket_userdata(),
+                         batch.data(), static_cast<unsigned>(batch.size()));
+    if (unlikely(m_rx_cb_timing)) {
+        gettimeoftsc(&end);
+        m_stats.n_rx_cb_tsc += end - start;
+    }
+    batch.clear();
+    // Give the capacity back to the socket unless a new batch was queued meanwhile
+    if (si->get_xlio_rx_batch().empty()) {
+        si->get_xlio_rx_batch().swap(batch);
+    }
+}
+
+void poll_group::flush_rx_batch_list(std::vector<sockinfo *> &sockets)
+{
+    /*
+     * The callback can destroy a socket, however, the destruction is postponed to the slow path.
+     * A socket which is removed from the group within the callback is replaced with nullptr.
+     */
+    for (size_t i = 0; i < sockets.size(); ++i) {
+        if (sockets[i]) {
+            deliver_rx_batch(sockets[i]);
+        }
+    }
+    sockets.clear();
+}
+
+void poll_group::flush_rx_batches()
+{
+    // The data of the high priority sockets doesn't wait for the bulk callbacks
+    flush_rx_batch_list(m_rx_batch_sockets_high);
+    flush_rx_batch_list(m_rx_batch_sockets);
+}
+
+void poll_group::deliver_comp_batch(sockinfo *si)
+{
+    std::vector<uintptr_t> batch;
+
+    // Same as for the RX batch, the callback can remove the socket from the group
+    batch.swap(si->get_xlio_comp_batch());
+    m_socket_comp_batch_cb(reinterpret_cast<xlio_socket_t>(si), si->get_xlio_socket_userdata(),
+                           batch.data(), static_cast<unsigned>(batch.size()));
+    batch.clear();
+    if (si->get_xlio_comp_batch().empty()) {
+        si->get_xlio_comp_batch().swap(batch);
+    }
+}
+
+void poll_group::flush_comp_batches()
+{
+    // A send within the callback can complete, the socket is appended and reported in this pass
+    for (size_t i = 0; i < m_comp_batch_sockets.size(); ++i) {
+        if (m_comp_batch_sockets[i]) {
+            deliver_comp_batch(m_comp_batch_sockets[i]);
+        }
+    }
+    m_comp_batch_sockets.clear();
+}
+
+void poll_group::flush_accept_batch()
+{
+    // The callback doesn't accept new connections, so the batch can't grow in the meantime.
+    m_socket_accept_batch_cb(reinterpret_cast<xlio_poll_group_t>(this), m_accept_batch.data(),
+                             static_cast<unsigned>(m_accept_batch.size()));
+    m_accept_batch.clear();
+}
+
+sockinfo_tcp *poll_group::get_accept_socket(sa_family_t family)
+{
+    std::vector<sockinfo_tcp *> &pool = m_accept_pool[family == AF_INET6];
+
+    if (pool.empty()) {
+        m_accept_pool_refill = !!m_accept_pool_size;
+        return nullptr;
+    }
+    sockinfo_tcp *si = pool.back();
+    pool.pop_back();
+    m_accept_pool_refill = true;
+    return si;
+}
+
+void poll_group::reserve_accept_sockets(sa_family_t family)
+{
+    m_accept_pool_active[family == AF_INET6] = true;
+    m_accept_pool_refill = !!m_accept_pool_size;
+}
+
+void poll_group::refill_accept_pool()
+{
+    m_accept_pool_refill = false;
+
+    for (int i = 0; i < 2; ++i) {
+        std::vector<sockinfo_tcp *> &pool = m_accept_pool[i];
+        int family = i ? AF_INET6 : AF_INET;
+
+        while (m_accept_pool_active[i] && pool.size() < m_accept_pool_size) {
+            int fd = socket_internal(family, SOCK_STREAM, 0, false, false);
+            if (fd < 0) {
+                grp_logdbg("Failed to pre-construct accept socket (errno=%d)", errno);
+                return;
+            }
+            sockinfo_tcp *si = dynamic_cast<sockinfo_tcp *>(fd_collection_get_sockfd(fd));
+            if (!si) {
+                XLIO_CALL(close, fd);
+                return;
+            }
+            pool.push_back(si);
+        }
+    }
+}
+
+void poll_group::release_accept_pool()
+{
+    for (auto &pool : m_accept_pool) {
+        for (sockinfo_tcp *si : pool) {
+            XLIO_CALL(close, si->get_fd());
+        }
+        pool.clear();
+    }
+}
+
+void poll_group::set_conn_pool(const sock_addr &dst, unsigned size)
+{
+    if (!size) {
+        auto iter = m_conn_pools.find(dst);
+        if (iter != std::end(m_conn_pools)) {
+            release_conn_pool(iter->second, true);
+            m_conn_pools.erase(iter);
+        }
+        return;
+    }
+
+    poll_group_conn_pool &pool = m_conn_pools[dst];
+    pool.size = size;
+    pool.retry_tsc = 0U;
+    while (pool.ready.size() > size) {
+        conn_pool_discard(pool.ready.front());
+    }
+    refill_conn_pool(dst, pool);
+}
+
+sockinfo_tcp *poll_group::get_pooled_connection(const sock_addr &dst, uintptr_t userdata_sq)
+{
+    auto iter = m_conn_pools.find(dst);
+    if (iter == std::end(m_conn_pools)) {
+        errno = ENOENT;
+        return nullptr;
+    }
+
+    poll_group_conn_pool &pool = iter->second;
+    if (pool.ready.empty()) {
+        ++m_stats.n_conn_pool_misses;
+        errno = EAGAIN;
+        return nullptr;
+    }
+    sockinfo_tcp *si = pool.ready.back();
+    pool.ready.pop_back();
+    si->set_conn_pool(nullptr, CONN_POOL_NONE);
+    si->update_xlio_socket(0, userdata_sq);
+    ++m_stats.n_conn_pool_hits;
+    // The replacement is connected from the polling context.
+    m_conn_pool_refill = true;
+    return si;
+}
+
+void poll_group::conn_pool_event(sockinfo_tcp *si, int event)
+{
+    poll_group_conn_pool *pool = si->get_conn_pool();
+
+    if (si->get_conn_pool_state() == CONN_POOL_CLOSING) {
+        return;
+    }
+    if (event == XLIO_SOCKET_EVENT_ESTABLISHED &&
+        si->get_conn_pool_state() == CONN_POOL_CONNECTING) {
+        tscval_t now;
+
+        gettimeoftsc(&now);
+        pool->connecting.erase(std::find(pool->connecting.begin(), pool->connecting.end(), si));
+        pool->ready.push_back(si);
+        si->set_conn_pool(pool, CONN_POOL_READY);
+        ++m_stats.n_conn_pool_warmups;
+        m_stats.n_conn_pool_warmup_tsc += now - si->get_conn_pool_start_tsc();
+    } else if (event == XLIO_SOCKET_EVENT_ERROR || event == XLIO_SOCKET_EVENT_CLOSED) {
+        if (si->get_conn_pool_state() == CONN_POOL_CONNECTING) {
+            // Don't hammer an unreachable destination, retry after a pause.
+            gettimeoftsc(&pool->retry_tsc);
+            pool->retry_tsc += get_tsc_rate_per_second() / 10U;
+        }
+        conn_pool_discard(si);
+    }
+}
+
+void poll_group::conn_pool_discard(sockinfo_tcp *si)
+{
+    poll_group_conn_pool *pool = si->get_conn_pool();
+    std::vector<sockinfo_tcp *> *list = nullptr;
+
+    if (si->get_conn_pool_state() == CONN_POOL_CONNECTING) {
+        list = &pool->connecting;
+    } else if (si->get_conn_pool_state() == CONN_POOL_READY) {
+        list = &pool->ready;
+    } else {
+        return;
+    }
+    list->erase(std::find(list->begin(), list->end(), si));
+    si->set_conn_pool(nullptr, CONN_POOL_CLOSING);
+    mark_socket_to_close(si);
+    m_conn_pool_refill = true;
+}
+
+void poll_group::refill_conn_pools()
+{
+    tscval_t now;
+
+    gettimeoftsc(&now);
+    m_conn_pool_refill = false;
+    for (auto &item : m_conn_pools) {
+        poll_group_conn_pool &pool = item.second;
+
+        if (pool.connecting.size() + pool.ready.size() >= pool.size) {
+            continue;
+        }
+        if (now < pool.retry_tsc) {
+            m_conn_pool_refill = true;
+            continue;
+        }
+        refill_conn_pool(item.first, pool);
+    }
+}
+
+void poll_group::refill_conn_pool(const sock_addr &dst, poll_group_conn_pool &pool)
+{
+    sa_family_t family = dst.get_sa_family();
+
+    while (pool.connecting.size() + pool.ready.size() < pool.size) {
+        int errno_save = errno;
+        int fd = SYSCALL(socket, family, SOCK_STREAM, 0);
+        if (fd < 0) {
+            grp_logdbg("Failed to create pooled socket (errno=%d)", errno);
+            errno = errno_save;
+            m_conn_pool_refill = true;
+            return;
+        }
+
+        struct xlio_socket_attr attr = {
+            .flags = 0U,
+            .domain = family,
+            .group = reinterpret_cast<xlio_poll_group_t>(this),
+            .userdata_sq = 0U,
+        };
+        sockinfo_tcp *si = new sockinfo_tcp(fd, family);
+        si->set_xlio_socket(&attr);
+        add_socket(si);
+        si->set_conn_pool(&pool, CONN_POOL_CONNECTING);
+        pool.connecting.push_back(si);
+
+        int rc = si->connect(dst.get_p_sa(), dst.get_socklen());
+        bool failed = si->isPassthrough() ||
+            (rc == -1 && errno != EINPROGRESS && errno != EAGAIN);
+        errno = errno_save;
+        if (failed) {
+            grp_logdbg("Failed to connect pooled socket to %s", dst.to_str_ip_port(true).c_str());
+            gettimeoftsc(&pool.retry_tsc);
+            pool.retry_tsc += get_tsc_rate_per_second() / 10U;
+            // The connect() may have reported an error event and discarded the socket.
+            conn_pool_discard(si);
+            return;
+        }
+    }
+}
+
+void poll_group::release_conn_pool(poll_group_conn_pool &pool, bool close)
+{
+    for (auto *list : {&pool.connecting, &pool.ready}) {
+        for (sockinfo_tcp *si : *list) {
+            si->set_conn_pool(nullptr, CONN_POOL_CLOSING);
+            if (close) {
+                mark_socket_to_close(si);
+            }
+        }
+        list->clear();
+    }
+}
+
 void poll_group::add_dirty_socket(sockinfo_tcp *si)
 {
     if (m_group_flags & XLIO_GROUP_FLAG_DIRTY) {
-        m_dirty_sockets.push_back(si);
+        (si->is_xlio_socket_high_prio() ? m_dirty_sockets_high : m_dirty_sockets).push_back(si);
     }
 }
 
+/*
+ * Flushes the first nr normal priority sockets within the budget. The rest of the nr sockets
+ * stay at the front of the list for the next pass.
+ */
+void poll_group::flush_dirty_sockets(size_t nr)
+{
+    size_t budget = (m_flush_budget && m_flush_budget < nr) ? m_flush_budget : nr;
+    for (size_t i = 0; i < budget; ++i) {
+        m_dirty_sockets[i]->flush();
+    }
+    m_stats.n_dirty_flushes += budget;
+    m_dirty_sockets.erase(m_dirty_sockets.begin(), m_dirty_sockets.begin() + budget);
+    m_dirty_flush_pending = nr - budget;
+}
+
 void poll_group::flush()
 {
-    for (auto si : m_dirty_sockets) {
+    if (m_dirty_sockets.empty() && m_dirty_sockets_high.empty() && !m_tx_db_deferred &&
+        m_comp_batch_sockets.empty()) {
+        return;
+    }
+
+    // Defer the doorbells, so each ring is notified once with a single completion request.
+    defer_tx_doorbells();
+    for (auto si : m_dirty_sockets_high) {
         si->flush();
     }
-    m_dirty_sockets.clear();
-    // TODO Ring doorbell and request TX completion.
+    m_stats.n_dirty_flushes += m_dirty_sockets_high.size();
+    m_dirty_sockets_high.clear();
+    flush_dirty_sockets(m_dirty_sockets.size());
+    ring_tx_doorbells();
+    if (!m_comp_batch_sockets.empty()) {
+        flush_comp_batches();
+    }
+}
+
+void poll_group::defer_tx_doorbells()
+{
+    if (!m_tx_db_deferred) {
+        for (ring *rng : m_rings) {
+            rng->tx_doorbell_batch_begin();
+        }
+        m_tx_db_deferred = true;
+    }
+}
+
+void poll_group::ring_tx_doorbells()
+{
+    if (m_tx_db_deferred) {
+        for (ring *rng : m_rings) {
+            rng->tx_doorbell_batch_end();
+        }
+        m_tx_db_deferred = false;
+    }
 }
 
 void poll_group::add_ring(ring *rng, ring_alloc_logic_attr *attr)
@@ -190,6 +896,18 @@ void poll_group::add_ring(ring *rng, ring_alloc_logic_attr *attr)
         grp_logdbg("New ring %p in group %p", rng, this);
         m_rings.push_back(rng);
         rng->set_poll_group(this);
+        if (m_ring_poll_budget) {
+            rng->set_rx_poll_budget(m_ring_poll_budget);
+        }
+        if (m_rx_filter_cb) {
+            rng->set_rx_filter(m_rx_filter_cb);
+        }
+        if (m_tx_db_deferred) {
+            rng->tx_doorbell_batch_begin();
+        }
+        if (m_epfd >= 0) {
+            add_ring_to_epfd(rng);
+        }
 
         /*
          * Take reference to the ring. This avoids a race between socket destruction and buffer
@@ -214,42 +932,70 @@ void poll_group::add_ring(ring *rng, ring_alloc_logic_attr *attr)
     }
 }
 
-void poll_group::add_socket_helper(sockinfo_tcp *si)
+void poll_group::add_socket_helper(sockinfo *si)
 {
     m_sockets_list.push_back(si);
+    m_stats.n_sockets = static_cast<uint32_t>(m_sockets_list.size());
 }
 
-void poll_group::add_socket(sockinfo_tcp *si)
+void poll_group::add_socket(sockinfo *si)
 {
     add_socket_helper(si);
     // For the flow_tag fast path support.
     g_p_fd_collection->set_socket(si->get_fd(), si);
 }
 
-void poll_group::remove_socket(sockinfo_tcp *si)
+void poll_group::remove_socket(sockinfo *si)
 {
     m_sockets_list.erase(si);
+    m_stats.n_sockets = static_cast<uint32_t>(m_sockets_list.size());
+    if (!si->get_xlio_rx_batch().empty()) {
+        // The priority could change after the socket was queued
+        for (auto *sockets : {&m_rx_batch_sockets, &m_rx_batch_sockets_high}) {
+            auto iter = std::find(sockets->begin(), sockets->end(), si);
+            if (iter != std::end(*sockets)) {
+                *iter = nullptr;
+            }
+        }
+        // Deliver the pending buffers, otherwise, they are lost for the user.
+        deliver_rx_batch(si);
+    }
+    if (!si->get_xlio_comp_batch().empty()) {
+        auto iter = std::find(m_comp_batch_sockets.begin(), m_comp_batch_sockets.end(), si);
+        if (iter != std::end(m_comp_batch_sockets)) {
+            *iter = nullptr;
+        }
+        deliver_comp_batch(si);
+    }
     auto iter = std::find(m_dirty_sockets.begin(), m_dirty_sockets.end(), si);
     if (iter != std::end(m_dirty_sockets)) {
+        if (static_cast<size_t>(iter - m_dirty_sockets.begin()) < m_dirty_flush_pending) {
+            --m_dirty_flush_pending;
+        }
         m_dirty_sockets.erase(iter);
     }
+    iter = std::find(m_dirty_sockets_high.begin(), m_dirty_sockets_high.end(), si);
+    if (iter != std::end(m_dirty_sockets_high)) {
+        m_dirty_sockets_high.erase(iter);
+    }
 }
 
-void poll_group::reuse_sockfd(int fd, sockinfo_tcp *si)
+void poll_group::reuse_sockfd(int fd, sockinfo *si)
 {
     m_pending_to_remove_lst.remove(si);
     g_p_fd_collection->set_socket(fd, si);
     m_sockets_list.push_back(si);
+    m_stats.n_sockets = static_cast<uint32_t>(m_sockets_list.size());
 }
 
-void poll_group::close_socket(sockinfo_tcp *si, bool force /*=false*/)
+void poll_group::close_socket(sockinfo *si, bool force /*=false*/)
 {
     int fd = si->get_fd();
     close_socket_helper(si, force);
     g_p_fd_collection->clear_socket(fd);
 }
 
-void poll_group::close_socket_helper(sockinfo_tcp *si, bool force /*=false*/)
+void poll_group::close_socket_helper(sockinfo *si, bool force /*=false*/)
 {
     remove_socket(si);
     if (si->prepare_to_close(force)) {
@@ -261,13 +1007,13 @@ void poll_group::close_socket_helper(sockinfo_tcp *si, bool force /*=false*/)
     }
 }
 
-void poll_group::mark_socket_to_close(sockinfo_tcp *si)
+void poll_group::mark_socket_to_close(sockinfo *si)
 {
     m_slow_path_sockets.push_back(std::make_pair(POLL_GROUP_SOCKET_CLOSE, si));
     m_is_slow_path = true;
 }
 
-void poll_group::mark_socket_to_destroy(sockinfo_tcp *si)
+void poll_group::mark_socket_to_destroy(sockinfo *si)
 {
     m_slow_path_sockets.push_back(std::make_pair(POLL_GROUP_SOCKET_DESTROY, si));
     m_is_slow_path = true;
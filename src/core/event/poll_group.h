@@ -7,20 +7,34 @@
 #ifndef XLIO_GROUP_H
 #define XLIO_GROUP_H
 
+#include <atomic>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "sock/fd_collection.h"
+#include "util/xlio_stats.h"
 #include "xlio.h"
 
 /* Forward declarations */
 struct xlio_poll_group_attr;
+class buffer_pool_cache;
 class event_handler_manager_local;
 class ring;
 class ring_alloc_logic_attr;
+class sockinfo;
 class sockinfo_tcp;
 class tcp_timers_collection;
 
+// Connections to a destination established ahead, see xlio_poll_group_connect_pool()
+struct poll_group_conn_pool {
+    unsigned size = 0U;
+    // No new connection attempt until then after a failure, 0 if none
+    tscval_t retry_tsc = 0U;
+    std::vector<sockinfo_tcp *> connecting;
+    std::vector<sockinfo_tcp *> ready;
+};
+
 enum poll_group_socket_op {
     POLL_GROUP_SOCKET_INVALID = 0,
     POLL_GROUP_SOCKET_CLOSE,
@@ -37,44 +51,222 @@ public:
     int update(const struct xlio_poll_group_attr *attr);
 
     bool poll();
+    int wait(int timeout_ms);
 
     void add_dirty_socket(sockinfo_tcp *si);
     void flush();
+    // Keep the TX doorbells of the rings deferred until the next flush() or poll().
+    void defer_tx_doorbells();
+
+    void add_rx_batch(sockinfo *si, void *data, size_t len, struct xlio_buf *buf)
+    {
+        std::vector<xlio_rx_batch_entry> &batch = si->get_xlio_rx_batch();
+        if (batch.empty()) {
+            (si->is_xlio_socket_high_prio() ? m_rx_batch_sockets_high : m_rx_batch_sockets)
+                .push_back(si);
+        }
+        batch.push_back({data, len, buf});
+        ++m_stats.n_rx_pkts;
+    }
+
+    void rx_cb(sockinfo *si, uintptr_t userdata, void *data, size_t len, struct xlio_buf *buf)
+    {
+        ++m_stats.n_rx_pkts;
+        if (likely(!m_rx_cb_timing)) {
+            m_socket_rx_cb(reinterpret_cast<xlio_socket_t>(si), userdata, data, len, buf);
+            return;
+        }
+
+        tscval_t start;
+        tscval_t end;
+
+        gettimeoftsc(&start);
+        m_socket_rx_cb(reinterpret_cast<xlio_socket_t>(si), userdata, data, len, buf);
+        gettimeoftsc(&end);
+        m_stats.n_rx_cb_tsc += end - start;
+    }
+
+    bool has_comp_cb() const { return m_socket_comp_cb || m_socket_comp_batch_cb; }
+
+    void comp_cb(sockinfo *si, uintptr_t userdata_op)
+    {
+        if (m_socket_comp_batch_cb && !(m_group_flags & XLIO_GROUP_FLAG_SAFE)) {
+            std::vector<uintptr_t> &batch = si->get_xlio_comp_batch();
+            if (batch.empty()) {
+                m_comp_batch_sockets.push_back(si);
+            }
+            batch.push_back(userdata_op);
+        } else if (m_socket_comp_batch_cb) {
+            m_socket_comp_batch_cb(reinterpret_cast<xlio_socket_t>(si),
+                                   si->get_xlio_socket_userdata(), &userdata_op, 1U);
+        } else if (m_socket_comp_cb) {
+            m_socket_comp_cb(reinterpret_cast<xlio_socket_t>(si), si->get_xlio_socket_userdata(),
+                             userdata_op);
+        }
+    }
+
+    void tx_ts_cb(sockinfo *si, uintptr_t userdata_op, const struct timespec &hw_timestamp)
+    {
+        if (m_socket_tx_ts_cb) {
+            m_socket_tx_ts_cb(reinterpret_cast<xlio_socket_t>(si), si->get_xlio_socket_userdata(),
+                              userdata_op, &hw_timestamp);
+        }
+    }
+
+    void add_accept_batch(sockinfo *si, sockinfo *parent)
+    {
+        m_accept_batch.push_back({reinterpret_cast<xlio_socket_t>(si),
+                                  reinterpret_cast<xlio_socket_t>(parent),
+                                  parent->get_xlio_socket_userdata()});
+    }
+    bool has_pending_accepts() const { return !m_accept_batch.empty(); }
+    void flush_accept_batch();
+
+    // Returns a pre-constructed socket or nullptr if the accept pool is empty.
+    sockinfo_tcp *get_accept_socket(sa_family_t family);
+    void reserve_accept_sockets(sa_family_t family);
+
+    // Zero size releases the pool of the destination.
+    void set_conn_pool(const sock_addr &dst, unsigned size);
+    // Returns an established connection or nullptr with errno set.
+    sockinfo_tcp *get_pooled_connection(const sock_addr &dst, uintptr_t userdata_sq);
+    // The events of the connections not handed out yet are consumed by the pool.
+    void conn_pool_event(sockinfo_tcp *si, int event);
+    void conn_pool_discard(sockinfo_tcp *si);
+
+    // Not atomic, the counter can be approximate for XLIO_GROUP_FLAG_SAFE with concurrent TX.
+    void count_tx_op() { ++m_stats.n_tx_ops; }
 
     void add_ring(ring *rng, ring_alloc_logic_attr *attr);
 
-    void add_socket(sockinfo_tcp *si);
-    void add_socket_helper(sockinfo_tcp *si);
-    void remove_socket(sockinfo_tcp *si);
-    void reuse_sockfd(int fd, sockinfo_tcp *si);
-    void close_socket(sockinfo_tcp *si, bool force = false);
-    void close_socket_helper(sockinfo_tcp *si, bool force = false);
-    void mark_socket_to_close(sockinfo_tcp *si);
-    void mark_socket_to_destroy(sockinfo_tcp *si);
+    unsigned get_rx_queues() const { return m_rx_queues; }
+    /*
+     * Ring user ID key of the next accepted connection, the queues are taken round-robin.
+     * Queue 0 is the key of the other sockets of the group, queue n is the group address plus n,
+     * which is unique while n is within the group object. Approximate for XLIO_GROUP_FLAG_SAFE.
+     */
+    uint64_t next_rx_queue_key()
+    {
+        uint64_t queue = m_rx_queue_next++ % m_rx_queues;
+        return reinterpret_cast<uint64_t>(this) + queue;
+    }
+
+    // Thread safe, can be called from the context of any group.
+    void migrate_socket(sockinfo_tcp *si);
+    // Thread safe, drops the socket from the inbox if the group hasn't taken it yet.
+    void cancel_migrate(sockinfo_tcp *si);
+
+    void add_socket(sockinfo *si);
+    void add_socket_helper(sockinfo *si);
+    void remove_socket(sockinfo *si);
+    void reuse_sockfd(int fd, sockinfo *si);
+    void close_socket(sockinfo *si, bool force = false);
+    void close_socket_helper(sockinfo *si, bool force = false);
+    void mark_socket_to_close(sockinfo *si);
+    void mark_socket_to_destroy(sockinfo *si);
     unsigned get_flags() const { return m_group_flags; }
+    // Datagrams sent without the flush flag wait for flush() to be packed into MPWQEs
+    bool defers_dgram_tx() const { return m_dgram_tx_deferred; }
+    // Extra fd of wait(), written by the other threads to interrupt the sleep
+    void set_wakeup_fd(int fd) { m_wakeup_fd = fd; }
+    // Sockets including the ones closing, they need the polling for the TCP timers
+    bool has_sockets() const { return !m_sockets_list.empty() || !m_pending_to_remove_lst.empty(); }
     event_handler_manager_local *get_event_handler() const { return m_event_handler.get(); }
     tcp_timers_collection *get_tcp_timers() const { return m_tcp_timers.get(); }
+    // Buffer caches are nullptr if disabled, rings fall back to the global pools then.
+    buffer_pool_cache *get_rx_buf_cache() const { return m_rx_buf_cache.get(); }
+    buffer_pool_cache *get_tx_buf_cache(pbuf_type type) const
+    {
+        return type == PBUF_ZEROCOPY ? m_zc_buf_cache.get() : m_tx_buf_cache.get();
+    }
 
 private:
     void slow_path_run();
+    void process_migrate_inbox();
+    bool arm_rings();
+    void ring_tx_doorbells();
+    void flush_dirty_sockets(size_t nr);
+    void add_ring_to_epfd(ring *rng);
+    void precreate_rings();
+    void flush_rx_batches();
+    void flush_rx_batch_list(std::vector<sockinfo *> &sockets);
+    void deliver_rx_batch(sockinfo *si);
+    void flush_comp_batches();
+    void deliver_comp_batch(sockinfo *si);
+    void refill_accept_pool();
+    void release_accept_pool();
+    void refill_conn_pools();
+    void refill_conn_pool(const sock_addr &dst, poll_group_conn_pool &pool);
+    void release_conn_pool(poll_group_conn_pool &pool, bool close);
 
 public:
     xlio_socket_event_cb_t m_socket_event_cb;
     xlio_socket_comp_cb_t m_socket_comp_cb;
     xlio_socket_rx_cb_t m_socket_rx_cb;
     xlio_socket_accept_cb_t m_socket_accept_cb;
+    xlio_socket_rx_batch_cb_t m_socket_rx_batch_cb;
+    xlio_socket_accept_batch_cb_t m_socket_accept_batch_cb;
+    xlio_socket_comp_batch_cb_t m_socket_comp_batch_cb;
+    xlio_socket_tx_ts_cb_t m_socket_tx_ts_cb;
 
 private:
     bool m_is_slow_path = false;
+    // The time of the RX callbacks is measured with monitor.stats.latency_hist only
+    bool m_rx_cb_timing;
+    bool m_dgram_tx_deferred;
     unsigned m_group_flags;
+    // Adaptive busy polling budget of wait() before going to sleep
+    int m_wait_spin;
+    // Lazily created epoll fd with the CQ channel fds of the rings for wait()
+    int m_epfd = -1;
+    int m_wakeup_fd = -1;
+    unsigned m_accept_pool_size;
+    bool m_accept_pool_refill = false;
+    // Address families of the listen sockets, only these pools are refilled
+    bool m_accept_pool_active[2] = {false, false};
+    // A connection pool misses connections, checked by poll()
+    bool m_conn_pool_refill = false;
+    // Per ring RX CQE budget of a single polling pass, zero is the default budget
+    unsigned m_ring_poll_budget;
+    // Installed in the rings, sees the packets before the steering
+    xlio_rx_filter_cb_t m_rx_filter_cb;
+    // Index of the ring which is polled first in the next pass
+    size_t m_ring_poll_next = 0U;
+    bool m_tx_db_deferred = false;
+    // Normal priority sockets flushed per pass, zero is unlimited
+    unsigned m_flush_budget;
+    // Sockets at the front of m_dirty_sockets which a flush left over the budget
+    size_t m_dirty_flush_pending = 0U;
+    // Rings per device for the accepted connections, at least 1
+    unsigned m_rx_queues;
+    unsigned m_rx_queue_next = 0U;
 
     std::vector<ring *> m_rings;
     std::unique_ptr<event_handler_manager_local> m_event_handler;
     std::unique_ptr<tcp_timers_collection> m_tcp_timers;
+    // Group private caches in front of the global buffer pools
+    std::unique_ptr<buffer_pool_cache> m_rx_buf_cache;
+    std::unique_ptr<buffer_pool_cache> m_tx_buf_cache;
+    std::unique_ptr<buffer_pool_cache> m_zc_buf_cache;
 
     std::vector<sockinfo_tcp *> m_dirty_sockets;
-    std::vector<std::pair<enum poll_group_socket_op, sockinfo_tcp *>> m_slow_path_sockets;
-    std::list<sockinfo_tcp *> m_pending_to_remove_lst;
+    std::vector<sockinfo_tcp *> m_dirty_sockets_high;
+    // Stack of the sockets migrating to this group, the poll checks it without the lock
+    std::atomic<sockinfo_tcp *> m_migrate_inbox {nullptr};
+    lock_spin m_migrate_lock;
+    poll_group_stats_t m_stats;
+    // Pre-constructed sockets for the incoming connections per address family (IPv4, IPv6)
+    std::vector<sockinfo_tcp *> m_accept_pool[2];
+    std::unordered_map<sock_addr, poll_group_conn_pool> m_conn_pools;
+    // Connections established within the current poll iteration
+    std::vector<xlio_accept_batch_entry> m_accept_batch;
+    // Sockets with non-empty RX batch within the current poll iteration
+    std::vector<sockinfo *> m_rx_batch_sockets;
+    std::vector<sockinfo *> m_rx_batch_sockets_high;
+    // Sockets with completed send operations not reported yet
+    std::vector<sockinfo *> m_comp_batch_sockets;
+    std::vector<std::pair<enum poll_group_socket_op, sockinfo *>> m_slow_path_sockets;
+    std::list<sockinfo *> m_pending_to_remove_lst;
     sockinfo_list_t m_sockets_list;
     std::vector<std::pair<std::unique_ptr<ring_alloc_logic_attr>, net_device_val *>> m_rings_ref;
 };
@@ -0,0 +1,265 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+
+#define TIMER_WHEEL_LEVELS    4U
+#define TIMER_WHEEL_SLOT_BITS 6U
+#define TIMER_WHEEL_SLOTS     (1U << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1U)
+/* Longer delays are kept at the top level and placed again once they get there */
+#define TIMER_WHEEL_MAX_DELAY ((1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1U)
+
+/* Slot ids of a node, zero stands for a node out of the wheel (as allocated by calloc) */
+#define TIMER_WHEEL_SLOT_NONE    0U
+#define TIMER_WHEEL_SLOT_EXPIRED (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1U)
+
+/**
+ * Hierarchical timing wheel with a millisecond tick.
+ *
+ * Level L has TIMER_WHEEL_SLOTS slots of 64^L ticks each, a node is linked to the slot of its
+ * expiry at the lowest level which covers the delay. Insert and removal are O(1), when the
+ * lower level wraps the next slot of the upper level is spread over the lower levels.
+ * The expired nodes are collected in a list the owner drains in one batch.
+ *
+ * T is an intrusive node with the fields:
+ *     uint64_t expiry_msec;
+ *     uint16_t wheel_slot;
+ *     T *next;
+ *     T *prev;
+ * Not thread safe.
+ */
+template <typename T> class timer_wheel {
+public:
+    void add(T *node, uint64_t delay_msec)
+    {
+        node->expiry_msec = m_now + std::min<uint64_t>(delay_msec, TIMER_WHEEL_MAX_DELAY);
+        place(node);
+        ++m_count;
+    }
+
+    void remove(T *node)
+    {
+        if (node->wheel_slot != TIMER_WHEEL_SLOT_NONE) {
+            unlink(node);
+            --m_count;
+        }
+    }
+
+    // Move the time forward, the nodes which expire on the way move to the expired list
+    void advance(uint64_t elapsed_msec)
+    {
+        uint64_t target = m_now + elapsed_msec;
+
+        while (m_now < target) {
+            if (m_count == m_expired_num) {
+                m_now = target;
+                break;
+            }
+            if (!m_bitmap[0]) {
+                // Nothing can expire before the next wrap of the lowest level
+                m_now = std::min(target, m_now | TIMER_WHEEL_SLOT_MASK);
+                if (m_now == target) {
+                    break;
+                }
+            }
+            ++m_now;
+            for (unsigned level = 1U; level < TIMER_WHEEL_LEVELS; ++level) {
+                if (m_now & ((1ULL << (level * TIMER_WHEEL_SLOT_BITS)) - 1U)) {
+                    break;
+                }
+                cascade(level);
+            }
+            cascade(0U);
+        }
+    }
+
+    // Milliseconds until the next expiry or cascade, 0 if expired nodes wait, -1 if empty
+    int64_t next_timeout() const
+    {
+        if (m_expired_num) {
+            return 0;
+        }
+        if (!m_count) {
+            return -1;
+        }
+
+        uint64_t best = UINT64_MAX;
+        for (unsigned level = 0U; level < TIMER_WHEEL_LEVELS; ++level) {
+            if (!m_bitmap[level]) {
+                continue;
+            }
+            unsigned shift = level * TIMER_WHEEL_SLOT_BITS;
+            // The first tick at which a slot of this level is processed
+            uint64_t boundary = ((m_now >> shift) + 1U) << shift;
+            unsigned base = (boundary >> shift) & TIMER_WHEEL_SLOT_MASK;
+            uint64_t dist = (uint64_t)first_slot(m_bitmap[level], base) << shift;
+            best = std::min(best, boundary - m_now + dist);
+        }
+        return (int64_t)best;
+    }
+
+    bool has_expired() const { return m_expired_num != 0; }
+    size_t expired_num() const { return m_expired_num; }
+    size_t size() const { return m_count; }
+    bool empty() const { return !m_count; }
+    uint64_t now() const { return m_now; }
+
+    // Unlink the oldest expired node, nullptr if there is none
+    T *pop_expired()
+    {
+        T *node = m_expired_head;
+        if (node) {
+            unlink(node);
+            --m_count;
+        }
+        return node;
+    }
+
+    // Call f for each node, f may remove the node it is called for, but not another one
+    template <typename F> void for_each(F f)
+    {
+        for_each_in(m_expired_head, f);
+        for (unsigned level = 0U; level < TIMER_WHEEL_LEVELS; ++level) {
+            for (unsigned idx = 0U; idx < TIMER_WHEEL_SLOTS; ++idx) {
+                for_each_in(m_slots[level][idx], f);
+            }
+        }
+    }
+
+    template <typename P> T *find_if(P pred)
+    {
+        T *found = nullptr;
+        for_each([&](T *node) {
+            if (!found && pred(node)) {
+                found = node;
+            }
+        });
+        return found;
+    }
+
+private:
+    static unsigned first_slot(uint64_t bitmap, unsigned base)
+    {
+        // Distance from base to the first set bit in the circular order
+        uint64_t rotated = base ? (bitmap >> base) | (bitmap << (TIMER_WHEEL_SLOTS - base)) : bitmap;
+        return (unsigned)__builtin_ctzll(rotated);
+    }
+
+    template <typename F> static void for_each_in(T *node, F &f)
+    {
+        while (node) {
+            T *next = node->next;
+            f(node);
+            node = next;
+        }
+    }
+
+    void place(T *node)
+    {
+        if (node->expiry_msec <= m_now) {
+            link_expired(node);
+            return;
+        }
+
+        uint64_t delta = std::min<uint64_t>(node->expiry_msec - m_now, TIMER_WHEEL_MAX_DELAY);
+        uint64_t expiry = m_now + delta;
+        unsigned level = 0U;
+        while (delta >> ((level + 1U) * TIMER_WHEEL_SLOT_BITS)) {
+            ++level;
+        }
+        unsigned idx = (expiry >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+
+        T *&head = m_slots[level][idx];
+        node->prev = nullptr;
+        node->next = head;
+        if (head) {
+            head->prev = node;
+        }
+        head = node;
+        node->wheel_slot = (uint16_t)(level * TIMER_WHEEL_SLOTS + idx + 1U);
+        m_bitmap[level] |= 1ULL << idx;
+    }
+
+    void link_expired(T *node)
+    {
+        // FIFO order, a node expired earlier runs first
+        node->next = nullptr;
+        node->prev = m_expired_tail;
+        if (m_expired_tail) {
+            m_expired_tail->next = node;
+        } else {
+            m_expired_head = node;
+        }
+        m_expired_tail = node;
+        node->wheel_slot = TIMER_WHEEL_SLOT_EXPIRED;
+        ++m_expired_num;
+    }
+
+    void unlink(T *node)
+    {
+        if (node->wheel_slot == TIMER_WHEEL_SLOT_EXPIRED) {
+            if (node->prev) {
+                node->prev->next = node->next;
+            } else {
+                m_expired_head = node->next;
+            }
+            if (node->next) {
+                node->next->prev = node->prev;
+            } else {
+                m_expired_tail = node->prev;
+            }
+            --m_expired_num;
+        } else {
+            unsigned slot = node->wheel_slot - 1U;
+            unsigned level = slot / TIMER_WHEEL_SLOTS;
+            unsigned idx = slot % TIMER_WHEEL_SLOTS;
+            if (node->prev) {
+                node->prev->next = node->next;
+            } else {
+                m_slots[level][idx] = node->next;
+                if (!node->next) {
+                    m_bitmap[level] &= ~(1ULL << idx);
+                }
+            }
+            if (node->next) {
+                node->next->prev = node->prev;
+            }
+        }
+        node->next = node->prev = nullptr;
+        node->wheel_slot = TIMER_WHEEL_SLOT_NONE;
+    }
+
+    // Place again the nodes of the current slot of the level, at level 0 they expire
+    void cascade(unsigned level)
+    {
+        unsigned idx = (m_now >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+        T *node = m_slots[level][idx];
+
+        m_slots[level][idx] = nullptr;
+        m_bitmap[level] &= ~(1ULL << idx);
+        while (node) {
+            T *next = node->next;
+            place(node);
+            node = next;
+        }
+    }
+
+    T *m_slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS] = {};
+    uint64_t m_bitmap[TIMER_WHEEL_LEVELS] = {};
+    T *m_expired_head = nullptr;
+    T *m_expired_tail = nullptr;
+    size_t m_expired_num = 0U;
+    size_t m_count = 0U;
+    uint64_t m_now = 0U;
+};
+
+#endif /* TIMER_WHEEL_H */
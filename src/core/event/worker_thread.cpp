@@ -65,10 +65,21 @@ void worker_thread::start_thread(entity_context *ctx)
 void worker_thread::stop_thread()
 {
     m_running.store(false);
+    m_entity_ctx->wake_up();
     m_thread.join();
     wt_logdbg("Worker Thread terminated (tid: %d, entctx: %p)", gettid(), m_entity_ctx);
 }
 
+int worker_thread::set_affinity(const cpu_set_t &cpuset)
+{
+    int rc = pthread_setaffinity_np(m_thread.native_handle(), sizeof(cpuset), &cpuset);
+    if (rc) {
+        wt_logwarn("Failed to set the affinity of the worker thread (entctx: %p, rc: %d)",
+                   m_entity_ctx, rc);
+    }
+    return rc;
+}
+
 void worker_thread::worker_thread_loop()
 {
     m_running.store(true);
@@ -44,6 +44,7 @@ class worker_thread {
 public:
     void start_thread(entity_context *ctx);
     void stop_thread();
+    int set_affinity(const cpu_set_t &cpuset);
 
 private:
     static void worker_thread_main(worker_thread &t, entity_context *ctx);
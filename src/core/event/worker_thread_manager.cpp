@@ -87,6 +87,27 @@ worker_thread_manager::worker_thread_manager()
     std::for_each(
         m_worker_threads.get(), m_worker_threads.get() + threads_num,
         [&next_ctx, &all_ctxs](worker_thread &t) { t.start_thread(all_ctxs[next_ctx++]); });
+
+    // Every worker thread takes the next core of the set
+    const cpu_set_t &affinity = safe_mce_sys().worker_affinity;
+    int cpus = CPU_COUNT(&affinity);
+    for (size_t i = 0, cpu = 0; cpus > 0 && i < threads_num; ++i, ++cpu) {
+        while (!CPU_ISSET(cpu % CPU_SETSIZE, &affinity)) {
+            ++cpu;
+        }
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu % CPU_SETSIZE, &cpuset);
+        m_worker_threads[i].set_affinity(cpuset);
+    }
+}
+
+int worker_thread_manager::set_affinity(size_t index, const cpu_set_t &cpuset)
+{
+    if (index >= safe_mce_sys().worker_threads || !CPU_COUNT(&cpuset)) {
+        return EINVAL;
+    }
+    return m_worker_threads[index].set_affinity(cpuset);
 }
 
 // coverity[UNCAUGHT_EXCEPT]
@@ -36,6 +36,7 @@
 #define WORKER_THREAD_MANAGER_H
 
 #include <memory>
+#include <sched.h>
 
 class worker_thread;
 
@@ -49,6 +50,9 @@ public:
     static void destroy();
     static void fork_nullify();
 
+    // Returns 0 or an errno value.
+    int set_affinity(size_t index, const cpu_set_t &cpuset);
+
 private:
     static worker_thread_manager *s_p_worker_thread_manager;
 
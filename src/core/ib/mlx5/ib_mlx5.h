@@ -54,6 +54,7 @@ typedef struct xlio_ib_mlx5_qp {
     } sq;
     struct {
         void *reg;
+        uint32_t size; // Size of a BlueFlame buffer, zero if the UAR has no BlueFlame
     } bf;
     uint32_t tisn;
     uint32_t sqn;
@@ -184,6 +185,19 @@ typedef struct xlio_mlx5_cqe {
     uint8_t op_own;
 } xlio_mlx5_cqe;
 
+/* CQE format value of a compressed CQE (title of a mini CQE session). */
+#define XLIO_MLX5_CQE_FORMAT_COMPRESSED 0x3
+
+/* Number of mini CQEs in a single 64 bytes CQE slot. */
+#define XLIO_MLX5_MINI_CQE_ARRAY_SIZE 8U
+
+/* Mini CQE in the checksum result format. */
+typedef struct xlio_mlx5_mini_cqe8 {
+    __be16 csum;
+    __be16 stride_idx;
+    __be32 byte_cnt;
+} xlio_mlx5_mini_cqe8;
+
 /* WQE segments structures */
 
 typedef struct xlio_mlx5_wqe_ctrl_seg {
@@ -429,6 +443,7 @@ enum {
     XLIO_MLX5_OPCODE_GET_PSV = 0x21,
     XLIO_MLX5_OPCODE_DUMP = 0x23,
     XLIO_MLX5_OPCODE_UMR = 0x25,
+    XLIO_MLX5_OPCODE_ENHANCED_MPSW = 0x29,
 };
 
 /*
@@ -437,6 +452,7 @@ enum {
 #define XLIO_MLX5_PARAMS_LRO_PAYLOAD_SIZE       (64U * 1024U)
 #define XLIO_MLX5_PARAMS_LRO_TIMEOUT            32
 #define XLIO_MLX5_PARAMS_LRO_TIMEOUT_ARRAY_SIZE 4
+#define XLIO_MLX5_PARAMS_MPWQE_MAX_PKTS         32U
 
 /*
  * Interfaces
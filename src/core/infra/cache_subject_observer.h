@@ -7,9 +7,11 @@
 #ifndef CACHE_SUBJECT_OBSERVER_H
 #define CACHE_SUBJECT_OBSERVER_H
 
+#include <atomic>
 #include <mutex>
 #include <stdio.h>
 #include <unordered_map>
+#include <vector>
 #include "vlogger/vlogger.h"
 #include "utils/lock_wrapper.h"
 #include "core/util/to_str.h"
@@ -81,14 +83,24 @@ protected:
 
 private:
     const Key m_key;
+    // Removed from the table, the lockless lookups must not register to it anymore
+    std::atomic<bool> m_retired {false};
 
     cache_entry_subject(const cache_entry_subject<Key, Val> &); // block copy constructor
 };
 
+/*
+ * The observers register to the existing entries without m_lock. The lookup is done in an
+ * immutable snapshot of m_cache_tbl, which is republished by every insert and removal.
+ * The replaced snapshots and the removed entries are reclaimed by the writers once there
+ * is no lockless reader, so a reader can use whatever it found for the whole lookup.
+ * The subclasses which modify m_cache_tbl under m_lock must call publish_snapshot().
+ */
 template <typename Key, typename Val> class cache_table_mgr : public tostr, public timer_handler {
 public:
     cache_table_mgr(const char *lock_name = "lock(cache_table_mgr)")
         : m_lock(lock_name)
+        , m_snapshot(new cache_tbl_t())
         , m_timer_handle(nullptr) {};
     virtual ~cache_table_mgr();
 
@@ -101,12 +113,17 @@ public:
     int get_cache_tbl_size() { return m_cache_tbl.size(); };
 
 protected:
-    std::unordered_map<Key, cache_entry_subject<Key, Val> *> m_cache_tbl;
+    typedef std::unordered_map<Key, cache_entry_subject<Key, Val> *> cache_tbl_t;
+
+    cache_tbl_t m_cache_tbl;
 
     lock_mutex_recursive m_lock;
 
     virtual cache_entry_subject<Key, Val> *create_new_entry(Key, const observer *) = 0;
 
+    // Called under m_lock after m_cache_tbl is modified
+    void publish_snapshot();
+
     // This function removes cache entries that are obsolete or number of observers is 0 + entry is
     // deletable
     virtual void run_garbage_collector();
@@ -117,8 +134,17 @@ protected:
 private:
     cache_table_mgr(const cache_table_mgr<Key, Val> &); // block copy constructor
 
-    void try_to_remove_cache_entry(
+    bool try_to_remove_cache_entry(
         IN typename std::unordered_map<Key, cache_entry_subject<Key, Val> *>::iterator &);
+    bool register_observer_lockless(IN const Key &, IN const cache_observer *,
+                                    OUT cache_entry_subject<Key, Val> **);
+    void reclaim_retired();
+
+    std::atomic<const cache_tbl_t *> m_snapshot;
+    std::atomic<unsigned> m_readers {0U}; // Lockless lookups in progress
+    // Waiting for the readers which may still use them, protected by m_lock
+    std::vector<const cache_tbl_t *> m_retired_snapshots;
+    std::vector<cache_entry_subject<Key, Val> *> m_retired_entries;
     void *m_timer_handle;
 };
 
@@ -152,34 +178,87 @@ template <typename Key, typename Val> int cache_entry_subject<Key, Val>::get_obs
 template <typename Key, typename Val> cache_table_mgr<Key, Val>::~cache_table_mgr()
 {
     print_tbl();
+
+    // There are no readers anymore
+    for (cache_entry_subject<Key, Val> *cache_entry : m_retired_entries) {
+        cache_entry->clean_obj();
+    }
+    for (const cache_tbl_t *snapshot : m_retired_snapshots) {
+        delete snapshot;
+    }
+    delete m_snapshot.load();
 }
 
 // This function should be called under lock
+template <typename Key, typename Val> void cache_table_mgr<Key, Val>::publish_snapshot()
+{
+    m_retired_snapshots.push_back(m_snapshot.exchange(new cache_tbl_t(m_cache_tbl)));
+    reclaim_retired();
+}
+
+/*
+ * This function should be called under lock. A reader enters before it loads the snapshot,
+ * so once there is no reader after the publication, nobody can reach the retired objects.
+ */
+template <typename Key, typename Val> void cache_table_mgr<Key, Val>::reclaim_retired()
+{
+    if (m_readers.load()) {
+        // Retried by the next insert, removal or garbage collection
+        return;
+    }
+    for (cache_entry_subject<Key, Val> *cache_entry : m_retired_entries) {
+        cache_entry->clean_obj();
+    }
+    m_retired_entries.clear();
+    for (const cache_tbl_t *snapshot : m_retired_snapshots) {
+        delete snapshot;
+    }
+    m_retired_snapshots.clear();
+}
+
+// This function should be called under lock, returns true if the entry is removed
 template <typename Key, typename Val>
-void cache_table_mgr<Key, Val>::try_to_remove_cache_entry(
+bool cache_table_mgr<Key, Val>::try_to_remove_cache_entry(
     IN typename std::unordered_map<Key, cache_entry_subject<Key, Val> *>::iterator &itr)
 {
     cache_entry_subject<Key, Val> *cache_entry = itr->second;
     Key key = itr->first;
     if (!cache_entry->get_observers_count() && cache_entry->is_deletable()) {
+        // Pairs with the fence of register_observer_lockless(): either the reader sees the
+        // entry retired or the entry sees the observer of the reader.
+        cache_entry->m_retired.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (cache_entry->get_observers_count()) {
+            cache_entry->m_retired.store(false);
+            __log_dbg("Cache_entry %s got an observer", cache_entry->to_str().c_str());
+            return false;
+        }
         __log_dbg("Deleting cache_entry %s", cache_entry->to_str().c_str());
         m_cache_tbl.erase(key);
-        cache_entry->clean_obj();
+        m_retired_entries.push_back(cache_entry);
+        return true;
     } else {
         __log_dbg("Cache_entry %s is not deletable", itr->second->to_str().c_str());
     }
+    return false;
 }
 
 template <typename Key, typename Val> void cache_table_mgr<Key, Val>::run_garbage_collector()
 {
     __log_dbg("");
     std::lock_guard<decltype(m_lock)> lock(m_lock);
+    bool removed = false;
     for (auto cache_itr = m_cache_tbl.begin(); cache_itr != m_cache_tbl.end();) {
         auto cache_itr_tmp = cache_itr;
         ++cache_itr_tmp;
-        try_to_remove_cache_entry(cache_itr);
+        removed |= try_to_remove_cache_entry(cache_itr);
         cache_itr = cache_itr_tmp;
     }
+    if (removed) {
+        publish_snapshot();
+    } else {
+        reclaim_retired();
+    }
 }
 
 template <typename Key, typename Val>
@@ -219,6 +298,10 @@ bool cache_table_mgr<Key, Val>::register_observer(IN const Key &key,
         return false;
     }
 
+    if (register_observer_lockless(key, new_observer, cache_entry)) {
+        return true;
+    }
+
     cache_entry_subject<Key, Val> *my_cache_entry;
 
     std::lock_guard<decltype(m_lock)> lock(m_lock);
@@ -231,6 +314,7 @@ bool cache_table_mgr<Key, Val>::register_observer(IN const Key &key,
             return false;
         }
         m_cache_tbl[key] = my_cache_entry;
+        publish_snapshot();
         __log_dbg("Created new cache_entry Key = %s", to_string_val(key).c_str());
     } else {
         my_cache_entry = m_cache_tbl[key];
@@ -241,6 +325,34 @@ bool cache_table_mgr<Key, Val>::register_observer(IN const Key &key,
     return true;
 }
 
+// The fast path of register_observer() for an existing entry, doesn't take m_lock
+template <typename Key, typename Val>
+bool cache_table_mgr<Key, Val>::register_observer_lockless(
+    IN const Key &key, IN const cache_observer *new_observer,
+    OUT cache_entry_subject<Key, Val> **cache_entry)
+{
+    bool registered = false;
+
+    m_readers.fetch_add(1U);
+    const cache_tbl_t *snapshot = m_snapshot.load();
+    auto cache_itr = snapshot->find(key);
+    if (cache_itr != snapshot->end()) {
+        cache_entry_subject<Key, Val> *my_cache_entry = cache_itr->second;
+
+        my_cache_entry->register_observer(new_observer);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (likely(!my_cache_entry->m_retired.load())) {
+            *cache_entry = my_cache_entry;
+            registered = true;
+        } else {
+            // The entry is being removed, the locked path finds or creates the current one
+            my_cache_entry->unregister_observer(new_observer);
+        }
+    }
+    m_readers.fetch_sub(1U);
+    return registered;
+}
+
 template <typename Key, typename Val>
 bool cache_table_mgr<Key, Val>::unregister_observer(IN Key key,
                                                     IN const cache_observer *old_observer)
@@ -264,7 +376,9 @@ bool cache_table_mgr<Key, Val>::unregister_observer(IN Key key,
     cache_itr->second->unregister_observer(old_observer);
 
     // If number of observers == 0 and cache_entry is deletable need to delete this entry
-    try_to_remove_cache_entry(cache_itr);
+    if (try_to_remove_cache_entry(cache_itr)) {
+        publish_snapshot();
+    }
     return true;
 }
 
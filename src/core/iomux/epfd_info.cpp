@@ -7,6 +7,7 @@
 #include <sock/fd_collection.h>
 #include <iomux/epfd_info.h>
 #include "event/entity_context.h"
+#include "dev/pacing_wheel.h"
 
 #define MODULE_NAME "epfd_info:"
 
@@ -64,7 +65,9 @@ epfd_info::epfd_info(int epfd, int size)
     wakeup_set_epoll_fd(m_epfd);
 
     if (safe_mce_sys().is_threads_mode()) {
-        m_entity_context_events.resize(safe_mce_sys().worker_threads);
+        m_n_entity_context_events = safe_mce_sys().worker_threads;
+        m_entity_context_events.reset(
+            new epfd_info_entity_context_events[m_n_entity_context_events]);
     }
 }
 
@@ -129,6 +132,10 @@ int epfd_info::ctl(int op, int fd, epoll_event *event)
         event = &event_dummy;
     }
 
+    if (op == EPOLL_CTL_MOD && (event->events & EPOLLONESHOT) && rearm_fd(fd, event)) {
+        return 0;
+    }
+
     // YossiE TODO make "event table" - and add index in that table instead
     // of real event (in SYSCALL(epoll_ctl)). must have this because fd's can
     // be added after the cq.
@@ -294,6 +301,8 @@ int epfd_info::add_fd(int fd, epoll_event *event)
     } else {
         fd_rec.offloaded_index = -1;
         m_fd_non_offloaded_map[fd] = fd_rec;
+        // The close of the fd must remove it from this set
+        g_p_fd_collection->set_xlio_fd(fd);
     }
 
     __log_func("fd %d added in epfd %d with events=%#x and data=%#x", fd, m_epfd, event->events,
@@ -372,8 +381,9 @@ void epfd_info::decrease_ring_ref_count(ring *ring)
 
 bool epfd_info::move_entity_context_ready_events()
 {
-    std::for_each(begin(m_entity_context_events), end(m_entity_context_events),
-                  [this](auto &itr) { itr.move_epoll_ready_events(m_ready_fds); });
+    for (size_t i = 0; i < m_n_entity_context_events; ++i) {
+        m_entity_context_events[i].move_epoll_ready_events(m_ready_fds);
+    }
     return !m_ready_fds.empty();
 }
 
@@ -546,6 +556,43 @@ int epfd_info::mod_fd(int fd, epoll_event *event)
     return 0;
 }
 
+/*
+ * Re-arm of an EPOLLONESHOT offloaded socket, which thread pool servers do after every request.
+ * The socket isn't in the OS epoll set, so only the registered event mask changes. The epfd lock
+ * is taken only to insert a socket which is ready already.
+ * A stale entry of the socket in the ready list is harmless: a level triggered socket is checked
+ * again by epoll_wait() and an edge triggered one is removed when its oneshot event is reported.
+ * Returns false if the socket needs mod_fd().
+ */
+bool epfd_info::rearm_fd(int fd, epoll_event *event)
+{
+    sockinfo *sock = fd_collection_get_sockfd(fd);
+
+    if (!sock || sock->get_type() != FD_TYPE_SOCKET || sock->get_epoll_context() != this ||
+        !sock->skip_os_select() || sock->get_entity_context() ||
+        (event->events & ~SUPPORTED_EPOLL_EVENTS)) {
+        return false;
+    }
+
+    // epoll_wait() reads the data after it sees the events
+    __atomic_store_n(&sock->m_fd_rec.epdata.u64, event->data.u64, __ATOMIC_RELAXED);
+    __atomic_store_n(&sock->m_fd_rec.events, event->events, __ATOMIC_RELEASE);
+
+    uint32_t events = 0;
+    if ((event->events & EPOLLIN) && sock->is_readable(nullptr, nullptr)) {
+        events |= EPOLLIN;
+    }
+    if ((event->events & EPOLLOUT) && sock->is_writeable()) {
+        events |= EPOLLOUT;
+    }
+    if (events) {
+        insert_epoll_event_cb(sock, events);
+    }
+
+    __log_func("fd %d re-armed in epfd %d with events=%#x", fd, m_epfd, event->events);
+    return true;
+}
+
 epoll_fd_rec *epfd_info::get_fd_rec(int fd)
 {
     epoll_fd_rec *fd_rec = nullptr;
@@ -580,8 +627,14 @@ void epfd_info::insert_epoll_event_cb(sockinfo *sock_fd, uint32_t event_flags)
         // EPOLLHUP | EPOLLERR are reported without user request
         if (event_flags & (sock_fd->m_fd_rec.events | EPOLLHUP | EPOLLERR)) {
             size_t vecindex =
-                sock_fd->get_entity_context()->get_index() % m_entity_context_events.size();
-            m_entity_context_events[vecindex].add_epoll_ready_socket(event_flags, sock_fd);
+                sock_fd->get_entity_context()->get_index() % m_n_entity_context_events;
+            if (m_entity_context_events[vecindex].add_epoll_ready_socket(event_flags, sock_fd)) {
+                // Pairs with the fence of an application thread going to sleep, see _wait()
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (is_sleeping()) {
+                    do_wakeup();
+                }
+            }
         }
         return;
     }
@@ -594,7 +647,36 @@ void epfd_info::insert_epoll_event_cb(sockinfo *sock_fd, uint32_t event_flags)
     unlock();
 }
 
+// Inserts the events of several sockets of this epoll set under one lock with one wakeup.
+// Sockets of an entity context aren't batched, they are reported by insert_epoll_event_cb().
+void epfd_info::insert_epoll_events_cb(const std::pair<epfd_info *, sockinfo *> *events,
+                                       size_t count, uint32_t event_flags)
+{
+    bool inserted = false;
+
+    lock();
+    for (size_t i = 0; i < count; ++i) {
+        sockinfo *sock_fd = events[i].second;
+        // EPOLLHUP | EPOLLERR are reported without user request
+        if (event_flags & (sock_fd->m_fd_rec.events | EPOLLHUP | EPOLLERR)) {
+            add_ready_fd(sock_fd, event_flags);
+            inserted = true;
+        }
+    }
+    if (inserted) {
+        do_wakeup();
+    }
+    unlock();
+}
+
 void epfd_info::insert_epoll_event(sockinfo *sock_fd, uint32_t event_flags)
+{
+    // assumed lock
+    add_ready_fd(sock_fd, event_flags);
+    do_wakeup();
+}
+
+void epfd_info::add_ready_fd(sockinfo *sock_fd, uint32_t event_flags)
 {
     // assumed lock
     if (sock_fd->ep_ready_fd_node.is_list_member()) {
@@ -603,8 +685,6 @@ void epfd_info::insert_epoll_event(sockinfo *sock_fd, uint32_t event_flags)
         sock_fd->set_epoll_event_flags(event_flags);
         m_ready_fds.push_back(sock_fd);
     }
-
-    do_wakeup();
 }
 
 void epfd_info::remove_epoll_event(sockinfo *sock_fd, uint32_t event_flags)
@@ -618,14 +698,14 @@ void epfd_info::remove_epoll_event(sockinfo *sock_fd, uint32_t event_flags)
 void epfd_info::remove_socket_from_ready_list(sockinfo *sk)
 {
     if (sk) {
-        remove_epoll_event(sk, sk->get_epoll_event_flags());
-        __log_dbg("Removing fd=%d from epoll=%d ready_fds", sk->get_fd(), get_epoll_fd());
-
+        // The queued events of a worker are moved first, the ring must not keep the socket
         if (sk->get_entity_context()) {
-            size_t vecindex =
-                sk->get_entity_context()->get_index() % m_entity_context_events.size();
-            m_entity_context_events[vecindex].remove_epoll_ready_socket(sk);
+            size_t vecindex = sk->get_entity_context()->get_index() % m_n_entity_context_events;
+            m_entity_context_events[vecindex].remove_epoll_ready_socket(sk, m_ready_fds);
         }
+
+        remove_epoll_event(sk, sk->get_epoll_event_flags());
+        __log_dbg("Removing fd=%d from epoll=%d ready_fds", sk->get_fd(), get_epoll_fd());
     }
 }
 
@@ -644,16 +724,26 @@ bool epfd_info::ring_poll_and_process_element(uint64_t *p_poll_sn_rx, uint64_t *
         return true;
     }
 
-    m_ring_map_lock.lock();
+    // One thread polls the rings of the epfd at a time. The others find the events it inserts
+    // into the ready list instead of polling the same rings again.
+    if (m_ring_map_lock.trylock()) {
+        return true;
+    }
 
     int all_drained = 1;
     for (ring_map_t::iterator iter = m_ring_map.begin(); iter != m_ring_map.end(); iter++) {
-        // Poll RX based on type
+        // Poll RX based on type, skip the rings which have nothing to process
         if (poll_type == epoll_poll_type_t::POLL_RX_ONLY ||
             poll_type == epoll_poll_type_t::POLL_BOTH) {
-            all_drained = std::min(all_drained,
-                                   std::abs(iter->first->poll_and_process_element_rx(
-                                       p_poll_sn_rx, pv_fd_ready_array)));
+            if (iter->first->has_rx_work()) {
+                all_drained = std::min(all_drained,
+                                       std::abs(iter->first->poll_and_process_element_rx(
+                                           p_poll_sn_rx, pv_fd_ready_array)));
+            } else {
+                // The ring poll runs the pacing wheel as well
+                g_pacing_wheel.process();
+                ++m_stats->stats.n_iomux_rx_poll_skipped;
+            }
         }
 
         // Poll TX based on type
@@ -826,43 +916,61 @@ void epfd_info::statistics_print(vlog_levels_t log_level /* = VLOG_DEBUG */)
     }
 }
 
-void epfd_info_entity_context_events::add_epoll_ready_socket(uint64_t events, sockinfo *si)
+// Called only by the worker thread of the entity context of the socket
+bool epfd_info_entity_context_events::add_epoll_ready_socket(uint32_t events, sockinfo *si)
 {
-    std::lock_guard<decltype(m_epoll_ready_sockets_lock)> lock(m_epoll_ready_sockets_lock);
+    // The socket is queued already, the consumer takes the new events with the queued ones
+    if (si->add_epoll_event_flags_thread(events)) {
+        return false;
+    }
 
-    si->set_epoll_event_flags_thread(si->get_epoll_event_flags_thread() | events);
-    m_epoll_ready_sockets.push_back_if_absent(si);
-    __log_dbg("Adding (threads mode) event %" PRIu64 " (fd=%d)", events, si->get_fd());
+    __log_dbg("Adding (threads mode) event %u (fd=%d)", events, si->get_fd());
+    if (unlikely(!m_ready_ring.push(si))) {
+        std::lock_guard<decltype(m_overflow_lock)> lock(m_overflow_lock);
+        m_overflow_sockets.push_back_if_absent(si);
+        m_has_overflow.store(true, std::memory_order_release);
+    }
+    return true;
+}
 
-    // For interrupt mode need to consider moderation and wakeup the epoll context.
+// Called under the epfd lock
+void epfd_info_entity_context_events::remove_epoll_ready_socket(sockinfo *si,
+                                                                ep_ready_fd_list_t &out)
+{
+    // The ring can't drop a socket from its middle. Moving all the queued sockets leaves no
+    // pointer to the removed one, the caller then removes it from the ready list.
+    move_epoll_ready_events(out);
+    __log_dbg("Removing fd=%d from epoll thread_ready_fds", si->get_fd());
+    si->set_epoll_event_flags_thread(0);
 }
 
-void epfd_info_entity_context_events::remove_epoll_ready_socket(sockinfo *si)
+static inline void move_epoll_ready_socket(sockinfo *si, ep_ready_fd_list_t &out)
 {
-    std::lock_guard<decltype(m_epoll_ready_sockets_lock)> lock(m_epoll_ready_sockets_lock);
+    uint32_t events = si->take_epoll_event_flags_thread();
 
-    if (m_epoll_ready_sockets.is_member(si)) {
-        __log_dbg("Removing fd=%d from epoll thread_ready_fds", si->get_fd());
-        si->set_epoll_event_flags_thread(0);
-        m_epoll_ready_sockets.erase(si);
+    // A socket queued twice, the first dequeue took the events
+    if (events) {
+        si->set_epoll_event_flags(si->get_epoll_event_flags() | events);
+        if (!out.is_member(si)) {
+            out.push_back(si);
+        }
     }
 }
 
+// Called under the epfd lock
 void epfd_info_entity_context_events::move_epoll_ready_events(ep_ready_fd_list_t &out)
 {
-    if (m_epoll_ready_sockets.empty()) {
-        return;
+    sockinfo *si;
+
+    while (m_ready_ring.pop(si)) {
+        move_epoll_ready_socket(si, out);
     }
 
-    std::lock_guard<decltype(m_epoll_ready_sockets_lock)> lock(m_epoll_ready_sockets_lock);
-    sockinfo *si = m_epoll_ready_sockets.front();
-    while (si) {
-        si->set_epoll_event_flags(si->get_epoll_event_flags() | si->get_epoll_event_flags_thread());
-        si->set_epoll_event_flags_thread(0);
-        if (!out.is_member(si)) {
-            out.push_back(si);
+    if (unlikely(m_has_overflow.load(std::memory_order_acquire))) {
+        std::lock_guard<decltype(m_overflow_lock)> lock(m_overflow_lock);
+        m_has_overflow.store(false, std::memory_order_relaxed);
+        while (!m_overflow_sockets.empty()) {
+            move_epoll_ready_socket(m_overflow_sockets.get_and_pop_front(), out);
         }
-
-        si = m_epoll_ready_sockets.next(si);
     }
 }
@@ -7,7 +7,9 @@
 #ifndef _EPFD_INFO_H
 #define _EPFD_INFO_H
 
-#include <util/wakeup_pipe.h>
+#include <util/adaptive_poll.h>
+#include <util/spsc_ring.h>
+#include <util/wakeup_eventfd.h>
 #include <sock/cleanable_obj.h>
 #include <sock/sockinfo.h>
 
@@ -19,19 +21,31 @@ typedef std::unordered_map<int, epoll_fd_rec> fd_info_map_t;
 typedef std::unordered_map<ring *, int /*ref count*/> ring_map_t;
 typedef std::deque<int> ready_cq_fd_q_t;
 
+#define EPOLL_ENTITY_EVENTS_RING 256U
+
+/*
+ * Ready sockets handed by one worker thread to the application threads of one epfd.
+ * The worker is the single producer and the epoll_wait() holding the epfd lock is the single
+ * consumer. The thread events of a socket de-duplicate it: the socket is queued only by the
+ * report which finds them empty, and the consumer takes them when it dequeues the socket.
+ * The locked list is used only when the ring is full.
+ */
 class epfd_info_entity_context_events {
 public:
     typedef xlio_list_t<sockinfo, sockinfo::socket_fd_list_node_offset> epoll_ready_sock_list;
 
-    ~epfd_info_entity_context_events() { m_epoll_ready_sockets.clear(); }
+    ~epfd_info_entity_context_events() { m_overflow_sockets.clear(); }
 
-    void add_epoll_ready_socket(uint64_t events, sockinfo *si);
-    void remove_epoll_ready_socket(sockinfo *si);
+    // Returns true if the socket was queued, i.e. the application may need a wakeup
+    bool add_epoll_ready_socket(uint32_t events, sockinfo *si);
+    void remove_epoll_ready_socket(sockinfo *si, ep_ready_fd_list_t &out);
     void move_epoll_ready_events(ep_ready_fd_list_t &out);
 
 private:
-    epoll_ready_sock_list m_epoll_ready_sockets;
-    lock_spin_recursive m_epoll_ready_sockets_lock;
+    spsc_ring<sockinfo *, EPOLL_ENTITY_EVENTS_RING> m_ready_ring;
+    std::atomic<bool> m_has_overflow {false};
+    epoll_ready_sock_list m_overflow_sockets;
+    lock_spin m_overflow_lock;
 };
 
 enum class epoll_poll_type_t {
@@ -40,7 +54,7 @@ enum class epoll_poll_type_t {
     POLL_BOTH // Poll both RX and TX rings (default epoll_wait behavior)
 };
 
-class epfd_info : public lock_mutex_recursive, public cleanable_obj, public wakeup_pipe {
+class epfd_info : public lock_mutex_recursive, public cleanable_obj, public wakeup_eventfd {
 public:
     epfd_info(int epfd, int size);
     ~epfd_info();
@@ -108,18 +122,23 @@ public:
     inline size_t get_fd_offloaded_size() { return m_fd_offloaded_list.size(); }
     void insert_epoll_event_cb(sockinfo *sock_fd, uint32_t event_flags);
     void insert_epoll_event(sockinfo *sock_fd, uint32_t event_flags);
+    void insert_epoll_events_cb(const std::pair<epfd_info *, sockinfo *> *events, size_t count,
+                                uint32_t event_flags);
     void remove_epoll_event(sockinfo *sock_fd, uint32_t event_flags);
     void increase_ring_ref_count(ring *ring);
     void decrease_ring_ref_count(ring *ring);
     bool move_entity_context_ready_events();
     void add_rx_migration_cand(sockinfo *si);
     void rx_migration_check();
+    adaptive_poll *get_adaptive_poll() { return &m_adaptive_poll; }
 
 private:
     int add_fd(int fd, epoll_event *event);
     int del_fd(int fd, bool passthrough = false);
     int mod_fd(int fd, epoll_event *event);
+    bool rearm_fd(int fd, epoll_event *event);
     void remove_socket_from_ready_list(sockinfo *sk);
+    void add_ready_fd(sockinfo *sock_fd, uint32_t event_flags);
 
 public:
     ep_ready_fd_list_t m_ready_fds;
@@ -139,6 +158,8 @@ private:
     epoll_stats_t *m_stats;
     int m_log_invalid_events;
     std::vector<sockinfo *> m_rx_migration_cands;
-    std::vector<epfd_info_entity_context_events> m_entity_context_events;
+    std::unique_ptr<epfd_info_entity_context_events[]> m_entity_context_events;
+    size_t m_n_entity_context_events = 0U;
+    adaptive_poll m_adaptive_poll;
 };
 #endif /* _EPFD_INFO_H */
@@ -55,7 +55,7 @@ void epoll_wait_call::init_offloaded_fds()
 
 int epoll_wait_call::get_current_events()
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         if (m_epfd_info->m_ready_fds.empty()) {
             return m_n_all_ready_fds;
         }
@@ -76,6 +76,9 @@ int epoll_wait_call::get_current_events()
     while (si && i < m_maxevents) {
         sockinfo *si_next = m_epfd_info->m_ready_fds.next(si);
         bool got_event = false;
+        // Edge triggered sockets are inserted on a state change, the events are reported as
+        // they are without checking the readiness again
+        bool edge_triggered = si->m_fd_rec.events & EPOLLET;
 
         m_events[i].events = 0;
 
@@ -90,7 +93,7 @@ int epoll_wait_call::get_current_events()
         }
 
         if (mutual_events & EPOLLIN) {
-            if (handle_epoll_event(si->is_readable(nullptr), EPOLLIN, si, i)) {
+            if (handle_epoll_event(edge_triggered || si->is_readable(nullptr), EPOLLIN, si, i)) {
                 ready_rfds++;
                 got_event = true;
             }
@@ -98,7 +101,7 @@ int epoll_wait_call::get_current_events()
         }
 
         if (mutual_events & EPOLLOUT) {
-            if (handle_epoll_event(si->is_writeable(), EPOLLOUT, si, i)) {
+            if (handle_epoll_event(edge_triggered || si->is_writeable(), EPOLLOUT, si, i)) {
                 ready_wfds++;
                 got_event = true;
             }
@@ -127,6 +130,14 @@ int epoll_wait_call::get_current_events()
         si = si_next;
     }
 
+    // maxevents is reached: the level triggered sockets reported now and still ready go behind
+    // the ones not reached, so the busy sockets don't starve the rest of the ready list
+    if (si) {
+        m_epfd_info->m_ready_fds.rotate_to_front(si);
+        // Hand the rest of the events to one of the threads sleeping on the epfd
+        m_epfd_info->do_wakeup();
+    }
+
     m_n_ready_rfds += ready_rfds;
     m_n_ready_wfds += ready_wfds;
     m_p_stats->n_iomux_rx_ready += ready_rfds;
@@ -160,6 +171,15 @@ bool epoll_wait_call::_wait(int timeout)
         lock();
         if (m_epfd_info->m_ready_fds.empty()) {
             m_epfd_info->going_to_sleep();
+            // The workers report the events without the lock: they check for a sleeper after
+            // queueing and this thread checks their queues after announcing the sleep
+            if (g_hot_sys_var.is_threads_mode()) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_epfd_info->move_entity_context_ready_events()) {
+                    m_epfd_info->return_from_sleep();
+                    timeout = 0;
+                }
+            }
         } else {
             timeout = 0;
         }
@@ -313,8 +333,8 @@ bool epoll_wait_call::handle_epoll_event(bool is_ready, uint32_t events, sockinf
         m_events[index].events |= events;
 
         if (fd_rec.events & EPOLLONESHOT) {
-            // Clear events for this fd
-            fd_rec.events &= ~events;
+            // Clear events for this fd, atomically with a re-arm out of the epfd lock
+            __atomic_fetch_and(&fd_rec.events, ~events, __ATOMIC_RELAXED);
         }
         if (fd_rec.events & EPOLLET) {
             m_epfd_info->remove_epoll_event(socket_object, events);
@@ -329,7 +349,7 @@ bool epoll_wait_call::handle_epoll_event(bool is_ready, uint32_t events, sockinf
 
 bool epoll_wait_call::ring_poll_and_process_element()
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         return m_epfd_info->ring_poll_and_process_element(&m_poll_sn_rx, &m_poll_sn_tx, nullptr);
     }
 
@@ -338,7 +358,7 @@ bool epoll_wait_call::ring_poll_and_process_element()
 
 int epoll_wait_call::ring_request_notification()
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         return m_epfd_info->ring_request_notification(m_poll_sn_rx, m_poll_sn_tx);
     }
 
@@ -347,8 +367,13 @@ int epoll_wait_call::ring_request_notification()
 
 void epoll_wait_call::ring_wait_for_notification_and_process_element(void *pv_fd_ready_array)
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         m_epfd_info->ring_wait_for_notification_and_process_element(&m_poll_sn_rx,
                                                                     pv_fd_ready_array);
     }
 }
+
+adaptive_poll *epoll_wait_call::get_adaptive_poll()
+{
+    return m_epfd_info->get_adaptive_poll();
+}
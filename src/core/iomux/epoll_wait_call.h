@@ -80,6 +80,8 @@ protected:
 
     virtual void ring_wait_for_notification_and_process_element(void *pv_fd_ready_array);
 
+    virtual adaptive_poll *get_adaptive_poll();
+
 private:
     bool _wait(int timeout);
 
@@ -227,7 +227,7 @@ bool io_mux_call::handle_os_countdown(int &poll_os_countdown)
      * Poll OS when count down reaches zero. This honors CQ-OS ratio.
      * This also handles the 0 ratio case - do not poll OS at all.
      */
-    if (poll_os_countdown-- <= 0 && safe_mce_sys().select_poll_os_ratio > 0) {
+    if (poll_os_countdown-- <= 0 && g_hot_sys_var.select_poll_os_ratio > 0) {
         if (wait_os(true)) {
             // This will empty the cqepfd
             // (most likely in case of a wakeup and probably only under epoll_wait (Not
@@ -246,7 +246,7 @@ bool io_mux_call::handle_os_countdown(int &poll_os_countdown)
             check_all_offloaded_sockets();
             return true;
         }
-        poll_os_countdown = safe_mce_sys().select_poll_os_ratio - 1;
+        poll_os_countdown = g_hot_sys_var.select_poll_os_ratio - 1;
     }
 
     return false;
@@ -264,13 +264,17 @@ void io_mux_call::polling_loops()
     timeval delta;
     int check_timer_countdown = 1; // Poll once before checking the time
     int check_timer_countdown_step = MAX(*m_p_num_all_offloaded_fds, 1U);
-    int check_timer_countdown_init = (safe_mce_sys().select_poll_num == 0 ? 1 : 512);
+    int check_timer_countdown_init = (g_hot_sys_var.select_poll_num == 0 ? 1 : 512);
     bool all_drained = false;
-    bool finite_polling = (safe_mce_sys().select_poll_num != -1);
+    bool finite_polling = (g_hot_sys_var.select_poll_num != -1);
 
     timeval poll_duration;
     tv_clear(&poll_duration);
-    poll_duration.tv_usec = safe_mce_sys().select_poll_num;
+    poll_duration.tv_usec = g_hot_sys_var.select_poll_num;
+    if (finite_polling && safe_mce_sys().poll_adaptive) {
+        m_p_adaptive_poll = get_adaptive_poll();
+        poll_duration.tv_usec = m_p_adaptive_poll->budget_usec(g_hot_sys_var.select_poll_num);
+    }
 
     __if_dbg("2nd scenario start");
 
@@ -350,6 +354,7 @@ void io_mux_call::polling_loops()
     }
 
     if (m_n_all_ready_fds) { // TODO: verify!
+        adaptive_poll_update();
         ++m_p_stats->n_iomux_poll_hit;
         __log_func("polling_loops found %d ready fds (rfds=%d, wfds=%d, efds=%d)",
                    m_n_all_ready_fds, m_n_ready_rfds, m_n_ready_wfds, m_n_ready_efds);
@@ -409,6 +414,8 @@ void io_mux_call::blocking_loops()
             }
         }
     } while (!m_n_all_ready_fds && !is_timeout(m_elapsed));
+
+    adaptive_poll_update();
 }
 
 int io_mux_call::call()
@@ -483,18 +490,32 @@ bool io_mux_call::immidiate_return(int &poll_os_countdown)
      * In all other times, OS is never polled first (even if ratio is 1).
      */
     if (--m_n_skip_os_count <= 0) {
-        m_n_skip_os_count = safe_mce_sys().select_skip_os_fd_check;
+        m_n_skip_os_count = g_hot_sys_var.select_skip_os_fd_check;
         poll_os_countdown = 0;
     } else {
-        poll_os_countdown = safe_mce_sys().select_poll_os_ratio;
+        poll_os_countdown = g_hot_sys_var.select_poll_os_ratio;
     }
 
     return false;
 }
 
+inline void io_mux_call::adaptive_poll_update()
+{
+    if (m_p_adaptive_poll) {
+        timer_update();
+        m_p_adaptive_poll->update(tv_to_usec(&m_elapsed));
+    }
+}
+
+adaptive_poll *io_mux_call::get_adaptive_poll()
+{
+    static thread_local adaptive_poll s_adaptive_poll;
+    return &s_adaptive_poll;
+}
+
 bool io_mux_call::ring_poll_and_process_element()
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         // TODO: (select, poll) this access all CQs, it is better to check only relevant ones
         return g_p_net_device_table_mgr->global_ring_poll_and_process_element(
             &m_poll_sn_rx, &m_poll_sn_tx, nullptr);
@@ -505,7 +526,7 @@ bool io_mux_call::ring_poll_and_process_element()
 
 int io_mux_call::ring_request_notification()
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         return g_p_net_device_table_mgr->global_ring_request_notification(m_poll_sn_rx,
                                                                           m_poll_sn_tx);
     }
@@ -515,7 +536,7 @@ int io_mux_call::ring_request_notification()
 
 void io_mux_call::ring_wait_for_notification_and_process_element(void *pv_fd_ready_array)
 {
-    if (!safe_mce_sys().is_threads_mode()) {
+    if (!g_hot_sys_var.is_threads_mode()) {
         g_p_net_device_table_mgr->global_ring_wait_for_notification_and_process_element(
             &m_poll_sn_rx, pv_fd_ready_array);
     }
@@ -10,6 +10,7 @@
 #include <exception>
 #include <sys/time.h>
 
+#include <util/adaptive_poll.h>
 #include <util/vtypes.h>
 #include <util/xlio_stats.h>
 #include <sock/sockinfo.h>
@@ -205,6 +206,11 @@ private:
 
     int m_check_sig_pending_ratio;
 
+    /// Wait history of the adaptive polling, nullptr while the polling is fixed
+    adaptive_poll *m_p_adaptive_poll = nullptr;
+
+    inline void adaptive_poll_update();
+
 public:
 protected:
     virtual bool ring_poll_and_process_element();
@@ -213,6 +219,11 @@ protected:
 
     virtual void ring_wait_for_notification_and_process_element(void *pv_fd_ready_array);
 
+    /**
+     * Wait history for the adaptive polling. select() and poll() share one per thread.
+     */
+    virtual adaptive_poll *get_adaptive_poll();
+
     bool handle_os_countdown(int &poll_os_countdown);
 
     /// Pointer to an array of all offloaded fd's
@@ -45,6 +45,10 @@ poll_call::poll_call(int *off_rfds_buffer, offloaded_mode_t *off_modes_buffer, i
         }
 
         fd = m_orig_fds[i].fd;
+        // The bit check keeps the lookups off the fds XLIO doesn't handle
+        if (!fd_collection_is_xlio_fd(fd)) {
+            continue;
+        }
         sockinfo *temp_sock_fd_api = fd_collection_get_sockfd(fd);
         if (temp_sock_fd_api && (temp_sock_fd_api->get_type() == FD_TYPE_SOCKET)) {
             // POLLERR and POLLHUP are always enabled implicitly and considered as READ by XLIO
@@ -64,57 +64,74 @@ select_call::select_call(int *off_fds_buffer, offloaded_mode_t *off_modes_buffer
             m_readfds = &m_cq_rfds;
         }
 
-        // get offloaded fds in read set
-        for (fd = 0; fd < m_nfds; ++fd) {
-
-            bool check_read = offloaded_read && FD_ISSET(fd, m_readfds);
-            bool check_write = offloaded_write && FD_ISSET(fd, m_writefds);
-
-            sockinfo *psock = fd_collection_get_sockfd(fd);
-
-            if (psock && psock->get_type() == FD_TYPE_SOCKET) {
-
-                offloaded_mode_t off_mode = OFF_NONE;
-                if (check_read) {
-                    off_mode = (offloaded_mode_t)(off_mode | OFF_READ);
-                }
-                if (check_write) {
-                    off_mode = (offloaded_mode_t)(off_mode | OFF_WRITE);
-                }
+        // get offloaded fds in read set, a word of the sets at a time
+        static_assert(sizeof(__FDS_BITS(m_readfds)[0]) == sizeof(uint64_t),
+                      "fd_set word doesn't match the fd_collection bits");
+        for (int base = 0; base < m_nfds; base += 64) {
+            uint64_t valid = (m_nfds - base >= 64) ? ~0ULL : ((1ULL << (m_nfds - base)) - 1U);
+            uint64_t rbits =
+                offloaded_read ? (static_cast<uint64_t>(__FDS_BITS(m_readfds)[base / 64]) & valid)
+                               : 0U;
+            uint64_t wbits = offloaded_write
+                ? (static_cast<uint64_t>(__FDS_BITS(m_writefds)[base / 64]) & valid)
+                : 0U;
+            uint64_t xlio_bits = (rbits | wbits) ? fd_collection_get_xlio_fd_bits(base) : 0U;
+
+            // The fds XLIO doesn't handle are passed to the OS as they are
+            __FDS_BITS(&m_os_rfds)[base / 64] = static_cast<__fd_mask>(rbits & ~xlio_bits);
+            __FDS_BITS(&m_os_wfds)[base / 64] = static_cast<__fd_mask>(wbits & ~xlio_bits);
+
+            for (xlio_bits &= (rbits | wbits); xlio_bits; xlio_bits &= xlio_bits - 1U) {
+                fd = base + __builtin_ctzll(xlio_bits);
+                bool check_read = rbits & (1ULL << (fd - base));
+                bool check_write = wbits & (1ULL << (fd - base));
+
+                sockinfo *psock = fd_collection_get_sockfd(fd);
+
+                if (psock && psock->get_type() == FD_TYPE_SOCKET) {
+
+                    offloaded_mode_t off_mode = OFF_NONE;
+                    if (check_read) {
+                        off_mode = (offloaded_mode_t)(off_mode | OFF_READ);
+                    }
+                    if (check_write) {
+                        off_mode = (offloaded_mode_t)(off_mode | OFF_WRITE);
+                    }
 
-                if (off_mode) {
-                    __log_func("---> fd=%d IS SET for read or write!", fd);
-
-                    m_p_all_offloaded_fds[m_num_all_offloaded_fds] = fd;
-                    m_p_offloaded_modes[m_num_all_offloaded_fds] = off_mode;
-                    m_num_all_offloaded_fds++;
-                    if (!psock->skip_os_select()) {
-                        if (check_read) {
-                            FD_SET(fd, &m_os_rfds);
-                            if (psock->is_readable(nullptr)) {
-                                io_mux_call::update_fd_array(&m_fd_ready_array, fd);
-                                m_n_ready_rfds++;
-                                m_n_all_ready_fds++;
-                            } else {
-                                // Instructing the socket to sample the OS immediately to prevent
-                                // hitting EAGAIN on recvfrom(), after iomux returned a shadow fd as
-                                // ready (only for non-blocking sockets)
-                                psock->set_immediate_os_sample();
+                    if (off_mode) {
+                        __log_func("---> fd=%d IS SET for read or write!", fd);
+
+                        m_p_all_offloaded_fds[m_num_all_offloaded_fds] = fd;
+                        m_p_offloaded_modes[m_num_all_offloaded_fds] = off_mode;
+                        m_num_all_offloaded_fds++;
+                        if (!psock->skip_os_select()) {
+                            if (check_read) {
+                                FD_SET(fd, &m_os_rfds);
+                                if (psock->is_readable(nullptr)) {
+                                    io_mux_call::update_fd_array(&m_fd_ready_array, fd);
+                                    m_n_ready_rfds++;
+                                    m_n_all_ready_fds++;
+                                } else {
+                                    // Instructing the socket to sample the OS immediately to
+                                    // prevent hitting EAGAIN on recvfrom(), after iomux returned a
+                                    // shadow fd as ready (only for non-blocking sockets)
+                                    psock->set_immediate_os_sample();
+                                }
                             }
+                            if (check_write) {
+                                FD_SET(fd, &m_os_wfds);
+                            }
+                        } else {
+                            __log_func("fd=%d must be skipped from os r select()", fd);
                         }
-                        if (check_write) {
-                            FD_SET(fd, &m_os_wfds);
-                        }
-                    } else {
-                        __log_func("fd=%d must be skipped from os r select()", fd);
                     }
-                }
-            } else {
-                if (check_read) {
-                    FD_SET(fd, &m_os_rfds);
-                }
-                if (check_write) {
-                    FD_SET(fd, &m_os_wfds);
+                } else {
+                    if (check_read) {
+                        FD_SET(fd, &m_os_rfds);
+                    }
+                    if (check_write) {
+                        FD_SET(fd, &m_os_wfds);
+                    }
                 }
             }
         }
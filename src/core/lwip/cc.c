@@ -102,4 +102,11 @@ inline void cc_post_recovery(struct tcp_pcb *pcb)
     }
 }
 
+inline void cc_on_rate_sample(struct tcp_pcb *pcb, const struct cc_rate_sample *rs)
+{
+    if (pcb->cc_algo->rate_sample != NULL) {
+        pcb->cc_algo->rate_sample(pcb, rs);
+    }
+}
+
 #endif // TCP_CC_ALGO_MOD
@@ -63,7 +63,7 @@ struct tcp_pcb;
 #include <stdint.h>
 
 /* types of different cc algorithms */
-enum cc_algo_mod { CC_MOD_LWIP, CC_MOD_CUBIC, CC_MOD_NONE };
+enum cc_algo_mod { CC_MOD_LWIP, CC_MOD_CUBIC, CC_MOD_NONE, CC_MOD_BBR, CC_MOD_DCTCP };
 
 /* ACK types passed to the ack_received() hook. */
 #define CC_ACK        0x0001 /* Regular in sequence ACK. */
@@ -85,6 +85,29 @@ enum cc_algo_mod { CC_MOD_LWIP, CC_MOD_CUBIC, CC_MOD_NONE };
 
 #define TCP_CA_NAME_MAX 16 /* max congestion control name length */
 
+/* Flags of the algorithm */
+#define CC_F_ECN 0x00000001 /* Negotiates ECN, the receiver echoes the CE mark of each segment. */
+
+/*
+ * Delivery rate sample passed to the rate_sample() hook, generated once per ACK
+ * which delivered new data. Times are in microseconds.
+ */
+struct cc_rate_sample {
+    uint32_t interval_us; /* Interval of the sample, 0 if there is no valid sample. */
+    uint32_t delivered; /* Bytes delivered over the interval. */
+    uint32_t prior_delivered; /* Bytes delivered when the sampled segment was sent. */
+    uint32_t acked; /* Bytes newly delivered by this ACK, cumulatively or by SACK. */
+    uint32_t rtt_us; /* RTT of the sampled segment, UINT32_MAX if retransmitted. */
+    uint8_t is_app_limited; /* The sampled segment was sent in an app limited period. */
+
+    /* State of the most recently sent segment delivered by the ACK */
+    uint8_t has_prior;
+    uint8_t is_rexmit;
+    uint32_t prior_time;
+    uint32_t sent_time;
+    uint32_t send_elapsed;
+};
+
 /*
  * Structure to hold data and function pointers that together represent a
  * congestion control algorithm.
@@ -92,6 +115,9 @@ enum cc_algo_mod { CC_MOD_LWIP, CC_MOD_CUBIC, CC_MOD_NONE };
 struct cc_algo {
     char name[TCP_CA_NAME_MAX];
 
+    /* CC_F_* flags */
+    uint32_t flags;
+
     /* Init cc_data */
     int (*init)(struct tcp_pcb *pcb);
 
@@ -112,11 +138,16 @@ struct cc_algo {
 
     /* Called when data transfer resumes after an idle period. */
     void (*after_idle)(struct tcp_pcb *pcb);
+
+    /* Called with the delivery rate sample of an ack, enables the sampling. */
+    void (*rate_sample)(struct tcp_pcb *pcb, const struct cc_rate_sample *rs);
 };
 
 extern struct cc_algo lwip_cc_algo;
 extern struct cc_algo cubic_cc_algo;
 extern struct cc_algo none_cc_algo;
+extern struct cc_algo bbr_cc_algo;
+extern struct cc_algo dctcp_cc_algo;
 
 void cc_init(struct tcp_pcb *pcb);
 void cc_destroy(struct tcp_pcb *pcb);
@@ -124,5 +155,6 @@ void cc_ack_received(struct tcp_pcb *pcb, uint16_t type);
 void cc_conn_init(struct tcp_pcb *pcb);
 void cc_cong_signal(struct tcp_pcb *pcb, uint32_t type);
 void cc_post_recovery(struct tcp_pcb *pcb);
+void cc_on_rate_sample(struct tcp_pcb *pcb, const struct cc_rate_sample *rs);
 
 #endif /* CC_H_ */
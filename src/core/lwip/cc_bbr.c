@@ -0,0 +1,461 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/*
+ * BBR (v1) congestion control.
+ *
+ * The model is the windowed maximum of the delivery rate and the windowed minimum
+ * of the RTT. The sending rate is paced at a gain of the bottleneck bandwidth
+ * estimate and cwnd caps the data in flight at a gain of the bandwidth-delay
+ * product. The gains depend on the state:
+ *  - STARTUP doubles the rate every round until the bandwidth stops to grow;
+ *  - DRAIN empties the queue created by STARTUP;
+ *  - PROBE_BW cycles the pacing gain to probe for more bandwidth and to drain;
+ *  - PROBE_RTT reduces the data in flight to refresh an expired min RTT.
+ * Losses don't update the model, the recovery conserves the data in flight.
+ */
+
+#include "core/lwip/cc.h"
+#include "core/lwip/tcp_impl.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if TCP_CC_ALGO_MOD
+
+/* Fixed point unit of the gains */
+#define BBR_SCALE 8
+#define BBR_UNIT  (1U << BBR_SCALE)
+
+/* 2/ln(2), the smallest gain doubling the delivery rate every round */
+#define BBR_HIGH_GAIN  (BBR_UNIT * 2885U / 1000U + 1U)
+/* Inverse of the high gain, drains the queue of STARTUP in a round */
+#define BBR_DRAIN_GAIN (BBR_UNIT * 1000U / 2885U)
+/* cwnd gain of PROBE_BW, room for the delayed and stretched ACKs */
+#define BBR_CWND_GAIN (BBR_UNIT * 2U)
+
+/* Rounds of the bandwidth max filter */
+#define BBR_BW_RTTS 10U
+/* Lifetime of the min RTT estimate */
+#define BBR_MIN_RTT_WIN_USEC (10U * 1000000U)
+/* Minimal time spent in PROBE_RTT */
+#define BBR_PROBE_RTT_USEC 200000U
+/* Initial cwnd in segments, used until there is a model */
+#define BBR_INIT_CWND_SEGS 10U
+/* Minimal cwnd in segments, kept in PROBE_RTT */
+#define BBR_MIN_CWND_SEGS 4U
+/* Segments added to the target cwnd for the delayed ACKs and the aggregation */
+#define BBR_QUANTA_SEGS 3U
+/* The pipe is full after rounds without 25% growth of the bandwidth */
+#define BBR_FULL_BW_THRESH (BBR_UNIT * 5U / 4U)
+#define BBR_FULL_BW_CNT    3U
+
+/* Pacing gains of the PROBE_BW cycle, a phase lasts a min RTT */
+#define BBR_CYCLE_LEN 8U
+static const uint32_t bbr_pacing_gain[BBR_CYCLE_LEN] = {
+    BBR_UNIT * 5U / 4U, BBR_UNIT * 3U / 4U, BBR_UNIT, BBR_UNIT,
+    BBR_UNIT,           BBR_UNIT,           BBR_UNIT, BBR_UNIT};
+
+enum bbr_mode { BBR_STARTUP, BBR_DRAIN, BBR_PROBE_BW, BBR_PROBE_RTT };
+
+/* Bandwidth sample of the max filter */
+struct bbr_bw_sample {
+    uint32_t round;
+    uint64_t bw; /* bytes per second */
+};
+
+struct bbr {
+    enum bbr_mode mode;
+    /* Best, 2nd best and 3rd best samples of the window (Kathleen Nichols' algorithm) */
+    struct bbr_bw_sample bw[3];
+    /* Min RTT in usec, UINT32_MAX until the first sample */
+    uint32_t min_rtt_us;
+    /* Time of the min RTT sample */
+    uint32_t min_rtt_stamp;
+    /* End of PROBE_RTT, valid when probe_rtt_started is set */
+    uint32_t probe_rtt_done_stamp;
+    /* Rounds trips so far and the delivered mark ending the current one */
+    uint32_t round_count;
+    uint32_t next_round_delivered;
+    /* Bandwidth of the full pipe detection and the rounds without growth */
+    uint64_t full_bw;
+    uint32_t full_bw_cnt;
+    uint32_t pacing_gain;
+    uint32_t cwnd_gain;
+    /* Phase of the PROBE_BW cycle and its start time */
+    uint32_t cycle_idx;
+    uint32_t cycle_stamp;
+    /* cwnd before the recovery or PROBE_RTT */
+    uint32_t prior_cwnd;
+    /* Last rate passed to the pacing */
+    uint64_t pacing_rate;
+    uint8_t full_bw_reached;
+    uint8_t round_start;
+    uint8_t probe_rtt_started;
+    uint8_t probe_rtt_round_done;
+};
+
+static int bbr_cb_init(struct tcp_pcb *pcb);
+static void bbr_cb_destroy(struct tcp_pcb *pcb);
+static void bbr_conn_init(struct tcp_pcb *pcb);
+static void bbr_cong_signal(struct tcp_pcb *pcb, uint32_t type);
+static void bbr_post_recovery(struct tcp_pcb *pcb);
+static void bbr_rate_sample(struct tcp_pcb *pcb, const struct cc_rate_sample *rs);
+
+struct cc_algo bbr_cc_algo = {.name = "bbr",
+                              .init = bbr_cb_init,
+                              .destroy = bbr_cb_destroy,
+                              .conn_init = bbr_conn_init,
+                              .cong_signal = bbr_cong_signal,
+                              .post_recovery = bbr_post_recovery,
+                              .rate_sample = bbr_rate_sample};
+
+static inline uint64_t bbr_max_bw(const struct bbr *bbr)
+{
+    return bbr->bw[0].bw;
+}
+
+static inline uint32_t bbr_min_cwnd(const struct tcp_pcb *pcb)
+{
+    return BBR_MIN_CWND_SEGS * pcb->mss;
+}
+
+static void bbr_bw_filter_update(struct bbr *bbr, uint64_t bw)
+{
+    struct bbr_bw_sample *s = bbr->bw;
+    struct bbr_bw_sample val = {.round = bbr->round_count, .bw = bw};
+    uint32_t dt;
+
+    if (bw >= s[0].bw || val.round - s[2].round > BBR_BW_RTTS) {
+        /* New max or nothing left in the window */
+        s[0] = s[1] = s[2] = val;
+        return;
+    }
+    if (bw >= s[1].bw) {
+        s[2] = s[1] = val;
+    } else if (bw >= s[2].bw) {
+        s[2] = val;
+    }
+
+    /* Age the samples so the window keeps a choice of the best within its subwindows */
+    dt = val.round - s[0].round;
+    if (dt > BBR_BW_RTTS) {
+        s[0] = s[1];
+        s[1] = s[2];
+        s[2] = val;
+        if (val.round - s[0].round > BBR_BW_RTTS) {
+            s[0] = s[1];
+            s[1] = s[2];
+            s[2] = val;
+        }
+    } else if (s[1].round == s[0].round && dt > BBR_BW_RTTS / 4U) {
+        s[2] = s[1] = val;
+    } else if (s[2].round == s[1].round && dt > BBR_BW_RTTS / 2U) {
+        s[2] = val;
+    }
+}
+
+/* Bandwidth-delay product at the given gain */
+static uint32_t bbr_bdp(const struct bbr *bbr, const struct tcp_pcb *pcb, uint32_t gain)
+{
+    uint64_t bdp;
+
+    if (bbr->min_rtt_us == UINT32_MAX || !bbr_max_bw(bbr)) {
+        /* No model yet, keep the initial window */
+        return (uint32_t)(((uint64_t)BBR_INIT_CWND_SEGS * pcb->mss * gain) >> BBR_SCALE);
+    }
+    bdp = bbr_max_bw(bbr) * bbr->min_rtt_us / 1000000U;
+    bdp = (bdp * gain) >> BBR_SCALE;
+    return (uint32_t)LWIP_MIN(bdp, (uint64_t)UINT32_MAX);
+}
+
+static uint32_t bbr_target_cwnd(const struct bbr *bbr, const struct tcp_pcb *pcb, uint32_t gain)
+{
+    uint64_t cwnd = (uint64_t)bbr_bdp(bbr, pcb, gain) + BBR_QUANTA_SEGS * pcb->mss;
+
+    return (uint32_t)LWIP_MAX(LWIP_MIN(cwnd, (uint64_t)UINT32_MAX), (uint64_t)bbr_min_cwnd(pcb));
+}
+
+static inline uint32_t bbr_inflight(const struct tcp_pcb *pcb)
+{
+    return pcb->snd_nxt - pcb->lastack;
+}
+
+static void bbr_save_cwnd(struct bbr *bbr, const struct tcp_pcb *pcb)
+{
+    /* Keep the cwnd of the model if a recovery or PROBE_RTT is already in progress */
+    if (!(pcb->flags & TF_INFR) && bbr->mode != BBR_PROBE_RTT) {
+        bbr->prior_cwnd = pcb->cwnd;
+    } else {
+        bbr->prior_cwnd = LWIP_MAX(bbr->prior_cwnd, pcb->cwnd);
+    }
+}
+
+static void bbr_enter_startup(struct bbr *bbr)
+{
+    bbr->mode = BBR_STARTUP;
+    bbr->pacing_gain = BBR_HIGH_GAIN;
+    bbr->cwnd_gain = BBR_HIGH_GAIN;
+}
+
+static void bbr_advance_cycle_phase(struct bbr *bbr, uint32_t now)
+{
+    bbr->cycle_idx = (bbr->cycle_idx + 1U) % BBR_CYCLE_LEN;
+    bbr->cycle_stamp = now;
+    bbr->pacing_gain = bbr_pacing_gain[bbr->cycle_idx];
+}
+
+static void bbr_enter_probe_bw(struct bbr *bbr, uint32_t now)
+{
+    bbr->mode = BBR_PROBE_BW;
+    bbr->cwnd_gain = BBR_CWND_GAIN;
+    /* Random phase other than the drain one, so flows don't probe in sync */
+    bbr->cycle_idx = BBR_CYCLE_LEN - 1U - (now % (BBR_CYCLE_LEN - 1U));
+    bbr_advance_cycle_phase(bbr, now);
+}
+
+static void bbr_update_round(struct bbr *bbr, const struct tcp_pcb *pcb,
+                             const struct cc_rate_sample *rs)
+{
+    bbr->round_start = 0;
+    if (rs->interval_us && TCP_SEQ_GEQ(rs->prior_delivered, bbr->next_round_delivered)) {
+        bbr->next_round_delivered = pcb->delivered;
+        bbr->round_count++;
+        bbr->round_start = 1;
+    }
+}
+
+static void bbr_update_bw(struct bbr *bbr, const struct cc_rate_sample *rs)
+{
+    uint64_t bw;
+
+    if (!rs->interval_us || !rs->delivered) {
+        return;
+    }
+    bw = (uint64_t)rs->delivered * 1000000U / rs->interval_us;
+    /* An app limited sample underestimates the bandwidth, unless it's higher anyway */
+    if (!rs->is_app_limited || bw >= bbr_max_bw(bbr)) {
+        bbr_bw_filter_update(bbr, bw);
+    }
+}
+
+static void bbr_update_cycle_phase(struct bbr *bbr, const struct tcp_pcb *pcb, uint32_t now)
+{
+    uint32_t inflight = bbr_inflight(pcb);
+    uint8_t is_full_length;
+
+    if (bbr->mode != BBR_PROBE_BW) {
+        return;
+    }
+    is_full_length = (now - bbr->cycle_stamp) > bbr->min_rtt_us;
+    if (bbr->pacing_gain > BBR_UNIT) {
+        /* Probe until the higher inflight is reached */
+        if (is_full_length && inflight >= bbr_bdp(bbr, pcb, bbr->pacing_gain)) {
+            bbr_advance_cycle_phase(bbr, now);
+        }
+    } else if (bbr->pacing_gain < BBR_UNIT) {
+        /* Drain until the queue is gone */
+        if (is_full_length || inflight <= bbr_bdp(bbr, pcb, BBR_UNIT)) {
+            bbr_advance_cycle_phase(bbr, now);
+        }
+    } else if (is_full_length) {
+        bbr_advance_cycle_phase(bbr, now);
+    }
+}
+
+static void bbr_check_full_bw_reached(struct bbr *bbr, const struct cc_rate_sample *rs)
+{
+    if (bbr->full_bw_reached || !bbr->round_start || rs->is_app_limited) {
+        return;
+    }
+    if (bbr_max_bw(bbr) >= ((bbr->full_bw * BBR_FULL_BW_THRESH) >> BBR_SCALE)) {
+        bbr->full_bw = bbr_max_bw(bbr);
+        bbr->full_bw_cnt = 0;
+        return;
+    }
+    if (++bbr->full_bw_cnt >= BBR_FULL_BW_CNT) {
+        bbr->full_bw_reached = 1;
+    }
+}
+
+static void bbr_check_drain(struct bbr *bbr, const struct tcp_pcb *pcb, uint32_t now)
+{
+    if (bbr->mode == BBR_STARTUP && bbr->full_bw_reached) {
+        bbr->mode = BBR_DRAIN;
+        bbr->pacing_gain = BBR_DRAIN_GAIN;
+        bbr->cwnd_gain = BBR_HIGH_GAIN;
+    }
+    if (bbr->mode == BBR_DRAIN && bbr_inflight(pcb) <= bbr_bdp(bbr, pcb, BBR_UNIT)) {
+        bbr_enter_probe_bw(bbr, now);
+    }
+}
+
+static void bbr_update_min_rtt(struct bbr *bbr, struct tcp_pcb *pcb,
+                               const struct cc_rate_sample *rs, uint32_t now)
+{
+    uint8_t filter_expired = (now - bbr->min_rtt_stamp) > BBR_MIN_RTT_WIN_USEC;
+
+    if (rs->rtt_us != UINT32_MAX && (rs->rtt_us <= bbr->min_rtt_us || filter_expired)) {
+        bbr->min_rtt_us = rs->rtt_us;
+        bbr->min_rtt_stamp = now;
+    }
+
+    if (filter_expired && bbr->mode != BBR_PROBE_RTT) {
+        bbr_save_cwnd(bbr, pcb);
+        bbr->mode = BBR_PROBE_RTT;
+        bbr->pacing_gain = BBR_UNIT;
+        bbr->cwnd_gain = BBR_UNIT;
+        bbr->probe_rtt_started = 0;
+    }
+
+    if (bbr->mode != BBR_PROBE_RTT) {
+        return;
+    }
+    if (!bbr->probe_rtt_started) {
+        /* The minimal inflight is held for a round and BBR_PROBE_RTT_USEC at least */
+        if (bbr_inflight(pcb) <= bbr_min_cwnd(pcb)) {
+            bbr->probe_rtt_started = 1;
+            bbr->probe_rtt_done_stamp = now + BBR_PROBE_RTT_USEC;
+            bbr->probe_rtt_round_done = 0;
+            bbr->next_round_delivered = pcb->delivered;
+        }
+        return;
+    }
+    if (bbr->round_start) {
+        bbr->probe_rtt_round_done = 1;
+    }
+    if (bbr->probe_rtt_round_done && (int32_t)(now - bbr->probe_rtt_done_stamp) >= 0) {
+        bbr->min_rtt_stamp = now;
+        pcb->cwnd = LWIP_MAX(pcb->cwnd, bbr->prior_cwnd);
+        if (bbr->full_bw_reached) {
+            bbr_enter_probe_bw(bbr, now);
+        } else {
+            bbr_enter_startup(bbr);
+        }
+    }
+}
+
+static void bbr_set_pacing_rate(struct bbr *bbr, struct tcp_pcb *pcb)
+{
+    uint64_t rate;
+
+    if (!bbr_max_bw(bbr)) {
+        /* Unpaced until the first bandwidth sample */
+        return;
+    }
+    rate = (bbr_max_bw(bbr) * bbr->pacing_gain) >> BBR_SCALE;
+    /* STARTUP doesn't slow down on a low sample before the pipe is full */
+    if ((bbr->full_bw_reached || rate > bbr->pacing_rate) && rate != bbr->pacing_rate) {
+        bbr->pacing_rate = rate;
+        tcp_set_pacing_rate(pcb, rate);
+    }
+}
+
+static void bbr_set_cwnd(struct bbr *bbr, struct tcp_pcb *pcb, const struct cc_rate_sample *rs)
+{
+    uint32_t target = bbr_target_cwnd(bbr, pcb, bbr->cwnd_gain);
+    uint32_t cwnd = pcb->cwnd;
+
+    if (pcb->flags & TF_INFR) {
+        /* Packet conservation, the recovery sends what is delivered */
+        cwnd = LWIP_MAX(cwnd, bbr_inflight(pcb) + rs->acked);
+    } else if (bbr->full_bw_reached) {
+        cwnd = LWIP_MIN(cwnd + rs->acked, target);
+    } else if (cwnd < target || pcb->delivered < BBR_INIT_CWND_SEGS * pcb->mss) {
+        cwnd += rs->acked;
+    }
+    cwnd = LWIP_MAX(cwnd, bbr_min_cwnd(pcb));
+    if (bbr->mode == BBR_PROBE_RTT) {
+        cwnd = LWIP_MIN(cwnd, bbr_min_cwnd(pcb));
+    }
+    pcb->cwnd = cwnd;
+}
+
+static void bbr_rate_sample(struct tcp_pcb *pcb, const struct cc_rate_sample *rs)
+{
+    struct bbr *bbr = pcb->cc_data;
+    uint32_t now = sys_now_us();
+
+    bbr_update_round(bbr, pcb, rs);
+    bbr_update_bw(bbr, rs);
+    bbr_update_cycle_phase(bbr, pcb, now);
+    bbr_check_full_bw_reached(bbr, rs);
+    bbr_check_drain(bbr, pcb, now);
+    bbr_update_min_rtt(bbr, pcb, rs, now);
+
+    bbr_set_pacing_rate(bbr, pcb);
+    bbr_set_cwnd(bbr, pcb, rs);
+}
+
+static int bbr_cb_init(struct tcp_pcb *pcb)
+{
+    struct bbr *bbr;
+
+    bbr = malloc(sizeof(struct bbr));
+    if (bbr == NULL) {
+        return (ENOMEM);
+    }
+    memset(bbr, 0, sizeof(*bbr));
+
+    bbr->min_rtt_us = UINT32_MAX;
+    bbr->min_rtt_stamp = sys_now_us();
+    bbr->next_round_delivered = pcb->delivered;
+    bbr_enter_startup(bbr);
+
+    pcb->cc_data = bbr;
+
+    return (0);
+}
+
+static void bbr_cb_destroy(struct tcp_pcb *pcb)
+{
+    if (pcb->cc_data != NULL) {
+        tcp_set_pacing_rate(pcb, 0);
+        free(pcb->cc_data);
+        pcb->cc_data = NULL;
+    }
+}
+
+static void bbr_conn_init(struct tcp_pcb *pcb)
+{
+    pcb->cwnd = BBR_INIT_CWND_SEGS * pcb->mss;
+    /* Not used by BBR, keeps the generic code away from the slow start logic */
+    pcb->ssthresh = UINT32_MAX;
+}
+
+static void bbr_cong_signal(struct tcp_pcb *pcb, uint32_t type)
+{
+    struct bbr *bbr = pcb->cc_data;
+
+    switch (type) {
+    case CC_NDUPACK:
+        if (!(pcb->flags & TF_INFR)) {
+            bbr_save_cwnd(bbr, pcb);
+            /* Packet conservation, the new data waits for the deliveries */
+            pcb->cwnd = LWIP_MAX(bbr_inflight(pcb), bbr_min_cwnd(pcb));
+        }
+        break;
+
+    case CC_RTO:
+        bbr_save_cwnd(bbr, pcb);
+        pcb->cwnd = pcb->mss;
+        /* Recheck the pipe after the timeout */
+        bbr->full_bw = 0;
+        bbr->full_bw_cnt = 0;
+        bbr->round_start = 1;
+        break;
+    }
+}
+
+static void bbr_post_recovery(struct tcp_pcb *pcb)
+{
+    struct bbr *bbr = pcb->cc_data;
+
+    pcb->cwnd = LWIP_MAX(pcb->cwnd, bbr->prior_cwnd);
+}
+
+#endif // TCP_CC_ALGO_MOD
@@ -211,6 +211,15 @@ static void cubic_cong_signal(struct tcp_pcb *pcb, uint32_t type)
         }
         break;
 
+    case CC_ECN:
+        /* Same reduction as a loss, the recovery completes at once */
+        cubic_ssthresh_update(pcb);
+        cubic_data->num_cong_events++;
+        cubic_data->prev_max_cwnd = cubic_data->max_cwnd;
+        cubic_data->max_cwnd = pcb->cwnd;
+        cubic_post_recovery(pcb);
+        break;
+
     case CC_RTO:
         /* Set ssthresh to half of the minimum of the current
          * cwnd and the advertised window */
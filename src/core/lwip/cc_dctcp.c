@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/*
+ * DCTCP congestion control (RFC 8257).
+ *
+ * The sender estimates the fraction of the data marked CE by the network over a
+ * window and reduces cwnd in proportion to it, instead of halving it. The growth
+ * and the loss reaction are the ones of the LWIP algorithm. Without ECN the
+ * connection behaves as the LWIP algorithm.
+ */
+
+#include "core/lwip/cc.h"
+#include "core/lwip/tcp_impl.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if TCP_CC_ALGO_MOD
+
+/* Fixed point unit of alpha */
+#define DCTCP_MAX_ALPHA 1024U
+/* Weight of the new sample in alpha, g = 1/16 */
+#define DCTCP_SHIFT_G 4U
+
+struct dctcp {
+    /* Moving average of the marked fraction, in DCTCP_MAX_ALPHA units */
+    uint32_t alpha;
+    /* Bytes acknowledged and bytes acknowledged with ECE in the current window */
+    uint32_t bytes_total;
+    uint32_t bytes_ecn;
+    /* End of the current observation window */
+    uint32_t next_seq;
+};
+
+static int dctcp_cb_init(struct tcp_pcb *pcb);
+static void dctcp_cb_destroy(struct tcp_pcb *pcb);
+static void dctcp_conn_init(struct tcp_pcb *pcb);
+static void dctcp_ack_received(struct tcp_pcb *pcb, uint16_t type);
+static void dctcp_cong_signal(struct tcp_pcb *pcb, uint32_t type);
+static void dctcp_post_recovery(struct tcp_pcb *pcb);
+
+struct cc_algo dctcp_cc_algo = {.name = "dctcp",
+                                .flags = CC_F_ECN,
+                                .init = dctcp_cb_init,
+                                .destroy = dctcp_cb_destroy,
+                                .conn_init = dctcp_conn_init,
+                                .ack_received = dctcp_ack_received,
+                                .cong_signal = dctcp_cong_signal,
+                                .post_recovery = dctcp_post_recovery};
+
+static void dctcp_update_alpha(struct dctcp *dctcp, struct tcp_pcb *pcb)
+{
+    uint32_t marked = 0;
+
+    if (dctcp->bytes_total) {
+        marked = (uint32_t)(((uint64_t)dctcp->bytes_ecn << (10U - DCTCP_SHIFT_G)) /
+                            dctcp->bytes_total);
+    }
+    /* alpha = (1 - g) * alpha + g * F */
+    dctcp->alpha = LWIP_MIN(dctcp->alpha - (dctcp->alpha >> DCTCP_SHIFT_G) + marked,
+                            DCTCP_MAX_ALPHA);
+    dctcp->bytes_total = 0;
+    dctcp->bytes_ecn = 0;
+    dctcp->next_seq = pcb->snd_nxt;
+}
+
+static void dctcp_ack_received(struct tcp_pcb *pcb, uint16_t type)
+{
+    struct dctcp *dctcp = pcb->cc_data;
+
+    if (type == CC_ACK && (pcb->flags & TF_ECN)) {
+        dctcp->bytes_total += pcb->acked;
+        if (pcb->ecn_ece) {
+            dctcp->bytes_ecn += pcb->acked;
+        }
+        if (TCP_SEQ_GEQ(pcb->lastack, dctcp->next_seq)) {
+            dctcp_update_alpha(dctcp, pcb);
+        }
+    }
+    lwip_cc_algo.ack_received(pcb, type);
+}
+
+static void dctcp_cong_signal(struct tcp_pcb *pcb, uint32_t type)
+{
+    struct dctcp *dctcp = pcb->cc_data;
+
+    if (type == CC_ECN) {
+        /* cwnd = cwnd * (1 - alpha / 2) */
+        pcb->ssthresh = LWIP_MAX(
+            pcb->cwnd - (uint32_t)(((uint64_t)pcb->cwnd * dctcp->alpha) >> 11U), 2U * pcb->mss);
+        pcb->cwnd = pcb->ssthresh;
+        return;
+    }
+    lwip_cc_algo.cong_signal(pcb, type);
+}
+
+static void dctcp_post_recovery(struct tcp_pcb *pcb)
+{
+    lwip_cc_algo.post_recovery(pcb);
+}
+
+static void dctcp_conn_init(struct tcp_pcb *pcb)
+{
+    struct dctcp *dctcp = pcb->cc_data;
+
+    dctcp->next_seq = pcb->snd_nxt;
+    lwip_cc_algo.conn_init(pcb);
+}
+
+static int dctcp_cb_init(struct tcp_pcb *pcb)
+{
+    struct dctcp *dctcp;
+
+    dctcp = malloc(sizeof(struct dctcp));
+    if (dctcp == NULL) {
+        return (ENOMEM);
+    }
+    memset(dctcp, 0, sizeof(*dctcp));
+
+    /* Start conservative, the first marks halve cwnd as the classic ECN reaction */
+    dctcp->alpha = DCTCP_MAX_ALPHA;
+    dctcp->next_seq = pcb->snd_nxt;
+
+    pcb->cc_data = dctcp;
+
+    return (0);
+}
+
+static void dctcp_cb_destroy(struct tcp_pcb *pcb)
+{
+    if (pcb->cc_data != NULL) {
+        free(pcb->cc_data);
+        pcb->cc_data = NULL;
+    }
+}
+
+#endif // TCP_CC_ALGO_MOD
@@ -46,6 +46,7 @@
 #include "core/lwip/tcp.h"
 #include "core/lwip/tcp_impl.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -93,6 +94,13 @@ enum cc_algo_mod lwip_cc_algo_module = CC_MOD_LWIP;
 u16_t lwip_tcp_mss = CONST_TCP_MSS;
 u8_t enable_push_flag = 1;
 u8_t enable_ts_option = 0;
+u8_t enable_sack_option = 0;
+u8_t enable_ecn_option = 0;
+u8_t enable_rack_option = 0;
+u8_t enable_ack_coalesce_option = 0;
+u8_t enable_ack_adaptive_option = 0;
+u8_t enable_mtu_probing_option = 0;
+u32_t tcp_cookie_secret[4];
 u32_t lwip_tcp_nodelay_treshold = 0;
 
 /* slow timer value */
@@ -542,7 +550,7 @@ err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, bool
     if (pcb->local_port == 0) {
         return ERR_VAL;
     }
-    iss = tcp_next_iss();
+    iss = (pcb->flags & TF_ISS_SET) ? pcb->snd_nxt : tcp_next_iss();
     pcb->rcv_nxt = 0;
     pcb->snd_nxt = iss;
     pcb->lastack = iss;
@@ -563,7 +571,10 @@ err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, bool
         /* SYN segment was enqueued, changed the pcbs state now */
         set_tcp_state(pcb, SYN_SENT);
 
-        tcp_output(pcb);
+        if (!(pcb->fastopen & TCP_TFO_DATA)) {
+            /* Fast Open <SYN> is sent with the first data */
+            tcp_output(pcb);
+        }
         pcb->ticks_since_data_sent = 0;
     }
     return ret;
@@ -657,6 +668,7 @@ void tcp_slowtmr(struct tcp_pcb *pcb)
 
                     /* Reset the retransmission timer. */
                     pcb->rtime = 0;
+                    ++pcb->stats.n_rto;
 
 #if TCP_CC_ALGO_MOD
                     cc_cong_signal(pcb, CC_RTO);
@@ -730,8 +742,7 @@ void tcp_slowtmr(struct tcp_pcb *pcb)
            be retransmitted). */
 #if TCP_QUEUE_OOSEQ
         if (pcb->ooseq != NULL && (u32_t)tcp_ticks - pcb->tmr >= pcb->rto * TCP_OOSEQ_TIMEOUT) {
-            tcp_segs_free(pcb, pcb->ooseq);
-            pcb->ooseq = NULL;
+            tcp_ooseq_free(pcb);
             LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: dropping OOSEQ queued data\n"));
         }
 #endif /* TCP_QUEUE_OOSEQ */
@@ -794,14 +805,65 @@ void tcp_slowtmr(struct tcp_pcb *pcb)
 void tcp_fasttmr(struct tcp_pcb *pcb)
 {
     if (pcb != NULL && PCB_IN_ACTIVE_STATE(pcb)) {
-        /* send delayed ACKs */
-        if (pcb->flags & TF_ACK_DELAY) {
+        /* send delayed ACKs and the coalesced ones left behind by the poll */
+        if (pcb->flags & (TF_ACK_DELAY | TF_ACK_COALESCE)) {
             LWIP_DEBUGF(TCP_DEBUG, ("tcp_fasttmr: delayed ACK\n"));
+            /* No response carried the ACK, leave the request/response mode as Linux does */
+            if (pcb->flags & TF_ACK_DELAY) {
+                pcb->ack_pingpong = 0;
+            }
             tcp_ack_now(pcb);
             tcp_output(pcb);
             pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW);
         }
+        /* RACK reordering and tail loss probe timers, at the resolution of the fast timer */
+        if (pcb->rack_tmr) {
+            tcp_rack_tmr(pcb);
+        }
+    }
+}
+
+/**
+ * Whether tcp_slowtmr() and tcp_fasttmr() have nothing to do for the pcb but the keepalive: an
+ * established connection without data in flight or queued, a delayed ACK, the persist, RACK or
+ * OOSEQ timers and a running user timeout. Everything which arms one of them goes through the
+ * input processing, tcp_output() or a socket option. The keepalive is due after
+ * tcp_keepalive_ticks().
+ */
+int tcp_tmr_idle(struct tcp_pcb *pcb)
+{
+    return get_tcp_state(pcb) == ESTABLISHED && !pcb->unsent && !pcb->unacked &&
+        !pcb->persist_backoff && !pcb->rack_tmr &&
+        !(pcb->flags & (TF_ACK_DELAY | TF_ACK_NOW | TF_ACK_COALESCE)) &&
+        (!pcb->user_timeout_ms || pcb->ticks_since_data_sent == -1)
+#if TCP_QUEUE_OOSEQ
+        && !pcb->ooseq
+#endif /* TCP_QUEUE_OOSEQ */
+        ;
+}
+
+/**
+ * Slow timer ticks until tcp_slowtmr() sends the next keepalive probe or times the connection
+ * out, 0 if the keepalive is off. The data received meanwhile only delays it.
+ */
+u32_t tcp_keepalive_ticks(struct tcp_pcb *pcb)
+{
+    u32_t due;
+    s32_t left;
+
+    if (!(pcb->so_options & SOF_KEEPALIVE) ||
+        (get_tcp_state(pcb) != ESTABLISHED && get_tcp_state(pcb) != CLOSE_WAIT)) {
+        return 0;
     }
+#if LWIP_TCP_KEEPALIVE
+    due = pcb->tmr + (pcb->keep_idle + pcb->keep_cnt_sent * pcb->keep_intvl) / slow_tmr_interval;
+#else
+    due = pcb->tmr +
+        (pcb->keep_idle + pcb->keep_cnt_sent * TCP_KEEPINTVL_DEFAULT) / slow_tmr_interval;
+#endif /* LWIP_TCP_KEEPALIVE */
+    /* tcp_slowtmr() acts once the idle time exceeds the threshold */
+    left = (s32_t)(due + 1U - tcp_ticks);
+    return left > 0 ? (u32_t)left : 1U;
 }
 
 /**
@@ -887,6 +949,45 @@ struct tcp_seg *tcp_seg_copy(struct tcp_pcb *pcb, struct tcp_seg *seg)
     pbuf_ref(cseg->p);
     return cseg;
 }
+
+/**
+ * Frees the out of sequence queue and its blocks.
+ *
+ * @param pcb the tcp_pcb owning the queue
+ */
+void tcp_ooseq_free(struct tcp_pcb *pcb)
+{
+    tcp_segs_free(pcb, pcb->ooseq);
+    pcb->ooseq = NULL;
+    free(pcb->ooseq_blocks);
+    pcb->ooseq_blocks = NULL;
+    pcb->ooseq_blocks_cnt = 0;
+    pcb->ooseq_blocks_max = 0;
+}
+
+/**
+ * Binary search of the out of sequence block which may hold a sequence number.
+ *
+ * @param pcb the tcp_pcb owning the queue
+ * @param seqno the sequence number to look up
+ * @return index of the last block starting at or below seqno, -1 if there is none
+ */
+s32_t tcp_ooseq_find(const struct tcp_pcb *pcb, u32_t seqno)
+{
+    s32_t lo = 0;
+    s32_t hi = (s32_t)pcb->ooseq_blocks_cnt - 1;
+
+    while (lo <= hi) {
+        s32_t mid = lo + (hi - lo) / 2;
+
+        if (TCP_SEQ_LEQ(pcb->ooseq_blocks[mid].left, seqno)) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return hi;
+}
 #endif /* TCP_QUEUE_OOSEQ */
 
 /**
@@ -907,8 +1008,6 @@ err_t tcp_recv_null(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 
 void tcp_pcb_init(struct tcp_pcb *pcb, u8_t prio, void *container)
 {
-    u32_t iss;
-
     memset(pcb, 0, sizeof(*pcb));
     pcb->my_container = container;
     pcb->is_last_seg_dropped = false;
@@ -939,6 +1038,12 @@ void tcp_pcb_init(struct tcp_pcb *pcb, u8_t prio, void *container)
     case CC_MOD_NONE:
         pcb->cc_algo = &none_cc_algo;
         break;
+    case CC_MOD_BBR:
+        pcb->cc_algo = &bbr_cc_algo;
+        break;
+    case CC_MOD_DCTCP:
+        pcb->cc_algo = &dctcp_cc_algo;
+        break;
     case CC_MOD_LWIP:
     default:
         pcb->cc_algo = &lwip_cc_algo;
@@ -947,11 +1052,7 @@ void tcp_pcb_init(struct tcp_pcb *pcb, u8_t prio, void *container)
     cc_init(pcb);
 #endif
     pcb->cwnd = 1;
-    iss = tcp_next_iss();
-    pcb->snd_wl2 = iss;
-    pcb->snd_nxt = iss;
-    pcb->lastack = iss;
-    pcb->snd_lbb = iss;
+    tcp_pcb_set_iss(pcb, tcp_next_iss());
     pcb->tmr = tcp_ticks;
     pcb->snd_sml_snt = 0;
     pcb->snd_sml_add = 0;
@@ -969,20 +1070,48 @@ void tcp_pcb_init(struct tcp_pcb *pcb, u8_t prio, void *container)
 
     pcb->keep_cnt_sent = 0;
     pcb->quickack = 0;
+    pcb->ack_quick = 0;
+    pcb->ack_pingpong = 0;
+    pcb->ack_rcv_time = 0;
     pcb->is_in_input = 0;
     pcb->enable_ts_opt = enable_ts_option;
+    pcb->enable_sack_opt = enable_sack_option;
+    pcb->enable_ecn_opt = enable_ecn_option;
+    pcb->enable_rack_opt = enable_rack_option;
+    pcb->enable_ack_coalesce_opt = enable_ack_coalesce_option;
+    pcb->enable_ack_adaptive_opt = enable_ack_adaptive_option;
     pcb->seg_alloc = NULL;
 }
 
+/**
+ * Sets the initial send sequence number and the sequence numbers which follow it.
+ */
+void tcp_pcb_set_iss(struct tcp_pcb *pcb, u32_t iss)
+{
+    pcb->snd_wl2 = iss;
+    pcb->snd_nxt = iss;
+    pcb->lastack = iss;
+    pcb->snd_lbb = iss;
+    pcb->sack_high = iss;
+    pcb->sack_rexmit_high = iss;
+    pcb->ecn_recover = iss;
+    pcb->rack_end_seq = iss;
+    pcb->rack_recover = iss;
+}
+
 /**
  * Resets pcb object to reuse it for the same tuple.
  * It's called by tcp_pcb_reuse().
  */
 void tcp_pcb_recycle(struct tcp_pcb *pcb)
 {
-    u32_t iss;
-
     pcb->flags = 0;
+    pcb->syncookies = 0;
+    pcb->fastopen = 0;
+    pcb->tfo_cookie_len = 0;
+    pcb->tfo_mss = 0;
+    pcb->mtup_low = 0;
+    pcb->mtup_probe = 0;
     pcb->user_timeout_ms = 0;
     pcb->ticks_since_data_sent = -1;
     pcb->rto = 3000 / slow_tmr_interval;
@@ -995,12 +1124,18 @@ void tcp_pcb_recycle(struct tcp_pcb *pcb)
     cc_init(pcb);
 #endif
     pcb->cwnd = 1;
-    iss = tcp_next_iss();
     pcb->acked = 0;
-    pcb->snd_wl2 = iss;
-    pcb->snd_nxt = iss;
-    pcb->lastack = iss;
-    pcb->snd_lbb = iss;
+    tcp_pcb_set_iss(pcb, tcp_next_iss());
+    pcb->rack_tmr = 0;
+    pcb->tmr_parked = 0;
+    pcb->rack_xmit_time = 0;
+    pcb->rack_rtt = 0;
+    pcb->rack_min_rtt = 0;
+    pcb->rack_srtt = 0;
+    pcb->rcv_rtt = 0;
+    pcb->rcv_rtt_time = 0;
+    pcb->tlp_outstanding = 0;
+    pcb->tlp_rexmit = 0;
     pcb->tmr = tcp_ticks;
     pcb->snd_sml_snt = 0;
     pcb->snd_sml_add = 0;
@@ -1009,6 +1144,9 @@ void tcp_pcb_recycle(struct tcp_pcb *pcb)
     pcb->recv = tcp_recv_null;
     pcb->keep_cnt_sent = 0;
     pcb->quickack = 0;
+    pcb->ack_quick = 0;
+    pcb->ack_pingpong = 0;
+    pcb->ack_rcv_time = 0;
     pcb->is_in_input = 0;
     pcb->snd_scale = 0;
     pcb->rcv_scale = 0;
@@ -1149,6 +1287,19 @@ void tcp_syn_handled(struct tcp_pcb *pcb, tcp_syn_handled_fn syn_handled)
     pcb->syn_handled_cb = syn_handled;
 }
 
+/**
+ * Used for specifying the function that should be called when a SYN is answered
+ * with a SYN cookie.
+ *
+ * @param pcb tcp_pcb to set the callback
+ * @param syn_cookie callback function to call for this pcb to send the <SYN,ACK>
+ *        of the connection, which is not kept
+ */
+void tcp_syn_cookie(struct tcp_pcb *pcb, tcp_syn_cookie_fn syn_cookie)
+{
+    pcb->syn_cookie_cb = syn_cookie;
+}
+
 /**
  * Used for specifying the function that should be called to clone pcb
  *
@@ -1194,8 +1345,7 @@ void tcp_pcb_purge(struct tcp_pcb *pcb)
         if (pcb->ooseq != NULL) {
             LWIP_DEBUGF(TCP_DEBUG, ("tcp_pcb_purge: data left on ->ooseq\n"));
         }
-        tcp_segs_free(pcb, pcb->ooseq);
-        pcb->ooseq = NULL;
+        tcp_ooseq_free(pcb);
 #endif /* TCP_QUEUE_OOSEQ */
 
         /* Stop the retransmission timer as it will expect data on unacked
@@ -1263,6 +1413,20 @@ u16_t tcp_initial_mss(struct tcp_pcb *pcb)
     return unlikely(LWIP_TCP_MSS > 0) ? LWIP_TCP_MSS : (pcb->is_ipv6 ? IPV6_MIN_MSS : IPV4_MIN_MSS);
 }
 
+/**
+ * Returns the MSS of a route mtu, the initial MSS if the mtu is not known (0).
+ */
+u16_t tcp_mtu_to_mss(u16_t mtu, bool is_ipv6)
+{
+    u16_t header_length = (is_ipv6 ? IPV6_HEADER_LEN : IPV4_HEADER_LEN);
+    if (mtu > header_length) {
+        u16_t mss = mtu - header_length;
+        return unlikely(LWIP_TCP_MSS > 0) ? LWIP_MIN(LWIP_TCP_MSS, mss) : mss;
+    }
+
+    return unlikely(LWIP_TCP_MSS > 0) ? LWIP_TCP_MSS : (is_ipv6 ? IPV6_MIN_MSS : IPV4_MIN_MSS);
+}
+
 u16_t tcp_send_mss(struct tcp_pcb *pcb)
 {
     u16_t external_mtu = 0;
@@ -1270,13 +1434,7 @@ u16_t tcp_send_mss(struct tcp_pcb *pcb)
     external_mtu = external_ip_route_mtu(pcb); // Take route or device mtu.
 #endif /* TCP_CALCULATE_EFF_SEND_MSS */
 
-    u16_t header_length = (pcb->is_ipv6 ? IPV6_HEADER_LEN : IPV4_HEADER_LEN);
-    if (external_mtu > header_length) {
-        u16_t mss = external_mtu - header_length;
-        return unlikely(LWIP_TCP_MSS > 0) ? LWIP_MIN(LWIP_TCP_MSS, mss) : mss;
-    }
-
-    return tcp_initial_mss(pcb);
+    return tcp_mtu_to_mss(external_mtu, pcb->is_ipv6);
 }
 
 void tcp_set_keepalive(struct tcp_pcb *pcb, u32_t idle, u32_t intvl, u32_t cnt)
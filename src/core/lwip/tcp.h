@@ -46,6 +46,10 @@ extern "C" {
 typedef u32_t (*sys_now_fn)(void);
 void register_sys_now(sys_now_fn fn);
 
+/* Microseconds clock of the delivery rate sampling */
+typedef u32_t (*sys_now_us_fn)(void);
+void register_sys_now_us(sys_now_us_fn fn);
+
 extern u16_t lwip_tcp_mss;
 extern u32_t lwip_tcp_nodelay_treshold;
 
@@ -102,6 +106,29 @@ typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
  */
 typedef err_t (*tcp_syn_handled_fn)(void *arg, struct tcp_pcb *newpcb);
 
+/* SYN answered with a SYN cookie, no pcb is created for it */
+struct tcp_syncookie_req {
+    /* IP addresses in network byte order, ports in host byte order */
+    ip_addr_t local_ip;
+    ip_addr_t remote_ip;
+    u16_t local_port;
+    u16_t remote_port;
+    u32_t irs; /* Initial sequence number of the remote host */
+    u16_t peer_mss; /* MSS option of the SYN, 0 if absent */
+    u8_t is_ipv6;
+};
+
+/** Function prototype for tcp syn cookie callback functions. Called when a SYN is
+ * answered with a SYN cookie, the callback sends the <SYN,ACK> built by
+ * tcp_syncookie_synack().
+ *
+ * @param arg Additional argument to pass to the callback function (@see tcp_arg())
+ * @param pcb The listen pcb
+ * @param req The connection requested by the SYN
+ */
+typedef err_t (*tcp_syn_cookie_fn)(void *arg, struct tcp_pcb *pcb,
+                                   const struct tcp_syncookie_req *req);
+
 /** Function prototype for tcp clone callback functions. Called to clone listen pcb
  * on connection establishment.
  * @param arg Additional argument to pass to the callback function (@see tcp_arg())
@@ -219,6 +246,16 @@ extern tcp_state_observer_fn external_tcp_state_observer;
 #define SND_WND_SCALE(pcb, wnd) ((u32_t)(wnd) << (pcb)->snd_scale)
 #define TCPWND_MIN16(x)         ((u16_t)LWIP_MIN((x), 0xFFFF))
 
+/* What stops the sender, the time of each limit is accounted by tcp_limited_update() */
+enum tcp_limited {
+    TCP_LIMITED_NONE, /* Nothing to send or held by Nagle, cork or pacing */
+    TCP_LIMITED_RWND, /* The next segment doesn't fit the window of the remote host */
+    TCP_LIMITED_CWND, /* The next segment doesn't fit the congestion window */
+    TCP_LIMITED_SNDBUF, /* All the data is in flight and a send waits for the send buffer */
+    TCP_LIMITED_APP, /* All the data is in flight and the application doesn't send more */
+    TCP_LIMITED_NR
+};
+
 /* the TCP protocol control block */
 struct tcp_pcb {
     /** IP specific PCB members */
@@ -251,6 +288,11 @@ struct tcp_pcb {
     u32_t rcv_ann_wnd; /* receiver window to announce */
     u32_t rcv_wnd_max; /* maximum available receive window */
     u32_t rcv_wnd_max_desired;
+    /* Receiver RTT estimate in usec, 0 without a sample. A sample is the time to receive
+     * a window of data, which the sender can't deliver faster than a round trip. */
+    u32_t rcv_rtt;
+    u32_t rcv_rtt_seq;
+    u32_t rcv_rtt_time;
 
     void *listen_sock;
     tcp_syn_handled_fn syn_tw_handled_cb;
@@ -269,6 +311,13 @@ struct tcp_pcb {
 #define TF_NAGLEMEMERR                                                                             \
     ((u16_t)0x0080U) /* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
 #define TF_WND_SCALE ((u16_t)0x0100U) /* Window Scale option enabled */
+#define TF_SACK      ((u16_t)0x0200U) /* Selective acknowledgment option enabled */
+#define TF_ECN       ((u16_t)0x0400U) /* ECN capable connection */
+#define TF_ECN_ECHO  ((u16_t)0x0800U) /* Set ECE in the outgoing segments */
+#define TF_ECN_CWR   ((u16_t)0x1000U) /* Set CWR in the next new data segment */
+#define TF_ISS_SET   ((u16_t)0x2000U) /* tcp_connect() keeps the ISS set by tcp_pcb_set_iss() */
+#define TF_ACK_COALESCE ((u16_t)0x4000U) /* The immediate ACK waits for the end of the poll */
+#define TF_CORK         ((u16_t)0x8000U) /* TCP_CORK or MSG_MORE, a partial segment waits */
 
     /* the rest of the fields are in host byte order
        as we have to do some math with them */
@@ -307,6 +356,12 @@ struct tcp_pcb {
 #if TCP_CC_ALGO_MOD
     struct cc_algo *cc_algo;
     void *cc_data;
+
+    /* Delivery rate sampling, maintained when the algorithm consumes rate samples */
+    u32_t delivered; /* Bytes delivered so far */
+    u32_t delivered_time; /* Time of the latest delivery in usec */
+    u32_t first_sent_time; /* Send time of the latest delivered segment in usec */
+    u32_t app_limited; /* Delivered mark ending an app limited period, 0 if none */
 #endif
     u32_t cwnd;
     u32_t ssthresh;
@@ -332,6 +387,10 @@ struct tcp_pcb {
     struct tcp_seg *last_unacked; /* Last element in unacknowledged segments list. */
 #if TCP_QUEUE_OOSEQ
     struct tcp_seg *ooseq; /* Received out of sequence segments. */
+    /* Sequence ordered blocks of contiguous ooseq data, for the lookups and the SACK option */
+    struct tcp_ooseq_block *ooseq_blocks;
+    u32_t ooseq_blocks_cnt;
+    u32_t ooseq_blocks_max;
 #endif /* TCP_QUEUE_OOSEQ */
 
     struct tcp_seg *seg_alloc; /* Available tcp_seg element for use */
@@ -351,6 +410,70 @@ struct tcp_pcb {
     u32_t ts_recent;
 #endif /* LWIP_TCP_TIMESTAMPS */
 
+    u8_t enable_sack_opt;
+    /* Highest right edge of the blocks SACKed by the remote host */
+    u32_t sack_high;
+    /* Holes below it were already retransmitted in the current recovery */
+    u32_t sack_rexmit_high;
+    /* Sequence number of the latest out of sequence segment, reported first */
+    u32_t rcv_sack_recent;
+
+    u8_t enable_ecn_opt;
+    /* The ACK being processed carries the ECN echo */
+    u8_t ecn_ece;
+    /* The congestion window was reduced for the ECN echoes of the data below */
+    u32_t ecn_recover;
+
+    u8_t enable_rack_opt;
+    /* Timer armed by RACK-TLP, TCP_RACK_TMR_*, and its expiration in usec */
+    u8_t rack_tmr;
+    u32_t rack_tmr_expire;
+    /* Send time in usec, end and RTT in usec of the most recently sent delivered segment */
+    u32_t rack_xmit_time;
+    u32_t rack_end_seq;
+    u32_t rack_rtt;
+    /* Minimum and smoothed RTT of the RACK samples in usec, 0 without a sample */
+    u32_t rack_min_rtt;
+    u32_t rack_srtt;
+    /* The losses of the data below were already signaled to the congestion control */
+    u32_t rack_recover;
+    /* A tail loss probe is outstanding until snd_nxt of its transmission is acknowledged */
+    u8_t tlp_outstanding;
+    /* The outstanding probe retransmitted data */
+    u8_t tlp_rexmit;
+    u32_t tlp_high_seq;
+
+    /* Listen pcb: the SYNs are answered with a SYN cookie. Connection pcb: created by a cookie */
+    u8_t syncookies;
+    /* Time in msec of the last SYN cookie sent by a listen pcb, 0 if none */
+    u32_t syncookie_ts;
+
+    /* TCP Fast Open (RFC 7413) state */
+    u8_t fastopen;
+#define TCP_TFO_SERVER   0x01U /* Listen pcb: accept the data of a SYN with a valid cookie */
+#define TCP_TFO_OPT      0x02U /* Send the Fast Open option in the SYN or the SYN|ACK */
+#define TCP_TFO_DATA     0x04U /* The SYN carries a cookie and waits for the first data */
+#define TCP_TFO_ACCEPTED 0x08U /* The connection was accepted with the data of the SYN */
+#define TCP_TFO_COOKIE   0x10U /* The SYN|ACK delivered a new cookie in tfo_cookie */
+    /* Cookie of the Fast Open option, the SYN requests a cookie if the length is 0 */
+    u8_t tfo_cookie_len;
+#define TCP_TFO_COOKIE_LEN_MIN 4U
+#define TCP_TFO_COOKIE_LEN_MAX 8U
+    u8_t tfo_cookie[TCP_TFO_COOKIE_LEN_MAX];
+    /* MSS of the remote host known with the cookie, 0 if unknown */
+    u16_t tfo_mss;
+
+    /* Packetization layer path MTU discovery (RFC 4821), the sizes are MSS values.
+     * The search runs between the largest size known to pass and the largest to try. */
+    u16_t mtup_low; /* 0 if the discovery is off */
+    u16_t mtup_high;
+    u16_t mtup_max; /* Route and peer limit, mtup_high of a new search */
+    u16_t mtup_probe; /* Size of the probe in flight, 0 if none */
+    u8_t mtup_fails; /* Probes of this size lost */
+    u32_t mtup_probe_seq; /* Sequence space of the probe */
+    u32_t mtup_probe_end;
+    u32_t mtup_next_ms; /* sys_now() of the next probe */
+
     /* idle time before KEEPALIVE is sent */
     u32_t keep_idle;
 #if LWIP_TCP_KEEPALIVE
@@ -370,15 +493,45 @@ struct tcp_pcb {
     u8_t rcv_scale;
 
     tcp_syn_handled_fn syn_handled_cb;
+    tcp_syn_cookie_fn syn_cookie_cb;
     tcp_clone_conn_fn clone_conn;
     tcp_accepted_pcb_fn accepted_pcb;
 
     /* Delayed ACK control: number of quick acks */
     u8_t quickack;
+    /* Adaptive delayed ACK, see enable_ack_adaptive_opt: segments left to acknowledge
+     * immediately, request/response pattern detected and the time of the last data received
+     * in usec */
+    u8_t ack_quick;
+    u8_t ack_pingpong;
+    u32_t ack_rcv_time;
+    /* The immediate ACKs of in sequence data may be coalesced, see TF_ACK_COALESCE */
+    u8_t enable_ack_coalesce_opt;
+    /* Quick ACK mode and request/response detection of the delayed ACK */
+    u8_t enable_ack_adaptive_opt;
 
     /* Set to true in a specific section of RX path to avoid tcp_output() */
     u8_t is_in_input;
 
+    /* Software pacing limits tcp_output() to the budget of the connection */
+    u8_t is_paced;
+
+    /* Left out of the timer ticks while none of the timers is armed, see tcp_tmr_idle() */
+    u8_t tmr_parked;
+
+    /* Loss recovery events and the time the sender was limited, for the statistics */
+    struct {
+        u32_t n_rto; /* Retransmission timeouts */
+        u32_t n_recovery; /* Fast recoveries, entered on the dupacks, the SACK scoreboard or RACK */
+        u32_t n_tlp; /* Tail loss probes */
+        u32_t n_spurious_rexmit; /* Retransmissions delivered by the original transmission */
+        u32_t n_zero_wnd; /* Times the remote host closed the window */
+        u8_t sndbuf_full; /* Set by the socket layer while a send waits for the send buffer */
+        u8_t limited; /* enum tcp_limited since limited_since, in usec */
+        u32_t limited_since;
+        u64_t limited_usec[TCP_LIMITED_NR];
+    } stats;
+
     /* TSO description */
     struct {
         /* Maximum length of memory buffer */
@@ -398,6 +551,30 @@ struct tcp_pcb {
 typedef u16_t (*ip_route_mtu_fn)(struct tcp_pcb *pcb);
 void register_ip_route_mtu(ip_route_mtu_fn fn);
 
+/* Path MTU of the destination discovered by the connections, 0 if unknown */
+typedef u16_t (*tcp_path_mtu_fn)(struct tcp_pcb *pcb);
+void register_tcp_path_mtu(tcp_path_mtu_fn fn);
+
+/* Called when a connection discovers the path MTU of its destination */
+typedef void (*tcp_path_mtu_update_fn)(struct tcp_pcb *pcb, u16_t mtu);
+void register_tcp_path_mtu_update(tcp_path_mtu_update_fn fn);
+
+/* Bytes of new data a paced connection is allowed to send now */
+typedef u32_t (*tcp_pacing_budget_fn)(struct tcp_pcb *pcb);
+void register_tcp_pacing_budget(tcp_pacing_budget_fn fn);
+
+/* Called at the end of tcp_output() of a paced connection with the new data sent */
+typedef void (*tcp_pacing_sent_fn)(struct tcp_pcb *pcb, u32_t sent);
+void register_tcp_pacing_sent(tcp_pacing_sent_fn fn);
+
+/* Pacing rate in bytes/second requested by the congestion control, 0 to stop pacing */
+typedef void (*tcp_pacing_rate_fn)(struct tcp_pcb *pcb, u64_t rate);
+void register_tcp_pacing_rate(tcp_pacing_rate_fn fn);
+
+/* Called by tcp_output() of a parked pcb, the timers are about to be armed */
+typedef void (*tcp_tmr_wake_fn)(struct tcp_pcb *pcb);
+void register_tcp_tmr_wake(tcp_tmr_wake_fn fn);
+
 #if defined(__GNUC__) && (((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)) || (__GNUC__ > 4))
 #pragma GCC visibility push(hidden)
 #endif
@@ -410,6 +587,8 @@ void tcp_arg(struct tcp_pcb *pcb, void *arg);
 void tcp_ip_output(struct tcp_pcb *pcb, ip_output_fn ip_output);
 void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
 void tcp_syn_handled(struct tcp_pcb *pcb, tcp_syn_handled_fn syn_handled);
+void tcp_syn_cookie(struct tcp_pcb *pcb, tcp_syn_cookie_fn syn_cookie);
+u16_t tcp_syncookie_synack(const struct tcp_syncookie_req *req, u16_t mtu, void *hdr);
 void tcp_clone_conn(struct tcp_pcb *pcb, tcp_clone_conn_fn clone_conn);
 void tcp_accepted_pcb(struct tcp_pcb *pcb, tcp_accepted_pcb_fn accepted_pcb);
 void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
@@ -450,6 +629,8 @@ err_t tcp_write_express(struct tcp_pcb *pcb, const struct iovec *iov, u32_t iovc
 #define TCP_PRIO_MAX    127
 
 err_t tcp_output(struct tcp_pcb *pcb);
+/* Accounts the time of the previous limit if the sender limit changed, or always with flush */
+void tcp_limited_update(struct tcp_pcb *pcb, u8_t flush);
 
 s32_t tcp_is_wnd_available(struct tcp_pcb *pcb, u32_t data_len);
 
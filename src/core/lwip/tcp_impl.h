@@ -50,6 +50,9 @@ void tcp_tmr(struct tcp_pcb *pcb); /* Must be called every (slow_tmr_interval /
    intervals (instead of calling tcp_tmr()). */
 void tcp_slowtmr(struct tcp_pcb *pcb);
 void tcp_fasttmr(struct tcp_pcb *pcb);
+/* None of the timers but the keepalive is armed, tcp_tmr() would only count the ticks. */
+int tcp_tmr_idle(struct tcp_pcb *pcb);
+u32_t tcp_keepalive_ticks(struct tcp_pcb *pcb);
 
 void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb);
 
@@ -62,9 +65,17 @@ void tcp_tx_pbuf_free(struct tcp_pcb *pcb, struct pbuf *pbuf);
 void tcp_abandon(struct tcp_pcb *pcb, int reset);
 err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_split_segment(struct tcp_pcb *pcb, struct tcp_seg *seg, u32_t wnd);
+void tcp_fastopen_requeue(struct tcp_pcb *pcb, struct tcp_seg *seg, u32_t acked);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+void tcp_rexmit_sack(struct tcp_pcb *pcb);
+void tcp_rack_detect_loss(struct tcp_pcb *pcb, u32_t now);
+void tcp_tlp_arm(struct tcp_pcb *pcb, u32_t now);
+void tcp_rack_tmr(struct tcp_pcb *pcb);
+void tcp_mtup_init(struct tcp_pcb *pcb);
+void tcp_mtup_acked(struct tcp_pcb *pcb);
+void tcp_set_pacing_rate(struct tcp_pcb *pcb, u64_t rate);
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 void set_tmr_resolution(u32_t v);
 
@@ -109,7 +120,7 @@ void set_tmr_resolution(u32_t v);
 #define TCP_ECE                  0x40U
 #define TCP_CWR                  0x80U
 
-#define TCP_FLAGS 0x3fU
+#define TCP_FLAGS 0xffU
 
 /* Length of the TCP header, excluding options. */
 #ifndef TCP_HLEN
@@ -205,6 +216,14 @@ PACK_STRUCT_END
             (ret) = ERR_ARG;                                                                       \
     } while (0)
 
+#define TCP_EVENT_SYN_COOKIE(pcb, p_req, ret)                                                      \
+    do {                                                                                           \
+        if ((pcb)->syn_cookie_cb != NULL)                                                          \
+            (ret) = (pcb)->syn_cookie_cb((pcb)->callback_arg, (pcb), (p_req));                     \
+        else                                                                                       \
+            (ret) = ERR_ARG;                                                                       \
+    } while (0)
+
 #define TCP_EVENT_CLONE_PCB(pcb, p_npcb, ret)                                                      \
     do {                                                                                           \
         if ((pcb)->clone_conn != NULL)                                                             \
@@ -259,6 +278,16 @@ PACK_STRUCT_END
             (errf)((arg), (err));                                                                  \
     } while (0)
 
+#if TCP_QUEUE_OOSEQ
+/* Block of contiguous data on the ooseq queue, from the first to the last segment */
+struct tcp_ooseq_block {
+    u32_t left;
+    u32_t right;
+    struct tcp_seg *first;
+    struct tcp_seg *last;
+};
+#endif /* TCP_QUEUE_OOSEQ */
+
 /* This structure represents a TCP segment on the unsent, unacked and ooseq queues */
 struct tcp_seg {
     struct tcp_seg *next; /* used when putting segments on a queue */
@@ -269,15 +298,37 @@ struct tcp_seg {
     u32_t len; /* the TCP length of this segment should allow >64K size */
 
     u8_t flags;
-#define TF_SEG_OPTS_MSS      (u8_t)0x01U /* Include MSS option. */
-#define TF_SEG_OPTS_TS       (u8_t)0x02U /* Include timestamp option. */
-#define TF_SEG_OPTS_WNDSCALE (u8_t)0x08U /* Include window scaling option */
-#define TF_SEG_OPTS_TSO      (u8_t) TCP_WRITE_TSO /* Use TSO send mode */
-#define TF_SEG_OPTS_NOMERGE  (u8_t)0x40U /* Don't merge with other segments */
-#define TF_SEG_OPTS_ZEROCOPY (u8_t) TCP_WRITE_ZEROCOPY /* Use zerocopy send mode */
+#define TF_SEG_OPTS_MSS       (u8_t)0x01U /* Include MSS option. */
+#define TF_SEG_OPTS_TS        (u8_t)0x02U /* Include timestamp option. */
+#define TF_SEG_OPTS_SACK_PERM (u8_t)0x04U /* Include SACK permitted option */
+#define TF_SEG_OPTS_WNDSCALE  (u8_t)0x08U /* Include window scaling option */
+#define TF_SEG_OPTS_TFO       (u8_t)0x10U /* Include Fast Open option */
+#define TF_SEG_OPTS_TSO       (u8_t) TCP_WRITE_TSO /* Use TSO send mode */
+#define TF_SEG_OPTS_NOMERGE   (u8_t)0x40U /* Don't merge with other segments */
+#define TF_SEG_OPTS_ZEROCOPY  (u8_t) TCP_WRITE_ZEROCOPY /* Use zerocopy send mode */
 
     u8_t tcp_flags; /* Cached TCP flags for outgoing segments */
 
+    u8_t sack_state; /* Scoreboard of an unacknowledged segment */
+#define TF_SEG_SACKED      (u8_t)0x01U /* Reported by a SACK block of the remote host */
+#define TF_SEG_SACK_REXMIT (u8_t)0x02U /* Retransmitted as a hole of the SACK scoreboard */
+#define TF_SEG_RACK_REXMIT (u8_t)0x04U /* Sent more than once, the RTT of the segment is ambiguous */
+
+    u32_t xmit_time; /* Time of the latest transmission in usec, maintained for RACK */
+
+#if TCP_CC_ALGO_MOD
+    /* Delivery state of the connection when the segment was last sent */
+    struct {
+        u32_t delivered;
+        u32_t delivered_time;
+        u32_t first_sent_time;
+        u32_t sent_time;
+        u8_t flags;
+#define TF_SEG_RS_APP_LIMITED (u8_t)0x01U /* Sent in an app limited period */
+#define TF_SEG_RS_REXMIT      (u8_t)0x02U /* Sent more than once */
+    } rs;
+#endif
+
     /* L2+L3+TCP header for zerocopy segments, it must have enough room for options
        This should have enough space for L2 (ETH+vLAN), L3 (IPv4/6), L4 (TCP)
        L2 = 20: (6 for alignment, so IPv4 packet is 4 bytes aligned)
@@ -291,19 +342,30 @@ struct tcp_seg {
 #if LWIP_TCP_TIMESTAMPS
 #define LWIP_TCP_OPT_LEN_TS 12U
 #endif
+/* The Fast Open option is padded to the size with the largest cookie */
+#define LWIP_TCP_OPT_LEN_TFO (4U + TCP_TFO_COOKIE_LEN_MAX)
 
 /* This macro calculates total length of tcp additional options
  * basing on option flags
  */
 #define LWIP_TCP_OPT_LENGTH(flags)                                                                 \
     (flags & TF_SEG_OPTS_MSS ? 4 : 0) + (flags & TF_SEG_OPTS_WNDSCALE ? 1 + 3 : 0) +               \
-        (flags & TF_SEG_OPTS_TS ? 12 : 0)
+        (flags & TF_SEG_OPTS_SACK_PERM ? 2 + 2 : 0) + (flags & TF_SEG_OPTS_TS ? 12 : 0) +           \
+        (flags & TF_SEG_OPTS_TFO ? LWIP_TCP_OPT_LEN_TFO : 0)
 
 /* This macro calculates total length of tcp header including
  * additional options
  */
 #define LWIP_TCP_HDRLEN(_tcphdr) (TCPH_HDRLEN(((struct tcp_hdr *)(_tcphdr))) * 4)
 
+/** This returns a TCP header option for SACK permitted in an u32_t, after two NOOPs */
+#define TCP_BUILD_SACK_PERM_OPTION(x)                                                              \
+    (x) = PP_HTONL(((u32_t)1 << 24) | ((u32_t)1 << 16) | ((u32_t)4 << 8) | (u32_t)2)
+
+/* SACK blocks fitting the option space of an ACK, with and without the timestamp option */
+#define TCP_SACK_MAX_BLOCKS    4U
+#define TCP_SACK_MAX_BLOCKS_TS 3U
+
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(x, mss)                                                               \
     (x) = PP_HTONL(((u32_t)2 << 24) | ((u32_t)4 << 16) | (((u32_t)mss / 256) << 8) | (mss & 255))
@@ -319,8 +381,47 @@ extern int32_t enable_wnd_scale;
 extern u32_t rcv_wnd_scale;
 extern u8_t enable_push_flag;
 extern u8_t enable_ts_option;
+extern u8_t enable_sack_option;
+extern u8_t enable_ecn_option;
+extern u8_t enable_rack_option;
+extern u8_t enable_ack_coalesce_option;
+extern u8_t enable_ack_adaptive_option;
+extern u8_t enable_mtu_probing_option;
+extern u32_t tcp_cookie_secret[4];
 extern u32_t tcp_ticks;
 extern ip_route_mtu_fn external_ip_route_mtu;
+extern sys_now_fn sys_now;
+extern sys_now_us_fn sys_now_us;
+
+/* ECN codepoint of the IP header */
+#define TCP_ECN_MASK 0x03U
+#define TCP_ECN_CE   0x03U
+
+#if TCP_CC_ALGO_MOD
+#define tcp_ecn_wanted(pcb) ((pcb)->enable_ecn_opt || ((pcb)->cc_algo->flags & CC_F_ECN))
+#else
+#define tcp_ecn_wanted(pcb) ((pcb)->enable_ecn_opt)
+#endif
+
+/* The transmission at t1 of the data ending at seq1 happened after the one at t2 ending at seq2 */
+#define tcp_rack_sent_after(t1, seq1, t2, seq2)                                                    \
+    (TCP_SEQ_GT((t1), (t2)) || ((t1) == (t2) && TCP_SEQ_GT((seq1), (seq2))))
+
+/* Timers of RACK-TLP */
+#define TCP_RACK_TMR_REO 1U /* Reordering window of the segments not marked lost yet */
+#define TCP_RACK_TMR_TLP 2U /* Tail loss probe */
+/* Worst case delayed ACK of the remote host, accounted when a single segment is in flight */
+#define TCP_TLP_WCDELACK_US 200000U
+/* Probe timeout without an RTT sample */
+#define TCP_TLP_INIT_PTO_US 1000000U
+
+/* Period of the SYN cookie counter, a cookie is accepted during one to two periods */
+#define TCP_SYNCOOKIE_PERIOD_MS 64000U
+
+#if TCP_CC_ALGO_MOD
+/* Delivery rate sampling is maintained for the algorithms consuming the samples only */
+#define tcp_rate_enabled(pcb) ((pcb)->cc_algo->rate_sample != NULL)
+#endif
 
 #if defined(__GNUC__) && (((__GNUC__ == 4) && (__GNUC_MINOR__ >= 4)) || (__GNUC__ > 4))
 #pragma GCC visibility push(hidden)
@@ -331,6 +432,13 @@ void tcp_pcb_purge(struct tcp_pcb *pcb);
 void tcp_pcb_remove(struct tcp_pcb *pcb);
 
 void tcp_segs_free(struct tcp_pcb *pcb, struct tcp_seg *seg);
+#if TCP_QUEUE_OOSEQ
+void tcp_ooseq_free(struct tcp_pcb *pcb);
+s32_t tcp_ooseq_find(const struct tcp_pcb *pcb, u32_t seqno);
+#define tcp_ooseq_empty(pcb) ((pcb)->ooseq == NULL)
+#else
+#define tcp_ooseq_empty(pcb) 1
+#endif /* TCP_QUEUE_OOSEQ */
 void tcp_seg_free(struct tcp_pcb *pcb, struct tcp_seg *seg);
 void tcp_tx_segs_free(struct tcp_pcb *pcb, struct tcp_seg *seg);
 void tcp_tx_seg_free(struct tcp_pcb *pcb, struct tcp_seg *seg);
@@ -349,20 +457,40 @@ struct tcp_seg *tcp_seg_copy(struct tcp_pcb *pcb, struct tcp_seg *seg);
 #define tcp_ack_now(pcb)                                                                           \
     do {                                                                                           \
         (pcb)->flags |= TF_ACK_NOW;                                                                \
+        (pcb)->flags &= ~TF_ACK_COALESCE;                                                          \
     } while (0)
 
+/* Most ACKs sent immediately in the quick ACK mode */
+#define TCP_ACK_QUICK_MAX 16U
+/* Receive idle time to enter the quick ACK mode again, in usec */
+#define TCP_ACK_QUICK_IDLE_US 200000U
+/* Data sent within this time after data is received is a response, in usec */
+#define TCP_ACK_ATO_US 40000U
+
+/* Data sent shortly after data is received: request/response pattern, the ACKs are delayed
+ * to be piggybacked on the responses. */
+static inline void tcp_ack_data_sent(struct tcp_pcb *pcb)
+{
+    if (!pcb->ack_pingpong && pcb->ack_rcv_time &&
+        sys_now_us() - pcb->ack_rcv_time < TCP_ACK_ATO_US) {
+        pcb->ack_pingpong = 1;
+    }
+}
+
 err_t tcp_send_fin(struct tcp_pcb *pcb);
 err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags);
 
 void tcp_rst(u32_t seqno, u32_t ackno, u16_t local_port, u16_t remote_port, struct tcp_pcb *pcb);
 
 u32_t tcp_next_iss(void);
+void tcp_pcb_set_iss(struct tcp_pcb *pcb, u32_t iss);
 
 void tcp_keepalive(struct tcp_pcb *pcb);
 void tcp_zero_window_probe(struct tcp_pcb *pcb);
 
 u16_t tcp_initial_mss(struct tcp_pcb *pcb);
 u16_t tcp_send_mss(struct tcp_pcb *pcb);
+u16_t tcp_mtu_to_mss(u16_t mtu, bool is_ipv6);
 
 err_t tcp_recv_null(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
 
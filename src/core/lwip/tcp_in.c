@@ -47,10 +47,12 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 typedef struct parsed_ip_hdr {
     bool is_ipv6;
+    u8_t ecn;
     s16_t header_length;
     u16_t total_length;
     const void *src, *dest;
@@ -66,16 +68,28 @@ typedef struct tcp_in_data {
     u16_t tcplen;
     u8_t flags;
     u8_t recv_flags;
+    u8_t sack_cnt;
+    u32_t sack_blocks[2 * TCP_SACK_MAX_BLOCKS]; /* SACK option edges in host byte order */
+    const u8_t *tfo_cookie; /* Fast Open option of a SYN, NULL if none */
+    u8_t tfo_cookie_len;
     struct tcp_seg inseg;
 } tcp_in_data;
 
+/* RACK state of the ACK being processed */
+struct tcp_rack_ack {
+    u32_t now;
+    u8_t sampled; /* A delivered segment updated the RACK state */
+};
+
 /* Forward declarations. */
 static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data);
 static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data);
 static bool tcp_parseopt_ts(u8_t *opts, u16_t opts_len, u32_t *tsval);
+static u16_t tcp_parseopt_mss(u8_t *opts, u16_t opts_len);
 static void tcp_parseopt(struct tcp_pcb *pcb, tcp_in_data *in_data);
 
 static void tcp_listen_input(struct tcp_pcb *pcb, tcp_in_data *in_data);
+static struct tcp_pcb *tcp_syncookie_input(struct tcp_pcb *pcb, tcp_in_data *in_data);
 static err_t tcp_timewait_input(struct tcp_pcb *pcb, tcp_in_data *in_data);
 static s8_t tcp_quickack(struct tcp_pcb *pcb, tcp_in_data *in_data);
 
@@ -101,11 +115,13 @@ static inline void fill_parsed_ip_hdr(const void *payload, parsed_ip_hdr_t *iphd
 
     iphdr->is_ipv6 = (view_8bit[0] >> 4U) == XLIO_IPV6_VERSION;
     if (iphdr->is_ipv6) {
+        iphdr->ecn = (view_8bit[1] >> 4U) & TCP_ECN_MASK;
         iphdr->src = (void *)&view_8bit[8];
         iphdr->dest = (void *)&view_8bit[24];
         iphdr->header_length = 40;
         iphdr->total_length = ntohs(view_16bit[2U]) + iphdr->header_length;
     } else {
+        iphdr->ecn = view_8bit[1] & TCP_ECN_MASK;
         iphdr->src = (const void *)&view_8bit[12];
         iphdr->dest = (const void *)&view_8bit[16];
         iphdr->header_length = ((view_8bit[0] & 0x0f) * 4);
@@ -115,6 +131,8 @@ static inline void fill_parsed_ip_hdr(const void *payload, parsed_ip_hdr_t *iphd
 
 void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
 {
+    struct tcp_pcb *listen_pcb = NULL;
+    struct tcp_pcb *npcb = NULL;
     u8_t hdrlen;
     err_t err;
     tcp_in_data in_data;
@@ -157,9 +175,20 @@ void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
 
     in_data.flags = TCPH_FLAGS(in_data.tcphdr);
     in_data.tcplen = p->tot_len + ((in_data.flags & (TCP_FIN | TCP_SYN)) ? 1 : 0);
+    in_data.sack_cnt = 0;
+    in_data.tfo_cookie = NULL;
 
     if (pcb != NULL) {
 
+        if (PCB_IN_LISTEN_STATE(pcb) && pcb->syncookie_ts) {
+            /* The ACK of a SYN cookie creates the connection */
+            npcb = tcp_syncookie_input(pcb, &in_data);
+            if (npcb != NULL) {
+                listen_pcb = pcb;
+                pcb = npcb;
+            }
+        }
+
         if (PCB_IN_ACTIVE_STATE(pcb)) {
 /* The incoming segment belongs to a connection. */
 #if TCP_INPUT_DEBUG
@@ -247,8 +276,11 @@ void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
                     }
 
                     pcb->is_in_input = 0;
-                    /* Try to send something out. */
-                    tcp_output(pcb);
+                    /* Try to send something out. A coalesced ACK alone waits for the end of
+                     * the poll, where a single cumulative ACK covers the segments of the poll. */
+                    if (!(pcb->flags & TF_ACK_COALESCE) || pcb->unsent) {
+                        tcp_output(pcb);
+                    }
                 }
             }
             /* Jump target if pcb has been aborted in a callback (by calling tcp_abort()).
@@ -266,8 +298,13 @@ void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
             }
         } else if (PCB_IN_LISTEN_STATE(pcb)) {
             LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
+            /* tcp_listen_input() sets in_data.inseg.p to NULL if the data of a Fast Open
+               SYN is delivered */
+            in_data.inseg.p = p;
             tcp_listen_input(pcb, &in_data);
-            pbuf_free(p);
+            if (in_data.inseg.p != NULL) {
+                pbuf_free(in_data.inseg.p);
+            }
         } else if (PCB_IN_TIME_WAIT_STATE(pcb)) {
             LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for TIME_WAITing connection.\n"));
             tcp_timewait_input(pcb, &in_data);
@@ -276,6 +313,9 @@ void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
             LWIP_DEBUGF(TCP_RST_DEBUG, ("tcp_input: illegal get_tcp_state(pcb).\n"));
             pbuf_free(p);
         }
+        if (listen_pcb != NULL) {
+            TCP_EVENT_ACCEPTED_PCB(listen_pcb, npcb);
+        }
     } else {
 
         /* If no matching PCB was found, send a TCP RST (reset) to the
@@ -289,6 +329,345 @@ void L3_level_tcp_input(struct pbuf *p, struct tcp_pcb *pcb)
     }
 }
 
+/* MSS values encoded in the low bits of a SYN cookie */
+static const u16_t tcp_syncookie_mss[] = {536, 1200, 1300, 1380, 1440, 1460, 4312, 8960};
+#define TCP_SYNCOOKIE_MSS_MASK 0x7U
+
+#define TCP_SIP_ROTL(x, b) (((x) << (b)) | ((x) >> (64U - (b))))
+#define TCP_SIP_ROUND(v0, v1, v2, v3)                                                              \
+    do {                                                                                           \
+        (v0) += (v1);                                                                              \
+        (v1) = TCP_SIP_ROTL(v1, 13U) ^ (v0);                                                       \
+        (v0) = TCP_SIP_ROTL(v0, 32U);                                                              \
+        (v2) += (v3);                                                                              \
+        (v3) = TCP_SIP_ROTL(v3, 16U) ^ (v2);                                                       \
+        (v0) += (v3);                                                                              \
+        (v3) = TCP_SIP_ROTL(v3, 21U) ^ (v0);                                                       \
+        (v2) += (v1);                                                                              \
+        (v1) = TCP_SIP_ROTL(v1, 17U) ^ (v2);                                                       \
+        (v2) = TCP_SIP_ROTL(v2, 32U);                                                              \
+    } while (0)
+
+/**
+ * SipHash-2-4 keyed by tcp_cookie_secret of n 64 bit words.
+ */
+static u64_t tcp_siphash(const u64_t *m, u32_t n)
+{
+    u64_t k0 = ((u64_t)tcp_cookie_secret[1] << 32) | tcp_cookie_secret[0];
+    u64_t k1 = ((u64_t)tcp_cookie_secret[3] << 32) | tcp_cookie_secret[2];
+    u64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    u64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    u64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    u64_t v3 = k1 ^ 0x7465646279746573ULL;
+    u64_t b;
+    u32_t i;
+
+    for (i = 0; i < n; ++i) {
+        v3 ^= m[i];
+        TCP_SIP_ROUND(v0, v1, v2, v3);
+        TCP_SIP_ROUND(v0, v1, v2, v3);
+        v0 ^= m[i];
+    }
+    b = (u64_t)(n * 8U) << 56;
+    v3 ^= b;
+    TCP_SIP_ROUND(v0, v1, v2, v3);
+    TCP_SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    for (i = 0; i < 4; ++i) {
+        TCP_SIP_ROUND(v0, v1, v2, v3);
+    }
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/**
+ * Copies the remote (src) and the local (dest) addresses to m and returns the number
+ * of words used.
+ */
+static u32_t tcp_hash_addrs(const void *src, const void *dest, u8_t is_ipv6, u64_t *m)
+{
+    if (is_ipv6) {
+        memcpy(&m[0], src, 16);
+        memcpy(&m[2], dest, 16);
+        return 4;
+    }
+    m[0] = 0;
+    memcpy(&m[0], src, 4);
+    memcpy((u8_t *)&m[0] + 4, dest, 4);
+    return 1;
+}
+
+/**
+ * Hash of the 4-tuple of a connection, the initial sequence number of the remote host
+ * and the cookie counter.
+ */
+static u32_t tcp_syncookie_hash(const void *src, const void *dest, u8_t is_ipv6, u16_t sport,
+                                u16_t dport, u32_t irs, u32_t count)
+{
+    u64_t m[6];
+    u64_t h;
+    u32_t n = tcp_hash_addrs(src, dest, is_ipv6, m);
+
+    m[n++] = ((u64_t)sport << 48) | ((u64_t)dport << 32) | irs;
+    m[n++] = count;
+    h = tcp_siphash(m, n);
+
+    return (u32_t)(h ^ (h >> 32));
+}
+
+/**
+ * Fast Open cookie of the client address of the SYN. The server address is hashed too,
+ * so a cookie is valid for the address it was requested from only.
+ */
+static void tcp_fastopen_cookie(tcp_in_data *in_data, u8_t *cookie)
+{
+    u64_t m[4];
+    u64_t h = tcp_siphash(
+        m, tcp_hash_addrs(in_data->iphdr.src, in_data->iphdr.dest, in_data->iphdr.is_ipv6, m));
+
+    memcpy(cookie, &h, TCP_TFO_COOKIE_LEN_MAX);
+}
+
+/**
+ * Returns the index of the largest encoded MSS which does not exceed mss.
+ */
+static u32_t tcp_syncookie_idx(u16_t mss)
+{
+    u32_t idx = TCP_SYNCOOKIE_MSS_MASK;
+
+    while (idx > 0 && tcp_syncookie_mss[idx] > mss) {
+        --idx;
+    }
+    return idx;
+}
+
+/**
+ * Returns the SYN cookie of the connection acknowledged by a segment: the hash of the
+ * connection with the MSS index in the low bits.
+ */
+static u32_t tcp_syncookie_make(tcp_in_data *in_data, u32_t idx, u32_t count)
+{
+    u32_t h = tcp_syncookie_hash(in_data->iphdr.src, in_data->iphdr.dest, in_data->iphdr.is_ipv6,
+                                 in_data->tcphdr->src, in_data->tcphdr->dest, in_data->seqno - 1,
+                                 count);
+
+    return (h & ~TCP_SYNCOOKIE_MSS_MASK) | idx;
+}
+
+/**
+ * Validates the SYN cookie acknowledged by a segment.
+ *
+ * @return the MSS encoded in the cookie, 0 if the cookie is not valid
+ */
+static u16_t tcp_syncookie_check(tcp_in_data *in_data)
+{
+    u32_t cookie = in_data->ackno - 1;
+    u32_t idx = cookie & TCP_SYNCOOKIE_MSS_MASK;
+    u32_t count = sys_now() / TCP_SYNCOOKIE_PERIOD_MS;
+
+    /* The cookies of the current and the previous periods are accepted */
+    if (tcp_syncookie_make(in_data, idx, count) == cookie ||
+        tcp_syncookie_make(in_data, idx, count - 1) == cookie) {
+        return tcp_syncookie_mss[idx];
+    }
+    return 0;
+}
+
+/**
+ * Builds the <SYN,ACK> which answers a SYN with a SYN cookie. The MSS option is
+ * computed from the route mtu and the cookie encodes the MSS of the connection.
+ *
+ * @param req the connection requested by the SYN
+ * @param mtu the route mtu, 0 if not known
+ * @param hdr buffer for the TCP header and the MSS option, TCP_HLEN + 4 bytes
+ * @return the length of the header written to hdr
+ */
+u16_t tcp_syncookie_synack(const struct tcp_syncookie_req *req, u16_t mtu, void *hdr)
+{
+    struct tcp_hdr *tcphdr = (struct tcp_hdr *)hdr;
+    u32_t *opts = (u32_t *)(void *)(tcphdr + 1);
+    u16_t advtsd_mss = tcp_mtu_to_mss(mtu, req->is_ipv6);
+    /* RFC 1122: the default MSS of a peer without the option */
+    u16_t mss = LWIP_MIN(req->peer_mss ? req->peer_mss : 536U, advtsd_mss);
+    u32_t h = tcp_syncookie_hash(&req->remote_ip, &req->local_ip, req->is_ipv6, req->remote_port,
+                                 req->local_port, req->irs, sys_now() / TCP_SYNCOOKIE_PERIOD_MS);
+    u32_t idx = tcp_syncookie_idx(mss);
+
+    tcphdr->src = htons(req->local_port);
+    tcphdr->dest = htons(req->remote_port);
+    tcphdr->seqno = htonl((h & ~TCP_SYNCOOKIE_MSS_MASK) | idx);
+    tcphdr->ackno = htonl(req->irs + 1);
+    TCPH_HDRLEN_FLAGS_SET(tcphdr, (TCP_HLEN + 4) / 4, TCP_SYN | TCP_ACK);
+    tcphdr->wnd = htons(LWIP_MIN(TCP_WND, 0xFFFFU));
+    tcphdr->chksum = 0;
+    tcphdr->urgp = 0;
+    TCP_BUILD_MSS_OPTION(*opts, advtsd_mss);
+
+    return TCP_HLEN + 4;
+}
+
+/**
+ * Sets up a pcb cloned by a listen pcb for the connection requested by a SYN.
+ *
+ * @param pcb the listen pcb
+ * @param npcb the new pcb
+ * @param irs the initial sequence number of the remote host
+ * @param syncookie the connection is kept in a SYN cookie, which encodes the MSS only,
+ *        so the other options are not negotiated
+ */
+static void tcp_listen_pcb_setup(struct tcp_pcb *pcb, struct tcp_pcb *npcb, tcp_in_data *in_data,
+                                 u32_t irs, u8_t syncookie)
+{
+    npcb->is_ipv6 = in_data->iphdr.is_ipv6;
+    ip_addr_from_raw(&npcb->local_ip, in_data->iphdr.dest, in_data->iphdr.is_ipv6);
+    npcb->local_port = pcb->local_port;
+    ip_addr_from_raw(&npcb->remote_ip, in_data->iphdr.src, in_data->iphdr.is_ipv6);
+    npcb->remote_port = in_data->tcphdr->src;
+    set_tcp_state(npcb, SYN_RCVD);
+    npcb->rcv_nxt = irs + 1;
+    npcb->rcv_ann_right_edge = npcb->rcv_nxt;
+    npcb->snd_wl1 = irs - 1; /* initialise to seqno-1 to force window update */
+    npcb->callback_arg = pcb->callback_arg;
+    npcb->accept = pcb->accept;
+    /* inherit socket options */
+    npcb->so_options = pcb->so_options & SOF_INHERITED;
+
+    npcb->snd_scale = 0;
+    npcb->rcv_scale = 0;
+
+    /* calculate advtsd_mss before parsing MSS option such that the resulting mss will take into
+     * account the updated advertized MSS */
+    npcb->advtsd_mss = tcp_send_mss(npcb);
+
+    /* Parse any options in the SYN. */
+    tcp_parseopt(npcb, in_data);
+
+    if (syncookie) {
+        npcb->syncookies = 1;
+        npcb->flags &= ~(TF_WND_SCALE | TF_SACK | TF_TIMESTAMP);
+        npcb->snd_scale = 0;
+        npcb->rcv_scale = 0;
+    } else if ((in_data->flags & (TCP_ECE | TCP_CWR)) == (TCP_ECE | TCP_CWR) &&
+               tcp_ecn_wanted(npcb)) {
+        /* ECN setup SYN, the SYN|ACK confirms it */
+        npcb->flags |= TF_ECN;
+    }
+
+    npcb->rcv_wnd = TCP_WND_SCALED(npcb);
+    npcb->rcv_ann_wnd = TCP_WND_SCALED(npcb);
+    npcb->rcv_wnd_max = TCP_WND_SCALED(npcb);
+    npcb->rcv_wnd_max_desired = TCP_WND_SCALED(npcb);
+
+    npcb->snd_wnd = SND_WND_SCALE(npcb, in_data->tcphdr->wnd);
+    npcb->snd_wnd_max = npcb->snd_wnd;
+    npcb->ssthresh = npcb->snd_wnd;
+#if TCP_CALCULATE_EFF_SEND_MSS
+    // mss can be changed by tcp_parseopt, need to take the MIN
+    npcb->mss = LWIP_MIN(npcb->mss, npcb->advtsd_mss);
+#endif /* TCP_CALCULATE_EFF_SEND_MSS */
+}
+
+/**
+ * Called by L3_level_tcp_input() when an ACK arrives for a listening connection which
+ * recently answered SYNs with SYN cookies. If the ACK carries a valid cookie, the
+ * connection is created in the SYN_RCVD state and L3_level_tcp_input() processes the
+ * segment for it.
+ *
+ * @param pcb the listen tcp_pcb for which a segment arrived
+ * @return The new pcb if there is one. Otherwise, NULL.
+ */
+static struct tcp_pcb *tcp_syncookie_input(struct tcp_pcb *pcb, tcp_in_data *in_data)
+{
+    struct tcp_pcb *npcb = NULL;
+    u16_t mss;
+    err_t rc;
+
+    if ((in_data->flags & (TCP_SYN | TCP_RST | TCP_FIN | TCP_ACK)) != TCP_ACK ||
+        pcb->syncookie_ts == 0 ||
+        (u32_t)(sys_now() - pcb->syncookie_ts) >= 2U * TCP_SYNCOOKIE_PERIOD_MS) {
+        return NULL;
+    }
+    mss = tcp_syncookie_check(in_data);
+    if (mss == 0) {
+        return NULL;
+    }
+
+    TCP_EVENT_CLONE_PCB(pcb, &npcb, rc);
+    if (npcb == NULL) {
+        LWIP_DEBUGF(TCP_DEBUG, ("tcp_syncookie_input: could not allocate PCB\n"));
+        return NULL;
+    }
+
+    tcp_listen_pcb_setup(pcb, npcb, in_data, in_data->seqno - 1, 1);
+    npcb->mss = LWIP_MIN(mss, npcb->advtsd_mss);
+    /* The SYN|ACK was sent by the cookie */
+    tcp_pcb_set_iss(npcb, in_data->ackno - 1);
+    npcb->snd_nxt = in_data->ackno;
+    npcb->snd_lbb = in_data->ackno;
+
+    TCP_EVENT_SYN_RECEIVED(pcb, npcb, rc);
+    if (rc != ERR_OK) {
+        return NULL;
+    }
+    return npcb;
+}
+
+/**
+ * Checks the Fast Open option of a SYN for a listening connection. The data of a SYN
+ * with a valid cookie is accepted if it fits the window, otherwise the SYN|ACK
+ * delivers the cookie of the client.
+ */
+static void tcp_fastopen_input(struct tcp_pcb *npcb, tcp_in_data *in_data)
+{
+    u8_t cookie[TCP_TFO_COOKIE_LEN_MAX];
+    u32_t datalen = in_data->inseg.p->tot_len;
+
+    tcp_fastopen_cookie(in_data, cookie);
+    if (in_data->tfo_cookie_len != TCP_TFO_COOKIE_LEN_MAX ||
+        memcmp(in_data->tfo_cookie, cookie, TCP_TFO_COOKIE_LEN_MAX) != 0) {
+        memcpy(npcb->tfo_cookie, cookie, TCP_TFO_COOKIE_LEN_MAX);
+        npcb->tfo_cookie_len = TCP_TFO_COOKIE_LEN_MAX;
+        npcb->fastopen |= TCP_TFO_OPT;
+        return;
+    }
+    if (datalen > 0 && datalen <= npcb->rcv_wnd) {
+        npcb->rcv_nxt += datalen;
+        npcb->rcv_ann_right_edge = npcb->rcv_nxt;
+        npcb->rcv_wnd -= datalen;
+        npcb->rcv_ann_wnd = npcb->rcv_wnd;
+        npcb->fastopen |= TCP_TFO_ACCEPTED;
+    }
+}
+
+/**
+ * Accepts a connection in SYN_RCVD and delivers the data of its Fast Open SYN
+ * before the handshake completes (RFC 7413 4.2.2).
+ */
+static void tcp_fastopen_accept(struct tcp_pcb *npcb, tcp_in_data *in_data)
+{
+    struct pbuf *p = in_data->inseg.p;
+    err_t err;
+
+    TCP_EVENT_ACCEPT(npcb, ERR_OK, err);
+    if (err != ERR_OK) {
+        if (err != ERR_ABRT) {
+            tcp_abort(npcb);
+        }
+        return;
+    }
+    if (in_data->flags & TCP_PSH) {
+        p->flags |= PBUF_FLAG_PUSH;
+    }
+    TCP_EVENT_RECV(npcb, p, ERR_OK, err);
+    if (err == ERR_OK || err == ERR_ABRT) {
+        in_data->inseg.p = NULL;
+    } else {
+        /* The upper layer can't receive this data, drop it */
+        npcb->rcv_wnd += p->tot_len;
+    }
+}
+
 /**
  * Called by L3_level_tcp_input() when a segment arrives for a listening
  * connection (from L3_level_tcp_input()).
@@ -322,6 +701,24 @@ static void tcp_listen_input(struct tcp_pcb *pcb, tcp_in_data *in_data)
                     ("TCP connection request %" U16_F " -> %" U16_F ".\n", in_data->tcphdr->src,
                      in_data->tcphdr->dest));
 
+        if (pcb->syncookies) {
+            /* The connection is encoded in the ISN of the <SYN,ACK>, no PCB is created
+               until the ACK returns a valid cookie. */
+            struct tcp_syncookie_req req;
+
+            req.is_ipv6 = in_data->iphdr.is_ipv6;
+            ip_addr_from_raw(&req.local_ip, in_data->iphdr.dest, req.is_ipv6);
+            ip_addr_from_raw(&req.remote_ip, in_data->iphdr.src, req.is_ipv6);
+            req.local_port = pcb->local_port;
+            req.remote_port = in_data->tcphdr->src;
+            req.irs = in_data->seqno;
+            req.peer_mss = tcp_parseopt_mss((u8_t *)in_data->tcphdr + TCP_HLEN,
+                                            (TCPH_HDRLEN(in_data->tcphdr) - 5) << 2);
+            pcb->syncookie_ts = sys_now() | 1U;
+            TCP_EVENT_SYN_COOKIE(pcb, &req, rc);
+            return;
+        }
+
         TCP_EVENT_CLONE_PCB(pcb, &npcb, rc);
 
         /* If a new PCB could not be created (probably due to lack of memory),
@@ -332,43 +729,7 @@ static void tcp_listen_input(struct tcp_pcb *pcb, tcp_in_data *in_data)
             return;
         }
 
-        /* Set up the new PCB. */
-        npcb->is_ipv6 = in_data->iphdr.is_ipv6;
-        ip_addr_from_raw(&npcb->local_ip, in_data->iphdr.dest, in_data->iphdr.is_ipv6);
-        npcb->local_port = pcb->local_port;
-        ip_addr_from_raw(&npcb->remote_ip, in_data->iphdr.src, in_data->iphdr.is_ipv6);
-        npcb->remote_port = in_data->tcphdr->src;
-        set_tcp_state(npcb, SYN_RCVD);
-        npcb->rcv_nxt = in_data->seqno + 1;
-        npcb->rcv_ann_right_edge = npcb->rcv_nxt;
-        npcb->snd_wl1 = in_data->seqno - 1; /* initialise to seqno-1 to force window update */
-        npcb->callback_arg = pcb->callback_arg;
-        npcb->accept = pcb->accept;
-        /* inherit socket options */
-        npcb->so_options = pcb->so_options & SOF_INHERITED;
-
-        npcb->snd_scale = 0;
-        npcb->rcv_scale = 0;
-
-        /* calculate advtsd_mss before parsing MSS option such that the resulting mss will take into
-         * account the updated advertized MSS */
-        npcb->advtsd_mss = tcp_send_mss(npcb);
-
-        /* Parse any options in the SYN. */
-        tcp_parseopt(npcb, in_data);
-
-        npcb->rcv_wnd = TCP_WND_SCALED(npcb);
-        npcb->rcv_ann_wnd = TCP_WND_SCALED(npcb);
-        npcb->rcv_wnd_max = TCP_WND_SCALED(npcb);
-        npcb->rcv_wnd_max_desired = TCP_WND_SCALED(npcb);
-
-        npcb->snd_wnd = SND_WND_SCALE(npcb, in_data->tcphdr->wnd);
-        npcb->snd_wnd_max = npcb->snd_wnd;
-        npcb->ssthresh = npcb->snd_wnd;
-#if TCP_CALCULATE_EFF_SEND_MSS
-        // mss can be changed by tcp_parseopt, need to take the MIN
-        npcb->mss = LWIP_MIN(npcb->mss, npcb->advtsd_mss);
-#endif /* TCP_CALCULATE_EFF_SEND_MSS */
+        tcp_listen_pcb_setup(pcb, npcb, in_data, in_data->seqno, 0);
 
         /* Register the new PCB so that we can begin sending segments
          for it. */
@@ -376,10 +737,16 @@ static void tcp_listen_input(struct tcp_pcb *pcb, tcp_in_data *in_data)
         if (rc != ERR_OK) {
             return;
         }
+        if ((pcb->fastopen & TCP_TFO_SERVER) && in_data->tfo_cookie) {
+            tcp_fastopen_input(npcb, in_data);
+        }
 
         /* Send a SYN|ACK together with the MSS option. */
         if (ERR_OK == tcp_enqueue_flags(npcb, TCP_SYN | TCP_ACK)) {
             tcp_output(npcb);
+            if (npcb->fastopen & TCP_TFO_ACCEPTED) {
+                tcp_fastopen_accept(npcb, in_data);
+            }
         } else {
             tcp_abandon(npcb, 0);
         }
@@ -562,9 +929,11 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
         LWIP_DEBUGF(TCP_INPUT_DEBUG,
                     ("SYN-SENT: ackno %" U32_F " pcb->snd_nxt %" U32_F " unacked %" U32_F "\n",
                      in_data->ackno, pcb->snd_nxt, ntohl(pcb->unacked->tcphdr->seqno)));
-        /* received SYN ACK with expected sequence number? */
+        /* received SYN ACK with expected sequence number? The data of a Fast Open SYN
+         * may be acknowledged partially or not at all. */
         if ((in_data->flags & TCP_ACK) && (in_data->flags & TCP_SYN) &&
-            in_data->ackno == pcb->unacked->seqno + 1) {
+            TCP_SEQ_BETWEEN(in_data->ackno, pcb->unacked->seqno + 1,
+                            pcb->unacked->seqno + 1 + pcb->unacked->len)) {
             pcb->rcv_nxt = in_data->seqno + 1;
             pcb->rcv_ann_right_edge = pcb->rcv_nxt;
             pcb->lastack = in_data->ackno;
@@ -572,6 +941,18 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 pcb, in_data->tcphdr->wnd); // Which means: tcphdr->wnd << pcb->snd_scale;
             pcb->snd_wnd_max = pcb->snd_wnd;
             pcb->snd_wl1 = in_data->seqno - 1; /* initialise to seqno - 1 to force window update */
+            if ((in_data->flags & (TCP_ECE | TCP_CWR)) == TCP_ECE && tcp_ecn_wanted(pcb)) {
+                /* ECN setup SYN|ACK */
+                pcb->flags |= TF_ECN;
+            }
+            if ((pcb->fastopen & TCP_TFO_OPT) && in_data->tfo_cookie &&
+                in_data->tfo_cookie_len >= TCP_TFO_COOKIE_LEN_MIN &&
+                in_data->tfo_cookie_len <= TCP_TFO_COOKIE_LEN_MAX) {
+                /* The cookie for the next connections to the server */
+                memcpy(pcb->tfo_cookie, in_data->tfo_cookie, in_data->tfo_cookie_len);
+                pcb->tfo_cookie_len = in_data->tfo_cookie_len;
+                pcb->fastopen |= TCP_TFO_COOKIE;
+            }
             set_tcp_state(pcb, ESTABLISHED);
 
 #if TCP_CALCULATE_EFF_SEND_MSS
@@ -587,6 +968,7 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
 #else
             pcb->cwnd = ((pcb->cwnd == 1) ? (pcb->mss * 2) : pcb->mss);
 #endif
+            tcp_mtup_init(pcb);
             rseg = pcb->unacked;
             pcb->unacked = rseg->next;
 
@@ -602,7 +984,13 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 pcb->nrtx = 0;
             }
 
-            tcp_tx_seg_free(pcb, rseg);
+            pcb->acked = in_data->ackno - rseg->seqno - 1;
+            if (pcb->acked != rseg->len) {
+                /* The server didn't accept all the data of the SYN */
+                tcp_fastopen_requeue(pcb, rseg, pcb->acked);
+            } else {
+                tcp_tx_seg_free(pcb, rseg);
+            }
 
             /* Call the user specified function to call when sucessfully
              * connected. */
@@ -629,8 +1017,11 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
                             ("TCP connection established %" U16_F " -> %" U16_F ".\n",
                              in_data->inseg.tcphdr->src, in_data->inseg.tcphdr->dest));
                 LWIP_ASSERT("pcb->accept != NULL", pcb->accept != NULL);
-                /* Call the accept function. */
-                TCP_EVENT_ACCEPT(pcb, ERR_OK, err);
+                /* Call the accept function, unless the Fast Open SYN was accepted. */
+                err = ERR_OK;
+                if (!(pcb->fastopen & TCP_TFO_ACCEPTED)) {
+                    TCP_EVENT_ACCEPT(pcb, ERR_OK, err);
+                }
                 if (err != ERR_OK) {
                     /* If the accept function returns with an error, we abort
                      * the connection. */
@@ -655,6 +1046,7 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
 #else
                 pcb->cwnd = ((old_cwnd == 1) ? (pcb->mss * 2) : pcb->mss);
 #endif
+                tcp_mtup_init(pcb);
                 if (in_data->recv_flags & TF_GOT_FIN) {
                     tcp_ack_now(pcb);
                     set_tcp_state(pcb, CLOSE_WAIT);
@@ -664,7 +1056,9 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 tcp_rst(in_data->ackno, in_data->seqno + in_data->tcplen, in_data->tcphdr->dest,
                         in_data->tcphdr->src, pcb);
             }
-        } else if ((in_data->flags & TCP_SYN) && (in_data->seqno == pcb->rcv_nxt - 1)) {
+        } else if ((in_data->flags & TCP_SYN) &&
+                   ((pcb->fastopen & TCP_TFO_ACCEPTED) ? TCP_SEQ_LT(in_data->seqno, pcb->rcv_nxt)
+                                                        : in_data->seqno == pcb->rcv_nxt - 1)) {
             /* Looks like another copy of the SYN - retransmit our SYN-ACK */
             tcp_rexmit(pcb);
         }
@@ -734,41 +1128,205 @@ static err_t tcp_process(struct tcp_pcb *pcb, tcp_in_data *in_data)
     return ERR_OK;
 }
 
+/**
+ * Drops the first bytes of the data of a received segment. The payload pointer
+ * of the pbufs is moved, the first pbuf keeps holding the TCP header.
+ *
+ * @param seg the received segment
+ * @param off number of bytes to drop
+ */
+static void tcp_seg_trim_head(struct tcp_seg *seg, u32_t off)
+{
+    struct pbuf *p = seg->p;
+
+    LWIP_ASSERT("inseg.p != NULL", p);
+    seg->len -= off;
+    if (p->len < off) {
+        u32_t new_tot_len;
+
+        LWIP_ASSERT("pbuf too short!", (((s32_t)p->tot_len) >= off));
+        new_tot_len = p->tot_len - off;
+        while (p->len < off) {
+            off -= p->len;
+            p->tot_len = new_tot_len;
+            p->len = 0;
+            p = p->next;
+        }
+    }
+    if (pbuf_header(p, -off)) {
+        /* Do we need to cope with this failing?  Assert for now */
+        LWIP_ASSERT("pbuf_header failed", 0);
+    }
+}
+
 #if TCP_QUEUE_OOSEQ
+/* Initial capacity of the ooseq blocks array */
+#define TCP_OOSEQ_BLOCKS_INIT 8U
+
+/* Trims the end of a received segment to len bytes of data, the FIN is dropped */
+static void tcp_ooseq_trim(struct tcp_seg *seg, u32_t len)
+{
+    if (TCPH_FLAGS(seg->tcphdr) & TCP_FIN) {
+        TCPH_FLAGS_SET(seg->tcphdr, TCPH_FLAGS(seg->tcphdr) & ~TCP_FIN);
+    }
+    seg->len = len;
+    pbuf_realloc(seg->p, seg->len);
+}
+
+static int tcp_ooseq_block_insert(struct tcp_pcb *pcb, u32_t idx)
+{
+    if (pcb->ooseq_blocks_cnt == pcb->ooseq_blocks_max) {
+        u32_t max = pcb->ooseq_blocks_max ? 2U * pcb->ooseq_blocks_max : TCP_OOSEQ_BLOCKS_INIT;
+        struct tcp_ooseq_block *blocks =
+            (struct tcp_ooseq_block *)realloc(pcb->ooseq_blocks, max * sizeof(*blocks));
+
+        if (blocks == NULL) {
+            return 0;
+        }
+        pcb->ooseq_blocks = blocks;
+        pcb->ooseq_blocks_max = max;
+    }
+    memmove(&pcb->ooseq_blocks[idx + 1], &pcb->ooseq_blocks[idx],
+            (pcb->ooseq_blocks_cnt - idx) * sizeof(*pcb->ooseq_blocks));
+    ++pcb->ooseq_blocks_cnt;
+    return 1;
+}
+
+static void tcp_ooseq_block_remove(struct tcp_pcb *pcb, u32_t idx)
+{
+    --pcb->ooseq_blocks_cnt;
+    memmove(&pcb->ooseq_blocks[idx], &pcb->ooseq_blocks[idx + 1],
+            (pcb->ooseq_blocks_cnt - idx) * sizeof(*pcb->ooseq_blocks));
+}
+
+/* Frees the segments of a block and removes it */
+static void tcp_ooseq_block_drop(struct tcp_pcb *pcb, u32_t idx)
+{
+    struct tcp_ooseq_block *block = &pcb->ooseq_blocks[idx];
+    struct tcp_seg **link = idx ? &pcb->ooseq_blocks[idx - 1].last->next : &pcb->ooseq;
+
+    *link = block->last->next;
+    block->last->next = NULL;
+    tcp_segs_free(pcb, block->first);
+    tcp_ooseq_block_remove(pcb, idx);
+}
+
+/* Unlinks the first segment of the ooseq queue */
+static void tcp_ooseq_pop(struct tcp_pcb *pcb)
+{
+    struct tcp_seg *seg = pcb->ooseq;
+    struct tcp_ooseq_block *block = &pcb->ooseq_blocks[0];
+
+    pcb->ooseq = seg->next;
+    seg->next = NULL;
+    if (pcb->ooseq == NULL) {
+        tcp_ooseq_free(pcb);
+    } else if (block->last == seg) {
+        tcp_ooseq_block_remove(pcb, 0);
+    } else {
+        block->first = pcb->ooseq;
+        block->left = pcb->ooseq->tcphdr->seqno;
+    }
+}
+
 /**
- * Insert segment into the list (segments covered with new one will be deleted)
+ * Queues an out of sequence segment. The place of the segment is found with a
+ * binary search of the blocks of contiguous data and the segment is merged
+ * with the adjacent blocks, so the cost doesn't grow with the queue length.
+ * The data already queued is trimmed from the segment, the blocks it covers
+ * entirely are replaced.
  *
  * Called from tcp_receive()
  */
-static void tcp_oos_insert_segment(struct tcp_pcb *pcb, struct tcp_seg *cseg, struct tcp_seg *next,
-                                   tcp_in_data *in_data)
+static void tcp_ooseq_insert(struct tcp_pcb *pcb, tcp_in_data *in_data)
 {
-    struct tcp_seg *old_seg;
+    struct tcp_seg *inseg = &in_data->inseg;
+    struct tcp_ooseq_block *block;
+    struct tcp_seg **link;
+    struct tcp_seg *cseg;
+    u32_t seqno = in_data->seqno;
+    u32_t right;
+    s32_t i;
+
+    /* check if the remote side overruns our receive window */
+    if (TCP_SEQ_GT(seqno + TCP_TCPLEN(inseg), pcb->rcv_nxt + pcb->rcv_wnd)) {
+        LWIP_DEBUGF(TCP_INPUT_DEBUG,
+                    ("tcp_receive: other end overran receive window"
+                     "seqno %" U32_F " len %" U16_F " right edge %" U32_F "\n",
+                     seqno, in_data->tcplen, pcb->rcv_nxt + pcb->rcv_wnd));
+        tcp_ooseq_trim(inseg, pcb->rcv_nxt + pcb->rcv_wnd - seqno);
+    }
 
-    if (TCPH_FLAGS(cseg->tcphdr) & TCP_FIN) {
-        /* received segment overlaps all following segments */
-        tcp_segs_free(pcb, next);
-        next = NULL;
-    } else {
-        /* delete some following segments
-           oos queue may have segments with FIN flag */
-        while (next &&
-               TCP_SEQ_GEQ((in_data->seqno + cseg->len), (next->tcphdr->seqno + next->len))) {
-            /* cseg with FIN already processed */
-            if (TCPH_FLAGS(next->tcphdr) & TCP_FIN) {
-                TCPH_SET_FLAG(cseg->tcphdr, TCP_FIN);
+    i = tcp_ooseq_find(pcb, seqno);
+    if (i >= 0) {
+        block = &pcb->ooseq_blocks[i];
+        if (TCP_SEQ_LEQ(seqno + TCP_TCPLEN(inseg), block->right) ||
+            (TCPH_FLAGS(block->last->tcphdr) & TCP_FIN)) {
+            /* Duplicate data or data beyond the FIN */
+            return;
+        }
+        if (TCP_SEQ_LT(seqno, block->right)) {
+            tcp_seg_trim_head(inseg, block->right - seqno);
+            in_data->seqno = inseg->tcphdr->seqno = seqno = block->right;
+        }
+    }
+
+    /* The following blocks are covered by the segment or lie beyond its FIN */
+    while ((u32_t)(i + 1) < pcb->ooseq_blocks_cnt) {
+        block = &pcb->ooseq_blocks[i + 1];
+        if (!(TCPH_FLAGS(inseg->tcphdr) & TCP_FIN)) {
+            if (TCP_SEQ_LT(seqno + TCP_TCPLEN(inseg), block->right)) {
+                if (TCP_SEQ_GT(seqno + TCP_TCPLEN(inseg), block->left)) {
+                    tcp_ooseq_trim(inseg, block->left - seqno);
+                }
+                break;
+            }
+            if (TCPH_FLAGS(block->last->tcphdr) & TCP_FIN) {
+                /* The FIN of the covered block ends the data */
+                tcp_ooseq_trim(inseg, block->right - 1U - seqno);
+                TCPH_SET_FLAG(inseg->tcphdr, TCP_FIN);
             }
-            old_seg = next;
-            next = next->next;
-            tcp_seg_free(pcb, old_seg);
         }
-        if (next && TCP_SEQ_GT(in_data->seqno + cseg->len, next->tcphdr->seqno)) {
-            /* We need to trim the incoming segment. */
-            cseg->len = (u32_t)(next->tcphdr->seqno - in_data->seqno);
-            pbuf_realloc(cseg->p, cseg->len);
+        tcp_ooseq_block_drop(pcb, i + 1);
+    }
+
+    cseg = tcp_seg_copy(pcb, inseg);
+    if (cseg != NULL) {
+        right = seqno + TCP_TCPLEN(cseg);
+        link = i >= 0 ? &pcb->ooseq_blocks[i].last->next : &pcb->ooseq;
+        cseg->next = *link;
+        *link = cseg;
+
+        if (i >= 0 && pcb->ooseq_blocks[i].right == seqno) {
+            /* Extends the previous block, possibly up to the next one */
+            block = &pcb->ooseq_blocks[i];
+            block->last = cseg;
+            block->right = right;
+            if ((u32_t)(i + 1) < pcb->ooseq_blocks_cnt && block[1].left == right) {
+                block->last = block[1].last;
+                block->right = block[1].right;
+                tcp_ooseq_block_remove(pcb, i + 1);
+            }
+        } else if ((u32_t)(i + 1) < pcb->ooseq_blocks_cnt &&
+                   pcb->ooseq_blocks[i + 1].left == right) {
+            block = &pcb->ooseq_blocks[i + 1];
+            block->first = cseg;
+            block->left = seqno;
+        } else if (tcp_ooseq_block_insert(pcb, i + 1)) {
+            block = &pcb->ooseq_blocks[i + 1];
+            block->left = seqno;
+            block->right = right;
+            block->first = cseg;
+            block->last = cseg;
+        } else {
+            *link = cseg->next;
+            cseg->next = NULL;
+            tcp_seg_free(pcb, cseg);
         }
     }
-    cseg->next = next;
+    if (pcb->ooseq == NULL) {
+        tcp_ooseq_free(pcb);
+    }
 }
 #endif /* TCP_QUEUE_OOSEQ */
 
@@ -930,7 +1488,77 @@ static void tcp_shrink_zc_segment(struct tcp_pcb *pcb, struct tcp_seg *seg, u32_
     seg->tcphdr->seqno = htonl(seg->seqno);
 }
 
-static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struct tcp_seg **seg)
+#if TCP_CC_ALGO_MOD
+/* The rate sample is taken from the most recently sent segment among the delivered ones */
+static void tcp_rate_seg_delivered(struct tcp_seg *seg, struct cc_rate_sample *rs)
+{
+    if (!seg->rs.sent_time ||
+        (rs->has_prior && TCP_SEQ_LT(seg->rs.delivered, rs->prior_delivered))) {
+        return;
+    }
+    rs->has_prior = 1;
+    rs->prior_delivered = seg->rs.delivered;
+    rs->prior_time = seg->rs.delivered_time;
+    rs->sent_time = seg->rs.sent_time;
+    rs->send_elapsed = seg->rs.sent_time - seg->rs.first_sent_time;
+    rs->is_app_limited = !!(seg->rs.flags & TF_SEG_RS_APP_LIMITED);
+    rs->is_rexmit = !!(seg->rs.flags & TF_SEG_RS_REXMIT);
+}
+
+/**
+ * Accounts the bytes delivered by the ACK and passes the delivery rate sample
+ * to the congestion control. The sample interval is the longer of the send and
+ * the ACK intervals, so ACK compression doesn't overestimate the rate.
+ */
+static void tcp_rate_gen(struct tcp_pcb *pcb, struct cc_rate_sample *rs)
+{
+    u32_t now = sys_now_us();
+
+    pcb->delivered += rs->acked;
+    pcb->delivered_time = now;
+    if (pcb->app_limited && TCP_SEQ_GT(pcb->delivered, pcb->app_limited)) {
+        pcb->app_limited = 0;
+    }
+    rs->rtt_us = UINT32_MAX;
+    if (rs->has_prior) {
+        pcb->first_sent_time = rs->sent_time;
+        rs->delivered = pcb->delivered - rs->prior_delivered;
+        rs->interval_us = LWIP_MAX(rs->send_elapsed, now - rs->prior_time);
+        if (!rs->is_rexmit) {
+            rs->rtt_us = now - rs->sent_time;
+        }
+    }
+    cc_on_rate_sample(pcb, rs);
+}
+#endif // TCP_CC_ALGO_MOD
+
+/* RACK follows the most recently sent segment among the delivered ones */
+static void tcp_rack_seg_delivered(struct tcp_pcb *pcb, struct tcp_seg *seg,
+                                   struct tcp_rack_ack *rack)
+{
+    u32_t end_seq = seg->seqno + TCP_SEGLEN(seg);
+    u32_t rtt = rack->now - seg->xmit_time;
+
+    if (!seg->xmit_time) {
+        return;
+    }
+    if ((seg->sack_state & TF_SEG_RACK_REXMIT) && rtt < pcb->rack_min_rtt) {
+        /* Likely the delivery of a previous transmission */
+        ++pcb->stats.n_spurious_rexmit;
+        return;
+    }
+    if (pcb->rack_xmit_time &&
+        !tcp_rack_sent_after(seg->xmit_time, end_seq, pcb->rack_xmit_time, pcb->rack_end_seq)) {
+        return;
+    }
+    pcb->rack_xmit_time = seg->xmit_time;
+    pcb->rack_end_seq = end_seq;
+    pcb->rack_rtt = rtt;
+    rack->sampled = 1;
+}
+
+static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struct tcp_seg **seg,
+                                         struct cc_rate_sample *rs, struct tcp_rack_ack *rack)
 {
     struct tcp_seg *whole_seg_to_ack;
     while ((*seg) != NULL && TCP_SEQ_GT(ackno, (*seg)->seqno)) {
@@ -945,6 +1573,15 @@ static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struc
                 break;
             }
             // Ack partial TCP segment
+#if TCP_CC_ALGO_MOD
+            if (rs) {
+                rs->acked += ackno - (*seg)->seqno;
+                tcp_rate_seg_delivered((*seg), rs);
+            }
+#endif
+            if (rack) {
+                tcp_rack_seg_delivered(pcb, (*seg), rack);
+            }
             if ((*seg)->flags & TF_SEG_OPTS_ZEROCOPY) {
                 tcp_shrink_zc_segment(pcb, (*seg), ackno);
             } else {
@@ -956,6 +1593,17 @@ static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struc
         whole_seg_to_ack = (*seg);
         (*seg) = (*seg)->next;
 
+#if TCP_CC_ALGO_MOD
+        /* A SACKed segment was accounted by the SACK block */
+        if (rs && !(whole_seg_to_ack->sack_state & TF_SEG_SACKED)) {
+            rs->acked += whole_seg_to_ack->len;
+            tcp_rate_seg_delivered(whole_seg_to_ack, rs);
+        }
+#endif
+        if (rack && !(whole_seg_to_ack->sack_state & TF_SEG_SACKED)) {
+            tcp_rack_seg_delivered(pcb, whole_seg_to_ack, rack);
+        }
+
         /* Prevent ACK for FIN to generate a sent event */
         if ((pcb->acked != 0) && ((whole_seg_to_ack->tcp_flags & TCP_FIN) != 0)) {
             pcb->acked--;
@@ -965,6 +1613,175 @@ static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struc
     }
 }
 
+/**
+ * Updates the SACK scoreboard with the blocks of the incoming segment.
+ * The unacked segments entirely covered by a block are marked as SACKed.
+ * Blocks which don't lie within the outstanding data are ignored.
+ */
+static void tcp_sack_update(struct tcp_pcb *pcb, tcp_in_data *in_data,
+                            struct cc_rate_sample *rs, struct tcp_rack_ack *rack)
+{
+    struct tcp_seg *seg;
+    u8_t i;
+
+    for (i = 0; i < in_data->sack_cnt; ++i) {
+        u32_t left = in_data->sack_blocks[2 * i];
+        u32_t right = in_data->sack_blocks[2 * i + 1];
+
+        if (!TCP_SEQ_LT(left, right) || !TCP_SEQ_GT(right, pcb->lastack) ||
+            TCP_SEQ_GT(right, pcb->snd_nxt)) {
+            continue;
+        }
+        if (TCP_SEQ_GT(right, pcb->sack_high)) {
+            pcb->sack_high = right;
+        }
+        for (seg = pcb->unacked; seg != NULL && TCP_SEQ_LT(seg->seqno, right); seg = seg->next) {
+            if (TCP_SEQ_GEQ(seg->seqno, left) && TCP_SEQ_LEQ(seg->seqno + seg->len, right) &&
+                !(seg->sack_state & TF_SEG_SACKED)) {
+                seg->sack_state |= TF_SEG_SACKED;
+#if TCP_CC_ALGO_MOD
+                if (rs) {
+                    rs->acked += seg->len;
+                    tcp_rate_seg_delivered(seg, rs);
+                }
+#else
+                LWIP_UNUSED_ARG(rs);
+#endif
+                if (rack) {
+                    tcp_rack_seg_delivered(pcb, seg, rack);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Completes the RACK-TLP processing of an ACK: updates the RTT estimations,
+ * ends the tail loss probe, detects the losses and rearms the probe.
+ * A retransmitted probe is assumed to repair a loss, there is no DSACK to
+ * tell otherwise, so the congestion window is reduced as for a recovery.
+ */
+static void tcp_rack_ack(struct tcp_pcb *pcb, tcp_in_data *in_data, struct tcp_rack_ack *rack)
+{
+    if (rack->sampled) {
+        u32_t rtt = LWIP_MAX(pcb->rack_rtt, 1U);
+
+        if (!pcb->rack_min_rtt || rtt < pcb->rack_min_rtt) {
+            pcb->rack_min_rtt = rtt;
+        }
+        if (pcb->rack_srtt) {
+            pcb->rack_srtt = pcb->rack_srtt - (pcb->rack_srtt >> 3) + (rtt >> 3);
+        } else {
+            pcb->rack_srtt = rtt;
+        }
+    }
+
+    if (pcb->tlp_outstanding && TCP_SEQ_GEQ(in_data->ackno, pcb->tlp_high_seq)) {
+        pcb->tlp_outstanding = 0;
+        if (pcb->tlp_rexmit && !(pcb->flags & TF_INFR) &&
+            TCP_SEQ_GEQ(pcb->tlp_high_seq, pcb->rack_recover)) {
+#if TCP_CC_ALGO_MOD
+            cc_cong_signal(pcb, CC_NDUPACK);
+            cc_post_recovery(pcb);
+#else
+            pcb->ssthresh = LWIP_MAX(LWIP_MIN(pcb->cwnd, pcb->snd_wnd) / 2, 2U * pcb->mss);
+            pcb->cwnd = pcb->ssthresh;
+#endif
+            pcb->rack_recover = pcb->snd_nxt;
+        }
+    }
+
+    if (rack->sampled && (pcb->flags & TF_SACK)) {
+        tcp_rack_detect_loss(pcb, rack->now);
+    }
+    tcp_tlp_arm(pcb, rack->now);
+}
+
+/**
+ * Reduces the congestion window on the ECN echo of the remote host, once per
+ * window of data. The next new data segment carries CWR.
+ */
+static void tcp_ecn_cwr(struct tcp_pcb *pcb)
+{
+#if TCP_CC_ALGO_MOD
+    cc_cong_signal(pcb, CC_ECN);
+#else
+    pcb->ssthresh = LWIP_MAX(LWIP_MIN(pcb->cwnd, pcb->snd_wnd) / 2, 2U * pcb->mss);
+    pcb->cwnd = pcb->ssthresh;
+#endif
+    pcb->ecn_recover = pcb->snd_nxt;
+    pcb->flags |= TF_ECN_CWR;
+}
+
+/**
+ * Updates the ECN echo state with the CE mark of an incoming data segment.
+ * The echo lasts until the remote host confirms it with CWR. A DCTCP receiver
+ * echoes the mark of each segment instead and acknowledges each change at once.
+ */
+static void tcp_ecn_rcv(struct tcp_pcb *pcb, tcp_in_data *in_data)
+{
+    u8_t ce = (in_data->iphdr.ecn == TCP_ECN_CE);
+
+#if TCP_CC_ALGO_MOD
+    if (pcb->cc_algo->flags & CC_F_ECN) {
+        if (ce != !!(pcb->flags & TF_ECN_ECHO)) {
+            if (pcb->flags & TF_ACK_DELAY) {
+                /* The delayed ACK covers the segments of the previous mark */
+                tcp_send_empty_ack(pcb);
+            }
+            pcb->flags ^= TF_ECN_ECHO;
+            tcp_ack_now(pcb);
+        }
+        return;
+    }
+#endif
+    if (in_data->flags & TCP_CWR) {
+        pcb->flags &= ~TF_ECN_ECHO;
+    }
+    if (ce) {
+        pcb->flags |= TF_ECN_ECHO;
+    }
+}
+
+/* Adaptive delayed ACK as Linux does. The first segments of a connection and the ones after
+ * a receive idle period are acknowledged immediately, since the sender can't grow its window
+ * until they are, tcp_ack_data_sent() stops it for the request/response connections.
+ */
+static void tcp_ack_data_recv(struct tcp_pcb *pcb)
+{
+    u32_t now = sys_now_us();
+
+    if (!pcb->ack_rcv_time || now - pcb->ack_rcv_time > TCP_ACK_QUICK_IDLE_US) {
+        u32_t quick = pcb->rcv_wnd / (2U * pcb->mss);
+
+        pcb->ack_quick = (u8_t)LWIP_MIN(LWIP_MAX(quick, 2U), TCP_ACK_QUICK_MAX);
+    }
+    pcb->ack_rcv_time = now;
+}
+
+/* Receiver side RTT sample, once per window of in sequence data. A sample can only
+ * overestimate the RTT, since the sender may be application or window limited,
+ * therefore the estimate keeps the lowest one as Linux does without timestamps.
+ */
+static void tcp_rcv_rtt_measure(struct tcp_pcb *pcb)
+{
+    u32_t now;
+
+    if (pcb->rcv_rtt_time && TCP_SEQ_LT(pcb->rcv_nxt, pcb->rcv_rtt_seq)) {
+        return;
+    }
+    now = sys_now_us();
+    if (pcb->rcv_rtt_time) {
+        u32_t rtt = LWIP_MAX(now - pcb->rcv_rtt_time, 1U);
+
+        if (!pcb->rcv_rtt || rtt < pcb->rcv_rtt) {
+            pcb->rcv_rtt = rtt;
+        }
+    }
+    pcb->rcv_rtt_seq = pcb->rcv_nxt + pcb->rcv_wnd;
+    pcb->rcv_rtt_time = now;
+}
+
 /**
  * Called by tcp_process. Checks if the given segment is an ACK for outstanding
  * data, and if so frees the memory of the buffered data. Next, is places the
@@ -979,21 +1796,39 @@ static void ack_partial_or_whole_segment(struct tcp_pcb *pcb, u32_t ackno, struc
  */
 static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
 {
-    struct tcp_seg *next;
 #if TCP_QUEUE_OOSEQ
-    struct tcp_seg *prev, *cseg;
+    struct tcp_seg *next, *cseg;
 #endif /* TCP_QUEUE_OOSEQ */
-    struct pbuf *p;
     s16_t m;
     u32_t right_wnd_edge;
-    u32_t new_tot_len;
     int found_dupack = 0;
     s8_t persist = 0;
+    struct cc_rate_sample *rs = NULL;
+#if TCP_CC_ALGO_MOD
+    struct cc_rate_sample rate_sample;
+#endif
+    struct tcp_rack_ack rack_ack;
+    struct tcp_rack_ack *rack = NULL;
 
     if (in_data->flags & TCP_ACK) {
         if (pcb->unacked) {
             __builtin_prefetch(pcb->unacked->p);
         }
+#if TCP_CC_ALGO_MOD
+        if (tcp_rate_enabled(pcb)) {
+            memset(&rate_sample, 0, sizeof(rate_sample));
+            rs = &rate_sample;
+        }
+#endif
+        if (pcb->enable_rack_opt) {
+            rack_ack.now = sys_now_us();
+            rack_ack.sampled = 0;
+            rack = &rack_ack;
+        }
+        if (in_data->sack_cnt) {
+            tcp_sack_update(pcb, in_data, rs, rack);
+        }
+        pcb->ecn_ece = (pcb->flags & TF_ECN) && (in_data->flags & TCP_ECE);
         right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
 
         /* Update window. */
@@ -1001,6 +1836,9 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
             (pcb->snd_wl1 == in_data->seqno && TCP_SEQ_LT(pcb->snd_wl2, in_data->ackno)) ||
             (pcb->snd_wl2 == in_data->ackno &&
              SND_WND_SCALE(pcb, in_data->tcphdr->wnd) > pcb->snd_wnd)) {
+            if (pcb->snd_wnd && !in_data->tcphdr->wnd) {
+                ++pcb->stats.n_zero_wnd;
+            }
             pcb->snd_wnd = SND_WND_SCALE(
                 pcb, in_data->tcphdr->wnd); // Which means: tcphdr->wnd << pcb->snd_scale;
             /* keep track of the biggest window announced by the remote host to calculate
@@ -1076,6 +1914,10 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                                     pcb->cwnd += pcb->mss;
                                 }
 #endif // TCP_CC_ALGO_MOD
+                                if ((pcb->flags & (TF_SACK | TF_INFR)) == (TF_SACK | TF_INFR)) {
+                                    /* Each further dupack may uncover the next hole */
+                                    tcp_rexmit_sack(pcb);
+                                }
                             } else if (pcb->dupacks == 3) {
                                 /* Do fast retransmit */
                                 tcp_rexmit_fast(pcb);
@@ -1095,6 +1937,7 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
             }
         } else if (TCP_SEQ_BETWEEN(in_data->ackno, pcb->lastack + 1, pcb->snd_nxt)) {
             /* We come here when the ACK acknowledges new data. */
+            u16_t was_in_recovery = pcb->flags & TF_INFR;
 
             /* Reset the "IN Fast Retransmit" flag, since we are no longer
                in fast retransmit. Also reset the congestion window to the
@@ -1120,6 +1963,22 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
             /* Reset the fast retransmit variables. */
             pcb->dupacks = 0;
             pcb->lastack = in_data->ackno;
+            /* Keep the SACK edges in the window for the sequence comparisons */
+            if (TCP_SEQ_GT(pcb->lastack, pcb->sack_high)) {
+                pcb->sack_high = pcb->lastack;
+            }
+            if (TCP_SEQ_GT(pcb->lastack, pcb->sack_rexmit_high)) {
+                pcb->sack_rexmit_high = pcb->lastack;
+            }
+            if (TCP_SEQ_GT(pcb->lastack, pcb->ecn_recover)) {
+                pcb->ecn_recover = pcb->lastack;
+            }
+            if (TCP_SEQ_GT(pcb->lastack, pcb->rack_recover)) {
+                pcb->rack_recover = pcb->lastack;
+            }
+            if (unlikely(pcb->mtup_probe)) {
+                tcp_mtup_acked(pcb);
+            }
 
             /* Update the congestion control variables (cwnd and ssthresh). */
             if (get_tcp_state(pcb) >= ESTABLISHED) {
@@ -1150,7 +2009,7 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                      ? ntohl(pcb->unacked->tcphdr->seqno) + TCP_SEGLEN(pcb->unacked)
                      : 0));
 
-            ack_partial_or_whole_segment(pcb, in_data->ackno, &(pcb->unacked));
+            ack_partial_or_whole_segment(pcb, in_data->ackno, &(pcb->unacked), rs, rack);
 
             /* If there's nothing left to acknowledge, stop the retransmit
                timer, otherwise reset it to start again */
@@ -1167,24 +2026,40 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 pcb->rtime = 0;
                 pcb->ticks_since_data_sent = 0;
             }
+
+            if (was_in_recovery && (pcb->flags & TF_SACK) &&
+                TCP_SEQ_GT(pcb->sack_high, pcb->lastack)) {
+                /* A partial ACK of the recovery, the next hole doesn't wait for dupacks */
+                tcp_rexmit_sack(pcb);
+            }
         } else {
             /* Out of sequence ACK, didn't really ack anything */
             pcb->acked = 0;
             tcp_send_empty_ack(pcb);
         }
 
+        if (pcb->ecn_ece && TCP_SEQ_GEQ(in_data->ackno, pcb->ecn_recover) &&
+            !(pcb->flags & TF_INFR) && get_tcp_state(pcb) >= ESTABLISHED) {
+            tcp_ecn_cwr(pcb);
+        }
+
         /* We go through the ->unsent list to see if any of the segments
            on the list are acknowledged by the ACK. This may seem
            strange since an "unsent" segment shouldn't be acked. The
            rationale is that lwIP puts all outstanding segments on the
            ->unsent list after a retransmission, so these segments may
            in fact have been sent once. */
-        ack_partial_or_whole_segment(pcb, in_data->ackno, &(pcb->unsent));
+        ack_partial_or_whole_segment(pcb, in_data->ackno, &(pcb->unsent), rs, rack);
 
         if (pcb->unsent == NULL) {
             /* We have sent all pending segments, reflect it in last_unsent */
             pcb->last_unsent = NULL;
         }
+#if TCP_CC_ALGO_MOD
+        if (rs && rs->acked) {
+            tcp_rate_gen(pcb, rs);
+        }
+#endif
         /* End of ACK for new data processing. */
 
         LWIP_DEBUGF(TCP_RTO_DEBUG,
@@ -1222,6 +2097,10 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
 
             pcb->rttest = 0;
         }
+
+        if (rack) {
+            tcp_rack_ack(pcb, in_data, rack);
+        }
     }
 
     /* If the incoming segment contains data, we must process it
@@ -1229,6 +2108,9 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
        (RFC 793, chapter 3.9, "SEGMENT ARRIVES" in states CLOSE-WAIT, CLOSING,
        LAST-ACK and TIME-WAIT: "Ignore the segment text.") */
     if ((in_data->tcplen > 0) && (get_tcp_state(pcb) < CLOSE_WAIT)) {
+        if (pcb->flags & TF_ECN) {
+            tcp_ecn_rcv(pcb, in_data);
+        }
         /* This code basically does three things:
 
         +) If the incoming segment contains data that is the next
@@ -1281,29 +2163,7 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                adjust the ->data pointer in the seg and the segment
                length.*/
 
-            u32_t off = pcb->rcv_nxt - in_data->seqno;
-            p = in_data->inseg.p;
-            LWIP_ASSERT("inseg.p != NULL", in_data->inseg.p);
-            if (in_data->inseg.p->len < off) {
-                LWIP_ASSERT("pbuf too short!", (((s32_t)in_data->inseg.p->tot_len) >= off));
-                new_tot_len = in_data->inseg.p->tot_len - off;
-                while (p->len < off) {
-                    off -= p->len;
-                    p->tot_len = new_tot_len;
-                    p->len = 0;
-                    p = p->next;
-                }
-                if (pbuf_header(p, -off)) {
-                    /* Do we need to cope with this failing?  Assert for now */
-                    LWIP_ASSERT("pbuf_header failed", 0);
-                }
-            } else {
-                if (pbuf_header(in_data->inseg.p, -off)) {
-                    /* Do we need to cope with this failing?  Assert for now */
-                    LWIP_ASSERT("pbuf_header failed", 0);
-                }
-            }
-            in_data->inseg.len -= pcb->rcv_nxt - in_data->seqno;
+            tcp_seg_trim_head(&in_data->inseg, pcb->rcv_nxt - in_data->seqno);
             in_data->inseg.tcphdr->seqno = in_data->seqno = pcb->rcv_nxt;
         } else {
             if (TCP_SEQ_LT(in_data->seqno, pcb->rcv_nxt)) {
@@ -1359,11 +2219,7 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                         /* Received in-order FIN means anything that was received
                          * out of order must now have been received in-order, so
                          * bin the ooseq queue */
-                        while (pcb->ooseq != NULL) {
-                            struct tcp_seg *old_ooseq = pcb->ooseq;
-                            pcb->ooseq = pcb->ooseq->next;
-                            tcp_seg_free(pcb, old_ooseq);
-                        }
+                        tcp_ooseq_free(pcb);
                     } else {
                         next = pcb->ooseq;
                         /* Remove all segments on ooseq that are covered by inseg already.
@@ -1377,9 +2233,9 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                                 TCPH_SET_FLAG(in_data->inseg.tcphdr, TCP_FIN);
                                 in_data->tcplen = TCP_TCPLEN(&in_data->inseg);
                             }
-                            prev = next;
-                            next = next->next;
-                            tcp_seg_free(pcb, prev);
+                            tcp_ooseq_pop(pcb);
+                            tcp_seg_free(pcb, next);
+                            next = pcb->ooseq;
                         }
                         /* Now trim right side of inseg if it overlaps with the first
                          * segment on ooseq */
@@ -1397,12 +2253,15 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                                 (in_data->seqno + in_data->tcplen) ==
                                     next->in_data->tcphdr->in_data->seqno);
                         }
-                        pcb->ooseq = next;
                     }
                 }
 #endif /* TCP_QUEUE_OOSEQ */
 
                 pcb->rcv_nxt = in_data->seqno + in_data->tcplen;
+                tcp_rcv_rtt_measure(pcb);
+                if (pcb->enable_ack_adaptive_opt) {
+                    tcp_ack_data_recv(pcb);
+                }
 
                 /* Update the receiver's (our) window. */
                 LWIP_ASSERT("tcp_receive: tcplen > rcv_wnd\n", pcb->rcv_wnd >= in_data->tcplen);
@@ -1465,7 +2324,7 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                         }
                     }
 
-                    pcb->ooseq = cseg->next;
+                    tcp_ooseq_pop(pcb);
                     tcp_seg_free(pcb, cseg);
                 }
 #endif /* TCP_QUEUE_OOSEQ */
@@ -1475,148 +2334,31 @@ static void tcp_receive(struct tcp_pcb *pcb, tcp_in_data *in_data)
                     tcp_quickack(pcb, in_data)) {
                     tcp_ack_now(pcb);
                 } else {
-                    tcp_ack(pcb);
+                    /* An immediate ACK of another event can't wait for the end of the poll */
+                    const u16_t ack_flags = pcb->flags & (TF_ACK_NOW | TF_ACK_COALESCE);
+
+                    if (pcb->ack_quick && !pcb->ack_pingpong) {
+                        --pcb->ack_quick;
+                        tcp_ack_now(pcb);
+                    } else {
+                        tcp_ack(pcb);
+                    }
+                    if (pcb->enable_ack_coalesce_opt && ack_flags != TF_ACK_NOW &&
+                        (pcb->flags & TF_ACK_NOW) && tcp_ooseq_empty(pcb)) {
+                        pcb->flags |= TF_ACK_COALESCE;
+                    }
                 }
 
             } else {
                 /* We get here if the incoming segment is out-of-sequence. */
-                tcp_send_empty_ack(pcb);
+                pcb->rcv_sack_recent = in_data->seqno;
 #if TCP_QUEUE_OOSEQ
                 /* Suppress coverity warning of uninit array during tcp_seg_copy(). */
                 memset(in_data->inseg.l2_l3_tcphdr_zc, 0, sizeof(in_data->inseg.l2_l3_tcphdr_zc));
-                /* We queue the segment on the ->ooseq queue. */
-                if (pcb->ooseq == NULL) {
-                    pcb->ooseq = tcp_seg_copy(pcb, &in_data->inseg);
-                } else {
-                    /* If the queue is not empty, we walk through the queue and
-                       try to find a place where the sequence number of the
-                       incoming segment is between the sequence numbers of the
-                       previous and the next segment on the ->ooseq queue. That is
-                       the place where we put the incoming segment. If needed, we
-                       trim the second edges of the previous and the incoming
-                       segment so that it will fit into the sequence.
-
-                       If the incoming segment has the same sequence number as a
-                       segment on the ->ooseq queue, we discard the segment that
-                       contains less data. */
-
-                    prev = NULL;
-                    for (next = pcb->ooseq; next != NULL; next = next->next) {
-                        if (in_data->seqno == next->tcphdr->seqno) {
-                            /* The sequence number of the incoming segment is the
-                               same as the sequence number of the segment on
-                               ->ooseq. We check the lengths to see which one to
-                               discard. */
-                            if (in_data->inseg.len > next->len) {
-                                /* The incoming segment is larger than the old
-                                   segment. We replace some segments with the new
-                                   one. */
-                                cseg = tcp_seg_copy(pcb, &in_data->inseg);
-                                if (cseg != NULL) {
-                                    if (prev != NULL) {
-                                        prev->next = cseg;
-                                    } else {
-                                        pcb->ooseq = cseg;
-                                    }
-                                    tcp_oos_insert_segment(pcb, cseg, next, in_data);
-                                }
-                                break;
-                            } else {
-                                /* Either the lenghts are the same or the incoming
-                                   segment was smaller than the old one; in either
-                                   case, we ditch the incoming segment. */
-                                break;
-                            }
-                        } else {
-                            if (prev == NULL) {
-                                if (TCP_SEQ_LT(in_data->seqno, next->tcphdr->seqno)) {
-                                    /* The sequence number of the incoming segment is lower
-                                       than the sequence number of the first segment on the
-                                       queue. We put the incoming segment first on the
-                                       queue. */
-                                    cseg = tcp_seg_copy(pcb, &in_data->inseg);
-                                    if (cseg != NULL) {
-                                        pcb->ooseq = cseg;
-                                        tcp_oos_insert_segment(pcb, cseg, next, in_data);
-                                    }
-                                    break;
-                                }
-                            } else {
-                                /*if (TCP_SEQ_LT(prev->tcphdr->seqno, seqno) &&
-                                  TCP_SEQ_LT(seqno, next->tcphdr->seqno)) {*/
-                                if (TCP_SEQ_BETWEEN(in_data->seqno, prev->tcphdr->seqno + 1,
-                                                    next->tcphdr->seqno - 1)) {
-                                    /* The sequence number of the incoming segment is in
-                                       between the sequence numbers of the previous and
-                                       the next segment on ->ooseq. We trim trim the previous
-                                       segment, delete next segments that included in received
-                                       segment and trim received, if needed. */
-                                    cseg = tcp_seg_copy(pcb, &in_data->inseg);
-                                    if (cseg != NULL) {
-                                        if (TCP_SEQ_GT(prev->tcphdr->seqno + prev->len,
-                                                       in_data->seqno)) {
-                                            /* We need to trim the prev segment. */
-                                            prev->len =
-                                                (u32_t)(in_data->seqno - prev->tcphdr->seqno);
-                                            pbuf_realloc(prev->p, prev->len);
-                                        }
-                                        prev->next = cseg;
-                                        tcp_oos_insert_segment(pcb, cseg, next, in_data);
-                                    }
-                                    break;
-                                }
-                            }
-                            /* If the "next" segment is the last segment on the
-                               ooseq queue, we add the incoming segment to the end
-                               of the list. */
-                            if (next->next == NULL &&
-                                TCP_SEQ_GT(in_data->seqno, next->tcphdr->seqno)) {
-                                if (TCPH_FLAGS(next->tcphdr) & TCP_FIN) {
-                                    /* segment "next" already contains all data */
-                                    break;
-                                }
-                                next->next = tcp_seg_copy(pcb, &in_data->inseg);
-                                if (next->next != NULL) {
-                                    if (TCP_SEQ_GT(next->tcphdr->seqno + next->len,
-                                                   in_data->seqno)) {
-                                        /* We need to trim the last segment. */
-                                        next->len = (u32_t)(in_data->seqno - next->tcphdr->seqno);
-                                        pbuf_realloc(next->p, next->len);
-                                    }
-                                    /* check if the remote side overruns our receive window */
-                                    if (TCP_SEQ_GT(in_data->seqno + in_data->tcplen,
-                                                   pcb->rcv_nxt + pcb->rcv_wnd)) {
-                                        LWIP_DEBUGF(TCP_INPUT_DEBUG,
-                                                    ("tcp_receive: other end overran receive window"
-                                                     "seqno %" U32_F " len %" U16_F
-                                                     " right edge %" U32_F "\n",
-                                                     in_data->seqno, in_data->tcplen,
-                                                     pcb->rcv_nxt + pcb->rcv_wnd));
-                                        if (TCPH_FLAGS(next->next->tcphdr) & TCP_FIN) {
-                                            /* Must remove the FIN from the header as we're trimming
-                                             * that byte of sequence-space from the packet */
-                                            TCPH_FLAGS_SET(
-                                                next->next->tcphdr,
-                                                TCPH_FLAGS(next->next->tcphdr) & ~TCP_FIN);
-                                        }
-                                        /* Adjust length of segment to fit in the window. */
-                                        next->next->len =
-                                            pcb->rcv_nxt + pcb->rcv_wnd - in_data->seqno;
-                                        pbuf_realloc(next->next->p, next->next->len);
-                                        in_data->tcplen = TCP_TCPLEN(next->next);
-                                        LWIP_ASSERT("tcp_receive: segment not trimmed correctly to "
-                                                    "rcv_wnd\n",
-                                                    (in_data->seqno + in_data->tcplen) ==
-                                                        (pcb->rcv_nxt + pcb->rcv_wnd));
-                                    }
-                                }
-                                break;
-                            }
-                        }
-                        prev = next;
-                    }
-                }
+                tcp_ooseq_insert(pcb, in_data);
 #endif /* TCP_QUEUE_OOSEQ */
+                /* The ACK follows the queueing, so the SACK blocks report the segment */
+                tcp_send_empty_ack(pcb);
             }
         } else {
             /* The incoming segment is not withing the window. */
@@ -1681,12 +2423,55 @@ static bool tcp_parseopt_ts(u8_t *opts, u16_t opts_len, u32_t *tsval)
     return false;
 }
 
+/**
+ * Looks for the MSS option.
+ *
+ * @param opts buffer with TCP options
+ * @param opts_len size of the buffer
+ * @return the MSS of the option, 0 if the option is not present
+ */
+static u16_t tcp_parseopt_mss(u8_t *opts, u16_t opts_len)
+{
+    u16_t c;
+
+    for (c = 0; c < opts_len;) {
+        switch (opts[c]) {
+        case 0x02:
+            /* MSS */
+            if (opts[c + 1] != 0x04 || c + 0x04 > opts_len) {
+                /* Bad length */
+                LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+                return 0;
+            }
+            return (opts[c + 2] << 8) | opts[c + 3];
+        case 0x00:
+            /* End of options. */
+            return 0;
+        case 0x01:
+            /* NOP option. */
+            ++c;
+            break;
+        default:
+            if (c + 1 >= opts_len || opts[c + 1] == 0) {
+                LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+                /* If the length field is zero, the options are malformed
+                   and we don't process them further. */
+                return 0;
+            }
+            /* All other options have a length field, so that we easily
+               can skip past them. */
+            c += opts[c + 1];
+        }
+    }
+    return 0;
+}
+
 /**
  * Parses the options contained in the incoming segment.
  *
  * Called from tcp_listen_input(), tcp_process() and tcp_pcb_reuse().
- * Currently, only the MSS, window scaling and TIMESTAMP options are
- * supported!
+ * Currently, only the MSS, window scaling, SACK, TIMESTAMP and Fast Open options
+ * are supported!
  *
  * @param pcb the tcp_pcb for which a segment arrived
  */
@@ -1753,6 +2538,38 @@ static void tcp_parseopt(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 /* Advance to next option */
                 c += 0x03;
                 break;
+            case 0x04:
+                LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK PERMITTED\n"));
+                if (opts[c + 1] != 0x02 || (c + 0x02 > max_c)) {
+                    /* Bad length */
+                    LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+                    return;
+                }
+                if (pcb->enable_sack_opt && (in_data->flags & TCP_SYN)) {
+                    pcb->flags |= TF_SACK;
+                }
+                /* Advance to next option */
+                c += 0x02;
+                break;
+            case 0x05:
+                LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+                if (opts[c + 1] < 0x0A || ((opts[c + 1] - 2) & 0x07) || (c + opts[c + 1] > max_c)) {
+                    /* Bad length */
+                    LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+                    return;
+                }
+                if (pcb->flags & TF_SACK) {
+                    u8_t cnt = LWIP_MIN((u8_t)((opts[c + 1] - 2) >> 3), (u8_t)TCP_SACK_MAX_BLOCKS);
+                    for (in_data->sack_cnt = 0; in_data->sack_cnt < cnt; ++in_data->sack_cnt) {
+                        in_data->sack_blocks[2 * in_data->sack_cnt] =
+                            read32_be(&opts[c + 2 + 8 * in_data->sack_cnt]);
+                        in_data->sack_blocks[2 * in_data->sack_cnt + 1] =
+                            read32_be(&opts[c + 6 + 8 * in_data->sack_cnt]);
+                    }
+                }
+                /* Advance to next option */
+                c += opts[c + 1];
+                break;
 #if LWIP_TCP_TIMESTAMPS
             case 0x08:
                 LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: TS\n"));
@@ -1776,6 +2593,20 @@ static void tcp_parseopt(struct tcp_pcb *pcb, tcp_in_data *in_data)
                 c += 0x0A;
                 break;
 #endif
+            case 0x22:
+                LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: FAST OPEN\n"));
+                if (opts[c + 1] < 0x02 || (c + opts[c + 1] > max_c)) {
+                    /* Bad length */
+                    LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+                    return;
+                }
+                if (in_data->flags & TCP_SYN) {
+                    in_data->tfo_cookie = &opts[c + 2];
+                    in_data->tfo_cookie_len = opts[c + 1] - 2;
+                }
+                /* Advance to next option */
+                c += opts[c + 1];
+                break;
             default:
                 LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
                 if (opts[c + 1] == 0) {
@@ -41,6 +41,7 @@
 #include "core/lwip/opt.h"
 
 #include "core/lwip/tcp_impl.h"
+#include "core/util/instrumentation.h"
 
 #include <string.h>
 #include <errno.h>
@@ -83,6 +84,12 @@ void register_sys_now(sys_now_fn fn)
     sys_now = fn;
 }
 
+sys_now_us_fn sys_now_us;
+void register_sys_now_us(sys_now_us_fn fn)
+{
+    sys_now_us = fn;
+}
+
 ip_route_mtu_fn external_ip_route_mtu;
 
 void register_ip_route_mtu(ip_route_mtu_fn fn)
@@ -90,6 +97,55 @@ void register_ip_route_mtu(ip_route_mtu_fn fn)
     external_ip_route_mtu = fn;
 }
 
+static tcp_path_mtu_fn external_tcp_path_mtu;
+
+void register_tcp_path_mtu(tcp_path_mtu_fn fn)
+{
+    external_tcp_path_mtu = fn;
+}
+
+static tcp_path_mtu_update_fn external_tcp_path_mtu_update;
+
+void register_tcp_path_mtu_update(tcp_path_mtu_update_fn fn)
+{
+    external_tcp_path_mtu_update = fn;
+}
+
+static tcp_pacing_budget_fn external_tcp_pacing_budget;
+
+void register_tcp_pacing_budget(tcp_pacing_budget_fn fn)
+{
+    external_tcp_pacing_budget = fn;
+}
+
+static tcp_pacing_sent_fn external_tcp_pacing_sent;
+
+void register_tcp_pacing_sent(tcp_pacing_sent_fn fn)
+{
+    external_tcp_pacing_sent = fn;
+}
+
+static tcp_pacing_rate_fn external_tcp_pacing_rate;
+
+void register_tcp_pacing_rate(tcp_pacing_rate_fn fn)
+{
+    external_tcp_pacing_rate = fn;
+}
+
+static tcp_tmr_wake_fn external_tcp_tmr_wake;
+
+void register_tcp_tmr_wake(tcp_tmr_wake_fn fn)
+{
+    external_tcp_tmr_wake = fn;
+}
+
+void tcp_set_pacing_rate(struct tcp_pcb *pcb, u64_t rate)
+{
+    if (external_tcp_pacing_rate) {
+        external_tcp_pacing_rate(pcb, rate);
+    }
+}
+
 /* Forward declarations.*/
 static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb);
 
@@ -193,6 +249,10 @@ static struct tcp_seg *tcp_create_segment(struct tcp_pcb *pcb, struct pbuf *p, u
 
     seg->flags = optflags;
     seg->tcp_flags = flags;
+    seg->sack_state = 0;
+#if TCP_CC_ALGO_MOD
+    memset(&seg->rs, 0, sizeof(seg->rs));
+#endif
     seg->p = p;
     seg->len = p->tot_len - optlen;
     seg->seqno = seqno;
@@ -310,6 +370,8 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
     const bool is_file = (apiflags & TCP_WRITE_FILE) == TCP_WRITE_FILE;
     u32_t oversize_used = 0;
     u32_t mss_local = 0;
+    u32_t seglen_max = 0;
+    u8_t seg_clen = 0;
     const int piov_max_size = 512;
     const int piov_max_len = 65536;
     struct iovec piov[piov_max_size];
@@ -331,6 +393,7 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
     if (err != ERR_OK) {
         return err;
     }
+    tcp_ack_data_sent(pcb);
 
 #if LWIP_TCP_TIMESTAMPS
     if (pcb->flags & TF_TIMESTAMP) {
@@ -340,6 +403,7 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
     optlen = LWIP_TCP_OPT_LENGTH(optflags);
 
     mss_local = tcp_xmit_size_goal(pcb, 1);
+    seglen_max = tcp_tso(pcb) ? LWIP_MAX(pcb->tso.max_payload_sz, mss_local) : mss_local;
     if (is_file) {
         offset = offset_next = *(__off64_t *)arg;
     }
@@ -360,6 +424,10 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
      * mss_local never exceeds the physical buffer size. Therefore, we always
      * can create an mss_local sized segment with a single pbuf. There is no
      * point in supporting the case when we add an extra pbuf to the last_unsent.
+     *
+     * With TSO, a new segment chains up to seglen_max bytes of pbufs, so a bulk
+     * write doesn't create and merge a segment per buffer. tcp_split_rexmit()
+     * splits such a segment back to its pbufs if it is retransmitted.
      */
 
     if (pcb->last_unsent != NULL) {
@@ -370,11 +438,20 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
          * The actual copying is done at the bottom of the function.
          */
         const u16_t unsent_optlen = LWIP_TCP_OPT_LENGTH(pcb->last_unsent->flags);
-        if (!is_file && (pcb->last_unsent->p->type == PBUF_RAM) &&
-            (mss_local > pcb->last_unsent->len + unsent_optlen) &&
+        struct pbuf *tail = pcb->last_unsent->p;
+        u32_t tail_used;
+
+        while (tail->next) {
+            tail = tail->next;
+        }
+        /* The chained pbufs keep the room of the options in front of the data */
+        tail_used = (tail == pcb->last_unsent->p ? pcb->last_unsent->len : tail->len) +
+            unsent_optlen;
+        if (!is_file && (pcb->last_unsent->p->type == PBUF_RAM) && (mss_local > tail_used) &&
+            (seglen_max > pcb->last_unsent->len) &&
             (TCP_SEQ_GEQ(pcb->last_unsent->seqno, pcb->snd_nxt)) &&
             (pcb->last_unsent->seqno + pcb->last_unsent->len == pcb->snd_lbb)) {
-            oversize_used = mss_local - (pcb->last_unsent->len + unsent_optlen);
+            oversize_used = LWIP_MIN(mss_local - tail_used, seglen_max - pcb->last_unsent->len);
             oversize_used = LWIP_MIN(oversize_used, len);
             pos += oversize_used;
         }
@@ -421,17 +498,27 @@ err_t tcp_write(struct tcp_pcb *pcb, const void *arg, u32_t len, u16_t apiflags,
             memcpy((char *)p->payload + optlen, (u8_t *)arg + pos, seglen);
         }
 
-        seg = tcp_create_segment(pcb, p, 0, pcb->snd_lbb + pos, optflags);
-        if (!seg) {
-            tcp_tx_pbuf_free(pcb, p);
-            goto memerr;
-        }
-        if (queue == NULL) {
-            queue = seg;
+        if (tcp_tso(pcb) && prev_seg && prev_seg->len + seglen <= seglen_max &&
+            seg_clen < pcb->tso.max_send_sge) {
+            /* Extend the new segment, the options are in its first pbuf only */
+            pbuf_header(p, -(s32_t)optlen);
+            pbuf_cat(prev_seg->p, p);
+            prev_seg->len += seglen;
+            ++seg_clen;
         } else {
-            prev_seg->next = seg;
+            seg = tcp_create_segment(pcb, p, 0, pcb->snd_lbb + pos, optflags);
+            if (!seg) {
+                tcp_tx_pbuf_free(pcb, p);
+                goto memerr;
+            }
+            if (queue == NULL) {
+                queue = seg;
+            } else {
+                prev_seg->next = seg;
+            }
+            prev_seg = seg;
+            seg_clen = 1;
         }
-        prev_seg = seg;
 
         pos += seglen;
     }
@@ -519,11 +606,12 @@ err_t tcp_write_express(struct tcp_pcb *pcb, const struct iovec *iov, u32_t iovc
      * the end of the function. Some pcb fields are maintained in local copies.
      */
 
+    tcp_ack_data_sent(pcb);
     last = pcb->last_unsent;
-    const bool can_merge =
-        last && (last->flags & TF_SEG_OPTS_ZEROCOPY) && TCP_SEQ_GEQ(last->seqno, pcb->snd_nxt);
+    const bool can_merge = last && (last->flags & TF_SEG_OPTS_ZEROCOPY) &&
+        !(last->flags & TF_SEG_OPTS_NOMERGE) && TCP_SEQ_GEQ(last->seqno, pcb->snd_nxt);
     if (!can_merge) {
-        /* We cannot append data to a segment of different type or a retransmitted segment. */
+        /* We cannot append data to a segment of different type, no-merge or retransmitted. */
         last = NULL;
     }
     last_seglen = last ? last->len : 0;
@@ -696,6 +784,22 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
                 be sent if we received a window scale option from the remote host. */
             optflags |= TF_SEG_OPTS_WNDSCALE;
         }
+        if (pcb->enable_sack_opt && ((get_tcp_state(pcb) != SYN_RCVD) || (pcb->flags & TF_SACK))) {
+            /* The <SYN,ACK> follows whether the remote host permitted SACK. */
+            optflags |= TF_SEG_OPTS_SACK_PERM;
+        }
+        if (pcb->fastopen & TCP_TFO_OPT) {
+            /* A cookie or a cookie request in the <SYN>, a new cookie in the <SYN,ACK> */
+            optflags |= TF_SEG_OPTS_TFO;
+        }
+        if (tcp_ecn_wanted(pcb)) {
+            /* ECN setup: ECE and CWR in the <SYN>, ECE in the <SYN,ACK> of an ECN setup */
+            if (get_tcp_state(pcb) != SYN_RCVD) {
+                flags |= TCP_ECE | TCP_CWR;
+            } else if (pcb->flags & TF_ECN) {
+                flags |= TCP_ECE;
+            }
+        }
 #if LWIP_TCP_TIMESTAMPS
         if (pcb->enable_ts_opt && !(flags & TCP_ACK)) {
             // enable initial timestamp announcement only for the connecting side. accepting side
@@ -763,6 +867,58 @@ static void tcp_build_timestamp_option(struct tcp_pcb *pcb, u32_t *opts)
 }
 #endif
 
+/* Build a Fast Open option (RFC 7413) with the cookie of the pcb, or a cookie request
+ * if there is no cookie.
+ */
+static void tcp_build_fastopen_option(struct tcp_pcb *pcb, u32_t *opts)
+{
+    u8_t *opt = (u8_t *)opts + LWIP_TCP_OPT_LEN_TFO - 2 - pcb->tfo_cookie_len;
+
+    /* Pad with NOP options in front of the option */
+    memset(opts, 0x01, LWIP_TCP_OPT_LEN_TFO);
+    opt[0] = 0x22;
+    opt[1] = 2 + pcb->tfo_cookie_len;
+    memcpy(&opt[2], pcb->tfo_cookie, pcb->tfo_cookie_len);
+}
+
+/* Collect the SACK blocks of the out of sequence queue (RFC 2018).
+ * The block of the most recently received segment goes first, the others follow
+ * in sequence order.
+ *
+ * @param pcb tcp_pcb
+ * @param blocks left and right edges of the blocks in host byte order
+ * @param max maximum number of blocks
+ * @return number of blocks
+ */
+static u8_t tcp_build_sack_blocks(struct tcp_pcb *pcb, u32_t *blocks, u8_t max)
+{
+    u8_t n = 0;
+#if TCP_QUEUE_OOSEQ
+    s32_t recent = tcp_ooseq_find(pcb, pcb->rcv_sack_recent);
+    u32_t i;
+
+    if (recent >= 0 && TCP_SEQ_LT(pcb->rcv_sack_recent, pcb->ooseq_blocks[recent].right)) {
+        blocks[0] = pcb->ooseq_blocks[recent].left;
+        blocks[1] = pcb->ooseq_blocks[recent].right;
+        n = 1;
+    } else {
+        recent = -1;
+    }
+    for (i = 0; i < pcb->ooseq_blocks_cnt && n < max; ++i) {
+        if ((s32_t)i != recent) {
+            blocks[2 * n] = pcb->ooseq_blocks[i].left;
+            blocks[2 * n + 1] = pcb->ooseq_blocks[i].right;
+            ++n;
+        }
+    }
+#else
+    LWIP_UNUSED_ARG(pcb);
+    LWIP_UNUSED_ARG(blocks);
+    LWIP_UNUSED_ARG(max);
+#endif /* TCP_QUEUE_OOSEQ */
+    return n;
+}
+
 /** Send an ACK without data.
  *
  * @param pcb Protocol control block for the TCP connection to send the ACK
@@ -773,12 +929,22 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
     struct tcp_hdr *tcphdr;
     u8_t optlen = 0;
     u32_t *opts;
+    u32_t sack_blocks[2 * TCP_SACK_MAX_BLOCKS];
+    u8_t sack_cnt = 0;
+    u8_t i;
 
 #if LWIP_TCP_TIMESTAMPS
     if (pcb->flags & TF_TIMESTAMP) {
         optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
     }
 #endif
+    if (pcb->flags & TF_SACK) {
+        sack_cnt = tcp_build_sack_blocks(
+            pcb, sack_blocks, optlen ? TCP_SACK_MAX_BLOCKS_TS : TCP_SACK_MAX_BLOCKS);
+        if (sack_cnt) {
+            optlen += 4 + 8 * sack_cnt;
+        }
+    }
 
     p = tcp_output_alloc_header(pcb, optlen, 0, htonl(pcb->snd_nxt));
     if (p == NULL) {
@@ -786,9 +952,12 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
         return ERR_BUF;
     }
     tcphdr = (struct tcp_hdr *)p->payload;
+    if (pcb->flags & TF_ECN_ECHO) {
+        TCPH_SET_FLAG(tcphdr, TCP_ECE);
+    }
     LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
     /* remove ACK flags from the PCB, as we send an empty ACK now */
-    pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW);
+    pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW | TF_ACK_COALESCE);
 
     opts = (u32_t *)(void *)(tcphdr + 1);
 
@@ -801,6 +970,13 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
         opts += 3;
     }
 #endif
+    if (sack_cnt) {
+        /* Pad with two NOP options to keep the blocks aligned */
+        *opts++ = htonl(0x01010500 | (2 + 8 * sack_cnt));
+        for (i = 0; i < 2 * sack_cnt; ++i) {
+            *opts++ = htonl(sack_blocks[i]);
+        }
+    }
     pcb->ip_output(p, NULL, pcb, 0);
     tcp_tx_pbuf_free(pcb, p);
 
@@ -910,6 +1086,168 @@ err:
     return;
 }
 
+/* Path MTU discovery: MTU of an unknown destination and the floor of the black hole
+ * detection, search precision, probes of a size lost before the search stops below it,
+ * retransmission timeouts of a black hole and the delays of the next probe (RFC 4821) */
+#define TCP_MTUP_BASE_MTU       1500U
+#define TCP_MTUP_THRESHOLD      8
+#define TCP_MTUP_MAX_PROBES     3U
+#define TCP_MTUP_BLACKHOLE_RTX  2U
+#define TCP_MTUP_RETRY_MS       1000U
+#define TCP_MTUP_INTERVAL_MS    600000U
+
+static inline u16_t tcp_mtup_hdr_len(struct tcp_pcb *pcb)
+{
+    return pcb->is_ipv6 ? IPV6_HLEN + TCP_HLEN : IP_HLEN + TCP_HLEN;
+}
+
+/* The congestion window keeps its number of segments */
+static void tcp_mtup_set_mss(struct tcp_pcb *pcb, u16_t mss)
+{
+    if (pcb->mss != mss) {
+        pcb->cwnd = LWIP_MAX((u32_t)((u64_t)pcb->cwnd * mss / pcb->mss), mss);
+        pcb->mss = mss;
+    }
+}
+
+/* A search which narrowed the size down starts over after the interval */
+static void tcp_mtup_schedule(struct tcp_pcb *pcb, u32_t delay_ms)
+{
+    if (pcb->mtup_high - pcb->mtup_low < TCP_MTUP_THRESHOLD) {
+        pcb->mtup_high = pcb->mtup_max;
+        delay_ms = TCP_MTUP_INTERVAL_MS;
+    }
+    pcb->mtup_next_ms = sys_now() + delay_ms;
+}
+
+/**
+ * Starts the path MTU discovery of an established connection.
+ *
+ * The connection sends with the size cached for the destination or the one of the base
+ * MTU and probes up to its MSS. A lost probe is retransmitted by the segmentation offload
+ * with the smaller size, so the discovery needs TSO.
+ *
+ * @param pcb the tcp_pcb with the negotiated MSS
+ */
+void tcp_mtup_init(struct tcp_pcb *pcb)
+{
+    u16_t hdr_len = tcp_mtup_hdr_len(pcb);
+    u16_t mtu;
+
+    pcb->mtup_low = 0;
+    pcb->mtup_probe = 0;
+    if (!enable_mtu_probing_option || !tcp_tso(pcb)) {
+        return;
+    }
+
+    mtu = external_tcp_path_mtu ? external_tcp_path_mtu(pcb) : 0;
+    if (mtu <= hdr_len) {
+        mtu = TCP_MTUP_BASE_MTU;
+    }
+    pcb->mtup_max = pcb->mtup_high = pcb->mss;
+    pcb->mtup_low = LWIP_MIN(pcb->mss, mtu - hdr_len);
+    pcb->mtup_fails = 0;
+    pcb->mtup_next_ms = sys_now();
+    tcp_mtup_set_mss(pcb, pcb->mtup_low);
+}
+
+/**
+ * Checks whether the probe in flight is acknowledged.
+ *
+ * Called by tcp_receive() when the ACK advances.
+ *
+ * @param pcb the tcp_pcb with the path MTU discovery on
+ */
+void tcp_mtup_acked(struct tcp_pcb *pcb)
+{
+    if (!pcb->mtup_probe || TCP_SEQ_LT(pcb->lastack, pcb->mtup_probe_end)) {
+        return;
+    }
+
+    LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_mtup_acked: mss %" U16_F "\n", pcb->mtup_probe));
+    pcb->mtup_low = pcb->mtup_probe;
+    pcb->mtup_probe = 0;
+    pcb->mtup_fails = 0;
+    tcp_mtup_set_mss(pcb, pcb->mtup_low);
+    tcp_mtup_schedule(pcb, 0);
+    if (external_tcp_path_mtu_update) {
+        external_tcp_path_mtu_update(pcb, pcb->mtup_low + tcp_mtup_hdr_len(pcb));
+    }
+}
+
+static void tcp_mtup_lost(struct tcp_pcb *pcb)
+{
+    LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_mtup_lost: mss %" U16_F "\n", pcb->mtup_probe));
+    if (++pcb->mtup_fails >= TCP_MTUP_MAX_PROBES) {
+        pcb->mtup_high = pcb->mtup_probe - 1U;
+        pcb->mtup_fails = 0;
+    }
+    pcb->mtup_probe = 0;
+    tcp_mtup_schedule(pcb, TCP_MTUP_RETRY_MS);
+}
+
+/* A timeout loses the probe in flight, repeated ones halve the size of a black hole path */
+static void tcp_mtup_timeout(struct tcp_pcb *pcb)
+{
+    u16_t hdr_len = tcp_mtup_hdr_len(pcb);
+    u16_t base = LWIP_MIN(TCP_MTUP_BASE_MTU - hdr_len, pcb->mtup_max);
+
+    if (pcb->mtup_probe) {
+        if (TCP_SEQ_LT(pcb->lastack, pcb->mtup_probe_end)) {
+            tcp_mtup_lost(pcb);
+        }
+        return;
+    }
+    if (pcb->nrtx >= TCP_MTUP_BLACKHOLE_RTX && pcb->mtup_low > base) {
+        pcb->mtup_low = LWIP_MAX(pcb->mtup_low / 2U, base);
+        pcb->mtup_high = pcb->mtup_max;
+        pcb->mtup_fails = 0;
+        pcb->mtup_next_ms = sys_now() + TCP_MTUP_INTERVAL_MS;
+        tcp_mtup_set_mss(pcb, pcb->mtup_low);
+        LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_mtup_timeout: mss %" U16_F "\n", pcb->mss));
+        if (external_tcp_path_mtu_update) {
+            external_tcp_path_mtu_update(pcb, pcb->mtup_low + hdr_len);
+        }
+    }
+}
+
+/**
+ * Cuts the probe of the path MTU discovery from the head of new data.
+ *
+ * The probe is a single segment of the next size of the search. It is sent only with the
+ * data of the application, within the window and out of the loss recovery.
+ *
+ * @param pcb the tcp_pcb with the path MTU discovery on
+ * @param seg the first segment of new data
+ * @param wnd the window of tcp_output()
+ * @return the MSS of the probe, 0 if no probe is sent now
+ */
+static u16_t tcp_mtup_probe_cut(struct tcp_pcb *pcb, struct tcp_seg *seg, u32_t wnd)
+{
+    u16_t probe;
+    u32_t len;
+
+    if (pcb->mtup_probe || pcb->mtup_high - pcb->mtup_low < TCP_MTUP_THRESHOLD ||
+        (s32_t)(sys_now() - pcb->mtup_next_ms) < 0 || pcb->nrtx || (pcb->flags & TF_INFR) ||
+        get_tcp_state(pcb) != ESTABLISHED ||
+        (TCPH_FLAGS(seg->tcphdr) & ~(TCP_ACK | TCP_PSH))) {
+        return 0;
+    }
+
+    probe = pcb->mtup_low + (pcb->mtup_high - pcb->mtup_low + 1U) / 2U;
+    len = probe - LWIP_TCP_OPT_LENGTH(seg->flags);
+    if (seg->len < len || seg->seqno - pcb->lastack + len > wnd) {
+        return 0;
+    }
+    if (seg->len > len) {
+        tcp_split_segment(pcb, seg, seg->seqno - pcb->lastack + len);
+        if (seg->len != len) {
+            return 0;
+        }
+    }
+    return probe;
+}
+
 /**
  * Called by tcp_output() to split a retransmitted multi-pbuf segment. This is
  * done to handle spurious retransmissions concurrently with incoming TCP ACK.
@@ -1180,6 +1518,110 @@ s32_t tcp_is_wnd_available(struct tcp_pcb *pcb, u32_t data_len)
     return ((wnd - tot_unacked_len) >= (tot_unsent_len + (tot_opts_hdrs_len + (s32_t)data_len)));
 }
 
+/**
+ * Moves the first data of a Fast Open connection into the <SYN>.
+ *
+ * The copied data of the first unsent segment is merged up to the MSS of the
+ * previous connection to the peer. Zero copy data follows the handshake.
+ *
+ * @param pcb the connection in SYN_SENT with the <SYN> at the head of unsent
+ * @return 0 if the <SYN> waits for data, 1 if it can be sent
+ */
+static int tcp_fastopen_syn(struct tcp_pcb *pcb)
+{
+    struct tcp_seg *syn = pcb->unsent;
+    struct tcp_seg *seg = syn->next;
+    struct tcp_seg *newseg;
+    struct pbuf *p;
+    u8_t optlen = LWIP_TCP_OPT_LENGTH(syn->flags);
+    u32_t cap;
+
+    if (seg == NULL) {
+        return 0;
+    }
+    pcb->fastopen &= ~TCP_TFO_DATA;
+
+    if ((seg->flags & TF_SEG_OPTS_ZEROCOPY) || (seg->tcp_flags & TCP_FIN) ||
+        seg->p->type != PBUF_RAM || seg->p->desc.attr != PBUF_DESC_NONE) {
+        return 1;
+    }
+    cap = (pcb->tfo_mss ? LWIP_MIN(pcb->mss, pcb->tfo_mss) : pcb->mss) - optlen;
+    if (seg->len > cap) {
+        tcp_split_segment(pcb, seg, seg->seqno - pcb->lastack + cap);
+    }
+    if (seg->len > cap || seg->p->next) {
+        return 1;
+    }
+
+    p = tcp_pbuf_prealloc(optlen + seg->len, pcb, PBUF_RAM, NULL, NULL);
+    if (p == NULL) {
+        return 1;
+    }
+    newseg = tcp_create_segment(pcb, p, syn->tcp_flags, syn->seqno, syn->flags);
+    if (newseg == NULL) {
+        tcp_tx_pbuf_free(pcb, p);
+        return 1;
+    }
+    memcpy((u8_t *)newseg->tcphdr + LWIP_TCP_HDRLEN(newseg->tcphdr),
+           (u8_t *)seg->tcphdr + LWIP_TCP_HDRLEN(seg->tcphdr), seg->len);
+
+    newseg->next = seg->next;
+    pcb->unsent = newseg;
+    if (pcb->last_unsent == seg) {
+        pcb->last_unsent = newseg;
+    }
+    tcp_tx_seg_free(pcb, syn);
+    tcp_tx_seg_free(pcb, seg);
+    return 1;
+}
+
+/**
+ * Requeues the data of a <SYN> which the <SYN,ACK> didn't acknowledge.
+ *
+ * The segment is turned into a data segment in place, the <SYN> options leave
+ * enough room in front of the data for the header and the timestamp option.
+ *
+ * @param pcb the connection established by the <SYN,ACK>
+ * @param seg the <SYN> removed from the unacked queue
+ * @param acked number of data bytes acknowledged by the <SYN,ACK>
+ */
+void tcp_fastopen_requeue(struct tcp_pcb *pcb, struct tcp_seg *seg, u32_t acked)
+{
+    u8_t optflags = 0;
+    u8_t optlen;
+    u8_t *data = (u8_t *)seg->tcphdr + LWIP_TCP_HDRLEN(seg->tcphdr) + acked;
+    struct tcp_hdr *tcphdr;
+
+#if LWIP_TCP_TIMESTAMPS
+    if ((pcb->flags & TF_TIMESTAMP)) {
+        optflags |= TF_SEG_OPTS_TS;
+    }
+#endif /* LWIP_TCP_TIMESTAMPS */
+    optlen = LWIP_TCP_OPT_LENGTH(optflags);
+
+    tcphdr = (struct tcp_hdr *)(data - optlen - TCP_HLEN);
+    memmove(tcphdr, seg->tcphdr, TCP_HLEN);
+    pbuf_header(seg->p, -(s32_t)((u8_t *)tcphdr - (u8_t *)seg->p->payload));
+
+    seg->tcphdr = tcphdr;
+    seg->seqno += 1U + acked;
+    seg->len -= acked;
+    seg->flags = optflags;
+    seg->tcp_flags = 0;
+    seg->sack_state = 0;
+#if TCP_CC_ALGO_MOD
+    memset(&seg->rs, 0, sizeof(seg->rs));
+#endif
+    tcphdr->seqno = htonl(seg->seqno);
+    TCPH_HDRLEN_FLAGS_SET(tcphdr, (5 + optlen / 4), enable_push_flag ? TCP_PSH : 0);
+
+    seg->next = pcb->unsent;
+    pcb->unsent = seg;
+    if (pcb->last_unsent == NULL) {
+        pcb->last_unsent = seg;
+    }
+}
+
 /**
  * Find out what we can send and send it
  *
@@ -1190,12 +1632,19 @@ s32_t tcp_is_wnd_available(struct tcp_pcb *pcb, u32_t data_len)
 err_t tcp_output(struct tcp_pcb *pcb)
 {
     struct tcp_seg *seg, *useg;
-    u32_t wnd, snd_nxt;
+    u32_t wnd, snd_nxt, start_snd_nxt;
+    u16_t probe_mss;
     err_t rc = ERR_OK;
 #if TCP_CWND_DEBUG
     s16_t i = 0;
 #endif /* TCP_CWND_DEBUG */
 
+    XLIO_TRACE(tcp_output, pcb, pcb->snd_nxt, pcb->cwnd, pcb->snd_wnd);
+
+    if (unlikely(pcb->tmr_parked) && external_tcp_tmr_wake) {
+        external_tcp_tmr_wake(pcb);
+    }
+
     /* First, check if we are invoked by the TCP input processing
        code. If so, we do not output anything. Instead, we rely on the
        input processing code to call us when input processing is done
@@ -1204,7 +1653,23 @@ err_t tcp_output(struct tcp_pcb *pcb)
         return ERR_OK;
     }
 
+    if ((pcb->fastopen & TCP_TFO_DATA) && pcb->unsent && !tcp_fastopen_syn(pcb)) {
+        return ERR_OK;
+    }
+
     wnd = LWIP_MIN(pcb->snd_wnd, pcb->cwnd);
+    if (pcb->unsent && (pcb->unsent->tcp_flags & TCP_SYN) && pcb->unsent->len) {
+        /* The <SYN> with Fast Open data is sent whole */
+        wnd = LWIP_MAX(wnd, pcb->unsent->len);
+    }
+    start_snd_nxt = pcb->snd_nxt;
+    if (pcb->is_paced) {
+        /* The new data is limited by the tokens, in flight data is not accounted. */
+        u32_t budget = external_tcp_pacing_budget(pcb);
+        if (budget < wnd) {
+            wnd = LWIP_MIN(wnd, pcb->snd_nxt - pcb->lastack + budget);
+        }
+    }
 
     LWIP_DEBUGF(TCP_CWND_DEBUG,
                 ("tcp_output: snd_wnd %" U32_F ", cwnd %" U32_F ", wnd %" U32_F "\n", pcb->snd_wnd,
@@ -1271,6 +1736,17 @@ err_t tcp_output(struct tcp_pcb *pcb)
             tcp_split_segment(pcb, seg, wnd);
         }
 
+        /* A corked pcb keeps its new partial tail segment until the uncork or a FIN */
+        if (unlikely(pcb->flags & TF_CORK) && !seg->next && seg->len < pcb->mss &&
+            TCP_SEQ_GEQ(seg->seqno, pcb->snd_nxt) && !(pcb->flags & TF_FIN)) {
+            break;
+        }
+
+        probe_mss = 0;
+        if (unlikely(pcb->mtup_low) && TCP_SEQ_GEQ(seg->seqno, pcb->snd_nxt)) {
+            probe_mss = tcp_mtup_probe_cut(pcb, seg, wnd);
+        }
+
         /* data available and window allows it to be sent? */
         if (((seg->seqno - pcb->lastack + seg->len) <= wnd)) {
             LWIP_ASSERT("RST not expected here!", (TCPH_FLAGS(seg->tcphdr) & TCP_RST) == 0);
@@ -1297,9 +1773,9 @@ err_t tcp_output(struct tcp_pcb *pcb)
             }
 
             /* Use TSO send operation in case TSO is enabled
-             * and current segment is not retransmitted
+             * and current segment is not retransmitted or a probe
              */
-            if (tcp_tso(pcb)) {
+            if (tcp_tso(pcb) && !probe_mss) {
                 tcp_tso_segment(pcb, seg, wnd);
             }
 
@@ -1315,10 +1791,22 @@ err_t tcp_output(struct tcp_pcb *pcb)
 
             if (get_tcp_state(pcb) != SYN_SENT) {
                 TCPH_SET_FLAG(seg->tcphdr, TCP_ACK);
-                pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW);
+                pcb->flags &= ~(TF_ACK_DELAY | TF_ACK_NOW | TF_ACK_COALESCE);
             }
 
-            rc = tcp_output_segment(seg, pcb);
+            if (unlikely(probe_mss)) {
+                /* The MSS of the probe is in effect for this segment only */
+                pcb->mss = probe_mss;
+                rc = tcp_output_segment(seg, pcb);
+                pcb->mss = pcb->mtup_low;
+                if (rc == ERR_OK) {
+                    pcb->mtup_probe = probe_mss;
+                    pcb->mtup_probe_seq = seg->seqno;
+                    pcb->mtup_probe_end = seg->seqno + seg->len;
+                }
+            } else {
+                rc = tcp_output_segment(seg, pcb);
+            }
             if (rc != ERR_OK && pcb->unacked) {
                 /* Transmission failed, skip moving the segment to unacked, so we
                  * retry with the next tcp_output(). We must have at least one unacked
@@ -1379,6 +1867,12 @@ err_t tcp_output(struct tcp_pcb *pcb)
     if (pcb->unsent == NULL) {
         /* We have sent all pending segments, reset last_unsent */
         pcb->last_unsent = NULL;
+#if TCP_CC_ALGO_MOD
+        /* The window is not filled, the rate samples until the mark are app limited */
+        if (tcp_rate_enabled(pcb) && pcb->snd_nxt - pcb->lastack < pcb->cwnd) {
+            pcb->app_limited = LWIP_MAX(pcb->delivered + (pcb->snd_nxt - pcb->lastack), 1U);
+        }
+#endif
     }
 
     /* Send empty ACK if TF_ACK_NOW was set and no data was sent. */
@@ -1388,15 +1882,87 @@ err_t tcp_output(struct tcp_pcb *pcb)
 
     pcb->flags &= ~TF_NAGLEMEMERR;
 
+    if (pcb->is_paced) {
+        external_tcp_pacing_sent(pcb, pcb->snd_nxt - start_snd_nxt);
+    }
+
+    if (pcb->enable_rack_opt && pcb->snd_nxt != start_snd_nxt) {
+        tcp_tlp_arm(pcb, sys_now_us());
+    }
+
     // Fetch buffers for the next packet.
     if (!pcb->seg_alloc) {
         // Fetch tcp segment for the next packet.
         pcb->seg_alloc = tcp_create_segment(pcb, NULL, 0, 0, 0);
     }
 
+    tcp_limited_update(pcb, 0);
+
     return rc == ERR_WOULDBLOCK ? ERR_OK : rc;
 }
 
+static u8_t tcp_limited_state(const struct tcp_pcb *pcb)
+{
+    const struct tcp_seg *seg = pcb->unsent;
+
+    if (seg) {
+        u32_t end = seg->seqno - pcb->lastack + seg->len;
+
+        if (end > pcb->snd_wnd) {
+            return TCP_LIMITED_RWND;
+        }
+        return end > pcb->cwnd ? TCP_LIMITED_CWND : TCP_LIMITED_NONE;
+    }
+    if (pcb->unacked == NULL) {
+        return TCP_LIMITED_NONE;
+    }
+    return pcb->stats.sndbuf_full ? TCP_LIMITED_SNDBUF : TCP_LIMITED_APP;
+}
+
+/**
+ * Accounts the time since the previous update to the limit of the sender in
+ * effect then. The clock is read only when the limit changes, the timer of the
+ * connection flushes the ongoing period.
+ *
+ * @param pcb the tcp_pcb to account
+ * @param flush account the ongoing period even if the limit didn't change
+ */
+void tcp_limited_update(struct tcp_pcb *pcb, u8_t flush)
+{
+    u8_t limited = tcp_limited_state(pcb);
+    u32_t now;
+
+    if (limited == pcb->stats.limited && !flush) {
+        return;
+    }
+    now = sys_now_us();
+    if (pcb->stats.limited != TCP_LIMITED_NONE) {
+        pcb->stats.limited_usec[pcb->stats.limited] += now - pcb->stats.limited_since;
+    }
+    pcb->stats.limited = limited;
+    pcb->stats.limited_since = now;
+}
+
+#if TCP_CC_ALGO_MOD
+/* Snapshots the delivery state of the connection for the rate sample of the segment */
+static void tcp_rate_seg_sent(struct tcp_pcb *pcb, struct tcp_seg *seg)
+{
+    u32_t now = sys_now_us();
+
+    if (pcb->unacked == NULL) {
+        /* Nothing in flight, the sampling restarts from now */
+        pcb->first_sent_time = now;
+        pcb->delivered_time = now;
+    }
+    seg->rs.delivered = pcb->delivered;
+    seg->rs.delivered_time = pcb->delivered_time;
+    seg->rs.first_sent_time = pcb->first_sent_time;
+    seg->rs.sent_time = now;
+    seg->rs.flags = (pcb->app_limited ? TF_SEG_RS_APP_LIMITED : 0) |
+        (TCP_SEQ_LT(seg->seqno, pcb->snd_nxt) ? TF_SEG_RS_REXMIT : 0);
+}
+#endif
+
 /**
  * Called by tcp_output() to actually send a TCP segment over IP.
  *
@@ -1425,6 +1991,18 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 
     pcb->rcv_ann_right_edge = pcb->rcv_nxt + pcb->rcv_ann_wnd;
 
+    if ((pcb->flags & TF_ECN) && !(seg->tcp_flags & TCP_SYN)) {
+        /* The header may keep the ECN flags of a previous transmission */
+        TCPH_UNSET_FLAG(seg->tcphdr, TCP_ECE | TCP_CWR);
+        if (pcb->flags & TF_ECN_ECHO) {
+            TCPH_SET_FLAG(seg->tcphdr, TCP_ECE);
+        }
+        if ((pcb->flags & TF_ECN_CWR) && seg->len && !TCP_SEQ_LT(seg->seqno, pcb->snd_nxt)) {
+            TCPH_SET_FLAG(seg->tcphdr, TCP_CWR);
+            pcb->flags &= ~TF_ECN_CWR;
+        }
+    }
+
     /* Add any requested options.  NB MSS option is only set on SYN
        packets, so ignore it here */
     LWIP_ASSERT("seg->tcphdr not aligned", ((uintptr_t)(seg->tcphdr + 1) % 4) == 0);
@@ -1442,6 +2020,16 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
                 // we added 1 byte NOOP padding => total 4 bytes
     }
 
+    if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+        TCP_BUILD_SACK_PERM_OPTION(*opts);
+        opts++; // The option is 2 bytes long + 2 bytes NOOP padding
+    }
+
+    if (seg->flags & TF_SEG_OPTS_TFO) {
+        tcp_build_fastopen_option(pcb, opts);
+        opts += LWIP_TCP_OPT_LEN_TFO / 4;
+    }
+
 #if LWIP_TCP_TIMESTAMPS
     pcb->ts_lastacksent = pcb->rcv_nxt;
 
@@ -1507,7 +2095,22 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
     flags |= (TCP_SEQ_LT(seg->seqno, pcb->snd_nxt) ? TCP_WRITE_REXMIT : 0);
     flags |= seg->flags & TF_SEG_OPTS_ZEROCOPY;
 
-    return pcb->ip_output(p, seg, pcb, flags);
+#if TCP_CC_ALGO_MOD
+    if (seg->len && tcp_rate_enabled(pcb)) {
+        tcp_rate_seg_sent(pcb, seg);
+    }
+#endif
+    if (pcb->enable_rack_opt) {
+        seg->xmit_time = sys_now_us();
+        if (TCP_SEQ_LT(seg->seqno, pcb->snd_nxt)) {
+            seg->sack_state |= TF_SEG_RACK_REXMIT;
+        }
+    }
+
+    err_t rc = pcb->ip_output(p, seg, pcb, flags);
+    /* A later retransmission of the segment is not driven by the scoreboard */
+    seg->sack_state &= ~TF_SEG_SACK_REXMIT;
+    return rc;
 }
 
 /**
@@ -1583,22 +2186,38 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
         return;
     }
 
-    if (pcb->unsent != NULL && TCP_SEQ_GT(pcb->unacked->seqno, pcb->unsent->seqno)) {
-        // Move fast-retransmitted segments to unacked - RTO after fast retransmission
-        struct tcp_seg *rexmit_start = pcb->unsent;
-        struct tcp_seg *rexmit_end = pcb->unsent;
-        while (rexmit_end->next != NULL &&
-               TCP_SEQ_GT(pcb->unacked->seqno, rexmit_end->next->seqno)) {
-            rexmit_end = rexmit_end->next;
-        }
+    /* The timeout ends the tail loss probe, all the outstanding data is sent again */
+    pcb->rack_tmr = 0;
+    pcb->tlp_outstanding = 0;
 
-        pcb->unsent = rexmit_end->next;
+    if (pcb->unsent != NULL && TCP_SEQ_LT(pcb->unsent->seqno, pcb->snd_nxt)) {
+        // Merge fast-retransmitted segments to unacked - RTO after fast retransmission.
+        // SACK recovery retransmits holes from the middle of the unacked queue.
+        struct tcp_seg **cur_seg = &(pcb->unacked);
+        while (pcb->unsent != NULL && TCP_SEQ_LT(pcb->unsent->seqno, pcb->snd_nxt)) {
+            struct tcp_seg *seg = pcb->unsent;
+            pcb->unsent = seg->next;
+            while (*cur_seg && TCP_SEQ_LT((*cur_seg)->seqno, seg->seqno)) {
+                cur_seg = &((*cur_seg)->next);
+            }
+            seg->next = *cur_seg;
+            *cur_seg = seg;
+            if (seg->next == NULL) {
+                pcb->last_unacked = seg;
+            }
+        }
         if (pcb->unsent == NULL) {
             pcb->last_unsent = NULL;
         }
+    }
 
-        rexmit_end->next = pcb->unacked;
-        pcb->unacked = rexmit_start;
+    if (pcb->flags & TF_SACK) {
+        /* The remote host may discard the SACKed data, forget the scoreboard (RFC 2018) */
+        struct tcp_seg *seg;
+        for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+            seg->sack_state = 0;
+        }
+        pcb->sack_high = pcb->lastack;
     }
 
     /* Move all unacked segments to the head of the unsent queue */
@@ -1620,35 +2239,35 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
     /* Don't take any RTT measurements after retransmitting. */
     pcb->rttest = 0;
 
+    if (pcb->mtup_low) {
+        tcp_mtup_timeout(pcb);
+    }
+
     /* Do the actual retransmission */
     tcp_output(pcb);
 }
 
 /**
- * Requeue the first unacked segment for retransmission
- *
- * Called by tcp_receive() for fast retramsmit.
+ * Move an unacked segment to the unsent queue for retransmission
  *
- * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ * @param pcb the tcp_pcb for which to retransmit the segment
+ * @param prev the unacked segment preceding seg or NULL for the first one
+ * @param seg the unacked segment to retransmit
  */
-void tcp_rexmit(struct tcp_pcb *pcb)
+static void tcp_rexmit_seg(struct tcp_pcb *pcb, struct tcp_seg *prev, struct tcp_seg *seg)
 {
-    struct tcp_seg *seg;
     struct tcp_seg **cur_seg;
 
-    if (pcb->unacked == NULL) {
-        return;
+    if (prev) {
+        prev->next = seg->next;
+    } else {
+        pcb->unacked = seg->next;
     }
-
-    /* Move the first unacked segment to the unsent queue */
-    /* Keep the unsent queue sorted. */
-    seg = pcb->unacked;
-
-    pcb->unacked = pcb->unacked->next;
-    if (NULL == pcb->unacked) {
-        pcb->last_unacked = NULL;
+    if (pcb->last_unacked == seg) {
+        pcb->last_unacked = prev;
     }
 
+    /* Keep the unsent queue sorted. */
     cur_seg = &(pcb->unsent);
     while (*cur_seg && TCP_SEQ_LT((*cur_seg)->seqno, seg->seqno)) {
         cur_seg = &((*cur_seg)->next);
@@ -1664,6 +2283,96 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 
     /* Don't take any rtt measurements after retransmitting. */
     pcb->rttest = 0;
+
+    if (pcb->mtup_probe && TCP_SEQ_LT(seg->seqno, pcb->mtup_probe_end) &&
+        TCP_SEQ_GT(seg->seqno + seg->len, pcb->mtup_probe_seq)) {
+        tcp_mtup_lost(pcb);
+    }
+}
+
+/**
+ * Requeue the first unacked segment for retransmission
+ *
+ * Called by tcp_receive() for fast retramsmit.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the first unacked segment
+ */
+void tcp_rexmit(struct tcp_pcb *pcb)
+{
+    if (pcb->unacked == NULL) {
+        return;
+    }
+
+    tcp_rexmit_seg(pcb, NULL, pcb->unacked);
+}
+
+/**
+ * Requeue the next hole of the SACK scoreboard for retransmission
+ *
+ * The hole is the first unacked segment below the highest SACKed sequence number
+ * which is neither SACKed nor already retransmitted in the current recovery.
+ * Called by tcp_receive() during the fast recovery of a SACK connection.
+ *
+ * @param pcb the tcp_pcb for which to retransmit the next hole
+ */
+void tcp_rexmit_sack(struct tcp_pcb *pcb)
+{
+    struct tcp_seg *prev = NULL;
+    struct tcp_seg *seg;
+    u32_t start = TCP_SEQ_GT(pcb->sack_rexmit_high, pcb->lastack) ? pcb->sack_rexmit_high
+                                                                   : pcb->lastack;
+
+    for (seg = pcb->unacked; seg != NULL; prev = seg, seg = seg->next) {
+        if (TCP_SEQ_GEQ(seg->seqno, pcb->sack_high)) {
+            return;
+        }
+        if (TCP_SEQ_GEQ(seg->seqno, start) && !(seg->sack_state & TF_SEG_SACKED)) {
+            break;
+        }
+    }
+    if (seg == NULL) {
+        return;
+    }
+
+    LWIP_DEBUGF(TCP_FR_DEBUG,
+                ("tcp_rexmit_sack: hole %" U32_F ":%" U32_F ", sack_high %" U32_F "\n", seg->seqno,
+                 seg->seqno + seg->len, pcb->sack_high));
+    pcb->sack_rexmit_high = seg->seqno + seg->len;
+    seg->sack_state |= TF_SEG_SACK_REXMIT;
+    tcp_rexmit_seg(pcb, prev, seg);
+}
+
+/**
+ * Reduces the congestion window for a loss and enters the fast recovery
+ *
+ * @param pcb the tcp_pcb which detected the loss
+ */
+static void tcp_enter_recovery(struct tcp_pcb *pcb)
+{
+#if TCP_CC_ALGO_MOD
+    cc_cong_signal(pcb, CC_NDUPACK);
+#else
+    /* Set ssthresh to half of the minimum of the current
+     * cwnd and the advertised window */
+    if (pcb->cwnd > pcb->snd_wnd) {
+        pcb->ssthresh = pcb->snd_wnd / 2;
+    } else {
+        pcb->ssthresh = pcb->cwnd / 2;
+    }
+
+    /* The minimum value for ssthresh should be 2 MSS */
+    if (pcb->ssthresh < (2U * pcb->mss)) {
+        LWIP_DEBUGF(TCP_FR_DEBUG,
+                    ("tcp_receive: The minimum value for ssthresh %" U16_F
+                     " should be min 2 mss %" U16_F "...\n",
+                     pcb->ssthresh, 2 * pcb->mss));
+        pcb->ssthresh = 2 * pcb->mss;
+    }
+
+    pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
+#endif
+    pcb->flags |= TF_INFR;
+    ++pcb->stats.n_recovery;
 }
 
 /**
@@ -1678,30 +2387,165 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
         LWIP_DEBUGF(TCP_FR_DEBUG,
                     ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n",
                      (u16_t)pcb->dupacks, pcb->lastack, pcb->unacked->seqno));
-        tcp_rexmit(pcb);
-#if TCP_CC_ALGO_MOD
-        cc_cong_signal(pcb, CC_NDUPACK);
-#else
-        /* Set ssthresh to half of the minimum of the current
-         * cwnd and the advertised window */
-        if (pcb->cwnd > pcb->snd_wnd) {
-            pcb->ssthresh = pcb->snd_wnd / 2;
+        if ((pcb->flags & TF_SACK) && TCP_SEQ_GT(pcb->sack_high, pcb->lastack)) {
+            tcp_rexmit_sack(pcb);
         } else {
-            pcb->ssthresh = pcb->cwnd / 2;
+            tcp_rexmit(pcb);
         }
+        tcp_enter_recovery(pcb);
+    }
+}
 
-        /* The minimum value for ssthresh should be 2 MSS */
-        if (pcb->ssthresh < (2U * pcb->mss)) {
-            LWIP_DEBUGF(TCP_FR_DEBUG,
-                        ("tcp_receive: The minimum value for ssthresh %" U16_F
-                         " should be min 2 mss %" U16_F "...\n",
-                         pcb->ssthresh, 2 * pcb->mss));
-            pcb->ssthresh = 2 * pcb->mss;
+/**
+ * Requeues for retransmission the unacked segments sent a reordering window
+ * before the most recently sent delivered segment (RACK, RFC 8985). The
+ * reordering timer is armed for the segments which are not marked lost yet.
+ * The congestion window is reduced once per window of data.
+ *
+ * @param pcb the tcp_pcb for which to detect the losses
+ * @param now current time in usec
+ */
+void tcp_rack_detect_loss(struct tcp_pcb *pcb, u32_t now)
+{
+    struct tcp_seg *prev = NULL;
+    struct tcp_seg *seg;
+    struct tcp_seg *next;
+    u32_t reo_wnd = LWIP_MIN(pcb->rack_min_rtt / 4U, pcb->rack_srtt);
+    s32_t timeout = 0;
+
+    for (seg = pcb->unacked; seg != NULL; seg = next) {
+        s32_t remaining;
+
+        next = seg->next;
+        if ((seg->sack_state & TF_SEG_SACKED) ||
+            !tcp_rack_sent_after(pcb->rack_xmit_time, pcb->rack_end_seq, seg->xmit_time,
+                                 seg->seqno + TCP_SEGLEN(seg))) {
+            prev = seg;
+            continue;
+        }
+        remaining = (s32_t)(seg->xmit_time + pcb->rack_rtt + reo_wnd - now);
+        if (remaining > 0) {
+            timeout = LWIP_MAX(timeout, remaining);
+            prev = seg;
+            continue;
         }
 
-        pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
-#endif
-        pcb->flags |= TF_INFR;
+        LWIP_DEBUGF(TCP_FR_DEBUG,
+                    ("tcp_rack_detect_loss: lost %" U32_F ":%" U32_F "\n", seg->seqno,
+                     seg->seqno + seg->len));
+        if (!(pcb->flags & TF_INFR) && TCP_SEQ_GEQ(seg->seqno, pcb->rack_recover)) {
+            tcp_enter_recovery(pcb);
+            pcb->rack_recover = pcb->snd_nxt;
+        }
+        if (TCP_SEQ_GT(seg->seqno + seg->len, pcb->sack_rexmit_high)) {
+            /* The SACK recovery doesn't retransmit the segment again */
+            pcb->sack_rexmit_high = seg->seqno + seg->len;
+        }
+        tcp_rexmit_seg(pcb, prev, seg);
+    }
+
+    if (timeout > 0) {
+        pcb->rack_tmr = TCP_RACK_TMR_REO;
+        pcb->rack_tmr_expire = now + (u32_t)timeout;
+    } else if (pcb->rack_tmr == TCP_RACK_TMR_REO) {
+        pcb->rack_tmr = 0;
+    }
+}
+
+/**
+ * Arms the tail loss probe timer, about two round trips after the latest
+ * transmission. The probe is armed in the open state of a SACK connection only.
+ *
+ * @param pcb the tcp_pcb for which to arm the probe
+ * @param now current time in usec
+ */
+void tcp_tlp_arm(struct tcp_pcb *pcb, u32_t now)
+{
+    u32_t pto;
+
+    if (pcb->rack_tmr == TCP_RACK_TMR_REO) {
+        /* The pending losses are detected first */
+        return;
+    }
+    pcb->rack_tmr = 0;
+    if (pcb->unacked == NULL || pcb->tlp_outstanding || !(pcb->flags & TF_SACK) ||
+        (pcb->flags & TF_INFR) || get_tcp_state(pcb) < ESTABLISHED) {
+        return;
+    }
+
+    if (pcb->rack_srtt) {
+        pto = 2U * pcb->rack_srtt;
+        if (pcb->snd_nxt - pcb->lastack <= pcb->mss) {
+            /* The ACK of a single segment may be delayed by the remote host */
+            pto += TCP_TLP_WCDELACK_US;
+        }
+    } else {
+        pto = TCP_TLP_INIT_PTO_US;
+    }
+    pcb->rack_tmr = TCP_RACK_TMR_TLP;
+    pcb->rack_tmr_expire = now + pto;
+}
+
+/**
+ * Sends the tail loss probe: new data if the windows allow it, the last unacked
+ * segment otherwise. The ACK of the probe triggers the loss detection of the tail.
+ *
+ * @param pcb the tcp_pcb for which to send the probe
+ */
+static void tcp_tlp_send_probe(struct tcp_pcb *pcb)
+{
+    u32_t snd_nxt = pcb->snd_nxt;
+
+    if (pcb->unacked == NULL) {
+        return;
+    }
+
+    pcb->tlp_outstanding = 1;
+    pcb->tlp_rexmit = 0;
+    ++pcb->stats.n_tlp;
+    tcp_output(pcb);
+    if (pcb->snd_nxt == snd_nxt && pcb->unacked != NULL) {
+        struct tcp_seg *prev = NULL;
+        struct tcp_seg *seg = pcb->unacked;
+        u8_t nrtx = pcb->nrtx;
+
+        while (seg->next != NULL) {
+            prev = seg;
+            seg = seg->next;
+        }
+        LWIP_DEBUGF(TCP_FR_DEBUG,
+                    ("tcp_tlp_send_probe: %" U32_F ":%" U32_F "\n", seg->seqno,
+                     seg->seqno + seg->len));
+        tcp_rexmit_seg(pcb, prev, seg);
+        /* The probe doesn't back off the retransmission timeout */
+        pcb->nrtx = nrtx;
+        pcb->tlp_rexmit = 1;
+        tcp_output(pcb);
+    }
+    pcb->tlp_high_seq = pcb->snd_nxt;
+}
+
+/**
+ * Handles the expiration of the RACK reordering and of the tail loss probe timers.
+ *
+ * Called by tcp_fasttmr()
+ *
+ * @param pcb the tcp_pcb with an armed RACK-TLP timer
+ */
+void tcp_rack_tmr(struct tcp_pcb *pcb)
+{
+    u32_t now = sys_now_us();
+    u8_t tmr = pcb->rack_tmr;
+
+    if ((s32_t)(now - pcb->rack_tmr_expire) < 0) {
+        return;
+    }
+    pcb->rack_tmr = 0;
+    if (tmr == TCP_RACK_TMR_REO) {
+        tcp_rack_detect_loss(pcb, now);
+        tcp_output(pcb);
+    } else {
+        tcp_tlp_send_probe(pcb);
     }
 }
 
@@ -23,6 +23,7 @@
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 
 #include "vlogger/vlogger.h"
 #include "utils/compiler.h"
@@ -30,6 +31,9 @@
 #include "util/xlio_stats.h"
 #include "util/hugepage_mgr.h"
 #include "util/utils.h"
+#include "util/trace_ring.h"
+#include "util/lock_prof.h"
+#include "util/coarse_clock.h"
 #include "event/event_handler_manager.h"
 #include "event/poll_group.h"
 #include "event/vlogger_timer_handler.h"
@@ -38,6 +42,7 @@
 #include "dev/net_device_table_mgr.h"
 #include "proto/ip_frag.h"
 #include "proto/xlio_lwip.h"
+#include "proto/dst_path.h"
 #include "proto/route_table_mgr.h"
 #include "proto/rule_table_mgr.h"
 #include "proto/mapping.h"
@@ -51,6 +56,7 @@
 #include "sock/sock-app.h"
 #include "sock/fd_collection.h"
 #include "sock/sockinfo_tcp.h"
+#include "sock/sockinfo_pool.h"
 #include "sock/sockinfo_udp.h"
 #include "sock/bind_no_port.h"
 #include "iomux/io_mux_call.h"
@@ -102,6 +108,11 @@ static int free_libxlio_resources()
 
     worker_thread_manager::destroy();
 
+    // The last events of the run for a post-mortem analysis
+    if (g_trace_ring_events) {
+        trace_ring_dump(safe_mce_sys().stats_shmem_dirname);
+    }
+
     if (safe_mce_sys().print_report != option_3::OFF) {
         bool print_only_critical = (safe_mce_sys().print_report == option_3::AUTO);
         buffer_pool::print_full_report(VLOG_INFO, print_only_critical);
@@ -148,6 +159,11 @@ static int free_libxlio_resources()
     }
     g_p_lwip = nullptr;
 
+    if (g_p_dst_path_table) {
+        delete g_p_dst_path_table;
+    }
+    g_p_dst_path_table = nullptr;
+
     if (g_p_route_table_mgr) {
         delete g_p_route_table_mgr;
     }
@@ -168,12 +184,6 @@ static int free_libxlio_resources()
     }
     g_p_net_device_table_mgr = nullptr;
 
-    ip_frag_manager *g_p_ip_frag_manager_temp = g_p_ip_frag_manager;
-    g_p_ip_frag_manager = nullptr;
-    if (g_p_ip_frag_manager_temp) {
-        delete g_p_ip_frag_manager_temp;
-    }
-
     if (g_p_neigh_table_mgr) {
         delete g_p_neigh_table_mgr;
     }
@@ -199,6 +209,11 @@ static int free_libxlio_resources()
     }
     g_buffer_pool_rx_stride = nullptr;
 
+    if (g_buffer_pool_rx_hdr) {
+        delete g_buffer_pool_rx_hdr;
+    }
+    g_buffer_pool_rx_hdr = nullptr;
+
     if (g_buffer_pool_rx_rwqe) {
         delete g_buffer_pool_rx_rwqe;
     }
@@ -347,6 +362,21 @@ void check_locked_mem()
     }
 }
 
+const char *sw_pacing_mode_str(sw_pacing_mode_t sw_pacing_mode)
+{
+    switch (sw_pacing_mode) {
+    case SW_PACING_DISABLE:
+        return "(Hardware pacing only)";
+    case SW_PACING_FALLBACK:
+        return "(Software pacing if hardware fails)";
+    case SW_PACING_ALWAYS:
+        return "(Software pacing only)";
+    default:
+        break;
+    }
+    return "";
+}
+
 const char *buffer_batching_mode_str(buffer_batching_mode_t buffer_batching_mode)
 {
     switch (buffer_batching_mode) {
@@ -454,6 +484,19 @@ void print_env_vars_xlio_global_settings()
         vlog_printf(VLOG_INFO, FORMAT_STRING, "Spec",
                     xlio_spec::to_str((xlio_spec_t)safe_mce_sys().mce_spec), SYS_VAR_SPEC);
     }
+    if (safe_mce_sys().auto_profile != option_auto_profile::NONE) {
+        // The parameters it has chosen are printed below with the others
+        vlog_printf(VLOG_INFO, FORMAT_STRING, "Auto profile",
+                    option_auto_profile::to_str(safe_mce_sys().auto_profile),
+                    SYS_VAR_AUTO_PROFILE);
+        vlog_printf(VLOG_INFO,
+                    "Auto profile hardware: %ld CPUs, %d NUMA nodes, %d active ports up to %u "
+                    "Gb/s, %zu MB of free hugepages\n",
+                    safe_mce_sys().auto_profile_hw.cpus, safe_mce_sys().auto_profile_hw.numa_nodes,
+                    safe_mce_sys().auto_profile_hw.ports,
+                    safe_mce_sys().auto_profile_hw.max_rate_gbps,
+                    safe_mce_sys().auto_profile_hw.hugepages_free >> 20U);
+    }
 
     VLOG_STR_PARAM_STRING("Log Level", log_level::to_str(safe_mce_sys().log_level), "",
                           SYS_VAR_LOG_LEVEL, log_level::to_str(safe_mce_sys().log_level));
@@ -461,6 +504,10 @@ void print_env_vars_xlio_global_settings()
                       SYS_VAR_LOG_DETAILS);
     VLOG_PARAM_STRING("Log Colors", safe_mce_sys().log_colors, MCE_DEFAULT_LOG_COLORS,
                       SYS_VAR_LOG_COLORS, safe_mce_sys().log_colors ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Log Async", safe_mce_sys().log_async, MCE_DEFAULT_LOG_ASYNC,
+                      SYS_VAR_LOG_ASYNC, safe_mce_sys().log_async ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("Log Rate Limit", safe_mce_sys().log_rate_limit, MCE_DEFAULT_LOG_RATE_LIMIT,
+                      SYS_VAR_LOG_RATE_LIMIT);
     VLOG_STR_PARAM_STRING("Log File", safe_mce_sys().log_filename, MCE_DEFAULT_LOG_FILE,
                           SYS_VAR_LOG_FILENAME, safe_mce_sys().log_filename);
     VLOG_STR_PARAM_STRING("Stats File", safe_mce_sys().stats_filename, MCE_DEFAULT_STATS_FILE,
@@ -478,6 +525,16 @@ void print_env_vars_xlio_global_settings()
     VLOG_PARAM_STRING("Polling CPU idle usage", safe_mce_sys().select_handle_cpu_usage_stats,
                       MCE_DEFAULT_SELECT_CPU_USAGE_STATS, SYS_VAR_SELECT_CPU_USAGE_STATS,
                       safe_mce_sys().select_handle_cpu_usage_stats ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Latency histograms", safe_mce_sys().stats_latency_hist,
+                      MCE_DEFAULT_STATS_LATENCY_HIST, SYS_VAR_STATS_LATENCY_HIST,
+                      safe_mce_sys().stats_latency_hist ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Lock profiling", safe_mce_sys().stats_lock_profiling,
+                      MCE_DEFAULT_STATS_LOCK_PROFILING, SYS_VAR_STATS_LOCK_PROFILING,
+                      safe_mce_sys().stats_lock_profiling ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("Trace ring events", safe_mce_sys().stats_trace_ring_events,
+                      MCE_DEFAULT_STATS_TRACE_RING_EVENTS, SYS_VAR_STATS_TRACE_RING_EVENTS);
+    VLOG_PARAM_NUMBER("Mirror ring slots", safe_mce_sys().stats_mirror_ring_slots,
+                      MCE_DEFAULT_STATS_MIRROR_RING_SLOTS, SYS_VAR_STATS_MIRROR_RING_SLOTS);
     VLOG_PARAM_STRING("SigIntr Ctrl-C Handle", safe_mce_sys().handle_sigintr,
                       MCE_DEFAULT_HANDLE_SIGINTR, SYS_VAR_HANDLE_SIGINTR,
                       safe_mce_sys().handle_sigintr ? "Enabled " : "Disabled");
@@ -526,10 +583,30 @@ void print_env_vars_xlio_global_settings()
 
     VLOG_PARAM_NUMBER("Ring On Device Memory TX", safe_mce_sys().ring_dev_mem_tx,
                       MCE_DEFAULT_RING_DEV_MEM_TX, SYS_VAR_RING_DEV_MEM_TX);
+    VLOG_PARAM_STRING("Ring On Device Memory TX shared", safe_mce_sys().ring_dev_mem_tx_shared,
+                      MCE_DEFAULT_RING_DEV_MEM_TX_SHARED, SYS_VAR_RING_DEV_MEM_TX_SHARED,
+                      safe_mce_sys().ring_dev_mem_tx_shared ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Ring per priority TX", safe_mce_sys().ring_per_priority_tx,
+                      MCE_DEFAULT_RING_PER_PRIORITY_TX, SYS_VAR_RING_PER_PRIORITY_TX,
+                      safe_mce_sys().ring_per_priority_tx ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Ring bond warm standby", safe_mce_sys().ring_bond_warm_standby,
+                      MCE_DEFAULT_RING_BOND_WARM_STANDBY, SYS_VAR_RING_BOND_WARM_STANDBY,
+                      safe_mce_sys().ring_bond_warm_standby ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Ring NUMA aware", safe_mce_sys().ring_numa_aware,
+                      MCE_DEFAULT_RING_NUMA_AWARE, SYS_VAR_RING_NUMA_AWARE,
+                      safe_mce_sys().ring_numa_aware ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("Ring precreate threads", safe_mce_sys().ring_precreate_threads,
+                      MCE_DEFAULT_RING_PRECREATE_THREADS, SYS_VAR_RING_PRECREATE_THREADS);
+    VLOG_PARAM_NUMBER("Ring core pool size", safe_mce_sys().ring_core_pool_size,
+                      MCE_DEFAULT_RING_CORE_POOL_SIZE, SYS_VAR_RING_CORE_POOL_SIZE);
+    VLOG_PARAM_NUMSTR("TX software pacing", safe_mce_sys().tx_sw_pacing, MCE_DEFAULT_TX_SW_PACING,
+                      SYS_VAR_TX_SW_PACING, sw_pacing_mode_str(safe_mce_sys().tx_sw_pacing));
 
     VLOG_PARAM_STRING("Zerocopy Cache Threshold", safe_mce_sys().zc_cache_threshold,
                       MCE_DEFAULT_ZC_CACHE_THRESHOLD, SYS_VAR_ZC_CACHE_THRESHOLD,
                       option_size::to_str(safe_mce_sys().zc_cache_threshold));
+    VLOG_PARAM_NUMBER("Zerocopy Cache Max Files", safe_mce_sys().zc_cache_max_files,
+                      MCE_DEFAULT_ZC_CACHE_MAX_FILES, SYS_VAR_ZC_CACHE_MAX_FILES);
     VLOG_PARAM_STRING("Tx Mem Buf size", safe_mce_sys().tx_buf_size, MCE_DEFAULT_TX_BUF_SIZE,
                       SYS_VAR_TX_BUF_SIZE, option_size::to_str(safe_mce_sys().tx_buf_size));
     VLOG_PARAM_NUMBER("Tx QP WRE", safe_mce_sys().tx_num_wr, MCE_DEFAULT_TX_NUM_WRE,
@@ -538,6 +615,8 @@ void print_env_vars_xlio_global_settings()
                       MCE_DEFAULT_TX_NUM_WRE_TO_SIGNAL, SYS_VAR_TX_NUM_WRE_TO_SIGNAL);
     VLOG_PARAM_NUMBER("Tx Max QP INLINE", safe_mce_sys().tx_max_inline, MCE_DEFAULT_TX_MAX_INLINE,
                       SYS_VAR_TX_MAX_INLINE);
+    VLOG_PARAM_NUMBER("Tx BlueFlame burst", safe_mce_sys().tx_bf_burst, MCE_DEFAULT_TX_BF_BURST,
+                      SYS_VAR_TX_BF_BURST);
     VLOG_PARAM_STRING("Tx MC Loopback", safe_mce_sys().tx_mc_loopback_default,
                       MCE_DEFAULT_TX_MC_LOOPBACK, SYS_VAR_TX_MC_LOOPBACK,
                       safe_mce_sys().tx_mc_loopback_default ? "Enabled " : "Disabled");
@@ -552,9 +631,20 @@ void print_env_vars_xlio_global_settings()
                       MCE_DEFAULT_TX_SEGS_BATCH_TCP, SYS_VAR_TX_SEGS_BATCH_TCP);
     VLOG_PARAM_NUMBER("Tx Segs Ring Batch TCP", safe_mce_sys().tx_segs_ring_batch_tcp,
                       MCE_DEFAULT_TX_SEGS_RING_BATCH_TCP, SYS_VAR_TX_SEGS_RING_BATCH_TCP);
+    VLOG_PARAM_NUMBER("Group Buf Cache Batch", safe_mce_sys().group_buf_cache_batch,
+                      MCE_DEFAULT_GROUP_BUF_CACHE_BATCH, SYS_VAR_GROUP_BUF_CACHE_BATCH);
+    VLOG_PARAM_NUMBER("Group Buf Cache Size", safe_mce_sys().group_buf_cache_size,
+                      MCE_DEFAULT_GROUP_BUF_CACHE_SIZE, SYS_VAR_GROUP_BUF_CACHE_SIZE);
     VLOG_PARAM_STRING("TCP Send Buffer size", safe_mce_sys().tcp_send_buffer_size,
                       MCE_DEFAULT_TCP_SEND_BUFFER_SIZE, SYS_VAR_TCP_SEND_BUFFER_SIZE,
                       option_size::to_str(safe_mce_sys().tcp_send_buffer_size));
+    VLOG_PARAM_STRING("TCP Send Buffer autotune limit",
+                      safe_mce_sys().tcp_send_buffer_autotune_limit,
+                      MCE_DEFAULT_TCP_SEND_BUFFER_AUTOTUNE_LIMIT,
+                      SYS_VAR_TCP_SEND_BUFFER_AUTOTUNE_LIMIT,
+                      option_size::to_str(safe_mce_sys().tcp_send_buffer_autotune_limit));
+    VLOG_PARAM_NUMBER("TCP Socket Pool size", safe_mce_sys().tcp_socket_pool_size,
+                      MCE_DEFAULT_TCP_SOCKET_POOL_SIZE, SYS_VAR_TCP_SOCKET_POOL_SIZE);
     VLOG_PARAM_NUMBER(
         "Rx QP WRE", safe_mce_sys().rx_num_wr,
         (safe_mce_sys().enable_striding_rq ? MCE_DEFAULT_STRQ_NUM_WRE : MCE_DEFAULT_RX_NUM_WRE),
@@ -563,6 +653,10 @@ void print_env_vars_xlio_global_settings()
                       (safe_mce_sys().enable_striding_rq ? MCE_DEFAULT_STRQ_NUM_WRE_TO_POST_RECV
                                                          : MCE_DEFAULT_RX_NUM_WRE_TO_POST_RECV),
                       SYS_VAR_RX_NUM_WRE_TO_POST_RECV);
+    VLOG_PARAM_NUMBER("Rx QP WRE Shared", safe_mce_sys().rx_num_wr_shared,
+                      MCE_DEFAULT_RX_NUM_WRE_SHARED, SYS_VAR_RX_NUM_WRE_SHARED);
+    VLOG_PARAM_NUMBER("Rx Header Split Size", safe_mce_sys().rx_hdr_split_size,
+                      MCE_DEFAULT_RX_HDR_SPLIT_SIZE, SYS_VAR_RX_HDR_SPLIT_SIZE);
     VLOG_PARAM_NUMBER("Rx Byte Min Limit", safe_mce_sys().rx_ready_byte_min_limit,
                       MCE_DEFAULT_RX_BYTE_MIN_LIMIT, SYS_VAR_RX_BYTE_MIN_LIMIT);
     VLOG_PARAM_NUMBER("Rx Poll Loops", safe_mce_sys().rx_poll_num, MCE_DEFAULT_RX_NUM_POLLS,
@@ -594,6 +688,14 @@ void print_env_vars_xlio_global_settings()
     VLOG_PARAM_NUMBER("Rx Prefetch Bytes Before Poll", safe_mce_sys().rx_prefetch_bytes_before_poll,
                       MCE_DEFAULT_RX_PREFETCH_BYTES_BEFORE_POLL,
                       SYS_VAR_RX_PREFETCH_BYTES_BEFORE_POLL);
+    VLOG_PARAM_NUMBER("Rx Prefetch Depth", safe_mce_sys().rx_prefetch_depth,
+                      MCE_DEFAULT_RX_PREFETCH_DEPTH, SYS_VAR_RX_PREFETCH_DEPTH);
+    VLOG_PARAM_NUMBER("Rx Compact Threshold", safe_mce_sys().rx_compact_threshold,
+                      MCE_DEFAULT_RX_COMPACT_THRESHOLD, SYS_VAR_RX_COMPACT_THRESHOLD);
+    VLOG_PARAM_NUMBER("Rx Compact Max Size", safe_mce_sys().rx_compact_max_size,
+                      MCE_DEFAULT_RX_COMPACT_MAX_SIZE, SYS_VAR_RX_COMPACT_MAX_SIZE);
+    VLOG_PARAM_NUMBER("Rx WAITALL Placement Min", safe_mce_sys().rx_waitall_placement_min,
+                      MCE_DEFAULT_RX_WAITALL_PLACEMENT_MIN, SYS_VAR_RX_WAITALL_PLACEMENT_MIN);
 
     if (safe_mce_sys().rx_cq_drain_rate_nsec == MCE_RX_CQ_DRAIN_RATE_DISABLED) {
         VLOG_PARAM_STRING("Rx CQ Drain Rate", safe_mce_sys().rx_cq_drain_rate_nsec,
@@ -605,6 +707,8 @@ void print_env_vars_xlio_global_settings()
 
     VLOG_PARAM_NUMBER("GRO max streams", safe_mce_sys().gro_streams_max,
                       MCE_DEFAULT_GRO_STREAMS_MAX, SYS_VAR_GRO_STREAMS_MAX);
+    VLOG_PARAM_NUMBER("GRO flush usec", safe_mce_sys().gro_flush_usec, MCE_DEFAULT_GRO_FLUSH_USEC,
+                      SYS_VAR_GRO_FLUSH_USEC);
     VLOG_PARAM_NUMBER("Disable flow tag", safe_mce_sys().disable_flow_tag,
                       MCE_DEFAULT_DISABLE_FLOW_TAG, SYS_VAR_DISABLE_FLOW_TAG);
 
@@ -612,8 +716,12 @@ void print_env_vars_xlio_global_settings()
                       SYS_VAR_TCP_2T_RULES, safe_mce_sys().tcp_2t_rules ? "Enabled " : "Disabled");
     VLOG_PARAM_STRING("TCP 3T rules", safe_mce_sys().tcp_3t_rules, MCE_DEFAULT_TCP_3T_RULES,
                       SYS_VAR_TCP_3T_RULES, safe_mce_sys().tcp_3t_rules ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("TCP deferred rules (msec)", safe_mce_sys().tcp_deferred_rules_msec,
+                      MCE_DEFAULT_TCP_DEFERRED_RULES_MSEC, SYS_VAR_TCP_DEFERRED_RULES_MSEC);
     VLOG_PARAM_STRING("UDP 3T rules", safe_mce_sys().udp_3t_rules, MCE_DEFAULT_UDP_3T_RULES,
                       SYS_VAR_UDP_3T_RULES, safe_mce_sys().udp_3t_rules ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("UDP reuseport buckets", safe_mce_sys().udp_reuseport_buckets,
+                      MCE_DEFAULT_UDP_REUSEPORT_BUCKETS, SYS_VAR_UDP_REUSEPORT_BUCKETS);
     VLOG_PARAM_STRING("ETH MC L2 only rules", safe_mce_sys().eth_mc_l2_only_rules,
                       MCE_DEFAULT_ETH_MC_L2_ONLY_RULES, SYS_VAR_ETH_MC_L2_ONLY_RULES,
                       safe_mce_sys().eth_mc_l2_only_rules ? "Enabled " : "Disabled");
@@ -631,8 +739,13 @@ void print_env_vars_xlio_global_settings()
     VLOG_PARAM_NUMBER(
         "STRQ Strides Compensation Level", safe_mce_sys().strq_strides_compensation_level,
         MCE_DEFAULT_STRQ_STRIDES_COMPENSATION_LEVEL, SYS_VAR_STRQ_STRIDES_COMPENSATION_LEVEL);
+    VLOG_PARAM_STRING("STRQ Auto Geometry", safe_mce_sys().strq_auto_geometry,
+                      MCE_DEFAULT_STRQ_AUTO_GEOMETRY, SYS_VAR_STRQ_AUTO_GEOMETRY,
+                      safe_mce_sys().strq_auto_geometry ? "Enabled " : "Disabled");
     VLOG_PARAM_NUMBER("Select Poll (usec)", safe_mce_sys().select_poll_num,
                       MCE_DEFAULT_SELECT_NUM_POLLS, SYS_VAR_SELECT_NUM_POLLS);
+    VLOG_PARAM_NUMBER("Adaptive Poll", safe_mce_sys().poll_adaptive, MCE_DEFAULT_POLL_ADAPTIVE,
+                      SYS_VAR_POLL_ADAPTIVE);
 
     if (safe_mce_sys().select_poll_os_ratio) {
         VLOG_PARAM_NUMBER("Select Poll OS Ratio", safe_mce_sys().select_poll_os_ratio,
@@ -684,6 +797,8 @@ void print_env_vars_xlio_global_settings()
     VLOG_PARAM_NUMBER(
         "CQ AIM Interrupts Rate (per sec)", safe_mce_sys().cq_aim_interrupts_rate_per_sec,
         MCE_DEFAULT_CQ_AIM_INTERRUPTS_RATE_PER_SEC, SYS_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC);
+    VLOG_PARAM_NUMBER("CQ AIM Target Latency (usec)", safe_mce_sys().cq_aim_target_latency_usec,
+                      MCE_DEFAULT_CQ_AIM_TARGET_LATENCY_USEC, SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC);
 
     VLOG_PARAM_NUMBER("CQ Poll Batch (max)", safe_mce_sys().cq_poll_batch_max,
                       MCE_DEFAULT_CQ_POLL_BATCH, SYS_VAR_CQ_POLL_BATCH_MAX);
@@ -711,6 +826,31 @@ void print_env_vars_xlio_global_settings()
                       MCE_DEFAULT_TCP_NODELAY_TRESHOLD, SYS_VAR_TCP_NODELAY_TRESHOLD);
     VLOG_PARAM_NUMBER("TCP quickack", safe_mce_sys().tcp_quickack, MCE_DEFAULT_TCP_QUICKACK,
                       SYS_VAR_TCP_QUICKACK);
+    VLOG_PARAM_NUMBER("TCP SACK", safe_mce_sys().tcp_sack, MCE_DEFAULT_TCP_SACK, SYS_VAR_TCP_SACK);
+    VLOG_PARAM_NUMBER("TCP ECN", safe_mce_sys().tcp_ecn, MCE_DEFAULT_TCP_ECN, SYS_VAR_TCP_ECN);
+    VLOG_PARAM_NUMBER("TCP RACK", safe_mce_sys().tcp_rack, MCE_DEFAULT_TCP_RACK, SYS_VAR_TCP_RACK);
+    VLOG_PARAM_NUMBER("TCP SYN cookies", safe_mce_sys().tcp_syncookies, MCE_DEFAULT_TCP_SYNCOOKIES,
+                      SYS_VAR_TCP_SYNCOOKIES);
+    VLOG_PARAM_NUMBER("TCP Fast Open", safe_mce_sys().tcp_fastopen, MCE_DEFAULT_TCP_FASTOPEN,
+                      SYS_VAR_TCP_FASTOPEN);
+    VLOG_PARAM_NUMBER("TCP compact TIME_WAIT", safe_mce_sys().tcp_timewait_compact,
+                      MCE_DEFAULT_TCP_TIMEWAIT_COMPACT, SYS_VAR_TCP_TIMEWAIT_COMPACT);
+    VLOG_PARAM_NUMBER("TCP park idle timers", safe_mce_sys().tcp_timer_park_idle,
+                      MCE_DEFAULT_TCP_TIMER_PARK_IDLE, SYS_VAR_TCP_TIMER_PARK_IDLE);
+    VLOG_PARAM_NUMBER("TCP rcvbuf autotuning", safe_mce_sys().tcp_moderate_rcvbuf,
+                      MCE_DEFAULT_TCP_MODERATE_RCVBUF, SYS_VAR_TCP_MODERATE_RCVBUF);
+    VLOG_PARAM_NUMBER("TCP ACK coalescing", safe_mce_sys().tcp_ack_coalesce,
+                      MCE_DEFAULT_TCP_ACK_COALESCE, SYS_VAR_TCP_ACK_COALESCE);
+    VLOG_PARAM_NUMBER("TCP adaptive delayed ACK", safe_mce_sys().tcp_ack_adaptive,
+                      MCE_DEFAULT_TCP_ACK_ADAPTIVE, SYS_VAR_TCP_ACK_ADAPTIVE);
+    VLOG_PARAM_NUMBER("TCP cork timeout (msec)", safe_mce_sys().tcp_cork_timeout_msec,
+                      MCE_DEFAULT_TCP_CORK_TIMEOUT_MSEC, SYS_VAR_TCP_CORK_TIMEOUT_MSEC);
+    VLOG_PARAM_NUMBER("TCP MTU probing", safe_mce_sys().tcp_mtu_probing,
+                      MCE_DEFAULT_TCP_MTU_PROBING, SYS_VAR_TCP_MTU_PROBING);
+    VLOG_PARAM_NUMBER("UDP dst cache size", safe_mce_sys().udp_dst_cache_size,
+                      MCE_DEFAULT_UDP_DST_CACHE_SIZE, SYS_VAR_UDP_DST_CACHE_SIZE);
+    VLOG_PARAM_NUMBER("Path cache size", safe_mce_sys().path_cache_size,
+                      MCE_DEFAULT_PATH_CACHE_SIZE, SYS_VAR_PATH_CACHE_SIZE);
     VLOG_PARAM_NUMSTR(xlio_exception_handling::getName(), (int)safe_mce_sys().exception_handling,
                       xlio_exception_handling::MODE_DEFAULT, xlio_exception_handling::getSysVar(),
                       safe_mce_sys().exception_handling.to_str());
@@ -743,6 +883,22 @@ void print_env_vars_xlio_global_settings()
                       option_size::to_str(safe_mce_sys().memory_limit_user));
     VLOG_PARAM_STRING("Hugepage size", safe_mce_sys().hugepage_size, MCE_DEFAULT_HUGEPAGE_SIZE,
                       SYS_VAR_HUGEPAGE_SIZE, option_size::to_str(safe_mce_sys().hugepage_size));
+    VLOG_PARAM_NUMBER("Hugepage prefault threads", safe_mce_sys().hugepage_prefault_threads,
+                      MCE_DEFAULT_HUGEPAGE_PREFAULT_THREADS, SYS_VAR_HUGEPAGE_PREFAULT_THREADS);
+    VLOG_STR_PARAM_STRING("Hugepage persistent file", safe_mce_sys().hugepage_persistent_file,
+                          MCE_DEFAULT_HUGEPAGE_PERSISTENT_FILE, SYS_VAR_HUGEPAGE_PERSISTENT_FILE,
+                          safe_mce_sys().hugepage_persistent_file);
+    VLOG_PARAM_NUMBER("Hugepage fork slices", safe_mce_sys().hugepage_fork_slices,
+                      MCE_DEFAULT_HUGEPAGE_FORK_SLICES, SYS_VAR_HUGEPAGE_FORK_SLICES);
+    VLOG_PARAM_STRING("Hugepage work queues", safe_mce_sys().hugepage_queues,
+                      MCE_DEFAULT_HUGEPAGE_QUEUES, SYS_VAR_HUGEPAGE_QUEUES,
+                      safe_mce_sys().hugepage_queues ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("Buffer pool shrink (msec)", safe_mce_sys().buffer_pool_shrink_msec,
+                      MCE_DEFAULT_BUFFER_POOL_SHRINK_MSEC, SYS_VAR_BUFFER_POOL_SHRINK_MSEC);
+    VLOG_PARAM_NUMBER("RX pool low watermark", safe_mce_sys().rx_pool_low_watermark,
+                      MCE_DEFAULT_RX_POOL_LOW_WATERMARK, SYS_VAR_RX_POOL_LOW_WATERMARK);
+    VLOG_PARAM_NUMBER("RX socket buffers max", safe_mce_sys().rx_socket_bufs_max,
+                      MCE_DEFAULT_RX_SOCKET_BUFS_MAX, SYS_VAR_RX_SOCKET_BUFS_MAX);
 
     VLOG_PARAM_NUMBER("Num of UC ARPs", safe_mce_sys().neigh_uc_arp_quata,
                       MCE_DEFAULT_NEIGH_UC_ARP_QUATA, SYS_VAR_NEIGH_UC_ARP_QUATA);
@@ -750,6 +906,11 @@ void print_env_vars_xlio_global_settings()
                       MCE_DEFAULT_NEIGH_UC_ARP_DELAY_MSEC, SYS_VAR_NEIGH_UC_ARP_DELAY_MSEC);
     VLOG_PARAM_NUMBER("Num of neigh restart retries", safe_mce_sys().neigh_num_err_retries,
                       MCE_DEFAULT_NEIGH_NUM_ERR_RETRIES, SYS_VAR_NEIGH_NUM_ERR_RETRIES);
+    VLOG_PARAM_NUMBER("Neigh refresh (msec)", safe_mce_sys().neigh_refresh_msec,
+                      MCE_DEFAULT_NEIGH_REFRESH_MSEC, SYS_VAR_NEIGH_REFRESH_MSEC);
+    VLOG_STR_PARAM_STRING("Neigh pre-resolve", safe_mce_sys().neigh_preresolve,
+                          MCE_DEFAULT_NEIGH_PRERESOLVE, SYS_VAR_NEIGH_PRERESOLVE,
+                          safe_mce_sys().neigh_preresolve);
     /* coverity[returned_null][dereference] */
     VLOG_STR_PARAM_STRING("TSO support", option_3::to_str(safe_mce_sys().enable_tso),
                           option_3::to_str(MCE_DEFAULT_TSO), SYS_VAR_TSO,
@@ -760,6 +921,15 @@ void print_env_vars_xlio_global_settings()
     VLOG_STR_PARAM_STRING("LRO support", option_3::to_str(safe_mce_sys().enable_lro),
                           option_3::to_str(MCE_DEFAULT_LRO), SYS_VAR_LRO,
                           option_3::to_str(safe_mce_sys().enable_lro));
+    VLOG_PARAM_STRING("MPWQE support", safe_mce_sys().enable_mpwqe, MCE_DEFAULT_MPWQE,
+                      SYS_VAR_MPWQE, safe_mce_sys().enable_mpwqe ? "Enabled " : "Disabled");
+    VLOG_PARAM_NUMBER("MPWQE max packet size", safe_mce_sys().mpwqe_max_pkt_size,
+                      MCE_DEFAULT_MPWQE_MAX_PKT_SIZE, SYS_VAR_MPWQE_MAX_PKT_SIZE);
+    VLOG_PARAM_STRING("RX CQE compression", safe_mce_sys().rx_cqe_compression,
+                      MCE_DEFAULT_RX_CQE_COMPRESSION, SYS_VAR_RX_CQE_COMPRESSION,
+                      safe_mce_sys().rx_cqe_compression ? "Enabled " : "Disabled");
+    VLOG_PARAM_STRING("Implicit ODP", safe_mce_sys().implicit_odp, MCE_DEFAULT_IMPLICIT_ODP,
+                      SYS_VAR_IMPLICIT_ODP, safe_mce_sys().implicit_odp ? "Enabled " : "Disabled");
 #ifdef DEFINED_UTLS
     VLOG_PARAM_STRING("UTLS RX support", safe_mce_sys().enable_utls_rx, MCE_DEFAULT_UTLS_RX,
                       SYS_VAR_UTLS_RX, safe_mce_sys().enable_utls_rx ? "Enabled " : "Disabled");
@@ -773,6 +943,11 @@ void print_env_vars_xlio_global_settings()
                       static_cast<uint32_t>(safe_mce_sys().utls_low_wmark_dek_cache_size),
                       MCE_DEFAULT_UTLS_LOW_WMARK_DEK_CACHE_SIZE,
                       SYS_VAR_UTLS_LOW_WMARK_DEK_CACHE_SIZE);
+    VLOG_PARAM_NUMBER("UTLS DEK pool size",
+                      static_cast<uint32_t>(safe_mce_sys().utls_dek_pool_size),
+                      MCE_DEFAULT_UTLS_DEK_POOL_SIZE, SYS_VAR_UTLS_DEK_POOL_SIZE);
+    VLOG_PARAM_NUMBER("UTLS TX coalesce size", safe_mce_sys().utls_tx_coalesce_size,
+                      MCE_DEFAULT_UTLS_TX_COALESCE_SIZE, SYS_VAR_UTLS_TX_COALESCE_SIZE);
 #endif /* DEFINED_UTLS */
 #if defined(DEFINED_NGINX)
     VLOG_PARAM_NUMBER("Number of Nginx workers",
@@ -844,6 +1019,19 @@ void print_env_vars_xlio_global_settings()
                       (safe_mce_sys().multilock == MULTILOCK_SPIN ? "Spin " : "Mutex"));
     VLOG_PARAM_NUMBER("Worker Threads", safe_mce_sys().worker_threads, MCE_DEFAULT_WORKER_THREADS,
                       SYS_VAR_WORKER_THREADS);
+    VLOG_PARAM_NUMBER("Worker Threads Placement", safe_mce_sys().worker_placement,
+                      MCE_DEFAULT_WORKER_PLACEMENT, SYS_VAR_WORKER_PLACEMENT);
+    VLOG_PARAM_NUMBER("Worker Threads Listen Buckets", safe_mce_sys().worker_listen_buckets,
+                      MCE_DEFAULT_WORKER_LISTEN_BUCKETS, SYS_VAR_WORKER_LISTEN_BUCKETS);
+    VLOG_STR_PARAM_STRING("Worker Threads Affinity", safe_mce_sys().worker_affinity_str,
+                          MCE_DEFAULT_WORKER_AFFINITY_STR, SYS_VAR_WORKER_AFFINITY,
+                          safe_mce_sys().worker_affinity_str);
+    VLOG_PARAM_NUMBER("Worker Threads Park (msec)", safe_mce_sys().worker_park_msec,
+                      MCE_DEFAULT_WORKER_PARK_MSEC, SYS_VAR_WORKER_PARK_MSEC);
+    VLOG_PARAM_NUMBER("Worker Threads Idle Pause (usec)", safe_mce_sys().worker_idle_pause_usec,
+                      MCE_DEFAULT_WORKER_IDLE_PAUSE_USEC, SYS_VAR_WORKER_IDLE_PAUSE_USEC);
+    VLOG_PARAM_NUMBER("Worker Threads Idle Block (usec)", safe_mce_sys().worker_idle_block_usec,
+                      MCE_DEFAULT_WORKER_IDLE_BLOCK_USEC, SYS_VAR_WORKER_IDLE_BLOCK_USEC);
     vlog_printf(VLOG_INFO,
                 "---------------------------------------------------------------------------\n");
 }
@@ -1056,8 +1244,45 @@ static void process_acceleration_rules()
         vlog_printf(VLOG_DEBUG, "FAILED to read library configuration file: %s\n",
                     safe_mce_sys().acceleration_rules);
     }
+    // The rules parsed before a failure are used as well
+    __xlio_compile_rules();
 }
 
+/*
+ * Reports the duration of the initialization phases, so startup regressions can be
+ * tracked with the debug log.
+ */
+class init_phase_timer {
+public:
+    init_phase_timer()
+        : m_start(std::chrono::steady_clock::now())
+        , m_last(m_start)
+    {
+    }
+
+    void phase_done(const char *phase)
+    {
+        auto now = std::chrono::steady_clock::now();
+        vlog_printf(VLOG_DEBUG, "Init phase %-16s %10lld usec\n", phase, to_usec(now - m_last));
+        m_last = now;
+    }
+
+    void all_done()
+    {
+        phase_done("stack");
+        vlog_printf(VLOG_DEBUG, "Init phases total      %10lld usec\n", to_usec(m_last - m_start));
+    }
+
+private:
+    static long long to_usec(std::chrono::steady_clock::duration duration)
+    {
+        return (long long)std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
+
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_last;
+};
+
 static void do_global_ctors_helper()
 {
     static lock_spin_recursive g_globals_lock;
@@ -1070,6 +1295,7 @@ static void do_global_ctors_helper()
     PROFILE_BLOCK("xlio_ctors")
 
     g_init_global_ctors_done = true;
+    init_phase_timer phases;
     set_env_params();
     prepare_fork();
 
@@ -1082,6 +1308,12 @@ static void do_global_ctors_helper()
     }
 
     xlio_heap::initialize();
+    coarse_clock_init();
+    if (safe_mce_sys().hugepage_fork_slices && !safe_mce_sys().user_alloc.memalloc) {
+        // A no-op in the children, they inherit the slices of the parent
+        g_hugepage_mgr.prepare_fork_slices(safe_mce_sys().hugepage_fork_slices,
+                                           safe_mce_sys().memory_limit);
+    }
 
 #if defined(DEFINED_NGINX) || defined(DEFINED_ENVOY)
     NEW_CTOR(g_p_app, app_conf());
@@ -1110,9 +1342,14 @@ static void do_global_ctors_helper()
     *g_p_vlogger_details = g_vlogger_details;
 
     sock_stats::init_instance(safe_mce_sys().stats_fd_num_max);
+    trace_ring_init(safe_mce_sys().stats_trace_ring_events);
+    lock_prof_init(safe_mce_sys().stats_lock_profiling);
+    sockinfo_pool::init_instances(sizeof(sockinfo_tcp), safe_mce_sys().tcp_socket_pool_size,
+                                  sizeof(sockinfo_udp));
 
     g_global_stat_static.init();
     xlio_stats_instance_create_global_block(&g_global_stat_static);
+    phases.phase_done("event handler");
 
     // Create new netlink listener
     NEW_CTOR(g_p_netlink_handler, netlink_wrapper());
@@ -1120,6 +1357,7 @@ static void do_global_ctors_helper()
     NEW_CTOR(g_p_ib_ctx_handler_collection, ib_ctx_handler_collection());
 
     NEW_CTOR(g_p_net_device_table_mgr, net_device_table_mgr());
+    phases.phase_done("devices");
 
     NEW_CTOR(g_p_neigh_table_mgr, neigh_table_mgr());
 
@@ -1127,18 +1365,32 @@ static void do_global_ctors_helper()
 
     NEW_CTOR(g_p_route_table_mgr, route_table_mgr());
 
+    NEW_CTOR(g_p_dst_path_table, dst_path_table());
+
+    if (safe_mce_sys().neigh_preresolve[0]) {
+        g_p_neigh_table_mgr->preresolve(safe_mce_sys().neigh_preresolve);
+    }
+
     NEW_CTOR(g_bind_no_port, bind_no_port());
 
-    NEW_CTOR(g_zc_cache, mapping_cache(safe_mce_sys().zc_cache_threshold));
+    NEW_CTOR(g_zc_cache, mapping_cache(safe_mce_sys().zc_cache_threshold,
+                                         safe_mce_sys().zc_cache_max_files));
+    phases.phase_done("routing");
 
     if (safe_mce_sys().rx_buf_size <=
         get_lwip_tcp_mss(g_p_net_device_table_mgr->get_max_mtu(), safe_mce_sys().lwip_mss)) {
         safe_mce_sys().rx_buf_size = 0;
     }
 
+    // The RX payloads land in the RWQE buffers, also with Striding RQ
+    bool rx_user_alloc = safe_mce_sys().user_alloc.rx_memalloc;
     NEW_CTOR(g_buffer_pool_rx_rwqe,
              buffer_pool(BUFFER_POOL_RX, calc_rx_wqe_buff_size(),
-                         safe_mce_sys().user_alloc.memalloc, safe_mce_sys().user_alloc.memfree));
+                         rx_user_alloc ? safe_mce_sys().user_alloc.rx_memalloc
+                                       : safe_mce_sys().user_alloc.memalloc,
+                         rx_user_alloc ? safe_mce_sys().user_alloc.rx_memfree
+                                       : safe_mce_sys().user_alloc.memfree));
+    g_buffer_pool_rx_rwqe->set_low_watermark(safe_mce_sys().rx_pool_low_watermark);
 
     if (safe_mce_sys().enable_striding_rq) {
         NEW_CTOR(g_buffer_pool_rx_stride, buffer_pool(BUFFER_POOL_RX, 0));
@@ -1147,6 +1399,12 @@ static void do_global_ctors_helper()
         g_buffer_pool_rx_ptr = g_buffer_pool_rx_rwqe;
     }
 
+    if (safe_mce_sys().rx_hdr_split_size) {
+        NEW_CTOR(g_buffer_pool_rx_hdr,
+                 buffer_pool(BUFFER_POOL_RX, safe_mce_sys().rx_hdr_split_size,
+                             safe_mce_sys().user_alloc.memalloc, safe_mce_sys().user_alloc.memfree));
+    }
+
     if (safe_mce_sys().tx_buf_size <=
         get_lwip_tcp_mss(g_p_net_device_table_mgr->get_max_mtu(), safe_mce_sys().lwip_mss)) {
         safe_mce_sys().tx_buf_size = 0;
@@ -1165,6 +1423,7 @@ static void do_global_ctors_helper()
              tcp_seg_pool("TCP segments", safe_mce_sys().tx_segs_pool_batch_tcp,
                           g_global_stat_static.n_tcp_seg_pool_size,
                           g_global_stat_static.n_tcp_seg_pool_no_segs));
+    phases.phase_done("buffer pools");
 
     // For delegated TCP timers the global collection is not used.
     if (safe_mce_sys().tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
@@ -1173,8 +1432,6 @@ static void do_global_ctors_helper()
 
     NEW_CTOR(g_p_vlogger_timer_handler, vlogger_timer_handler());
 
-    NEW_CTOR(g_p_ip_frag_manager, ip_frag_manager());
-
     NEW_CTOR(g_p_fd_collection, fd_collection());
 
     process_acceleration_rules();
@@ -1209,9 +1466,15 @@ static void do_global_ctors_helper()
     xlio_tls_api_setup();
 #endif /* DEFINED_UTLS */
 
+    if (safe_mce_sys().ring_precreate_threads) {
+        g_p_net_device_table_mgr->precreate_socket_rings();
+        phases.phase_done("rings");
+    }
+
     entity_context_manager::create();
 
     worker_thread_manager::create();
+    phases.all_done();
 }
 
 int do_global_ctors()
@@ -1237,10 +1500,10 @@ void reset_globals()
     entity_context_manager::fork_nullify();
     poll_group::fork_nullify();
     g_p_fd_collection = nullptr;
-    g_p_ip_frag_manager = nullptr;
     g_zc_cache = nullptr;
     g_buffer_pool_rx_ptr = nullptr;
     g_buffer_pool_rx_stride = nullptr;
+    g_buffer_pool_rx_hdr = nullptr;
     g_buffer_pool_rx_rwqe = nullptr;
     g_buffer_pool_tx = nullptr;
     g_buffer_pool_zc = nullptr;
@@ -1250,6 +1513,7 @@ void reset_globals()
     g_p_event_handler_manager = nullptr;
     g_p_agent = nullptr;
     g_p_route_table_mgr = nullptr;
+    g_p_dst_path_table = nullptr;
     g_bind_no_port = nullptr;
     g_p_rule_table_mgr = nullptr;
     g_p_net_device_table_mgr = nullptr;
@@ -1346,7 +1610,8 @@ extern "C" int xlio_init(void)
     g_init_xlio_init_done = true;
 
     vlog_start(PRODUCT_NAME, safe_mce_sys().log_level, safe_mce_sys().log_filename,
-               safe_mce_sys().log_details, safe_mce_sys().log_colors);
+               safe_mce_sys().log_details, safe_mce_sys().log_colors,
+               safe_mce_sys().log_async, safe_mce_sys().log_rate_limit);
 
     if (g_use_new_config) {
         print_xlio_global_settings();
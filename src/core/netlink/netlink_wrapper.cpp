@@ -117,7 +117,7 @@ static void route_callback(nl_cache *, nl_object *obj, int, void *)
 /* This function is called from internal thread only as neigh_timer_expired()
  * so it is protected by m_cache_lock call
  */
-void netlink_wrapper::notify_observers(netlink_event *p_new_event, e_netlink_event_type type)
+void netlink_wrapper::notify_observers(event *p_new_event, e_netlink_event_type type)
 {
     g_nl_rcv_arg.netlink->m_cache_lock.unlock();
     g_nl_rcv_arg.netlink->m_subj_map_lock.lock();
@@ -167,8 +167,10 @@ void netlink_wrapper::route_cache_callback(nl_object *obj)
         int family = rtnl_route_get_family(route);
         if ((table_id > (int)RT_TABLE_UNSPEC) && (family == AF_INET || family == AF_INET6)) {
             route_nl_event new_event(g_nl_rcv_arg.msghdr, route, g_nl_rcv_arg.netlink);
-            nl_logdbg("notify on route event: %s", new_event.to_str().c_str());
-            netlink_wrapper::notify_observers(&new_event, nlgrpROUTE);
+            nl_logdbg("batch route event: %s", new_event.to_str().c_str());
+            // The observers are notified once per read, see notify_route_batch()
+            g_nl_rcv_arg.netlink->m_route_batch.add(new_event.nl_type,
+                                                    new_event.get_route_info()->get_route_val());
         } else {
             nl_logdbg("Received event for not handled route entry: family=%d, table_id=%d", family,
                       table_id);
@@ -186,6 +188,7 @@ netlink_wrapper::netlink_wrapper()
     , m_cache_link(nullptr)
     , m_cache_neigh(nullptr)
     , m_cache_route(nullptr)
+    , m_route_batch(this)
 {
     nl_logfine("---> netlink_route_listener CTOR");
     g_nl_rcv_arg.subjects_map = &m_subjects_map;
@@ -336,6 +339,7 @@ int netlink_wrapper::handle_events()
     if (n < 0) {
         nl_logdbg("recvmsgs returned with error = %d", n);
     }
+    notify_route_batch();
 
     nl_logfine("<---handle_events");
 
@@ -413,6 +417,17 @@ int netlink_wrapper::get_neigh(const char *ipaddr, int ifindex, netlink_neigh_in
     return 0;
 }
 
+void netlink_wrapper::notify_route_batch()
+{
+    if (m_route_batch.empty()) {
+        return;
+    }
+
+    nl_logdbg("notify on route batch: %s", m_route_batch.to_str().c_str());
+    notify_observers(&m_route_batch, nlgrpROUTE);
+    m_route_batch.clear();
+}
+
 void netlink_wrapper::neigh_timer_expired()
 {
     std::lock_guard<decltype(m_cache_lock)> lock(m_cache_lock);
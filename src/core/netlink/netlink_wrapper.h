@@ -70,6 +70,7 @@ public:
 
     /*
      * Receive messages, parse, build relevant netlink_events and notify the registered observers.
+     * The route changes of all the messages read are notified at once as route_nl_batch_event.
      * return the number of events or negative number on error
      * **must first insure that opne_channel was called
      */
@@ -108,14 +109,19 @@ private:
     struct nl_cache *m_cache_neigh;
     struct nl_cache *m_cache_route;
 
+    // Route changes of the messages read by the current handle_events()
+    route_nl_batch_event m_route_batch;
+
     std::map<e_netlink_event_type, subject *> m_subjects_map;
     lock_mutex_recursive m_cache_lock;
     lock_mutex_recursive m_subj_map_lock;
 
     // This method should be called with m_cache_lock held!
-    static void notify_observers(netlink_event *p_new_event, e_netlink_event_type type);
+    static void notify_observers(event *p_new_event, e_netlink_event_type type);
 
     void notify_neigh_cache_entries();
+    // This method should be called with m_cache_lock held!
+    void notify_route_batch();
 };
 
 extern netlink_wrapper *g_p_netlink_handler;
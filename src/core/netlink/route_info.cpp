@@ -10,6 +10,7 @@
 #include "config.h"
 #include "core/util/if.h"
 #include "core/util/libxlio.h"
+#include "core/proto/route_table_mgr.h"
 #include "vlogger/vlogger.h"
 
 #define MODULE_NAME "route_info:"
@@ -79,21 +80,6 @@ void netlink_route_info::fill(struct rtnl_route *nl_route_obj)
         m_route_val.set_src_addr(ip_address((void *)nl_addr_get_binary_addr(addr), family));
     }
 
-    rtnl_nexthop *nh = rtnl_route_nexthop_n(nl_route_obj, 0);
-    if (nh) {
-        int oif = rtnl_route_nh_get_ifindex(nh);
-        if (oif > 0) {
-            m_route_val.set_if_index(oif);
-            char if_name[IFNAMSIZ] = {0};
-            if_indextoname(oif, if_name);
-            m_route_val.set_if_name(if_name);
-        }
-
-        addr = rtnl_route_nh_get_gateway(nh);
-        if (addr) {
-            // TODO: improve error handling
-            assert(family == nl_addr_get_family(addr));
-            m_route_val.set_gw(ip_address((void *)nl_addr_get_binary_addr(addr), family));
-        }
-    }
+    // The same next hop as the table dump, a deleted route must match its table entry
+    route_table_mgr::parse_nexthops(nl_route_obj, m_route_val);
 }
@@ -36,6 +36,8 @@ dst_entry::dst_entry(const sock_addr &dst, uint16_t src_port, socket_data &sock_
     , m_ring_alloc_logic_tx(sock_data.fd, ring_alloc_logic)
     , m_p_tx_mem_buf_desc_list(nullptr)
     , m_p_zc_mem_buf_desc_list(nullptr)
+    , m_p_tx_release_list(nullptr)
+    , m_n_tx_release_count(0U)
     , m_b_tx_mem_buf_desc_list_pending(false)
     , m_ttl_hop_limit(sock_data.ttl_hop_limit)
     , m_tos(sock_data.tos)
@@ -61,27 +63,13 @@ dst_entry::~dst_entry()
 {
     dst_logdbg("%s", to_str().c_str());
 
-    if (m_p_neigh_entry) {
-        ip_address dst_addr = m_dst_ip;
-        if (m_p_rt_val && !m_p_rt_val->get_gw_addr().is_anyaddr() && !dst_addr.is_mc(m_family)) {
-            dst_addr = m_p_rt_val->get_gw_addr();
-        }
-        g_p_neigh_table_mgr->unregister_observer(
-            neigh_key(ip_addr(dst_addr, m_family), m_p_net_dev_val), this);
-    }
-
-    if (m_p_rt_entry) {
-        g_p_route_table_mgr->unregister_observer(
-            route_rule_table_key(m_dst_ip, m_bound_ip, m_family, m_tos), this);
-        m_p_rt_entry = nullptr;
-    }
-
     if (m_p_ring) {
         if (m_sge) {
             delete[] m_sge;
             m_sge = nullptr;
         }
 
+        flush_tx_release_list(m_p_ring);
         if (m_p_tx_mem_buf_desc_list) {
             m_p_ring->mem_buf_tx_release(m_p_tx_mem_buf_desc_list, true);
             m_p_tx_mem_buf_desc_list = nullptr;
@@ -115,6 +103,11 @@ dst_entry::~dst_entry()
         m_header_neigh = nullptr;
     }
 
+    if (m_p_path) {
+        g_p_dst_path_table->put(m_p_path);
+        m_p_path = nullptr;
+    }
+
     dst_logdbg("Done %s", to_str().c_str());
 }
 
@@ -127,7 +120,9 @@ void dst_entry::init_members()
     m_p_net_dev_entry = nullptr;
     m_p_neigh_entry = nullptr;
     m_p_neigh_val = nullptr;
-    m_p_rt_entry = nullptr;
+    m_p_path = nullptr;
+    m_path_generation = 0U;
+    m_path_hop = 0U;
     memset(&m_inline_send_wqe, 0, sizeof(m_inline_send_wqe));
     memset(&m_not_inline_send_wqe, 0, sizeof(m_not_inline_send_wqe));
     memset(&m_fragmented_send_wqe, 0, sizeof(m_not_inline_send_wqe));
@@ -179,35 +174,16 @@ bool dst_entry::get_routing_addr_sel_src(ip_address &out_ip) const
     return false;
 }
 
-bool dst_entry::update_net_dev_val()
+bool dst_entry::update_net_dev_val(net_device_val *new_nd_val)
 {
     bool ret_val = false;
 
-    net_device_val *new_nd_val = m_p_net_dev_val;
-    if (!m_so_bindtodevice_ip.is_anyaddr() && g_p_net_device_table_mgr) {
-        new_nd_val =
-            g_p_net_device_table_mgr->get_net_device_val(ip_addr(m_so_bindtodevice_ip, m_family));
-        // TODO should we register to g_p_net_device_table_mgr  with m_p_net_dev_entry?
-        // what should we do with an old one?
-        dst_logdbg("getting net_dev_val by bindtodevice ip");
-    } else if (m_p_rt_entry) {
-        new_nd_val = m_p_rt_entry->get_net_dev_val();
-    }
-
     if (m_p_net_dev_val != new_nd_val) {
         dst_logdbg("updating net_device, new-if_name: %s",
                    new_nd_val ? new_nd_val->get_ifname() : "N/A");
 
-        if (m_p_neigh_entry) {
-            ip_address dst_addr = m_dst_ip;
-            if (m_p_rt_val && !m_p_rt_val->get_gw_addr().is_anyaddr() &&
-                !dst_addr.is_mc(m_family)) {
-                dst_addr = m_p_rt_val->get_gw_addr();
-            }
-            g_p_neigh_table_mgr->unregister_observer(
-                neigh_key(ip_addr(dst_addr, m_family), m_p_net_dev_val), this);
-            m_p_neigh_entry = nullptr;
-        }
+        // The path owns the neighbour registration
+        m_p_neigh_entry = nullptr;
 
         // Change the net_device, clean old resources...
         release_ring();
@@ -234,86 +210,74 @@ bool dst_entry::update_net_dev_val()
     return ret_val;
 }
 
-bool dst_entry::update_rt_val()
+dst_path_key dst_entry::get_path_key() const
 {
-    bool ret_val = true;
-    route_val *p_rt_val = nullptr;
-
-    if (m_p_rt_entry && m_p_rt_entry->get_val(p_rt_val)) {
-        if (m_p_rt_val == p_rt_val) {
-            dst_logdbg("no change in route_val");
-        } else {
-            dst_logdbg("updating route val");
-            m_p_rt_val = p_rt_val;
-        }
-    } else {
-        dst_logdbg("Route entry is not valid");
-        ret_val = false;
-    }
+    return dst_path_key {m_dst_ip, m_bound_ip, m_so_bindtodevice_ip, m_family, m_tos, false};
+}
 
-    return ret_val;
+uint32_t dst_entry::get_multipath_hash() const
+{
+    // The source before the selection, as the kernel hashes a socket's route lookup
+    return route_multipath_hash(
+        m_family, m_bound_ip, m_dst_ip, m_src_port, m_dst_port, get_protocol_type(),
+        safe_mce_sys().sysctl_reader.get_fib_multipath_hash_policy(m_family));
 }
 
 bool dst_entry::resolve_net_dev()
 {
-    bool ret_val = false;
-
-    cache_entry_subject<route_rule_table_key, route_val *> *p_ces = nullptr;
-
     if (m_dst_ip.is_anyaddr()) {
         dst_logdbg(PRODUCT_NAME " does not offload zero net IP address");
-        return ret_val;
+        return false;
     }
 
     if (m_dst_ip.is_loopback_class(get_sa_family())) {
         dst_logdbg(PRODUCT_NAME " does not offload local loopback IP address");
-        return ret_val;
-    }
-
-    // When XLIO will support routing with OIF, we need to check changing in outgoing interface
-    // Source address changes is not checked since multiple bind is not allowed on the same socket
-    if (!m_p_rt_entry) {
-        route_rule_table_key rtk(m_dst_ip, m_bound_ip, m_family, m_tos);
-        dst_logfunc("Fetching rt_entry %s", m_bound_ip.to_str(m_family).c_str());
-        if (g_p_route_table_mgr->register_observer(rtk, this, &p_ces)) {
-            // In case this is the first time we trying to resolve route entry,
-            // means that register_observer was run
-            m_p_rt_entry = dynamic_cast<route_entry *>(p_ces);
-        } else {
-            dst_logdbg("Error in registering route entry");
-            return ret_val;
+        return false;
+    }
+
+    // The bound or the SO_BINDTODEVICE address changed since the last resolution
+    dst_path_key key = get_path_key();
+    if (m_p_path && !(m_p_path->get_key() == key)) {
+        g_p_dst_path_table->put(m_p_path);
+        m_p_path = nullptr;
+    }
+    if (!m_p_path) {
+        m_p_path = g_p_dst_path_table->get(key);
+        if (!m_p_path) {
+            dst_logdbg("Error in getting the path");
+            return false;
         }
+        dst_logfunc("Using path %s", m_p_path->to_str().c_str());
     }
 
-    if (update_rt_val()) {
-        ret_val = update_net_dev_val();
+    // Taken before the resolution, a change on the way invalidates this entry again
+    m_path_generation = m_p_path->get_generation();
+
+    route_val *p_rt_val = m_p_rt_val;
+    net_device_val *new_nd_val = m_p_net_dev_val;
+    if (!m_p_path->resolve_net_dev(get_multipath_hash(), p_rt_val, new_nd_val, m_path_hop)) {
+        dst_logdbg("Route entry is not valid");
+        return false;
     }
-    return ret_val;
+    if (m_p_rt_val != p_rt_val) {
+        dst_logdbg("updating route val");
+        m_p_rt_val = p_rt_val;
+    }
+    return update_net_dev_val(new_nd_val);
 }
 
 bool dst_entry::resolve_neigh()
 {
     dst_logdbg("");
     bool ret_val = false;
-    ip_address dst_addr = m_dst_ip;
 
-    if (m_p_rt_val && !m_p_rt_val->get_gw_addr().is_anyaddr() && !dst_addr.is_mc(m_family)) {
-        dst_addr = m_p_rt_val->get_gw_addr();
-    }
-    cache_entry_subject<neigh_key, neigh_val *> *p_ces = nullptr;
-    if (m_p_neigh_entry ||
-        g_p_neigh_table_mgr->register_observer(
-            neigh_key(ip_addr(dst_addr, m_family), m_p_net_dev_val), this, &p_ces)) {
-        if (!m_p_neigh_entry) {
-            m_p_neigh_entry = dynamic_cast<neigh_entry *>(p_ces);
-        }
-        if (m_p_neigh_entry) {
-            if (m_p_neigh_entry->get_peer_info(m_p_neigh_val)) {
-                dst_logdbg("neigh is valid");
-                ret_val = true;
-            } else {
-                dst_logdbg("neigh is not valid");
-            }
+    m_p_neigh_entry = m_p_path ? m_p_path->resolve_neigh(m_path_hop) : nullptr;
+    if (m_p_neigh_entry) {
+        if (m_p_neigh_entry->get_peer_info(m_p_neigh_val)) {
+            dst_logdbg("neigh is valid");
+            ret_val = true;
+        } else {
+            dst_logdbg("neigh is not valid");
         }
     }
     return ret_val;
@@ -326,8 +290,9 @@ bool dst_entry::resolve_ring()
     if (m_p_net_dev_val) {
         if (!m_p_ring) {
             dst_logdbg("getting a ring");
-            m_p_ring =
-                m_p_net_dev_val->reserve_ring(m_ring_alloc_logic_tx.create_new_key(m_pkt_src_ip));
+            resource_allocation_key *key = m_ring_alloc_logic_tx.create_new_key(m_pkt_src_ip);
+            set_ring_tx_priority(key);
+            m_p_ring = m_p_net_dev_val->reserve_ring(key);
         }
         if (m_p_ring) {
             if (m_sge) {
@@ -352,6 +317,7 @@ bool dst_entry::release_ring()
     bool ret_val = false;
     if (m_p_net_dev_val) {
         if (m_p_ring) {
+            flush_tx_release_list(m_p_ring);
             if (m_p_tx_mem_buf_desc_list) {
                 m_p_ring->mem_buf_tx_release(m_p_tx_mem_buf_desc_list, true);
                 m_p_tx_mem_buf_desc_list = nullptr;
@@ -575,6 +541,14 @@ bool dst_entry::try_migrate_ring_tx(lock_base &socket_lock)
     return ret;
 }
 
+void dst_entry::expect_ring_migration_tx()
+{
+    if (m_ring_alloc_logic_tx.is_logic_support_migration() && !m_tx_migration_lock.trylock()) {
+        m_ring_alloc_logic_tx.expect_migration();
+        m_tx_migration_lock.unlock();
+    }
+}
+
 int dst_entry::get_route_mtu()
 {
     if (m_p_rt_val && m_p_rt_val->get_mtu() > 0) {
@@ -628,6 +602,8 @@ void dst_entry::do_ring_migration_tx(lock_base &socket_lock, resource_allocation
     set_state(false);
 
     ring *old_ring = m_p_ring;
+    // The freed buffers belong to the old ring
+    flush_tx_release_list(old_ring);
     m_p_ring = new_ring;
     if (m_sge) {
         delete[] m_sge;
@@ -739,10 +715,23 @@ mem_buf_desc_t *dst_entry::get_tx_buffer()
     return m_p_ring->mem_buf_tx_get(m_id, false, PBUF_RAM, 1, true);
 }
 
+void dst_entry::flush_tx_release_list(ring *p_ring)
+{
+    if (m_p_tx_release_list) {
+        // The buffers were counted as returned when they were freed
+        p_ring->mem_buf_tx_release(m_p_tx_release_list, false);
+        m_p_tx_release_list = nullptr;
+        m_n_tx_release_count = 0U;
+    }
+}
+
 void dst_entry::return_buffers_pool()
 {
     int count;
 
+    if (m_p_ring) {
+        flush_tx_release_list(m_p_ring);
+    }
     if (!m_p_tx_mem_buf_desc_list && !m_p_zc_mem_buf_desc_list) {
         return;
     }
@@ -781,12 +770,21 @@ uint32_t dst_entry::get_priority_by_tc_class(uint32_t pcp)
     return DEFAULT_ENGRESS_MAP_PRIO;
 }
 
+void dst_entry::set_ring_tx_priority(resource_allocation_key *key)
+{
+    // Sockets of different priorities get different TX rings and so different send queues
+    if (safe_mce_sys().ring_per_priority_tx) {
+        key->set_tx_priority(m_pcp);
+    }
+}
+
 bool dst_entry::update_ring_alloc_logic(int fd, lock_base &socket_lock,
                                         resource_allocation_key &ring_alloc_logic)
 {
     resource_allocation_key old_key(*m_ring_alloc_logic_tx.get_key());
 
     m_ring_alloc_logic_tx = ring_allocation_logic_tx(fd, ring_alloc_logic);
+    set_ring_tx_priority(m_ring_alloc_logic_tx.get_key());
 
     if (*m_ring_alloc_logic_tx.get_key() != old_key) {
         std::lock_guard<decltype(m_tx_migration_lock)> locker(m_tx_migration_lock);
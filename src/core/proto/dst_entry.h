@@ -14,6 +14,7 @@
 
 #include "vlogger/vlogger.h"
 #include "utils/lock_wrapper.h"
+#include "core/proto/dst_path.h"
 #include "core/proto/route_entry.h"
 #include "core/proto/route_val.h"
 #include "core/proto/neighbour_table_mgr.h"
@@ -52,6 +53,8 @@ struct xlio_send_attr {
     uint16_t mss;
     size_t length;
     xlio_tis *tis;
+    // TX HW timestamp of the send, reported by the completion of its last WQE, or nullptr
+    const tx_ts_request *ts;
 };
 
 class dst_entry : public cache_observer, public tostr {
@@ -73,7 +76,14 @@ public:
                               sockinfo *sock = nullptr, tx_call_t call_type = TX_UNDEF) = 0;
 
     bool try_migrate_ring_tx(lock_base &socket_lock);
+    void expect_ring_migration_tx();
 
+    // Also invalid since a change of the route or neighbour of the shared path
+    inline bool is_valid()
+    {
+        return cache_observer::is_valid() && m_p_path &&
+            m_path_generation == m_p_path->get_generation();
+    }
     bool is_offloaded() { return m_b_is_offloaded; }
     void set_bound_addr(const ip_address &addr);
     void set_so_bindtodevice_addr(const ip_address &addr);
@@ -87,7 +97,18 @@ public:
     mem_buf_desc_t *get_tx_buffer();
 
     void return_buffers_pool();
+    bool has_pending_tx_buffs() const
+    {
+        return m_p_tx_mem_buf_desc_list || m_p_zc_mem_buf_desc_list || m_p_tx_release_list;
+    }
     int get_route_mtu();
+    uint32_t get_path_mtu() const { return m_p_path ? m_p_path->get_pmtu() : 0U; }
+    void set_path_mtu(uint32_t mtu)
+    {
+        if (m_p_path) {
+            m_p_path->set_pmtu(mtu);
+        }
+    }
     inline void set_ip_ttl_hop_limit(uint8_t ttl_hop_limit)
     {
         m_header->set_ip_ttl_hop_limit(ttl_hop_limit);
@@ -95,6 +116,8 @@ public:
     inline void set_ip_tos(uint8_t tos) { m_header->set_ip_tos(tos); }
     inline bool set_pcp(uint32_t pcp)
     {
+        // A new TX ring priority takes effect on the next ring resolution
+        m_pcp = pcp;
         return m_header->set_vlan_pcp(get_priority_by_tc_class(pcp));
     }
     inline void set_src_sel_prefs(uint8_t sel_flags) { m_src_sel_prefs = sel_flags; }
@@ -131,7 +154,12 @@ protected:
     xlio_ibv_send_wr m_fragmented_send_wqe;
     wqe_send_handler *m_p_send_wqe_handler;
     ibv_sge *m_sge;
-    route_entry *m_p_rt_entry;
+    // Shared with the other dst_entry objects to the same destination
+    dst_path *m_p_path;
+    uint32_t m_path_generation;
+    // Next hop of the flow when the route is multipath
+    uint32_t m_path_hop;
+    // Copied from m_p_path on the resolution
     route_val *m_p_rt_val;
     net_device_entry *m_p_net_dev_entry;
     net_device_val *m_p_net_dev_val;
@@ -142,6 +170,9 @@ protected:
     ring_allocation_logic_tx m_ring_alloc_logic_tx;
     mem_buf_desc_t *m_p_tx_mem_buf_desc_list;
     mem_buf_desc_t *m_p_zc_mem_buf_desc_list;
+    // Freed TX buffers returned to the ring at once, to take the ring TX lock once per batch
+    mem_buf_desc_t *m_p_tx_release_list;
+    uint32_t m_n_tx_release_count;
     int m_b_tx_mem_buf_desc_list_pending;
     uint8_t m_ttl_hop_limit;
 
@@ -169,8 +200,9 @@ protected:
     virtual void init_members();
     virtual bool resolve_net_dev();
     virtual void set_src_addr();
-    bool update_net_dev_val();
-    bool update_rt_val();
+    virtual dst_path_key get_path_key() const;
+    uint32_t get_multipath_hash() const;
+    bool update_net_dev_val(net_device_val *new_nd_val);
     virtual bool resolve_neigh();
     virtual bool resolve_ring();
     virtual bool release_ring();
@@ -187,11 +219,13 @@ protected:
     bool get_routing_addr_sel_src(ip_address &out_ip) const;
     void do_ring_migration_tx(lock_base &socket_lock, resource_allocation_key &old_key);
     transport_type_t get_obs_transport_type() const;
+    void flush_tx_release_list(ring *p_ring);
     inline void set_tx_buff_list_pending(bool is_pending = true)
     {
         m_b_tx_mem_buf_desc_list_pending = is_pending;
     }
     uint32_t get_priority_by_tc_class(uint32_t tc_clas);
+    void set_ring_tx_priority(resource_allocation_key *key);
 };
 
 #endif /* DST_ENTRY_H */
@@ -7,6 +7,7 @@
 #include "dst_entry_tcp.h"
 #include "mapping.h"
 #include "mem_desc.h"
+#include "sock/tx_ts_sink.h"
 #include <netinet/tcp.h>
 
 #define MODULE_NAME "dst_tcp"
@@ -181,6 +182,9 @@ ssize_t dst_entry_tcp::fast_send(const iovec *p_iov, const ssize_t sz_iov, xlio_
 
         /* set wr_id as a pointer to memory descriptor */
         p_send_wqe->wr_id = (uintptr_t)p_tcp_iov[0].p_desc;
+        if (unlikely(attr.ts)) {
+            tx_ts_sink::attach(p_tcp_iov[0].p_desc, *attr.ts);
+        }
 
         /* Update scatter gather element list
          * ref counter is incremented (above) for the first memory descriptor only because it is
@@ -254,6 +258,9 @@ ssize_t dst_entry_tcp::fast_send(const iovec *p_iov, const ssize_t sz_iov, xlio_
 
         p_send_wqe = &m_not_inline_send_wqe;
         p_send_wqe->wr_id = (uintptr_t)p_mem_buf_desc;
+        if (unlikely(attr.ts)) {
+            tx_ts_sink::attach(p_mem_buf_desc, *attr.ts);
+        }
 
         m_p_ring->send_ring_buffer(m_id, p_send_wqe, attr.flags);
     }
@@ -377,13 +384,26 @@ mem_buf_desc_t *dst_entry_tcp::get_buffer(pbuf_type type, pbuf_desc *desc,
 // only single p_desc
 void dst_entry_tcp::put_buffer(mem_buf_desc_t *p_desc)
 {
-    // todo accumulate buffers?
-
     if (unlikely(!p_desc)) {
         return;
     }
 
     if (likely(m_p_ring->is_member(p_desc->p_desc_owner))) {
+        /* The reference is dropped by the ring under its TX lock, so the buffer is only
+         * stashed here and the batch takes the lock once. A buffer which releases a chain or
+         * notifies on the release is returned at once.
+         */
+        if (likely(m_n_sysvar_tx_bufs_batch_tcp > 1U &&
+                   !(p_desc->m_flags &
+                     (mem_buf_desc_t::TX_CHAIN | mem_buf_desc_t::ZCOPY |
+                      mem_buf_desc_t::TX_TIMESTAMP)))) {
+            p_desc->p_next_desc = m_p_tx_release_list;
+            m_p_tx_release_list = p_desc;
+            if (++m_n_tx_release_count >= m_n_sysvar_tx_bufs_batch_tcp) {
+                flush_tx_release_list(m_p_ring);
+            }
+            return;
+        }
         m_p_ring->mem_buf_desc_return_single_to_owner_tx(p_desc);
     } else {
 
@@ -7,7 +7,9 @@
 #include "utils/bullseye.h"
 #include "core/util/utils.h"
 #include "dst_entry_udp.h"
+#include "dev/wqe_send_handler.h"
 #include "sock/sockinfo.h"
+#include "sock/tx_ts_sink.h"
 
 #define MODULE_NAME "dst_udp"
 
@@ -44,6 +46,7 @@ void dst_entry_udp::configure_headers()
 {
     m_header->init();
     m_header->configure_udp_header(m_dst_port, m_src_port);
+    m_inline_udp_len = 0U;
     dst_entry::configure_headers();
 }
 
@@ -171,7 +174,8 @@ bool dst_entry_udp::fast_send_fragmented_ipv6(mem_buf_desc_t *p_mem_buf_desc, co
 inline ssize_t dst_entry_udp::fast_send_not_fragmented(const iovec *p_iov, const ssize_t sz_iov,
                                                        xlio_wr_tx_packet_attr attr,
                                                        size_t sz_udp_payload,
-                                                       ssize_t sz_data_payload)
+                                                       ssize_t sz_data_payload,
+                                                       const tx_ts_request *ts)
 {
     mem_buf_desc_t *p_mem_buf_desc;
     xlio_ibv_send_wr *p_send_wqe;
@@ -209,8 +213,13 @@ inline ssize_t dst_entry_udp::fast_send_not_fragmented(const iovec *p_iov, const
         !is_set(attr, XLIO_TX_SW_L4_CSUM)) {
         p_send_wqe = &m_inline_send_wqe;
 
-        m_header->get_udp_hdr()->len = htons((uint16_t)sz_udp_payload);
-        m_header->set_ip_len(m_header->m_ip_header_len + sz_udp_payload);
+        // The template keeps the lengths of the previous inline datagram, a publisher of same
+        // size messages doesn't patch it at all.
+        if (unlikely(sz_udp_payload != m_inline_udp_len)) {
+            m_header->get_udp_hdr()->len = htons((uint16_t)sz_udp_payload);
+            m_header->set_ip_len(m_header->m_ip_header_len + sz_udp_payload);
+            m_inline_udp_len = (uint16_t)sz_udp_payload;
+        }
 
         p_mem_buf_desc->tx.p_ip_h = m_header->get_ip_hdr();
         p_mem_buf_desc->tx.p_udp_h = m_header->get_udp_hdr();
@@ -276,6 +285,9 @@ inline ssize_t dst_entry_udp::fast_send_not_fragmented(const iovec *p_iov, const
     }
 
     p_send_wqe->wr_id = reinterpret_cast<uintptr_t>(p_mem_buf_desc);
+    if (unlikely(ts)) {
+        tx_ts_sink::attach(p_mem_buf_desc, *ts);
+    }
     m_p_ring->send_ring_buffer(m_id, p_send_wqe, attr);
 
     // request tx buffers for the next packets
@@ -398,7 +410,7 @@ inline bool dst_entry_udp::fast_send_fragmented_ipv4(mem_buf_desc_t *p_mem_buf_d
 
 ssize_t dst_entry_udp::fast_send_fragmented(const iovec *p_iov, const ssize_t sz_iov,
                                             xlio_wr_tx_packet_attr attr, size_t sz_udp_payload,
-                                            ssize_t sz_data_payload)
+                                            ssize_t sz_data_payload, const tx_ts_request *ts)
 {
     bool b_blocked = is_set(attr, XLIO_TX_PACKET_BLOCK);
     bool is_ipv6 = (get_sa_family() == AF_INET6);
@@ -430,6 +442,15 @@ ssize_t dst_entry_udp::fast_send_fragmented(const iovec *p_iov, const ssize_t sz
         return -1;
     }
 
+    if (unlikely(ts)) {
+        // The datagram is sent when its last fragment is
+        mem_buf_desc_t *p_last_desc = p_mem_buf_desc;
+        while (p_last_desc->p_next_desc) {
+            p_last_desc = p_last_desc->p_next_desc;
+        }
+        tx_ts_sink::attach(p_last_desc, *ts);
+    }
+
     bool ret;
     if (is_ipv6) {
         ret = dst_entry_udp::fast_send_fragmented_ipv6(
@@ -448,6 +469,136 @@ ssize_t dst_entry_udp::fast_send_fragmented(const iovec *p_iov, const ssize_t sz
     return sz_data_payload;
 }
 
+ssize_t dst_entry_udp::fast_send_segmented(const iovec *p_iov, const ssize_t sz_iov,
+                                            xlio_wr_tx_packet_attr attr, uint16_t gso_size,
+                                            ssize_t sz_data_payload, const tx_ts_request *ts)
+{
+    bool b_blocked = is_set(attr, XLIO_TX_PACKET_BLOCK);
+    bool is_ipv6 = (get_sa_family() == AF_INET6);
+    int n_num_segs = (sz_data_payload + gso_size - 1) / gso_size;
+    size_t hdr_len = m_header->m_transport_header_len + m_header->m_ip_header_len + UDP_HLEN;
+
+    // Same limits as the kernel UDP GSO, every segment must fit into a single packet
+    if (unlikely((gso_size + sizeof(struct udphdr)) > (size_t)m_max_udp_payload_size ||
+                 n_num_segs > UDP_GSO_MAX_SEGMENTS)) {
+        dst_udp_logdbg("Invalid UDP segment size %u for payload %zd", gso_size, sz_data_payload);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* The NIC segments the datagram when the ring supports LSO. The header template is taken
+     * from the first buffer and each buffer adds the payload of one segment as a data pointer.
+     * Otherwise, every segment is sent as a regular datagram with its own header.
+     */
+    bool b_lso = m_p_ring->is_tso() && n_num_segs < (int)m_p_ring->get_max_send_sge() &&
+        hdr_len <= m_p_ring->get_max_header_sz() &&
+        (size_t)sz_data_payload <= m_p_ring->get_max_payload_sz() &&
+        !is_set(attr, XLIO_TX_SW_L4_CSUM);
+
+    dst_udp_logfunc("udp gso: IPv%s, payload_sz=%zd, segs=%d, gso_size=%u, lso=%d",
+                    (is_ipv6) ? "6" : "4", sz_data_payload, n_num_segs, gso_size, b_lso);
+
+    mem_buf_desc_t *p_mem_buf_desc =
+        m_p_ring->mem_buf_tx_get(m_id, b_blocked, PBUF_RAM, n_num_segs);
+
+    if (unlikely(!p_mem_buf_desc)) {
+        if (b_blocked) {
+            dst_udp_logdbg("Error when blocking for next tx buffer (errno=%d %m)", errno);
+        } else {
+            dst_udp_logfunc(
+                "Packet dropped. NonBlocked call but not enough tx buffers. Returning OK");
+            if (!m_b_sysvar_tx_nonblocked_eagains) {
+                return sz_data_payload;
+            }
+        }
+        errno = EAGAIN;
+        return -1;
+    }
+
+    mem_buf_desc_t *p_first_desc = p_mem_buf_desc;
+    size_t sz_user_data_offset = 0;
+
+    for (int i = 0; i < n_num_segs; ++i) {
+        size_t sz_seg = std::min((size_t)gso_size, sz_data_payload - sz_user_data_offset);
+        uint8_t *p_payload =
+            p_mem_buf_desc->p_buffer + m_header->m_transport_header_tx_offset + hdr_len;
+        mem_buf_desc_t *tmp = p_mem_buf_desc->p_next_desc;
+
+        if (!b_lso || i == 0) {
+            void *p_pkt = p_mem_buf_desc->p_buffer;
+            void *p_ip_hdr;
+            void *p_udp_hdr;
+            // The LSO header describes the whole datagram, the NIC fixes the lengths per segment
+            size_t sz_ip_payload = UDP_HLEN + (b_lso ? sz_data_payload : sz_seg);
+
+            m_header->copy_l2_ip_udp_hdr(p_pkt);
+            if (is_ipv6) {
+                fill_hdrs<tx_ipv6_hdr_template_t>(p_pkt, p_ip_hdr, p_udp_hdr);
+                set_ipv6_len(p_ip_hdr, htons(m_header->m_ip_header_len + sz_ip_payload - IPV6_HLEN));
+            } else {
+                fill_hdrs<tx_ipv4_hdr_template_t>(p_pkt, p_ip_hdr, p_udp_hdr);
+                set_ipv4_len(p_ip_hdr, htons(m_header->m_ip_header_len + sz_ip_payload));
+                reinterpret_cast<iphdr *>(p_ip_hdr)->frag_off = htons(0);
+                reinterpret_cast<iphdr *>(p_ip_hdr)->id = 0;
+            }
+            reinterpret_cast<udphdr *>(p_udp_hdr)->len =
+                htons((uint16_t)(UDP_HLEN + (b_lso ? gso_size : sz_seg)));
+            p_mem_buf_desc->tx.p_ip_h = p_ip_hdr;
+            p_mem_buf_desc->tx.p_udp_h = reinterpret_cast<udphdr *>(p_udp_hdr);
+        }
+
+        // Copy user data to our tx buffers
+        int ret = memcpy_fromiovec(p_payload, p_iov, sz_iov, sz_user_data_offset, sz_seg);
+        BULLSEYE_EXCLUDE_BLOCK_START
+        if (ret != (int)sz_seg) {
+            dst_udp_logerr("memcpy_fromiovec error (sz_user_data_to_copy=%zu, ret=%d)", sz_seg,
+                           ret);
+            m_p_ring->mem_buf_tx_release(b_lso ? p_first_desc : p_mem_buf_desc, true);
+            errno = EINVAL;
+            return -1;
+        }
+        BULLSEYE_EXCLUDE_BLOCK_END
+        sz_user_data_offset += sz_seg;
+
+        if (b_lso) {
+            m_sge[1 + i].addr = (uintptr_t)p_payload;
+            m_sge[1 + i].length = sz_seg;
+            m_sge[1 + i].lkey = m_p_ring->get_tx_lkey(m_id);
+        } else {
+            m_sge[1].addr = (uintptr_t)(p_mem_buf_desc->p_buffer +
+                                        (uint8_t)m_header->m_transport_header_tx_offset);
+            m_sge[1].length = sz_seg + hdr_len;
+            m_sge[1].lkey = m_p_ring->get_tx_lkey(m_id);
+            m_not_inline_send_wqe.wr_id = (uintptr_t)p_mem_buf_desc;
+            p_mem_buf_desc->p_next_desc = nullptr;
+            if (unlikely(ts) && i == n_num_segs - 1) {
+                tx_ts_sink::attach(p_mem_buf_desc, *ts);
+            }
+            m_p_ring->send_ring_buffer(m_id, &m_not_inline_send_wqe, attr);
+        }
+        p_mem_buf_desc = tmp;
+    }
+
+    if (b_lso) {
+        xlio_ibv_send_wr send_wqe;
+        wqe_send_handler send_wqe_h;
+
+        send_wqe_h.init_not_inline_wqe(send_wqe, &m_sge[1], n_num_segs);
+        send_wqe_h.enable_tso(send_wqe,
+                              p_first_desc->p_buffer + m_header->m_transport_header_tx_offset,
+                              hdr_len, gso_size);
+        // A single completion releases the buffers of all the segments
+        p_first_desc->m_flags |= mem_buf_desc_t::TX_CHAIN;
+        send_wqe.wr_id = (uintptr_t)p_first_desc;
+        if (unlikely(ts)) {
+            tx_ts_sink::attach(p_first_desc, *ts);
+        }
+        m_p_ring->send_ring_buffer(m_id, &send_wqe, attr);
+    }
+
+    return sz_data_payload;
+}
+
 ssize_t dst_entry_udp::fast_send(const iovec *p_iov, const ssize_t sz_iov, xlio_send_attr attr)
 {
     /* Suppress flags that should not be used anymore
@@ -455,15 +606,23 @@ ssize_t dst_entry_udp::fast_send(const iovec *p_iov, const ssize_t sz_iov, xlio_
      */
     attr.flags = (xlio_wr_tx_packet_attr)(attr.flags & ~(XLIO_TX_PACKET_ZEROCOPY | XLIO_TX_FILE));
 
+    if (unlikely(attr.mss && attr.length > attr.mss)) {
+        attr.flags =
+            (xlio_wr_tx_packet_attr)(attr.flags | XLIO_TX_PACKET_L3_CSUM | XLIO_TX_PACKET_L4_CSUM);
+        return fast_send_segmented(p_iov, sz_iov, attr.flags, attr.mss, attr.length, attr.ts);
+    }
+
     // Calc udp payload size
     size_t sz_udp_payload = attr.length + sizeof(struct udphdr);
     if (sz_udp_payload <= (size_t)m_max_udp_payload_size) {
         attr.flags =
             (xlio_wr_tx_packet_attr)(attr.flags | XLIO_TX_PACKET_L3_CSUM | XLIO_TX_PACKET_L4_CSUM);
-        return fast_send_not_fragmented(p_iov, sz_iov, attr.flags, sz_udp_payload, attr.length);
+        return fast_send_not_fragmented(p_iov, sz_iov, attr.flags, sz_udp_payload, attr.length,
+                                        attr.ts);
     } else {
         attr.flags = (xlio_wr_tx_packet_attr)(attr.flags | XLIO_TX_PACKET_L3_CSUM);
-        return fast_send_fragmented(p_iov, sz_iov, attr.flags, sz_udp_payload, attr.length);
+        return fast_send_fragmented(p_iov, sz_iov, attr.flags, sz_udp_payload, attr.length,
+                                    attr.ts);
     }
 }
 
@@ -485,7 +644,11 @@ ssize_t dst_entry_udp::slow_send(const iovec *p_iov, const ssize_t sz_iov, xlio_
                               to_saddr.get_socklen());
     } else {
         if (!is_valid()) { // That means that the neigh is not resolved yet
-            ret_val = pass_buff_to_neigh(p_iov, sz_iov);
+            if (attr.mss && attr.length > attr.mss) {
+                ret_val = pass_segments_to_neigh(p_iov, sz_iov, attr.length, attr.mss);
+            } else {
+                ret_val = pass_buff_to_neigh(p_iov, sz_iov);
+            }
         } else {
             ret_val = fast_send(p_iov, sz_iov, attr);
         }
@@ -510,3 +673,37 @@ ssize_t dst_entry_udp::pass_buff_to_neigh(const iovec *p_iov, size_t sz_iov)
 
     return pass_pkt_to_neigh(p_iov, sz_iov, packet_id);
 }
+
+ssize_t dst_entry_udp::pass_segments_to_neigh(const iovec *p_iov, size_t sz_iov,
+                                              size_t sz_data_payload, uint16_t gso_size)
+{
+    std::vector<iovec> seg_iov;
+    size_t iov_idx = 0;
+    size_t iov_offset = 0;
+
+    // Split the user vector at the segment boundaries, each segment is a separate datagram
+    for (size_t offset = 0; offset < sz_data_payload; offset += gso_size) {
+        size_t sz_left = std::min((size_t)gso_size, sz_data_payload - offset);
+
+        seg_iov.clear();
+        while (sz_left && iov_idx < sz_iov) {
+            size_t len = std::min(sz_left, p_iov[iov_idx].iov_len - iov_offset);
+            if (len) {
+                seg_iov.push_back({(uint8_t *)p_iov[iov_idx].iov_base + iov_offset, len});
+            }
+            sz_left -= len;
+            iov_offset += len;
+            if (iov_offset == p_iov[iov_idx].iov_len) {
+                ++iov_idx;
+                iov_offset = 0;
+            }
+        }
+
+        ssize_t ret = pass_buff_to_neigh(seg_iov.data(), seg_iov.size());
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return sz_data_payload;
+}
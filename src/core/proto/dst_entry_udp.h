@@ -9,6 +9,9 @@
 
 #include "core/proto/dst_entry.h"
 
+/* Maximum number of segments of a single UDP GSO send, as in the kernel */
+#define UDP_GSO_MAX_SEGMENTS 64
+
 class dst_entry_udp : public dst_entry {
 public:
     dst_entry_udp(const sock_addr &dst, uint16_t src_port, socket_data &sock_data,
@@ -36,6 +39,8 @@ protected:
     virtual void configure_headers();
     virtual void init_sge();
     ssize_t pass_buff_to_neigh(const iovec *p_iov, size_t sz_iov);
+    ssize_t pass_segments_to_neigh(const iovec *p_iov, size_t sz_iov, size_t sz_data_payload,
+                                   uint16_t gso_size);
 
 private:
     inline uint16_t gen_packet_id_ip4() { return htons(static_cast<uint16_t>(m_frag_tx_pkt_id++)); }
@@ -44,7 +49,7 @@ private:
 
     inline ssize_t fast_send_not_fragmented(const iovec *p_iov, const ssize_t sz_iov,
                                             xlio_wr_tx_packet_attr attr, size_t sz_udp_payload,
-                                            ssize_t sz_data_payload);
+                                            ssize_t sz_data_payload, const tx_ts_request *ts);
     inline bool fast_send_fragmented_ipv4(mem_buf_desc_t *p_mem_buf_desc, const iovec *p_iov,
                                           const ssize_t sz_iov, xlio_wr_tx_packet_attr attr,
                                           size_t sz_udp_payload, int n_num_frags);
@@ -53,9 +58,14 @@ private:
                                           size_t sz_udp_payload, int n_num_frags);
     ssize_t fast_send_fragmented(const iovec *p_iov, const ssize_t sz_iov,
                                  xlio_wr_tx_packet_attr attr, size_t sz_udp_payload,
-                                 ssize_t sz_data_payload);
+                                 ssize_t sz_data_payload, const tx_ts_request *ts);
+    ssize_t fast_send_segmented(const iovec *p_iov, const ssize_t sz_iov,
+                                xlio_wr_tx_packet_attr attr, uint16_t gso_size,
+                                ssize_t sz_data_payload, const tx_ts_request *ts);
 
     uint32_t m_frag_tx_pkt_id = 0U;
+    // UDP length the header template holds for the inline send, 0 after the template is rebuilt
+    uint16_t m_inline_udp_len = 0U;
     const uint32_t m_n_sysvar_tx_bufs_batch_udp;
     const bool m_b_sysvar_tx_nonblocked_eagains;
     const uint32_t m_n_sysvar_tx_prefetch_bytes;
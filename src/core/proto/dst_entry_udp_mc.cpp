@@ -58,7 +58,6 @@ void dst_entry_udp_mc::set_src_addr()
 // The following function supposed to be called under m_lock
 bool dst_entry_udp_mc::resolve_net_dev()
 {
-    bool ret_val = false;
     cache_entry_subject<int, net_device_val *> *net_dev_entry = nullptr;
 
     if (!m_mc_tx_src_ip.is_anyaddr() && !m_mc_tx_src_ip.is_mc(m_family)) {
@@ -78,20 +77,20 @@ bool dst_entry_udp_mc::resolve_net_dev()
                 }
             }
         }
-        if (m_p_net_dev_entry) {
-            m_p_net_dev_entry->get_val(m_p_net_dev_val);
-            if (m_p_net_dev_val) {
-                ret_val = alloc_transport_dep_res();
-            } else {
-                dst_udp_mc_logdbg("Valid netdev value not found");
-            }
-        } else {
+        if (!m_p_net_dev_entry) {
             m_b_is_offloaded = false;
             dst_udp_mc_logdbg("Netdev is not offloaded fallback to OS");
+            return false;
         }
-    } else {
-        // XXX TODO: Why we dont pass is_connect to next resolve_net_dev call?
-        ret_val = dst_entry::resolve_net_dev();
     }
-    return ret_val;
+    // The path selects the net device of the TX interface without a route lookup
+    return dst_entry::resolve_net_dev();
+}
+
+dst_path_key dst_entry_udp_mc::get_path_key() const
+{
+    if (!m_mc_tx_src_ip.is_anyaddr() && !m_mc_tx_src_ip.is_mc(m_family)) {
+        return dst_path_key {m_dst_ip, m_bound_ip, m_mc_tx_src_ip, m_family, m_tos, true};
+    }
+    return dst_entry::get_path_key();
 }
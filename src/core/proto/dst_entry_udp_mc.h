@@ -22,6 +22,7 @@ protected:
 
     virtual void set_src_addr();
     virtual bool resolve_net_dev();
+    virtual dst_path_key get_path_key() const;
 };
 
 #endif /* DST_ENTRY_UDP_MC_H */
@@ -0,0 +1,257 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "dst_path.h"
+#include "core/dev/net_device_table_mgr.h"
+#include "core/proto/neighbour_table_mgr.h"
+#include "core/proto/route_table_mgr.h"
+
+#define MODULE_NAME "dst_path"
+
+#define dst_path_logdbg __log_info_dbg
+
+dst_path_table *g_p_dst_path_table = nullptr;
+
+dst_path::dst_path(const dst_path_key &key)
+    : m_key(key)
+    , m_lock("dst_path")
+    , m_generation(0U)
+    , m_pmtu(0U)
+{
+    dst_path_logdbg("%s", to_str().c_str());
+}
+
+dst_path::~dst_path()
+{
+    dst_path_logdbg("%s", to_str().c_str());
+
+    for (dst_path_hop &hop : m_hops) {
+        unregister_neigh(hop);
+    }
+    if (m_p_rt_entry) {
+        g_p_route_table_mgr->unregister_observer(
+            route_rule_table_key(m_key.dst_ip, m_key.src_ip, m_key.family, m_key.tos), this);
+        m_p_rt_entry = nullptr;
+    }
+}
+
+void dst_path::notify_cb()
+{
+    dst_path_logdbg("");
+    set_state(false);
+    m_pmtu.store(0U, std::memory_order_relaxed);
+    m_generation.fetch_add(1U, std::memory_order_release);
+}
+
+void dst_path::notify_cb(event *ev)
+{
+    NOT_IN_USE(ev);
+    notify_cb();
+}
+
+bool dst_path::resolve_net_dev(uint32_t flow_hash, route_val *&rt_val,
+                               net_device_val *&net_dev_val, uint32_t &hop)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    if (!is_valid()) {
+        // A notification during the resolution invalidates the path again
+        set_state(true);
+        if (!resolve()) {
+            set_state(false);
+            return false;
+        }
+    }
+    hop = m_nexthops.empty() ? 0U : route_nexthop_select(m_nexthops, flow_hash);
+    rt_val = m_p_rt_val;
+    net_dev_val = m_hops[hop].net_dev;
+    return true;
+}
+
+bool dst_path::resolve()
+{
+    net_device_val *new_nd_val;
+
+    if (m_key.without_route) {
+        new_nd_val =
+            g_p_net_device_table_mgr->get_net_device_val(ip_addr(m_key.dev_ip, m_key.family));
+    } else {
+        if (!m_p_rt_entry) {
+            cache_entry_subject<route_rule_table_key, route_val *> *p_ces = nullptr;
+            route_rule_table_key rtk(m_key.dst_ip, m_key.src_ip, m_key.family, m_key.tos);
+            if (!g_p_route_table_mgr->register_observer(rtk, this, &p_ces)) {
+                dst_path_logdbg("Error in registering route entry");
+                return false;
+            }
+            m_p_rt_entry = dynamic_cast<route_entry *>(p_ces);
+        }
+
+        route_val *p_rt_val = nullptr;
+        if (!m_p_rt_entry || !m_p_rt_entry->get_val(p_rt_val)) {
+            dst_path_logdbg("Route entry is not valid");
+            return false;
+        }
+        m_p_rt_val = p_rt_val;
+
+        if (!m_key.dev_ip.is_anyaddr() && g_p_net_device_table_mgr) {
+            new_nd_val = g_p_net_device_table_mgr->get_net_device_val(
+                ip_addr(m_key.dev_ip, m_key.family));
+        } else {
+            new_nd_val = m_p_rt_entry->get_net_dev_val();
+        }
+    }
+
+    if (m_p_net_dev_val != new_nd_val) {
+        dst_path_logdbg("updating net_device, new-if_name: %s",
+                        new_nd_val ? new_nd_val->get_ifname() : "N/A");
+        m_p_net_dev_val = new_nd_val;
+    }
+    update_hops();
+    return true;
+}
+
+void dst_path::update_hops()
+{
+    // A bound device pins the path to it
+    if (m_key.without_route || !m_key.dev_ip.is_anyaddr() || !m_p_rt_val) {
+        m_nexthops.clear();
+    } else {
+        m_nexthops = m_p_rt_val->get_nexthops();
+    }
+
+    size_t num_hops = m_nexthops.empty() ? 1U : m_nexthops.size();
+    while (m_hops.size() > num_hops) {
+        unregister_neigh(m_hops.back());
+        m_hops.pop_back();
+    }
+    m_hops.resize(num_hops);
+
+    // The hops keep their neighbours, resolve_neigh() replaces the ones which changed
+    if (m_nexthops.empty()) {
+        m_hops[0].net_dev = m_p_net_dev_val;
+        return;
+    }
+    for (size_t i = 0; i < m_nexthops.size(); ++i) {
+        int if_index = m_nexthops[i].if_index;
+        // The route entry tracks the bonding events of the primary interface
+        m_hops[i].net_dev = (if_index == m_p_rt_val->get_if_index() || !if_index)
+            ? m_p_net_dev_val
+            : g_p_net_device_table_mgr->get_net_device_val(if_index);
+    }
+}
+
+neigh_entry *dst_path::resolve_neigh(uint32_t hop)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    ip_address dst_addr = m_key.dst_ip;
+
+    if (hop >= m_hops.size()) {
+        return nullptr;
+    }
+    dst_path_hop &path_hop = m_hops[hop];
+
+    if (!dst_addr.is_mc(m_key.family)) {
+        if (!m_nexthops.empty()) {
+            if (!m_nexthops[hop].gw.is_anyaddr()) {
+                dst_addr = m_nexthops[hop].gw;
+            }
+        } else if (m_p_rt_val && !m_p_rt_val->get_gw_addr().is_anyaddr()) {
+            dst_addr = m_p_rt_val->get_gw_addr();
+        }
+    }
+
+    // The gateway or the net device changed since the registration
+    if (path_hop.neigh &&
+        (path_hop.neigh_ip != dst_addr ||
+         path_hop.neigh_net_dev != path_hop.net_dev)) {
+        unregister_neigh(path_hop);
+    }
+
+    if (!path_hop.neigh && path_hop.net_dev) {
+        cache_entry_subject<neigh_key, neigh_val *> *p_ces = nullptr;
+        if (g_p_neigh_table_mgr->register_observer(
+                neigh_key(ip_addr(dst_addr, m_key.family), path_hop.net_dev), this,
+                &p_ces)) {
+            path_hop.neigh = dynamic_cast<neigh_entry *>(p_ces);
+            path_hop.neigh_ip = dst_addr;
+            path_hop.neigh_net_dev = path_hop.net_dev;
+        }
+    }
+    return path_hop.neigh;
+}
+
+void dst_path::unregister_neigh(dst_path_hop &hop)
+{
+    if (hop.neigh) {
+        g_p_neigh_table_mgr->unregister_observer(
+            neigh_key(ip_addr(hop.neigh_ip, m_key.family), hop.neigh_net_dev), this);
+        hop.neigh = nullptr;
+        hop.neigh_net_dev = nullptr;
+    }
+}
+
+const std::string dst_path::to_str() const
+{
+    std::string rc = "dst: " + m_key.dst_ip.to_str(m_key.family);
+
+    rc += " src: " + m_key.src_ip.to_str(m_key.family);
+    if (!m_key.dev_ip.is_anyaddr()) {
+        rc += " dev: " + m_key.dev_ip.to_str(m_key.family);
+    }
+    rc += " tos: " + std::to_string(m_key.tos);
+    if (m_key.without_route) {
+        rc += " without route";
+    }
+    return rc;
+}
+
+dst_path_table::~dst_path_table()
+{
+    // The paths of the sockets which outlived the fd collection
+    for (auto &entry : m_paths) {
+        delete entry.second;
+    }
+    m_paths.clear();
+}
+
+dst_path *dst_path_table::get(const dst_path_key &key)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    auto iter = m_paths.find(key);
+    if (iter == m_paths.end()) {
+        dst_path *path = new (std::nothrow) dst_path(key);
+        if (!path) {
+            return nullptr;
+        }
+        iter = m_paths.emplace(key, path).first;
+    } else if (!iter->second->m_refcnt) {
+        m_idle_paths.erase(iter->second->m_idle_iter);
+    }
+    ++iter->second->m_refcnt;
+    return iter->second;
+}
+
+void dst_path_table::put(dst_path *path)
+{
+    {
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
+        if (--path->m_refcnt) {
+            return;
+        }
+        if (safe_mce_sys().path_cache_size) {
+            path->m_idle_iter = m_idle_paths.insert(m_idle_paths.end(), path);
+            if (m_idle_paths.size() <= safe_mce_sys().path_cache_size) {
+                return;
+            }
+            path = m_idle_paths.front();
+            m_idle_paths.pop_front();
+        }
+        m_paths.erase(path->get_key());
+    }
+    // Unregisters from the route and neighbour tables without the table lock
+    delete path;
+}
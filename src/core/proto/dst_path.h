@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef DST_PATH_H
+#define DST_PATH_H
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/lock_wrapper.h"
+#include "core/infra/cache_subject_observer.h"
+#include "core/proto/route_entry.h"
+#include "core/proto/neighbour.h"
+#include "core/util/ip_address.h"
+
+/*
+ * Destination of a dst_entry as the routing sees it. The dev_ip selects the net device
+ * (SO_BINDTODEVICE or the multicast TX interface), without_route skips the route lookup.
+ */
+struct dst_path_key {
+    ip_address dst_ip;
+    ip_address src_ip;
+    ip_address dev_ip;
+    sa_family_t family;
+    uint8_t tos;
+    bool without_route;
+
+    bool operator==(const dst_path_key &key) const
+    {
+        return dst_ip == key.dst_ip && src_ip == key.src_ip && dev_ip == key.dev_ip &&
+            family == key.family && tos == key.tos && without_route == key.without_route;
+    }
+};
+
+struct dst_path_key_hash {
+    size_t operator()(const dst_path_key &key) const
+    {
+        size_t hash = key.dst_ip.hash() * 31U + key.src_ip.hash();
+        hash = hash * 31U + key.dev_ip.hash();
+        return hash * 31U + (key.tos << 16U | key.family << 1U | key.without_route);
+    }
+};
+
+// Net device and neighbour registration of a next hop of the path
+struct dst_path_hop {
+    net_device_val *net_dev = nullptr;
+    neigh_entry *neigh = nullptr;
+    // Key of the registered neighbour entry
+    ip_address neigh_ip {in6addr_any};
+    net_device_val *neigh_net_dev = nullptr;
+};
+
+/**
+ * Route, net device and neighbour of all the dst_entry objects to the same destination.
+ *
+ * The path is the single observer of the route and neighbour entries, a notification bumps
+ * the generation and each dst_entry compares it with the one it resolved at. The headers,
+ * the ring and the neighbour L2 address copy stay in the dst_entry.
+ * A multipath route gives a hop per next hop, a dst_entry picks one by its flow hash and
+ * each hop resolves its own neighbour. Otherwise the path has a single hop.
+ * The methods lock the path, the dst_entry slow path lock may be held by the caller.
+ */
+class dst_path : public cache_observer, public tostr {
+public:
+    dst_path(const dst_path_key &key);
+    ~dst_path() override;
+
+    void notify_cb() override;
+    void notify_cb(event *ev) override;
+
+    // False if the route isn't resolved, the net device may be nullptr otherwise
+    bool resolve_net_dev(uint32_t flow_hash, route_val *&rt_val, net_device_val *&net_dev_val,
+                         uint32_t &hop);
+    neigh_entry *resolve_neigh(uint32_t hop);
+
+    uint32_t get_generation() const { return m_generation.load(std::memory_order_acquire); }
+    // Path MTU discovered by the TCP connections, 0 if unknown
+    uint32_t get_pmtu() const { return m_pmtu.load(std::memory_order_relaxed); }
+    void set_pmtu(uint32_t mtu) { m_pmtu.store(mtu, std::memory_order_relaxed); }
+    const dst_path_key &get_key() const { return m_key; }
+    const std::string to_str() const override;
+
+private:
+    friend class dst_path_table;
+
+    bool resolve();
+    void update_hops();
+    void unregister_neigh(dst_path_hop &hop);
+
+    const dst_path_key m_key;
+    lock_mutex m_lock;
+    std::atomic<uint32_t> m_generation;
+    // A route change forgets it
+    std::atomic<uint32_t> m_pmtu;
+    route_entry *m_p_rt_entry = nullptr;
+    route_val *m_p_rt_val = nullptr;
+    net_device_val *m_p_net_dev_val = nullptr;
+    // Copied from the route on the resolution, empty unless it is multipath
+    std::vector<route_nexthop> m_nexthops;
+    std::vector<dst_path_hop> m_hops;
+    // Number of dst_entry objects, guarded by the dst_path_table lock
+    uint32_t m_refcnt = 0U;
+    // Position in the unused paths of the table, valid while m_refcnt is 0
+    std::list<dst_path *>::iterator m_idle_iter;
+};
+
+/**
+ * Refcounted dst_path objects by their key. A path is created by the first dst_entry to a
+ * destination and destroyed with the last one, unless network.protocols.ip.path_cache_size
+ * keeps it. The kept paths stay registered and resolved, the least recently used goes first.
+ */
+class dst_path_table {
+public:
+    ~dst_path_table();
+
+    dst_path *get(const dst_path_key &key);
+    void put(dst_path *path);
+
+private:
+    lock_mutex m_lock {"dst_path_table"};
+    std::unordered_map<dst_path_key, dst_path *, dst_path_key_hash> m_paths;
+    // The paths without a dst_entry, the least recently used first
+    std::list<dst_path *> m_idle_paths;
+};
+
+extern dst_path_table *g_p_dst_path_table;
+
+#endif /* DST_PATH_H */
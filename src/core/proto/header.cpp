@@ -218,18 +218,8 @@ void header_ipv4::copy_l2_ip_hdr(void *p_h)
 void header_ipv4::copy_l2_ip_udp_hdr(void *p_h)
 {
     tx_ipv4_packet_template_t *p_hdr = reinterpret_cast<tx_ipv4_packet_template_t *>(p_h);
-    p_hdr->words[0] = m_header.words[0]; // dummy(16) + l2(16) (mac / dummy)
-    p_hdr->words[1] = m_header.words[1]; // l2 (32)            (mac / dummy)
-    p_hdr->words[2] = m_header.words[2]; // l2 (32)            (mac / dummy)
-    p_hdr->words[3] = m_header.words[3]; // l2 (32)            (mac / dummy)
-    p_hdr->words[4] = m_header.words[4]; // l2 (32)            (mac / vlan / ipoib)
-    p_hdr->words[5] = m_header.words[5]; // IP-> ver(4) + hdrlen(4) + tos(8) + totlen(16)
-    p_hdr->words[6] = m_header.words[6]; // IP-> id(16) + frag(16)
-    p_hdr->words[7] = m_header.words[7]; // IP-> ttl(8) + protocol(8) + checksum(16)
-    p_hdr->words[8] = m_header.words[8]; // IP-> saddr(32)
-    p_hdr->words[9] = m_header.words[9]; // IP-> daddr(32)
-    p_hdr->words[10] = m_header.words[10]; // UDP-> sport(16) + dst_port(16)
-    p_hdr->words[11] = m_header.words[11]; // UDP-> len(16) + check(16)
+    // Fixed size copy of the L2 + IP + UDP template (12 words), built with a few wide stores
+    memcpy(p_hdr->words, m_header.words, 12 * sizeof(uint32_t));
 }
 
 void header_ipv6::init()
@@ -308,21 +298,6 @@ void header_ipv6::copy_l2_ip_hdr(void *p_h)
 void header_ipv6::copy_l2_ip_udp_hdr(void *p_h)
 {
     tx_ipv6_packet_template_t *p_hdr = reinterpret_cast<tx_ipv6_packet_template_t *>(p_h);
-    p_hdr->words[0] = m_header.words[0]; // dummy(16) + l2(16) (mac / dummy)
-    p_hdr->words[1] = m_header.words[1]; // l2 (32)            (mac / dummy)
-    p_hdr->words[2] = m_header.words[2]; // l2 (32)            (mac / dummy)
-    p_hdr->words[3] = m_header.words[3]; // l2 (32)            (mac / dummy)
-    p_hdr->words[4] = m_header.words[4]; // l2 (32)            (mac / vlan / ipoib)
-    p_hdr->words[5] = m_header.words[5]; // IP-> version(4) + priority(4) + flow_lbl(24)
-    p_hdr->words[6] = m_header.words[6]; // IP-> payload_len(16) + nexthdr(8) + hop_limit(8)
-    p_hdr->words[7] = m_header.words[7]; // IP-> saddr(32)
-    p_hdr->words[8] = m_header.words[8]; // IP-> saddr(32)
-    p_hdr->words[9] = m_header.words[9]; // IP-> saddr(32)
-    p_hdr->words[10] = m_header.words[10]; // IP-> saddr(32)
-    p_hdr->words[11] = m_header.words[11]; // IP-> daddr(32)
-    p_hdr->words[12] = m_header.words[12]; // IP-> daddr(32)
-    p_hdr->words[13] = m_header.words[13]; // IP-> daddr(32)
-    p_hdr->words[14] = m_header.words[14]; // IP-> daddr(32)
-    p_hdr->words[15] = m_header.words[15]; // UDP-> sport(16) + dst_port(16)
-    p_hdr->words[16] = m_header.words[16]; // UDP-> len(16) + check(16)
+    // Fixed size copy of the L2 + IP + UDP template (17 words), built with a few wide stores
+    memcpy(p_hdr->words, m_header.words, 17 * sizeof(uint32_t));
 }
@@ -7,9 +7,8 @@
 #include "ip_frag.h"
 
 #include <assert.h>
-#include <list>
+#include <new>
 #include "utils/bullseye.h"
-#include "core/event/event_handler_manager.h"
 #include "mem_buf_desc.h"
 
 #undef MODULE_NAME
@@ -61,86 +60,131 @@ static int g_ip_frag_count_check = 0;
 #define PRINT_STATISTICS()
 #endif
 
-ip_frag_manager *g_p_ip_frag_manager = nullptr;
-
-ip_frag_hole_desc *hole_base = nullptr;
-ip_frag_hole_desc *hole_free_list_head = nullptr;
-int hole_free_list_count = 0;
-
-ip_frag_desc *desc_base = nullptr;
-ip_frag_desc *desc_free_list_head = nullptr;
-int desc_free_list_count = 0;
-
 ip_frag_manager::ip_frag_manager()
-    : lock_spin("ip_frag_manager")
+    : m_frag_counter(0)
+    , m_table_count(0)
+    , m_desc_free_list(nullptr)
+    , m_desc_free_count(0)
+    , m_hole_free_list(nullptr)
+    , m_hole_free_count(0)
+    , m_return_list(nullptr)
 {
-    frag_dbg("");
-    m_frag_counter = 0;
     int i;
 
-    frag_dbg("NOTE: ip frag periodic timer is disabled until HW supports ip frag offload");
-    // g_p_event_handler_manager->register_timer_event(IP_FRAG_CLEANUP_INT, this, PERIODIC_TIMER,
-    // 0);
+    memset(m_table, 0, sizeof(m_table));
 
-    frag_dbg("Created new IPFRAG MANAGER instance");
-    /* allocate hole list */
-    desc_base = new ip_frag_desc_t[IP_FRAG_MAX_DESC];
+    /* allocate descriptors and holes, without them every fragment is dropped */
+    m_desc_base = new (std::nothrow) ip_frag_desc_t[IP_FRAG_MAX_DESC];
+    m_hole_base = new (std::nothrow) ip_frag_hole_desc[IP_FRAG_MAX_HOLES];
     BULLSEYE_EXCLUDE_BLOCK_START
-    if (!desc_base) {
-        frag_dbg("Failed to allocate descriptor");
-        free_frag_resources();
-        throw_xlio_exception("Failed to allocate descriptor");
-    }
-    hole_base = new ip_frag_hole_desc[IP_FRAG_MAX_HOLES];
-    if (!hole_base) {
-        frag_dbg("Failed to allocate hole descriptor");
-        free_frag_resources();
-        throw_xlio_exception("Failed to allocate hole descriptor");
+    if (!m_desc_base || !m_hole_base) {
+        __log_info_warn("Failed to allocate IP fragments descriptors");
+        return;
     }
     BULLSEYE_EXCLUDE_BLOCK_END
     for (i = 0; i < IP_FRAG_MAX_DESC; i++) {
-        free_frag_desc(&desc_base[i]);
+        free_frag_desc(&m_desc_base[i]);
     }
     for (i = 0; i < IP_FRAG_MAX_HOLES; i++) {
-        free_hole_desc(&hole_base[i]);
+        free_hole_desc(&m_hole_base[i]);
     }
+    frag_dbg("Created new IPFRAG MANAGER instance");
 }
 
 void ip_frag_manager::free_frag_resources(void)
 {
+    for (uint32_t slot = 0; slot < IP_FRAG_TABLE_SIZE; ++slot) {
+        if (m_table[slot]) {
+            destroy_frag_desc(m_table[slot]);
+            free_frag_desc(m_table[slot]);
+            m_table[slot] = nullptr;
+        }
+    }
+    m_table_count = 0;
 
-    ip_frags_list_t::iterator i;
-    ip_frag_desc_t *desc;
+    return_buffers();
 
-    frag_dbg("NOTE: ip frag periodic timer is disabled until HW supports ip frag offload");
-    // g_p_event_handler_manager->unregister_timer_event(this, NULL);
+    delete[] m_desc_base;
+    delete[] m_hole_base;
+    frag_dbg("Deleted IPFRAG MANAGER instance");
+}
 
-    lock();
+ip_frag_manager::~ip_frag_manager()
+{
+    free_frag_resources();
+}
 
-    while (m_frags.size() > 0) {
-        i = m_frags.begin();
-        desc = i->second;
-        destroy_frag_desc(desc);
-        free_frag_desc(desc);
-        m_frags.erase(i);
-    }
+uint32_t ip_frag_manager::key_hash(const ip_frag_key_t &key)
+{
+    uint32_t hash = key.src_ip * 0x9e3779b1U;
 
-    owner_desc_map_t temp_buff_map = m_return_descs;
-    m_return_descs.clear();
+    hash ^= key.dst_ip + 0x7f4a7c15U + (hash << 6) + (hash >> 2);
+    hash ^= ((uint32_t)key.ip_id << 8 | key.ipproto) * 0x85ebca6bU;
+    return hash ^ (hash >> 16);
+}
 
-    unlock();
+/**
+ * Linear probing, returns the slot of the key or the empty slot to insert it.
+ * The table has twice the slots of the descriptors, so there is always an empty one.
+ */
+uint32_t ip_frag_manager::table_find(const ip_frag_key_t &key) const
+{
+    uint32_t slot = key_hash(key) & (IP_FRAG_TABLE_SIZE - 1);
 
-    // Must call cq_mgr_rx outside the lock to avoid ABBA deadlock
-    return_buffers_to_owners(temp_buff_map);
+    while (m_table[slot] && !(m_table[slot]->key == key)) {
+        slot = (slot + 1) & (IP_FRAG_TABLE_SIZE - 1);
+    }
+    return slot;
+}
 
-    delete[] desc_base;
-    delete[] hole_base;
-    frag_dbg("Deleted IPFRAG MANAGER instance");
+/**
+ * Backward shift deletion, the following entries of the cluster are moved so that
+ * no probe sequence is broken and no tombstone is needed.
+ */
+void ip_frag_manager::table_remove(uint32_t slot)
+{
+    uint32_t next = slot;
+
+    m_table[slot] = nullptr;
+    --m_table_count;
+    while (true) {
+        next = (next + 1) & (IP_FRAG_TABLE_SIZE - 1);
+        if (!m_table[next]) {
+            return;
+        }
+        uint32_t home = key_hash(m_table[next]->key) & (IP_FRAG_TABLE_SIZE - 1);
+        // Move the entry if its home isn't in the cyclic range (slot, next]
+        if (((next - home) & (IP_FRAG_TABLE_SIZE - 1)) >=
+            ((next - slot) & (IP_FRAG_TABLE_SIZE - 1))) {
+            m_table[slot] = m_table[next];
+            m_table[next] = nullptr;
+            slot = next;
+        }
+    }
 }
 
-ip_frag_manager::~ip_frag_manager()
+/**
+ * Discard the packets that didn't complete within IP_FRAG_SPACE fragments.
+ */
+void ip_frag_manager::expire_frags()
 {
-    free_frag_resources();
+    uint32_t slot = 0;
+
+    frag_dbg("expiring fragments, m_frag_counter=%ld", m_frag_counter);
+    PRINT_STATISTICS();
+
+    while (slot < IP_FRAG_TABLE_SIZE) {
+        ip_frag_desc_t *desc = m_table[slot];
+        if (desc && (m_frag_counter - desc->frag_counter) > IP_FRAG_SPACE) {
+            frag_dbg("expiring packet fragments desc=%p", desc);
+            destroy_frag_desc(desc);
+            free_frag_desc(desc);
+            // The shift may move a not yet visited entry into this slot
+            table_remove(slot);
+        } else {
+            ++slot;
+        }
+    }
 }
 
 #if _BullseyeCoverage
@@ -149,8 +193,8 @@ ip_frag_manager::~ip_frag_manager()
 
 void ip_frag_manager::print_statistics()
 {
-    frag_dbg("free desc=%d, free holes=%d, map size=%d, frags=%d", desc_free_list_count,
-             hole_free_list_count, m_frags.size(), g_ip_frag_count_check);
+    frag_dbg("free desc=%d, free holes=%d, table size=%u, frags=%d", m_desc_free_count,
+             m_hole_free_count, m_table_count, g_ip_frag_count_check);
 }
 
 void ip_frag_manager::free_frag(mem_buf_desc_t *frag)
@@ -173,22 +217,21 @@ void ip_frag_manager::free_frag(mem_buf_desc_t *frag)
     while (tail->p_next_desc) {
         tail = tail->p_next_desc;
     }
-    tail->p_next_desc = m_return_descs[frag->p_desc_owner];
-    m_return_descs[frag->p_desc_owner] = frag;
+    tail->p_next_desc = m_return_list;
+    m_return_list = frag;
 }
 
-// FIXME: use preallocated descriptors!!! instead of malloc
 ip_frag_hole_desc *ip_frag_manager::alloc_hole_desc()
 {
     struct ip_frag_hole_desc *ret;
-    ret = hole_free_list_head;
+    ret = m_hole_free_list;
     if (!ret) {
         return nullptr;
     }
 
     // unlink from hole's free list
-    hole_free_list_head = ret->next;
-    hole_free_list_count--;
+    m_hole_free_list = ret->next;
+    m_hole_free_count--;
 
     // clear hole struct
     ret->data_first = nullptr;
@@ -200,22 +243,22 @@ ip_frag_hole_desc *ip_frag_manager::alloc_hole_desc()
 void ip_frag_manager::free_hole_desc(struct ip_frag_hole_desc *p)
 {
     // link in head of free list
-    p->next = hole_free_list_head;
-    hole_free_list_head = p;
-    ++hole_free_list_count;
+    p->next = m_hole_free_list;
+    m_hole_free_list = p;
+    ++m_hole_free_count;
 }
 
 ip_frag_desc_t *ip_frag_manager::alloc_frag_desc()
 {
     ip_frag_desc_t *ret;
-    ret = desc_free_list_head;
+    ret = m_desc_free_list;
     if (!ret) {
         return nullptr;
     }
 
     // unlink from hole's free list
-    desc_free_list_head = ret->next;
-    --desc_free_list_count;
+    m_desc_free_list = ret->next;
+    --m_desc_free_count;
 
     ret->next = nullptr;
     return ret;
@@ -224,9 +267,9 @@ ip_frag_desc_t *ip_frag_manager::alloc_frag_desc()
 void ip_frag_manager::free_frag_desc(ip_frag_desc_t *p)
 {
     // link in head of free list
-    p->next = desc_free_list_head;
-    desc_free_list_head = p;
-    desc_free_list_count++;
+    p->next = m_desc_free_list;
+    m_desc_free_list = p;
+    m_desc_free_count++;
 }
 
 void ip_frag_manager::destroy_frag_desc(ip_frag_desc_t *desc)
@@ -253,6 +296,11 @@ ip_frag_desc_t *ip_frag_manager::new_frag_desc(ip_frag_key_t &key)
     ip_frag_desc_t *desc = nullptr;
     struct ip_frag_hole_desc *hole = nullptr;
 
+    if (!m_desc_free_list || !m_hole_free_list) {
+        // Reclaim the packets that will never complete before dropping this one
+        expire_frags();
+    }
+
     hole = alloc_hole_desc();
     if (!hole) {
         frag_dbg("NULL hole");
@@ -267,12 +315,13 @@ ip_frag_desc_t *ip_frag_manager::new_frag_desc(ip_frag_key_t &key)
         free_hole_desc(hole);
         return nullptr;
     }
-    desc->ttl = IP_FRAG_TTL;
+    desc->key = key;
     desc->frag_list = nullptr;
     desc->hole_list = hole;
     desc->frag_counter = m_frag_counter;
 
-    m_frags[key] = desc;
+    m_table[table_find(key)] = desc;
+    ++m_table_count;
     return desc;
 }
 
@@ -295,7 +344,7 @@ int ip_frag_manager::add_frag(ip6_hdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t
 int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t **ret)
 {
     ip_frag_key_t key;
-    ip_frags_list_t::iterator i;
+    uint32_t slot;
     ip_frag_desc_t *desc;
     struct ip_frag_hole_desc *phole, *phole_prev;
     struct ip_frag_hole_desc *new_hole;
@@ -320,8 +369,6 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
     }
 #endif
 
-    lock();
-
     MEMBUF_DEBUG_REF_INC(frag);
     PRINT_STATISTICS();
 
@@ -334,21 +381,20 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
 
     m_frag_counter++;
 
-    i = m_frags.find(key);
+    slot = table_find(key);
+    desc = m_table[slot];
 
-    if (i == m_frags.end()) {
+    if (!desc) {
         /* new fragment */
         frag_dbg("> new fragmented packet");
         desc = new_frag_desc(key);
     } else {
-        desc = i->second;
         if ((m_frag_counter - desc->frag_counter) > IP_FRAG_SPACE) {
             // discard this packet
-            frag_dbg("expiring packet fragments id=%x", i->first);
+            frag_dbg("expiring packet fragments id=%x", (int)key.ip_id);
             destroy_frag_desc(desc);
             free_frag_desc(desc);
-            m_frags.erase(i);
-            i = m_frags.end();
+            table_remove(slot);
             // Add new fregment
             frag_dbg("> new fragmented packet");
             desc = new_frag_desc(key);
@@ -359,7 +405,7 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
     if (!desc) {
         MEMBUF_DEBUG_REF_DEC(frag);
         PRINT_STATISTICS();
-        unlock();
+        return_buffers();
         return -1;
     }
 
@@ -380,7 +426,7 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
     if (!phole) { // the right hole wasn't found
         MEMBUF_DEBUG_REF_DEC(frag);
         PRINT_STATISTICS();
-        unlock();
+        return_buffers();
         return -1;
     }
 
@@ -400,7 +446,7 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
             free_hole_desc(phole); // phole was removed from the list in step 4!
             MEMBUF_DEBUG_REF_DEC(frag);
             PRINT_STATISTICS();
-            unlock();
+            return_buffers();
             return -1;
         }
         new_hole->first = phole->first;
@@ -425,7 +471,7 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
             free_hole_desc(phole); // phole was removed from the list in step 4!
             MEMBUF_DEBUG_REF_DEC(frag);
             PRINT_STATISTICS();
-            unlock();
+            return_buffers();
             return -1;
         }
 
@@ -454,87 +500,34 @@ int ip_frag_manager::add_frag(iphdr *hdr, mem_buf_desc_t *frag, mem_buf_desc_t *
 
     if (!desc->hole_list) {
         // step 8 - datagram assembly completed
-        if (i == m_frags.end()) {
-            i = m_frags.find(key);
-        }
-        if (i == m_frags.end()) {
+        slot = table_find(key);
+        if (m_table[slot] != desc) {
             MEMBUF_DEBUG_REF_DEC(frag);
-            frag_panic("frag desc lost from map???");
-            // coverity unreachable
-            /*unlock();
-            return -1;*/
+            frag_panic("frag desc lost from table???");
         }
         MEMBUF_DEBUG_REF_DEC(desc->frag_list);
-        m_frags.erase(i);
+        table_remove(slot);
         *ret = desc->frag_list;
         free_frag_desc(desc);
         frag_dbg("> PACKET ASSEMBLED");
         PRINT_STATISTICS();
-        unlock();
+        return_buffers();
         return 0;
     }
     frag_dbg("> need more packets");
 
     *ret = nullptr;
     PRINT_STATISTICS();
-    unlock();
+    return_buffers();
     return 0;
 }
 
-void ip_frag_manager::return_buffers_to_owners(const owner_desc_map_t &buff_map)
+void ip_frag_manager::return_buffers()
 {
-    // Assume locked !!!
-    owner_desc_map_t::const_iterator iter;
-
-    for (iter = buff_map.begin(); iter != buff_map.end(); ++iter) {
-        if (g_buffer_pool_rx_ptr) {
-            g_buffer_pool_rx_ptr->put_buffers_thread_safe(iter->second);
-        }
+    if (m_return_list && g_buffer_pool_rx_ptr) {
+        g_buffer_pool_rx_ptr->put_buffers_thread_safe(m_return_list);
     }
-}
-
-void ip_frag_manager::handle_timer_expired(void *user_data)
-{
-    NOT_IN_USE(user_data);
-    ip_frags_list_t::iterator iter, iter_temp;
-    ip_frag_desc_t *desc;
-    uint64_t delta = 0;
-
-    lock();
-    if (m_frag_counter > IP_FRAG_SPACE) {
-        delta = m_frag_counter - IP_FRAG_SPACE;
-        m_frag_counter -= delta;
-    }
-
-    frag_dbg("calling handle_timer_expired, m_frag_counter=%ld, delta=%ld", m_frag_counter, delta);
-    PRINT_STATISTICS();
-
-    iter = m_frags.begin();
-    while (iter != m_frags.end()) {
-        desc = iter->second;
-        desc->frag_counter -= delta;
-        if (desc->frag_counter < 0 || (desc->ttl <= 0)) { // discard this packet
-            frag_dbg("expiring packet fragments desc=%p (frag_counter=%d, ttl=%d)", desc,
-                     desc->frag_counter, desc->ttl);
-            destroy_frag_desc(desc);
-            free_frag_desc(desc);
-            iter_temp = iter++;
-            m_frags.erase(iter_temp);
-        } else {
-            iter++;
-        }
-
-        --desc->ttl;
-    }
-
-    owner_desc_map_t temp_buff_map = m_return_descs;
-    m_return_descs.clear();
-
-    PRINT_STATISTICS();
-    unlock();
-
-    // Must call cq_mgr_rx outside the lock to avoid ABBA deadlock
-    return_buffers_to_owners(temp_buff_map);
+    m_return_list = nullptr;
 }
 
 #if _BullseyeCoverage
@@ -11,32 +11,26 @@
  * IP reassembly is based on algorithm described in RFC815
  */
 
-#include <map>
 #include <netinet/ip.h>
 #include <netinet/udp.h>
 #include <sys/time.h>
 
 #include "vlogger/vlogger.h"
-#include "utils/lock_wrapper.h"
 #include <core/util/vtypes.h>
 #include <core/util/sys_vars.h>
-#include <core/event/timer_handler.h>
 #include <core/dev/buffer_pool.h>
 
 class mem_buf_desc_t;
-class event_handler_manager;
-class mem_buf_desc_owner;
 struct ip6_hdr;
 
 #define IP_FRAG_FREED ((size_t)-1)
 
 #define IP_FRAG_MAX_DESC    1024 /* maximum number of preallocated descriptors */
 #define IP_FRAG_MAX_HOLES   16000 /* maximum number of preallocated holes       */
-#define IP_FRAG_TTL         2 /* default unassembled fragment time to live in ticks */
+#define IP_FRAG_TABLE_SIZE  (2 * IP_FRAG_MAX_DESC) /* open addressing slots, power of 2 */
 #define IP_FRAG_INF         0xFFFF
 #define IP_FRAG_NINF        0x0
 #define IP_FRAG_SPACE       60000
-#define IP_FRAG_CLEANUP_INT 10
 
 struct ip_frag_key_t {
     uint16_t ip_id;
@@ -45,41 +39,10 @@ struct ip_frag_key_t {
     uint8_t ipproto;
 };
 
-inline bool operator<(ip_frag_key_t const &a, ip_frag_key_t const &b)
+inline bool operator==(ip_frag_key_t const &a, ip_frag_key_t const &b)
 {
-    if (a.ip_id < b.ip_id) {
-        return true;
-    }
-
-    if (a.ip_id > b.ip_id) {
-        return false;
-    }
-
-    if (a.src_ip < b.src_ip) {
-        return true;
-    }
-
-    if (a.src_ip > b.src_ip) {
-        return false;
-    }
-
-    if (a.dst_ip < b.dst_ip) {
-        return true;
-    }
-
-    if (a.dst_ip > b.dst_ip) {
-        return false;
-    }
-
-    if (a.ipproto < b.ipproto) {
-        return true;
-    }
-
-    if (a.ipproto > b.ipproto) {
-        return false;
-    }
-
-    return false;
+    return a.ip_id == b.ip_id && a.src_ip == b.src_ip && a.dst_ip == b.dst_ip &&
+        a.ipproto == b.ipproto;
 }
 
 struct ip_frag_hole_desc {
@@ -91,18 +54,21 @@ struct ip_frag_hole_desc {
 };
 
 typedef struct ip_frag_desc {
-    uint16_t ttl;
-    uint16_t pkt_size;
+    ip_frag_key_t key;
     struct ip_frag_hole_desc *hole_list;
     mem_buf_desc_t *frag_list;
     int64_t frag_counter;
     struct ip_frag_desc *next;
 } ip_frag_desc_t;
 
-typedef std::map<ip_frag_key_t, ip_frag_desc_t *, std::less<ip_frag_key_t>> ip_frags_list_t;
-typedef std::map<ring_slave *, mem_buf_desc_t *> owner_desc_map_t;
-
-class ip_frag_manager : private lock_spin, public timer_handler {
+/**
+ * Reassembly context of a single ring. It is only used from the RX path of its ring,
+ * so it takes no lock. The descriptors and the holes are preallocated on the first
+ * fragment and the packets in progress are found in an open addressing table.
+ * Incomplete packets expire once IP_FRAG_SPACE fragments were received after their
+ * first one, checked on lookup and swept when the descriptors run out.
+ */
+class ip_frag_manager {
 public:
     ip_frag_manager();
     ~ip_frag_manager();
@@ -121,17 +87,30 @@ public:
     uint64_t m_frag_counter;
 
 private:
-    ip_frags_list_t m_frags;
+    ip_frag_desc_t *m_table[IP_FRAG_TABLE_SIZE];
+    uint32_t m_table_count;
+
+    ip_frag_desc_t *m_desc_base;
+    ip_frag_desc_t *m_desc_free_list;
+    int m_desc_free_count;
+    ip_frag_hole_desc *m_hole_base;
+    ip_frag_hole_desc *m_hole_free_list;
+    int m_hole_free_count;
 
-    // Map of buffers to return, by owner
-    owner_desc_map_t m_return_descs;
+    // Buffers of discarded packets, returned once per add_frag()
+    mem_buf_desc_t *m_return_list;
+
+    static uint32_t key_hash(const ip_frag_key_t &key);
+    uint32_t table_find(const ip_frag_key_t &key) const;
+    void table_remove(uint32_t slot);
+    void expire_frags();
 
     /**
      * first fragment for given address is detected - setup
      */
     ip_frag_desc_t *new_frag_desc(ip_frag_key_t &key);
     void print_statistics();
-    void return_buffers_to_owners(const owner_desc_map_t &buff_map);
+    void return_buffers();
     void free_frag(mem_buf_desc_t *frag);
     ip_frag_hole_desc *alloc_hole_desc();
     void free_hole_desc(struct ip_frag_hole_desc *p);
@@ -139,11 +118,7 @@ private:
     void free_frag_desc(ip_frag_desc_t *p);
     void destroy_frag_desc(ip_frag_desc_t *desc);
 
-    virtual void handle_timer_expired(void *user_data);
-
     void free_frag_resources(void);
 };
 
-extern ip_frag_manager *g_p_ip_frag_manager;
-
 #endif
@@ -7,6 +7,7 @@
 #include "core/proto/mapping.h"
 #include "core/sock/sock-redirect.h"
 #include "core/util/instrumentation.h"
+#include "core/dev/ib_ctx_handler_collection.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -32,6 +33,25 @@
 
 mapping_cache *g_zc_cache = nullptr;
 
+/* Whether the implicit ODP regions of the devices cover any mapping */
+static bool is_odp_covered(ib_ctx_handler *p_ib_ctx)
+{
+    if (p_ib_ctx) {
+        return p_ib_ctx->get_odp_lkey() != LKEY_ERROR;
+    }
+
+    ib_context_map_t *ib_ctx_map = g_p_ib_ctx_handler_collection->get_ib_cxt_list();
+    if (!ib_ctx_map) {
+        return false;
+    }
+    for (const auto &ib_ctx_key_val : *ib_ctx_map) {
+        if (ib_ctx_key_val.second->get_odp_lkey() == LKEY_ERROR) {
+            return false;
+        }
+    }
+    return true;
+}
+
 mapping_t::mapping_t(file_uid_t &uid, mapping_cache *cache, ib_ctx_handler *p_ib_ctx)
     : m_registrator()
 {
@@ -62,6 +82,7 @@ int mapping_t::map(int fd)
 {
     struct stat st;
     bool result;
+    bool odp;
     bool rw;
     int flags;
     int rc;
@@ -84,7 +105,7 @@ int mapping_t::map(int fd)
     /* On success, rw flag indicates whether new fd is opened for writing. */
     m_fd = duplicate_fd(fd, rw);
     if (m_fd < 0) {
-        goto failed;
+        goto failed_free;
     }
 
     /*
@@ -99,14 +120,24 @@ int mapping_t::map(int fd)
      * performance results. For now, use only MAP_PRIVATE mappings.
      */
     flags = /* rw ? MAP_SHARED :*/ MAP_PRIVATE;
-    m_addr = mmap64(nullptr, m_size, PROT_WRITE | PROT_READ, flags | MAP_NORESERVE | MAP_POPULATE,
-                    m_fd, 0);
+    /*
+     * The registration faults the pages in by itself. Only with implicit ODP the
+     * page tables are populated here, so the adapter doesn't fault in the TX path.
+     */
+    odp = is_odp_covered(m_ib_ctx);
+    m_addr = mmap64(nullptr, m_size, PROT_WRITE | PROT_READ,
+                    flags | MAP_NORESERVE | (odp ? MAP_POPULATE : 0), m_fd, 0);
     if (MAP_FAILED == m_addr) {
         map_logerr("mmap64() errno=%d (%s)", errno, strerror(errno));
         goto failed_close_fd;
     }
+    /* Start the readahead of a cold file before it is faulted page by page */
+    if (!odp && madvise(m_addr, m_size, MADV_WILLNEED) != 0) {
+        map_logdbg("madvise() errno=%d (%s)", errno, strerror(errno));
+    }
 
-    result = m_registrator.register_memory(m_addr, m_size, m_ib_ctx);
+    // Nothing to pin with implicit ODP, the pages are resolved by the adapter on access
+    result = odp || m_registrator.register_memory(m_addr, m_size, m_ib_ctx);
     if (!result) {
         map_logerr("Failed to register mmapped memory");
         goto failed_unmap;
@@ -124,6 +155,8 @@ failed_close_fd:
     m_addr = nullptr;
     m_size = 0;
     m_fd = -1;
+failed_free:
+    p_cache->memory_free(st.st_size);
 failed:
     m_state = MAPPING_STATE_FAILED;
     return -1;
@@ -161,7 +194,8 @@ uint32_t mapping_t::get_lkey(mem_buf_desc_t *desc, ib_ctx_handler *p_ib_ctx, con
     NOT_IN_USE(addr);
     NOT_IN_USE(len);
 
-    return m_registrator.find_lkey_by_ib_ctx(p_ib_ctx);
+    uint32_t lkey = p_ib_ctx->get_odp_lkey();
+    return lkey != LKEY_ERROR ? lkey : m_registrator.find_lkey_by_ib_ctx(p_ib_ctx);
 }
 
 bool mapping_t::memory_belongs(uintptr_t addr, size_t size)
@@ -233,7 +267,7 @@ int mapping_t::duplicate_fd(int fd, bool &rw)
     return result;
 }
 
-mapping_cache::mapping_cache(size_t threshold)
+mapping_cache::mapping_cache(size_t threshold, uint32_t max_files)
     : lock_spin("mapping_cache_lock")
     , m_cache_uid()
     , m_cache_fd()
@@ -242,6 +276,8 @@ mapping_cache::mapping_cache(size_t threshold)
     memset(&m_stats, 0, sizeof(m_stats));
     m_used = 0;
     m_threshold = threshold;
+    m_nr_mapped = 0;
+    m_max_files = max_files;
 }
 
 mapping_cache::~mapping_cache()
@@ -267,7 +303,7 @@ mapping_cache::~mapping_cache()
     }
 }
 
-mapping_t *mapping_cache::get_mapping(int local_fd, void *p_ctx)
+mapping_t *mapping_cache::get_mapping(int local_fd, void *p_ctx, size_t min_size)
 {
     mapping_t *mapping = nullptr;
     mapping_fd_map_iter_t iter;
@@ -303,6 +339,12 @@ mapping_t *mapping_cache::get_mapping(int local_fd, void *p_ctx)
 
 quit:
     if (mapping) {
+        /* Nobody sends from a free mapping, so it can follow the file size */
+        if (mapping->m_state == MAPPING_STATE_MAPPED && mapping->m_size < min_size &&
+            mapping->is_free()) {
+            map_logdbg("File grew, remapping fd=%d size=%zu", local_fd, mapping->m_size);
+            mapping->unmap();
+        }
         mapping->get();
 
         /* Mapping object may be unmapped, call mmap() in this case */
@@ -359,11 +401,20 @@ bool mapping_cache::memory_reserve_unlocked(size_t size)
 {
     bool result = true;
 
-    if (m_used + size > m_threshold) {
+    /* Every mapping holds an fd and a memory registration, bound their number too */
+    while (m_max_files && m_nr_mapped >= m_max_files && result) {
+        result = !m_lru_list.empty();
+        if (result) {
+            evict_mapping_unlocked(m_lru_list.get_and_pop_front());
+            ++m_stats.n_evicts;
+        }
+    }
+    if (result && m_used + size > m_threshold) {
         result = cache_evict_unlocked(m_used + size - m_threshold);
     }
     if (result) {
         m_used += size;
+        ++m_nr_mapped;
     }
 
     return result;
@@ -376,7 +427,9 @@ void mapping_cache::memory_free(size_t size)
      * under the cache lock or in cache destructor.
      */
     assert(m_used >= size);
+    assert(m_nr_mapped > 0);
     m_used -= size;
+    --m_nr_mapped;
 }
 
 mapping_t *mapping_cache::get_mapping_by_uid_unlocked(file_uid_t &uid, ib_ctx_handler *p_ib_ctx)
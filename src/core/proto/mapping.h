@@ -98,10 +98,11 @@ typedef xlio_list_t<mapping_t, mapping_t::mapping_node_offset> mapping_list_t;
 
 class mapping_cache : public lock_spin {
 public:
-    mapping_cache(size_t threshold);
+    mapping_cache(size_t threshold, uint32_t max_files);
     ~mapping_cache();
 
-    mapping_t *get_mapping(int local_fd, void *p_ctx = nullptr);
+    /* min_size: a free mapping smaller than that is remapped, the file has grown */
+    mapping_t *get_mapping(int local_fd, void *p_ctx = nullptr, size_t min_size = 0);
     void release_mapping(mapping_t *mapping);
     void handle_close(int local_fd);
 
@@ -120,6 +121,8 @@ private:
     mapping_list_t m_lru_list;
     size_t m_used;
     size_t m_threshold;
+    uint32_t m_nr_mapped;
+    uint32_t m_max_files;
 };
 
 extern mapping_cache *g_zc_cache;
@@ -17,10 +17,18 @@
 
 // Forward declarations
 class ring_slave;
+class tx_ts_sink;
 struct iphdr;
 struct ip6_hdr;
 struct xlio_buf;
 
+// The TX HW timestamp request of a send, carried by the buffer of its last WQE
+struct tx_ts_request {
+    tx_ts_sink *sink;
+    uintptr_t userdata_op; // Ultra API send operation, zero for the POSIX sockets
+    uint32_t key; // SOF_TIMESTAMPING_OPT_ID of the send
+};
+
 struct timestamps_t {
     struct timespec sw;
     union {
@@ -38,6 +46,10 @@ struct timestamps_t {
  * 	TX fragment list, TX waiting completion signal list)
  * (3) p_buffer is the data buffer pointer (to be reused for TX or the ready
  * 	received data in TX)
+ *
+ * The fields are ordered by the RX fast path: the first cache line holds the pbuf and the
+ * data buffer, the second one the ownership and list linkage and the third one the RX
+ * packet metadata. The fields of UDP and timestamping follow.
  */
 class mem_buf_desc_t {
 public:
@@ -45,18 +57,21 @@ public:
         TYPICAL = 0,
         ZCOPY = 0x02,
         HAD_CQE_ERROR = 0x04,
+        RX_HDR = 0x08, // RX header split buffer, preserved across recycling
+        TX_CHAIN = 0x10, // TX buffers linked by p_next_desc are released together with this one
+        TX_TIMESTAMP = 0x20, // The WQE is signaled and reports tx.ts with its CQE timestamp
     };
 
 public:
     mem_buf_desc_t(uint8_t *buffer, size_t size, pbuf_type type)
         : p_buffer(buffer)
+        , sz_data(0)
+        , p_next_desc(nullptr)
+        , p_desc_owner(nullptr)
+        , sz_buffer(size)
         , m_flags(mem_buf_desc_t::TYPICAL)
         , lkey(0)
-        , p_next_desc(nullptr)
         , p_prev_desc(nullptr)
-        , sz_buffer(size)
-        , sz_data(0)
-        , p_desc_owner(nullptr)
         , unused_padding {0}
     {
         memset(&lwip_pbuf, 0, sizeof(lwip_pbuf));
@@ -121,6 +136,20 @@ public:
     /* This field must be first in this class. It encapsulates pbuf structure from lwip */
     struct pbuf lwip_pbuf;
     uint8_t *p_buffer;
+    size_t sz_data; // this is the amount of data inside the buffer (sz_data <= sz_buffer)
+
+    mem_buf_desc_t *p_next_desc; // A general purpose linked list of mem_buf_desc
+
+    // Tx: cq_mgr_tx owns the mem_buf_desc and the associated data buffer
+    // Rx: cq_mgr_rx owns the mem_buf_desc and the associated data buffer
+    ring_slave *p_desc_owner;
+
+    size_t sz_buffer; // this is the size of the buffer
+    int m_flags; /* object description */
+    uint32_t lkey; // Buffers lkey for QP access
+    atomic_t n_ref_count; // number of interested receivers (sockinfo) [can be modified only in
+                          // cq_mgr_rx context]
+    mem_buf_desc_t *p_prev_desc;
 
     static inline size_t buffer_node_offset(void)
     {
@@ -131,12 +160,8 @@ public:
     union {
         struct {
             iovec frag; // Datagram part base address and length
-            sock_addr src;
-            sock_addr dst;
-
             size_t sz_payload; // This is the total amount of data of the packet, if
                                // (sz_payload>sz_data) means fragmented packet.
-            timestamps_t timestamps;
 
             union {
                 struct {
@@ -154,11 +179,19 @@ public:
 
             size_t n_transport_header_len;
             uint32_t flow_tag_id; // Flow Tag ID of this received packet
+            uint32_t rss_hash; // Toeplitz hash of the packet, as computed by the NIC for RSS
             int8_t n_frags; // number of fragments
             bool is_sw_csum_need; // specify if software checksum is need for this packet
             uint8_t tls_decrypted;
             uint8_t tls_type;
             uint16_t strides_num;
+            uint16_t gro_size; // UDP GRO segment size of a coalesced datagram, 0 otherwise
+            uint64_t ready_tsc; // Queued to the socket ready list, for the latency histograms
+
+            // Not used by the TCP fast path
+            sock_addr src;
+            sock_addr dst;
+            timestamps_t timestamps;
         } rx;
         struct {
             size_t dev_mem_length; // Total data aligned to 4 bytes.
@@ -175,23 +208,11 @@ public:
                 void *ctx;
                 void (*callback)(mem_buf_desc_t *);
             } zc;
+            tx_ts_request ts;
         } tx;
     };
 
-    int m_flags; /* object description */
-    uint32_t lkey; // Buffers lkey for QP access
-    mem_buf_desc_t *p_next_desc; // A general purpose linked list of mem_buf_desc
-    mem_buf_desc_t *p_prev_desc;
-    size_t sz_buffer; // this is the size of the buffer
-    size_t sz_data; // this is the amount of data inside the buffer (sz_data <= sz_buffer)
-
-    // Tx: cq_mgr_tx owns the mem_buf_desc and the associated data buffer
-    // Rx: cq_mgr_rx owns the mem_buf_desc and the associated data buffer
-    ring_slave *p_desc_owner;
-
-    atomic_t n_ref_count; // number of interested receivers (sockinfo) [can be modified only in
-                          // cq_mgr_rx context]
-    uint64_t unused_padding[5]; // Align the structure to the cache line boundary
+    uint64_t unused_padding[4]; // Align the structure to the cache line boundary
 };
 
 typedef xlio_list_t<mem_buf_desc_t, mem_buf_desc_t::buffer_node_offset> descq_t;
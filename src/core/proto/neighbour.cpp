@@ -15,6 +15,7 @@
 #include "core/proto/dst_entry_udp.h"
 #include "core/proto/neighbour.h"
 #include "core/proto/neighbour_table_mgr.h"
+#include "core/util/instrumentation.h"
 #include "core/util/utils.h"
 #include "core/util/vtypes.h"
 
@@ -149,10 +150,12 @@ neigh_entry::neigh_entry(neigh_key key, transport_type_t _type, bool is_init_res
     , m_to_str(std::string(priv_xlio_transport_type_str(m_trans_type)) + ":" + get_key().to_str())
     , m_id(0)
     , m_is_first_send_arp(true)
+    , m_refresh_failed(false)
     , m_ch_fd(-1)
     , m_n_sysvar_neigh_wait_till_send_arp_msec(safe_mce_sys().neigh_wait_till_send_arp_msec)
     , m_n_sysvar_neigh_uc_arp_quata(safe_mce_sys().neigh_uc_arp_quata)
     , m_n_sysvar_neigh_num_err_retries(safe_mce_sys().neigh_num_err_retries)
+    , m_n_sysvar_neigh_refresh_msec(safe_mce_sys().neigh_refresh_msec)
 {
     m_val = NULL;
 
@@ -334,6 +337,14 @@ void neigh_entry::handle_timer_expired(void *ctx)
 
     // Check if neigh_entry state is reachable
     int state = 0;
+    if (m_refresh_failed) {
+        m_refresh_failed = false;
+        if (sm_state == ST_READY && (!priv_get_neigh_state(state) || priv_is_failed(state))) {
+            neigh_logdbg("Still failed after the refresh, dropping the L2 address");
+            event_handler(EV_ERROR);
+            return;
+        }
+    }
     if (!priv_get_neigh_state(state)) {
         neigh_logdbg("neigh state not valid!\n");
         return;
@@ -725,9 +736,53 @@ void neigh_entry::priv_handle_neigh_reachable_event()
     // In case this is reachable event we should set ARP counter to 0 and stop the timer
     //(we don't want to continue sending ARPs)
     m_arp_counter = 0;
+    m_refresh_failed = false;
     priv_unregister_timer();
 }
 
+void neigh_entry::refresh()
+{
+    int state = 0;
+
+    if (m_type != UC) {
+        return;
+    }
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    // Only the entries in use, an unused one expires and is collected
+    if (m_state_machine->get_curr_state() != ST_READY || m_refresh_failed ||
+        m_observers.empty()) {
+        return;
+    }
+    // The offloaded traffic doesn't confirm the kernel entry, it goes stale and expires
+    if (priv_get_neigh_state(state) && !priv_is_reachable(state)) {
+        neigh_logdbg("Refreshing neigh in state %d", state);
+        send_discovery_request();
+    }
+}
+
+// Keeps a ready entry and its L2 address for one more refresh interval, the sends go on
+// while the neighbor is resolved again
+bool neigh_entry::priv_refresh_on_failure()
+{
+    if (!m_n_sysvar_neigh_refresh_msec || m_type != UC || m_refresh_failed) {
+        return false;
+    }
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    if (m_state_machine->get_curr_state() != ST_READY) {
+        return false;
+    }
+    neigh_logdbg("Failed, keeping the L2 address until the next refresh");
+    m_refresh_failed = true;
+    // Broadcast, the peer may have moved
+    m_arp_counter = m_n_sysvar_neigh_uc_arp_quata;
+    send_discovery_request();
+    m_timer_handle =
+        priv_register_timer_event(m_n_sysvar_neigh_refresh_msec, this, ONE_SHOT_TIMER, NULL);
+    return true;
+}
+
 //==========================================  cache_observer functions implementation
 //============================
 
@@ -863,7 +918,9 @@ void neigh_entry::handle_neigh_event(neigh_nl_event *nl_ev)
 
     case NUD_FAILED: {
         neigh_logdbg("state = FAILED");
-        event_handler(EV_ERROR);
+        if (!priv_refresh_on_failure()) {
+            event_handler(EV_ERROR);
+        }
         break;
     }
 
@@ -1092,6 +1149,7 @@ void neigh_entry::dofunc_enter_ready(const sm_info_t &func_info)
 void neigh_entry::priv_general_st_entry(const sm_info_t &func_info)
 {
     NOT_IN_USE(func_info); /* to supress warning in case MAX_DEFINED_LOG_LEVEL */
+    XLIO_TRACE(neigh_state, this, func_info.old_state, func_info.new_state, func_info.event);
     neigh_logdbg("State change: %s (%d) => %s (%d) with event %s (%d)",
                  state_to_str((state_t)func_info.old_state), func_info.old_state,
                  state_to_str((state_t)func_info.new_state), func_info.new_state,
@@ -190,6 +190,8 @@ public:
 
     void handle_event_rdma_cm_cb(struct rdma_cm_event *p_event) override;
     void handle_neigh_event(neigh_nl_event *nl_ev);
+    // Proactive refresh of a ready entry, called periodically by the neigh_table_mgr
+    void refresh();
 
     static void general_st_entry(const sm_info_t &func_info);
     static void general_st_leave(const sm_info_t &func_info);
@@ -254,6 +256,7 @@ protected:
 
     virtual bool priv_handle_neigh_is_l2_changed(address_t) { return false; };
     void priv_handle_neigh_reachable_event();
+    bool priv_refresh_on_failure();
     void priv_destroy_cma_id();
     virtual void *priv_register_timer_event(int timeout_msec, timer_handler *handler,
                                             timer_req_type_t req_type, void *user_data);
@@ -275,10 +278,13 @@ protected:
 
 private:
     bool m_is_first_send_arp;
+    // A failed entry kept ready for one more refresh interval
+    bool m_refresh_failed;
     int m_ch_fd;
     const uint32_t m_n_sysvar_neigh_wait_till_send_arp_msec;
     const uint32_t m_n_sysvar_neigh_uc_arp_quata;
     const uint32_t m_n_sysvar_neigh_num_err_retries;
+    const uint32_t m_n_sysvar_neigh_refresh_msec;
     ring_allocation_logic_tx m_ring_allocation_logic;
     event_t rdma_event_mapping(struct rdma_cm_event *p_event);
     void empty_unsent_queue();
@@ -13,6 +13,7 @@
 #include "core/proto/neighbour_table_mgr.h"
 
 #include "core/dev/net_device_table_mgr.h"
+#include "core/proto/route_table_mgr.h"
 
 #define MODULE_NAME "ntm:"
 
@@ -27,6 +28,8 @@
 neigh_table_mgr *g_p_neigh_table_mgr = nullptr;
 
 #define DEFAULT_GARBAGE_COLLECTOR_TIME 100000
+// Timer user data which marks the refresh timer, the garbage collector has none
+#define NEIGH_REFRESH_TIMER ((void *)1)
 
 neigh_table_mgr::neigh_table_mgr()
 {
@@ -34,6 +37,14 @@ neigh_table_mgr::neigh_table_mgr()
 
     create_rdma_channel();
     start_garbage_collector(DEFAULT_GARBAGE_COLLECTOR_TIME);
+
+    if (safe_mce_sys().neigh_refresh_msec) {
+        m_refresh_timer_handle = g_p_event_handler_manager->register_timer_event(
+            safe_mce_sys().neigh_refresh_msec, this, PERIODIC_TIMER, NEIGH_REFRESH_TIMER);
+        if (!m_refresh_timer_handle) {
+            neigh_mgr_logwarn("Failed to start the neighbor refresh");
+        }
+    }
 }
 
 void neigh_table_mgr::create_rdma_channel()
@@ -51,6 +62,14 @@ void neigh_table_mgr::create_rdma_channel()
 
 neigh_table_mgr::~neigh_table_mgr()
 {
+    if (m_refresh_timer_handle) {
+        g_p_event_handler_manager->unregister_timer_event(this, m_refresh_timer_handle);
+        m_refresh_timer_handle = nullptr;
+    }
+    for (const neigh_key &key : m_preresolved) {
+        unregister_observer(key, &m_preresolve_observer);
+    }
+    m_preresolved.clear();
     stop_garbage_collector();
     if (m_neigh_cma_event_channel) {
         rdma_destroy_event_channel(m_neigh_cma_event_channel);
@@ -73,6 +92,83 @@ bool neigh_table_mgr::register_observer(
                                                                             cache_entry);
 }
 
+void neigh_table_mgr::handle_timer_expired(void *user_data)
+{
+    if (user_data == NEIGH_REFRESH_TIMER) {
+        refresh_entries();
+    } else {
+        cache_table_mgr<neigh_key, class neigh_val *>::handle_timer_expired(user_data);
+    }
+}
+
+void neigh_table_mgr::refresh_entries()
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    for (auto &entry : m_cache_tbl) {
+        neigh_entry *p_ne = dynamic_cast<neigh_entry *>(entry.second);
+        if (p_ne) {
+            p_ne->refresh();
+        }
+    }
+}
+
+void neigh_table_mgr::preresolve(const char *addr_list)
+{
+    std::string list(addr_list);
+    size_t pos = 0;
+
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        if (end > pos) {
+            preresolve_addr(list.substr(pos, end - pos));
+        }
+        pos = end + 1;
+    }
+}
+
+void neigh_table_mgr::preresolve_addr(const std::string &addr_str)
+{
+    struct in6_addr in;
+    sa_family_t family = AF_INET;
+
+    if (1 != inet_pton(AF_INET, addr_str.c_str(), &in)) {
+        family = AF_INET6;
+        if (1 != inet_pton(AF_INET6, addr_str.c_str(), &in)) {
+            neigh_mgr_logwarn("Ignoring the pre-resolve address '%s', not a valid IP",
+                              addr_str.c_str());
+            return;
+        }
+    }
+
+    ip_address addr(reinterpret_cast<void *>(&in), family);
+    route_result res;
+    if (!g_p_route_table_mgr ||
+        !g_p_route_table_mgr->route_resolve(
+            route_rule_table_key(addr, ip_address(in6addr_any), family, 0U), res)) {
+        neigh_mgr_logwarn("Ignoring the pre-resolve address %s, no route", addr_str.c_str());
+        return;
+    }
+
+    net_device_val *p_ndev = g_p_net_device_table_mgr->get_net_device_val(res.if_index);
+    if (!p_ndev) {
+        neigh_mgr_logdbg("Ignoring the pre-resolve address %s, interface %d is not offloaded",
+                         addr_str.c_str(), res.if_index);
+        return;
+    }
+
+    // Registration kicks off the resolution
+    neigh_key key(ip_addr(addr, family), p_ndev);
+    cache_entry_subject<neigh_key, class neigh_val *> *p_ces = nullptr;
+    if (register_observer(key, &m_preresolve_observer, &p_ces)) {
+        neigh_mgr_logdbg("Pre-resolving %s", key.to_str().c_str());
+        m_preresolved.push_back(key);
+    }
+}
+
 neigh_entry *neigh_table_mgr::create_new_entry(neigh_key neigh_key, const observer *obs)
 {
     NOT_IN_USE(obs);
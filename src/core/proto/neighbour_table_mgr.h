@@ -7,6 +7,8 @@
 #ifndef NEIGHBOUR_TABLE_MGR_H
 #define NEIGHBOUR_TABLE_MGR_H
 
+#include <vector>
+
 #include "core/proto/neighbour.h"
 #include "core/infra/cache_subject_observer.h"
 
@@ -19,6 +21,11 @@ public:
                                     event_handler_rdma_cm *context);
     bool register_observer(neigh_key, const cache_observer *,
                            cache_entry_subject<neigh_key, class neigh_val *> **);
+    // Resolves the comma separated next hop addresses and keeps them resolved
+    void preresolve(const char *addr_list);
+
+protected:
+    void handle_timer_expired(void *user_data) override;
 
 private:
     /* This function will retrieve neigh transport type by the following actions:
@@ -28,10 +35,16 @@ private:
      */
     neigh_entry *create_new_entry(neigh_key neigh_key, const observer *dst);
     void create_rdma_channel();
+    void refresh_entries();
+    void preresolve_addr(const std::string &addr_str);
 
     rdma_event_channel *m_neigh_cma_event_channel = nullptr;
     rdma_event_channel *m_neigh_cma_event_channel_prev = nullptr;
     lock_rw m_channel_lock;
+    void *m_refresh_timer_handle = nullptr;
+    // Observer which holds the pre-resolved entries
+    cache_observer m_preresolve_observer;
+    std::vector<neigh_key> m_preresolved;
 };
 
 extern neigh_table_mgr *g_p_neigh_table_mgr;
@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <string.h>
+
+#include "utils/asm.h"
+#include "nvme_tcp.h"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#endif
+
+#define CRC32C_POLY  0x82F63B78U // Reflected Castagnoli polynomial
+#define CRC32C_BLOCK 256U // Bytes of each of the three interleaved streams
+
+/*
+ * The CRC is linear: the CRC of A followed by B is the CRC of A shifted over len(B) zero bytes
+ * xor the CRC of B started from zero. The shift over CRC32C_BLOCK zero bytes is a linear map of
+ * the 32 bit state, applied with a table per byte of the state.
+ */
+struct crc32c_table_t {
+    uint32_t entry[256];
+    uint32_t shift[4][256];
+
+    crc32c_table_t()
+    {
+        uint32_t column[32];
+
+        for (uint32_t i = 0; i < 256U; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1U) ^ ((crc & 1U) ? CRC32C_POLY : 0U);
+            }
+            entry[i] = crc;
+        }
+        for (uint32_t bit = 0; bit < 32U; ++bit) {
+            uint32_t crc = 1U << bit;
+            for (uint32_t i = 0; i < CRC32C_BLOCK; ++i) {
+                crc = (crc >> 8U) ^ entry[crc & 0xFFU];
+            }
+            column[bit] = crc;
+        }
+        for (uint32_t byte = 0; byte < 4U; ++byte) {
+            for (uint32_t i = 0; i < 256U; ++i) {
+                uint32_t crc = 0U;
+                for (uint32_t bit = 0; bit < 8U; ++bit) {
+                    crc ^= ((i >> bit) & 1U) ? column[byte * 8U + bit] : 0U;
+                }
+                shift[byte][i] = crc;
+            }
+        }
+    }
+};
+
+static const crc32c_table_t s_crc32c_table;
+
+static inline uint32_t crc32c_sw_byte(uint32_t crc, uint8_t byte)
+{
+    return (crc >> 8U) ^ s_crc32c_table.entry[(crc ^ byte) & 0xFFU];
+}
+
+static uint32_t crc32c_sw(uint32_t crc, void *dst, const void *src, size_t len)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(src);
+
+    if (dst) {
+        memcpy(dst, src, len);
+    }
+    while (len--) {
+        crc = crc32c_sw_byte(crc, *p++);
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+
+#define CRC32C_HW_TARGET __attribute__((target("sse4.2")))
+
+CRC32C_HW_TARGET static inline uint32_t crc32c_hw_u64(uint32_t crc, uint64_t word)
+{
+    return static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+}
+
+CRC32C_HW_TARGET static inline uint32_t crc32c_hw_u8(uint32_t crc, uint8_t byte)
+{
+    return _mm_crc32_u8(crc, byte);
+}
+
+#elif defined(__aarch64__)
+
+#define CRC32C_HW_TARGET __attribute__((target("+crc")))
+
+CRC32C_HW_TARGET static inline uint32_t crc32c_hw_u64(uint32_t crc, uint64_t word)
+{
+    return __crc32cd(crc, word);
+}
+
+CRC32C_HW_TARGET static inline uint32_t crc32c_hw_u8(uint32_t crc, uint8_t byte)
+{
+    return __crc32cb(crc, byte);
+}
+
+#endif
+
+#ifdef CRC32C_HW_TARGET
+
+static inline uint32_t crc32c_shift_block(uint32_t crc)
+{
+    return s_crc32c_table.shift[0][crc & 0xFFU] ^ s_crc32c_table.shift[1][(crc >> 8U) & 0xFFU] ^
+        s_crc32c_table.shift[2][(crc >> 16U) & 0xFFU] ^ s_crc32c_table.shift[3][crc >> 24U];
+}
+
+CRC32C_HW_TARGET static inline uint32_t crc32c_hw_word(uint32_t crc, uint8_t *d,
+                                                       const uint8_t *p)
+{
+    uint64_t word;
+
+    memcpy(&word, p, sizeof(word));
+    if (d) {
+        memcpy(d, &word, sizeof(word));
+    }
+    return crc32c_hw_u64(crc, word);
+}
+
+/*
+ * The CRC instruction has a latency of three cycles and a throughput of one, three streams
+ * over consecutive blocks keep it busy. The streams are combined with the shift table.
+ */
+CRC32C_HW_TARGET static uint32_t crc32c_hw(uint32_t crc, void *dst, const void *src, size_t len)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(src);
+    uint8_t *d = static_cast<uint8_t *>(dst);
+
+    for (; len >= 3U * CRC32C_BLOCK; len -= 3U * CRC32C_BLOCK) {
+        uint8_t *d1 = d ? d + CRC32C_BLOCK : nullptr;
+        uint8_t *d2 = d ? d + 2U * CRC32C_BLOCK : nullptr;
+        uint32_t crc1 = 0U;
+        uint32_t crc2 = 0U;
+
+        for (size_t i = 0; i < CRC32C_BLOCK; i += sizeof(uint64_t)) {
+            crc = crc32c_hw_word(crc, d, p + i);
+            crc1 = crc32c_hw_word(crc1, d1, p + CRC32C_BLOCK + i);
+            crc2 = crc32c_hw_word(crc2, d2, p + 2U * CRC32C_BLOCK + i);
+            d = d ? d + sizeof(uint64_t) : nullptr;
+            d1 = d1 ? d1 + sizeof(uint64_t) : nullptr;
+            d2 = d2 ? d2 + sizeof(uint64_t) : nullptr;
+        }
+        crc = crc32c_shift_block(crc) ^ crc1;
+        crc = crc32c_shift_block(crc) ^ crc2;
+        p += 3U * CRC32C_BLOCK;
+        d = d2;
+    }
+    for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t)) {
+        crc = crc32c_hw_word(crc, d, p);
+        d = d ? d + sizeof(uint64_t) : nullptr;
+        p += sizeof(uint64_t);
+    }
+    for (; len; --len) {
+        if (d) {
+            *d++ = *p;
+        }
+        crc = crc32c_hw_u8(crc, *p++);
+    }
+    return crc;
+}
+
+static const bool s_crc32c_hw = cpu_has_crc32c();
+
+static inline uint32_t crc32c_update(uint32_t crc, void *dst, const void *src, size_t len)
+{
+    return s_crc32c_hw ? crc32c_hw(crc, dst, src, len) : crc32c_sw(crc, dst, src, len);
+}
+
+#else /* CRC32C_HW_TARGET */
+
+static inline uint32_t crc32c_update(uint32_t crc, void *dst, const void *src, size_t len)
+{
+    return crc32c_sw(crc, dst, src, len);
+}
+
+#endif /* CRC32C_HW_TARGET */
+
+uint32_t crc32c(uint32_t crc, const void *buf, size_t len)
+{
+    return crc32c_update(crc, nullptr, buf, len);
+}
+
+uint32_t crc32c_copy(uint32_t crc, void *dst, const void *src, size_t len)
+{
+    return crc32c_update(crc, dst, src, len);
+}
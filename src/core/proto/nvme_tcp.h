@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef NVME_TCP_H
+#define NVME_TCP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * NVMe/TCP PDU layout, as much as the digests and the data placement of C2HData need.
+ * All the header fields are little endian.
+ */
+#define NVME_TCP_CH_LEN        8U // Common header: type, flags, hlen, pdo and plen
+#define NVME_TCP_C2H_DATA_HLEN 24U
+#define NVME_TCP_DIGEST_LEN    4U
+
+enum nvme_tcp_pdu_type {
+    NVME_TCP_PDU_C2H_DATA = 0x07,
+};
+
+enum nvme_tcp_pdu_flags {
+    NVME_TCP_F_HDGST = 0x01,
+    NVME_TCP_F_DDGST = 0x02,
+};
+
+struct __attribute__((packed)) nvme_tcp_c2h_data_hdr {
+    uint8_t type;
+    uint8_t flags;
+    uint8_t hlen;
+    uint8_t pdo;
+    uint32_t plen;
+    uint16_t cccid;
+    uint16_t rsvd1;
+    uint32_t datao;
+    uint32_t datal;
+    uint32_t rsvd2;
+};
+
+/*
+ * CRC32C (Castagnoli) of the NVMe/TCP digests. A digest starts from CRC32C_INIT and the
+ * final value is inverted with crc32c_final(). The CRC32 instruction of SSE4.2 or ARMv8 is used
+ * when the CPU has it.
+ */
+#define CRC32C_INIT 0xFFFFFFFFU
+
+uint32_t crc32c(uint32_t crc, const void *buf, size_t len);
+// Copies the buffer and updates the CRC over it in the same pass
+uint32_t crc32c_copy(uint32_t crc, void *dst, const void *src, size_t len);
+
+static inline uint32_t crc32c_final(uint32_t crc)
+{
+    return crc ^ CRC32C_INIT;
+}
+
+#endif /* NVME_TCP_H */
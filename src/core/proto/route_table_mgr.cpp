@@ -46,8 +46,6 @@
 #define DEFAULT_ROUTE_TABLE_SIZE 256
 #define MAX_ROUTE_TABLE_SIZE     32768
 
-static inline route_val *find_route_val(route_table_t &table, const ip_address &dst,
-                                        uint32_t table_id);
 route_table_mgr *g_p_route_table_mgr = nullptr;
 
 route_table_mgr::route_table_mgr()
@@ -115,9 +113,12 @@ void route_table_mgr::dump_tbl()
     rt_mgr_loginfo("");
     rt_mgr_loginfo("Routing table lookup stats: %u / %u [hit/miss]", m_stats.n_lookup_hit,
                    m_stats.n_lookup_miss);
-    rt_mgr_loginfo("Routing table update stats: %u / %u / %u [new/del/unhandled]",
+    rt_mgr_loginfo("Routing table update stats: %u / %u / %u / %u [new/del/unhandled/batches]",
                    m_stats.n_updates_newroute, m_stats.n_updates_delroute,
-                   m_stats.n_updates_unhandled);
+                   m_stats.n_updates_unhandled, m_stats.n_updates_batches);
+    rt_mgr_loginfo("Rule lookup stats: %u / %u [cache hit/miss], %" PRIu64
+                   " rules compared on the misses",
+                   m_stats.n_rule_cache_hit, m_stats.n_rule_cache_miss, m_stats.n_rule_compared);
 }
 
 void route_table_mgr::update_tbl(nl_data_t data_type)
@@ -154,7 +155,10 @@ void route_table_mgr::parse_entry(struct nl_object *nl_obj)
 
     val.set_state(true);
 
-    route_table_t &table = val.get_family() == AF_INET ? m_table_in4 : m_table_in6;
+    route_table_t &table = get_table(val.get_family());
+    // A duplicate keeps the first position, as the lookup finds the first match
+    get_index(val.get_family()).emplace(val, table.size());
+    lpm_insert(val, table.size());
     table.push_back(val);
 }
 
@@ -183,6 +187,11 @@ void route_table_mgr::parse_attr(struct rtnl_route *route, route_val &val)
         }
     }
 
+    parse_nexthops(route, val);
+}
+
+void route_table_mgr::parse_nexthops(struct rtnl_route *route, route_val &val)
+{
     // Nexthop handling: Extract interface and gateway from nexthops
     // Try foreach_nexthop first for multipath/weight-based selection,
     // then fall back to nexthop_n(0) for routes that don't iterate
@@ -190,10 +199,12 @@ void route_table_mgr::parse_attr(struct rtnl_route *route, route_val &val)
         struct rtnl_nexthop *best_next_hop;
         uint8_t best_next_hop_weight;
         sa_family_t family;
+        std::vector<route_nexthop> nexthops;
 
     } best_next_hop_context = {.best_next_hop = nullptr,
                                .best_next_hop_weight = 0,
-                               .family = static_cast<sa_family_t>(val.get_family())};
+                               .family = static_cast<sa_family_t>(val.get_family()),
+                               .nexthops = {}};
 
     rtnl_route_foreach_nexthop(
         route,
@@ -202,9 +213,10 @@ void route_table_mgr::parse_attr(struct rtnl_route *route, route_val &val)
             const uint8_t current_nh_weight = rtnl_route_nh_get_weight(next_hop);
 
             // Check gateway - skip link-local gateways as they're not usable for routing
+            ip_address gw_ip(in6addr_any);
             struct nl_addr *gw = rtnl_route_nh_get_gateway(next_hop);
             if (gw && is_valid_addr(gw)) {
-                ip_address gw_ip(nl_addr_get_binary_addr(gw), nl_addr_get_family(gw));
+                gw_ip = ip_address(nl_addr_get_binary_addr(gw), nl_addr_get_family(gw));
                 // Skip link-local gateways (matching old RTA_MULTIPATH behavior)
                 if (gw_ip.is_linklocal(ctx->family)) {
                     return;
@@ -218,6 +230,8 @@ void route_table_mgr::parse_attr(struct rtnl_route *route, route_val &val)
                 ctx->best_next_hop_weight = normalized_weight;
                 ctx->best_next_hop = next_hop;
             }
+            ctx->nexthops.push_back(
+                route_nexthop {gw_ip, rtnl_route_nh_get_ifindex(next_hop), normalized_weight});
         },
         &best_next_hop_context);
 
@@ -244,6 +258,11 @@ void route_table_mgr::parse_attr(struct rtnl_route *route, route_val &val)
             val.set_if_name(nh_if_name);
         }
     }
+
+    // The flows are spread over the next hops on the dst_entry resolution
+    if (best_next_hop_context.nexthops.size() > 1U) {
+        val.set_nexthops(best_next_hop_context.nexthops);
+    }
 }
 
 void route_table_mgr::print_tbl()
@@ -258,26 +277,43 @@ void route_table_mgr::print_tbl()
     }
 }
 
-static inline route_val *find_route_val(route_table_t &table, const ip_address &dst,
-                                        uint32_t table_id)
+static inline const uint8_t *lpm_key(const ip_address &addr, sa_family_t family)
 {
-    int longest_prefix = -1;
-    route_val *found {nullptr};
-
-    for (auto &val : table) {
-        bool is_valid_entry_with_longer_prefix = !val.is_deleted() &&
-            val.get_table_id() == table_id &&
-            val.get_dst_addr().is_equal_with_prefix(dst, val.get_dst_pref_len(),
-                                                    val.get_family()) &&
-            val.get_dst_pref_len() > longest_prefix;
-
-        if (is_valid_entry_with_longer_prefix) {
-            longest_prefix = val.get_dst_pref_len();
-            found = &val;
-        }
+    return family == AF_INET ? reinterpret_cast<const uint8_t *>(&addr.get_in4_addr())
+                             : reinterpret_cast<const uint8_t *>(&addr.get_in6_addr());
+}
+
+void route_table_mgr::lpm_insert(const route_val &val, size_t idx)
+{
+    get_lpm(val.get_family())[val.get_table_id()].insert(
+        lpm_key(val.get_dst_addr(), val.get_family()), val.get_dst_pref_len(),
+        static_cast<uint32_t>(idx));
+}
+
+void route_table_mgr::lpm_remove(const route_val &val, size_t idx)
+{
+    route_lpm_t &lpm = get_lpm(val.get_family());
+    auto iter = lpm.find(val.get_table_id());
+
+    if (iter != lpm.end()) {
+        iter->second.remove(lpm_key(val.get_dst_addr(), val.get_family()), val.get_dst_pref_len(),
+                            static_cast<uint32_t>(idx));
+    }
+}
+
+route_val *route_table_mgr::find_route_val(sa_family_t family, const ip_address &dst,
+                                           uint32_t table_id)
+{
+    route_lpm_t &lpm = get_lpm(family);
+    auto iter = lpm.find(table_id);
+    if (iter == lpm.end()) {
+        return nullptr;
     }
 
-    return found;
+    // Of the routes with the longest prefix the first one in the table wins
+    const std::vector<uint32_t> *found =
+        iter->second.lookup(lpm_key(dst, family), family == AF_INET ? 32U : 128U);
+    return found ? &get_table(family)[found->front()] : nullptr;
 }
 
 bool route_table_mgr::route_resolve(IN route_rule_table_key key, OUT route_result &res)
@@ -287,15 +323,22 @@ bool route_table_mgr::route_resolve(IN route_rule_table_key key, OUT route_resul
     const ip_address &dst_addr = key.get_dst_ip();
     const sa_family_t family = key.get_family();
 
-    route_table_t &rt = family == AF_INET ? m_table_in4 : m_table_in6;
     route_val *p_val = nullptr;
 
-    auto table_id_list = g_p_rule_table_mgr->rule_resolve(key);
+    uint32_t n_compared = 0U;
+    auto table_id_list = g_p_rule_table_mgr->rule_resolve(key, &n_compared);
 
     std::lock_guard<decltype(m_lock)> lock(m_lock);
 
+    if (n_compared) {
+        ++m_stats.n_rule_cache_miss;
+        m_stats.n_rule_compared += n_compared;
+    } else {
+        ++m_stats.n_rule_cache_hit;
+    }
+
     for (const auto &table_id : table_id_list) {
-        p_val = ::find_route_val(rt, dst_addr, table_id);
+        p_val = find_route_val(family, dst_addr, table_id);
         if (p_val) {
             res.mtu = p_val->get_mtu();
             res.if_index = p_val->get_if_index();
@@ -321,7 +364,6 @@ void route_table_mgr::update_entry(INOUT route_entry *p_ent, bool b_register_to_
     std::lock_guard<decltype(m_lock)> lock(m_lock);
     if (p_ent && !p_ent->is_valid()) { // if entry is found in the collection and is not valid
         rt_mgr_logdbg("entry [%p]", p_ent);
-        route_table_t &rt = p_ent->get_key().get_family() == AF_INET ? m_table_in4 : m_table_in6;
         rt_mgr_logdbg("route_entry is not valid-> update value");
         rule_entry *p_rr_entry = p_ent->get_rule_entry();
         std::deque<rule_val *> *p_rr_val;
@@ -331,7 +373,7 @@ void route_table_mgr::update_entry(INOUT route_entry *p_ent, bool b_register_to_
             for (const auto &p_rule_val : *p_rr_val) {
                 uint32_t table_id = p_rule_val->get_table_id();
 
-                if ((p_val = ::find_route_val(rt, peer_ip, table_id))) {
+                if ((p_val = find_route_val(p_ent->get_key().get_family(), peer_ip, table_id))) {
                     p_ent->set_val(p_val);
                     if (b_register_to_net_dev) {
                         // Check if broadcast IPv4 which is NOT supported
@@ -388,36 +430,54 @@ void route_table_mgr::new_route_event(const route_val &netlink_route_val)
     val.set_if_index(netlink_route_val.get_if_index());
     val.set_if_name(const_cast<char *>(netlink_route_val.get_if_name()));
     val.set_mtu((netlink_route_val.get_mtu()));
+    val.set_nexthops(netlink_route_val.get_nexthops());
     val.set_state(true);
     val.print_val();
 
-    std::lock_guard<decltype(m_lock)> lock(m_lock);
-    route_table_t &table = val.get_family() == AF_INET ? m_table_in4 : m_table_in6;
-    // Search for deleted duplicate routes
-    auto iter = table.begin();
-    for (; iter != table.end(); ++iter) {
-        if (*iter == val && iter->is_deleted()) {
-            *iter = val; // Overwrites m_b_deleted
-            break;
+    route_table_t &table = get_table(val.get_family());
+    route_index_t &index = get_index(val.get_family());
+    // A duplicate route, deleted or replaced, is updated in place
+    auto iter = index.find(val);
+    if (iter != index.end()) {
+        if (table[iter->second].is_deleted()) {
+            lpm_insert(val, iter->second);
         }
-    }
-    // Push new value if there is no deleted duplicate route
-    if (iter == table.end() && table.size() < MAX_ROUTE_TABLE_SIZE) {
+        table[iter->second] = val; // Overwrites m_b_deleted
+    } else if (table.size() < MAX_ROUTE_TABLE_SIZE) {
+        index.emplace(val, table.size());
+        lpm_insert(val, table.size());
         table.push_back(val);
     }
 }
 
 void route_table_mgr::del_route_event(const route_val &netlink_route_val)
 {
-    route_table_t &table = netlink_route_val.get_family() == AF_INET ? m_table_in4 : m_table_in6;
-    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    route_table_t &table = get_table(netlink_route_val.get_family());
+    route_index_t &index = get_index(netlink_route_val.get_family());
 
     // We cannot erase elements in the array, because this would invalide pointers
-    for (auto iter = table.begin(); iter != table.end(); ++iter) {
-        if (*iter == netlink_route_val) {
-            (*iter).set_deleted(true);
-            break;
-        }
+    auto iter = index.find(netlink_route_val);
+    if (iter != index.end() && !table[iter->second].is_deleted()) {
+        table[iter->second].set_deleted(true);
+        lpm_remove(table[iter->second], iter->second);
+    }
+}
+
+void route_table_mgr::handle_route_change(uint16_t nl_type, const route_val &netlink_route_val)
+{
+    switch (nl_type) {
+    case RTM_NEWROUTE:
+        new_route_event(netlink_route_val);
+        ++m_stats.n_updates_newroute;
+        break;
+    case RTM_DELROUTE:
+        del_route_event(netlink_route_val);
+        ++m_stats.n_updates_delroute;
+        break;
+    default:
+        ++m_stats.n_updates_unhandled;
+        rt_mgr_logdbg("Route event (%u) is not handled", nl_type);
+        break;
     }
 }
 
@@ -425,6 +485,17 @@ void route_table_mgr::notify_cb(event *ev)
 {
     rt_mgr_logdbg("received route event from netlink");
 
+    // The changes of a netlink read are applied under a single lock
+    route_nl_batch_event *route_batch_ev = dynamic_cast<route_nl_batch_event *>(ev);
+    if (route_batch_ev) {
+        std::lock_guard<decltype(m_lock)> lock(m_lock);
+        for (const auto &change : route_batch_ev->get_changes()) {
+            handle_route_change(change.nl_type, change.val);
+        }
+        ++m_stats.n_updates_batches;
+        return;
+    }
+
     route_nl_event *route_netlink_ev = dynamic_cast<route_nl_event *>(ev);
     if (!route_netlink_ev) {
         rt_mgr_logwarn("Received non route event!!!");
@@ -437,18 +508,6 @@ void route_table_mgr::notify_cb(event *ev)
         return;
     }
 
-    switch (route_netlink_ev->nl_type) {
-    case RTM_NEWROUTE:
-        new_route_event(p_netlink_route_info->get_route_val());
-        ++m_stats.n_updates_newroute;
-        break;
-    case RTM_DELROUTE:
-        del_route_event(p_netlink_route_info->get_route_val());
-        ++m_stats.n_updates_delroute;
-        break;
-    default:
-        ++m_stats.n_updates_unhandled;
-        rt_mgr_logdbg("Route event (%u) is not handled", route_netlink_ev->nl_type);
-        break;
-    }
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    handle_route_change(route_netlink_ev->nl_type, p_netlink_route_info->get_route_val());
 }
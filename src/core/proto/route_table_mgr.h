@@ -12,6 +12,7 @@
 #include "route_rule_table_key.h"
 #include "route_entry.h"
 #include "route_val.h"
+#include "core/util/lpm_trie.h"
 
 #include <unordered_map>
 #include <vector>
@@ -22,6 +23,22 @@ class event;
 typedef std::unordered_map<ip_address, route_entry *> in_addr_route_entry_map_t;
 typedef std::vector<route_val> route_table_t;
 
+// Hash of the fields which route_val::operator==() compares
+struct route_val_hash {
+    size_t operator()(const route_val &val) const
+    {
+        size_t hash = val.get_dst_addr().hash() * 31U + val.get_gw_addr().hash();
+        hash = hash * 31U + val.get_table_id();
+        hash = hash * 31U + static_cast<size_t>(val.get_if_index());
+        return hash * 31U + (val.get_dst_pref_len() << 8U | val.get_family());
+    }
+};
+
+// Position of an entry in route_table_t, the deleted entries remain indexed for the reuse
+typedef std::unordered_map<route_val, size_t, route_val_hash> route_index_t;
+// Positions of the active entries in route_table_t per table id, by the destination prefix
+typedef std::unordered_map<uint32_t, lpm_trie<uint32_t>> route_lpm_t;
+
 struct route_result {
     uint32_t mtu;
     int if_index;
@@ -33,6 +50,11 @@ typedef struct {
     uint32_t n_updates_newroute;
     uint32_t n_updates_delroute;
     uint32_t n_updates_unhandled;
+    uint32_t n_updates_batches;
+    uint32_t n_rule_cache_hit;
+    uint32_t n_rule_cache_miss;
+    // Rules compared on the rule cache misses
+    uint64_t n_rule_compared;
 } route_table_stats_t;
 
 class route_table_mgr : public netlink_socket_mgr,
@@ -48,6 +70,9 @@ public:
 
     void dump_tbl();
 
+    // Gateway and interface of the route, all the next hops of a multipath route
+    static void parse_nexthops(struct rtnl_route *route, route_val &val);
+
 protected:
     virtual void parse_entry(struct nl_object *nl_obj) override;
 
@@ -61,13 +86,26 @@ private:
 
     void update_entry(INOUT route_entry *p_ent, bool b_register_to_net_dev = false);
 
+    // These methods should be called with m_lock held!
+    void handle_route_change(uint16_t nl_type, const route_val &netlink_route_val);
     void new_route_event(const route_val &netlink_route_val);
     void del_route_event(const route_val &netlink_route_val);
+    route_val *find_route_val(sa_family_t family, const ip_address &dst, uint32_t table_id);
+    void lpm_insert(const route_val &val, size_t idx);
+    void lpm_remove(const route_val &val, size_t idx);
+
+    route_table_t &get_table(int family) { return family == AF_INET ? m_table_in4 : m_table_in6; }
+    route_index_t &get_index(int family) { return family == AF_INET ? m_index_in4 : m_index_in6; }
+    route_lpm_t &get_lpm(int family) { return family == AF_INET ? m_lpm_in4 : m_lpm_in6; }
 
     // IPv4 routing infromation
     route_table_t m_table_in4;
+    route_index_t m_index_in4;
+    route_lpm_t m_lpm_in4;
     // IPv6 routing information
     route_table_t m_table_in6;
+    route_index_t m_index_in6;
+    route_lpm_t m_lpm_in6;
     // Statistics
     route_table_stats_t m_stats;
 };
@@ -56,6 +56,13 @@ const std::string route_val::to_str() const
     if (m_mtu) {
         rc += " mtu " + std::to_string(m_mtu);
     }
+    for (const route_nexthop &nh : m_nexthops) {
+        rc += " nexthop";
+        if (!nh.gw.is_anyaddr()) {
+            rc += " via " + nh.gw.to_str(m_family);
+        }
+        rc += " index " + std::to_string(nh.if_index) + " weight " + std::to_string(nh.weight);
+    }
     if (m_b_deleted) {
         rc += " ---> DELETED";
     }
@@ -11,6 +11,80 @@
 #include "core/util/ip_address.h"
 
 #include <string>
+#include <vector>
+
+// A next hop of a multipath route
+struct route_nexthop {
+    ip_address gw;
+    int if_index;
+    uint32_t weight; // rtnh_hops + 1, not zero
+};
+
+static inline uint32_t route_multipath_mix(uint32_t hash, uint32_t word)
+{
+    word *= 0xCC9E2D51U;
+    word = (word << 15U) | (word >> 17U);
+    hash ^= word * 0x1B873593U;
+    hash = (hash << 13U) | (hash >> 19U);
+    return hash * 5U + 0xE6546B64U;
+}
+
+/**
+ * Flow hash over the fields which the kernel hashes for the fib_multipath_hash_policy of the
+ * family: the addresses (and the protocol for IPv6) with the policy 0, the 5-tuple with 1.
+ * The value differs from the kernel's keyed hash, only the flow to next hop stickiness and
+ * the spread are the same. Ports are in the network byte order.
+ */
+static inline uint32_t route_multipath_hash(sa_family_t family, const ip_address &src,
+                                            const ip_address &dst, uint16_t src_port,
+                                            uint16_t dst_port, uint8_t protocol, int policy)
+{
+    uint32_t hash = 0U;
+
+    if (family == AF_INET) {
+        hash = route_multipath_mix(hash, src.get_in4_addr().s_addr);
+        hash = route_multipath_mix(hash, dst.get_in4_addr().s_addr);
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            hash = route_multipath_mix(hash, src.get_in6_addr().s6_addr32[i]);
+            hash = route_multipath_mix(hash, dst.get_in6_addr().s6_addr32[i]);
+        }
+    }
+    if (policy == 1) {
+        hash = route_multipath_mix(hash, (uint32_t)src_port << 16U | dst_port);
+    }
+    if (policy == 1 || family == AF_INET6) {
+        hash = route_multipath_mix(hash, protocol);
+    }
+
+    hash ^= hash >> 16U;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13U;
+    hash *= 0xC2B2AE35U;
+    return hash ^ (hash >> 16U);
+}
+
+/**
+ * Index of the next hop for a flow hash, the hash-threshold of fib_select_multipath(): the
+ * weights split the 31 bit hash space into ranges in the next hop order.
+ */
+static inline size_t route_nexthop_select(const std::vector<route_nexthop> &nexthops,
+                                          uint32_t hash)
+{
+    uint64_t total = 0U;
+
+    for (const route_nexthop &nh : nexthops) {
+        total += nh.weight;
+    }
+    uint64_t point = ((uint64_t)(hash & 0x7FFFFFFFU) * total) >> 31U;
+    for (size_t i = 0; i < nexthops.size(); ++i) {
+        if (point < nexthops[i].weight) {
+            return i;
+        }
+        point -= nexthops[i].weight;
+    }
+    return 0U;
+}
 
 class route_val {
 public:
@@ -28,6 +102,10 @@ public:
     void set_mtu(uint32_t mtu);
     inline void set_if_index(int if_index) { m_if_index = if_index; };
     inline void set_if_name(char *if_name) { memcpy(m_if_name, if_name, IFNAMSIZ); };
+    inline void set_nexthops(const std::vector<route_nexthop> &nexthops)
+    {
+        m_nexthops = nexthops;
+    };
 
     inline uint8_t get_dst_pref_len() const { return m_dst_pref_len; };
     inline const ip_address &get_dst_addr() const { return m_dst_addr; };
@@ -41,6 +119,8 @@ public:
     inline int get_if_index() const { return m_if_index; };
     inline const char *get_if_name() const { return m_if_name; };
     inline uint32_t get_mtu() const { return m_mtu; };
+    // Empty unless the route is multipath, the gateway and the interface are of the heaviest
+    inline const std::vector<route_nexthop> &get_nexthops() const { return m_nexthops; };
 
     inline void set_state(bool state) { m_is_valid = state; };
     inline bool is_valid() const { return m_is_valid; };
@@ -72,6 +152,7 @@ private:
     char m_if_name[IFNAMSIZ];
     int m_if_index;
     uint32_t m_mtu;
+    std::vector<route_nexthop> m_nexthops;
 
     uint8_t m_dst_pref_len;
 
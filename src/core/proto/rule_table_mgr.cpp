@@ -42,6 +42,7 @@
 #define rr_mgr_logfuncall  __log_funcall
 
 #define DEFAULT_RULE_TABLE_SIZE 64
+#define RULE_RESOLVE_CACHE_SIZE 1024
 
 rule_table_mgr *g_p_rule_table_mgr = nullptr;
 static inline bool is_matching_rule(const route_rule_table_key &key, const rule_val &val);
@@ -71,6 +72,8 @@ void rule_table_mgr::update_tbl(nl_data_t data_type)
     std::lock_guard<decltype(m_lock)> lock(m_lock);
 
     netlink_socket_mgr::update_tbl(data_type);
+    m_cache_list.clear();
+    m_cache_map.clear();
 
     return;
 }
@@ -246,26 +249,52 @@ static inline bool is_matching_rule(const route_rule_table_key &key, const rule_
 // Find table ID for given destination info.
 // Parameters:
 //		key			: key object that contain information about destination.
+//		n_compared	: number of rules compared with the key, 0 for a cached result.
 // Returns a collection of rule table IDs sorted by priority
-std::vector<uint32_t> rule_table_mgr::rule_resolve(route_rule_table_key key)
+std::vector<uint32_t> rule_table_mgr::rule_resolve(route_rule_table_key key,
+                                                   uint32_t *n_compared /*= nullptr*/)
 {
     rr_mgr_logdbg("dst info: '%s'", key.to_str().c_str());
 
     std::vector<uint32_t> res;
     std::deque<rule_val *> values;
 
-    {
-        std::lock_guard<decltype(m_lock)> lock(m_lock);
-        if (!find_rule_val(key, &values)) {
-            return res;
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    auto iter = m_cache_map.find(key);
+    if (iter != m_cache_map.end()) {
+        m_cache_list.splice(m_cache_list.begin(), m_cache_list, iter->second);
+        if (n_compared) {
+            *n_compared = 0U;
         }
+        return iter->second->second;
+    }
+
+    if (n_compared) {
+        *n_compared = static_cast<uint32_t>(
+            (key.get_family() == AF_INET ? m_table_in4 : m_table_in6).size());
+    }
+    if (find_rule_val(key, &values)) {
+        std::sort(values.begin(), values.end(), [](const rule_val *rhs, const rule_val *lhs) {
+            return rhs->get_priority() < lhs->get_priority();
+        });
+        res.reserve(values.size());
+        std::transform(values.begin(), values.end(), std::back_inserter(res),
+                       [](rule_val *rule) { return rule->get_table_id(); });
     }
-    std::sort(values.begin(), values.end(), [](const rule_val *rhs, const rule_val *lhs) {
-        return rhs->get_priority() < lhs->get_priority();
-    });
-    res.reserve(values.size());
-    std::transform(values.begin(), values.end(), std::back_inserter(res),
-                   [](rule_val *rule) { return rule->get_table_id(); });
+    // The keys without a rule are cached too, they would scan the whole table again
+    cache_insert(key, res);
 
     return res;
 }
+
+void rule_table_mgr::cache_insert(const route_rule_table_key &key,
+                                  const std::vector<uint32_t> &res)
+{
+    if (m_cache_list.size() >= RULE_RESOLVE_CACHE_SIZE) {
+        m_cache_map.erase(m_cache_list.back().first);
+        m_cache_list.pop_back();
+    }
+    m_cache_list.emplace_front(key, res);
+    m_cache_map.emplace(key, m_cache_list.begin());
+}
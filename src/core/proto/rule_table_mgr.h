@@ -12,9 +12,15 @@
 #include "rule_entry.h"
 #include "rule_val.h"
 
+#include <list>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 typedef std::vector<rule_val> rule_table_t;
+// Resolved table ids by key, the front of the list is the most recently used
+typedef std::list<std::pair<route_rule_table_key, std::vector<uint32_t>>> rule_cache_list_t;
+typedef std::unordered_map<route_rule_table_key, rule_cache_list_t::iterator> rule_cache_map_t;
 
 /*
  * This class manages routing rule related operation such as getting rules from kernel,
@@ -25,7 +31,8 @@ class rule_table_mgr : public netlink_socket_mgr,
 public:
     rule_table_mgr();
 
-    std::vector<uint32_t> rule_resolve(route_rule_table_key key);
+    // n_compared is the number of rules compared with the key, 0 if the result was cached
+    std::vector<uint32_t> rule_resolve(route_rule_table_key key, uint32_t *n_compared = nullptr);
 
 protected:
     virtual void parse_entry(struct nl_object *nl_obj) override;
@@ -40,9 +47,13 @@ private:
     void update_entry(rule_entry *p_ent);
 
     bool find_rule_val(const route_rule_table_key &key, std::deque<rule_val *> *p_val);
+    void cache_insert(const route_rule_table_key &key, const std::vector<uint32_t> &res);
 
     rule_table_t m_table_in4;
     rule_table_t m_table_in6;
+    // LRU cache of rule_resolve(), cleared when the rules are read again
+    rule_cache_list_t m_cache_list;
+    rule_cache_map_t m_cache_map;
 };
 
 extern rule_table_mgr *g_p_rule_table_mgr;
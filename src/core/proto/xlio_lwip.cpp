@@ -4,7 +4,10 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <random>
+
 #include "utils/rdtsc.h"
+#include "core/util/coarse_clock.h"
 #include "vlogger/vlogger.h"
 
 #include "core/event/event_handler_manager.h"
@@ -30,12 +33,15 @@
 int32_t enable_wnd_scale = 0;
 u32_t rcv_wnd_scale = 0;
 
+// The time of the current poll pass, see coarse_clock.h
 u32_t xlio_lwip::sys_now(void)
 {
-    struct timespec now;
+    return static_cast<u32_t>(coarse_clock_ms());
+}
 
-    gettimefromtsc(&now);
-    return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+u32_t xlio_lwip::sys_now_us(void)
+{
+    return static_cast<u32_t>(coarse_clock_us());
 }
 
 u8_t xlio_lwip::read_tcp_timestamp_option(void)
@@ -78,6 +84,19 @@ xlio_lwip::xlio_lwip()
 
     enable_push_flag = !!safe_mce_sys().tcp_push_flag;
     enable_ts_option = read_tcp_timestamp_option();
+    enable_sack_option = !!safe_mce_sys().tcp_sack;
+    enable_ecn_option = !!safe_mce_sys().tcp_ecn;
+    enable_rack_option = !!safe_mce_sys().tcp_rack;
+    enable_ack_coalesce_option = !!safe_mce_sys().tcp_ack_coalesce;
+    enable_ack_adaptive_option = !!safe_mce_sys().tcp_ack_adaptive;
+    enable_mtu_probing_option = !!safe_mce_sys().tcp_mtu_probing;
+    if (safe_mce_sys().tcp_syncookies ||
+        (safe_mce_sys().tcp_fastopen & TCP_FASTOPEN_SERVER_ENABLE)) {
+        std::random_device rd;
+        for (u32_t &word : tcp_cookie_secret) {
+            word = rd();
+        }
+    }
     int is_window_scaling_enabled = safe_mce_sys().sysctl_reader.get_tcp_window_scaling();
     if (is_window_scaling_enabled) {
         int rmem_max_value = safe_mce_sys().sysctl_reader.get_tcp_rmem()->max_value;
@@ -104,7 +123,14 @@ xlio_lwip::xlio_lwip()
     register_tcp_rx_pbuf_free(sockinfo_tcp::tcp_rx_pbuf_free);
     register_tcp_state_observer(sockinfo_tcp::tcp_state_observer);
     register_ip_route_mtu(sockinfo_tcp::get_route_mtu);
+    register_tcp_path_mtu(sockinfo_tcp::get_path_mtu);
+    register_tcp_path_mtu_update(sockinfo_tcp::set_path_mtu);
+    register_tcp_pacing_budget(sockinfo_tcp::tcp_pacing_budget);
+    register_tcp_pacing_sent(sockinfo_tcp::tcp_pacing_sent);
+    register_tcp_pacing_rate(sockinfo_tcp::tcp_pacing_rate);
+    register_tcp_tmr_wake(sockinfo_tcp::tcp_tmr_wake);
     register_sys_now(sys_now);
+    register_sys_now_us(sys_now_us);
     set_tmr_resolution(safe_mce_sys().tcp_timer_resolution_msec);
     // tcp_ticks increases in the rate of tcp slow_timer
     void *node = g_p_event_handler_manager->register_timer_event(
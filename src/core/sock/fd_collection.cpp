@@ -33,6 +33,7 @@ fd_collection *g_p_fd_collection = nullptr;
 
 fd_collection::fd_collection()
     : lock_mutex_recursive("fd_collection")
+    , m_epfd_lst_lock("fd_collection:epfd_lst")
     , m_b_sysvar_offloaded_sockets(safe_mce_sys().offloaded_sockets)
 #if defined(DEFINED_NGINX)
     // Avoid using socket pool for the master process (which doesn't have parent fd_collection)
@@ -50,14 +51,10 @@ fd_collection::fd_collection()
     }
     fdcoll_logdbg("using open files max limit of %d file descriptors", m_n_fd_map_size);
 
-    m_p_sockfd_map = new sockinfo *[m_n_fd_map_size];
-    memset(m_p_sockfd_map, 0, m_n_fd_map_size * sizeof(sockinfo *));
-
-    m_p_epfd_map = new epfd_info *[m_n_fd_map_size];
-    memset(m_p_epfd_map, 0, m_n_fd_map_size * sizeof(epfd_info *));
-
-    m_p_cq_channel_map = new cq_channel_info *[m_n_fd_map_size];
-    memset(m_p_cq_channel_map, 0, m_n_fd_map_size * sizeof(cq_channel_info *));
+    m_p_sockfd_map = new std::atomic<sockinfo *>[m_n_fd_map_size]();
+    m_p_epfd_map = new std::atomic<epfd_info *>[m_n_fd_map_size]();
+    m_p_cq_channel_map = new std::atomic<cq_channel_info *>[m_n_fd_map_size]();
+    m_p_xlio_fd_bits = new std::atomic<uint64_t>[(m_n_fd_map_size + 63) / 64]();
 }
 
 fd_collection::~fd_collection()
@@ -76,6 +73,9 @@ fd_collection::~fd_collection()
     delete[] m_p_cq_channel_map;
     m_p_cq_channel_map = nullptr;
 
+    delete[] m_p_xlio_fd_bits;
+    m_p_xlio_fd_bits = nullptr;
+
     m_epfd_lst.clear_without_cleanup();
     m_pending_to_remove_lst.clear_without_cleanup();
 }
@@ -134,7 +134,7 @@ void fd_collection::clear()
                 }
             }
 
-            m_p_sockfd_map[fd] = nullptr;
+            m_p_sockfd_map[fd].store(nullptr, std::memory_order_relaxed);
             fdcoll_logdbg("destroyed fd=%d", fd);
         }
 
@@ -143,7 +143,7 @@ void fd_collection::clear()
             if (p_epfd) {
                 delete p_epfd;
             }
-            m_p_epfd_map[fd] = nullptr;
+            m_p_epfd_map[fd].store(nullptr, std::memory_order_relaxed);
             fdcoll_logdbg("destroyed epfd=%d", fd);
         }
 
@@ -152,7 +152,7 @@ void fd_collection::clear()
             if (p_cq_ch_info) {
                 delete p_cq_ch_info;
             }
-            m_p_cq_channel_map[fd] = nullptr;
+            m_p_cq_channel_map[fd].store(nullptr, std::memory_order_relaxed);
             fdcoll_logdbg("destroyed cq_channel_fd=%d", fd);
         }
     }
@@ -216,8 +216,6 @@ int fd_collection::addsocket(int fd, int domain, int type, bool check_offload /*
         fdcoll_logdbg("recovering from %s", e.what());
         return -1;
     }
-    lock();
-
     BULLSEYE_EXCLUDE_BLOCK_START
     if (!p_sfd_api_obj) {
         fdcoll_logpanic("[fd=%d] Failed creating new sockinfo (%m)", fd);
@@ -233,11 +231,11 @@ int fd_collection::addsocket(int fd, int domain, int type, bool check_offload /*
         }
     }
 
+    // The object is complete, publish it
     assert(!get_sockfd(fd));
     assert(!get_epfd(fd));
-    m_p_sockfd_map[fd] = p_sfd_api_obj;
-
-    unlock();
+    set_xlio_fd(fd);
+    m_p_sockfd_map[fd].store(p_sfd_api_obj, std::memory_order_release);
 
     return fd;
 }
@@ -246,6 +244,10 @@ bool fd_collection::create_offloaded_sockets()
 {
     bool ret = m_b_sysvar_offloaded_sockets;
 
+    if (m_offload_thread_rule_size.load(std::memory_order_acquire) == 0U) {
+        return ret;
+    }
+
     lock();
     if (m_offload_thread_rule.find(pthread_self()) == m_offload_thread_rule.end()) {
         unlock();
@@ -270,6 +272,7 @@ void fd_collection::offloading_rule_change_thread(bool offloaded, pthread_t tid)
     } else {
         m_offload_thread_rule[tid] = 1;
     }
+    m_offload_thread_rule_size.store(m_offload_thread_rule.size(), std::memory_order_release);
     unlock();
 }
 
@@ -312,6 +315,18 @@ void fd_collection::statistics_print(int fd, vlog_levels_t log_level)
     vlog_printf(log_level, "==================================================\n");
 }
 
+void fd_collection::set_default_rx_poll_num(int32_t rx_poll_num)
+{
+    lock();
+    for (int fd = 0; fd < m_n_fd_map_size; ++fd) {
+        sockinfo *p_sfd_api = get_sockfd(fd);
+        if (p_sfd_api) {
+            p_sfd_api->set_default_rx_poll_num(rx_poll_num);
+        }
+    }
+    unlock();
+}
+
 int fd_collection::addepfd(int epfd, int size)
 {
     fdcoll_logfunc("epfd=%d", epfd);
@@ -320,30 +335,26 @@ int fd_collection::addepfd(int epfd, int size)
         return -1;
     }
 
-    lock();
-
     // Sanity check to remove any old sockinfo object using the same fd!!
     epfd_info *p_fd_info = get_epfd(epfd);
     if (p_fd_info) {
         fdcoll_logwarn("[fd=%d] Deleting old duplicate sockinfo object (%p)", epfd, p_fd_info);
-        unlock();
         handle_close(epfd, true);
-        lock();
     }
 
-    unlock();
     p_fd_info = new epfd_info(epfd, size);
-    lock();
 
     BULLSEYE_EXCLUDE_BLOCK_START
     if (!p_fd_info) {
         fdcoll_logpanic("[fd=%d] Failed creating new sockinfo (%m)", epfd);
     }
     BULLSEYE_EXCLUDE_BLOCK_END
-    m_p_epfd_map[epfd] = p_fd_info;
-    m_epfd_lst.push_back(p_fd_info);
 
-    unlock();
+    m_epfd_lst_lock.lock();
+    set_xlio_fd(epfd);
+    m_p_epfd_map[epfd].store(p_fd_info, std::memory_order_release);
+    m_epfd_lst.push_back(p_fd_info);
+    m_epfd_lst_lock.unlock();
 
     return 0;
 }
@@ -384,7 +395,7 @@ int fd_collection::add_cq_channel_fd(int cq_ch_fd, ring *p_ring)
     BULLSEYE_EXCLUDE_BLOCK_START
     if (p_cq_ch_info) {
         fdcoll_logwarn("cq channel fd already exists in fd_collection");
-        m_p_cq_channel_map[cq_ch_fd] = nullptr;
+        m_p_cq_channel_map[cq_ch_fd].store(nullptr, std::memory_order_relaxed);
         delete p_cq_ch_info;
         // coverity[assigned_pointer] /* Turn off coverity check, intended assign*/
         p_cq_ch_info = nullptr;
@@ -400,7 +411,8 @@ int fd_collection::add_cq_channel_fd(int cq_ch_fd, ring *p_ring)
         fdcoll_logpanic("[fd=%d] Failed creating new cq_channel_info (%m)", cq_ch_fd);
     }
     BULLSEYE_EXCLUDE_BLOCK_END
-    m_p_cq_channel_map[cq_ch_fd] = p_cq_ch_info;
+    set_xlio_fd(cq_ch_fd);
+    m_p_cq_channel_map[cq_ch_fd].store(p_cq_ch_info, std::memory_order_release);
 
     unlock();
 
@@ -430,22 +442,22 @@ int fd_collection::del_sockfd(int fd, bool is_for_udp_pool /*=false*/)
             // However, a timer may tick on this socket before it is deleted.
             ret_val = del_socket(fd, m_p_sockfd_map);
         } else {
-            lock();
             // The socket is not ready for close.
             // Delete it from fd_col and add it to pending_to_remove list.
             // This socket will be handled and destroyed now by fd_col.
             // This will be done from fd_col timer handler.
             // Used for UDP socket pool as well
             // so closed UDP sockets will be deleted at the end of the world
-            if (m_p_sockfd_map[fd] == p_sfd_api) {
+            sockinfo *p_expected = p_sfd_api;
+            if (m_p_sockfd_map[fd].compare_exchange_strong(p_expected, nullptr,
+                                                           std::memory_order_acq_rel)) {
+                lock();
                 if (!is_for_udp_pool) {
                     ++g_global_stat_static.n_pending_sockets;
                 }
-                m_p_sockfd_map[fd] = nullptr;
                 m_pending_to_remove_lst.push_front(p_sfd_api);
+                unlock();
             }
-
-            unlock();
             ret_val = 0;
         }
     }
@@ -506,9 +518,9 @@ int fd_collection::del_epfd(int fd, bool b_cleanup /*=false*/)
 
 void fd_collection::remove_epfd_from_list(epfd_info *epfd)
 {
-    lock();
+    m_epfd_lst_lock.lock();
     m_epfd_lst.erase(epfd);
-    unlock();
+    m_epfd_lst_lock.unlock();
 }
 
 int fd_collection::del_cq_channel_fd(int fd, bool b_cleanup /*=false*/)
@@ -516,7 +528,8 @@ int fd_collection::del_cq_channel_fd(int fd, bool b_cleanup /*=false*/)
     return del(fd, b_cleanup, m_p_cq_channel_map);
 }
 
-template <typename cls> int fd_collection::del(int fd, bool b_cleanup, cls **map_type)
+template <typename cls>
+int fd_collection::del(int fd, bool b_cleanup, std::atomic<cls *> *map_type)
 {
     fdcoll_logfunc("fd=%d%s", fd,
                    b_cleanup ? ", cleanup case: trying to remove old socket handler" : "");
@@ -525,22 +538,19 @@ template <typename cls> int fd_collection::del(int fd, bool b_cleanup, cls **map
         return -1;
     }
 
-    lock();
-    cls *p_obj = map_type[fd];
+    // Only one of the concurrent closers gets the object
+    cls *p_obj = map_type[fd].exchange(nullptr, std::memory_order_acq_rel);
     if (p_obj) {
-        map_type[fd] = NULL;
-        unlock();
         p_obj->clean_obj();
         return 0;
     }
     if (!b_cleanup) {
         fdcoll_logdbg("[fd=%d] Could not find related object", fd);
     }
-    unlock();
     return -1;
 }
 
-int fd_collection::del_socket(int fd, sockinfo **map_type)
+int fd_collection::del_socket(int fd, std::atomic<sockinfo *> *map_type)
 {
     fdcoll_logfunc("fd=%d", fd);
 
@@ -548,27 +558,23 @@ int fd_collection::del_socket(int fd, sockinfo **map_type)
         return -1;
     }
 
-    lock();
-    sockinfo *p_obj = map_type[fd];
+    sockinfo *p_obj = map_type[fd].exchange(nullptr, std::memory_order_acq_rel);
     if (p_obj) {
-        map_type[fd] = nullptr;
-        unlock();
         p_obj->clean_socket_obj();
         return 0;
     }
 
     fdcoll_logdbg("[fd=%d] Could not find related object", fd);
-    unlock();
     return -1;
 }
 
 void fd_collection::remove_from_all_epfds(int fd, bool passthrough)
 {
-    lock();
+    m_epfd_lst_lock.lock();
     for (epfd_info *ep = m_epfd_lst.front(); ep; ep = m_epfd_lst.next(ep)) {
         ep->fd_closed(fd, passthrough);
     }
-    unlock();
+    m_epfd_lst_lock.unlock();
 
     return;
 }
@@ -599,8 +605,9 @@ bool fd_collection::pop_socket_pool(int &fd, bool &add_to_udp_pool, int type)
         // use fd from pool - will skip creation of new fd by os
         sockinfo *sockfd = m_socket_pool.top();
         fd = sockfd->get_fd();
-        if (!m_p_sockfd_map[fd]) {
-            m_p_sockfd_map[fd] = sockfd;
+        if (!m_p_sockfd_map[fd].load(std::memory_order_relaxed)) {
+            set_xlio_fd(fd);
+            m_p_sockfd_map[fd].store(sockfd, std::memory_order_release);
             m_pending_to_remove_lst.erase(sockfd);
         }
         sockfd->prepare_to_close_socket_pool(false);
@@ -7,6 +7,7 @@
 #ifndef FD_COLLECTION_H
 #define FD_COLLECTION_H
 
+#include <atomic>
 #include <stack>
 #include <unordered_map>
 
@@ -109,8 +110,23 @@ public:
      */
     int del_cq_channel_fd(int fd, bool b_cleanup = false);
 
-    void set_socket(int fd, sockinfo *si) { m_p_sockfd_map[fd] = si; }
-    void clear_socket(int fd) { m_p_sockfd_map[fd] = nullptr; }
+    void set_socket(int fd, sockinfo *si)
+    {
+        set_xlio_fd(fd);
+        m_p_sockfd_map[fd].store(si, std::memory_order_release);
+    }
+    void clear_socket(int fd) { m_p_sockfd_map[fd].store(nullptr, std::memory_order_release); }
+
+    /**
+     * Mark fd as known to XLIO: it has an object in the collection or it is a member of an epoll
+     * set. Calls on the fds which aren't marked go directly to the OS.
+     * The mark is set before the object is published and cleared when the fd is closed.
+     */
+    inline void set_xlio_fd(int fd);
+    inline void clear_xlio_fd(int fd);
+    inline bool is_xlio_fd(int fd);
+    // The bits of the 64 fds starting at fd, a multiple of 64
+    inline uint64_t get_xlio_fd_bits(int fd);
 
     /**
      * Call set_immediate_os_sample of the input fd.
@@ -157,15 +173,20 @@ public:
      */
     void statistics_print(int fd, vlog_levels_t log_level);
 
+    /**
+     * Apply XLIO_RX_POLL changed at runtime to the open sockets.
+     */
+    void set_default_rx_poll_num(int32_t rx_poll_num);
+
 #if defined(DEFINED_NGINX)
     bool pop_socket_pool(int &fd, bool &add_to_udp_pool, int type);
     void push_socket_pool(sockinfo *sockfd);
     void handle_socket_pool(int fd);
 #endif
 private:
-    template <typename cls> int del(int fd, bool b_cleanup, cls **map_type);
-    template <typename cls> inline cls *get(int fd, cls **map_type);
-    int del_socket(int fd, sockinfo **map_type);
+    template <typename cls> int del(int fd, bool b_cleanup, std::atomic<cls *> *map_type);
+    template <typename cls> inline cls *get(int fd, std::atomic<cls *> *map_type);
+    int del_socket(int fd, std::atomic<sockinfo *> *map_type);
     inline bool is_valid_fd(int fd);
 
     inline bool create_offloaded_sockets();
@@ -180,11 +201,20 @@ private:
     void statistics_print_helper(int fd, vlog_levels_t log_level);
 
 private:
+    /*
+     * The kernel hands an fd to one owner at a time, so the map slots are published and cleared
+     * with atomic operations and the creation and close of different fds don't serialize on the
+     * collection lock. The lock protects the lists, the thread rules and the socket pool.
+     */
     int m_n_fd_map_size;
-    sockinfo **m_p_sockfd_map;
-    epfd_info **m_p_epfd_map;
-    cq_channel_info **m_p_cq_channel_map;
-
+    std::atomic<sockinfo *> *m_p_sockfd_map;
+    std::atomic<epfd_info *> *m_p_epfd_map;
+    std::atomic<cq_channel_info *> *m_p_cq_channel_map;
+    // One bit per fd, see set_xlio_fd()
+    std::atomic<uint64_t> *m_p_xlio_fd_bits;
+
+    // Every close walks the epoll sets, they have their own lock
+    lock_mutex_recursive m_epfd_lst_lock;
     epfd_info_list_t m_epfd_lst;
     // Contains fds which are in closing process
     sockinfo_list_t m_pending_to_remove_lst;
@@ -194,6 +224,8 @@ private:
     // if (m_b_sysvar_offloaded_sockets is true) contain all threads that need not be offloaded.
     // else contain all threads that need to be offloaded.
     offload_thread_rule_t m_offload_thread_rule;
+    // Size of m_offload_thread_rule, socket creation doesn't take the lock while it's empty
+    std::atomic<size_t> m_offload_thread_rule_size {0U};
 
 #if defined(DEFINED_NGINX)
     bool m_use_socket_pool;
@@ -211,21 +243,47 @@ inline bool fd_collection::is_valid_fd(int fd)
     return true;
 }
 
-template <typename cls> inline cls *fd_collection::get(int fd, cls **map_type)
+template <typename cls> inline cls *fd_collection::get(int fd, std::atomic<cls *> *map_type)
 {
     if (!is_valid_fd(fd)) {
         return NULL;
     }
 
-    cls *obj = map_type[fd];
+    cls *obj = map_type[fd].load(std::memory_order_acquire);
     return obj;
 }
 
+inline void fd_collection::set_xlio_fd(int fd)
+{
+    if (is_valid_fd(fd)) {
+        m_p_xlio_fd_bits[fd / 64U].fetch_or(1ULL << (fd % 64U), std::memory_order_release);
+    }
+}
+
+inline void fd_collection::clear_xlio_fd(int fd)
+{
+    if (is_valid_fd(fd)) {
+        m_p_xlio_fd_bits[fd / 64U].fetch_and(~(1ULL << (fd % 64U)), std::memory_order_release);
+    }
+}
+
+inline bool fd_collection::is_xlio_fd(int fd)
+{
+    return is_valid_fd(fd) &&
+        (m_p_xlio_fd_bits[fd / 64U].load(std::memory_order_acquire) & (1ULL << (fd % 64U)));
+}
+
+inline uint64_t fd_collection::get_xlio_fd_bits(int fd)
+{
+    return is_valid_fd(fd) ? m_p_xlio_fd_bits[fd / 64U].load(std::memory_order_acquire) : 0U;
+}
+
 inline void fd_collection::reuse_sockfd(int fd, sockinfo *p_sfd_api_obj)
 {
     lock();
     m_pending_to_remove_lst.erase(p_sfd_api_obj);
-    m_p_sockfd_map[fd] = p_sfd_api_obj;
+    set_xlio_fd(fd);
+    m_p_sockfd_map[fd].store(p_sfd_api_obj, std::memory_order_release);
     --g_global_stat_static.n_pending_sockets;
     unlock();
 }
@@ -269,6 +327,17 @@ inline sockinfo *fd_collection_get_sockfd(int fd)
     return nullptr;
 }
 
+// False for the fds XLIO doesn't handle, their calls can skip the lookups
+inline bool fd_collection_is_xlio_fd(int fd)
+{
+    return g_p_fd_collection && g_p_fd_collection->is_xlio_fd(fd);
+}
+
+inline uint64_t fd_collection_get_xlio_fd_bits(int fd)
+{
+    return g_p_fd_collection ? g_p_fd_collection->get_xlio_fd_bits(fd) : 0U;
+}
+
 inline epfd_info *fd_collection_get_epfd(int fd)
 {
     if (g_p_fd_collection) {
@@ -12,8 +12,11 @@
 #include <util/libxlio.h>
 #include <vlogger/vlogger.h>
 #include <dev/buffer_pool.h>
+#include <dev/ib_ctx_handler_collection.h>
 #include <event/event_handler_manager_local.h>
 #include <event/poll_group.h>
+#include <event/worker_thread_manager.h>
+#include <proto/mem_desc.h>
 #include <sock/sockinfo.h>
 #include <sock/sockinfo_tcp.h>
 #include <sock/sockinfo_udp.h>
@@ -38,6 +41,8 @@ extern "C" int xlio_add_conf_rule(const char *config_line)
 {
     int ret = __xlio_parse_config_line(config_line);
 
+    __xlio_compile_rules();
+
     if (*g_p_vlogger_level >= VLOG_DEBUG) {
         __xlio_print_conf_file(__instance_list);
     }
@@ -65,6 +70,95 @@ extern "C" int xlio_dump_fd_stats(int fd, int log_level)
     return -1;
 }
 
+extern "C" int xlio_recv_zcopy(int fd, struct xlio_zcopy_buf *bufs, unsigned count, int flags)
+{
+    sockinfo *si = fd_collection_get_sockfd(fd);
+
+    if (unlikely(!bufs || !count)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (unlikely(!si || si->is_xlio_socket())) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    return si->rx_zcopy(bufs, count, flags);
+}
+
+extern "C" int xlio_free_zcopy_bufs(int fd, const struct xlio_zcopy_buf *bufs, unsigned count)
+{
+    sockinfo *si = fd_collection_get_sockfd(fd);
+
+    if (unlikely(!si || (!bufs && count))) {
+        errno = EINVAL;
+        return -1;
+    }
+    si->rx_zcopy_free(bufs, count);
+    return 0;
+}
+
+extern "C" int xlio_worker_thread_set_affinity(unsigned index, size_t cpusetsize,
+                                               const void *cpuset)
+{
+    if (unlikely(!worker_thread_manager::instance())) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    if (unlikely(!cpuset || cpusetsize != sizeof(cpu_set_t))) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int rc = worker_thread_manager::instance()->set_affinity(
+        index, *reinterpret_cast<const cpu_set_t *>(cpuset));
+    if (rc) {
+        errno = rc;
+        return -1;
+    }
+    return 0;
+}
+
+static sockinfo_tcp *get_threads_mode_tcp_socket(int fd)
+{
+    sockinfo *si = fd_collection_get_sockfd(fd);
+
+    if (unlikely(!si || si->get_protocol() != PROTO_TCP || !si->get_entity_context())) {
+        return nullptr;
+    }
+    return static_cast<sockinfo_tcp *>(si);
+}
+
+extern "C" ssize_t xlio_send_zcopy(int fd, const struct iovec *iov, unsigned iovcnt, uint32_t mkey,
+                                   uintptr_t userdata)
+{
+    sockinfo_tcp *si = get_threads_mode_tcp_socket(fd);
+
+    if (unlikely(!si)) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    if (unlikely(!iov || !iovcnt || iovcnt > IOV_MAX)) {
+        errno = EINVAL;
+        return -1;
+    }
+    return si->tcp_tx_zcopy_thread(iov, iovcnt, mkey, userdata);
+}
+
+extern "C" int xlio_poll_zcopy_completions(int fd, uintptr_t *userdata, unsigned count)
+{
+    sockinfo_tcp *si = get_threads_mode_tcp_socket(fd);
+
+    if (unlikely(!si)) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    if (unlikely(!userdata && count)) {
+        errno = EINVAL;
+        return -1;
+    }
+    return static_cast<int>(si->tx_zcopy_poll_completions(userdata, count));
+}
+
 struct xlio_api_t *extra_api()
 {
     // xlio_api is zerod-out by linker
@@ -77,6 +171,13 @@ struct xlio_api_t *extra_api()
         SET_EXTRA_API(add_conf_rule, xlio_add_conf_rule, XLIO_EXTRA_API_ADD_CONF_RULE);
         SET_EXTRA_API(thread_offload, xlio_thread_offload, XLIO_EXTRA_API_THREAD_OFFLOAD);
         SET_EXTRA_API(dump_fd_stats, xlio_dump_fd_stats, XLIO_EXTRA_API_DUMP_FD_STATS);
+        SET_EXTRA_API(recv_zcopy, xlio_recv_zcopy, XLIO_EXTRA_API_RECV_ZCOPY);
+        SET_EXTRA_API(free_zcopy_bufs, xlio_free_zcopy_bufs, XLIO_EXTRA_API_RECV_ZCOPY);
+        SET_EXTRA_API(worker_thread_set_affinity, xlio_worker_thread_set_affinity,
+                      XLIO_EXTRA_API_WORKER_THREADS);
+        SET_EXTRA_API(send_zcopy, xlio_send_zcopy, XLIO_EXTRA_API_SEND_ZCOPY);
+        SET_EXTRA_API(poll_zcopy_completions, xlio_poll_zcopy_completions,
+                      XLIO_EXTRA_API_SEND_ZCOPY);
 
         // XLIO Socket API.
         SET_EXTRA_API(xlio_init_ex, xlio_init_ex, XLIO_EXTRA_API_XLIO_ULTRA);
@@ -105,6 +206,20 @@ struct xlio_api_t *extra_api()
         SET_EXTRA_API(xlio_socket_buf_free, xlio_socket_buf_free, XLIO_EXTRA_API_XLIO_ULTRA);
         SET_EXTRA_API(xlio_poll_group_buf_free, xlio_poll_group_buf_free,
                       XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_socket_sendto, xlio_socket_sendto, XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_socket_buf_dgram_info, xlio_socket_buf_dgram_info,
+                      XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_socket_buf_rx_info, xlio_socket_buf_rx_info,
+                      XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_poll_group_connect_pool, xlio_poll_group_connect_pool,
+                      XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_poll_group_get_connection, xlio_poll_group_get_connection,
+                      XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_poll_group_wait, xlio_poll_group_wait, XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_socket_migrate, xlio_socket_migrate, XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_mem_register, xlio_mem_register, XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_mem_deregister, xlio_mem_deregister, XLIO_EXTRA_API_XLIO_ULTRA);
+        SET_EXTRA_API(xlio_socket_send_buf, xlio_socket_send_buf, XLIO_EXTRA_API_XLIO_ULTRA);
     }
 
     return &xlio_api;
@@ -120,7 +235,7 @@ extern "C" int xlio_init_ex(const struct xlio_init_attr *attr)
         vlog_printf(VLOG_DEBUG, "XLIO is already initialized!!\n");
         // If XLIO global memory is already allocated, we can't
         // reinitialize XLIO with new memory allocator
-        if (attr->memory_alloc) {
+        if (attr->memory_alloc || attr->rx_memory_alloc) {
             errno = EEXIST;
             return -1;
         } else {
@@ -133,6 +248,8 @@ extern "C" int xlio_init_ex(const struct xlio_init_attr *attr)
 
     extern xlio_memory_cb_t g_user_memory_cb;
     g_user_memory_cb = attr->memory_cb;
+    extern xlio_memory_pressure_cb_t g_user_memory_pressure_cb;
+    g_user_memory_pressure_cb = attr->memory_pressure_cb;
 
     if (attr->memory_alloc) {
         safe_mce_sys().user_alloc.memalloc = attr->memory_alloc;
@@ -140,22 +257,54 @@ extern "C" int xlio_init_ex(const struct xlio_init_attr *attr)
         safe_mce_sys().memory_limit_user =
             std::max(safe_mce_sys().memory_limit_user, safe_mce_sys().memory_limit);
     }
+    if (attr->rx_memory_alloc) {
+        safe_mce_sys().user_alloc.rx_memalloc = attr->rx_memory_alloc;
+        safe_mce_sys().user_alloc.rx_memfree = attr->rx_memory_free;
+        safe_mce_sys().memory_limit_user =
+            std::max(safe_mce_sys().memory_limit_user, safe_mce_sys().memory_limit);
+    }
 
     DO_GLOBAL_CTORS();
 
     return 0;
 }
 
+/*
+ * Copy the attributes declared by the caller. Applications built against an older header
+ * pass a shorter structure, so the members after socket_accept_cb are read only with
+ * XLIO_GROUP_FLAG_ATTR_SIZE and up to attr_size. The rest is zeroed.
+ */
+static bool poll_group_attr_copy(const struct xlio_poll_group_attr *attr,
+                                 struct xlio_poll_group_attr &out)
+{
+    size_t size = offsetof(struct xlio_poll_group_attr, attr_size);
+
+    if (attr->flags & XLIO_GROUP_FLAG_ATTR_SIZE) {
+        if (attr->attr_size < size + sizeof(attr->attr_size)) {
+            return false;
+        }
+        size = std::min<size_t>(attr->attr_size, sizeof(out));
+    }
+    memset(&out, 0, sizeof(out));
+    memcpy(&out, attr, size);
+    out.flags &= ~XLIO_GROUP_FLAG_ATTR_SIZE;
+    out.attr_size = sizeof(out);
+    return true;
+}
+
 extern "C" int xlio_poll_group_create(const struct xlio_poll_group_attr *attr,
                                       xlio_poll_group_t *group_out)
 {
+    struct xlio_poll_group_attr group_attr;
+
     // Validate input arguments
-    if (!group_out || !attr || !attr->socket_event_cb) {
+    if (!group_out || !attr || !poll_group_attr_copy(attr, group_attr) ||
+        !group_attr.socket_event_cb || group_attr.rx_queues > XLIO_GROUP_RX_QUEUES_MAX) {
         errno = EINVAL;
         return -1;
     }
 
-    poll_group *grp = new poll_group(*attr);
+    poll_group *grp = new poll_group(group_attr);
     if (!grp) {
         errno = ENOMEM;
         return -1;
@@ -177,12 +326,13 @@ extern "C" int xlio_poll_group_update(xlio_poll_group_t group,
                                       const struct xlio_poll_group_attr *attr)
 {
     poll_group *grp = reinterpret_cast<poll_group *>(group);
+    struct xlio_poll_group_attr group_attr;
 
-    if (!attr || !attr->socket_event_cb) {
+    if (!attr || !poll_group_attr_copy(attr, group_attr) || !group_attr.socket_event_cb) {
         errno = EINVAL;
         return -1;
     }
-    return grp->update(attr);
+    return grp->update(&group_attr);
 }
 
 extern "C" void xlio_poll_group_poll(xlio_poll_group_t group)
@@ -192,6 +342,13 @@ extern "C" void xlio_poll_group_poll(xlio_poll_group_t group)
     grp->poll();
 }
 
+extern "C" int xlio_poll_group_wait(xlio_poll_group_t group, int timeout_ms)
+{
+    poll_group *grp = reinterpret_cast<poll_group *>(group);
+
+    return grp->wait(timeout_ms);
+}
+
 extern "C" int xlio_socket_create(const struct xlio_socket_attr *attr, xlio_socket_t *sock_out)
 {
     // Validate input arguments
@@ -201,17 +358,30 @@ extern "C" int xlio_socket_create(const struct xlio_socket_attr *attr, xlio_sock
         return -1;
     }
 
-    int fd = SYSCALL(socket, attr->domain, SOCK_STREAM, 0);
+    bool is_dgram = !!(attr->flags & XLIO_SOCKET_FLAG_DGRAM);
+    int fd = SYSCALL(socket, attr->domain, is_dgram ? SOCK_DGRAM : SOCK_STREAM, 0);
     if (fd < 0) {
         return -1;
     }
 
-    sockinfo_tcp *si = new sockinfo_tcp(fd, attr->domain);
-    if (!si) {
-        errno = ENOMEM;
-        return -1;
+    sockinfo *si;
+    if (is_dgram) {
+        sockinfo_udp *si_udp = new sockinfo_udp(fd, attr->domain);
+        if (!si_udp) {
+            errno = ENOMEM;
+            return -1;
+        }
+        si_udp->set_xlio_socket(attr);
+        si = si_udp;
+    } else {
+        sockinfo_tcp *si_tcp = new sockinfo_tcp(fd, attr->domain);
+        if (!si_tcp) {
+            errno = ENOMEM;
+            return -1;
+        }
+        si_tcp->set_xlio_socket(attr);
+        si = si_tcp;
     }
-    si->set_xlio_socket(attr);
 
     poll_group *grp = reinterpret_cast<poll_group *>(attr->group);
     grp->add_socket(si);
@@ -222,7 +392,7 @@ extern "C" int xlio_socket_create(const struct xlio_socket_attr *attr, xlio_sock
 
 extern "C" int xlio_socket_destroy(xlio_socket_t sock)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     poll_group *grp = si->get_poll_group();
 
     if (unlikely(!si->is_xlio_socket())) {
@@ -233,7 +403,10 @@ extern "C" int xlio_socket_destroy(xlio_socket_t sock)
     if (likely(grp)) {
         grp->mark_socket_to_close(si);
     } else {
-        // Detached socket flow.
+        // Detached socket flow, the socket can still be in a migration inbox.
+        if (si->get_protocol() == PROTO_TCP) {
+            static_cast<sockinfo_tcp *>(si)->cancel_migrate();
+        }
         g_p_fd_collection->clear_socket(si->get_fd());
         si->prepare_to_close(true);
         si->clean_socket_obj();
@@ -243,14 +416,14 @@ extern "C" int xlio_socket_destroy(xlio_socket_t sock)
 
 extern "C" int xlio_socket_update(xlio_socket_t sock, unsigned flags, uintptr_t userdata_sq)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     return si->update_xlio_socket(flags, userdata_sq);
 }
 
 extern "C" int xlio_socket_setsockopt(xlio_socket_t sock, int level, int optname,
                                       const void *optval, socklen_t optlen)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     int errno_save = errno;
 
     int rc = si->setsockopt(level, optname, optval, optlen);
@@ -263,20 +436,20 @@ extern "C" int xlio_socket_setsockopt(xlio_socket_t sock, int level, int optname
 extern "C" int xlio_socket_getsockname(xlio_socket_t sock, struct sockaddr *addr,
                                        socklen_t *addrlen)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     return si->getsockname(addr, addrlen);
 }
 
 extern "C" int xlio_socket_getpeername(xlio_socket_t sock, struct sockaddr *addr,
                                        socklen_t *addrlen)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     return si->getpeername(addr, addrlen);
 }
 
 extern "C" int xlio_socket_bind(xlio_socket_t sock, const struct sockaddr *addr, socklen_t addrlen)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     int errno_save = errno;
 
     int rc = si->bind(addr, addrlen);
@@ -292,7 +465,7 @@ extern "C" int xlio_socket_bind(xlio_socket_t sock, const struct sockaddr *addr,
 
 extern "C" int xlio_socket_connect(xlio_socket_t sock, const struct sockaddr *to, socklen_t tolen)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     int errno_save = errno;
     int rc = 0;
 
@@ -315,7 +488,11 @@ extern "C" int xlio_socket_listen(xlio_socket_t sock)
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
     poll_group *group = si->get_poll_group();
 
-    if (!group->m_socket_accept_cb) {
+    if (unlikely(si->get_protocol() != PROTO_TCP)) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    if (!group->m_socket_accept_cb && !group->m_socket_accept_batch_cb) {
         errno = ENOTCONN;
         return -1;
     }
@@ -325,12 +502,16 @@ extern "C" int xlio_socket_listen(xlio_socket_t sock)
         errno = ENODEV;
         rc = -1;
     }
-    return rc ?: si->listen(-1);
+    rc = rc ?: si->listen(-1);
+    if (rc == 0) {
+        group->reserve_accept_sockets(si->get_family());
+    }
+    return rc;
 }
 
 extern "C" struct ibv_pd *xlio_socket_get_pd(xlio_socket_t sock)
 {
-    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
     ib_ctx_handler *ctx = si->get_ctx();
 
     return ctx ? ctx->get_ibv_pd() : nullptr;
@@ -340,6 +521,11 @@ int xlio_socket_detach_group(xlio_socket_t sock)
 {
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
 
+    if (unlikely(si->get_protocol() != PROTO_TCP)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
     return si->detach_xlio_group();
 }
 
@@ -348,9 +534,76 @@ int xlio_socket_attach_group(xlio_socket_t sock, xlio_poll_group_t group)
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
     poll_group *grp = reinterpret_cast<poll_group *>(group);
 
+    if (unlikely(si->get_protocol() != PROTO_TCP)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    // Attaching explicitly takes over a pending migration.
+    si->cancel_migrate();
     return si->attach_xlio_group(grp);
 }
 
+int xlio_socket_migrate(xlio_socket_t sock, xlio_poll_group_t group)
+{
+    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+    poll_group *grp = reinterpret_cast<poll_group *>(group);
+
+    if (unlikely(si->get_protocol() != PROTO_TCP)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    return si->migrate_xlio_group(grp);
+}
+
+static ib_ctx_handler *xlio_mem_find_ctx(struct ibv_pd *pd)
+{
+    if (!g_p_ib_ctx_handler_collection || !g_p_ib_ctx_handler_collection->get_ib_cxt_list()) {
+        errno = ENODEV;
+        return nullptr;
+    }
+    // NULL pd is unambiguous only with a single offloaded device.
+    ib_ctx_handler *ctx = g_p_ib_ctx_handler_collection->get_ib_ctx_by_pd(pd);
+    if (!ctx) {
+        errno = EINVAL;
+    }
+    return ctx;
+}
+
+extern "C" int xlio_mem_register(struct ibv_pd *pd, void *addr, size_t len, uint32_t *mkey_out)
+{
+    if (unlikely(!addr || len == 0 || !mkey_out)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ib_ctx_handler *ctx = xlio_mem_find_ctx(pd);
+    if (unlikely(!ctx)) {
+        return -1;
+    }
+
+    errno = 0;
+    uint32_t lkey = ctx->user_mkey_reg(addr, len);
+    if (unlikely(lkey == LKEY_ERROR)) {
+        errno = errno ?: ENOMEM;
+        return -1;
+    }
+    *mkey_out = lkey;
+    return 0;
+}
+
+extern "C" int xlio_mem_deregister(struct ibv_pd *pd, uint32_t mkey)
+{
+    ib_ctx_handler *ctx = xlio_mem_find_ctx(pd);
+    if (unlikely(!ctx)) {
+        return -1;
+    }
+    if (unlikely(!ctx->user_mkey_dereg(mkey))) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
 static void xlio_buf_free(struct xlio_buf *buf)
 {
     mem_buf_desc_t *desc = mem_buf_desc_t::from_xlio_buf(buf);
@@ -375,6 +628,72 @@ extern "C" void xlio_poll_group_buf_free(xlio_poll_group_t group, struct xlio_bu
     xlio_buf_free(buf);
 }
 
+extern "C" int xlio_socket_buf_dgram_info(xlio_socket_t sock, struct xlio_buf *buf,
+                                          struct sockaddr *addr, socklen_t *addrlen,
+                                          struct timespec *hw_timestamp)
+{
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
+
+    if (unlikely(si->get_protocol() != PROTO_UDP || !buf)) {
+        errno = EINVAL;
+        return -1;
+    }
+    static_cast<sockinfo_udp *>(si)->get_xlio_buf_info(mem_buf_desc_t::from_xlio_buf(buf), addr,
+                                                       addrlen, hw_timestamp);
+    return 0;
+}
+
+extern "C" int xlio_socket_buf_rx_info(xlio_socket_t sock, struct xlio_buf *buf,
+                                       struct xlio_buf_rx_info *info)
+{
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
+
+    if (unlikely(!buf || !info)) {
+        errno = EINVAL;
+        return -1;
+    }
+    si->get_xlio_buf_rx_info(mem_buf_desc_t::from_xlio_buf(buf), info);
+    return 0;
+}
+
+static bool is_conn_pool_addr(const struct sockaddr *to, socklen_t tolen)
+{
+    return to &&
+        ((to->sa_family == AF_INET && tolen >= sizeof(struct sockaddr_in)) ||
+         (to->sa_family == AF_INET6 && tolen >= sizeof(struct sockaddr_in6)));
+}
+
+extern "C" int xlio_poll_group_connect_pool(xlio_poll_group_t group, const struct sockaddr *to,
+                                            socklen_t tolen, unsigned size)
+{
+    poll_group *grp = reinterpret_cast<poll_group *>(group);
+
+    if (unlikely(!grp || !is_conn_pool_addr(to, tolen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    grp->set_conn_pool(sock_addr(to, tolen), size);
+    return 0;
+}
+
+extern "C" int xlio_poll_group_get_connection(xlio_poll_group_t group, const struct sockaddr *to,
+                                              socklen_t tolen, uintptr_t userdata_sq,
+                                              xlio_socket_t *sock_out)
+{
+    poll_group *grp = reinterpret_cast<poll_group *>(group);
+
+    if (unlikely(!grp || !sock_out || !is_conn_pool_addr(to, tolen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    sockinfo_tcp *si = grp->get_pooled_connection(sock_addr(to, tolen), userdata_sq);
+    if (!si) {
+        return -1;
+    }
+    *sock_out = reinterpret_cast<xlio_socket_t>(si);
+    return 0;
+}
+
 extern "C" int xlio_socket_send(xlio_socket_t sock, const void *data, size_t len,
                                 const struct xlio_socket_send_attr *attr)
 {
@@ -383,19 +702,190 @@ extern "C" int xlio_socket_send(xlio_socket_t sock, const void *data, size_t len
     return xlio_socket_sendv(sock, &iov, 1, attr);
 }
 
+static int xlio_socket_sendv_dgram(sockinfo_udp *si, const struct iovec *iov, unsigned iovcnt,
+                                   const struct sockaddr *to, socklen_t tolen,
+                                   const struct xlio_socket_send_attr *attr)
+{
+    poll_group *grp = si->get_poll_group();
+
+    /*
+     * With XLIO_TX_MPWQE, a XLIO_GROUP_FLAG_DIRTY group delays the doorbell of the sends
+     * without the flush flag until xlio_poll_group_flush(). This lets the ring pack the
+     * datagrams into multi-packet WQEs.
+     */
+    if (grp && !(attr->flags & XLIO_SOCKET_SEND_FLAG_FLUSH) && grp->defers_dgram_tx()) {
+        grp->defer_tx_doorbells();
+    }
+
+    int rc = si->tx_xlio_socket(iov, iovcnt, to, tolen, attr);
+
+    if (rc == 0 && grp) {
+        grp->count_tx_op();
+    }
+
+    /*
+     * Datagram data is always copied to the internal buffers, so the user memory can be
+     * reused immediately. Complete non-inline operations right away to keep the TCP semantics.
+     */
+    if (rc == 0 && !(attr->flags & XLIO_SOCKET_SEND_FLAG_INLINE) && attr->userdata_op) {
+        if (grp && grp->has_comp_cb()) {
+            grp->comp_cb(si, attr->userdata_op);
+        }
+    }
+    return rc;
+}
+
+extern "C" int xlio_socket_sendto(xlio_socket_t sock, const void *data, size_t len,
+                                  const struct sockaddr *to, socklen_t tolen,
+                                  const struct xlio_socket_send_attr *attr)
+{
+    sockinfo *si = reinterpret_cast<sockinfo *>(sock);
+    const struct iovec iov = {.iov_base = const_cast<void *>(data), .iov_len = len};
+
+    if (unlikely(si->get_protocol() != PROTO_UDP)) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    return xlio_socket_sendv_dgram(static_cast<sockinfo_udp *>(si), &iov, 1, to, tolen, attr);
+}
+
 extern "C" int xlio_socket_sendv(xlio_socket_t sock, const struct iovec *iov, unsigned iovcnt,
                                  const struct xlio_socket_send_attr *attr)
 {
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
 
+    if (unlikely(si->get_protocol() == PROTO_UDP)) {
+        return xlio_socket_sendv_dgram(reinterpret_cast<sockinfo_udp *>(sock), iov, iovcnt,
+                                       nullptr, 0, attr);
+    }
+
+    // A timestamped send is registered before its data is posted
+    bool tx_ts = (attr->flags & XLIO_SOCKET_SEND_FLAG_TIMESTAMP);
     unsigned flags = XLIO_EXPRESS_OP_TYPE_DESC;
-    flags |= !(attr->flags & XLIO_SOCKET_SEND_FLAG_FLUSH) * XLIO_EXPRESS_MSG_MORE;
+    flags |= (!(attr->flags & XLIO_SOCKET_SEND_FLAG_FLUSH) || tx_ts) * XLIO_EXPRESS_MSG_MORE;
 
+    // The ULP, e.g. TLS, builds its records from the user data
+    sockinfo_tcp_ops *ops = si->get_ops();
     int rc = (attr->flags & XLIO_SOCKET_SEND_FLAG_INLINE)
-        ? si->tcp_tx_express_inline(iov, iovcnt, flags)
-        : si->tcp_tx_express(iov, iovcnt, attr->mkey, flags,
-                             reinterpret_cast<void *>(attr->userdata_op));
-    return rc < 0 ? rc : 0;
+        ? ops->tx_express_inline(iov, iovcnt, flags)
+        : ops->tx_express(iov, iovcnt, attr->mkey, flags,
+                          reinterpret_cast<void *>(attr->userdata_op));
+    if (rc < 0) {
+        return rc;
+    }
+    if (unlikely(tx_ts)) {
+        si->tx_ts_xlio_socket(attr->userdata_op);
+        if (attr->flags & XLIO_SOCKET_SEND_FLAG_FLUSH) {
+            si->flush();
+        }
+    }
+    if (likely(si->get_poll_group())) {
+        si->get_poll_group()->count_tx_op();
+    }
+    return 0;
+}
+
+/*
+ * Zerocopy owner of a received buffer sent by xlio_socket_send_buf(). The buffer goes back to
+ * its ring once the segments which refer to it are released by the TCP and the NIC.
+ */
+class xlio_buf_send_op : public mem_desc {
+public:
+    xlio_buf_send_op(mem_buf_desc_t *desc)
+        : m_p_desc(desc)
+    {
+        /* Allocate the operation with a taken reference. */
+        atomic_set(&m_ref, 1);
+    }
+
+    void get() override { (void)atomic_fetch_and_inc(&m_ref); }
+
+    void put() override
+    {
+        if (atomic_fetch_and_dec(&m_ref) == 1) {
+            xlio_buf_free(m_p_desc->to_xlio_buf());
+            delete this;
+        }
+    }
+
+    uint32_t get_lkey(mem_buf_desc_t *desc, ib_ctx_handler *ib_ctx, const void *addr,
+                      size_t len) override
+    {
+        NOT_IN_USE(desc);
+        NOT_IN_USE(addr);
+        NOT_IN_USE(len);
+        // The strides point into the RWQE buffers, so the data is in the RWQE pool memory
+        if (unlikely(ib_ctx != m_p_ib_ctx)) {
+            m_lkey = g_buffer_pool_rx_rwqe->find_lkey_by_ib_ctx_thread_safe(ib_ctx);
+            m_p_ib_ctx = ib_ctx;
+        }
+        return m_lkey;
+    }
+
+private:
+    atomic_t m_ref;
+    mem_buf_desc_t *const m_p_desc;
+    ib_ctx_handler *m_p_ib_ctx = nullptr;
+    uint32_t m_lkey = LKEY_ERROR;
+};
+
+extern "C" int xlio_socket_send_buf(xlio_socket_t sock, struct xlio_buf *buf, size_t offset,
+                                    size_t len, const struct xlio_socket_send_attr *attr)
+{
+    sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
+
+    if (unlikely(!buf || !len)) {
+        errno = EINVAL;
+        return -1;
+    }
+    mem_buf_desc_t *desc = mem_buf_desc_t::from_xlio_buf(buf);
+    if (unlikely(offset > desc->lwip_pbuf.len || len > desc->lwip_pbuf.len - offset)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const struct iovec iov = {
+        .iov_base = static_cast<uint8_t *>(desc->lwip_pbuf.payload) + offset, .iov_len = len};
+    ring *tx_ring = si->get_protocol() == PROTO_TCP ? si->get_tx_ring() : nullptr;
+
+    /*
+     * A datagram, a ULP which builds its own records or a device without the RX memory
+     * registration gets a copy, the buffer is released right away then.
+     */
+    if (unlikely(!tx_ring || si->has_ulp() ||
+                 g_buffer_pool_rx_rwqe->find_lkey_by_ib_ctx_thread_safe(tx_ring->get_ctx(0)) ==
+                     LKEY_ERROR)) {
+        struct xlio_socket_send_attr copy_attr = *attr;
+
+        copy_attr.flags |= XLIO_SOCKET_SEND_FLAG_INLINE;
+        copy_attr.flags &= ~XLIO_SOCKET_SEND_FLAG_TIMESTAMP;
+        int rc = xlio_socket_sendv(sock, &iov, 1, &copy_attr);
+        if (rc == 0) {
+            xlio_buf_free(buf);
+        }
+        return rc;
+    }
+
+    xlio_buf_send_op *op = new (std::nothrow) xlio_buf_send_op(desc);
+    if (unlikely(!op)) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    unsigned flags = XLIO_EXPRESS_OP_TYPE_FILE_ZEROCOPY;
+    flags |= !(attr->flags & XLIO_SOCKET_SEND_FLAG_FLUSH) * XLIO_EXPRESS_MSG_MORE;
+
+    // The segments take their references, the buffer stays with the caller on a failure
+    int rc = si->tcp_tx_express(&iov, 1, 0U, flags, op);
+    if (unlikely(rc < 0)) {
+        delete op;
+        return rc;
+    }
+    op->put();
+    if (likely(si->get_poll_group())) {
+        si->get_poll_group()->count_tx_op();
+    }
+    return 0;
 }
 
 extern "C" void xlio_poll_group_flush(xlio_poll_group_t group)
@@ -407,5 +897,9 @@ extern "C" void xlio_poll_group_flush(xlio_poll_group_t group)
 extern "C" void xlio_socket_flush(xlio_socket_t sock)
 {
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(sock);
-    si->flush();
+
+    // Datagrams are not aggregated and there is nothing to flush.
+    if (likely(si->get_protocol() == PROTO_TCP)) {
+        si->flush();
+    }
 }
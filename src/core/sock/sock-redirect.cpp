@@ -219,7 +219,8 @@ bool handle_close(int fd, bool cleanup, bool passthrough)
         g_zc_cache->handle_close(fd);
     }
 
-    if (g_p_fd_collection) {
+    // Closing a file or another fd which XLIO doesn't know needs nothing from the collection
+    if (fd_collection_is_xlio_fd(fd)) {
         // Remove fd from all existing epoll sets
         g_p_fd_collection->remove_from_all_epfds(fd, passthrough);
 
@@ -248,6 +249,11 @@ bool handle_close(int fd, bool cleanup, bool passthrough)
 #else
         NOT_IN_USE(is_for_udp_pool);
 #endif
+        // A passthrough socket stays open and may have moved to the non offloaded fds of an
+        // epoll set. A cq channel fd isn't closed through here.
+        if (!passthrough && !g_p_fd_collection->get_cq_channel_fd(fd)) {
+            g_p_fd_collection->clear_xlio_fd(fd);
+        }
     }
 
     return to_close_now;
@@ -370,7 +376,7 @@ static ssize_t sendfile_helper(sockinfo *p_socket_object, int in_fd, __off64_t *
         int rc;
 
         /* Get mapping from the cache */
-        mapping = g_zc_cache->get_mapping(in_fd);
+        mapping = g_zc_cache->get_mapping(in_fd, nullptr, cur_offset + count);
         if (!mapping) {
             srdr_logdbg("Couldn't allocate mapping object");
             goto fallback;
@@ -382,7 +388,9 @@ static ssize_t sendfile_helper(sockinfo *p_socket_object, int in_fd, __off64_t *
             /*
              * This is slow path, we check fstat(2) to handle the
              * scenario when user changes the file while respective
-             * mapping exists and the file becomes larger.
+             * mapping exists and the file becomes larger. A free
+             * mapping is remapped by the cache, this one is still
+             * in use by pending sends.
              * As workaround, fallback to preadv() implementation.
              */
             mapping->put();
@@ -671,7 +679,7 @@ inline int epoll_wait_helper(int __epfd, struct epoll_event *__events, int __max
         return -1;
     }
 
-    if (safe_mce_sys().tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
+    if (g_hot_sys_var.tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
         g_event_handler_manager_local.do_tasks();
     }
 
@@ -733,7 +741,7 @@ int sigaction_internal(int signum, const struct sigaction *act, struct sigaction
 
     PROFILE_FUNC
 
-    if (safe_mce_sys().handle_sigintr) {
+    if (g_hot_sys_var.handle_sigintr) {
         srdr_logdbg_entry("signum=%d, act=%p, oldact=%p", signum, act, oldact);
 
         switch (signum) {
@@ -771,7 +779,7 @@ int sigaction_internal(int signum, const struct sigaction *act, struct sigaction
     }
     ret = SYSCALL(sigaction, signum, act, oldact);
 
-    if (safe_mce_sys().handle_sigintr) {
+    if (g_hot_sys_var.handle_sigintr) {
         if (ret >= 0) {
             srdr_logdbg_exit("returned with %d", ret);
         } else {
@@ -1321,6 +1329,10 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(read)(int __fd, void *__buf, size_t __nbytes)
 
     srdr_logfuncall_entry("fd=%d", __fd);
 
+    if (!fd_collection_is_xlio_fd(__fd)) {
+        return SYSCALL(read, __fd, __buf, __nbytes);
+    }
+
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
@@ -1349,6 +1361,10 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(__read_chk)(int __fd, void *__buf, size_t __nb
 
     srdr_logfuncall_entry("fd=%d", __fd);
 
+    if (!fd_collection_is_xlio_fd(__fd)) {
+        return SYSCALL(__read_chk, __fd, __buf, __nbytes, __buflen);
+    }
+
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
@@ -1381,6 +1397,10 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(readv)(int __fd, const struct iovec *iov, int
 
     srdr_logfuncall_entry("fd=%d", __fd);
 
+    if (!fd_collection_is_xlio_fd(__fd)) {
+        return SYSCALL(readv, __fd, iov, iovcnt);
+    }
+
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
@@ -1528,19 +1548,15 @@ EXPORT_SYMBOL int XLIO_SYMBOL(recvmmsg)(int __fd, struct mmsghdr *__mmsghdr, uns
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
         int ret = 0;
-        for (unsigned int i = 0; i < __vlen; i++) {
+        while ((unsigned int)num_of_msg < __vlen) {
             int flags = __flags;
-            __mmsghdr[i].msg_hdr.msg_flags = 0;
-            ret = p_socket_object->rx(
-                RX_RECVMSG, __mmsghdr[i].msg_hdr.msg_iov, __mmsghdr[i].msg_hdr.msg_iovlen, &flags,
-                (__SOCKADDR_ARG)__mmsghdr[i].msg_hdr.msg_name,
-                (socklen_t *)&__mmsghdr[i].msg_hdr.msg_namelen, &__mmsghdr[i].msg_hdr);
+            // The socket fills as many messages as it has ready in one pass
+            ret = p_socket_object->rx_mmsg(&__mmsghdr[num_of_msg], __vlen - num_of_msg, &flags);
             if (ret < 0) {
                 break;
             }
-            num_of_msg++;
-            __mmsghdr[i].msg_len = ret;
-            if ((i == 0) && (flags & MSG_WAITFORONE)) {
+            num_of_msg += ret;
+            if (flags & MSG_WAITFORONE) {
                 __flags |= MSG_DONTWAIT;
             }
             if (__timeout) {
@@ -1643,6 +1659,10 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(write)(int __fd, __const void *__buf, size_t _
 
     srdr_logfuncall_entry("fd=%d, nbytes=%d", __fd, __nbytes);
 
+    if (!fd_collection_is_xlio_fd(__fd)) {
+        return SYSCALL(write, __fd, __buf, __nbytes);
+    }
+
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
@@ -1669,6 +1689,10 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(writev)(int __fd, const struct iovec *iov, int
 
     srdr_logfuncall_entry("fd=%d, %d iov blocks", __fd, iovcnt);
 
+    if (!fd_collection_is_xlio_fd(__fd)) {
+        return SYSCALL(writev, __fd, iov, iovcnt);
+    }
+
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
@@ -1739,8 +1763,6 @@ EXPORT_SYMBOL ssize_t XLIO_SYMBOL(sendmsg)(int __fd, __const struct msghdr *__ms
 EXPORT_SYMBOL int XLIO_SYMBOL(sendmmsg)(int __fd, struct mmsghdr *__mmsghdr, unsigned int __vlen,
                                         int __flags)
 {
-    int num_of_msg = 0;
-
     PROFILE_FUNC
 
     srdr_logfuncall_entry("fd=%d, mmsghdr length=%d flags=%x", __fd, __vlen, __flags);
@@ -1754,29 +1776,7 @@ EXPORT_SYMBOL int XLIO_SYMBOL(sendmmsg)(int __fd, struct mmsghdr *__mmsghdr, uns
     sockinfo *p_socket_object = nullptr;
     p_socket_object = fd_collection_get_sockfd(__fd);
     if (p_socket_object) {
-        for (unsigned int i = 0; i < __vlen; i++) {
-            xlio_tx_call_attr_t tx_arg;
-
-            tx_arg.opcode = TX_SENDMSG;
-            tx_arg.attr.iov = __mmsghdr[i].msg_hdr.msg_iov;
-            tx_arg.attr.sz_iov = (ssize_t)__mmsghdr[i].msg_hdr.msg_iovlen;
-            tx_arg.attr.flags = __flags;
-            tx_arg.attr.addr = (struct sockaddr *)(__SOCKADDR_ARG)__mmsghdr[i].msg_hdr.msg_name;
-            tx_arg.attr.len = (socklen_t)__mmsghdr[i].msg_hdr.msg_namelen;
-            tx_arg.attr.hdr = &__mmsghdr[i].msg_hdr;
-
-            int ret = p_socket_object->tx(tx_arg);
-            if (ret < 0) {
-                if (num_of_msg) {
-                    return num_of_msg;
-                } else {
-                    return ret;
-                }
-            }
-            num_of_msg++;
-            __mmsghdr[i].msg_len = ret;
-        }
-        return num_of_msg;
+        return p_socket_object->tx_mmsg(__mmsghdr, __vlen, __flags);
     }
 
     return SYSCALL(sendmmsg, __fd, __mmsghdr, __vlen, __flags);
@@ -2314,7 +2314,8 @@ EXPORT_SYMBOL pid_t XLIO_SYMBOL(fork)(void)
 
         safe_mce_sys().get_params();
         vlog_start(PRODUCT_NAME, safe_mce_sys().log_level, safe_mce_sys().log_filename,
-                   safe_mce_sys().log_details, safe_mce_sys().log_colors);
+                   safe_mce_sys().log_details, safe_mce_sys().log_colors,
+                   safe_mce_sys().log_async, safe_mce_sys().log_rate_limit);
         if (xlio_rdma_lib_reset()) {
             srdr_logerr("Child Process: rdma_lib_reset failed %d %s", errno, strerror(errno));
         }
@@ -2412,7 +2413,8 @@ EXPORT_SYMBOL int XLIO_SYMBOL(daemon)(int __nochdir, int __noclose)
 
         safe_mce_sys().get_params();
         vlog_start(PRODUCT_NAME, safe_mce_sys().log_level, safe_mce_sys().log_filename,
-                   safe_mce_sys().log_details, safe_mce_sys().log_colors);
+                   safe_mce_sys().log_details, safe_mce_sys().log_colors,
+                   safe_mce_sys().log_async, safe_mce_sys().log_rate_limit);
         if (xlio_rdma_lib_reset()) {
             srdr_logerr("Child Process: rdma_lib_reset failed %d %s", errno, strerror(errno));
         }
@@ -2456,7 +2458,7 @@ EXPORT_SYMBOL sighandler_t XLIO_SYMBOL(signal)(int signum, sighandler_t handler)
 {
     PROFILE_FUNC
 
-    if (safe_mce_sys().handle_sigintr) {
+    if (g_hot_sys_var.handle_sigintr) {
         srdr_logdbg_entry("signum=%d, handler=%p", signum, handler);
 
         if (handler && handler != SIG_ERR && handler != SIG_DFL && handler != SIG_IGN) {
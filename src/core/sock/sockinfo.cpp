@@ -18,6 +18,8 @@
 #include "sock-redirect.h"
 #include "fd_collection.h"
 #include "dev/ring_simple.h"
+#include "event/poll_group.h"
+#include "tx_ts_sink.h"
 
 #define MODULE_NAME "si"
 #undef MODULE_HDR_INFO
@@ -60,6 +62,26 @@ const char *sockinfo::setsockopt_so_opt_to_str(int opt)
         return "SO_MAX_PACING_RATE";
     case SO_XLIO_SHUTDOWN_RX:
         return "SO_XLIO_SHUTDOWN_RX";
+    case SO_XLIO_ADD_MEMBERSHIPS:
+        return "SO_XLIO_ADD_MEMBERSHIPS";
+    case SO_XLIO_DROP_MEMBERSHIPS:
+        return "SO_XLIO_DROP_MEMBERSHIPS";
+    case SO_XLIO_RX_POLL:
+        return "SO_XLIO_RX_POLL";
+    case SO_XLIO_TX_WATERMARKS:
+        return "SO_XLIO_TX_WATERMARKS";
+    case SO_XLIO_RX_DROP_POLICY:
+        return "SO_XLIO_RX_DROP_POLICY";
+    case SO_XLIO_NVME_OFFLOAD:
+        return "SO_XLIO_NVME_OFFLOAD";
+    case SO_XLIO_NVME_DDP_SETUP:
+        return "SO_XLIO_NVME_DDP_SETUP";
+    case SO_XLIO_NVME_DDP_TEARDOWN:
+        return "SO_XLIO_NVME_DDP_TEARDOWN";
+    case SO_BUSY_POLL:
+        return "SO_BUSY_POLL";
+    case SO_PREFER_BUSY_POLL:
+        return "SO_PREFER_BUSY_POLL";
     case IPV6_V6ONLY:
         return "IPV6_V6ONLY";
     case IPV6_ADDR_PREFERENCES:
@@ -71,7 +93,7 @@ const char *sockinfo::setsockopt_so_opt_to_str(int opt)
 }
 
 sockinfo::sockinfo(int fd, int domain, bool use_ring_locks)
-    : m_skip_cq_poll_in_rx(safe_mce_sys().skip_poll_in_rx == SKIP_POLL_IN_RX_ENABLE)
+    : m_skip_cq_poll_in_rx(g_hot_sys_var.skip_poll_in_rx == SKIP_POLL_IN_RX_ENABLE)
     , m_app_lock(multilock::create_new_lock(MULTILOCK_RECURSIVE, "app_sock_lock"))
     , m_family(domain)
     , m_fd(fd)
@@ -84,6 +106,8 @@ sockinfo::sockinfo(int fd, int domain, bool use_ring_locks)
     , m_lock_snd(MODULE_NAME "::m_lock_snd")
     , m_so_bindtodevice_ip(ip_address::any_addr(), domain)
     , m_rx_ring_map_lock(MODULE_NAME "::m_rx_ring_map_lock")
+    , m_rx_poll_num(safe_mce_sys().rx_poll_num)
+    , m_rx_poll_adaptive(safe_mce_sys().poll_adaptive)
     , m_ring_alloc_log_rx(safe_mce_sys().ring_allocation_logic_rx, use_ring_locks)
     , m_ring_alloc_log_tx(safe_mce_sys().ring_allocation_logic_tx, use_ring_locks)
 {
@@ -91,7 +115,7 @@ sockinfo::sockinfo(int fd, int domain, bool use_ring_locks)
     if (unlikely(m_rx_epfd == -1)) {
         throw_xlio_exception("create internal epoll");
     }
-    m_sock_wakeup_pipe.wakeup_set_epoll_fd(m_rx_epfd);
+    m_sock_wakeup.wakeup_set_epoll_fd(m_rx_epfd);
     if (m_fd == SOCKET_FAKE_FD) {
         m_fd = m_rx_epfd;
     }
@@ -102,6 +126,7 @@ sockinfo::sockinfo(int fd, int domain, bool use_ring_locks)
 
     m_rx_reuse_buff.n_buff_num = 0;
     memset(&m_so_ratelimit, 0, sizeof(xlio_rate_limit_t));
+    memset(&m_sw_ratelimit, 0, sizeof(xlio_rate_limit_t));
     set_flow_tag(m_fd + 1);
 
     m_connected.set_sa_family(m_family);
@@ -120,6 +145,12 @@ sockinfo::~sockinfo()
 {
     m_state = SOCKINFO_DESTROYING;
 
+    if (m_p_tx_ts_sink) {
+        // The buffers in flight keep the sink and drop their timestamps
+        m_p_tx_ts_sink->detach();
+        m_p_tx_ts_sink = nullptr;
+    }
+
     if (!sockinfo::is_shadow_socket_present()) {
         // Don't let other destructors know about substituted fd
         m_fd = -1;
@@ -176,6 +207,7 @@ void sockinfo::socket_stats_init()
     m_p_socket_stats->ring_user_id_tx =
         ring_allocation_logic_tx(get_fd(), m_ring_alloc_log_tx).calc_res_key_by_logic();
     m_p_socket_stats->sa_family = m_family;
+    m_p_lat_hists = safe_mce_sys().stats_latency_hist ? &m_p_socket_stats->lat_hists : nullptr;
 }
 
 void sockinfo::set_blocking(bool is_blocked)
@@ -441,16 +473,16 @@ int sockinfo::setsockopt(int __level, int __optname, const void *__optval, sockl
             if (__optval) {
                 uint8_t val = *(uint8_t *)__optval;
 
-                // SOF_TIMESTAMPING_TX_SOFTWARE and SOF_TIMESTAMPING_TX_HARDWARE is NOT supported.
-                if (val & (SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_HARDWARE)) {
+                // SOF_TIMESTAMPING_TX_SOFTWARE is NOT supported.
+                if (val & SOF_TIMESTAMPING_TX_SOFTWARE) {
                     ret = SOCKOPT_NO_XLIO_SUPPORT;
                     errno = EOPNOTSUPP;
-                    si_logdbg(
-                        "SOL_SOCKET, SOF_TIMESTAMPING_TX_SOFTWARE and SOF_TIMESTAMPING_TX_HARDWARE "
-                        "is not supported, errno set to EOPNOTSUPP");
+                    si_logdbg("SOL_SOCKET, SOF_TIMESTAMPING_TX_SOFTWARE is not supported, errno "
+                              "set to EOPNOTSUPP");
                 }
 
-                if (val & (SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE)) {
+                if (val & (SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+                           SOF_TIMESTAMPING_TX_HARDWARE)) {
                     if (g_p_net_device_table_mgr->get_ctx_time_conversion_mode() ==
                         TS_CONVERSION_MODE_DISABLE) {
                         if (safe_mce_sys().hw_ts_conversion_mode == TS_CONVERSION_MODE_DISABLE) {
@@ -470,6 +502,10 @@ int sockinfo::setsockopt(int __level, int __optname, const void *__optval, sockl
                     }
                 }
 
+                if ((val & SOF_TIMESTAMPING_OPT_ID) &&
+                    !(m_n_tsing_flags & SOF_TIMESTAMPING_OPT_ID)) {
+                    tx_ts_reset_key();
+                }
                 m_n_tsing_flags = val;
                 si_logdbg("SOL_SOCKET, SO_TIMESTAMPING=%u", m_n_tsing_flags);
             } else {
@@ -512,6 +548,51 @@ int sockinfo::setsockopt(int __level, int __optname, const void *__optval, sockl
             shutdown_rx();
             ret = SOCKOPT_INTERNAL_XLIO_SUPPORT;
             break;
+        case SO_XLIO_RX_POLL:
+            if (__optval && __optlen == sizeof(int) && *(int *)__optval >= MCE_MIN_RX_NUM_POLLS &&
+                *(int *)__optval <= MCE_MAX_RX_NUM_POLLS) {
+                // Force at least one good polling loop, as XLIO_RX_POLL does
+                m_rx_poll_num = *(int *)__optval ?: 1;
+                m_rx_poll_num_set = true;
+                m_busy_poll_tsc = 0U;
+                si_logdbg("SOL_SOCKET, %s=%d", setsockopt_so_opt_to_str(__optname),
+                          m_rx_poll_num);
+                ret = SOCKOPT_INTERNAL_XLIO_SUPPORT;
+            } else {
+                errno = EINVAL;
+                ret = SOCKOPT_NO_XLIO_SUPPORT;
+            }
+            break;
+        case SO_BUSY_POLL:
+            // Also set in the OS, which checks the privileges and reports the value back
+            if (__optval && __optlen >= sizeof(int) && *(int *)__optval >= 0) {
+                int usec = *(int *)__optval;
+
+                // 0 polls once and sleeps, otherwise poll for usec before sleeping
+                m_rx_poll_num = usec ? -1 : 1;
+                m_rx_poll_num_set = true;
+                m_busy_poll_tsc = (tscval_t)usec * get_tsc_rate_per_second() / USEC_PER_SEC;
+                si_logdbg("SOL_SOCKET, %s=%d", setsockopt_so_opt_to_str(__optname), usec);
+            }
+            ret = SOCKOPT_HANDLE_BY_OS;
+            break;
+        case SO_ZEROCOPY:
+            // Also set in the OS, which reports the value back
+            if (__optval && __optlen >= sizeof(int)) {
+                m_b_zerocopy = !!*(int *)__optval;
+                si_logdbg("SOL_SOCKET, %s=%s", setsockopt_so_opt_to_str(__optname),
+                          (m_b_zerocopy ? "true" : "false"));
+            }
+            ret = SOCKOPT_HANDLE_BY_OS;
+            break;
+        case SO_PREFER_BUSY_POLL:
+            if (__optval && __optlen >= sizeof(int)) {
+                m_prefer_busy_poll = !!*(int *)__optval;
+                si_logdbg("SOL_SOCKET, %s=%s", setsockopt_so_opt_to_str(__optname),
+                          (m_prefer_busy_poll ? "true" : "false"));
+            }
+            ret = SOCKOPT_HANDLE_BY_OS;
+            break;
         default:
             break;
         }
@@ -677,16 +758,18 @@ int sockinfo::getsockopt(int __level, int __optname, void *__optval, socklen_t *
     switch (__level) {
     case SOL_SOCKET:
         switch (__optname) {
-        case SO_MAX_PACING_RATE:
+        case SO_MAX_PACING_RATE: {
+            const struct xlio_rate_limit_t &rate_limit =
+                m_sw_ratelimit.rate ? m_sw_ratelimit : m_so_ratelimit;
             if (*__optlen == sizeof(struct xlio_rate_limit_t)) {
-                *(struct xlio_rate_limit_t *)__optval = m_so_ratelimit;
+                *(struct xlio_rate_limit_t *)__optval = rate_limit;
                 *__optlen = sizeof(struct xlio_rate_limit_t);
                 si_logdbg("(SO_MAX_PACING_RATE) value: %d, %d, %d",
                           (*(struct xlio_rate_limit_t *)__optval).rate,
                           (*(struct xlio_rate_limit_t *)__optval).max_burst_sz,
                           (*(struct xlio_rate_limit_t *)__optval).typical_pkt_sz);
             } else if (*__optlen == sizeof(uint32_t)) {
-                *(uint32_t *)__optval = KB_TO_BYTE(m_so_ratelimit.rate);
+                *(uint32_t *)__optval = KB_TO_BYTE(rate_limit.rate);
                 *__optlen = sizeof(uint32_t);
                 si_logdbg("(SO_MAX_PACING_RATE) value: %d", *(int *)__optval);
                 ret = 0;
@@ -694,6 +777,17 @@ int sockinfo::getsockopt(int __level, int __optname, void *__optval, socklen_t *
                 errno = EINVAL;
             }
             break;
+        }
+        case SO_XLIO_RX_POLL:
+            if (*__optlen >= sizeof(int)) {
+                *(int *)__optval = m_rx_poll_num;
+                *__optlen = sizeof(int);
+                si_logdbg("(SO_XLIO_RX_POLL) value: %d", *(int *)__optval);
+                ret = 0;
+            } else {
+                errno = EINVAL;
+            }
+            break;
         default:
             break;
         }
@@ -1224,6 +1318,10 @@ void sockinfo::consider_rings_migration_rx()
             if (m_ring_alloc_logic_rx.should_migrate_ring()) {
                 ring_alloc_logic_attr old_key(*m_ring_alloc_logic_rx.get_key());
                 do_rings_migration_rx(old_key);
+                // The consuming thread is stable, the TX ring moves with the next send
+                if (m_p_connected_dst_entry) {
+                    m_p_connected_dst_entry->expect_ring_migration_tx();
+                }
             }
             m_rx_migration_lock.unlock();
         }
@@ -1252,7 +1350,7 @@ int sockinfo::add_epoll_context(epfd_info *epfd)
         goto unlock_locks;
     }
 
-    if (safe_mce_sys().skip_poll_in_rx == SKIP_POLL_IN_RX_EPOLL_ONLY) {
+    if (g_hot_sys_var.skip_poll_in_rx == SKIP_POLL_IN_RX_EPOLL_ONLY) {
         m_skip_cq_poll_in_rx = true;
     }
 
@@ -1293,7 +1391,7 @@ void sockinfo::remove_epoll_context(epfd_info *epfd)
         m_econtext = NULL;
     }
 
-    if (safe_mce_sys().skip_poll_in_rx == SKIP_POLL_IN_RX_EPOLL_ONLY) {
+    if (g_hot_sys_var.skip_poll_in_rx == SKIP_POLL_IN_RX_EPOLL_ONLY) {
         m_skip_cq_poll_in_rx = false;
     }
 
@@ -1452,7 +1550,7 @@ void sockinfo::statistics_print(vlog_levels_t log_level /* = VLOG_DEBUG */)
 // Sleep on different CQs and OS listen socket
 int sockinfo::os_wait_sock_rx_epfd(epoll_event *ep_events, int maxevents)
 {
-    if (unlikely(safe_mce_sys().rx_cq_wait_ctrl)) {
+    if (unlikely(g_hot_sys_var.rx_cq_wait_ctrl)) {
         add_cqfd_to_sock_rx_epfd(m_p_rx_ring);
         int ret =
             SYSCALL(epoll_wait, m_rx_epfd, ep_events, maxevents, m_loops_timer.time_left_msec());
@@ -1544,12 +1642,12 @@ void sockinfo::rx_add_ring_cb(ring *p_ring)
         // Kernel loops through all the 350K epfds. By setting safe_mce_sys().rx_cq_wait_ctrl=true,
         // we add the cq-fd only to the epfds of the sockets that are going to sleep inside
         // sockinfo_tcp::rx_wait_helper/sockinfo_udp::rx_wait.
-        if (!safe_mce_sys().rx_cq_wait_ctrl) {
+        if (!g_hot_sys_var.rx_cq_wait_ctrl) {
             add_cqfd_to_sock_rx_epfd(p_ring);
         }
 
         // A ready wce can be pending due to the drain logic (cq channel will not wake up by itself)
-        m_sock_wakeup_pipe.do_wakeup();
+        m_sock_wakeup.do_wakeup();
     } else {
         // Increase ref count on cq_mgr_rx object
         rx_ring_iter->second->refcnt++;
@@ -1610,7 +1708,7 @@ void sockinfo::rx_del_ring_cb(ring *p_ring)
                     p_ring_info->rx_reuse_info.rx_reuse.size());
             }
 
-            if (!safe_mce_sys().rx_cq_wait_ctrl) {
+            if (!g_hot_sys_var.rx_cq_wait_ctrl) {
                 remove_cqfd_from_sock_rx_epfd(base_ring);
             }
 
@@ -1920,8 +2018,13 @@ int sockinfo::modify_ratelimit(dst_entry *p_dst_entry, struct xlio_rate_limit_t
         }
         return 0;
     }
-    si_logwarn(PRODUCT_NAME " is not configured with TX ring allocation logic per "
-                            "socket or user-id.");
+    if (g_hot_sys_var.tx_sw_pacing != SW_PACING_DISABLE) {
+        si_logdbg(PRODUCT_NAME " is not configured with TX ring allocation logic per "
+                               "socket or user-id.");
+    } else {
+        si_logwarn(PRODUCT_NAME " is not configured with TX ring allocation logic per "
+                                "socket or user-id.");
+    }
     return -1;
 }
 
@@ -2012,6 +2115,24 @@ void sockinfo::process_timestamps(mem_buf_desc_t *p_desc)
     }
 }
 
+void sockinfo::get_xlio_buf_rx_info(mem_buf_desc_t *p_desc, struct xlio_buf_rx_info *info)
+{
+    if (m_n_tsing_flags & SOF_TIMESTAMPING_RAW_HARDWARE) {
+        // Already converted by process_timestamps().
+        info->hw_timestamp = p_desc->rx.timestamps.hw;
+    } else {
+        // The conversion is done on demand, the RX path keeps the raw CQE value.
+        ring_simple *owner_ring = (ring_simple *)p_desc->p_desc_owner;
+        info->hw_timestamp = {0, 0};
+        if (owner_ring) {
+            owner_ring->convert_hw_time_to_system_time(p_desc->rx.timestamps.hw_raw,
+                                                       &info->hw_timestamp);
+        }
+    }
+    info->rss_hash = p_desc->rx.rss_hash;
+    info->flow_tag = p_desc->rx.flow_tag_id;
+}
+
 void sockinfo::handle_recv_timestamping(struct cmsg_state *cm_state,
                                         timestamps_t *packet_timestamps)
 {
@@ -2099,6 +2220,9 @@ void sockinfo::handle_cmsg(struct msghdr *msg)
     if (m_b_pktinfo) {
         handle_ip_pktinfo(&cm_state);
     }
+    if (m_b_udp_gro) {
+        handle_udp_gro(&cm_state);
+    }
     if (m_b_rcvtstamp || m_n_tsing_flags) {
         handle_recv_timestamping(&cm_state, get_socket_timestamps());
     }
@@ -2106,6 +2230,45 @@ void sockinfo::handle_cmsg(struct msghdr *msg)
     cm_state.mhdr->msg_controllen = cm_state.cmsg_bytes_consumed;
 }
 
+int sockinfo::tx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int flags)
+{
+    int num_of_msg = 0;
+
+    for (unsigned i = 0; i < vlen; i++) {
+        xlio_tx_call_attr_t tx_arg;
+
+        tx_arg.opcode = TX_SENDMSG;
+        tx_arg.attr.iov = mmsg[i].msg_hdr.msg_iov;
+        tx_arg.attr.sz_iov = (ssize_t)mmsg[i].msg_hdr.msg_iovlen;
+        tx_arg.attr.flags = flags;
+        tx_arg.attr.addr = (struct sockaddr *)mmsg[i].msg_hdr.msg_name;
+        tx_arg.attr.len = (socklen_t)mmsg[i].msg_hdr.msg_namelen;
+        tx_arg.attr.hdr = &mmsg[i].msg_hdr;
+
+        ssize_t ret = tx(tx_arg);
+        if (ret < 0) {
+            return num_of_msg ? num_of_msg : -1;
+        }
+        num_of_msg++;
+        mmsg[i].msg_len = ret;
+    }
+    return num_of_msg;
+}
+
+int sockinfo::rx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int *p_flags)
+{
+    NOT_IN_USE(vlen);
+    mmsg[0].msg_hdr.msg_flags = 0;
+    ssize_t ret = rx(RX_RECVMSG, mmsg[0].msg_hdr.msg_iov, mmsg[0].msg_hdr.msg_iovlen, p_flags,
+                     (sockaddr *)mmsg[0].msg_hdr.msg_name, &mmsg[0].msg_hdr.msg_namelen,
+                     &mmsg[0].msg_hdr);
+    if (ret < 0) {
+        return -1;
+    }
+    mmsg[0].msg_len = ret;
+    return 1;
+}
+
 ssize_t sockinfo::rx_os(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, const int flags,
                         sockaddr *__from, socklen_t *__fromlen, struct msghdr *__msg)
 {
@@ -2136,6 +2299,146 @@ ssize_t sockinfo::rx_os(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov,
     return (ssize_t)-1;
 }
 
+uint32_t sockinfo::zc_alloc_id()
+{
+    std::lock_guard<decltype(m_zc_lock)> lock(m_zc_lock);
+    return m_zc_next_id++;
+}
+
+void sockinfo::zc_notify(uint32_t id, bool copied)
+{
+    {
+        std::lock_guard<decltype(m_zc_lock)> lock(m_zc_lock);
+        m_zc_notify.complete(id, copied);
+    }
+    NOTIFY_ON_EVENTS(this, EPOLLERR);
+}
+
+bool sockinfo::has_errqueue_notify()
+{
+    std::lock_guard<decltype(m_zc_lock)> lock(m_zc_lock);
+    return !m_zc_notify.empty() || !m_tx_ts_notify.empty();
+}
+
+bool sockinfo::parse_tx_ts_request(const xlio_tx_call_attr_t &tx_arg) const
+{
+    bool requested = m_n_tsing_flags & SOF_TIMESTAMPING_TX_HARDWARE;
+
+    /* SO_TIMESTAMPING control message overrides the socket option for a single send */
+    if (tx_arg.opcode == TX_SENDMSG && tx_arg.attr.hdr && tx_arg.attr.hdr->msg_controllen) {
+        struct msghdr *__msg = const_cast<struct msghdr *>(tx_arg.attr.hdr);
+        struct cmsghdr *cmsg;
+        for (cmsg = CMSG_FIRSTHDR(__msg); cmsg; cmsg = CMSG_NXTHDR(__msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPING &&
+                cmsg->cmsg_len == CMSG_LEN(sizeof(uint32_t))) {
+                requested = *reinterpret_cast<uint32_t *>(CMSG_DATA(cmsg)) &
+                    SOF_TIMESTAMPING_TX_HARDWARE;
+            }
+        }
+    }
+    return requested;
+}
+
+tx_ts_request sockinfo::tx_ts_make_request(uint32_t key, uintptr_t userdata_op)
+{
+    if (!m_p_tx_ts_sink) {
+        m_p_tx_ts_sink = new tx_ts_sink(this);
+    }
+    return {m_p_tx_ts_sink, userdata_op, key};
+}
+
+void sockinfo::tx_ts_complete(const tx_ts_request &req, const struct timespec &hw_timestamp)
+{
+    if (m_p_group) {
+        m_p_group->tx_ts_cb(this, req.userdata_op, hw_timestamp);
+        return;
+    }
+    {
+        std::lock_guard<decltype(m_zc_lock)> lock(m_zc_lock);
+        m_tx_ts_notify.push_back({hw_timestamp, req.key});
+    }
+    NOTIFY_ON_EVENTS(this, EPOLLERR);
+}
+
+void tx_ts_sink::complete(const tx_ts_request &req, const struct timespec &hw_timestamp)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    if (m_owner) {
+        m_owner->tx_ts_complete(req, hw_timestamp);
+    }
+}
+
+/*
+ * A notification per call, as Linux does: the range of the completed sends in a
+ * sock_extended_err of IP_RECVERR or IPV6_RECVERR. A TX HW timestamp is reported without
+ * the packet, as with SOF_TIMESTAMPING_OPT_TSONLY, in SCM_TIMESTAMPING before the error.
+ * The OS socket has the errors of the sockets without SO_ZEROCOPY and TX timestamping.
+ */
+ssize_t sockinfo::rx_errqueue(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov,
+                              int *p_flags, sockaddr *__from, socklen_t *__fromlen,
+                              struct msghdr *__msg)
+{
+    struct {
+        struct sock_extended_err ee;
+        struct sockaddr_in6 offender;
+    } err;
+    zc_notify_range range;
+    tx_ts_notify ts = {};
+    bool found_ts = false;
+    bool found = false;
+
+    if (!m_b_zerocopy && !is_tx_ts_reported()) {
+        return rx_os(call_type, p_iov, sz_iov, *p_flags, __from, __fromlen, __msg);
+    }
+
+    {
+        std::lock_guard<decltype(m_zc_lock)> lock(m_zc_lock);
+        if (!m_tx_ts_notify.empty()) {
+            ts = m_tx_ts_notify.front();
+            m_tx_ts_notify.pop_front();
+            found_ts = true;
+        } else {
+            found = m_zc_notify.pop(range);
+        }
+    }
+    if (!found && !found_ts) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if (__msg) {
+        struct cmsg_state cm_state;
+        bool is_ipv6 = (m_family == AF_INET6);
+
+        cm_state.mhdr = __msg;
+        cm_state.cmhdr = CMSG_FIRSTHDR(__msg);
+        cm_state.cmsg_bytes_consumed = 0;
+
+        memset(&err, 0, sizeof(err));
+        if (found_ts) {
+            struct timespec tsing[3] = {};
+
+            tsing[2] = ts.hw_timestamp;
+            insert_cmsg(&cm_state, SOL_SOCKET, SO_TIMESTAMPING, &tsing, sizeof(tsing));
+            err.ee.ee_errno = ENOMSG;
+            err.ee.ee_origin = SO_EE_ORIGIN_TIMESTAMPING;
+            err.ee.ee_info = SCM_TSTAMP_SND;
+            err.ee.ee_data = (m_n_tsing_flags & SOF_TIMESTAMPING_OPT_ID) ? ts.key : 0U;
+        } else {
+            err.ee.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+            err.ee.ee_code = range.copied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+            err.ee.ee_info = range.lo;
+            err.ee.ee_data = range.hi;
+        }
+        insert_cmsg(&cm_state, is_ipv6 ? SOL_IPV6 : SOL_IP, is_ipv6 ? IPV6_RECVERR : IP_RECVERR,
+                    &err,
+                    sizeof(err.ee) + (is_ipv6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in)));
+        __msg->msg_controllen = cm_state.cmsg_bytes_consumed;
+        __msg->msg_flags |= MSG_ERRQUEUE;
+    }
+    return 0;
+}
+
 ssize_t sockinfo::tx_os(const tx_call_t call_type, const iovec *p_iov, const ssize_t sz_iov,
                         const int __flags, const sockaddr *__to, const socklen_t __tolen)
 {
@@ -2199,7 +2502,7 @@ bool sockinfo::skip_os_select()
 {
     // If safe_mce_sys().select_poll_os_ratio == 0, it means that user configured XLIO not to poll
     // os (i.e. TRUE...)
-    return (!safe_mce_sys().select_poll_os_ratio);
+    return (!g_hot_sys_var.select_poll_os_ratio);
 }
 
 void sockinfo::rx_handle_cmsg(struct msghdr *msg, mem_buf_desc_t *out_buf)
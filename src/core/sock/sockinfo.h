@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <atomic>
 #include <unordered_map>
 #include <deque>
+#include <vector>
 #include <ifaddrs.h>
 #include <sys/socket.h>
 #include "config.h"
@@ -15,11 +17,14 @@
 #include "sock/cleanable_obj.h"
 #include "vlogger/vlogger.h"
 #include "utils/lock_wrapper.h"
+#include "utils/rdtsc.h"
+#include "util/adaptive_poll.h"
 #include "util/data_updater.h"
 #include "util/sock_addr.h"
 #include "util/xlio_stats.h"
 #include "util/sys_vars.h"
-#include "util/wakeup_pipe.h"
+#include "util/wakeup_eventfd.h"
+#include "util/zc_notify_queue.h"
 #include "iomux/epfd_info.h"
 #include "proto/flow_tuple.h"
 #include "proto/mem_buf_desc.h"
@@ -100,6 +105,13 @@
 // Pass the option also to the OS.
 #define SOCKOPT_HANDLE_BY_OS -2
 
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
 #if DEFINED_MISSING_NET_TSTAMP
 enum {
     SOF_TIMESTAMPING_TX_HARDWARE = (1 << 0),
@@ -109,6 +121,7 @@ enum {
     SOF_TIMESTAMPING_SOFTWARE = (1 << 4),
     SOF_TIMESTAMPING_SYS_HARDWARE = (1 << 5),
     SOF_TIMESTAMPING_RAW_HARDWARE = (1 << 6),
+    SOF_TIMESTAMPING_OPT_ID = (1 << 7),
     SOF_TIMESTAMPING_MASK = (SOF_TIMESTAMPING_RAW_HARDWARE - 1) | SOF_TIMESTAMPING_RAW_HARDWARE
 };
 #else
@@ -188,6 +201,8 @@ struct xlio_tx_call_attr_t {
 
     pbuf_desc priv;
     tx_call_t opcode;
+    // Ultra API send operation, nullptr for the POSIX calls
+    const struct xlio_socket_send_attr *xlio_attr;
 
     ~xlio_tx_call_attr_t() {};
     void clear(void)
@@ -196,6 +211,7 @@ struct xlio_tx_call_attr_t {
         memset(&attr, 0, sizeof(attr));
         memset(&priv, 0, sizeof(priv));
         priv.attr = PBUF_DESC_NONE;
+        xlio_attr = nullptr;
     }
 
     xlio_tx_call_attr_t() { clear(); }
@@ -213,6 +229,16 @@ const uint8_t ip_tos2prio[16] = {0, 0, 0, 0, 2, 2, 2, 2, 6, 6, 6, 6, 4, 4, 4, 4}
 class epfd_info;
 class poll_group;
 class entity_context;
+class sockinfo;
+
+// A multicast datagram delivered to several sockets at once, see rfs_mc::rx_dispatch_packet()
+struct rx_fanout {
+    void *fd_ready_array;
+    // References preset on the buffer by the dispatch, taken by the sockets that queue it
+    uint32_t refs_used;
+    // Sockets reported to their epoll set once all the sockets are served
+    std::vector<std::pair<epfd_info *, sockinfo *>> &epoll_ready;
+};
 
 class sockinfo {
 public:
@@ -252,14 +278,33 @@ public:
     //         'false' if not interested in this receive packet
     virtual bool rx_input_cb(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info,
                              void *pv_fd_ready_array) = 0;
+    // Set while a datagram socket is over its SO_RCVBUF, so the ring drops the datagrams before
+    // it parses them. The drop is confirmed by rx_over_limit_drop(), which clears a stale state.
+    bool is_rx_over_limit() const { return m_rx_over_limit.load(std::memory_order_relaxed); }
+    virtual bool rx_over_limit_drop(mem_buf_desc_t *p_desc)
+    {
+        NOT_IN_USE(p_desc);
+        return false;
+    }
+    // rx_input_cb() of a datagram that the multicast dispatch delivers to several sockets
+    virtual bool rx_input_cb_fanout(mem_buf_desc_t *p_desc, rx_fanout &fanout)
+    {
+        return rx_input_cb(p_desc, fanout.fd_ready_array);
+    }
 
     virtual void rx_data_recvd(uint32_t tot_size) = 0;
     virtual ssize_t tx(xlio_tx_call_attr_t &tx_arg) = 0;
+    // Send up to vlen messages for sendmmsg(), returns the number of messages or -1
+    virtual int tx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int flags);
     virtual void tx_thread_commit(mem_buf_desc_t *buf_list, uint32_t offset, uint32_t size,
                                   int flags) = 0;
     virtual bool is_readable(uint64_t *p_poll_sn, fd_array_t *p_fd_array = nullptr) = 0;
     virtual bool is_writeable() = 0;
     virtual bool is_errorable(int *errors) = 0;
+    // The MSG_ZEROCOPY send id completed, reported by recvmsg(MSG_ERRQUEUE)
+    void zc_notify(uint32_t id, bool copied);
+    // The TX HW timestamp of a send, reported by recvmsg(MSG_ERRQUEUE) or the Ultra API
+    void tx_ts_complete(const tx_ts_request &req, const struct timespec &hw_timestamp);
     virtual void clean_socket_obj() = 0;
     virtual void setPassthrough() = 0;
     virtual bool isPassthrough() = 0;
@@ -281,6 +326,13 @@ public:
     virtual bool is_incoming() = 0;
     virtual bool is_closable() = 0;
     virtual void statistics_print(vlog_levels_t log_level = VLOG_DEBUG) = 0;
+    // XLIO_RX_POLL changed at runtime, the sockets with SO_XLIO_RX_POLL or SO_BUSY_POLL keep theirs
+    void set_default_rx_poll_num(int32_t rx_poll_num)
+    {
+        if (!m_rx_poll_num_set) {
+            __atomic_store_n(&m_rx_poll_num, rx_poll_num, __ATOMIC_RELAXED);
+        }
+    }
     virtual int fcntl(int __cmd, unsigned long int __arg);
     virtual int fcntl64(int __cmd, unsigned long int __arg);
     virtual int ioctl(unsigned long int __request, unsigned long int __arg);
@@ -289,6 +341,11 @@ public:
     virtual ssize_t rx(const rx_call_t call_type, iovec *iov, const ssize_t iovlen,
                        int *p_flags = 0, sockaddr *__from = nullptr, socklen_t *__fromlen = nullptr,
                        struct msghdr *__msg = nullptr) = 0;
+    // Zero copy receive of the ready buffers, see xlio_api_t::recv_zcopy()
+    virtual int rx_zcopy(struct xlio_zcopy_buf *bufs, unsigned count, int flags) = 0;
+    virtual void rx_zcopy_free(const struct xlio_zcopy_buf *bufs, unsigned count) = 0;
+    // Receive up to vlen messages for recvmmsg(), returns the number of messages or -1
+    virtual int rx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int *p_flags);
 
     // Instructing the socket to immediately sample/un-sample the OS in receive flow
     virtual void set_immediate_os_sample() = 0;
@@ -306,10 +363,27 @@ public:
 
     entity_context *get_entity_context() const { return m_entity_context; }
     uint32_t get_epoll_event_flags() { return m_epoll_event_flags; }
-    uint32_t get_epoll_event_flags_thread() const { return m_epoll_event_flags_thread; }
+    uint32_t get_epoll_event_flags_thread() const
+    {
+        return m_epoll_event_flags_thread.load(std::memory_order_relaxed);
+    }
     void set_epoll_event_flags(uint32_t events) { m_epoll_event_flags = events; }
-    void set_epoll_event_flags_thread(uint32_t events) { m_epoll_event_flags_thread = events; }
+    void set_epoll_event_flags_thread(uint32_t events)
+    {
+        m_epoll_event_flags_thread.store(events, std::memory_order_relaxed);
+    }
+    // Worker side, returns the previous events. No previous events means the socket isn't queued.
+    uint32_t add_epoll_event_flags_thread(uint32_t events)
+    {
+        return m_epoll_event_flags_thread.fetch_or(events, std::memory_order_acq_rel);
+    }
+    // Application side, takes the events reported by the worker so far
+    uint32_t take_epoll_event_flags_thread()
+    {
+        return m_epoll_event_flags_thread.exchange(0U, std::memory_order_acq_rel);
+    }
     bool has_epoll_context() { return (!!m_econtext); }
+    epfd_info *get_epoll_context() const { return m_econtext; }
     bool get_rx_pkt_ready_list_count() const { return m_n_rx_pkt_ready_list_count; }
     int get_fd() const { return m_fd; };
     sa_family_t get_family() { return m_family; }
@@ -351,6 +425,22 @@ public:
     // XLIO Ultra API
     bool is_xlio_socket() const { return m_is_xlio_socket; }
     poll_group *get_poll_group() const { return m_p_group; }
+    uintptr_t get_xlio_socket_userdata() const { return m_xlio_socket_userdata; }
+    bool is_xlio_socket_high_prio() const { return m_is_xlio_socket_high_prio; }
+    std::vector<xlio_rx_batch_entry> &get_xlio_rx_batch() { return m_xlio_rx_batch; }
+    std::vector<uintptr_t> &get_xlio_comp_batch() { return m_xlio_comp_batch; }
+    ib_ctx_handler *get_ctx()
+    {
+        return m_p_connected_dst_entry ? m_p_connected_dst_entry->get_ctx() : nullptr;
+    }
+    int update_xlio_socket(unsigned flags, uintptr_t userdata_sq)
+    {
+        // A socket already queued by the group is served in its old order once.
+        m_is_xlio_socket_high_prio = !!(flags & XLIO_SOCKET_FLAG_HIGH_PRIO);
+        m_xlio_socket_userdata = userdata_sq;
+        return 0;
+    }
+    void get_xlio_buf_rx_info(mem_buf_desc_t *p_desc, struct xlio_buf_rx_info *info);
 
 protected:
     static const char *setsockopt_so_opt_to_str(int opt);
@@ -372,6 +462,7 @@ protected:
     virtual void post_dequeue() = 0;
     virtual int os_epoll_wait(epoll_event *ep_events, int maxevents);
     virtual void handle_ip_pktinfo(struct cmsg_state *cm_state) = 0;
+    virtual void handle_udp_gro(struct cmsg_state *cm_state) = 0;
     virtual bool try_un_offloading(); // un-offload the socket if possible
 
     virtual size_t handle_msg_trunc(size_t total_rx, size_t payload_size, int in_flags,
@@ -382,8 +473,15 @@ protected:
     virtual void rx_del_ring_cb(ring *p_ring);
 
     inline void set_rx_reuse_pending(bool is_pending = true);
+    // True while a blocking receive may keep polling after poll_count empty polls
+    inline bool rx_poll_budget_left(int poll_count);
+    inline void rx_wait_end();
     inline void reuse_buffer(mem_buf_desc_t *buff);
     inline void save_strq_stats(uint32_t packet_strides);
+    // Latency histograms, nothing is done unless monitor.stats.latency_hist is enabled
+    inline void lat_hist_rx_queued(mem_buf_desc_t *p_desc);
+    inline void lat_hist_rx_dequeued(mem_buf_desc_t *p_desc);
+    inline void lat_hist_record(lat_hist_t lat_hists_t::*hist, ring *p_ring, uint64_t ticks);
 
     inline int dequeue_packet(iovec *p_iov, ssize_t sz_iov, sockaddr *__from, socklen_t *__fromlen,
                               int in_flags, int *p_out_flags);
@@ -430,6 +528,25 @@ protected:
     // connected_ip is routed to
     bool attach_as_uc_receiver(role_t role, bool skip_rules = false);
 
+    // recvmsg(MSG_ERRQUEUE), the MSG_ZEROCOPY completions and the TX HW timestamps
+    ssize_t rx_errqueue(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, int *p_flags,
+                        sockaddr *__from, socklen_t *__fromlen, struct msghdr *__msg);
+    uint32_t zc_alloc_id();
+    bool has_errqueue_notify();
+
+    // SOF_TIMESTAMPING_RAW_HARDWARE reports the TX HW timestamps on the error queue
+    bool is_tx_ts_reported() const { return m_n_tsing_flags & SOF_TIMESTAMPING_RAW_HARDWARE; }
+    // SOF_TIMESTAMPING_TX_HARDWARE of the socket or of a SO_TIMESTAMPING control message
+    bool is_tx_ts_requested(const xlio_tx_call_attr_t &tx_arg) const
+    {
+        return unlikely(is_tx_ts_reported()) && parse_tx_ts_request(tx_arg);
+    }
+    bool parse_tx_ts_request(const xlio_tx_call_attr_t &tx_arg) const;
+    // SOF_TIMESTAMPING_OPT_ID restarts the keys of the sends
+    virtual void tx_ts_reset_key() { m_tx_ts_next_key = 0U; }
+    // Called under the socket TX lock, the sink is created by the first timestamped send
+    tx_ts_request tx_ts_make_request(uint32_t key, uintptr_t userdata_op);
+
     // Calling OS receive
     ssize_t rx_os(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, const int flags,
                   sockaddr *__from, socklen_t *__fromlen, struct msghdr *__msg);
@@ -464,8 +581,10 @@ protected:
     uint8_t m_n_tsing_flags = 0U;
     bool m_b_rcvtstamp = false;
     bool m_b_pktinfo = false;
+    bool m_b_udp_gro = false;
     bool m_b_blocking = true;
     bool m_b_rcvtstampns = false;
+    bool m_b_zerocopy = false; // SO_ZEROCOPY
     bool m_skip_cq_poll_in_rx;
     rfs *m_rfs_ptr = nullptr;
     socket_stats_t *m_p_socket_stats = nullptr;
@@ -476,7 +595,7 @@ protected:
     // End of first cache line
 
     uint32_t m_epoll_event_flags = 0U;
-    uint32_t m_epoll_event_flags_thread = 0U;
+    std::atomic<uint32_t> m_epoll_event_flags_thread {0U};
     int m_n_rx_pkt_ready_list_count = 0;
     size_t m_rx_pkt_ready_offset = 0U;
     size_t m_rx_ready_byte_count = 0U;
@@ -485,7 +604,7 @@ protected:
 public:
     list_node<sockinfo, sockinfo::ep_ready_fd_node_offset> ep_ready_fd_node;
     epoll_fd_rec m_fd_rec;
-    wakeup_pipe m_sock_wakeup_pipe;
+    wakeup_eventfd m_sock_wakeup;
 
     // End of second cache 8 bytes ago
 
@@ -522,11 +641,37 @@ protected:
     lock_mutex_recursive m_rx_ring_map_lock;
     ring_allocation_logic_rx m_ring_alloc_logic_rx;
     loops_timer m_loops_timer;
+    // Per socket polling budget, SO_XLIO_RX_POLL loops or SO_BUSY_POLL time
+    tscval_t m_busy_poll_tsc = 0U; // 0 - the budget is m_rx_poll_num loops
+    tscval_t m_busy_poll_start_tsc = 0U;
+    tscval_t m_rx_wait_tsc = 0U; // Polling time of the current wait
+    adaptive_poll m_rx_adaptive_poll;
+    int32_t m_rx_poll_num;
+    bool m_rx_poll_num_set = false; // Set by a socket option, not by XLIO_RX_POLL
+    bool m_rx_poll_adaptive; // The polling follows the previous waits, m_rx_poll_num usec at most
+    bool m_prefer_busy_poll = false; // SO_PREFER_BUSY_POLL - don't yield the CPU while polling
     ring_alloc_logic_attr m_ring_alloc_log_rx;
     ring_alloc_logic_attr m_ring_alloc_log_tx;
     struct xlio_rate_limit_t m_so_ratelimit;
+    struct xlio_rate_limit_t m_sw_ratelimit; // Software pacing applied instead of the NIC
     uint32_t m_pcp = 0U;
     uint32_t m_flow_tag_id = 0U; // Flow Tag for this socket
+    lat_hists_t *m_p_lat_hists = nullptr; // Histograms of the socket stats if they are enabled
+    // MSG_ZEROCOPY completions, they may be reported from a ring without the socket lock
+    lock_spin m_zc_lock;
+    uint32_t m_zc_next_id = 0U;
+    zc_notify_queue m_zc_notify;
+    // SOF_TIMESTAMPING_TX_HARDWARE timestamps, protected by m_zc_lock as well
+    struct tx_ts_notify {
+        struct timespec hw_timestamp;
+        uint32_t key;
+    };
+    std::deque<tx_ts_notify> m_tx_ts_notify;
+    tx_ts_sink *m_p_tx_ts_sink = nullptr;
+    // SOF_TIMESTAMPING_OPT_ID of the next send, the seqno the keys count from for TCP
+    uint32_t m_tx_ts_next_key = 0U;
+    // Published to the rings by a datagram socket over its SO_RCVBUF, see is_rx_over_limit()
+    std::atomic<bool> m_rx_over_limit {false};
 
     /*
      * XLIO Ultra API
@@ -540,6 +685,14 @@ protected:
     bool m_is_xlio_socket = false;
     // Flag indicating if this is an XLIO socket terminat CB was called
     bool m_is_xlio_socket_terminated = false;
+    // The group serves the socket before the normal priority ones
+    bool m_is_xlio_socket_high_prio = false;
+    // User data provided to the XLIO socket callbacks
+    uintptr_t m_xlio_socket_userdata = 0;
+    // Buffers received within the current poll iteration for the batched RX callback
+    std::vector<xlio_rx_batch_entry> m_xlio_rx_batch;
+    // Send operations completed within the current poll iteration for the batched callback
+    std::vector<uintptr_t> m_xlio_comp_batch;
 
 public:
 #if defined(DEFINED_NGINX) || defined(DEFINED_ENVOY)
@@ -553,6 +706,38 @@ void sockinfo::set_rx_reuse_pending(bool is_pending)
     m_rx_reuse_buf_pending = is_pending;
 }
 
+bool sockinfo::rx_poll_budget_left(int poll_count)
+{
+    if (m_busy_poll_tsc || (m_rx_poll_adaptive && m_rx_poll_num > 1)) {
+        tscval_t now;
+
+        gettimeoftsc(&now);
+        if (poll_count <= 1) {
+            m_busy_poll_start_tsc = now;
+            m_rx_wait_tsc = m_busy_poll_tsc
+                ? m_busy_poll_tsc
+                : (tscval_t)m_rx_adaptive_poll.budget_usec(m_rx_poll_num) *
+                    get_tsc_rate_per_second() / USEC_PER_SEC;
+            return true;
+        }
+        return (now - m_busy_poll_start_tsc) < m_rx_wait_tsc;
+    }
+    return poll_count < m_rx_poll_num || m_rx_poll_num == -1;
+}
+
+void sockinfo::rx_wait_end()
+{
+    // Waits which found the data without polling aren't accounted
+    if (m_rx_poll_adaptive && m_busy_poll_start_tsc) {
+        tscval_t now;
+
+        gettimeoftsc(&now);
+        m_rx_adaptive_poll.update((now - m_busy_poll_start_tsc) /
+                                  (get_tsc_rate_per_second() / USEC_PER_SEC));
+        m_busy_poll_start_tsc = 0U;
+    }
+}
+
 bool sockinfo::set_flow_tag(uint32_t flow_tag_id)
 {
     if (flow_tag_id && (flow_tag_id != FLOW_TAG_MASK)) {
@@ -606,6 +791,39 @@ void sockinfo::save_strq_stats(uint32_t packet_strides)
     }
 }
 
+void sockinfo::lat_hist_rx_queued(mem_buf_desc_t *p_desc)
+{
+    if (unlikely(m_p_lat_hists)) {
+        tscval_t now;
+
+        gettimeoftsc(&now);
+        p_desc->rx.ready_tsc = now;
+    }
+}
+
+void sockinfo::lat_hist_rx_dequeued(mem_buf_desc_t *p_desc)
+{
+    // Zero for the buffers which were queued as a part of another one
+    if (unlikely(m_p_lat_hists) && p_desc->rx.ready_tsc) {
+        tscval_t now;
+
+        gettimeoftsc(&now);
+        lat_hist_record(&lat_hists_t::rx_dwell, p_desc->p_desc_owner,
+                        now - p_desc->rx.ready_tsc);
+        p_desc->rx.ready_tsc = 0U;
+    }
+}
+
+void sockinfo::lat_hist_record(lat_hist_t lat_hists_t::*hist, ring *p_ring, uint64_t ticks)
+{
+    lat_hists_t *ring_hists = p_ring ? p_ring->get_lat_hists() : nullptr;
+
+    lat_hist_add(&(m_p_lat_hists->*hist), ticks);
+    if (ring_hists) {
+        lat_hist_add(&(ring_hists->*hist), ticks);
+    }
+}
+
 int sockinfo::dequeue_packet(iovec *p_iov, ssize_t sz_iov, sockaddr *__from, socklen_t *__fromlen,
                              int in_flags, int *p_out_flags)
 {
@@ -693,7 +911,7 @@ void sockinfo::reuse_buffer(mem_buf_desc_t *buff)
     ring *p_ring = buff->p_desc_owner->get_parent();
     rx_ring_map_t::iterator iter = m_rx_ring_map.find(p_ring);
     if (likely(iter != m_rx_ring_map.end())) {
-        if (safe_mce_sys().buffer_batching_mode == BUFFER_BATCHING_NONE) {
+        if (g_hot_sys_var.buffer_batching_mode == BUFFER_BATCHING_NONE) {
             if (!p_ring->reclaim_recv_buffers(buff)) {
                 g_buffer_pool_rx_ptr->put_buffer_after_deref_thread_safe(buff);
             }
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "sockinfo_pool.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "vlogger/vlogger.h"
+#include "core/util/utils.h"
+
+#undef MODULE_NAME
+#define MODULE_NAME "si_pool"
+
+sockinfo_pool *sockinfo_pool::s_tcp = nullptr;
+sockinfo_pool *sockinfo_pool::s_udp = nullptr;
+
+void sockinfo_pool::init_instances(size_t tcp_obj_size, size_t tcp_pool_size,
+                                   size_t udp_obj_size)
+{
+    if (!s_tcp && tcp_pool_size) {
+        sockinfo_pool *pool = new sockinfo_pool("TCP", tcp_obj_size);
+        node_cache &cache = pool->m_nodes[pool->node_index(get_current_numa_node())];
+        size_t objs = 0;
+
+        // The startup thread's node, as the heap would place them
+        while (objs < tcp_pool_size && pool->add_slab(cache, get_current_numa_node())) {
+            objs += SOCKINFO_POOL_SLAB_OBJS;
+        }
+        vlog_printf(VLOG_DEBUG, MODULE_NAME ": Prepared %zu TCP socket objects of %zu bytes\n",
+                    objs, tcp_obj_size);
+        s_tcp = pool;
+    }
+    if (!s_udp) {
+        s_udp = new sockinfo_pool("UDP", udp_obj_size);
+    }
+}
+
+sockinfo_pool::sockinfo_pool(const char *name, size_t obj_size)
+    : m_name(name)
+    , m_obj_size(obj_size)
+{
+    // The node of the object is kept behind it
+    m_slot_size = (m_obj_size + sizeof(int) + CACHELINE_SIZE - 1) & ~(CACHELINE_SIZE - 1);
+}
+
+int sockinfo_pool::node_index(int node) const
+{
+    return (node >= 0 && node < SOCKINFO_POOL_MAX_NODES) ? node : SOCKINFO_POOL_MAX_NODES;
+}
+
+int &sockinfo_pool::obj_node(void *obj) const
+{
+    return *reinterpret_cast<int *>(static_cast<char *>(obj) + m_slot_size - sizeof(int));
+}
+
+// Called with the node lock or before the pool is published
+bool sockinfo_pool::add_slab(node_cache &cache, int node)
+{
+    size_t size = m_slot_size * SOCKINFO_POOL_SLAB_OBJS;
+    char *slab = static_cast<char *>(
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+    if (slab == MAP_FAILED) {
+        vlog_printf(VLOG_DEBUG, MODULE_NAME ": %s slab mmap failed (errno=%d)\n", m_name, errno);
+        return false;
+    }
+
+    // Bound before the first touch, the pages are faulted in on the node
+    if (node_index(node) < SOCKINFO_POOL_MAX_NODES) {
+        unsigned long mask = 1UL << node;
+        if (syscall(SYS_mbind, slab, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0) != 0) {
+            vlog_printf(VLOG_DEBUG, MODULE_NAME ": %s slab mbind to node %d failed (errno=%d)\n",
+                        m_name, node, errno);
+        }
+    }
+
+    for (size_t i = 0; i < SOCKINFO_POOL_SLAB_OBJS; ++i) {
+        free_obj *obj = reinterpret_cast<free_obj *>(slab + i * m_slot_size);
+        obj_node(obj) = node_index(node);
+        obj->next = cache.free_list;
+        cache.free_list = obj;
+    }
+    return true;
+}
+
+void *sockinfo_pool::get_obj()
+{
+    int node = get_current_numa_node();
+    node_cache &cache = m_nodes[node_index(node)];
+    std::lock_guard<decltype(cache.lock)> lock(cache.lock);
+
+    if (!cache.free_list && !add_slab(cache, node)) {
+        return nullptr;
+    }
+    free_obj *obj = cache.free_list;
+    cache.free_list = obj->next;
+    return obj;
+}
+
+void sockinfo_pool::return_obj(void *ptr)
+{
+    node_cache &cache = m_nodes[obj_node(ptr)];
+    std::lock_guard<decltype(cache.lock)> lock(cache.lock);
+
+    free_obj *obj = static_cast<free_obj *>(ptr);
+    obj->next = cache.free_list;
+    cache.free_list = obj;
+}
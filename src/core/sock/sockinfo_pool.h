@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef SOCKINFO_POOL_H
+#define SOCKINFO_POOL_H
+
+#include <stddef.h>
+#include <mutex>
+
+#define SOCKINFO_POOL_MAX_NODES 8
+#define SOCKINFO_POOL_SLAB_OBJS 32U
+
+/*
+ * Memory of the socket objects, in slabs per NUMA node.
+ * An object is taken from the node of the CPU which creates the socket: the application thread
+ * for socket() and the thread polling the ring for an accepted connection, which is the thread
+ * touching the socket for every packet. The slab pages are bound to their node and the objects
+ * are cache line aligned, so the hot sections of the socket don't share the lines with another
+ * object.
+ * The objects are constructed and destructed as usual, only the memory is recycled: a closed
+ * socket returns it to the free list of its node. The slabs stay mapped until the exit.
+ */
+class sockinfo_pool {
+public:
+    // The TCP pool prepares tcp_pool_size objects at startup, 0 disables it
+    static void init_instances(size_t tcp_obj_size, size_t tcp_pool_size, size_t udp_obj_size);
+    // Returns nullptr when the pool is disabled or not initialized yet.
+    static sockinfo_pool *tcp_instance() { return s_tcp; }
+    static sockinfo_pool *udp_instance() { return s_udp; }
+
+    size_t get_obj_size() const { return m_obj_size; }
+    void *get_obj();
+    void return_obj(void *obj);
+
+private:
+    struct free_obj {
+        free_obj *next;
+    };
+
+    // The nodes beyond SOCKINFO_POOL_MAX_NODES and an unknown node share the last list
+    struct node_cache {
+        std::mutex lock;
+        free_obj *free_list = nullptr;
+    };
+
+    sockinfo_pool(const char *name, size_t obj_size);
+
+    int node_index(int node) const;
+    int &obj_node(void *obj) const;
+    bool add_slab(node_cache &cache, int node);
+
+    static sockinfo_pool *s_tcp;
+    static sockinfo_pool *s_udp;
+    node_cache m_nodes[SOCKINFO_POOL_MAX_NODES + 1];
+    const char *m_name;
+    const size_t m_obj_size;
+    size_t m_slot_size;
+};
+
+#endif
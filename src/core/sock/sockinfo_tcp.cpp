@@ -17,8 +17,10 @@
 #include "utils/rdtsc.h"
 #include "util/libxlio.h"
 #include "util/instrumentation.h"
+#include "util/coarse_clock.h"
 #include "util/list.h"
 #include "util/agent.h"
+#include "util/memcpy_nt.h"
 #include "event/event_handler_manager.h"
 #include "event/event_handler_manager_local.h"
 #include "event/poll_group.h"
@@ -30,7 +32,9 @@
 #include "fd_collection.h"
 #include "sockinfo_tcp.h"
 #include "sockinfo_tcp_listen_context.h"
+#include "sockinfo_pool.h"
 #include "bind_no_port.h"
+#include "tcp_timewait.h"
 #include "xlio.h"
 #include "event/entity_context_manager.h"
 
@@ -54,6 +58,13 @@
 #define si_tcp_logfunc    __log_info_func
 #define si_tcp_logfuncall __log_info_funcall
 
+// Default burst of a software paced socket, in microseconds of its rate
+#define SW_PACING_BATCH_USEC 100
+// Idle time after which a socket gives its send buffer growth back
+#define SNDBUF_AUTOTUNE_IDLE_MSEC 1000U
+// MSG_WAITALL reads from this size are placed with non-temporal stores, larger than the L2
+#define RX_PLACE_NT_MIN (256U * 1024U)
+
 extern global_stats_t g_global_stat_static;
 
 tcp_timers_collection *g_tcp_timers_collection = nullptr;
@@ -62,6 +73,47 @@ bind_no_port *g_bind_no_port = nullptr;
 
 static padded_lock_dummy g_lock_dummy_socket;
 
+// Sum of the send buffer growth of all the sockets
+static std::atomic<size_t> g_sndbuf_autotune_used {0};
+
+// Fast Open cookies of the servers by the server address
+#define TFO_COOKIES_MAX 4096U
+struct tfo_cookie_entry {
+    uint8_t len;
+    uint8_t cookie[TCP_TFO_COOKIE_LEN_MAX];
+    uint16_t mss;
+};
+static lock_spin g_tfo_cookies_lock("tfo_cookies");
+static std::unordered_map<ip_address, tfo_cookie_entry> g_tfo_cookies;
+
+static bool tfo_cookie_get(const ip_address &ip, struct tcp_pcb *pcb)
+{
+    std::lock_guard<decltype(g_tfo_cookies_lock)> lock(g_tfo_cookies_lock);
+    auto iter = g_tfo_cookies.find(ip);
+
+    if (iter == g_tfo_cookies.end()) {
+        return false;
+    }
+    memcpy(pcb->tfo_cookie, iter->second.cookie, iter->second.len);
+    pcb->tfo_cookie_len = iter->second.len;
+    pcb->tfo_mss = iter->second.mss;
+    return true;
+}
+
+static void tfo_cookie_put(const ip_address &ip, const struct tcp_pcb *pcb)
+{
+    std::lock_guard<decltype(g_tfo_cookies_lock)> lock(g_tfo_cookies_lock);
+    tfo_cookie_entry entry;
+
+    if (g_tfo_cookies.size() >= TFO_COOKIES_MAX && g_tfo_cookies.find(ip) == g_tfo_cookies.end()) {
+        g_tfo_cookies.clear();
+    }
+    entry.len = pcb->tfo_cookie_len;
+    memcpy(entry.cookie, pcb->tfo_cookie, entry.len);
+    entry.mss = pcb->mss;
+    g_tfo_cookies[ip] = entry;
+}
+
 /*
  * The following socket options are inherited by a connected TCP socket from the listening socket:
  * SO_DEBUG, SO_DONTROUTE, SO_KEEPALIVE, SO_LINGER, SO_OOBINLINE, SO_RCVBUF, SO_RCVLOWAT, SO_SNDBUF,
@@ -82,6 +134,9 @@ static bool is_inherited_option(int __level, int __optname)
         case SO_SNDBUF:
         case SO_SNDLOWAT:
         case SO_XLIO_RING_ALLOC_LOGIC:
+        case SO_XLIO_RX_POLL:
+        case SO_BUSY_POLL:
+        case SO_PREFER_BUSY_POLL:
             ret = true;
         }
     } else if (__level == IPPROTO_TCP) {
@@ -115,9 +170,10 @@ event_handler_manager *sockinfo_tcp::get_event_mgr()
 {
     if (m_p_group) {
         return m_p_group->get_event_handler();
-    } else if (safe_mce_sys().tcp_ctl_thread ==
+    } else if (g_hot_sys_var.tcp_ctl_thread ==
                option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
-        return &g_event_handler_manager_local;
+        // The timer stays with the thread which registered it first
+        return m_p_timer_event_mgr ? m_p_timer_event_mgr : &g_event_handler_manager_local;
     } else {
         return g_p_event_handler_manager;
     }
@@ -127,7 +183,7 @@ tcp_timers_collection *sockinfo_tcp::get_tcp_timer_collection()
 {
     if (m_p_group) {
         return m_p_group->get_tcp_timers();
-    } else if (safe_mce_sys().tcp_ctl_thread ==
+    } else if (g_hot_sys_var.tcp_ctl_thread ==
                option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
         return &g_thread_local_tcp_timers;
     } else {
@@ -220,7 +276,7 @@ inline void sockinfo_tcp::reuse_buffer(mem_buf_desc_t *buff)
         buff->p_next_desc = nullptr;
     }
 
-    if (safe_mce_sys().buffer_batching_mode == BUFFER_BATCHING_NONE) {
+    if (g_hot_sys_var.buffer_batching_mode == BUFFER_BATCHING_NONE) {
         if (!m_p_rx_ring || !m_p_rx_ring->reclaim_recv_buffers(buff)) {
             g_buffer_pool_rx_ptr->put_buffer_after_deref_thread_safe(buff);
         }
@@ -231,6 +287,9 @@ inline void sockinfo_tcp::reuse_buffer(mem_buf_desc_t *buff)
     if (likely(m_p_rx_ring)) {
         m_rx_reuse_buff.n_buff_num += buff->rx.n_frags;
         m_rx_reuse_buff.rx_reuse.push_back(buff);
+        if (unlikely(m_pcb.tmr_parked)) {
+            wake_timer();
+        }
         if (m_rx_reuse_buff.n_buff_num < m_rx_num_buffs_reuse) {
             return;
         }
@@ -253,7 +312,7 @@ inline void sockinfo_tcp::reuse_buffer(mem_buf_desc_t *buff)
 
 static inline bool use_socket_locks()
 {
-    return (safe_mce_sys().tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS);
+    return (g_hot_sys_var.tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS);
 }
 
 static lock_base *get_tcp_lock(bool use_locks)
@@ -268,10 +327,35 @@ static lock_base *get_new_tcp_lock()
     return get_tcp_lock(use_socket_locks());
 }
 
+void *sockinfo_tcp::operator new(size_t size)
+{
+    sockinfo_pool *pool = sockinfo_pool::tcp_instance();
+
+    if (!pool) {
+        return ::operator new(size);
+    }
+    void *obj = pool->get_obj();
+    if (!obj) {
+        throw std::bad_alloc();
+    }
+    return obj;
+}
+
+void sockinfo_tcp::operator delete(void *ptr)
+{
+    sockinfo_pool *pool = sockinfo_pool::tcp_instance();
+
+    if (ptr && pool) {
+        pool->return_obj(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
 sockinfo_tcp::sockinfo_tcp(int fd, int domain)
     : sockinfo(fd, domain, use_socket_locks())
     , m_tcp_con_lock(get_new_tcp_lock())
-    , m_sysvar_buffer_batching_mode(safe_mce_sys().buffer_batching_mode)
+    , m_sysvar_buffer_batching_mode(g_hot_sys_var.buffer_batching_mode)
     , m_sysvar_tx_segs_batch_tcp(safe_mce_sys().tx_segs_batch_tcp)
     , m_tcp_seg_list(nullptr)
     , m_sysvar_rx_poll_on_tx_tcp(safe_mce_sys().rx_poll_on_tx_tcp)
@@ -304,6 +388,9 @@ sockinfo_tcp::sockinfo_tcp(int fd, int domain)
     tcp_pcb_init(&m_pcb, TCP_PRIO_NORMAL, this);
     m_snd_buf_max = safe_mce_sys().tcp_send_buffer_size;
     m_snd_buf = m_snd_buf_max;
+    m_snd_buf_base = m_snd_buf_max;
+    m_snd_buf_idle_ticks = 0;
+    m_snd_buf_autotune = safe_mce_sys().tcp_send_buffer_autotune_limit > 0;
 
     const tcp_keepalive_info keepalive_info = safe_mce_sys().sysctl_reader.get_tcp_keepalive_info();
     tcp_set_keepalive(&m_pcb, static_cast<u32_t>(1000U * keepalive_info.idle_secs),
@@ -324,6 +411,11 @@ sockinfo_tcp::sockinfo_tcp(int fd, int domain)
     m_rcvbuff_max = safe_mce_sys().sysctl_reader.get_tcp_rmem()->default_value;
     m_rcvbuff_current = 0;
     m_rcvbuff_non_tcp_recved = 0;
+    m_rcvbuff_autotune = safe_mce_sys().tcp_moderate_rcvbuf;
+    m_rcvbuff_initial = m_rcvbuff_max;
+    m_rcv_space_copied = 0;
+    m_rcv_space = 0;
+    m_rcv_space_time = 0;
     m_ready_conn_cnt = 0;
     m_backlog = INT_MAX;
     report_connected = false;
@@ -396,12 +488,13 @@ void sockinfo_tcp::set_xlio_socket(const struct xlio_socket_attr *attr)
     if (is_shadow_socket_present() && m_rx_epfd != -1) {
         // XLIO Socket API doesn't use per socket epfd
         // Closing it here leads to 2 extra syscalls per connection
-        m_sock_wakeup_pipe.wakeup_set_epoll_fd(0);
+        m_sock_wakeup.wakeup_set_epoll_fd(0);
         SYSCALL(close, m_rx_epfd);
         m_rx_epfd = -1;
     }
 
     m_xlio_socket_userdata = attr->userdata_sq;
+    m_is_xlio_socket_high_prio = !!(attr->flags & XLIO_SOCKET_FLAG_HIGH_PRIO);
     m_p_group = reinterpret_cast<poll_group *>(attr->group);
 
     m_ring_alloc_log_rx.set_ring_alloc_logic(RING_LOGIC_PER_USER_ID);
@@ -497,46 +590,46 @@ int sockinfo_tcp::harvest_sockinfo_tcp_listen_objects()
     return -1;
 }
 
+// Called under the lock of this socket, which serializes the consumers of the accept queues
+inline uint32_t sockinfo_tcp::collect_accepted_conns(sockinfo_tcp *listener)
+{
+    sockinfo_tcp *conn = listener->m_accept_queue.pop_all();
+    uint32_t conn_count = 0U;
+
+    while (conn) {
+        sockinfo_tcp *next = conn->m_accept_next;
+        conn->m_accept_next = nullptr;
+        m_accepted_conns.push_back(conn);
+        conn = next;
+        ++conn_count;
+    }
+    m_ready_conn_cnt += conn_count;
+    IF_STATS_O(listener,
+               listener->m_p_socket_stats->listen_counters.n_conn_established += conn_count);
+    IF_STATS(m_p_socket_stats->listen_counters.n_conn_backlog += conn_count);
+    return conn_count;
+}
+
 inline bool sockinfo_tcp::try_harvest_from_rss_child(size_t rss_child_index)
 {
     sockinfo_tcp *rss_child = m_listen_ctx->get_listen_rss_child(rss_child_index);
 
-    if (rss_child->m_ready_conn_cnt == 0) {
+    if (rss_child->m_accept_queue.empty()) {
         return false;
     }
 
-    std::lock_guard<decltype(rss_child->m_tcp_con_lock)> lock(rss_child->m_tcp_con_lock);
-
-    if (rss_child->m_ready_conn_cnt == 0) {
+    uint32_t conn_count = collect_accepted_conns(rss_child);
+    if (!conn_count) {
         return false;
     }
 
-    assert(rss_child->m_ready_conn_cnt == rss_child->m_accepted_conns.size());
-
-    size_t conn_count = rss_child->m_ready_conn_cnt;
-
-    m_accepted_conns.splice_tail(rss_child->m_accepted_conns);
-    m_ready_conn_cnt += conn_count;
-    rss_child->m_ready_conn_cnt = 0;
-
-    IF_STATS_O(rss_child,
-               rss_child->m_p_socket_stats->listen_counters.n_conn_backlog -= conn_count);
     IF_STATS_O(rss_child,
                rss_child->m_p_socket_stats->listen_counters.n_conn_accepted += conn_count);
-    IF_STATS(m_p_socket_stats->listen_counters.n_conn_backlog += conn_count);
 
     si_tcp_logdbg("Harvested %u connections from rss_child %zu", m_ready_conn_cnt, rss_child_index);
     return true;
 }
 
-int sockinfo_tcp::update_xlio_socket(unsigned flags, uintptr_t userdata_sq)
-{
-    NOT_IN_USE(flags); // Currently unused.
-    m_xlio_socket_userdata = userdata_sq;
-
-    return 0;
-}
-
 int sockinfo_tcp::detach_xlio_group()
 {
     std::lock_guard<decltype(m_tcp_con_lock)> lock(m_tcp_con_lock);
@@ -597,7 +690,7 @@ int sockinfo_tcp::detach_xlio_group()
 int sockinfo_tcp::attach_xlio_group(poll_group *group)
 {
     struct xlio_socket_attr attr = {
-        .flags = 0, /* unused */
+        .flags = m_is_xlio_socket_high_prio ? XLIO_SOCKET_FLAG_HIGH_PRIO : 0U,
         .domain = (int)m_family,
         .group = reinterpret_cast<xlio_poll_group_t>(group),
         .userdata_sq = m_xlio_socket_userdata,
@@ -606,6 +699,7 @@ int sockinfo_tcp::attach_xlio_group(poll_group *group)
     if (m_p_group) {
         si_tcp_logwarn("Cannot attach a non-detached XLIO socket %p, group %p, new-group %p", this,
                        m_p_group, group);
+        errno = EINVAL;
         return -1;
     }
 
@@ -616,24 +710,31 @@ int sockinfo_tcp::attach_xlio_group(poll_group *group)
 
     std::lock_guard<decltype(m_tcp_con_lock)> lock(m_tcp_con_lock);
 
+    // Leave the socket detached on a failure, so it can be attached again or destroyed.
+    auto attach_failed = [this, group](int err) {
+        delete m_p_connected_dst_entry;
+        m_p_connected_dst_entry = nullptr;
+        group->remove_socket(this);
+        m_p_group = nullptr;
+        errno = err;
+        return -1;
+    };
+
     create_dst_entry();
     if (!m_p_connected_dst_entry) {
         si_tcp_logwarn("Couldn't create dst_enrty, migration failed");
-        errno = ENOMEM;
-        return -1;
+        return attach_failed(ENOMEM);
     }
     bool result = prepare_dst_to_send(is_incoming());
     if (!result) {
         si_tcp_logwarn("Couldn't attach TX, migration failed");
-        errno = ENOTCONN;
-        return -1;
+        return attach_failed(ENOTCONN);
     }
 
     result = attach_as_uc_receiver(role_t(NULL), true);
     if (!result) {
         si_tcp_logwarn("Couldn't attach RX, migration failed");
-        errno = ECONNABORTED;
-        return -1;
+        return attach_failed(ECONNABORTED);
     }
     if (m_p_rule_extracted) {
         delete m_p_rule_extracted;
@@ -645,6 +746,36 @@ int sockinfo_tcp::attach_xlio_group(poll_group *group)
     return 0;
 }
 
+int sockinfo_tcp::migrate_xlio_group(poll_group *group)
+{
+    // Only a connected attached socket can be migrated, see detach_xlio_group().
+    if (!m_p_group || m_p_group == group || get_tcp_state(&m_pcb) != ESTABLISHED) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /*
+     * The source part runs in the context of the current group. The steering rule is extracted
+     * and kept in HW until the destination group attaches the new one, so the flow stays
+     * steered to XLIO for the whole migration.
+     */
+    int rc = detach_xlio_group();
+    if (rc == 0) {
+        // The destination group completes the migration in its context.
+        group->migrate_socket(this);
+    }
+    return rc;
+}
+
+void sockinfo_tcp::cancel_migrate()
+{
+    poll_group *group = get_migrate_group();
+
+    if (group) {
+        group->cancel_migrate(this);
+    }
+}
+
 void sockinfo_tcp::add_tx_ring_to_group()
 {
     ring *rng = get_tx_ring();
@@ -653,9 +784,37 @@ void sockinfo_tcp::add_tx_ring_to_group()
     }
 }
 
+void sockinfo_tcp::tx_watermark_check_high()
+{
+    uint32_t queued = tx_queued_bytes();
+
+    if (!m_tx_congested && queued >= m_tx_wm_high) {
+        m_tx_congested = true;
+        xlio_socket_event(XLIO_SOCKET_EVENT_TX_CONGESTED, static_cast<int>(queued));
+    }
+}
+
+void sockinfo_tcp::tx_watermark_check_low()
+{
+    uint32_t queued = tx_queued_bytes();
+
+    if (queued <= m_tx_wm_low) {
+        m_tx_congested = false;
+        xlio_socket_event(XLIO_SOCKET_EVENT_TX_WRITABLE, static_cast<int>(queued));
+    }
+}
+
 void sockinfo_tcp::xlio_socket_event(int event, int value)
 {
+    if (unlikely(m_conn_pool_state != CONN_POOL_NONE)) {
+        m_p_group->conn_pool_event(this, event);
+        return;
+    }
     if (is_xlio_socket()) {
+        // The user must learn about an accepted socket before its events.
+        if (unlikely(m_p_group->has_pending_accepts())) {
+            m_p_group->flush_accept_batch();
+        }
         /* poll_group::m_socket_event_cb must be always set. */
         m_p_group->m_socket_event_cb(reinterpret_cast<xlio_socket_t>(this), m_xlio_socket_userdata,
                                      event, value);
@@ -676,6 +835,11 @@ err_t sockinfo_tcp::rx_lwip_cb_xlio_socket(void *arg, struct tcp_pcb *pcb, struc
         return conn->handle_fin(pcb, err);
     }
 
+    // The user must learn about an accepted socket before its data.
+    if (unlikely(conn->m_p_group->has_pending_accepts())) {
+        conn->m_p_group->flush_accept_batch();
+    }
+
     if (unlikely(err != ERR_OK)) {
         conn->handle_rx_lwip_cb_error(p);
         return err;
@@ -683,7 +847,14 @@ err_t sockinfo_tcp::rx_lwip_cb_xlio_socket(void *arg, struct tcp_pcb *pcb, struc
 
     tcp_recved(pcb, p->tot_len, true);
 
-    if (conn->m_p_group->m_socket_rx_cb) {
+    poll_group *grp = conn->m_p_group;
+    if (unlikely(conn->m_conn_pool_state != CONN_POOL_NONE)) {
+        // Data on an idle pooled connection, the pool can't hand it out in a clean state.
+        pbuf_free(p);
+        grp->conn_pool_discard(conn);
+        return ERR_OK;
+    }
+    if (grp->m_socket_rx_batch_cb || grp->m_socket_rx_cb) {
         struct pbuf *ptmp = p;
 
         if (unlikely(conn->m_p_socket_stats)) {
@@ -701,9 +872,13 @@ err_t sockinfo_tcp::rx_lwip_cb_xlio_socket(void *arg, struct tcp_pcb *pcb, struc
                     conn->save_strq_stats(reinterpret_cast<mem_buf_desc_t *>(ptmp)->rx.strides_num);
                 }
             }
-            conn->m_p_group->m_socket_rx_cb(reinterpret_cast<xlio_socket_t>(conn),
-                                            conn->m_xlio_socket_userdata, ptmp->payload, ptmp->len,
-                                            mem_buf_desc_t::to_xlio_buf(ptmp));
+            if (grp->m_socket_rx_batch_cb) {
+                grp->add_rx_batch(conn, ptmp->payload, ptmp->len,
+                                  mem_buf_desc_t::to_xlio_buf(ptmp));
+            } else {
+                grp->rx_cb(conn, conn->m_xlio_socket_userdata, ptmp->payload, ptmp->len,
+                           mem_buf_desc_t::to_xlio_buf(ptmp));
+            }
             ptmp = ptmp->next;
         }
     } else {
@@ -751,6 +926,7 @@ err_t sockinfo_tcp::rx_lwip_cb_entity_context(void *arg, struct tcp_pcb *pcb, st
         conn->process_timestamps(buff);
 
         buff->p_next_desc = buff->p_prev_desc = nullptr;
+        conn->lat_hist_rx_queued(buff);
         conn->m_rx_pkt_ready_list.push_back(buff);
         conn->m_n_rx_pkt_ready_list_count++;
         conn->m_rx_ready_byte_count += ptmp->len;
@@ -765,7 +941,7 @@ err_t sockinfo_tcp::rx_lwip_cb_entity_context(void *arg, struct tcp_pcb *pcb, st
     io_mux_call::update_fd_array(conn->m_iomux_ready_fd_array, conn->m_fd);
 
     // Wakeup the APP thread that maybe sleeping on the socket.
-    conn->m_sock_wakeup_pipe.do_wakeup();
+    conn->m_sock_wakeup.do_wakeup();
 
     return ERR_OK;
 }
@@ -814,7 +990,9 @@ sockinfo_tcp::~sockinfo_tcp()
     si_tcp_logfunc("");
     g_global_stat_static.socket_tcp_destructor_counter.fetch_add(1, std::memory_order_relaxed);
 
+    g_pacing_wheel.cancel(this);
     lock_tcp_con();
+    sndbuf_autotune_release();
 
     if (!is_closable()) {
         /* Force closing TCP connection
@@ -823,7 +1001,7 @@ sockinfo_tcp::~sockinfo_tcp()
         prepare_to_close(true);
     }
 
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     if (m_ops_tcp != m_ops) {
         delete m_ops_tcp;
@@ -836,6 +1014,12 @@ sockinfo_tcp::~sockinfo_tcp()
         m_store = nullptr;
     }
 
+    for (auto &entry : m_syncookie_dst_lru) {
+        delete entry.second;
+    }
+    m_syncookie_dst_lru.clear();
+    m_syncookie_dst_map.clear();
+
     // Release unread RX buffers that may have been received before OR during TCP termination
     // handshake
     clear_rx_ready_buffers();
@@ -928,7 +1112,7 @@ void sockinfo_tcp::clean_socket_obj()
 
     event_handler_manager *p_event_mgr = get_event_mgr();
     bool delegated_timers_exit = g_b_exit &&
-        (safe_mce_sys().tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS);
+        (g_hot_sys_var.tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS);
 
     if (p_event_mgr->is_running() && !delegated_timers_exit) {
         p_event_mgr->unregister_socket_timer_and_delete(this);
@@ -942,6 +1126,7 @@ bool sockinfo_tcp::prepare_listen_to_close()
     // assume locked by sockinfo_tcp lock
 
     // remove the sockets from the accepted connections list
+    collect_accepted_conns(this);
     while (!m_accepted_conns.empty()) {
         sockinfo_tcp *new_sock = m_accepted_conns.get_and_pop_front();
         new_sock->m_sock_state = TCP_SOCK_INITED;
@@ -982,6 +1167,11 @@ bool sockinfo_tcp::prepare_to_close(bool process_shutdown /* = false */)
 
     lock_tcp_con();
 
+    // The ticks finish the closing and destroy the socket
+    if (m_pcb.tmr_parked) {
+        wake_timer();
+    }
+
     bool do_abort = safe_mce_sys().tcp_abort_on_close || m_n_rx_pkt_ready_list_count;
     bool is_listen_socket = is_server() || get_tcp_state(&m_pcb) == LISTEN;
 
@@ -1020,6 +1210,7 @@ bool sockinfo_tcp::prepare_to_close(bool process_shutdown /* = false */)
         enum tcp_state prev_state = get_tcp_state(&m_pcb);
 
         tcp_close(&m_pcb);
+        timewait_compact();
         if (unlikely(prev_state == CLOSED) && get_tcp_state(&m_pcb) == CLOSED && is_xlio_socket()) {
             /* Trigger XLIO_SOCKET_EVENT_TERMINATED if destroying already closed socket.
              * This can happen on a failed connect().
@@ -1030,6 +1221,7 @@ bool sockinfo_tcp::prepare_to_close(bool process_shutdown /* = false */)
         if (is_listen_socket) {
             tcp_accept(&m_pcb, nullptr);
             tcp_syn_handled(&m_pcb, nullptr);
+            tcp_syn_cookie(&m_pcb, nullptr);
             tcp_clone_conn(&m_pcb, nullptr);
             tcp_accepted_pcb(&m_pcb, nullptr);
             prepare_listen_to_close(); // close pending to accept sockets
@@ -1043,7 +1235,7 @@ bool sockinfo_tcp::prepare_to_close(bool process_shutdown /* = false */)
     }
 
     NOTIFY_ON_EVENTS(this, EPOLLHUP);
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     if (has_epoll_context()) {
         m_econtext->fd_closed(m_fd);
@@ -1136,11 +1328,88 @@ void sockinfo_tcp::tcp_timer()
     }
 
     tcp_tmr(&m_pcb);
+    timewait_compact();
+    publish_tcp_info();
+    tcp_limited_update(&m_pcb, 1);
+    publish_tcp_loss();
+
+    if (unlikely(m_pcb.flags & TF_CORK)) {
+        cork_timer();
+    }
+
+    if (m_snd_buf_max > m_snd_buf_base) {
+        // Give the growth back once the connection is idle for a second
+        if (m_pcb.unsent || m_pcb.unacked) {
+            m_snd_buf_idle_ticks = 0;
+        } else if (++m_snd_buf_idle_ticks * safe_mce_sys().tcp_timer_resolution_msec >=
+                   SNDBUF_AUTOTUNE_IDLE_MSEC) {
+            sndbuf_autotune_release();
+        }
+    }
 
     return_pending_rx_buffs();
     return_pending_tx_buffs();
 }
 
+void sockinfo_tcp::cork_timer()
+{
+    const uint32_t timeout = safe_mce_sys().tcp_cork_timeout_msec;
+
+    if (!m_pcb.unsent || !timeout) {
+        m_cork_ticks = 0U;
+        return;
+    }
+    if (++m_cork_ticks * safe_mce_sys().tcp_timer_resolution_msec >= timeout) {
+        // As Linux, the timeout ends a MSG_MORE and keeps TCP_CORK for the next data
+        m_cork_ticks = 0U;
+        m_pcb.flags &= ~TF_CORK;
+        tcp_output(&m_pcb);
+        tx_cork_update(0);
+    }
+}
+
+// The ticks also release the sndbuf growth and the pending buffers
+bool sockinfo_tcp::is_timer_idle()
+{
+    return m_state == SOCKINFO_OPENED && m_snd_buf_max <= m_snd_buf_base &&
+        !m_rx_reuse_buff.n_buff_num &&
+        (!m_p_connected_dst_entry || !m_p_connected_dst_entry->has_pending_tx_buffs()) &&
+        tcp_tmr_idle(&m_pcb);
+}
+
+void sockinfo_tcp::wake_timer()
+{
+    m_pcb.tmr_parked = 0;
+    get_tcp_timer_collection()->wake_timer(this);
+}
+
+// A parked timer is placed again with the new keepalive deadline
+void sockinfo_tcp::rearm_parked_timer()
+{
+    lock_tcp_con();
+    if (m_pcb.tmr_parked) {
+        wake_timer();
+    }
+    unlock_tcp_con();
+}
+
+void sockinfo_tcp::timewait_compact()
+{
+    // Only the closed outbound connections, the incoming ones are reused by the listener
+    if (!safe_mce_sys().tcp_timewait_compact || m_state != SOCKINFO_CLOSING || is_incoming() ||
+        get_tcp_state(&m_pcb) != TIME_WAIT) {
+        return;
+    }
+
+    flow_tuple key;
+    create_flow_tuple_key_from_pcb(key, &m_pcb);
+    g_tcp_timewait.add(key, m_pcb.snd_nxt, m_pcb.rcv_nxt);
+    si_tcp_logdbg("TIME_WAIT moved to a compact record %s", key.to_str().c_str());
+
+    tcp_pcb_purge(&m_pcb);
+    set_tcp_state(&m_pcb, CLOSED);
+}
+
 bool sockinfo_tcp::prepare_dst_to_send(bool is_accepted_socket /* = false */)
 {
     bool ret_val = false;
@@ -1155,6 +1424,13 @@ bool sockinfo_tcp::prepare_dst_to_send(bool is_accepted_socket /* = false */)
             m_pcb.tso.max_payload_sz = max_tso_sz;
             m_pcb.tso.max_header_sz = ring->get_max_header_sz();
             m_pcb.tso.max_send_sge = ring->get_max_send_sge();
+
+            // The ring may not get a hardware rate limit entry, pace in software then
+            if (m_so_ratelimit.rate && !m_pcb.is_paced &&
+                g_hot_sys_var.tx_sw_pacing == SW_PACING_FALLBACK &&
+                ring->modify_ratelimit(m_so_ratelimit) && !set_sw_pacing(m_so_ratelimit)) {
+                memset(&m_so_ratelimit, 0, sizeof(m_so_ratelimit));
+            }
         }
     }
     if (ret_val && m_p_group) {
@@ -1270,6 +1546,15 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
     err_t err;
     void *tx_ptr = nullptr;
 
+    if (unlikely(flags & MSG_FASTOPEN) && tx_arg.attr.addr && m_sock_state <= TCP_SOCK_BOUND &&
+        m_sock_offload == TCP_SOCK_LWIP) {
+        // Connect with the data in the SYN, the OS gets the call if the socket isn't offloaded
+        m_tfo_connect = (safe_mce_sys().tcp_fastopen & TCP_FASTOPEN_CLIENT_ENABLE);
+        if (connect(tx_arg.attr.addr, tx_arg.attr.len) < 0 && m_sock_offload == TCP_SOCK_LWIP) {
+            return -1;
+        }
+    }
+
     /* Let allow OS to process all invalid scenarios to avoid any
      * inconsistencies in setting errno values
      */
@@ -1283,6 +1568,8 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
 
     si_tcp_logfunc("tx: iov=%p niovs=%d", p_iov, sz_iov);
 
+    // The TSval and the RTT samples of the segments, a sending thread may not poll
+    coarse_clock_update();
     rx_poll_on_tx_if_needed();
 
     bool is_blocking = BLOCK_THIS_RUN(m_b_blocking, flags);
@@ -1292,6 +1579,9 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
     // 3. Non-blocking plain sendfile fallback.
     bool is_packet_zerocopy = (flags & MSG_ZEROCOPY) && (tx_arg.opcode == TX_FILE);
     if (unlikely(!is_packet_zerocopy) || unlikely(is_blocking)) {
+        if (unlikely(m_b_zerocopy && (flags & MSG_ZEROCOPY)) && tx_arg.opcode != TX_FILE) {
+            return tcp_tx_user_zerocopy(tx_arg, is_blocking);
+        }
         return tcp_tx_slow_path(tx_arg);
     }
 
@@ -1314,6 +1604,7 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
     if (TCP_WND_UNAVALABLE(m_pcb, total_iov_len)) {
         return tcp_tx_handle_errno_and_unlock(EAGAIN);
     }
+    tx_cork_update(flags);
 
     int total_tx = 0;
     for (size_t i = 0; i < sz_iov; i++) {
@@ -1327,8 +1618,13 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
         while (pos < p_iov[i].iov_len) {
             unsigned tx_size = sndbuf_available();
 
+            if (tx_size == 0 && m_snd_buf_autotune) {
+                sndbuf_autotune_grow();
+                tx_size = sndbuf_available();
+            }
             if (tx_size == 0) {
                 // force out TCP data before going on wait()
+                m_pcb.stats.sndbuf_full = 1;
                 tcp_output(&m_pcb);
                 return tcp_tx_handle_sndbuf_unavailable(total_tx, errno_tmp);
             }
@@ -1348,7 +1644,7 @@ ssize_t sockinfo_tcp::tcp_tx(xlio_tx_call_attr_t &tx_arg)
         }
     }
 
-    return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp);
+    return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp, &tx_arg);
 }
 
 ssize_t sockinfo_tcp::tcp_tx_thread(xlio_tx_call_attr_t &tx_arg)
@@ -1493,6 +1789,90 @@ void sockinfo_tcp::tx_thread_commit(mem_buf_desc_t *buf, uint32_t offset, uint32
     }
 }
 
+ssize_t sockinfo_tcp::tcp_tx_zcopy_thread(const iovec *iov, unsigned iovcnt, uint32_t mkey,
+                                          uintptr_t userdata)
+{
+    // See tcp_tx_thread() about the unprotected state access
+    if (!is_rts()) {
+        std::lock_guard<decltype(m_tcp_con_lock)> _lock(m_tcp_con_lock);
+        if (!is_connected_and_ready_to_send()) {
+            stats_update_tx_errors(errno);
+            return -1;
+        }
+    }
+
+    size_t bytes_to_send =
+        std::accumulate(&iov[0], &iov[iovcnt], 0U,
+                        [](size_t sum, const iovec &curr) { return sum + curr.iov_len; });
+    if (unlikely(!bytes_to_send || bytes_to_send > INT32_MAX)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // The operation completes as a whole, so it isn't split by the send buffer space
+    int32_t prev_sndbuf = m_snd_buf.fetch_sub(static_cast<int32_t>(bytes_to_send));
+    if (prev_sndbuf < static_cast<int32_t>(bytes_to_send)) {
+        m_snd_buf += static_cast<int32_t>(bytes_to_send);
+        stats_update_tx_errors(EAGAIN);
+        errno = EAGAIN;
+        return -1;
+    }
+
+    tx_zcopy_op *op = static_cast<tx_zcopy_op *>(malloc(sizeof(*op) + iovcnt * sizeof(iovec)));
+    if (unlikely(!op)) {
+        m_snd_buf += static_cast<int32_t>(bytes_to_send);
+        errno = ENOMEM;
+        return -1;
+    }
+    op->userdata = userdata;
+    op->mkey = mkey;
+    op->iovcnt = iovcnt;
+    op->iov = reinterpret_cast<iovec *>(op + 1);
+    memcpy(op->iov, iov, iovcnt * sizeof(iovec));
+
+    entity_context::job_desc job {entity_context::JOB_TYPE_SOCK_TX_ZCOPY, 0, this, nullptr, 0U,
+                                  static_cast<uint32_t>(bytes_to_send)};
+    job.zc_op = op;
+    m_entity_context->add_job(job);
+
+    return static_cast<ssize_t>(bytes_to_send);
+}
+
+void sockinfo_tcp::tx_zcopy_thread_commit(tx_zcopy_op *op)
+{
+    void *opaque = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(op) |
+                                            ENTITY_CONTEXT_ZCOPY_TAG);
+
+    int rc = tcp_tx_express(op->iov, op->iovcnt, op->mkey,
+                            XLIO_EXPRESS_OP_TYPE_DESC | XLIO_EXPRESS_MSG_MORE, opaque);
+    if (rc < 0) {
+        // Nothing references the application memory, report it back right away.
+        // See tx_thread_commit() about the socket state after a failure.
+        tx_zcopy_complete(op);
+    } else {
+        IF_STATS(m_p_socket_stats->n_tx_ready_byte_count += rc);
+    }
+}
+
+void sockinfo_tcp::tx_zcopy_complete(tx_zcopy_op *op)
+{
+    {
+        std::lock_guard<decltype(m_zc_completions_lock)> lock(m_zc_completions_lock);
+        m_zc_completions.push_back(op->userdata);
+    }
+    free(op);
+}
+
+unsigned sockinfo_tcp::tx_zcopy_poll_completions(uintptr_t *userdata, unsigned count)
+{
+    std::lock_guard<decltype(m_zc_completions_lock)> lock(m_zc_completions_lock);
+
+    unsigned num = std::min<size_t>(count, m_zc_completions.size());
+    std::copy_n(m_zc_completions.begin(), num, userdata);
+    m_zc_completions.erase(m_zc_completions.begin(), m_zc_completions.begin() + num);
+    return num;
+}
+
 /**
  * Handles transmission operations on a TCP socket similar to tcp_tx.
  * This is a fallback function when the operation is either blocking, not zero-copy, or the socket
@@ -1501,6 +1881,101 @@ void sockinfo_tcp::tx_thread_commit(mem_buf_desc_t *buf, uint32_t offset, uint32
  * @param tx_arg    The TCP transmission arguments and parameters.
  * @return          Returns the number of bytes transmitted, or -1 on error with the errno set.
  */
+/*
+ * send(MSG_ZEROCOPY) of a SO_ZEROCOPY socket, as Linux does. The segments refer to the user
+ * buffers, registered by the TX ring, and the send is reported by recvmsg(MSG_ERRQUEUE) when
+ * the last of its buffers is acknowledged and completed. A blocking send or a buffer which
+ * can't be registered is copied and reported with SO_EE_CODE_ZEROCOPY_COPIED right away.
+ */
+ssize_t sockinfo_tcp::tcp_tx_user_zerocopy(xlio_tx_call_attr_t &tx_arg, bool is_blocking)
+{
+    iovec *p_iov = tx_arg.attr.iov;
+    size_t sz_iov = tx_arg.attr.sz_iov;
+    int errno_tmp = errno;
+    ring *p_ring = get_tx_ring();
+    pbuf_desc mdesc;
+    ssize_t total_tx = 0;
+    size_t i;
+
+    if (is_blocking || !p_ring || m_sock_offload != TCP_SOCK_LWIP ||
+        is_invalid_iovec(p_iov, sz_iov)) {
+        goto copy;
+    }
+
+    lock_tcp_con();
+
+    if (unlikely(!is_connected_and_ready_to_send())) {
+        return tcp_tx_handle_errno_and_unlock(errno);
+    }
+    tx_cork_update(tx_arg.attr.flags);
+
+    memset(&mdesc, 0, sizeof(mdesc));
+    mdesc.attr = PBUF_DESC_EXPRESS;
+    for (i = 0; i < sz_iov; ++i) {
+        uint8_t *tx_ptr = reinterpret_cast<uint8_t *>(p_iov[i].iov_base);
+        size_t pos = 0;
+
+        if (unlikely(!tx_ptr || !p_iov[i].iov_len)) {
+            continue;
+        }
+        mdesc.mkey = p_ring->get_tx_user_lkey(tx_ptr, p_iov[i].iov_len);
+        if (unlikely(mdesc.mkey == LKEY_ERROR)) {
+            if (!total_tx) {
+                unlock_tcp_con();
+                goto copy;
+            }
+            break;
+        }
+
+        while (pos < p_iov[i].iov_len) {
+            unsigned tx_size = sndbuf_available();
+
+            if (tx_size == 0 && m_snd_buf_autotune) {
+                sndbuf_autotune_grow();
+                tx_size = sndbuf_available();
+            }
+            if (tx_size == 0) {
+                break;
+            }
+            tx_size = std::min<size_t>(p_iov[i].iov_len - pos, tx_size);
+
+            const struct iovec iov = {.iov_base = tx_ptr + pos, .iov_len = tx_size};
+            if (unlikely(tcp_write_express(&m_pcb, &iov, 1, &mdesc) != ERR_OK)) {
+                break;
+            }
+            pos += tx_size;
+            total_tx += tx_size;
+            m_snd_buf -= tx_size;
+        }
+        if (pos < p_iov[i].iov_len) {
+            break;
+        }
+    }
+
+    if (!total_tx) {
+        tcp_output(&m_pcb);
+        return tcp_tx_handle_sndbuf_unavailable(0, errno_tmp);
+    }
+
+    {
+        // The send completes with its last buffer, the segments aren't sent yet
+        struct pbuf *p = m_pcb.last_unsent->p;
+        while (p->next) {
+            p = p->next;
+        }
+        p->desc.opaque = reinterpret_cast<void *>(static_cast<uintptr_t>(zc_alloc_id()) + 1U);
+        __atomic_fetch_add(&m_zc_inflight, 1U, __ATOMIC_RELAXED);
+    }
+    return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp, &tx_arg);
+
+copy:
+    total_tx = tcp_tx_slow_path(tx_arg);
+    if (total_tx > 0) {
+        zc_notify(zc_alloc_id(), true);
+    }
+    return total_tx;
+}
+
 ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
 {
     iovec *p_iov = tx_arg.attr.iov;
@@ -1534,6 +2009,7 @@ ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
     if (unlikely(!is_connected_and_ready_to_send())) {
         return tcp_tx_handle_errno_and_unlock(errno);
     }
+    tx_cork_update(flags);
 
     int total_tx = 0;
     off64_t file_offset = 0;
@@ -1554,6 +2030,11 @@ ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
         while (pos < p_iov[i].iov_len) {
             auto tx_size = sndbuf_available();
 
+            if (tx_size == 0 && m_snd_buf_autotune) {
+                sndbuf_autotune_grow();
+                tx_size = sndbuf_available();
+            }
+
             /* Process a case when space is not available at the sending socket
              * to hold the message to be transmitted
              * Nonblocking socket:
@@ -1564,6 +2045,7 @@ ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
              */
             if (tx_size == 0) {
                 // force out TCP data before going on wait()
+                m_pcb.stats.sndbuf_full = 1;
                 tcp_output(&m_pcb);
 
                 // non blocking socket should return in order not to tx_wait()
@@ -1607,7 +2089,7 @@ ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
                     /* Set return values for nonblocking socket and finish processing */
                     if (!block_this_run) {
                         if (total_tx > 0) {
-                            return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp);
+                            return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp, &tx_arg);
                         } else {
                             return tcp_tx_handle_errno_and_unlock(EAGAIN);
                         }
@@ -1644,7 +2126,7 @@ ssize_t sockinfo_tcp::tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg)
         }
     }
 
-    return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp);
+    return tcp_tx_handle_done_and_unlock(total_tx, errno_tmp, &tx_arg);
 }
 
 static bool inspect_socket_error_state(const mem_buf_desc_t *mem_buf_desc, struct tcp_pcb *pcb)
@@ -1680,7 +2162,8 @@ err_t sockinfo_tcp::ip_output(struct pbuf *p, struct tcp_seg *seg, void *v_p_con
     tcp_iovec lwip_iovec[max_count];
     xlio_send_attr attr = {
         (xlio_wr_tx_packet_attr)(flags | (!!p_si_tcp->is_xlio_socket() * XLIO_TX_SKIP_POLL)),
-        p_si_tcp->m_pcb.mss, 0, nullptr};
+        p_si_tcp->m_pcb.mss, 0, nullptr, nullptr};
+    tx_ts_request ts_req;
     int count = 0;
 
     if (unlikely(flags & XLIO_TX_PACKET_REXMIT)) {
@@ -1694,6 +2177,11 @@ err_t sockinfo_tcp::ip_output(struct pbuf *p, struct tcp_seg *seg, void *v_p_con
     if (rc != 0) {
         return rc;
     }
+    p_si_tcp->lat_hist_tx_sent(seg, flags);
+    if (unlikely(!p_si_tcp->m_tx_ts_pending.empty()) &&
+        p_si_tcp->tx_ts_match(seg, flags, ts_req)) {
+        attr.ts = &ts_req;
+    }
 
     if (flags & TCP_WRITE_ZEROCOPY) {
         goto zc_fill_iov;
@@ -1757,6 +2245,9 @@ send_iov:
 
     if (unlikely(p_si_tcp->m_p_socket_stats && is_set(attr.flags, XLIO_TX_PACKET_REXMIT) && rc)) {
         p_si_tcp->m_p_socket_stats->counters.n_tx_retransmits++;
+        if (seg && (seg->sack_state & TF_SEG_SACK_REXMIT)) {
+            p_si_tcp->m_p_socket_stats->counters.n_tx_sack_retransmits++;
+        }
     }
 
     return (ret >= 0 ? ERR_OK : ERR_WOULDBLOCK);
@@ -1812,6 +2303,14 @@ void sockinfo_tcp::tcp_state_observer(void *pcb_container, enum tcp_state new_st
 {
     sockinfo_tcp *p_si_tcp = (sockinfo_tcp *)pcb_container;
     IF_STATS_O(p_si_tcp, p_si_tcp->m_p_socket_stats->tcp_state = new_state);
+    p_si_tcp->publish_tcp_info();
+    p_si_tcp->publish_tcp_loss();
+    if (new_state == ESTABLISHED && (p_si_tcp->m_pcb.flags & TF_ECN)) {
+        // ECN capable transport, the network may mark the packets instead of dropping them
+        p_si_tcp->m_pcb.tos = (p_si_tcp->m_pcb.tos & ~INET_ECN_MASK) | INET_ECN_ECT_0;
+        header_tos_updater du(p_si_tcp->m_pcb.tos);
+        p_si_tcp->update_header_field(&du);
+    }
     if (p_si_tcp->is_xlio_socket()) {
         if (new_state == CLOSE_WAIT) {
             p_si_tcp->xlio_socket_event(XLIO_SOCKET_EVENT_CLOSED, 0);
@@ -1866,16 +2365,149 @@ uint16_t sockinfo_tcp::get_route_mtu(struct tcp_pcb *pcb)
     return 0;
 }
 
-void sockinfo_tcp::err_lwip_cb(void *pcb_container, err_t err)
+uint16_t sockinfo_tcp::get_path_mtu(struct tcp_pcb *pcb)
 {
-    if (!pcb_container) {
-        return;
-    }
-
-    sockinfo_tcp *conn = (sockinfo_tcp *)pcb_container;
-    __log_dbg("[fd=%d] sock=%p lwip_pcb=%p err=%d", conn->m_fd, conn, &(conn->m_pcb), err);
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+    return tcp_sock->m_p_connected_dst_entry
+        ? static_cast<uint16_t>(tcp_sock->m_p_connected_dst_entry->get_path_mtu())
+        : 0U;
+}
 
-    if (get_tcp_state(&conn->m_pcb) == LISTEN && err == ERR_RST) {
+void sockinfo_tcp::set_path_mtu(struct tcp_pcb *pcb, uint16_t mtu)
+{
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+    tcp_sock->update_path_mtu(mtu);
+}
+
+void sockinfo_tcp::update_path_mtu(uint16_t mtu)
+{
+    if (m_p_connected_dst_entry) {
+        si_tcp_logdbg("Discovered path mtu %u", mtu);
+        m_p_connected_dst_entry->set_path_mtu(mtu);
+    }
+}
+
+u32_t sockinfo_tcp::tcp_pacing_budget(struct tcp_pcb *pcb)
+{
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+    tscval_t now;
+
+    gettimeoftsc(&now);
+    return static_cast<u32_t>(
+        std::min<uint64_t>(tcp_sock->m_pacing_bucket.get_tokens(now), UINT32_MAX));
+}
+
+void sockinfo_tcp::tcp_pacing_sent(struct tcp_pcb *pcb, u32_t sent)
+{
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+    token_bucket &bucket = tcp_sock->m_pacing_bucket;
+    tscval_t now;
+
+    bucket.consume(sent);
+    if (pcb->unsent) {
+        // Data is held back, wake up when the bucket covers the next segment
+        gettimeoftsc(&now);
+        if (bucket.get_tokens(now) < pcb->unsent->len) {
+            g_pacing_wheel.schedule(tcp_sock, now + bucket.tsc_until(pcb->unsent->len));
+        }
+    }
+}
+
+void sockinfo_tcp::tcp_pacing_rate(struct tcp_pcb *pcb, u64_t rate)
+{
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+
+    tcp_sock->set_cc_pacing_rate(rate);
+}
+
+void sockinfo_tcp::tcp_tmr_wake(struct tcp_pcb *pcb)
+{
+    sockinfo_tcp *tcp_sock = (sockinfo_tcp *)pcb->my_container;
+
+    tcp_sock->wake_timer();
+}
+
+bool sockinfo_tcp::handle_pacing_release()
+{
+    if (trylock_tcp_con()) {
+        return false;
+    }
+    if (m_pcb.is_paced) {
+        tcp_output(&m_pcb);
+    }
+    unlock_tcp_con();
+    return true;
+}
+
+int sockinfo_tcp::set_sw_pacing(const struct xlio_rate_limit_t &rate_limit)
+{
+    if (get_poll_group()) {
+        // The sockets of a group are progressed by the group owner only
+        si_tcp_logdbg("Software pacing is not supported for sockets of a poll group");
+        return -1;
+    }
+
+    m_sw_ratelimit = rate_limit;
+    if (!rate_limit.rate) {
+        m_pcb.is_paced = 0;
+        g_pacing_wheel.cancel(this);
+        return 0;
+    }
+
+    uint64_t rate = KB_TO_BYTE(static_cast<uint64_t>(rate_limit.rate));
+    uint64_t burst = rate_limit.max_burst_sz;
+    if (!burst) {
+        uint64_t pkt_sz = rate_limit.typical_pkt_sz ? rate_limit.typical_pkt_sz : ETH_DATA_LEN;
+        burst = std::max<uint64_t>(rate * SW_PACING_BATCH_USEC / 1000000U, 2U * pkt_sz);
+    }
+    m_pacing_bucket.set_rate(rate, burst);
+    m_pcb.is_paced = 1;
+
+    si_tcp_logdbg("Software pacing: %lu bytes/second, burst %lu bytes", rate, burst);
+    return 0;
+}
+
+void sockinfo_tcp::set_cc_pacing_rate(uint64_t rate)
+{
+    uint64_t user_rate = KB_TO_BYTE(static_cast<uint64_t>(m_sw_ratelimit.rate));
+
+    if (get_poll_group()) {
+        return;
+    }
+    if (!rate) {
+        // The congestion control stops pacing, the user rate limit applies alone
+        if (user_rate) {
+            set_sw_pacing(m_sw_ratelimit);
+        } else if (m_pcb.is_paced) {
+            m_pcb.is_paced = 0;
+            g_pacing_wheel.cancel(this);
+        }
+        return;
+    }
+
+    // The user rate limit caps the rate of the congestion control
+    if (user_rate) {
+        rate = std::min(rate, user_rate);
+    }
+    uint64_t burst = std::max<uint64_t>(rate * SW_PACING_BATCH_USEC / 1000000U, 2U * m_pcb.mss);
+    if (m_pcb.is_paced) {
+        m_pacing_bucket.update_rate(rate, burst);
+    } else {
+        m_pacing_bucket.set_rate(rate, burst);
+        m_pcb.is_paced = 1;
+    }
+}
+
+void sockinfo_tcp::err_lwip_cb(void *pcb_container, err_t err)
+{
+    if (!pcb_container) {
+        return;
+    }
+
+    sockinfo_tcp *conn = (sockinfo_tcp *)pcb_container;
+    __log_dbg("[fd=%d] sock=%p lwip_pcb=%p err=%d", conn->m_fd, conn, &(conn->m_pcb), err);
+
+    if (get_tcp_state(&conn->m_pcb) == LISTEN && err == ERR_RST) {
         vlog_printf(VLOG_ERROR, "listen socket should not receive RST\n");
         return;
     }
@@ -1929,7 +2561,7 @@ void sockinfo_tcp::err_lwip_cb(void *pcb_container, err_t err)
         conn->m_sock_state = TCP_SOCK_INITED;
     }
 
-    conn->m_sock_wakeup_pipe.do_wakeup();
+    conn->m_sock_wakeup.do_wakeup();
 }
 
 // Execute TCP timers of this connection
@@ -1939,6 +2571,13 @@ void sockinfo_tcp::handle_timer_expired()
     tcp_timer();
 }
 
+bool sockinfo_tcp::try_park_timer(uint32_t &keepalive_ticks)
+{
+    m_pcb.tmr_parked = is_timer_idle();
+    keepalive_ticks = m_pcb.tmr_parked ? tcp_keepalive_ticks(&m_pcb) : 0U;
+    return m_pcb.tmr_parked;
+}
+
 void sockinfo_tcp::abort_connection()
 {
     tcp_abort(&(m_pcb));
@@ -1962,7 +2601,7 @@ void sockinfo_tcp::handle_incoming_handshake_failure(sockinfo_tcp *child_conn)
 
     child_conn->lock_tcp_con();
 
-    if (safe_mce_sys().tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
+    if (g_hot_sys_var.tcp_ctl_thread != option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
         // Object destruction is expected to happen in internal thread. Unless XLIO is in late
         // terminating stage, in which case we don't expect to handle packets.
         // Calling close() under lock will prevent internal thread to delete the object before
@@ -1977,6 +2616,81 @@ void sockinfo_tcp::handle_incoming_handshake_failure(sockinfo_tcp *child_conn)
 }
 
 /*static*/
+// The send sample starts when the data is queued, not when it is transmitted
+inline void sockinfo_tcp::lat_hist_tx_queued()
+{
+    if (unlikely(m_p_lat_hists) && !m_lat_send_tsc && m_pcb.snd_lbb != m_pcb.lastack) {
+        gettimeoftsc(&m_lat_send_tsc);
+        m_lat_send_seqno = m_pcb.snd_lbb;
+    }
+}
+
+inline void sockinfo_tcp::lat_hist_tx_sent(const struct tcp_seg *seg, uint16_t flags)
+{
+    if (likely(!m_p_lat_hists)) {
+        return;
+    }
+    if (flags & XLIO_TX_PACKET_REXMIT) {
+        // The ACK of a retransmitted segment is ambiguous (Karn's algorithm)
+        m_lat_rtt_tsc = 0U;
+    } else if (!m_lat_rtt_tsc && seg && seg->len) {
+        gettimeoftsc(&m_lat_rtt_tsc);
+        m_lat_rtt_seqno = seg->seqno + seg->len;
+    }
+}
+
+// The key of a TCP send is the offset of its last byte, as Linux reports it
+void sockinfo_tcp::tx_ts_queued(uintptr_t userdata_op)
+{
+    if (m_pcb.snd_lbb != m_pcb.lastack) {
+        m_tx_ts_pending.push_back(
+            {m_pcb.snd_lbb, m_pcb.snd_lbb - m_tx_ts_next_key - 1U, userdata_op});
+    }
+}
+
+/*
+ * The segment of the last byte of a send reports its timestamp. If several sends end in the
+ * same segment, only the last one is reported. A retransmission doesn't report the sends.
+ */
+bool sockinfo_tcp::tx_ts_match(const struct tcp_seg *seg, uint16_t flags, tx_ts_request &req)
+{
+    bool found = false;
+
+    if (!seg || !seg->len || (flags & XLIO_TX_PACKET_REXMIT)) {
+        return false;
+    }
+    while (!m_tx_ts_pending.empty() &&
+           !TCP_SEQ_GT(m_tx_ts_pending.front().seqno, seg->seqno + seg->len)) {
+        const tx_ts_pending &pending = m_tx_ts_pending.front();
+        req = tx_ts_make_request(pending.key, pending.userdata_op);
+        m_tx_ts_pending.pop_front();
+        found = true;
+    }
+    return found;
+}
+
+void sockinfo_tcp::tx_ts_xlio_socket(uintptr_t userdata_op)
+{
+    std::lock_guard<decltype(m_tcp_con_lock)> lock(m_tcp_con_lock);
+    tx_ts_queued(userdata_op);
+}
+
+inline void sockinfo_tcp::lat_hist_acked(uint32_t lastack)
+{
+    ring *p_ring = m_p_connected_dst_entry ? m_p_connected_dst_entry->get_ring() : nullptr;
+    tscval_t now;
+
+    gettimeoftsc(&now);
+    if (m_lat_rtt_tsc && !TCP_SEQ_LT(lastack, m_lat_rtt_seqno)) {
+        lat_hist_record(&lat_hists_t::ack_rtt, p_ring, now - m_lat_rtt_tsc);
+        m_lat_rtt_tsc = 0U;
+    }
+    if (m_lat_send_tsc && !TCP_SEQ_LT(lastack, m_lat_send_seqno)) {
+        lat_hist_record(&lat_hists_t::tx_complete, p_ring, now - m_lat_send_tsc);
+        m_lat_send_tsc = 0U;
+    }
+}
+
 err_t sockinfo_tcp::ack_recvd_lwip_cb(void *arg, struct tcp_pcb *tpcb, u32_t acked)
 {
     sockinfo_tcp *conn = (sockinfo_tcp *)arg;
@@ -1989,13 +2703,21 @@ err_t sockinfo_tcp::ack_recvd_lwip_cb(void *arg, struct tcp_pcb *tpcb, u32_t ack
     ASSERT_LOCKED(conn->m_tcp_con_lock);
 
     IF_STATS_O(conn, conn->m_p_socket_stats->n_tx_ready_byte_count -= acked);
+    conn->publish_tcp_info();
+    if (unlikely(conn->m_p_lat_hists)) {
+        conn->lat_hist_acked(tpcb->lastack);
+    }
 
     conn->m_snd_buf += acked;
 
     if (conn->sndbuf_available()) {
+        conn->m_pcb.stats.sndbuf_full = 0;
         // This method can be called for closing socket. In this case there is no epoll context.
         NOTIFY_ON_EVENTS(conn, EPOLLOUT);
     }
+    if (unlikely(conn->m_tx_congested)) {
+        conn->tx_watermark_check_low();
+    }
     vlog_func_exit();
 
     return ERR_OK;
@@ -2008,7 +2730,7 @@ void sockinfo_tcp::tcp_shutdown_rx()
     NOTIFY_ON_EVENTS(this, EPOLLIN | EPOLLRDHUP);
 
     io_mux_call::update_fd_array(m_iomux_ready_fd_array, m_fd);
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     tcp_shutdown(&m_pcb, 1, 0);
 
@@ -2038,6 +2760,7 @@ err_t sockinfo_tcp::rx_lwip_cb(void *arg, struct tcp_pcb *pcb, struct pbuf *p, e
     vlog_func_enter();
 
     ASSERT_LOCKED(conn->m_tcp_con_lock);
+    XLIO_TRACE(tcp_rx, conn->m_fd, p ? p->tot_len : 0U, err);
 
     // if is FIN
     if (unlikely(!p)) {
@@ -2050,14 +2773,33 @@ err_t sockinfo_tcp::rx_lwip_cb(void *arg, struct tcp_pcb *pcb, struct pbuf *p, e
     }
 
     conn->rx_lwip_process_chained_pbufs(p);
-    conn->save_packet_info_in_ready_list(p);
+
+    if (unlikely(conn->m_rx_place.size) && conn->rx_place_packet(p)) {
+        return ERR_OK;
+    }
+
+    // p can be released by the compaction, keep its length for the accounting
+    const uint32_t tot_len = p->tot_len;
+    const uint32_t bufs_max = safe_mce_sys().rx_socket_bufs_max;
+    const uint32_t ready_bufs = static_cast<uint32_t>(conn->m_n_rx_pkt_ready_list_count);
+    bool over_budget = bufs_max && ready_bufs >= bufs_max;
+    // Small segments of a growing backlog share the last ready buffer
+    bool compact = over_budget ||
+        (safe_mce_sys().rx_compact_threshold && ready_bufs >= safe_mce_sys().rx_compact_threshold &&
+         tot_len <= safe_mce_sys().rx_compact_max_size);
+
+    if (compact && conn->rx_compact_into_tail(p)) {
+        over_budget = false;
+    } else {
+        conn->save_packet_info_in_ready_list(p);
+    }
 
     // notify io_mux
     NOTIFY_ON_EVENTS(conn, EPOLLIN);
     io_mux_call::update_fd_array(conn->m_iomux_ready_fd_array, conn->m_fd);
 
     // OLG: Now we should wakeup all threads that are sleeping on this socket.
-    conn->m_sock_wakeup_pipe.do_wakeup();
+    conn->m_sock_wakeup.do_wakeup();
 
     /*
      * RCVBUFF Accounting: tcp_recved here(stream into the 'internal' buffer) only if the user
@@ -2065,15 +2807,166 @@ err_t sockinfo_tcp::rx_lwip_cb(void *arg, struct tcp_pcb *pcb, struct pbuf *p, e
      */
     rcv_buffer_space = std::max(
         0, conn->m_rcvbuff_max - conn->m_rcvbuff_current - (int)conn->m_pcb.rcv_wnd_max_desired);
-    bytes_to_tcp_recved = std::min(rcv_buffer_space, (int)p->tot_len);
-    conn->m_rcvbuff_current += p->tot_len;
+    if (unlikely(over_budget)) {
+        // Out of the buffers budget, the window isn't reopened until the application reads
+        rcv_buffer_space = 0;
+        IF_STATS_O(conn, conn->m_p_socket_stats->counters.n_rx_budget_limited++);
+    }
+    bytes_to_tcp_recved = std::min(rcv_buffer_space, (int)tot_len);
+    conn->m_rcvbuff_current += tot_len;
 
-    conn->rx_lwip_shrink_rcv_wnd(p->tot_len, bytes_to_tcp_recved);
+    conn->rx_lwip_shrink_rcv_wnd(tot_len, bytes_to_tcp_recved);
 
     vlog_func_exit();
     return ERR_OK;
 }
 
+// Copies a single buffer packet to the free room of the last ready buffer and releases it.
+bool sockinfo_tcp::rx_compact_into_tail(pbuf *p)
+{
+    if (p->next || m_rx_pkt_ready_list.empty() || m_b_rcvtstamp || m_n_tsing_flags) {
+        return false;
+    }
+
+    mem_buf_desc_t *p_head = m_rx_pkt_ready_list.back();
+    mem_buf_desc_t *p_last = p_head;
+    while (p_last->p_next_desc) {
+        p_last = p_last->p_next_desc;
+    }
+
+    uint8_t *tail = reinterpret_cast<uint8_t *>(p_last->rx.frag.iov_base) + p_last->rx.frag.iov_len;
+    if (!p_last->p_buffer || tail + p->len > p_last->p_buffer + p_last->sz_buffer ||
+        p_last->rx.tls_type != reinterpret_cast<mem_buf_desc_t *>(p)->rx.tls_type) {
+        return false;
+    }
+
+    memcpy(tail, p->payload, p->len);
+    for (mem_buf_desc_t *p_desc = p_head; p_desc; p_desc = p_desc->p_next_desc) {
+        p_desc->lwip_pbuf.tot_len += p->len;
+    }
+    p_last->lwip_pbuf.len += p->len;
+    p_last->rx.frag.iov_len += p->len;
+    p_head->rx.sz_payload += p->len;
+    m_rx_ready_byte_count += p->len;
+    if (unlikely(m_p_socket_stats)) {
+        m_p_socket_stats->n_rx_ready_byte_count += p->len;
+        m_p_socket_stats->counters.n_rx_compacted++;
+    }
+
+    pbuf_free(p);
+    return true;
+}
+
+/*
+ * Starts the direct placement of a MSG_WAITALL read: the data already ready is copied first,
+ * and the receive window is opened to the size of the request. Called under the lock.
+ */
+bool sockinfo_tcp::rx_place_start(const iovec *p_iov, ssize_t sz_iov, size_t size, int in_flags)
+{
+    int out_flags = 0;
+
+    // The timestamps of the packets are returned with the front of the ready list
+    if (m_rx_place.size || m_b_rcvtstamp || m_n_tsing_flags) {
+        return false;
+    }
+
+    m_rx_place.iov.assign(p_iov, p_iov + sz_iov);
+    m_rx_place.iov_idx = 0U;
+    m_rx_place.size = size;
+    m_rx_place.placed = 0U;
+    m_rx_place.nt = size >= RX_PLACE_NT_MIN;
+    if (m_n_rx_pkt_ready_list_count) {
+        int total_rx = dequeue_packet(m_rx_place.iov.data(), sz_iov, nullptr, nullptr, in_flags,
+                                      &out_flags);
+        if (total_rx > 0) {
+            rx_consumed(total_rx);
+            rx_place_advance(total_rx);
+        }
+    }
+    fit_rcv_wnd(false);
+    return true;
+}
+
+void sockinfo_tcp::rx_place_advance(size_t len)
+{
+    m_rx_place.placed += len;
+    while (m_rx_place.iov_idx < m_rx_place.iov.size()) {
+        iovec &iov = m_rx_place.iov[m_rx_place.iov_idx];
+        size_t n = std::min(len, iov.iov_len);
+
+        iov.iov_base = static_cast<uint8_t *>(iov.iov_base) + n;
+        iov.iov_len -= n;
+        len -= n;
+        if (iov.iov_len) {
+            break;
+        }
+        ++m_rx_place.iov_idx;
+    }
+}
+
+/*
+ * Copies a segment to the pending MSG_WAITALL read instead of queuing it, the window isn't
+ * reduced since the data is consumed. The segment is queued if the ready list isn't empty,
+ * to keep the order, or if it doesn't fit, the reader then takes the rest from the ready list.
+ */
+bool sockinfo_tcp::rx_place_packet(pbuf *p)
+{
+    if (m_n_rx_pkt_ready_list_count || p->tot_len > m_rx_place.size - m_rx_place.placed) {
+        return false;
+    }
+#ifdef DEFINED_UTLS
+    if (reinterpret_cast<mem_buf_desc_t *>(p)->rx.tls_type) {
+        return false;
+    }
+#endif /* DEFINED_UTLS */
+
+    const uint32_t tot_len = p->tot_len;
+
+    for (pbuf *q = p; q; q = q->next) {
+        const uint8_t *src = static_cast<const uint8_t *>(q->payload);
+        size_t len = q->len;
+
+        while (len) {
+            const iovec &iov = m_rx_place.iov[m_rx_place.iov_idx];
+            size_t n = std::min(len, iov.iov_len);
+
+            if (m_rx_place.nt) {
+                memcpy_nt(iov.iov_base, src, n);
+            } else {
+                memcpy(iov.iov_base, src, n);
+            }
+            rx_place_advance(n);
+            src += n;
+            len -= n;
+        }
+    }
+    pbuf_free(p);
+
+    tcp_recved(&m_pcb, tot_len, true);
+    if (m_rcvbuff_autotune) {
+        rcvbuff_autotune(tot_len);
+    }
+    IF_STATS(m_p_socket_stats->counters.n_rx_placed++);
+
+    // The reader isn't woken before its request is complete
+    if (m_rx_place.placed == m_rx_place.size) {
+        m_sock_wakeup.do_wakeup();
+    }
+    return true;
+}
+
+// Returns the placed bytes, which the reader returns. Called under the lock.
+size_t sockinfo_tcp::rx_place_stop()
+{
+    size_t placed = m_rx_place.placed;
+
+    m_rx_place.size = m_rx_place.placed = 0U;
+    m_rx_place.iov.clear();
+    // The window closes gradually as the data arrives, see rx_lwip_shrink_rcv_wnd()
+    m_pcb.rcv_wnd_max_desired = rcv_wnd_desired();
+    return placed;
+}
+
 err_t sockinfo_tcp::handle_fin(struct tcp_pcb *pcb, err_t err)
 {
     if (is_server()) {
@@ -2094,7 +2987,7 @@ void sockinfo_tcp::handle_rx_lwip_cb_error(pbuf *p)
     // notify io_mux
     NOTIFY_ON_EVENTS(this, EPOLLERR);
 
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
     vlog_printf(VLOG_ERROR, "%s:%d %s\n", __func__, __LINE__, "recv error!!!");
     pbuf_free(p);
     m_sock_state = TCP_SOCK_INITED;
@@ -2163,6 +3056,7 @@ void sockinfo_tcp::update_ready_packets_stats(socket_stats_t *stats, uint64_t by
 
 inline void sockinfo_tcp::save_packet_info_in_ready_list(pbuf *p)
 {
+    lat_hist_rx_queued(reinterpret_cast<mem_buf_desc_t *>(p));
     m_rx_pkt_ready_list.push_back(reinterpret_cast<mem_buf_desc_t *>(p));
     m_n_rx_pkt_ready_list_count++;
     m_rx_ready_byte_count += p->tot_len;
@@ -2266,6 +3160,9 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
         save_stats_rx_os(ret);
         return ret;
     }
+    if (unlikely(*p_flags & MSG_ERRQUEUE)) {
+        return rx_errqueue(call_type, p_iov, sz_iov, p_flags, __from, __fromlen, __msg);
+    }
 
     // If the socket belongs to an entity_context read packets accordingly.
     if (m_entity_context) {
@@ -2274,8 +3171,8 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
 
     int errno_tmp = errno;
     int total_rx = 0;
+    int placed_rx = 0;
     int poll_count = 0;
-    int bytes_to_tcp_recved;
     size_t total_iov_sz = 0;
     int out_flags = 0;
     int in_flags = *p_flags;
@@ -2283,6 +3180,9 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
 
     m_loops_timer.start();
 
+    // The reading thread counts for the migration even when the data is ready without a poll
+    consider_rings_migration_rx();
+
     /* In general, without any special flags, socket options, or ioctls being set,
      * a recv call on a blocking TCP socket will return any number of bytes less than
      * or equal to the size being requested. But unless the socket is closed remotely,
@@ -2291,6 +3191,7 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
      * With MSG_ERRQUEUE flag user application can request just information from
      * error queue without any income data.
      */
+    bool place = false;
     if (p_iov && (sz_iov > 0)) {
         total_iov_sz = 1;
         if (unlikely((in_flags & MSG_WAITALL) && !(in_flags & MSG_PEEK))) {
@@ -2301,6 +3202,9 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
             if (total_iov_sz == 0) {
                 return 0;
             }
+            // A bulk read is filled by the RX path while it waits, see rx_place_packet()
+            place = block_this_run && safe_mce_sys().rx_waitall_placement_min &&
+                total_iov_sz >= safe_mce_sys().rx_waitall_placement_min;
         }
     }
 
@@ -2309,11 +3213,24 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
     /* poll rx queue till we have something */
     lock_tcp_con();
     return_reuse_buffers_postponed();
+    if (unlikely(place)) {
+        place = rx_place_start(p_iov, sz_iov, total_iov_sz, in_flags);
+    }
     unlock_tcp_con();
 
-    while (m_rx_ready_byte_count < total_iov_sz) {
+    while ((place ? m_rx_place.placed : 0U) + m_rx_ready_byte_count < total_iov_sz) {
         if (unlikely(g_b_exit || !is_rtr() || (m_skip_cq_poll_in_rx && (errno = EAGAIN)) ||
                      (rx_wait_lockless(poll_count, block_this_run) < 0))) {
+            if (unlikely(place)) {
+                lock_tcp_con();
+                total_rx = static_cast<int>(rx_place_stop());
+                unlock_tcp_con();
+                // The placed data is consumed, it's returned as a partial read
+                if (total_rx) {
+                    errno = errno_tmp;
+                    return total_rx;
+                }
+            }
             int ret = handle_rx_error(block_this_run);
             if (__msg && ret == 0) {
                 /* We don't return a control message in this case. */
@@ -2351,7 +3268,19 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
         }
 #endif /* DEFINED_UTLS */
 
-        total_rx = dequeue_packet(p_iov, sz_iov, __from, __fromlen, in_flags, &out_flags);
+        if (unlikely(place)) {
+            // The rest of the request is in the ready list, after the placed data
+            if (m_rx_place.placed < total_iov_sz) {
+                total_rx = dequeue_packet(&m_rx_place.iov[m_rx_place.iov_idx],
+                                          m_rx_place.iov.size() - m_rx_place.iov_idx, __from,
+                                          __fromlen, in_flags, &out_flags);
+            } else if (__from && __fromlen) {
+                m_connected.get_sa_by_family(__from, *__fromlen, m_family);
+            }
+            placed_rx = static_cast<int>(rx_place_stop());
+        } else {
+            total_rx = dequeue_packet(p_iov, sz_iov, __from, __fromlen, in_flags, &out_flags);
+        }
         if (total_rx < 0) {
             unlock_tcp_con();
             return total_rx;
@@ -2363,20 +3292,10 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
         handle_cmsg(__msg);
     }
 
-    /*
-     * RCVBUFF Accounting: Going 'out' of the internal buffer: if some bytes are not tcp_recved
-     * yet - do that. The packet might not be 'acked' (tcp_recved)
-     */
     if (!(in_flags & MSG_PEEK)) {
-        m_rcvbuff_current -= total_rx;
-
-        // data that was not tcp_recved should do it now.
-        if (m_rcvbuff_non_tcp_recved > 0) {
-            bytes_to_tcp_recved = std::min(m_rcvbuff_non_tcp_recved, total_rx);
-            tcp_recved(&m_pcb, bytes_to_tcp_recved, true);
-            m_rcvbuff_non_tcp_recved -= bytes_to_tcp_recved;
-        }
+        rx_consumed(total_rx);
     }
+    total_rx += placed_rx;
 
     unlock_tcp_con();
 
@@ -2388,6 +3307,103 @@ ssize_t sockinfo_tcp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
     return total_rx;
 }
 
+/*
+ * RCVBUFF Accounting: Going 'out' of the internal buffer: if some bytes are not tcp_recved
+ * yet - do that. The packet might not be 'acked' (tcp_recved)
+ */
+void sockinfo_tcp::rx_consumed(int total_rx)
+{
+    int bytes_to_tcp_recved;
+
+    m_rcvbuff_current -= total_rx;
+    if (m_rcvbuff_autotune) {
+        rcvbuff_autotune(total_rx);
+    }
+
+    // data that was not tcp_recved should do it now.
+    if (m_rcvbuff_non_tcp_recved > 0) {
+        bytes_to_tcp_recved = std::min(m_rcvbuff_non_tcp_recved, total_rx);
+        tcp_recved(&m_pcb, bytes_to_tcp_recved, true);
+        m_rcvbuff_non_tcp_recved -= bytes_to_tcp_recved;
+    }
+}
+
+int sockinfo_tcp::rx_zcopy(struct xlio_zcopy_buf *bufs, unsigned count, int flags)
+{
+    if (unlikely(m_sock_offload != TCP_SOCK_LWIP || m_entity_context)) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    int errno_tmp = errno;
+    int poll_count = 0;
+    bool block_this_run = BLOCK_THIS_RUN(m_b_blocking, flags);
+
+    m_loops_timer.start();
+
+    lock_tcp_con();
+    return_reuse_buffers_postponed();
+    unlock_tcp_con();
+
+    while (!m_rx_ready_byte_count) {
+        if (unlikely(g_b_exit || !is_rtr() || (m_skip_cq_poll_in_rx && (errno = EAGAIN)) ||
+                     (rx_wait_lockless(poll_count, block_this_run) < 0))) {
+            return handle_rx_error(block_this_run);
+        }
+    }
+
+    lock_tcp_con();
+
+    mem_buf_desc_t *pdesc = get_front_m_rx_pkt_ready_list();
+    int total_rx = 0;
+    unsigned i = 0;
+#ifdef DEFINED_UTLS
+    uint8_t tls_type = pdesc ? pdesc->rx.tls_type : 0U;
+#endif /* DEFINED_UTLS */
+
+    for (; i < count && pdesc; ++i) {
+#ifdef DEFINED_UTLS
+        if (unlikely(pdesc->rx.tls_type != tls_type)) {
+            break;
+        }
+#endif /* DEFINED_UTLS */
+        bufs[i].data = (uint8_t *)pdesc->rx.frag.iov_base + m_rx_pkt_ready_offset;
+        bufs[i].len = pdesc->rx.frag.iov_len - m_rx_pkt_ready_offset;
+        bufs[i].buf = pdesc->to_xlio_buf();
+        total_rx += bufs[i].len;
+        m_rx_pkt_ready_offset = 0;
+        if (m_b_rcvtstamp || m_n_tsing_flags) {
+            update_socket_timestamps(&pdesc->rx.timestamps);
+        }
+        // The chained buffers move to the front, the application owns this one
+        pop_ready_desc(pdesc);
+        pdesc = get_front_m_rx_pkt_ready_list();
+    }
+
+    IF_STATS(m_p_socket_stats->n_rx_ready_byte_count -= total_rx);
+    m_rx_ready_byte_count -= total_rx;
+    save_stats_rx_offload(total_rx);
+    rx_consumed(total_rx);
+
+    unlock_tcp_con();
+
+    si_tcp_logfunc("rx_zcopy completed, %d bytes in %u buffers", total_rx, i);
+
+    errno = errno_tmp;
+    return static_cast<int>(i);
+}
+
+void sockinfo_tcp::rx_zcopy_free(const struct xlio_zcopy_buf *bufs, unsigned count)
+{
+    lock_tcp_con();
+    for (unsigned i = 0; i < count; ++i) {
+        if (bufs[i].buf) {
+            reuse_buffer(mem_buf_desc_t::from_xlio_buf(bufs[i].buf));
+        }
+    }
+    unlock_tcp_con();
+}
+
 ssize_t sockinfo_tcp::rx_read_ready_packets(iovec *p_iov, ssize_t sz_iov, int *p_flags,
                                             sockaddr *__from, socklen_t *__fromlen,
                                             struct msghdr *__msg)
@@ -2562,7 +3578,9 @@ int sockinfo_tcp::rx_wait_for_data(int in_flags, struct msghdr *__msg, loops_tim
     // This conditions ensures that m_rx_pkt_ready_list.front() is not null later.
     if (m_rx_ready_byte_count < 1) {
         bool blocking = BLOCK_THIS_RUN(m_b_blocking, in_flags);
-        if ((!blocking && (errno = EAGAIN)) || (rx_sleep_wait(rcv_timeout) < 1)) {
+        int wait_ret = blocking ? rx_sleep_wait(rcv_timeout) : 0;
+        rx_wait_end();
+        if ((!blocking && (errno = EAGAIN)) || (wait_ret < 1)) {
             int ret = handle_rx_error(blocking);
             if (__msg && ret == 0) {
                 /* We don't return a control message in this case. */
@@ -2581,8 +3599,7 @@ int sockinfo_tcp::rx_sleep_wait(loops_timer &rcv_timeout)
     __log_info_func("");
     int32_t busy_loop_count = 0;
 
-    while (m_rx_ready_byte_count < 1 &&
-           (busy_loop_count < safe_mce_sys().rx_poll_num || safe_mce_sys().rx_poll_num == -1)) {
+    while (m_rx_ready_byte_count < 1 && rx_poll_budget_left(busy_loop_count)) {
         if (unlikely(g_b_exit || !is_rtr())) {
             return -1;
         }
@@ -2592,8 +3609,8 @@ int sockinfo_tcp::rx_sleep_wait(loops_timer &rcv_timeout)
             return -1;
         }
 
-        if (safe_mce_sys().rx_poll_yield_loops > 0 &&
-            static_cast<uint32_t>(busy_loop_count) > safe_mce_sys().rx_poll_yield_loops) {
+        if (g_hot_sys_var.rx_poll_yield_loops > 0 && !m_prefer_busy_poll &&
+            static_cast<uint32_t>(busy_loop_count) > g_hot_sys_var.rx_poll_yield_loops) {
             std::this_thread::yield();
         }
 
@@ -2615,7 +3632,7 @@ int sockinfo_tcp::rx_sleep_wait(loops_timer &rcv_timeout)
     // Check if we have a packet in receive queue before we going to sleep and
     // update is_sleeping flag under the same lock to synchronize between
     // this code and wakeup mechanism.
-    m_sock_wakeup_pipe.going_to_sleep();
+    m_sock_wakeup.going_to_sleep();
     unlock_tcp_con();
 
     epoll_event rx_epfd_events[SI_RX_EPFD_EVENT_MAX];
@@ -2623,7 +3640,7 @@ int sockinfo_tcp::rx_sleep_wait(loops_timer &rcv_timeout)
                       rcv_timeout.time_left_msec());
 
     lock_tcp_con();
-    m_sock_wakeup_pipe.return_from_sleep();
+    m_sock_wakeup.return_from_sleep();
     unlock_tcp_con();
 
     if (ret <= 0) {
@@ -2632,9 +3649,9 @@ int sockinfo_tcp::rx_sleep_wait(loops_timer &rcv_timeout)
 
     // Remove wakeup fd only if its found to save syscalls.
     for (int event_idx = 0; event_idx < ret; event_idx++) {
-        if (m_sock_wakeup_pipe.is_wakeup_fd(rx_epfd_events[event_idx].data.fd)) { // Wakeup event
+        if (m_sock_wakeup.is_wakeup_fd(rx_epfd_events[event_idx].data.fd)) { // Wakeup event
             lock_tcp_con();
-            m_sock_wakeup_pipe.remove_wakeup_fd();
+            m_sock_wakeup.remove_wakeup_fd();
             unlock_tcp_con();
             break;
         }
@@ -2661,7 +3678,8 @@ void sockinfo_tcp::register_timer()
                       this, get_tcp_timer_collection(), g_tcp_timers_collection);
 
         set_timer_registered(true);
-        get_event_mgr()->register_socket_timer_event(this);
+        m_p_timer_event_mgr = get_event_mgr();
+        m_p_timer_event_mgr->register_socket_timer_event(this);
     }
 }
 
@@ -2694,7 +3712,10 @@ bool sockinfo_tcp::rx_input_cb(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info, void
             pcb = &m_pcb;
 
             // Check established backlog
-            if (m_syn_received.size() >= (size_t)m_backlog &&
+            bool backlog_full = m_syn_received.size() >= (size_t)m_backlog;
+            // SYN cookies keep no state for the connections beyond the backlog
+            m_pcb.syncookies = backlog_full && m_pcb.syn_cookie_cb;
+            if (backlog_full && !m_pcb.syncookies &&
                 p_rx_pkt_mem_buf_desc_info->rx.tcp.p_tcp_h->syn) {
                 // TODO: consider check if we can now drain into Q of established
                 si_tcp_logdbg("SYN/CTL packet drop. established-backlog=%d (limit=%d)",
@@ -2712,10 +3733,23 @@ bool sockinfo_tcp::rx_input_cb(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info, void
 
     sockinfo_tcp *sock = (sockinfo_tcp *)pcb->my_container;
     if (sock == this) {
+        ring_slave *p_ring = p_rx_pkt_mem_buf_desc_info->p_desc_owner;
+
         L3_level_tcp_input((pbuf *)p_rx_pkt_mem_buf_desc_info, pcb);
+        // A single cumulative ACK is sent for the segments of this poll
+        if ((m_pcb.flags & TF_ACK_COALESCE) && !m_ack_coalesce_pending) {
+            m_ack_coalesce_pending = true;
+            p_ring->add_pending_ack(this);
+        }
+        if (unlikely(m_pcb.tmr_parked) && !is_timer_idle()) {
+            wake_timer();
+        }
     } else {
         sock->m_tcp_con_lock.lock();
         L3_level_tcp_input((pbuf *)p_rx_pkt_mem_buf_desc_info, pcb);
+        if (unlikely(sock->m_pcb.tmr_parked) && !sock->is_timer_idle()) {
+            sock->wake_timer();
+        }
         sock->m_tcp_con_lock.unlock();
     }
 
@@ -2725,6 +3759,16 @@ bool sockinfo_tcp::rx_input_cb(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info, void
     return true;
 }
 
+void sockinfo_tcp::flush_coalesced_ack()
+{
+    lock_tcp_con();
+    m_ack_coalesce_pending = false;
+    if ((m_pcb.flags & TF_ACK_COALESCE) && PCB_IN_ACTIVE_STATE(&m_pcb)) {
+        tcp_output(&m_pcb);
+    }
+    unlock_tcp_con();
+}
+
 void sockinfo_tcp::passthrough_unlock(const char *dbg)
 {
     setPassthrough();
@@ -2741,6 +3785,8 @@ int sockinfo_tcp::connect(const sockaddr *__to, socklen_t __tolen)
 {
     std::lock_guard<decltype(m_tcp_con_lock)> lock(m_tcp_con_lock);
 
+    coarse_clock_update(); // The SYN timestamp
+
     /* Connection was closed by RST, timeout, ICMP error
      * or another process disconnected us.
      * Socket should be recreated.
@@ -2805,7 +3851,7 @@ int sockinfo_tcp::connect(const sockaddr *__to, socklen_t __tolen)
         return -1;
     }
 
-    if (safe_mce_sys().is_threads_mode()) {
+    if (g_hot_sys_var.is_threads_mode()) {
         // For Threads mode need to do partial preparation and the rest will be done by the Thread.
         connect_threads_mode();
         return -1; // Currently no blocking socket support.
@@ -2833,6 +3879,14 @@ int sockinfo_tcp::connect(const sockaddr *__to, socklen_t __tolen)
     report_connected = true;
 
     const ip_address &ip = m_connected.get_ip_addr();
+    if (m_tfo_connect) {
+        // The SYN carries the first data if a cookie of the server is known, otherwise
+        // it requests a cookie for the next connections.
+        m_pcb.fastopen |= TCP_TFO_OPT;
+        if (tfo_cookie_get(ip, &m_pcb)) {
+            m_pcb.fastopen |= TCP_TFO_DATA;
+        }
+    }
     int err =
         tcp_connect(&m_pcb, reinterpret_cast<const ip_addr_t *>(&ip),
                     ntohs(m_connected.get_in_port()), m_pcb.is_ipv6, sockinfo_tcp::connect_lwip_cb);
@@ -2851,6 +3905,13 @@ int sockinfo_tcp::connect(const sockaddr *__to, socklen_t __tolen)
     // rexmits.
     register_timer();
 
+    if (m_pcb.fastopen & TCP_TFO_DATA) {
+        // Writable before the handshake, the SYN is sent with the first data.
+        m_sock_state = TCP_SOCK_CONNECTED_RDWR;
+        setPassthrough(false);
+        return 0;
+    }
+
     if (!m_b_blocking) {
         connect_async_set_errs();
         return -1;
@@ -2916,6 +3977,15 @@ bool sockinfo_tcp::connect_bind_any_and_check_rules()
         }
     }
 
+    // The 4-tuple of a compacted TIME_WAIT connection continues its sequence space
+    uint32_t snd_nxt, rcv_nxt;
+    flow_tuple key(m_bound.get_ip_addr(), m_bound.get_in_port(), m_connected.get_ip_addr(),
+                   m_connected.get_in_port(), PROTO_TCP, m_pcb.is_ipv6 ? AF_INET6 : AF_INET);
+    if (g_tcp_timewait.take(key, snd_nxt, rcv_nxt)) {
+        tcp_pcb_set_iss(&m_pcb, snd_nxt + TCP_TIMEWAIT_ISS_GAP);
+        m_pcb.flags |= TF_ISS_SET;
+    }
+
     m_conn_state = TCP_CONN_CONNECTING;
     return true;
 }
@@ -3244,6 +4314,8 @@ int sockinfo_tcp::listen(int backlog)
 
     tcp_accept(&m_pcb, sockinfo_tcp::accept_lwip_cb);
     tcp_syn_handled(&m_pcb, sockinfo_tcp::syn_received_lwip_cb);
+    tcp_syn_cookie(&m_pcb,
+                   safe_mce_sys().tcp_syncookies ? sockinfo_tcp::syn_cookie_lwip_cb : nullptr);
     tcp_clone_conn(&m_pcb, sockinfo_tcp::clone_conn_cb);
     tcp_accepted_pcb(&m_pcb, sockinfo_tcp::accepted_pcb_cb);
 
@@ -3319,7 +4391,7 @@ int sockinfo_tcp::accept_helper(struct sockaddr *__addr, socklen_t *__addrlen,
 {
     sockinfo_tcp *ns;
     // todo do one CQ poll and go to sleep even if infinite polling was set
-    int poll_count = safe_mce_sys().rx_poll_num; // do one poll and go to sleep (if blocking)
+    int poll_count = m_rx_poll_num; // do one poll and go to sleep (if blocking)
     int ret;
 
     si_tcp_logfuncall("");
@@ -3347,7 +4419,7 @@ int sockinfo_tcp::accept_helper(struct sockaddr *__addr, socklen_t *__addrlen,
     lock_tcp_con();
 
     si_tcp_logdbg("sock state = %d", get_tcp_state(&m_pcb));
-    while (m_ready_conn_cnt == 0 && !g_b_exit) {
+    while (!m_ready_conn_cnt && !collect_accepted_conns(this) && !g_b_exit) {
         if (m_sock_state != TCP_SOCK_ACCEPT_READY) {
             unlock_tcp_con();
             errno = EINVAL;
@@ -3486,18 +4558,22 @@ sockinfo_tcp *sockinfo_tcp::accept_clone()
     // Clone is always called first when a SYN packet received by a listen socket.
     IF_STATS(m_p_socket_stats->listen_counters.n_rx_syn++);
 
-    // Create the socket object. We skip shadow sockets for incoming connections.
-    fd = socket_internal(m_family, SOCK_STREAM, 0, false, false);
-    if (fd < 0) {
-        IF_STATS(m_p_socket_stats->listen_counters.n_conn_dropped++);
-        return nullptr;
-    }
+    // Take a pre-constructed object to keep the allocation out of the handshake path.
+    si = is_xlio_socket() ? m_p_group->get_accept_socket(m_family) : nullptr;
+    if (!si) {
+        // Create the socket object. We skip shadow sockets for incoming connections.
+        fd = socket_internal(m_family, SOCK_STREAM, 0, false, false);
+        if (fd < 0) {
+            IF_STATS(m_p_socket_stats->listen_counters.n_conn_dropped++);
+            return nullptr;
+        }
 
-    si = dynamic_cast<sockinfo_tcp *>(fd_collection_get_sockfd(fd));
-    if (!si) {
-        si_tcp_logwarn("Can not get accept socket from FD collection");
-        XLIO_CALL(close, fd);
-        return nullptr;
+        si = dynamic_cast<sockinfo_tcp *>(fd_collection_get_sockfd(fd));
+        if (!si) {
+            si_tcp_logwarn("Can not get accept socket from FD collection");
+            XLIO_CALL(close, fd);
+            return nullptr;
+        }
     }
 
     if (is_xlio_socket()) {
@@ -3519,6 +4595,8 @@ sockinfo_tcp *sockinfo_tcp::accept_clone()
 
     si->m_parent = this;
     si->m_b_incoming = true;
+    // A connection of a high priority listener, e.g. a control port, keeps the priority
+    si->m_is_xlio_socket_high_prio = m_is_xlio_socket_high_prio;
 
     si->m_sock_state = TCP_SOCK_BOUND;
     si->setPassthrough(false);
@@ -3530,6 +4608,16 @@ sockinfo_tcp *sockinfo_tcp::accept_clone()
     if (si->m_ring_alloc_log_tx != m_ring_alloc_log_tx) {
         si->set_ring_logic_tx(m_ring_alloc_log_tx);
     }
+    // The flow rule of the connection steers it to the ring of one of the group RX queues
+    if (is_xlio_socket() && m_p_group->get_rx_queues() > 1U) {
+        uint64_t queue_key = m_p_group->next_rx_queue_key();
+        ring_alloc_logic_attr key(m_ring_alloc_log_rx);
+        key.set_user_id_key(queue_key);
+        si->set_ring_logic_rx(key);
+        key = m_ring_alloc_log_tx;
+        key.set_user_id_key(queue_key);
+        si->set_ring_logic_tx(key);
+    }
 
     // listen flow for incoming socket
     if (m_entity_context) {
@@ -3589,6 +4677,10 @@ bool sockinfo_tcp::create_listen_rss_children()
         if (rss_child->m_p_socket_stats) {
             rss_child->m_p_socket_stats->set_bound_if(rss_child->m_bound);
             rss_child->m_p_socket_stats->bound_port = rss_child->m_bound.get_in_port();
+            rss_child->m_p_socket_stats->listen_parent_fd = m_fd;
+            rss_child->m_p_socket_stats->listen_child_index = static_cast<uint16_t>(i);
+            rss_child->m_p_socket_stats->listen_buckets = static_cast<uint16_t>(
+                entity_context_manager::calculate_listen_child_buckets(static_cast<int>(i)));
         }
         rss_child->m_sock_state = TCP_SOCK_BOUND;
 
@@ -3604,6 +4696,9 @@ bool sockinfo_tcp::create_listen_rss_children()
         // Set up TCP callbacks - accept, syn_handled, clone_conn, accepted_pcb
         tcp_accept(&rss_child->m_pcb, sockinfo_tcp::accept_lwip_cb);
         tcp_syn_handled(&rss_child->m_pcb, sockinfo_tcp::syn_received_lwip_cb);
+        tcp_syn_cookie(&rss_child->m_pcb,
+                       safe_mce_sys().tcp_syncookies ? sockinfo_tcp::syn_cookie_lwip_cb : nullptr);
+        rss_child->m_pcb.fastopen = m_pcb.fastopen & TCP_TFO_SERVER;
         tcp_clone_conn(&rss_child->m_pcb, sockinfo_tcp::clone_conn_cb);
         tcp_accepted_pcb(&rss_child->m_pcb, sockinfo_tcp::accepted_pcb_cb);
 
@@ -3646,8 +4741,13 @@ bool sockinfo_tcp::wait_for_listen_rss_children_ready()
 void sockinfo_tcp::accept_connection_xlio_socket(sockinfo_tcp *new_sock)
 {
     remove_received_syn_socket(new_sock);
-    m_p_group->m_socket_accept_cb(reinterpret_cast<xlio_socket_t>(new_sock),
-                                  reinterpret_cast<xlio_socket_t>(this), m_xlio_socket_userdata);
+    if (m_p_group->m_socket_accept_batch_cb) {
+        m_p_group->add_accept_batch(new_sock, this);
+    } else {
+        m_p_group->m_socket_accept_cb(reinterpret_cast<xlio_socket_t>(new_sock),
+                                      reinterpret_cast<xlio_socket_t>(this),
+                                      m_xlio_socket_userdata);
+    }
 }
 
 void sockinfo_tcp::remove_received_syn_socket(sockinfo_tcp *accepted)
@@ -3745,32 +4845,39 @@ err_t sockinfo_tcp::accept_lwip_cb(void *arg, struct tcp_pcb *child_pcb, err_t e
 
     new_sock->unlock_tcp_con();
 
-    conn->lock_tcp_con();
-
     if (conn->is_xlio_socket()) {
+        conn->lock_tcp_con();
         conn->accept_connection_xlio_socket(new_sock);
-    } else {
-        conn->m_accepted_conns.push_back(new_sock);
-        conn->m_ready_conn_cnt++;
+        if (conn->m_p_socket_stats) {
+            conn->m_p_socket_stats->listen_counters.n_conn_established++;
+            conn->m_p_socket_stats->listen_counters.n_conn_backlog++;
+        }
+        conn->unlock_tcp_con();
+        new_sock->lock_tcp_con();
+        return ERR_OK;
+    }
+
+    if (conn->is_sockinfo_tcp_listen_rss_child()) {
+        conn->lock_tcp_con();
+        conn->remove_received_syn_socket(new_sock);
+        conn->unlock_tcp_con();
+    }
+
+    /* The acceptor collects the queue under its own lock. Only the first connection of an empty
+     * queue notifies, the lock orders the wakeup with an acceptor going to sleep.
+     */
+    if (conn->m_accept_queue.push(new_sock)) {
+        conn->lock_tcp_con();
         if (conn->is_sockinfo_tcp_listen_rss_child()) {
-            conn->remove_received_syn_socket(new_sock);
             NOTIFY_ON_EVENTS(conn->m_listen_ctx->get_parent_listen_socket(), EPOLLIN);
         } else {
             NOTIFY_ON_EVENTS(conn, EPOLLIN);
         }
+        // Now we should wakeup all threads that are sleeping on this socket.
+        conn->m_sock_wakeup.do_wakeup();
+        conn->unlock_tcp_con();
     }
 
-    if (conn->m_p_socket_stats) {
-        conn->m_p_socket_stats->listen_counters.n_conn_established++;
-        conn->m_p_socket_stats->listen_counters.n_conn_backlog++;
-    }
-
-    // Now we should wakeup all threads that are sleeping on this socket.
-    conn->m_sock_wakeup_pipe.do_wakeup();
-    // Now we should register the child socket to TCP timer
-
-    conn->unlock_tcp_con();
-
     new_sock->lock_tcp_con();
 
     return ERR_OK;
@@ -3907,10 +5014,13 @@ err_t sockinfo_tcp::syn_received_timewait_cb(void *arg, struct tcp_pcb *newpcb)
     tcp_err(&new_sock->m_pcb, sockinfo_tcp::err_lwip_cb);
     tcp_acked(&new_sock->m_pcb, sockinfo_tcp::ack_recvd_lwip_cb);
     new_sock->m_pcb.syn_tw_handled_cb = nullptr;
-    new_sock->m_sock_wakeup_pipe.wakeup_clear();
+    new_sock->m_sock_wakeup.wakeup_clear();
     new_sock->m_snd_buf_max = safe_mce_sys().tcp_send_buffer_size;
     new_sock->m_snd_buf = new_sock->m_snd_buf_max;
+    new_sock->m_snd_buf_base = new_sock->m_snd_buf_max;
     new_sock->m_rcvbuff_max = std::max(listen_sock->m_rcvbuff_max, 2 * new_sock->m_pcb.mss);
+    new_sock->m_rcvbuff_autotune = listen_sock->m_rcvbuff_autotune;
+    new_sock->m_rcvbuff_initial = new_sock->m_rcvbuff_max;
     new_sock->fit_rcv_wnd(true);
 
     new_sock->register_timer();
@@ -3951,6 +5061,8 @@ err_t sockinfo_tcp::syn_received_lwip_cb(void *arg, struct tcp_pcb *newpcb)
     new_sock->set_conn_properties_from_pcb();
 
     new_sock->m_rcvbuff_max = std::max(listen_sock->m_rcvbuff_max, 2 * new_sock->m_pcb.mss);
+    new_sock->m_rcvbuff_autotune = listen_sock->m_rcvbuff_autotune;
+    new_sock->m_rcvbuff_initial = new_sock->m_rcvbuff_max;
     new_sock->fit_rcv_wnd(true);
 
     listen_sock->set_sock_options(new_sock);
@@ -3990,6 +5102,96 @@ err_t sockinfo_tcp::syn_received_lwip_cb(void *arg, struct tcp_pcb *newpcb)
 
     listen_sock->m_syn_received[key] = newpcb;
 
+    if (newpcb->syncookies) {
+        IF_STATS_O(listen_sock,
+                   listen_sock->m_p_socket_stats->listen_counters.n_syncookies_validated++);
+    }
+
+    return ERR_OK;
+}
+
+// Destinations kept for the SYN cookie <SYN,ACK>s of a listen socket
+#define SYNCOOKIE_DST_CACHE_SIZE 64U
+
+dst_entry_tcp *sockinfo_tcp::get_syncookie_dst(const struct tcp_syncookie_req *req)
+{
+    sa_family_t family = req->is_ipv6 ? AF_INET6 : AF_INET;
+    const ip_address &local_ip = reinterpret_cast<const ip_address &>(req->local_ip);
+    const ip_address &remote_ip = reinterpret_cast<const ip_address &>(req->remote_ip);
+    // The TCP header is built per SYN, so the ports are not part of the destination
+    flow_tuple key(remote_ip, 0, local_ip, 0, PROTO_TCP, family);
+
+    auto iter = m_syncookie_dst_map.find(key);
+    if (iter != m_syncookie_dst_map.end()) {
+        m_syncookie_dst_lru.splice(m_syncookie_dst_lru.end(), m_syncookie_dst_lru, iter->second);
+        return iter->second->second;
+    }
+
+    socket_data data = {m_fd, m_n_uc_ttl_hop_lim, m_pcb.tos, m_pcp};
+    sock_addr remote(family, &remote_ip, htons(req->remote_port));
+    dst_entry_tcp *p_dst =
+        new dst_entry_tcp(remote, htons(req->local_port), data, m_ring_alloc_log_tx);
+
+    p_dst->set_bound_addr(local_ip);
+    if (!m_so_bindtodevice_ip.is_anyaddr()) {
+        p_dst->set_so_bindtodevice_addr(m_so_bindtodevice_ip);
+    }
+    p_dst->set_src_sel_prefs(m_src_sel_flags);
+    p_dst->set_external_vlan_tag(m_external_vlan_tag);
+    // True for passive socket to skip the transport rules checking
+    if (!p_dst->prepare_to_send(m_so_ratelimit, true)) {
+        delete p_dst;
+        return nullptr;
+    }
+
+    m_syncookie_dst_map[key] = m_syncookie_dst_lru.emplace(m_syncookie_dst_lru.end(), key, p_dst);
+    if (m_syncookie_dst_lru.size() > SYNCOOKIE_DST_CACHE_SIZE) {
+        m_syncookie_dst_map.erase(m_syncookie_dst_lru.front().first);
+        delete m_syncookie_dst_lru.front().second;
+        m_syncookie_dst_lru.pop_front();
+    }
+    return p_dst;
+}
+
+err_t sockinfo_tcp::syn_cookie_lwip_cb(void *arg, struct tcp_pcb *pcb,
+                                       const struct tcp_syncookie_req *req)
+{
+    sockinfo_tcp *listen_sock = (sockinfo_tcp *)((arg));
+
+    if (!listen_sock || !pcb || !req) {
+        return ERR_VAL;
+    }
+
+    ASSERT_LOCKED(listen_sock->m_tcp_con_lock);
+
+    // The connection is encoded in the ISN, no socket exists until the ACK validates it.
+    dst_entry_tcp *p_dst = listen_sock->get_syncookie_dst(req);
+    if (!p_dst) {
+        return ERR_RTE;
+    }
+    mem_buf_desc_t *p_desc = p_dst->get_buffer(PBUF_RAM, nullptr);
+    if (!p_desc) {
+        return ERR_MEM;
+    }
+
+    // The buffer payload follows the space of the TCP header
+    uint8_t *tcphdr = (uint8_t *)p_desc->lwip_pbuf.payload - TCP_HLEN;
+    tcp_iovec iov = {};
+    iov.iovec.iov_base = tcphdr;
+    iov.iovec.iov_len = tcp_syncookie_synack(req, p_dst->get_route_mtu(), tcphdr);
+    iov.p_desc = p_desc;
+    p_desc->lwip_pbuf.ref = 1;
+    xlio_send_attr attr = {(xlio_wr_tx_packet_attr)0, 0, iov.iovec.iov_len, nullptr, nullptr};
+
+    ssize_t ret = likely(p_dst->is_valid())
+        ? p_dst->fast_send((struct iovec *)&iov, 1, attr)
+        : p_dst->slow_send((struct iovec *)&iov, 1, attr, listen_sock->m_so_ratelimit);
+    p_dst->put_buffer(p_desc);
+
+    if (ret < 0) {
+        return ERR_WOULDBLOCK;
+    }
+    IF_STATS_O(listen_sock, listen_sock->m_p_socket_stats->listen_counters.n_syncookies_sent++);
     return ERR_OK;
 }
 
@@ -4072,6 +5274,9 @@ err_t sockinfo_tcp::connect_lwip_cb(void *arg, struct tcp_pcb *tpcb, err_t err)
         return ERR_OK;
     }
     if (err == ERR_OK) {
+        if (tpcb->fastopen & TCP_TFO_COOKIE) {
+            tfo_cookie_put(conn->m_connected.get_ip_addr(), tpcb);
+        }
         conn->m_conn_state = TCP_CONN_CONNECTED;
         conn->m_sock_state = TCP_SOCK_CONNECTED_RDWR; // async connect verification
         conn->m_error_status = 0;
@@ -4087,7 +5292,7 @@ err_t sockinfo_tcp::connect_lwip_cb(void *arg, struct tcp_pcb *tpcb, err_t err)
 
     NOTIFY_ON_EVENTS(conn, EPOLLOUT);
     // OLG: Now we should wakeup all threads that are sleeping on this socket.
-    conn->m_sock_wakeup_pipe.do_wakeup();
+    conn->m_sock_wakeup.do_wakeup();
 
     if (conn->m_p_socket_stats) {
         conn->m_p_socket_stats->set_connected_ip(conn->m_connected);
@@ -4164,7 +5369,7 @@ int sockinfo_tcp::wait_for_conn_ready_blocking()
 int sockinfo_tcp::os_epoll_wait(epoll_event *ep_events, int maxevents)
 {
     return (
-        likely(safe_mce_sys().tcp_ctl_thread !=
+        likely(g_hot_sys_var.tcp_ctl_thread !=
                option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS)
             ? SYSCALL(epoll_wait, m_rx_epfd, ep_events, maxevents, m_loops_timer.time_left_msec())
             : os_epoll_wait_with_tcp_timers(ep_events, maxevents));
@@ -4202,14 +5407,14 @@ bool sockinfo_tcp::is_readable(uint64_t *p_poll_sn, fd_array_t *p_fd_array)
         // m_conn_cond.lock();
         if (m_listen_ctx) {
             for (size_t i = 0; i < m_listen_ctx->get_listen_rss_children_size(); i++) {
-                if (m_listen_ctx->get_listen_rss_child(i)->m_ready_conn_cnt > 0) {
+                if (!m_listen_ctx->get_listen_rss_child(i)->m_accept_queue.empty()) {
                     state = true;
                     break;
                 }
             }
         }
 
-        state |= m_ready_conn_cnt == 0 ? false : true;
+        state |= has_accepted_conns();
         if (state) {
             si_tcp_logdbg("accept ready");
             return true;
@@ -4328,6 +5533,9 @@ bool sockinfo_tcp::is_errorable(int *errors)
     if (m_conn_state == TCP_CONN_ERROR) {
         *errors |= POLLERR;
     }
+    if (unlikely(m_b_zerocopy || is_tx_ts_reported()) && has_errqueue_notify()) {
+        *errors |= POLLERR;
+    }
 
     return *errors;
 }
@@ -4401,6 +5609,7 @@ int sockinfo_tcp::shutdown(int __how)
         if (shut_rx) {
             tcp_accept(&m_pcb, nullptr);
             tcp_syn_handled(&m_pcb, sockinfo_tcp::syn_received_drop_lwip_cb);
+            tcp_syn_cookie(&m_pcb, nullptr);
         }
     } else {
         if (get_tcp_state(&m_pcb) != LISTEN && shut_rx && m_n_rx_pkt_ready_list_count) {
@@ -4410,7 +5619,7 @@ int sockinfo_tcp::shutdown(int __how)
         }
     }
 
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     if (err == ERR_OK) {
         unlock_tcp_con();
@@ -4445,7 +5654,7 @@ int sockinfo_tcp::fcntl_helper(int __cmd, unsigned long int __arg, bool &bexit)
 
 int sockinfo_tcp::fcntl(int __cmd, unsigned long int __arg)
 {
-    if (!safe_mce_sys().avoid_sys_calls_on_tcp_fd || !is_connected()) {
+    if (!g_hot_sys_var.avoid_sys_calls_on_tcp_fd || !is_connected()) {
         return sockinfo::fcntl(__cmd, __arg);
     }
 
@@ -4460,7 +5669,7 @@ int sockinfo_tcp::fcntl(int __cmd, unsigned long int __arg)
 
 int sockinfo_tcp::fcntl64(int __cmd, unsigned long int __arg)
 {
-    if (!safe_mce_sys().avoid_sys_calls_on_tcp_fd || !is_connected()) {
+    if (!g_hot_sys_var.avoid_sys_calls_on_tcp_fd || !is_connected()) {
         return sockinfo::fcntl64(__cmd, __arg);
     }
 
@@ -4475,7 +5684,7 @@ int sockinfo_tcp::fcntl64(int __cmd, unsigned long int __arg)
 
 int sockinfo_tcp::ioctl(unsigned long int __request, unsigned long int __arg)
 {
-    if (!safe_mce_sys().avoid_sys_calls_on_tcp_fd || !is_connected()) {
+    if (!g_hot_sys_var.avoid_sys_calls_on_tcp_fd || !is_connected()) {
         return sockinfo::ioctl(__request, __arg);
     }
 
@@ -4492,9 +5701,17 @@ int sockinfo_tcp::ioctl(unsigned long int __request, unsigned long int __arg)
     return sockinfo::ioctl(__request, __arg);
 }
 
+// A pending MSG_WAITALL placement opens the window to the size of its request
+int sockinfo_tcp::rcv_wnd_desired() const
+{
+    int place = static_cast<int>(std::min<size_t>(m_rx_place.size, TCP_WND_SCALED(&m_pcb)));
+
+    return std::min(TCP_WND_SCALED(&m_pcb), std::max(m_rcvbuff_max, place));
+}
+
 void sockinfo_tcp::fit_rcv_wnd(bool force_fit)
 {
-    m_pcb.rcv_wnd_max_desired = std::min(TCP_WND_SCALED(&m_pcb), m_rcvbuff_max);
+    m_pcb.rcv_wnd_max_desired = rcv_wnd_desired();
 
     if (force_fit) {
         int rcv_wnd_max_diff = m_pcb.rcv_wnd_max_desired - m_pcb.rcv_wnd_max;
@@ -4514,6 +5731,55 @@ void sockinfo_tcp::fit_rcv_wnd(bool force_fit)
     }
 }
 
+/*
+ * Dynamic right-sizing of the receive buffer, as tcp_rcv_space_adjust() of Linux.
+ * Once per round trip, the buffer is set to twice the data the application read during
+ * the round trip plus the growth since the previous one, so the window doesn't limit
+ * a sender which is still increasing its rate.
+ */
+void sockinfo_tcp::rcvbuff_autotune(int copied)
+{
+    uint32_t rtt = m_pcb.rcv_rtt ? m_pcb.rcv_rtt : m_pcb.rack_srtt;
+    uint32_t now;
+
+    m_rcv_space_copied += copied;
+    if (!rtt) {
+        return;
+    }
+    now = xlio_lwip::sys_now_us();
+    if (now - m_rcv_space_time < rtt) {
+        return;
+    }
+
+    if (unlikely(g_buffer_pool_rx_rwqe->is_under_pressure())) {
+        if (m_rcvbuff_max > m_rcvbuff_initial) {
+            // The window closes gradually as the data arrives, see rx_lwip_shrink_rcv_wnd()
+            m_rcvbuff_max = std::max(m_rcvbuff_initial, m_rcvbuff_max / 2);
+            m_pcb.rcv_wnd_max_desired = rcv_wnd_desired();
+            m_rcv_space = 0;
+            IF_STATS(m_p_socket_stats->counters.n_rx_wnd_shrinks++);
+        }
+    } else if (m_rcv_space_copied > m_rcv_space) {
+        const uint64_t rmem_max = safe_mce_sys().sysctl_reader.get_tcp_rmem()->max_value;
+        uint64_t rcvwin = 2ULL * m_rcv_space_copied + 16ULL * m_pcb.mss;
+
+        if (m_rcv_space) {
+            rcvwin += 2ULL * rcvwin * (m_rcv_space_copied - m_rcv_space) / m_rcv_space;
+        }
+        rcvwin = std::min(rcvwin, rmem_max);
+        if (static_cast<int>(rcvwin) > m_rcvbuff_max) {
+            m_rcvbuff_max = static_cast<int>(rcvwin);
+            fit_rcv_wnd(false);
+            IF_STATS(m_p_socket_stats->counters.n_rx_wnd_grows++);
+        }
+        m_rcv_space = m_rcv_space_copied;
+    }
+    IF_STATS(m_p_socket_stats->counters.n_rx_wnd_max = m_pcb.rcv_wnd_max);
+
+    m_rcv_space_copied = 0;
+    m_rcv_space_time = now;
+}
+
 void sockinfo_tcp::fit_snd_bufs(uint32_t new_snd_buf_max)
 {
     // m_snd_buf can become negative
@@ -4521,6 +5787,46 @@ void sockinfo_tcp::fit_snd_bufs(uint32_t new_snd_buf_max)
     m_snd_buf_max = new_snd_buf_max;
 }
 
+/*
+ * A sender limited by its send buffer grows it to twice the congestion window, so
+ * a round trip of data is in flight while the next one is written. The growth of all
+ * the sockets is limited by tcp_send_buffer_autotune_limit.
+ */
+void sockinfo_tcp::sndbuf_autotune_grow()
+{
+    const uint64_t wmem_max = safe_mce_sys().sysctl_reader.get_tcp_wmem()->max_value;
+    const size_t limit = safe_mce_sys().tcp_send_buffer_autotune_limit;
+    uint64_t target = std::min<uint64_t>(2ULL * m_pcb.cwnd, wmem_max);
+
+    m_snd_buf_idle_ticks = 0;
+    if (target <= m_snd_buf_max) {
+        return;
+    }
+
+    size_t grow = target - m_snd_buf_max;
+    size_t used = g_sndbuf_autotune_used.fetch_add(grow, std::memory_order_relaxed) + grow;
+    if (used > limit) {
+        size_t excess = std::min(grow, used - limit);
+        g_sndbuf_autotune_used.fetch_sub(excess, std::memory_order_relaxed);
+        grow -= excess;
+        if (!grow) {
+            return;
+        }
+    }
+    si_tcp_logdbg("send buffer %u -> %zu, cwnd %u", m_snd_buf_max, m_snd_buf_max + grow,
+                  m_pcb.cwnd);
+    fit_snd_bufs(m_snd_buf_max + static_cast<uint32_t>(grow));
+}
+
+void sockinfo_tcp::sndbuf_autotune_release()
+{
+    if (m_snd_buf_max > m_snd_buf_base) {
+        g_sndbuf_autotune_used.fetch_sub(m_snd_buf_max - m_snd_buf_base, std::memory_order_relaxed);
+        fit_snd_bufs(m_snd_buf_base);
+    }
+    m_snd_buf_idle_ticks = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool sockinfo_tcp::try_un_offloading() // un-offload the socket if possible
 {
@@ -4601,7 +5907,16 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
     } else if (__level == IPPROTO_TCP) {
         switch (__optname) {
         case TCP_CORK:
-            // We don't support TCP_CORK.
+            val = *(int *)__optval;
+            lock_tcp_con();
+            m_b_cork = (val != 0);
+            tx_cork_update(0);
+            if (!m_b_cork) {
+                // The uncork sends the held partial segment
+                tcp_output(&m_pcb);
+            }
+            unlock_tcp_con();
+            si_tcp_logdbg("(TCP_CORK) value: %d", val);
             break;
         case TCP_NODELAY:
             val = *(int *)__optval;
@@ -4678,6 +5993,10 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                     algo = &cubic_cc_algo;
                 } else if (cc_name == "none") {
                     algo = &none_cc_algo;
+                } else if (cc_name == "bbr") {
+                    algo = &bbr_cc_algo;
+                } else if (cc_name == "dctcp") {
+                    algo = &dctcp_cc_algo;
                 }
                 if (algo) {
                     lock_tcp_con();
@@ -4697,6 +6016,33 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                 ret = -1;
             }
             break;
+        case TCP_FASTOPEN: {
+            auto *int_ptr = reinterpret_cast<const int *>(__optval);
+            if (__optlen < sizeof(int) || *int_ptr < 0) {
+                errno = EINVAL;
+                ret = -1;
+            } else {
+                si_tcp_logdbg("TCP_FASTOPEN value: %d", *int_ptr);
+                lock_tcp_con();
+                if (*int_ptr > 0 && (safe_mce_sys().tcp_fastopen & TCP_FASTOPEN_SERVER_ENABLE)) {
+                    m_pcb.fastopen |= TCP_TFO_SERVER;
+                } else {
+                    m_pcb.fastopen &= ~TCP_TFO_SERVER;
+                }
+                unlock_tcp_con();
+            }
+        } break;
+        case TCP_FASTOPEN_CONNECT: {
+            auto *int_ptr = reinterpret_cast<const int *>(__optval);
+            if (__optlen < sizeof(int)) {
+                errno = EINVAL;
+                ret = -1;
+            } else {
+                si_tcp_logdbg("TCP_FASTOPEN_CONNECT value: %d", *int_ptr);
+                m_tfo_connect =
+                    *int_ptr && (safe_mce_sys().tcp_fastopen & TCP_FASTOPEN_CLIENT_ENABLE);
+            }
+        } break;
         case TCP_USER_TIMEOUT: {
             unsigned int user_timeout_ms = *(unsigned int *)__optval;
             si_tcp_logdbg("TCP_USER_TIMEOUT value: %u", user_timeout_ms);
@@ -4711,6 +6057,7 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                 auto idle_sec = static_cast<unsigned int>(*int_ptr);
                 si_tcp_logdbg("TCP_KEEPIDLE value: %us", idle_sec);
                 m_pcb.keep_idle = idle_sec * 1000U;
+                rearm_parked_timer();
             }
         } break;
 #if LWIP_TCP_KEEPALIVE
@@ -4723,6 +6070,7 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                 auto keep_intvl = static_cast<unsigned int>(*int_ptr);
                 si_tcp_logdbg("TCP_KEEPINTVL value: %us", keep_intvl);
                 m_pcb.keep_intvl = keep_intvl * 1000U;
+                rearm_parked_timer();
             }
         } break;
         case TCP_KEEPCNT: {
@@ -4734,6 +6082,7 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                 auto keep_cnt = static_cast<unsigned int>(*int_ptr);
                 si_tcp_logdbg("TCP_KEEPCNT value: %u", keep_cnt);
                 m_pcb.keep_cnt = keep_cnt;
+                rearm_parked_timer();
             }
         } break;
 #endif /* LWIP_TCP_KEEPALIVE */
@@ -4761,6 +6110,9 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             lock_tcp_con();
             if (val) {
                 m_pcb.so_options |= SOF_KEEPALIVE;
+                if (m_pcb.tmr_parked) {
+                    wake_timer();
+                }
             } else {
                 m_pcb.so_options &= ~SOF_KEEPALIVE;
             }
@@ -4773,6 +6125,7 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             // OS allocates double the size of memory requested by the application - not sure we
             // need it.
             m_rcvbuff_max = std::max(2 * m_pcb.mss, 2 * val);
+            m_rcvbuff_autotune = false;
 
             fit_rcv_wnd(!is_connected());
             unlock_tcp_con();
@@ -4784,6 +6137,9 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             // OS allocates double the size of memory requested by the application - not sure we
             // need it.
             val = std::max(2 * m_pcb.mss, 2 * val);
+            sndbuf_autotune_release();
+            m_snd_buf_autotune = false;
+            m_snd_buf_base = static_cast<uint32_t>(val);
             fit_snd_bufs(static_cast<uint32_t>(val));
             unlock_tcp_con();
             si_tcp_logdbg("setsockopt SO_SNDBUF: requested %d, set %d", *(int *)__optval, val);
@@ -4897,7 +6253,16 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             }
 
             lock_tcp_con();
-            ret = modify_ratelimit(m_p_connected_dst_entry, rate_limit);
+            ret = -1;
+            if (g_hot_sys_var.tx_sw_pacing != SW_PACING_ALWAYS) {
+                ret = modify_ratelimit(m_p_connected_dst_entry, rate_limit);
+            }
+            if (ret && g_hot_sys_var.tx_sw_pacing != SW_PACING_DISABLE) {
+                ret = set_sw_pacing(rate_limit);
+            } else if (!ret && m_sw_ratelimit.rate) {
+                struct xlio_rate_limit_t no_limit = {};
+                set_sw_pacing(no_limit);
+            }
             unlock_tcp_con();
             if (ret) {
                 si_tcp_logdbg("error setting setsockopt SO_MAX_PACING_RATE: %d bytes/second ",
@@ -4931,6 +6296,59 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             ret = -1;
             errno = EINVAL;
             break;
+        case SO_XLIO_TX_WATERMARKS:
+            if (__optlen >= sizeof(struct xlio_tx_watermarks)) {
+                const struct xlio_tx_watermarks *wm =
+                    reinterpret_cast<const struct xlio_tx_watermarks *>(__optval);
+                if (wm->low <= wm->high) {
+                    lock_tcp_con();
+                    m_tx_wm_low = wm->low;
+                    m_tx_wm_high = wm->high;
+                    // The next send reports the congestion against the new high watermark
+                    m_tx_congested = false;
+                    unlock_tcp_con();
+                    pass_to_os_cond = false;
+                    si_tcp_logdbg("(SO_XLIO_TX_WATERMARKS) low: %u high: %u", m_tx_wm_low,
+                                  m_tx_wm_high);
+                    break;
+                }
+            }
+            ret = -1;
+            errno = EINVAL;
+            break;
+        case SO_XLIO_NVME_OFFLOAD: {
+            // The NVMe ops handle the option once installed
+            const struct xlio_nvme_offload *offload =
+                reinterpret_cast<const struct xlio_nvme_offload *>(__optval);
+            pass_to_os_cond = false;
+            ret = -1;
+            if (!offload || __optlen < sizeof(*offload) ||
+                (offload->flags &
+                 ~(XLIO_NVME_TX_DIGEST | XLIO_NVME_RX_DIGEST | XLIO_NVME_RX_DDP))) {
+                errno = EINVAL;
+                break;
+            }
+            lock_tcp_con();
+            if (unlikely(!is_rts())) {
+                errno = ENOTCONN;
+            } else if (m_ops != m_ops_tcp) {
+                // Doesn't stack with TLS
+                errno = EEXIST;
+            } else {
+                set_ops(new sockinfo_tcp_ops_nvme(this, m_ops_tcp, offload->flags));
+                ret = 0;
+            }
+            unlock_tcp_con();
+            si_tcp_logdbg("(SO_XLIO_NVME_OFFLOAD) flags: %#x, ret: %d", offload->flags, ret);
+            break;
+        }
+        case SO_XLIO_NVME_DDP_SETUP:
+        case SO_XLIO_NVME_DDP_TEARDOWN:
+            // Without SO_XLIO_NVME_OFFLOAD
+            pass_to_os_cond = false;
+            ret = -1;
+            errno = EINVAL;
+            break;
         default:
             pass_to_os_always = true;
             supported = false;
@@ -4954,7 +6372,7 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
             new socket_option_t(__level, __optname, __optval, __optlen));
     }
 
-    if ((safe_mce_sys().avoid_sys_calls_on_tcp_fd && !pass_to_os_always && is_connected())) {
+    if ((g_hot_sys_var.avoid_sys_calls_on_tcp_fd && !pass_to_os_always && is_connected())) {
         pass_to_os_cond = false;
     }
 
@@ -4964,12 +6382,8 @@ int sockinfo_tcp::tcp_setsockopt(int __level, int __optname, __const void *__opt
                 : ret);
 }
 
-void sockinfo_tcp::get_tcp_info(struct tcp_info *ti)
+void sockinfo_tcp::publish_tcp_info()
 {
-    int state = get_tcp_state(&m_pcb);
-
-    memset(ti, 0, sizeof(*ti));
-
     static std::unordered_map<int, int> pcb_to_tcp_state = {
         {CLOSED, TCP_CLOSE},         {LISTEN, TCP_LISTEN},           {SYN_SENT, TCP_SYN_SENT},
         {SYN_RCVD, TCP_SYN_RECV},    {ESTABLISHED, TCP_ESTABLISHED}, {FIN_WAIT_1, TCP_FIN_WAIT1},
@@ -4978,17 +6392,94 @@ void sockinfo_tcp::get_tcp_info(struct tcp_info *ti)
 
     assert(pcb_to_tcp_state.size() == TCP_STATE_NR);
 
-    ti->tcpi_state = state < TCP_STATE_NR ? pcb_to_tcp_state[state] : 0;
-    ti->tcpi_options = (!!(m_pcb.flags & TF_TIMESTAMP) * TCPI_OPT_TIMESTAMPS) |
+    // We keep the RTT and rto with TCP slow timer granularity and convert them to usec.
+    const uint32_t tick_usec = safe_mce_sys().tcp_timer_resolution_msec * 2 * 1000U;
+    const uint32_t mss = m_pcb.mss ?: 1U;
+    const int state = get_tcp_state(&m_pcb);
+    tcp_info_snapshot info;
+
+    info.state = state < TCP_STATE_NR ? pcb_to_tcp_state[state] : 0;
+    info.options = (!!(m_pcb.flags & TF_TIMESTAMP) * TCPI_OPT_TIMESTAMPS) |
         (!!(m_pcb.flags & TF_WND_SCALE) * TCPI_OPT_WSCALE);
-    // We keep rto with TCP slow timer granularity and need to convert it to usec.
-    ti->tcpi_rto = m_pcb.rto * safe_mce_sys().tcp_timer_resolution_msec * 2 * 1000U;
-    ti->tcpi_advmss = m_pcb.advtsd_mss;
-    ti->tcpi_snd_mss = m_pcb.mss;
-    ti->tcpi_retransmits = m_pcb.nrtx;
+    info.retransmits = m_pcb.nrtx;
+    info.rto_usec = m_pcb.rto * tick_usec;
+    // The RACK samples are precise, the slow timer estimate is used without them
+    info.rtt_usec = m_pcb.rack_srtt ?: (m_pcb.sa >> 3) * tick_usec;
+    info.rttvar_usec = (m_pcb.sv >> 2) * tick_usec;
+    info.rcv_rtt_usec = m_pcb.rcv_rtt;
+    info.snd_mss = m_pcb.mss;
+    info.advmss = m_pcb.advtsd_mss;
+    info.snd_cwnd = m_pcb.cwnd / mss;
+    info.snd_ssthresh = m_pcb.ssthresh / mss;
+    info.unacked = (m_pcb.snd_nxt - m_pcb.lastack + mss - 1U) / mss;
+    info.rcv_wnd = m_pcb.rcv_wnd;
+    m_tcp_info.store(info);
+
+    if (m_p_socket_stats) {
+        m_p_socket_stats->tcp_snd_cwnd = info.snd_cwnd;
+        m_p_socket_stats->tcp_rtt_usec = info.rtt_usec;
+        m_p_socket_stats->tcp_unacked = info.unacked;
+        m_p_socket_stats->tcp_rcv_wnd = info.rcv_wnd;
+        m_p_socket_stats->tcp_mss = info.snd_mss;
+    }
+}
+
+void sockinfo_tcp::publish_tcp_loss()
+{
+    if (!m_p_socket_stats) {
+        return;
+    }
+
+    ring *p_ring = m_p_connected_dst_entry ? m_p_connected_dst_entry->get_ring() : nullptr;
+    tcp_loss_stats_t *ring_loss = p_ring ? p_ring->get_tcp_loss_stats() : nullptr;
+    tcp_loss_stats_t &loss = m_p_socket_stats->tcp_loss;
+    tcp_loss_stats_t cur = {};
+
+    cur.n_rto = m_pcb.stats.n_rto;
+    cur.n_recovery = m_pcb.stats.n_recovery;
+    cur.n_tlp = m_pcb.stats.n_tlp;
+    cur.n_spurious_rexmit = m_pcb.stats.n_spurious_rexmit;
+    cur.n_zero_wnd = m_pcb.stats.n_zero_wnd;
+    cur.rwnd_limited_usec = m_pcb.stats.limited_usec[TCP_LIMITED_RWND];
+    cur.cwnd_limited_usec = m_pcb.stats.limited_usec[TCP_LIMITED_CWND];
+    cur.sndbuf_limited_usec = m_pcb.stats.limited_usec[TCP_LIMITED_SNDBUF];
+    cur.app_limited_usec = m_pcb.stats.limited_usec[TCP_LIMITED_APP];
+
+    // The ring gets the growth since the previous publish
+    if (ring_loss) {
+        ring_loss->n_rto += cur.n_rto - loss.n_rto;
+        ring_loss->n_recovery += cur.n_recovery - loss.n_recovery;
+        ring_loss->n_tlp += cur.n_tlp - loss.n_tlp;
+        ring_loss->n_spurious_rexmit += cur.n_spurious_rexmit - loss.n_spurious_rexmit;
+        ring_loss->n_zero_wnd += cur.n_zero_wnd - loss.n_zero_wnd;
+        ring_loss->rwnd_limited_usec += cur.rwnd_limited_usec - loss.rwnd_limited_usec;
+        ring_loss->cwnd_limited_usec += cur.cwnd_limited_usec - loss.cwnd_limited_usec;
+        ring_loss->sndbuf_limited_usec += cur.sndbuf_limited_usec - loss.sndbuf_limited_usec;
+        ring_loss->app_limited_usec += cur.app_limited_usec - loss.app_limited_usec;
+    }
+    loss = cur;
+}
+
+void sockinfo_tcp::get_tcp_info(struct tcp_info *ti)
+{
+    // A monitoring thread doesn't compete with the data path for the connection lock
+    const tcp_info_snapshot info = m_tcp_info.load();
+
+    memset(ti, 0, sizeof(*ti));
+
+    ti->tcpi_state = info.state;
+    ti->tcpi_options = info.options;
+    ti->tcpi_rto = info.rto_usec;
+    ti->tcpi_rtt = info.rtt_usec;
+    ti->tcpi_rttvar = info.rttvar_usec;
+    ti->tcpi_rcv_rtt = info.rcv_rtt_usec;
+    ti->tcpi_advmss = info.advmss;
+    ti->tcpi_snd_mss = info.snd_mss;
+    ti->tcpi_retransmits = info.retransmits;
     // ti->tcpi_retrans - we don't keep it and calculation would be O(N).
-    ti->tcpi_snd_cwnd = m_pcb.cwnd / m_pcb.mss;
-    ti->tcpi_snd_ssthresh = m_pcb.ssthresh / m_pcb.mss;
+    ti->tcpi_snd_cwnd = info.snd_cwnd;
+    ti->tcpi_snd_ssthresh = info.snd_ssthresh;
+    ti->tcpi_unacked = info.unacked;
 
     // This will be incorrect if sockets number is bigger than safe_mce_sys().stats_fd_num_max.
     IF_STATS(ti->tcpi_total_retrans = m_p_socket_stats->counters.n_tx_retransmits);
@@ -5022,6 +6513,15 @@ int sockinfo_tcp::getsockopt_offload(int __level, int __optname, void *__optval,
                 errno = EINVAL;
             }
             break;
+        case TCP_CORK:
+            if (*__optlen >= sizeof(int)) {
+                *(int *)__optval = m_b_cork;
+                si_tcp_logdbg("(TCP_CORK) value: %d", *(int *)__optval);
+                ret = 0;
+            } else {
+                errno = EINVAL;
+            }
+            break;
         case TCP_QUICKACK:
             if (*__optlen >= sizeof(int)) {
                 *(int *)__optval = m_pcb.quickack;
@@ -5155,6 +6655,32 @@ int sockinfo_tcp::getsockopt_offload(int __level, int __optname, void *__optval,
                 errno = EINVAL;
             }
             break;
+        case SO_XLIO_TX_WATERMARKS:
+            if (*__optlen >= sizeof(struct xlio_tx_watermarks)) {
+                struct xlio_tx_watermarks *wm = reinterpret_cast<xlio_tx_watermarks *>(__optval);
+                wm->low = m_tx_wm_low;
+                wm->high = m_tx_wm_high;
+                *__optlen = sizeof(struct xlio_tx_watermarks);
+                ret = 0;
+            } else {
+                errno = EINVAL;
+            }
+            break;
+        case SO_XLIO_NVME_OFFLOAD:
+            if (*__optlen >= sizeof(struct xlio_nvme_offload)) {
+                struct xlio_nvme_offload *offload =
+                    reinterpret_cast<xlio_nvme_offload *>(__optval);
+                sockinfo_tcp_ops_nvme *nvme = dynamic_cast<sockinfo_tcp_ops_nvme *>(m_ops);
+                *offload = {};
+                if (nvme) {
+                    nvme->get_offload(*offload);
+                }
+                *__optlen = sizeof(struct xlio_nvme_offload);
+                ret = 0;
+            } else {
+                errno = EINVAL;
+            }
+            break;
         case SO_LINGER:
             if (*__optlen > 0) {
                 memcpy(__optval, &m_linger, std::min<size_t>(*__optlen, sizeof(struct linger)));
@@ -5333,7 +6859,7 @@ int sockinfo_tcp::rx_wait_helper(int &poll_count, bool blocking)
         return 1;
     }
 
-    if (safe_mce_sys().tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
+    if (g_hot_sys_var.tcp_ctl_thread == option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
         // There are scenarios when rx_wait_helper is called in an infinite loop but exits before
         // OS epoll_wait. Delegated TCP timers must be attempted in such case.
         // This is a slow path. So calling chrono::now(), even with every iteration, is OK here.
@@ -5346,7 +6872,7 @@ int sockinfo_tcp::rx_wait_helper(int &poll_count, bool blocking)
         return -1;
     }
 
-    if (poll_count < safe_mce_sys().rx_poll_num || safe_mce_sys().rx_poll_num == -1) {
+    if (rx_poll_budget_left(poll_count)) {
         return 0;
     }
 
@@ -5387,18 +6913,18 @@ int sockinfo_tcp::rx_wait_helper(int &poll_count, bool blocking)
     progress = check_last_rx_poll_progress(prev_sndbuf, all_drained);
     // End of do another poll.
 
-    if (progress || m_ready_conn_cnt) {
+    if (progress || has_accepted_conns()) {
         unlock_tcp_con();
         return 1;
     }
 
-    m_sock_wakeup_pipe.going_to_sleep();
+    m_sock_wakeup.going_to_sleep();
     unlock_tcp_con();
 
     int ret = os_wait_sock_rx_epfd(rx_epfd_events, SI_RX_EPFD_EVENT_MAX);
 
     lock_tcp_con();
-    m_sock_wakeup_pipe.return_from_sleep();
+    m_sock_wakeup.return_from_sleep();
     unlock_tcp_con();
 
     if (ret <= 0) {
@@ -5407,9 +6933,9 @@ int sockinfo_tcp::rx_wait_helper(int &poll_count, bool blocking)
 
     for (int event_idx = 0; event_idx < ret; event_idx++) {
         int fd = rx_epfd_events[event_idx].data.fd;
-        if (m_sock_wakeup_pipe.is_wakeup_fd(fd)) { // wakeup event
+        if (m_sock_wakeup.is_wakeup_fd(fd)) { // wakeup event
             lock_tcp_con();
-            m_sock_wakeup_pipe.remove_wakeup_fd();
+            m_sock_wakeup.remove_wakeup_fd();
             unlock_tcp_con();
             continue;
         }
@@ -5460,7 +6986,9 @@ bool sockinfo_tcp::poll_and_progress_rx(uint64_t &poll_sn)
 bool sockinfo_tcp::check_last_rx_poll_progress(unsigned int prev_sndbuf, bool all_drained)
 {
     bool sndbuf_change = (sndbuf_available() != prev_sndbuf);
-    if (likely(m_n_rx_pkt_ready_list_count || !all_drained || sndbuf_change)) {
+    // A complete MSG_WAITALL placement leaves nothing in the ready list
+    bool placed = m_rx_place.size && m_rx_place.placed == m_rx_place.size;
+    if (likely(m_n_rx_pkt_ready_list_count || !all_drained || sndbuf_change || placed)) {
         // Got completions from CQ
         __log_entry_funcall("Ready %d packets", m_n_rx_pkt_ready_list_count);
         IF_STATS(m_p_socket_stats->counters.n_rx_poll_hit++);
@@ -5472,9 +7000,22 @@ bool sockinfo_tcp::check_last_rx_poll_progress(unsigned int prev_sndbuf, bool al
 }
 
 mem_buf_desc_t *sockinfo_tcp::get_next_desc(mem_buf_desc_t *p_desc)
+{
+    pop_ready_desc(p_desc);
+    reuse_buffer(p_desc);
+    if (m_n_rx_pkt_ready_list_count) {
+        return m_rx_pkt_ready_list.front();
+    } else {
+        return nullptr;
+    }
+}
+
+// Remove the front buffer of the ready list, its chained buffers become the front
+void sockinfo_tcp::pop_ready_desc(mem_buf_desc_t *p_desc)
 {
     m_rx_pkt_ready_list.pop_front();
     IF_STATS(m_p_socket_stats->n_rx_ready_pkt_count--);
+    lat_hist_rx_dequeued(p_desc);
 
     m_n_rx_pkt_ready_list_count--;
     if (p_desc->p_next_desc) {
@@ -5485,20 +7026,13 @@ mem_buf_desc_t *sockinfo_tcp::get_next_desc(mem_buf_desc_t *p_desc)
             prev->lwip_pbuf.tot_len - prev->lwip_pbuf.len;
         p_desc->rx.n_frags = --prev->rx.n_frags;
         p_desc->inc_ref_count();
+        p_desc->rx.ready_tsc = 0U;
         m_rx_pkt_ready_list.push_front(p_desc);
         m_n_rx_pkt_ready_list_count++;
         prev->lwip_pbuf.next = nullptr;
         prev->p_next_desc = nullptr;
         prev->rx.n_frags = 1;
         IF_STATS(m_p_socket_stats->n_rx_ready_pkt_count++);
-        reuse_buffer(prev);
-    } else {
-        reuse_buffer(p_desc);
-    }
-    if (m_n_rx_pkt_ready_list_count) {
-        return m_rx_pkt_ready_list.front();
-    } else {
-        return nullptr;
     }
 }
 
@@ -5696,6 +7230,9 @@ void sockinfo_tcp::statistics_print(vlog_levels_t log_level /* = VLOG_DEBUG */)
 inline void sockinfo_tcp::non_tcp_recved(int rx_len)
 {
     m_rcvbuff_current -= rx_len;
+    if (m_rcvbuff_autotune) {
+        rcvbuff_autotune(rx_len);
+    }
     // data that was not tcp_recved should do it now.
     if (m_rcvbuff_non_tcp_recved > 0) {
         int bytes_to_tcp_recved = std::min(m_rcvbuff_non_tcp_recved, rx_len);
@@ -5790,9 +7327,12 @@ void sockinfo_tcp::tcp_express_zc_callback(mem_buf_desc_t *p_desc)
     sockinfo_tcp *si = reinterpret_cast<sockinfo_tcp *>(p_desc->tx.zc.ctx);
     const uintptr_t opaque_op = reinterpret_cast<uintptr_t>(p_desc->lwip_pbuf.desc.opaque);
 
-    if (opaque_op && si->m_p_group && si->m_p_group->m_socket_comp_cb) {
-        si->m_p_group->m_socket_comp_cb(reinterpret_cast<xlio_socket_t>(si),
-                                        si->m_xlio_socket_userdata, opaque_op);
+    if (opaque_op && si->m_p_group && si->m_p_group->has_comp_cb()) {
+        si->m_p_group->comp_cb(si, opaque_op);
+    } else if (opaque_op && !si->m_p_group) {
+        // send(MSG_ZEROCOPY), the socket isn't destroyed before its last completion
+        si->zc_notify(static_cast<uint32_t>(opaque_op - 1U), false);
+        __atomic_fetch_sub(&si->m_zc_inflight, 1U, __ATOMIC_RELEASE);
     }
 }
 
@@ -5827,7 +7367,8 @@ void sockinfo_tcp::return_tcp_segs(struct tcp_seg *seg)
 
 struct tcp_seg *sockinfo_tcp::get_tcp_seg_direct()
 {
-    return likely(m_p_rx_ring) ? m_p_rx_ring->get_tcp_segs(1U) : g_tcp_seg_pool->get_objs(1U);
+    // The thread magazines keep the segments hot without the ring lock
+    return g_tcp_seg_pool->get_obj();
 }
 
 struct tcp_seg *sockinfo_tcp::get_tcp_seg_cached()
@@ -5854,8 +7395,7 @@ struct tcp_seg *sockinfo_tcp::get_tcp_seg_cached()
 // Assumed seg != nullptr
 void sockinfo_tcp::put_tcp_seg_direct(struct tcp_seg *seg)
 {
-    seg->next = nullptr; // We occasionally get here trashed seg->next.
-    return_tcp_segs(seg);
+    g_tcp_seg_pool->put_obj(seg);
 }
 
 void sockinfo_tcp::put_tcp_seg_cached(struct tcp_seg *seg)
@@ -5884,6 +7424,7 @@ tcp_timers_collection::tcp_timers_collection(int intervals)
 {
     m_n_intervals_size = intervals;
     m_p_intervals.resize(m_n_intervals_size);
+    m_b_park_idle = safe_mce_sys().tcp_timer_park_idle;
 }
 
 // coverity[UNCAUGHT_EXCEPT]
@@ -5894,6 +7435,9 @@ tcp_timers_collection::~tcp_timers_collection()
             remove_timer(bucket.front());
         }
     }
+    while (!m_parked.empty()) {
+        remove_timer(m_parked.front());
+    }
     if (m_n_count) {
         __log_dbg("Not all TCP socket timers have been removed, count=%d", m_n_count);
     }
@@ -5903,7 +7447,7 @@ event_handler_manager *tcp_timers_collection::get_event_mgr()
 {
     if (m_p_group) {
         return m_p_group->get_event_handler();
-    } else if (safe_mce_sys().tcp_ctl_thread ==
+    } else if (g_hot_sys_var.tcp_ctl_thread ==
                option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
         return &g_event_handler_manager_local;
     } else {
@@ -5931,11 +7475,15 @@ void tcp_timers_collection::clean_obj()
 void tcp_timers_collection::handle_timer_expired(void *user_data)
 {
     NOT_IN_USE(user_data);
+    unpark_woken_timers();
+    process_keepalives();
+
     sock_list &bucket = m_p_intervals[m_n_location];
     m_n_location = (m_n_location + 1) % m_n_intervals_size;
 
     auto iter = bucket.begin();
     while (iter != bucket.end()) {
+        auto curr = iter;
         sockinfo_tcp *p_sock = *iter;
         // Must increment iterator first, the socket can be erased below in case of local timers.
         iter++;
@@ -5943,11 +7491,18 @@ void tcp_timers_collection::handle_timer_expired(void *user_data)
         // TODO Trylock can miss a timer tick and we don't trigger it in unlock() anymore.
         if (!p_sock->trylock_tcp_con()) {
             bool destroyable = false;
+            bool parked = false;
+            uint32_t keepalive_ticks = 0U;
             if (!p_sock->is_cleaned()) {
                 p_sock->handle_timer_expired();
                 destroyable = p_sock->is_destroyable_no_lock();
+                parked = m_b_park_idle && !destroyable && p_sock->try_park_timer(keepalive_ticks);
             }
             p_sock->unlock_tcp_con();
+            if (parked) {
+                // A wakeup of the socket from now on is handled by the next tick
+                park_timer(p_sock, bucket, curr, keepalive_ticks);
+            }
             if (destroyable) {
                 if (p_sock->get_poll_group()) {
                     p_sock->get_poll_group()->mark_socket_to_destroy(p_sock);
@@ -5958,6 +7513,10 @@ void tcp_timers_collection::handle_timer_expired(void *user_data)
         }
     }
 
+    // Backstop for the paced senders when the rings are not polled
+    g_pacing_wheel.process();
+    g_tcp_timewait.process();
+
     /* Processing all messages for the daemon */
     if (g_p_agent) {
         g_p_agent->progress();
@@ -5997,7 +7556,13 @@ void tcp_timers_collection::remove_timer(sockinfo_tcp *sock)
 {
     auto node = m_sock_remove_map.find(sock);
     if (node != m_sock_remove_map.end()) {
-        m_p_intervals[std::get<0>(node->second)].erase(std::get<1>(node->second));
+        uint32_t bucket = std::get<0>(node->second);
+        if (bucket == PARKED_BUCKET) {
+            m_keepalive_wheel.remove(sock->get_keepalive_node());
+            m_parked.erase(std::get<1>(node->second));
+        } else {
+            m_p_intervals[bucket].erase(std::get<1>(node->second));
+        }
         m_sock_remove_map.erase(node);
         sock->set_timer_registered(false);
 
@@ -6015,6 +7580,113 @@ void tcp_timers_collection::remove_timer(sockinfo_tcp *sock)
     }
 }
 
+void tcp_timers_collection::wake_timer(sockinfo_tcp *sock)
+{
+    m_woken_lock.lock();
+    m_woken.push_back(sock);
+    m_woken_lock.unlock();
+}
+
+void tcp_timers_collection::unpark_woken_timers()
+{
+    m_woken_lock.lock();
+    m_woken_batch.swap(m_woken);
+    m_woken_lock.unlock();
+
+    for (sockinfo_tcp *sock : m_woken_batch) {
+        // A socket removed meanwhile isn't found, it is not dereferenced
+        auto node = m_sock_remove_map.find(sock);
+        if (node != m_sock_remove_map.end() && std::get<0>(node->second) == PARKED_BUCKET) {
+            unpark_timer(sock, node->second);
+        }
+    }
+    m_woken_batch.clear();
+}
+
+void tcp_timers_collection::park_timer(sockinfo_tcp *sock, sock_list &bucket, sock_list_itr itr,
+                                       uint32_t keepalive_ticks)
+{
+    m_parked.splice(m_parked.end(), bucket, itr);
+    std::get<0>(m_sock_remove_map[sock]) = PARKED_BUCKET;
+    if (keepalive_ticks) {
+        tcp_keepalive_node *node = sock->get_keepalive_node();
+        node->sock = sock;
+        m_keepalive_wheel.add(node, keepalive_ticks);
+    }
+}
+
+void tcp_timers_collection::unpark_timer(sockinfo_tcp *sock,
+                                         std::tuple<uint32_t, sock_list_itr> &location)
+{
+    sock_list &bucket = m_p_intervals[m_n_next_insert_bucket];
+
+    m_keepalive_wheel.remove(sock->get_keepalive_node());
+    bucket.splice(bucket.end(), m_parked, std::get<1>(location));
+    std::get<0>(location) = m_n_next_insert_bucket;
+    m_n_next_insert_bucket = (m_n_next_insert_bucket + 1) % m_n_intervals_size;
+}
+
+/*
+ * The keepalives of the parked sockets are sent without ticking the sockets in between. The due
+ * ones are grouped by the TX ring, so a batch of probes rings a single doorbell.
+ */
+void tcp_timers_collection::process_keepalives()
+{
+    m_keepalive_wheel.advance(static_cast<u32_t>(tcp_ticks - m_keepalive_ticks));
+    m_keepalive_ticks = tcp_ticks;
+    if (!m_keepalive_wheel.has_expired()) {
+        return;
+    }
+
+    while (tcp_keepalive_node *node = m_keepalive_wheel.pop_expired()) {
+        m_keepalive_batch.push_back(node->sock);
+    }
+    std::sort(m_keepalive_batch.begin(), m_keepalive_batch.end(),
+              [](sockinfo_tcp *a, sockinfo_tcp *b) { return a->get_tx_ring() < b->get_tx_ring(); });
+
+    ring *p_batch_ring = nullptr;
+    for (sockinfo_tcp *p_sock : m_keepalive_batch) {
+        ring *p_ring = p_sock->get_tx_ring();
+        if (p_ring != p_batch_ring) {
+            if (p_batch_ring) {
+                p_batch_ring->tx_doorbell_batch_end();
+            }
+            p_batch_ring = p_ring;
+            if (p_batch_ring) {
+                p_batch_ring->tx_doorbell_batch_begin();
+            }
+        }
+
+        if (p_sock->trylock_tcp_con()) {
+            // Retried on the next tick
+            m_keepalive_wheel.add(p_sock->get_keepalive_node(), 1U);
+            continue;
+        }
+        bool destroyable = false;
+        bool parked = false;
+        uint32_t keepalive_ticks = 0U;
+        if (!p_sock->is_cleaned()) {
+            p_sock->handle_keepalive_expired();
+            destroyable = p_sock->is_destroyable_no_lock();
+            parked = !destroyable && p_sock->try_park_timer(keepalive_ticks);
+        }
+        p_sock->unlock_tcp_con();
+
+        if (parked) {
+            if (keepalive_ticks) {
+                m_keepalive_wheel.add(p_sock->get_keepalive_node(), keepalive_ticks);
+            }
+        } else {
+            // The connection timed out, the ticks take it over
+            unpark_timer(p_sock, m_sock_remove_map[p_sock]);
+        }
+    }
+    if (p_batch_ring) {
+        p_batch_ring->tx_doorbell_batch_end();
+    }
+    m_keepalive_batch.clear();
+}
+
 thread_local_tcp_timers::thread_local_tcp_timers()
     : tcp_timers_collection(1)
 {
@@ -6151,6 +7823,10 @@ int sockinfo_tcp::tcp_tx_express(const struct iovec *iov, unsigned iov_len, uint
     if (flags & XLIO_EXPRESS_MSG_SND_BUF) {
         m_snd_buf -= bytes_written;
     }
+    lat_hist_tx_queued();
+    if (unlikely(m_tx_wm_high)) {
+        tx_watermark_check_high();
+    }
 
     if (!(flags & XLIO_EXPRESS_MSG_MORE)) {
         tcp_output(&m_pcb);
@@ -6194,6 +7870,10 @@ int sockinfo_tcp::tcp_tx_express_inline(const struct iovec *iov, unsigned iov_le
         m_p_socket_stats->counters.n_tx_sent_byte_count += bytes_written;
         m_p_socket_stats->counters.n_tx_sent_pkt_count++;
     }
+    lat_hist_tx_queued();
+    if (unlikely(m_tx_wm_high)) {
+        tx_watermark_check_high();
+    }
 
     if (!(flags & XLIO_EXPRESS_MSG_MORE)) {
         m_b_xlio_socket_dirty = false;
@@ -6207,13 +7887,22 @@ int sockinfo_tcp::tcp_tx_express_inline(const struct iovec *iov, unsigned iov_le
 
 void sockinfo_tcp::flush()
 {
+    // A ULP may hold data which isn't queued to the TCP yet
+    m_ops->tx_flush();
+
     std::lock_guard<decltype(m_tcp_con_lock)> lock(m_tcp_con_lock);
     m_b_xlio_socket_dirty = false;
     tcp_output(&m_pcb);
 }
 
-ssize_t sockinfo_tcp::tcp_tx_handle_done_and_unlock(ssize_t total_tx, int errno_tmp)
+ssize_t sockinfo_tcp::tcp_tx_handle_done_and_unlock(ssize_t total_tx, int errno_tmp,
+                                                    const xlio_tx_call_attr_t *tx_arg)
 {
+    lat_hist_tx_queued();
+    // A partially sent call doesn't report the timestamp
+    if (unlikely(tx_arg && is_tx_ts_requested(*tx_arg))) {
+        tx_ts_queued(0U);
+    }
     tcp_output(&m_pcb); // force data out
 
     if (unlikely(m_p_socket_stats)) {
@@ -6299,7 +7988,7 @@ ssize_t sockinfo_tcp::tcp_tx_handle_sndbuf_unavailable(ssize_t total_tx, int err
     } else {
         m_tx_consecutive_eagain_count++;
         if (m_tx_consecutive_eagain_count >= TX_CONSECUTIVE_EAGAIN_THREASHOLD) {
-            if (safe_mce_sys().tcp_ctl_thread ==
+            if (g_hot_sys_var.tcp_ctl_thread ==
                 option_tcp_ctl_thread::CTL_THREAD_DELEGATE_TCP_TIMERS) {
                 // Slow path. We must attempt TCP timers here for applications that
                 // do not check for EV_OUT.
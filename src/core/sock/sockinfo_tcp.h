@@ -12,9 +12,15 @@
 #include "sock/sockinfo.h"
 #include "dev/buffer_pool.h"
 #include "dev/cq_mgr_rx.h"
+#include "dev/pacing_wheel.h"
+#include "event/timer_wheel.h"
+#include "util/token_bucket.h"
+#include "util/seqlock.h"
+#include "util/mpsc_queue.h"
 #include "xlio_extra.h"
 #include <atomic>
 #include <vector>
+#include <deque>
 
 #include "lwip/opt.h"
 #include "lwip/tcp_impl.h"
@@ -25,8 +31,11 @@
 
 /* Forward declarations */
 struct xlio_socket_attr;
+struct tx_zcopy_op;
+struct poll_group_conn_pool;
 class poll_group;
 class sockinfo_tcp;
+class dst_entry_tcp;
 
 #define BLOCK_THIS_RUN(blocking, flags) (blocking && !(flags & MSG_DONTWAIT))
 
@@ -69,6 +78,14 @@ enum tcp_conn_state_e {
     TCP_CONN_RESETED
 };
 
+// Membership of an Ultra API socket in a connection pool of its group
+enum conn_pool_state_e : uint8_t {
+    CONN_POOL_NONE = 0, // Not pooled or handed out to the user
+    CONN_POOL_CONNECTING,
+    CONN_POOL_READY,
+    CONN_POOL_CLOSING, // Dropped by the pool, the user never learns about the socket
+};
+
 enum xlio_express_flags : uint32_t {
     XLIO_EXPRESS_OP_TYPE_DESC,
     XLIO_EXPRESS_OP_TYPE_FILE_ZEROCOPY,
@@ -104,6 +121,32 @@ struct socket_option_t {
     }
 };
 
+// The pcb fields of TCP_INFO, published at the ACK, timer and state change time
+struct tcp_info_snapshot {
+    uint8_t state; // enum tcp_state
+    uint8_t options; // TCPI_OPT_*
+    uint8_t retransmits;
+    uint32_t rto_usec;
+    uint32_t rtt_usec;
+    uint32_t rttvar_usec;
+    uint32_t rcv_rtt_usec;
+    uint32_t snd_mss;
+    uint32_t advmss;
+    uint32_t snd_cwnd; // In segments
+    uint32_t snd_ssthresh; // In segments
+    uint32_t unacked; // Segments in flight
+    uint32_t rcv_wnd;
+};
+
+// A parked socket with the keepalive on, in the keepalive wheel of its timers collection
+struct tcp_keepalive_node {
+    uint64_t expiry_msec; // In slow timer ticks
+    uint16_t wheel_slot;
+    tcp_keepalive_node *next;
+    tcp_keepalive_node *prev;
+    sockinfo_tcp *sock;
+};
+
 class tcp_timers_collection : public timer_handler, public cleanable_obj {
 public:
     tcp_timers_collection();
@@ -118,6 +161,9 @@ public:
 
     void remove_timer(sockinfo_tcp *sock);
 
+    // Brings a parked socket back to the ticks, called under the lock of the socket
+    void wake_timer(sockinfo_tcp *sock);
+
     void set_group(poll_group *group) { m_p_group = group; }
     inline event_handler_manager *get_event_mgr();
 
@@ -125,10 +171,30 @@ protected:
     void *m_timer_handle = nullptr;
 
 private:
+    // The bucket of the parked sockets in m_sock_remove_map
+    static constexpr uint32_t PARKED_BUCKET = UINT32_MAX;
+
     typedef std::list<sockinfo_tcp *> sock_list;
     typedef typename sock_list::iterator sock_list_itr;
+
+    void park_timer(sockinfo_tcp *sock, sock_list &bucket, sock_list_itr itr,
+                    uint32_t keepalive_ticks);
+    void unpark_timer(sockinfo_tcp *sock, std::tuple<uint32_t, sock_list_itr> &location);
+    void unpark_woken_timers();
+    void process_keepalives();
+
     std::vector<sock_list> m_p_intervals;
     std::unordered_map<sockinfo_tcp *, std::tuple<uint32_t, sock_list_itr>> m_sock_remove_map;
+    // The sockets without an armed timer are left out of the ticks until they are woken
+    sock_list m_parked;
+    std::vector<sockinfo_tcp *> m_woken;
+    std::vector<sockinfo_tcp *> m_woken_batch;
+    lock_spin m_woken_lock;
+    // The keepalives of the parked sockets by deadline, sent in a doorbell batch per ring
+    timer_wheel<tcp_keepalive_node> m_keepalive_wheel;
+    std::vector<sockinfo_tcp *> m_keepalive_batch;
+    u32_t m_keepalive_ticks = 0U;
+    bool m_b_park_idle;
     int m_n_intervals_size;
     int m_n_location = 0;
     int m_n_count = 0;
@@ -147,6 +213,8 @@ extern tcp_timers_collection *g_tcp_timers_collection;
 typedef std::deque<socket_option_t *> socket_options_list_t;
 typedef std::map<tcp_pcb *, int> ready_pcb_map_t;
 typedef std::map<flow_tuple, tcp_pcb *> syn_received_map_t;
+typedef std::list<std::pair<flow_tuple, dst_entry_tcp *>> syncookie_dst_lru_t;
+typedef std::map<flow_tuple, syncookie_dst_lru_t::iterator> syncookie_dst_map_t;
 typedef std::map<sock_addr, xlio_desc_list_t> peer_map_t;
 
 /* taken from inet_ecn.h in kernel */
@@ -158,7 +226,7 @@ enum inet_ecns {
     INET_ECN_MASK = 3,
 };
 
-class sockinfo_tcp : public sockinfo {
+class sockinfo_tcp : public sockinfo, public pacing_wheel::client {
 public:
     static inline size_t accepted_conns_node_offset()
     {
@@ -168,6 +236,10 @@ public:
     sockinfo_tcp(int fd, int domain);
     ~sockinfo_tcp() override;
 
+    // The memory of the sockets comes from the NUMA node slabs of sockinfo_pool.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
     void clean_socket_obj() override;
 
     void setPassthrough(bool _isPassthrough)
@@ -205,6 +277,11 @@ public:
     void listen_entity_context();
     int harvest_sockinfo_tcp_listen_objects();
     inline bool try_harvest_from_rss_child(size_t rss_child_index);
+    inline uint32_t collect_accepted_conns(sockinfo_tcp *listener);
+    inline bool has_accepted_conns() const
+    {
+        return m_ready_conn_cnt || !m_accept_queue.empty();
+    }
     void set_entity_context(entity_context *ctx) override;
 
     // Listen context management
@@ -230,6 +307,7 @@ public:
     inline bool handle_bind_no_port(int &bind_ret, in_port_t in_port, const sockaddr *__addr,
                                     socklen_t __addrlen);
     inline void non_tcp_recved(int rx_len);
+    void rcvbuff_autotune(int copied);
 
     void statistics_print(vlog_levels_t log_level = VLOG_DEBUG) override;
 
@@ -247,17 +325,35 @@ public:
     ssize_t tcp_tx_thread(xlio_tx_call_attr_t &tx_arg);
     void tx_thread_commit(mem_buf_desc_t *buf_list, uint32_t offset, uint32_t size,
                           int flags) override;
+    // Zero copy send in the Threads mode, the worker thread posts the application memory.
+    ssize_t tcp_tx_zcopy_thread(const iovec *iov, unsigned iovcnt, uint32_t mkey,
+                                uintptr_t userdata);
+    void tx_zcopy_thread_commit(tx_zcopy_op *op);
+    void tx_zcopy_complete(tx_zcopy_op *op);
+    unsigned tx_zcopy_poll_completions(uintptr_t *userdata, unsigned count);
     ssize_t rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, int *p_flags,
                sockaddr *__from = nullptr, socklen_t *__fromlen = nullptr,
                struct msghdr *__msg = nullptr) override;
+    int rx_zcopy(struct xlio_zcopy_buf *bufs, unsigned count, int flags) override;
+    void rx_zcopy_free(const struct xlio_zcopy_buf *bufs, unsigned count) override;
     static err_t ip_output(struct pbuf *p, struct tcp_seg *seg, void *v_p_conn, uint16_t flags);
     static err_t ip_output_syn_ack(struct pbuf *p, struct tcp_seg *seg, void *v_p_conn,
                                    uint16_t flags);
     static void tcp_state_observer(void *pcb_container, enum tcp_state new_state);
     static uint16_t get_route_mtu(struct tcp_pcb *pcb);
+    static uint16_t get_path_mtu(struct tcp_pcb *pcb);
+    static void set_path_mtu(struct tcp_pcb *pcb, uint16_t mtu);
+    static u32_t tcp_pacing_budget(struct tcp_pcb *pcb);
+    static void tcp_pacing_sent(struct tcp_pcb *pcb, u32_t sent);
+    static void tcp_pacing_rate(struct tcp_pcb *pcb, u64_t rate);
+    static void tcp_tmr_wake(struct tcp_pcb *pcb);
+    bool handle_pacing_release() override;
 
     void update_header_field(data_updater *updater) override;
     bool rx_input_cb(mem_buf_desc_t *p_rx_pkt_mem_buf_desc_info, void *pv_fd_ready_array) override;
+    /* Send the ACK coalesced during a poll of the RX ring */
+    void flush_coalesced_ack();
+    void cancel_coalesced_ack() { m_ack_coalesce_pending = false; }
     void abort_connection();
     void tcp_shutdown_rx();
 
@@ -282,7 +378,8 @@ public:
     bool is_closable() override
     {
         return get_tcp_state(&m_pcb) == CLOSED && m_syn_received.empty() &&
-            m_accepted_conns.empty();
+            m_accepted_conns.empty() && m_accept_queue.empty() &&
+            !__atomic_load_n(&m_zc_inflight, __ATOMIC_ACQUIRE);
     }
     bool inline is_destroyable_lock()
     {
@@ -335,14 +432,14 @@ public:
     inline fd_type_t get_type() override { return FD_TYPE_SOCKET; }
 
     void handle_timer_expired();
+    // Marks the timer of an idle connection parked, the collection stops ticking it then.
+    // keepalive_ticks is the delay of the keepalive in slow timer ticks, 0 if it's off.
+    bool try_park_timer(uint32_t &keepalive_ticks);
+    void handle_keepalive_expired() { tcp_slowtmr(&m_pcb); }
+    tcp_keepalive_node *get_keepalive_node() { return &m_keepalive_node; }
     bool is_timer_registered() const { return m_timer_registered; }
     void set_timer_registered(bool v) { m_timer_registered = v; }
 
-    inline ib_ctx_handler *get_ctx()
-    {
-        return m_p_connected_dst_entry ? m_p_connected_dst_entry->get_ctx() : nullptr;
-    }
-
     inline ring *get_tx_ring() const noexcept
     {
         return m_p_connected_dst_entry ? m_p_connected_dst_entry->get_ring() : nullptr;
@@ -375,6 +472,7 @@ public:
         }
     }
     inline void reset_ops() noexcept { set_ops(m_ops_tcp); }
+    inline bool has_ulp() const noexcept { return m_ops != m_ops_tcp; }
 
     bool is_utls_supported(int direction) const;
 
@@ -390,13 +488,39 @@ public:
                        void *opaque_op);
     int tcp_tx_express_inline(const struct iovec *iov, unsigned iov_len, unsigned flags);
     void flush();
+    // XLIO_SOCKET_SEND_FLAG_TIMESTAMP of the data queued by the last send
+    void tx_ts_xlio_socket(uintptr_t userdata_op);
     void make_dirty();
     void set_xlio_socket(const struct xlio_socket_attr *attr);
-    int update_xlio_socket(unsigned flags, uintptr_t userdata_sq);
     void add_tx_ring_to_group();
     int detach_xlio_group();
     int attach_xlio_group(poll_group *group);
+    int migrate_xlio_group(poll_group *group);
+    sockinfo_tcp *get_migrate_next() const { return m_migrate_next; }
+    void set_migrate_next(sockinfo_tcp *si) { m_migrate_next = si; }
+    poll_group *get_migrate_group() const { return m_migrate_group.load(std::memory_order_relaxed); }
+    void set_migrate_group(poll_group *group)
+    {
+        m_migrate_group.store(group, std::memory_order_relaxed);
+    }
+    // Drop the socket from the inbox of the destination group of a pending migration
+    void cancel_migrate();
     void xlio_socket_event(int event, int value);
+    conn_pool_state_e get_conn_pool_state() const { return m_conn_pool_state; }
+    poll_group_conn_pool *get_conn_pool() const { return m_p_conn_pool; }
+    tscval_t get_conn_pool_start_tsc() const { return m_conn_pool_start_tsc; }
+    void set_conn_pool(poll_group_conn_pool *pool, conn_pool_state_e state)
+    {
+        m_p_conn_pool = pool;
+        m_conn_pool_state = state;
+        if (state == CONN_POOL_CONNECTING) {
+            gettimeoftsc(&m_conn_pool_start_tsc);
+        }
+    }
+    // Bytes queued and not acknowledged yet, the measure of SO_XLIO_TX_WATERMARKS
+    uint32_t tx_queued_bytes() const { return m_pcb.snd_lbb - m_pcb.lastack; }
+    void tx_watermark_check_high();
+    void tx_watermark_check_low();
     static err_t rx_lwip_cb_xlio_socket(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
     static void err_lwip_cb_xlio_socket(void *pcb_container, err_t err);
 
@@ -412,12 +536,44 @@ protected:
 private:
     int fcntl_helper(int __cmd, unsigned long int __arg, bool &bexit);
     void get_tcp_info(struct tcp_info *ti);
+    // Called under the connection lock
+    void publish_tcp_info();
+    // Publishes the loss recovery events and the limited time, adds their growth to the ring
+    void publish_tcp_loss();
+    // Path MTU discovered by lwIP, see set_path_mtu()
+    void update_path_mtu(uint16_t mtu);
 
     inline void lwip_pbuf_init_custom(mem_buf_desc_t *p_desc);
 
     void tcp_timer();
+    // Sends the partial segment held by TCP_CORK or MSG_MORE for longer than the timeout
+    void cork_timer();
+    // TCP_CORK or MSG_MORE of the send, called under the connection lock
+    void tx_cork_update(int flags)
+    {
+        if (unlikely(m_b_cork || (flags & MSG_MORE))) {
+            m_pcb.flags |= TF_CORK;
+        } else {
+            m_pcb.flags &= ~TF_CORK;
+        }
+    }
+    bool is_timer_idle();
+    void wake_timer();
+    void rearm_parked_timer();
+    // Replaces the TIME_WAIT of a closed outbound connection with a compact record
+    void timewait_compact();
+    int set_sw_pacing(const struct xlio_rate_limit_t &rate_limit);
+    void set_cc_pacing_rate(uint64_t rate);
     bool poll_and_progress_rx(uint64_t &poll_sn);
     bool check_last_rx_poll_progress(unsigned int prev_sndbuf, bool all_drained);
+    // Take the samples of the latency histograms, called under the connection lock
+    inline void lat_hist_tx_queued();
+    inline void lat_hist_tx_sent(const struct tcp_seg *seg, uint16_t flags);
+    inline void lat_hist_acked(uint32_t lastack);
+    // TX HW timestamp requests, called under the connection lock
+    void tx_ts_queued(uintptr_t userdata_op);
+    bool tx_ts_match(const struct tcp_seg *seg, uint16_t flags, tx_ts_request &req);
+    void tx_ts_reset_key() override { m_tx_ts_next_key = m_pcb.snd_lbb; }
     bool prepare_listen_to_close();
     void remove_received_syn_socket(sockinfo_tcp *accepted);
     void accept_connection_xlio_socket(sockinfo_tcp *new_sock);
@@ -435,6 +591,12 @@ private:
 
     static err_t syn_received_drop_lwip_cb(void *arg, struct tcp_pcb *newpcb);
 
+    // Called when a SYN is answered with a SYN cookie, sends the <SYN,ACK> from the listen
+    // socket through a destination shared by the SYNs of the same peer
+    static err_t syn_cookie_lwip_cb(void *arg, struct tcp_pcb *pcb,
+                                    const struct tcp_syncookie_req *req);
+    dst_entry_tcp *get_syncookie_dst(const struct tcp_syncookie_req *req);
+
     static err_t clone_conn_cb(void *arg, struct tcp_pcb **newpcb);
 
     // Called by L3_level_tcp_input to unlock a new pcb/socket.
@@ -467,18 +629,25 @@ private:
     // rx
     static err_t ack_recvd_lwip_cb(void *arg, struct tcp_pcb *tpcb, u32_t acked);
 
-    ssize_t tcp_tx_handle_done_and_unlock(ssize_t total_tx, int errno_tmp);
+    ssize_t tcp_tx_handle_done_and_unlock(ssize_t total_tx, int errno_tmp,
+                                          const xlio_tx_call_attr_t *tx_arg = nullptr);
     ssize_t tcp_tx_handle_errno_and_unlock(int error_number);
     ssize_t tcp_tx_handle_partial_send_and_unlock(ssize_t total_tx, int errno_to_report,
                                                   int errno_to_restore);
     ssize_t tcp_tx_handle_sndbuf_unavailable(ssize_t total_tx, int errno_to_restore);
     ssize_t tcp_tx_slow_path(xlio_tx_call_attr_t &tx_arg);
+    ssize_t tcp_tx_user_zerocopy(xlio_tx_call_attr_t &tx_arg, bool is_blocking);
     err_t handle_fin(struct tcp_pcb *pcb, err_t err);
     void handle_rx_lwip_cb_error(pbuf *p);
     void rx_lwip_cb_error(pbuf *p);
     inline void rx_lwip_process_chained_pbufs(pbuf *p);
     inline void rx_lwip_shrink_rcv_wnd(size_t pbuf_tot_len, int nbytes);
     inline void save_packet_info_in_ready_list(pbuf *p);
+    bool rx_compact_into_tail(pbuf *p);
+    bool rx_place_start(const iovec *p_iov, ssize_t sz_iov, size_t size, int in_flags);
+    bool rx_place_packet(pbuf *p);
+    void rx_place_advance(size_t len);
+    size_t rx_place_stop();
     // Be sure that m_pcb is initialized
     void set_conn_properties_from_pcb();
     void set_sock_options(sockinfo_tcp *new_sock);
@@ -499,6 +668,7 @@ private:
      * Supported only for UDP
      */
     void handle_ip_pktinfo(struct cmsg_state *) override {};
+    void handle_udp_gro(struct cmsg_state *) override {};
 
     int handle_rx_error(bool blocking);
 
@@ -520,6 +690,8 @@ private:
     inline void return_pending_tx_buffs();
     inline void reuse_buffer(mem_buf_desc_t *buff);
     mem_buf_desc_t *get_next_desc(mem_buf_desc_t *p_desc) override;
+    void pop_ready_desc(mem_buf_desc_t *p_desc);
+    void rx_consumed(int total_rx);
     mem_buf_desc_t *get_next_desc_peek(mem_buf_desc_t *p_desc, int &rx_pkt_ready_list_idx) override;
     timestamps_t *get_socket_timestamps() override;
 
@@ -580,7 +752,10 @@ private:
     inline int rx_wait_lockless(int &poll_count, bool blocking);
     int rx_wait_helper(int &poll_count, bool blocking);
     void fit_rcv_wnd(bool force_fit);
+    int rcv_wnd_desired() const;
     void fit_snd_bufs(uint32_t new_snd_buf_max);
+    void sndbuf_autotune_grow();
+    void sndbuf_autotune_release();
     bool rx_tls_msg(struct msghdr *__msg, mem_buf_desc_t *out_buf);
 
     inline struct tcp_seg *get_tcp_seg_cached();
@@ -612,17 +787,50 @@ private:
     tcp_sock_state_e m_sock_state;
     std::atomic<int32_t> m_snd_buf;
     uint32_t m_snd_buf_max;
+    /* SNDBUF autotuning: the size without the growth and the idle timer ticks */
+    uint32_t m_snd_buf_base;
+    uint32_t m_snd_buf_idle_ticks;
+    bool m_snd_buf_autotune;
     sockinfo_tcp *m_parent;
     // received packet source (true if its from internal thread)
     bool m_b_incoming;
     bool m_b_attached;
     bool m_timer_registered = false;
+    tcp_keepalive_node m_keepalive_node = {};
+    // Manager of the socket timer, the owner thread's one with the delegated TCP timers
+    event_handler_manager *m_p_timer_event_mgr = nullptr;
+    // TCP_FASTOPEN_CONNECT: the SYN of connect() carries the first data
+    bool m_tfo_connect = false;
+    // The coalesced ACK is registered in an RX ring for the end of its poll
+    bool m_ack_coalesce_pending = false;
+    // Read by TCP_INFO without the connection lock
+    seqlock_data<tcp_info_snapshot> m_tcp_info;
+    // TCP_CORK and the timer ticks of the held partial segment
+    bool m_b_cork = false;
+    uint32_t m_cork_ticks = 0U;
+    token_bucket m_pacing_bucket;
     /* connection state machine */
     int m_conn_timeout;
     /* RCVBUF acconting */
     int m_rcvbuff_max;
     int m_rcvbuff_current;
     int m_rcvbuff_non_tcp_recved;
+    /* RCVBUF autotuning: initial size, the data read by the application in the current
+     * round trip, the most read in a round trip so far and the start of the round trip */
+    bool m_rcvbuff_autotune;
+    int m_rcvbuff_initial;
+    uint32_t m_rcv_space_copied;
+    uint32_t m_rcv_space;
+    uint32_t m_rcv_space_time;
+    /* MSG_WAITALL read filled by the RX path, see rx_place_packet(). The iovecs are a copy of
+     * the reader ones, advanced as the data is placed */
+    struct {
+        std::vector<iovec> iov;
+        size_t iov_idx = 0U;
+        size_t size = 0U; // Of the request, 0 while no read waits
+        size_t placed = 0U;
+        bool nt = false; // Copied with non-temporal stores
+    } m_rx_place;
     tcp_conn_state_e m_conn_state;
     struct linger m_linger;
 
@@ -636,9 +844,18 @@ private:
     // Relevant only for listen sockets: map connections in syn received state
     // We need this map since for syn received connection no sockinfo is created yet!
     syn_received_map_t m_syn_received;
+    // Relevant only for listen sockets: destinations of the SYN cookie <SYN,ACK>s, keyed by
+    // the local and the remote addresses
+    syncookie_dst_lru_t m_syncookie_dst_lru;
+    syncookie_dst_map_t m_syncookie_dst_map;
 
     /* pending connections */
     sock_list_t m_accepted_conns;
+    /* Connections established by the RX processing. The acceptor moves them to m_accepted_conns
+     * without the lock of the listen socket which the RX processing would contend on.
+     */
+    sockinfo_tcp *m_accept_next = nullptr;
+    mpsc_queue<sockinfo_tcp, &sockinfo_tcp::m_accept_next> m_accept_queue;
 
     uint32_t m_ready_conn_cnt;
     int m_backlog;
@@ -663,16 +880,43 @@ private:
     unsigned m_tx_consecutive_eagain_count;
     bool m_sysvar_rx_poll_on_tx_tcp;
     uint16_t m_external_vlan_tag = 0U;
+    // SO_XLIO_TX_WATERMARKS, a zero high disables the events
+    bool m_tx_congested = false;
+    uint32_t m_tx_wm_low = 0U;
+    uint32_t m_tx_wm_high = 0U;
+    // A latency histogram sample completes once the ACK reaches its seqno, 0 TSC if none
+    tscval_t m_lat_send_tsc = 0U;
+    tscval_t m_lat_rtt_tsc = 0U;
+    uint32_t m_lat_send_seqno = 0U;
+    uint32_t m_lat_rtt_seqno = 0U;
+    // TX HW timestamp requests, by the seqno after their last byte
+    struct tx_ts_pending {
+        uint32_t seqno;
+        uint32_t key;
+        uintptr_t userdata_op;
+    };
+    std::deque<tx_ts_pending> m_tx_ts_pending;
     /*
      * XLIO Ultra API
      * TODO Move the fields to proper cold/hot sections in the final version.
      */
     bool m_b_xlio_socket_dirty = false;
-    uintptr_t m_xlio_socket_userdata = 0;
     rfs_rule *m_p_rule_extracted = nullptr;
+    // Link in the destination group migration inbox
+    sockinfo_tcp *m_migrate_next = nullptr;
+    // Destination group while the socket is in its migration inbox
+    std::atomic<poll_group *> m_migrate_group {nullptr};
+    conn_pool_state_e m_conn_pool_state = CONN_POOL_NONE;
+    poll_group_conn_pool *m_p_conn_pool = nullptr;
+    tscval_t m_conn_pool_start_tsc = 0U;
 
     mem_buf_desc_t *m_store = nullptr;
     uint32_t m_store_offset = 0;
+    // Completed zero copy sends, filled by the worker thread and read by the application
+    lock_spin m_zc_completions_lock;
+    std::deque<uintptr_t> m_zc_completions;
+    // send(MSG_ZEROCOPY) calls waiting for the completion of their buffers
+    uint32_t m_zc_inflight = 0U;
 
     // Listen context - allocated only for listen sockets
     sockinfo_tcp_listen_context *m_listen_ctx = nullptr;
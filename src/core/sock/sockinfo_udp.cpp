@@ -22,11 +22,13 @@
 #include "sock/sock-redirect.h"
 #include "sock/fd_collection.h"
 #include "event/event_handler_manager.h"
+#include "event/poll_group.h"
 #include "dev/buffer_pool.h"
 #include "dev/ring.h"
 #include "dev/ring_slave.h"
 #include "dev/ring_bond.h"
 #include "dev/ring_simple.h"
+#include "dev/gro_mgr.h"
 #include "proto/route_table_mgr.h"
 #include "proto/rule_table_mgr.h"
 #include "proto/dst_entry_tcp.h"
@@ -36,6 +38,7 @@
 #include "iomux/io_mux_call.h"
 #include "util/instrumentation.h"
 #include "dev/ib_ctx_handler_collection.h"
+#include "sock/sockinfo_pool.h"
 
 /* useful debugging macros */
 
@@ -57,6 +60,23 @@
 #define UDP_MAP_ADD    101
 #define UDP_MAP_REMOVE 102
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+/*
+ * The SO_REUSEPORT groups of the bound addresses. A socket of a group owns a source port bucket
+ * and receives it through its own steering rule, so the group spreads by the source port in the
+ * adapter instead of behind a shared socket. The socket of slot 0 keeps the 3 tuple rule which
+ * also catches the buckets without a socket.
+ */
+typedef std::unordered_map<sock_addr, std::vector<sockinfo_udp *>> reuseport_group_map_t;
+static reuseport_group_map_t s_reuseport_groups;
+static lock_mutex s_reuseport_lock("udp_reuseport");
+
 /**/
 /** inlining functions can only help if they are implemented before their usage **/
 /**/
@@ -101,7 +121,7 @@ inline int sockinfo_udp::rx_wait(bool blocking)
     while (loops_to_go) {
 
         // Multi-thread polling support - let other threads have a go on this CPU
-        if ((m_n_sysvar_rx_poll_yield_loops > 0) &&
+        if ((m_n_sysvar_rx_poll_yield_loops > 0) && !m_prefer_busy_poll &&
             ((loops % m_n_sysvar_rx_poll_yield_loops) == (m_n_sysvar_rx_poll_yield_loops - 1))) {
             sched_yield();
         }
@@ -124,9 +144,12 @@ inline int sockinfo_udp::rx_wait(bool blocking)
         }
 
         loops++;
-        if (!blocking || safe_mce_sys().rx_poll_num != -1) {
+        if (!blocking || m_rx_poll_num != -1) {
             loops_to_go--;
         }
+        if (blocking && (m_busy_poll_tsc || m_rx_poll_adaptive) && !rx_poll_budget_left(loops)) {
+            break;
+        }
         if (m_loops_timer.is_timeout()) {
             errno = EAGAIN;
             return -1;
@@ -178,11 +201,14 @@ inline int sockinfo_udp::rx_wait(bool blocking)
         // release lock so other threads that wait on this socket will not consume CPU
         /* coverity[double_lock] TODO: RM#1049980 */
         m_lock_rcv.lock();
-        if (!m_n_rx_pkt_ready_list_count) {
-            m_sock_wakeup_pipe.going_to_sleep();
+        m_sock_wakeup.going_to_sleep();
+        // Pairs with the fence of update_ready() which queues to m_rx_ready_ring without the lock
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!rx_ready_pkt_count()) {
             /* coverity[double_unlock] TODO: RM#1049980 */
             m_lock_rcv.unlock();
         } else {
+            m_sock_wakeup.return_from_sleep();
             m_lock_rcv.unlock();
             continue;
         }
@@ -191,7 +217,7 @@ inline int sockinfo_udp::rx_wait(bool blocking)
 
         /* coverity[double_lock] TODO: RM#1049980 */
         m_lock_rcv.lock();
-        m_sock_wakeup_pipe.return_from_sleep();
+        m_sock_wakeup.return_from_sleep();
         /* coverity[double_unlock] TODO: RM#1049980 */
         m_lock_rcv.unlock();
 
@@ -228,10 +254,10 @@ inline int sockinfo_udp::rx_wait(bool blocking)
             // Run through all ready fd's
             for (int event_idx = 0; event_idx < ret; ++event_idx) {
                 int fd = rx_epfd_events[event_idx].data.fd;
-                if (m_sock_wakeup_pipe.is_wakeup_fd(fd)) {
+                if (m_sock_wakeup.is_wakeup_fd(fd)) {
                     /* coverity[double_lock] TODO: RM#1049980 */
                     m_lock_rcv.lock();
-                    m_sock_wakeup_pipe.remove_wakeup_fd();
+                    m_sock_wakeup.remove_wakeup_fd();
                     /* coverity[double_unlock] TODO: RM#1049980 */
                     m_lock_rcv.unlock();
                     continue;
@@ -333,6 +359,31 @@ const char *setsockopt_level_to_str(int level)
 // Throttle the amount of ring polling we do (remember last time we check for receive packets)
 tscval_t g_si_tscv_last_poll = 0;
 
+void *sockinfo_udp::operator new(size_t size)
+{
+    sockinfo_pool *pool = sockinfo_pool::udp_instance();
+
+    if (!pool) {
+        return ::operator new(size);
+    }
+    void *obj = pool->get_obj();
+    if (!obj) {
+        throw std::bad_alloc();
+    }
+    return obj;
+}
+
+void sockinfo_udp::operator delete(void *ptr)
+{
+    sockinfo_pool *pool = sockinfo_pool::udp_instance();
+
+    if (ptr && pool) {
+        pool->return_obj(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
 sockinfo_udp::sockinfo_udp(int fd, int domain)
     : sockinfo(fd, domain, true)
     , m_mc_tx_src_ip(in6addr_any, domain)
@@ -347,6 +398,7 @@ sockinfo_udp::sockinfo_udp(int fd, int domain)
     , m_port_map_lock("sockinfo_udp::m_ports_map_lock")
     , m_port_map_index(0)
     , m_p_last_dst_entry(nullptr)
+    , m_rx_ready_ring_lock("sockinfo_udp::m_rx_ready_ring_lock")
     , m_n_sysvar_rx_poll_yield_loops(safe_mce_sys().rx_poll_yield_loops)
     , m_n_sysvar_rx_udp_poll_os_ratio(safe_mce_sys().rx_udp_poll_os_ratio)
     , m_n_sysvar_rx_ready_byte_min_limit(safe_mce_sys().rx_ready_byte_min_limit)
@@ -416,13 +468,11 @@ sockinfo_udp::~sockinfo_udp()
     rx_ready_byte_count_limit_update(0);
 
     // Clear the dst_entry map
-    dst_entry_map_t::iterator dst_entry_iter = m_dst_entry_map.begin();
-    while (dst_entry_iter != m_dst_entry_map.end()) {
-        delete dst_entry_iter
-            ->second; // TODO ALEXR - should we check and delete the udp_mc in MC cases?
-        m_dst_entry_map.erase(dst_entry_iter);
-        dst_entry_iter = m_dst_entry_map.begin();
+    for (auto &entry : m_dst_entry_lru) {
+        delete entry.second; // TODO ALEXR - should we check and delete the udp_mc in MC cases?
     }
+    m_dst_entry_lru.clear();
+    m_dst_entry_map.clear();
 
     /* AlexR:
        We don't have to be nice and delete the fd. close() will do that any way.
@@ -434,9 +484,11 @@ sockinfo_udp::~sockinfo_udp()
         }
     */
     m_lock_rcv.lock();
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     destructor_helper();
+    // The bucket is given away only after the rules of the socket are detached
+    reuseport_slot_release();
 
     m_lock_rcv.unlock();
 
@@ -474,11 +526,10 @@ int sockinfo_udp::bind_no_os()
     si_udp_logdbg("bound to %s", m_bound.to_str_ip_port(true).c_str());
 
     if (!m_bound.is_anyaddr() && !m_bound.is_mc()) {
-        auto bind_addr_to_dest_entry =
-            [&](std::pair<const sock_addr, dst_entry *> dst_entry_key_val) {
-                dst_entry_key_val.second->set_bound_addr(m_bound.get_ip_addr());
-            };
-        std::for_each(m_dst_entry_map.begin(), m_dst_entry_map.end(), bind_addr_to_dest_entry);
+        auto bind_addr_to_dest_entry = [&](std::pair<sock_addr, dst_entry *> &dst_entry_key_val) {
+            dst_entry_key_val.second->set_bound_addr(m_bound.get_ip_addr());
+        };
+        std::for_each(m_dst_entry_lru.begin(), m_dst_entry_lru.end(), bind_addr_to_dest_entry);
     }
 
     return 0;
@@ -736,6 +787,7 @@ int sockinfo_udp::on_sockname_change(struct sockaddr *__name, socklen_t __namele
         if ((m_bound.is_anyaddr() ||
              g_p_net_device_table_mgr->get_net_device_val(
                  ip_addr(m_bound.get_ip_addr(), m_bound.get_sa_family())))) {
+            reuseport_slot_acquire();
             attach_as_uc_receiver(ROLE_UDP_RECEIVER); // if failed, we will get RX from OS
         } else if (m_bound.is_mc()) {
             // MC address binding will happen later as part of the ADD_MEMBERSHIP in
@@ -764,10 +816,35 @@ int sockinfo_udp::setsockopt(int __level, int __optname, __const void *__optval,
         return SYSCALL(setsockopt, m_fd, __level, __optname, __optval, __optlen);
     }
 
+    if (__level == SOL_SOCKET &&
+        (__optname == SO_XLIO_ADD_MEMBERSHIPS || __optname == SO_XLIO_DROP_MEMBERSHIPS)) {
+        // Every entry takes the socket locks on its own
+        return mc_change_membership_batch(__optname, __optval, __optlen);
+    }
+
+    if (__level == SOL_SOCKET && __optname == SO_XLIO_RX_DROP_POLICY) {
+        if (!__optval || __optlen != sizeof(int) ||
+            (*(int *)__optval != XLIO_RX_DROP_NEWEST && *(int *)__optval != XLIO_RX_DROP_OLDEST)) {
+            errno = EINVAL;
+            return -1;
+        }
+        m_lock_rcv.lock();
+        m_rx_drop_oldest = (*(int *)__optval == XLIO_RX_DROP_OLDEST);
+        m_rx_over_limit.store(false, std::memory_order_relaxed);
+        m_lock_rcv.unlock();
+        si_udp_logdbg("SOL_SOCKET, %s=%d", setsockopt_so_opt_to_str(__optname),
+                      *(int *)__optval);
+        return 0;
+    }
+
     std::lock_guard<decltype(m_lock_snd)> lock_tx(m_lock_snd);
     std::lock_guard<decltype(m_lock_rcv)> lock_rx(m_lock_rcv);
 
     int ret = sockinfo::setsockopt(__level, __optname, __optval, __optlen);
+    if (__level == SOL_SOCKET && (__optname == SO_XLIO_RX_POLL || __optname == SO_BUSY_POLL) &&
+        m_b_blocking && !m_rx_ring_map.empty()) {
+        m_loops_to_go = m_rx_poll_num;
+    }
     if (ret != SOCKOPT_PASS_TO_OS) {
         return (ret == SOCKOPT_HANDLE_BY_OS
                     ? setsockopt_kernel(__level, __optname, __optval, __optlen, true, false)
@@ -841,10 +918,8 @@ int sockinfo_udp::setsockopt(int __level, int __optname, __const void *__optval,
                 if (m_p_connected_dst_entry) {
                     m_p_connected_dst_entry->set_so_bindtodevice_addr(m_so_bindtodevice_ip);
                 } else {
-                    dst_entry_map_t::iterator dst_entry_iter = m_dst_entry_map.begin();
-                    while (dst_entry_iter != m_dst_entry_map.end()) {
-                        dst_entry_iter->second->set_so_bindtodevice_addr(m_so_bindtodevice_ip);
-                        dst_entry_iter++;
+                    for (auto &entry : m_dst_entry_lru) {
+                        entry.second->set_so_bindtodevice_addr(m_so_bindtodevice_ip);
                     }
                 }
 
@@ -884,10 +959,8 @@ int sockinfo_udp::setsockopt(int __level, int __optname, __const void *__optval,
                 }
 
                 size_t dst_entries_not_modified = 0;
-                dst_entry_map_t::iterator dst_entry_iter;
-                for (dst_entry_iter = m_dst_entry_map.begin();
-                     dst_entry_iter != m_dst_entry_map.end(); ++dst_entry_iter) {
-                    dst_entry *p_dst_entry = dst_entry_iter->second;
+                for (auto &entry : m_dst_entry_lru) {
+                    dst_entry *p_dst_entry = entry.second;
                     if (modify_ratelimit(p_dst_entry, val) < 0) {
                         si_udp_logdbg("error setting setsockopt SO_MAX_PACING_RATE "
                                       "for dst_entry %p: %d bytes/second ",
@@ -898,8 +971,8 @@ int sockinfo_udp::setsockopt(int __level, int __optname, __const void *__optval,
                 // It is possible that the user has a setup with some NICs that support
                 // packet pacing and some that don't.
                 // Setting packet pacing fails only if all NICs do not support it.
-                if (m_dst_entry_map.size() &&
-                    (dst_entries_not_modified == m_dst_entry_map.size())) {
+                if (m_dst_entry_lru.size() &&
+                    (dst_entries_not_modified == m_dst_entry_lru.size())) {
                     return -1;
                 }
                 return 0;
@@ -1261,6 +1334,23 @@ int sockinfo_udp::setsockopt(int __level, int __optname, __const void *__optval,
             m_port_map_lock.unlock();
             return 0;
         }
+        case UDP_SEGMENT: {
+            // Validated by the kernel as well, the option is passed to the OS below
+            if (__optval && __optlen >= sizeof(int)) {
+                int val = *(const int *)__optval;
+                if (val >= 0 && val <= USHRT_MAX) {
+                    m_udp_gso_size = static_cast<uint16_t>(val);
+                    si_udp_logdbg("IPPROTO_UDP, UDP_SEGMENT=%d", val);
+                }
+            }
+        } break;
+        case UDP_GRO:
+            // The option is passed to the OS below, for the not offloaded traffic
+            if (__optval && __optlen >= sizeof(int)) {
+                m_b_udp_gro = *(const int *)__optval != 0;
+                si_udp_logdbg("IPPROTO_UDP, UDP_GRO=%d", m_b_udp_gro);
+            }
+            break;
         default:
             si_udp_logdbg("IPPROTO_UDP, optname=%s (%d)", setsockopt_ip_opt_to_str(__optname),
                           __optname);
@@ -1648,6 +1738,18 @@ int sockinfo_udp::getsockopt(int __level, int __optname, void *__optval, socklen
             si_udp_logdbg("SOL_SOCKET, SO_SNDBUF=%d", *(int *)__optval);
             break;
 
+        case SO_XLIO_RX_DROP_POLICY:
+            if (*__optlen >= sizeof(int)) {
+                *(int *)__optval = m_rx_drop_oldest ? XLIO_RX_DROP_OLDEST : XLIO_RX_DROP_NEWEST;
+                *__optlen = sizeof(int);
+                si_udp_logdbg("SOL_SOCKET, SO_XLIO_RX_DROP_POLICY=%d", *(int *)__optval);
+                ret = 0;
+            } else {
+                errno = EINVAL;
+                ret = -1;
+            }
+            break;
+
         case SO_MAX_PACING_RATE:
             ret = sockinfo::getsockopt(__level, __optname, __optval, __optlen);
             break;
@@ -1706,6 +1808,7 @@ void sockinfo_udp::rx_ready_byte_count_limit_update(size_t n_rx_ready_bytes_limi
 void sockinfo_udp::drop_rx_ready_byte_count(size_t n_rx_bytes_limit)
 {
     m_lock_rcv.lock();
+    rx_ready_ring_drain();
     while (m_n_rx_pkt_ready_list_count) {
         /* coverity[returned_null : FALSE] */
         mem_buf_desc_t *p_rx_pkt_desc = m_rx_pkt_ready_list.front();
@@ -1727,6 +1830,46 @@ void sockinfo_udp::drop_rx_ready_byte_count(size_t n_rx_bytes_limit)
     m_lock_rcv.unlock();
 }
 
+void sockinfo_udp::rx_ready_drop_oldest(size_t sz_payload)
+{
+    m_lock_rcv.lock();
+    rx_ready_ring_drain();
+    while (m_n_rx_pkt_ready_list_count &&
+           m_rx_ready_byte_count + sz_payload > m_rx_ready_byte_limit) {
+        /* coverity[returned_null : FALSE] */
+        mem_buf_desc_t *p_rx_pkt_desc = m_rx_pkt_ready_list.front();
+        m_rx_pkt_ready_list.pop_front();
+        m_n_rx_pkt_ready_list_count--;
+        m_rx_ready_byte_count -= p_rx_pkt_desc->rx.sz_payload;
+        if (m_p_socket_stats) {
+            m_p_socket_stats->n_rx_ready_pkt_count--;
+            m_p_socket_stats->n_rx_ready_byte_count -= p_rx_pkt_desc->rx.sz_payload;
+            m_p_socket_stats->counters.n_rx_ready_byte_drop += p_rx_pkt_desc->rx.sz_payload;
+            m_p_socket_stats->counters.n_rx_ready_pkt_drop++;
+        }
+        reuse_buffer(p_rx_pkt_desc);
+    }
+    return_reuse_buffers_postponed();
+    m_lock_rcv.unlock();
+}
+
+// Called by the ring instead of rx_input_cb() while m_rx_over_limit is set
+bool sockinfo_udp::rx_over_limit_drop(mem_buf_desc_t *p_desc)
+{
+    if (rx_ready_byte_count() < m_rx_ready_byte_limit) {
+        // The reader made room, the datagram takes the regular path
+        m_rx_over_limit.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    si_udp_logfunc("rx packet discarded by the ring - socket limit reached (%d bytes)",
+                   m_rx_ready_byte_limit);
+    if (m_p_socket_stats) {
+        m_p_socket_stats->counters.n_rx_ready_byte_drop += p_desc->rx.sz_payload;
+        m_p_socket_stats->counters.n_rx_ready_pkt_drop++;
+    }
+    return true;
+}
+
 ssize_t sockinfo_udp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, int *p_flags,
                          sockaddr *__from, socklen_t *__fromlen, struct msghdr *__msg)
 {
@@ -1738,6 +1881,10 @@ ssize_t sockinfo_udp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
 
     si_udp_logfunc("");
 
+    if (unlikely(in_flags & MSG_ERRQUEUE)) {
+        return rx_errqueue(call_type, p_iov, sz_iov, p_flags, __from, __fromlen, __msg);
+    }
+
     m_lock_rcv.lock();
 
     if (unlikely(m_state == SOCKINFO_DESTROYING)) {
@@ -1777,11 +1924,12 @@ ssize_t sockinfo_udp::rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov
     }
 
     // First check if we have a packet in the ready list
-    if ((m_n_rx_pkt_ready_list_count > 0 &&
+    if ((rx_ready_pkt_count() > 0 &&
          m_n_sysvar_rx_cq_drain_rate_nsec == MCE_RX_CQ_DRAIN_RATE_DISABLED) ||
         is_readable(&poll_sn)) {
         /* coverity[double_lock] TODO: RM#1049980 */
         m_lock_rcv.lock();
+        rx_ready_ring_drain();
         m_rx_udp_poll_os_ratio_counter++;
         if (m_n_rx_pkt_ready_list_count > 0) {
             // Found a ready packet in the list
@@ -1802,11 +1950,13 @@ wait:
      */
     si_udp_logfunc("rx_wait: %d", m_fd);
     rx_wait_ret = rx_wait(m_b_blocking && !(in_flags & MSG_DONTWAIT));
+    rx_wait_end();
 
     m_lock_rcv.lock();
 
     if (likely(rx_wait_ret == 0)) {
         // Got 0, means we might have a ready packet
+        rx_ready_ring_drain();
         if (m_n_rx_pkt_ready_list_count > 0) {
             if (__msg) {
                 handle_cmsg(__msg);
@@ -1856,6 +2006,168 @@ out:
     return ret;
 }
 
+// Poll every RX ring once without waiting, the batch is taken from what is ready after it
+inline void sockinfo_udp::rx_poll_rings(uint64_t *p_poll_sn)
+{
+    consider_rings_migration_rx();
+    m_rx_ring_map_lock.lock();
+    for (auto &rx_ring : m_rx_ring_map) {
+        if (rx_ring.second->refcnt > 0) {
+            rx_ring.first->poll_and_process_element_rx(p_poll_sn);
+        }
+    }
+    m_rx_ring_map_lock.unlock();
+}
+
+int sockinfo_udp::rx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int *p_flags)
+{
+    int errno_tmp = errno;
+    int in_flags = *p_flags;
+    uint64_t poll_sn = 0;
+    unsigned num = 0;
+    unsigned batch = 0;
+
+    if (unlikely(in_flags & MSG_PEEK) || vlen == 1) {
+        return sockinfo::rx_mmsg(mmsg, vlen, p_flags);
+    }
+
+    if (static_cast<unsigned>(rx_ready_pkt_count()) < vlen) {
+        rx_poll_rings(&poll_sn);
+    }
+
+    // With nothing ready or the OS due for a poll, the first message takes the regular path which
+    // waits for it and may receive it from the OS
+    if (rx_ready_pkt_count() == 0 ||
+        ((m_n_sysvar_rx_udp_poll_os_ratio > 0) &&
+         (m_rx_udp_poll_os_ratio_counter >= m_n_sysvar_rx_udp_poll_os_ratio))) {
+        if (sockinfo::rx_mmsg(mmsg, 1, p_flags) < 0) {
+            return -1;
+        }
+        num = 1;
+        errno_tmp = errno;
+    }
+
+    m_lock_rcv.lock();
+
+    if (unlikely(m_state == SOCKINFO_DESTROYING)) {
+        m_lock_rcv.unlock();
+        if (num) {
+            return num;
+        }
+        errno = EBADFD;
+        return -1;
+    }
+
+    save_stats_threadid_rx();
+    return_reuse_buffers_postponed();
+    rx_ready_ring_drain();
+
+    while (num < vlen && m_n_rx_pkt_ready_list_count > 0) {
+        struct msghdr *msg = &mmsg[num].msg_hdr;
+        int out_flags = 0;
+
+        msg->msg_flags = 0;
+        handle_cmsg(msg);
+        mmsg[num].msg_len = dequeue_packet(msg->msg_iov, msg->msg_iovlen, (sockaddr *)msg->msg_name,
+                                           &msg->msg_namelen, in_flags, &out_flags);
+        msg->msg_flags |= out_flags & MSG_TRUNC;
+        ++num;
+        ++batch;
+    }
+    m_rx_udp_poll_os_ratio_counter += batch;
+
+    m_lock_rcv.unlock();
+
+    if (unlikely(num == 0)) {
+        // Another thread took the ready datagrams meanwhile
+        return sockinfo::rx_mmsg(mmsg, 1, p_flags);
+    }
+
+    errno = errno_tmp;
+    si_udp_logfunc("returning with: %u messages", num);
+    return num;
+}
+
+int sockinfo_udp::rx_zcopy(struct xlio_zcopy_buf *bufs, unsigned count, int flags)
+{
+    int errno_tmp = errno;
+    mem_buf_desc_t *pdesc;
+    unsigned i = 0;
+    int ret = 0;
+
+    m_lock_rcv.lock();
+
+    if (unlikely(m_state == SOCKINFO_DESTROYING)) {
+        errno = EBADFD;
+        ret = -1;
+        goto out;
+    }
+
+    save_stats_threadid_rx();
+    return_reuse_buffers_postponed();
+    rx_ready_ring_drain();
+
+    while (m_n_rx_pkt_ready_list_count == 0) {
+        m_lock_rcv.unlock();
+        ret = rx_wait(m_b_blocking && !(flags & MSG_DONTWAIT));
+        rx_wait_end();
+        /* coverity[double_lock] TODO: RM#1049980 */
+        m_lock_rcv.lock();
+        rx_ready_ring_drain();
+        if (unlikely(ret > 0)) {
+            // The datagram is in the OS, only recv() can copy it out
+            errno = ENODATA;
+            ret = -1;
+        }
+        if (unlikely(ret < 0)) {
+            goto out;
+        }
+    }
+
+    pdesc = m_rx_pkt_ready_list.front();
+    if (unlikely(static_cast<unsigned>(pdesc->rx.n_frags) > count)) {
+        errno = EMSGSIZE;
+        ret = -1;
+        goto out;
+    }
+    for (mem_buf_desc_t *frag = pdesc; frag; frag = frag->p_next_desc) {
+        bufs[i].data = frag->rx.frag.iov_base;
+        bufs[i].len = frag->rx.frag.iov_len;
+        bufs[i].buf = (frag == pdesc) ? pdesc->to_xlio_buf() : nullptr;
+        ++i;
+    }
+
+    // The application owns the datagram until rx_zcopy_free()
+    m_rx_pkt_ready_list.pop_front();
+    lat_hist_rx_dequeued(pdesc);
+    m_n_rx_pkt_ready_list_count--;
+    m_rx_ready_byte_count -= pdesc->rx.sz_payload;
+    if (m_p_socket_stats) {
+        m_p_socket_stats->n_rx_ready_pkt_count--;
+        m_p_socket_stats->n_rx_ready_byte_count -= pdesc->rx.sz_payload;
+    }
+    save_stats_rx_offload(pdesc->rx.sz_payload);
+    ret = static_cast<int>(i);
+    errno = errno_tmp;
+
+out:
+    /* coverity[double_unlock] TODO: RM#1049980 */
+    m_lock_rcv.unlock();
+    return ret;
+}
+
+void sockinfo_udp::rx_zcopy_free(const struct xlio_zcopy_buf *bufs, unsigned count)
+{
+    m_lock_rcv.lock();
+    for (unsigned i = 0; i < count; ++i) {
+        if (bufs[i].buf) {
+            reuse_buffer(mem_buf_desc_t::from_xlio_buf(bufs[i].buf));
+        }
+    }
+    return_reuse_buffers_postponed();
+    m_lock_rcv.unlock();
+}
+
 void sockinfo_udp::handle_ip_pktinfo(struct cmsg_state *cm_state)
 {
     mem_buf_desc_t *p_desc = m_rx_pkt_ready_list.front();
@@ -1896,6 +2208,17 @@ void sockinfo_udp::handle_ip_pktinfo(struct cmsg_state *cm_state)
     }
 }
 
+void sockinfo_udp::handle_udp_gro(struct cmsg_state *cm_state)
+{
+    mem_buf_desc_t *p_desc = m_rx_pkt_ready_list.front();
+
+    // Like the kernel, report the segment size only for the coalesced datagrams
+    if (p_desc && p_desc->rx.gro_size) {
+        int gso_size = p_desc->rx.gro_size;
+        insert_cmsg(cm_state, SOL_UDP, UDP_GRO, &gso_size, sizeof(gso_size));
+    }
+}
+
 // This function is relevant only for non-blocking socket
 void sockinfo_udp::set_immediate_os_sample()
 {
@@ -1915,7 +2238,7 @@ bool sockinfo_udp::is_readable(uint64_t *p_poll_sn, fd_array_t *p_fd_ready_array
     // Check local list of ready rx packets
     // This is the quickest way back to the user with a ready packet (which will happen if we don't
     // force draining of the CQ)
-    if (m_n_rx_pkt_ready_list_count > 0) {
+    if (rx_ready_pkt_count() > 0) {
 
         if (m_n_sysvar_rx_cq_drain_rate_nsec == MCE_RX_CQ_DRAIN_RATE_DISABLED) {
             si_udp_logfunc("=> true (ready count = %d packets / %d bytes)",
@@ -1954,7 +2277,7 @@ bool sockinfo_udp::is_readable(uint64_t *p_poll_sn, fd_array_t *p_fd_ready_array
                 // We need here a lock() version of poll_and_process_element_rx.
                 bool was_drained = p_ring->poll_and_process_element_rx(p_poll_sn, p_fd_ready_array);
 
-                if (m_n_rx_pkt_ready_list_count) {
+                if (rx_ready_pkt_count()) {
                     // Get out of the CQ polling loop
                     si_udp_logfunc("=> polled true (ready count = %d packets / %d bytes)",
                                    m_n_rx_pkt_ready_list_count, m_rx_ready_byte_count);
@@ -1972,7 +2295,7 @@ bool sockinfo_udp::is_readable(uint64_t *p_poll_sn, fd_array_t *p_fd_ready_array
     // This check is added in case we processed all wce and drained the cq
     // TODO: handle the scenario of 2 thread accessing the same socket - might need to lock
     // m_n_rx_pkt_ready_list_count
-    if (m_n_rx_pkt_ready_list_count) {
+    if (rx_ready_pkt_count()) {
         si_udp_logfunc("=> true (ready count = %d packets / %d bytes)", m_n_rx_pkt_ready_list_count,
                        m_rx_ready_byte_count);
         return true;
@@ -2013,6 +2336,37 @@ int sockinfo_udp::rx_request_notification(uint64_t poll_sn)
     return ring_ready_count;
 }
 
+int sockinfo_udp::tx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int flags)
+{
+    ring *p_ring = nullptr;
+
+    // Defer the doorbell of the socket's ring, so the batch is rung once and, where the ring
+    // supports it, the datagrams are packed into multi-packet WQEs. The ring can't be held
+    // across a TX migration.
+    if (vlen > 1U && safe_mce_sys().ring_migration_ratio_tx <= 0) {
+        m_lock_snd.lock();
+        dst_entry *p_dst_entry = m_p_connected_dst_entry ?: m_p_last_dst_entry;
+        if (p_dst_entry && p_dst_entry->is_valid() && p_dst_entry->is_offloaded()) {
+            p_ring = p_dst_entry->get_ring();
+        }
+        if (p_ring) {
+            p_ring->tx_doorbell_batch_begin();
+            ++m_n_tx_batches;
+        }
+        m_lock_snd.unlock();
+    }
+
+    int ret = sockinfo::tx_mmsg(mmsg, vlen, flags);
+
+    if (p_ring) {
+        m_lock_snd.lock();
+        --m_n_tx_batches;
+        m_lock_snd.unlock();
+        p_ring->tx_doorbell_batch_end();
+    }
+    return ret;
+}
+
 ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
 {
     /* coverity[nonnull] */
@@ -2080,7 +2434,9 @@ ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
 
                 // Fast path
                 // We found our target dst_entry object
-                m_p_last_dst_entry = p_dst_entry = dst_entry_iter->second;
+                m_dst_entry_lru.splice(m_dst_entry_lru.end(), m_dst_entry_lru,
+                                       dst_entry_iter->second);
+                m_p_last_dst_entry = p_dst_entry = dst_entry_iter->second->second;
                 // coverity[copy_assignment_call:FALSE] /*Turn off check COPY_INSTEAD_OF_MOVE*/
                 m_last_sock_addr = dst;
             } else {
@@ -2128,7 +2484,9 @@ ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
                 p_dst_entry->set_src_sel_prefs(m_src_sel_flags);
 
                 // Save new dst_entry in map
-                m_dst_entry_map[dst] = p_dst_entry;
+                m_dst_entry_map[dst] =
+                    m_dst_entry_lru.emplace(m_dst_entry_lru.end(), dst, p_dst_entry);
+                dst_entry_cache_trim();
             }
         }
     } else if (unlikely(!p_dst_entry)) {
@@ -2138,14 +2496,24 @@ ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
     }
 
     {
-        xlio_send_attr attr = {(xlio_wr_tx_packet_attr)0, 0, 0, nullptr};
+        xlio_send_attr attr = {(xlio_wr_tx_packet_attr)0, 0, 0, nullptr, nullptr};
+        tx_ts_request ts_req;
         bool b_blocking = m_b_blocking;
         if (unlikely(__flags & MSG_DONTWAIT)) {
             b_blocking = false;
         }
 
         attr.length = static_cast<size_t>(sz_data_payload);
-        attr.flags = (xlio_wr_tx_packet_attr)((b_blocking * XLIO_TX_PACKET_BLOCK));
+        attr.flags = (xlio_wr_tx_packet_attr)((b_blocking * XLIO_TX_PACKET_BLOCK) |
+                                              (m_is_xlio_socket * XLIO_TX_SKIP_POLL));
+        attr.mss = get_tx_gso_size(tx_arg);
+        if (unlikely(tx_arg.xlio_attr
+                         ? (tx_arg.xlio_attr->flags & XLIO_SOCKET_SEND_FLAG_TIMESTAMP)
+                         : is_tx_ts_requested(tx_arg))) {
+            ts_req = tx_ts_make_request(m_tx_ts_next_key++,
+                                        tx_arg.xlio_attr ? tx_arg.xlio_attr->userdata_op : 0U);
+            attr.ts = &ts_req;
+        }
         if (likely(p_dst_entry->is_valid())) {
             // All set for fast path packet sending - this is our best performance flow
             ret = p_dst_entry->fast_send(p_iov, sz_iov, attr);
@@ -2153,6 +2521,10 @@ ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
             // updates the dst_entry internal information and packet headers
             ret = p_dst_entry->slow_send(p_iov, sz_iov, attr, m_so_ratelimit, __flags, this,
                                          tx_arg.opcode);
+            if (m_p_group) {
+                // TX completions of an XLIO socket are polled by the group.
+                add_tx_ring_to_group(p_dst_entry);
+            }
         }
 
         // Condition for cache optimization
@@ -2174,6 +2546,10 @@ ssize_t sockinfo_udp::tx(xlio_tx_call_attr_t &tx_arg)
         NOTIFY_ON_EVENTS(this, EPOLLOUT);
 
         save_stats_tx_offload(ret);
+        if (unlikely(m_b_zerocopy && (__flags & MSG_ZEROCOPY)) && ret >= 0) {
+            // The datagrams are copied to the TX buffers
+            zc_notify(zc_alloc_id(), true);
+        }
 
         m_lock_snd.unlock();
 
@@ -2192,10 +2568,15 @@ tx_packet_to_os:
     // coverity[FORWARD_NULL : FALSE]
     // coverity[var_deref_model : FALSE]
     // coverity[null_dereference : FALSE]
-    ret = tx_os(tx_arg.opcode, p_iov, sz_iov, __flags, __dst, __dstlen);
+    // The completion is reported by XLIO, as the ids of the offloaded sends
+    ret = tx_os(tx_arg.opcode, p_iov, sz_iov, m_b_zerocopy ? (__flags & ~MSG_ZEROCOPY) : __flags,
+                __dst, __dstlen);
 
 tx_packet_to_os_stats:
     save_stats_tx_os(ret);
+    if (unlikely(m_b_zerocopy && (__flags & MSG_ZEROCOPY)) && ret >= 0) {
+        zc_notify(zc_alloc_id(), true);
+    }
     m_lock_snd.unlock();
     return ret;
 }
@@ -2209,6 +2590,24 @@ void sockinfo_udp::tx_thread_commit(mem_buf_desc_t *buf_list, uint32_t offset, u
     NOT_IN_USE(flags);
 }
 
+uint16_t sockinfo_udp::get_tx_gso_size(const xlio_tx_call_attr_t &tx_arg)
+{
+    uint16_t gso_size = m_udp_gso_size;
+
+    /* UDP_SEGMENT control message overrides the socket option for a single send */
+    if (tx_arg.opcode == TX_SENDMSG && tx_arg.attr.hdr && tx_arg.attr.hdr->msg_controllen) {
+        struct msghdr *__msg = const_cast<struct msghdr *>(tx_arg.attr.hdr);
+        struct cmsghdr *cmsg;
+        for (cmsg = CMSG_FIRSTHDR(__msg); cmsg; cmsg = CMSG_NXTHDR(__msg, cmsg)) {
+            if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_SEGMENT &&
+                cmsg->cmsg_len == CMSG_LEN(sizeof(uint16_t))) {
+                gso_size = *reinterpret_cast<uint16_t *>(CMSG_DATA(cmsg));
+            }
+        }
+    }
+    return gso_size;
+}
+
 ssize_t sockinfo_udp::check_payload_size(const iovec *p_iov, ssize_t sz_iov)
 {
     // Calc user data payload size
@@ -2236,8 +2635,9 @@ int sockinfo_udp::rx_verify_available_data()
     int ret;
 
     // Don't poll cq if offloaded data is ready
-    if (!m_rx_pkt_ready_list.empty()) {
+    if (rx_ready_pkt_count() > 0) {
         std::lock_guard<decltype(m_lock_rcv)> locker(m_lock_rcv);
+        rx_ready_ring_drain();
         if (!m_rx_pkt_ready_list.empty()) {
             /* coverity[returned_null][null_deref] */
             return m_rx_pkt_ready_list.front()->rx.sz_payload;
@@ -2249,6 +2649,7 @@ int sockinfo_udp::rx_verify_available_data()
     if (ret == 0) {
         // Got 0, means we might have a ready packet
         std::lock_guard<decltype(m_lock_rcv)> locker(m_lock_rcv);
+        rx_ready_ring_drain();
         if (!m_rx_pkt_ready_list.empty()) {
             ret = m_rx_pkt_ready_list.front()->rx.sz_payload;
         }
@@ -2274,10 +2675,10 @@ int sockinfo_udp::rx_verify_available_data()
  *	Performs packet processing and store packet
  *	in ready queue.
  */
-inline void sockinfo_udp::update_ready(mem_buf_desc_t *p_desc, void *pv_fd_ready_array)
+inline void sockinfo_udp::rx_ready_list_push(mem_buf_desc_t *p_desc)
 {
-    m_lock_rcv.lock();
-    // Save rx packet info in our ready list
+    // Assume locked by m_lock_rcv
+    lat_hist_rx_queued(p_desc);
     m_rx_pkt_ready_list.push_back(p_desc);
     m_n_rx_pkt_ready_list_count++;
     m_rx_ready_byte_count += p_desc->rx.sz_payload;
@@ -2289,16 +2690,189 @@ inline void sockinfo_udp::update_ready(mem_buf_desc_t *p_desc, void *pv_fd_ready
         m_p_socket_stats->counters.n_rx_ready_byte_max = std::max(
             (uint32_t)m_rx_ready_byte_count, m_p_socket_stats->counters.n_rx_ready_byte_max);
     }
-    m_sock_wakeup_pipe.do_wakeup();
-    m_lock_rcv.unlock();
+}
+
+// Move the datagrams handed over by the polling threads to the ready list
+inline void sockinfo_udp::rx_ready_ring_drain()
+{
+    // Assume locked by m_lock_rcv
+    mem_buf_desc_t *p_desc;
+
+    while (m_rx_ready_ring.pop(p_desc)) {
+        rx_ready_list_push(p_desc);
+        m_rx_ready_ring_bytes_out.store(
+            m_rx_ready_ring_bytes_out.load(std::memory_order_relaxed) + p_desc->rx.sz_payload,
+            std::memory_order_release);
+    }
+}
 
-    NOTIFY_ON_EVENTS(this, EPOLLIN);
+inline void sockinfo_udp::update_ready(mem_buf_desc_t *p_desc, void *pv_fd_ready_array,
+                                       rx_fanout *p_fanout)
+{
+    size_t sz_payload = p_desc->rx.sz_payload;
+
+    // The bytes are accounted before the datagram becomes visible to the reader
+    m_rx_ready_ring_lock.lock();
+    m_rx_ready_ring_bytes_in.fetch_add(sz_payload, std::memory_order_relaxed);
+    bool queued = m_rx_ready_ring.push(p_desc);
+    if (unlikely(!queued)) {
+        m_rx_ready_ring_bytes_in.fetch_sub(sz_payload, std::memory_order_relaxed);
+    }
+    m_rx_ready_ring_lock.unlock();
+
+    if (unlikely(!queued)) {
+        // The reader is behind, queue the datagram after the ones in the ring
+        m_lock_rcv.lock();
+        rx_ready_ring_drain();
+        rx_ready_list_push(p_desc);
+        m_sock_wakeup.do_wakeup();
+        m_lock_rcv.unlock();
+    } else {
+        // Pairs with the fence of rx_wait(): either the reader sees the datagram before it goes
+        // to sleep or the sleeping reader is seen here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (unlikely(m_sock_wakeup.is_sleeping())) {
+            m_lock_rcv.lock();
+            m_sock_wakeup.do_wakeup();
+            m_lock_rcv.unlock();
+        }
+    }
+
+    if (p_fanout && has_epoll_context() && !get_entity_context()) {
+        // The epoll set is notified once for all the sockets of the dispatch
+        p_fanout->epoll_ready.emplace_back(get_epoll_context(), this);
+    } else {
+        NOTIFY_ON_EVENTS(this, EPOLLIN);
+    }
 
     // Add this fd to the ready fd list
     io_mux_call::update_fd_array((fd_array_t *)pv_fd_ready_array, m_fd);
 
-    si_udp_logfunc("rx ready count = %d packets / %d bytes", m_n_rx_pkt_ready_list_count,
-                   m_rx_ready_byte_count);
+    si_udp_logfunc("rx ready count = %d packets / %zu bytes", rx_ready_pkt_count(),
+                   rx_ready_byte_count());
+}
+
+/*
+ * Coalesce the datagram into the last ready datagram of the same flow, as UDP GRO does.
+ * The segments are chained by p_next_desc the same way as IP fragments. Only the head holds
+ * a reference, its p_prev_desc points to the last segment like in rfs_uc_tcp_gro.
+ * A segment shorter than the segment size closes the chain.
+ * Returns false if the datagram must be queued on its own.
+ */
+inline bool sockinfo_udp::rx_gro_append(mem_buf_desc_t *p_desc)
+{
+    size_t seg_len = p_desc->rx.frag.iov_len;
+    bool ret = false;
+
+    if (unlikely(p_desc->rx.n_frags != 1 || seg_len != p_desc->rx.sz_payload || !seg_len)) {
+        return false;
+    }
+
+    m_lock_rcv.lock();
+    rx_ready_ring_drain();
+    mem_buf_desc_t *p_head = m_rx_pkt_ready_list.back();
+    if (p_head && p_head->rx.n_frags < MAX_GRO_BUFS &&
+        p_head->rx.sz_payload + seg_len <= MAX_AGGR_BYTE_PER_STREAM &&
+        p_head->rx.src == p_desc->rx.src && p_head->rx.dst == p_desc->rx.dst &&
+        p_head->rx.udp.ifindex == p_desc->rx.udp.ifindex) {
+        mem_buf_desc_t *p_last = nullptr;
+        size_t gro_size = 0;
+
+        if (p_head->rx.gro_size) {
+            gro_size = p_head->rx.gro_size;
+            p_last = p_head->p_prev_desc;
+        } else if (p_head->rx.n_frags == 1 && p_head->rx.frag.iov_len == p_head->rx.sz_payload) {
+            gro_size = p_head->rx.frag.iov_len;
+            p_last = p_head;
+        }
+
+        if (p_last && seg_len <= gro_size && p_last->rx.frag.iov_len == gro_size) {
+            p_desc->p_next_desc = nullptr;
+            p_last->p_next_desc = p_desc;
+            p_head->p_prev_desc = p_desc;
+            p_head->rx.gro_size = static_cast<uint16_t>(gro_size);
+            p_head->rx.n_frags++;
+            p_head->rx.sz_payload += seg_len;
+            m_rx_ready_byte_count += seg_len;
+            if (unlikely(m_p_socket_stats)) {
+                m_p_socket_stats->n_rx_ready_byte_count += seg_len;
+                m_p_socket_stats->counters.n_rx_ready_byte_max =
+                    std::max((uint32_t)m_rx_ready_byte_count,
+                             m_p_socket_stats->counters.n_rx_ready_byte_max);
+            }
+            ret = true;
+        }
+    }
+    m_lock_rcv.unlock();
+
+    return ret;
+}
+
+// Drops the least recently used destinations beyond network.protocols.udp.dst_cache_size
+void sockinfo_udp::dst_entry_cache_trim()
+{
+    size_t max_size = safe_mce_sys().udp_dst_cache_size;
+
+    while (max_size && m_dst_entry_lru.size() > max_size && !m_n_tx_batches) {
+        dst_entry *p_dst_entry = m_dst_entry_lru.front().second;
+
+        if (p_dst_entry == m_p_last_dst_entry) {
+            m_p_last_dst_entry = nullptr;
+        }
+        m_dst_entry_map.erase(m_dst_entry_lru.front().first);
+        m_dst_entry_lru.pop_front();
+        // The path of the destination is kept by the path cache of the process
+        delete p_dst_entry;
+    }
+}
+
+void sockinfo_udp::reuseport_slot_acquire()
+{
+    if (!safe_mce_sys().udp_reuseport_buckets || !m_reuseport || m_is_connected) {
+        return;
+    }
+    if (m_reuseport_slot >= 0) {
+        if (m_reuseport_addr == m_bound) {
+            return;
+        }
+        reuseport_slot_release();
+    }
+
+    std::lock_guard<decltype(s_reuseport_lock)> lock(s_reuseport_lock);
+    std::vector<sockinfo_udp *> &slots = s_reuseport_groups[m_bound];
+    if (slots.empty()) {
+        slots.resize(safe_mce_sys().udp_reuseport_buckets, nullptr);
+    }
+    auto iter = std::find(slots.begin(), slots.end(), nullptr);
+    if (iter == slots.end()) {
+        // The group is full, the socket shares the rule of the first socket
+        si_udp_logdbg("no free reuseport bucket for %s", m_bound.to_str_ip_port(true).c_str());
+        return;
+    }
+    *iter = this;
+    m_reuseport_slot = static_cast<int>(iter - slots.begin());
+    m_reuseport_addr = m_bound;
+    si_udp_logdbg("reuseport bucket %d of %zu for %s", m_reuseport_slot, slots.size(),
+                  m_bound.to_str_ip_port(true).c_str());
+}
+
+void sockinfo_udp::reuseport_slot_release()
+{
+    if (m_reuseport_slot < 0) {
+        return;
+    }
+
+    std::lock_guard<decltype(s_reuseport_lock)> lock(s_reuseport_lock);
+    auto group = s_reuseport_groups.find(m_reuseport_addr);
+    if (group != s_reuseport_groups.end()) {
+        std::vector<sockinfo_udp *> &slots = group->second;
+        slots[m_reuseport_slot] = nullptr;
+        if (std::count(slots.begin(), slots.end(), nullptr) ==
+            static_cast<std::ptrdiff_t>(slots.size())) {
+            s_reuseport_groups.erase(group);
+        }
+    }
+    m_reuseport_slot = -1;
 }
 
 bool sockinfo_udp::packet_is_loopback(mem_buf_desc_t *p_desc)
@@ -2310,6 +2884,17 @@ bool sockinfo_udp::packet_is_loopback(mem_buf_desc_t *p_desc)
 }
 
 bool sockinfo_udp::rx_input_cb(mem_buf_desc_t *p_desc, void *pv_fd_ready_array)
+{
+    return rx_input(p_desc, pv_fd_ready_array, nullptr);
+}
+
+bool sockinfo_udp::rx_input_cb_fanout(mem_buf_desc_t *p_desc, rx_fanout &fanout)
+{
+    return rx_input(p_desc, fanout.fd_ready_array, &fanout);
+}
+
+inline bool sockinfo_udp::rx_input(mem_buf_desc_t *p_desc, void *pv_fd_ready_array,
+                                   rx_fanout *p_fanout)
 {
     if (unlikely((m_state == SOCKINFO_DESTROYING) || g_b_exit)) {
         si_udp_logfunc("rx packet discarded - fd closed");
@@ -2317,12 +2902,32 @@ bool sockinfo_udp::rx_input_cb(mem_buf_desc_t *p_desc, void *pv_fd_ready_array)
     }
 
     /* Check if sockinfo rx byte SO_RCVBUF reached - then disregard this packet */
-    if (unlikely(m_rx_ready_byte_count >= m_rx_ready_byte_limit)) {
-        si_udp_logfunc("rx packet discarded - socket limit reached (%d bytes)",
-                       m_rx_ready_byte_limit);
+    if (unlikely(rx_ready_byte_count() >= m_rx_ready_byte_limit)) {
+        if (m_rx_drop_oldest && m_rx_ready_byte_limit) {
+            rx_ready_drop_oldest(p_desc->rx.sz_payload);
+        } else {
+            si_udp_logfunc("rx packet discarded - socket limit reached (%d bytes)",
+                           m_rx_ready_byte_limit);
+            if (m_p_socket_stats) {
+                m_p_socket_stats->counters.n_rx_ready_byte_drop += p_desc->rx.sz_payload;
+                m_p_socket_stats->counters.n_rx_ready_pkt_drop++;
+            }
+            // The next datagrams are dropped by the ring until the reader makes room
+            m_rx_over_limit.store(true, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    /* Check the buffers budget of the socket, the datagram is dropped like on a full SO_RCVBUF */
+    if (unlikely(safe_mce_sys().rx_socket_bufs_max &&
+                 static_cast<uint32_t>(rx_ready_pkt_count()) >=
+                     safe_mce_sys().rx_socket_bufs_max)) {
+        si_udp_logfunc("rx packet discarded - socket buffers budget reached (%u buffers)",
+                       safe_mce_sys().rx_socket_bufs_max);
         if (m_p_socket_stats) {
             m_p_socket_stats->counters.n_rx_ready_byte_drop += p_desc->rx.sz_payload;
             m_p_socket_stats->counters.n_rx_ready_pkt_drop++;
+            m_p_socket_stats->counters.n_rx_budget_limited++;
         }
         return false;
     }
@@ -2443,20 +3048,127 @@ bool sockinfo_udp::rx_input_cb(mem_buf_desc_t *p_desc, void *pv_fd_ready_array)
 
     process_timestamps(p_desc);
 
-    // We must increment ref_counter before pushing this packet into the ready queue
+    if (m_is_xlio_socket) {
+        return rx_input_cb_xlio_socket(p_desc);
+    }
+
+    save_strq_stats(p_desc->rx.strides_num);
+    if (unlikely(m_p_socket_stats)) {
+        m_p_socket_stats->counters.n_rx_bytes += p_desc->rx.sz_payload;
+        m_p_socket_stats->counters.n_rx_data_pkts++;
+    }
+    if (!m_b_udp_gro || !rx_gro_append(p_desc)) {
+        // We must increment ref_counter before pushing this packet into the ready queue
+        if (p_fanout) {
+            // Take one of the references preset by the dispatch
+            ++p_fanout->refs_used;
+        } else {
+            p_desc->inc_ref_count();
+        }
+        update_ready(p_desc, pv_fd_ready_array, p_fanout);
+    }
+    return true;
+}
+
+bool sockinfo_udp::rx_input_cb_xlio_socket(mem_buf_desc_t *p_desc)
+{
+    // IP fragmented datagrams are not supported, a single xlio_buf describes a single buffer.
+    if (unlikely((!m_p_group->m_socket_rx_cb && !m_p_group->m_socket_rx_batch_cb) ||
+                 p_desc->rx.n_frags > 1)) {
+        si_udp_logfunc("rx packet discarded - no rx callback or fragmented datagram");
+        return false;
+    }
+
+    // The reference is released by xlio_socket_buf_free() or xlio_poll_group_buf_free().
     p_desc->inc_ref_count();
     save_strq_stats(p_desc->rx.strides_num);
-    update_ready(p_desc, pv_fd_ready_array);
     if (unlikely(m_p_socket_stats)) {
         m_p_socket_stats->counters.n_rx_bytes += p_desc->rx.sz_payload;
         m_p_socket_stats->counters.n_rx_data_pkts++;
     }
+
+    if (m_p_group->m_socket_rx_batch_cb) {
+        m_p_group->add_rx_batch(this, p_desc->rx.frag.iov_base, p_desc->rx.frag.iov_len,
+                                p_desc->to_xlio_buf());
+    } else {
+        m_p_group->rx_cb(this, m_xlio_socket_userdata, p_desc->rx.frag.iov_base,
+                         p_desc->rx.frag.iov_len, p_desc->to_xlio_buf());
+    }
     return true;
 }
 
+void sockinfo_udp::get_xlio_buf_info(mem_buf_desc_t *p_desc, struct sockaddr *addr,
+                                     socklen_t *addrlen, struct timespec *hw_timestamp)
+{
+    if (addr && addrlen) {
+        p_desc->rx.src.get_sa_by_family(addr, *addrlen, m_family);
+    }
+    if (hw_timestamp) {
+        // Don't expose the raw HW timestamp, it's meaningless for the user.
+        *hw_timestamp = (m_n_tsing_flags & SOF_TIMESTAMPING_RAW_HARDWARE)
+            ? p_desc->rx.timestamps.hw
+            : timespec {0, 0};
+    }
+}
+
+void sockinfo_udp::set_xlio_socket(const struct xlio_socket_attr *attr)
+{
+    if (m_rx_epfd != -1) {
+        // XLIO Socket API doesn't use per socket epfd
+        m_sock_wakeup.wakeup_set_epoll_fd(0);
+        SYSCALL(close, m_rx_epfd);
+        m_rx_epfd = -1;
+    }
+
+    m_xlio_socket_userdata = attr->userdata_sq;
+    m_is_xlio_socket_high_prio = !!(attr->flags & XLIO_SOCKET_FLAG_HIGH_PRIO);
+    m_p_group = reinterpret_cast<poll_group *>(attr->group);
+
+    m_ring_alloc_log_rx.set_ring_alloc_logic(RING_LOGIC_PER_USER_ID);
+    m_ring_alloc_log_rx.set_user_id_key(reinterpret_cast<uint64_t>(m_p_group));
+    m_ring_alloc_log_rx.set_use_locks(!!(m_p_group->get_flags() & XLIO_GROUP_FLAG_SAFE));
+    m_ring_alloc_logic_rx = ring_allocation_logic_rx(get_fd(), m_ring_alloc_log_rx);
+
+    m_ring_alloc_log_tx.set_ring_alloc_logic(RING_LOGIC_PER_USER_ID);
+    m_ring_alloc_log_tx.set_user_id_key(reinterpret_cast<uint64_t>(m_p_group));
+    m_ring_alloc_log_tx.set_use_locks(!!(m_p_group->get_flags() & XLIO_GROUP_FLAG_SAFE));
+
+    set_blocking(false);
+    m_is_xlio_socket = true;
+}
+
+int sockinfo_udp::tx_xlio_socket(const struct iovec *iov, unsigned iovcnt,
+                                 const struct sockaddr *to, socklen_t tolen,
+                                 const struct xlio_socket_send_attr *attr)
+{
+    xlio_tx_call_attr_t tx_arg;
+
+    tx_arg.opcode = to ? TX_SENDTO : TX_SEND;
+    tx_arg.attr.iov = const_cast<struct iovec *>(iov);
+    tx_arg.attr.sz_iov = static_cast<ssize_t>(iovcnt);
+    tx_arg.attr.flags = MSG_DONTWAIT;
+    tx_arg.attr.addr = const_cast<struct sockaddr *>(to);
+    tx_arg.attr.len = tolen;
+    tx_arg.xlio_attr = attr;
+
+    return tx(tx_arg) < 0 ? -1 : 0;
+}
+
+void sockinfo_udp::add_tx_ring_to_group(dst_entry *p_dst_entry)
+{
+    ring *rng = p_dst_entry->get_ring();
+    if (m_p_group && rng) {
+        m_p_group->add_ring(rng, &m_ring_alloc_log_tx);
+    }
+}
+
 void sockinfo_udp::rx_add_ring_cb(ring *p_ring)
 {
     si_udp_logdbg("");
+    if (m_p_group) {
+        m_p_group->add_ring(p_ring, &m_ring_alloc_log_rx);
+    }
+
     sockinfo::rx_add_ring_cb(p_ring);
 
     // Now that we got at least 1 CQ attached enable the skip os mechanism.
@@ -2464,7 +3176,7 @@ void sockinfo_udp::rx_add_ring_cb(ring *p_ring)
 
     // Now that we got at least 1 CQ attached start polling the CQs
     if (m_b_blocking) {
-        m_loops_to_go = safe_mce_sys().rx_poll_num;
+        m_loops_to_go = m_rx_poll_num;
     } else {
         m_loops_to_go = 1; // Force single CQ poll in case of non-blocking socket
     }
@@ -2494,7 +3206,7 @@ void sockinfo_udp::set_blocking(bool is_blocked)
         // Set the high CQ polling RX_POLL value
         // depending on where we have mapped offloaded MC gorups
         if (m_rx_ring_map.size() > 0) {
-            m_loops_to_go = safe_mce_sys().rx_poll_num;
+            m_loops_to_go = m_rx_poll_num;
         } else {
             m_loops_to_go = safe_mce_sys().rx_poll_num_init;
         }
@@ -2760,6 +3472,35 @@ int sockinfo_udp::mc_change_membership_ip4(const mc_pending_pram *p_mc_pram)
     return 0;
 }
 
+int sockinfo_udp::mc_change_membership_batch(int optname, const void *optval, socklen_t optlen)
+{
+    const struct ip_mreqn *p_mreqn = reinterpret_cast<const struct ip_mreqn *>(optval);
+    int mc_optname =
+        (optname == SO_XLIO_ADD_MEMBERSHIPS ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP);
+
+    if (!optval || optlen == 0 || optlen % sizeof(struct ip_mreqn)) {
+        si_udp_logdbg("SOL_SOCKET, %s: bad optval/optlen=%d", setsockopt_so_opt_to_str(optname),
+                      optlen);
+        errno = EINVAL;
+        return -1;
+    }
+
+    size_t count = optlen / sizeof(struct ip_mreqn);
+    si_udp_logdbg("SOL_SOCKET, %s: %zu groups", setsockopt_so_opt_to_str(optname), count);
+
+    for (size_t i = 0; i < count; ++i) {
+        int ret = setsockopt(IPPROTO_IP, mc_optname, &p_mreqn[i], sizeof(struct ip_mreqn));
+        if (ret) {
+            si_udp_logdbg("SOL_SOCKET, %s: failed at group %zu (%s), errno=%d",
+                          setsockopt_so_opt_to_str(optname), i,
+                          ip_address(p_mreqn[i].imr_multiaddr).to_str(AF_INET).c_str(), errno);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
 int sockinfo_udp::mc_change_membership_start_helper_ip6(const mc_pending_pram *p_mc_pram)
 {
     int optname = p_mc_pram->optname;
@@ -2994,7 +3735,8 @@ void sockinfo_udp::statistics_print(vlog_levels_t log_level /* = VLOG_DEBUG */)
     sockinfo::statistics_print(log_level);
 
     // Socket data
-    vlog_printf(log_level, "Rx ready list size : %zu\n", m_rx_pkt_ready_list.size());
+    vlog_printf(log_level, "Rx ready list size : %zu\n",
+                m_rx_pkt_ready_list.size() + m_rx_ready_ring.size());
 
     vlog_printf(
         log_level, "Socket timestamp : m_b_rcvtstamp %s, m_b_rcvtstampns %s, m_n_tsing_flags %u\n",
@@ -3056,6 +3798,7 @@ void sockinfo_udp::post_dequeue()
 {
     mem_buf_desc_t *to_resue = m_rx_pkt_ready_list.get_and_pop_front();
     IF_STATS(m_p_socket_stats->n_rx_ready_pkt_count--);
+    lat_hist_rx_dequeued(to_resue);
     m_n_rx_pkt_ready_list_count--;
     reuse_buffer(to_resue);
     m_rx_pkt_ready_offset = 0;
@@ -3083,6 +3826,8 @@ mem_buf_desc_t *sockinfo_udp::get_front_m_rx_pkt_ready_list()
 
 size_t sockinfo_udp::get_size_m_rx_pkt_ready_list()
 {
+    // Called under the rx queue lock by the helpers which walk the whole list
+    rx_ready_ring_drain();
     return m_rx_pkt_ready_list.size();
 }
 
@@ -3099,7 +3844,7 @@ void sockinfo_udp::push_back_m_rx_pkt_ready_list(mem_buf_desc_t *buff)
 bool sockinfo_udp::prepare_to_close(bool process_shutdown)
 {
     m_lock_rcv.lock();
-    m_sock_wakeup_pipe.do_wakeup();
+    m_sock_wakeup.do_wakeup();
 
     if (has_epoll_context()) {
         m_econtext->fd_closed(m_fd);
@@ -3109,14 +3854,20 @@ bool sockinfo_udp::prepare_to_close(bool process_shutdown)
 
     NOT_IN_USE(process_shutdown);
     m_state = SOCKINFO_CLOSING;
+
+    if (m_is_xlio_socket && m_p_group && !m_is_xlio_socket_terminated) {
+        // Datagram socket has no closing handshake, so it terminates immediately.
+        m_is_xlio_socket_terminated = true;
+        m_p_group->m_socket_event_cb(reinterpret_cast<xlio_socket_t>(this), m_xlio_socket_userdata,
+                                     XLIO_SOCKET_EVENT_TERMINATED, 0);
+    }
     return is_closable();
 }
 
 void sockinfo_udp::update_header_field(data_updater *updater)
 {
-    dst_entry_map_t::iterator dst_entry_iter = m_dst_entry_map.begin();
-    for (; dst_entry_iter != m_dst_entry_map.end(); dst_entry_iter++) {
-        updater->update_field(*dst_entry_iter->second);
+    for (auto &entry : m_dst_entry_lru) {
+        updater->update_field(*entry.second);
     }
     if (m_p_connected_dst_entry) {
         updater->update_field(*m_p_connected_dst_entry);
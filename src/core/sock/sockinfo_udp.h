@@ -17,6 +17,7 @@
 
 #include "xlio_extra.h"
 #include "util/chunk_list.h"
+#include "util/spsc_ring.h"
 #include "util/xlio_stats.h"
 #include "util/sys_vars.h"
 #include "proto/mem_buf_desc.h"
@@ -25,8 +26,9 @@
 #include "sock-redirect.h"
 #include "sockinfo.h"
 
-// Send flow dst_entry map
-typedef std::unordered_map<sock_addr, dst_entry *> dst_entry_map_t;
+// Send flow dst_entry objects, the least recently used first, and their map
+typedef std::list<std::pair<sock_addr, dst_entry *>> dst_entry_lru_t;
+typedef std::unordered_map<sock_addr, dst_entry_lru_t::iterator> dst_entry_map_t;
 
 typedef union {
     struct ip_mreq mreq;
@@ -52,6 +54,8 @@ struct mc_pending_pram {
 typedef std::list<struct mc_pending_pram> mc_pram_list_t;
 typedef std::unordered_map<ip_address, std::unordered_map<ip_address, int>> mc_memberships_map_t;
 
+struct xlio_socket_attr;
+
 /**
  * @class udp sockinfo
  * Represents an udp socket.
@@ -61,6 +65,10 @@ public:
     sockinfo_udp(int fd, int domain);
     ~sockinfo_udp() override;
 
+    // The memory of the sockets comes from the NUMA node slabs of sockinfo_pool.
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
     void setPassthrough() override
     {
         IF_STATS(m_p_socket_stats->b_is_offloaded = m_sock_offload = false);
@@ -78,8 +86,11 @@ public:
     bool is_writeable() override { return true; };
     bool is_errorable(int *errors) override
     {
-        NOT_IN_USE(errors);
-        return false;
+        // The MSG_ZEROCOPY completions and TX timestamps are the only errors reported by XLIO
+        *errors = (unlikely(m_b_zerocopy || is_tx_ts_reported()) && has_errqueue_notify())
+            ? POLLERR
+            : 0;
+        return *errors;
     }
     bool is_outgoing() override { return false; }
     bool is_incoming() override { return false; }
@@ -114,6 +125,9 @@ public:
     ssize_t rx(const rx_call_t call_type, iovec *p_iov, ssize_t sz_iov, int *p_flags,
                sockaddr *__from = nullptr, socklen_t *__fromlen = nullptr,
                struct msghdr *__msg = nullptr) override;
+    int rx_zcopy(struct xlio_zcopy_buf *bufs, unsigned count, int flags) override;
+    void rx_zcopy_free(const struct xlio_zcopy_buf *bufs, unsigned count) override;
+    int rx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int *p_flags) override;
     /**
      * Check that a call to this sockinfo rx() will not block
      * -> meaning, we got an offloaded ready rx datagram
@@ -135,6 +149,7 @@ public:
      * true)
      */
     ssize_t tx(xlio_tx_call_attr_t &tx_arg) override;
+    int tx_mmsg(struct mmsghdr *mmsg, unsigned vlen, int flags) override;
     void tx_thread_commit(mem_buf_desc_t *buf_list, uint32_t offset, uint32_t size,
                           int flags) override;
     /**
@@ -152,6 +167,8 @@ public:
      *	Normally it is single point from sockinfo to be called from ring level.
      */
     bool rx_input_cb(mem_buf_desc_t *p_desc, void *pv_fd_ready_array) override;
+    bool rx_input_cb_fanout(mem_buf_desc_t *p_desc, rx_fanout &fanout) override;
+    bool rx_over_limit_drop(mem_buf_desc_t *p_desc) override;
 
     // This call will handle all rdma related events (bind->listen->connect_req->accept)
     void statistics_print(vlog_levels_t log_level = VLOG_DEBUG) override;
@@ -160,6 +177,13 @@ public:
     bool prepare_to_close(bool process_shutdown = false) override;
     void update_header_field(data_updater *updater) override;
 
+    // XLIO Ultra API
+    void set_xlio_socket(const struct xlio_socket_attr *attr);
+    int tx_xlio_socket(const struct iovec *iov, unsigned iovcnt, const struct sockaddr *to,
+                       socklen_t tolen, const struct xlio_socket_send_attr *attr);
+    void get_xlio_buf_info(mem_buf_desc_t *p_desc, struct sockaddr *addr, socklen_t *addrlen,
+                           struct timespec *hw_timestamp);
+
 #if defined(DEFINED_NGINX)
     void prepare_to_close_socket_pool(bool _push_pop) override;
     void set_params_for_socket_pool() override
@@ -172,17 +196,28 @@ public:
     bool is_closable() override { return true; }
 #endif
 
+    // Source port bucket of the SO_REUSEPORT group, -1 when the socket has none
+    int get_reuseport_slot() const { return m_reuseport_slot; }
+
 protected:
     void lock_rx_q() override { m_lock_rcv.lock(); }
     void unlock_rx_q() override { m_lock_rcv.unlock(); }
 
 private:
     bool packet_is_loopback(mem_buf_desc_t *p_desc);
+    void reuseport_slot_acquire();
+    void reuseport_slot_release();
+    void dst_entry_cache_trim();
+    inline bool rx_input(mem_buf_desc_t *p_desc, void *pv_fd_ready_array, rx_fanout *p_fanout);
+    bool rx_input_cb_xlio_socket(mem_buf_desc_t *p_desc);
+    void add_tx_ring_to_group(dst_entry *p_dst_entry);
     ssize_t check_payload_size(const iovec *p_iov, ssize_t sz_iov);
+    uint16_t get_tx_gso_size(const xlio_tx_call_attr_t &tx_arg);
     int mc_change_membership_start_helper_ip4(const ip_address &mc_grp, int optname);
     int mc_change_membership_end_helper_ip4(const ip_address &mc_grp, int optname,
                                             const ip_address &mc_src);
     int mc_change_membership_ip4(const mc_pending_pram *p_mc_pram);
+    int mc_change_membership_batch(int optname, const void *optval, socklen_t optlen);
 
     int mc_change_membership_ip6(const mc_pending_pram *p_mc_pram);
     int mc_change_membership_start_helper_ip6(const mc_pending_pram *p_mc_pram);
@@ -197,6 +232,8 @@ private:
     void rx_ready_byte_count_limit_update(
         size_t n_rx_ready_bytes_limit); // Drop rx ready packets from head of queue
     void drop_rx_ready_byte_count(size_t n_rx_bytes_limit);
+    // Drop the oldest ready datagrams until sz_payload more bytes fit in SO_RCVBUF
+    void rx_ready_drop_oldest(size_t sz_payload);
 
     void
     save_stats_threadid_rx(); // ThreadId will only saved if logger is at least in DEBUG(4) level
@@ -206,6 +243,7 @@ private:
     void save_stats_tx_offload(int bytes);
 
     inline int rx_wait(bool blocking);
+    inline void rx_poll_rings(uint64_t *p_poll_sn);
     inline int poll_os();
 
     virtual inline void reuse_buffer(mem_buf_desc_t *buff);
@@ -240,12 +278,28 @@ private:
         }
     }
 
-    inline void update_ready(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array);
+    inline void update_ready(mem_buf_desc_t *p_rx_wc_buf_desc, void *pv_fd_ready_array,
+                             rx_fanout *p_fanout);
+    inline void rx_ready_list_push(mem_buf_desc_t *p_desc);
+    inline void rx_ready_ring_drain();
+    // Ready datagrams and bytes, including the ones not moved from m_rx_ready_ring yet
+    inline int rx_ready_pkt_count() const
+    {
+        return m_n_rx_pkt_ready_list_count + static_cast<int>(m_rx_ready_ring.size());
+    }
+    inline size_t rx_ready_byte_count() const
+    {
+        size_t bytes_out = m_rx_ready_ring_bytes_out.load(std::memory_order_acquire);
+        return m_rx_ready_byte_count + m_rx_ready_ring_bytes_in.load(std::memory_order_relaxed) -
+            bytes_out;
+    }
+    inline bool rx_gro_append(mem_buf_desc_t *p_desc);
 
     void post_dequeue() override;
     size_t handle_msg_trunc(size_t total_rx, size_t payload_size, int in_flags,
                             int *p_out_flags) override;
     void handle_ip_pktinfo(struct cmsg_state *cm_state) override;
+    void handle_udp_gro(struct cmsg_state *cm_state) override;
 
     mem_buf_desc_t *get_front_m_rx_pkt_ready_list() override;
     size_t get_size_m_rx_pkt_ready_list() override;
@@ -262,6 +316,7 @@ private:
     };
 
     uint32_t m_rx_ready_byte_limit;
+    bool m_rx_drop_oldest = false; // setsockopt SOL_SOCKET SO_XLIO_RX_DROP_POLICY
     ip_addr m_mc_tx_src_ip;
     bool m_b_mc_tx_loop;
     uint8_t m_n_mc_ttl_hop_lim;
@@ -280,11 +335,28 @@ private:
     std::vector<struct port_socket_t> m_port_map;
     unsigned m_port_map_index;
 
+    int m_reuseport_slot = -1;
+    sock_addr m_reuseport_addr;
+
+    dst_entry_lru_t m_dst_entry_lru;
     dst_entry_map_t m_dst_entry_map;
+    // The doorbell batches of tx_mmsg() hold the ring of a dst_entry, none is dropped meanwhile
+    uint32_t m_n_tx_batches = 0U;
     dst_entry *m_p_last_dst_entry;
     sock_addr m_last_sock_addr;
 
     chunk_list_t<mem_buf_desc_t *> m_rx_pkt_ready_list;
+    /*
+     * The ring polling threads hand the datagrams over through m_rx_ready_ring without taking
+     * m_lock_rcv. The reader moves them to m_rx_pkt_ready_list under m_lock_rcv before it looks
+     * at the list, so the list and its counters are touched only by the reader. Several polling
+     * threads are serialized by m_rx_ready_ring_lock. The byte counters are monotonic, the ring
+     * holds bytes_in - bytes_out bytes.
+     */
+    std::atomic<size_t> m_rx_ready_ring_bytes_out {0};
+    spsc_ring<mem_buf_desc_t *, 256> m_rx_ready_ring;
+    lock_spin m_rx_ready_ring_lock;
+    std::atomic<size_t> m_rx_ready_ring_bytes_in {0};
 
     const uint32_t m_n_sysvar_rx_poll_yield_loops;
     const uint32_t m_n_sysvar_rx_udp_poll_os_ratio;
@@ -293,6 +365,7 @@ private:
     const uint32_t m_n_sysvar_rx_delta_tsc_between_cq_polls;
 
     uint8_t m_tos;
+    uint16_t m_udp_gso_size = 0U; // setsockopt IPPROTO_UDP UDP_SEGMENT
     bool m_sockopt_mapped; // setsockopt IPPROTO_UDP UDP_MAP_ADD
     bool m_is_connected; // to inspect for in_addr.src
     bool m_multicast; // true when socket set MC rule
@@ -6,6 +6,7 @@
 
 #include "sockinfo_tcp.h"
 #include "sockinfo_ulp.h"
+#include "event/poll_group.h"
 
 #include <algorithm>
 #include <assert.h>
@@ -44,6 +45,19 @@ ssize_t sockinfo_tcp_ops::tx(xlio_tx_call_attr_t &tx_arg)
     return m_p_sock->tcp_tx(tx_arg);
 }
 
+/*virtual*/
+int sockinfo_tcp_ops::tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey,
+                                 unsigned flags, void *opaque_op)
+{
+    return m_p_sock->tcp_tx_express(iov, iov_len, mkey, flags, opaque_op);
+}
+
+/*virtual*/
+int sockinfo_tcp_ops::tx_express_inline(const struct iovec *iov, unsigned iov_len, unsigned flags)
+{
+    return m_p_sock->tcp_tx_express_inline(iov, iov_len, flags);
+}
+
 /*virtual*/
 int sockinfo_tcp_ops::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_send_attr &attr)
 {
@@ -66,6 +80,421 @@ ssize_t sockinfo_tcp_ops_thread::tx(xlio_tx_call_attr_t &tx_arg)
     return m_p_sock->tcp_tx_thread(tx_arg);
 }
 
+sockinfo_tcp_ops_nvme::sockinfo_tcp_ops_nvme(sockinfo_tcp *sock, sockinfo_tcp_ops *next,
+                                             uint32_t flags)
+    : sockinfo_tcp_ops(sock)
+    , m_p_next(next)
+    , m_flags(flags)
+{
+    /* The previous callback serves the socket type, the RX buffers pass through the parser. */
+    m_rx_next = m_p_sock->get_pcb()->recv;
+    tcp_recv(m_p_sock->get_pcb(), sockinfo_tcp_ops_nvme::rx_lwip_cb);
+}
+
+sockinfo_tcp_ops_nvme::~sockinfo_tcp_ops_nvme()
+{
+    if (m_p_sock->get_pcb()->recv == sockinfo_tcp_ops_nvme::rx_lwip_cb) {
+        tcp_recv(m_p_sock->get_pcb(), m_rx_next);
+    }
+}
+
+int sockinfo_tcp_ops_nvme::setsockopt(int __level, int __optname, const void *__optval,
+                                      socklen_t __optlen)
+{
+    if (__level != SOL_SOCKET ||
+        (__optname != SO_XLIO_NVME_OFFLOAD && __optname != SO_XLIO_NVME_DDP_SETUP &&
+         __optname != SO_XLIO_NVME_DDP_TEARDOWN)) {
+        return m_p_next->setsockopt(__level, __optname, __optval, __optlen);
+    }
+
+    if (__optname == SO_XLIO_NVME_OFFLOAD) {
+        if (!__optval || __optlen < sizeof(struct xlio_nvme_offload)) {
+            errno = EINVAL;
+            return -1;
+        }
+        uint32_t flags = reinterpret_cast<const struct xlio_nvme_offload *>(__optval)->flags;
+        if (flags & ~(XLIO_NVME_TX_DIGEST | XLIO_NVME_RX_DIGEST | XLIO_NVME_RX_DDP)) {
+            errno = EINVAL;
+            return -1;
+        }
+        m_p_sock->lock_tcp_con();
+        /* A direction which starts to be parsed is at a PDU boundary. */
+        if (!(m_flags & XLIO_NVME_TX_DIGEST)) {
+            m_tx_pdu = {};
+        }
+        if (!(m_flags & (XLIO_NVME_RX_DIGEST | XLIO_NVME_RX_DDP))) {
+            m_rx_pdu = {};
+        }
+        m_flags = flags;
+        m_p_sock->unlock_tcp_con();
+        si_ulp_logdbg("(SO_XLIO_NVME_OFFLOAD) flags: %#x", flags);
+        return 0;
+    }
+
+    if (!__optval || __optlen < sizeof(struct xlio_nvme_ddp)) {
+        errno = EINVAL;
+        return -1;
+    }
+    const struct xlio_nvme_ddp *ddp = reinterpret_cast<const struct xlio_nvme_ddp *>(__optval);
+    int ret = 0;
+
+    m_p_sock->lock_tcp_con();
+    if (__optname == SO_XLIO_NVME_DDP_SETUP) {
+        if (ddp->buf && ddp->len) {
+            m_ddp_bufs[ddp->cid] = {ddp->buf, ddp->len};
+        } else {
+            errno = EINVAL;
+            ret = -1;
+        }
+    } else if (!m_ddp_bufs.erase(ddp->cid)) {
+        errno = ENOENT;
+        ret = -1;
+    }
+    m_p_sock->unlock_tcp_con();
+    return ret;
+}
+
+/*
+ * Advances the PDU stream over the data. On TX the data is added to m_tx_iov with the digest
+ * fields replaced by the computed digests. On RX the digests are compared and the C2HData
+ * data is copied to its DDP buffer and removed: the rest of the data is moved to the front
+ * and its length is returned in kept. Returns false for a malformed PDU or a digest mismatch.
+ */
+bool sockinfo_tcp_ops_nvme::pdu_advance(pdu_state &pdu, uint8_t *data, uint32_t len, bool is_tx,
+                                        uint32_t *kept)
+{
+    const bool is_digest = m_flags & (is_tx ? XLIO_NVME_TX_DIGEST : XLIO_NVME_RX_DIGEST);
+    const nvme_tcp_c2h_data_hdr *hdr = reinterpret_cast<nvme_tcp_c2h_data_hdr *>(pdu.hdr);
+    uint8_t *const start = data;
+    uint8_t *out = data;
+
+    while (len) {
+        uint32_t n;
+        bool keep = true;
+
+        if (pdu.offset < NVME_TCP_CH_LEN) {
+            n = std::min(len, NVME_TCP_CH_LEN - pdu.offset);
+            memcpy(pdu.hdr + pdu.offset, data, n);
+        }
+
+        const uint32_t hlen = hdr->hlen;
+        const uint32_t plen = le32toh(hdr->plen);
+        const uint32_t hdgst = (hdr->flags & NVME_TCP_F_HDGST) ? NVME_TCP_DIGEST_LEN : 0U;
+        const uint32_t ddgst = (hdr->flags & NVME_TCP_F_DDGST) ? NVME_TCP_DIGEST_LEN : 0U;
+        const uint32_t data_end = plen - ddgst;
+        const uint32_t data_start = hdr->pdo ? hdr->pdo : data_end;
+
+        if (pdu.offset < NVME_TCP_CH_LEN) {
+            if (pdu.offset + n == NVME_TCP_CH_LEN) {
+                if (unlikely(hlen < NVME_TCP_CH_LEN || plen < hlen + hdgst + ddgst ||
+                             (hdr->pdo && (hdr->pdo < hlen + hdgst || hdr->pdo > data_end)))) {
+                    si_ulp_logdbg("Malformed NVMe/TCP PDU: hlen %u pdo %u plen %u", hlen,
+                                  hdr->pdo, plen);
+                    return false;
+                }
+                if (is_digest && hdgst) {
+                    pdu.crc = crc32c(CRC32C_INIT, pdu.hdr, NVME_TCP_CH_LEN);
+                }
+            }
+        } else if (pdu.offset < hlen) {
+            n = std::min(len, hlen - pdu.offset);
+            if (pdu.offset < sizeof(pdu.hdr)) {
+                memcpy(pdu.hdr + pdu.offset, data,
+                       std::min<uint32_t>(n, sizeof(pdu.hdr) - pdu.offset));
+            }
+            if (is_digest && hdgst) {
+                pdu.crc = crc32c(pdu.crc, data, n);
+            }
+        } else if (pdu.offset < hlen + hdgst || pdu.offset >= data_end) {
+            /* Digest field, the CRC of the header or of the data is complete. */
+            uint32_t field = (pdu.offset < hlen + hdgst) ? hlen : data_end;
+            uint32_t digest = htole32(crc32c_final(pdu.crc));
+            uint32_t pos = pdu.offset - field;
+
+            n = std::min(len, NVME_TCP_DIGEST_LEN - pos);
+            if (is_digest && is_tx) {
+                if (pos == 0U) {
+                    m_tx_digests.push_back(digest);
+                }
+                tx_emit(reinterpret_cast<uint8_t *>(&m_tx_digests.back()) + pos, n, true);
+                keep = false;
+            } else if (is_digest &&
+                       memcmp(data, reinterpret_cast<uint8_t *>(&digest) + pos, n) != 0) {
+                ++m_rx_digest_errors;
+                si_ulp_logdbg("NVMe/TCP %s digest mismatch, PDU type %u",
+                              field == hlen ? "header" : "data", hdr->type);
+                return false;
+            }
+        } else if (pdu.offset < data_start) {
+            /* Padding up to the PDO. */
+            n = std::min(len, data_start - pdu.offset);
+        } else {
+            uint32_t data_offset = pdu.offset - data_start;
+            uint8_t *dst;
+
+            n = std::min(len, data_end - pdu.offset);
+            if (data_offset == 0U) {
+                pdu.ddp = is_tx ? nullptr : ddp_target(pdu, data_end - data_start);
+            }
+            dst = pdu.ddp ? pdu.ddp + data_offset : nullptr;
+            if (is_digest && ddgst) {
+                pdu.crc = crc32c_copy(data_offset ? pdu.crc : CRC32C_INIT, dst, data, n);
+            } else if (dst) {
+                memcpy(dst, data, n);
+            }
+            keep = !dst;
+        }
+
+        if (keep && is_tx) {
+            tx_emit(data, n, false);
+        } else if (keep) {
+            if (out != data) {
+                memmove(out, data, n);
+            }
+            out += n;
+        }
+        pdu.offset += n;
+        data += n;
+        len -= n;
+        if (pdu.offset >= NVME_TCP_CH_LEN && pdu.offset == plen) {
+            pdu.offset = 0U;
+        }
+    }
+    if (kept) {
+        *kept = static_cast<uint32_t>(out - start);
+    }
+    return true;
+}
+
+/* Returns the placement of the data of a C2HData PDU, the whole data fits or nothing. */
+uint8_t *sockinfo_tcp_ops_nvme::ddp_target(const pdu_state &pdu, uint32_t data_len)
+{
+    const nvme_tcp_c2h_data_hdr *hdr = reinterpret_cast<const nvme_tcp_c2h_data_hdr *>(pdu.hdr);
+
+    if (!(m_flags & XLIO_NVME_RX_DDP) || hdr->type != NVME_TCP_PDU_C2H_DATA ||
+        hdr->hlen < NVME_TCP_C2H_DATA_HLEN) {
+        return nullptr;
+    }
+
+    auto iter = m_ddp_bufs.find(le16toh(hdr->cccid));
+    uint64_t datao = le32toh(hdr->datao);
+    uint64_t datal = le32toh(hdr->datal);
+
+    if (iter == m_ddp_bufs.end() || datal != data_len || datao + datal > iter->second.iov_len) {
+        return nullptr;
+    }
+    return static_cast<uint8_t *>(iter->second.iov_base) + datao;
+}
+
+void sockinfo_tcp_ops_nvme::tx_emit(uint8_t *data, uint32_t len, bool is_digest)
+{
+    if (!m_tx_iov.empty() && m_tx_iov_digest.back() == is_digest &&
+        static_cast<uint8_t *>(m_tx_iov.back().iov_base) + m_tx_iov.back().iov_len == data) {
+        m_tx_iov.back().iov_len += len;
+        return;
+    }
+    m_tx_iov.push_back({data, len});
+    m_tx_iov_digest.push_back(is_digest);
+}
+
+/*
+ * Builds m_tx_iov from up to limit bytes of the iovec, the digest fields point to the
+ * computed digests. Returns the bytes parsed or -1.
+ */
+ssize_t sockinfo_tcp_ops_nvme::tx_build(const struct iovec *iov, size_t iov_len, size_t limit)
+{
+    size_t total = 0;
+
+    m_tx_iov.clear();
+    m_tx_iov_digest.clear();
+    m_tx_digests.clear();
+    for (size_t i = 0; i < iov_len && total < limit; ++i) {
+        uint32_t len = static_cast<uint32_t>(std::min(iov[i].iov_len, limit - total));
+
+        if (unlikely(!pdu_advance(m_tx_pdu, static_cast<uint8_t *>(iov[i].iov_base), len, true,
+                                  nullptr))) {
+            errno = EINVAL;
+            return -1;
+        }
+        total += len;
+    }
+    return static_cast<ssize_t>(total);
+}
+
+ssize_t sockinfo_tcp_ops_nvme::tx(xlio_tx_call_attr_t &tx_arg)
+{
+    if (!(m_flags & XLIO_NVME_TX_DIGEST)) {
+        return m_p_next->tx(tx_arg);
+    }
+    /* The digests are sent from XLIO buffers, which live until the copy of the send only. */
+    if (unlikely(tx_arg.opcode == TX_FILE || (tx_arg.attr.flags & MSG_ZEROCOPY))) {
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    struct iovec *iov = tx_arg.attr.iov;
+    ssize_t sz_iov = tx_arg.attr.sz_iov;
+    pdu_state saved = m_tx_pdu;
+    ssize_t total = tx_build(iov, static_cast<size_t>(sz_iov), SIZE_MAX);
+
+    if (unlikely(total < 0)) {
+        m_tx_pdu = saved;
+        return -1;
+    }
+
+    tx_arg.attr.iov = m_tx_iov.data();
+    tx_arg.attr.sz_iov = static_cast<ssize_t>(m_tx_iov.size());
+    ssize_t ret = m_p_next->tx(tx_arg);
+    tx_arg.attr.iov = iov;
+    tx_arg.attr.sz_iov = sz_iov;
+    if (unlikely(ret != total)) {
+        /* The rest is sent again by the application and parsed then. */
+        int errno_save = errno;
+
+        m_tx_pdu = saved;
+        if (ret > 0) {
+            tx_build(iov, static_cast<size_t>(sz_iov), static_cast<size_t>(ret));
+        }
+        errno = errno_save;
+    }
+    return ret;
+}
+
+/*
+ * The application buffers are sent zero copy with the mkey and the digests are copied, so the
+ * PDUs are sent in runs of either. The completion is reported for the last application run.
+ */
+int sockinfo_tcp_ops_nvme::tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey,
+                                      unsigned flags, void *opaque_op)
+{
+    if (!(m_flags & XLIO_NVME_TX_DIGEST)) {
+        return m_p_next->tx_express(iov, iov_len, mkey, flags, opaque_op);
+    }
+
+    pdu_state saved = m_tx_pdu;
+    if (unlikely(tx_build(iov, iov_len, SIZE_MAX) < 0)) {
+        m_tx_pdu = saved;
+        return -1;
+    }
+
+    size_t last_app = m_tx_iov.size();
+    for (size_t i = 0; i < m_tx_iov.size(); ++i) {
+        if (!m_tx_iov_digest[i]) {
+            last_app = i;
+        }
+    }
+
+    int ret = 0;
+    int total = 0;
+    for (size_t i = 0; i < m_tx_iov.size() && ret >= 0;) {
+        const bool is_digest = m_tx_iov_digest[i];
+        size_t n = 1;
+
+        while (i + n < m_tx_iov.size() && m_tx_iov_digest[i + n] == is_digest) {
+            ++n;
+        }
+        const bool is_last = i + n == m_tx_iov.size();
+        unsigned run_flags = is_last ? flags : (flags | XLIO_EXPRESS_MSG_MORE);
+
+        if (is_digest) {
+            ret = m_p_next->tx_express_inline(&m_tx_iov[i], static_cast<unsigned>(n),
+                                              run_flags & ~XLIO_EXPRESS_OP_TYPE_MASK);
+        } else {
+            ret = m_p_next->tx_express(&m_tx_iov[i], static_cast<unsigned>(n), mkey, run_flags,
+                                       i + n > last_app ? opaque_op : nullptr);
+        }
+        total += ret;
+        i += n;
+    }
+    if (unlikely(ret < 0)) {
+        m_tx_pdu = saved;
+        return -1;
+    }
+    return total;
+}
+
+int sockinfo_tcp_ops_nvme::tx_express_inline(const struct iovec *iov, unsigned iov_len,
+                                             unsigned flags)
+{
+    if (m_flags & XLIO_NVME_TX_DIGEST) {
+        pdu_state saved = m_tx_pdu;
+        if (unlikely(tx_build(iov, iov_len, SIZE_MAX) < 0)) {
+            m_tx_pdu = saved;
+            return -1;
+        }
+        int ret = m_p_next->tx_express_inline(m_tx_iov.data(),
+                                              static_cast<unsigned>(m_tx_iov.size()), flags);
+        if (unlikely(ret < 0)) {
+            m_tx_pdu = saved;
+        }
+        return ret;
+    }
+    return m_p_next->tx_express_inline(iov, iov_len, flags);
+}
+
+/* Unlinks the buffers emptied by the placement and fixes tot_len, returns the new head. */
+static struct pbuf *nvme_rx_trim(struct pbuf *p)
+{
+    struct pbuf *head = nullptr;
+    struct pbuf **link = &head;
+    uint32_t tot_len = 0;
+
+    while (p) {
+        struct pbuf *next = p->next;
+
+        if (p->len) {
+            tot_len += p->len;
+            *link = p;
+            link = &p->next;
+        } else {
+            p->next = nullptr;
+            pbuf_free(p);
+        }
+        p = next;
+    }
+    *link = nullptr;
+    for (struct pbuf *q = head; q; q = q->next) {
+        q->tot_len = tot_len;
+        tot_len -= q->len;
+    }
+    return head;
+}
+
+/* static */
+err_t sockinfo_tcp_ops_nvme::rx_lwip_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p,
+                                        err_t err)
+{
+    sockinfo_tcp *conn = reinterpret_cast<sockinfo_tcp *>(arg);
+    sockinfo_tcp_ops_nvme *nvme = static_cast<sockinfo_tcp_ops_nvme *>(conn->get_ops());
+
+    if (likely(p && err == ERR_OK) &&
+        (nvme->m_flags & (XLIO_NVME_RX_DIGEST | XLIO_NVME_RX_DDP))) {
+        uint32_t placed = 0U;
+
+        /* The receive callbacks take every buffer, so each byte is parsed once. */
+        for (struct pbuf *q = p; q; q = q->next) {
+            uint32_t kept;
+
+            if (unlikely(!nvme->pdu_advance(nvme->m_rx_pdu, static_cast<uint8_t *>(q->payload),
+                                            q->len, false, &kept))) {
+                conn->tcp_shutdown_rx();
+                return sockinfo_tcp::rx_drop_lwip_cb(arg, tpcb, p, err);
+            }
+            placed += q->len - kept;
+            q->len = kept;
+        }
+        if (placed) {
+            /* The placed data is consumed, the reader never returns its window. */
+            tcp_recved(tpcb, placed, true);
+            p = nvme_rx_trim(p);
+            if (!p) {
+                return ERR_OK;
+            }
+        }
+    }
+    return nvme->m_rx_next(arg, tpcb, p, err);
+}
+
 #ifdef DEFINED_UTLS
 
 #include <openssl/evp.h>
@@ -335,6 +764,53 @@ public:
     ring *m_p_tx_ring;
 };
 
+/*
+ * Zerocopy owner of the user buffer of a XLIO Ultra API send. Completes the send operation
+ * once the records which refer to the buffer are released.
+ */
+class tls_express_op : public mem_desc {
+public:
+    tls_express_op(sockinfo_tcp *sock, uint32_t mkey, void *opaque_op)
+        : m_p_sock(sock)
+        , m_mkey(mkey)
+        , m_opaque_op(reinterpret_cast<uintptr_t>(opaque_op))
+    {
+        /* Allocate the operation with a taken reference. */
+        atomic_set(&m_ref, 1);
+    }
+
+    void get() override { (void)atomic_fetch_and_inc(&m_ref); }
+
+    void put() override
+    {
+        int ref = atomic_fetch_and_dec(&m_ref);
+
+        if (ref == 1) {
+            poll_group *grp = m_p_sock->get_poll_group();
+            if (m_opaque_op && grp && grp->has_comp_cb()) {
+                grp->comp_cb(m_p_sock, m_opaque_op);
+            }
+            delete this;
+        }
+    }
+
+    uint32_t get_lkey(mem_buf_desc_t *desc, ib_ctx_handler *ib_ctx, const void *addr,
+                      size_t len) override
+    {
+        NOT_IN_USE(desc);
+        NOT_IN_USE(ib_ctx);
+        NOT_IN_USE(addr);
+        NOT_IN_USE(len);
+        return m_mkey;
+    }
+
+private:
+    atomic_t m_ref;
+    sockinfo_tcp *const m_p_sock;
+    const uint32_t m_mkey;
+    const uintptr_t m_opaque_op;
+};
+
 /*
  * sockinfo_tcp_ops_tls
  */
@@ -346,6 +822,7 @@ sockinfo_tcp_ops_tls::sockinfo_tcp_ops_tls(sockinfo_tcp *sock)
     m_p_tx_ring = sock->get_tx_ring();
     m_p_rx_ring = sock->get_rx_ring();
     memset(&m_tls_info_tx, 0, sizeof(m_tls_info_tx));
+    memset(&m_tls_info_tx_prev, 0, sizeof(m_tls_info_tx_prev));
     memset(&m_tls_info_rx, 0, sizeof(m_tls_info_rx));
 
     m_is_tls_tx = false;
@@ -353,14 +830,21 @@ sockinfo_tcp_ops_tls::sockinfo_tcp_ops_tls(sockinfo_tcp *sock)
     m_tls_rec_overhead = 0;
 
     m_p_tis = nullptr;
+    m_is_tls_tx_posted = false;
+    m_p_tis_prev = nullptr;
+    m_rekey_seqno_tx = 0;
+    m_expected_seqno_prev = 0;
     m_zc_stor = nullptr;
     m_zc_stor_offset = 0;
     m_expected_seqno = 0;
     m_next_recno_tx = 0;
+    m_p_open_rec = nullptr;
+    m_tx_coalesce_size = safe_mce_sys().utls_tx_coalesce_size;
 
     m_p_tir = nullptr;
     m_p_evp_cipher = nullptr;
     m_p_cipher_ctx = nullptr;
+    m_is_cipher_ctx_dec = false;
     m_next_recno_rx = 0;
     m_rx_offset = 0;
     m_rx_rec_len = 0;
@@ -377,8 +861,17 @@ sockinfo_tcp_ops_tls::~sockinfo_tcp_ops_tls()
     /* Destroy TLS object under TCP connection lock. */
 
     if (m_is_tls_tx) {
+        if (m_p_open_rec) {
+            /* The socket is closed before the coalesced data is flushed. */
+            m_p_open_rec->put();
+            m_p_open_rec = nullptr;
+        }
         m_p_tx_ring->tls_release_tis(m_p_tis);
         m_p_tis = nullptr;
+        if (m_p_tis_prev) {
+            m_p_tx_ring->tls_release_tis(m_p_tis_prev);
+            m_p_tis_prev = nullptr;
+        }
         if (m_zc_stor) {
             /* Release references taken in advance, but not used. See get_record_buf(). */
             unsigned extra_ref = (m_zc_stor->sz_buffer - m_zc_stor_offset) / TLS_ZC_BLOCK;
@@ -392,8 +885,10 @@ sockinfo_tcp_ops_tls::~sockinfo_tcp_ops_tls()
             delete m_rx_rule;
             m_rx_rule = nullptr;
         }
-        m_p_tx_ring->tls_release_tir(m_p_tir);
-        m_p_tir = nullptr;
+        if (m_p_tir) {
+            m_p_tx_ring->tls_release_tir(m_p_tir);
+            m_p_tir = nullptr;
+        }
         if (m_p_cipher_ctx) {
             g_tls_api->EVP_CIPHER_CTX_free(reinterpret_cast<EVP_CIPHER_CTX *>(m_p_cipher_ctx));
             m_p_cipher_ctx = nullptr;
@@ -568,7 +1063,28 @@ int sockinfo_tcp_ops_tls::setsockopt(int __level, int __optname, const void *__o
         return -1;
     }
 
+    bool is_rekey = (__optname == TLS_TX) && m_is_tls_tx;
+    if (unlikely(is_rekey)) {
+        /* Only TLS 1.3 updates the keys of a session, see RFC 8446 4.6.3. */
+        if (base_info->version != TLS_1_3_VERSION ||
+            base_info->version != m_tls_info_tx.tls_version ||
+            base_info->cipher_type != m_tls_info_tx.tls_cipher) {
+            si_ulp_logdbg("TLS_TX key update requires the same TLS1.3 cipher.");
+            errno = EINVAL;
+            return -1;
+        }
+    } else if (unlikely(__optname == TLS_RX && m_is_tls_rx)) {
+        /* The TIR and its steering rule cannot switch the key at a record boundary. */
+        si_ulp_logdbg("TLS_RX key update is not supported.");
+        errno = EBUSY;
+        return -1;
+    }
+
     xlio_tls_info *tls_info = (__optname == TLS_TX) ? &m_tls_info_tx : &m_tls_info_rx;
+    xlio_tls_info tls_info_tx_old;
+    if (unlikely(is_rekey)) {
+        tls_info_tx_old = m_tls_info_tx;
+    }
     tls_info->tls_version = base_info->version;
     tls_info->tls_cipher = base_info->cipher_type;
     tls_info->key_len = keylen;
@@ -581,19 +1097,17 @@ int sockinfo_tcp_ops_tls::setsockopt(int __level, int __optname, const void *__o
     m_tls_rec_overhead =
         (base_info->version == TLS_1_2_VERSION) ? TLS_12_RECORD_OVERHEAD : TLS_13_RECORD_OVERHEAD;
 
+    if (unlikely(is_rekey)) {
+        return tls_tx_update_key(tls_info_tx_old, be64toh(recno_be64));
+    }
+
     if (__optname == TLS_TX) {
-        if (!m_p_tx_ring->credits_get(SQ_CREDITS_TLS_TX_CONTEXT)) {
-            si_ulp_logdbg("No available space in SQ to create TLS TX context");
-            errno = ENOPROTOOPT;
-            return -1;
-        }
         m_expected_seqno = m_p_sock->get_next_tcp_seqno();
         m_next_recno_tx = be64toh(recno_be64);
         m_p_tis = m_p_tx_ring->tls_context_setup_tx(&m_tls_info_tx);
         /* We don't need key for TX anymore. */
         memset(m_tls_info_tx.key, 0, keylen);
         if (unlikely(!m_p_tis)) {
-            m_p_tx_ring->credits_return(SQ_CREDITS_TLS_TX_CONTEXT);
             errno = ENOPROTOOPT;
             return -1;
         }
@@ -619,11 +1133,9 @@ int sockinfo_tcp_ops_tls::setsockopt(int __level, int __optname, const void *__o
         m_p_tir = m_p_tx_ring->tls_create_tir(true) ?: m_p_rx_ring->tls_create_tir(false);
 
         m_p_sock->lock_tcp_con();
-        if (m_p_tir) {
-            err_t err = tls_rx_consume_ready_packets();
-            if (unlikely(err != ERR_OK)) {
-                si_ulp_logdbg("Cannot consume ready packets, TLS RX offload will likely fail.");
-            }
+        err_t err = tls_rx_consume_ready_packets();
+        if (unlikely(err != ERR_OK)) {
+            si_ulp_logdbg("Cannot consume ready packets, TLS RX offload will likely fail.");
         }
 
         if (m_p_tir) {
@@ -645,16 +1157,16 @@ int sockinfo_tcp_ops_tls::setsockopt(int __level, int __optname, const void *__o
             }
         }
         if (unlikely(!m_p_tir)) {
-            si_ulp_logdbg("TLS RX offload setup failed");
-            m_is_tls_rx = false;
-            m_p_sock->unlock_tcp_con();
-            errno = ENOPROTOOPT;
-            return -1;
+            /*
+             * Out of HW contexts. Without a TIR, the records arrive fully encrypted and
+             * tls_rx_decrypt() handles them in software.
+             */
+            si_ulp_logdbg("TLS RX offload setup failed, falling back to SW decryption");
         }
 
         tcp_recv(m_p_sock->get_pcb(), sockinfo_tcp_ops_tls::rx_lwip_cb);
         if (m_p_sock->get_sock_stats()) {
-            m_p_sock->get_sock_stats()->tls_rx_offload = true;
+            m_p_sock->get_sock_stats()->tls_rx_offload = (m_p_tir != nullptr);
         }
         m_p_sock->unlock_tcp_con();
     }
@@ -670,6 +1182,70 @@ int sockinfo_tcp_ops_tls::setsockopt(int __level, int __optname, const void *__o
     return 0;
 }
 
+int sockinfo_tcp_ops_tls::tls_tx_update_key(const xlio_tls_info &info_old, uint64_t recno)
+{
+    /* The coalesced data belongs to the previous key. */
+    tx_flush();
+
+    m_p_sock->lock_tcp_con();
+
+    tls_tx_release_prev_key();
+    if (unlikely(m_p_tis_prev)) {
+        /* Records of the key before the previous one are still in flight. */
+        si_ulp_logdbg("TLS_TX key update: the previous key is still in use.");
+        m_tls_info_tx = info_old;
+        m_p_sock->unlock_tcp_con();
+        errno = EBUSY;
+        return -1;
+    }
+
+    xlio_tis *tis = m_p_tx_ring->tls_context_setup_tx(&m_tls_info_tx);
+    memset(m_tls_info_tx.key, 0, m_tls_info_tx.key_len);
+    if (unlikely(!tis)) {
+        m_tls_info_tx = info_old;
+        m_p_sock->unlock_tcp_con();
+        errno = ENOPROTOOPT;
+        return -1;
+    }
+
+    if (m_is_tls_tx_posted) {
+        /* Keep the previous key for the retransmissions of the records sent with it. */
+        m_p_tis_prev = m_p_tis;
+        m_tls_info_tx_prev = info_old;
+        m_expected_seqno_prev = m_expected_seqno;
+    } else {
+        m_p_tx_ring->tls_release_tis(m_p_tis);
+    }
+    m_p_tis = tis;
+    m_is_tls_tx_posted = false;
+    m_rekey_seqno_tx = m_p_sock->get_next_tcp_seqno();
+    m_expected_seqno = m_rekey_seqno_tx;
+    m_next_recno_tx = recno;
+
+    /* A segment must not carry records of both keys. */
+    struct tcp_pcb *pcb = m_p_sock->get_pcb();
+    if (pcb->last_unsent) {
+        pcb->last_unsent->flags |= TF_SEG_OPTS_NOMERGE;
+    }
+
+    if (m_p_sock->get_sock_stats()) {
+        ++m_p_sock->get_sock_stats()->tls_counters.n_tls_tx_key_updates;
+    }
+    m_p_sock->unlock_tcp_con();
+
+    si_ulp_logdbg("TLS1.3 TX key is updated at seqno=%u", m_rekey_seqno_tx);
+    return 0;
+}
+
+void sockinfo_tcp_ops_tls::tls_tx_release_prev_key()
+{
+    /* Must be called under socket lock. */
+    if (m_p_tis_prev && !TCP_SEQ_LT(m_p_sock->get_pcb()->lastack, m_rekey_seqno_tx)) {
+        m_p_tx_ring->tls_release_tis(m_p_tis_prev);
+        m_p_tis_prev = nullptr;
+    }
+}
+
 err_t sockinfo_tcp_ops_tls::tls_rx_consume_ready_packets()
 {
     err_t ret = ERR_OK;
@@ -724,6 +1300,14 @@ ssize_t sockinfo_tcp_ops_tls::tx(xlio_tx_call_attr_t &tx_arg)
     if (!m_is_tls_tx) {
         return m_p_sock->tcp_tx(tx_arg);
     }
+    if (unlikely(m_p_open_rec)) {
+        /* Keep the order with the data coalesced by the XLIO Ultra API. */
+        tls_record *open_rec = m_p_open_rec;
+        m_p_open_rec = nullptr;
+        if (unlikely(tls_tx_push_record(open_rec) < 0)) {
+            return -1;
+        }
+    }
 
     errno_save = errno;
 
@@ -867,11 +1451,167 @@ done:
     return ret;
 }
 
+tls_record *sockinfo_tcp_ops_tls::tls_tx_new_record(mem_desc *zc_owner)
+{
+    uint8_t *iv = is_tx_tls13() ? nullptr : m_tls_info_tx.iv;
+    /* The TCP sequence number is known when the record is pushed. */
+    tls_record *rec = new (std::nothrow) tls_record(this, 0, m_next_recno_tx, iv, zc_owner);
+
+    if (unlikely(!rec || !rec->m_p_buf)) {
+        delete rec;
+        errno = ENOMEM;
+        return nullptr;
+    }
+    ++m_next_recno_tx;
+    if (!is_tx_tls13()) {
+        ++m_tls_info_tx.iv64;
+    }
+    return rec;
+}
+
+int sockinfo_tcp_ops_tls::tls_tx_push_record(tls_record *rec)
+{
+    struct iovec iov[3];
+
+    rec->m_seqno = m_p_sock->get_next_tcp_seqno();
+    rec->set_type(0x17, is_tx_tls13());
+    rec->fill_iov(iov, ARRAY_SIZE(iov), is_tx_tls13());
+
+    /* The doorbell is rung by the flush, the caller flushes if it is requested. */
+    int ret = m_p_sock->tcp_tx_express(iov, rec->m_p_zc_owner ? 3U : 1U, 0,
+                                       XLIO_EXPRESS_OP_TYPE_FILE_ZEROCOPY | XLIO_EXPRESS_MSG_MORE,
+                                       reinterpret_cast<void *>(rec));
+    if (likely(ret >= 0) && m_p_sock->get_sock_stats()) {
+        ++m_p_sock->get_sock_stats()->tls_counters.n_tls_tx_records;
+        m_p_sock->get_sock_stats()->tls_counters.n_tls_tx_bytes +=
+            rec->m_size - (is_tx_tls13() ? TLS_13_RECORD_OVERHEAD : TLS_12_RECORD_OVERHEAD);
+    }
+    /* The pbufs hold the record from now on. */
+    rec->put();
+    return ret < 0 ? -1 : 0;
+}
+
+int sockinfo_tcp_ops_tls::tls_tx_express(const struct iovec *iov, unsigned iov_len,
+                                         mem_desc *zc_owner, unsigned flags)
+{
+    int bytes = 0;
+
+    for (unsigned i = 0; i < iov_len; ++i) {
+        uint8_t *data = reinterpret_cast<uint8_t *>(iov[i].iov_base);
+        size_t len = iov[i].iov_len;
+
+        bytes += static_cast<int>(len);
+        while (len > 0) {
+            tls_record *rec;
+            size_t appended;
+
+            if (zc_owner && len >= m_tx_coalesce_size) {
+                /* A zerocopy record for the large send, after the coalesced data. */
+                if (m_p_open_rec) {
+                    rec = m_p_open_rec;
+                    m_p_open_rec = nullptr;
+                    if (unlikely(tls_tx_push_record(rec) < 0)) {
+                        return -1;
+                    }
+                }
+                rec = tls_tx_new_record(zc_owner);
+                if (unlikely(!rec)) {
+                    return -1;
+                }
+                appended = rec->append_data(data, len, is_tx_tls13());
+                if (unlikely(tls_tx_push_record(rec) < 0)) {
+                    return -1;
+                }
+            } else {
+                if (!m_p_open_rec) {
+                    m_p_open_rec = tls_tx_new_record(nullptr);
+                    if (unlikely(!m_p_open_rec)) {
+                        return -1;
+                    }
+                    /* Let the group flush push the record. */
+                    m_p_sock->make_dirty();
+                }
+                appended = m_p_open_rec->append_data(data, len, is_tx_tls13());
+                size_t payload = m_p_open_rec->m_size -
+                    (is_tx_tls13() ? TLS_13_RECORD_OVERHEAD : TLS_12_RECORD_OVERHEAD);
+                if (payload >= m_tx_coalesce_size || !m_p_open_rec->avail_space()) {
+                    rec = m_p_open_rec;
+                    m_p_open_rec = nullptr;
+                    if (unlikely(tls_tx_push_record(rec) < 0)) {
+                        return -1;
+                    }
+                }
+            }
+            data += appended;
+            len -= appended;
+        }
+    }
+
+    if (!(flags & XLIO_EXPRESS_MSG_MORE)) {
+        m_p_sock->flush();
+    }
+    return bytes;
+}
+
+int sockinfo_tcp_ops_tls::tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey,
+                                     unsigned flags, void *opaque_op)
+{
+    if (!m_is_tls_tx) {
+        return m_p_sock->tcp_tx_express(iov, iov_len, mkey, flags, opaque_op);
+    }
+
+    /* The copied parts don't refer to the user buffer, the zerocopy records take references. */
+    tls_express_op *op = new (std::nothrow) tls_express_op(m_p_sock, mkey, opaque_op);
+    if (unlikely(!op)) {
+        errno = ENOMEM;
+        return -1;
+    }
+    int ret = tls_tx_express(iov, iov_len, op, flags);
+    op->put();
+    return ret;
+}
+
+int sockinfo_tcp_ops_tls::tx_express_inline(const struct iovec *iov, unsigned iov_len,
+                                            unsigned flags)
+{
+    if (!m_is_tls_tx) {
+        return m_p_sock->tcp_tx_express_inline(iov, iov_len, flags);
+    }
+    return tls_tx_express(iov, iov_len, nullptr, flags);
+}
+
+void sockinfo_tcp_ops_tls::tx_flush()
+{
+    if (m_p_open_rec) {
+        tls_record *rec = m_p_open_rec;
+        m_p_open_rec = nullptr;
+        (void)tls_tx_push_record(rec);
+    }
+}
+
 int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_send_attr &attr)
 {
     if (m_is_tls_tx && seg && p->type != PBUF_RAM) {
         if (seg->len != 0) {
-            if (unlikely(seg->seqno != m_expected_seqno)) {
+            if (unlikely(m_p_tis_prev)) {
+                tls_tx_release_prev_key();
+            }
+            /* Retransmissions of the records before a key update use the previous key. */
+            bool is_prev = is_tx_prev_key(seg->seqno);
+            xlio_tis *tis = is_prev ? m_p_tis_prev : m_p_tis;
+            xlio_tls_info *info = is_prev ? &m_tls_info_tx_prev : &m_tls_info_tx;
+            uint32_t &expected_seqno = is_prev ? m_expected_seqno_prev : m_expected_seqno;
+
+            /* The TLS context is posted with the 1st record, not at setsockopt(). */
+            if (unlikely(!m_is_tls_tx_posted && !is_prev)) {
+                if (!m_p_tx_ring->credits_get(SQ_CREDITS_TLS_TX_CONTEXT)) {
+                    si_ulp_logdbg("No available space in SQ to post TLS TX context");
+                    return ERR_WOULDBLOCK;
+                }
+                m_p_tx_ring->tls_context_post_tx(&m_tls_info_tx, m_p_tis);
+                m_is_tls_tx_posted = true;
+            }
+            if (unlikely(seg->seqno != expected_seqno)) {
 
                 /* For zerocopy the 1st pbuf is always a TCP header and the pbuf is on stack */
                 assert(p->type == PBUF_STACK); /* TCP header pbuf */
@@ -887,7 +1627,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
                 uint8_t *addr = rec->m_p_data;
                 uint64_t recno_be64 = htobe64(rec->m_record_number);
                 bool skip_static =
-                    !memcmp(m_tls_info_tx.rec_seq, &recno_be64, TLS_AES_GCM_REC_SEQ_LEN);
+                    !memcmp(info->rec_seq, &recno_be64, TLS_AES_GCM_REC_SEQ_LEN);
                 bool is_zerocopy = rec->m_p_zc_owner;
                 unsigned mss = m_p_sock->get_mss();
                 uint32_t totlen = seg->seqno - rec->m_seqno;
@@ -932,9 +1672,9 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
                 }
 
                 if (!skip_static) {
-                    memcpy(m_tls_info_tx.rec_seq, &recno_be64, TLS_AES_GCM_REC_SEQ_LEN);
+                    memcpy(info->rec_seq, &recno_be64, TLS_AES_GCM_REC_SEQ_LEN);
                 }
-                m_p_tx_ring->tls_context_resync_tx(&m_tls_info_tx, m_p_tis, skip_static);
+                m_p_tx_ring->tls_context_resync_tx(info, tis, skip_static);
 
                 if (totlen == 0) {
                     m_p_tx_ring->post_nop_fence();
@@ -944,7 +1684,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
 
                     if (is_zerocopy) {
                         /* hdrlen and taillen are prepared above. */
-                        m_p_tx_ring->tls_tx_post_dump_wqe(m_p_tis, (void *)addr, hdrlen,
+                        m_p_tx_ring->tls_tx_post_dump_wqe(tis, (void *)addr, hdrlen,
                                                           LKEY_TX_DEFAULT, true);
                         addr_tail = addr + hdrlen;
                         addr = rec->m_p_zc_data;
@@ -957,7 +1697,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
 
                     while (totlen > 0) {
                         uint32_t len = std::min(totlen, mss);
-                        m_p_tx_ring->tls_tx_post_dump_wqe(m_p_tis, (void *)addr, len, lkey,
+                        m_p_tx_ring->tls_tx_post_dump_wqe(tis, (void *)addr, len, lkey,
                                                           b_fence);
                         totlen -= len;
                         addr += len;
@@ -966,7 +1706,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
                     }
 
                     if (is_zerocopy && taillen) {
-                        m_p_tx_ring->tls_tx_post_dump_wqe(m_p_tis, (void *)addr_tail, taillen,
+                        m_p_tx_ring->tls_tx_post_dump_wqe(tis, (void *)addr_tail, taillen,
                                                           LKEY_TX_DEFAULT, false);
                         --dump_nr;
                     }
@@ -974,7 +1714,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
 
                 assert(dump_nr == 0);
                 NOT_IN_USE(dump_nr);
-                m_expected_seqno = seg->seqno;
+                expected_seqno = seg->seqno;
 
                 /* Statistics */
                 if (m_p_sock->get_sock_stats()) {
@@ -983,8 +1723,8 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
                         (seg->seqno != rec->m_seqno);
                 }
             }
-            m_expected_seqno += seg->len;
-            attr.tis = m_p_tis;
+            expected_seqno += seg->len;
+            attr.tis = tis;
         }
     }
     return 0;
@@ -993,7 +1733,7 @@ int sockinfo_tcp_ops_tls::postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_
 bool sockinfo_tcp_ops_tls::handle_send_ret(ssize_t ret, struct tcp_seg *seg)
 {
     if (ret < 0 && seg) {
-        m_expected_seqno -= seg->len;
+        (is_tx_prev_key(seg->seqno) ? m_expected_seqno_prev : m_expected_seqno) -= seg->len;
         return false;
     }
 
@@ -1116,10 +1856,6 @@ int sockinfo_tcp_ops_tls::tls_rx_decrypt(struct pbuf *plist)
 
     tls_ctx = (EVP_CIPHER_CTX *)m_p_cipher_ctx;
     assert(tls_ctx);
-    ret = g_tls_api->EVP_CIPHER_CTX_reset(tls_ctx);
-    if (unlikely(!ret)) {
-        return TLS_DECRYPT_INTERNAL;
-    }
 
     /* Build nonce. */
     memcpy(buf, m_tls_info_rx.salt, TLS_AES_GCM_SALT_LEN);
@@ -1131,8 +1867,15 @@ int sockinfo_tcp_ops_tls::tls_rx_decrypt(struct pbuf *plist)
         copy_by_offset(&buf[TLS_AES_GCM_SALT_LEN], m_rx_offset + TLS_RECORD_HDR_LEN,
                        TLS_RECORD_IV_LEN);
     }
-    ret = g_tls_api->EVP_DecryptInit_ex(tls_ctx, (EVP_CIPHER *)m_p_evp_cipher, nullptr,
-                                        m_tls_info_rx.key, buf);
+    if (likely(m_is_cipher_ctx_dec)) {
+        /* Same key, only the nonce changes. Saves the key expansion for each record. */
+        ret = g_tls_api->EVP_DecryptInit_ex(tls_ctx, nullptr, nullptr, nullptr, buf);
+    } else {
+        ret = g_tls_api->EVP_CIPHER_CTX_reset(tls_ctx) &&
+            g_tls_api->EVP_DecryptInit_ex(tls_ctx, (EVP_CIPHER *)m_p_evp_cipher, nullptr,
+                                          m_tls_info_rx.key, buf);
+        m_is_cipher_ctx_dec = ret;
+    }
     if (unlikely(!ret)) {
         return TLS_DECRYPT_INTERNAL;
     }
@@ -1199,6 +1942,7 @@ int sockinfo_tcp_ops_tls::tls_rx_encrypt(struct pbuf *plist)
 
     tls_ctx = (EVP_CIPHER_CTX *)m_p_cipher_ctx;
     assert(tls_ctx);
+    m_is_cipher_ctx_dec = false;
     ret = g_tls_api->EVP_CIPHER_CTX_reset(tls_ctx);
     if (unlikely(!ret)) {
         return TLS_DECRYPT_INTERNAL;
@@ -10,9 +10,14 @@
 #include "sockinfo.h" /* xlio_tx_call_attr_t */
 #include "proto/dst_entry.h" /* xlio_send_attr */
 #include "proto/tls.h" /* xlio_tls_info */
+#include "proto/nvme_tcp.h"
 #include "lwip/err.h" /* err_t */
+#include "lwip/tcp.h" /* tcp_recv_fn */
 
 #include <stdint.h>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 /*
  * TODO Make ULP layer generic (not TCP specific) and implement ULP manager.
@@ -21,6 +26,8 @@
 /* Forward declarations */
 class sockinfo_tcp;
 class xlio_tis;
+class tls_record;
+class mem_desc;
 struct pbuf;
 
 class sockinfo_tcp_ops {
@@ -35,6 +42,12 @@ public:
     virtual ssize_t tx(xlio_tx_call_attr_t &tx_arg);
     virtual int postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_send_attr &attr);
     virtual bool handle_send_ret(ssize_t ret, struct tcp_seg *seg);
+    /* XLIO Ultra API send path. */
+    virtual int tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey,
+                           unsigned flags, void *opaque_op);
+    virtual int tx_express_inline(const struct iovec *iov, unsigned iov_len, unsigned flags);
+    /* Called before the socket pushes its queued data to the wire. */
+    virtual void tx_flush() {}
 
     virtual err_t recv(struct pbuf *p)
     {
@@ -55,6 +68,59 @@ public:
     ssize_t tx(xlio_tx_call_attr_t &tx_arg) override;
 };
 
+/*
+ * NVMe/TCP digests and C2HData placement in software (SO_XLIO_NVME_OFFLOAD). Both streams are
+ * parsed PDU by PDU: TX sends the digests from XLIO buffers in place of the fields reserved in
+ * the PDUs and RX verifies them and removes the placed data before the buffers go to the
+ * socket. The TX and RX calls are forwarded to the previous ops.
+ */
+class sockinfo_tcp_ops_nvme : public sockinfo_tcp_ops {
+public:
+    sockinfo_tcp_ops_nvme(sockinfo_tcp *sock, sockinfo_tcp_ops *next, uint32_t flags);
+    ~sockinfo_tcp_ops_nvme() override;
+
+    int setsockopt(int, int, const void *, socklen_t) override;
+    ssize_t tx(xlio_tx_call_attr_t &tx_arg) override;
+    int tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey, unsigned flags,
+                   void *opaque_op) override;
+    int tx_express_inline(const struct iovec *iov, unsigned iov_len, unsigned flags) override;
+    void tx_flush() override { m_p_next->tx_flush(); }
+
+    void get_offload(struct xlio_nvme_offload &offload) const
+    {
+        offload.flags = m_flags;
+        offload.rx_digest_errors = m_rx_digest_errors;
+    }
+
+private:
+    /* Position in a PDU stream, the header is kept up to the C2HData specific fields. */
+    struct pdu_state {
+        uint8_t hdr[NVME_TCP_C2H_DATA_HLEN];
+        uint32_t offset;
+        uint32_t crc;
+        uint8_t *ddp; /* Placement of the data of the current PDU, nullptr if not placed */
+    };
+
+    ssize_t tx_build(const struct iovec *iov, size_t iov_len, size_t limit);
+    void tx_emit(uint8_t *data, uint32_t len, bool is_digest);
+    bool pdu_advance(pdu_state &pdu, uint8_t *data, uint32_t len, bool is_tx, uint32_t *kept);
+    uint8_t *ddp_target(const pdu_state &pdu, uint32_t data_len);
+
+    static err_t rx_lwip_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+
+    sockinfo_tcp_ops *const m_p_next;
+    tcp_recv_fn m_rx_next;
+    uint32_t m_flags;
+    uint32_t m_rx_digest_errors = 0U;
+    pdu_state m_tx_pdu = {};
+    pdu_state m_rx_pdu = {};
+    std::unordered_map<uint16_t, struct iovec> m_ddp_bufs;
+    /* The send in progress: the application buffers with the digest fields replaced */
+    std::vector<struct iovec> m_tx_iov;
+    std::vector<bool> m_tx_iov_digest;
+    std::deque<uint32_t> m_tx_digests;
+};
+
 #ifdef DEFINED_UTLS
 
 enum xlio_utls_mode {
@@ -73,6 +139,10 @@ public:
     ssize_t tx(xlio_tx_call_attr_t &tx_arg) override;
     int postrouting(struct pbuf *p, struct tcp_seg *seg, xlio_send_attr &attr) override;
     bool handle_send_ret(ssize_t ret, struct tcp_seg *seg) override;
+    int tx_express(const struct iovec *iov, unsigned iov_len, uint32_t mkey, unsigned flags,
+                   void *opaque_op) override;
+    int tx_express_inline(const struct iovec *iov, unsigned iov_len, unsigned flags) override;
+    void tx_flush() override;
 
     void get_record_buf(mem_buf_desc_t *&buf, uint8_t *&data, bool is_zerocopy);
 
@@ -84,6 +154,16 @@ private:
     void terminate_session_fatal(uint8_t alert_type);
 
     err_t tls_rx_consume_ready_packets();
+    int tls_tx_express(const struct iovec *iov, unsigned iov_len, mem_desc *zc_owner,
+                       unsigned flags);
+    tls_record *tls_tx_new_record(mem_desc *zc_owner);
+    int tls_tx_push_record(tls_record *rec);
+    int tls_tx_update_key(const xlio_tls_info &info_old, uint64_t recno);
+    void tls_tx_release_prev_key();
+    bool is_tx_prev_key(uint32_t seqno) const
+    {
+        return m_p_tis_prev && static_cast<int32_t>(seqno - m_rekey_seqno_tx) < 0;
+    }
     err_t recv(struct pbuf *p) override;
     void copy_by_offset(uint8_t *dst, uint32_t offset, uint32_t len);
     uint16_t offset_to_host16(uint32_t offset);
@@ -138,6 +218,16 @@ private:
 
     /* TX specific fields */
     xlio_tis *m_p_tis;
+    /* Static and progress params of the TIS are posted. */
+    bool m_is_tls_tx_posted;
+    /*
+     * TLS1.3 key update. The records before m_rekey_seqno_tx keep the previous TIS for
+     * their retransmissions until they are acknowledged.
+     */
+    xlio_tis *m_p_tis_prev;
+    xlio_tls_info m_tls_info_tx_prev;
+    uint32_t m_rekey_seqno_tx;
+    uint32_t m_expected_seqno_prev;
 
     /* A buffer to keep multiple headers for zerocopy TLS records. */
     mem_buf_desc_t *m_zc_stor;
@@ -147,6 +237,9 @@ private:
     uint32_t m_expected_seqno;
     /* Track TX record number for TX resync flow. */
     uint64_t m_next_recno_tx;
+    /* Record which coalesces the small XLIO Ultra API sends until a flush. */
+    tls_record *m_p_open_rec;
+    uint32_t m_tx_coalesce_size;
 
     /* RX specific fields */
     xlio_tir *m_p_tir;
@@ -154,6 +247,8 @@ private:
     /* OpenSSL objects for SW decryption. */
     void *m_p_evp_cipher;
     void *m_p_cipher_ctx;
+    /* The key schedule of m_p_cipher_ctx is set up for decryption. */
+    bool m_is_cipher_ctx_dec;
 
     /* List of RX buffers that contain unhandled records. */
     xlio_desc_list_t m_rx_bufs;
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "sock/tcp_timewait.h"
+#include "lwip/tcp_impl.h"
+
+#include <algorithm>
+#include <mutex>
+
+#define MODULE_NAME "tcp_timewait"
+
+tcp_timewait_table g_tcp_timewait;
+
+tcp_timewait_table::tcp_timewait_table()
+    : m_lock("tcp_timewait")
+    , m_slots(TCP_TIMEWAIT_SLOTS)
+{
+}
+
+uint64_t tcp_timewait_table::now_tick()
+{
+    tscval_t now;
+
+    if (unlikely(!m_slot_tsc)) {
+        m_slot_tsc = std::max<tscval_t>(1U, get_tsc_rate_per_second() * TCP_TIMEWAIT_SLOT_SEC);
+    }
+    gettimeoftsc(&now);
+    return now / m_slot_tsc;
+}
+
+void tcp_timewait_table::add(const flow_tuple &key, uint32_t snd_nxt, uint32_t rcv_nxt)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    uint64_t tick = now_tick();
+
+    if (!m_n_count) {
+        m_cur_tick = tick;
+    }
+    // 2*MSL, rounded up to the next slot
+    tick += (2U * TCP_MSL / 1000U + TCP_TIMEWAIT_SLOT_SEC - 1U) / TCP_TIMEWAIT_SLOT_SEC + 1U;
+
+    auto ret = m_records.emplace(key, record {snd_nxt, rcv_nxt, tick});
+    if (!ret.second) {
+        ret.first->second = record {snd_nxt, rcv_nxt, tick};
+    }
+    m_slots[tick % TCP_TIMEWAIT_SLOTS].push_back(key);
+    m_n_count.store(static_cast<uint32_t>(m_records.size()), std::memory_order_relaxed);
+}
+
+bool tcp_timewait_table::take(const flow_tuple &key, uint32_t &snd_nxt, uint32_t &rcv_nxt)
+{
+    if (!m_n_count.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+    auto iter = m_records.find(key);
+
+    if (iter == m_records.end()) {
+        return false;
+    }
+    snd_nxt = iter->second.snd_nxt;
+    rcv_nxt = iter->second.rcv_nxt;
+    m_records.erase(iter);
+    m_n_count.store(static_cast<uint32_t>(m_records.size()), std::memory_order_relaxed);
+    return true;
+}
+
+void tcp_timewait_table::process_expired()
+{
+    if (m_lock.trylock()) {
+        // Another thread is expiring the records
+        return;
+    }
+
+    uint64_t tick = now_tick();
+    uint64_t last = std::min(tick, m_cur_tick + TCP_TIMEWAIT_SLOTS - 1U);
+
+    for (; m_cur_tick <= last; ++m_cur_tick) {
+        uint64_t idx = m_cur_tick % TCP_TIMEWAIT_SLOTS;
+        std::vector<flow_tuple> &slot = m_slots[idx];
+        // A record which expires on a later revolution of the wheel keeps its key in the slot
+        auto end = std::remove_if(slot.begin(), slot.end(), [&](const flow_tuple &key) {
+            auto iter = m_records.find(key);
+            if (iter == m_records.end()) {
+                return true;
+            }
+            if (iter->second.expire_tick <= tick) {
+                m_records.erase(iter);
+                return true;
+            }
+            return iter->second.expire_tick % TCP_TIMEWAIT_SLOTS != idx;
+        });
+        slot.erase(end, slot.end());
+    }
+    m_cur_tick = tick;
+    m_n_count.store(static_cast<uint32_t>(m_records.size()), std::memory_order_relaxed);
+
+    m_lock.unlock();
+}
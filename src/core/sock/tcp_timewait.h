@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TCP_TIMEWAIT_H_
+#define TCP_TIMEWAIT_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+#include "proto/flow_tuple.h"
+#include "utils/lock_wrapper.h"
+#include "utils/rdtsc.h"
+
+#define TCP_TIMEWAIT_SLOT_SEC 1U
+#define TCP_TIMEWAIT_SLOTS    256U
+/* Distance of a reused 4-tuple ISS from the last sequence of the previous incarnation */
+#define TCP_TIMEWAIT_ISS_GAP (1U << 18)
+
+/**
+ * Compact records of the outbound connections in TIME_WAIT.
+ *
+ * A closed connection which enters TIME_WAIT leaves its 4-tuple and sequence numbers
+ * here and the socket and its steering rule are released. The records expire on a
+ * hashed timer wheel after 2*MSL. A new connection over the same 4-tuple takes the
+ * record and starts after the sequence space of the previous incarnation.
+ */
+class tcp_timewait_table {
+public:
+    tcp_timewait_table();
+
+    void add(const flow_tuple &key, uint32_t snd_nxt, uint32_t rcv_nxt);
+    /* Removes the record of the 4-tuple, returns false if there is none. */
+    bool take(const flow_tuple &key, uint32_t &snd_nxt, uint32_t &rcv_nxt);
+
+    void process()
+    {
+        if (m_n_count.load(std::memory_order_relaxed)) {
+            process_expired();
+        }
+    }
+
+private:
+    struct record {
+        uint32_t snd_nxt;
+        uint32_t rcv_nxt;
+        uint64_t expire_tick;
+    };
+
+    uint64_t now_tick();
+    void process_expired();
+
+    lock_spin m_lock;
+    std::unordered_map<flow_tuple, record> m_records;
+    /* The slots keep the keys only, a key whose record was taken or renewed is skipped */
+    std::vector<std::vector<flow_tuple>> m_slots;
+    std::atomic<uint32_t> m_n_count {0};
+    tscval_t m_slot_tsc = 0;
+    uint64_t m_cur_tick = 0;
+};
+
+extern tcp_timewait_table g_tcp_timewait;
+
+#endif /* TCP_TIMEWAIT_H_ */
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TX_TS_SINK_H
+#define TX_TS_SINK_H
+
+#include <time.h>
+#include <mutex>
+#include "utils/lock_wrapper.h"
+#include "proto/mem_buf_desc.h"
+
+class sockinfo;
+
+/**
+ * The receiver of the TX HW timestamps of a socket.
+ *
+ * A timestamped buffer holds a reference, since its completion can be polled after the
+ * socket is destroyed. The socket detaches from the sink on destruction and such late
+ * timestamps are dropped. The completions are reported under the ring TX lock.
+ */
+class tx_ts_sink {
+public:
+    explicit tx_ts_sink(sockinfo *owner)
+        : m_owner(owner)
+    {
+    }
+
+    void get() { __atomic_fetch_add(&m_ref, 1U, __ATOMIC_RELAXED); }
+    void put()
+    {
+        if (__atomic_sub_fetch(&m_ref, 1U, __ATOMIC_ACQ_REL) == 0U) {
+            delete this;
+        }
+    }
+
+    void detach()
+    {
+        {
+            std::lock_guard<decltype(m_lock)> lock(m_lock);
+            m_owner = nullptr;
+        }
+        put();
+    }
+
+    // Implemented in sockinfo.cpp
+    void complete(const tx_ts_request &req, const struct timespec &hw_timestamp);
+
+    // Makes the buffer of the last WQE of a send carry the request
+    static void attach(mem_buf_desc_t *p_desc, const tx_ts_request &req)
+    {
+        req.sink->get();
+        p_desc->tx.ts = req;
+        p_desc->m_flags |= mem_buf_desc_t::TX_TIMESTAMP;
+    }
+
+    /*
+     * Consumes the request of a TX buffer whose WQE completed. The timestamp is null for
+     * a failed or a dropped WQE.
+     */
+    static void release(mem_buf_desc_t *p_desc, const struct timespec *hw_timestamp)
+    {
+        tx_ts_sink *sink = p_desc->tx.ts.sink;
+
+        p_desc->m_flags &= ~mem_buf_desc_t::TX_TIMESTAMP;
+        if (hw_timestamp && !(p_desc->m_flags & mem_buf_desc_t::HAD_CQE_ERROR)) {
+            sink->complete(p_desc->tx.ts, *hw_timestamp);
+        }
+        sink->put();
+    }
+
+private:
+    lock_spin m_lock;
+    sockinfo *m_owner;
+    uint32_t m_ref = 1U;
+};
+
+#endif /* TX_TS_SINK_H */
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef ADAPTIVE_POLL_H
+#define ADAPTIVE_POLL_H
+
+#include <stdint.h>
+#include <algorithm>
+
+/* Polling before an expected long wait, it saves the sleep of the data arriving right away */
+#define ADAPTIVE_POLL_MIN_USEC 10U
+/* Weight of a new wait in the average, 1/8 */
+#define ADAPTIVE_POLL_SHIFT 3U
+
+/**
+ * Polling time of a blocking wait derived from the previous waits.
+ *
+ * The owner reports how long each wait took until the data arrived, the next wait polls for
+ * twice the average. A wait expected to be longer than the configured polling isn't worth
+ * the CPU and blocks after a short poll.
+ * Not thread safe, a race between the threads only skews the estimate.
+ */
+class adaptive_poll {
+public:
+    uint32_t budget_usec(uint32_t max_usec) const
+    {
+        if (!m_avg_usec_scaled) {
+            return max_usec;
+        }
+
+        uint64_t expected = m_avg_usec_scaled >> ADAPTIVE_POLL_SHIFT;
+        if (expected > max_usec) {
+            return std::min(ADAPTIVE_POLL_MIN_USEC, max_usec);
+        }
+        return static_cast<uint32_t>(
+            std::min<uint64_t>(max_usec, std::max<uint64_t>(expected * 2U, ADAPTIVE_POLL_MIN_USEC)));
+    }
+
+    void update(uint64_t wait_usec)
+    {
+        // Keep the average non zero, zero stands for no wait seen yet
+        wait_usec = std::max<uint64_t>(std::min<uint64_t>(wait_usec, UINT32_MAX), 1U);
+        if (!m_avg_usec_scaled) {
+            m_avg_usec_scaled = wait_usec << ADAPTIVE_POLL_SHIFT;
+        } else {
+            m_avg_usec_scaled += wait_usec - (m_avg_usec_scaled >> ADAPTIVE_POLL_SHIFT);
+        }
+    }
+
+private:
+    uint64_t m_avg_usec_scaled = 0U; // Average wait << ADAPTIVE_POLL_SHIFT
+};
+
+#endif /* ADAPTIVE_POLL_H */
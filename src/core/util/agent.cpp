@@ -21,6 +21,7 @@
 #include "core/sock/sock-redirect.h"
 #include "core/util/list.h"
 #include "core/util/agent.h"
+#include "core/util/xlio_stats.h"
 
 #undef MODULE_NAME
 #define MODULE_NAME "agent:"
@@ -65,6 +66,8 @@
         vlog_printf(_level, "*************************************************************\n");    \
     } while (0)
 
+extern global_stats_t g_global_stat_static;
+
 agent *g_p_agent = nullptr;
 
 agent::agent()
@@ -331,6 +334,11 @@ int agent::put(const void *data, size_t length, intptr_t tag)
                 list_add_tail(&msg->item, &m_free_queue);
                 m_msg_num++;
             }
+            if (list_empty(&m_free_queue)) {
+                ++g_global_stat_static.n_agent_msgs_dropped;
+                m_msg_lock.unlock();
+                return -ENOMEM;
+            }
         }
         /* get message from free queue */
         /* coverity[overwrite_var] */
@@ -339,6 +347,8 @@ int agent::put(const void *data, size_t length, intptr_t tag)
 
         /* put message into wait queue */
         list_add_tail(&msg->item, &m_wait_queue);
+        ++g_global_stat_static.n_agent_msgs;
+        ++g_global_stat_static.n_agent_wait_queue;
     }
 
     /* update message */
@@ -355,7 +365,6 @@ int agent::put(const void *data, size_t length, intptr_t tag)
 
 void agent::progress(void)
 {
-    agent_msg_t *msg = nullptr;
     struct timeval tv_now = TIMEVAL_INITIALIZER;
     static struct timeval tv_inactive_elapsed = TIMEVAL_INITIALIZER;
     static struct timeval tv_alive_elapsed = TIMEVAL_INITIALIZER;
@@ -391,17 +400,14 @@ go:
         tv_alive_elapsed = tv_now;
         tv_alive_elapsed.tv_sec += AGENT_DEFAULT_ALIVE;
 
-        /* Process all messages that are in wait queue */
+        /* Process all messages that are in wait queue, the ones which
+         * don't fit the daemon queue are sent on the next tick
+         */
         m_msg_lock.lock();
         while (!list_empty(&m_wait_queue)) {
-            msg = list_first_entry(&m_wait_queue, agent_msg_t, item);
-            if (0 > send(msg)) {
+            if (0 > send_batch()) {
                 break;
             }
-            list_del_init(&msg->item);
-            msg->length = 0;
-            msg->tag = AGENT_MSG_TAG_INVALID;
-            list_add_tail(&msg->item, &m_free_queue);
         }
         m_msg_lock.unlock();
     }
@@ -421,9 +427,14 @@ void agent::progress_cb(void)
     m_cb_lock.unlock();
 }
 
-int agent::send(agent_msg_t *msg)
+int agent::send_batch(void)
 {
     int rc = 0;
+    char buf[XLIO_AGENT_MSG_MAX];
+    size_t length = 0;
+    int num = 0;
+    agent_msg_t *msg = nullptr;
+    struct list_head *entry = nullptr;
 
     if (AGENT_ACTIVE != m_state) {
         return -ENODEV;
@@ -433,20 +444,42 @@ int agent::send(agent_msg_t *msg)
         return -EBADF;
     }
 
-    if (!msg) {
-        return -EINVAL;
+    /* Put the messages from the head of wait queue into a single datagram */
+    list_for_each(entry, &m_wait_queue)
+    {
+        msg = list_entry(entry, agent_msg_t, item);
+        if (length + msg->length > sizeof(buf)) {
+            break;
+        }
+        memcpy(buf + length, &msg->data, msg->length);
+        length += msg->length;
+        num++;
     }
 
-    /* send() in blocking manner */
-    sys_call(rc, send, m_sock_fd, (void *)&msg->data, msg->length, 0);
+    /* send() in non blocking manner, the daemon may fall behind */
+    sys_call(rc, send, m_sock_fd, buf, length, MSG_DONTWAIT);
     if (rc < 0) {
-        __log_dbg("Failed to send() errno %d (%s)", errno, strerror(errno));
         rc = -errno;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            ++g_global_stat_static.n_agent_send_deferred;
+            goto err;
+        }
+        __log_dbg("Failed to send() errno %d (%s)", errno, strerror(errno));
         m_state = AGENT_INACTIVE;
         __log_dbg("Agent is inactivated. state = %d", m_state);
         goto err;
     }
 
+    ++g_global_stat_static.n_agent_batches;
+    g_global_stat_static.n_agent_wait_queue -= num;
+    while (num--) {
+        msg = list_first_entry(&m_wait_queue, agent_msg_t, item);
+        list_del_init(&msg->item);
+        msg->length = 0;
+        msg->tag = AGENT_MSG_TAG_INVALID;
+        list_add_tail(&msg->item, &m_free_queue);
+    }
+
 err:
     return rc;
 }
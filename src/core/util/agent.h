@@ -111,7 +111,7 @@ private:
     int m_msg_num;
 
     int create_agent_socket(void);
-    int send(agent_msg_t *msg);
+    int send_batch(void);
     int send_msg_init(void);
     int send_msg_exit(void);
     void progress_cb(void);
@@ -33,7 +33,11 @@
 #define XLIO_MSG_EXIT  0x03
 #define XLIO_MSG_ACK   0x80
 
-#define XLIO_AGENT_VER 0x04
+/* Version 0x05: an agent puts several messages into a datagram */
+#define XLIO_AGENT_VER 0x05
+
+/* Maximum size of a datagram */
+#define XLIO_AGENT_MSG_MAX 4096
 
 #define XLIO_AGENT_BASE_NAME "xlioagent"
 #define XLIO_AGENT_ADDR      "/var/run/" XLIO_AGENT_BASE_NAME ".sock"
@@ -7,10 +7,22 @@
 #ifndef CACHED_OBJ_POOL_H
 #define CACHED_OBJ_POOL_H
 
+#include <atomic>
 #include <utility>
+#include <vector>
 #include "dev/allocator.h"
 #include "utils/lock_wrapper.h"
 
+#define CACHED_OBJ_MAGAZINE_SIZE 64U
+
+/*
+ * Objects pool with a per thread magazine layer for single object operations.
+ *
+ * Every thread owns a loaded and a previous magazine, an object is allocated and freed
+ * from them without a lock. Only full magazines are exchanged with the depot of the pool
+ * under the lock, the previous magazine is always either full or empty. A thread caches
+ * objects of the first pool it uses, the other pools are served by the locked path.
+ */
 template <typename T> class cached_obj_pool : lock_spin {
 public:
     cached_obj_pool(const char *pool_name, size_t alloc_batch, uint32_t &global_obj_pool_size_ref,
@@ -21,13 +33,29 @@ public:
     T *get_objs(uint32_t amount);
     void put_objs(T *obj_list);
 
+    inline T *get_obj();
+    inline void put_obj(T *obj);
+
     static T *split_obj_list(uint32_t count, T *&obj_list, uint32_t &total_count);
 
 protected:
+    struct magazines {
+        cached_obj_pool *owner = nullptr;
+        T *loaded = nullptr;
+        T *previous = nullptr;
+        uint32_t loaded_count = 0U;
+        ~magazines();
+    };
+
     bool expand();
+    bool load_magazine(magazines &mags);
+    void unload_magazine(magazines &mags);
 
     T *m_p_head = nullptr;
     xlio_allocator_heap m_allocator;
+    std::vector<T *> m_depot; // Full magazines
+    static thread_local magazines s_mags;
+    static std::atomic<cached_obj_pool *> s_live_pool;
 
     struct {
         unsigned total_objs;
@@ -51,10 +79,12 @@ cached_obj_pool<T>::cached_obj_pool(const char *pool_name, size_t alloc_batch,
     , m_pool_name(pool_name)
 {
     expand();
+    s_live_pool.store(this, std::memory_order_release);
 }
 
 template <typename T> cached_obj_pool<T>::~cached_obj_pool()
 {
+    s_live_pool.store(nullptr, std::memory_order_release);
     vlog_printf(VLOG_DEBUG, "%s pool statistics:\n", m_pool_name);
     vlog_printf(VLOG_DEBUG, "  allocations=%u expands=%u total_segs=%u\n", m_stats.allocations,
                 m_stats.expands, m_stats.total_objs);
@@ -119,6 +149,101 @@ template <typename T> void cached_obj_pool<T>::put_objs(T *obj_list)
     unlock();
 }
 
+template <typename T> inline T *cached_obj_pool<T>::get_obj()
+{
+    magazines &mags = s_mags;
+
+    if (unlikely(mags.owner != this)) {
+        if (mags.owner) {
+            return get_objs(1U);
+        }
+        mags.owner = this;
+    }
+    if (unlikely(!mags.loaded)) {
+        if (mags.previous) {
+            mags.loaded = mags.previous;
+            mags.previous = nullptr;
+            mags.loaded_count = CACHED_OBJ_MAGAZINE_SIZE;
+        } else if (!load_magazine(mags)) {
+            return nullptr;
+        }
+    }
+
+    T *obj = mags.loaded;
+    mags.loaded = obj->next;
+    obj->next = nullptr;
+    --mags.loaded_count;
+    return obj;
+}
+
+// Assumed obj is a single object
+template <typename T> inline void cached_obj_pool<T>::put_obj(T *obj)
+{
+    magazines &mags = s_mags;
+
+    if (unlikely(mags.owner != this)) {
+        if (mags.owner) {
+            obj->next = nullptr;
+            put_objs(obj);
+            return;
+        }
+        mags.owner = this;
+    }
+    if (unlikely(mags.loaded_count == CACHED_OBJ_MAGAZINE_SIZE)) {
+        if (mags.previous) {
+            unload_magazine(mags);
+        }
+        mags.previous = mags.loaded;
+        mags.loaded = nullptr;
+        mags.loaded_count = 0U;
+    }
+
+    obj->next = mags.loaded;
+    mags.loaded = obj;
+    ++mags.loaded_count;
+}
+
+template <typename T> bool cached_obj_pool<T>::load_magazine(magazines &mags)
+{
+    lock();
+    if (!m_depot.empty()) {
+        mags.loaded = m_depot.back();
+        m_depot.pop_back();
+        m_stats.global_obj_pool_size -= CACHED_OBJ_MAGAZINE_SIZE;
+        unlock();
+        mags.loaded_count = CACHED_OBJ_MAGAZINE_SIZE;
+        return true;
+    }
+    unlock();
+
+    mags.loaded = get_objs(CACHED_OBJ_MAGAZINE_SIZE);
+    mags.loaded_count = mags.loaded ? CACHED_OBJ_MAGAZINE_SIZE : 0U;
+    return mags.loaded;
+}
+
+template <typename T> void cached_obj_pool<T>::unload_magazine(magazines &mags)
+{
+    lock();
+    m_depot.push_back(mags.previous);
+    m_stats.global_obj_pool_size += CACHED_OBJ_MAGAZINE_SIZE;
+    unlock();
+    mags.previous = nullptr;
+}
+
+template <typename T> cached_obj_pool<T>::magazines::~magazines()
+{
+    // The pool may be already destroyed on the process exit
+    if (owner && owner == s_live_pool.load(std::memory_order_acquire)) {
+        owner->put_objs(loaded);
+        owner->put_objs(previous);
+    }
+}
+
+template <typename T>
+thread_local typename cached_obj_pool<T>::magazines cached_obj_pool<T>::s_mags;
+
+template <typename T> std::atomic<cached_obj_pool<T> *> cached_obj_pool<T>::s_live_pool {nullptr};
+
 // Splitting obj list such that first 'count' objs are returned and 'obj_list'
 // is updated to point to the remaining objs.
 // The length of obj_list is assumed to be at least 'count' long.
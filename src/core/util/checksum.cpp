@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <string.h>
+
+#include "utils/asm.h"
+#include "checksum.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * The ones' complement sum doesn't depend on the word size: the 32 bit words are added into a
+ * 64 bit accumulator, which can't overflow, and folded to 16 bits at the end.
+ */
+static inline uint64_t csum_tail(const uint8_t *p, size_t len, uint64_t acc)
+{
+    uint64_t word;
+
+    for (; len >= sizeof(word); len -= sizeof(word), p += sizeof(word)) {
+        memcpy(&word, p, sizeof(word));
+        acc += (word & 0xFFFFFFFFU) + (word >> 32U);
+    }
+    if (len) {
+        word = 0U;
+        memcpy(&word, p, len);
+        acc += (word & 0xFFFFFFFFU) + (word >> 32U);
+    }
+    return acc;
+}
+
+static uint64_t csum_scalar(const uint8_t *p, size_t len)
+{
+    uint64_t acc0 = 0U, acc1 = 0U;
+
+    // Two chains hide the latency of the adds
+    for (; len >= 16U; len -= 16U, p += 16U) {
+        uint64_t w0, w1;
+
+        memcpy(&w0, p, sizeof(w0));
+        memcpy(&w1, p + 8, sizeof(w1));
+        acc0 += (w0 & 0xFFFFFFFFU) + (w0 >> 32U);
+        acc1 += (w1 & 0xFFFFFFFFU) + (w1 >> 32U);
+    }
+    return csum_tail(p, len, acc0 + acc1);
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2"))) static uint64_t csum_avx2(const uint8_t *p, size_t len)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    uint64_t lanes[4];
+
+    // The low and the high 32 bit halves of each 64 bit lane go to separate accumulators
+    for (; len >= 64U; len -= 64U, p += 64U) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+
+        acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v0, mask));
+        acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v0, 32));
+        acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v1, mask));
+        acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v1, 32));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(acc0, acc1));
+    return csum_tail(p, len, lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+static const bool s_csum_avx2 = cpu_has_avx2();
+
+static inline uint64_t csum_kernel(const uint8_t *p, size_t len)
+{
+    return s_csum_avx2 ? csum_avx2(p, len) : csum_scalar(p, len);
+}
+
+#elif defined(__aarch64__)
+
+static uint64_t csum_neon(const uint8_t *p, size_t len)
+{
+    uint64x2_t acc0 = vdupq_n_u64(0U);
+    uint64x2_t acc1 = vdupq_n_u64(0U);
+
+    // Each pair of 32 bit words is added into a 64 bit lane
+    for (; len >= 32U; len -= 32U, p += 32U) {
+        acc0 = vpadalq_u32(acc0, vld1q_u32(reinterpret_cast<const uint32_t *>(p)));
+        acc1 = vpadalq_u32(acc1, vld1q_u32(reinterpret_cast<const uint32_t *>(p + 16)));
+    }
+    return csum_tail(p, len, vaddvq_u64(vaddq_u64(acc0, acc1)));
+}
+
+static inline uint64_t csum_kernel(const uint8_t *p, size_t len)
+{
+    return csum_neon(p, len);
+}
+
+#else
+
+static inline uint64_t csum_kernel(const uint8_t *p, size_t len)
+{
+    return csum_scalar(p, len);
+}
+
+#endif
+
+uint32_t csum_partial(const void *buf, size_t len, uint32_t sum)
+{
+    uint64_t acc = sum;
+
+    // The vector setup doesn't pay off for the headers
+    if (len < 64U) {
+        acc += csum_scalar(static_cast<const uint8_t *>(buf), len);
+    } else {
+        acc += csum_kernel(static_cast<const uint8_t *>(buf), len);
+    }
+    acc = (acc & 0xFFFFFFFFU) + (acc >> 32U);
+    return static_cast<uint32_t>((acc & 0xFFFFFFFFU) + (acc >> 32U));
+}
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Internet checksum (RFC 1071) of the paths which can't use the HW checksum, e.g. the IP
+ * fragments, the loopback and the devices without the offload.
+ * csum_partial() adds the 16 bit words of the buffer to a partial sum, an odd length is padded
+ * with zero. The sum is in the network byte order of the words, as the headers keep it.
+ * The AVX2 or the NEON kernel is selected at startup, the scalar one adds 32 bit words.
+ */
+uint32_t csum_partial(const void *buf, size_t len, uint32_t sum);
+
+// Folds a partial sum to 16 bits, without the final inversion
+static inline uint16_t csum_fold16(uint64_t sum)
+{
+    sum = (sum & 0xFFFFFFFFU) + (sum >> 32U);
+    sum = (sum & 0xFFFFFFFFU) + (sum >> 32U);
+    sum = (sum & 0xFFFFU) + (sum >> 16U);
+    sum = (sum & 0xFFFFU) + (sum >> 16U);
+    return static_cast<uint16_t>(sum);
+}
+
+static inline uint16_t csum_fold(uint64_t sum)
+{
+    return static_cast<uint16_t>(~csum_fold16(sum));
+}
+
+#endif /* CHECKSUM_H */
@@ -136,6 +136,16 @@ public:
         return m_used_containers.front()->m_p_buffer[m_front];
     }
 
+    inline T back() const
+    {
+        // Check if the list is empty.
+        if (unlikely(empty())) {
+            return NULL;
+        }
+        /* coverity[returned_null][dereference] */
+        return m_used_containers.back()->m_p_buffer[m_back];
+    }
+
     inline void pop_front()
     {
         // Check if the list is empty.
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "vlogger/vlogger.h"
+#include "coarse_clock.h"
+
+#define MODULE_NAME "coarse_clock"
+
+seqlock_data<coarse_clock_calib_t> g_coarse_clock_calib;
+// The threads start with epoch 0, so their first read converts the TSC
+std::atomic<uint32_t> g_coarse_clock_epoch {1U};
+thread_local coarse_clock_t g_coarse_clock = {0U, 0U};
+
+// The last calibration point, written by the internal thread only
+static coarse_clock_calib_t s_calib;
+
+static void coarse_clock_sample(coarse_clock_calib_t &calib)
+{
+    struct timespec ts;
+    tscval_t tsc;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    gettimeoftsc(&tsc);
+    calib.tsc = tsc;
+    calib.nsec = ts_to_nsec(&ts);
+}
+
+void coarse_clock_init()
+{
+    coarse_clock_sample(s_calib);
+    s_calib.mult = (static_cast<uint64_t>(NSEC_PER_SEC) << 32U) / get_tsc_rate_per_second();
+    g_coarse_clock_calib.store(s_calib);
+    vlog_printf(VLOG_DEBUG, MODULE_NAME ": %llu TSC ticks per second\n",
+                get_tsc_rate_per_second());
+}
+
+void coarse_clock_tick()
+{
+    tscval_t tsc;
+
+    gettimeoftsc(&tsc);
+    if (tsc - s_calib.tsc >= get_tsc_rate_per_second()) {
+        coarse_clock_calib_t calib;
+
+        // The rate is measured over the last second, the nominal CPU rate may be off
+        coarse_clock_sample(calib);
+        if (calib.tsc > s_calib.tsc && calib.nsec > s_calib.nsec) {
+            unsigned __int128 nsec = calib.nsec - s_calib.nsec;
+            calib.mult = static_cast<uint64_t>((nsec << 32U) / (calib.tsc - s_calib.tsc));
+        } else {
+            calib.mult = s_calib.mult;
+        }
+        s_calib = calib;
+        g_coarse_clock_calib.store(s_calib);
+    }
+    g_coarse_clock_epoch.fetch_add(1U, std::memory_order_relaxed);
+    coarse_clock_update();
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef COARSE_CLOCK_H
+#define COARSE_CLOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+#include "utils/rdtsc.h"
+#include "utils/types.h"
+#include "core/util/seqlock.h"
+
+/*
+ * Per thread CLOCK_MONOTONIC time cached once per poll pass, for the TCP timestamps, the RTT
+ * samples and the timer checks. The time is converted from the TSC with a calibration which the
+ * internal thread measures against CLOCK_MONOTONIC every second.
+ * A thread refreshes its time with coarse_clock_update() at the start of a poll pass and of a
+ * send call. The internal thread advances an epoch on each loop, so the cached time of a thread
+ * which doesn't poll is refreshed on its next read after that.
+ * The paths which need the exact time, e.g. the timeouts of the blocking calls, keep gettime().
+ */
+struct coarse_clock_calib_t {
+    uint64_t tsc;
+    uint64_t nsec;
+    uint64_t mult; // Nanoseconds per TSC tick in 32.32 fixed point
+};
+
+struct coarse_clock_t {
+    uint64_t nsec;
+    uint32_t epoch;
+};
+
+extern seqlock_data<coarse_clock_calib_t> g_coarse_clock_calib;
+extern std::atomic<uint32_t> g_coarse_clock_epoch;
+extern thread_local coarse_clock_t g_coarse_clock;
+
+void coarse_clock_init();
+// Called by the internal thread on each loop, recalibrates once a second
+void coarse_clock_tick();
+
+// Converts a TSC read by the caller, the time of a thread never goes backwards
+static inline uint64_t coarse_clock_update(tscval_t tsc)
+{
+    coarse_clock_calib_t calib = g_coarse_clock_calib.load();
+    coarse_clock_t &clock = g_coarse_clock;
+    uint64_t nsec = calib.nsec;
+    if (likely(tsc > calib.tsc)) {
+        unsigned __int128 delta = tsc - calib.tsc;
+        nsec += static_cast<uint64_t>((delta * calib.mult) >> 32U);
+    }
+    clock.epoch = g_coarse_clock_epoch.load(std::memory_order_relaxed);
+    clock.nsec = std::max(clock.nsec, nsec);
+    return clock.nsec;
+}
+
+static inline uint64_t coarse_clock_update()
+{
+    tscval_t tsc;
+
+    gettimeoftsc(&tsc);
+    return coarse_clock_update(tsc);
+}
+
+static inline uint64_t coarse_clock_ns()
+{
+    if (unlikely(g_coarse_clock.epoch != g_coarse_clock_epoch.load(std::memory_order_relaxed))) {
+        return coarse_clock_update();
+    }
+    return g_coarse_clock.nsec;
+}
+
+static inline uint64_t coarse_clock_us()
+{
+    return coarse_clock_ns() / NSEC_PER_USEC;
+}
+
+static inline uint64_t coarse_clock_ms()
+{
+    return coarse_clock_ns() / NSEC_PER_MSEC;
+}
+
+#endif /* COARSE_CLOCK_H */
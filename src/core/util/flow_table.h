@@ -0,0 +1,238 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef FLOW_TABLE_H
+#define FLOW_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include "utils/asm.h"
+#include "utils/types.h"
+
+/**
+ * Open addressing hash table for the RX steering lookups.
+ *
+ * Keys and values are stored inline in a flat array of entries, so a lookup usually touches
+ * a single cache line instead of walking the node based buckets of std::unordered_map.
+ * Collisions are resolved with linear probing, a 32-bit tag taken from the hash is compared
+ * before the key. Erased entries become tombstones which are purged on the next rehash.
+ *
+ * The interface is the subset of std::unordered_map used by the steering code. Iterators
+ * and references are invalidated by operator[] and by erase() of the last element.
+ * Not thread safe, the owner serializes the access.
+ */
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>> class flow_table {
+public:
+    struct entry {
+        uint32_t tag;
+        KEY first;
+        VALUE second;
+    };
+
+    class iterator {
+    public:
+        iterator(entry *p_entry, entry *p_end)
+            : m_p_entry(p_entry)
+            , m_p_end(p_end)
+        {
+        }
+
+        entry &operator*() const { return *m_p_entry; }
+        entry *operator->() const { return m_p_entry; }
+        bool operator==(const iterator &other) const { return m_p_entry == other.m_p_entry; }
+        bool operator!=(const iterator &other) const { return m_p_entry != other.m_p_entry; }
+
+        iterator &operator++()
+        {
+            ++m_p_entry;
+            skip_free();
+            return *this;
+        }
+
+    private:
+        void skip_free()
+        {
+            while (m_p_entry != m_p_end && m_p_entry->tag < TAG_MIN) {
+                ++m_p_entry;
+            }
+        }
+
+        entry *m_p_entry;
+        entry *m_p_end;
+
+        friend class flow_table;
+    };
+
+    flow_table() = default;
+    ~flow_table() { delete[] m_entries; }
+
+    flow_table(const flow_table &) = delete;
+    flow_table &operator=(const flow_table &) = delete;
+
+    iterator begin()
+    {
+        iterator itr(m_entries, m_entries + m_capacity);
+        itr.skip_free();
+        return itr;
+    }
+    iterator end() { return iterator(m_entries + m_capacity, m_entries + m_capacity); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /* Bring the home entry of the key into the cache and return the hash for find(). */
+    size_t prefetch(const KEY &key) const
+    {
+        size_t hash = hash_key(key);
+        if (likely(m_capacity)) {
+            ::prefetch(static_cast<void *>(m_entries + (hash & m_mask)));
+        }
+        return hash;
+    }
+
+    iterator find(const KEY &key) { return find(key, hash_key(key)); }
+
+    iterator find(const KEY &key, size_t hash)
+    {
+        if (unlikely(!m_capacity)) {
+            return end();
+        }
+
+        uint32_t tag = make_tag(hash);
+        size_t idx = hash & m_mask;
+        while (m_entries[idx].tag != TAG_EMPTY) {
+            if (m_entries[idx].tag == tag && m_entries[idx].first == key) {
+                return iterator(m_entries + idx, m_entries + m_capacity);
+            }
+            idx = (idx + 1) & m_mask;
+        }
+        return end();
+    }
+
+    VALUE &operator[](const KEY &key)
+    {
+        if (unlikely((m_size + m_deleted + 1) * 4 > m_capacity * 3)) {
+            grow();
+        }
+
+        size_t hash = hash_key(key);
+        uint32_t tag = make_tag(hash);
+        size_t idx = hash & m_mask;
+        entry *p_free = nullptr;
+
+        while (m_entries[idx].tag != TAG_EMPTY) {
+            if (m_entries[idx].tag == tag && m_entries[idx].first == key) {
+                return m_entries[idx].second;
+            }
+            if (m_entries[idx].tag == TAG_DELETED && !p_free) {
+                p_free = m_entries + idx;
+            }
+            idx = (idx + 1) & m_mask;
+        }
+
+        if (p_free) {
+            --m_deleted;
+        } else {
+            p_free = m_entries + idx;
+        }
+        p_free->tag = tag;
+        p_free->first = key;
+        p_free->second = VALUE();
+        ++m_size;
+        return p_free->second;
+    }
+
+    iterator erase(iterator itr)
+    {
+        entry *p_entry = itr.m_p_entry;
+        size_t next = (static_cast<size_t>(p_entry - m_entries) + 1) & m_mask;
+
+        p_entry->second = VALUE();
+        --m_size;
+        if (m_size == 0) {
+            clear();
+            return end();
+        }
+        if (m_entries[next].tag == TAG_EMPTY) {
+            // End of a probe chain, no need to keep the tombstone
+            p_entry->tag = TAG_EMPTY;
+        } else {
+            p_entry->tag = TAG_DELETED;
+            ++m_deleted;
+        }
+        ++itr;
+        return itr;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_entries[i].tag = TAG_EMPTY;
+            m_entries[i].second = VALUE();
+        }
+        m_size = m_deleted = 0;
+    }
+
+private:
+    enum : uint32_t { TAG_EMPTY = 0U, TAG_DELETED = 1U, TAG_MIN = 2U };
+    static constexpr size_t MIN_CAPACITY = 16U;
+
+    static size_t hash_key(const KEY &key)
+    {
+        // The key hashes are close to identity, mix them before masking the low bits
+        uint64_t hash = static_cast<uint64_t>(HASH()(key));
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return static_cast<size_t>(hash);
+    }
+
+    static uint32_t make_tag(size_t hash)
+    {
+        uint32_t tag = static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+        return tag < TAG_MIN ? tag + TAG_MIN : tag;
+    }
+
+    void grow()
+    {
+        // Double only when live entries need it, otherwise just purge the tombstones
+        size_t capacity = (m_size + 1) * 2 > m_capacity ? m_capacity * 2 : m_capacity;
+        rehash(capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity);
+    }
+
+    void rehash(size_t capacity)
+    {
+        entry *old_entries = m_entries;
+        size_t old_capacity = m_capacity;
+
+        m_entries = new entry[capacity]();
+        m_capacity = capacity;
+        m_mask = capacity - 1;
+        m_deleted = 0;
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_entries[i].tag >= TAG_MIN) {
+                size_t idx = hash_key(old_entries[i].first) & m_mask;
+                while (m_entries[idx].tag != TAG_EMPTY) {
+                    idx = (idx + 1) & m_mask;
+                }
+                m_entries[idx] = old_entries[i];
+            }
+        }
+        delete[] old_entries;
+    }
+
+    entry *m_entries = nullptr;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+    size_t m_deleted = 0;
+};
+
+#endif /* FLOW_TABLE_H */
@@ -8,25 +8,41 @@
 
 #include <sys/types.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/file.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <mutex>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 #include "vlogger/vlogger.h"
 #include "util/sys_vars.h"
 
 #define MODULE_NAME "hugepage_mgr"
 
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
 hugepage_mgr g_hugepage_mgr;
 
 hugepage_mgr::hugepage_mgr()
 {
     memset(&m_stats, 0, sizeof(m_stats));
+    memset(&m_fork, 0, sizeof(m_fork));
     m_default_hugepage = read_meminfo("Hugepagesize:");
     update();
 
@@ -95,21 +111,90 @@ bool hugepage_mgr::check_resident_pages(void *ptr, size_t size, size_t page_size
     return resident_nr == pages_nr;
 }
 
-void *hugepage_mgr::alloc_hugepages_helper(size_t &size, size_t hugepage)
+uint32_t hugepage_mgr::get_prefault_threads(size_t size, size_t page_size)
+{
+    cpu_set_t cpuset;
+    size_t threads = safe_mce_sys().hugepage_prefault_threads;
+
+    if (threads > 1U && sched_getaffinity(0, sizeof(cpuset), &cpuset) == 0) {
+        // More threads than the CPUs available to the process only add contention
+        threads = std::min<size_t>(threads, CPU_COUNT(&cpuset));
+    }
+    threads = std::min<size_t>(threads, size / page_size / HUGEPAGE_PREFAULT_MIN_PAGES);
+    return static_cast<uint32_t>(threads);
+}
+
+bool hugepage_mgr::prefault_pages(void *ptr, size_t size, size_t page_size, uint32_t threads)
+{
+    /*
+     * MADV_POPULATE_WRITE reports a failure instead of the SIGBUS of a touch beyond the
+     * cgroup limit. The threads inherit the memory policy of this thread, so the pages land
+     * on the same NUMA node as with MAP_POPULATE.
+     */
+    const size_t pages_nr = size / page_size;
+    std::atomic<bool> unsupported(false);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+
+    auto populate = [&](size_t first, size_t last) {
+        uint8_t *from = reinterpret_cast<uint8_t *>(ptr) + first * page_size;
+        if (madvise(from, (last - first) * page_size, MADV_POPULATE_WRITE) != 0) {
+            if (errno == EINVAL) {
+                unsupported = true;
+            }
+            __log_info_dbg("madvise(MADV_POPULATE_WRITE) failed (errno=%d)", errno);
+        }
+    };
+
+    size_t tail = pages_nr;
+    try {
+        for (uint32_t i = 1; i < threads; ++i) {
+            workers.emplace_back(populate, pages_nr * i / threads, pages_nr * (i + 1) / threads);
+        }
+    } catch (const std::system_error &) {
+        // The calling thread populates the ranges which got no thread
+        tail = pages_nr * (workers.size() + 1U) / threads;
+    }
+    populate(0, pages_nr / threads);
+    if (tail < pages_nr) {
+        populate(tail, pages_nr);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    __log_info_dbg(
+        "Prefaulted %zu hugepages %zu kB with %zu threads in %lld usec", pages_nr,
+        page_size / 1024U, workers.size() + 1U,
+        (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    return !unsupported;
+}
+
+void *hugepage_mgr::alloc_hugepages_helper(size_t &size, size_t hugepage, bool shared)
 {
     size_t hugepage_mask = hugepage - 1;
     size_t actual_size = (size + hugepage_mask) & ~hugepage_mask;
+    uint32_t threads = get_prefault_threads(actual_size, hugepage);
     void *ptr = nullptr;
-    int map_flags = 0;
+    int map_flags = shared ? MAP_SHARED : MAP_PRIVATE;
 
     __log_info_dbg("Allocating %zu bytes with hugepages %zu kB", actual_size, hugepage / 1024U);
 
     if (hugepage != m_default_hugepage) {
-        map_flags = (int)log2(hugepage) << MAP_HUGE_SHIFT;
+        map_flags |= (int)log2(hugepage) << MAP_HUGE_SHIFT;
     }
 
     ptr = mmap(nullptr, actual_size, PROT_READ | PROT_WRITE,
-               MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | MAP_HUGETLB | map_flags, -1, 0);
+               MAP_ANONYMOUS | (threads > 1U ? 0 : MAP_POPULATE) | MAP_HUGETLB | map_flags, -1,
+               0);
+    if (ptr != MAP_FAILED && threads > 1U && !prefault_pages(ptr, actual_size, hugepage, threads)) {
+        // The kernel doesn't support MADV_POPULATE_WRITE, let it populate the mapping
+        munmap(ptr, actual_size);
+        ptr = mmap(nullptr, actual_size, PROT_READ | PROT_WRITE,
+                   MAP_ANONYMOUS | MAP_POPULATE | MAP_HUGETLB | map_flags, -1, 0);
+    }
     if (ptr == MAP_FAILED) {
         ptr = nullptr;
         __log_info_dbg("mmap failed (errno=%d)", errno);
@@ -136,7 +221,7 @@ void *hugepage_mgr::alloc_hugepages_helper(size_t &size, size_t hugepage)
     return ptr;
 }
 
-void *hugepage_mgr::alloc_hugepages(size_t &size, size_t &hugepage_size)
+void *hugepage_mgr::alloc_hugepages(size_t &size, size_t &hugepage_size, bool shared /*=false*/)
 {
     std::lock_guard<decltype(m_lock)> lock(m_lock);
 
@@ -156,13 +241,13 @@ void *hugepage_mgr::alloc_hugepages(size_t &size, size_t &hugepage_size)
     for (auto iter = hugepages.begin(); !ptr && iter != hugepages.end(); ++iter) {
         hugepage = *iter;
         if (get_total_hugepages(hugepage) && is_hugepage_optimal(hugepage, size)) {
-            ptr = alloc_hugepages_helper(actual_size, hugepage);
+            ptr = alloc_hugepages_helper(actual_size, hugepage, shared);
         }
     }
     for (auto iter = hugepages.begin(); !ptr && iter != hugepages.end(); ++iter) {
         hugepage = *iter;
         if (get_total_hugepages(hugepage) && is_hugepage_acceptable(hugepage, size)) {
-            ptr = alloc_hugepages_helper(actual_size, hugepage);
+            ptr = alloc_hugepages_helper(actual_size, hugepage, shared);
         }
     }
     if (ptr) {
@@ -184,6 +269,77 @@ void *hugepage_mgr::alloc_hugepages(size_t &size, size_t &hugepage_size)
     return ptr;
 }
 
+void *hugepage_mgr::alloc_hugepages_persistent(const char *path, size_t &size,
+                                               size_t &hugepage_size, int &fd)
+{
+    std::lock_guard<decltype(m_lock)> lock(m_lock);
+
+    struct statfs fs;
+    struct stat st;
+    void *ptr = nullptr;
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        __log_info_warn("Cannot open persistent hugepages file %s (errno=%d)", path, errno);
+        return nullptr;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        __log_info_warn("Persistent hugepages file %s is used by another process", path);
+        goto error;
+    }
+    if (fstatfs(fd, &fs) != 0 || fs.f_type != HUGETLBFS_MAGIC || fstat(fd, &st) != 0) {
+        __log_info_warn("Persistent hugepages file %s is not on a hugetlbfs mount", path);
+        goto error;
+    }
+
+    {
+        const size_t hugepage = static_cast<size_t>(fs.f_bsize);
+        const size_t actual_size = (size + hugepage - 1) & ~(hugepage - 1);
+        // The pages of a previous run are already allocated and zeroed
+        const bool reused = static_cast<size_t>(st.st_size) >= actual_size;
+        uint32_t threads = reused ? 0U : get_prefault_threads(actual_size, hugepage);
+
+        if (!reused && ftruncate(fd, actual_size) != 0) {
+            __log_info_dbg("ftruncate failed (errno=%d)", errno);
+            goto error;
+        }
+        ptr = mmap(nullptr, actual_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | (threads > 1U ? 0 : MAP_POPULATE), fd, 0);
+        if (ptr != MAP_FAILED && threads > 1U &&
+            !prefault_pages(ptr, actual_size, hugepage, threads)) {
+            munmap(ptr, actual_size);
+            ptr = mmap(nullptr, actual_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       fd, 0);
+        }
+        if (ptr == MAP_FAILED) {
+            ptr = nullptr;
+            __log_info_dbg("mmap failed (errno=%d)", errno);
+            goto error;
+        }
+        if (!reused && !safe_mce_sys().quick_start &&
+            !check_resident_pages(ptr, actual_size, hugepage)) {
+            munmap(ptr, actual_size);
+            ptr = nullptr;
+            goto error;
+        }
+
+        __log_info_dbg("%s %zu kB of hugepages %zu kB from %s", reused ? "Reused" : "Allocated",
+                       actual_size / 1024U, hugepage / 1024U, path);
+        size = actual_size;
+        hugepage_size = hugepage;
+        ++m_stats.allocations;
+        m_stats.total_requested += actual_size;
+        m_stats.total_allocated += actual_size;
+    }
+    return ptr;
+
+error:
+    close(fd);
+    fd = -1;
+    ++m_stats.fails;
+    return nullptr;
+}
+
 void hugepage_mgr::dealloc_hugepages(void *ptr, size_t size)
 {
     int rc = munmap(ptr, size);
@@ -192,6 +348,80 @@ void hugepage_mgr::dealloc_hugepages(void *ptr, size_t size)
     }
 }
 
+bool hugepage_mgr::prepare_fork_slices(uint32_t slices, size_t slice_size)
+{
+    if (m_fork.base) {
+        // Prepared by the parent before the fork()
+        return true;
+    }
+
+    // The slices start at a hugepage boundary at least for the default hugepage size
+    const size_t align = std::max<size_t>(m_default_hugepage, sysconf(_SC_PAGESIZE));
+    const size_t owners_size = slices * sizeof(std::atomic<pid_t>);
+    size_t aligned_slice = (slice_size + align - 1) & ~(align - 1);
+    size_t size = aligned_slice * slices;
+    size_t hugepage = 0;
+
+    void *owners = mmap(nullptr, owners_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                        -1, 0);
+    if (owners == MAP_FAILED) {
+        __log_info_dbg("mmap failed (errno=%d)", errno);
+        return false;
+    }
+    void *ptr = alloc_hugepages(size, hugepage, true);
+    if (!ptr) {
+        __log_info_warn("Cannot allocate %u fork slices of %zu kB in hugepages", slices,
+                        aligned_slice / 1024U);
+        munmap(owners, owners_size);
+        return false;
+    }
+
+    m_fork.base = reinterpret_cast<uint8_t *>(ptr);
+    m_fork.slice_size = aligned_slice;
+    m_fork.hugepage = hugepage;
+    m_fork.slices = slices;
+    m_fork.creator = getpid();
+    m_fork.owners = new (owners) std::atomic<pid_t>[slices];
+    for (uint32_t i = 0; i < slices; ++i) {
+        m_fork.owners[i].store(0, std::memory_order_relaxed);
+    }
+    __log_info_dbg("Prepared %u fork slices of %zu kB with hugepages %zu kB", slices,
+                   aligned_slice / 1024U, hugepage / 1024U);
+    return true;
+}
+
+void *hugepage_mgr::claim_fork_slice(size_t size, size_t &hugepage_size)
+{
+    const pid_t pid = getpid();
+
+    if (!m_fork.base || pid == m_fork.creator || size > m_fork.slice_size) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < m_fork.slices; ++i) {
+        pid_t owner = m_fork.owners[i].load(std::memory_order_acquire);
+        bool is_free = !owner || (kill(owner, 0) != 0 && errno == ESRCH);
+
+        if (is_free && m_fork.owners[i].compare_exchange_strong(owner, pid)) {
+            __log_info_dbg("Claimed fork slice %u of %zu kB", i, m_fork.slice_size / 1024U);
+            hugepage_size = m_fork.hugepage;
+            return m_fork.base + i * m_fork.slice_size;
+        }
+    }
+    __log_info_dbg("All %u fork slices are taken", m_fork.slices);
+    return nullptr;
+}
+
+void hugepage_mgr::release_fork_slice(void *ptr)
+{
+    size_t offset = reinterpret_cast<uint8_t *>(ptr) - m_fork.base;
+    pid_t pid = getpid();
+
+    // The mapping stays, another child of the same parent takes the slice later
+    if (m_fork.base && offset < m_fork.slice_size * m_fork.slices) {
+        m_fork.owners[offset / m_fork.slice_size].compare_exchange_strong(pid, 0);
+    }
+}
+
 void hugepage_mgr::print_report(vlog_levels_t log_level, bool print_only_critical /*=false*/,
                                 bool short_report /*=false*/)
 {
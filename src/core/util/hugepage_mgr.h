@@ -9,7 +9,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -40,9 +42,22 @@ public:
     size_t get_default_hugepage() { return m_default_hugepage; }
     bool is_hugepage_supported(size_t hugepage);
 
-    void *alloc_hugepages(size_t &size, size_t &hugepage_size);
+    /* shared keeps the pages shared with the forked children instead of copy on write */
+    void *alloc_hugepages(size_t &size, size_t &hugepage_size, bool shared = false);
+    /* Maps a hugetlbfs file, the pages of a previous run are reused. fd keeps the file lock. */
+    void *alloc_hugepages_persistent(const char *path, size_t &size, size_t &hugepage_size,
+                                     int &fd);
     void dealloc_hugepages(void *ptr, size_t size);
 
+    /*
+     * The fork slices: the parent maps and faults in a shared region of slices of slice_size,
+     * a forked child takes a free slice for its buffers instead of allocating new hugepages.
+     * A slice of an exited child is free again.
+     */
+    bool prepare_fork_slices(uint32_t slices, size_t slice_size);
+    void *claim_fork_slice(size_t size, size_t &hugepage_size);
+    void release_fork_slice(void *ptr);
+
     void print_report(vlog_levels_t log_level, bool print_only_critical = false,
                       bool short_report = false);
 
@@ -53,6 +68,8 @@ private:
         HUGEPAGE_UNUSED_OPTIMAL = (2U * 1024U * 1024U),
         HUGEPAGE_UNUSED_ACCEPTABLE = (256U * 1024U * 1024U),
         HUGEPAGE_UNUSED_WARNING_THRESHOLD = (100U * 1024U * 1024U),
+        // Hugepages faulted by a prefault thread at least
+        HUGEPAGE_PREFAULT_MIN_PAGES = 16U,
     };
 
     void read_sysfs();
@@ -62,7 +79,9 @@ private:
     bool is_hugepage_optimal(size_t hugepage, size_t size);
     bool is_hugepage_acceptable(size_t hugepage, size_t size);
     bool check_resident_pages(void *ptr, size_t size, size_t page_size);
-    void *alloc_hugepages_helper(size_t &size, size_t hugepage);
+    uint32_t get_prefault_threads(size_t size, size_t page_size);
+    bool prefault_pages(void *ptr, size_t size, size_t page_size, uint32_t threads);
+    void *alloc_hugepages_helper(size_t &size, size_t hugepage, bool shared);
 
     // Returns unused bytes in the tail hugepage because of alignment.
     size_t hugepage_unused_space(size_t hugepage, size_t size)
@@ -108,6 +127,16 @@ private:
         size_t total_requested;
         size_t total_unused;
     } m_stats;
+
+    struct {
+        uint8_t *base;
+        size_t slice_size;
+        size_t hugepage;
+        uint32_t slices;
+        pid_t creator;
+        // In a shared mapping, the pid of the child which took the slice or 0
+        std::atomic<pid_t> *owners;
+    } m_fork;
 };
 
 extern hugepage_mgr g_hugepage_mgr;
@@ -10,3 +10,16 @@
 #if defined(DEFINED_PROF)
 atomic_t ibprof_handle::m_current_id = atomic_t {1};
 #endif /* DEFINED_PROF */
+
+#if defined(DEFINED_USDT)
+extern "C" {
+XLIO_USDT_DEFINE(cq_rx_poll);
+XLIO_USDT_DEFINE(rfs_dispatch);
+XLIO_USDT_DEFINE(tcp_rx);
+XLIO_USDT_DEFINE(tcp_output);
+XLIO_USDT_DEFINE(send_to_wire);
+XLIO_USDT_DEFINE(ring_doorbell);
+XLIO_USDT_DEFINE(bpool_expand);
+XLIO_USDT_DEFINE(neigh_state);
+}
+#endif /* DEFINED_USDT */
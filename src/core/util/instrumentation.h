@@ -8,9 +8,12 @@
 #define V_INSTRUMENTATION_H
 
 #include <stdint.h>
+#ifdef __cplusplus
 #include "utils/atomic.h"
+#include "core/util/trace_ring.h"
+#endif
 
-#if defined(DEFINED_PROF)
+#if defined(DEFINED_PROF) && defined(__cplusplus)
 #include <ibprof_api.h>
 
 class ibprof_handle {
@@ -38,4 +41,48 @@ private:
 #define PROFILE_BLOCK(name)
 #endif /* DEFINED_PROF */
 
+/*
+ * USDT probes of the xlio provider, e.g.
+ *   bpftrace -e 'usdt:/usr/lib64/libxlio.so:xlio:tcp_rx { @bytes = hist(arg1); }'
+ * A probe is skipped by a branch on its semaphore, which a tracer raises when it attaches.
+ * The arguments are evaluated only while the probe is traced.
+ */
+#if defined(DEFINED_USDT)
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define XLIO_USDT_SEMAPHORE(name) xlio_##name##_semaphore
+#define XLIO_USDT_DECLARE(name)   extern volatile unsigned short XLIO_USDT_SEMAPHORE(name)
+#define XLIO_USDT_DEFINE(name)                                                                     \
+    volatile unsigned short XLIO_USDT_SEMAPHORE(name) __attribute__((section(".probes"))) = 0
+#define XLIO_USDT_ENABLED(name) __builtin_expect(XLIO_USDT_SEMAPHORE(name) != 0, 0)
+#define XLIO_TRACE(name, ...)                                                                      \
+    do {                                                                                           \
+        if (XLIO_USDT_ENABLED(name)) {                                                             \
+            STAP_PROBEV(xlio, name, __VA_ARGS__);                                                  \
+        }                                                                                          \
+    } while (0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+// Arguments of each probe are listed in README.md
+XLIO_USDT_DECLARE(cq_rx_poll);
+XLIO_USDT_DECLARE(rfs_dispatch);
+XLIO_USDT_DECLARE(tcp_rx);
+XLIO_USDT_DECLARE(tcp_output);
+XLIO_USDT_DECLARE(send_to_wire);
+XLIO_USDT_DECLARE(ring_doorbell);
+XLIO_USDT_DECLARE(bpool_expand);
+XLIO_USDT_DECLARE(neigh_state);
+#ifdef __cplusplus
+}
+#endif
+#else
+#define XLIO_USDT_ENABLED(name) 0
+#define XLIO_TRACE(name, ...)                                                                      \
+    do {                                                                                           \
+    } while (0)
+#endif /* DEFINED_USDT */
+
 #endif // INSTRUMENTATION
@@ -234,6 +234,9 @@ int __xlio_match_user_defined_id(struct instance *instance, const char *app_id);
 
 transport_t __xlio_match_by_program(in_protocol_t my_protocol, const char *app_id);
 
+/* Compiles the rules of __instance_list for the lookups, called after they change */
+void __xlio_compile_rules(void);
+
 /* log.c */
 #if 0
 static inline
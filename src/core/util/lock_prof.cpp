@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vlogger/vlogger.h"
+#include "xlio_stats.h"
+#include "lock_prof.h"
+
+#define MODULE_NAME "lock_prof"
+
+#define LOCK_PROF_OTHER_NAME "(other)"
+
+struct lock_prof_thread_t {
+    lock_prof_thread_t *next;
+    lock_stats_t stats[NUM_OF_SUPPORTED_LOCKS];
+};
+
+bool g_lock_prof_enabled = false;
+static thread_local lock_prof_thread_t *t_p_lock_prof = nullptr;
+
+// The counters of all the threads, the ones of the exited threads are kept for the totals
+static lock_prof_thread_t *s_p_lock_prof_threads = nullptr;
+
+// A plain mutex since a lock_wrapper lock would profile itself, the count publishes the names
+static pthread_mutex_t s_names_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char s_names[NUM_OF_SUPPORTED_LOCKS][LOCK_NAME_LEN];
+static int s_num_names = 0;
+
+void lock_prof_init(bool enable)
+{
+    g_lock_prof_enabled = enable;
+    if (enable) {
+        vlog_printf(VLOG_DEBUG, MODULE_NAME ": profiling up to %d lock names\n",
+                    NUM_OF_SUPPORTED_LOCKS);
+    }
+}
+
+int lock_prof_register(const char *name)
+{
+    int id;
+
+    if (!name) {
+        name = "unnamed";
+    }
+
+    pthread_mutex_lock(&s_names_mutex);
+    for (id = 0; id < s_num_names; ++id) {
+        if (!strncmp(s_names[id], name, LOCK_NAME_LEN - 1)) {
+            break;
+        }
+    }
+    if (id == s_num_names) {
+        if (id == NUM_OF_SUPPORTED_LOCKS - 1) {
+            name = LOCK_PROF_OTHER_NAME;
+        }
+        if (id < NUM_OF_SUPPORTED_LOCKS) {
+            strncpy(s_names[id], name, LOCK_NAME_LEN - 1);
+            __atomic_store_n(&s_num_names, id + 1, __ATOMIC_RELEASE);
+        } else {
+            id = NUM_OF_SUPPORTED_LOCKS - 1;
+        }
+    }
+    pthread_mutex_unlock(&s_names_mutex);
+    return id;
+}
+
+static lock_stats_t *lock_prof_thread_stats(int id)
+{
+    lock_prof_thread_t *thread = t_p_lock_prof;
+
+    if (unlikely(!thread)) {
+        thread = static_cast<lock_prof_thread_t *>(calloc(1, sizeof(*thread)));
+        if (!thread) {
+            return nullptr;
+        }
+        thread->next = __atomic_load_n(&s_p_lock_prof_threads, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&s_p_lock_prof_threads, &thread->next, thread, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        t_p_lock_prof = thread;
+    }
+    return &thread->stats[id];
+}
+
+void lock_prof_acquired(int id, bool contended, uint64_t wait_tsc)
+{
+    lock_stats_t *stats = lock_prof_thread_stats(id);
+
+    if (unlikely(!stats)) {
+        return;
+    }
+    ++stats->n_acquired;
+    if (contended) {
+        ++stats->n_contended;
+        stats->n_wait_tsc += wait_tsc;
+        lat_hist_add(&stats->wait_hist, wait_tsc);
+    }
+}
+
+void lock_prof_trylock_failed(int id)
+{
+    lock_stats_t *stats = lock_prof_thread_stats(id);
+
+    if (likely(stats)) {
+        ++stats->n_trylock_failed;
+    }
+}
+
+void lock_prof_publish(lock_instance_block_t *p_blocks)
+{
+    // Only the stats publisher timer sums, the result is copied at once to the reader
+    static lock_stats_t s_sums[NUM_OF_SUPPORTED_LOCKS];
+    int num_names = __atomic_load_n(&s_num_names, __ATOMIC_ACQUIRE);
+
+    if (!g_lock_prof_enabled || !num_names) {
+        return;
+    }
+
+    memset(s_sums, 0, sizeof(s_sums[0]) * num_names);
+    for (lock_prof_thread_t *thread = __atomic_load_n(&s_p_lock_prof_threads, __ATOMIC_ACQUIRE);
+         thread; thread = thread->next) {
+        for (int i = 0; i < num_names; ++i) {
+            const lock_stats_t &stats = thread->stats[i];
+
+            s_sums[i].n_acquired += stats.n_acquired;
+            s_sums[i].n_contended += stats.n_contended;
+            s_sums[i].n_trylock_failed += stats.n_trylock_failed;
+            s_sums[i].n_wait_tsc += stats.n_wait_tsc;
+            for (uint32_t b = 0; b < LAT_HIST_BUCKETS; ++b) {
+                s_sums[i].wait_hist.buckets[b] += stats.wait_hist.buckets[b];
+            }
+        }
+    }
+
+    for (int i = 0; i < num_names; ++i) {
+        if (!p_blocks[i].b_enabled) {
+            memcpy(p_blocks[i].name, s_names[i], sizeof(p_blocks[i].name));
+            p_blocks[i].b_enabled = true;
+        }
+        p_blocks[i].lock_stats = s_sums[i];
+    }
+}
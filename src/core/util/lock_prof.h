@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef LOCK_PROF_H
+#define LOCK_PROF_H
+
+#include <stdint.h>
+
+#include "utils/rdtsc.h"
+#include "utils/types.h"
+
+struct lock_instance_block_t;
+
+/*
+ * Contention profiling of the lock_wrapper locks, enabled by monitor.stats.lock_profiling.
+ * A lock gets the index of its name on its first profiled acquisition, each thread counts in its
+ * own array indexed by the names and the stats publisher sums the threads into the stats file.
+ * The locks aren't profiled before lock_prof_init(), the counters of the exited threads are kept.
+ *
+ * The hooks used by lock_wrapper.h are weak, so the header-only users of the locks which don't
+ * link lock_prof.cpp, such as the unit tests, resolve them to null and never profile.
+ */
+#define LOCK_PROF_ID_UNSET (-1)
+
+extern bool g_lock_prof_enabled __attribute__((weak));
+
+void lock_prof_init(bool enable);
+// Returns the index of the name, the names beyond the table share its last entry
+int lock_prof_register(const char *name) __attribute__((weak));
+void lock_prof_acquired(int id, bool contended, uint64_t wait_tsc) __attribute__((weak));
+void lock_prof_trylock_failed(int id) __attribute__((weak));
+// Sums the counters of all the threads into the blocks, called by the stats publisher only
+void lock_prof_publish(lock_instance_block_t *p_blocks);
+
+static inline bool lock_prof_enabled()
+{
+    return &g_lock_prof_enabled && g_lock_prof_enabled;
+}
+
+// The id is stored by the lock owner only, a failed trylock doesn't cache it
+static inline int lock_prof_id(const char *name, int &id, bool owner)
+{
+    int ret = __atomic_load_n(&id, __ATOMIC_RELAXED);
+
+    if (unlikely(ret == LOCK_PROF_ID_UNSET)) {
+        ret = lock_prof_register(name);
+        if (owner) {
+            __atomic_store_n(&id, ret, __ATOMIC_RELAXED);
+        }
+    }
+    return ret;
+}
+
+// Blocking lock which tries first, the wait of a busy lock is measured with the TSC
+template <typename T>
+inline int lock_prof_lock(int (*try_fn)(T *), int (*lock_fn)(T *), T *p_lock, const char *name,
+                          int &id)
+{
+    tscval_t start, end;
+
+    if (likely(try_fn(p_lock) == 0)) {
+        lock_prof_acquired(lock_prof_id(name, id, true), false, 0U);
+        return 0;
+    }
+
+    gettimeoftsc(&start);
+    int ret = lock_fn(p_lock);
+    gettimeoftsc(&end);
+    if (likely(ret == 0)) {
+        lock_prof_acquired(lock_prof_id(name, id, true), true, end - start);
+    }
+    return ret;
+}
+
+static inline void lock_prof_trylock(int ret, const char *name, int &id)
+{
+    if (ret == 0) {
+        lock_prof_acquired(lock_prof_id(name, id, true), false, 0U);
+    } else {
+        lock_prof_trylock_failed(lock_prof_id(name, id, false));
+    }
+}
+
+#endif /* LOCK_PROF_H */
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef LPM_TRIE_H
+#define LPM_TRIE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+/* Longest key, an IPv6 address */
+#define LPM_TRIE_MAX_BITS 128U
+
+/**
+ * Longest prefix match over keys given as bytes in the network order.
+ *
+ * A binary trie with the nodes in a vector, a lookup walks as many nodes as the bits of the
+ * longest matching prefix. A prefix holds a sorted set of values, e.g. the positions of the
+ * routes with the same destination in a table, so the lowest one is the first inserted.
+ * Not thread safe.
+ */
+template <typename V> class lpm_trie {
+public:
+    lpm_trie() { m_nodes.resize(1U); }
+
+    // prefix_len is up to LPM_TRIE_MAX_BITS
+    void insert(const uint8_t *key, unsigned prefix_len, V val)
+    {
+        uint32_t idx = 0U;
+
+        for (unsigned bit = 0U; bit < prefix_len; ++bit) {
+            uint32_t &child = m_nodes[idx].child[get_bit(key, bit)];
+            if (!child) {
+                uint32_t new_idx = alloc_node();
+                // The vector may grow, the reference isn't valid anymore
+                m_nodes[idx].child[get_bit(key, bit)] = new_idx;
+                idx = new_idx;
+            } else {
+                idx = child;
+            }
+        }
+
+        std::vector<V> &vals = m_nodes[idx].vals;
+        auto iter = std::lower_bound(vals.begin(), vals.end(), val);
+        if (iter == vals.end() || *iter != val) {
+            vals.insert(iter, val);
+            ++m_size;
+        }
+    }
+
+    bool remove(const uint8_t *key, unsigned prefix_len, V val)
+    {
+        uint32_t path[LPM_TRIE_MAX_BITS + 1U];
+        uint32_t idx = 0U;
+
+        path[0] = 0U;
+        for (unsigned bit = 0U; bit < prefix_len; ++bit) {
+            idx = m_nodes[idx].child[get_bit(key, bit)];
+            if (!idx) {
+                return false;
+            }
+            path[bit + 1U] = idx;
+        }
+
+        std::vector<V> &vals = m_nodes[idx].vals;
+        auto iter = std::lower_bound(vals.begin(), vals.end(), val);
+        if (iter == vals.end() || *iter != val) {
+            return false;
+        }
+        vals.erase(iter);
+        --m_size;
+
+        // Release the nodes left without a value and a child
+        for (unsigned depth = prefix_len; depth > 0U; --depth) {
+            node &n = m_nodes[path[depth]];
+            if (!n.vals.empty() || n.child[0] || n.child[1]) {
+                break;
+            }
+            m_nodes[path[depth - 1U]].child[get_bit(key, depth - 1U)] = 0U;
+            m_free.push_back(path[depth]);
+        }
+        return true;
+    }
+
+    // Values of the longest prefix which matches the key, nullptr if there is none
+    const std::vector<V> *lookup(const uint8_t *key, unsigned key_bits) const
+    {
+        const std::vector<V> *best = m_nodes[0].vals.empty() ? nullptr : &m_nodes[0].vals;
+        uint32_t idx = 0U;
+
+        for (unsigned bit = 0U; bit < key_bits; ++bit) {
+            idx = m_nodes[idx].child[get_bit(key, bit)];
+            if (!idx) {
+                break;
+            }
+            if (!m_nodes[idx].vals.empty()) {
+                best = &m_nodes[idx].vals;
+            }
+        }
+        return best;
+    }
+
+    // Calls fn() with the values of every prefix which matches the key, the shortest one first
+    template <typename F> void for_each_match(const uint8_t *key, unsigned key_bits, F fn) const
+    {
+        uint32_t idx = 0U;
+
+        if (!m_nodes[0].vals.empty()) {
+            fn(m_nodes[0].vals);
+        }
+        for (unsigned bit = 0U; bit < key_bits; ++bit) {
+            idx = m_nodes[idx].child[get_bit(key, bit)];
+            if (!idx) {
+                break;
+            }
+            if (!m_nodes[idx].vals.empty()) {
+                fn(m_nodes[idx].vals);
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_nodes.clear();
+        m_nodes.resize(1U);
+        m_free.clear();
+        m_size = 0U;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+
+private:
+    struct node {
+        // Index 0 is the root, it is never a child
+        uint32_t child[2] = {0U, 0U};
+        std::vector<V> vals;
+    };
+
+    static unsigned get_bit(const uint8_t *key, unsigned bit)
+    {
+        return (key[bit >> 3U] >> (7U - (bit & 7U))) & 1U;
+    }
+
+    uint32_t alloc_node()
+    {
+        if (!m_free.empty()) {
+            uint32_t idx = m_free.back();
+            m_free.pop_back();
+            return idx;
+        }
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1U);
+    }
+
+    std::vector<node> m_nodes;
+    std::vector<uint32_t> m_free;
+    size_t m_size = 0U;
+};
+
+#endif /* LPM_TRIE_H */
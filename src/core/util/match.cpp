@@ -21,6 +21,10 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <linux/if_ether.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
 #include <vlogger/vlogger.h>
 
 /*
@@ -28,6 +32,7 @@
  */
 #include "libxlio.h"
 #include "core/util/sys_vars.h"
+#include "core/util/rule_matcher.h"
 
 // debugging macros
 #define MODULE_NAME "match:"
@@ -45,6 +50,24 @@
 /* --------------------------------------------------------------------- */
 extern char *program_invocation_name, *program_invocation_short_name;
 
+/*
+ * The rules of an instance compiled by __xlio_compile_rules(), the instances are kept in the
+ * order of __instance_list. The program name is matched once at the compilation.
+ */
+struct compiled_instance {
+    struct instance *p_instance;
+    bool program_match;
+    rule_matcher roles[ROLE_UDP_CONNECT + 1];
+    // match_by_all_rules_program() of the server and the client lists, by protocol
+    transport_t tcp_program[2];
+    transport_t udp_program[2];
+};
+
+typedef std::vector<compiled_instance> compiled_rules_t;
+
+// Replaced as a whole when the rules change, a lookup holds the table it has loaded
+static std::shared_ptr<const compiled_rules_t> g_compiled_rules;
+
 static void free_dbl_lst(struct dbl_lst *dbl_lst)
 {
     struct dbl_lst_node *node, *tmp;
@@ -90,6 +113,9 @@ void __xlio_free_resources(void)
 {
     struct dbl_lst_node *node, *tmp;
 
+    // The compiled rules reference the lists
+    std::atomic_store(&g_compiled_rules, std::shared_ptr<const compiled_rules_t>());
+
     /* free the instances */
     node = __instance_list.head;
     while (node) {
@@ -419,16 +445,78 @@ static transport_t get_family_by_first_matching_rule(transport_t my_transport,
     return TRANS_XLIO; // No matching rule or no rule at all. Don't continue to next application-id
 }
 
+static void to_rule_match_addr(const struct sockaddr *addr, socklen_t addrlen,
+                               rule_match_addr &match_addr)
+{
+    struct sockaddr_in sin;
+    int saved_errno = errno;
+
+    // sin_port and sin6_port are at the same offset
+    match_addr.port = addr ? ntohs(((const struct sockaddr_in *)addr)->sin_port) : 0U;
+    match_addr.addr_valid = !__xlio_sockaddr_to_xlio(addr, addrlen, &sin, nullptr);
+    match_addr.addr = match_addr.addr_valid ? sin.sin_addr.s_addr : 0U;
+    errno = saved_errno;
+}
+
+static transport_t get_family_by_compiled_rules(const compiled_rules_t &rules,
+                                                transport_t my_transport, role_t role,
+                                                const char *app_id,
+                                                const struct sockaddr *sin_first,
+                                                const socklen_t addrlen_first,
+                                                const struct sockaddr *sin_second,
+                                                const socklen_t addrlen_second)
+{
+    rule_match_addr first;
+    rule_match_addr second;
+
+    to_rule_match_addr(sin_first, addrlen_first, first);
+    if (sin_second) {
+        to_rule_match_addr(sin_second, addrlen_second, second);
+    }
+
+    for (const compiled_instance &instance : rules) {
+        if (!instance.program_match ||
+            !__xlio_match_user_defined_id(instance.p_instance, app_id)) {
+            continue;
+        }
+        match_logdbg("MATCHING program name: %s, application-id: %s",
+                     instance.p_instance->id.prog_name_expr,
+                     instance.p_instance->id.user_defined_id);
+
+        const struct use_family_rule *rule =
+            instance.roles[role].match(my_transport, first, sin_second ? &second : nullptr);
+        if (!rule) {
+            match_logdbg("No matching rule. Using (default)");
+            return TRANS_XLIO;
+        }
+#if (MAX_DEFINED_LOG_LEVEL >= DEFINED_VLOG_DEBUG)
+        if (g_vlogger_level >= VLOG_DEBUG) {
+            char rule_str[512];
+
+            get_rule_str(const_cast<struct use_family_rule *>(rule), rule_str, sizeof(rule_str));
+            match_logdbg("MATCH: POSITIVE MATCH %s", rule_str);
+        }
+#endif /* MAX_DEFINED_LOG_LEVEL */
+        return rule->target_transport;
+    }
+    return TRANS_XLIO;
+}
+
 static transport_t get_family_by_instance_first_matching_rule(
     transport_t my_transport, role_t role, const char *app_id, const struct sockaddr *sin_first,
     const socklen_t addrlen_first, const struct sockaddr *sin_second = nullptr,
     const socklen_t addrlen_second = 0)
 {
     transport_t target_family = TRANS_DEFAULT;
+    std::shared_ptr<const compiled_rules_t> compiled_rules = std::atomic_load(&g_compiled_rules);
 
     /* if we do not have any rules we use xlio */
     if (__xlio_config_empty()) {
         target_family = TRANS_XLIO;
+    } else if (compiled_rules) {
+        target_family =
+            get_family_by_compiled_rules(*compiled_rules, my_transport, role, app_id, sin_first,
+                                         addrlen_first, sin_second, addrlen_second);
     } else {
         struct dbl_lst_node *curr = __instance_list.head;
 
@@ -614,10 +702,30 @@ transport_t __xlio_match_by_program(in_protocol_t my_protocol, const char *app_i
     transport_t client_target_family = TRANS_DEFAULT;
     transport_t target_family = TRANS_DEFAULT;
     bool b_found_app_id_match = false;
+    std::shared_ptr<const compiled_rules_t> compiled_rules = std::atomic_load(&g_compiled_rules);
 
     if (__xlio_config_empty()) {
         match_logdbg("Configuration file is empty. Using (default)");
         target_family = TRANS_XLIO;
+    } else if (compiled_rules) {
+        for (const compiled_instance &instance : *compiled_rules) {
+            if (!instance.program_match ||
+                !__xlio_match_user_defined_id(instance.p_instance, app_id)) {
+                continue;
+            }
+            b_found_app_id_match = true;
+            if (my_protocol == PROTO_TCP) {
+                server_target_family = instance.tcp_program[0];
+                client_target_family = instance.tcp_program[1];
+            } else if (my_protocol == PROTO_UDP) {
+                server_target_family = instance.udp_program[0];
+                client_target_family = instance.udp_program[1];
+            }
+            if (server_target_family == client_target_family) {
+                target_family = server_target_family;
+                break;
+            }
+        }
     } else {
         struct dbl_lst_node *node = __instance_list.head;
 
@@ -659,6 +767,44 @@ transport_t __xlio_match_by_program(in_protocol_t my_protocol, const char *app_i
     return target_family;
 }
 
+void __xlio_compile_rules(void)
+{
+    std::shared_ptr<compiled_rules_t> compiled_rules;
+
+    try {
+        compiled_rules = std::make_shared<compiled_rules_t>();
+        for (struct dbl_lst_node *node = __instance_list.head; node; node = node->next) {
+            struct instance *p_instance = (struct instance *)node->data;
+            if (!p_instance) {
+                continue;
+            }
+
+            compiled_rules->emplace_back();
+            compiled_instance &instance = compiled_rules->back();
+            instance.p_instance = p_instance;
+            instance.program_match = __xlio_match_program_name(p_instance);
+            instance.roles[ROLE_TCP_SERVER].build(p_instance->tcp_srv_rules_lst);
+            instance.roles[ROLE_TCP_CLIENT].build(p_instance->tcp_clt_rules_lst);
+            instance.roles[ROLE_UDP_RECEIVER].build(p_instance->udp_rcv_rules_lst);
+            instance.roles[ROLE_UDP_SENDER].build(p_instance->udp_snd_rules_lst);
+            instance.roles[ROLE_UDP_CONNECT].build(p_instance->udp_con_rules_lst);
+            instance.tcp_program[0] =
+                match_by_all_rules_program(PROTO_TCP, p_instance->tcp_srv_rules_lst);
+            instance.tcp_program[1] =
+                match_by_all_rules_program(PROTO_TCP, p_instance->tcp_clt_rules_lst);
+            instance.udp_program[0] =
+                match_by_all_rules_program(PROTO_UDP, p_instance->udp_rcv_rules_lst);
+            instance.udp_program[1] =
+                match_by_all_rules_program(PROTO_UDP, p_instance->udp_snd_rules_lst);
+        }
+    } catch (const std::bad_alloc &) {
+        // The lookups walk the rule lists
+        match_logwarn("Failed to compile the offload rules, matching them one by one");
+        compiled_rules.reset();
+    }
+    std::atomic_store(&g_compiled_rules, std::shared_ptr<const compiled_rules_t>(compiled_rules));
+}
+
 /* is_ipv4_embedded_in_ipv6 -- return 1 if the given ipv6 address is ipv4   */
 static int is_ipv4_embedded_in_ipv6(const struct sockaddr_in6 *sin6)
 {
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef MEMCPY_NT_H
+#define MEMCPY_NT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Copy with non-temporal stores, for a large destination which isn't read soon, so the copy
+ * doesn't evict the working set of the caches. The stores are fenced before the return, the
+ * data is visible to another thread which observes a later store. Other architectures copy
+ * with memcpy().
+ */
+static inline void memcpy_nt(void *dst, const void *src, size_t len)
+{
+#if defined(__x86_64__)
+    uint8_t *d = static_cast<uint8_t *>(dst);
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+    size_t head = (16U - (reinterpret_cast<uintptr_t>(d) & 15U)) & 15U;
+
+    if (len < 256U) {
+        memcpy(dst, src, len);
+        return;
+    }
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    len -= head;
+    // SSE2 is the baseline of x86_64, the destination is aligned and the source may be not
+    for (; len >= 64U; len -= 64U, d += 64U, s += 64U) {
+        __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+        __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+        __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d), x0);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 16), x1);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 32), x2);
+        _mm_stream_si128(reinterpret_cast<__m128i *>(d + 48), x3);
+    }
+    memcpy(d, s, len);
+    _mm_sfence();
+#else
+    memcpy(dst, src, len);
+#endif
+}
+
+#endif /* MEMCPY_NT_H */
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+
+/*
+ * Unbounded intrusive queue for multiple producers and a single consumer, linked through the
+ * Next member of T. The producers push onto a lock-free stack and the consumer takes the whole
+ * stack at once, so there is no ABA problem. pop_all() returns the elements in the push order.
+ */
+template <typename T, T *T::*Next> class mpsc_queue {
+public:
+    mpsc_queue() = default;
+    mpsc_queue(const mpsc_queue &) = delete;
+    mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+    // Producer side. Returns true if the queue was empty, i.e. the consumer may need a wakeup.
+    inline bool push(T *obj)
+    {
+        T *head = m_head.load(std::memory_order_relaxed);
+
+        do {
+            obj->*Next = head;
+        } while (!m_head.compare_exchange_weak(head, obj, std::memory_order_release,
+                                               std::memory_order_relaxed));
+        return !head;
+    }
+
+    // Consumer side. Returns the list of all the elements linked through Next, or nullptr.
+    inline T *pop_all()
+    {
+        T *head = m_head.exchange(nullptr, std::memory_order_acquire);
+        T *list = nullptr;
+
+        while (head) {
+            T *next = head->*Next;
+            head->*Next = list;
+            list = head;
+            head = next;
+        }
+        return list;
+    }
+
+    // Either side, the result is a snapshot
+    inline bool empty() const { return !m_head.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<T *> m_head {nullptr};
+};
+
+#endif /* MPSC_QUEUE_H */
@@ -0,0 +1,151 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/udp.h>
+#include <linux/if_ether.h>
+#include <arpa/inet.h>
+#include <algorithm>
+
+#include "core/util/vtypes.h"
+#include "core/util/seqlock.h"
+#include "pkt_mirror.h"
+
+pkt_mirror_shm_t *g_p_pkt_mirror = nullptr;
+
+// Written by the publisher timer, read by the producers of any thread
+static seqlock_data<pkt_mirror_filter_t> s_filter;
+static thread_local uint32_t t_sample_count = 0U;
+
+void pkt_mirror_set_filter(pkt_mirror_shm_t *shm, const pkt_mirror_filter_t &filter)
+{
+    if (!filter.sample_rate) {
+        __atomic_store_n(&g_p_pkt_mirror, nullptr, __ATOMIC_RELEASE);
+        return;
+    }
+    s_filter.store(filter);
+    __atomic_store_n(&g_p_pkt_mirror, shm, __ATOMIC_RELEASE);
+}
+
+static bool addr_match(const uint8_t *filter_addr, const void *addr, size_t len)
+{
+    static const uint8_t any[16] = {};
+
+    return !memcmp(filter_addr, any, len) || !memcmp(filter_addr, addr, len);
+}
+
+size_t pkt_mirror_select(uint8_t dir, const void *hdr, size_t len)
+{
+    const uint8_t *frame = static_cast<const uint8_t *>(hdr);
+    pkt_mirror_filter_t filter = s_filter.load();
+    size_t l3_offset = ETH_HDR_LEN;
+    size_t l4_offset = 0U;
+    uint16_t h_proto = 0U;
+    const void *saddr = nullptr;
+    const void *daddr = nullptr;
+    size_t addr_len = 0U;
+    uint8_t family = 0U;
+    uint8_t protocol = 0U;
+
+    if (len >= ETH_HDR_LEN) {
+        h_proto = reinterpret_cast<const struct ethhdr *>(frame)->h_proto;
+    }
+    if (h_proto == htons(ETH_P_8021Q) && len >= ETH_VLAN_HDR_LEN) {
+        const struct vlanhdr *p_vlan_hdr =
+            reinterpret_cast<const struct vlanhdr *>(frame + ETH_HDR_LEN);
+        h_proto = p_vlan_hdr->h_vlan_encapsulated_proto;
+        l3_offset = ETH_VLAN_HDR_LEN;
+    }
+    if (h_proto == htons(ETH_P_IP) && len >= l3_offset + sizeof(struct iphdr)) {
+        const struct iphdr *p_ip_h = reinterpret_cast<const struct iphdr *>(frame + l3_offset);
+        family = AF_INET;
+        protocol = p_ip_h->protocol;
+        saddr = &p_ip_h->saddr;
+        daddr = &p_ip_h->daddr;
+        addr_len = sizeof(p_ip_h->saddr);
+        // Only the first fragment carries the ports
+        if (!(p_ip_h->frag_off & htons(IP_OFFMASK))) {
+            l4_offset = l3_offset + p_ip_h->ihl * 4U;
+        }
+    } else if (h_proto == htons(ETH_P_IPV6) && len >= l3_offset + sizeof(struct ip6_hdr)) {
+        const struct ip6_hdr *p_ip_h6 = reinterpret_cast<const struct ip6_hdr *>(frame + l3_offset);
+        family = AF_INET6;
+        protocol = p_ip_h6->ip6_nxt;
+        saddr = &p_ip_h6->ip6_src;
+        daddr = &p_ip_h6->ip6_dst;
+        addr_len = sizeof(p_ip_h6->ip6_src);
+        l4_offset = l3_offset + sizeof(struct ip6_hdr);
+    }
+
+    if (filter.family &&
+        (filter.family != family ||
+         !addr_match(filter.local_addr, dir == PKT_MIRROR_DIR_RX ? daddr : saddr, addr_len) ||
+         !addr_match(filter.remote_addr, dir == PKT_MIRROR_DIR_RX ? saddr : daddr, addr_len))) {
+        return 0U;
+    }
+    if (filter.protocol && filter.protocol != protocol) {
+        return 0U;
+    }
+    if (filter.local_port || filter.remote_port) {
+        // The ports are at the same place in the TCP and UDP headers
+        if (!l4_offset || len < l4_offset + sizeof(struct udphdr) ||
+            (protocol != IPPROTO_TCP && protocol != IPPROTO_UDP)) {
+            return 0U;
+        }
+        const struct udphdr *p_udp_h = reinterpret_cast<const struct udphdr *>(frame + l4_offset);
+        uint16_t local = dir == PKT_MIRROR_DIR_RX ? p_udp_h->dest : p_udp_h->source;
+        uint16_t remote = dir == PKT_MIRROR_DIR_RX ? p_udp_h->source : p_udp_h->dest;
+        if ((filter.local_port && filter.local_port != local) ||
+            (filter.remote_port && filter.remote_port != remote)) {
+            return 0U;
+        }
+    }
+
+    if (filter.sample_rate > 1U && ++t_sample_count < filter.sample_rate) {
+        return 0U;
+    }
+    t_sample_count = 0U;
+    return std::min<size_t>(filter.snap_len ? filter.snap_len : PKT_MIRROR_SNAP_MAX,
+                            PKT_MIRROR_SNAP_MAX);
+}
+
+void pkt_mirror_write(uint8_t dir, uint32_t if_index, uint64_t ts_nsec, uint8_t flags,
+                      const struct iovec *iov, int iovcnt, size_t snap_len, size_t wire_len)
+{
+    pkt_mirror_shm_t *shm = __atomic_load_n(&g_p_pkt_mirror, __ATOMIC_ACQUIRE);
+
+    if (!shm) {
+        return;
+    }
+
+    uint64_t idx = __atomic_fetch_add(&shm->head, 1U, __ATOMIC_RELAXED);
+    pkt_mirror_slot_t *slot = &shm->slots[idx & (shm->num_slots - 1U)];
+    uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+
+    // An odd sequence is a slot still written by a producer which wrapped around the ring
+    if ((seq & 1U) ||
+        !__atomic_compare_exchange_n(&slot->seq, &seq, 2U * idx + 1U, false, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&shm->n_busy_drops, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    size_t cap_len = 0U;
+    for (int i = 0; i < iovcnt && cap_len < snap_len; ++i) {
+        size_t copy = std::min(iov[i].iov_len, snap_len - cap_len);
+        memcpy(slot->data + cap_len, iov[i].iov_base, copy);
+        cap_len += copy;
+    }
+    slot->ts_nsec = ts_nsec;
+    slot->wire_len = static_cast<uint32_t>(wire_len);
+    slot->if_index = if_index;
+    slot->cap_len = static_cast<uint16_t>(cap_len);
+    slot->dir = dir;
+    slot->flags = flags;
+    __atomic_store_n(&slot->seq, 2U * idx + 2U, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef PKT_MIRROR_H
+#define PKT_MIRROR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/uio.h>
+
+/*
+ * Mirroring of the offloaded packets, which tcpdump doesn't see, to the shared memory file
+ * <monitor.stats.shmem_dir>/xliomirror.<pid>. The file exists when monitor.stats.mirror_ring_slots
+ * is set, a capture runs while 'xlio_stats --mirror' holds a filter in it.
+ *
+ * The ring RX and TX paths of any thread produce: a slot is claimed by an increment of head and
+ * locked by its sequence, 2 * index + 1 while written and 2 * index + 2 once published. A busy
+ * slot drops the packet, the oldest slots are overwritten. The reader keeps its own position and
+ * counts the overwritten and torn slots as lost.
+ *
+ * All the fields are in the host byte order, except the addresses and ports of the filter.
+ */
+#define PKT_MIRROR_FILE_MAGIC   "XLIOMIR1"
+#define PKT_MIRROR_FILE_VERSION 1U
+// Bytes of a packet kept in a slot, enough for the headers and the start of the payload
+#define PKT_MIRROR_SNAP_MAX 480U
+
+enum pkt_mirror_dir_t : uint8_t { PKT_MIRROR_DIR_RX = 1, PKT_MIRROR_DIR_TX = 2 };
+
+#define PKT_MIRROR_FLAG_HW_TS 0x1 // The timestamp is of the NIC clock
+
+/*
+ * The zero fields match any packet. The local endpoint is the destination of a received packet
+ * and the source of a sent one, so one filter captures both directions of a connection.
+ */
+struct pkt_mirror_filter_t {
+    uint8_t local_addr[16]; // IPv4 in the first 4 bytes
+    uint8_t remote_addr[16];
+    uint16_t local_port;
+    uint16_t remote_port;
+    uint8_t family; // AF_INET, AF_INET6 or 0, the addresses are compared if set
+    uint8_t protocol; // IPPROTO_TCP, IPPROTO_UDP or 0
+    uint16_t snap_len; // Bytes from the start of the frame, up to PKT_MIRROR_SNAP_MAX
+    uint32_t sample_rate; // Every sample_rate-th matching packet of a thread, 0 stops the capture
+};
+
+struct pkt_mirror_slot_t {
+    uint64_t seq;
+    uint64_t ts_nsec; // CLOCK_REALTIME
+    uint32_t wire_len; // Length of the frame, a TSO frame before the segmentation
+    uint32_t if_index;
+    uint16_t cap_len;
+    uint8_t dir; // pkt_mirror_dir_t
+    uint8_t flags; // PKT_MIRROR_FLAG_*
+    uint32_t reserved;
+    uint8_t data[PKT_MIRROR_SNAP_MAX];
+};
+
+/*
+ * The reader writes filter and increments req_seq, the publisher timer of the process applies
+ * the filter, stores the status, 0 or a negative errno, and then ack_seq = req_seq. The capture
+ * is stopped if the reader doesn't increment reader_alive for a second.
+ */
+struct pkt_mirror_ctl_t {
+    uint32_t req_seq;
+    uint32_t ack_seq;
+    int32_t status;
+    uint32_t reader_alive;
+    pkt_mirror_filter_t filter;
+};
+
+struct pkt_mirror_shm_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_slots; // Power of 2
+    uint32_t slot_size; // sizeof(pkt_mirror_slot_t)
+    uint32_t reserved;
+    pkt_mirror_ctl_t ctl;
+    alignas(64) uint64_t head; // Slots claimed by the producers
+    uint64_t n_busy_drops; // Packets dropped on a slot which was still written
+    alignas(64) pkt_mirror_slot_t slots[];
+};
+
+static inline size_t pkt_mirror_shm_size(uint32_t num_slots)
+{
+    return sizeof(pkt_mirror_shm_t) + (size_t)num_slots * sizeof(pkt_mirror_slot_t);
+}
+
+enum pkt_mirror_read_t { PKT_MIRROR_READ_OK, PKT_MIRROR_READ_PENDING, PKT_MIRROR_READ_LOST };
+
+/*
+ * Copies the slot of the packet number pos. PENDING means the producer hasn't published it yet,
+ * LOST means the slot was overwritten by a newer packet.
+ */
+static inline pkt_mirror_read_t pkt_mirror_read(const pkt_mirror_shm_t *shm, uint64_t pos,
+                                                pkt_mirror_slot_t *out)
+{
+    const pkt_mirror_slot_t *slot = &shm->slots[pos & (shm->num_slots - 1U)];
+    uint64_t expected = 2U * pos + 2U;
+    uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if (seq != expected) {
+        return seq < expected ? PKT_MIRROR_READ_PENDING : PKT_MIRROR_READ_LOST;
+    }
+    memcpy(out, slot, offsetof(pkt_mirror_slot_t, data));
+    memcpy(out->data, slot->data, out->cap_len <= PKT_MIRROR_SNAP_MAX ? out->cap_len : 0U);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == expected ? PKT_MIRROR_READ_OK
+                                                                     : PKT_MIRROR_READ_LOST;
+}
+
+// The ring of the running capture, nullptr while there is no capture
+extern pkt_mirror_shm_t *g_p_pkt_mirror;
+
+// Called by the publisher timer only, a zero sample rate stops the capture
+void pkt_mirror_set_filter(pkt_mirror_shm_t *shm, const pkt_mirror_filter_t &filter);
+
+/*
+ * Returns the number of bytes to capture of a packet or 0 to skip it. hdr is the start of the
+ * frame, at least up to the transport ports.
+ */
+size_t pkt_mirror_select(uint8_t dir, const void *hdr, size_t len);
+// Copies up to snap_len bytes of the frame, iov may cover only the start of the frame
+void pkt_mirror_write(uint8_t dir, uint32_t if_index, uint64_t ts_nsec, uint8_t flags,
+                      const struct iovec *iov, int iovcnt, size_t snap_len, size_t wire_len);
+
+#endif /* PKT_MIRROR_H */
@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef RULE_MATCHER_H
+#define RULE_MATCHER_H
+
+#include <stdint.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <vector>
+
+#include "core/util/libxlio.h"
+#include "core/util/lpm_trie.h"
+
+// An address of a socket to match against the address:port parts of the rules
+struct rule_match_addr {
+    uint32_t addr; // IPv4 in the network byte order
+    uint16_t port; // Host byte order
+    bool addr_valid; // false if the address isn't IPv4 or IPv4 embedded in IPv6
+};
+
+/**
+ * The use_family_rule list of a role of an instance, compiled for the lookups.
+ *
+ * The rules with a port range of the first address are found in a table of the port intervals
+ * between the range boundaries, the rules with an address only in a prefix trie and the rest in
+ * a list. A lookup takes the first rule which matches in each of them and returns the earliest
+ * of these, so the first matching rule of the list still wins. The rules are referenced, the
+ * list must outlive the matcher. Not thread safe.
+ */
+class rule_matcher {
+public:
+    void build(const struct dbl_lst &rules)
+    {
+        std::vector<uint32_t> bounds {0U};
+
+        clear();
+        for (struct dbl_lst_node *node = rules.head; node; node = node->next) {
+            if (node->data) {
+                m_rules.push_back(static_cast<const struct use_family_rule *>(node->data));
+            }
+        }
+
+        for (const struct use_family_rule *rule : m_rules) {
+            if (rule->first.match_by_port) {
+                bounds.push_back(rule->first.sport);
+                bounds.push_back(rule->first.eport + 1U);
+            }
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+        // The intervals start at the bounds up to the last port
+        while (bounds.back() > UINT16_MAX) {
+            bounds.pop_back();
+        }
+        m_port_starts.assign(bounds.begin(), bounds.end());
+        m_port_rules.resize(m_port_starts.size());
+
+        for (uint32_t i = 0; i < m_rules.size(); ++i) {
+            const struct address_port_rule &first = m_rules[i]->first;
+
+            if (first.match_by_port) {
+                auto begin = std::lower_bound(m_port_starts.begin(), m_port_starts.end(),
+                                              first.sport);
+                auto end = std::lower_bound(m_port_starts.begin(), m_port_starts.end(),
+                                            first.eport + 1U);
+                for (auto iter = begin; iter < end; ++iter) {
+                    m_port_rules[iter - m_port_starts.begin()].push_back(i);
+                }
+            } else if (first.match_by_addr) {
+                unsigned prefix_len = std::min<unsigned>(first.prefixlen, 32U);
+                uint32_t prefix = first.ipv4.s_addr & netmask(prefix_len);
+                m_addr_rules.insert(reinterpret_cast<const uint8_t *>(&prefix), prefix_len, i);
+            } else {
+                m_any_rules.push_back(i);
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_rules.clear();
+        m_port_starts.clear();
+        m_port_rules.clear();
+        m_addr_rules.clear();
+        m_any_rules.clear();
+    }
+
+    /*
+     * The first rule which matches the addresses and targets the transport, OS or ULP.
+     * The second address is nullptr for the roles with a single address.
+     */
+    const struct use_family_rule *match(transport_t my_transport, const rule_match_addr &first,
+                                        const rule_match_addr *second = nullptr) const
+    {
+        uint32_t best = UINT32_MAX;
+        auto first_match = [&](const std::vector<uint32_t> &candidates) {
+            for (uint32_t i : candidates) {
+                if (i >= best) {
+                    break;
+                }
+                if (matches(*m_rules[i], my_transport, first, second)) {
+                    best = i;
+                    break;
+                }
+            }
+        };
+
+        if (!m_port_starts.empty()) {
+            auto iter = std::upper_bound(m_port_starts.begin(), m_port_starts.end(), first.port);
+            first_match(m_port_rules[iter - m_port_starts.begin() - 1]);
+        }
+        if (first.addr_valid) {
+            m_addr_rules.for_each_match(reinterpret_cast<const uint8_t *>(&first.addr), 32U,
+                                        first_match);
+        }
+        first_match(m_any_rules);
+
+        return best < m_rules.size() ? m_rules[best] : nullptr;
+    }
+
+    size_t size() const { return m_rules.size(); }
+
+    // The check of a single rule, as done by the linear walk of the list
+    static bool matches(const struct use_family_rule &rule, transport_t my_transport,
+                        const rule_match_addr &first, const rule_match_addr *second)
+    {
+        if (!matches(rule.first, first)) {
+            return false;
+        }
+        if (rule.use_second && second && !matches(rule.second, *second)) {
+            return false;
+        }
+        return rule.target_transport == TRANS_OS || rule.target_transport == TRANS_ULP ||
+            rule.target_transport == my_transport;
+    }
+
+private:
+    static uint32_t netmask(unsigned prefix_len)
+    {
+        return htonl(static_cast<uint32_t>(XLIO_NETMASK(prefix_len)));
+    }
+
+    static bool matches(const struct address_port_rule &rule, const rule_match_addr &addr)
+    {
+        if (rule.match_by_port && (addr.port < rule.sport || addr.port > rule.eport)) {
+            return false;
+        }
+        if (rule.match_by_addr) {
+            uint32_t mask = netmask(std::min<unsigned>(rule.prefixlen, 32U));
+            return addr.addr_valid && (rule.ipv4.s_addr & mask) == (addr.addr & mask);
+        }
+        return true;
+    }
+
+    std::vector<const struct use_family_rule *> m_rules;
+    // The rules of the port interval starting at m_port_starts[i], by their position
+    std::vector<uint32_t> m_port_starts;
+    std::vector<std::vector<uint32_t>> m_port_rules;
+    lpm_trie<uint32_t> m_addr_rules;
+    std::vector<uint32_t> m_any_rules;
+};
+
+#endif /* RULE_MATCHER_H */
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Value published by a single writer and read without a lock.
+ *
+ * The writer makes the sequence odd, stores the value and makes the sequence even again.
+ * A reader retries while the sequence is odd or changed during its copy. The value is kept
+ * in atomic words, so a torn copy is only discarded and never a data race.
+ * The writers must be serialized by the owner, the readers may run on any thread.
+ */
+template <typename T> class seqlock_data {
+    static_assert(std::is_trivially_copyable<T>::value, "seqlock_data needs a plain type");
+
+public:
+    seqlock_data()
+    {
+        for (auto &word : m_words) {
+            word.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    void store(const T &val)
+    {
+        uint64_t words[WORDS] = {};
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+
+        memcpy(words, &val, sizeof(val));
+        m_seq.store(seq + 1U, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_seq.store(seq + 2U, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        uint64_t words[WORDS];
+        uint32_t seq;
+        T val;
+
+        do {
+            seq = m_seq.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1U) || seq != m_seq.load(std::memory_order_relaxed));
+
+        memcpy(&val, words, sizeof(val));
+        return val;
+    }
+
+private:
+    enum : size_t { WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t) };
+
+    std::atomic<uint32_t> m_seq {0U};
+    std::atomic<uint64_t> m_words[WORDS];
+};
+
+#endif /* SEQLOCK_H */
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/util/utils.h"
+
+/*
+ * Bounded ring of N elements for a single producer and a single consumer.
+ * The producer owns the tail and the consumer owns the head, each index is on its own cache
+ * line next to the cached copy of the other index, so push() and pop() don't share a written
+ * cache line unless the ring is observed full or empty.
+ * Several producers or several consumers must be serialized by their owner.
+ */
+template <typename T, size_t N> class spsc_ring {
+    static_assert(N && !(N & (N - 1)), "spsc_ring size must be a power of 2");
+
+public:
+    spsc_ring() = default;
+    spsc_ring(const spsc_ring &) = delete;
+    spsc_ring &operator=(const spsc_ring &) = delete;
+
+    // Producer side. Returns false if the ring is full.
+    inline bool push(T val)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_head_cache >= N) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail - m_head_cache >= N) {
+                return false;
+            }
+        }
+        m_slots[tail & (N - 1)] = val;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    inline bool pop(T &val)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail_cache) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tail_cache) {
+                return false;
+            }
+        }
+        val = m_slots[head & (N - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side, the result is a snapshot
+    inline size_t size() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    inline bool empty() const { return size() == 0; }
+
+private:
+    // Producer cache line
+    std::atomic<size_t> m_tail {0};
+    size_t m_head_cache = 0;
+    uint8_t m_pad_tail[CACHELINE_SIZE - sizeof(size_t) * 2];
+
+    // Consumer cache line
+    std::atomic<size_t> m_head {0};
+    size_t m_tail_cache = 0;
+    uint8_t m_pad_head[CACHELINE_SIZE - sizeof(size_t) * 2];
+
+    T m_slots[N];
+};
+
+#endif /* SPSC_RING_H */
@@ -11,6 +11,7 @@
 #include "main.h"
 
 #include <execinfo.h>
+#include <glob.h>
 #include <libgen.h>
 #include <linux/igmp.h>
 #include <math.h>
@@ -76,6 +77,26 @@ void check_netperf_flags();
 
 bool g_use_new_config = false;
 
+// Constant initialized, so the update from the library constructor isn't overwritten
+mce_hot_sys_var g_hot_sys_var;
+
+void mce_hot_sys_var::update(const mce_sys_var &sys)
+{
+    select_poll_num = sys.select_poll_num;
+    select_poll_os_ratio = sys.select_poll_os_ratio;
+    select_skip_os_fd_check = sys.select_skip_os_fd_check;
+    rx_poll_yield_loops = sys.rx_poll_yield_loops;
+    worker_placement = sys.worker_placement;
+    tcp_ctl_thread = sys.tcp_ctl_thread;
+    tx_sw_pacing = sys.tx_sw_pacing;
+    skip_poll_in_rx = sys.skip_poll_in_rx;
+    buffer_batching_mode = sys.buffer_batching_mode;
+    worker_threads = sys.worker_threads;
+    rx_cq_wait_ctrl = sys.rx_cq_wait_ctrl;
+    avoid_sys_calls_on_tcp_fd = sys.avoid_sys_calls_on_tcp_fd;
+    handle_sigintr = sys.handle_sigintr;
+}
+
 // Do not rely on global variable initialization in code that might be called
 // from library constructor
 mce_sys_var &safe_mce_sys()
@@ -340,6 +361,14 @@ static option_t<mode_t> options[] = {{ANON, "Regular pages", {"ANON", "ANONYMOUS
 OPTION_FROM_TO_STR_IMPL
 } // namespace option_alloc_type
 
+namespace option_auto_profile {
+static option_t<mode_t> options[] = {{NONE, "None", {"none", NULL, NULL}},
+                                     {LATENCY, "Latency", {"latency", NULL, NULL}},
+                                     {THROUGHPUT, "Throughput", {"throughput", NULL, NULL}},
+                                     {MEMORY, "Memory", {"memory", NULL, NULL}}};
+OPTION_FROM_TO_STR_IMPL
+} // namespace option_auto_profile
+
 int mce_sys_var::list_to_cpuset(char *cpulist, cpu_set_t *cpu_set)
 {
     char comma[] = ",";
@@ -745,6 +774,31 @@ void mce_sys_var::read_strq_stride_size_bytes(const config_registry &registry)
     strq_stride_size_bytes = static_cast<uint32_t>(stirde_size_bytes);
 }
 
+void mce_sys_var::validate_rx_hdr_split_size()
+{
+    if (!rx_hdr_split_size) {
+        return;
+    }
+    if (enable_striding_rq) {
+        // Striding RQ already packs small packets into small strides.
+        vlog_printf(VLOG_DEBUG, SYS_VAR_RX_HDR_SPLIT_SIZE " is ignored with Striding RQ\n");
+        rx_hdr_split_size = 0;
+        return;
+    }
+
+    uint32_t size = std::max<uint32_t>(rx_hdr_split_size, MCE_MIN_RX_HDR_SPLIT_SIZE);
+    size = std::min<uint32_t>(size, MCE_MAX_RX_HDR_SPLIT_SIZE);
+    // Header buffers are cache line granular.
+    size = (size + 63U) & ~63U;
+    if (size != rx_hdr_split_size) {
+        vlog_printf(VLOG_INFO,
+                    " Invalid " SYS_VAR_RX_HDR_SPLIT_SIZE
+                    ": Must be multiple of 64 and in the range of (%d,%d). Using: %u.\n",
+                    MCE_MIN_RX_HDR_SPLIT_SIZE, MCE_MAX_RX_HDR_SPLIT_SIZE, size);
+        rx_hdr_split_size = size;
+    }
+}
+
 void mce_sys_var::update_multi_process_params()
 {
 #if defined(DEFINED_NGINX)
@@ -794,6 +848,8 @@ void mce_sys_var::get_env_params()
     log_level = VLOG_DEFAULT;
     log_details = MCE_DEFAULT_LOG_DETAILS;
     log_colors = MCE_DEFAULT_LOG_COLORS;
+    log_async = MCE_DEFAULT_LOG_ASYNC;
+    log_rate_limit = MCE_DEFAULT_LOG_RATE_LIMIT;
     handle_sigintr = MCE_DEFAULT_HANDLE_SIGINTR;
     handle_segfault = MCE_DEFAULT_HANDLE_SIGFAULT;
     stats_fd_num_max = MCE_DEFAULT_STATS_FD_NUM;
@@ -805,13 +861,22 @@ void mce_sys_var::get_env_params()
     ring_migration_ratio_rx = MCE_DEFAULT_RING_MIGRATION_RATIO_RX;
     ring_limit_per_interface = MCE_DEFAULT_RING_LIMIT_PER_INTERFACE;
     ring_dev_mem_tx = MCE_DEFAULT_RING_DEV_MEM_TX;
+    ring_dev_mem_tx_shared = MCE_DEFAULT_RING_DEV_MEM_TX_SHARED;
+    ring_per_priority_tx = MCE_DEFAULT_RING_PER_PRIORITY_TX;
+    ring_bond_warm_standby = MCE_DEFAULT_RING_BOND_WARM_STANDBY;
+    ring_numa_aware = MCE_DEFAULT_RING_NUMA_AWARE;
+    ring_precreate_threads = MCE_DEFAULT_RING_PRECREATE_THREADS;
+    ring_core_pool_size = MCE_DEFAULT_RING_CORE_POOL_SIZE;
+    tx_sw_pacing = MCE_DEFAULT_TX_SW_PACING;
 
     zc_cache_threshold = MCE_DEFAULT_ZC_CACHE_THRESHOLD;
+    zc_cache_max_files = MCE_DEFAULT_ZC_CACHE_MAX_FILES;
     tx_buf_size = MCE_DEFAULT_TX_BUF_SIZE;
     tcp_nodelay_treshold = MCE_DEFAULT_TCP_NODELAY_TRESHOLD;
     tx_num_wr = MCE_DEFAULT_TX_NUM_WRE;
     tx_num_wr_to_signal = MCE_DEFAULT_TX_NUM_WRE_TO_SIGNAL;
     tx_max_inline = MCE_DEFAULT_TX_MAX_INLINE;
+    tx_bf_burst = MCE_DEFAULT_TX_BF_BURST;
     tx_mc_loopback_default = MCE_DEFAULT_TX_MC_LOOPBACK;
     tx_nonblocked_eagains = MCE_DEFAULT_TX_NONBLOCKED_EAGAINS;
     tx_prefetch_bytes = MCE_DEFAULT_TX_PREFETCH_BYTES;
@@ -820,19 +885,31 @@ void mce_sys_var::get_env_params()
     tx_segs_batch_tcp = MCE_DEFAULT_TX_SEGS_BATCH_TCP;
     tx_segs_ring_batch_tcp = MCE_DEFAULT_TX_SEGS_RING_BATCH_TCP;
     tx_segs_pool_batch_tcp = MCE_DEFAULT_TX_SEGS_POOL_BATCH_TCP;
+    group_buf_cache_batch = MCE_DEFAULT_GROUP_BUF_CACHE_BATCH;
+    group_buf_cache_size = MCE_DEFAULT_GROUP_BUF_CACHE_SIZE;
     rx_buf_size = MCE_DEFAULT_RX_BUF_SIZE;
     rx_bufs_batch = MCE_DEFAULT_RX_BUFS_BATCH;
     rx_num_wr = MCE_DEFAULT_RX_NUM_WRE;
     rx_num_wr_to_post_recv = MCE_DEFAULT_RX_NUM_WRE_TO_POST_RECV;
+    rx_num_wr_shared = MCE_DEFAULT_RX_NUM_WRE_SHARED;
+    rx_hdr_split_size = MCE_DEFAULT_RX_HDR_SPLIT_SIZE;
     rx_poll_num = MCE_DEFAULT_RX_NUM_POLLS;
     rx_poll_num_init = MCE_DEFAULT_RX_NUM_POLLS_INIT;
     rx_udp_poll_os_ratio = MCE_DEFAULT_RX_UDP_POLL_OS_RATIO;
     hw_ts_conversion_mode = MCE_DEFAULT_HW_TS_CONVERSION_MODE;
     rx_poll_yield_loops = MCE_DEFAULT_RX_POLL_YIELD;
     select_handle_cpu_usage_stats = MCE_DEFAULT_SELECT_CPU_USAGE_STATS;
+    stats_latency_hist = MCE_DEFAULT_STATS_LATENCY_HIST;
+    stats_lock_profiling = MCE_DEFAULT_STATS_LOCK_PROFILING;
+    stats_trace_ring_events = MCE_DEFAULT_STATS_TRACE_RING_EVENTS;
+    stats_mirror_ring_slots = MCE_DEFAULT_STATS_MIRROR_RING_SLOTS;
     rx_ready_byte_min_limit = MCE_DEFAULT_RX_BYTE_MIN_LIMIT;
     rx_prefetch_bytes = MCE_DEFAULT_RX_PREFETCH_BYTES;
     rx_prefetch_bytes_before_poll = MCE_DEFAULT_RX_PREFETCH_BYTES_BEFORE_POLL;
+    rx_prefetch_depth = MCE_DEFAULT_RX_PREFETCH_DEPTH;
+    rx_compact_threshold = MCE_DEFAULT_RX_COMPACT_THRESHOLD;
+    rx_compact_max_size = MCE_DEFAULT_RX_COMPACT_MAX_SIZE;
+    rx_waitall_placement_min = MCE_DEFAULT_RX_WAITALL_PLACEMENT_MIN;
     rx_cq_drain_rate_nsec = MCE_DEFAULT_RX_CQ_DRAIN_RATE;
     rx_delta_tsc_between_cq_polls = 0;
 
@@ -840,17 +917,22 @@ void mce_sys_var::get_env_params()
     strq_stride_num_per_rwqe = MCE_DEFAULT_STRQ_NUM_STRIDES;
     strq_stride_size_bytes = MCE_DEFAULT_STRQ_STRIDE_SIZE_BYTES;
     strq_strides_compensation_level = MCE_DEFAULT_STRQ_STRIDES_COMPENSATION_LEVEL;
+    strq_auto_geometry = MCE_DEFAULT_STRQ_AUTO_GEOMETRY;
 
     gro_streams_max = MCE_DEFAULT_GRO_STREAMS_MAX;
+    gro_flush_usec = MCE_DEFAULT_GRO_FLUSH_USEC;
     disable_flow_tag = MCE_DEFAULT_DISABLE_FLOW_TAG;
 
     tcp_2t_rules = MCE_DEFAULT_TCP_2T_RULES;
     tcp_3t_rules = MCE_DEFAULT_TCP_3T_RULES;
+    tcp_deferred_rules_msec = MCE_DEFAULT_TCP_DEFERRED_RULES_MSEC;
     udp_3t_rules = MCE_DEFAULT_UDP_3T_RULES;
+    udp_reuseport_buckets = MCE_DEFAULT_UDP_REUSEPORT_BUCKETS;
     eth_mc_l2_only_rules = MCE_DEFAULT_ETH_MC_L2_ONLY_RULES;
     mc_force_flowtag = MCE_DEFAULT_MC_FORCE_FLOWTAG;
 
     select_poll_num = MCE_DEFAULT_SELECT_NUM_POLLS;
+    poll_adaptive = MCE_DEFAULT_POLL_ADAPTIVE;
     select_poll_os_ratio = MCE_DEFAULT_SELECT_POLL_OS_RATIO;
     select_skip_os_fd_check = MCE_DEFAULT_SELECT_SKIP_OS;
 
@@ -861,6 +943,7 @@ void mce_sys_var::get_env_params()
     cq_aim_max_period_usec = MCE_DEFAULT_CQ_AIM_MAX_PERIOD_USEC;
     cq_aim_interval_msec = MCE_DEFAULT_CQ_AIM_INTERVAL_MSEC;
     cq_aim_interrupts_rate_per_sec = MCE_DEFAULT_CQ_AIM_INTERRUPTS_RATE_PER_SEC;
+    cq_aim_target_latency_usec = MCE_DEFAULT_CQ_AIM_TARGET_LATENCY_USEC;
 
     cq_poll_batch_max = MCE_DEFAULT_CQ_POLL_BATCH;
     progress_engine_interval_msec = MCE_DEFAULT_PROGRESS_ENGINE_INTERVAL_MSEC;
@@ -868,6 +951,13 @@ void mce_sys_var::get_env_params()
     cq_keep_qp_full = MCE_DEFAULT_CQ_KEEP_QP_FULL;
     max_tso_sz = MCE_DEFAULT_MAX_TSO_SIZE;
     worker_threads = MCE_DEFAULT_WORKER_THREADS;
+    worker_placement = MCE_DEFAULT_WORKER_PLACEMENT;
+    worker_listen_buckets = MCE_DEFAULT_WORKER_LISTEN_BUCKETS;
+    worker_park_msec = MCE_DEFAULT_WORKER_PARK_MSEC;
+    worker_idle_pause_usec = MCE_DEFAULT_WORKER_IDLE_PAUSE_USEC;
+    worker_idle_block_usec = MCE_DEFAULT_WORKER_IDLE_BLOCK_USEC;
+    strcpy(worker_affinity_str, MCE_DEFAULT_WORKER_AFFINITY_STR);
+    CPU_ZERO(&worker_affinity);
     offloaded_sockets = MCE_DEFAULT_OFFLOADED_SOCKETS;
     timer_resolution_msec = MCE_DEFAULT_TIMER_RESOLUTION_MSEC;
     tcp_timer_resolution_msec = MCE_DEFAULT_TCP_TIMER_RESOLUTION_MSEC;
@@ -875,6 +965,20 @@ void mce_sys_var::get_env_params()
     tcp_ts_opt = MCE_DEFAULT_TCP_TIMESTAMP_OPTION;
     tcp_nodelay = MCE_DEFAULT_TCP_NODELAY;
     tcp_quickack = MCE_DEFAULT_TCP_QUICKACK;
+    tcp_sack = MCE_DEFAULT_TCP_SACK;
+    tcp_ecn = MCE_DEFAULT_TCP_ECN;
+    tcp_rack = MCE_DEFAULT_TCP_RACK;
+    tcp_syncookies = MCE_DEFAULT_TCP_SYNCOOKIES;
+    tcp_fastopen = MCE_DEFAULT_TCP_FASTOPEN;
+    tcp_timewait_compact = MCE_DEFAULT_TCP_TIMEWAIT_COMPACT;
+    tcp_timer_park_idle = MCE_DEFAULT_TCP_TIMER_PARK_IDLE;
+    tcp_moderate_rcvbuf = MCE_DEFAULT_TCP_MODERATE_RCVBUF;
+    tcp_ack_coalesce = MCE_DEFAULT_TCP_ACK_COALESCE;
+    tcp_ack_adaptive = MCE_DEFAULT_TCP_ACK_ADAPTIVE;
+    tcp_cork_timeout_msec = MCE_DEFAULT_TCP_CORK_TIMEOUT_MSEC;
+    tcp_mtu_probing = MCE_DEFAULT_TCP_MTU_PROBING;
+    udp_dst_cache_size = MCE_DEFAULT_UDP_DST_CACHE_SIZE;
+    path_cache_size = MCE_DEFAULT_PATH_CACHE_SIZE;
     tcp_push_flag = MCE_DEFAULT_TCP_PUSH_FLAG;
     //	exception_handling is handled by its CTOR
     avoid_sys_calls_on_tcp_fd = MCE_DEFAULT_AVOID_SYS_CALLS_ON_TCP_FD;
@@ -885,15 +989,28 @@ void mce_sys_var::get_env_params()
     memory_limit = MCE_DEFAULT_MEMORY_LIMIT;
     memory_limit_user = MCE_DEFAULT_MEMORY_LIMIT_USER;
     heap_metadata_block = MCE_DEFAULT_HEAP_METADATA_BLOCK;
+    buffer_pool_shrink_msec = MCE_DEFAULT_BUFFER_POOL_SHRINK_MSEC;
+    rx_pool_low_watermark = MCE_DEFAULT_RX_POOL_LOW_WATERMARK;
+    rx_socket_bufs_max = MCE_DEFAULT_RX_SOCKET_BUFS_MAX;
     hugepage_size = MCE_DEFAULT_HUGEPAGE_SIZE;
+    hugepage_prefault_threads = MCE_DEFAULT_HUGEPAGE_PREFAULT_THREADS;
+    strcpy(hugepage_persistent_file, MCE_DEFAULT_HUGEPAGE_PERSISTENT_FILE);
+    hugepage_fork_slices = MCE_DEFAULT_HUGEPAGE_FORK_SLICES;
+    hugepage_queues = MCE_DEFAULT_HUGEPAGE_QUEUES;
     enable_tso = MCE_DEFAULT_TSO;
 #ifdef DEFINED_UTLS
     enable_utls_rx = MCE_DEFAULT_UTLS_RX;
     enable_utls_tx = MCE_DEFAULT_UTLS_TX;
     utls_high_wmark_dek_cache_size = MCE_DEFAULT_UTLS_HIGH_WMARK_DEK_CACHE_SIZE;
     utls_low_wmark_dek_cache_size = MCE_DEFAULT_UTLS_LOW_WMARK_DEK_CACHE_SIZE;
+    utls_dek_pool_size = MCE_DEFAULT_UTLS_DEK_POOL_SIZE;
+    utls_tx_coalesce_size = MCE_DEFAULT_UTLS_TX_COALESCE_SIZE;
 #endif /* DEFINED_UTLS */
     enable_lro = MCE_DEFAULT_LRO;
+    enable_mpwqe = MCE_DEFAULT_MPWQE;
+    mpwqe_max_pkt_size = MCE_DEFAULT_MPWQE_MAX_PKT_SIZE;
+    rx_cqe_compression = MCE_DEFAULT_RX_CQE_COMPRESSION;
+    implicit_odp = MCE_DEFAULT_IMPLICIT_ODP;
     handle_fork = MCE_DEFAULT_FORK_SUPPORT;
     close_on_dup2 = MCE_DEFAULT_CLOSE_ON_DUP2;
     mtu = MCE_DEFAULT_MTU;
@@ -910,10 +1027,14 @@ void mce_sys_var::get_env_params()
     lwip_mss = MCE_DEFAULT_MSS;
     lwip_cc_algo_mod = MCE_DEFAULT_LWIP_CC_ALGO_MOD;
     mce_spec = MCE_SPEC_NONE;
+    auto_profile = MCE_DEFAULT_AUTO_PROFILE;
+    memset(&auto_profile_hw, 0, sizeof(auto_profile_hw));
 
     neigh_num_err_retries = MCE_DEFAULT_NEIGH_NUM_ERR_RETRIES;
     neigh_uc_arp_quata = MCE_DEFAULT_NEIGH_UC_ARP_QUATA;
     neigh_wait_till_send_arp_msec = MCE_DEFAULT_NEIGH_UC_ARP_DELAY_MSEC;
+    neigh_refresh_msec = MCE_DEFAULT_NEIGH_REFRESH_MSEC;
+    strcpy(neigh_preresolve, MCE_DEFAULT_NEIGH_PRERESOLVE);
     timer_netlink_update_msec = MCE_DEFAULT_NETLINK_TIMER_MSEC;
 
     deferred_close = MCE_DEFAULT_DEFERRED_CLOSE;
@@ -921,6 +1042,8 @@ void mce_sys_var::get_env_params()
     rx_poll_on_tx_tcp = MCE_DEFAULT_RX_POLL_ON_TX_TCP;
     rx_cq_wait_ctrl = MCE_DEFAULT_RX_CQ_WAIT_CTRL;
     tcp_send_buffer_size = MCE_DEFAULT_TCP_SEND_BUFFER_SIZE;
+    tcp_send_buffer_autotune_limit = MCE_DEFAULT_TCP_SEND_BUFFER_AUTOTUNE_LIMIT;
+    tcp_socket_pool_size = MCE_DEFAULT_TCP_SOCKET_POOL_SIZE;
     skip_poll_in_rx = MCE_DEFAULT_SKIP_POLL_IN_RX;
     multilock = MCE_DEFAULT_MULTILOCK;
 
@@ -949,6 +1072,40 @@ void mce_sys_var::get_env_params()
         }
     }
 
+    if ((env_ptr = getenv(SYS_VAR_WORKER_PLACEMENT))) {
+        worker_placement = (uint32_t)atoi(env_ptr);
+    }
+    if (worker_placement > WORKER_PLACEMENT_LEAST_LOADED) {
+        vlog_printf(VLOG_WARNING, "%s has an invalid value %u, using the default\n",
+                    SYS_VAR_WORKER_PLACEMENT, worker_placement);
+        worker_placement = MCE_DEFAULT_WORKER_PLACEMENT;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_WORKER_LISTEN_BUCKETS))) {
+        worker_listen_buckets =
+            std::min<uint32_t>((uint32_t)atoi(env_ptr), MCE_MAX_WORKER_LISTEN_BUCKETS);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_WORKER_PARK_MSEC))) {
+        worker_park_msec = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_WORKER_IDLE_PAUSE_USEC))) {
+        worker_idle_pause_usec = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_WORKER_IDLE_BLOCK_USEC))) {
+        worker_idle_block_usec = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_WORKER_AFFINITY))) {
+        int n = snprintf(worker_affinity_str, sizeof(worker_affinity_str), "%s", env_ptr);
+        if (unlikely(((int)sizeof(worker_affinity_str) < n) || (n < 0))) {
+            vlog_printf(VLOG_WARNING, "Failed to process: %s.\n", SYS_VAR_WORKER_AFFINITY);
+        }
+    }
+    configure_worker_affinity();
+
     /*
      * Check for specific application configuration first. We can make decisions
      * based on number of workers or application type further.
@@ -1099,6 +1256,11 @@ void mce_sys_var::get_env_params()
         break;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_AUTO_PROFILE))) {
+        auto_profile = option_auto_profile::from_str(env_ptr, MCE_DEFAULT_AUTO_PROFILE);
+    }
+    apply_auto_profile();
+
     if ((env_ptr = getenv(SYS_VAR_PRINT_REPORT))) {
         print_report = option_3::from_str(env_ptr, MCE_DEFAULT_PRINT_REPORT);
     }
@@ -1152,6 +1314,14 @@ void mce_sys_var::get_env_params()
         log_colors = atoi(env_ptr) ? true : false;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_LOG_ASYNC))) {
+        log_async = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_LOG_RATE_LIMIT))) {
+        log_rate_limit = (uint32_t)atoi(env_ptr);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_APPLICATION_ID))) {
         read_env_variable_with_pid(app_id, sizeof(app_id), env_ptr);
     }
@@ -1176,6 +1346,10 @@ void mce_sys_var::get_env_params()
     legacy_read_strq_strides_num();
     legacy_read_strq_stride_size_bytes();
 
+    if ((env_ptr = getenv(SYS_VAR_STRQ_AUTO_GEOMETRY))) {
+        strq_auto_geometry = atoi(env_ptr) ? true : false;
+    }
+
     if ((env_ptr = getenv(SYS_VAR_STRQ_STRIDES_COMPENSATION_LEVEL))) {
         strq_strides_compensation_level = (uint32_t)atoi(env_ptr);
     }
@@ -1184,6 +1358,10 @@ void mce_sys_var::get_env_params()
         zc_cache_threshold = option_size::from_str(env_ptr);
     }
 
+    if ((env_ptr = getenv(SYS_VAR_ZC_CACHE_MAX_FILES))) {
+        zc_cache_max_files = (uint32_t)atoi(env_ptr);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_TX_BUF_SIZE))) {
         tx_buf_size = (uint32_t)option_size::from_str(env_ptr);
         tx_buf_size = std::min(tx_buf_size, 256U * 1024U);
@@ -1208,6 +1386,10 @@ void mce_sys_var::get_env_params()
     if ((env_ptr = getenv(SYS_VAR_TX_MAX_INLINE))) {
         tx_max_inline = (uint32_t)atoi(env_ptr);
     }
+
+    if ((env_ptr = getenv(SYS_VAR_TX_BF_BURST))) {
+        tx_bf_burst = std::min<uint32_t>(TX_BF_BURST_MAX, std::max(atoi(env_ptr), 0));
+    }
     if (tx_max_inline > MAX_SUPPORTED_IB_INLINE_SIZE) {
         vlog_printf(VLOG_WARNING, "%s must be smaller or equal to %d [%d]\n", SYS_VAR_TX_MAX_INLINE,
                     MAX_SUPPORTED_IB_INLINE_SIZE, tx_max_inline);
@@ -1242,6 +1424,14 @@ void mce_sys_var::get_env_params()
         tx_segs_pool_batch_tcp = (uint32_t)std::max<int32_t>(atoi(env_ptr), 1);
     }
 
+    if ((env_ptr = getenv(SYS_VAR_GROUP_BUF_CACHE_BATCH))) {
+        group_buf_cache_batch = (uint32_t)std::max<int32_t>(atoi(env_ptr), 1);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_GROUP_BUF_CACHE_SIZE))) {
+        group_buf_cache_size = (uint32_t)std::max<int32_t>(atoi(env_ptr), 0);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_RING_ALLOCATION_LOGIC_TX))) {
         ring_allocation_logic_tx = (ring_logic_t)atoi(env_ptr);
         if (!is_ring_logic_valid(ring_allocation_logic_tx)) {
@@ -1278,6 +1468,39 @@ void mce_sys_var::get_env_params()
         ring_dev_mem_tx = std::max(0, atoi(env_ptr));
     }
 
+    if ((env_ptr = getenv(SYS_VAR_RING_DEV_MEM_TX_SHARED))) {
+        ring_dev_mem_tx_shared = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RING_PER_PRIORITY_TX))) {
+        ring_per_priority_tx = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RING_BOND_WARM_STANDBY))) {
+        ring_bond_warm_standby = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RING_NUMA_AWARE))) {
+        ring_numa_aware = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RING_PRECREATE_THREADS))) {
+        ring_precreate_threads = std::min<uint32_t>((uint32_t)std::max(0, atoi(env_ptr)),
+                                                    MCE_MAX_RING_PRECREATE_THREADS);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RING_CORE_POOL_SIZE))) {
+        ring_core_pool_size = std::min<uint32_t>((uint32_t)std::max(0, atoi(env_ptr)),
+                                                 MCE_MAX_RING_CORE_POOL_SIZE);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TX_SW_PACING))) {
+        tx_sw_pacing = (sw_pacing_mode_t)atoi(env_ptr);
+        if (tx_sw_pacing < 0 || tx_sw_pacing >= SW_PACING_LAST) {
+            tx_sw_pacing = MCE_DEFAULT_TX_SW_PACING;
+        }
+    }
+
     if ((env_ptr = getenv(SYS_VAR_RX_BUF_SIZE))) {
         rx_buf_size = (uint32_t)option_size::from_str(env_ptr);
         rx_buf_size = std::min(rx_buf_size, 0xFF00U);
@@ -1305,6 +1528,15 @@ void mce_sys_var::get_env_params()
         rx_num_wr = rx_num_wr_to_post_recv * 2;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_RX_NUM_WRE_SHARED))) {
+        rx_num_wr_shared = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RX_HDR_SPLIT_SIZE))) {
+        rx_hdr_split_size = (uint32_t)atoi(env_ptr);
+    }
+    validate_rx_hdr_split_size();
+
     if ((env_ptr = getenv(SYS_VAR_RX_NUM_POLLS))) {
         rx_poll_num = atoi(env_ptr);
     }
@@ -1349,6 +1581,24 @@ void mce_sys_var::get_env_params()
         select_handle_cpu_usage_stats = atoi(env_ptr) ? true : false;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_STATS_LATENCY_HIST))) {
+        stats_latency_hist = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_STATS_LOCK_PROFILING))) {
+        stats_lock_profiling = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_STATS_TRACE_RING_EVENTS))) {
+        stats_trace_ring_events = std::min(static_cast<uint32_t>(std::max(atoi(env_ptr), 0)),
+                                           MAX_STATS_TRACE_RING_EVENTS);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_STATS_MIRROR_RING_SLOTS))) {
+        stats_mirror_ring_slots = std::min(static_cast<uint32_t>(std::max(atoi(env_ptr), 0)),
+                                           MAX_STATS_MIRROR_RING_SLOTS);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_RX_BYTE_MIN_LIMIT))) {
         rx_ready_byte_min_limit = (uint32_t)atoi(env_ptr);
     }
@@ -1377,6 +1627,25 @@ void mce_sys_var::get_env_params()
         rx_prefetch_bytes_before_poll = MCE_DEFAULT_RX_PREFETCH_BYTES_BEFORE_POLL;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_RX_PREFETCH_DEPTH))) {
+        rx_prefetch_depth = (uint32_t)atoi(env_ptr);
+    }
+    if (rx_prefetch_depth > MCE_MAX_RX_PREFETCH_DEPTH) {
+        vlog_printf(VLOG_WARNING, "Rx prefetch depth out of range [%u] (max=%d, disabled=0)\n",
+                    rx_prefetch_depth, MCE_MAX_RX_PREFETCH_DEPTH);
+        rx_prefetch_depth = MCE_DEFAULT_RX_PREFETCH_DEPTH;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RX_COMPACT_THRESHOLD))) {
+        rx_compact_threshold = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+    if ((env_ptr = getenv(SYS_VAR_RX_COMPACT_MAX_SIZE))) {
+        rx_compact_max_size = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+    if ((env_ptr = getenv(SYS_VAR_RX_WAITALL_PLACEMENT_MIN))) {
+        rx_waitall_placement_min = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_RX_CQ_DRAIN_RATE_NSEC))) {
         rx_cq_drain_rate_nsec = atoi(env_ptr);
     }
@@ -1388,17 +1657,28 @@ void mce_sys_var::get_env_params()
         gro_streams_max = std::max(atoi(env_ptr), 0);
     }
 
+    if ((env_ptr = getenv(SYS_VAR_GRO_FLUSH_USEC))) {
+        gro_flush_usec = std::min<uint32_t>(std::max(atoi(env_ptr), 0), MCE_MAX_GRO_FLUSH_USEC);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_TCP_2T_RULES))) {
         tcp_2t_rules = atoi(env_ptr) ? true : false;
     }
     if ((env_ptr = getenv(SYS_VAR_TCP_3T_RULES))) {
         tcp_3t_rules = atoi(env_ptr) ? true : false;
     }
+    if ((env_ptr = getenv(SYS_VAR_TCP_DEFERRED_RULES_MSEC))) {
+        tcp_deferred_rules_msec = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
 
     if ((env_ptr = getenv(SYS_VAR_UDP_3T_RULES))) {
         udp_3t_rules = atoi(env_ptr) ? true : false;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_UDP_REUSEPORT_BUCKETS))) {
+        udp_reuseport_buckets = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_ETH_MC_L2_ONLY_RULES))) {
         eth_mc_l2_only_rules = atoi(env_ptr) ? true : false;
     }
@@ -1427,6 +1707,10 @@ void mce_sys_var::get_env_params()
         select_poll_num = MCE_DEFAULT_SELECT_NUM_POLLS;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_POLL_ADAPTIVE))) {
+        poll_adaptive = atoi(env_ptr) ? true : false;
+    }
+
     if ((env_ptr = getenv(SYS_VAR_SELECT_POLL_OS_RATIO))) {
         select_poll_os_ratio = (uint32_t)atoi(env_ptr);
     }
@@ -1481,6 +1765,10 @@ void mce_sys_var::get_env_params()
     if ((env_ptr = getenv(SYS_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC))) {
         cq_aim_interrupts_rate_per_sec = (uint32_t)atoi(env_ptr);
     }
+
+    if ((env_ptr = getenv(SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC))) {
+        cq_aim_target_latency_usec = (uint32_t)atoi(env_ptr);
+    }
 #else
     if ((env_ptr = getenv(SYS_VAR_CQ_MODERATION_ENABLE)) != NULL) {
         vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
@@ -1510,6 +1798,10 @@ void mce_sys_var::get_env_params()
         vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
                     SYS_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC);
     }
+    if ((env_ptr = getenv(SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC)) != NULL) {
+        vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
+                    SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC);
+    }
 #endif /* DEFINED_IBV_CQ_ATTR_MODERATE */
 
     if ((env_ptr = getenv(SYS_VAR_CQ_POLL_BATCH_MAX))) {
@@ -1597,6 +1889,62 @@ void mce_sys_var::get_env_params()
         tcp_quickack = atoi(env_ptr) ? true : false;
     }
 
+    if ((env_ptr = getenv(SYS_VAR_TCP_SACK))) {
+        tcp_sack = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_ECN))) {
+        tcp_ecn = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_RACK))) {
+        tcp_rack = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_SYNCOOKIES))) {
+        tcp_syncookies = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_FASTOPEN))) {
+        tcp_fastopen = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_TIMEWAIT_COMPACT))) {
+        tcp_timewait_compact = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_TIMER_PARK_IDLE))) {
+        tcp_timer_park_idle = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_MODERATE_RCVBUF))) {
+        tcp_moderate_rcvbuf = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_ACK_COALESCE))) {
+        tcp_ack_coalesce = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_ACK_ADAPTIVE))) {
+        tcp_ack_adaptive = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_CORK_TIMEOUT_MSEC))) {
+        tcp_cork_timeout_msec = (uint32_t)atoi(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_MTU_PROBING))) {
+        tcp_mtu_probing = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_UDP_DST_CACHE_SIZE))) {
+        udp_dst_cache_size = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_PATH_CACHE_SIZE))) {
+        path_cache_size = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_TCP_PUSH_FLAG))) {
         tcp_push_flag = atoi(env_ptr) ? true : false;
     }
@@ -1677,6 +2025,12 @@ void mce_sys_var::get_env_params()
     if ((env_ptr = getenv(SYS_VAR_NEIGH_UC_ARP_QUATA))) {
         neigh_uc_arp_quata = (uint32_t)atoi(env_ptr);
     }
+    if ((env_ptr = getenv(SYS_VAR_NEIGH_REFRESH_MSEC))) {
+        neigh_refresh_msec = (uint32_t)atoi(env_ptr);
+    }
+    if ((env_ptr = getenv(SYS_VAR_NEIGH_PRERESOLVE))) {
+        strncpy(neigh_preresolve, env_ptr, sizeof(neigh_preresolve) - 1);
+    }
 
     if ((env_ptr = getenv(SYS_VAR_MEM_ALLOC_TYPE))) {
         mem_alloc_type = option_alloc_type::from_str(env_ptr, MCE_DEFAULT_MEM_ALLOC_TYPE);
@@ -1690,6 +2044,15 @@ void mce_sys_var::get_env_params()
     if ((env_ptr = getenv(SYS_VAR_HEAP_METADATA_BLOCK))) {
         heap_metadata_block = option_size::from_str(env_ptr) ?: MCE_DEFAULT_HEAP_METADATA_BLOCK;
     }
+    if ((env_ptr = getenv(SYS_VAR_BUFFER_POOL_SHRINK_MSEC))) {
+        buffer_pool_shrink_msec = (uint32_t)atoi(env_ptr);
+    }
+    if ((env_ptr = getenv(SYS_VAR_RX_POOL_LOW_WATERMARK))) {
+        rx_pool_low_watermark = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
+    if ((env_ptr = getenv(SYS_VAR_RX_SOCKET_BUFS_MAX))) {
+        rx_socket_bufs_max = (uint32_t)std::max(atoi(env_ptr), 0);
+    }
     if ((env_ptr = getenv(SYS_VAR_HUGEPAGE_SIZE))) {
         hugepage_size = option_size::from_str(env_ptr);
         if (hugepage_size & (hugepage_size - 1)) {
@@ -1703,6 +2066,20 @@ void mce_sys_var::get_env_params()
             hugepage_size = MCE_DEFAULT_HUGEPAGE_SIZE;
         }
     }
+    if ((env_ptr = getenv(SYS_VAR_HUGEPAGE_PREFAULT_THREADS))) {
+        hugepage_prefault_threads =
+            std::min<uint32_t>((uint32_t)atoi(env_ptr), MCE_MAX_HUGEPAGE_PREFAULT_THREADS);
+    }
+    if ((env_ptr = getenv(SYS_VAR_HUGEPAGE_PERSISTENT_FILE))) {
+        strncpy(hugepage_persistent_file, env_ptr, sizeof(hugepage_persistent_file) - 1);
+    }
+    if ((env_ptr = getenv(SYS_VAR_HUGEPAGE_FORK_SLICES))) {
+        hugepage_fork_slices =
+            std::min<uint32_t>((uint32_t)atoi(env_ptr), MCE_MAX_HUGEPAGE_FORK_SLICES);
+    }
+    if ((env_ptr = getenv(SYS_VAR_HUGEPAGE_QUEUES))) {
+        hugepage_queues = atoi(env_ptr) ? true : false;
+    }
 
     if ((env_ptr = getenv(SYS_VAR_FORK))) {
         handle_fork = atoi(env_ptr) ? true : false;
@@ -1743,12 +2120,39 @@ void mce_sys_var::get_env_params()
             utls_low_wmark_dek_cache_size = utls_high_wmark_dek_cache_size / 2U;
         }
     }
+
+    if ((env_ptr = getenv(SYS_VAR_UTLS_DEK_POOL_SIZE)) != NULL) {
+        int temp = atoi(env_ptr);
+        utls_dek_pool_size = (temp >= 0 ? static_cast<size_t>(temp) : 0);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_UTLS_TX_COALESCE_SIZE)) != NULL) {
+        int temp = atoi(env_ptr);
+        utls_tx_coalesce_size = static_cast<uint32_t>(
+            std::min(std::max(temp, 0), static_cast<int>(MCE_MAX_UTLS_TX_COALESCE_SIZE)));
+    }
 #endif /* DEFINED_UTLS */
 
     if ((env_ptr = getenv(SYS_VAR_LRO))) {
         enable_lro = option_3::from_str(env_ptr, MCE_DEFAULT_LRO);
     }
 
+    if ((env_ptr = getenv(SYS_VAR_MPWQE))) {
+        enable_mpwqe = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_MPWQE_MAX_PKT_SIZE))) {
+        mpwqe_max_pkt_size = (uint32_t)std::max<int32_t>(atoi(env_ptr), 0);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_RX_CQE_COMPRESSION))) {
+        rx_cqe_compression = atoi(env_ptr) ? true : false;
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_IMPLICIT_ODP))) {
+        implicit_odp = atoi(env_ptr) ? true : false;
+    }
+
     if ((env_ptr = getenv(SYS_VAR_CLOSE_ON_DUP2))) {
         close_on_dup2 = atoi(env_ptr) ? true : false;
     }
@@ -1801,6 +2205,14 @@ void mce_sys_var::get_env_params()
         tcp_send_buffer_size = (uint32_t)option_size::from_str(env_ptr);
     }
 
+    if ((env_ptr = getenv(SYS_VAR_TCP_SEND_BUFFER_AUTOTUNE_LIMIT))) {
+        tcp_send_buffer_autotune_limit = option_size::from_str(env_ptr);
+    }
+
+    if ((env_ptr = getenv(SYS_VAR_TCP_SOCKET_POOL_SIZE))) {
+        tcp_socket_pool_size = (uint32_t)atoi(env_ptr);
+    }
+
     if ((env_ptr = getenv(SYS_VAR_SKIP_POLL_IN_RX))) {
         int temp = atoi(env_ptr);
         if (temp < 0 || temp > SKIP_POLL_IN_RX_EPOLL_ONLY) {
@@ -1897,6 +2309,8 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         static_cast<decltype(log_level)>(registry.get_default_value<int>("monitor.log.level"));
     log_details = registry.get_default_value<uint32_t>("monitor.log.details");
     log_colors = registry.get_default_value<bool>("monitor.log.colors");
+    log_async = registry.get_default_value<bool>("monitor.log.async");
+    log_rate_limit = registry.get_default_value<uint32_t>("monitor.log.rate_limit");
     handle_sigintr = registry.get_default_value<bool>("core.signals.sigint.exit");
     handle_segfault = registry.get_default_value<bool>("core.signals.sigsegv.backtrace");
     stats_fd_num_max = registry.get_default_value<uint32_t>("monitor.stats.fd_num");
@@ -1913,8 +2327,21 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     ring_limit_per_interface =
         registry.get_default_value<int>("performance.rings.max_per_interface");
     ring_dev_mem_tx = registry.get_default_value<int>("performance.rings.tx.max_on_device_memory");
+    ring_dev_mem_tx_shared =
+        registry.get_default_value<bool>("performance.rings.tx.shared_on_device_memory");
+    ring_per_priority_tx = registry.get_default_value<bool>("performance.rings.tx.per_priority");
+    ring_bond_warm_standby =
+        registry.get_default_value<bool>("performance.rings.bond_warm_standby");
+    ring_numa_aware = registry.get_default_value<bool>("performance.rings.numa_aware");
+    ring_precreate_threads =
+        registry.get_default_value<uint32_t>("performance.rings.precreate_threads");
+    ring_core_pool_size = registry.get_default_value<uint32_t>("performance.rings.core_pool_size");
+    tx_sw_pacing = static_cast<sw_pacing_mode_t>(
+        registry.get_default_value<int>("performance.rings.tx.sw_pacing"));
 
     zc_cache_threshold = registry.get_default_value<int64_t>("core.syscall.sendfile_cache_limit");
+    zc_cache_max_files =
+        registry.get_default_value<uint32_t>("core.syscall.sendfile_cache_max_files");
     tx_buf_size = registry.get_default_value<uint32_t>("performance.buffers.tx.buf_size");
     tcp_nodelay_treshold =
         registry.get_default_value<uint32_t>("network.protocols.tcp.nodelay.byte_threshold");
@@ -1922,6 +2349,7 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     tx_num_wr_to_signal =
         registry.get_default_value<int>("performance.rings.tx.completion_batch_size");
     tx_max_inline = registry.get_default_value<uint32_t>("performance.rings.tx.max_inline_size");
+    tx_bf_burst = registry.get_default_value<uint32_t>("performance.rings.tx.bf_burst");
     tx_mc_loopback_default = registry.get_default_value<bool>("network.multicast.mc_loopback");
     tx_nonblocked_eagains =
         registry.get_default_value<bool>("performance.polling.nonblocking_eagain");
@@ -1936,6 +2364,10 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         registry.get_default_value<int>("performance.buffers.tcp_segments.ring_batch_size");
     tx_segs_pool_batch_tcp =
         registry.get_default_value<int>("performance.buffers.tcp_segments.pool_batch_size");
+    group_buf_cache_batch =
+        registry.get_default_value<int>("performance.buffers.group_cache.batch_size");
+    group_buf_cache_size =
+        registry.get_default_value<int>("performance.buffers.group_cache.max_size");
     rx_buf_size = registry.get_default_value<uint32_t>("performance.buffers.rx.buf_size");
 
     // TODO: No direct mapping for rx_bufs_batch
@@ -1944,6 +2376,10 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     rx_num_wr = registry.get_default_value<uint32_t>("performance.rings.rx.ring_elements_count");
     rx_num_wr_to_post_recv =
         registry.get_default_value<int>("performance.rings.rx.post_batch_size");
+    rx_num_wr_shared =
+        registry.get_default_value<uint32_t>("performance.rings.rx.shared_elements_count");
+    rx_hdr_split_size =
+        registry.get_default_value<uint32_t>("performance.rings.rx.header_split_size");
     rx_poll_num = registry.get_default_value<int>("performance.polling.blocking_rx_poll_usec");
     rx_poll_num_init =
         registry.get_default_value<int>("performance.polling.offload_transition_poll_count");
@@ -1953,12 +2389,25 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         registry.get_default_value<int>("network.timing.hw_ts_conversion"));
     rx_poll_yield_loops = registry.get_default_value<int>("performance.polling.yield_on_poll");
     select_handle_cpu_usage_stats = registry.get_default_value<bool>("monitor.stats.cpu_usage");
+    stats_latency_hist = registry.get_default_value<bool>("monitor.stats.latency_hist");
+    stats_lock_profiling = registry.get_default_value<bool>("monitor.stats.lock_profiling");
+    stats_trace_ring_events =
+        registry.get_default_value<uint32_t>("monitor.stats.trace_ring_events");
+    stats_mirror_ring_slots =
+        registry.get_default_value<uint32_t>("monitor.stats.mirror_ring_slots");
     rx_ready_byte_min_limit =
         registry.get_default_value<uint32_t>("performance.override_rcvbuf_limit");
     rx_prefetch_bytes =
         registry.get_default_value<uint32_t>("performance.buffers.rx.prefetch_size");
     rx_prefetch_bytes_before_poll =
         registry.get_default_value<uint32_t>("performance.buffers.rx.prefetch_before_poll");
+    rx_prefetch_depth = registry.get_default_value<uint32_t>("performance.buffers.rx.prefetch_depth");
+    rx_compact_threshold =
+        registry.get_default_value<uint32_t>("performance.buffers.rx.compact_threshold");
+    rx_compact_max_size =
+        registry.get_default_value<uint32_t>("performance.buffers.rx.compact_max_size");
+    rx_waitall_placement_min =
+        registry.get_default_value<uint32_t>("performance.buffers.rx.waitall_placement_min");
     rx_cq_drain_rate_nsec =
         registry.get_default_value<int>("performance.completion_queue.rx_drain_rate_nsec");
     rx_delta_tsc_between_cq_polls = 0;
@@ -1971,20 +2420,28 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         registry.get_default_value<uint32_t>("hardware_features.striding_rq.stride_size");
     strq_strides_compensation_level =
         registry.get_default_value<uint32_t>("performance.rings.rx.spare_strides");
+    strq_auto_geometry =
+        registry.get_default_value<bool>("hardware_features.striding_rq.auto_geometry");
 
     gro_streams_max = registry.get_default_value<int>("performance.max_gro_streams");
+    gro_flush_usec = registry.get_default_value<uint32_t>(CONFIG_VAR_GRO_FLUSH_USEC);
     disable_flow_tag =
         registry.get_default_value<bool>("performance.steering_rules.disable_flowtag");
 
     tcp_2t_rules = registry.get_default_value<bool>("performance.steering_rules.tcp.2t_rules");
     tcp_3t_rules = registry.get_default_value<bool>("performance.steering_rules.tcp.3t_rules");
+    tcp_deferred_rules_msec =
+        registry.get_default_value<int>("performance.steering_rules.tcp.deferred_rules_msec");
     udp_3t_rules = registry.get_default_value<bool>("performance.steering_rules.udp.3t_rules");
+    udp_reuseport_buckets =
+        registry.get_default_value<int>("performance.steering_rules.udp.reuseport_buckets");
     eth_mc_l2_only_rules =
         registry.get_default_value<bool>("performance.steering_rules.udp.only_mc_l2_rules");
     mc_force_flowtag =
         registry.get_default_value<bool>("network.multicast.mc_flowtag_acceleration");
 
     select_poll_num = registry.get_default_value<int>("performance.polling.iomux.poll_usec");
+    poll_adaptive = registry.get_default_value<bool>("performance.polling.adaptive");
     select_poll_os_ratio =
         registry.get_default_value<int>("performance.polling.iomux.poll_os_ratio");
     select_skip_os_fd_check =
@@ -2005,6 +2462,8 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         "frequency_msec");
     cq_aim_interrupts_rate_per_sec = registry.get_default_value<uint32_t>(
         "performance.completion_queue.interrupt_moderation.adaptive_interrupt_per_sec");
+    cq_aim_target_latency_usec = registry.get_default_value<uint32_t>(
+        "performance.completion_queue.interrupt_moderation.adaptive_target_latency_usec");
 
     cq_poll_batch_max =
         registry.get_default_value<uint32_t>("performance.polling.max_rx_poll_batch");
@@ -2015,6 +2474,21 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     cq_keep_qp_full = registry.get_default_value<bool>("performance.completion_queue.keep_full");
     max_tso_sz = registry.get_default_value<int64_t>("hardware_features.tcp.tso.max_size");
     worker_threads = registry.get_default_value<uint16_t>("performance.threading.worker_threads");
+    worker_placement =
+        registry.get_default_value<uint32_t>("performance.threading.worker_placement");
+    worker_listen_buckets =
+        registry.get_default_value<uint32_t>("performance.threading.worker_listen_buckets");
+    worker_park_msec =
+        registry.get_default_value<uint32_t>("performance.threading.worker_park_msec");
+    worker_idle_pause_usec =
+        registry.get_default_value<uint32_t>("performance.threading.worker_idle_pause_usec");
+    worker_idle_block_usec =
+        registry.get_default_value<uint32_t>("performance.threading.worker_idle_block_usec");
+    strncpy(worker_affinity_str,
+            registry.get_default_value<std::string>("performance.threading.worker_cpu_affinity")
+                .c_str(),
+            sizeof(worker_affinity_str) - 1);
+    CPU_ZERO(&worker_affinity);
     offloaded_sockets =
         registry.get_default_value<bool>("acceleration_control.default_acceleration");
     timer_resolution_msec =
@@ -2026,6 +2500,23 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         registry.get_default_value<int>("network.protocols.tcp.timestamps"));
     tcp_nodelay = registry.get_default_value<bool>("network.protocols.tcp.nodelay.enable");
     tcp_quickack = registry.get_default_value<bool>("network.protocols.tcp.quickack");
+    tcp_sack = registry.get_default_value<bool>("network.protocols.tcp.sack");
+    tcp_ecn = registry.get_default_value<bool>("network.protocols.tcp.ecn");
+    tcp_rack = registry.get_default_value<bool>("network.protocols.tcp.rack");
+    tcp_syncookies = registry.get_default_value<bool>("network.protocols.tcp.syncookies");
+    tcp_fastopen = registry.get_default_value<uint32_t>("network.protocols.tcp.fastopen");
+    tcp_timewait_compact =
+        registry.get_default_value<bool>("network.protocols.tcp.timewait_compact");
+    tcp_timer_park_idle = registry.get_default_value<bool>("network.protocols.tcp.timer_park_idle");
+    tcp_moderate_rcvbuf = registry.get_default_value<bool>("network.protocols.tcp.moderate_rcvbuf");
+    tcp_ack_coalesce = registry.get_default_value<bool>("network.protocols.tcp.ack_coalesce");
+    tcp_ack_adaptive = registry.get_default_value<bool>("network.protocols.tcp.ack_adaptive");
+    tcp_cork_timeout_msec =
+        registry.get_default_value<uint32_t>("network.protocols.tcp.cork_timeout_msec");
+    tcp_mtu_probing = registry.get_default_value<bool>("network.protocols.tcp.mtu_probing");
+    udp_dst_cache_size =
+        registry.get_default_value<uint32_t>("network.protocols.udp.dst_cache_size");
+    path_cache_size = registry.get_default_value<uint32_t>("network.protocols.ip.path_cache_size");
     tcp_push_flag = registry.get_default_value<bool>("network.protocols.tcp.push");
     // Exception_handling is handled by its CTOR
     avoid_sys_calls_on_tcp_fd = registry.get_default_value<bool>("core.syscall.avoid_ctl_syscalls");
@@ -2042,7 +2533,22 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     memory_limit_user = registry.get_default_value<int64_t>("core.resources.external_memory_limit");
     heap_metadata_block =
         registry.get_default_value<int64_t>("core.resources.heap_metadata_block_size");
+    buffer_pool_shrink_msec =
+        registry.get_default_value<uint32_t>("core.resources.buffer_pool_shrink_msec");
+    rx_pool_low_watermark =
+        registry.get_default_value<uint32_t>("core.resources.rx_pool_low_watermark");
+    rx_socket_bufs_max = registry.get_default_value<uint32_t>("core.resources.rx_socket_bufs_max");
     hugepage_size = registry.get_default_value<int64_t>("core.resources.hugepages.size");
+    hugepage_prefault_threads =
+        registry.get_default_value<uint32_t>("core.resources.hugepages.prefault_threads");
+    memset(hugepage_persistent_file, 0, sizeof(hugepage_persistent_file));
+    strncpy(hugepage_persistent_file,
+            registry.get_default_value<std::string>("core.resources.hugepages.persistent_file")
+                .c_str(),
+            sizeof(hugepage_persistent_file) - 1);
+    hugepage_fork_slices =
+        registry.get_default_value<uint32_t>("core.resources.hugepages.fork_slices");
+    hugepage_queues = registry.get_default_value<bool>("core.resources.hugepages.queues");
     enable_tso = static_cast<decltype(enable_tso)>(
         registry.get_default_value<int>("hardware_features.tcp.tso.enable"));
 #ifdef DEFINED_UTLS
@@ -2054,9 +2560,17 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
         registry.get_default_value<int>("hardware_features.tcp.tls_offload.dek_cache_max_size");
     utls_low_wmark_dek_cache_size =
         registry.get_default_value<int>("hardware_features.tcp.tls_offload.dek_cache_min_size");
+    utls_dek_pool_size =
+        registry.get_default_value<int>("hardware_features.tcp.tls_offload.dek_pool_size");
+    utls_tx_coalesce_size =
+        registry.get_default_value<int>("hardware_features.tcp.tls_offload.tx_coalesce_size");
 #endif /* DEFINED_UTLS */
     enable_lro = static_cast<decltype(enable_lro)>(
         registry.get_default_value<int>("hardware_features.tcp.lro"));
+    enable_mpwqe = registry.get_default_value<bool>("hardware_features.mpwqe.enable");
+    mpwqe_max_pkt_size = registry.get_default_value<int>("hardware_features.mpwqe.max_pkt_size");
+    rx_cqe_compression = registry.get_default_value<bool>("hardware_features.rx_cqe_compression");
+    implicit_odp = registry.get_default_value<bool>("hardware_features.implicit_odp");
     handle_fork = registry.get_default_value<bool>("core.syscall.fork_support");
     close_on_dup2 = registry.get_default_value<bool>("core.syscall.dup2_close_fd");
     mtu = registry.get_default_value<uint32_t>("network.protocols.ip.mtu");
@@ -2078,12 +2592,20 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     lwip_cc_algo_mod =
         registry.get_default_value<uint32_t>("network.protocols.tcp.congestion_control");
     mce_spec = static_cast<decltype(mce_spec)>(registry.get_default_value<int>("profiles.spec"));
+    auto_profile = option_auto_profile::from_int(
+        registry.get_default_value<int>(CONFIG_VAR_AUTO_PROFILE), MCE_DEFAULT_AUTO_PROFILE);
+    memset(&auto_profile_hw, 0, sizeof(auto_profile_hw));
 
     neigh_num_err_retries =
         registry.get_default_value<uint32_t>("network.neighbor.errors_before_reset");
     neigh_uc_arp_quata = registry.get_default_value<uint32_t>("network.neighbor.arp.uc_retries");
     neigh_wait_till_send_arp_msec =
         registry.get_default_value<uint32_t>("network.neighbor.arp.uc_delay_msec");
+    neigh_refresh_msec = registry.get_default_value<uint32_t>("network.neighbor.refresh_msec");
+    memset(neigh_preresolve, 0, sizeof(neigh_preresolve));
+    strncpy(neigh_preresolve,
+            registry.get_default_value<std::string>("network.neighbor.preresolve").c_str(),
+            sizeof(neigh_preresolve) - 1);
     timer_netlink_update_msec =
         registry.get_default_value<uint32_t>("network.neighbor.update_interval_msec");
 
@@ -2092,6 +2614,10 @@ void mce_sys_var::initialize_base_variables(const config_registry &registry)
     rx_poll_on_tx_tcp = registry.get_default_value<bool>("performance.polling.rx_poll_on_tx_tcp");
     rx_cq_wait_ctrl = registry.get_default_value<bool>("performance.polling.rx_cq_wait_ctrl");
     tcp_send_buffer_size = registry.get_default_value<uint32_t>("network.protocols.tcp.wmem");
+    tcp_send_buffer_autotune_limit =
+        registry.get_default_value<int64_t>("network.protocols.tcp.wmem_autotune_limit");
+    tcp_socket_pool_size =
+        registry.get_default_value<uint32_t>("network.protocols.tcp.socket_pool_size");
     skip_poll_in_rx = static_cast<skip_poll_in_rx_t>(
         registry.get_default_value<int>("performance.polling.skip_cq_on_rx"));
     multilock = registry.get_default_value<bool>("performance.threading.mutex_over_spinlock")
@@ -2120,10 +2646,41 @@ void mce_sys_var::configure_striding_rq(const config_registry &registry)
     }
 }
 
+void mce_sys_var::configure_worker_affinity()
+{
+    // Value of "-1" means the worker threads inherit the affinity of the creating thread
+    CPU_ZERO(&worker_affinity);
+    if (strcmp(worker_affinity_str, "-1") != 0 &&
+        env_to_cpuset(worker_affinity_str, &worker_affinity)) {
+        vlog_printf(VLOG_WARNING, "Failed to set worker threads affinity: %s... ignoring it.\n",
+                    worker_affinity_str);
+        CPU_ZERO(&worker_affinity);
+    }
+}
+
 void mce_sys_var::configure_running_mode(const config_registry &registry)
 {
     set_value_from_registry_if_exists(worker_threads, "performance.threading.worker_threads",
                                       registry);
+    set_value_from_registry_if_exists(worker_placement, "performance.threading.worker_placement",
+                                      registry);
+    set_value_from_registry_if_exists(worker_listen_buckets,
+                                      "performance.threading.worker_listen_buckets", registry);
+    set_value_from_registry_if_exists(worker_park_msec, "performance.threading.worker_park_msec",
+                                      registry);
+    set_value_from_registry_if_exists(worker_idle_pause_usec,
+                                      "performance.threading.worker_idle_pause_usec", registry);
+    set_value_from_registry_if_exists(worker_idle_block_usec,
+                                      "performance.threading.worker_idle_block_usec", registry);
+    if (registry.value_exists("performance.threading.worker_cpu_affinity")) {
+        int n = snprintf(
+            worker_affinity_str, sizeof(worker_affinity_str), "%s",
+            registry.get_value<std::string>("performance.threading.worker_cpu_affinity").c_str());
+        if (unlikely(((int)sizeof(worker_affinity_str) < n) || (n < 0))) {
+            vlog_printf(VLOG_WARNING, "Failed to process: %s.\n", SYS_VAR_WORKER_AFFINITY);
+        }
+    }
+    configure_worker_affinity();
     if (worker_threads > 0) {
         tx_buf_size = 256U * 1024U;
         tx_bufs_batch_tcp = 1;
@@ -2133,6 +2690,10 @@ void mce_sys_var::configure_running_mode(const config_registry &registry)
 void mce_sys_var::detect_application_profile(const config_registry &registry)
 {
     set_value_from_registry_if_exists(mce_spec, "profiles.spec", registry);
+    if (registry.value_exists(CONFIG_VAR_AUTO_PROFILE)) {
+        auto_profile = option_auto_profile::from_int(
+            registry.get_value<int>(CONFIG_VAR_AUTO_PROFILE), MCE_DEFAULT_AUTO_PROFILE);
+    }
 
     /*
      * Check for specific application configuration first. We can make decisions
@@ -2309,6 +2870,114 @@ void mce_sys_var::apply_nvme_bf3_profile()
     tcp_nodelay = true;
 }
 
+void mce_sys_var::read_auto_profile_hw()
+{
+    glob_t paths;
+
+    memset(&auto_profile_hw, 0, sizeof(auto_profile_hw));
+    auto_profile_hw.cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (!glob("/sys/devices/system/node/node[0-9]*", 0, nullptr, &paths)) {
+        auto_profile_hw.numa_nodes = static_cast<int>(paths.gl_pathc);
+        globfree(&paths);
+    }
+
+    // The devices aren't open yet, the ports are taken from the sysfs of the RDMA devices
+    if (!glob("/sys/class/infiniband/*/ports/*/state", 0, nullptr, &paths)) {
+        for (size_t i = 0; i < paths.gl_pathc; ++i) {
+            // The state is "4: ACTIVE" and the rate "100 Gb/sec (4X EDR)"
+            if (read_file_to_int(paths.gl_pathv[i], 0, VLOG_DEBUG) != IBV_PORT_ACTIVE) {
+                continue;
+            }
+            std::string rate_path(paths.gl_pathv[i]);
+            rate_path.replace(rate_path.rfind("state"), strlen("state"), "rate");
+            int rate = read_file_to_int(rate_path.c_str(), 0, VLOG_DEBUG);
+            ++auto_profile_hw.ports;
+            auto_profile_hw.max_rate_gbps =
+                std::max(auto_profile_hw.max_rate_gbps, static_cast<uint32_t>(std::max(rate, 0)));
+        }
+        globfree(&paths);
+    }
+
+    if (!glob("/sys/kernel/mm/hugepages/hugepages-*kB/free_hugepages", 0, nullptr, &paths)) {
+        for (size_t i = 0; i < paths.gl_pathc; ++i) {
+            size_t page_kb = 0U;
+            int pages = read_file_to_int(paths.gl_pathv[i], 0, VLOG_DEBUG);
+            if (pages > 0 &&
+                sscanf(paths.gl_pathv[i], "/sys/kernel/mm/hugepages/hugepages-%zukB", &page_kb) ==
+                    1) {
+                auto_profile_hw.hugepages_free += static_cast<size_t>(pages) * page_kb * 1024U;
+            }
+        }
+        globfree(&paths);
+    }
+}
+
+/*
+ * Derives the parameters from the hardware for the goal. It is applied over the defaults like
+ * the spec profiles, so the parameters which are set explicitly still take precedence.
+ */
+void mce_sys_var::apply_auto_profile()
+{
+    if (auto_profile == option_auto_profile::NONE) {
+        return;
+    }
+    if (mce_spec != MCE_SPEC_NONE) {
+        vlog_printf(VLOG_WARNING, "%s is ignored, the %s profile is used\n", SYS_VAR_AUTO_PROFILE,
+                    xlio_spec::to_str(static_cast<xlio_spec_t>(mce_spec)));
+        auto_profile = option_auto_profile::NONE;
+        return;
+    }
+
+    read_auto_profile_hw();
+    const bool fast_link = auto_profile_hw.max_rate_gbps >= 100U;
+    const size_t ports = static_cast<size_t>(std::max(auto_profile_hw.ports, 1));
+
+    switch (auto_profile) {
+    case option_auto_profile::LATENCY:
+        apply_latency_profile();
+        // The moderation delays the completions
+        cq_moderation_enable = false;
+        break;
+
+    case option_auto_profile::THROUGHPUT:
+        enable_tso = option_3::ON;
+        enable_lro = option_3::ON;
+        cq_moderation_enable = true;
+        // Deeper RX queues absorb the bursts of the 100G+ links between the polls
+        if (enable_striding_rq && fast_link) {
+            strq_stride_num_per_rwqe = 8192U;
+        }
+        memory_limit = std::max<size_t>(memory_limit, ports * (fast_link ? 2048LU : 1024LU) *
+                                            1024U * 1024U);
+        break;
+
+    case option_auto_profile::MEMORY:
+        // A ring per interface instead of per thread, with short queues
+        ring_allocation_logic_tx = RING_LOGIC_PER_INTERFACE;
+        ring_allocation_logic_rx = RING_LOGIC_PER_INTERFACE;
+        tx_num_wr = 1024U;
+        if (enable_striding_rq) {
+            rx_num_wr = 16U;
+            strq_stride_num_per_rwqe = STRQ_MIN_STRIDES_NUM;
+        } else {
+            rx_num_wr = 1024U;
+            rx_num_wr_to_post_recv = 64U;
+        }
+        memory_limit = ports * 256LU * 1024U * 1024U;
+        break;
+
+    case option_auto_profile::NONE:
+    default:
+        break;
+    }
+
+    // A hugepages allocation which can't succeed only adds a warning and a fallback
+    if (!auto_profile_hw.hugepages_free) {
+        mem_alloc_type = option_alloc_type::ANON;
+    }
+}
+
 void mce_sys_var::configure_monitor(const config_registry &registry)
 {
     if (registry.value_exists("monitor.exit_report")) {
@@ -2359,6 +3028,10 @@ void mce_sys_var::configure_monitor(const config_registry &registry)
 
     set_value_from_registry_if_exists(log_colors, "monitor.log.colors", registry);
 
+    set_value_from_registry_if_exists(log_async, "monitor.log.async", registry);
+
+    set_value_from_registry_if_exists(log_rate_limit, "monitor.log.rate_limit", registry);
+
     if (registry.value_exists("acceleration_control.app_id")) {
         read_env_variable_with_pid(
             app_id, sizeof(app_id),
@@ -2382,11 +3055,16 @@ void mce_sys_var::configure_buffer_allocation(const config_registry &registry)
     read_strq_strides_num(registry);
     read_strq_stride_size_bytes(registry);
 
+    set_value_from_registry_if_exists(strq_auto_geometry,
+                                      "hardware_features.striding_rq.auto_geometry", registry);
+
     set_value_from_registry_if_exists(strq_strides_compensation_level,
                                       "performance.rings.rx.spare_strides", registry);
 
     set_value_from_registry_if_exists(zc_cache_threshold, "core.syscall.sendfile_cache_limit",
                                       registry);
+    set_value_from_registry_if_exists(zc_cache_max_files, "core.syscall.sendfile_cache_max_files",
+                                      registry);
 
     set_value_from_registry_if_exists(tx_buf_size, "performance.buffers.tx.buf_size", registry);
 
@@ -2406,6 +3084,8 @@ void mce_sys_var::configure_buffer_allocation(const config_registry &registry)
     set_value_from_registry_if_exists(tx_max_inline, "performance.rings.tx.max_inline_size",
                                       registry);
 
+    set_value_from_registry_if_exists(tx_bf_burst, "performance.rings.tx.bf_burst", registry);
+
     set_value_from_registry_if_exists(tx_mc_loopback_default, "network.multicast.mc_loopback",
                                       registry);
 
@@ -2426,6 +3106,12 @@ void mce_sys_var::configure_buffer_allocation(const config_registry &registry)
 
     set_value_from_registry_if_exists(tx_segs_pool_batch_tcp,
                                       "performance.buffers.tcp_segments.pool_batch_size", registry);
+
+    set_value_from_registry_if_exists(group_buf_cache_batch,
+                                      "performance.buffers.group_cache.batch_size", registry);
+
+    set_value_from_registry_if_exists(group_buf_cache_size,
+                                      "performance.buffers.group_cache.max_size", registry);
 }
 
 void mce_sys_var::configure_tcp_parameters(const config_registry &registry)
@@ -2447,6 +3133,25 @@ void mce_sys_var::configure_tcp_parameters(const config_registry &registry)
 
     set_value_from_registry_if_exists(ring_dev_mem_tx, "performance.rings.tx.max_on_device_memory",
                                       registry);
+
+    set_value_from_registry_if_exists(ring_dev_mem_tx_shared,
+                                      "performance.rings.tx.shared_on_device_memory", registry);
+
+    set_value_from_registry_if_exists(ring_per_priority_tx, "performance.rings.tx.per_priority",
+                                      registry);
+
+    set_value_from_registry_if_exists(ring_bond_warm_standby,
+                                      "performance.rings.bond_warm_standby", registry);
+
+    set_value_from_registry_if_exists(ring_numa_aware, "performance.rings.numa_aware", registry);
+
+    set_value_from_registry_if_exists(ring_precreate_threads, "performance.rings.precreate_threads",
+                                      registry);
+
+    set_value_from_registry_if_exists(ring_core_pool_size, "performance.rings.core_pool_size",
+                                      registry);
+
+    set_value_from_registry_if_exists(tx_sw_pacing, "performance.rings.tx.sw_pacing", registry);
 }
 
 void mce_sys_var::configure_buffer_sizes(const config_registry &registry)
@@ -2472,6 +3177,13 @@ void mce_sys_var::configure_buffer_sizes(const config_registry &registry)
     if (rx_num_wr <= (rx_num_wr_to_post_recv * 2)) {
         rx_num_wr = rx_num_wr_to_post_recv * 2;
     }
+
+    set_value_from_registry_if_exists(rx_num_wr_shared,
+                                      "performance.rings.rx.shared_elements_count", registry);
+
+    set_value_from_registry_if_exists(rx_hdr_split_size, "performance.rings.rx.header_split_size",
+                                      registry);
+    validate_rx_hdr_split_size();
 }
 
 void mce_sys_var::configure_polling_mechanism(const config_registry &registry)
@@ -2500,6 +3212,16 @@ void mce_sys_var::configure_polling_mechanism(const config_registry &registry)
     set_value_from_registry_if_exists(select_handle_cpu_usage_stats, "monitor.stats.cpu_usage",
                                       registry);
 
+    set_value_from_registry_if_exists(stats_latency_hist, "monitor.stats.latency_hist", registry);
+    set_value_from_registry_if_exists(stats_lock_profiling, "monitor.stats.lock_profiling",
+                                      registry);
+    set_value_from_registry_if_exists(stats_trace_ring_events, "monitor.stats.trace_ring_events",
+                                      registry);
+    stats_trace_ring_events = std::min(stats_trace_ring_events, MAX_STATS_TRACE_RING_EVENTS);
+    set_value_from_registry_if_exists(stats_mirror_ring_slots, "monitor.stats.mirror_ring_slots",
+                                      registry);
+    stats_mirror_ring_slots = std::min(stats_mirror_ring_slots, MAX_STATS_MIRROR_RING_SLOTS);
+
     set_value_from_registry_if_exists(rx_ready_byte_min_limit, "performance.override_rcvbuf_limit",
                                       registry);
 
@@ -2509,6 +3231,15 @@ void mce_sys_var::configure_polling_mechanism(const config_registry &registry)
     set_value_from_registry_if_exists(rx_prefetch_bytes_before_poll,
                                       "performance.buffers.rx.prefetch_before_poll", registry);
 
+    set_value_from_registry_if_exists(rx_prefetch_depth, "performance.buffers.rx.prefetch_depth",
+                                      registry);
+    set_value_from_registry_if_exists(rx_compact_threshold,
+                                      "performance.buffers.rx.compact_threshold", registry);
+    set_value_from_registry_if_exists(rx_compact_max_size,
+                                      "performance.buffers.rx.compact_max_size", registry);
+    set_value_from_registry_if_exists(rx_waitall_placement_min,
+                                      "performance.buffers.rx.waitall_placement_min", registry);
+
     set_value_from_registry_if_exists(rx_cq_drain_rate_nsec,
                                       "performance.completion_queue.rx_drain_rate_nsec", registry);
 
@@ -2517,6 +3248,7 @@ void mce_sys_var::configure_polling_mechanism(const config_registry &registry)
     rx_delta_tsc_between_cq_polls = tsc_per_second * rx_cq_drain_rate_nsec / NSEC_PER_SEC;
 
     set_value_from_registry_if_exists(gro_streams_max, "performance.max_gro_streams", registry);
+    set_value_from_registry_if_exists(gro_flush_usec, CONFIG_VAR_GRO_FLUSH_USEC, registry);
 }
 
 void mce_sys_var::configure_completion_queue(const config_registry &registry)
@@ -2527,9 +3259,16 @@ void mce_sys_var::configure_completion_queue(const config_registry &registry)
     set_value_from_registry_if_exists(tcp_3t_rules, "performance.steering_rules.tcp.3t_rules",
                                       registry);
 
+    set_value_from_registry_if_exists(tcp_deferred_rules_msec,
+                                      "performance.steering_rules.tcp.deferred_rules_msec",
+                                      registry);
+
     set_value_from_registry_if_exists(udp_3t_rules, "performance.steering_rules.udp.3t_rules",
                                       registry);
 
+    set_value_from_registry_if_exists(udp_reuseport_buckets,
+                                      "performance.steering_rules.udp.reuseport_buckets", registry);
+
     set_value_from_registry_if_exists(udp_3t_rules, "performance.steering_rules.udp.3t_rules",
                                       registry);
 
@@ -2556,6 +3295,8 @@ void mce_sys_var::configure_completion_queue(const config_registry &registry)
     set_value_from_registry_if_exists(select_poll_num, "performance.polling.iomux.poll_usec",
                                       registry);
 
+    set_value_from_registry_if_exists(poll_adaptive, "performance.polling.adaptive", registry);
+
     set_value_from_registry_if_exists(select_poll_os_ratio,
                                       "performance.polling.iomux.poll_os_ratio", registry);
 
@@ -2613,6 +3354,11 @@ void mce_sys_var::configure_completion_queue(const config_registry &registry)
                                       "adaptive_interrupt_per_sec",
                                       registry);
 
+    set_value_from_registry_if_exists(cq_aim_target_latency_usec,
+                                      "performance.completion_queue.interrupt_moderation."
+                                      "adaptive_target_latency_usec",
+                                      registry);
+
 #else
     if (registry.value_exists("performance.completion_queue.interrupt_moderation.enable")) {
         vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
@@ -2645,6 +3391,11 @@ void mce_sys_var::configure_completion_queue(const config_registry &registry)
         vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
                     SYS_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC);
     }
+    if (registry.value_exists("performance.completion_queue.interrupt_moderation."
+                              "adaptive_target_latency_usec")) {
+        vlog_printf(VLOG_WARNING, "'%s' is not supported on this environment\n",
+                    SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC);
+    }
 #endif /* DEFINED_IBV_CQ_ATTR_MODERATE */
 
     set_value_from_registry_if_exists(cq_poll_batch_max, "performance.polling.max_rx_poll_batch",
@@ -2728,6 +3479,44 @@ void mce_sys_var::configure_memory_limits(const config_registry &registry)
 
     set_value_from_registry_if_exists(tcp_quickack, "network.protocols.tcp.quickack", registry);
 
+    set_value_from_registry_if_exists(tcp_sack, "network.protocols.tcp.sack", registry);
+
+    set_value_from_registry_if_exists(tcp_ecn, "network.protocols.tcp.ecn", registry);
+
+    set_value_from_registry_if_exists(tcp_rack, "network.protocols.tcp.rack", registry);
+
+    set_value_from_registry_if_exists(tcp_syncookies, "network.protocols.tcp.syncookies",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_fastopen, "network.protocols.tcp.fastopen", registry);
+
+    set_value_from_registry_if_exists(tcp_timewait_compact, "network.protocols.tcp.timewait_compact",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_timer_park_idle, "network.protocols.tcp.timer_park_idle",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_moderate_rcvbuf, "network.protocols.tcp.moderate_rcvbuf",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_ack_coalesce, "network.protocols.tcp.ack_coalesce",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_ack_adaptive, "network.protocols.tcp.ack_adaptive",
+                                      registry);
+
+    set_value_from_registry_if_exists(tcp_cork_timeout_msec,
+                                      "network.protocols.tcp.cork_timeout_msec", registry);
+
+    set_value_from_registry_if_exists(tcp_mtu_probing, "network.protocols.tcp.mtu_probing",
+                                      registry);
+
+    set_value_from_registry_if_exists(udp_dst_cache_size, "network.protocols.udp.dst_cache_size",
+                                      registry);
+
+    set_value_from_registry_if_exists(path_cache_size, "network.protocols.ip.path_cache_size",
+                                      registry);
+
     set_value_from_registry_if_exists(tcp_push_flag, "network.protocols.tcp.push", registry);
 
     // TODO: this should be replaced by calling "exception_handling.init()" that
@@ -2805,6 +3594,15 @@ void mce_sys_var::configure_network_protocols(const config_registry &registry)
     set_value_from_registry_if_exists(neigh_uc_arp_quata, "network.neighbor.arp.uc_retries",
                                       registry);
 
+    set_value_from_registry_if_exists(neigh_refresh_msec, "network.neighbor.refresh_msec",
+                                      registry);
+
+    if (registry.value_exists("network.neighbor.preresolve")) {
+        strncpy(neigh_preresolve,
+                registry.get_value<std::string>("network.neighbor.preresolve").c_str(),
+                sizeof(neigh_preresolve) - 1);
+    }
+
     if (registry.value_exists("core.resources.hugepages.enable")) {
         // TODO: simulate (mem_alloc_type -> bool) and not as we do it now - (bool ->
         // mem_alloc_type).
@@ -2825,6 +3623,12 @@ void mce_sys_var::configure_network_protocols(const config_registry &registry)
         heap_metadata_block = registry.get_value<int64_t>("core.resources.heap_metadata_block_size")
             ?: MCE_DEFAULT_HEAP_METADATA_BLOCK;
     }
+    set_value_from_registry_if_exists(buffer_pool_shrink_msec,
+                                      "core.resources.buffer_pool_shrink_msec", registry);
+    set_value_from_registry_if_exists(rx_pool_low_watermark,
+                                      "core.resources.rx_pool_low_watermark", registry);
+    set_value_from_registry_if_exists(rx_socket_bufs_max, "core.resources.rx_socket_bufs_max",
+                                      registry);
     if (registry.value_exists("core.resources.hugepages.size")) {
         hugepage_size = registry.get_value<int64_t>("core.resources.hugepages.size");
         if (hugepage_size & (hugepage_size - 1)) {
@@ -2838,6 +3642,17 @@ void mce_sys_var::configure_network_protocols(const config_registry &registry)
             hugepage_size = MCE_DEFAULT_HUGEPAGE_SIZE;
         }
     }
+    set_value_from_registry_if_exists(hugepage_prefault_threads,
+                                      "core.resources.hugepages.prefault_threads", registry);
+    if (registry.value_exists("core.resources.hugepages.persistent_file")) {
+        strncpy(hugepage_persistent_file,
+                registry.get_value<std::string>("core.resources.hugepages.persistent_file").c_str(),
+                sizeof(hugepage_persistent_file) - 1);
+    }
+    set_value_from_registry_if_exists(hugepage_fork_slices, "core.resources.hugepages.fork_slices",
+                                      registry);
+    set_value_from_registry_if_exists(hugepage_queues, "core.resources.hugepages.queues",
+                                      registry);
 }
 
 void mce_sys_var::configure_application_specifics(const config_registry &registry)
@@ -2873,12 +3688,33 @@ void mce_sys_var::configure_application_specifics(const config_registry &registr
             utls_low_wmark_dek_cache_size = utls_high_wmark_dek_cache_size / 2U;
         }
     }
+
+    if (registry.value_exists("hardware_features.tcp.tls_offload.dek_pool_size")) {
+        int temp = registry.get_value<int>("hardware_features.tcp.tls_offload.dek_pool_size");
+        utls_dek_pool_size = (temp >= 0 ? static_cast<size_t>(temp) : 0);
+    }
+
+    if (registry.value_exists("hardware_features.tcp.tls_offload.tx_coalesce_size")) {
+        int temp = registry.get_value<int>("hardware_features.tcp.tls_offload.tx_coalesce_size");
+        utls_tx_coalesce_size = static_cast<uint32_t>(
+            std::min(std::max(temp, 0), static_cast<int>(MCE_MAX_UTLS_TX_COALESCE_SIZE)));
+    }
 #endif /* DEFINED_UTLS */
     if (registry.value_exists("hardware_features.tcp.lro")) {
         enable_lro =
             static_cast<decltype(enable_lro)>(registry.get_value<int>("hardware_features.tcp.lro"));
     }
 
+    set_value_from_registry_if_exists(enable_mpwqe, "hardware_features.mpwqe.enable", registry);
+
+    set_value_from_registry_if_exists(mpwqe_max_pkt_size, "hardware_features.mpwqe.max_pkt_size",
+                                      registry);
+
+    set_value_from_registry_if_exists(rx_cqe_compression, "hardware_features.rx_cqe_compression",
+                                      registry);
+
+    set_value_from_registry_if_exists(implicit_odp, "hardware_features.implicit_odp", registry);
+
     set_value_from_registry_if_exists(close_on_dup2, "core.syscall.dup2_close_fd", registry);
 
     set_value_from_registry_if_exists(mtu, "network.protocols.ip.mtu", registry);
@@ -2921,6 +3757,10 @@ void mce_sys_var::configure_syscall_behavior(const config_registry &registry)
 void mce_sys_var::configure_network_timing(const config_registry &registry)
 {
     set_value_from_registry_if_exists(tcp_send_buffer_size, "network.protocols.tcp.wmem", registry);
+    set_value_from_registry_if_exists(tcp_send_buffer_autotune_limit,
+                                      "network.protocols.tcp.wmem_autotune_limit", registry);
+    set_value_from_registry_if_exists(tcp_socket_pool_size, "network.protocols.tcp.socket_pool_size",
+                                      registry);
 
     if (registry.value_exists("performance.polling.skip_cq_on_rx")) {
         int temp = registry.get_value<int>("performance.polling.skip_cq_on_rx");
@@ -2958,6 +3798,7 @@ void mce_sys_var::apply_config_from_registry()
     configure_running_mode(registry);
     detect_application_profile(registry);
     apply_spec_profile_optimizations();
+    apply_auto_profile();
 
     configure_monitor(registry);
     configure_buffer_allocation(registry);
@@ -3044,6 +3885,11 @@ void mce_sys_var::fixup_params()
         select_poll_num = -1;
         progress_engine_interval_msec = 0;
     }
+    if (udp_reuseport_buckets) {
+        udp_reuseport_buckets = align32pow2(
+            std::min<uint32_t>(udp_reuseport_buckets, MCE_MAX_UDP_REUSEPORT_BUCKETS));
+    }
+    g_hot_sys_var.update(*this);
 }
 
 void set_env_params()
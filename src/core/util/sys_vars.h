@@ -56,6 +56,7 @@ static inline bool is_ring_logic_valid(ring_logic_t logic)
     case RING_LOGIC_PER_THREAD:
     case RING_LOGIC_PER_CORE:
     case RING_LOGIC_PER_CORE_ATTACH_THREADS:
+    case RING_LOGIC_PER_CORE_POOL:
         return true;
     default:
         return false;
@@ -77,6 +78,8 @@ static inline const char *ring_logic_str(ring_logic_t logic)
         return "(Ring per core)";
     case RING_LOGIC_PER_CORE_ATTACH_THREADS:
         return "(Ring per core - attach threads)";
+    case RING_LOGIC_PER_CORE_POOL:
+        return "(Ring per core - bounded pool)";
     default:
         break;
     }
@@ -90,11 +93,20 @@ typedef enum {
     BUFFER_BATCHING_LAST,
 } buffer_batching_mode_t;
 
+typedef enum {
+    SW_PACING_DISABLE = 0,
+    SW_PACING_FALLBACK,
+    SW_PACING_ALWAYS,
+    SW_PACING_LAST,
+} sw_pacing_mode_t;
+
 // See ibv_transport_type for general verbs transport types
 typedef enum { XLIO_TRANSPORT_UNKNOWN = -1, XLIO_TRANSPORT_ETH } transport_type_t;
 
 typedef enum { APP_NONE, APP_NGINX, APP_ENVOY } app_type_t;
 
+typedef enum { WORKER_PLACEMENT_ROUND_ROBIN = 0, WORKER_PLACEMENT_LEAST_LOADED } worker_placement_t;
+
 static inline const char *priv_xlio_transport_type_str(transport_type_t transport_type)
 {
     BULLSEYE_EXCLUDE_BLOCK_START
@@ -183,6 +195,12 @@ typedef enum {
 OPTIONS_FROM_TO_STR_DEF;
 } // namespace option_alloc_type
 
+// The goal of the profile derived from the hardware at the startup
+namespace option_auto_profile {
+typedef enum { NONE = 0, LATENCY, THROUGHPUT, MEMORY } mode_t;
+OPTIONS_FROM_TO_STR_DEF;
+} // namespace option_auto_profile
+
 typedef enum {
     ALLOC_TYPE_ANON = option_alloc_type::ANON,
     ALLOC_TYPE_HUGEPAGES = option_alloc_type::HUGE,
@@ -312,6 +330,15 @@ public:
     char app_id[MAX_APP_ID_LENGHT];
 
     uint32_t mce_spec;
+    option_auto_profile::mode_t auto_profile;
+    // The machine as seen by the automatic profile
+    struct {
+        long cpus;
+        int numa_nodes;
+        int ports; // Active ports of the RDMA devices
+        uint32_t max_rate_gbps;
+        size_t hugepages_free; // Bytes
+    } auto_profile_hw;
 
     option_3::mode_t print_report;
     bool quick_start;
@@ -327,6 +354,8 @@ public:
     char service_notify_dir[PATH_MAX];
     bool service_enable;
     bool log_colors;
+    bool log_async;
+    uint32_t log_rate_limit;
     bool handle_sigintr;
     bool handle_segfault;
     uint32_t stats_fd_num_max;
@@ -338,13 +367,22 @@ public:
     int ring_migration_ratio_rx;
     int ring_limit_per_interface;
     int ring_dev_mem_tx;
+    bool ring_dev_mem_tx_shared;
+    bool ring_per_priority_tx;
+    bool ring_bond_warm_standby;
+    bool ring_numa_aware;
+    uint32_t ring_precreate_threads;
+    uint32_t ring_core_pool_size;
+    sw_pacing_mode_t tx_sw_pacing;
 
     size_t zc_cache_threshold;
+    uint32_t zc_cache_max_files;
     uint32_t tx_buf_size;
     uint32_t tcp_nodelay_treshold;
     uint32_t tx_num_wr;
     uint32_t tx_num_wr_to_signal;
     uint32_t tx_max_inline;
+    uint32_t tx_bf_burst;
     bool tx_mc_loopback_default;
     bool tx_nonblocked_eagains;
     uint32_t tx_prefetch_bytes;
@@ -355,6 +393,8 @@ public:
     uint32_t rx_buf_size;
     uint32_t rx_bufs_batch;
     uint32_t rx_num_wr;
+    uint32_t rx_num_wr_shared;
+    uint32_t rx_hdr_split_size;
     uint32_t rx_num_wr_to_post_recv;
     int32_t rx_poll_num;
     int32_t rx_poll_num_init;
@@ -364,6 +404,10 @@ public:
     uint32_t rx_ready_byte_min_limit;
     uint32_t rx_prefetch_bytes;
     uint32_t rx_prefetch_bytes_before_poll;
+    uint32_t rx_prefetch_depth;
+    uint32_t rx_compact_threshold;
+    uint32_t rx_compact_max_size;
+    uint32_t rx_waitall_placement_min;
     uint32_t rx_cq_drain_rate_nsec; // If enabled this will cause the Rx to drain
                                     // all wce in CQ before returning to user,
                                     // Else (Default: Disbaled) it will return
@@ -373,21 +417,30 @@ public:
     uint32_t strq_stride_num_per_rwqe;
     uint32_t strq_stride_size_bytes;
     uint32_t strq_strides_compensation_level;
+    bool strq_auto_geometry;
 
     uint32_t gro_streams_max;
+    uint32_t gro_flush_usec;
     bool disable_flow_tag;
 
     bool enable_striding_rq;
     bool tcp_2t_rules;
     bool tcp_3t_rules;
+    uint32_t tcp_deferred_rules_msec;
     bool udp_3t_rules;
+    uint32_t udp_reuseport_buckets;
     bool eth_mc_l2_only_rules;
     bool mc_force_flowtag;
 
     int32_t select_poll_num;
+    bool poll_adaptive;
     uint32_t select_poll_os_ratio;
     uint32_t select_skip_os_fd_check;
     bool select_handle_cpu_usage_stats;
+    bool stats_latency_hist;
+    bool stats_lock_profiling;
+    uint32_t stats_trace_ring_events;
+    uint32_t stats_mirror_ring_slots;
 
     bool cq_moderation_enable;
     uint32_t cq_moderation_count;
@@ -396,6 +449,7 @@ public:
     uint32_t cq_aim_max_period_usec;
     uint32_t cq_aim_interval_msec;
     uint32_t cq_aim_interrupts_rate_per_sec;
+    uint32_t cq_aim_target_latency_usec;
 
     uint32_t cq_poll_batch_max;
     uint32_t progress_engine_interval_msec;
@@ -406,12 +460,33 @@ public:
 
     bool offloaded_sockets;
     uint16_t worker_threads;
+    uint32_t worker_placement;
+    uint32_t worker_listen_buckets;
+    uint32_t worker_park_msec;
+    uint32_t worker_idle_pause_usec;
+    uint32_t worker_idle_block_usec;
+    char worker_affinity_str[FILENAME_MAX];
+    cpu_set_t worker_affinity;
     uint32_t timer_resolution_msec;
     uint32_t tcp_timer_resolution_msec;
     option_tcp_ctl_thread::mode_t tcp_ctl_thread;
     tcp_ts_opt_t tcp_ts_opt;
     bool tcp_nodelay;
     bool tcp_quickack;
+    bool tcp_sack;
+    bool tcp_ecn;
+    bool tcp_rack;
+    bool tcp_syncookies;
+    uint32_t tcp_fastopen;
+    bool tcp_timewait_compact;
+    bool tcp_timer_park_idle;
+    bool tcp_moderate_rcvbuf;
+    bool tcp_ack_coalesce;
+    bool tcp_ack_adaptive;
+    uint32_t tcp_cork_timeout_msec;
+    bool tcp_mtu_probing;
+    uint32_t udp_dst_cache_size;
+    uint32_t path_cache_size;
     bool tcp_push_flag;
     xlio_exception_handling exception_handling;
     bool avoid_sys_calls_on_tcp_fd;
@@ -422,7 +497,14 @@ public:
     size_t memory_limit;
     size_t memory_limit_user;
     size_t heap_metadata_block;
+    uint32_t buffer_pool_shrink_msec;
+    uint32_t rx_pool_low_watermark;
+    uint32_t rx_socket_bufs_max;
     size_t hugepage_size;
+    uint32_t hugepage_prefault_threads;
+    char hugepage_persistent_file[PATH_MAX];
+    uint32_t hugepage_fork_slices;
+    bool hugepage_queues;
     bool handle_fork;
     bool close_on_dup2;
     uint32_t mtu; /* effective MTU. If mtu==0 then auto calculate the MTU */
@@ -435,6 +517,10 @@ public:
     multilock_t multilock;
     option_3::mode_t enable_tso;
     option_3::mode_t enable_lro;
+    bool enable_mpwqe;
+    uint32_t mpwqe_max_pkt_size;
+    bool rx_cqe_compression;
+    bool implicit_odp;
     option_3::mode_t enable_strq_env;
 #ifdef DEFINED_UTLS
     bool enable_utls_rx;
@@ -445,6 +531,10 @@ public:
     // DEK cache size low-watermark. Min number of available DEKs required in the
     // cache to perform Crypto-Sync and reuse.
     size_t utls_low_wmark_dek_cache_size;
+    // DEKs created ahead per device and kept available by the internal thread.
+    size_t utls_dek_pool_size;
+    // Ultra API sends smaller than this are coalesced into TLS records of this size.
+    uint32_t utls_tx_coalesce_size;
 #endif /* DEFINED_UTLS */
     uint32_t timer_netlink_update_msec;
 
@@ -452,6 +542,8 @@ public:
     uint32_t neigh_uc_arp_quata;
     uint32_t neigh_wait_till_send_arp_msec;
     uint32_t neigh_num_err_retries;
+    uint32_t neigh_refresh_msec;
+    char neigh_preresolve[FILENAME_MAX];
 
     sysctl_reader_t &sysctl_reader;
     // Workaround for #3440429: postpone close(2) to the socket destructor, so the
@@ -475,11 +567,18 @@ public:
     } app;
 #endif
     uint32_t tcp_send_buffer_size;
+    size_t tcp_send_buffer_autotune_limit;
+    uint32_t tcp_socket_pool_size;
     uint32_t tx_segs_ring_batch_tcp;
     uint32_t tx_segs_pool_batch_tcp;
+    uint32_t group_buf_cache_batch;
+    uint32_t group_buf_cache_size;
     struct {
         alloc_t memalloc;
         free_t memfree;
+        // RX buffers allocator, falls back to memalloc/memfree
+        alloc_t rx_memalloc;
+        free_t rx_memfree;
     } user_alloc;
 
 private:
@@ -495,6 +594,8 @@ private:
     void apply_latency_profile();
     void apply_nginx_profile();
     void apply_nvme_bf3_profile();
+    void read_auto_profile_hw();
+    void apply_auto_profile();
     void configure_monitor(const config_registry &registry);
     void configure_buffer_allocation(const config_registry &registry);
     void configure_tcp_parameters(const config_registry &registry);
@@ -513,6 +614,7 @@ private:
     int list_to_cpuset(char *cpulist, cpu_set_t *cpu_set);
     int hex_to_cpuset(char *start, cpu_set_t *cpu_set);
     int env_to_cpuset(char *orig_start, cpu_set_t *cpu_set);
+    void configure_worker_affinity();
     void read_env_variable_with_pid(char *mce_sys_name, size_t mce_sys_max_size,
                                     const char *env_ptr);
     bool check_cpuinfo_flag(const char *flag);
@@ -523,6 +625,7 @@ private:
     void read_strq_stride_size_bytes(const config_registry &registry);
     void legacy_read_strq_strides_num();
     void legacy_read_strq_stride_size_bytes();
+    void validate_rx_hdr_split_size();
 
     // The configuration registry
     // Defined after all other members to not to disturb alignment and division to cache-lines
@@ -547,6 +650,35 @@ private:
 
 extern mce_sys_var &safe_mce_sys();
 
+/*
+ * The parameters read per packet or per poll loop, a copy of the mce_sys_var fields once the
+ * configuration is final. They share a single cache line, a read is a load of a global instead of
+ * the call of safe_mce_sys() and the access to a struct of several kilobytes. The changes of the
+ * runtime tuning are stored to both places.
+ */
+struct alignas(64) mce_hot_sys_var {
+    int32_t select_poll_num;
+    uint32_t select_poll_os_ratio;
+    uint32_t select_skip_os_fd_check;
+    uint32_t rx_poll_yield_loops;
+    uint32_t worker_placement;
+    option_tcp_ctl_thread::mode_t tcp_ctl_thread;
+    sw_pacing_mode_t tx_sw_pacing;
+    skip_poll_in_rx_t skip_poll_in_rx;
+    buffer_batching_mode_t buffer_batching_mode;
+    uint16_t worker_threads;
+    bool rx_cq_wait_ctrl;
+    bool avoid_sys_calls_on_tcp_fd;
+    bool handle_sigintr;
+
+    bool is_threads_mode() const { return worker_threads > 0; }
+    void update(const mce_sys_var &sys);
+};
+
+static_assert(sizeof(mce_hot_sys_var) == 64U, "The hot parameters must fit a cache line");
+
+extern mce_hot_sys_var g_hot_sys_var;
+
 /*
  * This block consists of library specific configuration
  * environment variables
@@ -565,6 +697,8 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_SERVICE_ENABLE      "XLIO_SERVICE_ENABLE"
 #define SYS_VAR_CONF_FILENAME       "XLIO_CONFIG_FILE"
 #define SYS_VAR_LOG_COLORS          "XLIO_LOG_COLORS"
+#define SYS_VAR_LOG_ASYNC           "XLIO_LOG_ASYNC"
+#define SYS_VAR_LOG_RATE_LIMIT      "XLIO_LOG_RATE_LIMIT"
 #define SYS_VAR_APPLICATION_ID      "XLIO_APPLICATION_ID"
 #define SYS_VAR_HANDLE_SIGINTR      "XLIO_HANDLE_SIGINTR"
 #define SYS_VAR_HANDLE_SIGSEGV      "XLIO_HANDLE_SIGSEGV"
@@ -577,13 +711,22 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_RING_MIGRATION_RATIO_RX  "XLIO_RING_MIGRATION_RATIO_RX"
 #define SYS_VAR_RING_LIMIT_PER_INTERFACE "XLIO_RING_LIMIT_PER_INTERFACE"
 #define SYS_VAR_RING_DEV_MEM_TX          "XLIO_RING_DEV_MEM_TX"
+#define SYS_VAR_RING_DEV_MEM_TX_SHARED   "XLIO_RING_DEV_MEM_TX_SHARED"
+#define SYS_VAR_RING_PER_PRIORITY_TX     "XLIO_RING_PER_PRIORITY_TX"
+#define SYS_VAR_RING_BOND_WARM_STANDBY   "XLIO_RING_BOND_WARM_STANDBY"
+#define SYS_VAR_RING_NUMA_AWARE          "XLIO_RING_NUMA_AWARE"
+#define SYS_VAR_RING_PRECREATE_THREADS   "XLIO_RING_PRECREATE_THREADS"
+#define SYS_VAR_RING_CORE_POOL_SIZE      "XLIO_RING_CORE_POOL_SIZE"
+#define SYS_VAR_TX_SW_PACING             "XLIO_TX_SW_PACING"
 
 #define SYS_VAR_ZC_CACHE_THRESHOLD    "XLIO_ZC_CACHE_THRESHOLD"
+#define SYS_VAR_ZC_CACHE_MAX_FILES    "XLIO_ZC_CACHE_MAX_FILES"
 #define SYS_VAR_TX_BUF_SIZE           "XLIO_TX_BUF_SIZE"
 #define SYS_VAR_TCP_NODELAY_TRESHOLD  "XLIO_TCP_NODELAY_TRESHOLD"
 #define SYS_VAR_TX_NUM_WRE            "XLIO_TX_WRE"
 #define SYS_VAR_TX_NUM_WRE_TO_SIGNAL  "XLIO_TX_WRE_BATCHING"
 #define SYS_VAR_TX_MAX_INLINE         "XLIO_TX_MAX_INLINE"
+#define SYS_VAR_TX_BF_BURST           "XLIO_TX_BF_BURST"
 #define SYS_VAR_TX_MC_LOOPBACK        "XLIO_TX_MC_LOOPBACK"
 #define SYS_VAR_TX_NONBLOCKED_EAGAINS "XLIO_TX_NONBLOCKED_EAGAINS"
 #define SYS_VAR_TX_PREFETCH_BYTES     "XLIO_TX_PREFETCH_BYTES"
@@ -594,10 +737,13 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_STRQ_NUM_STRIDES                "XLIO_STRQ_NUM_STRIDES"
 #define SYS_VAR_STRQ_STRIDE_SIZE_BYTES          "XLIO_STRQ_STRIDE_SIZE_BYTES"
 #define SYS_VAR_STRQ_STRIDES_COMPENSATION_LEVEL "XLIO_STRQ_STRIDES_COMPENSATION_LEVEL"
+#define SYS_VAR_STRQ_AUTO_GEOMETRY              "XLIO_STRQ_AUTO_GEOMETRY"
 
 #define SYS_VAR_RX_BUF_SIZE                   "XLIO_RX_BUF_SIZE"
 #define SYS_VAR_RX_NUM_WRE                    "XLIO_RX_WRE"
 #define SYS_VAR_RX_NUM_WRE_TO_POST_RECV       "XLIO_RX_WRE_BATCHING"
+#define SYS_VAR_RX_NUM_WRE_SHARED             "XLIO_RX_WRE_SHARED"
+#define SYS_VAR_RX_HDR_SPLIT_SIZE             "XLIO_RX_HDR_SPLIT_SIZE"
 #define SYS_VAR_RX_NUM_POLLS                  "XLIO_RX_POLL"
 #define SYS_VAR_RX_NUM_POLLS_INIT             "XLIO_RX_POLL_INIT"
 #define SYS_VAR_RX_UDP_POLL_OS_RATIO          "XLIO_RX_UDP_POLL_OS_RATIO"
@@ -606,19 +752,33 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_RX_BYTE_MIN_LIMIT             "XLIO_RX_BYTES_MIN"
 #define SYS_VAR_RX_PREFETCH_BYTES             "XLIO_RX_PREFETCH_BYTES"
 #define SYS_VAR_RX_PREFETCH_BYTES_BEFORE_POLL "XLIO_RX_PREFETCH_BYTES_BEFORE_POLL"
+#define SYS_VAR_RX_PREFETCH_DEPTH             "XLIO_RX_PREFETCH_DEPTH"
+#define SYS_VAR_RX_COMPACT_THRESHOLD          "XLIO_RX_COMPACT_THRESHOLD"
+#define SYS_VAR_RX_COMPACT_MAX_SIZE           "XLIO_RX_COMPACT_MAX_SIZE"
+#define SYS_VAR_RX_WAITALL_PLACEMENT_MIN      "XLIO_RX_WAITALL_PLACEMENT_MIN"
 #define SYS_VAR_RX_CQ_DRAIN_RATE_NSEC         "XLIO_RX_CQ_DRAIN_RATE_NSEC"
 #define SYS_VAR_GRO_STREAMS_MAX               "XLIO_GRO_STREAMS_MAX"
+#define SYS_VAR_GRO_FLUSH_USEC                "XLIO_GRO_FLUSH_USEC"
 #define SYS_VAR_DISABLE_FLOW_TAG              "XLIO_DISABLE_FLOW_TAG"
 #define SYS_VAR_TCP_2T_RULES                  "XLIO_TCP_2T_RULES"
 #define SYS_VAR_TCP_3T_RULES                  "XLIO_TCP_3T_RULES"
+#define SYS_VAR_TCP_DEFERRED_RULES_MSEC       "XLIO_TCP_DEFERRED_RULES_MSEC"
 #define SYS_VAR_UDP_3T_RULES                  "XLIO_UDP_3T_RULES"
+#define SYS_VAR_UDP_REUSEPORT_BUCKETS         "XLIO_UDP_REUSEPORT_BUCKETS"
 #define SYS_VAR_ETH_MC_L2_ONLY_RULES          "XLIO_ETH_MC_L2_ONLY_RULES"
 #define SYS_VAR_MC_FORCE_FLOWTAG              "XLIO_MC_FORCE_FLOWTAG"
 #define SYS_VAR_TX_SEGS_RING_BATCH_TCP        "XLIO_TX_SEGS_RING_BATCH_TCP"
 #define SYS_VAR_TX_SEGS_POOL_BATCH_TCP        "XLIO_TX_SEGS_POOL_BATCH_TCP"
+#define SYS_VAR_GROUP_BUF_CACHE_BATCH         "XLIO_GROUP_BUF_CACHE_BATCH"
+#define SYS_VAR_GROUP_BUF_CACHE_SIZE          "XLIO_GROUP_BUF_CACHE_SIZE"
 
 #define SYS_VAR_SELECT_CPU_USAGE_STATS "XLIO_CPU_USAGE_STATS"
+#define SYS_VAR_STATS_LATENCY_HIST     "XLIO_STATS_LATENCY_HIST"
+#define SYS_VAR_STATS_LOCK_PROFILING   "XLIO_STATS_LOCK_PROFILING"
+#define SYS_VAR_STATS_TRACE_RING_EVENTS "XLIO_STATS_TRACE_RING_EVENTS"
+#define SYS_VAR_STATS_MIRROR_RING_SLOTS "XLIO_STATS_MIRROR_RING_SLOTS"
 #define SYS_VAR_SELECT_NUM_POLLS       "XLIO_SELECT_POLL"
+#define SYS_VAR_POLL_ADAPTIVE          "XLIO_POLL_ADAPTIVE"
 #define SYS_VAR_SELECT_POLL_OS_RATIO   "XLIO_SELECT_POLL_OS_RATIO"
 #define SYS_VAR_SELECT_SKIP_OS         "XLIO_SELECT_SKIP_OS"
 
@@ -629,6 +789,7 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_CQ_AIM_MAX_PERIOD_USEC         "XLIO_CQ_AIM_MAX_PERIOD_USEC"
 #define SYS_VAR_CQ_AIM_INTERVAL_MSEC           "XLIO_CQ_AIM_INTERVAL_MSEC"
 #define SYS_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC "XLIO_CQ_AIM_INTERRUPTS_RATE_PER_SEC"
+#define SYS_VAR_CQ_AIM_TARGET_LATENCY_USEC     "XLIO_CQ_AIM_TARGET_LATENCY_USEC"
 
 #define SYS_VAR_CQ_POLL_BATCH_MAX         "XLIO_CQ_POLL_BATCH_MAX"
 #define SYS_VAR_PROGRESS_ENGINE_INTERVAL  "XLIO_PROGRESS_ENGINE_INTERVAL"
@@ -638,12 +799,32 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_MAX_TSO_SIZE              "XLIO_MAX_TSO_SIZE"
 #define SYS_VAR_OFFLOADED_SOCKETS         "XLIO_OFFLOADED_SOCKETS"
 #define SYS_VAR_WORKER_THREADS            "XLIO_WORKER_THREADS"
+#define SYS_VAR_WORKER_PLACEMENT          "XLIO_WORKER_THREADS_PLACEMENT"
+#define SYS_VAR_WORKER_LISTEN_BUCKETS     "XLIO_WORKER_THREADS_LISTEN_BUCKETS"
+#define SYS_VAR_WORKER_AFFINITY           "XLIO_WORKER_THREADS_AFFINITY"
+#define SYS_VAR_WORKER_PARK_MSEC          "XLIO_WORKER_THREADS_PARK_MSEC"
+#define SYS_VAR_WORKER_IDLE_PAUSE_USEC    "XLIO_WORKER_THREADS_IDLE_PAUSE_USEC"
+#define SYS_VAR_WORKER_IDLE_BLOCK_USEC    "XLIO_WORKER_THREADS_IDLE_BLOCK_USEC"
 #define SYS_VAR_TIMER_RESOLUTION_MSEC     "XLIO_TIMER_RESOLUTION_MSEC"
 #define SYS_VAR_TCP_TIMER_RESOLUTION_MSEC "XLIO_TCP_TIMER_RESOLUTION_MSEC"
 #define SYS_VAR_TCP_CTL_THREAD            "XLIO_TCP_CTL_THREAD"
 #define SYS_VAR_TCP_TIMESTAMP_OPTION      "XLIO_TCP_TIMESTAMP_OPTION"
 #define SYS_VAR_TCP_NODELAY               "XLIO_TCP_NODELAY"
 #define SYS_VAR_TCP_QUICKACK              "XLIO_TCP_QUICKACK"
+#define SYS_VAR_TCP_SACK                  "XLIO_TCP_SACK"
+#define SYS_VAR_TCP_ECN                   "XLIO_TCP_ECN"
+#define SYS_VAR_TCP_RACK                  "XLIO_TCP_RACK"
+#define SYS_VAR_TCP_SYNCOOKIES            "XLIO_TCP_SYNCOOKIES"
+#define SYS_VAR_TCP_FASTOPEN              "XLIO_TCP_FASTOPEN"
+#define SYS_VAR_TCP_TIMEWAIT_COMPACT      "XLIO_TCP_TIMEWAIT_COMPACT"
+#define SYS_VAR_TCP_TIMER_PARK_IDLE       "XLIO_TCP_TIMER_PARK_IDLE"
+#define SYS_VAR_TCP_MODERATE_RCVBUF       "XLIO_TCP_MODERATE_RCVBUF"
+#define SYS_VAR_TCP_ACK_COALESCE          "XLIO_TCP_ACK_COALESCE"
+#define SYS_VAR_TCP_ACK_ADAPTIVE          "XLIO_TCP_ACK_ADAPTIVE"
+#define SYS_VAR_TCP_CORK_TIMEOUT_MSEC     "XLIO_TCP_CORK_TIMEOUT_MSEC"
+#define SYS_VAR_TCP_MTU_PROBING           "XLIO_TCP_MTU_PROBING"
+#define SYS_VAR_UDP_DST_CACHE_SIZE        "XLIO_UDP_DST_CACHE_SIZE"
+#define SYS_VAR_PATH_CACHE_SIZE           "XLIO_PATH_CACHE_SIZE"
 #define SYS_VAR_TCP_PUSH_FLAG             "XLIO_TCP_PUSH_FLAG"
 #define SYS_VAR_AVOID_SYS_CALLS_ON_TCP_FD "XLIO_AVOID_SYS_CALLS_ON_TCP_FD"
 #define SYS_VAR_ALLOW_PRIVILEGED_SOCK_OPT "XLIO_ALLOW_PRIVILEGED_SOCK_OPT"
@@ -653,7 +834,14 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_MEMORY_LIMIT              "XLIO_MEMORY_LIMIT"
 #define SYS_VAR_MEMORY_LIMIT_USER         "XLIO_MEMORY_LIMIT_USER"
 #define SYS_VAR_HEAP_METADATA_BLOCK       "XLIO_HEAP_METADATA_BLOCK"
+#define SYS_VAR_BUFFER_POOL_SHRINK_MSEC   "XLIO_BUFFER_POOL_SHRINK_MSEC"
+#define SYS_VAR_RX_POOL_LOW_WATERMARK     "XLIO_RX_POOL_LOW_WATERMARK"
+#define SYS_VAR_RX_SOCKET_BUFS_MAX        "XLIO_RX_SOCKET_BUFS_MAX"
 #define SYS_VAR_HUGEPAGE_SIZE             "XLIO_HUGEPAGE_SIZE"
+#define SYS_VAR_HUGEPAGE_PREFAULT_THREADS "XLIO_HUGEPAGE_PREFAULT_THREADS"
+#define SYS_VAR_HUGEPAGE_PERSISTENT_FILE  "XLIO_HUGEPAGE_PERSISTENT_FILE"
+#define SYS_VAR_HUGEPAGE_FORK_SLICES      "XLIO_HUGEPAGE_FORK_SLICES"
+#define SYS_VAR_HUGEPAGE_QUEUES           "XLIO_HUGEPAGE_QUEUES"
 #define SYS_VAR_FORK                      "XLIO_FORK"
 #define SYS_VAR_CLOSE_ON_DUP2             "XLIO_CLOSE_ON_DUP2"
 #define SYS_VAR_MTU                       "XLIO_MTU"
@@ -669,19 +857,27 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_SRC_PORT_STRIDE "XLIO_SRC_PORT_STRIDE"
 #define SYS_VAR_DISTRIBUTE_CQ   "XLIO_DISTRIBUTE_CQ"
 #endif
-#define SYS_VAR_MSS         "XLIO_MSS"
-#define SYS_VAR_TCP_CC_ALGO "XLIO_TCP_CC_ALGO"
-#define SYS_VAR_SPEC        "XLIO_SPEC"
-#define SYS_VAR_TSO         "XLIO_TSO"
+#define SYS_VAR_MSS          "XLIO_MSS"
+#define SYS_VAR_TCP_CC_ALGO  "XLIO_TCP_CC_ALGO"
+#define SYS_VAR_SPEC         "XLIO_SPEC"
+#define SYS_VAR_AUTO_PROFILE "XLIO_AUTO_PROFILE"
+#define SYS_VAR_TSO          "XLIO_TSO"
 #ifdef DEFINED_UTLS
 #define SYS_VAR_UTLS_RX                        "XLIO_UTLS_RX"
 #define SYS_VAR_UTLS_TX                        "XLIO_UTLS_TX"
 #define SYS_VAR_UTLS_HIGH_WMARK_DEK_CACHE_SIZE "XLIO_UTLS_HIGH_WMARK_DEK_CACHE_SIZE"
 #define SYS_VAR_UTLS_LOW_WMARK_DEK_CACHE_SIZE  "XLIO_UTLS_LOW_WMARK_DEK_CACHE_SIZE"
+#define SYS_VAR_UTLS_DEK_POOL_SIZE             "XLIO_UTLS_DEK_POOL_SIZE"
+#define SYS_VAR_UTLS_TX_COALESCE_SIZE          "XLIO_UTLS_TX_COALESCE_SIZE"
 #endif /* DEFINED_UTLS */
 
 #define SYS_VAR_LRO "XLIO_LRO"
 
+#define SYS_VAR_MPWQE              "XLIO_TX_MPWQE"
+#define SYS_VAR_MPWQE_MAX_PKT_SIZE "XLIO_TX_MPWQE_MAX_PKT_SIZE"
+#define SYS_VAR_RX_CQE_COMPRESSION "XLIO_RX_CQE_COMPRESSION"
+#define SYS_VAR_IMPLICIT_ODP       "XLIO_IMPLICIT_ODP"
+
 #define SYS_VAR_INTERNAL_THREAD_AFFINITY "XLIO_INTERNAL_THREAD_AFFINITY"
 #define SYS_VAR_INTERNAL_THREAD_CPUSET   "XLIO_INTERNAL_THREAD_CPUSET"
 
@@ -690,12 +886,16 @@ extern mce_sys_var &safe_mce_sys();
 #define SYS_VAR_NEIGH_UC_ARP_QUATA      "XLIO_NEIGH_UC_ARP_QUATA"
 #define SYS_VAR_NEIGH_UC_ARP_DELAY_MSEC "XLIO_NEIGH_UC_ARP_DELAY_MSEC"
 #define SYS_VAR_NEIGH_NUM_ERR_RETRIES   "XLIO_NEIGH_NUM_ERR_RETRIES"
+#define SYS_VAR_NEIGH_REFRESH_MSEC      "XLIO_NEIGH_REFRESH_MSEC"
+#define SYS_VAR_NEIGH_PRERESOLVE        "XLIO_NEIGH_PRERESOLVE"
 
 #define SYS_VAR_DEFERRED_CLOSE       "XLIO_DEFERRED_CLOSE"
 #define SYS_VAR_TCP_ABORT_ON_CLOSE   "XLIO_TCP_ABORT_ON_CLOSE"
 #define SYS_VAR_RX_POLL_ON_TX_TCP    "XLIO_RX_POLL_ON_TX_TCP"
 #define SYS_VAR_RX_CQ_WAIT_CTRL      "XLIO_RX_CQ_WAIT_CTRL"
 #define SYS_VAR_TCP_SEND_BUFFER_SIZE "XLIO_TCP_SEND_BUFFER_SIZE"
+#define SYS_VAR_TCP_SEND_BUFFER_AUTOTUNE_LIMIT "XLIO_TCP_SEND_BUFFER_AUTOTUNE_LIMIT"
+#define SYS_VAR_TCP_SOCKET_POOL_SIZE "XLIO_TCP_SOCKET_POOL_SIZE"
 #define SYS_VAR_SKIP_POLL_IN_RX      "XLIO_SKIP_POLL_IN_RX"
 #define SYS_VAR_MULTILOCK            "XLIO_MULTILOCK"
 
@@ -708,6 +908,8 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_SERVICE_DIR         "core.daemon.dir"
 #define CONFIG_VAR_SERVICE_ENABLE      "core.daemon.enable"
 #define CONFIG_VAR_LOG_COLORS          "monitor.log.colors"
+#define CONFIG_VAR_LOG_ASYNC           "monitor.log.async"
+#define CONFIG_VAR_LOG_RATE_LIMIT      "monitor.log.rate_limit"
 #define CONFIG_VAR_APPLICATION_ID      "acceleration_control.app_id"
 #define CONFIG_VAR_HANDLE_SIGINTR      "core.signals.sigint.exit"
 #define CONFIG_VAR_HANDLE_SIGSEGV      "core.signals.sigsegv.backtrace"
@@ -720,13 +922,22 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_RING_MIGRATION_RATIO_RX  "performance.rings.rx.migration_ratio"
 #define CONFIG_VAR_RING_LIMIT_PER_INTERFACE "performance.rings.max_per_interface"
 #define CONFIG_VAR_RING_DEV_MEM_TX          "performance.rings.tx.max_on_device_memory"
+#define CONFIG_VAR_RING_DEV_MEM_TX_SHARED   "performance.rings.tx.shared_on_device_memory"
+#define CONFIG_VAR_RING_PER_PRIORITY_TX     "performance.rings.tx.per_priority"
+#define CONFIG_VAR_RING_BOND_WARM_STANDBY   "performance.rings.bond_warm_standby"
+#define CONFIG_VAR_RING_NUMA_AWARE          "performance.rings.numa_aware"
+#define CONFIG_VAR_RING_PRECREATE_THREADS   "performance.rings.precreate_threads"
+#define CONFIG_VAR_RING_CORE_POOL_SIZE      "performance.rings.core_pool_size"
+#define CONFIG_VAR_TX_SW_PACING             "performance.rings.tx.sw_pacing"
 
 #define CONFIG_VAR_ZC_CACHE_THRESHOLD    "core.syscall.sendfile_cache_limit"
+#define CONFIG_VAR_ZC_CACHE_MAX_FILES    "core.syscall.sendfile_cache_max_files"
 #define CONFIG_VAR_TX_BUF_SIZE           "performance.buffers.tx.buf_size"
 #define CONFIG_VAR_TCP_NODELAY_TRESHOLD  "network.protocols.tcp.nodelay.byte_threshold"
 #define CONFIG_VAR_TX_NUM_WRE            "performance.rings.tx.ring_elements_count"
 #define CONFIG_VAR_TX_NUM_WRE_TO_SIGNAL  "performance.rings.tx.completion_batch_size"
 #define CONFIG_VAR_TX_MAX_INLINE         "performance.rings.tx.max_inline_size"
+#define CONFIG_VAR_TX_BF_BURST           "performance.rings.tx.bf_burst"
 #define CONFIG_VAR_TX_MC_LOOPBACK        "network.multicast.mc_loopback"
 #define CONFIG_VAR_TX_NONBLOCKED_EAGAINS "performance.polling.nonblocking_eagain"
 #define CONFIG_VAR_TX_PREFETCH_BYTES     "performance.buffers.tx.prefetch_size"
@@ -737,10 +948,13 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_STRQ_NUM_STRIDES                "hardware_features.striding_rq.strides_num"
 #define CONFIG_VAR_STRQ_STRIDE_SIZE_BYTES          "hardware_features.striding_rq.stride_size"
 #define CONFIG_VAR_STRQ_STRIDES_COMPENSATION_LEVEL "performance.rings.rx.spare_strides"
+#define CONFIG_VAR_STRQ_AUTO_GEOMETRY              "hardware_features.striding_rq.auto_geometry"
 
 #define CONFIG_VAR_RX_BUF_SIZE                   "performance.buffers.rx.buf_size"
 #define CONFIG_VAR_RX_NUM_WRE                    "performance.rings.rx.ring_elements_count"
 #define CONFIG_VAR_RX_NUM_WRE_TO_POST_RECV       "performance.rings.rx.post_batch_size"
+#define CONFIG_VAR_RX_NUM_WRE_SHARED             "performance.rings.rx.shared_elements_count"
+#define CONFIG_VAR_RX_HDR_SPLIT_SIZE             "performance.rings.rx.header_split_size"
 #define CONFIG_VAR_RX_NUM_POLLS                  "performance.polling.blocking_rx_poll_usec"
 #define CONFIG_VAR_RX_NUM_POLLS_INIT             "performance.polling.offload_transition_poll_count"
 #define CONFIG_VAR_RX_UDP_POLL_OS_RATIO          "performance.polling.rx_kernel_fd_attention_level"
@@ -749,19 +963,33 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_RX_BYTE_MIN_LIMIT             "performance.override_rcvbuf_limit"
 #define CONFIG_VAR_RX_PREFETCH_BYTES             "performance.buffers.rx.prefetch_size"
 #define CONFIG_VAR_RX_PREFETCH_BYTES_BEFORE_POLL "performance.buffers.rx.prefetch_before_poll"
+#define CONFIG_VAR_RX_PREFETCH_DEPTH             "performance.buffers.rx.prefetch_depth"
+#define CONFIG_VAR_RX_COMPACT_THRESHOLD          "performance.buffers.rx.compact_threshold"
+#define CONFIG_VAR_RX_COMPACT_MAX_SIZE           "performance.buffers.rx.compact_max_size"
+#define CONFIG_VAR_RX_WAITALL_PLACEMENT_MIN      "performance.buffers.rx.waitall_placement_min"
 #define CONFIG_VAR_RX_CQ_DRAIN_RATE_NSEC         "performance.completion_queue.rx_drain_rate_nsec"
 #define CONFIG_VAR_GRO_STREAMS_MAX               "performance.max_gro_streams"
+#define CONFIG_VAR_GRO_FLUSH_USEC                "performance.gro_flush_usec"
 #define CONFIG_VAR_DISABLE_FLOW_TAG              "performance.steering_rules.disable_flowtag"
 #define CONFIG_VAR_TCP_2T_RULES                  "performance.steering_rules.tcp.2t_rules"
 #define CONFIG_VAR_TCP_3T_RULES                  "performance.steering_rules.tcp.3t_rules"
+#define CONFIG_VAR_TCP_DEFERRED_RULES_MSEC       "performance.steering_rules.tcp.deferred_rules_msec"
 #define CONFIG_VAR_UDP_3T_RULES                  "performance.steering_rules.udp.3t_rules"
+#define CONFIG_VAR_UDP_REUSEPORT_BUCKETS         "performance.steering_rules.udp.reuseport_buckets"
 #define CONFIG_VAR_ETH_MC_L2_ONLY_RULES          "performance.steering_rules.udp.only_mc_l2_rules"
 #define CONFIG_VAR_MC_FORCE_FLOWTAG              "network.multicast.mc_flowtag_acceleration"
 #define CONFIG_VAR_TX_SEGS_RING_BATCH_TCP        "performance.buffers.tcp_segments.ring_batch_size"
 #define CONFIG_VAR_TX_SEGS_POOL_BATCH_TCP        "performance.buffers.tcp_segments.pool_batch_size"
+#define CONFIG_VAR_GROUP_BUF_CACHE_BATCH         "performance.buffers.group_cache.batch_size"
+#define CONFIG_VAR_GROUP_BUF_CACHE_SIZE          "performance.buffers.group_cache.max_size"
 
 #define CONFIG_VAR_SELECT_CPU_USAGE_STATS "monitor.stats.cpu_usage"
+#define CONFIG_VAR_STATS_LATENCY_HIST     "monitor.stats.latency_hist"
+#define CONFIG_VAR_STATS_LOCK_PROFILING   "monitor.stats.lock_profiling"
+#define CONFIG_VAR_STATS_TRACE_RING_EVENTS "monitor.stats.trace_ring_events"
+#define CONFIG_VAR_STATS_MIRROR_RING_SLOTS "monitor.stats.mirror_ring_slots"
 #define CONFIG_VAR_SELECT_NUM_POLLS       "performance.polling.iomux.poll_usec"
+#define CONFIG_VAR_POLL_ADAPTIVE          "performance.polling.adaptive"
 #define CONFIG_VAR_SELECT_POLL_OS_RATIO   "performance.polling.iomux.poll_os_ratio"
 #define CONFIG_VAR_SELECT_SKIP_OS         "performance.polling.iomux.skip_os"
 
@@ -779,6 +1007,8 @@ extern mce_sys_var &safe_mce_sys();
     "frequency_msec"
 #define CONFIG_VAR_CQ_AIM_INTERRUPTS_RATE_PER_SEC                                                  \
     "performance.completion_queue.interrupt_moderation.adaptive_interrupt_per_sec"
+#define CONFIG_VAR_CQ_AIM_TARGET_LATENCY_USEC                                                      \
+    "performance.completion_queue.interrupt_moderation.adaptive_target_latency_usec"
 
 #define CONFIG_VAR_CQ_POLL_BATCH_MAX         "performance.polling.max_rx_poll_batch"
 #define CONFIG_VAR_PROGRESS_ENGINE_INTERVAL  "performance.completion_queue.periodic_drain_msec"
@@ -787,6 +1017,12 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_QP_COMPENSATION_LEVEL     "performance.rings.rx.spare_buffers"
 #define CONFIG_VAR_MAX_TSO_SIZE              "hardware_features.tcp.tso.max_size"
 #define CONFIG_VAR_WORKER_THREADS            "performance.threading.worker_threads"
+#define CONFIG_VAR_WORKER_PLACEMENT          "performance.threading.worker_placement"
+#define CONFIG_VAR_WORKER_LISTEN_BUCKETS     "performance.threading.worker_listen_buckets"
+#define CONFIG_VAR_WORKER_AFFINITY           "performance.threading.worker_cpu_affinity"
+#define CONFIG_VAR_WORKER_PARK_MSEC          "performance.threading.worker_park_msec"
+#define CONFIG_VAR_WORKER_IDLE_PAUSE_USEC    "performance.threading.worker_idle_pause_usec"
+#define CONFIG_VAR_WORKER_IDLE_BLOCK_USEC    "performance.threading.worker_idle_block_usec"
 #define CONFIG_VAR_OFFLOADED_SOCKETS         "acceleration_control.default_acceleration"
 #define CONFIG_VAR_TIMER_RESOLUTION_MSEC     "performance.threading.internal_handler.timer_msec"
 #define CONFIG_VAR_TCP_TIMER_RESOLUTION_MSEC "network.protocols.tcp.timer_msec"
@@ -794,6 +1030,20 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_TCP_TIMESTAMP_OPTION      "network.protocols.tcp.timestamps"
 #define CONFIG_VAR_TCP_NODELAY               "network.protocols.tcp.nodelay.enable"
 #define CONFIG_VAR_TCP_QUICKACK              "network.protocols.tcp.quickack"
+#define CONFIG_VAR_TCP_SACK                  "network.protocols.tcp.sack"
+#define CONFIG_VAR_TCP_ECN                   "network.protocols.tcp.ecn"
+#define CONFIG_VAR_TCP_RACK                  "network.protocols.tcp.rack"
+#define CONFIG_VAR_TCP_SYNCOOKIES            "network.protocols.tcp.syncookies"
+#define CONFIG_VAR_TCP_FASTOPEN              "network.protocols.tcp.fastopen"
+#define CONFIG_VAR_TCP_TIMEWAIT_COMPACT      "network.protocols.tcp.timewait_compact"
+#define CONFIG_VAR_TCP_TIMER_PARK_IDLE       "network.protocols.tcp.timer_park_idle"
+#define CONFIG_VAR_TCP_MODERATE_RCVBUF       "network.protocols.tcp.moderate_rcvbuf"
+#define CONFIG_VAR_TCP_ACK_COALESCE          "network.protocols.tcp.ack_coalesce"
+#define CONFIG_VAR_TCP_ACK_ADAPTIVE          "network.protocols.tcp.ack_adaptive"
+#define CONFIG_VAR_TCP_CORK_TIMEOUT_MSEC     "network.protocols.tcp.cork_timeout_msec"
+#define CONFIG_VAR_TCP_MTU_PROBING           "network.protocols.tcp.mtu_probing"
+#define CONFIG_VAR_UDP_DST_CACHE_SIZE        "network.protocols.udp.dst_cache_size"
+#define CONFIG_VAR_PATH_CACHE_SIZE           "network.protocols.ip.path_cache_size"
 #define CONFIG_VAR_TCP_PUSH_FLAG             "network.protocols.tcp.push"
 #define CONFIG_VAR_AVOID_SYS_CALLS_ON_TCP_FD "core.syscall.avoid_ctl_syscalls"
 #define CONFIG_VAR_ALLOW_PRIVILEGED_SOCK_OPT "core.syscall.allow_privileged_sockopt"
@@ -803,7 +1053,14 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_MEMORY_LIMIT              "core.resources.memory_limit"
 #define CONFIG_VAR_MEMORY_LIMIT_USER         "core.resources.external_memory_limit"
 #define CONFIG_VAR_HEAP_METADATA_BLOCK       "core.resources.heap_metadata_block_size"
+#define CONFIG_VAR_BUFFER_POOL_SHRINK_MSEC   "core.resources.buffer_pool_shrink_msec"
+#define CONFIG_VAR_RX_POOL_LOW_WATERMARK     "core.resources.rx_pool_low_watermark"
+#define CONFIG_VAR_RX_SOCKET_BUFS_MAX        "core.resources.rx_socket_bufs_max"
 #define CONFIG_VAR_HUGEPAGE_SIZE             "core.resources.hugepages.size"
+#define CONFIG_VAR_HUGEPAGE_PREFAULT_THREADS "core.resources.hugepages.prefault_threads"
+#define CONFIG_VAR_HUGEPAGE_PERSISTENT_FILE  "core.resources.hugepages.persistent_file"
+#define CONFIG_VAR_HUGEPAGE_FORK_SLICES      "core.resources.hugepages.fork_slices"
+#define CONFIG_VAR_HUGEPAGE_QUEUES           "core.resources.hugepages.queues"
 #define CONFIG_VAR_FORK                      "core.syscall.fork_support"
 #define CONFIG_VAR_CLOSE_ON_DUP2             "core.syscall.dup2_close_fd"
 #define CONFIG_VAR_MTU                       "network.protocols.ip.mtu"
@@ -819,9 +1076,10 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_SRC_PORT_STRIDE "applications.nginx.src_port_stride"
 #define CONFIG_VAR_DISTRIBUTE_CQ   "applications.nginx.distribute_cq"
 #endif
-#define CONFIG_VAR_MSS         "network.protocols.tcp.mss"
-#define CONFIG_VAR_TCP_CC_ALGO "network.protocols.tcp.congestion_control"
-#define CONFIG_VAR_SPEC        "profiles.spec"
+#define CONFIG_VAR_MSS          "network.protocols.tcp.mss"
+#define CONFIG_VAR_TCP_CC_ALGO  "network.protocols.tcp.congestion_control"
+#define CONFIG_VAR_SPEC         "profiles.spec"
+#define CONFIG_VAR_AUTO_PROFILE "profiles.auto"
 
 #define CONFIG_VAR_TSO "hardware_features.tcp.tso.enable"
 #ifdef DEFINED_UTLS
@@ -831,10 +1089,17 @@ extern mce_sys_var &safe_mce_sys();
     "hardware_features.tcp.tls_offload.dek_cache_max_size"
 #define CONFIG_VAR_UTLS_LOW_WMARK_DEK_CACHE_SIZE                                                   \
     "hardware_features.tcp.tls_offload.dek_cache_min_size"
+#define CONFIG_VAR_UTLS_DEK_POOL_SIZE "hardware_features.tcp.tls_offload.dek_pool_size"
+#define CONFIG_VAR_UTLS_TX_COALESCE_SIZE "hardware_features.tcp.tls_offload.tx_coalesce_size"
 #endif /* DEFINED_UTLS */
 
 #define CONFIG_VAR_LRO "hardware_features.tcp.lro"
 
+#define CONFIG_VAR_MPWQE              "hardware_features.mpwqe.enable"
+#define CONFIG_VAR_MPWQE_MAX_PKT_SIZE "hardware_features.mpwqe.max_pkt_size"
+#define CONFIG_VAR_RX_CQE_COMPRESSION "hardware_features.rx_cqe_compression"
+#define CONFIG_VAR_IMPLICIT_ODP       "hardware_features.implicit_odp"
+
 #define CONFIG_VAR_INTERNAL_THREAD_AFFINITY "performance.threading.cpu_affinity"
 #define CONFIG_VAR_INTERNAL_THREAD_CPUSET   "performance.threading.cpuset"
 
@@ -843,12 +1108,16 @@ extern mce_sys_var &safe_mce_sys();
 #define CONFIG_VAR_NEIGH_UC_ARP_QUATA      "network.neighbor.arp.uc_retries"
 #define CONFIG_VAR_NEIGH_UC_ARP_DELAY_MSEC "network.neighbor.arp.uc_delay_msec"
 #define CONFIG_VAR_NEIGH_NUM_ERR_RETRIES   "network.neighbor.errors_before_reset"
+#define CONFIG_VAR_NEIGH_REFRESH_MSEC      "network.neighbor.refresh_msec"
+#define CONFIG_VAR_NEIGH_PRERESOLVE        "network.neighbor.preresolve"
 
 #define CONFIG_VAR_DEFERRED_CLOSE       "core.syscall.deferred_close"
 #define CONFIG_VAR_TCP_ABORT_ON_CLOSE   "network.protocols.tcp.linger_0"
 #define CONFIG_VAR_RX_POLL_ON_TX_TCP    "performance.polling.rx_poll_on_tx_tcp"
 #define CONFIG_VAR_RX_CQ_WAIT_CTRL      "performance.polling.rx_cq_wait_ctrl"
 #define CONFIG_VAR_TCP_SEND_BUFFER_SIZE "network.protocols.tcp.wmem"
+#define CONFIG_VAR_TCP_SEND_BUFFER_AUTOTUNE_LIMIT "network.protocols.tcp.wmem_autotune_limit"
+#define CONFIG_VAR_TCP_SOCKET_POOL_SIZE "network.protocols.tcp.socket_pool_size"
 #define CONFIG_VAR_SKIP_POLL_IN_RX      "performance.polling.skip_cq_on_rx"
 #define CONFIG_VAR_MULTILOCK            "performance.threading.mutex_over_spinlock"
 
@@ -858,6 +1127,8 @@ extern mce_sys_var &safe_mce_sys();
  */
 #define MCE_DEFAULT_PRINT_REPORT             (option_3::AUTO)
 #define MCE_DEFAULT_TCP_SEND_BUFFER_SIZE     (1024 * 1024)
+#define MCE_DEFAULT_TCP_SEND_BUFFER_AUTOTUNE_LIMIT (256LU * 1024 * 1024)
+#define MCE_DEFAULT_TCP_SOCKET_POOL_SIZE     (64)
 #define MCE_DEFAULT_LOG_FILE                 ("")
 #define MCE_DEFAULT_CONF_FILE                ("/etc/libxlio.conf")
 #define MCE_DEFAULT_STATS_FILE               ("")
@@ -866,6 +1137,8 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_SERVICE_ENABLE           (false)
 #define MCE_DEFAULT_LOG_DETAILS              (0)
 #define MCE_DEFAULT_LOG_COLORS               (true)
+#define MCE_DEFAULT_LOG_ASYNC                (false)
+#define MCE_DEFAULT_LOG_RATE_LIMIT           (0)
 #define MCE_DEFAULT_APP_ID                   ("XLIO_DEFAULT_APPLICATION_ID")
 #define MCE_DEFAULT_HANDLE_SIGINTR           (true)
 #define MCE_DEFAULT_HANDLE_SIGFAULT          (false)
@@ -877,12 +1150,23 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_RING_MIGRATION_RATIO_RX  (-1)
 #define MCE_DEFAULT_RING_LIMIT_PER_INTERFACE (0)
 #define MCE_DEFAULT_RING_DEV_MEM_TX          (0)
+#define MCE_DEFAULT_RING_DEV_MEM_TX_SHARED   (false)
+#define MCE_DEFAULT_RING_PER_PRIORITY_TX     (false)
+#define MCE_DEFAULT_RING_BOND_WARM_STANDBY   (false)
+#define MCE_DEFAULT_RING_NUMA_AWARE          (false)
+#define MCE_DEFAULT_RING_PRECREATE_THREADS   (0)
+#define MCE_MAX_RING_PRECREATE_THREADS       (64)
+#define MCE_DEFAULT_RING_CORE_POOL_SIZE      (0)
+#define MCE_MAX_RING_CORE_POOL_SIZE          (1024)
+#define MCE_DEFAULT_TX_SW_PACING             (SW_PACING_FALLBACK)
 #define MCE_DEFAULT_TCP_NODELAY_TRESHOLD     (0)
 #define MCE_DEFAULT_ZC_CACHE_THRESHOLD       (10LU * 1024 * 1024 * 1024) // 10GB
+#define MCE_DEFAULT_ZC_CACHE_MAX_FILES       (0) // unlimited
 #define MCE_DEFAULT_TX_BUF_SIZE              (0)
 #define MCE_DEFAULT_TX_NUM_WRE               (32768)
 #define MCE_DEFAULT_TX_NUM_WRE_TO_SIGNAL     (64)
 #define MCE_DEFAULT_TX_MAX_INLINE            (204) //+18(always inline ETH header) = 222
+#define MCE_DEFAULT_TX_BF_BURST              (0)
 #define MCE_DEFAULT_TX_BUILD_IP_CHKSUM       (true)
 #define MCE_DEFAULT_TX_MC_LOOPBACK           (true)
 #define MCE_DEFAULT_TX_NONBLOCKED_EAGAINS    (false)
@@ -892,6 +1176,8 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_TX_SEGS_BATCH_TCP        (64)
 #define MCE_DEFAULT_TX_SEGS_RING_BATCH_TCP   (1024)
 #define MCE_DEFAULT_TX_SEGS_POOL_BATCH_TCP   (16384)
+#define MCE_DEFAULT_GROUP_BUF_CACHE_BATCH    (256)
+#define MCE_DEFAULT_GROUP_BUF_CACHE_SIZE     (1024)
 #define MCE_DEFAULT_TX_NUM_SGE               (4)
 
 #define MCE_DEFAULT_STRQ                            (option_3::ON)
@@ -900,11 +1186,14 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_STRQ_NUM_WRE                    (128)
 #define MCE_DEFAULT_STRQ_NUM_WRE_TO_POST_RECV       (1)
 #define MCE_DEFAULT_STRQ_STRIDES_COMPENSATION_LEVEL (32768)
+#define MCE_DEFAULT_STRQ_AUTO_GEOMETRY              (false)
 
 #define MCE_DEFAULT_RX_BUF_SIZE                   (0)
 #define MCE_DEFAULT_RX_BUFS_BATCH                 (64)
 #define MCE_DEFAULT_RX_NUM_WRE                    (32768)
 #define MCE_DEFAULT_RX_NUM_WRE_TO_POST_RECV       (1024)
+#define MCE_DEFAULT_RX_NUM_WRE_SHARED             (0)
+#define MCE_DEFAULT_RX_HDR_SPLIT_SIZE             (0)
 #define MCE_DEFAULT_RX_NUM_POLLS                  (100000)
 #define MCE_DEFAULT_RX_NUM_POLLS_INIT             (0)
 #define MCE_DEFAULT_RX_UDP_POLL_OS_RATIO          (100)
@@ -913,18 +1202,32 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_RX_BYTE_MIN_LIMIT             (65536)
 #define MCE_DEFAULT_RX_PREFETCH_BYTES             (256)
 #define MCE_DEFAULT_RX_PREFETCH_BYTES_BEFORE_POLL (0)
+#define MCE_DEFAULT_RX_PREFETCH_DEPTH             (4)
+#define MCE_DEFAULT_RX_COMPACT_THRESHOLD          (0)
+#define MCE_DEFAULT_RX_COMPACT_MAX_SIZE           (256)
+#define MCE_DEFAULT_RX_WAITALL_PLACEMENT_MIN      (0)
 #define MCE_DEFAULT_RX_CQ_DRAIN_RATE              (MCE_RX_CQ_DRAIN_RATE_DISABLED)
 #define MCE_DEFAULT_GRO_STREAMS_MAX               (32)
+#define MCE_DEFAULT_GRO_FLUSH_USEC                (0)
+#define MCE_MAX_GRO_FLUSH_USEC                    (1000)
 #define MCE_DEFAULT_DISABLE_FLOW_TAG              (false)
 #define MCE_DEFAULT_TCP_2T_RULES                  (false)
 #define MCE_DEFAULT_TCP_3T_RULES                  (false)
+#define MCE_DEFAULT_TCP_DEFERRED_RULES_MSEC       (0)
 #define MCE_DEFAULT_UDP_3T_RULES                  (true)
+#define MCE_DEFAULT_UDP_REUSEPORT_BUCKETS         (0)
+#define MCE_MAX_UDP_REUSEPORT_BUCKETS             (64)
 #define MCE_DEFAULT_ETH_MC_L2_ONLY_RULES          (false)
 #define MCE_DEFAULT_MC_FORCE_FLOWTAG              (false)
 #define MCE_DEFAULT_SELECT_NUM_POLLS              (100000)
+#define MCE_DEFAULT_POLL_ADAPTIVE                 (false)
 #define MCE_DEFAULT_SELECT_POLL_OS_RATIO          (10)
 #define MCE_DEFAULT_SELECT_SKIP_OS                (4)
 #define MCE_DEFAULT_SELECT_CPU_USAGE_STATS        (false)
+#define MCE_DEFAULT_STATS_LATENCY_HIST            (false)
+#define MCE_DEFAULT_STATS_LOCK_PROFILING          (false)
+#define MCE_DEFAULT_STATS_TRACE_RING_EVENTS       (0)
+#define MCE_DEFAULT_STATS_MIRROR_RING_SLOTS       (0)
 #ifdef DEFINED_IBV_CQ_ATTR_MODERATE
 #define MCE_DEFAULT_CQ_MODERATION_ENABLE (true)
 #else
@@ -936,6 +1239,7 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_CQ_AIM_MAX_PERIOD_USEC         (1000)
 #define MCE_DEFAULT_CQ_AIM_INTERVAL_MSEC           (1000)
 #define MCE_DEFAULT_CQ_AIM_INTERRUPTS_RATE_PER_SEC (10000)
+#define MCE_DEFAULT_CQ_AIM_TARGET_LATENCY_USEC     (0)
 #define MCE_DEFAULT_CQ_POLL_BATCH                  (16)
 #define MCE_DEFAULT_PROGRESS_ENGINE_INTERVAL_MSEC  (10)
 #define MCE_DEFAULT_PROGRESS_ENGINE_WCE_MAX        (10000)
@@ -948,6 +1252,22 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_TCP_TIMESTAMP_OPTION           (TCP_TS_OPTION_DISABLE)
 #define MCE_DEFAULT_TCP_NODELAY                    (false)
 #define MCE_DEFAULT_TCP_QUICKACK                   (false)
+#define MCE_DEFAULT_TCP_SACK                       (false)
+#define MCE_DEFAULT_TCP_ECN                        (false)
+#define MCE_DEFAULT_TCP_RACK                       (false)
+#define MCE_DEFAULT_TCP_SYNCOOKIES                 (false)
+#define MCE_DEFAULT_TCP_FASTOPEN                   (1)
+#define TCP_FASTOPEN_CLIENT_ENABLE                 (0x1U)
+#define TCP_FASTOPEN_SERVER_ENABLE                 (0x2U)
+#define MCE_DEFAULT_TCP_TIMEWAIT_COMPACT           (false)
+#define MCE_DEFAULT_TCP_TIMER_PARK_IDLE            (false)
+#define MCE_DEFAULT_TCP_MODERATE_RCVBUF            (false)
+#define MCE_DEFAULT_TCP_ACK_COALESCE               (false)
+#define MCE_DEFAULT_TCP_ACK_ADAPTIVE               (false)
+#define MCE_DEFAULT_TCP_CORK_TIMEOUT_MSEC          (200)
+#define MCE_DEFAULT_TCP_MTU_PROBING                (false)
+#define MCE_DEFAULT_UDP_DST_CACHE_SIZE             (0)
+#define MCE_DEFAULT_PATH_CACHE_SIZE                (0)
 #define MCE_DEFAULT_TCP_PUSH_FLAG                  (true)
 #define MCE_DEFAULT_AVOID_SYS_CALLS_ON_TCP_FD      (false)
 #define MCE_DEFAULT_ALLOW_PRIVILEGED_SOCK_OPT      (true)
@@ -957,8 +1277,17 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_MEMORY_LIMIT                   (2LU * 1024 * 1024 * 1024)
 #define MCE_DEFAULT_MEMORY_LIMIT_USER              (0)
 #define MCE_DEFAULT_HEAP_METADATA_BLOCK            (32LU * 1024 * 1024)
+#define MCE_DEFAULT_BUFFER_POOL_SHRINK_MSEC        (0)
+#define MCE_DEFAULT_RX_POOL_LOW_WATERMARK          (0)
+#define MCE_DEFAULT_RX_SOCKET_BUFS_MAX             (0)
 #define MCE_DEFAULT_HUGEPAGE_SIZE                  (0)
+#define MCE_DEFAULT_HUGEPAGE_PREFAULT_THREADS      (0)
+#define MCE_DEFAULT_HUGEPAGE_PERSISTENT_FILE       ""
 #define MCE_MAX_HUGEPAGE_SIZE                      (1ULL << 63ULL) - 1
+#define MCE_MAX_HUGEPAGE_PREFAULT_THREADS          (64)
+#define MCE_DEFAULT_HUGEPAGE_FORK_SLICES           (0)
+#define MCE_MAX_HUGEPAGE_FORK_SLICES               (1024)
+#define MCE_DEFAULT_HUGEPAGE_QUEUES                (false)
 #define MCE_DEFAULT_FORK_SUPPORT                   (true)
 #define MCE_DEFAULT_CLOSE_ON_DUP2                  (true)
 #define MCE_DEFAULT_MTU                            (0)
@@ -981,6 +1310,8 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_DEFAULT_NEIGH_UC_ARP_QUATA      3
 #define MCE_DEFAULT_NEIGH_UC_ARP_DELAY_MSEC 10000
 #define MCE_DEFAULT_NEIGH_NUM_ERR_RETRIES   1
+#define MCE_DEFAULT_NEIGH_REFRESH_MSEC      0
+#define MCE_DEFAULT_NEIGH_PRERESOLVE        ""
 
 #define MCE_MIN_NUM_SGE                     (1)
 #define MCE_MAX_NUM_SGE                     (32)
@@ -988,22 +1319,40 @@ extern mce_sys_var &safe_mce_sys();
 #define MCE_MAX_RX_NUM_POLLS                (100000000)
 #define MCE_MIN_RX_PREFETCH_BYTES           (32) /* Just enough for headers (IPoIB+IP+UDP)*/
 #define MCE_MAX_RX_PREFETCH_BYTES           (2044)
+#define MCE_MAX_RX_PREFETCH_DEPTH           (16)
+#define MCE_MIN_RX_HDR_SPLIT_SIZE           (64)
+#define MCE_MAX_RX_HDR_SPLIT_SIZE           (1024)
 #define MCE_RX_CQ_DRAIN_RATE_DISABLED       (0)
 #define MCE_CQ_DRAIN_INTERVAL_DISABLED      (0)
 #define MCE_CQ_ADAPTIVE_MODERATION_DISABLED (0)
 #define MCE_MIN_CQ_POLL_BATCH               (1)
 #define MCE_MAX_CQ_POLL_BATCH               (32768)
 #define MCE_DEFAULT_TSO                     (option_3::AUTO)
+#define MCE_DEFAULT_AUTO_PROFILE            (option_auto_profile::NONE)
 #define MCE_DEFAULT_MAX_TSO_SIZE            (256 * 1024)
 #define MCE_DEFAULT_WORKER_THREADS          (0)
+#define MCE_DEFAULT_WORKER_PLACEMENT        (WORKER_PLACEMENT_ROUND_ROBIN)
+#define MCE_DEFAULT_WORKER_LISTEN_BUCKETS   (0)
+#define MCE_MAX_WORKER_LISTEN_BUCKETS       (256)
+#define MCE_DEFAULT_WORKER_AFFINITY_STR     ("-1")
+#define MCE_DEFAULT_WORKER_PARK_MSEC        (0)
+#define MCE_DEFAULT_WORKER_IDLE_PAUSE_USEC  (0)
+#define MCE_DEFAULT_WORKER_IDLE_BLOCK_USEC  (0)
 #ifdef DEFINED_UTLS
 #define MCE_DEFAULT_UTLS_RX                        (false)
 #define MCE_DEFAULT_UTLS_TX                        (true)
 #define MCE_DEFAULT_UTLS_HIGH_WMARK_DEK_CACHE_SIZE (1024)
 #define MCE_DEFAULT_UTLS_LOW_WMARK_DEK_CACHE_SIZE  (512)
+#define MCE_DEFAULT_UTLS_DEK_POOL_SIZE             (0)
+#define MCE_DEFAULT_UTLS_TX_COALESCE_SIZE          (0)
+#define MCE_MAX_UTLS_TX_COALESCE_SIZE              (16384)
 #endif /* DEFINED_UTLS */
 
 #define MCE_DEFAULT_LRO                (option_3::AUTO)
+#define MCE_DEFAULT_MPWQE              (false)
+#define MCE_DEFAULT_MPWQE_MAX_PKT_SIZE (256)
+#define MCE_DEFAULT_RX_CQE_COMPRESSION (false)
+#define MCE_DEFAULT_IMPLICIT_ODP       (false)
 #define MCE_DEFAULT_DEFERRED_CLOSE     (false)
 #define MCE_DEFAULT_TCP_ABORT_ON_CLOSE (false)
 #define MCE_DEFAULT_RX_POLL_ON_TX_TCP  (false)
@@ -1020,6 +1369,7 @@ extern mce_sys_var &safe_mce_sys();
 #define TX_BUF_SIZE(mtu) ((mtu) + 92)
 
 #define NUM_TX_WRE_TO_SIGNAL_MAX            64
+#define TX_BF_BURST_MAX                     64
 #define NUM_RX_WRE_TO_POST_RECV_MAX         1024
 #define MAX_MLX5_CQ_SIZE_ITEMS              4194304
 #define DEFAULT_MC_TTL                      64
@@ -1035,6 +1385,7 @@ extern mce_sys_var &safe_mce_sys();
 #define BONDING_FAILOVER_MAC_PARAM_FILE     "/sys/class/net/%s/bonding/fail_over_mac"
 #define BONDING_XMIT_HASH_POLICY_PARAM_FILE "/sys/class/net/%s/bonding/xmit_hash_policy"
 #define BONDING_ROCE_LAG_FILE               "/sys/class/net/%s/device/roce_lag_enable"
+#define IB_DEVICE_NUMA_NODE_PARAM_FILE      "/sys/class/infiniband/%s/device/numa_node"
 /* BONDING_SLAVE_STATE_PARAM_FILE is for kernel  > 3.14 or RH7.2 and higher */
 #define BONDING_SLAVE_STATE_PARAM_FILE "/sys/class/net/%s/bonding_slave/state"
 #define L2_ADDR_FILE_FMT               "/sys/class/net/%.*s/address"
@@ -1046,8 +1397,10 @@ extern mce_sys_var &safe_mce_sys();
 #define BOND_DEVICE_FILE       "/proc/net/bonding/%s"
 #define BOND_DEVICE_UPPER_FILE "/sys/class/net/%s/upper_%s/ifindex"
 
-#define MAX_STATS_FD_NUM   1024U
-#define MAX_WINDOW_SCALING 14
+#define MAX_STATS_FD_NUM            (1U << 20U)
+#define MAX_STATS_TRACE_RING_EVENTS (1U << 20U)
+#define MAX_STATS_MIRROR_RING_SLOTS (1U << 20U)
+#define MAX_WINDOW_SCALING          14
 
 #define STRQ_MIN_STRIDES_NUM       512
 #define STRQ_MAX_STRIDES_NUM       65536
@@ -78,6 +78,8 @@ public:
         get_igmp_max_source_membership(true);
         get_mld_max_source_membership(true);
         get_net_ipv6_hop_limit(true);
+        get_fib_multipath_hash_policy(AF_INET, true);
+        get_fib_multipath_hash_policy(AF_INET6, true);
         get_ipv6_bindv6only(true);
         get_ipv6_conf_all_optimistic_dad(true);
         get_ipv6_conf_all_use_optimistic(true);
@@ -202,6 +204,22 @@ public:
         return val;
     }
 
+    int get_fib_multipath_hash_policy(sa_family_t family, bool update = false)
+    {
+        static int val4;
+        static int val6;
+        if (update) {
+            if (family == AF_INET) {
+                val4 = read_file_to_int("/proc/sys/net/ipv4/fib_multipath_hash_policy", 0,
+                                        VLOG_DEBUG);
+            } else {
+                val6 = read_file_to_int("/proc/sys/net/ipv6/fib_multipath_hash_policy", 0,
+                                        VLOG_DEBUG);
+            }
+        }
+        return family == AF_INET ? val4 : val6;
+    }
+
     int get_igmp_max_membership(bool update = false)
     {
         static int val;
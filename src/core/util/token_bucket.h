@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TOKEN_BUCKET_H
+#define TOKEN_BUCKET_H
+
+#include <stdint.h>
+#include <algorithm>
+#include "utils/rdtsc.h"
+
+/**
+ * Byte token bucket clocked by the TSC.
+ *
+ * Tokens are added at the configured rate up to the burst size. A sender consumes the
+ * tokens of the bytes it transmits and waits for tsc_until() otherwise.
+ * Not thread safe, the owner serializes the access.
+ */
+class token_bucket {
+public:
+    void set_rate(uint64_t bytes_per_sec, uint64_t burst_bytes)
+    {
+        m_bytes_per_tsc = static_cast<double>(bytes_per_sec) / get_tsc_rate_per_second();
+        m_burst = static_cast<double>(std::max<uint64_t>(burst_bytes, 1U));
+        m_tokens = m_burst;
+        gettimeoftsc(&m_last_tsc);
+    }
+
+    /* Changes the rate without a refill, the tokens above the new burst are dropped. */
+    void update_rate(uint64_t bytes_per_sec, uint64_t burst_bytes)
+    {
+        m_bytes_per_tsc = static_cast<double>(bytes_per_sec) / get_tsc_rate_per_second();
+        m_burst = static_cast<double>(std::max<uint64_t>(burst_bytes, 1U));
+        m_tokens = std::min(m_tokens, m_burst);
+    }
+
+    bool is_set() const { return m_bytes_per_tsc > 0; }
+    uint64_t get_burst() const { return static_cast<uint64_t>(m_burst); }
+
+    uint64_t get_tokens(tscval_t now)
+    {
+        if (now > m_last_tsc) {
+            m_tokens = std::min(m_burst, m_tokens + (now - m_last_tsc) * m_bytes_per_tsc);
+            m_last_tsc = now;
+        }
+        return static_cast<uint64_t>(m_tokens);
+    }
+
+    void consume(uint64_t bytes) { m_tokens = std::max(0.0, m_tokens - bytes); }
+
+    /* TSC ticks until the bucket holds the given number of bytes, the burst at most. */
+    tscval_t tsc_until(uint64_t bytes) const
+    {
+        double need = std::min(m_burst, static_cast<double>(bytes));
+        return need > m_tokens ? static_cast<tscval_t>((need - m_tokens) / m_bytes_per_tsc) : 0U;
+    }
+
+private:
+    double m_bytes_per_tsc = 0;
+    double m_burst = 0;
+    double m_tokens = 0;
+    tscval_t m_last_tsc = 0;
+};
+
+#endif /* TOKEN_BUCKET_H */
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <vector>
+
+#include "vlogger/vlogger.h"
+#include "trace_ring.h"
+
+#define MODULE_NAME "trace_ring"
+
+uint32_t g_trace_ring_events = 0U;
+thread_local trace_ring_t *g_p_trace_ring = nullptr;
+
+// The rings of all the threads, the rings of the exited threads are kept for the dumps
+static trace_ring_t *s_p_trace_rings = nullptr;
+
+void trace_ring_init(uint32_t num_events)
+{
+    uint32_t events = 1U;
+
+    if (!num_events) {
+        return;
+    }
+    while (events < num_events) {
+        events <<= 1U;
+    }
+    g_trace_ring_events = events;
+    vlog_printf(VLOG_DEBUG, MODULE_NAME ": %u events per thread\n", events);
+}
+
+trace_ring_t *trace_ring_create()
+{
+    size_t size = sizeof(trace_ring_t) + g_trace_ring_events * sizeof(trace_event_t);
+    trace_ring_t *ring = static_cast<trace_ring_t *>(calloc(1, size));
+
+    if (!ring) {
+        return nullptr;
+    }
+    ring->mask = g_trace_ring_events - 1U;
+    ring->tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+    ring->next = __atomic_load_n(&s_p_trace_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&s_p_trace_rings, &ring->next, ring, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    g_p_trace_ring = ring;
+    return ring;
+}
+
+// Copies the events of a ring which aren't overwritten by its thread during the copy
+static void trace_ring_snapshot(const trace_ring_t *ring, std::vector<trace_event_t> &events)
+{
+    uint64_t capacity = ring->mask + 1ULL;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t start = head > capacity ? head - capacity : 0U;
+
+    events.clear();
+    for (uint64_t i = start; i < head; ++i) {
+        events.push_back(ring->events[i & ring->mask]);
+    }
+
+    // The thread may be writing the event after the new head, it replaces the oldest one
+    uint64_t new_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t valid_start = new_head + 1U > capacity ? new_head + 1U - capacity : 0U;
+    if (valid_start > start) {
+        events.erase(events.begin(),
+                     events.begin() + std::min<uint64_t>(valid_start - start, events.size()));
+    }
+}
+
+int trace_ring_dump(const char *dirname)
+{
+    char filename[PATH_MAX];
+    trace_ring_t *rings = __atomic_load_n(&s_p_trace_rings, __ATOMIC_ACQUIRE);
+    trace_file_header_t header;
+    std::vector<trace_event_t> events;
+
+    if (!g_trace_ring_events || !dirname || !*dirname) {
+        vlog_printf(VLOG_WARNING, MODULE_NAME ": tracing is disabled or no directory is set\n");
+        return -1;
+    }
+
+    snprintf(filename, sizeof(filename), "%s/xliotrace.%d", dirname, getpid());
+    FILE *file = fopen(filename, "w");
+    if (!file) {
+        vlog_printf(VLOG_ERROR, MODULE_NAME ": unable to open %s (errno=%d %m)\n", filename,
+                    errno);
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FILE_VERSION;
+    for (trace_ring_t *ring = rings; ring; ring = ring->next) {
+        ++header.num_rings;
+    }
+    header.tsc_rate = get_tsc_rate_per_second();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (trace_ring_t *ring = rings; ring && ok; ring = ring->next) {
+        trace_file_ring_t ring_header;
+
+        trace_ring_snapshot(ring, events);
+        ring_header.tid = static_cast<uint32_t>(ring->tid);
+        ring_header.num_events = static_cast<uint32_t>(events.size());
+        ring_header.total_events = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        ok = fwrite(&ring_header, sizeof(ring_header), 1, file) == 1 &&
+            (events.empty() ||
+             fwrite(events.data(), sizeof(trace_event_t), events.size(), file) == events.size());
+    }
+
+    if (fclose(file) || !ok) {
+        vlog_printf(VLOG_ERROR, MODULE_NAME ": failed to write %s\n", filename);
+        return -1;
+    }
+    vlog_printf(VLOG_INFO, MODULE_NAME ": %u rings written to %s\n", header.num_rings, filename);
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "utils/rdtsc.h"
+#include "utils/types.h"
+
+/*
+ * Per thread binary trace rings of monitor.stats.trace_ring_events events, the last events of
+ * each thread are kept. The layout of the dump file is decoded by tools/xlio_trace_decode.py:
+ *   trace_file_header_t, then per ring a trace_file_ring_t followed by its events, oldest first.
+ * All the fields are in the host byte order.
+ */
+#define TRACE_FILE_MAGIC   "XLIOTRC1"
+#define TRACE_FILE_VERSION 1U
+
+enum trace_event_id_t : uint16_t {
+    TRACE_EVENT_CQ_POLL = 1, // cq, completions polled
+    TRACE_EVENT_RFS_DISPATCH, // rfs, sinks
+    TRACE_EVENT_TIMER_BEGIN, // timer handler, 0
+    TRACE_EVENT_TIMER_END, // timer handler, 0
+    TRACE_EVENT_LOCK_BUSY, // ring, 0 for the RX lock and 1 for the TX lock
+    TRACE_EVENT_BPOOL_EXPAND, // buffer pool, buffers added
+    TRACE_EVENT_DOORBELL, // hw queue, WQE counter
+};
+
+struct trace_event_t {
+    uint64_t tsc;
+    uint64_t arg0;
+    uint32_t arg1;
+    uint16_t id;
+    uint16_t reserved;
+};
+
+struct trace_file_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_rings;
+    uint64_t tsc_rate; // TSC ticks per second
+};
+
+struct trace_file_ring_t {
+    uint32_t tid;
+    uint32_t num_events;
+    uint64_t total_events; // Events recorded by the thread, the older ones are overwritten
+};
+
+// Written by its thread only, a dump reads it concurrently
+struct trace_ring_t {
+    uint64_t head; // Events written, the next event goes to head & mask
+    uint32_t mask;
+    pid_t tid;
+    trace_ring_t *next;
+    trace_event_t events[];
+};
+
+// Events per ring, 0 if the tracing is disabled
+extern uint32_t g_trace_ring_events;
+extern thread_local trace_ring_t *g_p_trace_ring;
+
+void trace_ring_init(uint32_t num_events);
+trace_ring_t *trace_ring_create();
+// Writes the rings to <dirname>/xliotrace.<pid>, returns 0 on success
+int trace_ring_dump(const char *dirname);
+
+static inline void trace_ring_record(uint16_t id, uint64_t arg0, uint32_t arg1)
+{
+    trace_ring_t *ring = g_p_trace_ring;
+
+    if (unlikely(!ring)) {
+        ring = trace_ring_create();
+        if (!ring) {
+            return;
+        }
+    }
+
+    uint64_t head = ring->head;
+    trace_event_t &event = ring->events[head & ring->mask];
+    tscval_t tsc;
+    gettimeoftsc(&tsc);
+    event.tsc = tsc;
+    event.arg0 = arg0;
+    event.arg1 = arg1;
+    event.id = id;
+    // Publishes the event to a concurrent dump
+    __atomic_store_n(&ring->head, head + 1U, __ATOMIC_RELEASE);
+}
+
+#define XLIO_TRACE_RING(id, arg0, arg1)                                                            \
+    do {                                                                                           \
+        if (unlikely(g_trace_ring_events)) {                                                       \
+            trace_ring_record(id, (uint64_t)(arg0), (uint32_t)(arg1));                             \
+        }                                                                                          \
+    } while (0)
+
+#endif /* TRACE_RING_H */
@@ -17,6 +17,8 @@
 #include <linux/rtnetlink.h>
 #include <linux/sockios.h>
 #include <linux/netlink.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
 #include <math.h>
 #include <netinet/ip.h>
 #include <netinet/ip6.h>
@@ -258,15 +260,7 @@ void compute_tx_checksum(mem_buf_desc_t *p_mem_buf_desc, bool l3_csum, bool l4_c
 
 unsigned short compute_ip_checksum(const uint16_t *p_data, size_t sz_count)
 {
-    unsigned long sum = 0;
-
-    while (sz_count--) {
-        sum += *p_data;
-        p_data++;
-    }
-    sum = (sum >> 16) + (sum & 0xffff);
-    sum += (sum >> 16);
-    return ~sum;
+    return csum_fold(csum_partial(p_data, sz_count * sizeof(uint16_t), 0U));
 }
 
 unsigned short compute_ip_checksum(const iphdr *p_ip_h)
@@ -309,22 +303,7 @@ static uint32_t compute_pseudo_header(const ip6_hdr *ipv6, uint16_t proto, uint1
 static unsigned short compute_payload_checksum(const uint16_t *payload, uint16_t payload_len,
                                                uint32_t sum)
 {
-    while (payload_len > 1) {
-        sum += *payload++;
-        payload_len -= 2;
-    }
-
-    if (payload_len > 0) {
-        sum += ((*payload) & htons(0xFF00));
-    }
-    //
-    // Fold 32-bit sum to 16 bits: add carrier to result
-    while (sum >> 16) {
-        sum = (sum & 0xffff) + (sum >> 16);
-    }
-
-    sum = ~sum;
-    return static_cast<unsigned short>(sum);
+    return csum_fold(csum_partial(payload, payload_len, sum));
 }
 
 unsigned short compute_tcp_checksum(const iphdr *ipv4, const uint16_t *payload, uint16_t hdr_len)
@@ -379,41 +358,25 @@ unsigned short compute_udp_payload_checksum_rx(const struct udphdr *udphdrp,
                                                mem_buf_desc_t *p_rx_wc_buf_desc, uint16_t udp_len,
                                                uint32_t sum)
 {
-    const uint16_t *p_ip_payload = (const uint16_t *)udphdrp;
+    const void *p_ip_payload = udphdrp;
     mem_buf_desc_t *p_ip_frag = p_rx_wc_buf_desc;
-    unsigned short ip_frag_len = p_ip_frag->rx.frag.iov_len + sizeof(struct udphdr);
-    unsigned short ip_frag_remainder = ip_frag_len;
-
-    // add the IP payload
-    while (udp_len > 1) {
-        // Each packet but the last must contain a payload length that is a multiple of 8
-        if (!ip_frag_remainder && p_ip_frag->p_next_desc) {
-            p_ip_frag = p_ip_frag->p_next_desc;
-            p_ip_payload = (const uint16_t *)p_ip_frag->rx.frag.iov_base;
-            ip_frag_remainder = ip_frag_len = p_ip_frag->rx.frag.iov_len;
+    size_t ip_frag_len = p_ip_frag->rx.frag.iov_len + sizeof(struct udphdr);
+    size_t remainder = udp_len;
+
+    // Each fragment but the last carries a multiple of 8 bytes, the words stay aligned
+    while (remainder && p_ip_frag) {
+        size_t len = std::min(ip_frag_len, remainder);
+
+        sum = csum_partial(p_ip_payload, len, sum);
+        remainder -= len;
+        p_ip_frag = p_ip_frag->p_next_desc;
+        if (p_ip_frag) {
+            p_ip_payload = p_ip_frag->rx.frag.iov_base;
+            ip_frag_len = p_ip_frag->rx.frag.iov_len;
         }
-
-        while (ip_frag_remainder > 1) {
-            sum += *p_ip_payload++;
-            ip_frag_remainder -= 2;
-        }
-
-        udp_len -= (ip_frag_len - ip_frag_remainder);
-    }
-
-    // if any bytes left, pad the bytes and add
-    if (udp_len > 0) {
-        sum += ((*p_ip_payload) & htons(0xFF00));
     }
 
-    // Fold sum to 16 bits: add carrier to result
-    while (sum >> 16) {
-        sum = (sum & 0xffff) + (sum >> 16);
-    }
-
-    sum = ~sum;
-    // computation result
-    return (unsigned short)sum;
+    return csum_fold(sum);
 }
 
 /* set udp checksum: given IP header and UDP datagram
@@ -1294,6 +1257,60 @@ int validate_lro(int if_index)
 #endif
 }
 
+int get_ib_device_numa_node(const char *ibname)
+{
+    char path[256] = {0};
+
+    snprintf(path, sizeof(path), IB_DEVICE_NUMA_NODE_PARAM_FILE, ibname);
+    // The kernel reports -1 for a device without NUMA affinity
+    return read_file_to_int(path, -1, VLOG_DEBUG);
+}
+
+int get_current_numa_node()
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+
+    // libnuma is not a dependency, getcpu() wrapper is missing in older glibc
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+
+numa_preferred_scope::numa_preferred_scope(int node)
+    : m_prev_mask {}
+    , m_prev_mode(MPOL_DEFAULT)
+    , m_applied(false)
+{
+    const int bits = 8 * sizeof(unsigned long);
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+
+    if (node < 0 || node >= MAX_NODES) {
+        return;
+    }
+    if (syscall(SYS_get_mempolicy, &m_prev_mode, m_prev_mask, MAX_NODES, nullptr, 0) != 0) {
+        __log_dbg("get_mempolicy failed (errno=%d %m)", errno);
+        return;
+    }
+
+    mask[node / bits] = 1UL << (node % bits);
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, MAX_NODES) != 0) {
+        __log_dbg("set_mempolicy failed for node %d (errno=%d %m)", node, errno);
+        return;
+    }
+    m_applied = true;
+}
+
+numa_preferred_scope::~numa_preferred_scope()
+{
+    if (m_applied &&
+        syscall(SYS_set_mempolicy, m_prev_mode,
+                m_prev_mode == MPOL_DEFAULT ? nullptr : m_prev_mask, MAX_NODES) != 0) {
+        __log_dbg("Failed to restore memory policy (errno=%d %m)", errno);
+    }
+}
+
 loops_timer::loops_timer()
 {
     m_timeout_msec = -1;
@@ -21,6 +21,7 @@
 #include "vlogger/vlogger.h"
 #include "core/proto/mem_buf_desc.h"
 #include "core/util/xlio_exception.h"
+#include "core/util/checksum.h"
 
 #ifndef ARRAY_SIZE
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -301,6 +302,38 @@ int validate_tso(int if_index);
  */
 int validate_lro(int if_index);
 
+/**
+ * Get the NUMA node of an IB device
+ *
+ * @param ibname input IB device name (e.g. mlx5_0)
+ * @return node number or -1 if unknown
+ */
+int get_ib_device_numa_node(const char *ibname);
+
+/**
+ * Get the NUMA node of the CPU the calling thread runs on
+ *
+ * @return node number or -1 on failure
+ */
+int get_current_numa_node();
+
+/**
+ * Prefer a NUMA node for the memory allocated by the calling thread until the end of the scope.
+ * The previous memory policy of the thread is restored on destruction.
+ * Nothing is done for a negative node.
+ */
+class numa_preferred_scope {
+public:
+    numa_preferred_scope(int node);
+    ~numa_preferred_scope();
+
+private:
+    enum { MAX_NODES = 1024 };
+    unsigned long m_prev_mask[MAX_NODES / (8 * sizeof(unsigned long))];
+    int m_prev_mode;
+    bool m_applied;
+};
+
 inline std::string to_string_val(const int &k)
 {
     return std::to_string(k);
@@ -361,6 +394,20 @@ inline void create_multicast_mac_from_ip(unsigned char *mc_mac, const ip_address
     }
 }
 
+// The lowest group that create_multicast_mac_from_ip() maps to the same MAC as addr
+inline ip_address create_multicast_mac_group(const ip_address &addr, sa_family_t family)
+{
+    if (family == AF_INET) {
+        return ip_address((addr.get_in_addr() & htonl(0x007fffffU)) | htonl(0xe0000000U));
+    }
+
+    in6_addr ip;
+    memset(&ip, 0, sizeof(ip));
+    ip.s6_addr[0] = 0xff;
+    memcpy(&ip.s6_addr[12], &addr.get_in6_addr().s6_addr[12], 4);
+    return ip_address(ip);
+}
+
 // @scope Returns the scope of the address.
 // @return The type of the address. @see ip_address
 uint16_t ipv6_addr_type_scope(const ip_address &addr, uint8_t &scope);
@@ -508,40 +555,23 @@ static inline bool is_ilog2(unsigned int x)
 
 inline uint16_t calc_sum_of_payload(const iovec *p_iov, const ssize_t sz_iov)
 {
-    uint32_t sum = 0;
+    uint64_t sum = 0;
     bool prev_iov_unaligned = false;
 
     for (ssize_t i = 0; i < sz_iov; i++) {
         size_t iov_len = p_iov[i].iov_len;
-        uint16_t *iov_data = reinterpret_cast<uint16_t *>(p_iov[i].iov_base);
 
-        if (unlikely(!iov_data) || unlikely(iov_len <= 0U)) {
+        if (unlikely(!p_iov[i].iov_base) || unlikely(iov_len <= 0U)) {
             continue;
         }
 
-        // alignment to 16-bits, since checksum is calculated per each 16-bits
-        if (prev_iov_unaligned) {
-            sum += ((*iov_data) & htons(0xFF00)) << 8;
-            iov_data =
-                reinterpret_cast<uint16_t *>(reinterpret_cast<u_int8_t *>(p_iov[i].iov_base) + 1);
-            iov_len -= 1;
-        }
-
-        while (iov_len > 1) {
-            sum += *iov_data++;
-            iov_len -= 2;
-        }
-
-        if ((prev_iov_unaligned = (iov_len > 0))) {
-            sum += ((*iov_data) & htons(0xFF00));
-        }
-    }
-
-    while (sum >> 16) {
-        sum = (sum & 0xffff) + (sum >> 16);
+        // The sum of the words which start at an odd offset is the byte swapped sum
+        uint16_t iov_sum = csum_fold16(csum_partial(p_iov[i].iov_base, iov_len, 0U));
+        sum += prev_iov_unaligned ? __builtin_bswap16(iov_sum) : iov_sum;
+        prev_iov_unaligned ^= (iov_len & 1U);
     }
 
-    return static_cast<uint16_t>(sum);
+    return csum_fold16(sum);
 }
 
 #endif
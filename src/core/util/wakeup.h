@@ -19,8 +19,9 @@ public:
     virtual ~wakeup() {};
     virtual bool is_wakeup_fd(int fd) = 0;
     virtual void remove_wakeup_fd() = 0;
-    void going_to_sleep();
+    virtual void going_to_sleep();
     void return_from_sleep() { --m_is_sleeping; };
+    bool is_sleeping() const { return m_is_sleeping > 0; }
     void wakeup_clear() { m_is_sleeping = 0; }
     void wakeup_set_epoll_fd(int epfd);
 
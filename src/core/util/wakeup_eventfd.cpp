@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2021-2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <sys/eventfd.h>
+#include "utils/bullseye.h"
+#include "vlogger/vlogger.h"
+#include "wakeup_eventfd.h"
+#include "sock/sock-redirect.h"
+
+#define MODULE_NAME "wakeup_eventfd"
+
+#define wkup_logpanic   __log_info_panic
+#define wkup_logerr     __log_info_err
+#define wkup_logwarn    __log_info_warn
+#define wkup_loginfo    __log_info_info
+#define wkup_logdbg     __log_info_dbg
+#define wkup_logfunc    __log_info_func
+#define wkup_logfuncall __log_info_funcall
+#define wkup_entry_dbg  __log_entry_dbg
+
+#undef MODULE_HDR_INFO
+#define MODULE_HDR_INFO MODULE_NAME "[epfd=%d]:%d:%s() "
+#undef __INFO__
+#define __INFO__         m_wakeup_epfd
+#define UNINIT_WAKEUP_FD (-1)
+
+wakeup_eventfd::wakeup_eventfd()
+    : m_wakeup_fd(UNINIT_WAKEUP_FD)
+    , m_wakeup_fd_epfd(0)
+    , m_wakeup_pending(false)
+{
+}
+
+bool wakeup_eventfd::prepare_wakeup_fd()
+{
+    int errno_tmp = errno;
+
+    if (m_wakeup_fd < 0) {
+        m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        BULLSEYE_EXCLUDE_BLOCK_START
+        if (m_wakeup_fd < 0) {
+            wkup_logerr("wakeup eventfd create failed (errno=%d %m)", errno);
+            errno = errno_tmp;
+            return false;
+        }
+        BULLSEYE_EXCLUDE_BLOCK_END
+        wkup_logdbg("created wakeup eventfd %d", m_wakeup_fd);
+    }
+
+    // The epfd of the owner has changed, the previous one may be closed already
+    if (m_wakeup_fd_epfd > 0) {
+        SYSCALL(epoll_ctl, m_wakeup_fd_epfd, EPOLL_CTL_DEL, m_wakeup_fd, nullptr);
+    }
+    m_wakeup_fd_epfd = 0;
+
+    // Edge triggered, every write is reported once and there is nothing to drain
+    m_ev.events = EPOLLIN | EPOLLET;
+    m_ev.data.fd = m_wakeup_fd;
+    BULLSEYE_EXCLUDE_BLOCK_START
+    if (SYSCALL(epoll_ctl, m_wakeup_epfd, EPOLL_CTL_ADD, m_wakeup_fd, &m_ev) && errno != EEXIST) {
+        wkup_logerr("Failed to add wakeup fd to internal epfd (errno=%d %m)", errno);
+        errno = errno_tmp;
+        return false;
+    }
+    BULLSEYE_EXCLUDE_BLOCK_END
+    m_wakeup_fd_epfd = m_wakeup_epfd;
+    errno = errno_tmp;
+    return true;
+}
+
+void wakeup_eventfd::going_to_sleep()
+{
+    if (unlikely(m_wakeup_epfd > 0 && m_wakeup_fd_epfd != m_wakeup_epfd)) {
+        prepare_wakeup_fd();
+    }
+    wakeup::going_to_sleep();
+}
+
+void wakeup_eventfd::do_wakeup()
+{
+    wkup_logfuncall("");
+
+    // This func should be called under socket / epoll lock
+
+    // Call to wakeup only in case there is some thread that is sleeping on epoll
+    if (!m_is_sleeping) {
+        wkup_logfunc("There is no thread in epoll_wait, therefore not calling for wakeup");
+        return;
+    }
+
+    // A sleeper is about to wake up already
+    if (m_wakeup_pending.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    wkup_entry_dbg("");
+
+    int errno_tmp = errno; // don't let wakeup affect errno
+    uint64_t val = 1U;
+    BULLSEYE_EXCLUDE_BLOCK_START
+    if (m_wakeup_fd < 0 || SYSCALL(write, m_wakeup_fd, &val, sizeof(val)) != sizeof(val)) {
+        wkup_logerr("Failed to write wakeup eventfd %d (errno=%d %m)", m_wakeup_fd, errno);
+        m_wakeup_pending.store(false, std::memory_order_relaxed);
+    }
+    BULLSEYE_EXCLUDE_BLOCK_END
+    errno = errno_tmp;
+}
+
+void wakeup_eventfd::remove_wakeup_fd()
+{
+    wkup_entry_dbg("");
+    // The counter isn't read, the next write makes a new edge anyway
+    m_wakeup_pending.store(false, std::memory_order_release);
+}
+
+wakeup_eventfd::~wakeup_eventfd()
+{
+    if (m_wakeup_fd >= 0) {
+        SYSCALL(close, m_wakeup_fd);
+        m_wakeup_fd = UNINIT_WAKEUP_FD;
+    }
+}
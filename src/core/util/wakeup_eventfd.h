@@ -0,0 +1,39 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2021-2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef WAKEUP_EVENTFD_H
+#define WAKEUP_EVENTFD_H
+
+/**
+ * wakeup class that adds a wakeup functionality to socket (tcp and udp) and epoll using a
+ * per waiter eventfd.
+ *
+ * The eventfd is created on the first sleep and stays in the epfd as edge triggered, a wakeup
+ * is a single write which only the sleepers of this epfd see. The wakeups are coalesced until
+ * a sleeper consumes the pending one.
+ */
+#include <atomic>
+#include "wakeup.h"
+
+class wakeup_eventfd : public wakeup {
+public:
+    wakeup_eventfd(void);
+    ~wakeup_eventfd();
+    void do_wakeup();
+    void going_to_sleep() override;
+    virtual inline bool is_wakeup_fd(int fd) { return fd == m_wakeup_fd && fd >= 0; };
+    virtual void remove_wakeup_fd();
+
+private:
+    bool prepare_wakeup_fd();
+
+    int m_wakeup_fd;
+    // epfd the eventfd was added to
+    int m_wakeup_fd_epfd;
+    std::atomic<bool> m_wakeup_pending;
+};
+
+#endif /* WAKEUP_EVENTFD_H */
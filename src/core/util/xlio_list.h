@@ -293,6 +293,13 @@ public:
         return false;
     }
 
+    // Move the elements ahead of obj to the tail keeping their order, obj becomes the front
+    void rotate_to_front(T *obj)
+    {
+        list_node<T, offset> *node_obj = GET_NODE(obj, T, offset);
+        list_move_tail(&m_list.head, &node_obj->head);
+    }
+
 #if VLIST_DEBUG
     char *list_id() { return (char *)&id; }
 #endif
@@ -9,6 +9,7 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <algorithm>
 #include <bitset>
 #include <netinet/in.h>
 #include <linux/if.h>
@@ -27,7 +28,12 @@
 #define NUM_OF_SUPPORTED_BPOOLS      4
 #define NUM_OF_SUPPORTED_GLOBALS     1
 #define NUM_OF_SUPPORTED_EPFDS       32
-#define SHMEM_STATS_SIZE(fds_num)    sizeof(sh_mem_t) + (fds_num * sizeof(socket_instance_block_t))
+#define NUM_OF_SUPPORTED_POLL_GROUPS 16
+#define NUM_OF_SUPPORTED_LOCKS       64
+#define LOCK_NAME_LEN                32
+#define SHMEM_STATS_SIZE(fds_num)                                                                  \
+    (sizeof(sh_mem_t) + ((fds_num) * sizeof(socket_instance_block_t)))
+#define SHMEM_STATS_FD_NUM_INITIAL   1024U // Socket blocks allocated when the stats file is created
 #define MC_TABLE_SIZE                1024
 #define MAP_SH_MEM(var, sh_stats)    var = (sh_mem_t *)sh_stats
 #define STATS_PUBLISHER_TIMER_PERIOD 10 // publisher will check for stats request every 10 msec
@@ -44,6 +50,7 @@ typedef enum {
     DUMP_FD,
     DUMP_ROUTE,
     DUMP_NEIGH,
+    DUMP_TRACE,
 } dump_type_t;
 
 // Common iomux stats
@@ -56,11 +63,22 @@ typedef struct {
     uint32_t n_iomux_rx_ready;
     uint32_t n_iomux_os_rx_ready;
     uint32_t n_iomux_polling_time;
+    uint32_t n_iomux_rx_poll_skipped; // Ring polls skipped, the ring had nothing to process
 } iomux_func_stats_t;
 
 typedef enum { e_totals = 1, e_deltas } print_details_mode_t;
 
-typedef enum { e_basic = 1, e_medium, e_full, e_mc_groups, e_netstat_like, e_entctx } view_mode_t;
+typedef enum {
+    e_basic = 1,
+    e_medium,
+    e_full,
+    e_mc_groups,
+    e_netstat_like,
+    e_entctx,
+    e_poll_groups,
+    e_poll_efficiency,
+    e_lock_contention
+} view_mode_t;
 
 typedef enum { e_by_pid_str, e_by_app_name, e_by_runn_proccess } proc_ident_mode_t;
 
@@ -80,6 +98,7 @@ struct user_params_t {
     vlog_levels_t fd_dump_log_level;
     std::string xlio_stats_path;
     std::ofstream csv_stream;
+    std::string exporter_addr;
 };
 
 extern user_params_t user_params;
@@ -89,7 +108,7 @@ typedef struct {
     iomux_func_stats_t stats;
     int epfd;
     bool enabled;
-    PADDING(27); // Pad to cache line boundary
+    PADDING(23); // Pad to cache line boundary
 } epoll_stats_t;
 
 CACHELINE_BOUNDARY_SIZE_ASSERT(epoll_stats_t);
@@ -99,7 +118,7 @@ typedef struct {
     iomux_func_stats_t poll;
     iomux_func_stats_t select;
     epoll_stats_t epoll[NUM_OF_SUPPORTED_EPFDS];
-    PADDING(0); // Pad to cache line boundary
+    PADDING(56); // Pad to cache line boundary
 } iomux_stats_t;
 
 CACHELINE_BOUNDARY_SIZE_ASSERT(iomux_stats_t);
@@ -115,6 +134,64 @@ typedef struct {
     mc_tbl_entry_t mc_grp_tbl[MC_TABLE_SIZE];
 } mc_grp_info_t;
 
+/*
+ * Log bucketed latency histogram in TSC ticks, two buckets per power of two. The buckets 0 and
+ * 1 hold the values 0 and 1, bucket 2n the values from 2^n and bucket 2n+1 the values from
+ * 2^n + 2^(n-1). The last bucket holds everything from 2^31 + 2^30 ticks.
+ */
+#define LAT_HIST_BUCKETS 64U
+
+typedef struct {
+    uint64_t buckets[LAT_HIST_BUCKETS];
+} lat_hist_t;
+
+static inline uint32_t lat_hist_bucket(uint64_t ticks)
+{
+    if (ticks < 2U) {
+        return static_cast<uint32_t>(ticks);
+    }
+    uint32_t msb = 63U - __builtin_clzll(ticks);
+    uint32_t idx = (msb << 1U) | ((ticks >> (msb - 1U)) & 1U);
+    return std::min(idx, LAT_HIST_BUCKETS - 1U);
+}
+
+// Lowest value of the bucket in TSC ticks
+static inline uint64_t lat_hist_bucket_min(uint32_t idx)
+{
+    if (idx < 2U) {
+        return idx;
+    }
+    uint32_t msb = idx >> 1U;
+    return (1ULL << msb) | (static_cast<uint64_t>(idx & 1U) << (msb - 1U));
+}
+
+// The samples are added by a single thread, a reader may see a partial update only
+static inline void lat_hist_add(lat_hist_t *hist, uint64_t ticks)
+{
+    ++hist->buckets[lat_hist_bucket(ticks)];
+}
+
+// Latency histograms of a socket or a ring, recorded if monitor.stats.latency_hist is enabled
+typedef struct {
+    lat_hist_t rx_dwell; // RX packet queued to the socket ready list until read
+    lat_hist_t tx_complete; // TCP send call until the ACK of its last byte
+    lat_hist_t ack_rtt; // TCP segment transmission until its ACK
+} lat_hists_t;
+
+// TCP loss recovery events and the time the sender was limited by each of the limits
+typedef struct {
+    uint32_t n_rto; // Retransmission timeouts
+    uint32_t n_recovery; // Fast recoveries
+    uint32_t n_tlp; // Tail loss probes
+    uint32_t n_spurious_rexmit; // Retransmissions delivered by the original transmission
+    uint32_t n_zero_wnd; // Times the remote host closed the window
+    uint32_t reserved;
+    uint64_t rwnd_limited_usec; // The window of the remote host
+    uint64_t cwnd_limited_usec; // The congestion window
+    uint64_t sndbuf_limited_usec; // A send waits for the send buffer
+    uint64_t app_limited_usec; // All the data is in flight, the application doesn't send more
+} tcp_loss_stats_t;
+
 // socket stat info
 typedef struct {
     uint32_t n_rx_packets;
@@ -149,6 +226,13 @@ typedef struct {
     uint32_t n_rx_data_pkts;
     uint32_t n_rx_frags;
     uint32_t n_gro;
+    uint32_t n_rx_compacted;
+    uint32_t n_rx_budget_limited;
+    uint32_t n_rx_placed; // Packets copied by the RX path into a pending MSG_WAITALL read
+    uint32_t n_rx_wnd_max;
+    uint32_t n_rx_wnd_grows;
+    uint32_t n_rx_wnd_shrinks;
+    uint32_t n_tx_sack_retransmits;
 } socket_counters_t;
 
 #ifdef DEFINED_UTLS
@@ -158,6 +242,7 @@ typedef struct {
     uint32_t n_tls_tx_records;
     uint32_t n_tls_tx_resync;
     uint32_t n_tls_tx_resync_replay;
+    uint32_t n_tls_tx_key_updates;
     uint32_t n_tls_rx_records;
     uint32_t n_tls_rx_records_full_enc;
     uint32_t n_tls_rx_records_head_enc;
@@ -181,6 +266,8 @@ typedef struct socket_listen_counters {
     uint32_t n_conn_established;
     uint32_t n_conn_accepted;
     uint32_t n_conn_dropped;
+    uint32_t n_syncookies_sent;
+    uint32_t n_syncookies_validated;
     int n_conn_backlog;
 
     socket_listen_counters() = default;
@@ -194,6 +281,8 @@ typedef struct socket_listen_counters {
         n_conn_established += rhs.n_conn_established;
         n_conn_accepted += rhs.n_conn_accepted;
         n_conn_dropped += rhs.n_conn_dropped;
+        n_syncookies_sent += rhs.n_syncookies_sent;
+        n_syncookies_validated += rhs.n_syncookies_validated;
         n_conn_backlog += rhs.n_conn_backlog;
         return *this;
     }
@@ -205,6 +294,8 @@ typedef struct socket_listen_counters {
                 n_conn_established - rhs.n_conn_established,
                 n_conn_accepted - rhs.n_conn_accepted,
                 n_conn_dropped - rhs.n_conn_dropped,
+                n_syncookies_sent - rhs.n_syncookies_sent,
+                n_syncookies_validated - rhs.n_syncookies_validated,
                 n_conn_backlog - rhs.n_conn_backlog};
     }
 } socket_listen_counters_t;
@@ -215,12 +306,20 @@ struct socket_stats_t {
     uint64_t n_rx_ready_byte_count;
     uint32_t n_rx_ready_pkt_count;
     uint32_t tcp_state; // enum tcp_state
+    // TCP_INFO snapshot of the connection
+    uint32_t tcp_snd_cwnd; // In segments
+    uint32_t tcp_rtt_usec;
+    uint32_t tcp_unacked; // Segments in flight
+    uint32_t tcp_rcv_wnd;
+    uint32_t tcp_mss; // Effective, follows the path MTU discovery
     socket_counters_t counters;
     socket_strq_counters_t strq_counters;
 #ifdef DEFINED_UTLS
     socket_tls_counters_t tls_counters;
 #endif /* DEFINED_UTLS */
     socket_listen_counters_t listen_counters;
+    lat_hists_t lat_hists;
+    tcp_loss_stats_t tcp_loss;
 
     // Control Path
     std::bitset<MC_TABLE_SIZE> mc_grp_map;
@@ -238,6 +337,10 @@ struct socket_stats_t {
     sa_family_t sa_family;
     in_port_t bound_port;
     in_port_t connected_port;
+    // A listen RSS child: the listen socket, the worker index and the source port buckets
+    int listen_parent_fd;
+    uint16_t listen_child_index;
+    uint16_t listen_buckets; // 0 for the other sockets
     uint8_t socket_type; // SOCK_STREAM, SOCK_DGRAM, ...
     bool b_is_offloaded;
     bool b_blocking;
@@ -254,11 +357,14 @@ struct socket_stats_t {
     {
         fd = 0;
         inode = tcp_state = 0;
+        tcp_snd_cwnd = tcp_rtt_usec = tcp_unacked = tcp_rcv_wnd = tcp_mss = 0;
         socket_type = 0;
         sa_family = 0;
         b_is_offloaded = b_blocking = b_mc_loop = false;
         bound_if = connected_ip = mc_tx_if = ip_address(in6addr_any);
         bound_port = connected_port = (in_port_t)0;
+        listen_parent_fd = 0;
+        listen_child_index = listen_buckets = 0;
         threadid_last_rx = threadid_last_tx = pid_t(0);
         n_rx_ready_pkt_count = n_rx_ready_byte_count = n_tx_ready_byte_count = 0;
         memset(&counters, 0, sizeof(counters));
@@ -269,6 +375,8 @@ struct socket_stats_t {
 #endif /* DEFINED_UTLS */
         memset(&strq_counters, 0, sizeof(strq_counters));
         memset(&listen_counters, 0, sizeof(listen_counters));
+        memset(&lat_hists, 0, sizeof(lat_hists));
+        memset(&tcp_loss, 0, sizeof(tcp_loss));
         mc_grp_map.reset();
         ring_user_id_rx = ring_user_id_tx = 0;
         ring_alloc_logic_rx = ring_alloc_logic_tx = RING_LOGIC_PER_INTERFACE;
@@ -313,6 +421,17 @@ typedef struct {
     }
 } socket_instance_block_t;
 
+/*
+ * Productive RX polls by the CQEs they returned, the bucket n holds the polls of 2^n to
+ * 2^(n+1) - 1 CQEs and the last bucket everything from 32 CQEs.
+ */
+#define CQ_POLL_HIST_BUCKETS 6U
+
+static inline uint32_t cq_poll_hist_bucket(uint32_t cqes)
+{
+    return std::min(31U - __builtin_clz(cqes), CQ_POLL_HIST_BUCKETS - 1U);
+}
+
 // CQ stat info
 typedef struct {
     uint64_t n_rx_stride_count;
@@ -325,17 +444,25 @@ typedef struct {
     uint64_t n_rx_gro_packets;
     uint64_t n_rx_gro_bytes;
     uint64_t n_rx_gro_frags;
+    uint64_t n_rx_gro_held; // GRO aggregates kept open at the end of a poll, for the deadline
+    uint64_t n_rx_cqe_zip_packets;
+    uint64_t n_rx_empty_polls; // RX polls which found no CQE
+    uint64_t n_rx_poll_tsc; // TSC ticks from the first CQE of a poll until the socket enqueue
+    uint64_t n_rx_poll_cqes_hist[CQ_POLL_HIST_BUCKETS];
     uint32_t n_rx_sw_queue_len;
     uint32_t n_rx_drained_at_once_max;
     uint32_t n_buffer_pool_len;
     uint32_t n_rx_cqe_error;
+    uint32_t n_rx_cqe_zip_sessions;
+    uint32_t n_rx_stride_size;
+    uint32_t n_rx_strides_per_rwqe;
     uint16_t n_rx_max_stirde_per_packet;
 } cq_stats_t;
 
 typedef struct {
     cq_stats_t cq_stats;
     bool b_enabled;
-    PADDING(23); // Pad to cache line boundary
+    PADDING(63); // Pad to cache line boundary
 } cq_instance_block_t;
 
 CACHELINE_BOUNDARY_SIZE_ASSERT(cq_instance_block_t);
@@ -374,12 +501,41 @@ typedef struct {
     uint64_t n_tx_dev_mem_oob;
     uint32_t n_tx_dev_mem_allocated;
     uint32_t n_rx_steering_rules;
+    uint64_t n_tx_db_saved; // Doorbells avoided by the batched poll group flush
+    uint64_t n_rx_poll_cqes; // RX completions processed by the CQ polling
+    uint64_t n_rx_poll_budget_hits; // Polls stopped by the poll budget with the CQ not drained
+    uint64_t n_tx_wqes; // TX WQEs posted to the SQ
+    uint64_t n_tx_wqes_signaled; // TX WQEs which requested a completion
+    // Inputs of the last target latency moderation decision
+    uint32_t n_rx_cq_moderation_gap_usec; // Median gap between RX bursts
+    uint32_t n_rx_cq_moderation_burst; // 90th percentile of RX burst size
+    uint32_t n_rx_cq_moderation_target_frames; // Frames expected within the target latency
+    uint32_t n_rx_cq_moderation_decisions;
+    uint32_t n_bond_failovers; // Restarts of the bond this ring is a slave of
+    uint32_t n_bond_failover_usec; // Duration of the last bond restart
+    int32_t n_numa_node; // NUMA node of the ring device, -1 if unknown
+    uint32_t n_numa_cross_allocs; // Buffer allocations requested from a CPU of another node
+    uint64_t n_tx_odp_pkt_count; // Packets which referenced the implicit ODP region
+    uint64_t n_tx_odp_byte_count;
+    uint64_t n_tx_doorbells; // Doorbells rung on the SQ
+    uint64_t n_tx_bf_wqes; // TX WQEs pushed through BlueFlame instead of fetched by the HW
+    uint64_t n_tx_mpwqe_sessions; // Multi-packet WQEs posted
+    uint64_t n_tx_mpwqe_pkts; // Packets packed into the multi-packet WQEs
+    uint64_t n_rx_filter_drops; // Packets dropped by the Ultra API RX filter
+    uint64_t n_rx_filter_redirects; // Packets taken over by the Ultra API RX filter
+    uint32_t n_queue_page_size; // Page size of the CQ/QP buffers, 0 if allocated by rdma-core
+    uint32_t n_rx_steering_rule_fails; // Deferred steering rules which failed to be created
+
+    // Aggregate of the socket latency histograms, the sockets of different threads may race
+    lat_hists_t lat_hists;
+    // Aggregate of the TCP sockets, added on the TCP timer and the state changes
+    tcp_loss_stats_t tcp_loss;
 } ring_stats_t;
 
 typedef struct {
     ring_stats_t ring_stats;
     bool b_enabled;
-    PADDING(31); // Pad to cache line boundary
+    PADDING(23); // Pad to cache line boundary
 } ring_instance_block_t;
 
 CACHELINE_BOUNDARY_SIZE_ASSERT(ring_instance_block_t);
@@ -388,8 +544,12 @@ typedef struct {
     int64_t idle_time;
     int64_t hit_poll_time;
     int64_t job_proc_time;
+    // Parts of idle_time spent in the CPU pause and sleeping
+    int64_t idle_pause_time;
+    int64_t idle_block_time;
     uint64_t socket_num_added;
     uint64_t socket_num_removed;
+    uint64_t socket_num_stolen;
     uint32_t listen_rsschild_num;
     uint32_t job_queue_size_max;
     uint32_t job_queue_size_acc;
@@ -400,17 +560,64 @@ typedef struct {
     entity_context_stats_t entity_ctx_stats;
     uint32_t tot_socket;
     bool b_enabled;
-    PADDING(3); // Pad to cache line boundary
+    PADDING(43); // Pad to cache line boundary
 } entity_context_instance_block_t;
 
 CACHELINE_BOUNDARY_SIZE_ASSERT(entity_context_instance_block_t);
 
+// Ultra API poll group stat info, updated by the group owner thread only
+typedef struct {
+    uint64_t n_poll_iterations;
+    uint64_t n_poll_empty;
+    uint64_t n_rx_pkts; // Buffers delivered to the RX callbacks
+    uint64_t n_tx_ops; // Successful send operations
+    uint64_t n_dirty_flushes; // Sockets flushed by xlio_poll_group_flush()
+    uint64_t n_slow_path_runs;
+    uint64_t n_rx_cb_tsc; // Time spent in the RX callbacks in TSC ticks, with latency_hist only
+    uint64_t n_conn_pool_hits; // Connections handed out by the connection pools
+    uint64_t n_conn_pool_misses; // Requests to a pool without an established connection
+    uint64_t n_conn_pool_warmups; // Pooled connections established
+    uint64_t n_conn_pool_warmup_tsc; // Connect to established time of the warmups in TSC ticks
+    uint32_t n_sockets;
+} poll_group_stats_t;
+
+typedef struct {
+    poll_group_stats_t poll_group_stats;
+    bool b_enabled;
+    PADDING(31); // Pad to cache line boundary
+} poll_group_instance_block_t;
+
+CACHELINE_BOUNDARY_SIZE_ASSERT(poll_group_instance_block_t);
+
+/*
+ * Lock contention stat info, recorded if monitor.stats.lock_profiling is enabled. The locks are
+ * aggregated by name, an acquisition is contended if the lock was busy on the first try.
+ */
+typedef struct {
+    uint64_t n_acquired;
+    uint64_t n_contended;
+    uint64_t n_trylock_failed;
+    uint64_t n_wait_tsc; // Spin or sleep time of the contended acquisitions in TSC ticks
+    lat_hist_t wait_hist; // Wait time of the contended acquisitions
+} lock_stats_t;
+
+typedef struct lock_instance_block_t {
+    lock_stats_t lock_stats;
+    char name[LOCK_NAME_LEN];
+    bool b_enabled;
+    PADDING(63); // Pad to cache line boundary
+} lock_instance_block_t;
+
+CACHELINE_BOUNDARY_SIZE_ASSERT(lock_instance_block_t);
+
 // Buffer Pool stat info
 typedef struct {
     uint32_t n_buffer_pool_size;
     uint32_t n_buffer_pool_no_bufs;
     uint32_t n_buffer_pool_expands;
     uint32_t n_buffer_pool_created;
+    uint32_t n_buffer_pool_cache_hits;
+    uint32_t n_buffer_pool_cache_misses;
     bool is_rx;
     bool is_tx;
 } bpool_stats_t;
@@ -418,7 +625,7 @@ typedef struct {
 typedef struct {
     bpool_stats_t bpool_stats;
     bool b_enabled;
-    PADDING(11); // Pad to half cache line boundary
+    PADDING(3); // Pad to half cache line boundary
 } bpool_instance_block_t;
 
 BOUNDARY_SIZE_ASSERT(bpool_instance_block_t, CACHELINE_SIZE / 2);
@@ -428,6 +635,12 @@ typedef struct {
     uint32_t n_tcp_seg_pool_size;
     uint32_t n_tcp_seg_pool_no_segs;
     int n_pending_sockets;
+    uint32_t n_rx_pool_pressure_events;
+    uint32_t n_agent_msgs; // State messages queued for the daemon
+    uint32_t n_agent_batches; // Datagrams sent to the daemon
+    uint32_t n_agent_send_deferred; // Sends retried on the next tick, the daemon queue was full
+    uint32_t n_agent_msgs_dropped;
+    uint32_t n_agent_wait_queue; // Messages waiting for the daemon
     std::atomic<int> socket_tcp_destructor_counter;
     std::atomic<int> socket_udp_destructor_counter;
     void init()
@@ -435,6 +648,12 @@ typedef struct {
         n_tcp_seg_pool_size = 0;
         n_tcp_seg_pool_no_segs = 0;
         n_pending_sockets = 0;
+        n_rx_pool_pressure_events = 0;
+        n_agent_msgs = 0;
+        n_agent_batches = 0;
+        n_agent_send_deferred = 0;
+        n_agent_msgs_dropped = 0;
+        n_agent_wait_queue = 0;
         socket_tcp_destructor_counter = 0;
         socket_udp_destructor_counter = 0;
     }
@@ -450,6 +669,52 @@ typedef struct {
     };
 } global_instance_block_t;
 
+/*
+ * Runtime tuning of the hot parameters by xlio_stats --tune. The reader writes param and value and
+ * increments req_seq, the publisher timer applies the request and stores the status, 0 or a
+ * negative errno, and then ack_seq = req_seq. values[] are the parameters in effect.
+ */
+typedef enum {
+    TUNE_RX_POLL_NUM,
+    TUNE_SELECT_POLL_NUM,
+    TUNE_CQ_MODERATION_COUNT,
+    TUNE_CQ_MODERATION_PERIOD_USEC,
+    TUNE_CQ_AIM_MAX_COUNT,
+    TUNE_CQ_AIM_MAX_PERIOD_USEC,
+    TUNE_CQ_AIM_INTERRUPTS_RATE_PER_SEC,
+    TUNE_TCP_NODELAY,
+    TUNE_TCP_QUICKACK,
+    TUNE_GRO_STREAMS_MAX,
+    TUNE_PARAM_NUM
+} tune_param_t;
+
+// The parameters are named after their environment variables
+static inline const char *tune_param_name(uint32_t param)
+{
+    static const char *const names[TUNE_PARAM_NUM] = {"XLIO_RX_POLL",
+                                                      "XLIO_SELECT_POLL",
+                                                      "XLIO_CQ_MODERATION_COUNT",
+                                                      "XLIO_CQ_MODERATION_PERIOD_USEC",
+                                                      "XLIO_CQ_AIM_MAX_COUNT",
+                                                      "XLIO_CQ_AIM_MAX_PERIOD_USEC",
+                                                      "XLIO_CQ_AIM_INTERRUPTS_RATE_PER_SEC",
+                                                      "XLIO_TCP_NODELAY",
+                                                      "XLIO_TCP_QUICKACK",
+                                                      "XLIO_GRO_STREAMS_MAX"};
+
+    return param < TUNE_PARAM_NUM ? names[param] : nullptr;
+}
+
+typedef struct {
+    uint32_t req_seq;
+    uint32_t ack_seq;
+    uint32_t param; // tune_param_t
+    int32_t status;
+    int64_t value;
+    int64_t values[TUNE_PARAM_NUM];
+    uint32_t n_changes; // Requests applied since the start
+} tune_info_t;
+
 // Version info
 typedef struct {
     uint8_t xlio_lib_maj;
@@ -463,6 +728,8 @@ typedef struct sh_mem_t {
     ring_instance_block_t ring_inst_arr[NUM_OF_SUPPORTED_RINGS];
     entity_context_instance_block_t ent_ctx_inst_arr[NUM_OF_SUPPORTED_ENTITY_CTX];
     bpool_instance_block_t bpool_inst_arr[NUM_OF_SUPPORTED_BPOOLS];
+    poll_group_instance_block_t poll_group_inst_arr[NUM_OF_SUPPORTED_POLL_GROUPS];
+    lock_instance_block_t lock_inst_arr[NUM_OF_SUPPORTED_LOCKS];
     iomux_stats_t iomux;
     global_instance_block_t global_inst_arr[NUM_OF_SUPPORTED_GLOBALS];
     int reader_counter; // only copy to shm upon active reader
@@ -473,8 +740,15 @@ typedef struct sh_mem_t {
     int fd_dump;
     vlog_levels_t fd_dump_log_level;
     mc_grp_info_t mc_info;
+    tune_info_t tune;
+    /*
+     * The file is sized for max_skt_inst_limit socket blocks but only the first max_skt_inst_num
+     * are allocated. The publisher allocates more blocks as the sockets are created and increases
+     * max_skt_inst_num afterwards, the offsets of the allocated blocks never change.
+     */
     size_t max_skt_inst_num; // number of elements allocated in 'socket_instance_block_t
                              // skt_inst_arr[]'
+    size_t max_skt_inst_limit;
     char stats_protocol_ver[32];
 
     /* IMPORTANT:  MUST BE LAST ENTRY in struct: [0] is the allocation start point for all fd's
@@ -507,14 +781,18 @@ typedef struct sh_mem_t {
         memset(&ver_info, 0, sizeof(ver_info));
         memset(stats_protocol_ver, 0, sizeof(stats_protocol_ver));
         max_skt_inst_num = 0;
+        max_skt_inst_limit = 0;
         log_level = (vlog_levels_t)0;
         log_details_level = 0;
         dump = DUMP_DISABLED;
         fd_dump = 0;
         fd_dump_log_level = (vlog_levels_t)0;
+        memset(&tune, 0, sizeof(tune));
         memset(cq_inst_arr, 0, sizeof(cq_inst_arr));
         memset(ring_inst_arr, 0, sizeof(ring_inst_arr));
         memset(bpool_inst_arr, 0, sizeof(bpool_inst_arr));
+        memset(poll_group_inst_arr, 0, sizeof(poll_group_inst_arr));
+        memset(lock_inst_arr, 0, sizeof(lock_inst_arr));
         global_inst_arr->init();
         mc_info.max_grp_num = 0;
         for (uint32_t i = 0; i < MC_TABLE_SIZE; i++) {
@@ -560,6 +838,9 @@ void xlio_stats_instance_remove_ent_ctx_block(entity_context_stats_t *);
 void xlio_stats_instance_create_bpool_block(bpool_stats_t *);
 void xlio_stats_instance_remove_bpool_block(bpool_stats_t *);
 
+void xlio_stats_instance_create_poll_group_block(poll_group_stats_t *);
+void xlio_stats_instance_remove_poll_group_block(poll_group_stats_t *);
+
 void xlio_stats_instance_create_global_block(global_stats_t *);
 void xlio_stats_instance_remove_global_block(global_stats_t *);
 
@@ -574,5 +855,7 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
 void print_netstat_like(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info, FILE *file,
                         int pid);
 void print_netstat_like_headers(FILE *file);
+bool print_lat_hists(const lat_hists_t *p_hists, FILE *file);
+bool print_tcp_loss(const tcp_loss_stats_t *p_loss, FILE *file, const char *post_fix);
 
 #endif // XLIO_STATS_H
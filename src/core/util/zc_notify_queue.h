@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef ZC_NOTIFY_QUEUE_H
+#define ZC_NOTIFY_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+
+// The sends lo..hi completed, as reported by a single sock_extended_err
+struct zc_notify_range {
+    uint32_t lo;
+    uint32_t hi;
+    bool copied; // SO_EE_CODE_ZEROCOPY_COPIED
+};
+
+/**
+ * The MSG_ZEROCOPY completions of a socket waiting for recvmsg(MSG_ERRQUEUE).
+ *
+ * A completion which follows the last queued range with the same code extends it, as Linux
+ * does, so the sends completed in order are read with a single notification. The ids wrap
+ * around at 32 bits. Not thread safe.
+ */
+class zc_notify_queue {
+public:
+    void complete(uint32_t id, bool copied)
+    {
+        if (!m_ranges.empty()) {
+            zc_notify_range &last = m_ranges.back();
+            if (last.copied == copied && id == last.hi + 1U && id != last.lo) {
+                last.hi = id;
+                return;
+            }
+        }
+        m_ranges.push_back({id, id, copied});
+    }
+
+    bool pop(zc_notify_range &range)
+    {
+        if (m_ranges.empty()) {
+            return false;
+        }
+        range = m_ranges.front();
+        m_ranges.pop_front();
+        return true;
+    }
+
+    void clear() { m_ranges.clear(); }
+
+    bool empty() const { return m_ranges.empty(); }
+    size_t size() const { return m_ranges.size(); }
+
+private:
+    std::deque<zc_notify_range> m_ranges;
+};
+
+#endif /* ZC_NOTIFY_QUEUE_H */
@@ -190,7 +190,7 @@ int xlio_dump_fd_stats(int fd, int log_level);
  * @section architecture Architecture Overview
  * The API is built around three main concepts:
  * 1. **Polling Groups**: Event management and callback registration
- * 2. **Sockets**: TCP socket abstraction with zero-copy capabilities
+ * 2. **Sockets**: TCP and UDP socket abstraction with zero-copy capabilities
  * 3. **Buffers**: Memory management for zero-copy operations
  *
  * @section workflow Typical Workflow
@@ -234,10 +234,10 @@ int xlio_dump_fd_stats(int fd, int log_level);
  *   operations concurrently
  *
  * @section limitations Current Limitations
- * - TCP sockets only (no UDP support)
+ * - UDP sockets don't support IP fragmentation on RX and group detach/attach
  * - No crypto offload support
  * - No bonding support
- * - Only busy polling is supported
+ * - Blocking wait with xlio_poll_group_wait() is driven by RX completions and TCP timers only
  * - fork() is supported only without created polling groups
  * @{
  */
@@ -338,7 +338,8 @@ int xlio_exit(void);
  * @return 0 on success, -1 on error (errno is set)
  *
  * @par Error Codes:
- * - EINVAL: Invalid parameters (group_out is NULL, attr is NULL, or socket_event_cb is NULL)
+ * - EINVAL: Invalid parameters (group_out is NULL, attr is NULL, socket_event_cb is NULL,
+ *   attr_size is too small or rx_queues is over XLIO_GROUP_RX_QUEUES_MAX)
  * - ENOMEM: Insufficient memory
  *
  * @note socket_event_cb is mandatory.
@@ -370,7 +371,8 @@ int xlio_poll_group_destroy(xlio_poll_group_t group);
  * @return 0 on success, -1 on error (errno is set)
  *
  * @par Error Codes:
- * - EINVAL: Invalid parameters (attr is NULL or socket_event_cb is NULL)
+ * - EINVAL: Invalid parameters (attr is NULL, socket_event_cb is NULL or attr_size is too
+ *   small), or the flags or rx_queues differ from the current ones
  */
 int xlio_poll_group_update(xlio_poll_group_t group, const struct xlio_poll_group_attr *attr);
 
@@ -383,21 +385,73 @@ int xlio_poll_group_update(xlio_poll_group_t group, const struct xlio_poll_group
  *
  * @param group The polling group to poll
  *
+ * If socket_rx_batch_cb is registered, buffers received during the call are
+ * accumulated per socket and delivered with a single callback per socket
+ * after all the rings are polled.
+ * Similarly, socket_accept_batch_cb receives all the connections established
+ * during the call at once, and socket_comp_batch_cb all the send operations
+ * of a socket completed during the call.
+ *
  * @note This function should be called regularly in the main event loop.
  * It's non-blocking and will return immediately if no events are available.
  */
 void xlio_poll_group_poll(xlio_poll_group_t group);
 
+/**
+ * @brief Wait for events on a polling group
+ *
+ * Blocking alternative to xlio_poll_group_poll(). The group busy polls for a
+ * while first and, if no events arrive, arms the completion queues of all its
+ * rings and sleeps until a packet is received or the timeout expires. A single
+ * polling pass is executed after wake up, so callbacks are invoked from the
+ * context of this call in the same way as with xlio_poll_group_poll().
+ *
+ * The busy polling budget is adaptive: it grows while the group keeps finding
+ * events and shrinks while the group is idle. The initial and maximum budget
+ * is XLIO_RX_POLL_NUM iterations. With XLIO_RX_POLL_NUM=-1 the group never sleeps
+ * and busy polls until an event or the timeout.
+ *
+ * @param group The polling group to wait on
+ * @param timeout_ms Maximum time to sleep in milliseconds, -1 for infinite and
+ *                   0 for a single non-blocking polling phase
+ * @return 1 if events were processed, 0 on timeout, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINTR: The wait was interrupted by a signal
+ *
+ * @note If the group has sockets, the sleep is limited by the TCP timer
+ * resolution to keep TCP timers running. TX completions don't wake up the
+ * group, they are processed with the next polling pass.
+ */
+int xlio_poll_group_wait(xlio_poll_group_t group, int timeout_ms);
+
 /** @} */ // end of xlio_poll_group group
 
 /**
  * @defgroup xlio_socket Socket Management
  * @brief Functions for creating and managing XLIO sockets
  *
- * XLIO sockets are high-performance TCP socket abstractions that provide
+ * XLIO sockets are high-performance TCP and UDP socket abstractions that provide
  * zero-copy capabilities. They are represented by opaque handles rather than
  * file descriptors.
  *
+ * @section dgram_sockets Datagram Sockets
+ * A socket created with XLIO_SOCKET_FLAG_DGRAM is a UDP socket driven by the same
+ * polling group as TCP sockets:
+ * - Each received datagram is delivered as a single xlio_buf via the RX callback
+ * - Source address and HW timestamp are available with xlio_socket_buf_dgram_info()
+ *   and the NIC metadata with xlio_socket_buf_rx_info()
+ * - xlio_socket_send()/xlio_socket_sendv() send to the connected peer, and
+ *   xlio_socket_sendto() sends to an arbitrary destination
+ * - Data is copied on TX, so the completion callback is invoked before the send
+ *   function returns
+ * - With XLIO_TX_MPWQE enabled (disabled by default), in a XLIO_GROUP_FLAG_DIRTY group
+ *   without XLIO_GROUP_FLAG_SAFE, datagrams sent without XLIO_SOCKET_SEND_FLAG_FLUSH are
+ *   posted to the wire by xlio_poll_group_flush() or the next xlio_poll_group_poll().
+ *   Small datagrams are packed into multi-packet WQEs then.
+ * - xlio_socket_listen(), xlio_socket_detach_group(), xlio_socket_attach_group() and
+ *   xlio_socket_migrate() are not supported
+ *
  * @{
  */
 
@@ -448,7 +502,7 @@ int xlio_socket_destroy(xlio_socket_t sock);
  * changing socket behavior and context without recreating the socket.
  *
  * @param sock The socket to update
- * @param flags New flags for the socket
+ * @param flags New flags for the socket, only XLIO_SOCKET_FLAG_HIGH_PRIO can be changed
  * @param userdata_sq New user data for the socket
  * @return 0 on success, -1 on error
  */
@@ -539,6 +593,12 @@ int xlio_socket_bind(xlio_socket_t sock, const struct sockaddr *addr, socklen_t
  * indicated by the XLIO_SOCKET_EVENT_ESTABLISHED event. If a connection
  * failure occurs an XLIO_SOCKET_EVENT_ERROR event will be delivered.
  *
+ * @note With the TCP_FASTOPEN_CONNECT socket option set and a Fast Open cookie
+ * known for the remote address, the socket accepts sends right after this call.
+ * The first copied (XLIO_SOCKET_SEND_FLAG_INLINE) data is sent in the SYN, zero
+ * copy data follows the handshake. Otherwise the SYN requests a cookie for the
+ * next connections.
+ *
  * @see connect(2)
  */
 int xlio_socket_connect(xlio_socket_t sock, const struct sockaddr *to, socklen_t tolen);
@@ -547,7 +607,8 @@ int xlio_socket_connect(xlio_socket_t sock, const struct sockaddr *to, socklen_t
  * @brief Listen for incoming connections
  *
  * Configures the socket to listen for incoming connections. Requires that
- * the polling group has a socket_accept_cb callback registered.
+ * the polling group has a socket_accept_cb or socket_accept_batch_cb callback
+ * registered.
  *
  * @param sock The socket to configure for listening
  * @return 0 on success, -1 on error (errno is set)
@@ -565,6 +626,57 @@ int xlio_socket_connect(xlio_socket_t sock, const struct sockaddr *to, socklen_t
  */
 int xlio_socket_listen(xlio_socket_t sock);
 
+/**
+ * @brief Keep a pool of established connections to a destination
+ *
+ * The polling group connects up to size sockets to the destination in the background,
+ * so xlio_poll_group_get_connection() hands out a connection without the handshake
+ * latency. A handed out connection is replaced from the polling context. A failed
+ * connect attempt is retried with a backoff of 100 ms.
+ *
+ * @param group The polling group
+ * @param to Destination address
+ * @param tolen Size of the destination address
+ * @param size Number of the pooled connections, zero closes the idle connections and
+ *             releases the pool
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: Invalid parameters (group or to is NULL, or unsupported address)
+ *
+ * @note The pooled connections aren't reported to the application until handed out,
+ * their events are consumed by the pool. An idle connection that receives data or is
+ * closed by the peer is replaced.
+ *
+ * @note Must be called from the polling group context, as xlio_poll_group_poll().
+ */
+int xlio_poll_group_connect_pool(xlio_poll_group_t group, const struct sockaddr *to,
+                                 socklen_t tolen, unsigned size);
+
+/**
+ * @brief Take an established connection from the pool of a destination
+ *
+ * @param group The polling group
+ * @param to Destination address, as passed to xlio_poll_group_connect_pool()
+ * @param tolen Size of the destination address
+ * @param userdata_sq User data of the handed out socket
+ * @param sock_out Pointer to store the socket handle
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: Invalid parameters (group, to or sock_out is NULL, or unsupported address)
+ * - ENOENT: No pool for the destination
+ * - EAGAIN: No established connection in the pool, xlio_socket_connect() can be used
+ *
+ * @note The socket is connected already, XLIO_SOCKET_EVENT_ESTABLISHED isn't delivered.
+ * From now the socket belongs to the application as if created by xlio_socket_create().
+ *
+ * @note Must be called from the polling group context, as xlio_poll_group_poll().
+ */
+int xlio_poll_group_get_connection(xlio_poll_group_t group, const struct sockaddr *to,
+                                   socklen_t tolen, uintptr_t userdata_sq,
+                                   xlio_socket_t *sock_out);
+
 /**
  * @brief Get InfiniBand protection domain
  *
@@ -616,6 +728,34 @@ int xlio_socket_detach_group(xlio_socket_t sock);
  */
 int xlio_socket_attach_group(xlio_socket_t sock, xlio_poll_group_t group);
 
+/**
+ * @brief Migrate socket to another polling group asynchronously
+ *
+ * Detaches the socket from its current polling group and hands it over to the
+ * destination group. The call must be serialized with the current group of the
+ * socket. The destination group completes the migration from the context of its
+ * next xlio_poll_group_poll() and there is no synchronization between the groups.
+ *
+ * The RX steering rule of the connection stays in place until the destination
+ * group installs the new one. RX packets received during the handoff are dropped
+ * and recovered by TCP retransmissions.
+ *
+ * @param sock The socket to migrate
+ * @param group The destination polling group
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: Socket is not connected, detached or already in the destination group
+ * - ENOTSUP: Not supported with listen sockets, UDP sockets or disabled flow tag
+ *
+ * @note XLIO_SOCKET_EVENT_MIGRATED event is generated by the destination group
+ * when the migration completes. If the destination group fails to attach the socket,
+ * XLIO_SOCKET_EVENT_ERROR is generated instead and the socket is left detached. The
+ * socket must not be used for TX until either of the events. Destroying or attaching
+ * the socket before the destination group takes it cancels the migration.
+ */
+int xlio_socket_migrate(xlio_socket_t sock, xlio_poll_group_t group);
+
 /** @} */ // end of xlio_socket group
 
 /**
@@ -641,6 +781,45 @@ int xlio_socket_attach_group(xlio_socket_t sock, xlio_poll_group_t group);
  * @{
  */
 
+/**
+ * @brief Register user memory for zero-copy send operations
+ *
+ * Registers a memory region with the device of the protection domain and returns
+ * a memory key to be passed in xlio_socket_send_attr::mkey. The registration is an
+ * expensive operation, so it's supposed to be done once for long living memory such
+ * as message arenas at the application startup. The TX path uses the key as is and
+ * doesn't look the memory up.
+ *
+ * @param pd Protection domain returned by xlio_socket_get_pd() or NULL if XLIO
+ *           uses a single device
+ * @param addr Start of the memory region
+ * @param len Length of the memory region
+ * @param mkey_out Pointer to store the memory key
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: Invalid parameters, unknown pd or NULL pd with multiple devices
+ * - ENODEV: No offloaded devices
+ * - Other errors are reported by ibv_reg_mr(3)
+ *
+ * @see xlio_mem_deregister()
+ */
+int xlio_mem_register(struct ibv_pd *pd, void *addr, size_t len, uint32_t *mkey_out);
+
+/**
+ * @brief Deregister memory registered with xlio_mem_register()
+ *
+ * @param pd Protection domain used for the registration
+ * @param mkey Memory key returned by xlio_mem_register()
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: Unknown pd or mkey
+ *
+ * @note The memory must not be used by in-flight zero-copy send operations.
+ */
+int xlio_mem_deregister(struct ibv_pd *pd, uint32_t mkey);
+
 /**
  * @brief Send data on a socket
  *
@@ -657,8 +836,9 @@ int xlio_socket_attach_group(xlio_socket_t sock, xlio_poll_group_t group);
  * - ENOMEM: Insufficient memory (recoverable by retrying later)
  * - Other errors are generally not recoverable
  *
- * @note For zero-copy operation, the memory must be registered with the
- * InfiniBand protection domain obtained from xlio_socket_get_pd().
+ * @note For zero-copy operation, the memory must be registered with
+ * xlio_mem_register() or with the InfiniBand protection domain obtained from
+ * xlio_socket_get_pd().
  *
  * @see xlio_socket_send_attr
  */
@@ -681,6 +861,57 @@ int xlio_socket_send(xlio_socket_t sock, const void *data, size_t len,
 int xlio_socket_sendv(xlio_socket_t sock, const struct iovec *iov, unsigned iovcnt,
                       const struct xlio_socket_send_attr *attr);
 
+/**
+ * @brief Send a datagram to the specified destination
+ *
+ * Sends a single datagram on an unconnected or connected datagram socket, similar
+ * to the standard sendto() function.
+ *
+ * @param sock The datagram socket to send data on
+ * @param data Pointer to the data to send
+ * @param len Length of the data
+ * @param to Destination address
+ * @param tolen Length of the destination address
+ * @param attr Send attributes controlling the operation
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EOPNOTSUPP: The socket is not a datagram socket
+ * - EAGAIN: No TX resources are available (recoverable by retrying later)
+ *
+ * @see xlio_socket_send()
+ */
+int xlio_socket_sendto(xlio_socket_t sock, const void *data, size_t len, const struct sockaddr *to,
+                       socklen_t tolen, const struct xlio_socket_send_attr *attr);
+
+/**
+ * @brief Send data of a receive buffer without a copy
+ *
+ * Forwards a part of a buffer received on any socket, e.g. from a client socket to a
+ * backend socket of a proxy. The segments refer to the receive buffer, which goes back
+ * to its ring once the data is acknowledged and completed by the NIC.
+ *
+ * @param sock The socket to send data on
+ * @param buf The receive buffer owned by the application
+ * @param offset Offset of the data from the start of the data reported by the RX callback
+ * @param len Length of the data
+ * @param attr Send attributes, only XLIO_SOCKET_SEND_FLAG_FLUSH is used
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: buf is NULL, len is zero or the range exceeds the buffer data
+ * - ENOMEM: Out of memory for the operation
+ *
+ * @note On success the buffer belongs to XLIO and must not be freed or accessed, on
+ * error it stays with the application. A datagram socket, a socket with a ULP (e.g. TLS)
+ * or a device which doesn't share the receive memory registration gets a copy of the
+ * data, then the buffer is freed before the call returns.
+ *
+ * @see xlio_socket_send()
+ */
+int xlio_socket_send_buf(xlio_socket_t sock, struct xlio_buf *buf, size_t offset, size_t len,
+                         const struct xlio_socket_send_attr *attr);
+
 /**
  * @brief Flush all dirty sockets in a polling group
  *
@@ -688,6 +919,9 @@ int xlio_socket_sendv(xlio_socket_t sock, const struct iovec *iov, unsigned iovc
  * flushes all sockets that have pending data to send. This provides
  * batch flushing capabilities for improved performance.
  *
+ * High priority sockets are flushed first. With a non-zero flush_budget of the group,
+ * the normal priority sockets over the budget are flushed by the following flushes or polls.
+ *
  * @param group The polling group to flush
  *
  * @note This function should only be used with groups that have the
@@ -759,6 +993,49 @@ void xlio_socket_buf_free(xlio_socket_t sock, struct xlio_buf *buf);
  */
 void xlio_poll_group_buf_free(xlio_poll_group_t group, struct xlio_buf *buf);
 
+/**
+ * @brief Get metadata of a received datagram
+ *
+ * Retrieves the source address and the HW timestamp of a buffer received on
+ * a datagram socket. The buffer must be owned by the application.
+ *
+ * @param sock The datagram socket that received the buffer
+ * @param buf The buffer descriptor
+ * @param addr Buffer for the source address (optional)
+ * @param addrlen Size of the addr buffer on input, actual size on output (optional)
+ * @param hw_timestamp Buffer for the HW timestamp (optional)
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: The socket is not a datagram socket or buf is NULL
+ *
+ * @note HW timestamp is zero unless SOF_TIMESTAMPING_RAW_HARDWARE is enabled with
+ * SO_TIMESTAMPING socket option.
+ */
+int xlio_socket_buf_dgram_info(xlio_socket_t sock, struct xlio_buf *buf, struct sockaddr *addr,
+                               socklen_t *addrlen, struct timespec *hw_timestamp);
+
+/**
+ * @brief Get the NIC metadata of a receive buffer
+ *
+ * Retrieves the HW timestamp, the RSS hash and the flow tag of a buffer received on
+ * a stream or a datagram socket. The buffer must be owned by the application.
+ *
+ * @param sock The socket that received the buffer
+ * @param buf The buffer descriptor
+ * @param info Buffer for the metadata
+ * @return 0 on success, -1 on error (errno is set)
+ *
+ * @par Error Codes:
+ * - EINVAL: buf or info is NULL
+ *
+ * @note The metadata is saved by the RX path anyway, the HW timestamp is converted to
+ * the system time by the call, so SO_TIMESTAMPING isn't required. For a stream socket,
+ * each buffer of a chained receive has its own metadata.
+ */
+int xlio_socket_buf_rx_info(xlio_socket_t sock, struct xlio_buf *buf,
+                            struct xlio_buf_rx_info *info);
+
 /** @} */ // end of xlio_rx group
 
 /** @} */ // end of xlio_ultra_api group
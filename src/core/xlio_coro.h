@@ -0,0 +1,910 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/**
+ * @file xlio_coro.h
+ * @brief C++20 coroutine adapter over the XLIO Ultra API
+ *
+ * Header-only layer which turns the callbacks of a polling group into awaitable
+ * operations:
+ * - xlio_coro::executor owns a polling group and resumes the coroutines after each
+ *   xlio_poll_group_poll(), outside of the XLIO callbacks
+ * - xlio_coro::stream_socket provides co_await connect(), accept(), recv() and send()
+ * - xlio_coro::buf_view is a zero-copy view of a received xlio_buf, the buffer is
+ *   returned to XLIO when the view is destroyed
+ * - xlio_coro::task<T> is a lazy coroutine, its frame is taken from the frame arena
+ *   of the executor when the first parameter of the coroutine is the executor or
+ *   a stream_socket, so the steady state doesn't allocate; the tasks must complete
+ *   before the executor is destroyed
+ *
+ * The functions are called through the xlio_api_t table, so the adapter works when
+ * libxlio is preloaded. An executor and its sockets are used by a single thread.
+ * XLIO must be initialized with xlio_init_ex() before an executor is created.
+ *
+ * Errors are reported as errno values: 0 on success, a positive error code otherwise.
+ */
+
+#ifndef XLIO_CORO_H
+#define XLIO_CORO_H
+
+#if !defined(__cplusplus) || __cplusplus < 202002L
+#error "xlio_coro.h requires C++20"
+#endif
+
+#include <coroutine>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "xlio_extra.h"
+
+namespace xlio_coro {
+
+class executor;
+class stream_socket;
+
+namespace detail {
+
+/*
+ * Growing FIFO of trivially copyable entries. The storage is kept when the queue
+ * drains, so a reused queue doesn't allocate.
+ */
+template <typename T> class fifo {
+public:
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_buf.size()) {
+            grow(capacity);
+        }
+    }
+    void push(const T &val)
+    {
+        if (m_count == m_buf.size()) {
+            grow(m_buf.empty() ? 16U : m_buf.size() * 2U);
+        }
+        m_buf[(m_head + m_count) % m_buf.size()] = val;
+        ++m_count;
+    }
+    T pop()
+    {
+        T val = m_buf[m_head];
+        m_head = (m_head + 1U) % m_buf.size();
+        --m_count;
+        return val;
+    }
+    bool empty() const { return !m_count; }
+    size_t size() const { return m_count; }
+
+private:
+    void grow(size_t capacity)
+    {
+        std::vector<T> buf(capacity);
+        for (size_t i = 0; i < m_count; ++i) {
+            buf[i] = m_buf[(m_head + i) % m_buf.size()];
+        }
+        m_buf.swap(buf);
+        m_head = 0U;
+    }
+
+    std::vector<T> m_buf;
+    size_t m_head = 0U;
+    size_t m_count = 0U;
+};
+
+} // namespace detail
+
+/**
+ * @brief Allocator of the coroutine frames of an executor
+ *
+ * Frames are rounded up to size classes of 64 bytes and recycled through a free list
+ * per class. The memory is carved from chunks which are kept until the arena is
+ * destroyed. Frames bigger than the largest class are allocated from the heap.
+ */
+class frame_arena {
+public:
+    static constexpr size_t CLASS_SIZE = 64U;
+    static constexpr size_t NUM_CLASSES = 64U; // Up to 4KB frames
+    static constexpr size_t CHUNK_SIZE = 64U * 1024U;
+
+    frame_arena() = default;
+    frame_arena(const frame_arena &) = delete;
+    frame_arena &operator=(const frame_arena &) = delete;
+    ~frame_arena()
+    {
+        for (void *chunk : m_chunks) {
+            std::free(chunk);
+        }
+    }
+
+    void *allocate(size_t size)
+    {
+        size_t cls = (size + sizeof(header) + CLASS_SIZE - 1U) / CLASS_SIZE;
+        if (cls > NUM_CLASSES) {
+            return allocate_heap(size);
+        }
+
+        header *hdr = m_free[cls - 1U];
+        if (hdr) {
+            m_free[cls - 1U] = hdr->next;
+        } else {
+            hdr = static_cast<header *>(carve(cls * CLASS_SIZE));
+        }
+        hdr->owner = this;
+        hdr->cls = static_cast<uint32_t>(cls);
+        return hdr + 1;
+    }
+
+    static void *allocate_heap(size_t size)
+    {
+        header *hdr = static_cast<header *>(::operator new(size + sizeof(header)));
+        hdr->owner = nullptr;
+        return hdr + 1;
+    }
+
+    static void deallocate(void *ptr)
+    {
+        header *hdr = static_cast<header *>(ptr) - 1;
+        if (!hdr->owner) {
+            ::operator delete(hdr);
+            return;
+        }
+        frame_arena *arena = hdr->owner;
+        hdr->next = arena->m_free[hdr->cls - 1U];
+        arena->m_free[hdr->cls - 1U] = hdr;
+    }
+
+private:
+    struct alignas(std::max_align_t) header {
+        union {
+            frame_arena *owner;
+            header *next; // While the block is free
+        };
+        uint32_t cls;
+    };
+
+    void *carve(size_t size)
+    {
+        if (m_chunk_left < size) {
+            void *chunk = std::malloc(CHUNK_SIZE);
+            if (!chunk) {
+                throw std::bad_alloc();
+            }
+            m_chunks.push_back(chunk);
+            m_chunk_pos = static_cast<char *>(chunk);
+            m_chunk_left = CHUNK_SIZE;
+        }
+        void *ptr = m_chunk_pos;
+        m_chunk_pos += size;
+        m_chunk_left -= size;
+        return ptr;
+    }
+
+    header *m_free[NUM_CLASSES] = {};
+    std::vector<void *> m_chunks;
+    char *m_chunk_pos = nullptr;
+    size_t m_chunk_left = 0U;
+};
+
+namespace detail {
+
+frame_arena &arena_of(executor &ex);
+frame_arena &arena_of(stream_socket &sock);
+void task_done(executor &ex);
+
+struct promise_base {
+    // The frame is taken from the arena of the executor given as the first parameter
+    template <typename... Args> static void *operator new(size_t size, executor &ex, Args &&...)
+    {
+        return arena_of(ex).allocate(size);
+    }
+    template <typename... Args>
+    static void *operator new(size_t size, stream_socket &sock, Args &&...)
+    {
+        return arena_of(sock).allocate(size);
+    }
+    static void *operator new(size_t size) { return frame_arena::allocate_heap(size); }
+    static void operator delete(void *ptr) { frame_arena::deallocate(ptr); }
+
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept
+        {
+            promise_base &promise = handle.promise();
+            if (promise.m_detached_ex) {
+                executor *ex = promise.m_detached_ex;
+                handle.destroy();
+                task_done(*ex);
+                return std::noop_coroutine();
+            }
+            return promise.m_continuation ? promise.m_continuation : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    final_awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception()
+    {
+        if (m_detached_ex) {
+            // Nobody awaits a spawned task
+            std::terminate();
+        }
+        m_exception = std::current_exception();
+    }
+    void rethrow()
+    {
+        if (m_exception) {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    std::coroutine_handle<> m_continuation;
+    executor *m_detached_ex = nullptr;
+    std::exception_ptr m_exception;
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazy coroutine returning T
+ *
+ * The coroutine starts when it is awaited or spawned with executor::spawn(). An
+ * exception leaving an awaited task is rethrown to the awaiter.
+ */
+template <typename T = void> class task {
+public:
+    struct promise_type : detail::promise_base {
+        task get_return_object()
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        template <typename U> void return_value(U &&val) { m_value.emplace(std::forward<U>(val)); }
+
+        std::optional<T> m_value;
+    };
+
+    task() = default;
+    task(task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    ~task() { reset(); }
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+        m_handle.promise().m_continuation = awaiter;
+        return m_handle;
+    }
+    T await_resume()
+    {
+        m_handle.promise().rethrow();
+        return std::move(*m_handle.promise().m_value);
+    }
+
+    std::coroutine_handle<promise_type> release() { return std::exchange(m_handle, nullptr); }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    void reset()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template <> class task<void> {
+public:
+    struct promise_type : detail::promise_base {
+        task get_return_object()
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        void return_void() {}
+    };
+
+    task() = default;
+    task(task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    ~task() { reset(); }
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept
+    {
+        m_handle.promise().m_continuation = awaiter;
+        return m_handle;
+    }
+    void await_resume() { m_handle.promise().rethrow(); }
+
+    std::coroutine_handle<promise_type> release() { return std::exchange(m_handle, nullptr); }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    void reset()
+    {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief Zero-copy view of a received buffer
+ *
+ * Move-only owner of an xlio_buf. The buffer is returned to XLIO by the destructor
+ * or reset(), release() passes the ownership to the caller. An empty view is returned
+ * by stream_socket::recv() at the end of the stream or on an error.
+ */
+class buf_view {
+public:
+    buf_view() = default;
+    buf_view(struct xlio_api_t *api, xlio_poll_group_t group, void *data, size_t len,
+             struct xlio_buf *buf)
+        : m_api(api)
+        , m_group(group)
+        , m_data(data)
+        , m_len(len)
+        , m_buf(buf)
+    {
+    }
+    buf_view(buf_view &&other) noexcept { *this = std::move(other); }
+    buf_view &operator=(buf_view &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_api = other.m_api;
+            m_group = other.m_group;
+            m_data = other.m_data;
+            m_len = other.m_len;
+            m_buf = std::exchange(other.m_buf, nullptr);
+        }
+        return *this;
+    }
+    ~buf_view() { reset(); }
+
+    explicit operator bool() const { return m_buf; }
+    const uint8_t *data() const { return static_cast<const uint8_t *>(m_data); }
+    size_t size() const { return m_len; }
+    std::span<const uint8_t> span() const { return {data(), m_len}; }
+    struct xlio_buf *get() const { return m_buf; }
+
+    struct xlio_buf *release() { return std::exchange(m_buf, nullptr); }
+    void reset()
+    {
+        if (m_buf) {
+            m_api->xlio_poll_group_buf_free(m_group, std::exchange(m_buf, nullptr));
+        }
+    }
+
+private:
+    struct xlio_api_t *m_api = nullptr;
+    xlio_poll_group_t m_group = 0;
+    void *m_data = nullptr;
+    size_t m_len = 0U;
+    struct xlio_buf *m_buf = nullptr;
+};
+
+namespace detail {
+
+struct rx_entry {
+    void *data;
+    size_t len;
+    struct xlio_buf *buf;
+};
+
+// State of an XLIO socket, referenced by its userdata_sq and recycled by the executor
+struct socket_state {
+    executor *m_ex = nullptr;
+    xlio_socket_t m_sock = 0;
+    fifo<rx_entry> m_rx;
+    fifo<socket_state *> m_accepted;
+    std::coroutine_handle<> m_connect_waiter;
+    std::coroutine_handle<> m_recv_waiter;
+    std::coroutine_handle<> m_accept_waiter;
+    socket_state *m_next_free = nullptr;
+    int m_error = 0;
+    bool m_established = false;
+    bool m_eof = false;
+    bool m_closed = false; // xlio_socket_destroy() is called, waiting for TERMINATED
+    bool m_terminated = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief Polling group driving the coroutines of a thread
+ *
+ * The executor creates a polling group with its own callbacks. The callbacks only
+ * record the events, the awaiting coroutines are resumed after xlio_poll_group_poll()
+ * returns, so they may call any Ultra API function.
+ */
+class executor {
+public:
+    explicit executor(struct xlio_api_t *api, unsigned group_flags = 0U) : m_api(api)
+    {
+        struct xlio_poll_group_attr attr = {};
+
+        attr.flags = group_flags;
+        attr.socket_event_cb = &executor::event_cb;
+        attr.socket_comp_cb = &executor::comp_cb;
+        attr.socket_rx_cb = &executor::rx_cb;
+        attr.socket_accept_cb = &executor::accept_cb;
+        m_error = api->xlio_poll_group_create(&attr, &m_group) ? errno : 0;
+        m_ready.reserve(64U);
+        m_running.reserve(64U);
+    }
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+    ~executor()
+    {
+        if (!m_error) {
+            m_api->xlio_poll_group_destroy(m_group);
+        }
+        for (detail::socket_state *chunk : m_state_chunks) {
+            delete[] chunk;
+        }
+    }
+
+    // 0 if the polling group is created, an errno value otherwise
+    int error() const { return m_error; }
+    struct xlio_api_t *api() const { return m_api; }
+    xlio_poll_group_t group() const { return m_group; }
+    frame_arena &arena() { return m_arena; }
+
+    int create_socket(int domain, stream_socket &sock);
+
+    // Start a detached task, it is destroyed when it completes
+    void spawn(task<void> &&t)
+    {
+        auto handle = t.release();
+        handle.promise().m_detached_ex = this;
+        ++m_tasks;
+        schedule(handle);
+    }
+
+    // One polling iteration followed by the resumption of the ready coroutines
+    void poll()
+    {
+        m_api->xlio_poll_group_poll(m_group);
+        run_ready();
+    }
+
+    // Poll until all the spawned tasks complete or stop() is called
+    void run()
+    {
+        m_stopped = false;
+        run_ready();
+        while (m_tasks && !m_stopped) {
+            poll();
+        }
+    }
+    void stop() { m_stopped = true; }
+    size_t tasks() const { return m_tasks; }
+
+    void schedule(std::coroutine_handle<> handle) { m_ready.push_back(handle); }
+
+private:
+    friend class stream_socket;
+    friend void detail::task_done(executor &ex);
+
+    void run_ready()
+    {
+        while (!m_ready.empty()) {
+            m_running.swap(m_ready);
+            for (std::coroutine_handle<> handle : m_running) {
+                handle.resume();
+            }
+            m_running.clear();
+        }
+    }
+
+    detail::socket_state *alloc_state(xlio_socket_t sock)
+    {
+        if (!m_free_states) {
+            static constexpr size_t STATES_PER_CHUNK = 64U;
+            detail::socket_state *chunk = new detail::socket_state[STATES_PER_CHUNK];
+            m_state_chunks.push_back(chunk);
+            for (size_t i = 0; i < STATES_PER_CHUNK; ++i) {
+                chunk[i].m_next_free = m_free_states;
+                m_free_states = &chunk[i];
+            }
+        }
+        detail::socket_state *state = m_free_states;
+        m_free_states = state->m_next_free;
+        state->m_ex = this;
+        state->m_sock = sock;
+        state->m_rx.reserve(16U);
+        state->m_error = 0;
+        state->m_established = state->m_eof = state->m_closed = state->m_terminated = false;
+        return state;
+    }
+    void free_state(detail::socket_state *state)
+    {
+        state->m_connect_waiter = state->m_recv_waiter = state->m_accept_waiter = nullptr;
+        state->m_next_free = m_free_states;
+        m_free_states = state;
+    }
+
+    // Releases the buffers and the accepted sockets of a state and destroys its socket
+    void close_state(detail::socket_state *state)
+    {
+        while (!state->m_rx.empty()) {
+            m_api->xlio_socket_buf_free(state->m_sock, state->m_rx.pop().buf);
+        }
+        while (!state->m_accepted.empty()) {
+            close_state(state->m_accepted.pop());
+        }
+        if (state->m_terminated || m_api->xlio_socket_destroy(state->m_sock)) {
+            free_state(state);
+        } else {
+            state->m_closed = true;
+        }
+    }
+
+    static void wake(std::coroutine_handle<> &waiter, executor *ex)
+    {
+        if (waiter) {
+            ex->schedule(std::exchange(waiter, nullptr));
+        }
+    }
+
+    static void event_cb(xlio_socket_t sock, uintptr_t userdata_sq, int event, int value)
+    {
+        (void)sock;
+        detail::socket_state *state = reinterpret_cast<detail::socket_state *>(userdata_sq);
+        executor *ex = state->m_ex;
+
+        switch (event) {
+        case XLIO_SOCKET_EVENT_ESTABLISHED:
+            state->m_established = true;
+            wake(state->m_connect_waiter, ex);
+            break;
+        case XLIO_SOCKET_EVENT_CLOSED:
+            state->m_eof = true;
+            wake(state->m_connect_waiter, ex);
+            wake(state->m_recv_waiter, ex);
+            break;
+        case XLIO_SOCKET_EVENT_ERROR:
+            state->m_error = value ? value : ECONNABORTED;
+            wake(state->m_connect_waiter, ex);
+            wake(state->m_recv_waiter, ex);
+            wake(state->m_accept_waiter, ex);
+            break;
+        case XLIO_SOCKET_EVENT_TERMINATED:
+            if (state->m_closed) {
+                ex->free_state(state);
+            } else {
+                state->m_terminated = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void comp_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op);
+
+    static void rx_cb(xlio_socket_t sock, uintptr_t userdata_sq, void *data, size_t len,
+                      struct xlio_buf *buf)
+    {
+        detail::socket_state *state = reinterpret_cast<detail::socket_state *>(userdata_sq);
+
+        if (state->m_closed) {
+            state->m_ex->m_api->xlio_socket_buf_free(sock, buf);
+            return;
+        }
+        state->m_rx.push({data, len, buf});
+        wake(state->m_recv_waiter, state->m_ex);
+    }
+
+    static void accept_cb(xlio_socket_t sock, xlio_socket_t parent, uintptr_t parent_userdata_sq)
+    {
+        (void)parent;
+        detail::socket_state *listener =
+            reinterpret_cast<detail::socket_state *>(parent_userdata_sq);
+        executor *ex = listener->m_ex;
+        detail::socket_state *state = ex->alloc_state(sock);
+
+        ex->m_api->xlio_socket_update(sock, 0U, reinterpret_cast<uintptr_t>(state));
+        state->m_established = true;
+        if (listener->m_closed) {
+            ex->close_state(state);
+            return;
+        }
+        listener->m_accepted.push(state);
+        wake(listener->m_accept_waiter, ex);
+    }
+
+    struct xlio_api_t *m_api;
+    xlio_poll_group_t m_group = 0;
+    int m_error = 0;
+    bool m_stopped = false;
+    size_t m_tasks = 0U;
+    frame_arena m_arena;
+    std::vector<std::coroutine_handle<>> m_ready;
+    std::vector<std::coroutine_handle<>> m_running;
+    detail::socket_state *m_free_states = nullptr;
+    std::vector<detail::socket_state *> m_state_chunks;
+};
+
+/**
+ * @brief Awaitable Ultra API TCP socket
+ *
+ * Move-only owner of an XLIO socket, the destructor destroys the socket and returns
+ * the buffers not received yet. A socket supports a single pending connect(), accept()
+ * and recv() at a time and any number of pending send() calls. The sockets must be
+ * closed before their executor is destroyed.
+ */
+class stream_socket {
+public:
+    stream_socket() = default;
+    stream_socket(stream_socket &&other) noexcept
+        : m_state(std::exchange(other.m_state, nullptr))
+    {
+    }
+    stream_socket &operator=(stream_socket &&other) noexcept
+    {
+        if (this != &other) {
+            close();
+            m_state = std::exchange(other.m_state, nullptr);
+        }
+        return *this;
+    }
+    ~stream_socket() { close(); }
+
+    explicit operator bool() const { return m_state; }
+    xlio_socket_t native_handle() const { return m_state->m_sock; }
+    executor &get_executor() const { return *m_state->m_ex; }
+    // The error reported by XLIO_SOCKET_EVENT_ERROR, 0 if none
+    int error() const { return m_state->m_error; }
+    // The peer closed the connection
+    bool eof() const { return m_state->m_eof; }
+
+    void close()
+    {
+        if (m_state) {
+            m_state->m_ex->close_state(std::exchange(m_state, nullptr));
+        }
+    }
+
+    int bind(const struct sockaddr *addr, socklen_t addrlen)
+    {
+        return api()->xlio_socket_bind(m_state->m_sock, addr, addrlen) ? errno : 0;
+    }
+    int listen() { return api()->xlio_socket_listen(m_state->m_sock) ? errno : 0; }
+    int setsockopt(int level, int optname, const void *optval, socklen_t optlen)
+    {
+        return api()->xlio_socket_setsockopt(m_state->m_sock, level, optname, optval, optlen)
+            ? errno
+            : 0;
+    }
+
+    // Copies the data to the XLIO buffers and flushes the socket
+    int send_inline(const void *data, size_t len)
+    {
+        struct xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_INLINE | XLIO_SOCKET_SEND_FLAG_FLUSH,
+            .mkey = 0U,
+            .userdata_op = 0U,
+        };
+        return api()->xlio_socket_send(m_state->m_sock, data, len, &attr) ? errno : 0;
+    }
+
+    struct connect_awaiter {
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            if (m_sock.api()->xlio_socket_connect(m_sock.m_state->m_sock, m_addr, m_addrlen)) {
+                m_rc = errno;
+                return false;
+            }
+            m_sock.m_state->m_connect_waiter = handle;
+            return true;
+        }
+        int await_resume() const
+        {
+            if (m_rc) {
+                return m_rc;
+            }
+            const detail::socket_state *state = m_sock.m_state;
+            return state->m_error ? state->m_error : (state->m_established ? 0 : ECONNRESET);
+        }
+
+        stream_socket &m_sock;
+        const struct sockaddr *m_addr;
+        socklen_t m_addrlen;
+        int m_rc = 0;
+    };
+
+    // co_await returns 0 when the connection is established, an errno value otherwise
+    connect_awaiter connect(const struct sockaddr *addr, socklen_t addrlen)
+    {
+        return {*this, addr, addrlen};
+    }
+
+    struct accept_awaiter {
+        bool await_ready() const noexcept
+        {
+            return !m_sock.m_state->m_accepted.empty() || m_sock.m_state->m_error;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_sock.m_state->m_accept_waiter = handle;
+        }
+        int await_resume()
+        {
+            if (m_sock.m_state->m_accepted.empty()) {
+                return m_sock.m_state->m_error;
+            }
+            m_peer = stream_socket(m_sock.m_state->m_accepted.pop());
+            return 0;
+        }
+
+        stream_socket &m_sock;
+        stream_socket &m_peer;
+    };
+
+    // co_await returns 0 and sets peer to the next accepted connection
+    accept_awaiter accept(stream_socket &peer) { return {*this, peer}; }
+
+    struct recv_awaiter {
+        bool await_ready() const noexcept
+        {
+            const detail::socket_state *state = m_sock.m_state;
+            return !state->m_rx.empty() || state->m_eof || state->m_error;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_sock.m_state->m_recv_waiter = handle;
+        }
+        buf_view await_resume()
+        {
+            detail::socket_state *state = m_sock.m_state;
+            if (state->m_rx.empty()) {
+                return {};
+            }
+            detail::rx_entry entry = state->m_rx.pop();
+            return {m_sock.api(), state->m_ex->group(), entry.data, entry.len, entry.buf};
+        }
+
+        stream_socket &m_sock;
+    };
+
+    // co_await returns the next received buffer, an empty view after eof() or error()
+    recv_awaiter recv() { return {*this}; }
+
+    struct send_awaiter {
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            struct xlio_socket_send_attr attr = {
+                .flags = XLIO_SOCKET_SEND_FLAG_FLUSH,
+                .mkey = m_mkey,
+                .userdata_op = reinterpret_cast<uintptr_t>(this),
+            };
+
+            m_handle = handle;
+            if (m_sock.api()->xlio_socket_send(m_sock.m_state->m_sock, m_data, m_len, &attr)) {
+                m_rc = errno;
+                return false;
+            }
+            // The completion can be reported from xlio_socket_send() itself
+            m_waiting = !m_done;
+            return m_waiting;
+        }
+        int await_resume() const { return m_rc; }
+
+        stream_socket &m_sock;
+        const void *m_data;
+        size_t m_len;
+        uint32_t m_mkey;
+        std::coroutine_handle<> m_handle;
+        int m_rc = 0;
+        bool m_done = false;
+        bool m_waiting = false;
+    };
+
+    /*
+     * Zero-copy send of registered memory, see xlio_socket_send(). co_await returns 0 when
+     * the data is completed and the memory can be reused, an errno value otherwise.
+     */
+    send_awaiter send(const void *data, size_t len, uint32_t mkey)
+    {
+        return {*this, data, len, mkey, {}};
+    }
+
+private:
+    friend class executor;
+    friend frame_arena &detail::arena_of(stream_socket &sock);
+
+    explicit stream_socket(detail::socket_state *state) : m_state(state) {}
+    struct xlio_api_t *api() const { return m_state->m_ex->m_api; }
+
+    detail::socket_state *m_state = nullptr;
+};
+
+inline int executor::create_socket(int domain, stream_socket &sock)
+{
+    detail::socket_state *state = alloc_state(0);
+    struct xlio_socket_attr attr = {
+        .flags = 0U,
+        .domain = domain,
+        .group = m_group,
+        .userdata_sq = reinterpret_cast<uintptr_t>(state),
+    };
+
+    if (m_api->xlio_socket_create(&attr, &state->m_sock)) {
+        int rc = errno;
+        free_state(state);
+        return rc;
+    }
+    sock = stream_socket(state);
+    return 0;
+}
+
+inline void executor::comp_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op)
+{
+    (void)sock;
+    detail::socket_state *state = reinterpret_cast<detail::socket_state *>(userdata_sq);
+    auto *awaiter = reinterpret_cast<stream_socket::send_awaiter *>(userdata_op);
+
+    if (awaiter) {
+        awaiter->m_done = true;
+        if (awaiter->m_waiting) {
+            state->m_ex->schedule(awaiter->m_handle);
+        }
+    }
+}
+
+namespace detail {
+
+inline frame_arena &arena_of(executor &ex)
+{
+    return ex.arena();
+}
+
+inline frame_arena &arena_of(stream_socket &sock)
+{
+    return sock.m_state->m_ex->arena();
+}
+
+inline void task_done(executor &ex)
+{
+    --ex.m_tasks;
+}
+
+} // namespace detail
+
+} // namespace xlio_coro
+
+#endif /* XLIO_CORO_H */
@@ -37,6 +37,19 @@ enum {
     XLIO_EXTRA_API_THREAD_OFFLOAD = (1 << 4),
     XLIO_EXTRA_API_DUMP_FD_STATS = (1 << 11),
     XLIO_EXTRA_API_XLIO_ULTRA = (1 << 13),
+    XLIO_EXTRA_API_RECV_ZCOPY = (1 << 14),
+    XLIO_EXTRA_API_WORKER_THREADS = (1 << 15),
+    XLIO_EXTRA_API_SEND_ZCOPY = (1 << 16),
+};
+
+/*
+ * Buffer of the zero copy receive, see recv_zcopy().
+ */
+struct xlio_zcopy_buf {
+    void *data; /* Received payload */
+    size_t len; /* Length of the payload */
+    /* Handle to return with free_zcopy_bufs(), NULL in the next fragments of a datagram */
+    struct xlio_buf *buf;
 };
 
 struct __attribute__((packed)) xlio_api_t {
@@ -111,6 +124,92 @@ struct __attribute__((packed)) xlio_api_t {
     void (*xlio_socket_flush)(xlio_socket_t sock);
     void (*xlio_socket_buf_free)(xlio_socket_t sock, struct xlio_buf *buf);
     void (*xlio_poll_group_buf_free)(xlio_poll_group_t group, struct xlio_buf *buf);
+    int (*xlio_socket_sendto)(xlio_socket_t sock, const void *data, size_t len,
+                              const struct sockaddr *to, socklen_t tolen,
+                              const struct xlio_socket_send_attr *attr);
+    int (*xlio_socket_buf_dgram_info)(xlio_socket_t sock, struct xlio_buf *buf,
+                                      struct sockaddr *addr, socklen_t *addrlen,
+                                      struct timespec *hw_timestamp);
+    int (*xlio_poll_group_wait)(xlio_poll_group_t group, int timeout_ms);
+    int (*xlio_socket_migrate)(xlio_socket_t sock, xlio_poll_group_t group);
+    int (*xlio_mem_register)(struct ibv_pd *pd, void *addr, size_t len, uint32_t *mkey_out);
+    int (*xlio_mem_deregister)(struct ibv_pd *pd, uint32_t mkey);
+
+    /*
+     * Zero copy receive on an offloaded TCP or UDP socket.
+     * The entries point to the XLIO buffers ready on the socket instead of copying them.
+     * A TCP call returns the stream data in order, a UDP call returns a single datagram. The
+     * fragments of a datagram after the first one have a NULL handle.
+     * The call blocks according to the socket mode and the MSG_DONTWAIT flag.
+     * The data is removed from the socket receive buffer and the buffers must be returned
+     * with free_zcopy_bufs() on the same fd.
+     * @param fd Offloaded socket.
+     * @param bufs Array of entries to fill.
+     * @param count Number of entries in the array.
+     * @param flags 0 or MSG_DONTWAIT.
+     * @return Number of filled entries, 0 at the end of a TCP stream, or -1 with errno set.
+     * EOPNOTSUPP if the fd is not offloaded or belongs to the XLIO Ultra API. ENODATA if a
+     * UDP datagram received through the kernel is ready, recv() returns it.
+     */
+    int (*recv_zcopy)(int fd, struct xlio_zcopy_buf *bufs, unsigned count, int flags);
+
+    /*
+     * Return the buffers filled by recv_zcopy() to XLIO.
+     * @param fd Socket the buffers were received from.
+     * @param bufs Entries filled by recv_zcopy(), the entries with a NULL handle are skipped.
+     * @param count Number of entries.
+     * @return 0 on success, or -1 with errno set.
+     */
+    int (*free_zcopy_bufs)(int fd, const struct xlio_zcopy_buf *bufs, unsigned count);
+
+    /*
+     * Pin a worker thread of the Worker Threads mode to a set of CPUs, a single core or
+     * the cores of a NUMA node.
+     * @param index Worker thread, from 0 to the number of the worker threads - 1.
+     * @param cpusetsize Size of the set, sizeof(cpu_set_t).
+     * @param cpuset Pointer to the cpu_set_t of the CPUs.
+     * @return 0 on success, or -1 with errno set. EOPNOTSUPP if the Worker Threads mode
+     * isn't enabled, EINVAL for a wrong index or an empty set.
+     */
+    int (*worker_thread_set_affinity)(unsigned index, size_t cpusetsize, const void *cpuset);
+
+    /*
+     * Send the application memory without a copy, in the Worker Threads mode.
+     * The worker thread of the socket posts the data, the memory must stay unchanged until
+     * poll_zcopy_completions() returns the userdata of the send. The send is ordered with
+     * the other sends of the calling thread and isn't split: it returns -1 with EAGAIN if
+     * the send buffer has no room for the whole data.
+     * @param fd Connected TCP socket.
+     * @param iov Data, registered with xlio_mem_register().
+     * @param iovcnt Number of the iov entries.
+     * @param mkey Memory key of the registration.
+     * @param userdata Value reported with the completion.
+     * @return Number of bytes queued, or -1 with errno set. EOPNOTSUPP if the socket isn't
+     * an offloaded TCP socket of a worker thread.
+     */
+    ssize_t (*send_zcopy)(int fd, const struct iovec *iov, unsigned iovcnt, uint32_t mkey,
+                          uintptr_t userdata);
+
+    /*
+     * Retrieve the completed send_zcopy() operations of a socket, in the send order.
+     * The memory of a completed send can be reused.
+     * @param fd Socket passed to send_zcopy().
+     * @param userdata Array receiving the userdata of the completed sends.
+     * @param count Number of the array entries.
+     * @return Number of the filled entries, or -1 with errno set.
+     */
+    int (*poll_zcopy_completions)(int fd, uintptr_t *userdata, unsigned count);
+
+    /* XLIO Ultra API, see xlio.h. */
+    int (*xlio_socket_buf_rx_info)(xlio_socket_t sock, struct xlio_buf *buf,
+                                   struct xlio_buf_rx_info *info);
+    int (*xlio_poll_group_connect_pool)(xlio_poll_group_t group, const struct sockaddr *to,
+                                        socklen_t tolen, unsigned size);
+    int (*xlio_poll_group_get_connection)(xlio_poll_group_t group, const struct sockaddr *to,
+                                          socklen_t tolen, uintptr_t userdata_sq,
+                                          xlio_socket_t *sock_out);
+    int (*xlio_socket_send_buf)(xlio_socket_t sock, struct xlio_buf *buf, size_t offset,
+                                size_t len, const struct xlio_socket_send_attr *attr);
 };
 
 /*
@@ -23,10 +23,94 @@
 /*
  * Options for setsockopt()/getsockopt()
  */
-#define SO_XLIO_GET_API          2800
-#define SO_XLIO_RING_ALLOC_LOGIC 2810
-#define SO_XLIO_SHUTDOWN_RX      2821
-#define SO_XLIO_EXT_VLAN_TAG     2824
+#define SO_XLIO_GET_API           2800
+#define SO_XLIO_RING_ALLOC_LOGIC  2810
+#define SO_XLIO_SHUTDOWN_RX       2821
+#define SO_XLIO_EXT_VLAN_TAG      2824
+#define SO_XLIO_ADD_MEMBERSHIPS   2830
+#define SO_XLIO_DROP_MEMBERSHIPS  2831
+#define SO_XLIO_RX_POLL           2832
+#define SO_XLIO_TX_WATERMARKS     2833
+#define SO_XLIO_RX_DROP_POLICY    2834
+#define SO_XLIO_NVME_OFFLOAD      2835
+#define SO_XLIO_NVME_DDP_SETUP    2836
+#define SO_XLIO_NVME_DDP_TEARDOWN 2837
+
+/*
+ * @brief SO_XLIO_RX_POLL sets the number of times a blocking receive of the socket polls
+ * 	for data before it goes to sleep, overriding XLIO_RX_POLL for this socket. optval is
+ * 	an int with the XLIO_RX_POLL semantics: -1 polls forever and 0 polls once. It replaces
+ * 	a budget set with SO_BUSY_POLL, which is taken as the time to poll, in usec.
+ */
+
+/*
+ * @brief SO_XLIO_ADD_MEMBERSHIPS and SO_XLIO_DROP_MEMBERSHIPS join or leave many IPv4
+ * 	multicast groups of a UDP socket with a single setsockopt() call at level SOL_SOCKET.
+ * 	optval is an array of struct ip_mreqn and optlen is its size in bytes. Every entry
+ * 	is handled as IP_ADD_MEMBERSHIP or IP_DROP_MEMBERSHIP, in order. On the first
+ * 	failing entry -1 is returned with errno set, the entries before it remain applied.
+ * 	Sockets that aren't handled by the library fail with ENOPROTOOPT.
+ */
+
+/*
+ * @brief SO_XLIO_TX_WATERMARKS sets the send backpressure thresholds of a TCP socket of the
+ * 	Ultra API. optval is a struct xlio_tx_watermarks with the bytes queued and not yet
+ * 	acknowledged by the peer. XLIO_SOCKET_EVENT_TX_CONGESTED is reported when a send
+ * 	reaches high, then XLIO_SOCKET_EVENT_TX_WRITABLE when the ACKs bring it down to low.
+ * 	A zero high disables the events, low must not exceed high.
+ */
+struct xlio_tx_watermarks {
+    uint32_t low;
+    uint32_t high;
+};
+
+/*
+ * @brief SO_XLIO_RX_DROP_POLICY selects the datagrams a UDP socket drops when its SO_RCVBUF is
+ * 	full. optval is an int. XLIO_RX_DROP_NEWEST, the default, drops the arriving datagrams and
+ * 	the rings drop them early while the socket stays full. XLIO_RX_DROP_OLDEST drops the
+ * 	oldest queued datagrams to make room, so the reader gets the most recent data.
+ */
+#define XLIO_RX_DROP_NEWEST 0
+#define XLIO_RX_DROP_OLDEST 1
+
+/*
+ * @brief SO_XLIO_NVME_OFFLOAD enables the NVMe/TCP digests and the data placement on a
+ * 	connected TCP socket, at a PDU boundary of both directions. optval is a struct
+ * 	xlio_nvme_offload, flags is a mask of:
+ * 	XLIO_NVME_TX_DIGEST - the HDGST and DDGST of the sent PDUs which have the HDGSTF and
+ * 	DDGSTF flags are computed. The application reserves the digest fields in its PDUs and
+ * 	XLIO sends the computed digests in their place, the application buffers are not
+ * 	modified. The send(MSG_ZEROCOPY) of such a socket fails with EOPNOTSUPP.
+ * 	XLIO_NVME_RX_DIGEST - the digests of the received PDUs are verified. On a mismatch the
+ * 	socket stops receiving: the reader gets EOF and rx_digest_errors counts the failure.
+ * 	XLIO_NVME_RX_DDP - the data of a received C2HData PDU is copied at its DATAO into the
+ * 	buffer registered for its CCCID, see SO_XLIO_NVME_DDP_SETUP. The placed data is removed
+ * 	from the stream: the reader gets the PDU header, its digest and padding and then the
+ * 	data digest, the PLEN of the header is unchanged.
+ * 	getsockopt() returns the flags and the number of digest errors.
+ * 	The digests are computed in software, fused with the copy of the data where there is one.
+ */
+#define XLIO_NVME_TX_DIGEST (1U << 0)
+#define XLIO_NVME_RX_DIGEST (1U << 1)
+#define XLIO_NVME_RX_DDP    (1U << 2)
+
+struct xlio_nvme_offload {
+    uint32_t flags;
+    uint32_t rx_digest_errors;
+};
+
+/*
+ * @brief SO_XLIO_NVME_DDP_SETUP registers the I/O buffer of a command for the data placement
+ * 	of XLIO_NVME_RX_DDP and SO_XLIO_NVME_DDP_TEARDOWN releases it. optval is a struct
+ * 	xlio_nvme_ddp, the teardown reads the cid only. A C2HData PDU which doesn't fit in the
+ * 	registered buffer isn't placed.
+ */
+struct xlio_nvme_ddp {
+    uint16_t cid;
+    uint16_t reserved;
+    uint32_t len;
+    void *buf;
+};
 
 struct xlio_rate_limit_t {
     uint32_t rate; /* rate limit in Kbps */
@@ -43,6 +127,7 @@ typedef enum {
     RING_LOGIC_PER_CORE = 30,
     RING_LOGIC_PER_CORE_ATTACH_THREADS = 31,
     RING_LOGIC_PER_OBJECT = 32,
+    RING_LOGIC_PER_CORE_POOL = 33,
     RING_LOGIC_LAST
 } ring_logic_t;
 
@@ -124,6 +209,24 @@ struct xlio_buf {
     uint64_t userdata;
 };
 
+/**
+ * @brief Metadata of a receive buffer
+ *
+ * Collected by XLIO from the completion of the packet and retrieved with
+ * xlio_socket_buf_rx_info().
+ *
+ * @par Structure Members:
+ * - hw_timestamp: NIC arrival time converted to the system time, zero if the HW timestamp
+ *   conversion is disabled (XLIO_HW_TS_CONVERSION) or not supported by the device
+ * - rss_hash: RSS hash computed by the NIC, zero if the receive queue doesn't hash
+ * - flow_tag: Flow tag of the steering rule which matched the packet
+ */
+struct xlio_buf_rx_info {
+    struct timespec hw_timestamp;
+    uint32_t rss_hash;
+    uint32_t flow_tag;
+};
+
 /** @} */ // end of xlio_rx group
 
 /**
@@ -158,6 +261,23 @@ struct xlio_buf {
  */
 typedef void (*xlio_memory_cb_t)(void *addr, size_t len, size_t hugepage_size);
 
+/**
+ * @brief Memory pressure callback function
+ *
+ * This callback is invoked when the number of RX buffers XLIO can still provide
+ * drops below core.resources.rx_pool_low_watermark, and again when twice the
+ * watermark is available. Applications can release the buffers held with
+ * xlio_socket_buf_free() or xlio_poll_group_buf_free() on a pressure.
+ *
+ * @param pressure 1 when the pressure starts, 0 when it ends
+ * @param bufs_left Number of RX buffers which can still be provided
+ *
+ * @note The callback can be invoked from any XLIO thread.
+ *
+ * @see xlio_init_attr
+ */
+typedef void (*xlio_memory_pressure_cb_t)(int pressure, size_t bufs_left);
+
 /** @brief Socket events */
 enum {
     /** TCP connection established. */
@@ -168,6 +288,12 @@ enum {
     XLIO_SOCKET_EVENT_CLOSED,
     /** An error occurred, see the error code value. */
     XLIO_SOCKET_EVENT_ERROR,
+    /** Socket migration with xlio_socket_migrate() completed. */
+    XLIO_SOCKET_EVENT_MIGRATED,
+    /** The queued bytes reached the SO_XLIO_TX_WATERMARKS high watermark. */
+    XLIO_SOCKET_EVENT_TX_CONGESTED,
+    /** The queued bytes dropped to the SO_XLIO_TX_WATERMARKS low watermark. */
+    XLIO_SOCKET_EVENT_TX_WRITABLE,
 };
 
 /**
@@ -186,6 +312,12 @@ enum {
  * - XLIO_SOCKET_EVENT_TERMINATED: Socket terminated, no further events
  * - XLIO_SOCKET_EVENT_CLOSED: Passive close by remote peer
  * - XLIO_SOCKET_EVENT_ERROR: Error occurred, see value for error code
+ * - XLIO_SOCKET_EVENT_MIGRATED: Socket is attached to the destination group of
+ *   xlio_socket_migrate(), the event is generated by the destination group
+ * - XLIO_SOCKET_EVENT_TX_CONGESTED: A send queued the high watermark of
+ *   SO_XLIO_TX_WATERMARKS, value is the number of bytes not acknowledged
+ * - XLIO_SOCKET_EVENT_TX_WRITABLE: The acknowledgements brought a congested socket
+ *   down to the low watermark, value is the number of bytes not acknowledged
  *
  * @par Error Codes (for ERROR events):
  * - ECONNABORTED: Connection aborted by local side
@@ -193,7 +325,8 @@ enum {
  * - ECONNREFUSED: Connection refused during handshake
  * - ETIMEDOUT: Connection timed out
  *
- * @note Send operations are allowed only from the ESTABLISHED event context.
+ * @note Send operations are allowed only from the ESTABLISHED and TX_WRITABLE
+ * event contexts.
  *
  * @see xlio_poll_group_attr
  */
@@ -224,6 +357,51 @@ typedef void (*xlio_socket_event_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq
 typedef void (*xlio_socket_comp_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq,
                                       uintptr_t userdata_op);
 
+/**
+ * @brief Batched zero-copy completion callback function
+ *
+ * This callback is invoked once per socket per xlio_poll_group_poll() or
+ * xlio_poll_group_flush() with all the send operations completed since the previous
+ * call. It replaces the per-operation socket_comp_cb when provided.
+ *
+ * @param sock The socket whose send operations completed
+ * @param userdata_sq User data associated with the socket
+ * @param userdata_ops Array of the completed userdata_op values in the completion order
+ * @param count Number of entries in the array
+ *
+ * @note The operations of a TCP socket complete in the send order, so the last
+ * entry is the highest completed operation. The array is valid only during the
+ * callback. A group with XLIO_GROUP_FLAG_SAFE reports each operation at once with
+ * a single entry, since its completions can be polled by the sending threads.
+ *
+ * @see xlio_socket_comp_cb_t
+ * @see xlio_poll_group_attr
+ */
+typedef void (*xlio_socket_comp_batch_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq,
+                                            const uintptr_t *userdata_ops, unsigned count);
+
+/**
+ * @brief TX hardware timestamp callback function
+ *
+ * This callback is invoked for a send operation with XLIO_SOCKET_SEND_FLAG_TIMESTAMP once
+ * its last byte is completed by the NIC.
+ *
+ * @param sock The socket of the send operation
+ * @param userdata_sq User data associated with the socket
+ * @param userdata_op User data of the send operation
+ * @param hw_timestamp NIC transmission time of the last packet, in the system clock
+ *
+ * @note The TX timestamps require the HW timestamp conversion (XLIO_HW_TS_CONVERSION).
+ * A send whose packet is retransmitted or dropped before its completion doesn't
+ * report a timestamp. If several TCP sends end in the same packet, only the last one
+ * reports it. The socket must not be destroyed in this callback.
+ *
+ * @see XLIO_SOCKET_SEND_FLAG_TIMESTAMP
+ * @see xlio_poll_group_attr
+ */
+typedef void (*xlio_socket_tx_ts_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq,
+                                       uintptr_t userdata_op, const struct timespec *hw_timestamp);
+
 /**
  * @brief Receive data callback function
  *
@@ -246,6 +424,42 @@ typedef void (*xlio_socket_comp_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq,
 typedef void (*xlio_socket_rx_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq, void *data,
                                     size_t len, struct xlio_buf *buf);
 
+/**
+ * @brief Received buffer entry of a batched receive callback
+ *
+ * @par Structure Members:
+ * - void *data: Pointer to the received data
+ * - size_t len: Length of the received data
+ * - struct xlio_buf *buf: Buffer descriptor that must be returned via xlio_*_buf_free()
+ */
+struct xlio_rx_batch_entry {
+    void *data;
+    size_t len;
+    struct xlio_buf *buf;
+};
+
+/**
+ * @brief Batched receive data callback function
+ *
+ * This callback is invoked once per socket per xlio_poll_group_poll() iteration
+ * with all the buffers received by the socket during the iteration. It replaces
+ * the per-buffer socket_rx_cb when provided.
+ *
+ * @param sock The socket that received the data
+ * @param userdata_sq User data associated with the socket
+ * @param entries Array of the received buffers in the order of arrival
+ * @param count Number of entries in the array
+ *
+ * @note The entries array is valid only during the callback, while each buffer
+ * remains owned by the application until it is freed.
+ *
+ * @see xlio_socket_rx_cb_t
+ * @see xlio_poll_group_attr
+ */
+typedef void (*xlio_socket_rx_batch_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq,
+                                          const struct xlio_rx_batch_entry *entries,
+                                          unsigned count);
+
 /**
  * @brief Accept callback function
  *
@@ -266,6 +480,94 @@ typedef void (*xlio_socket_rx_cb_t)(xlio_socket_t sock, uintptr_t userdata_sq, v
 typedef void (*xlio_socket_accept_cb_t)(xlio_socket_t sock, xlio_socket_t parent,
                                         uintptr_t parent_userdata_sq);
 
+/**
+ * @brief Accepted connection entry of a batched accept callback
+ *
+ * @par Structure Members:
+ * - xlio_socket_t sock: The newly accepted socket
+ * - xlio_socket_t parent: The listening socket that accepted the connection
+ * - uintptr_t parent_userdata_sq: User data from the parent socket
+ */
+struct xlio_accept_batch_entry {
+    xlio_socket_t sock;
+    xlio_socket_t parent;
+    uintptr_t parent_userdata_sq;
+};
+
+/**
+ * @brief Batched accept callback function
+ *
+ * This callback is invoked once per xlio_poll_group_poll() iteration with all
+ * the connections established during the iteration on all the listening sockets
+ * of the group. It replaces the per-connection socket_accept_cb when provided.
+ *
+ * @param group The polling group of the listening sockets
+ * @param entries Array of the accepted connections in the order of establishment
+ * @param count Number of entries in the array
+ *
+ * @note The entries array is valid only during the callback. A connection is
+ * always reported before any other callback is invoked for its socket.
+ *
+ * @see xlio_socket_accept_cb_t
+ * @see xlio_poll_group_attr
+ */
+typedef void (*xlio_socket_accept_batch_cb_t)(xlio_poll_group_t group,
+                                              const struct xlio_accept_batch_entry *entries,
+                                              unsigned count);
+
+/** Continue with the regular processing of the packet. */
+#define XLIO_RX_FILTER_PASS 0
+/** Drop the packet, its buffer is recycled right away. */
+#define XLIO_RX_FILTER_DROP 1
+/** The application takes the buffer over and frees it with xlio_poll_group_buf_free(). */
+#define XLIO_RX_FILTER_REDIRECT 2
+
+/**
+ * @brief Received packet passed to the RX filter callback
+ *
+ * @par Structure Members:
+ * - const void *frame: Start of the Ethernet frame
+ * - const void *l3_hdr: IPv4 or IPv6 header, NULL for the other protocols
+ * - const void *l4_hdr: Transport header, NULL for the non first IPv4 fragments or if the
+ *   header is not within the frame
+ * - uint32_t len: Bytes received in the frame, including the Ethernet padding
+ * - uint16_t vlan_id: VLAN ID of the frame, 0 if the frame is not tagged
+ * - uint8_t l3_family: AF_INET, AF_INET6 or AF_UNSPEC for the other protocols
+ * - uint8_t l4_proto: IP protocol of the transport header (IPPROTO_UDP, IPPROTO_TCP...)
+ */
+struct xlio_rx_filter_pkt {
+    const void *frame;
+    const void *l3_hdr;
+    const void *l4_hdr;
+    uint32_t len;
+    uint16_t vlan_id;
+    uint8_t l3_family;
+    uint8_t l4_proto;
+};
+
+/**
+ * @brief RX filter callback function
+ *
+ * This callback is invoked for each packet received on the rings of a polling group,
+ * right after its completion is parsed. It runs before the socket lookup, the queueing
+ * and the wakeup, so the unwanted packets cost neither of them.
+ *
+ * @param group The polling group of the ring
+ * @param pkt Headers of the packet, valid only during the callback
+ * @param buf Buffer of the packet, owned by the application if XLIO_RX_FILTER_REDIRECT
+ *            is returned
+ * @return XLIO_RX_FILTER_PASS, XLIO_RX_FILTER_DROP or XLIO_RX_FILTER_REDIRECT
+ *
+ * @note The callback is called from xlio_poll_group_poll() and must not call XLIO
+ * functions other than xlio_poll_group_buf_free(). The packet is not checked before the
+ * callback beyond its length, the checksum offload result is not applied yet.
+ * Drops and redirects are counted per ring by xlio_stats.
+ *
+ * @see xlio_poll_group_attr
+ */
+typedef int (*xlio_rx_filter_cb_t)(xlio_poll_group_t group, const struct xlio_rx_filter_pkt *pkt,
+                                   struct xlio_buf *buf);
+
 /** @} */ // end of xlio_callbacks group
 
 /**
@@ -287,11 +589,22 @@ typedef void (*xlio_socket_accept_cb_t)(xlio_socket_t sock, xlio_socket_t parent
  * - Current implementation allocates a single memory block during xlio_init_ex()
  * - For external allocators, hugepage_size in memory_cb is always reported as zero
  *
+ * @par RX Memory Notes:
+ * - rx_memory_alloc/rx_memory_free provide the memory the RX payloads are received to,
+ *   overriding memory_alloc/memory_free for the RX buffers only
+ * - Received data lands directly in the application memory, the rx callbacks point to it
+ * - A buffer returns to XLIO with xlio_socket_buf_free() or xlio_poll_group_buf_free()
+ * - The memory is released with rx_memory_free() in xlio_exit()
+ * - memory_cb reports the RX memory block separately from the other blocks
+ *
  * @par Structure Members:
  * - unsigned flags: Initialization flags (reserved for future use)
  * - xlio_memory_cb_t memory_cb: Memory allocation notification callback
  * - void *(*memory_alloc)(size_t): Optional external memory allocator function
  * - void (*memory_free)(void *): Optional external memory deallocator function
+ * - void *(*rx_memory_alloc)(size_t): Optional external allocator of the RX buffers
+ * - void (*rx_memory_free)(void *): Optional external deallocator of the RX buffers
+ * - xlio_memory_pressure_cb_t memory_pressure_cb: RX memory pressure notification callback
  */
 struct xlio_init_attr {
     unsigned flags;
@@ -300,6 +613,13 @@ struct xlio_init_attr {
     /* Optional external user allocator for XLIO buffers. */
     void *(*memory_alloc)(size_t);
     void (*memory_free)(void *);
+
+    /* Optional external user allocator for the RX buffers. */
+    void *(*rx_memory_alloc)(size_t);
+    void (*rx_memory_free)(void *);
+
+    /* Optional RX memory pressure notification, see rx_pool_low_watermark. */
+    xlio_memory_pressure_cb_t memory_pressure_cb;
 };
 
 /** @} */ // end of xlio_init group
@@ -313,6 +633,11 @@ struct xlio_init_attr {
 #define XLIO_GROUP_FLAG_SAFE 0x1
 /** Group will keep dirty sockets to be flushed with xlio_poll_group_flush(). */
 #define XLIO_GROUP_FLAG_DIRTY 0x2
+/** attr_size of the attributes is set, the members after it are read up to attr_size. */
+#define XLIO_GROUP_FLAG_ATTR_SIZE 0x4
+
+/** Max rx_queues of a polling group. */
+#define XLIO_GROUP_RX_QUEUES_MAX 64U
 
 /**
  * @brief Polling group attributes
@@ -328,6 +653,46 @@ struct xlio_init_attr {
  * - socket_comp_cb: Zero-copy completion notifications
  * - socket_rx_cb: Receive data notifications
  * - socket_accept_cb: New connection acceptance (required for listening sockets)
+ * - socket_rx_batch_cb: Batched receive data notifications (overrides socket_rx_cb)
+ * - socket_accept_batch_cb: Batched connection acceptance (overrides socket_accept_cb)
+ * - socket_comp_batch_cb: Batched zero-copy completions (overrides socket_comp_cb)
+ *
+ * @par Accept Pool:
+ * A group with non-zero accept_pool_size keeps up to that many pre-constructed TCP
+ * socket objects. Incoming connections take the objects from the pool, so the
+ * allocation is not done on the handshake path. The pool is refilled at the end
+ * of the polling iteration.
+ *
+ * @par Ring Polling:
+ * Rings of the group are polled round-robin, each polling iteration starts from the
+ * next ring. Non-zero ring_poll_budget limits the number of RX completions processed
+ * per ring in an iteration, so a busy ring doesn't delay the others. Zero keeps the
+ * performance.polling.max_rx_poll_batch default. Per ring counters are shown by xlio_stats.
+ *
+ * @par RX Filter:
+ * rx_filter_cb sees every packet of the group rings before the socket lookup. It can
+ * drop the packet, pass it on or take its buffer over, e.g. to discard a flood of
+ * unwanted datagrams at the ring.
+ *
+ * @par Socket Priority:
+ * Sockets created or updated with XLIO_SOCKET_FLAG_HIGH_PRIO are served first: they are
+ * flushed before the other dirty sockets and their batched RX data is delivered first.
+ * Non-zero flush_budget limits the number of normal priority sockets flushed by a single
+ * xlio_poll_group_flush(), the remaining sockets are flushed by the following flushes and
+ * polls of the group. Zero flushes all the dirty sockets.
+ *
+ * @par RX Queues:
+ * With rx_queues greater than 1, the group owns that many rings per network device
+ * instead of one. Each accepted connection is steered to one of them round-robin by
+ * its own flow rule, so the traffic of a single group is spread over several RX queues
+ * and CQs, and xlio_poll_group_poll() services all of them. The listen sockets and the
+ * outgoing connections use the first ring. Zero is the same as 1.
+ *
+ * @par Attributes Size:
+ * Without XLIO_GROUP_FLAG_ATTR_SIZE only the members up to socket_accept_cb are read, as
+ * they were laid out by the first version of the structure. To use the following members,
+ * set the flag and attr_size to sizeof(struct xlio_poll_group_attr). The members beyond
+ * attr_size are taken as zero, the bytes beyond the library's own structure are ignored.
  *
  * @par Structure Members:
  * - unsigned flags: Group flags (XLIO_GROUP_FLAG_*)
@@ -335,6 +700,18 @@ struct xlio_init_attr {
  * - xlio_socket_comp_cb_t socket_comp_cb: Zero-copy completion callback (optional)
  * - xlio_socket_rx_cb_t socket_rx_cb: Receive data callback (optional)
  * - xlio_socket_accept_cb_t socket_accept_cb: Accept callback for listening sockets (optional)
+ * - unsigned attr_size: Size of the structure, read with XLIO_GROUP_FLAG_ATTR_SIZE only
+ * - xlio_socket_rx_batch_cb_t socket_rx_batch_cb: Batched receive data callback (optional)
+ * - xlio_socket_accept_batch_cb_t socket_accept_batch_cb: Batched accept callback (optional)
+ * - unsigned accept_pool_size: Number of pre-constructed accept sockets, 0 disables the pool
+ * - unsigned ring_poll_budget: Max RX completions per ring per polling iteration, 0 for default
+ * - xlio_socket_comp_batch_cb_t socket_comp_batch_cb: Batched zero-copy completion callback
+ *   (optional)
+ * - xlio_socket_tx_ts_cb_t socket_tx_ts_cb: TX hardware timestamp callback (optional)
+ * - xlio_rx_filter_cb_t rx_filter_cb: Early filter of the received packets (optional)
+ * - unsigned flush_budget: Max normal priority sockets flushed per pass, 0 for unlimited
+ * - unsigned rx_queues: Rings per network device for the accepted connections, up to
+ *   XLIO_GROUP_RX_QUEUES_MAX, 0 for a single ring
  */
 struct xlio_poll_group_attr {
     unsigned flags;
@@ -343,6 +720,16 @@ struct xlio_poll_group_attr {
     xlio_socket_comp_cb_t socket_comp_cb;
     xlio_socket_rx_cb_t socket_rx_cb;
     xlio_socket_accept_cb_t socket_accept_cb;
+    unsigned attr_size;
+    xlio_socket_rx_batch_cb_t socket_rx_batch_cb;
+    xlio_socket_accept_batch_cb_t socket_accept_batch_cb;
+    unsigned accept_pool_size;
+    unsigned ring_poll_budget;
+    xlio_socket_comp_batch_cb_t socket_comp_batch_cb;
+    xlio_socket_tx_ts_cb_t socket_tx_ts_cb;
+    xlio_rx_filter_cb_t rx_filter_cb;
+    unsigned flush_budget;
+    unsigned rx_queues;
 };
 
 /** @} */ // end of xlio_poll_group group
@@ -352,6 +739,11 @@ struct xlio_poll_group_attr {
  * @{
  */
 
+/** Create a datagram (SOCK_DGRAM) socket instead of a stream one. */
+#define XLIO_SOCKET_FLAG_DGRAM 0x1
+/** Serve the socket before the normal priority sockets of the group. */
+#define XLIO_SOCKET_FLAG_HIGH_PRIO 0x2
+
 /**
  * @brief Socket creation attributes
  *
@@ -362,12 +754,20 @@ struct xlio_poll_group_attr {
  * - AF_INET: IPv4 support
  * - AF_INET6: IPv6 support
  *
+ * @par Socket Type:
+ * - Stream (TCP) socket is created by default
+ * - XLIO_SOCKET_FLAG_DGRAM: Datagram (UDP) socket
+ *
+ * @par Priority:
+ * - XLIO_SOCKET_FLAG_HIGH_PRIO: Latency critical socket, e.g. a control connection next to
+ *   bulk transfers within the group. Can be changed later with xlio_socket_update()
+ *
  * @par User Data:
  * - userdata_sq: Application-defined value for socket identification in callbacks
  * - Can be updated later with xlio_socket_update()
  *
  * @par Structure Members:
- * - unsigned flags: Socket flags (reserved for future use)
+ * - unsigned flags: Socket flags (XLIO_SOCKET_FLAG_*)
  * - int domain: Address family (AF_INET or AF_INET6)
  * - xlio_poll_group_t group: Polling group to associate socket with
  * - uintptr_t userdata_sq: User data for socket identification in callbacks
@@ -390,6 +790,8 @@ struct xlio_socket_attr {
 #define XLIO_SOCKET_SEND_FLAG_FLUSH 0x1
 /** Copy user data to the internal buffers instead of taking ownership. */
 #define XLIO_SOCKET_SEND_FLAG_INLINE 0x2
+/** Report the TX hardware timestamp of the operation with socket_tx_ts_cb. */
+#define XLIO_SOCKET_SEND_FLAG_TIMESTAMP 0x4
 
 /**
  * @brief Send operation attributes
@@ -400,7 +802,8 @@ struct xlio_socket_attr {
  * @par Zero-Copy Operation:
  * - mkey: Memory key for registered memory regions
  * - userdata_op: User data provided to completion callback
- * - For zero-copy, memory must be registered with ibv_pd from xlio_socket_get_pd()
+ * - For zero-copy, memory must be registered with xlio_mem_register() or with ibv_pd
+ *   from xlio_socket_get_pd()
  *
  * @par Inline vs Zero-Copy:
  * - INLINE flag: Data copied to internal buffers, no completion callback
@@ -281,14 +281,15 @@ struct socket_listen_counter_aggregate {
 
     static const constexpr char *hdr_val =
         "IP4_RX_SYN,IP4_RX_SYN_TW,IP4_RX_FIN,IP4_NUM_ESTAB_CONN,IP4_NUM_ACCEP_CONN,"
-        "IP4_NUM_DROPPED_CONN,IP4_BACKLOG,"
+        "IP4_NUM_DROPPED_CONN,IP4_SYNCOOKIES_SENT,IP4_SYNCOOKIES_VALIDATED,IP4_BACKLOG,"
         "IP6_RX_SYN,IP6_RX_SYN_TW,IP6_RX_FIN,IP6_NUM_ESTAB_CONN,IP6_NUM_ACCEP_CONN,"
-        "IP6_NUM_DROPPED_CONN,IP6_BACKLOG,";
+        "IP6_NUM_DROPPED_CONN,IP6_SYNCOOKIES_SENT,IP6_SYNCOOKIES_VALIDATED,IP6_BACKLOG,";
 
 private:
     listen_counters summarize_listen_counters(const sh_mem_t &mem)
     {
-        listen_counters lc {.ipv4 = {0, 0, 0, 0, 0, 0, 0}, .ipv6 = {0, 0, 0, 0, 0, 0, 0}};
+        listen_counters lc {.ipv4 = {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                            .ipv6 = {0, 0, 0, 0, 0, 0, 0, 0, 0}};
         for (size_t i = 0; i < mem.max_skt_inst_num; i++) {
             if (!mem.skt_inst_arr[i].b_enabled) {
                 continue;
@@ -319,10 +320,12 @@ std::ostream &operator<<(std::ostream &os, const listen_counters &obj)
 {
     return os << obj.ipv4.n_rx_syn << "," << obj.ipv4.n_rx_syn_tw << "," << obj.ipv4.n_rx_fin << ","
               << obj.ipv4.n_conn_established << "," << obj.ipv4.n_conn_accepted << ","
-              << obj.ipv4.n_conn_dropped << "," << obj.ipv4.n_conn_backlog << ","
+              << obj.ipv4.n_conn_dropped << "," << obj.ipv4.n_syncookies_sent << ","
+              << obj.ipv4.n_syncookies_validated << "," << obj.ipv4.n_conn_backlog << ","
               << obj.ipv6.n_rx_syn << "," << obj.ipv6.n_rx_syn_tw << "," << obj.ipv6.n_rx_fin << ","
               << obj.ipv6.n_conn_established << "," << obj.ipv6.n_conn_accepted << ","
-              << obj.ipv6.n_conn_dropped << "," << obj.ipv6.n_conn_backlog << ",";
+              << obj.ipv6.n_conn_dropped << "," << obj.ipv6.n_syncookies_sent << ","
+              << obj.ipv6.n_syncookies_validated << "," << obj.ipv6.n_conn_backlog << ",";
 }
 
 listen_counters operator-(listen_counters lhs, const listen_counters &rhs)
@@ -0,0 +1,602 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <sstream>
+#include <utility>
+
+#include "stats/stats_exporter.h"
+
+#define MODULE_NAME "xliostat"
+#define log_err(log_fmt, log_args...) fprintf(stderr, MODULE_NAME ": " log_fmt "\n", ##log_args)
+
+#define EXPORTER_BACKLOG         16
+#define EXPORTER_REQUEST_MAX     4096
+#define EXPORTER_REFRESH_MSEC    1000
+#define EXPORTER_CLIENT_TIMEOUT  1 // sec
+
+enum metric_type_t { e_counter, e_gauge };
+
+template <typename T> struct metric_desc {
+    const char *name;
+    metric_type_t type;
+    const char *help;
+    int64_t (*get)(const T &);
+};
+
+// The labels of an instance, e.g. pid="1",app="a",ring="0", and its counters
+template <typename T> using metric_instances = std::vector<std::pair<std::string, const T *>>;
+
+#define METRIC(T, name, type, field, help)                                                         \
+    {                                                                                              \
+        name, type, help, [](const T &s) -> int64_t { return static_cast<int64_t>(s.field); }      \
+    }
+
+#define SOCKET_COUNTER(name, field, help) METRIC(socket_stats_t, name, e_counter, field, help)
+#define SOCKET_GAUGE(name, field, help)   METRIC(socket_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<socket_stats_t> socket_metrics[] = {
+    SOCKET_GAUGE("tcp_state", tcp_state, "TCP state of the socket"),
+    SOCKET_GAUGE("tcp_snd_cwnd", tcp_snd_cwnd, "TCP congestion window in segments"),
+    SOCKET_GAUGE("tcp_rtt_usec", tcp_rtt_usec, "TCP smoothed RTT"),
+    SOCKET_GAUGE("tcp_unacked", tcp_unacked, "TCP segments in flight"),
+    SOCKET_GAUGE("tcp_rcv_wnd", tcp_rcv_wnd, "TCP receive window"),
+    SOCKET_GAUGE("tcp_mss", tcp_mss, "TCP effective send MSS"),
+    SOCKET_GAUGE("rx_ready_packets", n_rx_ready_pkt_count, "Packets in the RX ready queue"),
+    SOCKET_GAUGE("rx_ready_bytes", n_rx_ready_byte_count, "Bytes in the RX ready queue"),
+    SOCKET_GAUGE("tx_ready_bytes", n_tx_ready_byte_count, "Bytes queued for transmission"),
+    SOCKET_COUNTER("rx_packets", counters.n_rx_packets, "Offloaded RX packets"),
+    SOCKET_COUNTER("rx_bytes", counters.n_rx_bytes, "Offloaded RX bytes"),
+    SOCKET_COUNTER("rx_data_packets", counters.n_rx_data_pkts, "RX packets with payload"),
+    SOCKET_COUNTER("rx_frags", counters.n_rx_frags, "RX buffers of the received packets"),
+    SOCKET_COUNTER("rx_gro", counters.n_gro, "GRO aggregated RX packets"),
+    SOCKET_COUNTER("rx_poll_hits", counters.n_rx_poll_hit, "RX polls which found data"),
+    SOCKET_COUNTER("rx_poll_misses", counters.n_rx_poll_miss, "RX polls which found no data"),
+    SOCKET_GAUGE("rx_ready_packets_max", counters.n_rx_ready_pkt_max,
+                 "Maximum of the packets in the RX ready queue"),
+    SOCKET_GAUGE("rx_ready_bytes_max", counters.n_rx_ready_byte_max,
+                 "Maximum of the bytes in the RX ready queue"),
+    SOCKET_COUNTER("rx_ready_packet_drops", counters.n_rx_ready_pkt_drop,
+                   "RX packets dropped by the full ready queue"),
+    SOCKET_COUNTER("rx_ready_byte_drops", counters.n_rx_ready_byte_drop,
+                   "RX bytes dropped by the full ready queue"),
+    SOCKET_COUNTER("rx_errors", counters.n_rx_errors, "RX calls which failed"),
+    SOCKET_COUNTER("rx_eagain", counters.n_rx_eagain, "RX calls which returned EAGAIN"),
+    SOCKET_COUNTER("rx_os_packets", counters.n_rx_os_packets, "RX packets from the OS"),
+    SOCKET_COUNTER("rx_os_bytes", counters.n_rx_os_bytes, "RX bytes from the OS"),
+    SOCKET_COUNTER("rx_os_poll_hits", counters.n_rx_poll_os_hit, "OS polls which found data"),
+    SOCKET_COUNTER("rx_os_errors", counters.n_rx_os_errors, "OS RX calls which failed"),
+    SOCKET_COUNTER("rx_os_eagain", counters.n_rx_os_eagain, "OS RX calls which returned EAGAIN"),
+    SOCKET_COUNTER("rx_migrations", counters.n_rx_migrations, "RX ring migrations"),
+    SOCKET_COUNTER("rx_compacted", counters.n_rx_compacted, "RX buffers compacted"),
+    SOCKET_COUNTER("rx_budget_limited", counters.n_rx_budget_limited,
+                   "RX processing stopped by the budget"),
+    SOCKET_COUNTER("rx_placed", counters.n_rx_placed,
+                   "RX packets copied into a pending MSG_WAITALL read"),
+    SOCKET_GAUGE("rx_window_max", counters.n_rx_wnd_max, "Maximum of the TCP receive window"),
+    SOCKET_COUNTER("rx_window_grows", counters.n_rx_wnd_grows, "TCP receive window grows"),
+    SOCKET_COUNTER("rx_window_shrinks", counters.n_rx_wnd_shrinks, "TCP receive window shrinks"),
+    SOCKET_COUNTER("tx_packets", counters.n_tx_sent_pkt_count, "Offloaded TX packets"),
+    SOCKET_COUNTER("tx_bytes", counters.n_tx_sent_byte_count, "Offloaded TX bytes"),
+    SOCKET_COUNTER("tx_errors", counters.n_tx_errors, "TX calls which failed"),
+    SOCKET_COUNTER("tx_eagain", counters.n_tx_eagain, "TX calls which returned EAGAIN"),
+    SOCKET_COUNTER("tx_retransmits", counters.n_tx_retransmits, "TCP retransmissions"),
+    SOCKET_COUNTER("tx_sack_retransmits", counters.n_tx_sack_retransmits,
+                   "TCP retransmissions of the SACK holes"),
+    SOCKET_COUNTER("tx_os_packets", counters.n_tx_os_packets, "TX packets through the OS"),
+    SOCKET_COUNTER("tx_os_bytes", counters.n_tx_os_bytes, "TX bytes through the OS"),
+    SOCKET_COUNTER("tx_os_errors", counters.n_tx_os_errors, "OS TX calls which failed"),
+    SOCKET_COUNTER("tx_os_eagain", counters.n_tx_os_eagain, "OS TX calls which returned EAGAIN"),
+    SOCKET_COUNTER("tx_migrations", counters.n_tx_migrations, "TX ring migrations"),
+    SOCKET_COUNTER("tx_dummy", counters.n_tx_dummy, "Dummy TX packets"),
+    SOCKET_COUNTER("tx_sendfile_fallbacks", counters.n_tx_sendfile_fallbacks,
+                   "sendfile() calls served by the copy path"),
+    SOCKET_COUNTER("tx_sendfile_overflows", counters.n_tx_sendfile_overflows,
+                   "sendfile() calls which overflowed the send buffer"),
+    SOCKET_COUNTER("rx_strides", strq_counters.n_strq_total_strides, "RX strides received"),
+    SOCKET_GAUGE("rx_strides_per_packet_max", strq_counters.n_strq_max_strides_per_packet,
+                 "Maximum of the strides of an RX packet"),
+    SOCKET_COUNTER("rx_syn", listen_counters.n_rx_syn, "SYN packets of the listen socket"),
+    SOCKET_COUNTER("rx_syn_time_wait", listen_counters.n_rx_syn_tw,
+                   "SYN packets to a connection in TIME-WAIT"),
+    SOCKET_COUNTER("rx_fin", listen_counters.n_rx_fin, "FIN packets of the listen socket"),
+    SOCKET_COUNTER("conn_established", listen_counters.n_conn_established,
+                   "Connections established"),
+    SOCKET_COUNTER("conn_accepted", listen_counters.n_conn_accepted, "Connections accepted"),
+    SOCKET_COUNTER("conn_dropped", listen_counters.n_conn_dropped, "Connections dropped"),
+    SOCKET_COUNTER("syncookies_sent", listen_counters.n_syncookies_sent, "SYN cookies sent"),
+    SOCKET_COUNTER("syncookies_validated", listen_counters.n_syncookies_validated,
+                   "SYN cookies validated"),
+    SOCKET_GAUGE("conn_backlog", listen_counters.n_conn_backlog,
+                 "Connections waiting for accept()"),
+    SOCKET_COUNTER("tcp_rto", tcp_loss.n_rto, "TCP retransmission timeouts"),
+    SOCKET_COUNTER("tcp_recoveries", tcp_loss.n_recovery, "TCP fast recoveries"),
+    SOCKET_COUNTER("tcp_tail_loss_probes", tcp_loss.n_tlp, "TCP tail loss probes"),
+    SOCKET_COUNTER("tcp_spurious_retransmits", tcp_loss.n_spurious_rexmit,
+                    "TCP retransmissions delivered by the original transmission"),
+    SOCKET_COUNTER("tcp_zero_windows", tcp_loss.n_zero_wnd,
+                   "TCP windows closed by the remote host"),
+    SOCKET_COUNTER("tcp_rwnd_limited_usec", tcp_loss.rwnd_limited_usec,
+                    "TCP sender time limited by the remote window"),
+    SOCKET_COUNTER("tcp_cwnd_limited_usec", tcp_loss.cwnd_limited_usec,
+                    "TCP sender time limited by the congestion window"),
+    SOCKET_COUNTER("tcp_sndbuf_limited_usec", tcp_loss.sndbuf_limited_usec,
+                    "TCP sender time limited by the send buffer"),
+    SOCKET_COUNTER("tcp_app_limited_usec", tcp_loss.app_limited_usec,
+                    "TCP sender time limited by the application"),
+#ifdef DEFINED_UTLS
+    SOCKET_COUNTER("tls_tx_bytes", tls_counters.n_tls_tx_bytes, "TLS TX payload bytes"),
+    SOCKET_COUNTER("tls_tx_records", tls_counters.n_tls_tx_records, "TLS TX records"),
+    SOCKET_COUNTER("tls_tx_resyncs", tls_counters.n_tls_tx_resync, "TLS TX resyncs"),
+    SOCKET_COUNTER("tls_tx_resync_replays", tls_counters.n_tls_tx_resync_replay,
+                   "TLS TX resyncs which replayed a record"),
+    SOCKET_COUNTER("tls_tx_key_updates", tls_counters.n_tls_tx_key_updates,
+                   "TLS 1.3 TX key updates"),
+    SOCKET_COUNTER("tls_rx_bytes", tls_counters.n_tls_rx_bytes, "TLS RX payload bytes"),
+    SOCKET_COUNTER("tls_rx_records", tls_counters.n_tls_rx_records, "TLS RX records"),
+    SOCKET_COUNTER("tls_rx_records_full_enc", tls_counters.n_tls_rx_records_full_enc,
+                   "TLS RX records decrypted by software"),
+    SOCKET_COUNTER("tls_rx_records_head_enc", tls_counters.n_tls_rx_records_head_enc,
+                   "TLS RX records with an encrypted head"),
+    SOCKET_COUNTER("tls_rx_records_tail_enc", tls_counters.n_tls_rx_records_tail_enc,
+                   "TLS RX records with an encrypted tail"),
+    SOCKET_COUNTER("tls_rx_records_mix_enc", tls_counters.n_tls_rx_records_mix_enc,
+                   "TLS RX records partially decrypted by the HW"),
+    SOCKET_COUNTER("tls_rx_hw_auth_failures", tls_counters.n_tls_rx_records_hw_auth_fail,
+                   "TLS RX records which failed the HW authentication"),
+    SOCKET_COUNTER("tls_rx_sw_decrypt_failures", tls_counters.n_tls_rx_records_sw_dec_fail,
+                   "TLS RX records which failed the software decryption"),
+    SOCKET_COUNTER("tls_rx_resyncs", tls_counters.n_tls_rx_resync, "TLS RX resyncs"),
+#endif /* DEFINED_UTLS */
+};
+
+#define RING_COUNTER(name, field, help) METRIC(ring_stats_t, name, e_counter, field, help)
+#define RING_GAUGE(name, field, help)   METRIC(ring_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<ring_stats_t> ring_metrics[] = {
+    RING_COUNTER("rx_packets", n_rx_pkt_count, "RX packets"),
+    RING_COUNTER("rx_bytes", n_rx_byte_count, "RX bytes"),
+    RING_COUNTER("rx_interrupt_requests", n_rx_interrupt_requests, "RX interrupts requested"),
+    RING_COUNTER("rx_interrupts", n_rx_interrupt_received, "RX interrupts received"),
+    RING_GAUGE("rx_cq_moderation_count", n_rx_cq_moderation_count,
+               "Frames of the RX CQ moderation"),
+    RING_GAUGE("rx_cq_moderation_period_usec", n_rx_cq_moderation_period,
+               "Period of the RX CQ moderation"),
+    RING_GAUGE("rx_cq_moderation_gap_usec", n_rx_cq_moderation_gap_usec,
+               "Median gap between the RX bursts of the last moderation decision"),
+    RING_GAUGE("rx_cq_moderation_burst", n_rx_cq_moderation_burst,
+               "90th percentile of the RX burst size of the last moderation decision"),
+    RING_GAUGE("rx_cq_moderation_target_frames", n_rx_cq_moderation_target_frames,
+               "Frames expected within the target latency of the last moderation decision"),
+    RING_COUNTER("rx_cq_moderation_decisions", n_rx_cq_moderation_decisions,
+                 "RX CQ moderation decisions"),
+    RING_COUNTER("rx_poll_cqes", n_rx_poll_cqes, "RX completions processed by the polling"),
+    RING_COUNTER("rx_poll_budget_hits", n_rx_poll_budget_hits,
+                 "RX polls stopped by the budget with the CQ not drained"),
+    RING_GAUGE("rx_steering_rules", n_rx_steering_rules, "RX steering rules"),
+    RING_COUNTER("rx_steering_rule_fails", n_rx_steering_rule_fails,
+                 "Deferred RX steering rules which failed to be created"),
+    RING_GAUGE("rx_tls_contexts", n_rx_tls_contexts, "TLS RX contexts"),
+    RING_COUNTER("rx_tls_resyncs", n_rx_tls_resyncs, "TLS RX resyncs"),
+    RING_COUNTER("rx_tls_auth_failures", n_rx_tls_auth_fail, "TLS RX authentication failures"),
+    RING_COUNTER("rx_zc_migration_drops", n_rx_zc_migiration_drop,
+                 "Zero copy RX buffers dropped by a migration"),
+    RING_COUNTER("rx_filter_drops", n_rx_filter_drops, "RX packets dropped by the RX filter"),
+    RING_COUNTER("rx_filter_redirects", n_rx_filter_redirects,
+                 "RX packets taken over by the RX filter"),
+    RING_COUNTER("tx_packets", n_tx_pkt_count, "TX packets"),
+    RING_COUNTER("tx_bytes", n_tx_byte_count, "TX bytes"),
+    RING_COUNTER("tx_retransmits", n_tx_retransmits, "TX retransmissions"),
+    RING_COUNTER("tx_tso_packets", n_tx_tso_pkt_count, "TSO TX packets"),
+    RING_COUNTER("tx_tso_bytes", n_tx_tso_byte_count, "TSO TX bytes"),
+    RING_COUNTER("tx_odp_packets", n_tx_odp_pkt_count,
+                 "TX packets which referenced the implicit ODP region"),
+    RING_COUNTER("tx_odp_bytes", n_tx_odp_byte_count,
+                 "TX bytes which referenced the implicit ODP region"),
+    RING_GAUGE("tx_bufs", n_tx_num_bufs, "TX buffers of the ring"),
+    RING_GAUGE("zc_bufs", n_zc_num_bufs, "Zero copy TX buffers of the ring"),
+    RING_COUNTER("tx_dropped_wqes", n_tx_dropped_wqes, "TX WQEs dropped"),
+    RING_COUNTER("tx_wqes", n_tx_wqes, "TX WQEs posted"),
+    RING_COUNTER("tx_wqes_signaled", n_tx_wqes_signaled, "TX WQEs which requested a completion"),
+    RING_COUNTER("tx_doorbells", n_tx_doorbells, "Doorbells rung on the SQ"),
+    RING_COUNTER("tx_bf_wqes", n_tx_bf_wqes, "TX WQEs pushed through BlueFlame"),
+    RING_COUNTER("tx_mpwqe_sessions", n_tx_mpwqe_sessions, "TX multi-packet WQEs posted"),
+    RING_COUNTER("tx_mpwqe_packets", n_tx_mpwqe_pkts, "TX packets packed into multi-packet WQEs"),
+    RING_COUNTER("tx_doorbells_saved", n_tx_db_saved,
+                 "Doorbells avoided by the batched poll group flush"),
+    RING_GAUGE("tx_tls_contexts", n_tx_tls_contexts, "TLS TX contexts"),
+    RING_COUNTER("tx_tls_resyncs", n_tx_tls_resyncs, "TLS TX resyncs"),
+    RING_COUNTER("tx_dev_mem_packets", n_tx_dev_mem_pkt_count, "TX packets from device memory"),
+    RING_COUNTER("tx_dev_mem_bytes", n_tx_dev_mem_byte_count, "TX bytes from device memory"),
+    RING_COUNTER("tx_dev_mem_oob", n_tx_dev_mem_oob,
+                 "TX packets which didn't fit the device memory"),
+    RING_GAUGE("tx_dev_mem_allocated_bytes", n_tx_dev_mem_allocated, "Device memory allocated"),
+    RING_COUNTER("bond_failovers", n_bond_failovers, "Restarts of the bond of the ring"),
+    RING_GAUGE("bond_failover_usec", n_bond_failover_usec, "Duration of the last bond restart"),
+    RING_GAUGE("numa_node", n_numa_node, "NUMA node of the ring device, -1 if unknown"),
+    RING_COUNTER("numa_cross_allocs", n_numa_cross_allocs,
+                 "Buffer allocations requested from a CPU of another node"),
+    RING_GAUGE("queue_page_size_bytes", n_queue_page_size,
+               "Page size of the CQ/QP buffers, 0 if allocated by rdma-core"),
+    RING_COUNTER("tcp_rto", tcp_loss.n_rto, "TCP retransmission timeouts"),
+    RING_COUNTER("tcp_recoveries", tcp_loss.n_recovery, "TCP fast recoveries"),
+    RING_COUNTER("tcp_tail_loss_probes", tcp_loss.n_tlp, "TCP tail loss probes"),
+    RING_COUNTER("tcp_spurious_retransmits", tcp_loss.n_spurious_rexmit,
+                  "TCP retransmissions delivered by the original transmission"),
+    RING_COUNTER("tcp_zero_windows", tcp_loss.n_zero_wnd, "TCP windows closed by the remote host"),
+    RING_COUNTER("tcp_rwnd_limited_usec", tcp_loss.rwnd_limited_usec,
+                  "TCP sender time limited by the remote window"),
+    RING_COUNTER("tcp_cwnd_limited_usec", tcp_loss.cwnd_limited_usec,
+                  "TCP sender time limited by the congestion window"),
+    RING_COUNTER("tcp_sndbuf_limited_usec", tcp_loss.sndbuf_limited_usec,
+                  "TCP sender time limited by the send buffer"),
+    RING_COUNTER("tcp_app_limited_usec", tcp_loss.app_limited_usec,
+                  "TCP sender time limited by the application"),
+};
+
+#define CQ_COUNTER(name, field, help) METRIC(cq_stats_t, name, e_counter, field, help)
+#define CQ_GAUGE(name, field, help)   METRIC(cq_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<cq_stats_t> cq_metrics[] = {
+    CQ_COUNTER("rx_packets", n_rx_packet_count, "RX packets"),
+    CQ_COUNTER("rx_strides", n_rx_stride_count, "RX strides"),
+    CQ_COUNTER("rx_consumed_wqes", n_rx_consumed_rwqe_count, "RX WQEs consumed"),
+    CQ_COUNTER("rx_hw_drops", n_rx_hw_pkt_drops, "RX packets dropped by the HW"),
+    CQ_COUNTER("rx_sw_drops", n_rx_sw_pkt_drops, "RX packets dropped by the software"),
+    CQ_COUNTER("rx_lro_packets", n_rx_lro_packets, "LRO RX packets"),
+    CQ_COUNTER("rx_lro_bytes", n_rx_lro_bytes, "LRO RX bytes"),
+    CQ_COUNTER("rx_gro_packets", n_rx_gro_packets, "GRO RX packets"),
+    CQ_COUNTER("rx_gro_bytes", n_rx_gro_bytes, "GRO RX bytes"),
+    CQ_COUNTER("rx_gro_frags", n_rx_gro_frags, "RX packets aggregated by GRO"),
+    CQ_COUNTER("rx_gro_held", n_rx_gro_held, "GRO aggregates kept open across RX polls"),
+    CQ_COUNTER("rx_cqe_zip_packets", n_rx_cqe_zip_packets, "RX packets of compressed CQEs"),
+    CQ_COUNTER("rx_cqe_zip_sessions", n_rx_cqe_zip_sessions, "RX CQE compression sessions"),
+    CQ_COUNTER("rx_cqe_errors", n_rx_cqe_error, "RX CQEs with an error"),
+    CQ_COUNTER("rx_empty_polls", n_rx_empty_polls, "RX polls which found no CQE"),
+    CQ_COUNTER("rx_poll_ticks", n_rx_poll_tsc,
+               "TSC ticks from the first CQE of an RX poll until the socket enqueue"),
+    CQ_COUNTER("rx_polls_1_cqe", n_rx_poll_cqes_hist[0], "RX polls which returned 1 CQE"),
+    CQ_COUNTER("rx_polls_2_3_cqes", n_rx_poll_cqes_hist[1], "RX polls which returned 2-3 CQEs"),
+    CQ_COUNTER("rx_polls_4_7_cqes", n_rx_poll_cqes_hist[2], "RX polls which returned 4-7 CQEs"),
+    CQ_COUNTER("rx_polls_8_15_cqes", n_rx_poll_cqes_hist[3], "RX polls which returned 8-15 CQEs"),
+    CQ_COUNTER("rx_polls_16_31_cqes", n_rx_poll_cqes_hist[4],
+               "RX polls which returned 16-31 CQEs"),
+    CQ_COUNTER("rx_polls_32_cqes", n_rx_poll_cqes_hist[5],
+               "RX polls which returned 32 CQEs or more"),
+    CQ_GAUGE("rx_sw_queue_len", n_rx_sw_queue_len, "RX packets in the software queue"),
+    CQ_GAUGE("rx_drained_at_once_max", n_rx_drained_at_once_max,
+             "Maximum of the RX packets drained at once"),
+    CQ_GAUGE("buffer_pool_len", n_buffer_pool_len, "Buffers in the CQ buffer pool"),
+    CQ_GAUGE("rx_stride_size_bytes", n_rx_stride_size, "Size of an RX stride"),
+    CQ_GAUGE("rx_strides_per_wqe", n_rx_strides_per_rwqe, "RX strides of a WQE"),
+    CQ_GAUGE("rx_strides_per_packet_max", n_rx_max_stirde_per_packet,
+             "Maximum of the strides of an RX packet"),
+};
+
+#define BPOOL_COUNTER(name, field, help) METRIC(bpool_stats_t, name, e_counter, field, help)
+#define BPOOL_GAUGE(name, field, help)   METRIC(bpool_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<bpool_stats_t> bpool_metrics[] = {
+    BPOOL_GAUGE("size", n_buffer_pool_size, "Free buffers of the pool"),
+    BPOOL_GAUGE("created", n_buffer_pool_created, "Buffers created by the pool"),
+    BPOOL_COUNTER("no_bufs", n_buffer_pool_no_bufs, "Requests which found no buffers"),
+    BPOOL_COUNTER("expands", n_buffer_pool_expands, "Expansions of the pool"),
+    BPOOL_COUNTER("cache_hits", n_buffer_pool_cache_hits, "Requests served by the cache"),
+    BPOOL_COUNTER("cache_misses", n_buffer_pool_cache_misses, "Requests which missed the cache"),
+};
+
+#define IOMUX_COUNTER(name, field, help) METRIC(iomux_func_stats_t, name, e_counter, field, help)
+#define IOMUX_GAUGE(name, field, help)   METRIC(iomux_func_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<iomux_func_stats_t> iomux_metrics[] = {
+    IOMUX_COUNTER("poll_hits", n_iomux_poll_hit, "Polls which found ready fds"),
+    IOMUX_COUNTER("poll_misses", n_iomux_poll_miss, "Polls which found no ready fds"),
+    IOMUX_COUNTER("timeouts", n_iomux_timeouts, "Calls which timed out"),
+    IOMUX_COUNTER("errors", n_iomux_errors, "Calls which failed"),
+    IOMUX_COUNTER("rx_ready", n_iomux_rx_ready, "Offloaded fds found ready"),
+    IOMUX_COUNTER("os_rx_ready", n_iomux_os_rx_ready, "OS fds found ready"),
+    IOMUX_COUNTER("rx_poll_skipped", n_iomux_rx_poll_skipped,
+                  "Ring polls skipped with nothing to process"),
+    IOMUX_GAUGE("polling_time_percent", n_iomux_polling_time, "Share of the time spent polling"),
+};
+
+#define GLOBAL_COUNTER(name, field, help) METRIC(global_stats_t, name, e_counter, field, help)
+#define GLOBAL_GAUGE(name, field, help)   METRIC(global_stats_t, name, e_gauge, field, help)
+
+static const metric_desc<global_stats_t> global_metrics[] = {
+    GLOBAL_GAUGE("tcp_seg_pool_size", n_tcp_seg_pool_size, "Free TCP segments"),
+    GLOBAL_COUNTER("tcp_seg_pool_no_segs", n_tcp_seg_pool_no_segs,
+                   "Requests which found no TCP segments"),
+    GLOBAL_GAUGE("pending_sockets", n_pending_sockets, "Sockets pending the destruction"),
+    GLOBAL_COUNTER("rx_pool_pressure_events", n_rx_pool_pressure_events,
+                   "RX buffer pool pressure events"),
+    GLOBAL_COUNTER("agent_msgs", n_agent_msgs, "State messages queued for the daemon"),
+    GLOBAL_COUNTER("agent_batches", n_agent_batches, "Datagrams sent to the daemon"),
+    GLOBAL_COUNTER("agent_send_deferred", n_agent_send_deferred,
+                   "Sends deferred while the daemon queue was full"),
+    GLOBAL_COUNTER("agent_msgs_dropped", n_agent_msgs_dropped,
+                   "State messages dropped on memory shortage"),
+    GLOBAL_GAUGE("agent_wait_queue", n_agent_wait_queue, "State messages waiting for the daemon"),
+    GLOBAL_COUNTER("tcp_sockets_destroyed", socket_tcp_destructor_counter.load(),
+                   "TCP sockets destroyed"),
+    GLOBAL_COUNTER("udp_sockets_destroyed", socket_udp_destructor_counter.load(),
+                   "UDP sockets destroyed"),
+};
+
+static std::string escape_label(const std::string &val)
+{
+    std::string rc;
+
+    for (char c : val) {
+        if (c == '\\' || c == '"') {
+            rc += '\\';
+        } else if (c == '\n') {
+            rc += "\\n";
+            continue;
+        }
+        rc += c;
+    }
+    return rc;
+}
+
+static std::string process_labels(const stats_exporter_process &proc)
+{
+    return "pid=\"" + std::to_string(proc.pid) + "\",app=\"" + escape_label(proc.app_name) + '"';
+}
+
+// The samples of a family must be contiguous, so the instances of all the processes are written
+// per metric
+template <typename T, size_t N>
+static void write_metrics(std::ostream &out, const char *prefix, const metric_desc<T> (&descs)[N],
+                          const metric_instances<T> &insts)
+{
+    for (const metric_desc<T> &desc : descs) {
+        out << "# TYPE xlio_" << prefix << '_' << desc.name << ' '
+            << (desc.type == e_counter ? "counter" : "gauge") << '\n';
+        out << "# HELP xlio_" << prefix << '_' << desc.name << ' ' << desc.help << '\n';
+        for (const auto &inst : insts) {
+            out << "xlio_" << prefix << '_' << desc.name << (desc.type == e_counter ? "_total" : "")
+                << '{' << inst.first << "} " << desc.get(*inst.second) << '\n';
+        }
+    }
+}
+
+void stats_exporter_write(std::ostream &out, const std::vector<stats_exporter_process> &procs)
+{
+    metric_instances<socket_stats_t> sockets;
+    metric_instances<ring_stats_t> rings;
+    metric_instances<cq_stats_t> cqs;
+    metric_instances<bpool_stats_t> bpools;
+    metric_instances<iomux_func_stats_t> iomuxes;
+    metric_instances<global_stats_t> globals;
+
+    out << "# TYPE xlio_info gauge\n# HELP xlio_info Version of the library of the process\n";
+    for (const stats_exporter_process &proc : procs) {
+        const sh_mem_t *p_sh_mem = proc.p_sh_mem;
+        std::string labels = process_labels(proc);
+
+        out << "xlio_info{" << labels << ",version=\"" << (int)p_sh_mem->ver_info.xlio_lib_maj
+            << '.' << (int)p_sh_mem->ver_info.xlio_lib_min << '.'
+            << (int)p_sh_mem->ver_info.xlio_lib_rev << '.' << (int)p_sh_mem->ver_info.xlio_lib_rel
+            << "\"} 1\n";
+
+        for (size_t i = 0; i < p_sh_mem->max_skt_inst_num; i++) {
+            const socket_instance_block_t &block = p_sh_mem->skt_inst_arr[i];
+            if (block.b_enabled && block.skt_stats.b_is_offloaded) {
+                const char *proto = block.skt_stats.socket_type == SOCK_STREAM ? "tcp" : "udp";
+                sockets.emplace_back(labels + ",fd=\"" + std::to_string(block.skt_stats.fd) +
+                                         "\",proto=\"" + proto + '"',
+                                     &block.skt_stats);
+            }
+        }
+        for (int i = 0; i < NUM_OF_SUPPORTED_RINGS; i++) {
+            if (p_sh_mem->ring_inst_arr[i].b_enabled) {
+                rings.emplace_back(labels + ",ring=\"" + std::to_string(i) + '"',
+                                   &p_sh_mem->ring_inst_arr[i].ring_stats);
+            }
+        }
+        for (int i = 0; i < NUM_OF_SUPPORTED_CQS; i++) {
+            if (p_sh_mem->cq_inst_arr[i].b_enabled) {
+                cqs.emplace_back(labels + ",cq=\"" + std::to_string(i) + '"',
+                                 &p_sh_mem->cq_inst_arr[i].cq_stats);
+            }
+        }
+        for (int i = 0; i < NUM_OF_SUPPORTED_BPOOLS; i++) {
+            const bpool_stats_t &bpool = p_sh_mem->bpool_inst_arr[i].bpool_stats;
+            if (p_sh_mem->bpool_inst_arr[i].b_enabled) {
+                bpools.emplace_back(labels + ",bpool=\"" + std::to_string(i) + "\",type=\"" +
+                                        (bpool.is_rx ? "rx" : (bpool.is_tx ? "tx" : "other")) + '"',
+                                    &bpool);
+            }
+        }
+        iomuxes.emplace_back(labels + ",func=\"poll\"", &p_sh_mem->iomux.poll);
+        iomuxes.emplace_back(labels + ",func=\"select\"", &p_sh_mem->iomux.select);
+        for (int i = 0; i < NUM_OF_SUPPORTED_EPFDS; i++) {
+            const epoll_stats_t &epoll = p_sh_mem->iomux.epoll[i];
+            if (epoll.enabled) {
+                iomuxes.emplace_back(
+                    labels + ",func=\"epoll\",epfd=\"" + std::to_string(epoll.epfd) + '"',
+                    &epoll.stats);
+            }
+        }
+        for (int i = 0; i < NUM_OF_SUPPORTED_GLOBALS; i++) {
+            if (p_sh_mem->global_inst_arr[i].b_enabled) {
+                globals.emplace_back(labels, &p_sh_mem->global_inst_arr[i].global_stats);
+            }
+        }
+    }
+
+    write_metrics(out, "socket", socket_metrics, sockets);
+    write_metrics(out, "ring", ring_metrics, rings);
+    write_metrics(out, "cq", cq_metrics, cqs);
+    write_metrics(out, "bpool", bpool_metrics, bpools);
+    write_metrics(out, "iomux", iomux_metrics, iomuxes);
+    write_metrics(out, "global", global_metrics, globals);
+    out << "# EOF\n";
+}
+
+static int exporter_listen(const std::string &listen_addr)
+{
+    std::string host;
+    std::string port = listen_addr;
+    size_t pos = listen_addr.rfind(':');
+
+    if (pos != std::string::npos) {
+        host = listen_addr.substr(0, pos);
+        port = listen_addr.substr(pos + 1);
+    }
+    // [::1]:9100
+    if (host.size() >= 2U && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2U);
+    }
+
+    struct addrinfo hints;
+    struct addrinfo *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    int rc = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res);
+    if (rc) {
+        log_err("Invalid exporter address %s: %s", listen_addr.c_str(), gai_strerror(rc));
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai && fd < 0; ai = ai->ai_next) {
+        int opt = 1;
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) ||
+            bind(fd, ai->ai_addr, ai->ai_addrlen) || listen(fd, EXPORTER_BACKLOG)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        log_err("Unable to listen on %s (errno=%d %s)", listen_addr.c_str(), errno,
+                strerror(errno));
+    }
+    return fd;
+}
+
+static void exporter_send(int fd, const std::string &data)
+{
+    size_t sent = 0;
+
+    while (sent < data.size()) {
+        ssize_t rc = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return;
+        }
+        sent += rc;
+    }
+}
+
+static void exporter_reply(int fd, const char *status, const char *content_type,
+                           const std::string &body)
+{
+    std::ostringstream reply;
+
+    reply << "HTTP/1.1 " << status << "\r\nContent-Type: " << content_type
+          << "\r\nContent-Length: " << body.size() << "\r\nConnection: close\r\n\r\n"
+          << body;
+    exporter_send(fd, reply.str());
+}
+
+static void exporter_serve_client(int fd, const std::function<void()> &refresh,
+                                  const std::function<void(std::ostream &)> &collect)
+{
+    struct timeval tv = {EXPORTER_CLIENT_TIMEOUT, 0};
+    std::string request;
+    char buf[1024];
+
+    // A stalled client holds the exporter up to the timeout only
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    while (request.find("\r\n\r\n") == std::string::npos) {
+        ssize_t rc = recv(fd, buf, sizeof(buf), 0);
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0 || request.size() + rc > EXPORTER_REQUEST_MAX) {
+            return;
+        }
+        request.append(buf, rc);
+    }
+
+    std::istringstream line(request.substr(0, request.find("\r\n")));
+    std::string method, path;
+    line >> method >> path;
+    path = path.substr(0, path.find('?'));
+    if (method != "GET" && method != "HEAD") {
+        exporter_reply(fd, "405 Method Not Allowed", "text/plain", "Method not allowed\n");
+    } else if (path != "/metrics") {
+        exporter_reply(fd, "404 Not Found", "text/plain", "Scrape /metrics\n");
+    } else {
+        std::ostringstream body;
+        refresh();
+        collect(body);
+        exporter_reply(fd, "200 OK", STATS_EXPORTER_CONTENT_TYPE,
+                       method == "GET" ? body.str() : std::string());
+    }
+}
+
+int stats_exporter_serve(const std::string &listen_addr, const std::function<void()> &refresh,
+                         const std::function<void(std::ostream &)> &collect,
+                         const volatile bool *p_exit)
+{
+    std::chrono::steady_clock::time_point next_refresh;
+    int listen_fd = exporter_listen(listen_addr);
+
+    if (listen_fd < 0) {
+        return 1;
+    }
+
+    while (!*p_exit) {
+        // Keeps the publishers of the processes writing to the shared memory
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_refresh) {
+            refresh();
+            next_refresh = now + std::chrono::milliseconds(EXPORTER_REFRESH_MSEC);
+        }
+
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        int rc = poll(&pfd, 1, EXPORTER_REFRESH_MSEC);
+        if (rc < 0 && errno != EINTR) {
+            log_err("poll() failed (errno=%d %s)", errno, strerror(errno));
+            break;
+        }
+        if (rc <= 0) {
+            continue;
+        }
+
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            exporter_serve_client(fd, refresh, collect);
+            close(fd);
+        }
+    }
+
+    close(listen_fd);
+    return 0;
+}
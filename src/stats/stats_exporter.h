@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef STATS_EXPORTER_H
+#define STATS_EXPORTER_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/util/xlio_stats.h"
+
+#define STATS_EXPORTER_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+// Shared memory of a process to export, mapped by xlio_stats
+struct stats_exporter_process {
+    int pid;
+    std::string app_name;
+    const sh_mem_t *p_sh_mem;
+};
+
+/*
+ * Writes the counters of the processes in the OpenMetrics text format. Every sample has the pid
+ * and app labels and a label with the index of its ring, CQ, buffer pool, socket fd or epfd.
+ * The shared memory is read as is, the publisher may update it meanwhile.
+ */
+void stats_exporter_write(std::ostream &out, const std::vector<stats_exporter_process> &procs);
+
+/*
+ * Serves "GET /metrics" on listen_addr, given as [host:]port, until *p_exit is set.
+ * The refresh callback runs once in a second and before each scrape, collect writes the body.
+ * Returns 0 on exit and 1 if the address can't be listened on.
+ */
+int stats_exporter_serve(const std::string &listen_addr, const std::function<void()> &refresh,
+                         const std::function<void(std::ostream &)> &collect,
+                         const volatile bool *p_exit);
+
+#endif /* STATS_EXPORTER_H */
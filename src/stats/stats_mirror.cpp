@@ -0,0 +1,245 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <vector>
+#include "stats/stats_mirror.h"
+
+#define PCAPNG_BLOCK_SHB       0x0A0D0D0AU
+#define PCAPNG_BLOCK_IDB       0x00000001U
+#define PCAPNG_BLOCK_EPB       0x00000006U
+#define PCAPNG_BYTE_ORDER      0x1A2B3C4DU
+#define PCAPNG_LINKTYPE_ETH    1U
+#define PCAPNG_OPT_END         0U
+#define PCAPNG_OPT_IF_NAME     2U
+#define PCAPNG_OPT_IF_TSRESOL  9U
+#define PCAPNG_OPT_EPB_FLAGS   2U
+#define PCAPNG_EPB_INBOUND     0x1U
+#define PCAPNG_EPB_OUTBOUND    0x2U
+#define PCAPNG_TSRESOL_NSEC    9U
+
+static bool parse_number(const char *str, uint32_t max, uint32_t &value)
+{
+    char *end = nullptr;
+
+    errno = 0;
+    unsigned long num = strtoul(str, &end, 0);
+    if (errno || end == str || *end || num > max) {
+        return false;
+    }
+    value = static_cast<uint32_t>(num);
+    return true;
+}
+
+static bool parse_addr(const char *str, uint8_t *addr, uint8_t &family)
+{
+    uint8_t addr_family = strchr(str, ':') ? AF_INET6 : AF_INET;
+
+    if ((family && family != addr_family) || inet_pton(addr_family, str, addr) != 1) {
+        return false;
+    }
+    family = addr_family;
+    return true;
+}
+
+bool stats_mirror_parse_filter(const char *spec, pkt_mirror_filter_t &filter)
+{
+    std::string list(spec);
+    size_t pos = 0U;
+
+    memset(&filter, 0, sizeof(filter));
+    filter.sample_rate = 1U;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        std::string item = list.substr(pos, end == std::string::npos ? end : end - pos);
+        size_t sep = item.find('=');
+        pos = end == std::string::npos ? list.size() : end + 1U;
+
+        if (sep == std::string::npos) {
+            return false;
+        }
+        std::string key = item.substr(0, sep);
+        const char *value = item.c_str() + sep + 1U;
+        uint32_t num = 0U;
+
+        if (key == "proto") {
+            if (strcasecmp(value, "tcp") == 0) {
+                filter.protocol = IPPROTO_TCP;
+            } else if (strcasecmp(value, "udp") == 0) {
+                filter.protocol = IPPROTO_UDP;
+            } else {
+                return false;
+            }
+        } else if (key == "local_ip") {
+            if (!parse_addr(value, filter.local_addr, filter.family)) {
+                return false;
+            }
+        } else if (key == "remote_ip") {
+            if (!parse_addr(value, filter.remote_addr, filter.family)) {
+                return false;
+            }
+        } else if (key == "local_port" || key == "remote_port") {
+            if (!parse_number(value, UINT16_MAX, num) || !num) {
+                return false;
+            }
+            (key == "local_port" ? filter.local_port : filter.remote_port) =
+                htons(static_cast<uint16_t>(num));
+        } else if (key == "snap") {
+            if (!parse_number(value, PKT_MIRROR_SNAP_MAX, num) || !num) {
+                return false;
+            }
+            filter.snap_len = static_cast<uint16_t>(num);
+        } else if (key == "sample") {
+            if (!parse_number(value, UINT32_MAX, num) || !num) {
+                return false;
+            }
+            filter.sample_rate = num;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void put_u16(std::vector<uint8_t> &buf, uint16_t value)
+{
+    buf.insert(buf.end(), reinterpret_cast<uint8_t *>(&value),
+               reinterpret_cast<uint8_t *>(&value) + sizeof(value));
+}
+
+static void put_u32(std::vector<uint8_t> &buf, uint32_t value)
+{
+    buf.insert(buf.end(), reinterpret_cast<uint8_t *>(&value),
+               reinterpret_cast<uint8_t *>(&value) + sizeof(value));
+}
+
+// The data is padded to 32 bits
+static void put_data(std::vector<uint8_t> &buf, const void *data, size_t len)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+
+    buf.insert(buf.end(), p, p + len);
+    buf.resize(buf.size() + ((4U - len % 4U) % 4U), 0U);
+}
+
+static void put_option(std::vector<uint8_t> &buf, uint16_t code, const void *data, size_t len)
+{
+    put_u16(buf, code);
+    put_u16(buf, static_cast<uint16_t>(len));
+    put_data(buf, data, len);
+}
+
+bool stats_mirror_pcapng::write_block(uint32_t type, const void *body, size_t len)
+{
+    uint32_t total_len = static_cast<uint32_t>(len + 3U * sizeof(uint32_t));
+
+    return fwrite(&type, sizeof(type), 1, m_file) == 1 &&
+        fwrite(&total_len, sizeof(total_len), 1, m_file) == 1 &&
+        fwrite(body, len, 1, m_file) == 1 &&
+        fwrite(&total_len, sizeof(total_len), 1, m_file) == 1;
+}
+
+bool stats_mirror_pcapng::open(FILE *file)
+{
+    std::vector<uint8_t> body;
+    uint64_t section_len = UINT64_MAX; // Not specified
+
+    m_file = file;
+    m_if_ids.clear();
+    put_u32(body, PCAPNG_BYTE_ORDER);
+    put_u16(body, 1U); // Major version
+    put_u16(body, 0U);
+    put_data(body, &section_len, sizeof(section_len));
+    return write_block(PCAPNG_BLOCK_SHB, body.data(), body.size());
+}
+
+bool stats_mirror_pcapng::write_interface(uint32_t if_index)
+{
+    std::vector<uint8_t> body;
+    char if_name[IF_NAMESIZE] = {};
+    uint8_t tsresol = PCAPNG_TSRESOL_NSEC;
+
+    put_u16(body, PCAPNG_LINKTYPE_ETH);
+    put_u16(body, 0U);
+    put_u32(body, PKT_MIRROR_SNAP_MAX);
+    if (if_indextoname(if_index, if_name)) {
+        put_option(body, PCAPNG_OPT_IF_NAME, if_name, strlen(if_name));
+    }
+    put_option(body, PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol));
+    put_option(body, PCAPNG_OPT_END, nullptr, 0U);
+    if (!write_block(PCAPNG_BLOCK_IDB, body.data(), body.size())) {
+        return false;
+    }
+    uint32_t if_id = static_cast<uint32_t>(m_if_ids.size());
+    m_if_ids[if_index] = if_id;
+    return true;
+}
+
+bool stats_mirror_pcapng::write_packet(const pkt_mirror_slot_t &slot)
+{
+    std::vector<uint8_t> body;
+    uint32_t flags = slot.dir == PKT_MIRROR_DIR_RX ? PCAPNG_EPB_INBOUND : PCAPNG_EPB_OUTBOUND;
+    uint16_t cap_len = std::min<uint16_t>(slot.cap_len, PKT_MIRROR_SNAP_MAX);
+
+    if (m_if_ids.find(slot.if_index) == m_if_ids.end() && !write_interface(slot.if_index)) {
+        return false;
+    }
+    put_u32(body, m_if_ids[slot.if_index]);
+    put_u32(body, static_cast<uint32_t>(slot.ts_nsec >> 32U));
+    put_u32(body, static_cast<uint32_t>(slot.ts_nsec));
+    put_u32(body, cap_len);
+    put_u32(body, std::max<uint32_t>(slot.wire_len, cap_len));
+    put_data(body, slot.data, cap_len);
+    put_option(body, PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+    put_option(body, PCAPNG_OPT_END, nullptr, 0U);
+    return write_block(PCAPNG_BLOCK_EPB, body.data(), body.size());
+}
+
+stats_mirror_reader::stats_mirror_reader(const pkt_mirror_shm_t *shm)
+    : m_shm(shm)
+    , m_tail(__atomic_load_n(&shm->head, __ATOMIC_ACQUIRE))
+{
+}
+
+bool stats_mirror_reader::drain(stats_mirror_pcapng &out)
+{
+    uint64_t head = __atomic_load_n(&m_shm->head, __ATOMIC_ACQUIRE);
+    pkt_mirror_slot_t slot;
+
+    // The producers lapped the reader, the oldest slots are overwritten
+    if (head - m_tail > m_shm->num_slots) {
+        m_lost += head - m_shm->num_slots - m_tail;
+        m_tail = head - m_shm->num_slots;
+    }
+    while (m_tail != head) {
+        switch (pkt_mirror_read(m_shm, m_tail, &slot)) {
+        case PKT_MIRROR_READ_OK:
+            if (!out.write_packet(slot)) {
+                return false;
+            }
+            ++m_packets;
+            break;
+        case PKT_MIRROR_READ_LOST:
+            ++m_lost;
+            break;
+        case PKT_MIRROR_READ_PENDING:
+            if (m_pending_tail != m_tail) {
+                m_pending_tail = m_tail;
+                return true;
+            }
+            ++m_lost;
+            break;
+        }
+        ++m_tail;
+    }
+    return true;
+}
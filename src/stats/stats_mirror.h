@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef STATS_MIRROR_H
+#define STATS_MIRROR_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include "core/util/pkt_mirror.h"
+
+/*
+ * The capture mode of xlio_stats: a filter is set in the mirror ring of the process, see
+ * pkt_mirror.h, and the mirrored packets are written to a pcapng file which Wireshark and tcpdump
+ * read. The timestamps are in nanoseconds and the direction is in the epb_flags option.
+ */
+struct mirror_params_t {
+    bool enabled;
+    std::string file;
+    pkt_mirror_filter_t filter;
+};
+
+/*
+ * Parses a comma separated list of proto=tcp|udp, local_ip=, local_port=, remote_ip=,
+ * remote_port=, snap=<bytes> and sample=<n>, false if it isn't valid.
+ */
+bool stats_mirror_parse_filter(const char *spec, pkt_mirror_filter_t &filter);
+
+// A pcapng section with an interface block per interface index of the process
+class stats_mirror_pcapng {
+public:
+    // Writes the section header, false on a write error
+    bool open(FILE *file);
+    bool write_packet(const pkt_mirror_slot_t &slot);
+
+private:
+    bool write_block(uint32_t type, const void *body, size_t len);
+    bool write_interface(uint32_t if_index);
+
+    FILE *m_file = nullptr;
+    std::map<uint32_t, uint32_t> m_if_ids; // Interface index to the pcapng interface ID
+};
+
+// Follows the head of the ring from the moment of the construction
+class stats_mirror_reader {
+public:
+    explicit stats_mirror_reader(const pkt_mirror_shm_t *shm);
+
+    // Writes the published packets to out, false on a write error
+    bool drain(stats_mirror_pcapng &out);
+
+    uint64_t packets() const { return m_packets; }
+    // Overwritten before they were read, torn or never published by a producer
+    uint64_t lost() const { return m_lost; }
+
+private:
+    const pkt_mirror_shm_t *m_shm;
+    uint64_t m_tail;
+    // A slot which stays unpublished for a whole pass belongs to a dropped packet
+    uint64_t m_pending_tail = UINT64_MAX;
+    uint64_t m_packets = 0U;
+    uint64_t m_lost = 0U;
+};
+
+#endif /* STATS_MIRROR_H */
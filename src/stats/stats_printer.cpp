@@ -51,6 +51,68 @@ const char *to_str_socket_type_netstat_like(int type, sa_family_t family)
     return "???";
 }
 
+// Percentiles of a latency histogram, the upper bounds of the buckets in usec
+static bool print_lat_hist(const char *name, const lat_hist_t &hist, FILE *file)
+{
+    static const double percentiles[] = {50.0, 99.0, 99.9, 100.0};
+    double usec[sizeof(percentiles) / sizeof(percentiles[0])];
+    const double tsc_per_usec = static_cast<double>(get_tsc_rate_per_second()) / 1e6;
+    uint64_t samples = 0U;
+    uint64_t sum = 0U;
+    size_t pos = 0U;
+
+    for (uint32_t i = 0U; i < LAT_HIST_BUCKETS; ++i) {
+        samples += hist.buckets[i];
+    }
+    if (!samples) {
+        return false;
+    }
+    for (uint32_t i = 0U; i < LAT_HIST_BUCKETS && pos < sizeof(usec) / sizeof(usec[0]); ++i) {
+        sum += hist.buckets[i];
+        uint64_t bound = lat_hist_bucket_min(std::min(i + 1U, LAT_HIST_BUCKETS - 1U));
+        while (pos < sizeof(usec) / sizeof(usec[0]) &&
+               sum * 100.0 >= percentiles[pos] * samples) {
+            usec[pos++] = bound / tsc_per_usec;
+        }
+    }
+    fprintf(file,
+            "%s latency: %" PRIu64 " / %.1f / %.1f / %.1f / %.1f"
+            " [samples/p50/p99/p99.9/max usec]\n",
+            name, samples, usec[0], usec[1], usec[2], usec[3]);
+    return true;
+}
+
+bool print_lat_hists(const lat_hists_t *p_hists, FILE *file)
+{
+    bool b_any = print_lat_hist("Rx dwell", p_hists->rx_dwell, file);
+    b_any = print_lat_hist("Tx completion", p_hists->tx_complete, file) || b_any;
+    return print_lat_hist("ACK RTT", p_hists->ack_rtt, file) || b_any;
+}
+
+// Nothing is printed for a connection without losses which was never limited
+bool print_tcp_loss(const tcp_loss_stats_t *p_loss, FILE *file, const char *post_fix)
+{
+    bool b_any = false;
+
+    if (p_loss->n_rto || p_loss->n_recovery || p_loss->n_tlp || p_loss->n_spurious_rexmit ||
+        p_loss->n_zero_wnd) {
+        fprintf(file, "TCP Loss: %u / %u / %u / %u / %u [rto/recovery/tlp/spurious/zero-wnd]%s\n",
+                p_loss->n_rto, p_loss->n_recovery, p_loss->n_tlp, p_loss->n_spurious_rexmit,
+                p_loss->n_zero_wnd, post_fix);
+        b_any = true;
+    }
+    if (p_loss->rwnd_limited_usec || p_loss->cwnd_limited_usec || p_loss->sndbuf_limited_usec ||
+        p_loss->app_limited_usec) {
+        fprintf(file,
+                "TCP Limited: %" PRIu64 " / %" PRIu64 " / %" PRIu64 " / %" PRIu64
+                " [rwnd/cwnd/sndbuf/app usec]%s\n",
+                p_loss->rwnd_limited_usec, p_loss->cwnd_limited_usec,
+                p_loss->sndbuf_limited_usec, p_loss->app_limited_usec, post_fix);
+        b_any = true;
+    }
+    return b_any;
+}
+
 // Print statistics for offloaded sockets
 void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info, FILE *filename)
 {
@@ -166,6 +228,22 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
                         p_si_stats->counters.n_rx_data_pkts);
         }
     }
+    if (p_si_stats->counters.n_rx_compacted || p_si_stats->counters.n_rx_budget_limited) {
+        fprintf(filename, "Rx budget: %u / %u [compacted/limited]%s\n",
+                p_si_stats->counters.n_rx_compacted, p_si_stats->counters.n_rx_budget_limited,
+                post_fix);
+        b_any_activiy = true;
+    }
+    if (p_si_stats->counters.n_rx_placed) {
+        fprintf(filename, "Rx placed: %u [packets]%s\n", p_si_stats->counters.n_rx_placed,
+                post_fix);
+    }
+    if (p_si_stats->counters.n_rx_wnd_grows || p_si_stats->counters.n_rx_wnd_shrinks) {
+        fprintf(filename, "Rx window: %u / %u / %u [max/grows/shrinks]%s\n",
+                p_si_stats->counters.n_rx_wnd_max, p_si_stats->counters.n_rx_wnd_grows,
+                p_si_stats->counters.n_rx_wnd_shrinks, post_fix);
+        b_any_activiy = true;
+    }
     if (p_si_stats->counters.n_rx_os_bytes || p_si_stats->counters.n_rx_os_packets ||
         p_si_stats->counters.n_rx_os_eagain || p_si_stats->counters.n_rx_os_errors) {
         fprintf(filename,
@@ -209,6 +287,11 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
         fprintf(filename, "Retransmissions: %u\n", p_si_stats->counters.n_tx_retransmits);
     }
 
+    if (p_si_stats->counters.n_tx_sack_retransmits) {
+        fprintf(filename, "SACK retransmissions: %u\n",
+                p_si_stats->counters.n_tx_sack_retransmits);
+    }
+
     if (p_si_stats->counters.n_tx_sendfile_fallbacks) {
         fprintf(filename, "Sendfile: fallbacks %u / overflows %u\n",
                 p_si_stats->counters.n_tx_sendfile_fallbacks,
@@ -234,6 +317,10 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
                 p_si_stats->tls_counters.n_tls_tx_resync,
                 p_si_stats->tls_counters.n_tls_tx_resync_replay, post_fix);
     }
+    if (p_si_stats->tls_counters.n_tls_tx_key_updates) {
+        fprintf(filename, "TLS Tx Key updates: %u%s\n",
+                p_si_stats->tls_counters.n_tls_tx_key_updates, post_fix);
+    }
 
     if (p_si_stats->tls_counters.n_tls_rx_records || p_si_stats->tls_counters.n_tls_rx_bytes ||
         p_si_stats->tls_counters.n_tls_rx_records_sw_dec_fail) {
@@ -258,9 +345,17 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
     }
 #endif /* DEFINED_UTLS */
 
+    b_any_activiy = print_lat_hists(&p_si_stats->lat_hists, filename) || b_any_activiy;
+    b_any_activiy = print_tcp_loss(&p_si_stats->tcp_loss, filename, post_fix) || b_any_activiy;
+
     if (p_si_stats->tcp_state == LISTEN || p_si_stats->listen_counters.n_rx_syn) {
         fprintf(filename, "Listen Backlog: %u [current]\n",
                 p_si_stats->listen_counters.n_conn_backlog);
+        if (p_si_stats->listen_buckets) {
+            fprintf(filename, "Listen RSS child: %d / %u / %u [parent fd/worker/buckets]\n",
+                    p_si_stats->listen_parent_fd, p_si_stats->listen_child_index,
+                    p_si_stats->listen_buckets);
+        }
         fprintf(
             filename, "Listen Accepts: %u / %u / %u / %u [accepted/established/SYNs/reused]%s\n",
             p_si_stats->listen_counters.n_conn_accepted,
@@ -271,10 +366,16 @@ void print_full_stats(socket_stats_t *p_si_stats, mc_grp_info_t *p_mc_grp_info,
                     p_si_stats->listen_counters.n_conn_dropped,
                     p_si_stats->listen_counters.n_rx_fin, post_fix);
         }
+        if (p_si_stats->listen_counters.n_syncookies_sent != 0) {
+            fprintf(filename, "Listen SYN cookies: %u / %u [sent/validated]%s\n",
+                    p_si_stats->listen_counters.n_syncookies_sent,
+                    p_si_stats->listen_counters.n_syncookies_validated, post_fix);
+        }
         b_any_activiy = b_any_activiy || p_si_stats->listen_counters.n_conn_accepted ||
             p_si_stats->listen_counters.n_conn_established ||
             p_si_stats->listen_counters.n_rx_syn || p_si_stats->listen_counters.n_rx_syn_tw ||
-            p_si_stats->listen_counters.n_conn_dropped;
+            p_si_stats->listen_counters.n_conn_dropped ||
+            p_si_stats->listen_counters.n_syncookies_sent;
     }
 
     if (b_any_activiy == false) {
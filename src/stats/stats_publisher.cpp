@@ -10,7 +10,10 @@
 
 #include "stats/stats_data_reader.h"
 #include "core/util/xlio_stats.h"
+#include "core/util/lock_prof.h"
+#include "core/util/pkt_mirror.h"
 #include "core/sock/sock-redirect.h"
+#include "core/sock/fd_collection.h"
 #include "core/event/event_handler_manager.h"
 
 #define MODULE_NAME "STATS: "
@@ -21,12 +24,15 @@ static lock_spin g_lock_ring_inst_arr("g_lock_ring_inst_arr");
 static lock_spin g_lock_cq_inst_arr("g_lock_cq_inst_arr");
 static lock_spin g_lock_ent_ctx_arr("g_lock_ent_ctx_arr");
 static lock_spin g_lock_bpool_inst_arr("g_lock_bpool_inst_arr");
+static lock_spin g_lock_poll_group_inst_arr("g_lock_poll_group_inst_arr");
 static lock_spin g_lock_global_inst("g_lock_global_inst");
 static lock_spin g_lock_iomux("g_lock_iomux");
 
 static sh_mem_info_t g_sh_mem_info;
 static sh_mem_t *g_sh_mem;
 static sh_mem_t g_local_sh_mem;
+// Indexes of the free socket blocks, protected by g_lock_skt_inst_arr
+static std::vector<size_t> g_skt_free_blocks;
 
 // statistic file
 FILE *g_stats_file = NULL;
@@ -39,11 +45,21 @@ stats_data_reader *g_p_stats_data_reader = NULL;
 #define TIMERS_IN_STATS_PUBLISH_DURATION (STATS_PUBLISH_DURATION / STATS_PUBLISHER_TIMER_PERIOD)
 #define TIMERS_IN_STATS_PUBLISH_INTERVAL (STATS_PUBLISH_INTERVAL / STATS_PUBLISHER_TIMER_PERIOD)
 
+// A capture whose reader stopped draining the mirror ring is stopped after 1 sec
+#define TIMERS_IN_MIRROR_READER_TIMEOUT (1000 / STATS_PUBLISHER_TIMER_PERIOD)
+
+static char g_mirror_filename[PATH_MAX];
+static pkt_mirror_shm_t *g_mirror_shm = nullptr;
+static size_t g_mirror_size = 0U;
+static uint32_t g_mirror_reader_alive = 0U;
+static uint32_t g_mirror_idle_timers = 0U;
+
 bool printed_sock_limit_info = false;
 bool printed_ring_limit_info = false;
 bool printed_cq_limit_info = false;
 bool printed_ent_ctx_limit_info = false;
 bool printed_bpool_limit_info = false;
+bool printed_poll_group_limit_info = false;
 bool printed_global_limit_info = false;
 
 stats_data_reader::stats_data_reader()
@@ -79,10 +95,204 @@ bool should_write()
     return (timers_counter % TIMERS_IN_STATS_PUBLISH_INTERVAL == 0); // write once in interval
 }
 
+static int64_t tune_param_get(uint32_t param)
+{
+    const mce_sys_var &sys = safe_mce_sys();
+
+    switch (param) {
+    case TUNE_RX_POLL_NUM:
+        return sys.rx_poll_num;
+    case TUNE_SELECT_POLL_NUM:
+        return sys.select_poll_num;
+    case TUNE_CQ_MODERATION_COUNT:
+        return sys.cq_moderation_count;
+    case TUNE_CQ_MODERATION_PERIOD_USEC:
+        return sys.cq_moderation_period_usec;
+    case TUNE_CQ_AIM_MAX_COUNT:
+        return sys.cq_aim_max_count;
+    case TUNE_CQ_AIM_MAX_PERIOD_USEC:
+        return sys.cq_aim_max_period_usec;
+    case TUNE_CQ_AIM_INTERRUPTS_RATE_PER_SEC:
+        return sys.cq_aim_interrupts_rate_per_sec;
+    case TUNE_TCP_NODELAY:
+        return sys.tcp_nodelay;
+    case TUNE_TCP_QUICKACK:
+        return sys.tcp_quickack;
+    case TUNE_GRO_STREAMS_MAX:
+    default:
+        return sys.gro_streams_max;
+    }
+}
+
+// The limits of the startup checks in mce_sys_var
+static void tune_param_range(uint32_t param, int64_t &min, int64_t &max)
+{
+    const mce_sys_var &sys = safe_mce_sys();
+
+    min = 0;
+    max = UINT32_MAX;
+    switch (param) {
+    case TUNE_RX_POLL_NUM:
+    case TUNE_SELECT_POLL_NUM:
+        min = MCE_MIN_RX_NUM_POLLS;
+        max = MCE_MAX_RX_NUM_POLLS;
+        break;
+    case TUNE_CQ_MODERATION_COUNT:
+    case TUNE_CQ_AIM_MAX_COUNT:
+        max = (!sys.enable_striding_rq ? sys.rx_num_wr
+                                       : (sys.strq_stride_num_per_rwqe * sys.rx_num_wr)) /
+            2U;
+        break;
+    case TUNE_CQ_AIM_INTERRUPTS_RATE_PER_SEC:
+        min = 1; // A divisor of the adaptive moderation
+        break;
+    case TUNE_TCP_NODELAY:
+    case TUNE_TCP_QUICKACK:
+        max = 1;
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * The values are stored atomically, the readers of safe_mce_sys() pick them up at their next use:
+ * the polling loops at the next wait, the adaptive CQ moderation at its next tick, the TCP
+ * options and the GRO limit for the new sockets and flows.
+ */
+static void tune_param_set(uint32_t param, int64_t value)
+{
+    mce_sys_var &sys = safe_mce_sys();
+
+    switch (param) {
+    case TUNE_RX_POLL_NUM:
+        // Force at least one good polling loop, as at the startup
+        value = value ?: 1;
+        __atomic_store_n(&sys.rx_poll_num, (int32_t)value, __ATOMIC_RELAXED);
+        if (g_p_fd_collection) {
+            g_p_fd_collection->set_default_rx_poll_num((int32_t)value);
+        }
+        break;
+    case TUNE_SELECT_POLL_NUM:
+        __atomic_store_n(&sys.select_poll_num, (int32_t)value, __ATOMIC_RELAXED);
+        __atomic_store_n(&g_hot_sys_var.select_poll_num, (int32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_CQ_MODERATION_COUNT:
+        __atomic_store_n(&sys.cq_moderation_count, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_CQ_MODERATION_PERIOD_USEC:
+        __atomic_store_n(&sys.cq_moderation_period_usec, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_CQ_AIM_MAX_COUNT:
+        __atomic_store_n(&sys.cq_aim_max_count, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_CQ_AIM_MAX_PERIOD_USEC:
+        __atomic_store_n(&sys.cq_aim_max_period_usec, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_CQ_AIM_INTERRUPTS_RATE_PER_SEC:
+        __atomic_store_n(&sys.cq_aim_interrupts_rate_per_sec, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    case TUNE_TCP_NODELAY:
+        __atomic_store_n(&sys.tcp_nodelay, value != 0, __ATOMIC_RELAXED);
+        break;
+    case TUNE_TCP_QUICKACK:
+        __atomic_store_n(&sys.tcp_quickack, value != 0, __ATOMIC_RELAXED);
+        break;
+    case TUNE_GRO_STREAMS_MAX:
+        __atomic_store_n(&sys.gro_streams_max, (uint32_t)value, __ATOMIC_RELAXED);
+        break;
+    default:
+        break;
+    }
+}
+
+static void tune_values_update(tune_info_t &tune)
+{
+    for (uint32_t i = 0; i < TUNE_PARAM_NUM; ++i) {
+        tune.values[i] = tune_param_get(i);
+    }
+}
+
+static void handle_tune_request(tune_info_t &tune)
+{
+    uint32_t seq = __atomic_load_n(&tune.req_seq, __ATOMIC_ACQUIRE);
+    int64_t min, max;
+
+    if (likely(seq == tune.ack_seq)) {
+        return;
+    }
+
+    uint32_t param = tune.param;
+    int64_t value = tune.value;
+    if (param >= TUNE_PARAM_NUM) {
+        tune.status = -EINVAL;
+    } else {
+        tune_param_range(param, min, max);
+        if (value < min || value > max) {
+            vlog_printf(VLOG_WARNING,
+                        "Runtime tuning of %s to %" PRId64 " rejected, the range is %" PRId64
+                        "..%" PRId64 "\n",
+                        tune_param_name(param), value, min, max);
+            tune.status = -ERANGE;
+        } else {
+            int64_t prev = tune_param_get(param);
+            tune_param_set(param, value);
+            vlog_printf(VLOG_INFO, "Runtime tuning: %s %" PRId64 " -> %" PRId64 "\n",
+                        tune_param_name(param), prev, tune_param_get(param));
+            tune_values_update(tune);
+            ++tune.n_changes;
+            tune.status = 0;
+        }
+    }
+    __atomic_store_n(&tune.ack_seq, seq, __ATOMIC_RELEASE);
+}
+
+static void handle_mirror_request(pkt_mirror_shm_t *shm)
+{
+    pkt_mirror_ctl_t &ctl = shm->ctl;
+    uint32_t seq = __atomic_load_n(&ctl.req_seq, __ATOMIC_ACQUIRE);
+
+    if (seq != ctl.ack_seq) {
+        pkt_mirror_filter_t filter = ctl.filter;
+        if (filter.snap_len > PKT_MIRROR_SNAP_MAX ||
+            (filter.family && filter.family != AF_INET && filter.family != AF_INET6) ||
+            (filter.protocol && filter.protocol != IPPROTO_TCP &&
+             filter.protocol != IPPROTO_UDP)) {
+            ctl.status = -EINVAL;
+        } else {
+            vlog_printf(VLOG_INFO, "Packet mirroring %s\n",
+                        filter.sample_rate ? "started" : "stopped");
+            pkt_mirror_set_filter(shm, filter);
+            g_mirror_reader_alive = __atomic_load_n(&ctl.reader_alive, __ATOMIC_RELAXED);
+            g_mirror_idle_timers = 0U;
+            ctl.status = 0;
+        }
+        __atomic_store_n(&ctl.ack_seq, seq, __ATOMIC_RELEASE);
+        return;
+    }
+
+    if (!g_p_pkt_mirror) {
+        return;
+    }
+    uint32_t alive = __atomic_load_n(&ctl.reader_alive, __ATOMIC_RELAXED);
+    if (alive != g_mirror_reader_alive) {
+        g_mirror_reader_alive = alive;
+        g_mirror_idle_timers = 0U;
+    } else if (++g_mirror_idle_timers >= TIMERS_IN_MIRROR_READER_TIMEOUT) {
+        vlog_printf(VLOG_INFO, "Packet mirroring stopped, the reader is gone\n");
+        pkt_mirror_set_filter(shm, pkt_mirror_filter_t {});
+    }
+}
+
 void stats_data_reader::handle_timer_expired(void *ctx)
 {
     NOT_IN_USE(ctx);
 
+    handle_tune_request(g_sh_mem->tune);
+    if (g_mirror_shm) {
+        handle_mirror_request(g_mirror_shm);
+    }
+
     if (!should_write()) {
         return;
     }
@@ -102,6 +312,8 @@ void stats_data_reader::handle_timer_expired(void *ctx)
         memcpy(SHM_DATA_ADDRESS, LOCAL_OBJECT_DATA, COPY_SIZE);
     }
     m_lock_data_map.unlock();
+
+    lock_prof_publish(g_sh_mem->lock_inst_arr);
 }
 
 void stats_data_reader::register_to_timer()
@@ -138,12 +350,86 @@ void write_version_details_to_shmem(version_info_t *p_ver_info)
     p_ver_info->xlio_lib_rel = PRJ_LIBRARY_RELEASE;
 }
 
+// The mirror ring file next to the stats file, when monitor.stats.mirror_ring_slots is set
+static void xlio_shmem_mirror_open(const char *dir_path)
+{
+    uint32_t num_slots = safe_mce_sys().stats_mirror_ring_slots;
+    int fd, ret;
+    mode_t saved_mode;
+    void *p_shmem;
+
+    if (!num_slots) {
+        return;
+    }
+    num_slots = align32pow2(num_slots);
+    g_mirror_size = pkt_mirror_shm_size(num_slots);
+
+    ret = snprintf(g_mirror_filename, sizeof(g_mirror_filename), "%s/xliomirror.%d", dir_path,
+                   getpid());
+    if (!((0 < ret) && (ret < (int)sizeof(g_mirror_filename)))) {
+        vlog_printf(VLOG_ERROR, "%s: Could not create file under %s\n", __func__, dir_path);
+        return;
+    }
+    saved_mode = umask(0);
+    fd = open(g_mirror_filename, O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    umask(saved_mode);
+    if (fd < 0) {
+        vlog_printf(VLOG_ERROR, "%s: Could not open %s %s\n", __func__, g_mirror_filename,
+                    strerror(errno));
+        return;
+    }
+    // The slots are a hole until the capture writes them
+    if (ftruncate(fd, g_mirror_size) != 0) {
+        vlog_printf(VLOG_ERROR, "%s: Could not resize %s - %s\n", __func__, g_mirror_filename,
+                    strerror(errno));
+        close(fd);
+        unlink(g_mirror_filename);
+        return;
+    }
+    p_shmem = mmap(0, g_mirror_size, PROT_WRITE | PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p_shmem == MAP_FAILED) {
+        vlog_printf(VLOG_ERROR, "%s: MAP_FAILED for %s - %s\n", __func__, g_mirror_filename,
+                    strerror(errno));
+        unlink(g_mirror_filename);
+        return;
+    }
+
+    g_mirror_shm = static_cast<pkt_mirror_shm_t *>(p_shmem);
+    g_mirror_shm->version = PKT_MIRROR_FILE_VERSION;
+    g_mirror_shm->num_slots = num_slots;
+    g_mirror_shm->slot_size = sizeof(pkt_mirror_slot_t);
+    // The magic is the last, the reader checks it before the geometry
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(g_mirror_shm->magic, PKT_MIRROR_FILE_MAGIC, sizeof(g_mirror_shm->magic));
+    __log_dbg("mirror file '%s' with %u slots at %p", g_mirror_filename, num_slots,
+              g_mirror_shm);
+}
+
+static void xlio_shmem_mirror_close()
+{
+    if (!g_mirror_shm) {
+        return;
+    }
+    pkt_mirror_set_filter(g_mirror_shm, pkt_mirror_filter_t {});
+    if (munmap(g_mirror_shm, g_mirror_size) != 0) {
+        vlog_printf(VLOG_ERROR, "%s: error while unmap mirror ring at [%p]\n", __func__,
+                    g_mirror_shm);
+    }
+    g_mirror_shm = nullptr;
+    if (!g_is_forked_child) {
+        unlink(g_mirror_filename);
+    }
+}
+
 void xlio_shmem_stats_open(vlog_levels_t **p_p_xlio_log_level, uint8_t **p_p_xlio_log_details)
 {
     void *buf = NULL;
     void *p_shmem = NULL;
     int ret;
     size_t shmem_size = 0;
+    size_t skt_num_limit = safe_mce_sys().stats_fd_num_monitor;
+    size_t skt_num = std::min<size_t>(skt_num_limit, SHMEM_STATS_FD_NUM_INITIAL);
     mode_t saved_mode;
     const char *dir_path = safe_mce_sys().stats_shmem_dirname;
 
@@ -157,7 +443,7 @@ void xlio_shmem_stats_open(vlog_levels_t **p_p_xlio_log_level, uint8_t **p_p_xli
     }
     BULLSEYE_EXCLUDE_BLOCK_END
 
-    shmem_size = SHMEM_STATS_SIZE(safe_mce_sys().stats_fd_num_monitor);
+    shmem_size = SHMEM_STATS_SIZE(skt_num);
     buf = malloc(shmem_size);
     if (buf == NULL) {
         goto shmem_error;
@@ -207,8 +493,16 @@ void xlio_shmem_stats_open(vlog_levels_t **p_p_xlio_log_level, uint8_t **p_p_xli
     }
     BULLSEYE_EXCLUDE_BLOCK_END
 
-    g_sh_mem_info.p_sh_stats =
-        mmap(0, shmem_size, PROT_WRITE | PROT_READ, MAP_SHARED, g_sh_mem_info.fd_sh_stats, 0);
+    // The rest of the socket blocks is a hole until the sockets need it
+    if (ftruncate(g_sh_mem_info.fd_sh_stats, SHMEM_STATS_SIZE(skt_num_limit)) != 0) {
+        vlog_printf(VLOG_ERROR, "%s: Could not resize %s - %s\n", __func__,
+                    g_sh_mem_info.filename_sh_stats, strerror(errno));
+        goto no_shmem;
+    }
+
+    g_sh_mem_info.shmem_size = SHMEM_STATS_SIZE(skt_num_limit);
+    g_sh_mem_info.p_sh_stats = mmap(0, g_sh_mem_info.shmem_size, PROT_WRITE | PROT_READ,
+                                    MAP_SHARED, g_sh_mem_info.fd_sh_stats, 0);
 
     BULLSEYE_EXCLUDE_BLOCK_START
     if (g_sh_mem_info.p_sh_stats == MAP_FAILED) {
@@ -219,6 +513,7 @@ void xlio_shmem_stats_open(vlog_levels_t **p_p_xlio_log_level, uint8_t **p_p_xli
     BULLSEYE_EXCLUDE_BLOCK_END
 
     p_shmem = g_sh_mem_info.p_sh_stats;
+    xlio_shmem_mirror_open(dir_path);
 
     free(buf);
     /* coverity[assigned_pointer] */
@@ -235,6 +530,8 @@ no_shmem:
     }
 
     g_sh_mem_info.p_sh_stats = 0;
+    // The blocks of the local buffer can't grow
+    skt_num_limit = skt_num;
 
 success:
 
@@ -243,11 +540,15 @@ success:
     write_version_details_to_shmem(&g_sh_mem->ver_info);
     memcpy(g_sh_mem->stats_protocol_ver, STATS_PROTOCOL_VER,
            std::min(sizeof(g_sh_mem->stats_protocol_ver), sizeof(STATS_PROTOCOL_VER)));
-    g_sh_mem->max_skt_inst_num = safe_mce_sys().stats_fd_num_monitor;
+    g_sh_mem->max_skt_inst_num = skt_num;
+    g_sh_mem->max_skt_inst_limit = skt_num_limit;
+    for (size_t i = skt_num; i > 0; --i) {
+        g_skt_free_blocks.push_back(i - 1U);
+    }
     g_sh_mem->reader_counter = 0;
-    __log_dbg("file '%s' fd %d shared memory at %p with %d max blocks",
+    __log_dbg("file '%s' fd %d shared memory at %p with %zu blocks of %zu max blocks",
               g_sh_mem_info.filename_sh_stats, g_sh_mem_info.fd_sh_stats, g_sh_mem_info.p_sh_stats,
-              safe_mce_sys().stats_fd_num_monitor);
+              skt_num, skt_num_limit);
 
     // Update the shmem initial log values
     g_sh_mem->log_level = **p_p_xlio_log_level;
@@ -258,6 +559,9 @@ success:
     g_sh_mem->fd_dump = 0;
     g_sh_mem->fd_dump_log_level = STATS_FD_STATISTICS_LOG_LEVEL_DEFAULT;
 
+    memset(&g_sh_mem->tune, 0, sizeof(g_sh_mem->tune));
+    tune_values_update(g_sh_mem->tune);
+
     // ReMap internal log level to ShMem area
     *p_p_xlio_log_level = &g_sh_mem->log_level;
     *p_p_xlio_log_details = &g_sh_mem->log_details_level;
@@ -280,14 +584,14 @@ shmem_error:
 
 void xlio_shmem_stats_close()
 {
+    xlio_shmem_mirror_close();
     if (g_sh_mem_info.p_sh_stats && g_sh_mem_info.p_sh_stats != MAP_FAILED) {
         __log_dbg("file '%s' fd %d shared memory at %p with %d max blocks",
                   g_sh_mem_info.filename_sh_stats, g_sh_mem_info.fd_sh_stats,
                   g_sh_mem_info.p_sh_stats, safe_mce_sys().stats_fd_num_monitor);
 
         BULLSEYE_EXCLUDE_BLOCK_START
-        if (munmap(g_sh_mem_info.p_sh_stats,
-                   SHMEM_STATS_SIZE(safe_mce_sys().stats_fd_num_monitor)) != 0) {
+        if (munmap(g_sh_mem_info.p_sh_stats, g_sh_mem_info.shmem_size) != 0) {
             vlog_printf(VLOG_ERROR,
                         "%s: file [%s] fd [%d] error while unmap shared memory at [%p]\n", __func__,
                         g_sh_mem_info.filename_sh_stats, g_sh_mem_info.fd_sh_stats,
@@ -308,44 +612,60 @@ void xlio_shmem_stats_close()
         free(g_sh_mem);
     }
     g_sh_mem = NULL;
+    g_skt_free_blocks.clear();
     g_p_vlogger_level = NULL;
     g_p_vlogger_details = NULL;
     delete g_p_stats_data_reader;
     g_p_stats_data_reader = NULL;
 }
 
+// Allocates more socket blocks in the stats file, called with g_lock_skt_inst_arr taken
+static bool grow_socket_blocks()
+{
+    size_t num = g_sh_mem->max_skt_inst_num;
+    size_t new_num = std::min(num * 2U, g_sh_mem->max_skt_inst_limit);
+
+    if (new_num <= num) {
+        return false;
+    }
+
+    int rc = posix_fallocate(g_sh_mem_info.fd_sh_stats, SHMEM_STATS_SIZE(num),
+                             SHMEM_STATS_SIZE(new_num) - SHMEM_STATS_SIZE(num));
+    if (rc != 0) {
+        vlog_printf(VLOG_WARNING, "%s: Could not extend %s to %zu sockets - %s\n", __func__,
+                    g_sh_mem_info.filename_sh_stats, new_num, strerror(rc));
+        g_sh_mem->max_skt_inst_limit = num;
+        return false;
+    }
+
+    for (size_t i = new_num; i > num; --i) {
+        g_skt_free_blocks.push_back(i - 1U);
+    }
+    // The new blocks are zero, the readers may scan them once the number is updated
+    __atomic_store_n(&g_sh_mem->max_skt_inst_num, new_num, __ATOMIC_RELEASE);
+    __log_dbg("file '%s' grown to %zu blocks", g_sh_mem_info.filename_sh_stats, new_num);
+    return true;
+}
+
 void xlio_stats_instance_create_socket_block(socket_stats_t *local_stats_addr)
 {
     socket_stats_t *p_skt_stats = NULL;
     g_lock_skt_inst_arr.lock();
 
-    // search the first free sh_mem block
-    for (uint32_t i = 0; i < g_sh_mem->max_skt_inst_num; i++) {
-        if (g_sh_mem->skt_inst_arr[i].b_enabled == false) {
-            // found free slot ,enabled and returning to the user
-            p_skt_stats = &g_sh_mem->skt_inst_arr[i].skt_stats;
-            g_sh_mem->skt_inst_arr[i].b_enabled = true;
-            goto out;
-        }
-    }
-    if (g_sh_mem->max_skt_inst_num + 1 < safe_mce_sys().stats_fd_num_monitor) {
-        // allocate next sh_mem block
-        p_skt_stats = &g_sh_mem->skt_inst_arr[g_sh_mem->max_skt_inst_num].skt_stats;
-        g_sh_mem->skt_inst_arr[g_sh_mem->max_skt_inst_num].b_enabled = true;
-        g_sh_mem->max_skt_inst_num++;
-        goto out;
-    } else {
-        if (!printed_sock_limit_info) {
-            printed_sock_limit_info = true;
-            if (safe_mce_sys().stats_fd_num_monitor < MAX_STATS_FD_NUM) {
-                vlog_printf(VLOG_INFO, "Statistics can monitor up to %d sockets - increase %s\n",
-                            safe_mce_sys().stats_fd_num_monitor, SYS_VAR_STATS_FD_NUM);
-            }
+    if (!g_skt_free_blocks.empty() || grow_socket_blocks()) {
+        size_t i = g_skt_free_blocks.back();
+
+        g_skt_free_blocks.pop_back();
+        p_skt_stats = &g_sh_mem->skt_inst_arr[i].skt_stats;
+        g_sh_mem->skt_inst_arr[i].b_enabled = true;
+    } else if (!printed_sock_limit_info) {
+        printed_sock_limit_info = true;
+        if (safe_mce_sys().stats_fd_num_monitor < MAX_STATS_FD_NUM) {
+            vlog_printf(VLOG_INFO, "Statistics can monitor up to %d sockets - increase %s\n",
+                        safe_mce_sys().stats_fd_num_monitor, SYS_VAR_STATS_FD_NUM);
         }
-        goto out;
     }
 
-out:
     if (p_skt_stats) {
         p_skt_stats->reset();
         g_p_stats_data_reader->add_data_reader(local_stats_addr, p_skt_stats,
@@ -378,13 +698,15 @@ void xlio_stats_instance_remove_socket_block(socket_stats_t *local_addr)
     }
     BULLSEYE_EXCLUDE_BLOCK_END*/
 
-    // Search sh_mem block to release
-    for (uint32_t i = 0; i < g_sh_mem->max_skt_inst_num; i++) {
-        if (&g_sh_mem->skt_inst_arr[i].skt_stats == p_skt_stats) {
-            g_sh_mem->skt_inst_arr[i].b_enabled = false;
-            g_lock_skt_inst_arr.unlock();
-            return;
-        }
+    // The block index follows from the offset of the stats in the array
+    uint8_t *p_first = reinterpret_cast<uint8_t *>(&g_sh_mem->skt_inst_arr[0].skt_stats);
+    size_t i = static_cast<size_t>(reinterpret_cast<uint8_t *>(p_skt_stats) - p_first) /
+        sizeof(socket_instance_block_t);
+    if (i < g_sh_mem->max_skt_inst_num && &g_sh_mem->skt_inst_arr[i].skt_stats == p_skt_stats) {
+        g_sh_mem->skt_inst_arr[i].b_enabled = false;
+        g_skt_free_blocks.push_back(i);
+        g_lock_skt_inst_arr.unlock();
+        return;
     }
 
     vlog_printf(VLOG_ERROR, "%s:%d: Could not find user pointer (%p)\n", __func__, __LINE__,
@@ -415,6 +737,8 @@ void xlio_stats_mc_group_add(const ip_address &mc_grp, socket_stats_t *p_socket_
 
     if (index_to_insert == -1 && empty_entry != -1) {
         index_to_insert = empty_entry;
+        g_sh_mem->mc_info.mc_grp_tbl[index_to_insert].mc_grp =
+            ip_addr(mc_grp, p_socket_stats->sa_family);
     } else if (index_to_insert == -1 && g_sh_mem->mc_info.max_grp_num < MC_TABLE_SIZE) {
         index_to_insert = g_sh_mem->mc_info.max_grp_num;
         g_sh_mem->mc_info.mc_grp_tbl[index_to_insert].mc_grp =
@@ -428,7 +752,12 @@ void xlio_stats_mc_group_add(const ip_address &mc_grp, socket_stats_t *p_socket_
     }
     g_lock_mc_info.unlock();
     if (index_to_insert == -1) {
-        vlog_printf(VLOG_INFO, "Statistics can monitor up to %d mc groups\n", MC_TABLE_SIZE);
+        // Once per process, applications may join thousands of groups
+        static bool s_table_full_logged = false;
+        if (!s_table_full_logged) {
+            s_table_full_logged = true;
+            vlog_printf(VLOG_INFO, "Statistics can monitor up to %d mc groups\n", MC_TABLE_SIZE);
+        }
     }
 }
 
@@ -445,11 +774,13 @@ void xlio_stats_mc_group_remove(const ip_address &mc_grp, socket_stats_t *p_sock
                 ip_addr(mc_grp, p_socket_stats->sa_family)) {
             p_socket_stats->mc_grp_map.set((size_t)grp_idx, 0);
             g_sh_mem->mc_info.mc_grp_tbl[grp_idx].sock_num--;
-            if (!g_sh_mem->mc_info.mc_grp_tbl[grp_idx].sock_num) {
-                g_sh_mem->mc_info.max_grp_num--;
-            }
         }
     }
+    // Only the empty tail is dropped, the entries in use keep their index
+    while (g_sh_mem->mc_info.max_grp_num &&
+           !g_sh_mem->mc_info.mc_grp_tbl[g_sh_mem->mc_info.max_grp_num - 1].sock_num) {
+        g_sh_mem->mc_info.max_grp_num--;
+    }
     g_lock_mc_info.unlock();
 }
 
@@ -631,6 +962,60 @@ void xlio_stats_instance_remove_ent_ctx_block(entity_context_stats_t *local_stat
     g_lock_ent_ctx_arr.unlock();
 }
 
+void xlio_stats_instance_create_poll_group_block(poll_group_stats_t *local_stats_addr)
+{
+    poll_group_stats_t *p_instance_poll_group = NULL;
+    g_lock_poll_group_inst_arr.lock();
+    for (int i = 0; i < NUM_OF_SUPPORTED_POLL_GROUPS; i++) {
+        if (!g_sh_mem->poll_group_inst_arr[i].b_enabled) {
+            g_sh_mem->poll_group_inst_arr[i].b_enabled = true;
+            p_instance_poll_group = &g_sh_mem->poll_group_inst_arr[i].poll_group_stats;
+            memset(p_instance_poll_group, 0, sizeof(*p_instance_poll_group));
+            break;
+        }
+    }
+    if (p_instance_poll_group == NULL) {
+        if (!printed_poll_group_limit_info) {
+            printed_poll_group_limit_info = true;
+            vlog_printf(VLOG_INFO, "Statistics can monitor up to %d poll group elements\n",
+                        NUM_OF_SUPPORTED_POLL_GROUPS);
+        }
+    } else {
+        g_p_stats_data_reader->add_data_reader(local_stats_addr, p_instance_poll_group,
+                                               sizeof(poll_group_stats_t));
+        __log_dbg("Added poll_group local=%p shm=%p", local_stats_addr, p_instance_poll_group);
+    }
+    g_lock_poll_group_inst_arr.unlock();
+}
+
+void xlio_stats_instance_remove_poll_group_block(poll_group_stats_t *local_stats_addr)
+{
+    g_lock_poll_group_inst_arr.lock();
+    __log_dbg("Remove poll_group local=%p", local_stats_addr);
+
+    poll_group_stats_t *p_poll_group_stats =
+        (poll_group_stats_t *)g_p_stats_data_reader->pop_data_reader(local_stats_addr);
+
+    if (p_poll_group_stats == NULL) {
+        __log_dbg("application xlio_stats pointer is NULL");
+        g_lock_poll_group_inst_arr.unlock();
+        return;
+    }
+
+    // Search sh_mem block to release
+    for (int i = 0; i < NUM_OF_SUPPORTED_POLL_GROUPS; i++) {
+        if (&g_sh_mem->poll_group_inst_arr[i].poll_group_stats == p_poll_group_stats) {
+            g_sh_mem->poll_group_inst_arr[i].b_enabled = false;
+            g_lock_poll_group_inst_arr.unlock();
+            return;
+        }
+    }
+
+    vlog_printf(VLOG_ERROR, "%s:%d: Could not find user pointer (%p)\n", __func__, __LINE__,
+                p_poll_group_stats);
+    g_lock_poll_group_inst_arr.unlock();
+}
+
 void xlio_stats_instance_create_bpool_block(bpool_stats_t *local_stats_addr)
 {
     bpool_stats_t *p_instance_bpool = NULL;
@@ -18,6 +18,7 @@
 #include <errno.h>
 #include <dirent.h>
 #include <string.h>
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
 #include <vector>
@@ -30,6 +31,8 @@
 #include <cinttypes>
 #include <iostream>
 #include <list>
+#include <map>
+#include <set>
 #include <vector>
 #include <unordered_map>
 
@@ -38,6 +41,9 @@
 #include "core/util/xlio_stats.h"
 #include "core/util/sys_vars.h"
 #include "stats/stats_data_reader.h"
+#include "stats/stats_exporter.h"
+#include "stats/stats_snapshot.h"
+#include "stats/stats_mirror.h"
 #include <sstream>
 
 using namespace std;
@@ -86,6 +92,7 @@ typedef enum { e_K = 1024, e_M = 1048576 } units_t;
 #define FORMAT_RING_STRIDES    "%-20s %zu / %zu / %zu [total/max-per-packet/packets-per-rwqe] %-3s\n"
 #define FORMAT_RING_INTERRUPT  "%-20s %zu / %zu [requests/received] %-3s\n"
 #define FORMAT_RING_MODERATION "%-20s %u / %u [frames/usec period] %-3s\n"
+#define FORMAT_RING_AIM_INPUT  "%-20s %u / %u / %u [usec gap/frames burst/frames in target] %-3s\n"
 #define FORMAT_RING_DM_STATS   "%-20s %zu / %zu / %zu [kilobytes/packets/oob] %-3s\n"
 #define FORMAT_RING_MASTER     "%-20s %p\n"
 #define FORMAT_RING_RX_TLS     "%-20s %u / %u / %u [contexts/resyncs/auth-fail] %-3s\n"
@@ -97,7 +104,7 @@ typedef enum { e_K = 1024, e_M = 1048576 } units_t;
 #define SCREEN_SIZE             24
 #define MAX_BUFF_SIZE           256
 #define PRINT_DETAILS_MODES_NUM 2
-#define VIEW_MODES_NUM          6
+#define VIEW_MODES_NUM          9
 #define DEFAULT_DELAY_SEC       1
 #define DEFAULT_CYCLES          0
 #define DEFAULT_VIEW_MODE       e_basic
@@ -115,6 +122,17 @@ bool g_b_exit = false;
 struct sigaction g_sigact;
 uint8_t *g_fd_mask;
 uint32_t g_fd_map_size = e_K;
+snapshot_params_t g_snapshot_params = {false, 10U, SNAPSHOT_SORT_RX_PPS, SNAPSHOT_FORMAT_CSV, {}};
+
+// --tune, param is TUNE_PARAM_NUM to only list the values
+struct tune_params_t {
+    bool enabled;
+    uint32_t param;
+    int64_t value;
+    uint32_t seq;
+};
+tune_params_t g_tune_params = {false, TUNE_PARAM_NUM, 0, 0U};
+mirror_params_t g_mirror_params = {false, {}, {}};
 
 // statistic file
 FILE *g_stats_file = stdout;
@@ -143,10 +161,11 @@ void usage(const char *argv0)
     printf("  -i, --interval=<n>\t\tPrint report every <n> seconds\n");
     printf("  -c, --cycles=<n>\t\tDo <n> report print cycles and exit, use 0 value for infinite "
            "(default)\n");
-    printf("  -v, --view=<1|2|3|4|5|6>\tSet view type:\n" INFO_TABS "1 - Basic info\n" INFO_TABS
-           "2 - Extra info\n" INFO_TABS "3 - Full info\n" INFO_TABS
+    printf("  -v, --view=<1|2|3|4|5|6|7|8|9>\tSet view type:\n" INFO_TABS
+           "1 - Basic info\n" INFO_TABS "2 - Extra info\n" INFO_TABS "3 - Full info\n" INFO_TABS
            "4 - Multicast groups\n" INFO_TABS "5 - Show as 'netstat -tunaep'\n" INFO_TABS
-           "6 - Entity Context info\n");
+           "6 - Entity Context info\n" INFO_TABS "7 - Poll Group info\n" INFO_TABS
+           "8 - Ring and CQ poll efficiency\n" INFO_TABS "9 - Lock contention\n");
     printf("  -d, --details=<1|2>\t\tSet details mode:\n" INFO_TABS "1 - Totals\n" INFO_TABS
            "2 - Deltas\n");
     printf("  -z, --zero\t\t\tZero counters\n");
@@ -160,10 +179,62 @@ void usage(const char *argv0)
     printf("  -s, --sockets=<list|range>\tLog only sockets that match <list> or <range>, format: "
            "4-16 or 1,9 (or combination)\n");
     printf("  -C, --csv_file=<file path>\tA path to the statics CSV file\n");
+    printf("  -e, --exporter=<[host:]port>\tServe the counters of all the " PRODUCT_NAME
+           " processes as OpenMetrics on http://<host:port>/metrics\n");
+    printf("  --top=<n>\t\t\tSampling mode: copy the shared memory once per interval and "
+           "print the <n> busiest sockets (default 10)\n");
+    printf("  --sort=<rx_pps|drops|retrans>\tSampling mode: sort the sockets by the RX packets, "
+           "drops or retransmits\n");
+    printf("  --snapshot_file=<file path>\tSampling mode: write the socket deltas of every "
+           "interval to <file path>\n");
+    printf("  --snapshot_format=<csv|bin>\tThe format of the snapshot file (default csv), the "
+           "layout of bin is in stats_snapshot.h\n");
+    printf("  --tune=<name>[=<value>]\tSet a parameter of the running process, 'list' prints "
+           "the current values. The parameters:\n");
+    for (uint32_t i = 0; i < TUNE_PARAM_NUM; ++i) {
+        printf(INFO_TABS "%s\n", tune_param_name(i));
+    }
+    printf("  --mirror=<file path>\t\tCapture the offloaded packets of the process to a pcapng "
+           "file, needs " SYS_VAR_STATS_MIRROR_RING_SLOTS "\n");
+    printf("  --mirror_filter=<filter>\tThe packets to capture, a comma separated list of "
+           "proto=<tcp|udp>, local_ip=, local_port=,\n" INFO_TABS
+           "remote_ip=, remote_port=, snap=<bytes> and sample=<n>, every n-th packet\n");
     printf("  -V, --version\t\t\tPrint version\n");
     printf("  -h, --help\t\t\tPrint this help message\n");
 }
 
+// The histograms of the interval, the samples aren't divided by the interval
+void update_delta_lat_hists(const lat_hists_t *p_curr_hists, lat_hists_t *p_prev_hists)
+{
+    for (uint32_t i = 0U; i < LAT_HIST_BUCKETS; ++i) {
+        p_prev_hists->rx_dwell.buckets[i] =
+            p_curr_hists->rx_dwell.buckets[i] - p_prev_hists->rx_dwell.buckets[i];
+        p_prev_hists->tx_complete.buckets[i] =
+            p_curr_hists->tx_complete.buckets[i] - p_prev_hists->tx_complete.buckets[i];
+        p_prev_hists->ack_rtt.buckets[i] =
+            p_curr_hists->ack_rtt.buckets[i] - p_prev_hists->ack_rtt.buckets[i];
+    }
+}
+
+void update_delta_tcp_loss(const tcp_loss_stats_t *p_curr_loss, tcp_loss_stats_t *p_prev_loss)
+{
+    int delay = user_params.interval;
+    p_prev_loss->n_rto = (p_curr_loss->n_rto - p_prev_loss->n_rto) / delay;
+    p_prev_loss->n_recovery = (p_curr_loss->n_recovery - p_prev_loss->n_recovery) / delay;
+    p_prev_loss->n_tlp = (p_curr_loss->n_tlp - p_prev_loss->n_tlp) / delay;
+    p_prev_loss->n_spurious_rexmit =
+        (p_curr_loss->n_spurious_rexmit - p_prev_loss->n_spurious_rexmit) / delay;
+    p_prev_loss->n_zero_wnd = (p_curr_loss->n_zero_wnd - p_prev_loss->n_zero_wnd) / delay;
+    p_prev_loss->rwnd_limited_usec =
+        (p_curr_loss->rwnd_limited_usec - p_prev_loss->rwnd_limited_usec) / delay;
+    p_prev_loss->cwnd_limited_usec =
+        (p_curr_loss->cwnd_limited_usec - p_prev_loss->cwnd_limited_usec) / delay;
+    p_prev_loss->sndbuf_limited_usec =
+        (p_curr_loss->sndbuf_limited_usec - p_prev_loss->sndbuf_limited_usec) / delay;
+    p_prev_loss->app_limited_usec =
+        (p_curr_loss->app_limited_usec - p_prev_loss->app_limited_usec) / delay;
+}
+
 void update_delta_stat(socket_stats_t *p_curr_stat, socket_stats_t *p_prev_stat)
 {
     int delay = user_params.interval;
@@ -195,6 +266,18 @@ void update_delta_stat(socket_stats_t *p_curr_stat, socket_stats_t *p_prev_stat)
         (p_curr_stat->counters.n_rx_data_pkts - p_prev_stat->counters.n_rx_data_pkts) / delay;
     p_prev_stat->counters.n_rx_frags =
         (p_curr_stat->counters.n_rx_frags - p_prev_stat->counters.n_rx_frags) / delay;
+    p_prev_stat->counters.n_rx_compacted =
+        (p_curr_stat->counters.n_rx_compacted - p_prev_stat->counters.n_rx_compacted) / delay;
+    p_prev_stat->counters.n_rx_budget_limited =
+        (p_curr_stat->counters.n_rx_budget_limited - p_prev_stat->counters.n_rx_budget_limited) /
+        delay;
+    p_prev_stat->counters.n_rx_placed =
+        (p_curr_stat->counters.n_rx_placed - p_prev_stat->counters.n_rx_placed) / delay;
+    p_prev_stat->counters.n_rx_wnd_max = p_curr_stat->counters.n_rx_wnd_max;
+    p_prev_stat->counters.n_rx_wnd_grows =
+        (p_curr_stat->counters.n_rx_wnd_grows - p_prev_stat->counters.n_rx_wnd_grows) / delay;
+    p_prev_stat->counters.n_rx_wnd_shrinks =
+        (p_curr_stat->counters.n_rx_wnd_shrinks - p_prev_stat->counters.n_rx_wnd_shrinks) / delay;
     p_prev_stat->counters.n_rx_eagain =
         (p_curr_stat->counters.n_rx_eagain - p_prev_stat->counters.n_rx_eagain) / delay;
     p_prev_stat->counters.n_rx_errors =
@@ -243,6 +326,10 @@ void update_delta_stat(socket_stats_t *p_curr_stat, socket_stats_t *p_prev_stat)
         (p_curr_stat->tls_counters.n_tls_tx_resync_replay -
          p_prev_stat->tls_counters.n_tls_tx_resync_replay) /
         delay;
+    p_prev_stat->tls_counters.n_tls_tx_key_updates =
+        (p_curr_stat->tls_counters.n_tls_tx_key_updates -
+         p_prev_stat->tls_counters.n_tls_tx_key_updates) /
+        delay;
     p_prev_stat->tls_counters.n_tls_rx_records =
         (p_curr_stat->tls_counters.n_tls_rx_records - p_prev_stat->tls_counters.n_tls_rx_records) /
         delay;
@@ -283,6 +370,9 @@ void update_delta_stat(socket_stats_t *p_curr_stat, socket_stats_t *p_prev_stat)
         (p_curr_stat->counters.n_tx_migrations - p_prev_stat->counters.n_tx_migrations) / delay;
     p_prev_stat->counters.n_tx_retransmits =
         (p_curr_stat->counters.n_tx_retransmits - p_prev_stat->counters.n_tx_retransmits) / delay;
+    p_prev_stat->counters.n_tx_sack_retransmits = (p_curr_stat->counters.n_tx_sack_retransmits -
+                                                   p_prev_stat->counters.n_tx_sack_retransmits) /
+        delay;
     p_prev_stat->counters.n_tx_sendfile_fallbacks =
         (p_curr_stat->counters.n_tx_sendfile_fallbacks -
          p_prev_stat->counters.n_tx_sendfile_fallbacks) /
@@ -309,6 +399,16 @@ void update_delta_stat(socket_stats_t *p_curr_stat, socket_stats_t *p_prev_stat)
     p_prev_stat->listen_counters.n_conn_dropped = (p_curr_stat->listen_counters.n_conn_dropped -
                                                    p_prev_stat->listen_counters.n_conn_dropped) /
         delay;
+    p_prev_stat->listen_counters.n_syncookies_sent =
+        (p_curr_stat->listen_counters.n_syncookies_sent -
+         p_prev_stat->listen_counters.n_syncookies_sent) /
+        delay;
+    p_prev_stat->listen_counters.n_syncookies_validated =
+        (p_curr_stat->listen_counters.n_syncookies_validated -
+         p_prev_stat->listen_counters.n_syncookies_validated) /
+        delay;
+    update_delta_lat_hists(&p_curr_stat->lat_hists, &p_prev_stat->lat_hists);
+    update_delta_tcp_loss(&p_curr_stat->tcp_loss, &p_prev_stat->tcp_loss);
 }
 
 void update_delta_iomux_stat(iomux_func_stats_t *p_curr_stats, iomux_func_stats_t *p_prev_stats)
@@ -327,6 +427,9 @@ void update_delta_iomux_stat(iomux_func_stats_t *p_curr_stats, iomux_func_stats_
             (p_curr_stats->n_iomux_rx_ready - p_prev_stats->n_iomux_rx_ready) / delay;
         p_prev_stats->n_iomux_timeouts =
             (p_curr_stats->n_iomux_timeouts - p_prev_stats->n_iomux_timeouts) / delay;
+        p_prev_stats->n_iomux_rx_poll_skipped =
+            (p_curr_stats->n_iomux_rx_poll_skipped - p_prev_stats->n_iomux_rx_poll_skipped) /
+            delay;
         p_prev_stats->threadid_last = p_curr_stats->threadid_last;
     }
 }
@@ -367,6 +470,11 @@ void update_delta_ring_stat(ring_stats_t *p_curr_ring_stats, ring_stats_t *p_pre
         p_prev_ring_stats->n_rx_zc_migiration_drop = (p_curr_ring_stats->n_rx_zc_migiration_drop -
                                                       p_prev_ring_stats->n_rx_zc_migiration_drop) /
             delay;
+        p_prev_ring_stats->n_rx_filter_drops =
+            (p_curr_ring_stats->n_rx_filter_drops - p_prev_ring_stats->n_rx_filter_drops) / delay;
+        p_prev_ring_stats->n_rx_filter_redirects = (p_curr_ring_stats->n_rx_filter_redirects -
+                                                    p_prev_ring_stats->n_rx_filter_redirects) /
+            delay;
         p_prev_ring_stats->n_tx_tso_pkt_count =
             (p_curr_ring_stats->n_tx_tso_pkt_count - p_prev_ring_stats->n_tx_tso_pkt_count) / delay;
         p_prev_ring_stats->n_tx_tso_byte_count =
@@ -380,6 +488,23 @@ void update_delta_ring_stat(ring_stats_t *p_curr_ring_stats, ring_stats_t *p_pre
             delay;
         p_prev_ring_stats->n_rx_cq_moderation_count = p_curr_ring_stats->n_rx_cq_moderation_count;
         p_prev_ring_stats->n_rx_cq_moderation_period = p_curr_ring_stats->n_rx_cq_moderation_period;
+        p_prev_ring_stats->n_rx_cq_moderation_gap_usec =
+            p_curr_ring_stats->n_rx_cq_moderation_gap_usec;
+        p_prev_ring_stats->n_rx_cq_moderation_burst = p_curr_ring_stats->n_rx_cq_moderation_burst;
+        p_prev_ring_stats->n_rx_cq_moderation_target_frames =
+            p_curr_ring_stats->n_rx_cq_moderation_target_frames;
+        p_prev_ring_stats->n_rx_cq_moderation_decisions =
+            (p_curr_ring_stats->n_rx_cq_moderation_decisions -
+             p_prev_ring_stats->n_rx_cq_moderation_decisions) /
+            delay;
+        p_prev_ring_stats->n_bond_failovers =
+            (p_curr_ring_stats->n_bond_failovers - p_prev_ring_stats->n_bond_failovers) / delay;
+        p_prev_ring_stats->n_bond_failover_usec = p_curr_ring_stats->n_bond_failover_usec;
+        p_prev_ring_stats->n_numa_node = p_curr_ring_stats->n_numa_node;
+        p_prev_ring_stats->n_queue_page_size = p_curr_ring_stats->n_queue_page_size;
+        p_prev_ring_stats->n_numa_cross_allocs =
+            (p_curr_ring_stats->n_numa_cross_allocs - p_prev_ring_stats->n_numa_cross_allocs) /
+            delay;
         p_prev_ring_stats->n_tx_dev_mem_allocated = p_curr_ring_stats->n_tx_dev_mem_allocated;
         p_prev_ring_stats->n_tx_dev_mem_byte_count = (p_curr_ring_stats->n_tx_dev_mem_byte_count -
                                                       p_prev_ring_stats->n_tx_dev_mem_byte_count) /
@@ -392,6 +517,38 @@ void update_delta_ring_stat(ring_stats_t *p_curr_ring_stats, ring_stats_t *p_pre
         p_prev_ring_stats->n_rx_steering_rules =
             (p_curr_ring_stats->n_rx_steering_rules - p_prev_ring_stats->n_rx_steering_rules) /
             delay;
+        p_prev_ring_stats->n_rx_steering_rule_fails =
+            (p_curr_ring_stats->n_rx_steering_rule_fails -
+             p_prev_ring_stats->n_rx_steering_rule_fails) /
+            delay;
+        p_prev_ring_stats->n_tx_db_saved =
+            (p_curr_ring_stats->n_tx_db_saved - p_prev_ring_stats->n_tx_db_saved) / delay;
+        p_prev_ring_stats->n_rx_poll_cqes =
+            (p_curr_ring_stats->n_rx_poll_cqes - p_prev_ring_stats->n_rx_poll_cqes) / delay;
+        p_prev_ring_stats->n_rx_poll_budget_hits = (p_curr_ring_stats->n_rx_poll_budget_hits -
+                                                    p_prev_ring_stats->n_rx_poll_budget_hits) /
+            delay;
+        p_prev_ring_stats->n_tx_wqes =
+            (p_curr_ring_stats->n_tx_wqes - p_prev_ring_stats->n_tx_wqes) / delay;
+        p_prev_ring_stats->n_tx_wqes_signaled =
+            (p_curr_ring_stats->n_tx_wqes_signaled - p_prev_ring_stats->n_tx_wqes_signaled) /
+            delay;
+        p_prev_ring_stats->n_tx_odp_pkt_count =
+            (p_curr_ring_stats->n_tx_odp_pkt_count - p_prev_ring_stats->n_tx_odp_pkt_count) / delay;
+        p_prev_ring_stats->n_tx_odp_byte_count =
+            (p_curr_ring_stats->n_tx_odp_byte_count - p_prev_ring_stats->n_tx_odp_byte_count) /
+            delay;
+        p_prev_ring_stats->n_tx_doorbells =
+            (p_curr_ring_stats->n_tx_doorbells - p_prev_ring_stats->n_tx_doorbells) / delay;
+        p_prev_ring_stats->n_tx_bf_wqes =
+            (p_curr_ring_stats->n_tx_bf_wqes - p_prev_ring_stats->n_tx_bf_wqes) / delay;
+        p_prev_ring_stats->n_tx_mpwqe_sessions =
+            (p_curr_ring_stats->n_tx_mpwqe_sessions - p_prev_ring_stats->n_tx_mpwqe_sessions) /
+            delay;
+        p_prev_ring_stats->n_tx_mpwqe_pkts =
+            (p_curr_ring_stats->n_tx_mpwqe_pkts - p_prev_ring_stats->n_tx_mpwqe_pkts) / delay;
+        update_delta_lat_hists(&p_curr_ring_stats->lat_hists, &p_prev_ring_stats->lat_hists);
+        update_delta_tcp_loss(&p_curr_ring_stats->tcp_loss, &p_prev_ring_stats->tcp_loss);
     }
 }
 
@@ -417,6 +574,8 @@ void update_delta_cq_stat(cq_stats_t *p_curr_cq_stats, cq_stats_t *p_prev_cq_sta
             (p_curr_cq_stats->n_rx_gro_frags - p_prev_cq_stats->n_rx_gro_frags) / delay;
         p_prev_cq_stats->n_rx_gro_bytes =
             (p_curr_cq_stats->n_rx_gro_bytes - p_prev_cq_stats->n_rx_gro_bytes) / delay;
+        p_prev_cq_stats->n_rx_gro_held =
+            (p_curr_cq_stats->n_rx_gro_held - p_prev_cq_stats->n_rx_gro_held) / delay;
         p_prev_cq_stats->n_rx_consumed_rwqe_count = (p_curr_cq_stats->n_rx_consumed_rwqe_count -
                                                      p_prev_cq_stats->n_rx_consumed_rwqe_count) /
             delay;
@@ -425,8 +584,25 @@ void update_delta_cq_stat(cq_stats_t *p_curr_cq_stats, cq_stats_t *p_prev_cq_sta
         p_prev_cq_stats->n_rx_packet_count =
             (p_curr_cq_stats->n_rx_packet_count - p_prev_cq_stats->n_rx_packet_count) / delay;
         p_prev_cq_stats->n_rx_max_stirde_per_packet = p_curr_cq_stats->n_rx_max_stirde_per_packet;
+        p_prev_cq_stats->n_rx_stride_size = p_curr_cq_stats->n_rx_stride_size;
+        p_prev_cq_stats->n_rx_strides_per_rwqe = p_curr_cq_stats->n_rx_strides_per_rwqe;
         p_prev_cq_stats->n_rx_cqe_error =
             (p_curr_cq_stats->n_rx_cqe_error - p_prev_cq_stats->n_rx_cqe_error) / delay;
+        p_prev_cq_stats->n_rx_cqe_zip_packets =
+            (p_curr_cq_stats->n_rx_cqe_zip_packets - p_prev_cq_stats->n_rx_cqe_zip_packets) /
+            delay;
+        p_prev_cq_stats->n_rx_cqe_zip_sessions =
+            (p_curr_cq_stats->n_rx_cqe_zip_sessions - p_prev_cq_stats->n_rx_cqe_zip_sessions) /
+            delay;
+        p_prev_cq_stats->n_rx_empty_polls =
+            (p_curr_cq_stats->n_rx_empty_polls - p_prev_cq_stats->n_rx_empty_polls) / delay;
+        p_prev_cq_stats->n_rx_poll_tsc =
+            (p_curr_cq_stats->n_rx_poll_tsc - p_prev_cq_stats->n_rx_poll_tsc) / delay;
+        for (uint32_t i = 0; i < CQ_POLL_HIST_BUCKETS; i++) {
+            p_prev_cq_stats->n_rx_poll_cqes_hist[i] = (p_curr_cq_stats->n_rx_poll_cqes_hist[i] -
+                                                       p_prev_cq_stats->n_rx_poll_cqes_hist[i]) /
+                delay;
+        }
     }
 }
 
@@ -438,6 +614,14 @@ void update_delta_bpool_stat(bpool_stats_t *p_curr_bpool_stats, bpool_stats_t *p
         p_prev_bpool_stats->n_buffer_pool_no_bufs = (p_curr_bpool_stats->n_buffer_pool_no_bufs -
                                                      p_prev_bpool_stats->n_buffer_pool_no_bufs) /
             delay;
+        p_prev_bpool_stats->n_buffer_pool_cache_hits =
+            (p_curr_bpool_stats->n_buffer_pool_cache_hits -
+             p_prev_bpool_stats->n_buffer_pool_cache_hits) /
+            delay;
+        p_prev_bpool_stats->n_buffer_pool_cache_misses =
+            (p_curr_bpool_stats->n_buffer_pool_cache_misses -
+             p_prev_bpool_stats->n_buffer_pool_cache_misses) /
+            delay;
     }
 }
 
@@ -454,6 +638,23 @@ void update_delta_global_stat(global_stats_t *p_curr_global_stats,
         p_prev_global_stats->n_pending_sockets =
             (p_curr_global_stats->n_pending_sockets - p_prev_global_stats->n_pending_sockets) /
             delay;
+        p_prev_global_stats->n_rx_pool_pressure_events =
+            (p_curr_global_stats->n_rx_pool_pressure_events -
+             p_prev_global_stats->n_rx_pool_pressure_events) /
+            delay;
+        p_prev_global_stats->n_agent_msgs =
+            (p_curr_global_stats->n_agent_msgs - p_prev_global_stats->n_agent_msgs) / delay;
+        p_prev_global_stats->n_agent_batches =
+            (p_curr_global_stats->n_agent_batches - p_prev_global_stats->n_agent_batches) / delay;
+        p_prev_global_stats->n_agent_send_deferred =
+            (p_curr_global_stats->n_agent_send_deferred -
+             p_prev_global_stats->n_agent_send_deferred) /
+            delay;
+        p_prev_global_stats->n_agent_msgs_dropped =
+            (p_curr_global_stats->n_agent_msgs_dropped -
+             p_prev_global_stats->n_agent_msgs_dropped) /
+            delay;
+        p_prev_global_stats->n_agent_wait_queue = p_curr_global_stats->n_agent_wait_queue;
         p_prev_global_stats->socket_tcp_destructor_counter =
             (p_curr_global_stats->socket_tcp_destructor_counter.load() -
              p_prev_global_stats->socket_tcp_destructor_counter.load()) /
@@ -507,6 +708,12 @@ void print_ring_stats(ring_instance_block_t *p_ring_inst_arr)
                 printf(FORMAT_STATS_32bit,
                        "RX ZC Migration Drop:", p_ring_stats->n_rx_zc_migiration_drop);
             }
+            if (p_ring_stats->n_rx_filter_drops || p_ring_stats->n_rx_filter_redirects) {
+                printf(FORMAT_STATS_64bit, "RX Filter Drops:", p_ring_stats->n_rx_filter_drops,
+                       post_fix);
+                printf(FORMAT_STATS_64bit,
+                       "RX Filter Redirects:", p_ring_stats->n_rx_filter_redirects, post_fix);
+            }
 #ifdef DEFINED_UTLS
             if (p_ring_stats->n_tx_tls_contexts || p_ring_stats->n_tx_tls_resyncs) {
                 printf(FORMAT_RING_TX_TLS, "HW TLS TX:", p_ring_stats->n_tx_tls_contexts,
@@ -533,6 +740,27 @@ void print_ring_stats(ring_instance_block_t *p_ring_inst_arr)
                        "Moderation:", p_ring_stats->n_rx_cq_moderation_count,
                        p_ring_stats->n_rx_cq_moderation_period, post_fix);
             }
+            if (p_ring_stats->n_rx_cq_moderation_decisions) {
+                printf(FORMAT_RING_AIM_INPUT,
+                       "Moderation input:", p_ring_stats->n_rx_cq_moderation_gap_usec,
+                       p_ring_stats->n_rx_cq_moderation_burst,
+                       p_ring_stats->n_rx_cq_moderation_target_frames, post_fix);
+                printf(FORMAT_STATS_32bit,
+                       "Moderation updates:", p_ring_stats->n_rx_cq_moderation_decisions);
+            }
+            if (p_ring_stats->n_bond_failovers) {
+                printf(FORMAT_STATS_32bit, "Bond failovers:", p_ring_stats->n_bond_failovers);
+                printf(FORMAT_STATS_32bit,
+                       "Last failover usec:", p_ring_stats->n_bond_failover_usec);
+            }
+            if (p_ring_stats->n_numa_node >= 0) {
+                printf(FORMAT_STATS_32bit, "NUMA node:", p_ring_stats->n_numa_node);
+                printf(FORMAT_STATS_32bit,
+                       "Cross node allocs:", p_ring_stats->n_numa_cross_allocs);
+            }
+            if (p_ring_stats->n_queue_page_size) {
+                printf(FORMAT_STATS_32bit, "Queue page size:", p_ring_stats->n_queue_page_size);
+            }
             if (p_ring_stats->n_tx_dev_mem_allocated) {
                 printf(FORMAT_STATS_32bit, "Dev Mem Alloc:", p_ring_stats->n_tx_dev_mem_allocated);
                 printf(FORMAT_RING_DM_STATS,
@@ -543,9 +771,49 @@ void print_ring_stats(ring_instance_block_t *p_ring_inst_arr)
             if (p_ring_stats->n_rx_steering_rules) {
                 printf(FORMAT_STATS_32bit, "RX steering rules:", p_ring_stats->n_rx_steering_rules);
             }
+            if (p_ring_stats->n_rx_steering_rule_fails) {
+                printf(FORMAT_STATS_32bit,
+                       "RX steering rule fails:", p_ring_stats->n_rx_steering_rule_fails);
+            }
+            if (p_ring_stats->n_tx_db_saved) {
+                printf(FORMAT_STATS_64bit, "TX Doorbells Saved:", p_ring_stats->n_tx_db_saved,
+                       post_fix);
+            }
+            if (p_ring_stats->n_rx_poll_cqes) {
+                printf(FORMAT_STATS_64bit, "RX Polled CQEs:", p_ring_stats->n_rx_poll_cqes,
+                       post_fix);
+                printf(FORMAT_STATS_64bit, "RX Poll Budget Hits:",
+                       p_ring_stats->n_rx_poll_budget_hits, post_fix);
+            }
+            if (p_ring_stats->n_tx_wqes) {
+                printf(FORMAT_STATS_64bit, "TX WQEs:", p_ring_stats->n_tx_wqes, post_fix);
+                printf(FORMAT_STATS_64bit, "TX Doorbells:", p_ring_stats->n_tx_doorbells,
+                       post_fix);
+                if (p_ring_stats->n_tx_bf_wqes) {
+                    printf(FORMAT_STATS_64bit, "TX BlueFlame WQEs:", p_ring_stats->n_tx_bf_wqes,
+                           post_fix);
+                }
+                if (p_ring_stats->n_tx_mpwqe_sessions) {
+                    printf(FORMAT_STATS_64bit,
+                           "TX MPWQE Sessions:", p_ring_stats->n_tx_mpwqe_sessions, post_fix);
+                    printf(FORMAT_STATS_64bit, "TX MPWQE Packets:", p_ring_stats->n_tx_mpwqe_pkts,
+                           post_fix);
+                }
+                printf(FORMAT_STATS_64bit, "TX Signaled WQEs:", p_ring_stats->n_tx_wqes_signaled,
+                       post_fix);
+                printf(FORMAT_STATS_double, "TX CQE/WQE ratio %:",
+                       100.0 * p_ring_stats->n_tx_wqes_signaled / p_ring_stats->n_tx_wqes);
+            }
+            if (p_ring_stats->n_tx_odp_pkt_count) {
+                printf(FORMAT_RING_PACKETS,
+                       "TX ODP:", p_ring_stats->n_tx_odp_byte_count / BYTES_TRAFFIC_UNIT,
+                       p_ring_stats->n_tx_odp_pkt_count, post_fix);
+            }
 
             printf(FORMAT_STATS_32bit, "TX buffers inflight:", p_ring_stats->n_tx_num_bufs);
             printf(FORMAT_STATS_32bit, "TX ZC buffers inflight:", p_ring_stats->n_zc_num_bufs);
+            print_lat_hists(&p_ring_stats->lat_hists, stdout);
+            print_tcp_loss(&p_ring_stats->tcp_loss, stdout, post_fix);
         }
     }
     printf("======================================================\n");
@@ -580,6 +848,10 @@ void print_cq_stats(cq_instance_block_t *p_cq_inst_arr)
             printf(FORMAT_STATS_32bit, "CQE errors:", p_cq_stats->n_rx_cqe_error);
             printf(FORMAT_STATS_64bit, "Consumed rwqes:", p_cq_stats->n_rx_consumed_rwqe_count,
                    post_fix);
+            if (p_cq_stats->n_rx_stride_size) {
+                printf(FORMAT_STATS_32bit, "Stride size:", p_cq_stats->n_rx_stride_size);
+                printf(FORMAT_STATS_32bit, "Strides/rwqe:", p_cq_stats->n_rx_strides_per_rwqe);
+            }
             printf(FORMAT_STATS_32bit, "Max strides/packet:",
                    static_cast<uint32_t>(p_cq_stats->n_rx_max_stirde_per_packet));
             printf(FORMAT_STATS_double, "Avg strides/packet:",
@@ -588,6 +860,13 @@ void print_cq_stats(cq_instance_block_t *p_cq_inst_arr)
             printf(FORMAT_STATS_double, "Avg packets/rwqe:",
                    p_cq_stats->n_rx_packet_count /
                        static_cast<double>(p_cq_stats->n_rx_consumed_rwqe_count + 1U));
+            printf(FORMAT_STATS_64bit, "Empty polls:", p_cq_stats->n_rx_empty_polls, post_fix);
+            if (p_cq_stats->n_rx_cqe_zip_packets) {
+                printf(FORMAT_STATS_64bit, "Compressed CQEs:", p_cq_stats->n_rx_cqe_zip_packets,
+                       post_fix);
+                printf(FORMAT_STATS_32bit, "Compressed sessions:",
+                       p_cq_stats->n_rx_cqe_zip_sessions);
+            }
             if (p_cq_stats->n_rx_lro_packets) {
                 printf(FORMAT_RING_PACKETS,
                        "Rx lro:", p_cq_stats->n_rx_lro_bytes / BYTES_TRAFFIC_UNIT,
@@ -602,6 +881,10 @@ void print_cq_stats(cq_instance_block_t *p_cq_inst_arr)
                 printf(
                     FORMAT_STATS_double, "GRO frags per packet:",
                     static_cast<double>(p_cq_stats->n_rx_gro_frags) / p_cq_stats->n_rx_gro_packets);
+                if (p_cq_stats->n_rx_gro_held) {
+                    printf(FORMAT_STATS_64bit, "GRO held over polls:", p_cq_stats->n_rx_gro_held,
+                           post_fix);
+                }
             }
         }
     }
@@ -616,13 +899,13 @@ void print_entity_context_stats(entity_context_instance_block_t *p_ent_ctx_inst_
     }
 
     printf("======================================================================================="
-           "============\n");
-    printf("Entity  | CPUTime                  | Job Queue     | Sockets                           "
-           "    | RSS   \n");
-    printf("Context | Idle | PollHit | JobProc | Max   | Avg   | Total   | Added   | Removed | Delt"
-           "a   | Childs\n");
+           "======================================\n");
+    printf("Entity  | CPUTime                  | Idle          | Job Queue     | Sockets           "
+           "                              | RSS   \n");
+    printf("Context | Idle | PollHit | JobProc | Pause | Block | Max   | Avg   | Total   | Added   | "
+           "Removed | Delta   | Stolen  | Childs\n");
     printf("---------------------------------------------------------------------------------------"
-           "------------\n");
+           "--------------------------------------\n");
 
     for (int i = 0; i < NUM_OF_SUPPORTED_ENTITY_CTX; i++) {
         // coverity[missing_lock:FALSE] /* Turn off coverity missing_lock check*/
@@ -636,23 +919,216 @@ void print_entity_context_stats(entity_context_instance_block_t *p_ent_ctx_inst_
             uint8_t job_time =
                 static_cast<uint8_t>((p_ent_ctx_stats.job_proc_time * 100.0) / tot_time);
             uint8_t idle_time = 100U - poll_hit_time - job_time;
+            uint8_t pause_time =
+                static_cast<uint8_t>((p_ent_ctx_stats.idle_pause_time * 100.0) / tot_time);
+            uint8_t block_time =
+                static_cast<uint8_t>((p_ent_ctx_stats.idle_block_time * 100.0) / tot_time);
 
             printf(
-                "%7d | %3" PRIu8 "%% | %6" PRIu8 "%% | %6" PRIu8 "%% | %5" PRIu32 " | %5" PRIu32
+                "%7d | %3" PRIu8 "%% | %6" PRIu8 "%% | %6" PRIu8 "%% | %4" PRIu8 "%% | %4" PRIu8
+                "%% | %5" PRIu32 " | %5" PRIu32
                 " | %7" PRIu32 " | %7G"
-                " | %7G | %7G | %" PRIu32 "\n",
-                i, idle_time, poll_hit_time, job_time, p_ent_ctx_stats.job_queue_size_max,
+                " | %7G | %7G | %7G | %" PRIu32 "\n",
+                i, idle_time, poll_hit_time, job_time, pause_time, block_time,
+                p_ent_ctx_stats.job_queue_size_max,
                 p_ent_ctx_stats.job_queue_size_acc / std::max(p_ent_ctx_stats.job_queue_hits, 1U),
                 p_ent_ctx_inst_arr[i].tot_socket,
                 static_cast<double>(p_ent_ctx_stats.socket_num_added),
                 static_cast<double>(p_ent_ctx_stats.socket_num_removed),
                 static_cast<double>(p_ent_ctx_stats.socket_num_added -
                                     p_ent_ctx_stats.socket_num_removed),
+                static_cast<double>(p_ent_ctx_stats.socket_num_stolen),
                 p_ent_ctx_stats.listen_rsschild_num);
         }
     }
 }
 
+void print_poll_group_stats(poll_group_instance_block_t *p_poll_group_inst_arr)
+{
+    const double tsc_per_usec = static_cast<double>(get_tsc_rate_per_second()) / 1e6;
+
+    printf("======================================================================================="
+           "===========================================\n");
+    printf("Poll  | Polls      | Empty | Rx Pkts    | Tx Ops     | Dirty      | Slow   | RxCB     "
+           "| Sockets | Pool       | Pool       | Warmup\n");
+    printf("Group |            |       |            |            | Flushes    | Path   | usec     "
+           "|         | Hits       | Misses     | usec\n");
+    printf("---------------------------------------------------------------------------------------"
+           "-------------------------------------------\n");
+
+    for (int i = 0; i < NUM_OF_SUPPORTED_POLL_GROUPS; i++) {
+        // coverity[missing_lock:FALSE] /* Turn off coverity missing_lock check*/
+        if (p_poll_group_inst_arr[i].b_enabled) {
+            poll_group_stats_t &p_grp_stats = p_poll_group_inst_arr[i].poll_group_stats;
+            uint64_t polls = std::max<uint64_t>(p_grp_stats.n_poll_iterations, 1U);
+            uint8_t empty = static_cast<uint8_t>((p_grp_stats.n_poll_empty * 100.0) / polls);
+            // Average warm-up latency of a pooled connection
+            uint64_t warmups = std::max<uint64_t>(p_grp_stats.n_conn_pool_warmups, 1U);
+
+            printf("%5d | %10" PRIu64 " | %4" PRIu8 "%% | %10" PRIu64 " | %10" PRIu64 " | %10" PRIu64
+                   " | %6" PRIu64 " | %8.0f | %7" PRIu32 " | %10" PRIu64 " | %10" PRIu64
+                   " | %.1f\n",
+                   i, p_grp_stats.n_poll_iterations, empty, p_grp_stats.n_rx_pkts,
+                   p_grp_stats.n_tx_ops, p_grp_stats.n_dirty_flushes,
+                   p_grp_stats.n_slow_path_runs, p_grp_stats.n_rx_cb_tsc / tsc_per_usec,
+                   p_grp_stats.n_sockets, p_grp_stats.n_conn_pool_hits,
+                   p_grp_stats.n_conn_pool_misses,
+                   p_grp_stats.n_conn_pool_warmup_tsc / tsc_per_usec / warmups);
+        }
+    }
+}
+
+/*
+ * Prints the poll efficiency of the CQs and the rings, the rates of the last interval if the
+ * previous blocks are given and the totals otherwise.
+ */
+void print_poll_efficiency_stats(const cq_instance_block_t *p_curr_cq_blocks,
+                                 const cq_instance_block_t *p_prev_cq_blocks,
+                                 const ring_instance_block_t *p_curr_ring_blocks,
+                                 const ring_instance_block_t *p_prev_ring_blocks)
+{
+    const double tsc_per_usec = static_cast<double>(get_tsc_rate_per_second()) / 1e6;
+    const uint64_t delay = p_prev_cq_blocks ? static_cast<uint64_t>(user_params.interval) : 1U;
+
+    printf("======================================================================================="
+           "==========\n");
+    printf("CQ   | Polls      | Empty | Pkts/ | CQEs per productive poll %%          | Poll     "
+           "| nsec/\n");
+    printf("     |            |       | Poll  |     1   2-3   4-7  8-15 16-31   32+ | usec     "
+           "| Pkt\n");
+    printf("---------------------------------------------------------------------------------------"
+           "----------\n");
+
+    for (int i = 0; i < NUM_OF_SUPPORTED_CQS; i++) {
+        // coverity[missing_lock:FALSE] /* Turn off coverity missing_lock check*/
+        if (!p_curr_cq_blocks[i].b_enabled) {
+            continue;
+        }
+        const cq_stats_t &curr = p_curr_cq_blocks[i].cq_stats;
+        const cq_stats_t *prev = p_prev_cq_blocks ? &p_prev_cq_blocks[i].cq_stats : nullptr;
+        auto rate = [&](uint64_t cq_stats_t::*field) {
+            return (curr.*field - (prev ? prev->*field : 0U)) / delay;
+        };
+        uint64_t hist[CQ_POLL_HIST_BUCKETS];
+        uint64_t productive = 0U;
+        uint64_t productive_div;
+
+        for (uint32_t b = 0; b < CQ_POLL_HIST_BUCKETS; b++) {
+            hist[b] = (curr.n_rx_poll_cqes_hist[b] - (prev ? prev->n_rx_poll_cqes_hist[b] : 0U)) /
+                delay;
+            productive += hist[b];
+        }
+        productive_div = std::max<uint64_t>(productive, 1U);
+        uint64_t empty = rate(&cq_stats_t::n_rx_empty_polls);
+        uint64_t polls = std::max<uint64_t>(empty + productive, 1U);
+        uint64_t packets = rate(&cq_stats_t::n_rx_packet_count);
+        double poll_usec = rate(&cq_stats_t::n_rx_poll_tsc) / tsc_per_usec;
+
+        printf("%4d | %10" PRIu64 " | %4u%% | %5.1f |", i, empty + productive,
+               static_cast<unsigned>(empty * 100U / polls),
+               static_cast<double>(packets) / productive_div);
+        for (uint32_t b = 0; b < CQ_POLL_HIST_BUCKETS; b++) {
+            printf(" %5u", static_cast<unsigned>(hist[b] * 100U / productive_div));
+        }
+        printf(" | %8.0f | %.0f\n", poll_usec,
+               poll_usec * 1000.0 / std::max<uint64_t>(packets, 1U));
+    }
+
+    printf("---------------------------------------------------------------------------------------"
+           "----------\n");
+    printf("Ring | RX CQEs    | Budget | TX WQEs    | Doorbells  | WQEs/ | Doorbells\n");
+    printf("     |            | Hits   |            |            | DB    | Saved\n");
+    printf("---------------------------------------------------------------------------------------"
+           "----------\n");
+
+    for (int i = 0; i < NUM_OF_SUPPORTED_RINGS; i++) {
+        // coverity[missing_lock:FALSE] /* Turn off coverity missing_lock check*/
+        if (!p_curr_ring_blocks[i].b_enabled) {
+            continue;
+        }
+        const ring_stats_t &curr = p_curr_ring_blocks[i].ring_stats;
+        const ring_stats_t *prev = p_prev_ring_blocks ? &p_prev_ring_blocks[i].ring_stats : nullptr;
+        auto rate = [&](uint64_t ring_stats_t::*field) {
+            return (curr.*field - (prev ? prev->*field : 0U)) / delay;
+        };
+        uint64_t wqes = rate(&ring_stats_t::n_tx_wqes);
+        uint64_t doorbells = rate(&ring_stats_t::n_tx_doorbells);
+
+        printf("%4d | %10" PRIu64 " | %6" PRIu64 " | %10" PRIu64 " | %10" PRIu64 " | %5.1f"
+               " | %" PRIu64 "\n",
+               i, rate(&ring_stats_t::n_rx_poll_cqes), rate(&ring_stats_t::n_rx_poll_budget_hits),
+               wqes, doorbells, static_cast<double>(wqes) / std::max<uint64_t>(doorbells, 1U),
+               rate(&ring_stats_t::n_tx_db_saved));
+    }
+}
+
+// Upper bound of the bucket which holds the percentile of the samples, in usec
+static double lat_hist_percentile_usec(const uint64_t *p_buckets, uint64_t samples, double pct)
+{
+    const double tsc_per_usec = static_cast<double>(get_tsc_rate_per_second()) / 1e6;
+    uint64_t sum = 0U;
+
+    for (uint32_t i = 0U; i < LAT_HIST_BUCKETS; ++i) {
+        sum += p_buckets[i];
+        if (sum * 100.0 >= pct * samples) {
+            return lat_hist_bucket_min(std::min(i + 1U, LAT_HIST_BUCKETS - 1U)) / tsc_per_usec;
+        }
+    }
+    return 0.0;
+}
+
+/*
+ * Prints the lock contention by lock name, the rates of the last interval if the previous blocks
+ * are given and the totals otherwise. The wait columns are of the contended acquisitions.
+ */
+void print_lock_stats(const lock_instance_block_t *p_curr_lock_blocks,
+                      const lock_instance_block_t *p_prev_lock_blocks)
+{
+    const double tsc_per_usec = static_cast<double>(get_tsc_rate_per_second()) / 1e6;
+    const uint64_t delay = p_prev_lock_blocks ? static_cast<uint64_t>(user_params.interval) : 1U;
+    bool b_any = false;
+
+    printf("======================================================================================="
+           "==========\n");
+    printf("Lock                            | Acquired   | Cont  | Trylock    | Wait     | Wait     "
+           "| Wait\n");
+    printf("                                |            |       | Failed     | avg usec | p99 usec "
+           "| max usec\n");
+    printf("---------------------------------------------------------------------------------------"
+           "----------\n");
+
+    for (int i = 0; i < NUM_OF_SUPPORTED_LOCKS; i++) {
+        // coverity[missing_lock:FALSE] /* Turn off coverity missing_lock check*/
+        if (!p_curr_lock_blocks[i].b_enabled) {
+            continue;
+        }
+        const lock_stats_t &curr = p_curr_lock_blocks[i].lock_stats;
+        const lock_stats_t *prev = p_prev_lock_blocks ? &p_prev_lock_blocks[i].lock_stats : nullptr;
+        auto delta = [&](uint64_t lock_stats_t::*field) {
+            return curr.*field - (prev ? prev->*field : 0U);
+        };
+        uint64_t hist[LAT_HIST_BUCKETS];
+        uint64_t acquired = delta(&lock_stats_t::n_acquired);
+        uint64_t contended = delta(&lock_stats_t::n_contended);
+        uint64_t contended_div = std::max<uint64_t>(contended, 1U);
+
+        for (uint32_t b = 0; b < LAT_HIST_BUCKETS; b++) {
+            hist[b] = curr.wait_hist.buckets[b] - (prev ? prev->wait_hist.buckets[b] : 0U);
+        }
+        b_any = true;
+        printf("%-31.31s | %10" PRIu64 " | %4u%% | %10" PRIu64 " | %8.2f | %8.2f | %.2f\n",
+               p_curr_lock_blocks[i].name, acquired / delay,
+               static_cast<unsigned>(contended * 100U / std::max<uint64_t>(acquired, 1U)),
+               delta(&lock_stats_t::n_trylock_failed) / delay,
+               delta(&lock_stats_t::n_wait_tsc) / tsc_per_usec / contended_div,
+               contended ? lat_hist_percentile_usec(hist, contended, 99.0) : 0.0,
+               contended ? lat_hist_percentile_usec(hist, contended, 100.0) : 0.0);
+    }
+    if (!b_any) {
+        printf("No locks profiled, set monitor.stats.lock_profiling to enable the profiling\n");
+    }
+}
+
 void print_bpool_stats(bpool_instance_block_t *p_bpool_inst_arr)
 {
     bpool_stats_t *p_bpool_stats = NULL;
@@ -681,6 +1157,13 @@ void print_bpool_stats(bpool_instance_block_t *p_bpool_inst_arr)
             if (p_bpool_stats->n_buffer_pool_expands) {
                 printf(FORMAT_STATS_32bit, "Expands:", p_bpool_stats->n_buffer_pool_expands);
             }
+            if (p_bpool_stats->n_buffer_pool_cache_hits ||
+                p_bpool_stats->n_buffer_pool_cache_misses) {
+                printf(FORMAT_STATS_32bit, "Group cache hits:",
+                       p_bpool_stats->n_buffer_pool_cache_hits);
+                printf(FORMAT_STATS_32bit, "Group cache misses:",
+                       p_bpool_stats->n_buffer_pool_cache_misses);
+            }
         }
     }
     printf("======================================================\n");
@@ -706,6 +1189,16 @@ void print_global_stats(global_instance_block_t *p_global_inst_arr)
             printf("======================================================\n");
             printf("\tGLOBAL\n");
             printf(FORMAT_STATS_s_32bit, "Pending sockets:", p_global_stats->n_pending_sockets);
+            printf(FORMAT_STATS_32bit,
+                   "RX pool pressures:", p_global_stats->n_rx_pool_pressure_events);
+            printf(FORMAT_STATS_32bit, "Agent messages:", p_global_stats->n_agent_msgs);
+            printf(FORMAT_STATS_32bit, "Agent batches:", p_global_stats->n_agent_batches);
+            printf(FORMAT_STATS_32bit,
+                   "Agent deferred sends:", p_global_stats->n_agent_send_deferred);
+            printf(FORMAT_STATS_32bit,
+                   "Agent dropped messages:", p_global_stats->n_agent_msgs_dropped);
+            printf(FORMAT_STATS_32bit,
+                   "Agent waiting messages:", p_global_stats->n_agent_wait_queue);
             printf(FORMAT_STATS_s_32bit,
                    "Destructed TCP sockets:", p_global_stats->socket_tcp_destructor_counter.load());
             printf(FORMAT_STATS_s_32bit,
@@ -988,6 +1481,10 @@ void print_full_iomux_stats(const char *func_name, iomux_func_stats_t *p_iomux_s
             if (p_iomux_stats->n_iomux_errors) {
                 printf("Errors%s: %u\n", post_fix, p_iomux_stats->n_iomux_errors);
             }
+            if (p_iomux_stats->n_iomux_rx_poll_skipped) {
+                printf("Ring polls skipped%s: %u\n", post_fix,
+                       p_iomux_stats->n_iomux_rx_poll_skipped);
+            }
             printf("======================================================\n");
         }
     }
@@ -1167,6 +1664,10 @@ void show_entity_context_stats(entity_context_instance_block_t *p_curr_entctx_bl
             (curr_entctx_stats.hit_poll_time - prev_entctx_stats.hit_poll_time) / delay;
         prev_entctx_stats.job_proc_time =
             (curr_entctx_stats.job_proc_time - prev_entctx_stats.job_proc_time) / delay;
+        prev_entctx_stats.idle_pause_time =
+            (curr_entctx_stats.idle_pause_time - prev_entctx_stats.idle_pause_time) / delay;
+        prev_entctx_stats.idle_block_time =
+            (curr_entctx_stats.idle_block_time - prev_entctx_stats.idle_block_time) / delay;
         prev_entctx_stats.job_queue_hits =
             (curr_entctx_stats.job_queue_hits - prev_entctx_stats.job_queue_hits) / delay;
         prev_entctx_stats.job_queue_size_acc =
@@ -1179,18 +1680,66 @@ void show_entity_context_stats(entity_context_instance_block_t *p_curr_entctx_bl
         if (user_params.print_details_mode == e_totals) {
             prev_entctx_stats.socket_num_added = curr_entctx_stats.socket_num_added;
             prev_entctx_stats.socket_num_removed = curr_entctx_stats.socket_num_removed;
+            prev_entctx_stats.socket_num_stolen = curr_entctx_stats.socket_num_stolen;
         } else {
             prev_entctx_stats.socket_num_added =
                 (curr_entctx_stats.socket_num_added - prev_entctx_stats.socket_num_added) / delay;
             prev_entctx_stats.socket_num_removed =
                 (curr_entctx_stats.socket_num_removed - prev_entctx_stats.socket_num_removed) /
                 delay;
+            prev_entctx_stats.socket_num_stolen =
+                (curr_entctx_stats.socket_num_stolen - prev_entctx_stats.socket_num_stolen) / delay;
         }
     }
 
     print_entity_context_stats(p_prev_entctx_blocks);
 }
 
+void show_poll_group_stats(poll_group_instance_block_t *p_curr_grp_blocks,
+                           poll_group_instance_block_t *p_prev_grp_blocks)
+{
+    if (unlikely(!p_curr_grp_blocks || !p_prev_grp_blocks)) {
+        return;
+    }
+
+    if (user_params.print_details_mode == e_totals) {
+        print_poll_group_stats(p_curr_grp_blocks);
+        return;
+    }
+
+    for (int i = 0; i < NUM_OF_SUPPORTED_POLL_GROUPS; i++) {
+        uint64_t delay = static_cast<uint64_t>(user_params.interval);
+        poll_group_stats_t &curr_grp_stats = p_curr_grp_blocks[i].poll_group_stats;
+        poll_group_stats_t &prev_grp_stats = p_prev_grp_blocks[i].poll_group_stats;
+
+        p_prev_grp_blocks[i].b_enabled = p_curr_grp_blocks[i].b_enabled;
+        prev_grp_stats.n_poll_iterations =
+            (curr_grp_stats.n_poll_iterations - prev_grp_stats.n_poll_iterations) / delay;
+        prev_grp_stats.n_poll_empty =
+            (curr_grp_stats.n_poll_empty - prev_grp_stats.n_poll_empty) / delay;
+        prev_grp_stats.n_rx_pkts = (curr_grp_stats.n_rx_pkts - prev_grp_stats.n_rx_pkts) / delay;
+        prev_grp_stats.n_tx_ops = (curr_grp_stats.n_tx_ops - prev_grp_stats.n_tx_ops) / delay;
+        prev_grp_stats.n_dirty_flushes =
+            (curr_grp_stats.n_dirty_flushes - prev_grp_stats.n_dirty_flushes) / delay;
+        prev_grp_stats.n_slow_path_runs =
+            (curr_grp_stats.n_slow_path_runs - prev_grp_stats.n_slow_path_runs) / delay;
+        prev_grp_stats.n_rx_cb_tsc =
+            (curr_grp_stats.n_rx_cb_tsc - prev_grp_stats.n_rx_cb_tsc) / delay;
+        prev_grp_stats.n_conn_pool_hits =
+            (curr_grp_stats.n_conn_pool_hits - prev_grp_stats.n_conn_pool_hits) / delay;
+        prev_grp_stats.n_conn_pool_misses =
+            (curr_grp_stats.n_conn_pool_misses - prev_grp_stats.n_conn_pool_misses) / delay;
+        // The average of the interval, the warmups aren't divided by the delay
+        prev_grp_stats.n_conn_pool_warmup_tsc =
+            curr_grp_stats.n_conn_pool_warmup_tsc - prev_grp_stats.n_conn_pool_warmup_tsc;
+        prev_grp_stats.n_conn_pool_warmups =
+            curr_grp_stats.n_conn_pool_warmups - prev_grp_stats.n_conn_pool_warmups;
+        prev_grp_stats.n_sockets = curr_grp_stats.n_sockets;
+    }
+
+    print_poll_group_stats(p_prev_grp_blocks);
+}
+
 void show_cq_stats(cq_instance_block_t *p_curr_cq_blocks, cq_instance_block_t *p_prev_cq_blocks)
 {
     switch (user_params.print_details_mode) {
@@ -1468,6 +2017,298 @@ bool check_if_process_running(int pid)
     return false;
 }
 
+/*
+ * Extends the copies of the socket blocks to the blocks the publisher added since the last
+ * cycle, the new blocks start from zero. Returns false if the memory can't be allocated.
+ */
+static bool grow_instance_blocks(const sh_mem_t *p_sh_mem, socket_instance_block_t **p_prev,
+                                 socket_instance_block_t **p_curr, size_t &skt_num)
+{
+    size_t new_num = __atomic_load_n(&p_sh_mem->max_skt_inst_num, __ATOMIC_ACQUIRE);
+
+    if (new_num <= skt_num) {
+        return true;
+    }
+    for (socket_instance_block_t **p_p_blocks : {p_prev, p_curr}) {
+        void *p = realloc((void *)*p_p_blocks, new_num * sizeof(socket_instance_block_t));
+        if (!p) {
+            log_system_err("realloc()");
+            return false;
+        }
+        *p_p_blocks = static_cast<socket_instance_block_t *>(p);
+        memset((void *)(*p_p_blocks + skt_num), 0,
+               (new_num - skt_num) * sizeof(socket_instance_block_t));
+    }
+    skt_num = new_num;
+    return true;
+}
+
+static uint64_t realtime_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Parses <name>[=<value>] of --tune, false if it isn't valid
+static bool parse_tune_arg(const char *arg)
+{
+    const char *sep = strchr(arg, '=');
+    size_t name_len = sep ? (size_t)(sep - arg) : strlen(arg);
+
+    g_tune_params.enabled = true;
+    g_tune_params.param = TUNE_PARAM_NUM;
+    if (!sep && strcasecmp("list", arg) == 0) {
+        return true;
+    }
+    for (uint32_t i = 0; i < TUNE_PARAM_NUM; ++i) {
+        const char *name = tune_param_name(i);
+        if (strlen(name) == name_len && strncasecmp(name, arg, name_len) == 0) {
+            g_tune_params.param = i;
+        }
+    }
+    if (g_tune_params.param == TUNE_PARAM_NUM || !sep || !sep[1]) {
+        return false;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    g_tune_params.value = strtoll(sep + 1, &end, 0);
+    return errno == 0 && *end == '\0';
+}
+
+static void set_tune_request(sh_mem_t *p_sh_mem)
+{
+    tune_info_t &tune = p_sh_mem->tune;
+
+    if (g_tune_params.param == TUNE_PARAM_NUM) {
+        return;
+    }
+    tune.param = g_tune_params.param;
+    tune.value = g_tune_params.value;
+    g_tune_params.seq = __atomic_add_fetch(&tune.req_seq, 1U, __ATOMIC_RELEASE);
+}
+
+// Waits for the publisher to apply the request and prints the values in effect
+static void tune_reader_handler(sh_mem_t *p_sh_mem)
+{
+    tune_info_t &tune = p_sh_mem->tune;
+
+    if (g_tune_params.param != TUNE_PARAM_NUM) {
+        int retries = 1000 / STATS_PUBLISHER_TIMER_PERIOD;
+        while (__atomic_load_n(&tune.ack_seq, __ATOMIC_ACQUIRE) != g_tune_params.seq &&
+               retries-- > 0) {
+            usleep(STATS_READER_DELAY * 1000);
+        }
+        if (__atomic_load_n(&tune.ack_seq, __ATOMIC_ACQUIRE) != g_tune_params.seq) {
+            log_err("No reply from the process to the tuning of %s",
+                    tune_param_name(g_tune_params.param));
+            return;
+        }
+        if (tune.status) {
+            log_err("Tuning of %s to %" PRId64 " failed: %s", tune_param_name(g_tune_params.param),
+                    g_tune_params.value, strerror(-tune.status));
+            return;
+        }
+        log_msg("%s is set to %" PRId64, tune_param_name(g_tune_params.param),
+                tune.values[g_tune_params.param]);
+    }
+
+    printf("Runtime tuning, %u changes:\n", tune.n_changes);
+    for (uint32_t i = 0; i < TUNE_PARAM_NUM; ++i) {
+        printf("  %-40s %" PRId64 "\n", tune_param_name(i), tune.values[i]);
+    }
+}
+
+// Sets the filter of the capture and waits for the publisher to apply it, false on a failure
+static bool set_mirror_filter(pkt_mirror_shm_t *shm, const pkt_mirror_filter_t &filter)
+{
+    pkt_mirror_ctl_t &ctl = shm->ctl;
+    int retries = 1000 / STATS_PUBLISHER_TIMER_PERIOD;
+
+    ctl.filter = filter;
+    uint32_t seq = __atomic_add_fetch(&ctl.req_seq, 1U, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&ctl.ack_seq, __ATOMIC_ACQUIRE) != seq && retries-- > 0) {
+        usleep(STATS_READER_DELAY * 1000);
+    }
+    if (__atomic_load_n(&ctl.ack_seq, __ATOMIC_ACQUIRE) != seq) {
+        log_err("No reply from the process to the mirror request");
+        return false;
+    }
+    if (ctl.status) {
+        log_err("Mirror request failed: %s", strerror(-ctl.status));
+        return false;
+    }
+    return true;
+}
+
+// The capture mode, the mirror ring is drained every millisecond to the pcapng file
+static void mirror_reader_handler(int pid)
+{
+    char path[PATH_MAX];
+    struct stat st = {};
+    void *p_map = MAP_FAILED;
+    pkt_mirror_shm_t *shm = nullptr;
+    FILE *file = nullptr;
+    int cycles = user_params.cycles ? user_params.cycles : -1;
+    bool proc_running = true;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/xliomirror.%d", user_params.xlio_stats_path.c_str(), pid);
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        log_err("Packet mirroring is disabled in process %d, set " SYS_VAR_STATS_MIRROR_RING_SLOTS,
+                pid);
+        return;
+    }
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(pkt_mirror_shm_t)) {
+        p_map = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        log_system_err("mmap %s failed", path);
+        return;
+    }
+    shm = static_cast<pkt_mirror_shm_t *>(p_map);
+    if (memcmp(shm->magic, PKT_MIRROR_FILE_MAGIC, sizeof(shm->magic)) != 0 ||
+        shm->version != PKT_MIRROR_FILE_VERSION || shm->slot_size != sizeof(pkt_mirror_slot_t) ||
+        !shm->num_slots || (shm->num_slots & (shm->num_slots - 1U)) ||
+        pkt_mirror_shm_size(shm->num_slots) > (size_t)st.st_size) {
+        log_err("Unsupported mirror file %s", path);
+        goto out;
+    }
+
+    file = fopen(g_mirror_params.file.c_str(), "w");
+    {
+        stats_mirror_pcapng pcapng;
+        stats_mirror_reader reader(shm);
+
+        if (!file || !pcapng.open(file)) {
+            log_err("Unable to write file: %s", g_mirror_params.file.c_str());
+            goto out;
+        }
+        if (!set_mirror_filter(shm, g_mirror_params.filter)) {
+            goto out;
+        }
+        set_signal_action();
+
+        while (!g_b_exit && proc_running && cycles) {
+            uint64_t end_ns = realtime_ns() + user_params.interval * 1000000000ULL;
+
+            --cycles;
+            while (!g_b_exit && realtime_ns() < end_ns) {
+                if (!reader.drain(pcapng)) {
+                    log_err("Unable to write file: %s", g_mirror_params.file.c_str());
+                    g_b_exit = true;
+                    break;
+                }
+                __atomic_add_fetch(&shm->ctl.reader_alive, 1U, __ATOMIC_RELAXED);
+                usleep(1000);
+            }
+            fflush(file);
+            log_msg("Mirrored %" PRIu64 " packets, %" PRIu64 " lost, %" PRIu64 " busy drops",
+                    reader.packets(), reader.lost(),
+                    __atomic_load_n(&shm->n_busy_drops, __ATOMIC_RELAXED));
+            proc_running = check_if_process_running(pid);
+        }
+        if (proc_running) {
+            pkt_mirror_filter_t stop = {};
+            set_mirror_filter(shm, stop);
+            reader.drain(pcapng);
+        } else {
+            log_msg("Proccess %d ended - exiting", pid);
+        }
+    }
+
+out:
+    if (file) {
+        fclose(file);
+    }
+    munmap(p_map, st.st_size);
+}
+
+// The sampling mode, the region is copied once per interval and the deltas are computed offline
+static void snapshot_reader_handler(sh_mem_t *p_sh_mem, int pid)
+{
+    int cycles = user_params.cycles ? user_params.cycles : -1;
+    bool proc_running = true;
+    std::ofstream csv_stream;
+    FILE *bin_file = nullptr;
+    stats_snapshot prev, curr;
+    std::vector<snapshot_socket_delta_t> deltas;
+
+    if (!g_snapshot_params.file.empty()) {
+        if (g_snapshot_params.format == SNAPSHOT_FORMAT_BIN) {
+            bin_file = fopen(g_snapshot_params.file.c_str(), "w");
+            if (!bin_file || !stats_snapshot_write_bin_header(bin_file, pid)) {
+                log_err("Unable to write file: %s", g_snapshot_params.file.c_str());
+                goto out;
+            }
+        } else {
+            csv_stream.open(g_snapshot_params.file);
+            if (!csv_stream.is_open()) {
+                log_err("Unable to open file: %s", g_snapshot_params.file.c_str());
+                goto out;
+            }
+            stats_snapshot_write_csv_header(csv_stream);
+        }
+    }
+
+    if (!prev.take(p_sh_mem)) {
+        log_system_err("realloc()");
+        goto out;
+    }
+    set_signal_action();
+
+    while (!g_b_exit && proc_running && cycles) {
+        uint64_t start_ns = realtime_ns();
+
+        --cycles;
+        if (!g_b_exit && check_if_process_running(pid)) {
+            usleep(SEC_TO_MICRO(user_params.interval));
+        }
+        inc_read_counter(p_sh_mem);
+        if (!curr.take(p_sh_mem)) {
+            log_system_err("realloc()");
+            goto out;
+        }
+        uint64_t end_ns = realtime_ns();
+        uint64_t interval_ns = end_ns - start_ns;
+
+        stats_snapshot_diff(prev, curr, deltas);
+        deltas.erase(std::remove_if(deltas.begin(), deltas.end(),
+                                    [](const snapshot_socket_delta_t &delta) {
+                                        return (uint32_t)delta.fd >= g_fd_map_size ||
+                                            !g_fd_mask[delta.fd];
+                                    }),
+                     deltas.end());
+        if (bin_file && !stats_snapshot_write_bin(bin_file, end_ns, interval_ns, deltas)) {
+            log_err("Unable to write file: %s", g_snapshot_params.file.c_str());
+            goto out;
+        }
+        if (csv_stream.is_open()) {
+            stats_snapshot_write_csv(csv_stream, end_ns, interval_ns, deltas);
+            csv_stream.flush();
+        }
+        if (g_snapshot_params.top) {
+            stats_snapshot_top(deltas, g_snapshot_params.sort, g_snapshot_params.top);
+            stats_snapshot_print(stdout, interval_ns, deltas);
+            printf(CYCLES_SEPARATOR);
+        }
+        prev.swap(curr);
+        proc_running = check_if_process_running(pid);
+    }
+    if (!proc_running) {
+        log_msg("Proccess %d ended - exiting", pid);
+    }
+
+out:
+    if (bin_file) {
+        fclose(bin_file);
+    }
+}
+
 void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
 {
     int ret;
@@ -1476,6 +2317,7 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
     int printed_line_num = SCREEN_SIZE;
     struct timespec start, end;
     bool proc_running = true;
+    size_t skt_num;
     socket_instance_block_t *prev_instance_blocks;
     socket_instance_block_t *curr_instance_blocks;
     cq_instance_block_t prev_cq_blocks[NUM_OF_SUPPORTED_CQS];
@@ -1484,6 +2326,9 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
     ring_instance_block_t curr_ring_blocks[NUM_OF_SUPPORTED_RINGS];
     entity_context_instance_block_t prev_entctx_blocks[NUM_OF_SUPPORTED_ENTITY_CTX];
     entity_context_instance_block_t curr_entctx_blocks[NUM_OF_SUPPORTED_ENTITY_CTX];
+    poll_group_instance_block_t prev_poll_group_blocks[NUM_OF_SUPPORTED_POLL_GROUPS];
+    poll_group_instance_block_t curr_poll_group_blocks[NUM_OF_SUPPORTED_POLL_GROUPS];
+    lock_instance_block_t prev_lock_blocks[NUM_OF_SUPPORTED_LOCKS];
     bpool_instance_block_t prev_bpool_blocks[NUM_OF_SUPPORTED_BPOOLS];
     bpool_instance_block_t curr_bpool_blocks[NUM_OF_SUPPORTED_BPOOLS];
     global_instance_block_t prev_global_blocks[NUM_OF_SUPPORTED_GLOBALS];
@@ -1501,7 +2346,8 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
             {DUMP_DISABLED, "Unknown"},
             {DUMP_FD, "Fd"},
             {DUMP_ROUTE, "Routing"},
-            {DUMP_NEIGH, "Neighboring"}};
+            {DUMP_NEIGH, "Neighboring"},
+            {DUMP_TRACE, "Trace"}};
 
         const char *name = dump_type_names[user_params.dump] ?: "Unknown";
         log_msg("Dumping %s information to " PRODUCT_NAME " using log level = %s...", name,
@@ -1509,22 +2355,36 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
         return;
     }
 
-    prev_instance_blocks = (socket_instance_block_t *)malloc(sizeof(*prev_instance_blocks) *
-                                                             p_sh_mem->max_skt_inst_num);
+    if (g_tune_params.enabled) {
+        tune_reader_handler(p_sh_mem);
+        return;
+    }
+
+    if (g_mirror_params.enabled) {
+        mirror_reader_handler(pid);
+        return;
+    }
+
+    if (g_snapshot_params.enabled) {
+        snapshot_reader_handler(p_sh_mem, pid);
+        return;
+    }
+
+    skt_num = __atomic_load_n(&p_sh_mem->max_skt_inst_num, __ATOMIC_ACQUIRE);
+    prev_instance_blocks =
+        (socket_instance_block_t *)malloc(sizeof(*prev_instance_blocks) * skt_num);
     if (NULL == prev_instance_blocks) {
         return;
     }
-    curr_instance_blocks = (socket_instance_block_t *)malloc(sizeof(*curr_instance_blocks) *
-                                                             p_sh_mem->max_skt_inst_num);
+    curr_instance_blocks =
+        (socket_instance_block_t *)malloc(sizeof(*curr_instance_blocks) * skt_num);
     if (NULL == curr_instance_blocks) {
         free(prev_instance_blocks);
         return;
     }
 
-    memset((void *)prev_instance_blocks, 0,
-           sizeof(socket_instance_block_t) * p_sh_mem->max_skt_inst_num);
-    memset((void *)curr_instance_blocks, 0,
-           sizeof(socket_instance_block_t) * p_sh_mem->max_skt_inst_num);
+    memset((void *)prev_instance_blocks, 0, sizeof(socket_instance_block_t) * skt_num);
+    memset((void *)curr_instance_blocks, 0, sizeof(socket_instance_block_t) * skt_num);
     memset((void *)prev_cq_blocks, 0, sizeof(cq_instance_block_t) * NUM_OF_SUPPORTED_CQS);
     memset((void *)curr_cq_blocks, 0, sizeof(cq_instance_block_t) * NUM_OF_SUPPORTED_CQS);
     memset((void *)prev_ring_blocks, 0, sizeof(ring_instance_block_t) * NUM_OF_SUPPORTED_RINGS);
@@ -1548,10 +2408,14 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
 
     memcpy((void *)prev_entctx_blocks, (void *)p_sh_mem->ent_ctx_inst_arr,
            NUM_OF_SUPPORTED_ENTITY_CTX * sizeof(entity_context_instance_block_t));
+    memcpy((void *)prev_poll_group_blocks, (void *)p_sh_mem->poll_group_inst_arr,
+           NUM_OF_SUPPORTED_POLL_GROUPS * sizeof(poll_group_instance_block_t));
+    memcpy((void *)prev_lock_blocks, (void *)p_sh_mem->lock_inst_arr,
+           NUM_OF_SUPPORTED_LOCKS * sizeof(lock_instance_block_t));
 
     if (user_params.print_details_mode == e_deltas) {
         memcpy((void *)prev_instance_blocks, (void *)p_sh_mem->skt_inst_arr,
-               p_sh_mem->max_skt_inst_num * sizeof(socket_instance_block_t));
+               skt_num * sizeof(socket_instance_block_t));
         memcpy((void *)prev_cq_blocks, (void *)p_sh_mem->cq_inst_arr,
                NUM_OF_SUPPORTED_CQS * sizeof(cq_instance_block_t));
         memcpy((void *)prev_ring_blocks, (void *)p_sh_mem->ring_inst_arr,
@@ -1581,10 +2445,14 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
             log_system_err("gettime()");
             goto out;
         }
+        if (!grow_instance_blocks(p_sh_mem, &prev_instance_blocks, &curr_instance_blocks,
+                                  skt_num)) {
+            goto out;
+        }
 
         if (user_params.print_details_mode == e_deltas) {
             memcpy((void *)curr_instance_blocks, (void *)p_sh_mem->skt_inst_arr,
-                   p_sh_mem->max_skt_inst_num * sizeof(socket_instance_block_t));
+                   skt_num * sizeof(socket_instance_block_t));
             memcpy((void *)curr_cq_blocks, (void *)p_sh_mem->cq_inst_arr,
                    NUM_OF_SUPPORTED_CQS * sizeof(cq_instance_block_t));
             memcpy((void *)curr_ring_blocks, (void *)p_sh_mem->ring_inst_arr,
@@ -1613,8 +2481,7 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
             NOT_IN_USE(ret);
             break;
         case e_mc_groups:
-            show_mc_group_stats(&p_sh_mem->mc_info, p_sh_mem->skt_inst_arr,
-                                p_sh_mem->max_skt_inst_num);
+            show_mc_group_stats(&p_sh_mem->mc_info, p_sh_mem->skt_inst_arr, skt_num);
             goto out;
             break;
         case e_entctx:
@@ -1623,6 +2490,33 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
             show_entity_context_stats(curr_entctx_blocks, prev_entctx_blocks);
             memcpy((void *)prev_entctx_blocks, (void *)curr_entctx_blocks,
                    NUM_OF_SUPPORTED_ENTITY_CTX * sizeof(entity_context_instance_block_t));
+            break;
+        case e_poll_groups:
+            memcpy((void *)curr_poll_group_blocks, (void *)p_sh_mem->poll_group_inst_arr,
+                   NUM_OF_SUPPORTED_POLL_GROUPS * sizeof(poll_group_instance_block_t));
+            show_poll_group_stats(curr_poll_group_blocks, prev_poll_group_blocks);
+            memcpy((void *)prev_poll_group_blocks, (void *)curr_poll_group_blocks,
+                   NUM_OF_SUPPORTED_POLL_GROUPS * sizeof(poll_group_instance_block_t));
+            break;
+        case e_poll_efficiency:
+            // The deltas mode refreshes the current blocks and rotates them to the previous ones
+            if (user_params.print_details_mode == e_deltas) {
+                print_poll_efficiency_stats(curr_cq_blocks, prev_cq_blocks, curr_ring_blocks,
+                                            prev_ring_blocks);
+            } else {
+                print_poll_efficiency_stats(p_sh_mem->cq_inst_arr, nullptr,
+                                            p_sh_mem->ring_inst_arr, nullptr);
+            }
+            break;
+        case e_lock_contention:
+            if (user_params.print_details_mode == e_deltas) {
+                print_lock_stats(p_sh_mem->lock_inst_arr, prev_lock_blocks);
+                memcpy((void *)prev_lock_blocks, (void *)p_sh_mem->lock_inst_arr,
+                       NUM_OF_SUPPORTED_LOCKS * sizeof(lock_instance_block_t));
+            } else {
+                print_lock_stats(p_sh_mem->lock_inst_arr, nullptr);
+            }
+            break;
         default:
             break;
         }
@@ -1630,7 +2524,7 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
         case e_totals:
             /* coverity[forward_null] */
             num_act_inst =
-                show_socket_stats(p_sh_mem->skt_inst_arr, NULL, p_sh_mem->max_skt_inst_num,
+                show_socket_stats(p_sh_mem->skt_inst_arr, NULL, skt_num,
                                   &printed_line_num, &p_sh_mem->mc_info, pid);
             show_iomux_stats(&p_sh_mem->iomux, NULL, &printed_line_num);
             if (user_params.view_mode == e_full) {
@@ -1642,7 +2536,7 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
             break;
         case e_deltas:
             num_act_inst = show_socket_stats(curr_instance_blocks, prev_instance_blocks,
-                                             p_sh_mem->max_skt_inst_num, &printed_line_num,
+                                             skt_num, &printed_line_num,
                                              &p_sh_mem->mc_info, pid);
             show_iomux_stats(&curr_iomux_blocks, &prev_iomux_blocks, &printed_line_num);
             if (user_params.view_mode == e_full) {
@@ -1652,7 +2546,7 @@ void stats_reader_handler(sh_mem_t *p_sh_mem, int pid)
                 show_global_stats(curr_global_blocks, prev_global_blocks);
             }
             memcpy((void *)prev_instance_blocks, (void *)curr_instance_blocks,
-                   p_sh_mem->max_skt_inst_num * sizeof(socket_instance_block_t));
+                   skt_num * sizeof(socket_instance_block_t));
             memcpy((void *)prev_cq_blocks, (void *)curr_cq_blocks,
                    NUM_OF_SUPPORTED_CQS * sizeof(cq_instance_block_t));
             memcpy((void *)prev_ring_blocks, (void *)curr_ring_blocks,
@@ -1731,9 +2625,15 @@ void clean_inactive_sh_ibj()
     }
     dirent = readdir(dir);
     while (dirent != NULL && !user_params.forbid_cleaning) {
+        char *pid_str = nullptr;
         if (!strncmp("xliostat.", dirent->d_name, module_name_size)) {
+            pid_str = dirent->d_name + pid_offset;
+        } else if (!strncmp("xliomirror.", dirent->d_name, sizeof("xliomirror.") - 1U)) {
+            pid_str = dirent->d_name + sizeof("xliomirror.") - 1U;
+        }
+        if (pid_str) {
             bool proccess_running = false;
-            proccess_running = check_if_process_running(dirent->d_name + pid_offset);
+            proccess_running = check_if_process_running(pid_str);
             if (!proccess_running) {
                 char to_delete[PATH_MAX + 1] = {0};
                 int n = snprintf(to_delete, sizeof(to_delete), "%s/%s",
@@ -1863,6 +2763,8 @@ int update_fds_mask(char *fds_list)
 void zero_socket_stats(socket_stats_t *p_socket_stats)
 {
     memset((void *)&p_socket_stats->counters, 0, sizeof(socket_counters_t));
+    memset(&p_socket_stats->lat_hists, 0, sizeof(lat_hists_t));
+    memset(&p_socket_stats->tcp_loss, 0, sizeof(tcp_loss_stats_t));
 }
 
 void zero_iomux_stats(iomux_stats_t *p_iomux_stats)
@@ -1890,6 +2792,24 @@ void zero_ring_stats(ring_stats_t *p_ring_stats)
     p_ring_stats->n_rx_interrupt_received = 0;
     p_ring_stats->n_rx_interrupt_requests = 0;
     p_ring_stats->n_tx_dropped_wqes = 0;
+    p_ring_stats->n_tx_db_saved = 0;
+    p_ring_stats->n_rx_poll_cqes = 0;
+    p_ring_stats->n_rx_poll_budget_hits = 0;
+    p_ring_stats->n_tx_wqes = 0;
+    p_ring_stats->n_tx_wqes_signaled = 0;
+    p_ring_stats->n_tx_odp_pkt_count = 0;
+    p_ring_stats->n_tx_odp_byte_count = 0;
+    p_ring_stats->n_tx_doorbells = 0;
+    p_ring_stats->n_tx_bf_wqes = 0;
+    p_ring_stats->n_tx_mpwqe_sessions = 0;
+    p_ring_stats->n_tx_mpwqe_pkts = 0;
+    p_ring_stats->n_rx_cq_moderation_gap_usec = 0;
+    p_ring_stats->n_rx_cq_moderation_burst = 0;
+    p_ring_stats->n_rx_cq_moderation_target_frames = 0;
+    p_ring_stats->n_rx_cq_moderation_decisions = 0;
+    p_ring_stats->n_bond_failovers = 0;
+    p_ring_stats->n_bond_failover_usec = 0;
+    p_ring_stats->n_numa_cross_allocs = 0;
     p_ring_stats->n_tx_num_bufs = 0;
     p_ring_stats->n_zc_num_bufs = 0;
 #ifdef DEFINED_UTLS
@@ -1900,14 +2820,25 @@ void zero_ring_stats(ring_stats_t *p_ring_stats)
     p_ring_stats->n_rx_tls_auth_fail = 0;
 #endif /* DEFINED_UTLS */
     p_ring_stats->n_rx_zc_migiration_drop = 0;
+    p_ring_stats->n_rx_filter_drops = 0;
+    p_ring_stats->n_rx_filter_redirects = 0;
+    p_ring_stats->n_rx_steering_rule_fails = 0;
     p_ring_stats->n_tx_dev_mem_byte_count = 0;
     p_ring_stats->n_tx_dev_mem_pkt_count = 0;
     p_ring_stats->n_tx_dev_mem_oob = 0;
+    memset(&p_ring_stats->lat_hists, 0, sizeof(lat_hists_t));
+    memset(&p_ring_stats->tcp_loss, 0, sizeof(tcp_loss_stats_t));
 }
 
 void zero_cq_stats(cq_stats_t *p_cq_stats)
 {
+    // The striding RQ geometry is not a counter
+    uint32_t stride_size = p_cq_stats->n_rx_stride_size;
+    uint32_t strides_per_rwqe = p_cq_stats->n_rx_strides_per_rwqe;
+
     memset(p_cq_stats, 0, sizeof(*p_cq_stats));
+    p_cq_stats->n_rx_stride_size = stride_size;
+    p_cq_stats->n_rx_strides_per_rwqe = strides_per_rwqe;
 }
 
 void zero_ent_ctx_stats(entity_context_stats_t *p_ent_ctx_stats)
@@ -1915,10 +2846,20 @@ void zero_ent_ctx_stats(entity_context_stats_t *p_ent_ctx_stats)
     memset(p_ent_ctx_stats, 0, sizeof(*p_ent_ctx_stats));
 }
 
+void zero_poll_group_stats(poll_group_stats_t *p_poll_group_stats)
+{
+    uint32_t n_sockets = p_poll_group_stats->n_sockets;
+
+    memset(p_poll_group_stats, 0, sizeof(*p_poll_group_stats));
+    p_poll_group_stats->n_sockets = n_sockets;
+}
+
 void zero_bpool_stats(bpool_stats_t *p_bpool_stats)
 {
     p_bpool_stats->n_buffer_pool_size = 0;
     p_bpool_stats->n_buffer_pool_no_bufs = 0;
+    p_bpool_stats->n_buffer_pool_cache_hits = 0;
+    p_bpool_stats->n_buffer_pool_cache_misses = 0;
 }
 
 void zero_counters(sh_mem_t *p_sh_mem)
@@ -1941,6 +2882,12 @@ void zero_counters(sh_mem_t *p_sh_mem)
     for (int i = 0; i < NUM_OF_SUPPORTED_BPOOLS; i++) {
         zero_bpool_stats(&p_sh_mem->bpool_inst_arr[i].bpool_stats);
     }
+    for (int i = 0; i < NUM_OF_SUPPORTED_POLL_GROUPS; i++) {
+        zero_poll_group_stats(&p_sh_mem->poll_group_inst_arr[i].poll_group_stats);
+    }
+    for (int i = 0; i < NUM_OF_SUPPORTED_LOCKS; i++) {
+        memset(&p_sh_mem->lock_inst_arr[i].lock_stats, 0, sizeof(lock_stats_t));
+    }
 }
 
 int get_pid(char *proc_desc, char *argv0)
@@ -2004,6 +2951,7 @@ void set_xlio_log_details_level(sh_mem_t *p_sh_mem)
 //////////////////forward declarations /////////////////////////////
 void get_all_processes_pids(std::vector<int> &pids);
 int print_processes_stats(const std::vector<int> &pids);
+int export_processes_stats();
 
 ////////////////////////////////////////////////////////////////////
 int main(int argc, char **argv)
@@ -2037,9 +2985,17 @@ int main(int argc, char **argv)
                                                {"forbid_clean", 0, NULL, 'F'},
                                                {"help", 0, NULL, 'h'},
                                                {"csv_file", 1, NULL, 'C'},
+                                               {"exporter", 1, NULL, 'e'},
+                                               {"top", 1, NULL, 0},
+                                               {"sort", 1, NULL, 0},
+                                               {"snapshot_file", 1, NULL, 0},
+                                               {"snapshot_format", 1, NULL, 0},
+                                               {"tune", 1, NULL, 0},
+                                               {"mirror", 1, NULL, 0},
+                                               {"mirror_filter", 1, NULL, 0},
                                                {0, 0, 0, 0}};
 
-        if ((c = getopt_long(argc, argv, "i:c:v:d:p:k:s:Vzl:S:C:D:n:fFh?", long_options,
+        if ((c = getopt_long(argc, argv, "i:c:v:d:p:k:s:Vzl:S:C:D:n:e:fFh?", long_options,
                              &option_index)) == -1) {
             break;
         }
@@ -2053,12 +3009,70 @@ int main(int argc, char **argv)
                     user_params.dump = DUMP_ROUTE;
                 } else if (strcasecmp("neigh", optarg) == 0) {
                     user_params.dump = DUMP_NEIGH;
+                } else if (strcasecmp("trace", optarg) == 0) {
+                    user_params.dump = DUMP_TRACE;
                 } else {
                     log_err("'--dump' Invalid argument: %s", optarg);
                     usage(argv[0]);
                     cleanup(NULL);
                     return 1;
                 }
+            } else if (strcmp("top", long_options[option_index].name) == 0) {
+                errno = 0;
+                int top = strtol(optarg, NULL, 0);
+                if (errno != 0 || top < 0) {
+                    log_err("'--top' Invalid argument: %s", optarg);
+                    usage(argv[0]);
+                    cleanup(NULL);
+                    return 1;
+                }
+                g_snapshot_params.enabled = true;
+                g_snapshot_params.top = top;
+            } else if (strcmp("sort", long_options[option_index].name) == 0) {
+                if (strcasecmp("rx_pps", optarg) == 0) {
+                    g_snapshot_params.sort = SNAPSHOT_SORT_RX_PPS;
+                } else if (strcasecmp("drops", optarg) == 0) {
+                    g_snapshot_params.sort = SNAPSHOT_SORT_DROPS;
+                } else if (strcasecmp("retrans", optarg) == 0) {
+                    g_snapshot_params.sort = SNAPSHOT_SORT_RETRANS;
+                } else {
+                    log_err("'--sort' Invalid argument: %s", optarg);
+                    usage(argv[0]);
+                    cleanup(NULL);
+                    return 1;
+                }
+                g_snapshot_params.enabled = true;
+            } else if (strcmp("snapshot_file", long_options[option_index].name) == 0) {
+                g_snapshot_params.enabled = true;
+                g_snapshot_params.file = optarg;
+            } else if (strcmp("snapshot_format", long_options[option_index].name) == 0) {
+                if (strcasecmp("csv", optarg) == 0) {
+                    g_snapshot_params.format = SNAPSHOT_FORMAT_CSV;
+                } else if (strcasecmp("bin", optarg) == 0) {
+                    g_snapshot_params.format = SNAPSHOT_FORMAT_BIN;
+                } else {
+                    log_err("'--snapshot_format' Invalid argument: %s", optarg);
+                    usage(argv[0]);
+                    cleanup(NULL);
+                    return 1;
+                }
+            } else if (strcmp("tune", long_options[option_index].name) == 0) {
+                if (!parse_tune_arg(optarg)) {
+                    log_err("'--tune' Invalid argument: %s", optarg);
+                    usage(argv[0]);
+                    cleanup(NULL);
+                    return 1;
+                }
+            } else if (strcmp("mirror", long_options[option_index].name) == 0) {
+                g_mirror_params.enabled = true;
+                g_mirror_params.file = optarg;
+            } else if (strcmp("mirror_filter", long_options[option_index].name) == 0) {
+                if (!stats_mirror_parse_filter(optarg, g_mirror_params.filter)) {
+                    log_err("'--mirror_filter' Invalid argument: %s", optarg);
+                    usage(argv[0]);
+                    cleanup(NULL);
+                    return 1;
+                }
             }
         } break;
         case 'i': {
@@ -2193,6 +3207,9 @@ int main(int argc, char **argv)
         case 'f':
             user_params.proc_ident_mode = e_by_runn_proccess;
             break;
+        case 'e':
+            user_params.exporter_addr = optarg;
+            break;
         case 'F':
             user_params.forbid_cleaning = true;
             break;
@@ -2210,6 +3227,12 @@ int main(int argc, char **argv)
 
     clean_inactive_sh_ibj();
 
+    if (!user_params.exporter_addr.empty()) {
+        int ret = export_processes_stats();
+        free(g_fd_mask);
+        return ret;
+    }
+
     std::vector<int> pids;
     if (user_params.view_mode == e_netstat_like) {
         get_all_processes_pids(pids);
@@ -2298,7 +3321,8 @@ int init_print_process_stats(sh_mem_info_t &sh_mem_info)
         return 1;
     }
 
-    sh_mem_info.shmem_size = SHMEM_STATS_SIZE(sh_mem->max_skt_inst_num);
+    // The whole file is mapped, the publisher grows max_skt_inst_num within it
+    sh_mem_info.shmem_size = SHMEM_STATS_SIZE(sh_mem->max_skt_inst_limit);
     if (munmap(sh_mem_info.p_sh_stats, sizeof(sh_mem_t)) != 0) {
         log_system_err(
             "file='%s' sh_mem_info.fd_sh_stats=%d; error while munmap shared memory at [%p]\n",
@@ -2318,7 +3342,7 @@ int init_print_process_stats(sh_mem_info_t &sh_mem_info)
         return 1;
     }
     MAP_SH_MEM(sh_mem, sh_mem_info.p_sh_stats);
-    if (user_params.view_mode != e_netstat_like) {
+    if (user_params.view_mode != e_netstat_like && user_params.exporter_addr.empty()) {
         print_version(pid);
     }
     if (user_params.zero_counters == true) {
@@ -2333,6 +3357,9 @@ int init_print_process_stats(sh_mem_info_t &sh_mem_info)
     if (user_params.dump != DUMP_DISABLED) {
         set_dumping_data(sh_mem);
     }
+    if (g_tune_params.enabled) {
+        set_tune_request(sh_mem);
+    }
 
     // here we indicate XLIO to write to shmem
     inc_read_counter(sh_mem);
@@ -2408,6 +3435,63 @@ int print_processes_stats(const std::vector<int> &pids)
     return 0;
 }
 
+///////////////////////////
+int export_processes_stats()
+{
+    std::map<int, sh_mem_info_t> sh_mem_infos;
+    // Processes with an incompatible or missing shared memory aren't retried
+    std::set<int> skipped_pids;
+
+    auto refresh = [&sh_mem_infos, &skipped_pids]() {
+        for (auto iter = sh_mem_infos.begin(); iter != sh_mem_infos.end();) {
+            if (!check_if_process_running(iter->first)) {
+                cleanup(&iter->second);
+                iter = sh_mem_infos.erase(iter);
+            } else {
+                inc_read_counter((sh_mem_t *)iter->second.p_sh_stats);
+                ++iter;
+            }
+        }
+
+        std::vector<int> pids;
+        get_all_processes_pids(pids);
+        for (int pid : pids) {
+            if (sh_mem_infos.count(pid) || skipped_pids.count(pid)) {
+                continue;
+            }
+            sh_mem_info_t sh_mem_info;
+            sh_mem_info.pid = pid;
+            if (init_print_process_stats(sh_mem_info)) {
+                skipped_pids.insert(pid);
+            } else {
+                sh_mem_infos.emplace(pid, sh_mem_info);
+            }
+        }
+    };
+
+    auto collect = [&sh_mem_infos](std::ostream &out) {
+        std::vector<stats_exporter_process> procs;
+        char app_name[FILE_NAME_MAX_SIZE];
+
+        for (auto &entry : sh_mem_infos) {
+            if (get_procname(entry.first, app_name, sizeof(app_name)) < 0) {
+                app_name[0] = '\0';
+            }
+            procs.push_back({entry.first, app_name, (sh_mem_t *)entry.second.p_sh_stats});
+        }
+        stats_exporter_write(out, procs);
+    };
+
+    set_signal_action();
+    log_msg("Serving OpenMetrics on %s/metrics", user_params.exporter_addr.c_str());
+    int ret = stats_exporter_serve(user_params.exporter_addr, refresh, collect, &g_b_exit);
+
+    for (auto &entry : sh_mem_infos) {
+        cleanup(&entry.second);
+    }
+    return ret;
+}
+
 ///////////////////////////
 void cpu_stats::capture()
 {
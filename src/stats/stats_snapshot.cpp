@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "stats/stats_snapshot.h"
+
+stats_snapshot::~stats_snapshot()
+{
+    free(m_p_region);
+}
+
+bool stats_snapshot::take(const sh_mem_t *p_sh_mem)
+{
+    size_t skt_num = __atomic_load_n(&p_sh_mem->max_skt_inst_num, __ATOMIC_ACQUIRE);
+    size_t size = SHMEM_STATS_SIZE(skt_num);
+
+    if (size > m_size) {
+        void *p = realloc((void *)m_p_region, size);
+        if (!p) {
+            return false;
+        }
+        m_p_region = static_cast<sh_mem_t *>(p);
+        m_size = size;
+    }
+    memcpy((void *)m_p_region, (const void *)p_sh_mem, size);
+    m_skt_num = skt_num;
+    return true;
+}
+
+void stats_snapshot::swap(stats_snapshot &other)
+{
+    std::swap(m_p_region, other.m_p_region);
+    std::swap(m_size, other.m_size);
+    std::swap(m_skt_num, other.m_skt_num);
+}
+
+// The 32 bit counters wrap around, the 64 bit ones only go back when the block is zeroed
+static inline uint64_t delta32(uint32_t curr, uint32_t prev)
+{
+    return static_cast<uint32_t>(curr - prev);
+}
+
+static inline uint64_t delta64(uint64_t curr, uint64_t prev)
+{
+    return curr >= prev ? curr - prev : curr;
+}
+
+void stats_snapshot_diff(const stats_snapshot &prev, const stats_snapshot &curr,
+                         std::vector<snapshot_socket_delta_t> &deltas)
+{
+    static const socket_counters_t zero_counters = {};
+
+    deltas.clear();
+    if (!curr.region()) {
+        return;
+    }
+
+    for (size_t i = 0; i < curr.socket_num(); ++i) {
+        const socket_instance_block_t &block = curr.region()->skt_inst_arr[i];
+        const socket_stats_t &stats = block.skt_stats;
+        if (!block.b_enabled || !stats.b_is_offloaded) {
+            continue;
+        }
+
+        const socket_counters_t *p_prev = &zero_counters;
+        if (prev.region() && i < prev.socket_num()) {
+            const socket_instance_block_t &prev_block = prev.region()->skt_inst_arr[i];
+            if (prev_block.b_enabled && prev_block.skt_stats.fd == stats.fd &&
+                prev_block.skt_stats.inode == stats.inode) {
+                p_prev = &prev_block.skt_stats.counters;
+            }
+        }
+        const socket_counters_t &c = stats.counters;
+        const socket_counters_t &p = *p_prev;
+
+        snapshot_socket_delta_t delta;
+        memset(&delta, 0, sizeof(delta));
+        delta.fd = stats.fd;
+        delta.inode = stats.inode;
+        delta.socket_type = stats.socket_type;
+        delta.sa_family = stats.sa_family;
+        delta.bound_port = stats.bound_port;
+        delta.connected_port = stats.connected_port;
+        memcpy(delta.bound_ip, &stats.bound_if.get_in6_addr(), sizeof(delta.bound_ip));
+        memcpy(delta.connected_ip, &stats.connected_ip.get_in6_addr(), sizeof(delta.connected_ip));
+        delta.rx_packets = delta32(c.n_rx_packets, p.n_rx_packets);
+        delta.rx_bytes = delta64(c.n_rx_bytes, p.n_rx_bytes);
+        delta.tx_packets = delta32(c.n_tx_sent_pkt_count, p.n_tx_sent_pkt_count);
+        delta.tx_bytes = delta64(c.n_tx_sent_byte_count, p.n_tx_sent_byte_count);
+        delta.drops = delta32(c.n_rx_ready_pkt_drop, p.n_rx_ready_pkt_drop) +
+            delta32(c.n_rx_errors, p.n_rx_errors) + delta32(c.n_tx_errors, p.n_tx_errors);
+        delta.retrans = delta32(c.n_tx_retransmits, p.n_tx_retransmits) +
+            delta32(c.n_tx_sack_retransmits, p.n_tx_sack_retransmits);
+        deltas.push_back(delta);
+    }
+}
+
+static uint64_t sort_key(const snapshot_socket_delta_t &delta, snapshot_sort_t sort)
+{
+    switch (sort) {
+    case SNAPSHOT_SORT_DROPS:
+        return delta.drops;
+    case SNAPSHOT_SORT_RETRANS:
+        return delta.retrans;
+    case SNAPSHOT_SORT_RX_PPS:
+    default:
+        return delta.rx_packets;
+    }
+}
+
+void stats_snapshot_top(std::vector<snapshot_socket_delta_t> &deltas, snapshot_sort_t sort,
+                        size_t top)
+{
+    auto greater = [sort](const snapshot_socket_delta_t &a, const snapshot_socket_delta_t &b) {
+        uint64_t key_a = sort_key(a, sort);
+        uint64_t key_b = sort_key(b, sort);
+        return key_a != key_b ? key_a > key_b : a.fd < b.fd;
+    };
+
+    top = std::min(top, deltas.size());
+    std::partial_sort(deltas.begin(), deltas.begin() + top, deltas.end(), greater);
+    deltas.resize(top);
+}
+
+static std::string addr_str(const uint8_t *raw, uint16_t sa_family, uint16_t port)
+{
+    in6_addr addr;
+
+    memcpy(&addr, raw, sizeof(addr));
+    return ip_address(addr).to_str(sa_family) + ":" + std::to_string(ntohs(port));
+}
+
+static const char *socket_type_str(uint8_t socket_type)
+{
+    return socket_type == SOCK_STREAM ? "TCP" : (socket_type == SOCK_DGRAM ? "UDP" : "RAW");
+}
+
+void stats_snapshot_write_csv_header(std::ostream &out)
+{
+    out << "Timestamp[ns],Interval[ns],Fd,Inode,Type,Local,Peer,RxPackets,RxBytes,TxPackets,"
+           "TxBytes,Drops,Retransmits\n";
+}
+
+void stats_snapshot_write_csv(std::ostream &out, uint64_t timestamp_ns, uint64_t interval_ns,
+                              const std::vector<snapshot_socket_delta_t> &deltas)
+{
+    for (const snapshot_socket_delta_t &delta : deltas) {
+        out << timestamp_ns << ',' << interval_ns << ',' << delta.fd << ',' << delta.inode << ','
+            << socket_type_str(delta.socket_type) << ','
+            << addr_str(delta.bound_ip, delta.sa_family, delta.bound_port) << ','
+            << addr_str(delta.connected_ip, delta.sa_family, delta.connected_port) << ','
+            << delta.rx_packets << ',' << delta.rx_bytes << ',' << delta.tx_packets << ','
+            << delta.tx_bytes << ',' << delta.drops << ',' << delta.retrans << '\n';
+    }
+}
+
+bool stats_snapshot_write_bin_header(FILE *file, int pid)
+{
+    snapshot_file_header_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_FILE_VERSION;
+    header.record_size = sizeof(snapshot_socket_delta_t);
+    header.pid = pid;
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool stats_snapshot_write_bin(FILE *file, uint64_t timestamp_ns, uint64_t interval_ns,
+                              const std::vector<snapshot_socket_delta_t> &deltas)
+{
+    snapshot_file_interval_t interval;
+
+    memset(&interval, 0, sizeof(interval));
+    interval.timestamp_ns = timestamp_ns;
+    interval.interval_ns = interval_ns;
+    interval.num_sockets = static_cast<uint32_t>(deltas.size());
+    return fwrite(&interval, sizeof(interval), 1, file) == 1 &&
+        (deltas.empty() ||
+         fwrite(deltas.data(), sizeof(snapshot_socket_delta_t), deltas.size(), file) ==
+             deltas.size());
+}
+
+void stats_snapshot_print(FILE *out, uint64_t interval_ns,
+                          const std::vector<snapshot_socket_delta_t> &deltas)
+{
+    double seconds = interval_ns ? interval_ns / 1e9 : 1.0;
+
+    fprintf(out, "%-6s %-4s %-47s %-47s %10s %10s %10s %10s %9s %9s\n", "fd", "type", "local",
+            "peer", "rx pps", "rx Mbps", "tx pps", "tx Mbps", "drops/s", "retrans/s");
+    for (const snapshot_socket_delta_t &delta : deltas) {
+        fprintf(out, "%-6d %-4s %-47s %-47s %10.0f %10.2f %10.0f %10.2f %9.0f %9.0f\n", delta.fd,
+                socket_type_str(delta.socket_type),
+                addr_str(delta.bound_ip, delta.sa_family, delta.bound_port).c_str(),
+                addr_str(delta.connected_ip, delta.sa_family, delta.connected_port).c_str(),
+                delta.rx_packets / seconds, delta.rx_bytes * 8 / seconds / 1e6,
+                delta.tx_packets / seconds, delta.tx_bytes * 8 / seconds / 1e6,
+                delta.drops / seconds, delta.retrans / seconds);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#ifndef STATS_SNAPSHOT_H
+#define STATS_SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "core/util/xlio_stats.h"
+
+/*
+ * The sampling mode of xlio_stats: the shared memory is copied with a single memcpy per interval
+ * and the socket deltas are computed from the copies, so the reader doesn't touch the counters
+ * of the writer field by field.
+ *
+ * The layout of the binary snapshot file, all the fields are in the host byte order:
+ *   snapshot_file_header_t, then per interval a snapshot_file_interval_t followed by its
+ *   snapshot_socket_delta_t records.
+ */
+#define SNAPSHOT_FILE_MAGIC   "XLIOSNP1"
+#define SNAPSHOT_FILE_VERSION 1U
+
+enum snapshot_sort_t { SNAPSHOT_SORT_RX_PPS, SNAPSHOT_SORT_DROPS, SNAPSHOT_SORT_RETRANS };
+
+enum snapshot_format_t { SNAPSHOT_FORMAT_CSV, SNAPSHOT_FORMAT_BIN };
+
+struct snapshot_params_t {
+    bool enabled;
+    size_t top; // Sockets printed per interval
+    snapshot_sort_t sort;
+    snapshot_format_t format;
+    std::string file;
+};
+
+struct snapshot_socket_delta_t {
+    int32_t fd;
+    uint32_t inode;
+    uint8_t socket_type;
+    uint8_t reserved;
+    uint16_t sa_family;
+    uint16_t bound_port; // Network byte order as in the socket stats
+    uint16_t connected_port;
+    uint8_t bound_ip[16];
+    uint8_t connected_ip[16];
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_bytes;
+    uint64_t drops; // RX ready queue drops and RX and TX errors
+    uint64_t retrans; // Retransmits, including the SACK ones
+};
+
+struct snapshot_file_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size; // sizeof(snapshot_socket_delta_t)
+    int32_t pid;
+    uint32_t reserved;
+};
+
+struct snapshot_file_interval_t {
+    uint64_t timestamp_ns; // CLOCK_REALTIME at the end of the interval
+    uint64_t interval_ns;
+    uint32_t num_sockets;
+    uint32_t reserved;
+};
+
+// A copy of the whole shared memory region, taken with a single memcpy
+class stats_snapshot {
+public:
+    stats_snapshot() = default;
+    ~stats_snapshot();
+    stats_snapshot(const stats_snapshot &) = delete;
+    stats_snapshot &operator=(const stats_snapshot &) = delete;
+
+    // Copies the region with the socket blocks allocated by the publisher, false on ENOMEM
+    bool take(const sh_mem_t *p_sh_mem);
+    void swap(stats_snapshot &other);
+
+    const sh_mem_t *region() const { return m_p_region; }
+    size_t socket_num() const { return m_skt_num; }
+
+private:
+    sh_mem_t *m_p_region = nullptr;
+    size_t m_size = 0U;
+    size_t m_skt_num = 0U;
+};
+
+/*
+ * Fills deltas with the counters of the offloaded sockets enabled in curr minus the ones in prev.
+ * A block reused by another socket or zeroed meanwhile counts from 0.
+ */
+void stats_snapshot_diff(const stats_snapshot &prev, const stats_snapshot &curr,
+                         std::vector<snapshot_socket_delta_t> &deltas);
+
+// Keeps the top sockets by the sort key, in the descending order
+void stats_snapshot_top(std::vector<snapshot_socket_delta_t> &deltas, snapshot_sort_t sort,
+                        size_t top);
+
+void stats_snapshot_write_csv_header(std::ostream &out);
+void stats_snapshot_write_csv(std::ostream &out, uint64_t timestamp_ns, uint64_t interval_ns,
+                              const std::vector<snapshot_socket_delta_t> &deltas);
+// Returns false on a write error
+bool stats_snapshot_write_bin_header(FILE *file, int pid);
+bool stats_snapshot_write_bin(FILE *file, uint64_t timestamp_ns, uint64_t interval_ns,
+                              const std::vector<snapshot_socket_delta_t> &deltas);
+
+// The per second rates of the top sockets, as a table
+void stats_snapshot_print(FILE *out, uint64_t interval_ns,
+                          const std::vector<snapshot_socket_delta_t> &deltas);
+
+#endif /* STATS_SNAPSHOT_H */
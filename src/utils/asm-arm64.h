@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <unistd.h>
+#include <sys/auxv.h>
 
 #define COPY_64B_NT(dst, src)                                                                      \
     *dst++ = *src++;                                                                               \
@@ -57,6 +58,22 @@ static inline void gettimeoftsc(unsigned long long *p_tscval)
     asm volatile("mrs %0, cntvct_el0" : "=r"((unsigned long long)*p_tscval));
 }
 
+/**
+ * Spin loop hint
+ */
+static inline void cpu_relax(void)
+{
+    asm volatile("yield" ::: "memory");
+}
+
+/**
+ * CRC32 instructions of ARMv8.0, optional before ARMv8.1
+ */
+static inline bool cpu_has_crc32c(void)
+{
+    return getauxval(AT_HWCAP) & (1UL << 7); // HWCAP_CRC32
+}
+
 /**
  * Cache Line Prefetch - Arch specific!
  */
@@ -63,6 +63,14 @@ static inline void gettimeoftsc(unsigned long long *p_tscval)
     asm volatile("mftb %0" : "=r"(*p_tscval) :);
 }
 
+/**
+ * Spin loop hint, low and back to medium SMT priority
+ */
+static inline void cpu_relax(void)
+{
+    asm volatile("or 1,1,1\n\tor 2,2,2" ::: "memory");
+}
+
 /**
  * Cache Line Prefetch - Arch specific!
  */
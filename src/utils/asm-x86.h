@@ -98,6 +98,58 @@ static inline void gettimeoftsc(unsigned long long *p_tscval)
     *p_tscval = (((unsigned long long)upper_32) << 32) | lower_32;
 }
 
+/**
+ * Spin loop hint
+ */
+static inline void cpu_relax(void)
+{
+    __asm__ __volatile__("pause" ::: "memory");
+}
+
+/**
+ * WAITPKG support (UMONITOR, UMWAIT, TPAUSE), CPUID.(EAX=7,ECX=0):ECX[bit 5]
+ */
+static inline bool cpu_has_waitpkg(void)
+{
+    uint32_t _eax = 0, _ebx, _ecx = 0, _edx;
+
+    __asm__ __volatile__("cpuid" : "+a"(_eax), "=b"(_ebx), "+c"(_ecx), "=d"(_edx));
+    if (_eax < 7) {
+        return false;
+    }
+    _eax = 7;
+    _ecx = 0;
+    __asm__ __volatile__("cpuid" : "+a"(_eax), "=b"(_ebx), "+c"(_ecx), "=d"(_edx));
+    return (_ecx >> 5) & 0x1;
+}
+
+/**
+ * AVX2 and SSE4.2 (CRC32) support, including the OS support of the YMM state
+ */
+static inline bool cpu_has_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static inline bool cpu_has_crc32c(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+/**
+ * Light sleep in C0.2 until the TSC deadline or an interrupt, requires WAITPKG.
+ * TPAUSE %ecx is encoded as bytes for the assemblers without WAITPKG.
+ */
+static inline void cpu_tpause(unsigned long long tsc_deadline)
+{
+    __asm__ __volatile__(".byte 0x66, 0x0f, 0xae, 0xf1"
+                         :
+                         : "c"(0), "a"((uint32_t)tsc_deadline), "d"((uint32_t)(tsc_deadline >> 32))
+                         : "memory", "cc");
+}
+
 /**
  * Cache Line Prefetch - Arch specific!
  */
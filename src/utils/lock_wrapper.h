@@ -19,6 +19,7 @@
 #include <functional>
 #include <vlogger/vlogger.h>
 #include <core/util/sys_vars.h>
+#include <core/util/lock_prof.h>
 
 // todo disable assert
 #define ASSERT_LOCKED(lock)     assert((lock).is_locked_by_me())
@@ -61,6 +62,9 @@ public:
 
     const char *to_str() { return m_lock_name; }
 
+protected:
+    int m_prof_id = LOCK_PROF_ID_UNSET; // Index of the name in the contention profiler
+
 private:
     const char *m_lock_name;
 };
@@ -122,6 +126,8 @@ private:
     tscval_t m_print_interval;
 
 protected:
+    int m_prof_id = LOCK_PROF_ID_UNSET; // Index of the name in the contention profiler
+
     tscval_t start_lock_wait()
     {
         tscval_t t;
@@ -162,7 +168,9 @@ public:
     inline int lock()
     {
         LOCK_BASE_START_LOCK_WAIT
-        int ret = pthread_spin_lock(&m_lock);
+        int ret = likely(!lock_prof_enabled())
+            ? pthread_spin_lock(&m_lock)
+            : lock_prof_lock(pthread_spin_trylock, pthread_spin_lock, &m_lock, to_str(), m_prof_id);
         LOCK_BASE_LOCK
         LOCK_BASE_END_LOCK_WAIT
         return ret;
@@ -170,6 +178,9 @@ public:
     inline int trylock()
     {
         int ret = pthread_spin_trylock(&m_lock);
+        if (unlikely(lock_prof_enabled())) {
+            lock_prof_trylock(ret, to_str(), m_prof_id);
+        }
         LOCK_BASE_TRYLOCK
         return ret;
     };
@@ -291,7 +302,10 @@ public:
     inline int lock()
     {
         LOCK_BASE_START_LOCK_WAIT
-        int ret = pthread_mutex_lock(&m_lock);
+        int ret = likely(!lock_prof_enabled())
+            ? pthread_mutex_lock(&m_lock)
+            : lock_prof_lock(pthread_mutex_trylock, pthread_mutex_lock, &m_lock, to_str(),
+                             m_prof_id);
         LOCK_BASE_LOCK
         LOCK_BASE_END_LOCK_WAIT
         return ret;
@@ -299,6 +313,9 @@ public:
     inline int trylock()
     {
         int ret = pthread_mutex_trylock(&m_lock);
+        if (unlikely(lock_prof_enabled())) {
+            lock_prof_trylock(ret, to_str(), m_prof_id);
+        }
         LOCK_BASE_TRYLOCK
         return ret;
     };
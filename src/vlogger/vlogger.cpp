@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
 
 #include "utils/bullseye.h"
 #include "core/util/utils.h"
@@ -22,6 +24,11 @@
 #define VLOG_DEFAULT_MODULE_NAME "XLIO"
 #define XLIO_LOG_CB_ENV_VAR      "XLIO_LOG_CB_FUNC_PTR"
 
+#define VLOG_ASYNC_RING_SIZE  128U // Records per thread, power of 2
+#define VLOG_ASYNC_IDLE_USEC  1000U
+#define VLOG_RATE_LIMIT_SITES 256U // Power of 2
+#define VLOG_CACHE_LINE_SIZE  64U
+
 char g_vlogger_module_name[VLOG_MODULE_MAX_LEN] = VLOG_DEFAULT_MODULE_NAME;
 int g_vlogger_fd = -1;
 FILE *g_vlogger_file = NULL;
@@ -32,6 +39,55 @@ uint8_t *g_p_vlogger_details = NULL;
 uint32_t g_vlogger_usec_on_startup = 0;
 bool g_vlogger_log_in_colors = MCE_DEFAULT_LOG_COLORS;
 xlio_log_cb_t g_vlogger_cb = NULL;
+uint32_t g_vlogger_rate_limit = 0U;
+uint64_t g_vlogger_dropped = 0U;
+uint64_t g_vlogger_suppressed = 0U;
+
+// A record formatted by its thread and written out by the drain thread
+struct vlog_record {
+    vlog_levels_t level;
+    char buf[VLOGGER_STR_SIZE];
+};
+
+// Single producer (the owning thread) and single consumer (the drain thread) ring.
+// The ring of an exited thread is drained and then reused by a new thread.
+struct vlog_ring {
+    uint32_t head; // Written by the producer
+    char pad_head[VLOG_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    uint32_t tail; // Written by the consumer
+    char pad_tail[VLOG_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    bool in_use;
+    vlog_ring *next;
+    vlog_record records[VLOG_ASYNC_RING_SIZE];
+};
+
+struct vlog_thread_ring {
+    vlog_ring *ring = nullptr;
+    ~vlog_thread_ring()
+    {
+        if (ring) {
+            __atomic_store_n(&ring->in_use, false, __ATOMIC_RELEASE);
+        }
+    }
+};
+
+// Budget of a call site, keyed by its format string, in the current second
+struct vlog_site {
+    const char *fmt;
+    uint32_t second;
+    uint32_t count;
+};
+
+static thread_local vlog_thread_ring s_vlog_thread_ring;
+// The rings are never freed, a forked child finds the rings of its parent in the list
+static vlog_ring *s_vlog_rings = nullptr;
+static bool s_vlog_async = false;
+static bool s_vlog_drain_stop = false;
+static pid_t s_vlog_drain_pid = 0;
+static pthread_t s_vlog_drain_tid;
+static uint64_t s_vlog_dropped_reported = 0U;
+static uint64_t s_vlog_suppressed_reported = 0U;
+static vlog_site s_vlog_sites[VLOG_RATE_LIMIT_SITES];
 
 namespace log_level {
 typedef struct {
@@ -206,8 +262,203 @@ static xlio_log_cb_t xlio_log_get_cb_func()
     return log_cb;
 }
 
+static void vlog_write(const char *buf, bool flush)
+{
+    FILE *file = g_vlogger_file ? g_vlogger_file : stderr;
+
+    fprintf(file, "%s", buf);
+    if (flush) {
+        fflush(file);
+    }
+}
+
+static vlog_ring *vlog_get_thread_ring()
+{
+    vlog_ring *ring = s_vlog_thread_ring.ring;
+
+    if (likely(ring)) {
+        return ring;
+    }
+
+    // Take over the ring of an exited thread first
+    for (ring = __atomic_load_n(&s_vlog_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        bool in_use = false;
+        if (!__atomic_load_n(&ring->in_use, __ATOMIC_RELAXED) &&
+            __atomic_compare_exchange_n(&ring->in_use, &in_use, true, false, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            s_vlog_thread_ring.ring = ring;
+            return ring;
+        }
+    }
+
+    ring = static_cast<vlog_ring *>(calloc(1, sizeof(vlog_ring)));
+    if (!ring) {
+        return nullptr;
+    }
+    ring->in_use = true;
+    ring->next = __atomic_load_n(&s_vlog_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&s_vlog_rings, &ring->next, ring, true, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED)) {
+    }
+    s_vlog_thread_ring.ring = ring;
+    return ring;
+}
+
+// Hands a formatted record over to the drain thread. Returns false if the record must be
+// written by the calling thread. A record which doesn't fit the ring is dropped and counted.
+static bool vlog_async_output(vlog_levels_t log_level, const char *buf)
+{
+    if (!__atomic_load_n(&s_vlog_async, __ATOMIC_RELAXED) || log_level <= VLOG_PANIC) {
+        return false;
+    }
+
+    vlog_ring *ring = vlog_get_thread_ring();
+    if (unlikely(!ring)) {
+        return false;
+    }
+
+    uint32_t head = ring->head;
+    if (unlikely(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= VLOG_ASYNC_RING_SIZE)) {
+        __atomic_add_fetch(&g_vlogger_dropped, 1U, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    vlog_record &record = ring->records[head & (VLOG_ASYNC_RING_SIZE - 1U)];
+    size_t len = strnlen(buf, sizeof(record.buf) - 1U);
+    record.level = log_level;
+    memcpy(record.buf, buf, len);
+    record.buf[len] = '\0';
+    __atomic_store_n(&ring->head, head + 1U, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Writes out the pending records of all the threads, returns the number of the records
+static uint32_t vlog_drain_rings()
+{
+    uint32_t drained = 0U;
+
+    for (vlog_ring *ring = __atomic_load_n(&s_vlog_rings, __ATOMIC_ACQUIRE); ring;
+         ring = ring->next) {
+        uint32_t tail = ring->tail;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+        for (; tail != head; ++tail, ++drained) {
+            vlog_write(ring->records[tail & (VLOG_ASYNC_RING_SIZE - 1U)].buf, false);
+            __atomic_store_n(&ring->tail, tail + 1U, __ATOMIC_RELEASE);
+        }
+    }
+    if (drained) {
+        fflush(g_vlogger_file ? g_vlogger_file : stderr);
+    }
+    return drained;
+}
+
+// Called by the drain thread, or by vlog_stop() once there is no drain thread
+static void vlog_report_lost()
+{
+    uint64_t dropped = __atomic_load_n(&g_vlogger_dropped, __ATOMIC_RELAXED);
+    uint64_t suppressed = __atomic_load_n(&g_vlogger_suppressed, __ATOMIC_RELAXED);
+
+    if (dropped != s_vlog_dropped_reported) {
+        vlog_printf(VLOG_WARNING, "vlogger: %" PRIu64 " log records dropped, the log ring is full\n",
+                    dropped - s_vlog_dropped_reported);
+        s_vlog_dropped_reported = dropped;
+    }
+    if (suppressed != s_vlog_suppressed_reported) {
+        vlog_printf(VLOG_WARNING, "vlogger: %" PRIu64 " log records suppressed by the rate limit\n",
+                    suppressed - s_vlog_suppressed_reported);
+        s_vlog_suppressed_reported = suppressed;
+    }
+}
+
+static void *vlog_drain_thread(void *)
+{
+    uint32_t report_second = 0U;
+    bool stop;
+
+    do {
+        // Check the stop flag first, so the last pass sees the records written before it
+        stop = __atomic_load_n(&s_vlog_drain_stop, __ATOMIC_ACQUIRE);
+        uint32_t drained = vlog_drain_rings();
+
+        uint32_t second = vlog_get_usec_since_start() / 1000000U;
+        if (second != report_second) {
+            report_second = second;
+            vlog_report_lost();
+        }
+        if (!drained && !stop) {
+            usleep(VLOG_ASYNC_IDLE_USEC);
+        }
+    } while (!stop);
+
+    return nullptr;
+}
+
+static void vlog_async_start()
+{
+    __atomic_store_n(&s_vlog_drain_stop, false, __ATOMIC_RELAXED);
+    if (pthread_create(&s_vlog_drain_tid, nullptr, vlog_drain_thread, nullptr)) {
+        vlog_printf(VLOG_WARNING, "vlogger: failed to start the async log thread (errno=%d %m)\n",
+                    errno);
+        return;
+    }
+    s_vlog_drain_pid = getpid();
+    __atomic_store_n(&s_vlog_async, true, __ATOMIC_RELEASE);
+}
+
+static void vlog_async_stop()
+{
+    if (!s_vlog_drain_pid) {
+        return;
+    }
+
+    __atomic_store_n(&s_vlog_async, false, __ATOMIC_RELEASE);
+    if (s_vlog_drain_pid == getpid()) {
+        __atomic_store_n(&s_vlog_drain_stop, true, __ATOMIC_RELEASE);
+        pthread_join(s_vlog_drain_tid, nullptr);
+        // Records of the threads which saw the async mode right before it was turned off
+        vlog_drain_rings();
+    } else {
+        // A forked child doesn't have the drain thread, the pending records belong to the parent
+        for (vlog_ring *ring = s_vlog_rings; ring; ring = ring->next) {
+            ring->tail = ring->head;
+        }
+    }
+    s_vlog_drain_pid = 0;
+}
+
+// Returns true if the call site, identified by its format string, ran out of its budget
+// for the current second. The call sites which collide on a slot are not limited.
+static bool vlog_rate_limited(vlog_levels_t log_level, const char *fmt)
+{
+    if (likely(!g_vlogger_rate_limit) || log_level <= VLOG_PANIC || !fmt) {
+        return false;
+    }
+
+    uint64_t hash = reinterpret_cast<uintptr_t>(fmt) * 0x9E3779B97F4A7C15ULL;
+    vlog_site &site = s_vlog_sites[(hash >> 32U) & (VLOG_RATE_LIMIT_SITES - 1U)];
+    const char *owner = __atomic_load_n(&site.fmt, __ATOMIC_RELAXED);
+    if (owner != fmt &&
+        (owner ||
+         !__atomic_compare_exchange_n(&site.fmt, &owner, fmt, false, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED))) {
+        return false;
+    }
+
+    uint32_t second = vlog_get_usec_since_start() / 1000000U;
+    if (__atomic_load_n(&site.second, __ATOMIC_RELAXED) != second) {
+        __atomic_store_n(&site.second, second, __ATOMIC_RELAXED);
+        __atomic_store_n(&site.count, 0U, __ATOMIC_RELAXED);
+    }
+    if (__atomic_add_fetch(&site.count, 1U, __ATOMIC_RELAXED) <= g_vlogger_rate_limit) {
+        return false;
+    }
+    __atomic_add_fetch(&g_vlogger_suppressed, 1U, __ATOMIC_RELAXED);
+    return true;
+}
+
 void vlog_start(const char *log_module_name, vlog_levels_t log_level, const char *log_filename,
-                int log_details, bool log_in_colors)
+                int log_details, bool log_in_colors, bool log_async, uint32_t log_rate_limit)
 {
     g_vlogger_file = stderr;
 
@@ -246,11 +497,26 @@ void vlog_start(const char *log_module_name, vlog_levels_t log_level, const char
     if (file_fd >= 0 && isatty(file_fd) && log_in_colors) {
         g_vlogger_log_in_colors = log_in_colors;
     }
+
+    g_vlogger_rate_limit = log_rate_limit;
+    __atomic_store_n(&g_vlogger_dropped, 0U, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_vlogger_suppressed, 0U, __ATOMIC_RELAXED);
+    s_vlog_dropped_reported = 0U;
+    s_vlog_suppressed_reported = 0U;
+    memset(s_vlog_sites, 0, sizeof(s_vlog_sites));
+
+    // The user callback keeps being called by the logging thread
+    if (log_async && !g_vlogger_cb) {
+        vlog_async_start();
+    }
 }
 
 void vlog_stop(void)
 {
     // Closing logger
+    vlog_async_stop();
+    g_vlogger_rate_limit = 0U;
+    vlog_report_lost();
 
     // Allow only really extreme (PANIC) logs to go out
     g_vlogger_level = VLOG_PANIC;
@@ -272,6 +538,10 @@ void vlog_stop(void)
 
 void vlog_output(vlog_levels_t log_level, const char *fmt, ...)
 {
+    if (unlikely(vlog_rate_limited(log_level, fmt))) {
+        return;
+    }
+
     int len = 0;
     char buf[VLOGGER_STR_SIZE];
 
@@ -327,12 +597,9 @@ void vlog_output(vlog_levels_t log_level, const char *fmt, ...)
 
     if (g_vlogger_cb) {
         g_vlogger_cb(log_level, buf);
-    } else if (g_vlogger_file) {
+    } else if (!vlog_async_output(log_level, buf)) {
         // Print out
-        fprintf(g_vlogger_file, "%s", buf);
-        fflush(g_vlogger_file);
-    } else {
-        fprintf(stderr, "%s", buf);
+        vlog_write(buf, true);
     }
 }
 
@@ -380,6 +647,8 @@ void vlog_print_buffer(vlog_levels_t log_level, const char *msg_header, const ch
     // Print out
     if (g_vlogger_cb) {
         g_vlogger_cb(log_level, buf);
+    } else if (vlog_async_output(log_level, buf)) {
+        return;
     } else if (g_vlogger_file) {
         fprintf(g_vlogger_file, "%s", buf);
         fflush(g_vlogger_file);
@@ -314,6 +314,9 @@ extern uint8_t *g_p_vlogger_details;
 extern uint32_t g_vlogger_usec_on_startup;
 extern bool g_vlogger_log_in_colors;
 extern xlio_log_cb_t g_vlogger_cb;
+extern uint32_t g_vlogger_rate_limit; // Records per second of a call site, 0 - unlimited
+extern uint64_t g_vlogger_dropped; // Records lost to a full async ring
+extern uint64_t g_vlogger_suppressed; // Records lost to the rate limit
 
 #define vlog_func_enter() vlog_printf(VLOG_FINE, "ENTER %s\n", __PRETTY_FUNCTION__);
 #define vlog_func_exit()  vlog_printf(VLOG_FINE, "EXIT %s\n", __PRETTY_FUNCTION__);
@@ -327,8 +330,10 @@ pid_t gettid(void); // Check vlogger.cpp for implementation
 
 void printf_backtrace(void);
 
+// log_async - the records are written by a background thread instead of the logging one
 void vlog_start(const char *log_module_name, vlog_levels_t log_level = VLOG_DEFAULT,
-                const char *log_filename = NULL, int log_details = 0, bool colored_log = true);
+                const char *log_filename = NULL, int log_details = 0, bool colored_log = true,
+                bool log_async = false, uint32_t log_rate_limit = 0);
 void vlog_stop(void);
 
 static inline uint32_t vlog_get_usec_since_start()
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include "core/util/checksum.h"
+#include "core/proto/nvme_tcp.h"
+
+// The 16 bit loop of the previous software checksum, kept as the baseline
+static uint16_t csum_words(const uint16_t *p, size_t len)
+{
+    uint64_t sum = 0;
+
+    for (; len > 1; len -= 2) {
+        sum += *p++;
+    }
+    if (len) {
+        sum += *reinterpret_cast<const uint8_t *>(p);
+    }
+    return csum_fold(sum);
+}
+
+static void bm_csum_words(benchmark::State &state)
+{
+    std::vector<uint16_t> buf(state.range(0) / 2, 0x1234);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csum_words(buf.data(), state.range(0)));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bm_csum_words)->RangeMultiplier(4)->Range(64, 64 << 10);
+
+static void bm_csum_partial(benchmark::State &state)
+{
+    std::vector<uint16_t> buf(state.range(0) / 2, 0x1234);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csum_fold(csum_partial(buf.data(), state.range(0), 0U)));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bm_csum_partial)->RangeMultiplier(4)->Range(64, 64 << 10);
+
+static void bm_crc32c(benchmark::State &state)
+{
+    std::vector<uint8_t> buf(state.range(0), 0x5A);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crc32c(CRC32C_INIT, buf.data(), buf.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bm_crc32c)->RangeMultiplier(4)->Range(64, 64 << 10);
+
+// The NVMe/TCP C2HData placement, the copy and the data digest in one pass
+static void bm_crc32c_copy(benchmark::State &state)
+{
+    std::vector<uint8_t> src(state.range(0), 0x5A);
+    std::vector<uint8_t> dst(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(crc32c_copy(CRC32C_INIT, dst.data(), src.data(), src.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bm_crc32c_copy)->RangeMultiplier(4)->Range(64, 64 << 10);
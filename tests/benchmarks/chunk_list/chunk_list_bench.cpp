@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include "utils/types.h"
+#include "core/util/chunk_list.h"
+
+struct bench_buf {
+    uint64_t data[4];
+};
+
+// A burst is queued and then drained, as the rx ready packets of a socket
+static void bm_chunk_list_push_pop(benchmark::State &state)
+{
+    chunk_list_t<bench_buf *> list;
+    int64_t burst = state.range(0);
+    bench_buf buf;
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < burst; ++i) {
+            list.push_back(&buf);
+        }
+        while (!list.empty()) {
+            benchmark::DoNotOptimize(list.get_and_pop_front());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(bm_chunk_list_push_pop)->RangeMultiplier(8)->Range(1, 1 << 12);
+
+// The container of the STL with the same use, kept as the baseline
+static void bm_deque_push_pop(benchmark::State &state)
+{
+    std::deque<bench_buf *> list;
+    int64_t burst = state.range(0);
+    bench_buf buf;
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < burst; ++i) {
+            list.push_back(&buf);
+        }
+        while (!list.empty()) {
+            benchmark::DoNotOptimize(list.front());
+            list.pop_front();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(bm_deque_push_pop)->RangeMultiplier(8)->Range(1, 1 << 12);
+
+// A standing queue of the argument length, one element in and one out
+static void bm_chunk_list_steady(benchmark::State &state)
+{
+    chunk_list_t<bench_buf *> list;
+    bench_buf buf;
+
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        list.push_back(&buf);
+    }
+    for (auto _ : state) {
+        list.push_back(&buf);
+        benchmark::DoNotOptimize(list.get_and_pop_front());
+    }
+    while (!list.empty()) {
+        list.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_chunk_list_steady)->RangeMultiplier(8)->Range(1, 1 << 12);
@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <unordered_map>
+#include <vector>
+#include "core/util/flow_table.h"
+
+// Same layout and hash as flow_spec_4t_key_ipv4 in dev/ring_slave.h
+struct __attribute__((packed)) bench_4t_key {
+    uint32_t dst_ip;
+    uint32_t src_ip;
+    uint16_t dst_port;
+    uint16_t src_port;
+
+    size_t hash() const
+    {
+        std::hash<size_t> _hash;
+        return _hash((static_cast<size_t>(dst_ip) | (static_cast<size_t>(src_ip) << 32)) ^
+                     (static_cast<size_t>(src_port) << 32) ^ static_cast<size_t>(dst_port));
+    }
+};
+
+inline bool operator==(const bench_4t_key &key1, const bench_4t_key &key2)
+{
+    return (key1.src_port == key2.src_port) && (key1.src_ip == key2.src_ip) &&
+        (key1.dst_port == key2.dst_port) && (key1.dst_ip == key2.dst_ip);
+}
+
+namespace std {
+template <> class hash<bench_4t_key> {
+public:
+    size_t operator()(const bench_4t_key &key) const { return key.hash(); }
+};
+} // namespace std
+
+static bench_4t_key make_key(uint32_t i)
+{
+    // Many clients of a single listener, like the TCP map of a loaded server
+    return bench_4t_key {0x0a000001U, 0x0b000000U + (i >> 16), 8080U,
+                         static_cast<uint16_t>(i & 0xffffU)};
+}
+
+// The keys of the packets in an order which defeats the cache of the last lookup
+static std::vector<bench_4t_key> make_lookups(uint32_t flows)
+{
+    std::vector<bench_4t_key> keys(flows);
+
+    for (uint32_t i = 0; i < flows; ++i) {
+        keys[i] = make_key((i * 2654435761U) % flows);
+    }
+    return keys;
+}
+
+// The ring_slave flow map lookup of a received packet, the number of flows is the argument
+static void bm_flow_table_find(benchmark::State &state)
+{
+    uint32_t flows = static_cast<uint32_t>(state.range(0));
+    flow_table<bench_4t_key, uintptr_t> table;
+    std::vector<bench_4t_key> keys = make_lookups(flows);
+    size_t i = 0;
+
+    for (uint32_t j = 0; j < flows; ++j) {
+        table[make_key(j)] = j + 1U;
+    }
+    for (auto _ : state) {
+        const bench_4t_key &key = keys[i];
+        benchmark::DoNotOptimize(table.find(key, table.prefetch(key))->second);
+        i = (i + 1U == keys.size()) ? 0U : i + 1U;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_flow_table_find)->RangeMultiplier(8)->Range(16, 1 << 16);
+
+// A packet of an unknown flow, e.g. a SYN or a packet to be forwarded to the OS
+static void bm_flow_table_find_miss(benchmark::State &state)
+{
+    uint32_t flows = static_cast<uint32_t>(state.range(0));
+    flow_table<bench_4t_key, uintptr_t> table;
+    uint32_t i = 0;
+
+    for (uint32_t j = 0; j < flows; ++j) {
+        table[make_key(j)] = j + 1U;
+    }
+    for (auto _ : state) {
+        bench_4t_key key = make_key(flows + (i++ & 0xfffU));
+        benchmark::DoNotOptimize(table.find(key, table.prefetch(key)) == table.end());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_flow_table_find_miss)->RangeMultiplier(8)->Range(16, 1 << 16);
+
+// The map ring_slave used before flow_table, kept as the baseline
+static void bm_flow_unordered_map_find(benchmark::State &state)
+{
+    uint32_t flows = static_cast<uint32_t>(state.range(0));
+    std::unordered_map<bench_4t_key, uintptr_t> table;
+    std::vector<bench_4t_key> keys = make_lookups(flows);
+    size_t i = 0;
+
+    for (uint32_t j = 0; j < flows; ++j) {
+        table[make_key(j)] = j + 1U;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.find(keys[i])->second);
+        i = (i + 1U == keys.size()) ? 0U : i + 1U;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_flow_unordered_map_find)->RangeMultiplier(8)->Range(16, 1 << 16);
+
+// A connection is accepted and another one is closed, the table size stays the same
+static void bm_flow_table_churn(benchmark::State &state)
+{
+    uint32_t flows = static_cast<uint32_t>(state.range(0));
+    flow_table<bench_4t_key, uintptr_t> table;
+    uint32_t oldest = 0;
+
+    for (uint32_t j = 0; j < flows; ++j) {
+        table[make_key(j)] = j + 1U;
+    }
+    for (auto _ : state) {
+        table[make_key(oldest + flows)] = oldest;
+        table.erase(table.find(make_key(oldest)));
+        ++oldest;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_flow_table_churn)->RangeMultiplier(8)->Range(16, 1 << 16);
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+#include "core/event/job_queue.h"
+
+struct bench_job {
+    void *p_sock;
+    uint64_t arg;
+};
+
+typedef job_queue<bench_job> job_queue_t;
+
+// Single producer and consumer, the insert and get_all() costs without the contention
+static void bm_job_queue_insert_get(benchmark::State &state)
+{
+    job_queue_t queue;
+    int64_t batch = state.range(0);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            queue.insert_job(bench_job {&queue, static_cast<uint64_t>(i)});
+        }
+        job_queue_t::queue_type &jobs = queue.get_all();
+        benchmark::DoNotOptimize(jobs.data());
+        jobs.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(bm_job_queue_insert_get)->Arg(1)->Arg(32)->Arg(256)->Arg(1024);
+
+// The producer threads insert while a consumer thread drains as the event handler does
+static job_queue_t *s_p_queue;
+static std::thread *s_p_consumer;
+static std::atomic<bool> s_consumer_stop;
+
+static void job_queue_consumer_start(const benchmark::State &)
+{
+    s_p_queue = new job_queue_t();
+    s_consumer_stop.store(false);
+    s_p_consumer = new std::thread([] {
+        while (!s_consumer_stop.load(std::memory_order_relaxed)) {
+            job_queue_t::queue_type &jobs = s_p_queue->get_all();
+            benchmark::DoNotOptimize(jobs.data());
+            jobs.clear();
+        }
+    });
+}
+
+static void job_queue_consumer_stop(const benchmark::State &)
+{
+    s_consumer_stop.store(true);
+    s_p_consumer->join();
+    delete s_p_consumer;
+    s_p_queue->get_all().clear();
+    delete s_p_queue;
+}
+
+static void bm_job_queue_mpsc(benchmark::State &state)
+{
+    uint64_t i = 0;
+
+    for (auto _ : state) {
+        s_p_queue->insert_job(bench_job {nullptr, i++});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_job_queue_mpsc)
+    ->Setup(job_queue_consumer_start)
+    ->Teardown(job_queue_consumer_stop)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
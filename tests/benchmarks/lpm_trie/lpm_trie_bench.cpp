@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+#include <random>
+#include <vector>
+#include "core/util/lpm_trie.h"
+
+struct bench_route {
+    uint32_t dst; // Network byte order
+    unsigned prefix_len;
+};
+
+static std::vector<bench_route> random_routes(std::mt19937 &gen, size_t num)
+{
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<unsigned> len(8U, 32U);
+    std::vector<bench_route> routes(num);
+
+    for (bench_route &route : routes) {
+        route.prefix_len = len(gen);
+        route.dst = htonl(addr(gen) & ~(UINT32_MAX >> route.prefix_len));
+    }
+    return routes;
+}
+
+// The destinations, half of them within a route to hit the long prefixes
+static std::vector<uint32_t> random_dsts(std::mt19937 &gen, const std::vector<bench_route> &routes)
+{
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<size_t> pick(0U, routes.size() - 1U);
+    std::vector<uint32_t> dsts(4096U);
+
+    for (size_t i = 0; i < dsts.size(); ++i) {
+        dsts[i] = (i & 1U) ? addr(gen) : htonl(ntohl(routes[pick(gen)].dst) | (i & 0xFFU));
+    }
+    return dsts;
+}
+
+// The longest prefix match of route_table_mgr::route_resolve(), the routes are the argument
+static void bm_lpm_trie_lookup(benchmark::State &state)
+{
+    std::mt19937 gen(1);
+    std::vector<bench_route> routes = random_routes(gen, static_cast<size_t>(state.range(0)));
+    std::vector<uint32_t> dsts = random_dsts(gen, routes);
+    lpm_trie<uint32_t> trie;
+    size_t i = 0;
+
+    for (size_t j = 0; j < routes.size(); ++j) {
+        trie.insert(reinterpret_cast<const uint8_t *>(&routes[j].dst), routes[j].prefix_len,
+                    static_cast<uint32_t>(j));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(trie.lookup(reinterpret_cast<const uint8_t *>(&dsts[i]), 32U));
+        i = (i + 1U) & (dsts.size() - 1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_lpm_trie_lookup)->RangeMultiplier(8)->Range(16, 1 << 16);
+
+// The linear scan which route_table_mgr did before the trie, kept as the baseline
+static void bm_lpm_linear_lookup(benchmark::State &state)
+{
+    std::mt19937 gen(1);
+    std::vector<bench_route> routes = random_routes(gen, static_cast<size_t>(state.range(0)));
+    std::vector<uint32_t> dsts = random_dsts(gen, routes);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        uint32_t dst = ntohl(dsts[i]);
+        int longest = -1;
+        int found = -1;
+
+        for (size_t j = 0; j < routes.size(); ++j) {
+            unsigned shift = 32U - routes[j].prefix_len;
+            if ((ntohl(routes[j].dst) >> shift) == (dst >> shift) &&
+                static_cast<int>(routes[j].prefix_len) > longest) {
+                longest = static_cast<int>(routes[j].prefix_len);
+                found = static_cast<int>(j);
+            }
+        }
+        benchmark::DoNotOptimize(found);
+        i = (i + 1U) & (dsts.size() - 1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_lpm_linear_lookup)->RangeMultiplier(8)->Range(16, 1 << 12);
+
+// A route is replaced, as a netlink update does
+static void bm_lpm_trie_update(benchmark::State &state)
+{
+    std::mt19937 gen(1);
+    std::vector<bench_route> routes = random_routes(gen, static_cast<size_t>(state.range(0)));
+    lpm_trie<uint32_t> trie;
+    size_t i = 0;
+
+    for (size_t j = 0; j < routes.size(); ++j) {
+        trie.insert(reinterpret_cast<const uint8_t *>(&routes[j].dst), routes[j].prefix_len,
+                    static_cast<uint32_t>(j));
+    }
+    for (auto _ : state) {
+        const uint8_t *key = reinterpret_cast<const uint8_t *>(&routes[i].dst);
+        trie.remove(key, routes[i].prefix_len, static_cast<uint32_t>(i));
+        trie.insert(key, routes[i].prefix_len, static_cast<uint32_t>(i));
+        i = (i + 1U == routes.size()) ? 0U : i + 1U;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_lpm_trie_update)->RangeMultiplier(8)->Range(16, 1 << 16);
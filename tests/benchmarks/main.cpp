@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "utils/types.h"
+#include "vlogger/vlogger.h"
+
+// The structures log only on errors, the benchmarks don't link the logger of the library
+vlog_levels_t g_vlogger_level = VLOG_NONE;
+
+void vlog_output(vlog_levels_t log_level, const char *fmt, ...)
+{
+    NOT_IN_USE(log_level);
+    NOT_IN_USE(fmt);
+}
+
+BENCHMARK_MAIN();
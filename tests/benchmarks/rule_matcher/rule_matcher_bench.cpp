@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+#include <random>
+#include <vector>
+#include "core/util/rule_matcher.h"
+
+// The offload rules of a role: a third by address, a third by port range and a third by both
+static std::vector<use_family_rule> random_rules(std::mt19937 &gen, size_t num)
+{
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<unsigned> len(8U, 32U);
+    std::uniform_int_distribution<unsigned> port(1U, 60000U);
+    std::vector<use_family_rule> rules(num);
+
+    for (size_t i = 0; i < num; ++i) {
+        use_family_rule &rule = rules[i];
+        rule = use_family_rule();
+        rule.protocol = PROTO_TCP;
+        rule.target_transport = (i & 1U) ? TRANS_OS : TRANS_XLIO;
+        if (i % 3U != 1U) {
+            rule.first.match_by_addr = 1;
+            rule.first.prefixlen = static_cast<unsigned char>(len(gen));
+            rule.first.ipv4.s_addr = htonl(addr(gen) & ~(UINT32_MAX >> rule.first.prefixlen));
+        }
+        if (i % 3U != 0U) {
+            rule.first.match_by_port = 1;
+            rule.first.sport = static_cast<unsigned short>(port(gen));
+            rule.first.eport = static_cast<unsigned short>(rule.first.sport + port(gen) % 16U);
+        }
+    }
+    return rules;
+}
+
+// Mostly misses, as for the sockets which no rule covers and which fall to the default
+static std::vector<rule_match_addr> random_addrs(std::mt19937 &gen)
+{
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<unsigned> port(1U, 65535U);
+    std::vector<rule_match_addr> addrs(4096U);
+
+    for (rule_match_addr &match_addr : addrs) {
+        match_addr = {addr(gen), static_cast<uint16_t>(port(gen)), true};
+    }
+    return addrs;
+}
+
+static std::vector<dbl_lst_node> rule_list(std::vector<use_family_rule> &rules, dbl_lst &lst)
+{
+    std::vector<dbl_lst_node> nodes(rules.size());
+
+    for (size_t i = 0; i < rules.size(); ++i) {
+        nodes[i].data = &rules[i];
+        nodes[i].prev = i ? &nodes[i - 1] : nullptr;
+        nodes[i].next = i + 1 < rules.size() ? &nodes[i + 1] : nullptr;
+    }
+    lst.head = nodes.empty() ? nullptr : &nodes.front();
+    lst.tail = nodes.empty() ? nullptr : &nodes.back();
+    return nodes;
+}
+
+// The lookup of __xlio_match_tcp_server() with the compiled rules, the rules are the argument
+static void bm_rule_matcher_match(benchmark::State &state)
+{
+    std::mt19937 gen(1);
+    std::vector<use_family_rule> rules = random_rules(gen, static_cast<size_t>(state.range(0)));
+    std::vector<rule_match_addr> addrs = random_addrs(gen);
+    dbl_lst lst;
+    std::vector<dbl_lst_node> nodes = rule_list(rules, lst);
+    rule_matcher matcher;
+    size_t i = 0;
+
+    matcher.build(lst);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matcher.match(TRANS_XLIO, addrs[i]));
+        i = (i + 1U) & (addrs.size() - 1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_rule_matcher_match)->RangeMultiplier(8)->Range(8, 1 << 12);
+
+// The walk of the rule list which the match functions did before, kept as the baseline
+static void bm_rule_linear_match(benchmark::State &state)
+{
+    std::mt19937 gen(1);
+    std::vector<use_family_rule> rules = random_rules(gen, static_cast<size_t>(state.range(0)));
+    std::vector<rule_match_addr> addrs = random_addrs(gen);
+    size_t i = 0;
+
+    for (auto _ : state) {
+        const use_family_rule *found = nullptr;
+
+        for (const use_family_rule &rule : rules) {
+            if (rule_matcher::matches(rule, TRANS_XLIO, addrs[i], nullptr)) {
+                found = &rule;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+        i = (i + 1U) & (addrs.size() - 1U);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_rule_linear_match)->RangeMultiplier(8)->Range(8, 1 << 12);
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+#include "core/event/timer_wheel.h"
+
+// Same intrusive fields as timer_node_t in event/delta_timer.h
+struct bench_timer {
+    uint64_t expiry_msec;
+    uint16_t wheel_slot;
+    bench_timer *next;
+    bench_timer *prev;
+};
+
+typedef timer_wheel<bench_timer> timer_wheel_t;
+
+static void arm_all(timer_wheel_t &wheel, std::vector<bench_timer> &timers, std::mt19937 &gen,
+                    std::uniform_int_distribution<uint64_t> &delay)
+{
+    for (bench_timer &timer : timers) {
+        timer = bench_timer();
+        wheel.add(&timer, delay(gen));
+    }
+}
+
+// A timer is rearmed before it expires, like the TCP retransmit timer on every ACK
+static void bm_timer_wheel_rearm(benchmark::State &state)
+{
+    std::vector<bench_timer> timers(static_cast<size_t>(state.range(0)));
+    std::uniform_int_distribution<uint64_t> delay(10U, 200000U);
+    std::mt19937 gen(1);
+    timer_wheel_t wheel;
+    size_t i = 0;
+
+    arm_all(wheel, timers, gen, delay);
+    for (auto _ : state) {
+        wheel.remove(&timers[i]);
+        wheel.add(&timers[i], delay(gen));
+        i = (i + 1U == timers.size()) ? 0U : i + 1U;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(bm_timer_wheel_rearm)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+// The periodic tick: the wheel moves 1 msec and the expired timers are armed again
+static void bm_timer_wheel_tick(benchmark::State &state)
+{
+    std::vector<bench_timer> timers(static_cast<size_t>(state.range(0)));
+    std::uniform_int_distribution<uint64_t> delay(1U, 1000U);
+    std::mt19937 gen(1);
+    timer_wheel_t wheel;
+    int64_t fired = 0;
+
+    arm_all(wheel, timers, gen, delay);
+    for (auto _ : state) {
+        wheel.advance(1U);
+        while (bench_timer *timer = wheel.pop_expired()) {
+            wheel.add(timer, delay(gen));
+            ++fired;
+        }
+    }
+    state.SetItemsProcessed(fired);
+    state.counters["timers_per_tick"] =
+        benchmark::Counter(static_cast<double>(fired) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(bm_timer_wheel_tick)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+// next_timeout() is called on every sleep of the event handler
+static void bm_timer_wheel_next_timeout(benchmark::State &state)
+{
+    std::vector<bench_timer> timers(static_cast<size_t>(state.range(0)));
+    std::uniform_int_distribution<uint64_t> delay(100U, 200000U);
+    std::mt19937 gen(1);
+    timer_wheel_t wheel;
+
+    arm_all(wheel, timers, gen, delay);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(wheel.next_timeout());
+    }
+}
+BENCHMARK(bm_timer_wheel_next_timeout)->RangeMultiplier(8)->Range(64, 1 << 18);
+
+// Every tick a part of the timers is cancelled and armed again as TCP retransmission timers
+// are, the rest expires and is armed again as periodic timers are
+static void bm_timer_wheel_churn(benchmark::State &state)
+{
+    std::vector<bench_timer> timers(static_cast<size_t>(state.range(0)));
+    std::uniform_int_distribution<uint64_t> delay(1U, 5000U);
+    std::uniform_int_distribution<size_t> pick(0U, timers.size() - 1U);
+    std::mt19937 gen(13);
+    timer_wheel_t wheel;
+    int64_t ops = 0;
+
+    arm_all(wheel, timers, gen, delay);
+    for (auto _ : state) {
+        for (size_t i = 0; i < 100U; ++i) {
+            bench_timer *timer = &timers[pick(gen)];
+            wheel.remove(timer);
+            wheel.add(timer, delay(gen));
+        }
+        ops += 200;
+        wheel.advance(1U);
+        while (bench_timer *timer = wheel.pop_expired()) {
+            wheel.add(timer, delay(gen));
+            ops += 2;
+        }
+    }
+    state.SetItemsProcessed(ops);
+}
+BENCHMARK(bm_timer_wheel_churn)->Arg(100000);
+
+// The event handler sleeps for next_timeout() until the armed timers expire
+static void bm_timer_wheel_sleep(benchmark::State &state)
+{
+    std::vector<bench_timer> timers(static_cast<size_t>(state.range(0)));
+    std::uniform_int_distribution<uint64_t> delay(1U, 1000000U);
+    std::mt19937 gen(7);
+    int64_t wakeups = 0;
+
+    for (auto _ : state) {
+        timer_wheel_t wheel;
+
+        arm_all(wheel, timers, gen, delay);
+        while (!wheel.empty()) {
+            wheel.advance(static_cast<uint64_t>(wheel.next_timeout()));
+            while (wheel.pop_expired()) {
+            }
+            ++wakeups;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["wakeups"] =
+        benchmark::Counter(static_cast<double>(wakeups) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(bm_timer_wheel_sleep)->Arg(1000);
@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "common/def.h"
+#include "common/log.h"
+#include "common/sys.h"
+#include "common/base.h"
+#include "common/cmn.h"
+
+#include "xlio_base.h"
+
+#if defined(EXTRA_API_ENABLED) && (EXTRA_API_ENABLED == 1)
+
+class xlio_recv_zcopy : public xlio_base {
+protected:
+    void SetUp() override
+    {
+        xlio_base::SetUp();
+        SKIP_TRUE(xlio_api->cap_mask & XLIO_EXTRA_API_RECV_ZCOPY,
+                  "recv_zcopy is not supported by the library");
+    }
+
+    static int set_rcv_timeout(int fd)
+    {
+        struct timeval tv = {.tv_sec = 10, .tv_usec = 0};
+        return setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+
+    static size_t zcopy_copy(const struct xlio_zcopy_buf *bufs, int count, char *out, size_t len)
+    {
+        size_t total = 0;
+
+        for (int i = 0; i < count; ++i) {
+            size_t n = std::min(bufs[i].len, len - total);
+            memcpy(out + total, bufs[i].data, n);
+            total += n;
+        }
+        return total;
+    }
+};
+
+/**
+ * @test xlio_recv_zcopy.ti_1
+ * @brief
+ *    Bad arguments
+ * @details
+ */
+TEST_F(xlio_recv_zcopy, ti_1)
+{
+    struct xlio_zcopy_buf bufs[4];
+    int fds[2];
+    int rc;
+
+    int fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    errno = EOK;
+    rc = xlio_api->recv_zcopy(fd, bufs, 0, MSG_DONTWAIT);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    errno = EOK;
+    rc = xlio_api->recv_zcopy(fd, nullptr, 4, MSG_DONTWAIT);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    close(fd);
+
+    // Not a socket
+    ASSERT_EQ(0, pipe(fds));
+    errno = EOK;
+    rc = xlio_api->recv_zcopy(fds[0], bufs, 4, MSG_DONTWAIT);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EOPNOTSUPP, errno);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/**
+ * @test xlio_recv_zcopy.ti_2
+ * @brief
+ *    UDP datagram received without a copy
+ * @details
+ */
+TEST_F(xlio_recv_zcopy, ti_2)
+{
+    const char msg[] = "zero copy datagram";
+    int pid = fork();
+
+    if (0 == pid) { // Child
+        barrier_fork(pid);
+
+        int fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = sendto(fd, msg, sizeof(msg), 0, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO((int)sizeof(msg), rc);
+            close(fd);
+        }
+
+        // This exit is very important, otherwise the fork
+        // keeps running and may duplicate other tests.
+        exit(testing::Test::HasFailure());
+    } else { // Parent
+        int fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = bind(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            EXPECT_EQ_ERRNO(0, set_rcv_timeout(fd));
+            if (0 == rc) {
+                barrier_fork(pid);
+
+                struct xlio_zcopy_buf bufs[4];
+                char data[sizeof(msg)] = {0};
+
+                rc = xlio_api->recv_zcopy(fd, bufs, 4, 0);
+                EXPECT_LE_ERRNO(1, rc);
+                if (rc > 0) {
+                    EXPECT_TRUE(bufs[0].buf);
+                    EXPECT_EQ(sizeof(msg), zcopy_copy(bufs, rc, data, sizeof(data)));
+                    EXPECT_EQ(0, memcmp(msg, data, sizeof(msg)));
+                    EXPECT_EQ_ERRNO(0, xlio_api->free_zcopy_bufs(fd, bufs, rc));
+                }
+            }
+
+            close(fd);
+        }
+
+        EXPECT_EQ(0, wait_fork(pid));
+    }
+}
+
+/**
+ * @test xlio_recv_zcopy.ti_3
+ * @brief
+ *    TCP stream received without a copy
+ * @details
+ */
+TEST_F(xlio_recv_zcopy, ti_3)
+{
+    static char msg[64 * 1024];
+    int pid = fork();
+
+    for (size_t i = 0; i < sizeof(msg); ++i) {
+        msg[i] = (char)i;
+    }
+
+    if (0 == pid) { // Child
+        barrier_fork(pid);
+
+        int fd = socket(m_family, SOCK_STREAM, IPPROTO_IP);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = connect(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                size_t sent = 0;
+                while (sent < sizeof(msg)) {
+                    ssize_t n = send(fd, msg + sent, sizeof(msg) - sent, 0);
+                    EXPECT_LT(0, n);
+                    if (n <= 0) {
+                        break;
+                    }
+                    sent += n;
+                }
+            }
+            close(fd);
+        }
+
+        exit(testing::Test::HasFailure());
+    } else { // Parent
+        int lfd = socket(m_family, SOCK_STREAM, IPPROTO_IP);
+        EXPECT_LE_ERRNO(0, lfd);
+        if (0 <= lfd) {
+            int rc = bind(lfd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            rc = rc ?: listen(lfd, 5);
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                barrier_fork(pid);
+
+                int fd = accept(lfd, nullptr, nullptr);
+                EXPECT_LE_ERRNO(0, fd);
+                EXPECT_EQ_ERRNO(0, set_rcv_timeout(fd));
+
+                static char data[sizeof(msg)];
+                struct xlio_zcopy_buf bufs[16];
+                size_t total = 0;
+
+                while (0 <= fd && total < sizeof(data)) {
+                    rc = xlio_api->recv_zcopy(fd, bufs, 16, 0);
+                    EXPECT_LE_ERRNO(1, rc);
+                    if (rc <= 0) {
+                        break;
+                    }
+                    total += zcopy_copy(bufs, rc, data + total, sizeof(data) - total);
+                    EXPECT_EQ_ERRNO(0, xlio_api->free_zcopy_bufs(fd, bufs, rc));
+                }
+                EXPECT_EQ(sizeof(msg), total);
+                EXPECT_EQ(0, memcmp(msg, data, sizeof(msg)));
+
+                if (0 <= fd) {
+                    close(fd);
+                }
+            }
+
+            close(lfd);
+        }
+
+        EXPECT_EQ(0, wait_fork(pid));
+    }
+}
+
+#endif /* EXTRA_API_ENABLED */
@@ -90,4 +90,233 @@ TEST_F(xlio_sockopt, ti_2)
     close(fd);
 }
 
+/**
+ * @test xlio_sockopt.ti_3
+ * @brief
+ *    UDP batched multicast membership bad flow
+ * @details
+ */
+TEST_F(xlio_sockopt, ti_3)
+{
+    int rc = EOK;
+    int fd = UNDEFINED_VALUE;
+    struct ip_mreqn mreqs[2];
+
+    SKIP_TRUE(m_family == AF_INET, "IPv4 only");
+
+    memset(mreqs, 0, sizeof(mreqs));
+
+    fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    /* No groups */
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_ADD_MEMBERSHIPS, mreqs, 0);
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    /* Partial entry */
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_ADD_MEMBERSHIPS, mreqs, sizeof(mreqs) - 1);
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    /* Entry that is not a multicast group */
+    mreqs[0].imr_multiaddr = server_addr.addr4.sin_addr;
+    mreqs[0].imr_address = server_addr.addr4.sin_addr;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_ADD_MEMBERSHIPS, mreqs, sizeof(mreqs[0]));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    close(fd);
+}
+
+/**
+ * @test xlio_sockopt.ti_4
+ * @brief
+ *    UDP batched multicast membership join and leave
+ * @details
+ */
+TEST_F(xlio_sockopt, ti_4)
+{
+    int rc = EOK;
+    int fd = UNDEFINED_VALUE;
+    struct ip_mreqn mreqs[4];
+    char grp[32];
+
+    SKIP_TRUE(m_family == AF_INET, "IPv4 only");
+
+    memset(mreqs, 0, sizeof(mreqs));
+    for (size_t i = 0; i < ARRAY_SIZE(mreqs); i++) {
+        /* 224.4.4.x and 224.132.4.x map to the same MAC addresses */
+        snprintf(grp, sizeof(grp), "224.%d.4.%zu", (i & 1) ? 132 : 4, 1 + i / 2);
+        ASSERT_EQ(1, inet_pton(AF_INET, grp, &mreqs[i].imr_multiaddr));
+        mreqs[i].imr_address = server_addr.addr4.sin_addr;
+    }
+
+    fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_ADD_MEMBERSHIPS, mreqs, sizeof(mreqs));
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(EOK, errno);
+
+    /* Already a member */
+    errno = EOK;
+    rc = setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreqs[0], sizeof(mreqs[0]));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EADDRINUSE, errno);
+
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_DROP_MEMBERSHIPS, mreqs, sizeof(mreqs));
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(EOK, errno);
+
+    close(fd);
+}
+
+/**
+ * @test xlio_sockopt.ti_5
+ * @brief
+ *    Per socket receive polling budget
+ * @details
+ */
+TEST_F(xlio_sockopt, ti_5)
+{
+    int rc = EOK;
+    int fd = UNDEFINED_VALUE;
+    int val = 0;
+    socklen_t len = sizeof(val);
+
+    fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    val = 1000;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_RX_POLL, &val, sizeof(val));
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(EOK, errno);
+
+    val = 0;
+    rc = getsockopt(fd, SOL_SOCKET, SO_XLIO_RX_POLL, &val, &len);
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(1000, val);
+
+    /* Below -1 is invalid */
+    val = -2;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_RX_POLL, &val, sizeof(val));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    /* A time budget replaces the loops count */
+    val = 50;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &val, sizeof(val));
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(EOK, errno);
+
+    val = 0;
+    len = sizeof(val);
+    rc = getsockopt(fd, SOL_SOCKET, SO_XLIO_RX_POLL, &val, &len);
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(-1, val);
+
+    close(fd);
+}
+
+/**
+ * @test xlio_sockopt.ti_6
+ * @brief
+ *    UDP drop policy of a full receive buffer
+ * @details
+ */
+TEST_F(xlio_sockopt, ti_6)
+{
+    int rc = EOK;
+    int fd = UNDEFINED_VALUE;
+    int val = 0;
+    socklen_t len = sizeof(val);
+
+    fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    val = -1;
+    rc = getsockopt(fd, SOL_SOCKET, SO_XLIO_RX_DROP_POLICY, &val, &len);
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(XLIO_RX_DROP_NEWEST, val);
+
+    val = XLIO_RX_DROP_OLDEST;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_RX_DROP_POLICY, &val, sizeof(val));
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(EOK, errno);
+
+    val = -1;
+    len = sizeof(val);
+    rc = getsockopt(fd, SOL_SOCKET, SO_XLIO_RX_DROP_POLICY, &val, &len);
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(XLIO_RX_DROP_OLDEST, val);
+
+    /* Unknown policy */
+    val = 2;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_RX_DROP_POLICY, &val, sizeof(val));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    close(fd);
+}
+
+/**
+ * @test xlio_sockopt.ti_7
+ * @brief
+ *    NVMe/TCP offload options of an unconnected socket
+ * @details
+ */
+TEST_F(xlio_sockopt, ti_7)
+{
+    int rc = EOK;
+    int fd = UNDEFINED_VALUE;
+    struct xlio_nvme_offload offload = {};
+    struct xlio_nvme_ddp ddp = {};
+    char buf[64];
+    socklen_t len = sizeof(offload);
+
+    fd = socket(m_family, SOCK_STREAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    offload.flags = ~0U;
+    rc = getsockopt(fd, SOL_SOCKET, SO_XLIO_NVME_OFFLOAD, &offload, &len);
+    EXPECT_EQ(0, rc);
+    EXPECT_EQ(0U, offload.flags);
+    EXPECT_EQ(0U, offload.rx_digest_errors);
+
+    /* Unknown flag */
+    offload.flags = 1U << 31;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_NVME_OFFLOAD, &offload, sizeof(offload));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    offload.flags = XLIO_NVME_TX_DIGEST | XLIO_NVME_RX_DIGEST;
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_NVME_OFFLOAD, &offload, sizeof(offload));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(ENOTCONN, errno);
+
+    /* No placement without the offload */
+    ddp.cid = 1;
+    ddp.buf = buf;
+    ddp.len = sizeof(buf);
+    errno = EOK;
+    rc = setsockopt(fd, SOL_SOCKET, SO_XLIO_NVME_DDP_SETUP, &ddp, sizeof(ddp));
+    EXPECT_GT(0, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    close(fd);
+}
+
 #endif /* EXTRA_API_ENABLED */
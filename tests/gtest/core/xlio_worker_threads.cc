@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "common/def.h"
+#include "common/log.h"
+#include "common/sys.h"
+#include "common/base.h"
+#include "common/cmn.h"
+
+#include "xlio_base.h"
+
+#if defined(EXTRA_API_ENABLED) && (EXTRA_API_ENABLED == 1)
+
+class xlio_worker_threads : public xlio_base {
+protected:
+    void SetUp() override
+    {
+        xlio_base::SetUp();
+        SKIP_TRUE(xlio_api->cap_mask & XLIO_EXTRA_API_WORKER_THREADS,
+                  "worker_thread_set_affinity is not supported by the library");
+    }
+};
+
+/**
+ * @test xlio_worker_threads.ti_1
+ * @brief
+ *    Bad arguments of worker_thread_set_affinity()
+ * @details
+ */
+TEST_F(xlio_worker_threads, ti_1)
+{
+    cpu_set_t cpuset;
+    int rc;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(0, &cpuset);
+
+    errno = EOK;
+    rc = xlio_api->worker_thread_set_affinity(0, sizeof(cpuset), nullptr);
+    EXPECT_EQ(-1, rc);
+    EXPECT_TRUE(errno == EINVAL || errno == EOPNOTSUPP);
+
+    errno = EOK;
+    rc = xlio_api->worker_thread_set_affinity(0, sizeof(cpuset) - 1, &cpuset);
+    EXPECT_EQ(-1, rc);
+    EXPECT_TRUE(errno == EINVAL || errno == EOPNOTSUPP);
+
+    // No worker thread has this index
+    errno = EOK;
+    rc = xlio_api->worker_thread_set_affinity(UINT16_MAX + 1U, sizeof(cpuset), &cpuset);
+    EXPECT_EQ(-1, rc);
+    EXPECT_TRUE(errno == EINVAL || errno == EOPNOTSUPP);
+}
+
+/**
+ * @test xlio_worker_threads.ti_2
+ * @brief
+ *    send_zcopy() of a socket not served by a worker thread
+ * @details
+ */
+TEST_F(xlio_worker_threads, ti_2)
+{
+    SKIP_TRUE(xlio_api->cap_mask & XLIO_EXTRA_API_SEND_ZCOPY,
+              "send_zcopy is not supported by the library");
+
+    char data[8] = {0};
+    struct iovec iov = {.iov_base = data, .iov_len = sizeof(data)};
+    uintptr_t userdata;
+    int rc;
+
+    // Not connected, the socket has no worker thread
+    int fd = socket(m_family, SOCK_STREAM, IPPROTO_IP);
+    ASSERT_LE(0, fd);
+
+    errno = EOK;
+    rc = xlio_api->send_zcopy(fd, &iov, 1, 0U, 1U);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EOPNOTSUPP, errno);
+
+    errno = EOK;
+    rc = xlio_api->poll_zcopy_completions(fd, &userdata, 1);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EOPNOTSUPP, errno);
+
+    close(fd);
+}
+
+#endif /* EXTRA_API_ENABLED */
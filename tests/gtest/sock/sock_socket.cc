@@ -4,6 +4,12 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "common/def.h"
 #include "common/log.h"
 #include "common/sys.h"
@@ -165,3 +171,92 @@ TEST_F(sock_socket, ti_7)
 
     close(fd);
 }
+
+/**
+ * @test sock_socket.ti_8
+ * @brief
+ *    Create and close sockets from many threads
+ * @details
+ *    Every thread opens and closes its own sockets concurrently with the
+ *    others. All the calls succeed and the aggregate rate is reported.
+ */
+TEST_F(sock_socket, ti_8)
+{
+    const int n_threads = std::max(2U, std::min(std::thread::hardware_concurrency(), 16U));
+    const int n_iters = 2000;
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t]() {
+            int type = (t % 2) ? SOCK_STREAM : SOCK_DGRAM;
+            for (int i = 0; i < n_iters; i++) {
+                int fd = socket(m_family, type, IPPROTO_IP);
+                if (fd < 0 || close(fd) != 0) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    EXPECT_EQ(0, failures.load());
+    log_trace("%d threads: %.0f socket/close pairs per second\n", n_threads,
+              (double)n_threads * n_iters * 1000000.0 / std::max<int64_t>(usec, 1));
+}
+
+/**
+ * @test sock_socket.ti_9
+ * @brief
+ *    read() of a regular file
+ * @details
+ *    The file takes the fd number of a closed socket and is read through the
+ *    OS. The cost of an intercepted read() of the file is reported.
+ */
+TEST_F(sock_socket, ti_9)
+{
+    char path[] = "/tmp/gtest_sock_socket_XXXXXX";
+    const char data[] = "regular file data";
+    char buf[sizeof(data)];
+    const int n_iters = 100000;
+    int rc;
+
+    int tmp_fd = mkstemp(path);
+    ASSERT_LE(0, tmp_fd);
+    EXPECT_EQ((ssize_t)sizeof(data), write(tmp_fd, data, sizeof(data)));
+    close(tmp_fd);
+
+    int sock_fd = socket(m_family, SOCK_DGRAM, IPPROTO_IP);
+    ASSERT_LE(0, sock_fd);
+    EXPECT_EQ(0, close(sock_fd));
+
+    int fd = open(path, O_RDONLY);
+    unlink(path);
+    ASSERT_LE(0, fd);
+    log_trace("file fd=%d closed socket fd=%d\n", fd, sock_fd);
+
+    rc = read(fd, buf, sizeof(buf));
+    EXPECT_EQ((ssize_t)sizeof(data), rc);
+    EXPECT_EQ(0, memcmp(data, buf, sizeof(data)));
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n_iters; i++) {
+        lseek(fd, 0, SEEK_SET);
+        if (read(fd, buf, 1) != 1) {
+            ADD_FAILURE() << "read() failed errno=" << errno;
+            break;
+        }
+    }
+    auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    EXPECT_EQ(0, close(fd));
+    log_trace("%.0f nsec per lseek() and read() of a regular file\n", (double)nsec / n_iters);
+}
@@ -314,6 +314,29 @@ TEST_F(tcp_set_get_sockopt, set_and_get_tcp_ipv6_user_timeout)
     EXPECT_EQ(output_user_timeout_ms, user_timeout_ms) << "Unexpected timeout value";
 }
 
+TEST_F(tcp_set_get_sockopt, set_and_get_tcp_cork)
+{
+    int optval = 1;
+    socklen_t optlen = sizeof(optval);
+
+    int result = setsockopt(m_ipv4_tcp_socket_fd, IPPROTO_TCP, TCP_CORK, &optval, optlen);
+    EXPECT_EQ(result, 0) << "setsockopt failed for TCP_CORK";
+
+    optval = 0;
+    result = getsockopt(m_ipv4_tcp_socket_fd, IPPROTO_TCP, TCP_CORK, &optval, &optlen);
+    EXPECT_EQ(result, 0) << "getsockopt failed for TCP_CORK";
+    EXPECT_EQ(optval, 1) << "Socket isn't corked";
+
+    optval = 0;
+    result = setsockopt(m_ipv4_tcp_socket_fd, IPPROTO_TCP, TCP_CORK, &optval, optlen);
+    EXPECT_EQ(result, 0) << "setsockopt failed for TCP_CORK";
+
+    optval = 1;
+    result = getsockopt(m_ipv4_tcp_socket_fd, IPPROTO_TCP, TCP_CORK, &optval, &optlen);
+    EXPECT_EQ(result, 0) << "getsockopt failed for TCP_CORK";
+    EXPECT_EQ(optval, 0) << "Socket is still corked";
+}
+
 struct reusable_cleanable_test_socket {
     int m_fd;
     reusable_cleanable_test_socket(int domain, int type, int protocol)
@@ -5,6 +5,7 @@
  */
 
 #include <sys/mman.h>
+#include <netinet/udp.h>
 #include "common/def.h"
 #include "common/log.h"
 #include "common/sys.h"
@@ -12,6 +13,10 @@
 #include "src/core/util/sock_addr.h"
 #include "udp_base.h"
 
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 class udp_recv : public udp_base {};
 
 /**
@@ -121,3 +126,201 @@ TEST_F(udp_recv, mapped_ipv4_recv)
         EXPECT_EQ(0, wait_fork(pid));
     }
 }
+
+/**
+ * @test udp_recv.gro_recv
+ * @brief
+ *    Receive of same size datagrams with UDP_GRO
+ *
+ * @details
+ *    Datagrams may be coalesced, in this case the UDP_GRO control message reports
+ *    the segment size and the data is a multiple of it.
+ */
+TEST_F(udp_recv, gro_recv)
+{
+    const int n_msgs = 8;
+    const int msg_size = 1000;
+    int pid = fork();
+
+    if (0 == pid) { // Child
+        barrier_fork(pid);
+
+        int fd = udp_base::sock_create();
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = bind(fd, &client_addr.addr, sizeof(client_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                rc = connect(fd, &server_addr.addr, sizeof(server_addr));
+                EXPECT_EQ_ERRNO(0, rc);
+                if (0 == rc) {
+                    char buffer[msg_size];
+                    for (int i = 0; i < n_msgs; i++) {
+                        memset(buffer, 'a' + i, sizeof(buffer));
+                        rc = send(fd, buffer, sizeof(buffer), 0);
+                        EXPECT_EQ(msg_size, rc);
+                    }
+                }
+            }
+
+            close(fd);
+        }
+
+        // This exit is very important, otherwise the fork
+        // keeps running and may duplicate other tests.
+        exit(testing::Test::HasFailure());
+    } else { // Parent
+        int fd = udp_base::sock_create_to(m_family, false, 10);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int val = 1;
+            int rc = setsockopt(fd, IPPROTO_UDP, UDP_GRO, &val, sizeof(val));
+            if (0 != rc) {
+                log_trace("UDP_GRO is not supported: errno=%d\n", errno);
+                close(fd);
+                barrier_fork(pid);
+                EXPECT_EQ(0, wait_fork(pid));
+                return;
+            }
+            rc = bind(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                barrier_fork(pid);
+
+                static char buffer[65536];
+                char control[CMSG_SPACE(sizeof(int))];
+                int total = 0;
+
+                while (total < n_msgs * msg_size) {
+                    iovec vec = {.iov_base = buffer, .iov_len = sizeof(buffer)};
+                    msghdr msg;
+                    memset(&msg, 0, sizeof(msg));
+                    msg.msg_iov = &vec;
+                    msg.msg_iovlen = 1U;
+                    msg.msg_control = control;
+                    msg.msg_controllen = sizeof(control);
+                    rc = recvmsg(fd, &msg, 0);
+                    EXPECT_LE_ERRNO(0, rc);
+                    if (rc <= 0) {
+                        break;
+                    }
+
+                    int gso_size = 0;
+                    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+                         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                            memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                        }
+                    }
+                    if (gso_size) {
+                        EXPECT_EQ(msg_size, gso_size);
+                    }
+                    EXPECT_EQ(0, rc % msg_size);
+                    for (int i = 0; i < rc; i += msg_size) {
+                        EXPECT_EQ('a' + (total + i) / msg_size, buffer[i]);
+                    }
+                    total += rc;
+                }
+                EXPECT_EQ(n_msgs * msg_size, total);
+            }
+
+            close(fd);
+        }
+
+        EXPECT_EQ(0, wait_fork(pid));
+    }
+}
+
+/**
+ * @test udp_recv.recvmmsg_batch
+ * @brief
+ *    Receive of several datagrams with one recvmmsg() call
+ *
+ * @details
+ *    Each message gets its own datagram, length and control messages, in the
+ *    order of the sender.
+ */
+TEST_F(udp_recv, recvmmsg_batch)
+{
+    const int n_msgs = 16;
+    const int vlen = 8;
+    int pid = fork();
+
+    if (0 == pid) { // Child
+        barrier_fork(pid);
+
+        int fd = udp_base::sock_create();
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = connect(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                char buffer[n_msgs + 100];
+                for (int i = 0; i < n_msgs; i++) {
+                    memset(buffer, 'a' + i, sizeof(buffer));
+                    rc = send(fd, buffer, 100 + i, 0);
+                    EXPECT_EQ(100 + i, rc);
+                }
+            }
+
+            close(fd);
+        }
+
+        // This exit is very important, otherwise the fork
+        // keeps running and may duplicate other tests.
+        exit(testing::Test::HasFailure());
+    } else { // Parent
+        int fd = udp_base::sock_create_to(m_family, false, 10);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int val = 1;
+            bool pktinfo = (m_family == AF_INET);
+            if (pktinfo) {
+                EXPECT_EQ_ERRNO(0, setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &val, sizeof(val)));
+            }
+            int rc = bind(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                barrier_fork(pid);
+
+                static char buffer[vlen][1024];
+                char control[vlen][CMSG_SPACE(sizeof(struct in_pktinfo))];
+                iovec vec[vlen];
+                mmsghdr mmsg[vlen];
+                int total = 0;
+
+                while (total < n_msgs) {
+                    memset(mmsg, 0, sizeof(mmsg));
+                    for (int i = 0; i < vlen; i++) {
+                        vec[i] = {.iov_base = buffer[i], .iov_len = sizeof(buffer[i])};
+                        mmsg[i].msg_hdr.msg_iov = &vec[i];
+                        mmsg[i].msg_hdr.msg_iovlen = 1U;
+                        mmsg[i].msg_hdr.msg_control = control[i];
+                        mmsg[i].msg_hdr.msg_controllen = sizeof(control[i]);
+                    }
+                    rc = recvmmsg(fd, mmsg, vlen, MSG_WAITFORONE, nullptr);
+                    EXPECT_LE_ERRNO(1, rc);
+                    if (rc <= 0) {
+                        break;
+                    }
+
+                    for (int i = 0; i < rc; i++, total++) {
+                        EXPECT_EQ(100U + total, mmsg[i].msg_len);
+                        EXPECT_EQ('a' + total, buffer[i][0]);
+                        EXPECT_EQ('a' + total, buffer[i][mmsg[i].msg_len - 1]);
+                        if (pktinfo) {
+                            cmsghdr *cmsg = CMSG_FIRSTHDR(&mmsg[i].msg_hdr);
+                            EXPECT_TRUE(cmsg && cmsg->cmsg_level == IPPROTO_IP &&
+                                        cmsg->cmsg_type == IP_PKTINFO);
+                        }
+                    }
+                }
+                EXPECT_EQ(n_msgs, total);
+            }
+
+            close(fd);
+        }
+
+        EXPECT_EQ(0, wait_fork(pid));
+    }
+}
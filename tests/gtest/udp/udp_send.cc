@@ -762,3 +762,76 @@ TEST_F(udp_send, DISABLED_null_iov_elements_fragmented)
         EXPECT_EQ(0, wait_fork(pid));
     }
 }
+
+/**
+ * @test udp_send.sendmmsg_batch
+ * @brief
+ *    Send of several datagrams with one sendmmsg() call
+ *
+ * @details
+ *    All the datagrams are reported as sent and arrive in order.
+ */
+TEST_F(udp_send, sendmmsg_batch)
+{
+    const int n_msgs = 16;
+    int pid = fork();
+
+    if (0 == pid) { // Child
+        barrier_fork(pid);
+
+        int fd = udp_base::sock_create();
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = connect(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                static char buffer[n_msgs][100 + n_msgs];
+                iovec vec[n_msgs];
+                mmsghdr mmsg[n_msgs];
+
+                memset(mmsg, 0, sizeof(mmsg));
+                for (int i = 0; i < n_msgs; i++) {
+                    memset(buffer[i], 'a' + i, sizeof(buffer[i]));
+                    vec[i] = {.iov_base = buffer[i], .iov_len = 100U + i};
+                    mmsg[i].msg_hdr.msg_iov = &vec[i];
+                    mmsg[i].msg_hdr.msg_iovlen = 1U;
+                }
+                rc = sendmmsg(fd, mmsg, n_msgs, 0);
+                EXPECT_EQ_ERRNO(n_msgs, rc);
+                for (int i = 0; i < rc; i++) {
+                    EXPECT_EQ(100U + i, mmsg[i].msg_len);
+                }
+            }
+
+            close(fd);
+        }
+
+        // This exit is very important, otherwise the fork
+        // keeps running and may duplicate other tests.
+        exit(testing::Test::HasFailure());
+    } else { // Parent
+        int fd = udp_base::sock_create_to(m_family, false, 10);
+        EXPECT_LE_ERRNO(0, fd);
+        if (0 <= fd) {
+            int rc = bind(fd, &server_addr.addr, sizeof(server_addr));
+            EXPECT_EQ_ERRNO(0, rc);
+            if (0 == rc) {
+                barrier_fork(pid);
+
+                char buffer[1024];
+                for (int i = 0; i < n_msgs; i++) {
+                    rc = recv(fd, buffer, sizeof(buffer), 0);
+                    EXPECT_EQ(100 + i, rc);
+                    if (rc <= 0) {
+                        break;
+                    }
+                    EXPECT_EQ('a' + i, buffer[0]);
+                }
+            }
+
+            close(fd);
+        }
+
+        EXPECT_EQ(0, wait_fork(pid));
+    }
+}
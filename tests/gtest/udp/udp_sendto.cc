@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
  */
 
+#include <netinet/udp.h>
+
 #include "common/def.h"
 #include "common/log.h"
 #include "common/sys.h"
@@ -203,3 +205,70 @@ TEST_F(udp_sendto, ti_6)
 
     close(fd);
 }
+
+/**
+ * @test udp_sendto.ti_7
+ * @brief
+ *    sendmsg() with UDP_SEGMENT control message and socket option
+ * @details
+ *    The payload is sent as several datagrams of gso_size bytes each.
+ *    A segment which does not fit into a single packet is rejected.
+ */
+TEST_F(udp_sendto, ti_7)
+{
+    int rc = EOK;
+    int fd;
+    int val;
+    char buf[4000] = "hello";
+    char control[CMSG_SPACE(sizeof(uint16_t))] = {0};
+    struct iovec iov = {buf, sizeof(buf)};
+    struct msghdr msg;
+    struct cmsghdr *cmsg;
+
+    fd = udp_base::sock_create();
+    ASSERT_LE(0, fd);
+
+    errno = EOK;
+    rc = bind(fd, (struct sockaddr *)&client_addr, sizeof(client_addr));
+    EXPECT_EQ(EOK, errno);
+    EXPECT_EQ(0, rc);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = (void *)&server_addr;
+    msg.msg_namelen = sizeof(server_addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *(uint16_t *)CMSG_DATA(cmsg) = 1000;
+
+    errno = EOK;
+    rc = sendmsg(fd, &msg, 0);
+    EXPECT_EQ(EOK, errno);
+    EXPECT_EQ(sizeof(buf), static_cast<size_t>(rc));
+
+    val = 1200;
+    errno = EOK;
+    rc = setsockopt(fd, IPPROTO_UDP, UDP_SEGMENT, &val, sizeof(val));
+    EXPECT_EQ(EOK, errno);
+    EXPECT_EQ(0, rc);
+
+    errno = EOK;
+    rc = sendto(fd, (void *)buf, sizeof(buf), 0, (struct sockaddr *)&server_addr,
+                sizeof(server_addr));
+    EXPECT_EQ(EOK, errno);
+    EXPECT_EQ(sizeof(buf), static_cast<size_t>(rc));
+
+    *(uint16_t *)CMSG_DATA(cmsg) = 3000;
+
+    errno = EOK;
+    rc = sendmsg(fd, &msg, 0);
+    EXPECT_EQ(EINVAL, errno);
+    EXPECT_EQ(-1, rc);
+
+    close(fd);
+}
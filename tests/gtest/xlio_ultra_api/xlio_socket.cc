@@ -220,4 +220,118 @@ TEST_F(ultra_api_socket, ti_3)
     destroy_poll_group(group);
 }
 
+/**
+ * @test ultra_api_socket.ti_4
+ * @brief
+ *    Set the SO_XLIO_TX_WATERMARKS thresholds
+ * @details
+ *    A low watermark over the high one is rejected, a zero high disables the events.
+ */
+TEST_F(ultra_api_socket, ti_4)
+{
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+    struct xlio_tx_watermarks wm;
+    int rc;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = 0,
+        .domain = client_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    base_create_socket(&sattr, &sock);
+
+    wm.low = 16384U;
+    wm.high = 65536U;
+    rc = xlio_api->xlio_socket_setsockopt(sock, SOL_SOCKET, SO_XLIO_TX_WATERMARKS, &wm,
+                                          sizeof(wm));
+    EXPECT_EQ(0, rc);
+
+    wm.low = wm.high + 1U;
+    rc = xlio_api->xlio_socket_setsockopt(sock, SOL_SOCKET, SO_XLIO_TX_WATERMARKS, &wm,
+                                          sizeof(wm));
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    wm.low = 0U;
+    wm.high = 0U;
+    rc = xlio_api->xlio_socket_setsockopt(sock, SOL_SOCKET, SO_XLIO_TX_WATERMARKS, &wm,
+                                          sizeof(wm));
+    EXPECT_EQ(0, rc);
+
+    base_destroy_socket(sock);
+    destroy_poll_group(group);
+}
+
+/**
+ * @test ultra_api_socket.ti_5
+ * @brief
+ *    Send of a receive buffer with invalid arguments
+ * @details
+ *    A NULL buffer or an empty range is rejected before the buffer is touched.
+ */
+TEST_F(ultra_api_socket, ti_5)
+{
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+    struct xlio_socket_send_attr attr = {};
+    int rc;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = 0,
+        .domain = client_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    base_create_socket(&sattr, &sock);
+
+    rc = xlio_api->xlio_socket_send_buf(sock, nullptr, 0U, 64U, &attr);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EINVAL, errno);
+
+    base_destroy_socket(sock);
+    destroy_poll_group(group);
+}
+
+/**
+ * @test ultra_api_socket.ti_6
+ * @brief
+ *    Change the priority of a socket
+ * @details
+ *    A high priority socket is created, moved to the normal priority and back, the group
+ *    is flushed in between.
+ */
+TEST_F(ultra_api_socket, ti_6)
+{
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+    int rc;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_HIGH_PRIO,
+        .domain = client_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    base_create_socket(&sattr, &sock);
+
+    xlio_api->xlio_poll_group_flush(group);
+    rc = xlio_api->xlio_socket_update(sock, 0U, 1U);
+    EXPECT_EQ(0, rc);
+    xlio_api->xlio_poll_group_flush(group);
+    rc = xlio_api->xlio_socket_update(sock, XLIO_SOCKET_FLAG_HIGH_PRIO, 2U);
+    EXPECT_EQ(0, rc);
+    xlio_api->xlio_poll_group_poll(group);
+
+    base_destroy_socket(sock);
+    destroy_poll_group(group);
+}
+
 #endif /* EXTRA_API_ENABLED */
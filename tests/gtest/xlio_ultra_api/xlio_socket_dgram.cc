@@ -0,0 +1,757 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include "common/def.h"
+#include "common/log.h"
+#include "common/sys.h"
+#include "common/base.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <netinet/udp.h>
+#include <vector>
+#include "core/xlio_base.h"
+#include "core/util/xlio_stats.h"
+
+#if defined(EXTRA_API_ENABLED) && (EXTRA_API_ENABLED == 1)
+
+static int terminated_counter = 0;
+static int rx_cb_counter = 0;
+static int comp_cb_counter = 0;
+static int rx_batch_entries = 0;
+static int tx_ts_cb_counter = 0;
+static int rx_filter_drops = 0;
+static std::vector<struct xlio_buf *> rx_filter_bufs;
+static in_port_t rx_filter_port = 0;
+static sockaddr_store_t rx_from;
+static const char *data_to_send = "I Love XLIO!";
+
+/*
+ * Sums the MPWQE counters of the rings in the statistics file of this process.
+ * The library copies the counters to the file only on a request of a reader, so the
+ * function requests a fresh copy like xlio_stats does and waits for it.
+ */
+static bool get_mpwqe_stats(uint64_t &sessions, uint64_t &pkts)
+{
+    const char *dir = getenv("XLIO_STATS_SHMEM_DIR");
+    char path[PATH_MAX];
+    sh_mem_t *p_sh_mem;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/xliostat.%d", dir ? dir : "/tmp/xlio", getpid());
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    p_sh_mem = static_cast<sh_mem_t *>(
+        mmap(nullptr, sizeof(sh_mem_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    close(fd);
+    if (p_sh_mem == MAP_FAILED) {
+        return false;
+    }
+
+    __atomic_add_fetch(&p_sh_mem->reader_counter, 1, __ATOMIC_SEQ_CST);
+    usleep(2 * (STATS_READER_DELAY) * 1000);
+
+    sessions = pkts = 0;
+    for (int i = 0; i < NUM_OF_SUPPORTED_RINGS; ++i) {
+        if (p_sh_mem->ring_inst_arr[i].b_enabled) {
+            sessions += p_sh_mem->ring_inst_arr[i].ring_stats.n_tx_mpwqe_sessions;
+            pkts += p_sh_mem->ring_inst_arr[i].ring_stats.n_tx_mpwqe_pkts;
+        }
+    }
+    munmap(p_sh_mem, sizeof(sh_mem_t));
+    return true;
+}
+
+class ultra_api_socket_dgram : public ultra_api_base {
+public:
+    virtual void SetUp()
+    {
+        errno = EOK;
+        terminated_counter = 0;
+        rx_cb_counter = 0;
+        comp_cb_counter = 0;
+        rx_batch_entries = 0;
+        tx_ts_cb_counter = 0;
+        rx_filter_drops = 0;
+        rx_filter_bufs.clear();
+        memset(&rx_from, 0, sizeof(rx_from));
+    };
+    virtual void TearDown() {};
+    void destroy_poll_group(xlio_poll_group_t group) { base_destroy_poll_group(group); }
+    static void socket_event_cb(xlio_socket_t sock, uintptr_t userdata_sq, int event, int value)
+    {
+        UNREFERENCED_PARAMETER(sock);
+        UNREFERENCED_PARAMETER(userdata_sq);
+        UNREFERENCED_PARAMETER(value);
+        if (event == XLIO_SOCKET_EVENT_TERMINATED) {
+            terminated_counter++;
+        }
+    }
+    static void socket_comp_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op)
+    {
+        UNREFERENCED_PARAMETER(sock);
+        UNREFERENCED_PARAMETER(userdata_sq);
+        EXPECT_EQ(0x1U, userdata_op);
+        comp_cb_counter++;
+    }
+    static void socket_rx_cb(xlio_socket_t sock, uintptr_t userdata_sq, void *data, size_t len,
+                             struct xlio_buf *buf)
+    {
+        UNREFERENCED_PARAMETER(userdata_sq);
+        socklen_t fromlen = sizeof(rx_from);
+
+        rx_cb_counter++;
+        EXPECT_EQ(strlen(data_to_send), len);
+        EXPECT_EQ(0, memcmp(data, data_to_send, len));
+        int rc = xlio_api->xlio_socket_buf_dgram_info(sock, buf, (struct sockaddr *)&rx_from,
+                                                      &fromlen, nullptr);
+        EXPECT_EQ(0, rc);
+        struct xlio_buf_rx_info info;
+        rc = xlio_api->xlio_socket_buf_rx_info(sock, buf, &info);
+        EXPECT_EQ(0, rc);
+        EXPECT_LT(info.hw_timestamp.tv_nsec, 1000000000L);
+        rc = xlio_api->xlio_socket_buf_rx_info(sock, buf, nullptr);
+        EXPECT_EQ(-1, rc);
+        EXPECT_EQ(EINVAL, errno);
+        xlio_api->xlio_socket_buf_free(sock, buf);
+    }
+    static void socket_rx_batch_cb(xlio_socket_t sock, uintptr_t userdata_sq,
+                                   const struct xlio_rx_batch_entry *entries, unsigned count)
+    {
+        UNREFERENCED_PARAMETER(userdata_sq);
+        EXPECT_LT(0U, count);
+        for (unsigned i = 0; i < count; ++i) {
+            EXPECT_EQ(strlen(data_to_send), entries[i].len);
+            EXPECT_EQ(0, memcmp(entries[i].data, data_to_send, entries[i].len));
+            xlio_api->xlio_socket_buf_free(sock, entries[i].buf);
+        }
+        rx_batch_entries += count;
+    }
+    static void socket_tx_ts_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op,
+                                const struct timespec *hw_timestamp)
+    {
+        UNREFERENCED_PARAMETER(sock);
+        UNREFERENCED_PARAMETER(userdata_sq);
+        EXPECT_EQ(0x2U, userdata_op);
+        EXPECT_LT(hw_timestamp->tv_nsec, 1000000000L);
+        tx_ts_cb_counter++;
+    }
+    static int rx_filter_cb(xlio_poll_group_t group, const struct xlio_rx_filter_pkt *pkt,
+                            struct xlio_buf *buf)
+    {
+        UNREFERENCED_PARAMETER(group);
+        if (!pkt->l4_hdr || pkt->l4_proto != IPPROTO_UDP) {
+            return XLIO_RX_FILTER_PASS;
+        }
+        const struct udphdr *udp = static_cast<const struct udphdr *>(pkt->l4_hdr);
+        const char *payload = reinterpret_cast<const char *>(udp + 1);
+        if (udp->dest != rx_filter_port ||
+            payload + 4 > static_cast<const char *>(pkt->frame) + pkt->len) {
+            return XLIO_RX_FILTER_PASS;
+        }
+        if (memcmp(payload, "drop", 4) == 0) {
+            rx_filter_drops++;
+            return XLIO_RX_FILTER_DROP;
+        }
+        if (memcmp(payload, "take", 4) == 0) {
+            rx_filter_bufs.push_back(buf);
+            return XLIO_RX_FILTER_REDIRECT;
+        }
+        return XLIO_RX_FILTER_PASS;
+    }
+    static void socket_accept_cb(xlio_socket_t sock, xlio_socket_t parent_sock,
+                                 uintptr_t parent_userdata)
+    {
+        UNREFERENCED_PARAMETER(sock);
+        UNREFERENCED_PARAMETER(parent_sock);
+        UNREFERENCED_PARAMETER(parent_userdata);
+    }
+};
+
+/**
+ * @test ultra_api_socket_dgram.ti_1
+ * @brief
+ *    Create UDP socket and check that TERMINATED event is triggered on destroy
+ * @details
+ */
+TEST_F(ultra_api_socket_dgram, ti_1)
+{
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = client_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    base_create_socket(&sattr, &sock);
+
+    int rc = xlio_api->xlio_socket_listen(sock);
+    EXPECT_EQ(-1, rc);
+    EXPECT_EQ(EOPNOTSUPP, errno);
+
+    base_destroy_socket(sock);
+    while (terminated_counter < 1) {
+        xlio_api->xlio_poll_group_poll(group);
+    }
+
+    destroy_poll_group(group);
+}
+
+/**
+ * @test ultra_api_socket_dgram.ti_2
+ * @brief
+ *    UDP sendto(initiator)/receive(target) within a polling group
+ * @details
+ */
+TEST_F(ultra_api_socket_dgram, ti_2)
+{
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        while (rx_cb_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        EXPECT_EQ(client_addr.addr.sa_family, rx_from.addr.sa_family);
+        EXPECT_EQ(sys_get_port((struct sockaddr *)&client_addr),
+                  sys_get_port((struct sockaddr *)&rx_from));
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_FLUSH,
+            .mkey = 0,
+            .userdata_op = 0x1,
+        };
+        rc = xlio_api->xlio_socket_sendto(sock, data_to_send, strlen(data_to_send),
+                                          (struct sockaddr *)&server_addr, sizeof(server_addr),
+                                          &attr);
+        ASSERT_EQ(0, rc);
+        EXPECT_EQ(1, comp_cb_counter);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+/**
+ * @test ultra_api_socket_dgram.ti_3
+ * @brief
+ *    UDP send(initiator)/batched receive(target) within a polling group
+ * @details
+ */
+TEST_F(ultra_api_socket_dgram, ti_3)
+{
+    const int msg_nr = 8;
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    xlio_poll_group_attr gattr = {
+        .flags = XLIO_GROUP_FLAG_ATTR_SIZE,
+        .socket_event_cb = &socket_event_cb,
+        .socket_comp_cb = &socket_comp_cb,
+        .socket_rx_cb = &socket_rx_cb,
+        .socket_accept_cb = &socket_accept_cb,
+        .attr_size = sizeof(xlio_poll_group_attr),
+        .socket_rx_batch_cb = &socket_rx_batch_cb,
+    };
+    rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+    ASSERT_EQ(0, rc);
+
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        while (rx_batch_entries < msg_nr) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        // The per-buffer callback is overridden by the batched one.
+        EXPECT_EQ(0, rx_cb_counter);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_INLINE,
+            .mkey = 0,
+            .userdata_op = 0,
+        };
+        for (int i = 0; i < msg_nr; ++i) {
+            rc = xlio_api->xlio_socket_send(sock, data_to_send, strlen(data_to_send), &attr);
+            ASSERT_EQ(0, rc);
+        }
+        EXPECT_EQ(0, comp_cb_counter);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+/**
+ * @test ultra_api_socket_dgram.ti_4
+ * @brief
+ *    UDP sendto(initiator)/blocking wait and receive(target) within a polling group
+ * @details
+ */
+TEST_F(ultra_api_socket_dgram, ti_4)
+{
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        // No traffic yet, the wait must expire.
+        rc = xlio_api->xlio_poll_group_wait(group, 10);
+        EXPECT_EQ(0, rc);
+        EXPECT_EQ(0, rx_cb_counter);
+
+        barrier_fork(pid, true);
+
+        while (rx_cb_counter < 1) {
+            rc = xlio_api->xlio_poll_group_wait(group, 100);
+            ASSERT_LE(0, rc);
+        }
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+        usleep(100000); // Let the child go to sleep
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_INLINE,
+            .mkey = 0,
+            .userdata_op = 0,
+        };
+        rc = xlio_api->xlio_socket_sendto(sock, data_to_send, strlen(data_to_send),
+                                          (struct sockaddr *)&server_addr, sizeof(server_addr),
+                                          &attr);
+        ASSERT_EQ(0, rc);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+/**
+ * @test ultra_api_socket_dgram.ti_5
+ * @brief
+ *    UDP send(initiator) of deferred datagrams in a dirty group/receive(target)
+ * @details
+ *    With XLIO_TX_MPWQE=1, datagrams sent without XLIO_SOCKET_SEND_FLAG_FLUSH are posted by
+ *    xlio_poll_group_flush() and must be packed into multi-packet WQEs. Otherwise, they are
+ *    sent immediately. The MPWQE check needs an adapter with the enhanced MPW support.
+ */
+TEST_F(ultra_api_socket_dgram, ti_5)
+{
+    const int msg_nr = 16;
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    xlio_poll_group_attr gattr = {
+        .flags = XLIO_GROUP_FLAG_DIRTY | XLIO_GROUP_FLAG_ATTR_SIZE,
+        .socket_event_cb = &socket_event_cb,
+        .socket_comp_cb = &socket_comp_cb,
+        .socket_rx_cb = &socket_rx_cb,
+        .socket_accept_cb = &socket_accept_cb,
+        .attr_size = sizeof(xlio_poll_group_attr),
+        .socket_rx_batch_cb = &socket_rx_batch_cb,
+    };
+    rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+    ASSERT_EQ(0, rc);
+
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        while (rx_batch_entries < msg_nr) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+
+        const char *mpwqe_env = getenv("XLIO_TX_MPWQE");
+        bool check_mpwqe = mpwqe_env && atoi(mpwqe_env);
+        uint64_t sessions_before = 0, pkts_before = 0;
+        if (check_mpwqe) {
+            check_mpwqe = get_mpwqe_stats(sessions_before, pkts_before);
+            if (!check_mpwqe) {
+                log_warn("Statistics file is not available, MPWQE is not checked\n");
+            }
+        }
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_INLINE,
+            .mkey = 0,
+            .userdata_op = 0,
+        };
+        for (int i = 0; i < msg_nr; ++i) {
+            rc = xlio_api->xlio_socket_send(sock, data_to_send, strlen(data_to_send), &attr);
+            ASSERT_EQ(0, rc);
+        }
+        xlio_api->xlio_poll_group_flush(group);
+
+        if (check_mpwqe) {
+            uint64_t sessions = 0, pkts = 0;
+            ASSERT_TRUE(get_mpwqe_stats(sessions, pkts));
+            sessions -= sessions_before;
+            pkts -= pkts_before;
+            // At least one session carried more than a single datagram
+            EXPECT_LT(0U, sessions);
+            EXPECT_LT(sessions, pkts);
+            EXPECT_GE(static_cast<uint64_t>(msg_nr), pkts);
+        }
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+/**
+ * @test ultra_api_socket_dgram.ti_6
+ * @brief
+ *    UDP send(initiator) with TX HW timestamps/receive(target)
+ * @details
+ *    Datagrams sent with XLIO_SOCKET_SEND_FLAG_TIMESTAMP report their timestamps with
+ *    socket_tx_ts_cb. A datagram sent before the neighbor is resolved has no timestamp.
+ */
+TEST_F(ultra_api_socket_dgram, ti_6)
+{
+    const int msg_nr = 16;
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    xlio_poll_group_attr gattr = {
+        .flags = XLIO_GROUP_FLAG_ATTR_SIZE,
+        .socket_event_cb = &socket_event_cb,
+        .socket_comp_cb = &socket_comp_cb,
+        .socket_rx_cb = &socket_rx_cb,
+        .socket_accept_cb = &socket_accept_cb,
+        .attr_size = sizeof(xlio_poll_group_attr),
+        .socket_rx_batch_cb = &socket_rx_batch_cb,
+        .accept_pool_size = 0,
+        .ring_poll_budget = 0,
+        .socket_comp_batch_cb = nullptr,
+        .socket_tx_ts_cb = &socket_tx_ts_cb,
+    };
+    rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+    ASSERT_EQ(0, rc);
+
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        while (rx_batch_entries < msg_nr - 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_INLINE | XLIO_SOCKET_SEND_FLAG_FLUSH |
+                XLIO_SOCKET_SEND_FLAG_TIMESTAMP,
+            .mkey = 0,
+            .userdata_op = 0x2,
+        };
+        for (int i = 0; i < msg_nr; ++i) {
+            rc = xlio_api->xlio_socket_send(sock, data_to_send, strlen(data_to_send), &attr);
+            ASSERT_EQ(0, rc);
+            usleep(1000);
+        }
+        for (int i = 0; i < 1000000 && tx_ts_cb_counter < msg_nr - 1; ++i) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        EXPECT_LE(msg_nr - 1, tx_ts_cb_counter);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+
+/**
+ * @test ultra_api_socket_dgram.ti_7
+ * @brief
+ *    UDP receive(target) through an RX filter of the group
+ * @details
+ *    The filter drops the datagrams starting with "drop" and takes over the ones
+ *    starting with "take". Only the other datagrams reach the RX callback.
+ */
+TEST_F(ultra_api_socket_dgram, ti_7)
+{
+    const int msg_nr = 8;
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    xlio_poll_group_attr gattr = {
+        .flags = XLIO_GROUP_FLAG_ATTR_SIZE,
+        .socket_event_cb = &socket_event_cb,
+        .socket_comp_cb = &socket_comp_cb,
+        .socket_rx_cb = &socket_rx_cb,
+        .socket_accept_cb = &socket_accept_cb,
+        .attr_size = sizeof(xlio_poll_group_attr),
+        .socket_rx_batch_cb = nullptr,
+        .socket_accept_batch_cb = nullptr,
+        .accept_pool_size = 0,
+        .ring_poll_budget = 0,
+        .socket_comp_batch_cb = nullptr,
+        .socket_tx_ts_cb = nullptr,
+        .rx_filter_cb = &rx_filter_cb,
+    };
+    rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+    ASSERT_EQ(0, rc);
+
+    xlio_socket_attr sattr = {
+        .flags = XLIO_SOCKET_FLAG_DGRAM,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        rx_filter_port = server_addr.addr4.sin_port;
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        // The datagram for the RX callback is sent last
+        while (rx_cb_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        EXPECT_EQ(msg_nr, rx_filter_drops);
+        EXPECT_EQ(msg_nr, static_cast<int>(rx_filter_bufs.size()));
+        for (struct xlio_buf *buf : rx_filter_bufs) {
+            xlio_api->xlio_poll_group_buf_free(group, buf);
+        }
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to bind
+
+        xlio_socket_send_attr attr = {
+            .flags = XLIO_SOCKET_SEND_FLAG_FLUSH | XLIO_SOCKET_SEND_FLAG_INLINE,
+            .mkey = 0,
+            .userdata_op = 0,
+        };
+        for (int i = 0; i < msg_nr; ++i) {
+            rc = xlio_api->xlio_socket_send(sock, "drop this", 9, &attr);
+            ASSERT_EQ(0, rc);
+            rc = xlio_api->xlio_socket_send(sock, "take this", 9, &attr);
+            ASSERT_EQ(0, rc);
+        }
+        rc = xlio_api->xlio_socket_send(sock, data_to_send, strlen(data_to_send), &attr);
+        ASSERT_EQ(0, rc);
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+#endif /* EXTRA_API_ENABLED */
@@ -61,6 +61,19 @@ public:
         accepted_sockets.push_back(sock);
         connected_counter++;
     }
+
+    static void socket_accept_batch_cb(xlio_poll_group_t group,
+                                       const struct xlio_accept_batch_entry *entries,
+                                       unsigned count)
+    {
+        UNREFERENCED_PARAMETER(group);
+        EXPECT_GT(count, 0U);
+        for (unsigned i = 0; i < count; ++i) {
+            EXPECT_NE(entries[i].sock, entries[i].parent);
+            accepted_sockets.push_back(entries[i].sock);
+            connected_counter++;
+        }
+    }
 };
 
 /**
@@ -138,4 +151,195 @@ TEST_F(ultra_api_socket_listen_connect, ti_1)
     }
 }
 
+/**
+ * @test socket_connect.ti_2
+ * @brief
+ *    Same as ti_1, but the target accepts with the batched callback and
+ *    pre-constructed accept sockets
+ * @details
+ */
+TEST_F(ultra_api_socket_listen_connect, ti_2)
+{
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    connected_counter = 0;
+    terminated_counter = 0;
+    accepted_sockets.clear();
+
+    if (pid == 0) {
+        // Child process - server side
+        xlio_poll_group_attr gattr = {
+            .flags = XLIO_GROUP_FLAG_ATTR_SIZE,
+            .socket_event_cb = &socket_event_cb,
+            .socket_comp_cb = &socket_comp_cb,
+            .socket_rx_cb = &socket_rx_cb,
+            .socket_accept_cb = nullptr,
+            .attr_size = sizeof(xlio_poll_group_attr),
+            .socket_rx_batch_cb = nullptr,
+            .socket_accept_batch_cb = &socket_accept_batch_cb,
+            .accept_pool_size = 4,
+        };
+        rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+        ASSERT_EQ(0, rc);
+
+        xlio_socket_attr sattr = {
+            .flags = 0,
+            .domain = server_addr.addr.sa_family,
+            .group = group,
+            .userdata_sq = 0,
+        };
+        base_create_socket(&sattr, &sock);
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_listen(sock);
+        ASSERT_EQ(0, rc);
+        // Let the group pre-construct the accept sockets.
+        xlio_api->xlio_poll_group_poll(group);
+        barrier_fork(pid, true); // Tell parent that we are listening
+        while (connected_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        base_wait_for_delayed_acks(group);
+        barrier_fork(pid, true); // Tell parent that we got last ack
+        base_destroy_socket(sock);
+        base_cleanup_accepted_sockets(accepted_sockets);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        // Parent process - client side
+        base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                               &socket_accept_cb);
+        xlio_socket_attr sattr = {
+            .flags = 0,
+            .domain = server_addr.addr.sa_family,
+            .group = group,
+            .userdata_sq = 0,
+        };
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // Wait for child to listen
+
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        while (connected_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        base_wait_for_delayed_acks(group);
+
+        barrier_fork(pid, true); // Wait for child to get last ack
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
+/**
+ * @test socket_connect.ti_3
+ * @brief
+ *    The initiator takes an established connection from a connection pool
+ * @details
+ *    The pooled connection is established in the background, so the initiator
+ *    doesn't receive XLIO_SOCKET_EVENT_ESTABLISHED for it.
+ */
+TEST_F(ultra_api_socket_listen_connect, ti_3)
+{
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    connected_counter = 0;
+    terminated_counter = 0;
+    accepted_sockets.clear();
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+
+    if (pid == 0) {
+        // Child process - server side
+        xlio_socket_attr sattr = {
+            .flags = 0,
+            .domain = server_addr.addr.sa_family,
+            .group = group,
+            .userdata_sq = 0,
+        };
+        base_create_socket(&sattr, &sock);
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+        rc = xlio_api->xlio_socket_listen(sock);
+        ASSERT_EQ(0, rc);
+        barrier_fork(pid, true); // Tell parent that we are listening
+        while (connected_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        base_wait_for_delayed_acks(group);
+        barrier_fork(pid, true); // Tell parent that we got last ack
+        base_destroy_socket(sock);
+        base_cleanup_accepted_sockets(accepted_sockets);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+        destroy_poll_group(group);
+        exit(testing::Test::HasFailure());
+    } else {
+        // Parent process - client side
+        barrier_fork(pid, true); // Wait for child to listen
+
+        rc = xlio_api->xlio_poll_group_get_connection(group, (struct sockaddr *)&server_addr,
+                                                      sizeof(server_addr), 0, &sock);
+        ASSERT_EQ(-1, rc);
+        ASSERT_EQ(ENOENT, errno);
+
+        rc = xlio_api->xlio_poll_group_connect_pool(group, (struct sockaddr *)&server_addr,
+                                                    sizeof(server_addr), 1);
+        ASSERT_EQ(0, rc);
+
+        do {
+            xlio_api->xlio_poll_group_poll(group);
+            rc = xlio_api->xlio_poll_group_get_connection(group, (struct sockaddr *)&server_addr,
+                                                          sizeof(server_addr), 0, &sock);
+        } while (rc != 0 && errno == EAGAIN);
+        ASSERT_EQ(0, rc);
+        EXPECT_EQ(0, connected_counter);
+
+        // Release the pool before the replacement is connected.
+        rc = xlio_api->xlio_poll_group_connect_pool(group, (struct sockaddr *)&server_addr,
+                                                    sizeof(server_addr), 0);
+        ASSERT_EQ(0, rc);
+
+        base_wait_for_delayed_acks(group);
+
+        barrier_fork(pid, true); // Wait for child to get last ack
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
 #endif /* EXTRA_API_ENABLED */
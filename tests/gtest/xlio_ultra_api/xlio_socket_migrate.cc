@@ -17,6 +17,7 @@
 
 static int connected_counter = 0;
 static int terminated_counter = 0;
+static int migrated_counter = 0;
 static int rx_cb_counter = 0;
 static int comp_cb_counter = 0;
 static const char *data_to_send = "I Love XLIO!";
@@ -37,6 +38,7 @@ public:
         // Reset static variables between test runs
         connected_counter = 0;
         terminated_counter = 0;
+        migrated_counter = 0;
         rx_cb_counter = 0;
         comp_cb_counter = 0;
         data_sent_completed = 0;
@@ -69,6 +71,8 @@ public:
             terminated_counter++;
         } else if (event == XLIO_SOCKET_EVENT_TERMINATED) {
             terminated_counter++;
+        } else if (event == XLIO_SOCKET_EVENT_MIGRATED) {
+            migrated_counter++;
         }
     }
     static void socket_comp_cb(xlio_socket_t sock, uintptr_t userdata_sq, uintptr_t userdata_op)
@@ -210,4 +214,111 @@ TEST_F(ultra_api_socket_migrate, ti_1)
     }
 }
 
+/**
+ * @test ultra_api_socket_migrate.ti_2
+ * @brief
+ *    Asynchronous migration of an accepted TCP socket with xlio_socket_migrate()
+ * @details
+ */
+TEST_F(ultra_api_socket_migrate, ti_2)
+{
+    int rc;
+    int pid = fork();
+    ultra_api_base::SetUp();
+    xlio_poll_group_t group;
+    xlio_socket_t sock;
+
+    base_create_poll_group(&group, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                           &socket_accept_cb);
+    xlio_socket_attr sattr = {
+        .flags = 0,
+        .domain = server_addr.addr.sa_family,
+        .group = group,
+        .userdata_sq = 0,
+    };
+    if (pid == 0) {
+        xlio_poll_group_t group_2;
+        base_create_poll_group(&group_2, &socket_event_cb, &socket_comp_cb, &socket_rx_cb,
+                               &socket_accept_cb);
+
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        rc = xlio_api->xlio_socket_listen(sock);
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true);
+
+        while (data_received < data_bytes_to_be_sent) {
+            xlio_api->xlio_poll_group_poll(group);
+            xlio_api->xlio_poll_group_poll(group_2);
+            if (do_migrate) {
+                rc = xlio_api->xlio_socket_migrate(accepted_sockets.back(), group_2);
+                EXPECT_EQ(0, rc);
+                do_migrate = false;
+            }
+        }
+
+        base_wait_for_delayed_acks(group);
+
+        ASSERT_EQ(data_received, data_bytes_to_be_sent);
+        EXPECT_EQ(1, migrated_counter);
+
+        barrier_fork(pid, true);
+
+        base_destroy_socket(sock);
+        base_cleanup_accepted_sockets(accepted_sockets);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        if (mr_buf) {
+            ibv_dereg_mr(mr_buf);
+            mr_buf = NULL;
+        }
+
+        destroy_poll_group(group);
+        destroy_poll_group(group_2);
+        exit(testing::Test::HasFailure());
+    } else {
+        base_create_socket(&sattr, &sock);
+
+        rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr, sizeof(client_addr));
+        ASSERT_EQ(0, rc);
+
+        barrier_fork(pid, true); // wait for child to bind and listen
+
+        rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                           sizeof(server_addr));
+        ASSERT_EQ(0, rc);
+
+        int sent_bytes = 0;
+        while (data_sent_completed < data_bytes_to_be_sent) {
+            xlio_api->xlio_poll_group_poll(group);
+            if (connected_counter > 0 && sent_bytes < data_bytes_to_be_sent) {
+                base_send_single_msg(sock, data_to_send, strlen(data_to_send), strlen(data_to_send),
+                                     0, mr_buf, sndbuf);
+                sent_bytes += strlen(data_to_send);
+            }
+        }
+
+        base_wait_for_delayed_acks(group);
+
+        ASSERT_EQ(data_sent_completed, data_bytes_to_be_sent);
+
+        barrier_fork(pid, true); // wait for child to accept + receive last ack
+
+        base_destroy_socket(sock);
+        while (terminated_counter < 1) {
+            xlio_api->xlio_poll_group_poll(group);
+        }
+
+        destroy_poll_group(group);
+
+        wait_fork(pid);
+    }
+}
+
 #endif /* EXTRA_API_ENABLED */
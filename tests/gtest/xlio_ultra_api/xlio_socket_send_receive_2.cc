@@ -23,6 +23,11 @@ static const char *data_to_send = "I Love XLIO!";
 static struct ibv_pd *pd = NULL;
 static struct ibv_mr *mr_buf;
 static char sndbuf[256];
+static bool use_xlio_mkey = false;
+static uint32_t xlio_mkey = 0;
+static unsigned ring_poll_budget = 0;
+static unsigned rx_queues = 0;
+static bool use_comp_batch = false;
 static std::vector<xlio_socket_t> accepted_sockets;
 
 class ultra_api_socket_send_receive_2 : public ultra_api_base {
@@ -37,6 +42,11 @@ public:
         comp_cb_counter = 0;
         pd = NULL;
         mr_buf = NULL;
+        use_xlio_mkey = false;
+        xlio_mkey = 0;
+        ring_poll_budget = 0;
+        rx_queues = 0;
+        use_comp_batch = false;
         accepted_sockets.clear();
     };
     virtual void TearDown()
@@ -68,6 +78,15 @@ public:
         UNREFERENCED_PARAMETER(userdata_op);
         comp_cb_counter++;
     }
+    static void socket_comp_batch_cb(xlio_socket_t sock, uintptr_t userdata_sq,
+                                     const uintptr_t *userdata_ops, unsigned count)
+    {
+        UNREFERENCED_PARAMETER(sock);
+        UNREFERENCED_PARAMETER(userdata_sq);
+        ASSERT_GT(count, 0U);
+        EXPECT_EQ(0x1U, userdata_ops[count - 1]);
+        comp_cb_counter += count;
+    }
 
     static void socket_rx_cb(xlio_socket_t sock, uintptr_t userdata_sq, void *data, size_t len,
                              struct xlio_buf *buf)
@@ -95,10 +114,126 @@ public:
         connected_counter++;
         pd = xlio_api->xlio_socket_get_pd(sock);
         ASSERT_TRUE(pd != NULL);
+        if (use_xlio_mkey) {
+            rc = xlio_api->xlio_mem_register(pd, sndbuf, sizeof(sndbuf), &xlio_mkey);
+            ASSERT_EQ(rc, 0);
+
+            struct xlio_socket_send_attr attr = {
+                .flags = 0,
+                .mkey = xlio_mkey,
+                .userdata_op = 0x1,
+            };
+            memcpy(sndbuf, data_to_send, strlen(data_to_send));
+            rc = xlio_api->xlio_socket_send(sock, sndbuf, strlen(data_to_send), &attr);
+            ASSERT_EQ(rc, 0);
+            xlio_api->xlio_socket_flush(sock);
+            return;
+        }
         mr_buf = ibv_reg_mr(pd, sndbuf, sizeof(sndbuf), IBV_ACCESS_LOCAL_WRITE);
         ASSERT_TRUE(mr_buf != NULL);
         base_send_single_msg(sock, data_to_send, strlen(data_to_send), 0x1, 0, mr_buf, sndbuf);
     }
+
+    void run_send_receive()
+    {
+        int rc;
+        int pid = fork();
+        ultra_api_base::SetUp();
+        xlio_poll_group_t group;
+        xlio_socket_t sock;
+
+        xlio_poll_group_attr gattr = {
+            .flags = XLIO_GROUP_FLAG_ATTR_SIZE,
+            .socket_event_cb = &socket_event_cb,
+            .socket_comp_cb = use_comp_batch ? nullptr : &socket_comp_cb,
+            .socket_rx_cb = &socket_rx_cb,
+            .socket_accept_cb = &socket_accept_cb,
+            .attr_size = sizeof(xlio_poll_group_attr),
+            .ring_poll_budget = ring_poll_budget,
+            .socket_comp_batch_cb = use_comp_batch ? &socket_comp_batch_cb : nullptr,
+            .rx_queues = rx_queues,
+        };
+        rc = xlio_api->xlio_poll_group_create(&gattr, &group);
+        ASSERT_EQ(0, rc);
+        xlio_socket_attr sattr = {
+            .flags = 0,
+            .domain = server_addr.addr.sa_family,
+            .group = group,
+            .userdata_sq = 0,
+        };
+        base_create_socket(&sattr, &sock);
+        if (pid == 0) {
+            // Child process - server side
+            rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&server_addr,
+                                            sizeof(server_addr));
+            ASSERT_EQ(0, rc);
+
+            rc = xlio_api->xlio_socket_listen(sock);
+            ASSERT_EQ(0, rc);
+
+            barrier_fork(pid, true);
+
+            while (connected_counter < 1 || comp_cb_counter < 1) {
+                xlio_api->xlio_poll_group_poll(group);
+            }
+
+            base_wait_for_delayed_acks(group);
+
+            barrier_fork(pid, true);
+
+            base_destroy_socket(sock);
+            base_cleanup_accepted_sockets(accepted_sockets);
+            while (terminated_counter < 1) {
+                xlio_api->xlio_poll_group_poll(group);
+            }
+
+            if (mr_buf) {
+                ibv_dereg_mr(mr_buf);
+                mr_buf = NULL;
+            }
+            if (use_xlio_mkey) {
+                // Only keys returned by xlio_mem_register() can be deregistered
+                rc = xlio_api->xlio_mem_deregister(pd, xlio_mkey + 1);
+                EXPECT_EQ(-1, rc);
+                EXPECT_EQ(EINVAL, errno);
+                rc = xlio_api->xlio_mem_deregister(pd, xlio_mkey);
+                EXPECT_EQ(0, rc);
+                rc = xlio_api->xlio_mem_deregister(pd, xlio_mkey);
+                EXPECT_EQ(-1, rc);
+            }
+
+            destroy_poll_group(group);
+            exit(testing::Test::HasFailure());
+        } else {
+            // Parent process - client side
+            rc = xlio_api->xlio_socket_bind(sock, (struct sockaddr *)&client_addr,
+                                            sizeof(client_addr));
+            ASSERT_EQ(0, rc);
+
+            barrier_fork(pid, true); // Wait for child to bind and listen
+
+            rc = xlio_api->xlio_socket_connect(sock, (struct sockaddr *)&server_addr,
+                                               sizeof(server_addr));
+            ASSERT_EQ(0, rc);
+
+            while (connected_counter < 1 || rx_cb_counter < 1) {
+                xlio_api->xlio_poll_group_poll(group);
+            }
+
+            base_wait_for_delayed_acks(group);
+
+            barrier_fork(pid, true); // Wait for child to accept + receive last ack
+
+            base_destroy_socket(sock);
+            while (terminated_counter < 1) {
+                xlio_api->xlio_poll_group_poll(group);
+            }
+
+            destroy_poll_group(group);
+
+            wait_fork(pid);
+        }
+    }
 };
 
 /**
@@ -185,4 +320,53 @@ TEST_F(ultra_api_socket_send_receive_2, ti_1)
     }
 }
 
+/**
+ * @test ultra_api_socket_send_receive_2.ti_2
+ * @brief
+ *    Same as ti_1, but the target sends from memory registered with xlio_mem_register()
+ * @details
+ */
+TEST_F(ultra_api_socket_send_receive_2, ti_2)
+{
+    use_xlio_mkey = true;
+    run_send_receive();
+}
+
+/**
+ * @test ultra_api_socket_send_receive_2.ti_3
+ * @brief
+ *    Same as ti_1, but the rings are polled with a single CQE budget
+ * @details
+ */
+TEST_F(ultra_api_socket_send_receive_2, ti_3)
+{
+    ring_poll_budget = 1U;
+    run_send_receive();
+}
+
+/**
+ * @test ultra_api_socket_send_receive_2.ti_4
+ * @brief
+ *    Same as ti_1, but the completions are reported by the batched callback
+ * @details
+ */
+TEST_F(ultra_api_socket_send_receive_2, ti_4)
+{
+    use_comp_batch = true;
+    run_send_receive();
+}
+
+/**
+ * @test ultra_api_socket_send_receive_2.ti_5
+ * @brief
+ *    Same as ti_1, but the groups have several RX queues per device
+ * @details
+ *    The accepted connection is steered to a ring other than the one of the listen socket.
+ */
+TEST_F(ultra_api_socket_send_receive_2, ti_5)
+{
+    rx_queues = 4U;
+    run_send_receive();
+}
+
 #endif /* EXTRA_API_ENABLED */
@@ -0,0 +1,684 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+/*
+ * Replays the UDP multicast packets of a pcap with sendmmsg() and receives them on the other
+ * side, for the capacity tests of the feed handlers. Run both sides with XLIO preloaded:
+ *
+ *   LD_PRELOAD=libxlio.so ./mc_replay -r -f feed.pcap -i <local ip>
+ *   LD_PRELOAD=libxlio.so ./mc_replay -s -f feed.pcap -i <local ip> -x 2
+ *
+ * The sender keeps the gaps between the packets of the capture, divided by the speedup (-x),
+ * and sends the packets which are due together with one sendmmsg(). The small datagrams go
+ * through the MPWQE of XLIO (XLIO_TX_MPWQE). The sender stamps a sequence per group and the
+ * send time over the start of the payload, the receiver reports per group the lost and the
+ * reordered packets and the one way latency percentiles. The latency needs the clocks of the
+ * two hosts synchronized, e.g. with PTP. The receiver joins all the groups found in the pcap
+ * and prints the report after the idle timeout (-T) or on SIGINT.
+ * The drops inside XLIO, e.g. n_rx_ready_byte_drop and the CQ out of buffer drops, are shown
+ * by xlio_stats -p <receiver pid> during the run.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#define PCAP_MAGIC_USEC 0xA1B2C3D4U
+#define PCAP_MAGIC_NSEC 0xA1B23C4DU
+
+#define LINKTYPE_ETHERNET  1U
+#define LINKTYPE_RAW       101U
+#define LINKTYPE_LINUX_SLL 113U
+
+#define ETH_P_IPV4  0x0800U
+#define ETH_P_8021Q 0x8100U
+#define ETH_P_8021AD 0x88A8U
+
+#define STAMP_MAGIC 0x58524D43U // "XRMC"
+
+#define MAX_GROUPS  1024
+#define MAX_BATCH   64
+#define HIST_SUB    32
+#define HIST_BUCKETS (64 * HIST_SUB)
+
+struct pcap_file_hdr {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+};
+
+struct pcap_rec_hdr {
+    uint32_t ts_sec;
+    uint32_t ts_frac;
+    uint32_t incl_len;
+    uint32_t orig_len;
+};
+
+// Written over the start of the payload, the datagrams shorter than it are sent as they are
+struct stamp {
+    uint32_t magic;
+    uint32_t group;
+    uint64_t seq;
+    uint64_t tx_ns;
+};
+
+struct packet {
+    uint64_t ts_ns; // Capture time relative to the first packet
+    uint32_t group;
+    uint32_t len;
+    uint8_t *payload;
+};
+
+struct group {
+    struct sockaddr_in addr;
+    uint64_t seq; // Next sequence, sender and receiver
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t lost;
+    uint64_t reordered;
+    uint64_t unstamped;
+    uint64_t hist[HIST_BUCKETS];
+    int fd;
+};
+
+static struct group g_groups[MAX_GROUPS];
+static unsigned g_n_groups;
+static struct packet *g_packets;
+static size_t g_n_packets;
+
+static volatile sig_atomic_t g_quit;
+
+static const char *g_pcap;
+static const char *g_local_ip;
+static double g_speedup = 1.0;
+static unsigned g_loops = 1;
+static unsigned g_batch = 32;
+static unsigned g_idle_sec = 5;
+static int g_ttl = 1;
+static bool g_stamp = true;
+static bool g_busy;
+
+static uint64_t now_ns(clockid_t clk)
+{
+    struct timespec ts;
+
+    clock_gettime(clk, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cpu_ns(void)
+{
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return ((uint64_t)ru.ru_utime.tv_sec + (uint64_t)ru.ru_stime.tv_sec) * 1000000000ULL +
+        ((uint64_t)ru.ru_utime.tv_usec + (uint64_t)ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_quit = 1;
+}
+
+static uint32_t swap32(uint32_t v, bool swap)
+{
+    return swap ? __builtin_bswap32(v) : v;
+}
+
+static unsigned find_group(uint32_t addr, uint16_t port)
+{
+    unsigned i;
+
+    for (i = 0; i < g_n_groups; ++i) {
+        if (g_groups[i].addr.sin_addr.s_addr == addr && g_groups[i].addr.sin_port == port) {
+            return i;
+        }
+    }
+    if (g_n_groups == MAX_GROUPS) {
+        fprintf(stderr, "More than %d groups in the pcap\n", MAX_GROUPS);
+        exit(1);
+    }
+    g_groups[i].addr.sin_family = AF_INET;
+    g_groups[i].addr.sin_addr.s_addr = addr;
+    g_groups[i].addr.sin_port = port;
+    g_groups[i].fd = -1;
+    return g_n_groups++;
+}
+
+// Returns the IPv4 header of the frame or NULL
+static const uint8_t *frame_to_ip(const uint8_t *frame, size_t len, uint32_t linktype)
+{
+    uint16_t proto;
+    size_t off;
+
+    switch (linktype) {
+    case LINKTYPE_RAW:
+        return len ? frame : NULL;
+    case LINKTYPE_LINUX_SLL:
+        if (len < 16) {
+            return NULL;
+        }
+        proto = (uint16_t)(frame[14] << 8 | frame[15]);
+        off = 16;
+        break;
+    case LINKTYPE_ETHERNET:
+        if (len < 14) {
+            return NULL;
+        }
+        proto = (uint16_t)(frame[12] << 8 | frame[13]);
+        off = 14;
+        while ((proto == ETH_P_8021Q || proto == ETH_P_8021AD) && off + 4 <= len) {
+            proto = (uint16_t)(frame[off + 2] << 8 | frame[off + 3]);
+            off += 4;
+        }
+        break;
+    default:
+        return NULL;
+    }
+    return (proto == ETH_P_IPV4 && off < len) ? frame + off : NULL;
+}
+
+// Keeps the UDP payload of the multicast datagrams, the fragments are skipped
+static void add_frame(const uint8_t *frame, size_t len, uint32_t linktype, uint64_t ts_ns)
+{
+    static uint64_t first_ns;
+    static size_t capacity;
+    const uint8_t *ip = frame_to_ip(frame, len, linktype);
+    const uint8_t *udp;
+    struct packet *pkt;
+    uint32_t daddr;
+    uint16_t dport;
+    size_t ihl, ip_len, udp_len;
+
+    if (!ip) {
+        return;
+    }
+    len -= (size_t)(ip - frame);
+    if (len < 20 || (ip[0] >> 4) != 4 || ip[9] != IPPROTO_UDP) {
+        return;
+    }
+    ihl = (size_t)(ip[0] & 0x0F) * 4;
+    ip_len = (size_t)(ip[2] << 8 | ip[3]);
+    if (ihl < 20 || ip_len > len || ip_len < ihl + 8 || (ip[6] & 0x3F) || ip[7]) {
+        return;
+    }
+    memcpy(&daddr, ip + 16, sizeof(daddr));
+    if (!IN_MULTICAST(ntohl(daddr))) {
+        return;
+    }
+    udp = ip + ihl;
+    memcpy(&dport, udp + 2, sizeof(dport));
+    udp_len = (size_t)(udp[4] << 8 | udp[5]);
+    if (udp_len < 8 || udp_len > ip_len - ihl) {
+        return;
+    }
+
+    if (g_n_packets == capacity) {
+        capacity = capacity ? capacity * 2 : 65536;
+        g_packets = realloc(g_packets, capacity * sizeof(*g_packets));
+        if (!g_packets) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    if (!g_n_packets) {
+        first_ns = ts_ns;
+    }
+    pkt = &g_packets[g_n_packets++];
+    pkt->ts_ns = ts_ns > first_ns ? ts_ns - first_ns : 0;
+    pkt->group = find_group(daddr, dport);
+    pkt->len = (uint32_t)(udp_len - 8);
+    pkt->payload = malloc(pkt->len ? pkt->len : 1);
+    if (!pkt->payload) {
+        perror("malloc");
+        exit(1);
+    }
+    memcpy(pkt->payload, udp + 8, pkt->len);
+}
+
+static void load_pcap(const char *path)
+{
+    struct pcap_file_hdr fh;
+    struct pcap_rec_hdr rh;
+    uint8_t *frame = NULL;
+    uint32_t frame_size = 0;
+    bool swap, nsec;
+    FILE *f = fopen(path, "rb");
+
+    if (!f || fread(&fh, sizeof(fh), 1, f) != 1) {
+        fprintf(stderr, "Can't read %s: %s\n", path, f ? "short file" : strerror(errno));
+        exit(1);
+    }
+    swap = fh.magic == __builtin_bswap32(PCAP_MAGIC_USEC) ||
+        fh.magic == __builtin_bswap32(PCAP_MAGIC_NSEC);
+    nsec = swap32(fh.magic, swap) == PCAP_MAGIC_NSEC;
+    if (swap32(fh.magic, swap) != PCAP_MAGIC_USEC && !nsec) {
+        fprintf(stderr, "%s isn't a pcap file (pcapng isn't supported)\n", path);
+        exit(1);
+    }
+    fh.linktype = swap32(fh.linktype, swap);
+
+    while (fread(&rh, sizeof(rh), 1, f) == 1) {
+        uint32_t incl_len = swap32(rh.incl_len, swap);
+        uint64_t ts_ns = (uint64_t)swap32(rh.ts_sec, swap) * 1000000000ULL +
+            (uint64_t)swap32(rh.ts_frac, swap) * (nsec ? 1U : 1000U);
+
+        if (incl_len > frame_size) {
+            frame_size = incl_len;
+            frame = realloc(frame, frame_size);
+            if (!frame) {
+                perror("realloc");
+                exit(1);
+            }
+        }
+        if (fread(frame, 1, incl_len, f) != incl_len) {
+            break;
+        }
+        add_frame(frame, incl_len, fh.linktype, ts_ns);
+    }
+    free(frame);
+    fclose(f);
+
+    if (!g_n_packets) {
+        fprintf(stderr, "No UDP multicast packets in %s\n", path);
+        exit(1);
+    }
+    printf("Loaded %zu packets of %u groups, %.3f sec\n", g_n_packets, g_n_groups,
+           (double)g_packets[g_n_packets - 1].ts_ns / 1e9);
+}
+
+static int run_sender(void)
+{
+    struct mmsghdr msgs[MAX_BATCH];
+    struct iovec iovs[MAX_BATCH];
+    struct group *grps[MAX_BATCH];
+    uint64_t sent = 0, sent_bytes = 0, start_ns, end_ns, start_cpu;
+    unsigned loop;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    if (g_local_ip) {
+        struct in_addr local;
+
+        local.s_addr = inet_addr(g_local_ip);
+        if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local))) {
+            perror("IP_MULTICAST_IF");
+            return 1;
+        }
+    }
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &g_ttl, sizeof(g_ttl))) {
+        perror("IP_MULTICAST_TTL");
+        return 1;
+    }
+
+    memset(msgs, 0, sizeof(msgs));
+    start_cpu = cpu_ns();
+    start_ns = now_ns(CLOCK_MONOTONIC);
+    for (loop = 0; loop < g_loops && !g_quit; ++loop) {
+        uint64_t loop_ns = now_ns(CLOCK_MONOTONIC);
+        size_t i = 0;
+
+        while (i < g_n_packets && !g_quit) {
+            uint64_t now = now_ns(CLOCK_MONOTONIC);
+            uint64_t tx_ns;
+            unsigned n = 0;
+            int rc, j;
+
+            // The packets which are due go in one batch
+            while (i < g_n_packets && n < g_batch &&
+                   (g_speedup <= 0 ||
+                    loop_ns + (uint64_t)((double)g_packets[i].ts_ns / g_speedup) <= now)) {
+                struct packet *pkt = &g_packets[i++];
+                struct group *grp = &g_groups[pkt->group];
+
+                grps[n] = grp;
+                iovs[n].iov_base = pkt->payload;
+                iovs[n].iov_len = pkt->len;
+                msgs[n].msg_hdr.msg_name = &grp->addr;
+                msgs[n].msg_hdr.msg_namelen = sizeof(grp->addr);
+                msgs[n].msg_hdr.msg_iov = &iovs[n];
+                msgs[n].msg_hdr.msg_iovlen = 1;
+                ++n;
+            }
+            if (!n) {
+                if (!g_busy) {
+                    uint64_t due = loop_ns + (uint64_t)((double)g_packets[i].ts_ns / g_speedup);
+                    // Sleep only for the long gaps, the wakeup latency is tens of usec
+                    if (due - now > 200000ULL) {
+                        struct timespec ts = {0, (long)(due - now - 100000ULL)};
+                        nanosleep(&ts, NULL);
+                    }
+                }
+                continue;
+            }
+
+            tx_ns = now_ns(CLOCK_REALTIME);
+            for (j = 0; g_stamp && j < (int)n; ++j) {
+                if (iovs[j].iov_len >= sizeof(struct stamp)) {
+                    struct stamp st = {STAMP_MAGIC, (uint32_t)(grps[j] - g_groups),
+                                       grps[j]->seq++, tx_ns};
+
+                    memcpy(iovs[j].iov_base, &st, sizeof(st));
+                }
+            }
+
+            for (j = 0; j < (int)n; j += rc) {
+                rc = sendmmsg(fd, msgs + j, n - (unsigned)j, 0);
+                if (rc < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == ENOBUFS) {
+                        rc = 0;
+                        continue;
+                    }
+                    perror("sendmmsg");
+                    return 1;
+                }
+            }
+            for (j = 0; j < (int)n; ++j) {
+                sent_bytes += iovs[j].iov_len;
+            }
+            sent += n;
+        }
+    }
+    end_ns = now_ns(CLOCK_MONOTONIC);
+
+    printf("Sent %" PRIu64 " packets, %" PRIu64 " bytes in %.3f sec: %.0f pps, %.1f Mbps, "
+           "%.0f ns CPU per packet\n",
+           sent, sent_bytes, (double)(end_ns - start_ns) / 1e9,
+           (double)sent * 1e9 / (double)(end_ns - start_ns + 1),
+           (double)sent_bytes * 8e3 / (double)(end_ns - start_ns + 1),
+           sent ? (double)(cpu_ns() - start_cpu) / (double)sent : 0.0);
+    close(fd);
+    return 0;
+}
+
+static unsigned hist_index(uint64_t v)
+{
+    unsigned shift;
+
+    if (v < 2 * HIST_SUB) {
+        return (unsigned)v;
+    }
+    shift = (unsigned)(63 - __builtin_clzll(v)) - 5;
+    return shift * HIST_SUB + (unsigned)(v >> shift);
+}
+
+static uint64_t hist_value(unsigned idx)
+{
+    if (idx < 2 * HIST_SUB) {
+        return idx;
+    }
+    return (uint64_t)(idx % HIST_SUB + HIST_SUB) << (idx / HIST_SUB - 1);
+}
+
+static uint64_t hist_percentile(const uint64_t *hist, uint64_t count, double pct)
+{
+    uint64_t rank = (uint64_t)((double)count * pct / 100.0);
+    uint64_t seen = 0;
+    unsigned i;
+
+    for (i = 0; i < HIST_BUCKETS; ++i) {
+        seen += hist[i];
+        if (seen > rank) {
+            return hist_value(i);
+        }
+    }
+    return hist_value(HIST_BUCKETS - 1);
+}
+
+static void account(struct group *grp, const uint8_t *buf, size_t len, uint64_t rx_ns)
+{
+    struct stamp st;
+
+    grp->packets++;
+    grp->bytes += len;
+    if (len < sizeof(st)) {
+        grp->unstamped++;
+        return;
+    }
+    memcpy(&st, buf, sizeof(st));
+    if (st.magic != STAMP_MAGIC) {
+        grp->unstamped++;
+        return;
+    }
+    if (st.seq >= grp->seq) {
+        grp->lost += st.seq - grp->seq;
+        grp->seq = st.seq + 1;
+    } else {
+        // A late packet was counted as lost
+        grp->reordered++;
+        if (grp->lost) {
+            grp->lost--;
+        }
+    }
+    grp->hist[hist_index(rx_ns > st.tx_ns ? rx_ns - st.tx_ns : 0)]++;
+}
+
+static void report(uint64_t cpu)
+{
+    uint64_t total = 0, lost = 0;
+    unsigned i;
+
+    printf("%-21s %12s %14s %10s %10s %9s %9s %9s %9s\n", "group", "packets", "bytes", "lost",
+           "reordered", "p50 us", "p99 us", "p99.9 us", "max us");
+    for (i = 0; i < g_n_groups; ++i) {
+        struct group *grp = &g_groups[i];
+        uint64_t stamped = grp->packets - grp->unstamped;
+        char name[32];
+        unsigned max = HIST_BUCKETS;
+
+        while (max && !grp->hist[max - 1]) {
+            --max;
+        }
+        snprintf(name, sizeof(name), "%s:%u", inet_ntoa(grp->addr.sin_addr),
+                 ntohs(grp->addr.sin_port));
+        printf("%-21s %12" PRIu64 " %14" PRIu64 " %10" PRIu64 " %10" PRIu64
+               " %9.1f %9.1f %9.1f %9.1f\n",
+               name, grp->packets, grp->bytes, grp->lost, grp->reordered,
+               stamped ? (double)hist_percentile(grp->hist, stamped, 50.0) / 1e3 : 0.0,
+               stamped ? (double)hist_percentile(grp->hist, stamped, 99.0) / 1e3 : 0.0,
+               stamped ? (double)hist_percentile(grp->hist, stamped, 99.9) / 1e3 : 0.0,
+               max ? (double)hist_value(max - 1) / 1e3 : 0.0);
+        total += grp->packets;
+        lost += grp->lost;
+    }
+    printf("Received %" PRIu64 " packets, lost %" PRIu64 ", %.0f ns CPU per packet\n", total, lost,
+           total ? (double)cpu / (double)total : 0.0);
+}
+
+static int run_receiver(void)
+{
+    struct mmsghdr msgs[MAX_BATCH];
+    struct iovec iovs[MAX_BATCH];
+    static uint8_t bufs[MAX_BATCH][65536];
+    struct epoll_event events[64];
+    uint64_t start_cpu = 0, last_rx_ns = 0;
+    bool started = false;
+    unsigned i;
+    int ep = epoll_create1(0);
+
+    if (ep < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+    for (i = 0; i < g_n_groups; ++i) {
+        struct group *grp = &g_groups[i];
+        struct sockaddr_in bind_addr = grp->addr;
+        struct ip_mreq mreq;
+        struct epoll_event ev;
+        int one = 1;
+
+        grp->seq = 0;
+        grp->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (grp->fd < 0) {
+            perror("socket");
+            return 1;
+        }
+        setsockopt(grp->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(grp->fd, (struct sockaddr *)&bind_addr, sizeof(bind_addr))) {
+            perror("bind");
+            return 1;
+        }
+        mreq.imr_multiaddr = grp->addr.sin_addr;
+        mreq.imr_interface.s_addr = g_local_ip ? inet_addr(g_local_ip) : INADDR_ANY;
+        if (setsockopt(grp->fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq))) {
+            perror("IP_ADD_MEMBERSHIP");
+            return 1;
+        }
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, grp->fd, &ev)) {
+            perror("epoll_ctl");
+            return 1;
+        }
+    }
+    for (i = 0; i < MAX_BATCH; ++i) {
+        iovs[i].iov_base = bufs[i];
+        iovs[i].iov_len = sizeof(bufs[i]);
+    }
+    printf("Joined %u groups\n", g_n_groups);
+
+    while (!g_quit) {
+        int n = epoll_wait(ep, events, 64, g_busy ? 0 : 100);
+        int e;
+
+        if (n <= 0) {
+            if (started && now_ns(CLOCK_MONOTONIC) - last_rx_ns > g_idle_sec * 1000000000ULL) {
+                break;
+            }
+            continue;
+        }
+        if (!started) {
+            start_cpu = cpu_ns();
+            started = true;
+        }
+        for (e = 0; e < n; ++e) {
+            struct group *grp = &g_groups[events[e].data.u32];
+            int rc, j;
+
+            do {
+                memset(msgs, 0, sizeof(msgs));
+                for (j = 0; j < (int)g_batch; ++j) {
+                    msgs[j].msg_hdr.msg_iov = &iovs[j];
+                    msgs[j].msg_hdr.msg_iovlen = 1;
+                }
+                rc = recvmmsg(grp->fd, msgs, g_batch, MSG_DONTWAIT, NULL);
+                if (rc > 0) {
+                    uint64_t rx_ns = now_ns(CLOCK_REALTIME);
+
+                    for (j = 0; j < rc; ++j) {
+                        account(grp, bufs[j], msgs[j].msg_len, rx_ns);
+                    }
+                }
+            } while (rc == (int)g_batch);
+        }
+        last_rx_ns = now_ns(CLOCK_MONOTONIC);
+    }
+
+    report(started ? cpu_ns() - start_cpu : 0);
+    for (i = 0; i < g_n_groups; ++i) {
+        close(g_groups[i].fd);
+    }
+    close(ep);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s -s|-r -f <pcap> [options]\n"
+            "  -s          replay the pcap\n"
+            "  -r          receive the groups of the pcap and report\n"
+            "  -f <pcap>   capture, Ethernet, Linux cooked or raw IP link type\n"
+            "  -i <ip>     local interface address\n"
+            "  -x <n>      speedup of the capture timing, 0 sends as fast as possible (1)\n"
+            "  -l <n>      sender loops over the capture (1)\n"
+            "  -b <n>      packets per sendmmsg()/recvmmsg() (32, max %d)\n"
+            "  -t <n>      multicast TTL (1)\n"
+            "  -T <sec>    receiver idle timeout (5)\n"
+            "  -n          don't stamp the payload, no loss and latency report\n"
+            "  -B          busy poll instead of sleeping\n",
+            prog, MAX_BATCH);
+}
+
+int main(int argc, char **argv)
+{
+    int sender = -1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "srf:i:x:l:b:t:T:nBh")) != -1) {
+        switch (opt) {
+        case 's':
+            sender = 1;
+            break;
+        case 'r':
+            sender = 0;
+            break;
+        case 'f':
+            g_pcap = optarg;
+            break;
+        case 'i':
+            g_local_ip = optarg;
+            break;
+        case 'x':
+            g_speedup = atof(optarg);
+            break;
+        case 'l':
+            g_loops = (unsigned)atoi(optarg);
+            break;
+        case 'b':
+            g_batch = (unsigned)atoi(optarg);
+            break;
+        case 't':
+            g_ttl = atoi(optarg);
+            break;
+        case 'T':
+            g_idle_sec = (unsigned)atoi(optarg);
+            break;
+        case 'n':
+            g_stamp = false;
+            break;
+        case 'B':
+            g_busy = true;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (sender < 0 || !g_pcap || !g_batch || g_batch > MAX_BATCH) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    load_pcap(g_pcap);
+    return sender ? run_sender() : run_receiver();
+}
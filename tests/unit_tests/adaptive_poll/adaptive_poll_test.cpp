@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/util/adaptive_poll.h"
+
+/**
+ * @test adaptive_poll_test.ti_1
+ * @brief
+ *    The configured polling is used until a wait is seen
+ * @details
+ */
+TEST(adaptive_poll_test, ti_1)
+{
+    adaptive_poll poll;
+
+    EXPECT_EQ(100000U, poll.budget_usec(100000U));
+    EXPECT_EQ(0U, poll.budget_usec(0U));
+}
+
+/**
+ * @test adaptive_poll_test.ti_2
+ * @brief
+ *    Short waits are polled for twice the average
+ * @details
+ *    The budget doesn't go below ADAPTIVE_POLL_MIN_USEC nor above the configured polling.
+ */
+TEST(adaptive_poll_test, ti_2)
+{
+    adaptive_poll poll;
+
+    for (int i = 0; i < 100; ++i) {
+        poll.update(50U);
+    }
+    EXPECT_EQ(100U, poll.budget_usec(100000U));
+    EXPECT_EQ(80U, poll.budget_usec(80U));
+
+    for (int i = 0; i < 100; ++i) {
+        poll.update(0U);
+    }
+    EXPECT_EQ(ADAPTIVE_POLL_MIN_USEC, poll.budget_usec(100000U));
+}
+
+/**
+ * @test adaptive_poll_test.ti_3
+ * @brief
+ *    Waits longer than the configured polling block after a short poll
+ * @details
+ *    The estimate moves back once the waits become short.
+ */
+TEST(adaptive_poll_test, ti_3)
+{
+    adaptive_poll poll;
+
+    poll.update(1000000U);
+    EXPECT_EQ(ADAPTIVE_POLL_MIN_USEC, poll.budget_usec(100000U));
+    EXPECT_EQ(5U, poll.budget_usec(5U));
+
+    for (int i = 0; i < 200; ++i) {
+        poll.update(20U);
+    }
+    EXPECT_EQ(40U, poll.budget_usec(100000U));
+}
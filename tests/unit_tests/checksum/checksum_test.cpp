@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include "core/util/checksum.h"
+#include "core/proto/nvme_tcp.h"
+
+static std::vector<uint8_t> make_data(size_t len)
+{
+    std::vector<uint8_t> data(len);
+    uint32_t seed = 12345U;
+
+    for (auto &byte : data) {
+        seed = seed * 1103515245U + 12345U;
+        byte = static_cast<uint8_t>(seed >> 16U);
+    }
+    return data;
+}
+
+// RFC 1071 over the 16 bit words of the memory order
+static uint16_t ref_csum(const uint8_t *p, size_t len)
+{
+    uint64_t sum = 0;
+
+    for (; len > 1; len -= 2, p += 2) {
+        uint16_t word;
+        memcpy(&word, p, sizeof(word));
+        sum += word;
+    }
+    if (len) {
+        uint16_t word = 0;
+        memcpy(&word, p, 1);
+        sum += word;
+    }
+    while (sum >> 16U) {
+        sum = (sum & 0xFFFFU) + (sum >> 16U);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+static uint32_t ref_crc32c(uint32_t crc, const uint8_t *p, size_t len)
+{
+    while (len--) {
+        crc ^= *p++;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1U) ^ ((crc & 1U) ? 0x82F63B78U : 0U);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @test checksum_test.ti_1
+ * @brief
+ *    The Internet checksum matches the reference
+ * @details
+ *    All the lengths around the vector widths, at an odd start address too.
+ */
+TEST(checksum_test, ti_1)
+{
+    std::vector<uint8_t> data = make_data(4096 + 1);
+
+    for (size_t offset = 0; offset < 2; ++offset) {
+        for (size_t len = 0; len <= 1500; ++len) {
+            const uint8_t *p = data.data() + offset;
+            ASSERT_EQ(ref_csum(p, len), csum_fold(csum_partial(p, len, 0U))) << len;
+        }
+        const uint8_t *p = data.data() + offset;
+        ASSERT_EQ(ref_csum(p, 4096), csum_fold(csum_partial(p, 4096, 0U)));
+    }
+}
+
+/**
+ * @test checksum_test.ti_2
+ * @brief
+ *    The partial sums chain
+ * @details
+ *    A sum split at an even offset with the initial sum of the pseudo header, the all ones
+ *    buffer checks the carries.
+ */
+TEST(checksum_test, ti_2)
+{
+    std::vector<uint8_t> data(9000, 0xFF);
+    uint32_t sum = csum_partial(data.data(), 1000, 0xFFFFFFFFU);
+
+    sum = csum_partial(data.data() + 1000, data.size() - 1000, sum);
+    EXPECT_EQ(csum_fold(csum_partial(data.data(), data.size(), 0xFFFFFFFFU)), csum_fold(sum));
+    EXPECT_EQ(0U, csum_fold(sum));
+
+    data = make_data(9000);
+    sum = csum_partial(data.data(), 2048, 0U);
+    sum = csum_partial(data.data() + 2048, data.size() - 2048, sum);
+    EXPECT_EQ(ref_csum(data.data(), data.size()), csum_fold(sum));
+}
+
+/**
+ * @test checksum_test.ti_3
+ * @brief
+ *    CRC32C matches the reference and copies the data
+ * @details
+ *    The check value of the standard and the lengths around the interleaved blocks.
+ */
+TEST(checksum_test, ti_3)
+{
+    const char check[] = "123456789";
+    EXPECT_EQ(0xE3069283U, crc32c_final(crc32c(CRC32C_INIT, check, 9)));
+
+    std::vector<uint8_t> data = make_data(8192 + 7);
+    std::vector<uint8_t> copy(data.size());
+    const size_t lens[] = {0, 1, 7, 8, 255, 767, 768, 769, 1536, 4096, 8192 + 7};
+
+    for (size_t len : lens) {
+        uint32_t ref = ref_crc32c(CRC32C_INIT, data.data(), len);
+
+        EXPECT_EQ(ref, crc32c(CRC32C_INIT, data.data(), len)) << len;
+        std::fill(copy.begin(), copy.end(), 0);
+        EXPECT_EQ(ref, crc32c_copy(CRC32C_INIT, copy.data(), data.data(), len)) << len;
+        EXPECT_EQ(0, memcmp(copy.data(), data.data(), len)) << len;
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "tools/daemon/hash.h"
+
+static int s_freed = 0;
+
+static void count_free(void *ptr)
+{
+    ++s_freed;
+    free(ptr);
+}
+
+static int *new_value(int val)
+{
+    int *p = static_cast<int *>(malloc(sizeof(int)));
+    *p = val;
+    return p;
+}
+
+/**
+ * @test daemon_hash_test.ti_1
+ * @brief
+ *    The table grows on demand up to the maximum size
+ * @details
+ */
+TEST(daemon_hash_test, ti_1)
+{
+    hash_t ht = hash_create(&count_free, 65599);
+
+    ASSERT_NE(nullptr, ht);
+    EXPECT_GT(1000, hash_size(ht));
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_NE(nullptr, hash_put(ht, i * 7, new_value(i)));
+    }
+    EXPECT_EQ(10000, hash_count(ht));
+    EXPECT_LT(0, hash_resizes(ht));
+    EXPECT_LE(10000 * 4 / 3, hash_size(ht));
+    for (int i = 0; i < 10000; i++) {
+        int *p = static_cast<int *>(hash_get(ht, i * 7));
+        ASSERT_NE(nullptr, p);
+        EXPECT_EQ(i, *p);
+    }
+    EXPECT_EQ(nullptr, hash_get(ht, 3));
+
+    s_freed = 0;
+    hash_destroy(ht);
+    EXPECT_EQ(10000, s_freed);
+
+    // Not a prime number
+    EXPECT_EQ(nullptr, hash_create(&count_free, 100));
+}
+
+/**
+ * @test daemon_hash_test.ti_2
+ * @brief
+ *    The deleted elements keep the others reachable and the limit is kept
+ * @details
+ */
+TEST(daemon_hash_test, ti_2)
+{
+    hash_t ht = hash_create(&count_free, 7);
+
+    ASSERT_NE(nullptr, ht);
+    // The keys collide
+    for (int i = 0; i < 7; i++) {
+        ASSERT_NE(nullptr, hash_put(ht, 1 + i * 7, new_value(i)));
+    }
+    EXPECT_EQ(nullptr, hash_put(ht, 100, new_value(0)));
+    // The existing element is replaced when the table is full
+    int *p = new_value(42);
+    EXPECT_EQ(p, hash_put(ht, 15, p));
+
+    s_freed = 0;
+    hash_del(ht, 1);
+    hash_del(ht, 8);
+    EXPECT_EQ(2, s_freed);
+    EXPECT_EQ(5, hash_count(ht));
+    EXPECT_EQ(42, *static_cast<int *>(hash_get(ht, 15)));
+    EXPECT_EQ(nullptr, hash_get(ht, 8));
+
+    // The churn reuses the deleted elements
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_NE(nullptr, hash_put(ht, 1000 + i, new_value(i)));
+        hash_del(ht, 1000 + i);
+    }
+    EXPECT_EQ(5, hash_count(ht));
+    EXPECT_EQ(6, *static_cast<int *>(hash_get(ht, 43)));
+    hash_destroy(ht);
+}
@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/util/flow_table.h"
+
+// Same layout and hash as flow_spec_4t_key_ipv4 in dev/ring_slave.h
+struct __attribute__((packed)) test_4t_key {
+    uint32_t dst_ip;
+    uint32_t src_ip;
+    uint16_t dst_port;
+    uint16_t src_port;
+
+    size_t hash() const
+    {
+        std::hash<size_t> _hash;
+        return _hash((static_cast<size_t>(dst_ip) | (static_cast<size_t>(src_ip) << 32)) ^
+                     (static_cast<size_t>(src_port) << 32) ^ static_cast<size_t>(dst_port));
+    }
+};
+
+inline bool operator==(const test_4t_key &key1, const test_4t_key &key2)
+{
+    return (key1.src_port == key2.src_port) && (key1.src_ip == key2.src_ip) &&
+        (key1.dst_port == key2.dst_port) && (key1.dst_ip == key2.dst_ip);
+}
+
+namespace std {
+template <> class hash<test_4t_key> {
+public:
+    size_t operator()(const test_4t_key &key) const { return key.hash(); }
+};
+} // namespace std
+
+typedef flow_table<test_4t_key, uintptr_t> flow_table_t;
+
+static test_4t_key make_key(uint32_t i)
+{
+    // Many clients of a single listener, like the TCP map of a loaded server
+    return test_4t_key {0x0a000001U, 0x0b000000U + (i >> 16), 8080U,
+                        static_cast<uint16_t>(i & 0xffffU)};
+}
+
+class flow_table_test : public ::testing::Test {
+public:
+    flow_table_t table;
+};
+
+/**
+ * @test flow_table_test.ti_1
+ * @brief
+ *    Test insert, find and erase of a single key.
+ * @details
+ */
+TEST_F(flow_table_test, ti_1)
+{
+    test_4t_key key = make_key(1);
+
+    EXPECT_TRUE(table.find(key) == table.end());
+    table[key] = 100;
+    EXPECT_EQ(table.size(), 1UL);
+
+    auto itr = table.find(key);
+    ASSERT_TRUE(itr != table.end());
+    EXPECT_EQ(itr->second, 100UL);
+    EXPECT_TRUE(table.find(make_key(2)) == table.end());
+
+    table[key] = 200;
+    EXPECT_EQ(table.size(), 1UL);
+    EXPECT_EQ(table.find(key, table.prefetch(key))->second, 200UL);
+
+    EXPECT_TRUE(table.erase(table.find(key)) == table.end());
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.find(key) == table.end());
+}
+
+/**
+ * @test flow_table_test.ti_2
+ * @brief
+ *    Test growth and erase of interleaved keys.
+ * @details
+ *    Insert enough keys to rehash several times, erase every second key and check that
+ *    the remaining keys are still found after the tombstones are reused.
+ */
+TEST_F(flow_table_test, ti_2)
+{
+    const uint32_t n = 10000U;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        table[make_key(i)] = i + 1;
+    }
+    EXPECT_EQ(table.size(), n);
+
+    for (uint32_t i = 0; i < n; i += 2) {
+        table.erase(table.find(make_key(i)));
+    }
+    EXPECT_EQ(table.size(), n / 2);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        auto itr = table.find(make_key(i));
+        if (i % 2) {
+            ASSERT_TRUE(itr != table.end());
+            EXPECT_EQ(itr->second, i + 1);
+        } else {
+            EXPECT_TRUE(itr == table.end());
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i += 2) {
+        table[make_key(i)] = i + 1;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        auto itr = table.find(make_key(i));
+        ASSERT_TRUE(itr != table.end());
+        EXPECT_EQ(itr->second, i + 1);
+    }
+}
+
+/**
+ * @test flow_table_test.ti_3
+ * @brief
+ *    Test iteration with erase, the way the rings release all the rfs objects.
+ * @details
+ */
+TEST_F(flow_table_test, ti_3)
+{
+    const uint32_t n = 1000U;
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        table[make_key(i)] = i + 1;
+    }
+
+    uint32_t visited = 0;
+    auto itr = table.begin();
+    while (itr != table.end()) {
+        sum += itr->second;
+        ++visited;
+        itr = table.erase(itr);
+    }
+
+    EXPECT_EQ(visited, n);
+    EXPECT_EQ(sum, static_cast<uint64_t>(n) * (n + 1) / 2);
+    EXPECT_TRUE(table.empty());
+    EXPECT_TRUE(table.begin() == table.end());
+}
+
+// Maps the keys to a few hash values, so the keys share their probe chains and tags
+struct colliding_hash {
+    size_t operator()(const test_4t_key &key) const { return key.src_port % 4U; }
+};
+
+/**
+ * @test flow_table_test.ti_4
+ * @brief
+ *    Test erase and reinsert of colliding keys.
+ * @details
+ *    Every key collides with a quarter of the others. Keys are erased from the middle of
+ *    the probe chains and reinserted, the rest of the chains must stay reachable over the
+ *    tombstones. A long erase/reinsert churn must keep all the keys.
+ */
+TEST_F(flow_table_test, ti_4)
+{
+    const uint32_t n = 64U;
+    flow_table<test_4t_key, uintptr_t, colliding_hash> colliding;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        colliding[make_key(i)] = i + 1;
+    }
+    for (uint32_t i = 0; i < n; i += 3) {
+        colliding.erase(colliding.find(make_key(i)));
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        auto itr = colliding.find(make_key(i));
+        if (i % 3) {
+            ASSERT_TRUE(itr != colliding.end());
+            EXPECT_EQ(itr->second, i + 1);
+        } else {
+            EXPECT_TRUE(itr == colliding.end());
+        }
+    }
+
+    for (uint32_t i = 0; i < n; i += 3) {
+        colliding[make_key(i)] = i + 1000;
+    }
+    EXPECT_EQ(colliding.size(), n);
+
+    for (uint32_t round = 0; round < 10000U; ++round) {
+        test_4t_key key = make_key(round % n);
+        uintptr_t value = colliding.find(key)->second;
+        colliding.erase(colliding.find(key));
+        EXPECT_TRUE(colliding.find(key) == colliding.end());
+        colliding[key] = value;
+    }
+    EXPECT_EQ(colliding.size(), n);
+    for (uint32_t i = 0; i < n; ++i) {
+        auto itr = colliding.find(make_key(i));
+        ASSERT_TRUE(itr != colliding.end());
+        EXPECT_EQ(itr->second, (i % 3) ? i + 1 : i + 1000);
+    }
+}
@@ -8,6 +8,7 @@
 
 #include <pthread.h>
 #include <mutex>
+#include <thread>
 #include "core/event/job_queue.h"
 
 // Simple test job structure
@@ -216,3 +217,84 @@ TEST_F(job_queue_test, ti_6)
     auto &remaining_jobs = queue.get_all();
     EXPECT_EQ(remaining_jobs.size(), 0UL);
 }
+
+/**
+ * @test job_queue_test.ti_7
+ * @brief
+ *    Multi producer order with a concurrent consumer.
+ * @details
+ *    Every producer inserts more jobs than its ring holds, so the overflow path runs too.
+ *    The jobs of every producer must be consumed in the insertion order.
+ */
+TEST_F(job_queue_test, ti_7)
+{
+    const int num_producer_threads = 4;
+    const int jobs_per_thread = 200000;
+    std::vector<std::thread> producers;
+    std::vector<int> next_id(num_producer_threads, 0);
+    std::atomic<int> producers_done(0);
+    bool in_order = true;
+    int consumed = 0;
+
+    for (int i = 0; i < num_producer_threads; ++i) {
+        producers.emplace_back([&, i]() {
+            for (int j = 0; j < jobs_per_thread; ++j) {
+                queue.insert_job(test_job {j, i});
+            }
+            producers_done.fetch_add(1);
+        });
+    }
+
+    while (consumed < num_producer_threads * jobs_per_thread) {
+        bool done = (producers_done.load() == num_producer_threads);
+        auto &jobs = queue.get_all();
+        for (const auto &job : jobs) {
+            in_order = in_order && (job.id == next_id[job.priority]++);
+        }
+        consumed += static_cast<int>(jobs.size());
+        jobs.clear();
+        if (done) {
+            break;
+        }
+    }
+
+    for (auto &t : producers) {
+        t.join();
+    }
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(num_producer_threads * jobs_per_thread, consumed);
+    EXPECT_TRUE(queue.get_all().empty());
+}
+
+/**
+ * @test job_queue_test.ti_8
+ * @brief
+ *    The rings of the exited producer threads are reused.
+ * @details
+ *    More threads than JOB_QUEUE_PRODUCERS_MAX insert one after another, every thread takes
+ *    the ring released by the previous one.
+ */
+TEST_F(job_queue_test, ti_8)
+{
+    const int num_producer_threads = 2 * JOB_QUEUE_PRODUCERS_MAX;
+    const int jobs_per_thread = 10;
+
+    for (int i = 0; i < num_producer_threads; ++i) {
+        std::thread producer([&, i]() {
+            for (int j = 0; j < jobs_per_thread; ++j) {
+                queue.insert_job(test_job {j, i});
+            }
+        });
+        producer.join();
+    }
+
+    auto &jobs = queue.get_all();
+    ASSERT_EQ(static_cast<size_t>(num_producer_threads * jobs_per_thread), jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i) / jobs_per_thread, jobs[i].priority);
+        EXPECT_EQ(static_cast<int>(i) % jobs_per_thread, jobs[i].id);
+    }
+    jobs.clear();
+    EXPECT_EQ(1U, queue.producers_num());
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include "core/util/xlio_stats.h"
+
+/**
+ * @test lat_hist_test.ti_1
+ * @brief
+ *    Bucket boundaries of the two buckets per power of two
+ * @details
+ */
+TEST(lat_hist_test, ti_1)
+{
+    EXPECT_EQ(0U, lat_hist_bucket(0U));
+    EXPECT_EQ(1U, lat_hist_bucket(1U));
+    EXPECT_EQ(2U, lat_hist_bucket(2U));
+    EXPECT_EQ(3U, lat_hist_bucket(3U));
+    EXPECT_EQ(4U, lat_hist_bucket(4U));
+    EXPECT_EQ(4U, lat_hist_bucket(5U));
+    EXPECT_EQ(5U, lat_hist_bucket(6U));
+    EXPECT_EQ(5U, lat_hist_bucket(7U));
+    EXPECT_EQ(6U, lat_hist_bucket(8U));
+    EXPECT_EQ(7U, lat_hist_bucket(12U));
+    EXPECT_EQ(7U, lat_hist_bucket(15U));
+
+    // The last bucket takes everything above its bound
+    EXPECT_EQ(LAT_HIST_BUCKETS - 1U, lat_hist_bucket(lat_hist_bucket_min(LAT_HIST_BUCKETS - 1U)));
+    EXPECT_EQ(LAT_HIST_BUCKETS - 1U, lat_hist_bucket(UINT64_MAX));
+    EXPECT_EQ(LAT_HIST_BUCKETS - 2U,
+              lat_hist_bucket(lat_hist_bucket_min(LAT_HIST_BUCKETS - 1U) - 1U));
+}
+
+/**
+ * @test lat_hist_test.ti_2
+ * @brief
+ *    A value falls into the bucket whose range holds it
+ * @details
+ *    The lower bound of the bucket is at least two thirds of the value.
+ */
+TEST(lat_hist_test, ti_2)
+{
+    std::mt19937_64 gen(7U);
+    const uint64_t max = lat_hist_bucket_min(LAT_HIST_BUCKETS - 1U);
+
+    for (uint32_t idx = 1U; idx < LAT_HIST_BUCKETS; ++idx) {
+        ASSERT_LT(lat_hist_bucket_min(idx - 1U), lat_hist_bucket_min(idx));
+        ASSERT_EQ(idx, lat_hist_bucket(lat_hist_bucket_min(idx)));
+    }
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t ticks = gen() >> (gen() % 64U);
+        uint32_t idx = lat_hist_bucket(ticks);
+        uint64_t low = lat_hist_bucket_min(idx);
+
+        ASSERT_LE(low, ticks);
+        if (ticks < max) {
+            ASSERT_GT(lat_hist_bucket_min(idx + 1U), ticks);
+            ASSERT_LE((ticks - low) * 3U, ticks);
+        }
+    }
+}
+
+/**
+ * @test lat_hist_test.ti_3
+ * @brief
+ *    Samples are counted in their buckets
+ * @details
+ */
+TEST(lat_hist_test, ti_3)
+{
+    lat_hist_t hist;
+
+    memset(&hist, 0, sizeof(hist));
+    lat_hist_add(&hist, 0U);
+    lat_hist_add(&hist, 100U);
+    lat_hist_add(&hist, 127U);
+    lat_hist_add(&hist, 128U);
+
+    uint64_t samples = 0U;
+    for (uint32_t i = 0U; i < LAT_HIST_BUCKETS; ++i) {
+        samples += hist.buckets[i];
+    }
+    EXPECT_EQ(4U, samples);
+    EXPECT_EQ(1U, hist.buckets[0]);
+    EXPECT_EQ(2U, hist.buckets[lat_hist_bucket(96U)]);
+    EXPECT_EQ(1U, hist.buckets[lat_hist_bucket(128U)]);
+}
@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <random>
+#include <vector>
+#include "core/util/lpm_trie.h"
+
+struct test_route {
+    uint32_t dst; // Network byte order
+    unsigned prefix_len;
+    bool deleted;
+};
+
+static bool prefix_match(const test_route &route, uint32_t addr)
+{
+    if (!route.prefix_len) {
+        return true;
+    }
+    unsigned shift = 32U - route.prefix_len;
+    return (ntohl(route.dst) >> shift) == (ntohl(addr) >> shift);
+}
+
+// The linear scan which route_table_mgr did before, the first longest match wins
+static int linear_lookup(const std::vector<test_route> &routes, uint32_t addr)
+{
+    int longest = -1;
+    int found = -1;
+
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (!routes[i].deleted && prefix_match(routes[i], addr) &&
+            (int)routes[i].prefix_len > longest) {
+            longest = routes[i].prefix_len;
+            found = (int)i;
+        }
+    }
+    return found;
+}
+
+static int trie_lookup(const lpm_trie<uint32_t> &trie, uint32_t addr)
+{
+    const std::vector<uint32_t> *vals =
+        trie.lookup(reinterpret_cast<const uint8_t *>(&addr), 32U);
+    return vals ? (int)vals->front() : -1;
+}
+
+static std::vector<test_route> random_routes(std::mt19937 &gen, size_t num)
+{
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<unsigned> len(8U, 32U);
+    std::vector<test_route> routes(num);
+
+    for (test_route &route : routes) {
+        route.prefix_len = len(gen);
+        route.dst = htonl(addr(gen) & ~(UINT32_MAX >> route.prefix_len));
+        route.deleted = false;
+    }
+    return routes;
+}
+
+static void insert_all(lpm_trie<uint32_t> &trie, const std::vector<test_route> &routes)
+{
+    for (size_t i = 0; i < routes.size(); ++i) {
+        trie.insert(reinterpret_cast<const uint8_t *>(&routes[i].dst), routes[i].prefix_len,
+                    (uint32_t)i);
+    }
+}
+
+/**
+ * @test lpm_trie_test.ti_1
+ * @brief
+ *    Longest prefix wins, the lowest value wins among the same prefixes
+ * @details
+ */
+TEST(lpm_trie_test, ti_1)
+{
+    std::vector<test_route> routes = {
+        {htonl(0x0A000000U), 8U, false},  {htonl(0x0A010000U), 16U, false},
+        {htonl(0x0A010100U), 24U, false}, {htonl(0x0A010000U), 16U, false},
+        {htonl(0x00000000U), 0U, false},
+    };
+    lpm_trie<uint32_t> trie;
+
+    EXPECT_EQ(-1, trie_lookup(trie, htonl(0x0A010101U)));
+    insert_all(trie, routes);
+    EXPECT_EQ(routes.size(), trie.size());
+
+    EXPECT_EQ(2, trie_lookup(trie, htonl(0x0A010101U)));
+    EXPECT_EQ(1, trie_lookup(trie, htonl(0x0A01FF01U)));
+    EXPECT_EQ(0, trie_lookup(trie, htonl(0x0AFF0000U)));
+    EXPECT_EQ(4, trie_lookup(trie, htonl(0xC0A80001U)));
+
+    // The second /16 takes over once the first one is removed
+    EXPECT_TRUE(trie.remove(reinterpret_cast<const uint8_t *>(&routes[1].dst), 16U, 1U));
+    EXPECT_FALSE(trie.remove(reinterpret_cast<const uint8_t *>(&routes[1].dst), 16U, 1U));
+    EXPECT_EQ(3, trie_lookup(trie, htonl(0x0A01FF01U)));
+
+    EXPECT_TRUE(trie.remove(reinterpret_cast<const uint8_t *>(&routes[4].dst), 0U, 4U));
+    EXPECT_EQ(-1, trie_lookup(trie, htonl(0xC0A80001U)));
+    EXPECT_EQ(routes.size() - 2U, trie.size());
+}
+
+/**
+ * @test lpm_trie_test.ti_2
+ * @brief
+ *    Same results as the linear scan through additions and removals
+ * @details
+ */
+TEST(lpm_trie_test, ti_2)
+{
+    std::mt19937 gen(11U);
+    std::vector<test_route> routes = random_routes(gen, 2000U);
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<size_t> pick(0U, routes.size() - 1U);
+    lpm_trie<uint32_t> trie;
+
+    insert_all(trie, routes);
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            size_t idx = pick(gen);
+            const uint8_t *key = reinterpret_cast<const uint8_t *>(&routes[idx].dst);
+            if (routes[idx].deleted) {
+                trie.insert(key, routes[idx].prefix_len, (uint32_t)idx);
+            } else {
+                EXPECT_TRUE(trie.remove(key, routes[idx].prefix_len, (uint32_t)idx));
+            }
+            routes[idx].deleted = !routes[idx].deleted;
+        }
+        for (int i = 0; i < 1000; ++i) {
+            // Half of the addresses within a route to hit the long prefixes
+            uint32_t dst = (i & 1) ? addr(gen) : htonl(ntohl(routes[pick(gen)].dst) | (i & 0xFF));
+            ASSERT_EQ(linear_lookup(routes, dst), trie_lookup(trie, dst));
+        }
+    }
+
+    // The pruned nodes are reused
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (!routes[i].deleted) {
+            trie.remove(reinterpret_cast<const uint8_t *>(&routes[i].dst), routes[i].prefix_len,
+                        (uint32_t)i);
+        }
+    }
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(-1, trie_lookup(trie, addr(gen)));
+}
+
+/**
+ * @test lpm_trie_test.ti_3
+ * @brief
+ *    IPv6 prefixes across the 64 bit halves
+ * @details
+ */
+TEST(lpm_trie_test, ti_3)
+{
+    struct in6_addr net48, net64, net127, dst;
+    lpm_trie<uint32_t> trie;
+
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1::", &net48));
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1:2::", &net64));
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1:2::2", &net127));
+    trie.insert(reinterpret_cast<const uint8_t *>(&net48), 48U, 0U);
+    trie.insert(reinterpret_cast<const uint8_t *>(&net64), 64U, 1U);
+    trie.insert(reinterpret_cast<const uint8_t *>(&net127), 127U, 2U);
+
+    const uint8_t *key = reinterpret_cast<const uint8_t *>(&dst);
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1:2::3", &dst));
+    EXPECT_EQ(2U, trie.lookup(key, 128U)->front());
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1:2::4", &dst));
+    EXPECT_EQ(1U, trie.lookup(key, 128U)->front());
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1:3::2", &dst));
+    EXPECT_EQ(0U, trie.lookup(key, 128U)->front());
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:2::", &dst));
+    EXPECT_EQ(nullptr, trie.lookup(key, 128U));
+}
+
+/**
+ * @test lpm_trie_test.ti_4
+ * @brief
+ *    Lookups in 50k random IPv4 prefixes
+ * @details
+ *    The trie returns the route of the linear scan of the route table.
+ */
+TEST(lpm_trie_test, ti_4)
+{
+    const size_t num_lookups = 1000U;
+    std::mt19937 gen(17U);
+    std::vector<test_route> routes = random_routes(gen, 50000U);
+    std::uniform_int_distribution<size_t> pick(0U, routes.size() - 1U);
+    std::vector<uint32_t> dsts(num_lookups);
+    lpm_trie<uint32_t> trie;
+
+    for (uint32_t &dst : dsts) {
+        dst = htonl(ntohl(routes[pick(gen)].dst) | (gen() & 0xFFU));
+    }
+    insert_all(trie, routes);
+
+    for (uint32_t dst : dsts) {
+        EXPECT_EQ(linear_lookup(routes, dst), trie_lookup(trie, dst));
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <time.h>
+#include <set>
+#include <vector>
+#include "core/proto/mem_buf_desc.h"
+
+#define TEST_CACHELINE 64U
+
+#define FIELD(f)                                                                                   \
+    {                                                                                              \
+        #f, offsetof(mem_buf_desc_t, f), sizeof(reinterpret_cast<mem_buf_desc_t *>(0)->f)          \
+    }
+
+struct field_span {
+    const char *name;
+    size_t offset;
+    size_t size;
+};
+
+// Descriptor fields accessed per packet by cq_mgr_rx -> ring_slave/rfs -> sockinfo_tcp
+static const std::vector<field_span> s_tcp_rx_fields = {
+    FIELD(lwip_pbuf),
+    FIELD(p_buffer),
+    FIELD(sz_data),
+    FIELD(p_next_desc),
+    FIELD(p_desc_owner),
+    FIELD(sz_buffer),
+    FIELD(m_flags),
+    FIELD(lkey),
+    FIELD(n_ref_count),
+    FIELD(p_prev_desc),
+    FIELD(rx.frag),
+    FIELD(rx.sz_payload),
+    FIELD(rx.tcp),
+    FIELD(rx.n_transport_header_len),
+    FIELD(rx.flow_tag_id),
+    FIELD(rx.n_frags),
+    FIELD(rx.is_sw_csum_need),
+    FIELD(rx.tls_decrypted),
+    FIELD(rx.strides_num),
+};
+
+// UDP also fills the addresses and queues the descriptor to the socket
+static const std::vector<field_span> s_udp_rx_extra_fields = {
+    FIELD(buffer_node),
+    FIELD(rx.src),
+    FIELD(rx.dst),
+    FIELD(rx.udp),
+    FIELD(rx.gro_size),
+};
+
+static size_t count_cachelines(const std::vector<field_span> &fields)
+{
+    std::set<size_t> lines;
+
+    for (const auto &field : fields) {
+        for (size_t line = field.offset / TEST_CACHELINE;
+             line <= (field.offset + field.size - 1U) / TEST_CACHELINE; ++line) {
+            lines.insert(line);
+        }
+    }
+    return lines.size();
+}
+
+TEST(mem_buf_desc_layout, size)
+{
+    EXPECT_EQ(0U, sizeof(mem_buf_desc_t) % TEST_CACHELINE);
+    EXPECT_EQ(0U, offsetof(mem_buf_desc_t, lwip_pbuf));
+    EXPECT_LE(sizeof(reinterpret_cast<mem_buf_desc_t *>(0)->tx),
+              sizeof(reinterpret_cast<mem_buf_desc_t *>(0)->rx));
+}
+
+TEST(mem_buf_desc_layout, rx_cachelines)
+{
+    std::vector<field_span> udp_fields = s_tcp_rx_fields;
+    udp_fields.insert(udp_fields.end(), s_udp_rx_extra_fields.begin(),
+                      s_udp_rx_extra_fields.end());
+
+    size_t tcp_lines = count_cachelines(s_tcp_rx_fields);
+    size_t udp_lines = count_cachelines(udp_fields);
+
+    // The TCP fast path used to touch 5 cachelines of the descriptor
+    EXPECT_LE(tcp_lines, 3U);
+    EXPECT_LE(udp_lines, 4U);
+
+    // The hot fields are packed at the head of the descriptor
+    for (const auto &field : s_tcp_rx_fields) {
+        EXPECT_LE(field.offset + field.size, 3U * TEST_CACHELINE) << field.name;
+    }
+    for (const auto &field : s_udp_rx_extra_fields) {
+        EXPECT_LE(field.offset + field.size, 4U * TEST_CACHELINE) << field.name;
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include "core/util/memcpy_nt.h"
+
+/**
+ * @test memcpy_nt.ti_1
+ * @brief
+ *    The copy of any length between misaligned buffers, the bytes around it are untouched
+ * @details
+ */
+TEST(memcpy_nt, ti_1)
+{
+    std::vector<uint8_t> src(4096U + 64U);
+    std::vector<uint8_t> dst(src.size() + 64U);
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<uint8_t>(i * 7U + 3U);
+    }
+    for (size_t len : {0U, 1U, 63U, 255U, 256U, 257U, 1000U, 4096U}) {
+        for (size_t dst_off = 0; dst_off < 17U; dst_off += 5U) {
+            for (size_t src_off = 0; src_off < 17U; src_off += 3U) {
+                std::fill(dst.begin(), dst.end(), 0xEEU);
+                memcpy_nt(&dst[dst_off + 1U], &src[src_off], len);
+                ASSERT_EQ(0, memcmp(&dst[dst_off + 1U], &src[src_off], len))
+                    << "len " << len << " dst " << dst_off << " src " << src_off;
+                EXPECT_EQ(0xEEU, dst[dst_off]);
+                EXPECT_EQ(0xEEU, dst[dst_off + 1U + len]);
+            }
+        }
+    }
+}
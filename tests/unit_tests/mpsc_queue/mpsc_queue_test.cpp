@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+#include "core/util/mpsc_queue.h"
+
+struct mpsc_elem {
+    mpsc_elem *next = nullptr;
+    uint32_t producer = 0U;
+    uint32_t seq = 0U;
+};
+
+typedef mpsc_queue<mpsc_elem, &mpsc_elem::next> mpsc_queue_t;
+
+/**
+ * @test mpsc_queue_test.ti_1
+ * @brief
+ *    pop_all() returns the elements in the push order
+ * @details
+ *    Only the push to an empty queue reports the transition.
+ */
+TEST(mpsc_queue_test, ti_1)
+{
+    mpsc_elem elems[5];
+    mpsc_queue_t queue;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.pop_all());
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        elems[i].seq = i;
+        EXPECT_EQ(i == 0, queue.push(&elems[i]));
+    }
+    EXPECT_FALSE(queue.empty());
+
+    uint32_t seq = 0U;
+    for (mpsc_elem *elem = queue.pop_all(); elem; elem = elem->next) {
+        EXPECT_EQ(seq++, elem->seq);
+    }
+    EXPECT_EQ(5U, seq);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push(&elems[0]));
+}
+
+/**
+ * @test mpsc_queue_test.ti_2
+ * @brief
+ *    Several producer threads and a consumer thread
+ * @details
+ *    Every element is received once and in the order of its producer.
+ */
+TEST(mpsc_queue_test, ti_2)
+{
+    const uint32_t producers = 4;
+    const uint32_t count = 100000;
+    std::vector<mpsc_elem> elems(producers * count);
+    std::vector<std::thread> threads;
+    mpsc_queue_t queue;
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&elems, &queue, p, count]() {
+            for (uint32_t i = 0; i < count; ++i) {
+                mpsc_elem *elem = &elems[p * count + i];
+                elem->producer = p;
+                elem->seq = i;
+                queue.push(elem);
+            }
+        });
+    }
+
+    std::vector<uint32_t> expected(producers, 0U);
+    uint32_t received = 0U;
+    while (received < producers * count) {
+        for (mpsc_elem *elem = queue.pop_all(); elem; elem = elem->next) {
+            EXPECT_EQ(expected[elem->producer]++, elem->seq);
+            ++received;
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(queue.empty());
+}
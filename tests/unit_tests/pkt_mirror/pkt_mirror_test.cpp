@@ -0,0 +1,260 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <linux/if_ether.h>
+#include <vector>
+#include "stats/stats_mirror.h"
+
+#define NUM_SLOTS 4U
+
+// An Ethernet/IPv4/UDP frame
+struct test_frame {
+    struct ethhdr eth;
+    struct iphdr ip;
+    struct udphdr udp;
+    uint8_t payload[64];
+} __attribute__((packed));
+
+static test_frame make_frame(const char *saddr, uint16_t sport, const char *daddr,
+                             uint16_t dport)
+{
+    test_frame frame = {};
+
+    frame.eth.h_proto = htons(ETH_P_IP);
+    frame.ip.ihl = 5;
+    frame.ip.version = 4;
+    frame.ip.protocol = IPPROTO_UDP;
+    inet_pton(AF_INET, saddr, &frame.ip.saddr);
+    inet_pton(AF_INET, daddr, &frame.ip.daddr);
+    frame.udp.source = htons(sport);
+    frame.udp.dest = htons(dport);
+    memset(frame.payload, 0xAB, sizeof(frame.payload));
+    return frame;
+}
+
+class pkt_mirror_test : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_shm = static_cast<pkt_mirror_shm_t *>(calloc(1, pkt_mirror_shm_size(NUM_SLOTS)));
+        m_shm->num_slots = NUM_SLOTS;
+        m_shm->slot_size = sizeof(pkt_mirror_slot_t);
+    }
+
+    void TearDown() override
+    {
+        pkt_mirror_set_filter(m_shm, pkt_mirror_filter_t {});
+        free(m_shm);
+    }
+
+    // The mirroring of a ring: select and then write the frame
+    void mirror(uint8_t dir, const test_frame &frame)
+    {
+        size_t snap_len = pkt_mirror_select(dir, &frame, sizeof(frame));
+        if (snap_len) {
+            struct iovec iov = {const_cast<test_frame *>(&frame), sizeof(frame)};
+            pkt_mirror_write(dir, 1U, 1000U, 0U, &iov, 1, snap_len, sizeof(frame));
+        }
+    }
+
+    pkt_mirror_shm_t *m_shm = nullptr;
+};
+
+/**
+ * @test pkt_mirror_test.ti_1
+ * @brief
+ *    The filter matches the local endpoint as the destination of RX and the source of TX
+ * @details
+ */
+TEST_F(pkt_mirror_test, ti_1)
+{
+    pkt_mirror_filter_t filter;
+    pkt_mirror_slot_t slot;
+
+    ASSERT_TRUE(stats_mirror_parse_filter("proto=udp,local_ip=10.0.0.1,local_port=5000,snap=40",
+                                          filter));
+    pkt_mirror_set_filter(m_shm, filter);
+    ASSERT_EQ(m_shm, g_p_pkt_mirror);
+
+    mirror(PKT_MIRROR_DIR_RX, make_frame("10.0.0.2", 6000, "10.0.0.1", 5000));
+    mirror(PKT_MIRROR_DIR_TX, make_frame("10.0.0.1", 5000, "10.0.0.2", 6000));
+    // The local endpoint on the wrong side, another port and another address
+    mirror(PKT_MIRROR_DIR_TX, make_frame("10.0.0.2", 6000, "10.0.0.1", 5000));
+    mirror(PKT_MIRROR_DIR_RX, make_frame("10.0.0.2", 6000, "10.0.0.1", 5001));
+    mirror(PKT_MIRROR_DIR_RX, make_frame("10.0.0.2", 6000, "10.0.0.3", 5000));
+    ASSERT_EQ(2U, m_shm->head);
+
+    ASSERT_EQ(PKT_MIRROR_READ_OK, pkt_mirror_read(m_shm, 0U, &slot));
+    EXPECT_EQ(PKT_MIRROR_DIR_RX, slot.dir);
+    EXPECT_EQ(40U, slot.cap_len);
+    EXPECT_EQ(sizeof(test_frame), slot.wire_len);
+    ASSERT_EQ(PKT_MIRROR_READ_OK, pkt_mirror_read(m_shm, 1U, &slot));
+    EXPECT_EQ(PKT_MIRROR_DIR_TX, slot.dir);
+    EXPECT_EQ(PKT_MIRROR_READ_PENDING, pkt_mirror_read(m_shm, 2U, &slot));
+
+    // A zero sample rate stops the capture
+    pkt_mirror_set_filter(m_shm, pkt_mirror_filter_t {});
+    EXPECT_EQ(nullptr, g_p_pkt_mirror);
+}
+
+/**
+ * @test pkt_mirror_test.ti_2
+ * @brief
+ *    Sampling, and the reader counts the slots overwritten before it read them
+ * @details
+ */
+TEST_F(pkt_mirror_test, ti_2)
+{
+    pkt_mirror_filter_t filter;
+    test_frame frame = make_frame("10.0.0.2", 6000, "10.0.0.1", 5000);
+    stats_mirror_pcapng pcapng;
+    FILE *file = tmpfile();
+
+    ASSERT_TRUE(file);
+    ASSERT_TRUE(pcapng.open(file));
+    ASSERT_TRUE(stats_mirror_parse_filter("sample=2", filter));
+    pkt_mirror_set_filter(m_shm, filter);
+
+    stats_mirror_reader reader(m_shm);
+    for (int i = 0; i < 4; ++i) {
+        mirror(PKT_MIRROR_DIR_RX, frame);
+    }
+    ASSERT_EQ(2U, m_shm->head);
+    ASSERT_TRUE(reader.drain(pcapng));
+    EXPECT_EQ(2U, reader.packets());
+    EXPECT_EQ(0U, reader.lost());
+
+    // The producers lap the reader
+    filter.sample_rate = 1U;
+    pkt_mirror_set_filter(m_shm, filter);
+    for (uint32_t i = 0; i < NUM_SLOTS + 3U; ++i) {
+        mirror(PKT_MIRROR_DIR_RX, frame);
+    }
+    ASSERT_TRUE(reader.drain(pcapng));
+    EXPECT_EQ(2U + NUM_SLOTS, reader.packets());
+    EXPECT_EQ(3U, reader.lost());
+
+    // A slot older than the reader position is reported as overwritten
+    pkt_mirror_slot_t slot;
+    EXPECT_EQ(PKT_MIRROR_READ_LOST, pkt_mirror_read(m_shm, 2U, &slot));
+    fclose(file);
+}
+
+/**
+ * @test pkt_mirror_test.ti_3
+ * @brief
+ *    A claimed slot which is never published is counted as lost after a pass
+ * @details
+ */
+TEST_F(pkt_mirror_test, ti_3)
+{
+    stats_mirror_pcapng pcapng;
+    FILE *file = tmpfile();
+
+    ASSERT_TRUE(file);
+    ASSERT_TRUE(pcapng.open(file));
+    stats_mirror_reader reader(m_shm);
+
+    // A producer which dropped its packet on a busy slot
+    m_shm->head = 1U;
+    ASSERT_TRUE(reader.drain(pcapng));
+    EXPECT_EQ(0U, reader.lost());
+    ASSERT_TRUE(reader.drain(pcapng));
+    EXPECT_EQ(1U, reader.lost());
+    fclose(file);
+}
+
+/**
+ * @test pkt_mirror_test.ti_4
+ * @brief
+ *    Parsing of the filter of --mirror_filter
+ * @details
+ */
+TEST_F(pkt_mirror_test, ti_4)
+{
+    pkt_mirror_filter_t filter;
+    uint8_t addr[16] = {};
+
+    ASSERT_TRUE(stats_mirror_parse_filter("", filter));
+    EXPECT_EQ(0U, filter.family);
+    EXPECT_EQ(1U, filter.sample_rate);
+
+    ASSERT_TRUE(stats_mirror_parse_filter("proto=tcp,remote_ip=fe80::1,remote_port=443", filter));
+    inet_pton(AF_INET6, "fe80::1", addr);
+    EXPECT_EQ(AF_INET6, filter.family);
+    EXPECT_EQ(IPPROTO_TCP, filter.protocol);
+    EXPECT_EQ(0, memcmp(addr, filter.remote_addr, sizeof(addr)));
+    EXPECT_EQ(htons(443), filter.remote_port);
+
+    EXPECT_FALSE(stats_mirror_parse_filter("proto=icmp", filter));
+    EXPECT_FALSE(stats_mirror_parse_filter("local_ip=10.0.0.1,remote_ip=::1", filter));
+    EXPECT_FALSE(stats_mirror_parse_filter("snap=4096", filter));
+    EXPECT_FALSE(stats_mirror_parse_filter("sample=0", filter));
+    EXPECT_FALSE(stats_mirror_parse_filter("local_port=70000", filter));
+    EXPECT_FALSE(stats_mirror_parse_filter("vlan=5", filter));
+}
+
+/**
+ * @test pkt_mirror_test.ti_5
+ * @brief
+ *    The pcapng blocks: the section header, an interface per index and the packets
+ * @details
+ */
+TEST_F(pkt_mirror_test, ti_5)
+{
+    stats_mirror_pcapng pcapng;
+    pkt_mirror_slot_t slot = {};
+    std::vector<uint32_t> types;
+    FILE *file = tmpfile();
+
+    ASSERT_TRUE(file);
+    ASSERT_TRUE(pcapng.open(file));
+    slot.if_index = 1U;
+    slot.dir = PKT_MIRROR_DIR_TX;
+    slot.cap_len = 61U;
+    slot.wire_len = 9000U;
+    slot.ts_nsec = 0x123456789ULL;
+    ASSERT_TRUE(pcapng.write_packet(slot));
+    ASSERT_TRUE(pcapng.write_packet(slot));
+    slot.if_index = 2U;
+    ASSERT_TRUE(pcapng.write_packet(slot));
+
+    long size = ftell(file);
+    std::vector<uint8_t> buf(size);
+    rewind(file);
+    ASSERT_EQ(1U, fread(buf.data(), size, 1, file));
+    fclose(file);
+
+    // Every block starts and ends with its length, a multiple of 4
+    for (long pos = 0; pos < size;) {
+        uint32_t type, len, trailer;
+        memcpy(&type, &buf[pos], sizeof(type));
+        memcpy(&len, &buf[pos + 4], sizeof(len));
+        ASSERT_EQ(0U, len % 4U);
+        ASSERT_LE(pos + len, size);
+        memcpy(&trailer, &buf[pos + len - 4], sizeof(trailer));
+        ASSERT_EQ(len, trailer);
+        if (type == 6U) {
+            uint32_t ts_high, cap_len, orig_len;
+            memcpy(&ts_high, &buf[pos + 12], sizeof(ts_high));
+            memcpy(&cap_len, &buf[pos + 20], sizeof(cap_len));
+            memcpy(&orig_len, &buf[pos + 24], sizeof(orig_len));
+            EXPECT_EQ(1U, ts_high);
+            EXPECT_EQ(61U, cap_len);
+            EXPECT_EQ(9000U, orig_len);
+        }
+        types.push_back(type);
+        pos += len;
+    }
+    std::vector<uint32_t> expected = {0x0A0D0D0AU, 1U, 6U, 6U, 1U, 6U};
+    EXPECT_EQ(expected, types);
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <vector>
+#include "core/proto/route_val.h"
+
+static std::vector<route_nexthop> make_nexthops(const std::vector<uint32_t> &weights)
+{
+    std::vector<route_nexthop> nexthops;
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+        in_addr gw = {htonl(0x0A000001U + (uint32_t)i)};
+        nexthops.push_back(route_nexthop {ip_address(gw), (int)i + 1, weights[i]});
+    }
+    return nexthops;
+}
+
+/**
+ * @test route_multipath_test.ti_1
+ * @brief
+ *    The hash space is split by the weights in the next hop order
+ * @details
+ */
+TEST(route_multipath_test, ti_1)
+{
+    std::vector<route_nexthop> nexthops = make_nexthops({1U, 3U});
+
+    EXPECT_EQ(0U, route_nexthop_select(nexthops, 0U));
+    EXPECT_EQ(0U, route_nexthop_select(nexthops, 0x1FFFFFFFU));
+    EXPECT_EQ(1U, route_nexthop_select(nexthops, 0x20000000U));
+    EXPECT_EQ(1U, route_nexthop_select(nexthops, 0x7FFFFFFFU));
+    // The top bit is out of the kernel's 31 bit hash
+    EXPECT_EQ(0U, route_nexthop_select(nexthops, 0x80000000U));
+
+    std::vector<route_nexthop> single = make_nexthops({1U});
+    EXPECT_EQ(0U, route_nexthop_select(single, 0xFFFFFFFFU));
+}
+
+/**
+ * @test route_multipath_test.ti_2
+ * @brief
+ *    The flows spread by the weights
+ * @details
+ *    A flow per source port with the L4 policy.
+ */
+TEST(route_multipath_test, ti_2)
+{
+    std::vector<route_nexthop> nexthops = make_nexthops({1U, 1U, 2U});
+    in_addr src = {htonl(0x0A010101U)};
+    in_addr dst = {htonl(0xC0A80101U)};
+    std::vector<int> counts(nexthops.size(), 0);
+    const int num_flows = 40000;
+
+    for (int port = 0; port < num_flows; ++port) {
+        uint32_t hash = route_multipath_hash(AF_INET, ip_address(src), ip_address(dst),
+                                             htons(10000 + port), htons(80), IPPROTO_TCP, 1);
+        ++counts[route_nexthop_select(nexthops, hash)];
+    }
+
+    EXPECT_NEAR(num_flows / 4, counts[0], num_flows / 50);
+    EXPECT_NEAR(num_flows / 4, counts[1], num_flows / 50);
+    EXPECT_NEAR(num_flows / 2, counts[2], num_flows / 50);
+}
+
+/**
+ * @test route_multipath_test.ti_3
+ * @brief
+ *    The hashed fields follow the policy
+ * @details
+ *    The ports change the hash with the L4 policy only, the protocol is in the IPv6 L3 hash.
+ */
+TEST(route_multipath_test, ti_3)
+{
+    in_addr src4 = {htonl(0x0A010101U)};
+    in_addr dst4 = {htonl(0xC0A80101U)};
+    in6_addr src6, dst6;
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8::1", &src6));
+    ASSERT_EQ(1, inet_pton(AF_INET6, "2001:db8:1::1", &dst6));
+
+    ip_address s4(src4), d4(dst4), s6(src6), d6(dst6);
+    EXPECT_EQ(route_multipath_hash(AF_INET, s4, d4, htons(1000), htons(80), IPPROTO_TCP, 0),
+              route_multipath_hash(AF_INET, s4, d4, htons(2000), htons(81), IPPROTO_UDP, 0));
+    EXPECT_NE(route_multipath_hash(AF_INET, s4, d4, htons(1000), htons(80), IPPROTO_TCP, 1),
+              route_multipath_hash(AF_INET, s4, d4, htons(2000), htons(80), IPPROTO_TCP, 1));
+    EXPECT_EQ(route_multipath_hash(AF_INET, s4, d4, htons(1000), htons(80), IPPROTO_TCP, 1),
+              route_multipath_hash(AF_INET, s4, d4, htons(1000), htons(80), IPPROTO_TCP, 1));
+
+    EXPECT_EQ(route_multipath_hash(AF_INET6, s6, d6, htons(1000), htons(80), IPPROTO_TCP, 0),
+              route_multipath_hash(AF_INET6, s6, d6, htons(2000), htons(80), IPPROTO_TCP, 0));
+    EXPECT_NE(route_multipath_hash(AF_INET6, s6, d6, htons(1000), htons(80), IPPROTO_TCP, 0),
+              route_multipath_hash(AF_INET6, s6, d6, htons(1000), htons(80), IPPROTO_UDP, 0));
+    EXPECT_NE(route_multipath_hash(AF_INET6, s6, d6, htons(1000), htons(80), IPPROTO_TCP, 0),
+              route_multipath_hash(AF_INET6, d6, s6, htons(1000), htons(80), IPPROTO_TCP, 0));
+}
@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <random>
+#include <vector>
+#include "core/util/rule_matcher.h"
+
+// A dbl_lst over the rules, in the order of the configuration file
+class test_rule_list {
+public:
+    explicit test_rule_list(std::vector<use_family_rule> &rules)
+        : m_nodes(rules.size())
+    {
+        m_lst.head = m_lst.tail = nullptr;
+        for (size_t i = 0; i < rules.size(); ++i) {
+            m_nodes[i].data = &rules[i];
+            m_nodes[i].prev = i ? &m_nodes[i - 1] : nullptr;
+            m_nodes[i].next = i + 1 < rules.size() ? &m_nodes[i + 1] : nullptr;
+        }
+        if (!rules.empty()) {
+            m_lst.head = &m_nodes.front();
+            m_lst.tail = &m_nodes.back();
+        }
+    }
+
+    const dbl_lst &lst() const { return m_lst; }
+
+private:
+    std::vector<dbl_lst_node> m_nodes;
+    dbl_lst m_lst;
+};
+
+static address_port_rule addr_port(const char *addr, unsigned prefixlen, unsigned sport,
+                                   unsigned eport)
+{
+    address_port_rule rule = {};
+
+    if (addr) {
+        rule.match_by_addr = 1;
+        inet_pton(AF_INET, addr, &rule.ipv4);
+        rule.prefixlen = static_cast<unsigned char>(prefixlen);
+    }
+    if (sport) {
+        rule.match_by_port = 1;
+        rule.sport = static_cast<unsigned short>(sport);
+        rule.eport = static_cast<unsigned short>(eport);
+    }
+    return rule;
+}
+
+static use_family_rule make_rule(transport_t target, const address_port_rule &first)
+{
+    use_family_rule rule = {};
+
+    rule.first = first;
+    rule.protocol = PROTO_TCP;
+    rule.target_transport = target;
+    return rule;
+}
+
+static rule_match_addr match_addr(const char *addr, uint16_t port)
+{
+    rule_match_addr match = {};
+
+    match.addr_valid = inet_pton(AF_INET, addr, &match.addr) == 1;
+    match.port = port;
+    return match;
+}
+
+// The walk of get_family_by_first_matching_rule(), the first matching rule wins
+static const use_family_rule *linear_match(const std::vector<use_family_rule> &rules,
+                                           transport_t my_transport, const rule_match_addr &first,
+                                           const rule_match_addr *second)
+{
+    for (const use_family_rule &rule : rules) {
+        if (rule_matcher::matches(rule, my_transport, first, second)) {
+            return &rule;
+        }
+    }
+    return nullptr;
+}
+
+TEST(rule_matcher_test, ti_1)
+{
+    std::vector<use_family_rule> rules;
+    rules.push_back(make_rule(TRANS_OS, addr_port("10.1.1.0", 24, 6000, 6010)));
+    rules.push_back(make_rule(TRANS_XLIO, addr_port("10.1.0.0", 16, 0, 0)));
+    rules.push_back(make_rule(TRANS_OS, addr_port(nullptr, 0, 5000, 5000)));
+    rules.push_back(make_rule(TRANS_SDP, addr_port(nullptr, 0, 0, 0)));
+    rules.push_back(make_rule(TRANS_OS, addr_port(nullptr, 0, 0, 0)));
+    test_rule_list lst(rules);
+    rule_matcher matcher;
+
+    matcher.build(lst.lst());
+    EXPECT_EQ(rules.size(), matcher.size());
+
+    rule_match_addr addr = match_addr("10.1.1.5", 6005);
+    EXPECT_EQ(&rules[0], matcher.match(TRANS_XLIO, addr));
+    addr = match_addr("10.1.2.5", 6005);
+    EXPECT_EQ(&rules[1], matcher.match(TRANS_XLIO, addr));
+    // The rule of another transport is skipped
+    addr = match_addr("192.168.0.1", 80);
+    EXPECT_EQ(&rules[4], matcher.match(TRANS_XLIO, addr));
+    EXPECT_EQ(&rules[3], matcher.match(TRANS_SDP, addr));
+    // The port rule comes before the wildcards, the address rule before it
+    addr = match_addr("192.168.0.1", 5000);
+    EXPECT_EQ(&rules[2], matcher.match(TRANS_XLIO, addr));
+    addr = match_addr("10.1.0.1", 5000);
+    EXPECT_EQ(&rules[1], matcher.match(TRANS_XLIO, addr));
+    // An address which isn't IPv4 matches the rules without an address only
+    addr = match_addr("::1", 6005);
+    EXPECT_EQ(&rules[4], matcher.match(TRANS_XLIO, addr));
+
+    matcher.clear();
+    EXPECT_EQ(0U, matcher.size());
+    EXPECT_EQ(nullptr, matcher.match(TRANS_XLIO, addr));
+}
+
+TEST(rule_matcher_test, ti_2)
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<uint32_t> addr;
+    std::uniform_int_distribution<unsigned> len(0U, 32U);
+    std::uniform_int_distribution<unsigned> port(0U, 64U);
+    std::uniform_int_distribution<unsigned> kind(0U, 7U);
+    const transport_t transports[] = {TRANS_OS, TRANS_XLIO, TRANS_SDP, TRANS_ULP};
+    std::vector<use_family_rule> rules(300);
+
+    // The addresses and ports are drawn from a small space, so the rules overlap
+    for (use_family_rule &rule : rules) {
+        rule = use_family_rule();
+        rule.protocol = PROTO_TCP;
+        rule.target_transport = transports[kind(gen) & 3U];
+        for (address_port_rule *part : {&rule.first, &rule.second}) {
+            unsigned k = kind(gen);
+            if (k & 1U) {
+                part->match_by_addr = 1;
+                part->ipv4.s_addr = htonl(0x0A000000U | (addr(gen) & 0xFFFFU));
+                part->prefixlen = static_cast<unsigned char>(len(gen));
+            }
+            if (k & 2U) {
+                part->match_by_port = 1;
+                part->sport = static_cast<unsigned short>(port(gen));
+                part->eport = static_cast<unsigned short>(part->sport + port(gen) / 4U);
+            }
+        }
+        rule.use_second = kind(gen) & 1U;
+    }
+    test_rule_list lst(rules);
+    rule_matcher matcher;
+    matcher.build(lst.lst());
+
+    for (int i = 0; i < 20000; ++i) {
+        rule_match_addr first = {htonl(0x0A000000U | (addr(gen) & 0xFFFFU)),
+                                 static_cast<uint16_t>(port(gen)), kind(gen) != 0U};
+        rule_match_addr second = {htonl(0x0A000000U | (addr(gen) & 0xFFFFU)),
+                                  static_cast<uint16_t>(port(gen)), true};
+        transport_t my_transport = transports[kind(gen) & 3U];
+        const rule_match_addr *p_second = (i & 1) ? &second : nullptr;
+
+        ASSERT_EQ(linear_match(rules, my_transport, first, p_second),
+                  matcher.match(my_transport, first, p_second));
+    }
+}
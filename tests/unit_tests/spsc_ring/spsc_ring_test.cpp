@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include "core/util/spsc_ring.h"
+
+typedef spsc_ring<uintptr_t, 8> spsc_ring_t;
+
+/**
+ * @test spsc_ring_test.ti_1
+ * @brief
+ *    Elements are popped in the push order
+ * @details
+ *    The ring wraps around several times.
+ */
+TEST(spsc_ring_test, ti_1)
+{
+    spsc_ring_t ring;
+    uintptr_t val = 0;
+
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.pop(val));
+
+    for (uintptr_t i = 0; i < 100; i += 5) {
+        for (uintptr_t j = 0; j < 5; ++j) {
+            EXPECT_TRUE(ring.push(i + j));
+        }
+        EXPECT_EQ(5U, ring.size());
+        for (uintptr_t j = 0; j < 5; ++j) {
+            EXPECT_TRUE(ring.pop(val));
+            EXPECT_EQ(i + j, val);
+        }
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+/**
+ * @test spsc_ring_test.ti_2
+ * @brief
+ *    push() fails on a full ring
+ * @details
+ */
+TEST(spsc_ring_test, ti_2)
+{
+    spsc_ring_t ring;
+    uintptr_t val = 0;
+
+    for (uintptr_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_FALSE(ring.push(8));
+    EXPECT_EQ(8U, ring.size());
+
+    EXPECT_TRUE(ring.pop(val));
+    EXPECT_EQ(0U, val);
+    EXPECT_TRUE(ring.push(8));
+    EXPECT_FALSE(ring.push(9));
+}
+
+/**
+ * @test spsc_ring_test.ti_3
+ * @brief
+ *    Producer and consumer threads
+ * @details
+ *    Every element is received once and in order.
+ */
+TEST(spsc_ring_test, ti_3)
+{
+    const uintptr_t count = 1000000;
+    spsc_ring_t ring;
+    uintptr_t expected = 0;
+
+    std::thread producer([&ring, count]() {
+        for (uintptr_t i = 0; i < count;) {
+            if (ring.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    while (expected < count) {
+        uintptr_t val;
+        if (ring.pop(val)) {
+            if (val != expected) {
+                break;
+            }
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(count, expected);
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include "stats/stats_exporter.h"
+
+static size_t count_lines(const std::string &text, const std::string &line)
+{
+    size_t num = 0;
+    std::istringstream in(text);
+
+    for (std::string cur; std::getline(in, cur);) {
+        num += (cur == line);
+    }
+    return num;
+}
+
+static std::unique_ptr<sh_mem_t> make_sh_mem()
+{
+    std::unique_ptr<sh_mem_t> p_sh_mem(new sh_mem_t());
+
+    p_sh_mem->max_skt_inst_num = 1U;
+    p_sh_mem->skt_inst_arr[0].reset();
+    return p_sh_mem;
+}
+
+/**
+ * @test stats_exporter_test.ti_1
+ * @brief
+ *    Samples of the enabled instances with the process and instance labels
+ * @details
+ */
+TEST(stats_exporter_test, ti_1)
+{
+    std::unique_ptr<sh_mem_t> p_sh_mem = make_sh_mem();
+    std::ostringstream out;
+
+    p_sh_mem->ring_inst_arr[2].b_enabled = true;
+    p_sh_mem->ring_inst_arr[2].ring_stats.n_rx_pkt_count = 5U;
+    p_sh_mem->ring_inst_arr[2].ring_stats.n_numa_node = -1;
+    p_sh_mem->cq_inst_arr[1].cq_stats.n_rx_packet_count = 3U;
+    socket_instance_block_t &sock = p_sh_mem->skt_inst_arr[0];
+    sock.b_enabled = true;
+    sock.skt_stats.b_is_offloaded = true;
+    sock.skt_stats.fd = 7;
+    sock.skt_stats.socket_type = SOCK_STREAM;
+    sock.skt_stats.counters.n_tx_sent_byte_count = 1ULL << 40U;
+
+    stats_exporter_write(out, {{10, "app", p_sh_mem.get()}});
+    std::string text = out.str();
+
+    EXPECT_EQ(1U, count_lines(text, "# TYPE xlio_ring_rx_packets counter"));
+    EXPECT_EQ(1U,
+              count_lines(text, "xlio_ring_rx_packets_total{pid=\"10\",app=\"app\",ring=\"2\"} 5"));
+    EXPECT_EQ(1U, count_lines(text, "xlio_ring_numa_node{pid=\"10\",app=\"app\",ring=\"2\"} -1"));
+    EXPECT_EQ(1U, count_lines(text, "xlio_socket_tx_bytes_total{pid=\"10\",app=\"app\",fd=\"7\","
+                                    "proto=\"tcp\"} 1099511627776"));
+    EXPECT_EQ(1U, count_lines(text, "xlio_iomux_poll_hits_total{pid=\"10\",app=\"app\","
+                                    "func=\"poll\"} 0"));
+    // The disabled CQ isn't exported
+    EXPECT_EQ(std::string::npos, text.find("xlio_cq_rx_packets_total{"));
+    EXPECT_EQ(text.size() - 6U, text.rfind("# EOF\n"));
+}
+
+/**
+ * @test stats_exporter_test.ti_2
+ * @brief
+ *    Families stay contiguous across the processes, the label values are escaped
+ * @details
+ */
+TEST(stats_exporter_test, ti_2)
+{
+    std::unique_ptr<sh_mem_t> p_sh_mem1 = make_sh_mem();
+    std::unique_ptr<sh_mem_t> p_sh_mem2 = make_sh_mem();
+    std::ostringstream out;
+
+    p_sh_mem1->bpool_inst_arr[0].b_enabled = true;
+    p_sh_mem1->bpool_inst_arr[0].bpool_stats.is_rx = true;
+    p_sh_mem2->bpool_inst_arr[0].b_enabled = true;
+    p_sh_mem2->bpool_inst_arr[0].bpool_stats.is_tx = true;
+    p_sh_mem2->bpool_inst_arr[0].bpool_stats.n_buffer_pool_expands = 4U;
+
+    stats_exporter_write(out, {{1, "a\"b", p_sh_mem1.get()}, {2, "c\\d", p_sh_mem2.get()}});
+    std::string text = out.str();
+
+    size_t type_pos = text.find("# TYPE xlio_bpool_expands counter\n");
+    size_t first = text.find("xlio_bpool_expands_total{pid=\"1\",app=\"a\\\"b\",bpool=\"0\","
+                             "type=\"rx\"} 0\n");
+    size_t second = text.find("xlio_bpool_expands_total{pid=\"2\",app=\"c\\\\d\",bpool=\"0\","
+                              "type=\"tx\"} 4\n");
+    ASSERT_NE(std::string::npos, type_pos);
+    ASSERT_NE(std::string::npos, first);
+    ASSERT_NE(std::string::npos, second);
+    EXPECT_LT(type_pos, first);
+    // Nothing but the samples of the family between them
+    std::string between = text.substr(first, second - first);
+    EXPECT_EQ(std::string::npos, between.find('#'));
+    EXPECT_EQ(1U, count_lines(text, "# TYPE xlio_info gauge"));
+}
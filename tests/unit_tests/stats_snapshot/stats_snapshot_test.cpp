@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <sstream>
+#include "stats/stats_snapshot.h"
+
+#define SKT_NUM 4U
+
+static sh_mem_t *make_sh_mem()
+{
+    sh_mem_t *p_sh_mem = static_cast<sh_mem_t *>(calloc(1, SHMEM_STATS_SIZE(SKT_NUM)));
+
+    p_sh_mem->max_skt_inst_num = SKT_NUM;
+    for (size_t i = 0; i < SKT_NUM; ++i) {
+        p_sh_mem->skt_inst_arr[i].reset();
+    }
+    return p_sh_mem;
+}
+
+static socket_stats_t &add_socket(sh_mem_t *p_sh_mem, size_t i, int fd)
+{
+    socket_instance_block_t &block = p_sh_mem->skt_inst_arr[i];
+
+    block.b_enabled = true;
+    block.skt_stats.fd = fd;
+    block.skt_stats.inode = 100U + fd;
+    block.skt_stats.b_is_offloaded = true;
+    block.skt_stats.socket_type = SOCK_STREAM;
+    block.skt_stats.sa_family = AF_INET;
+    return block.skt_stats;
+}
+
+/**
+ * @test stats_snapshot_test.ti_1
+ * @brief
+ *    The deltas of the sockets between two copies of the region
+ * @details
+ */
+TEST(stats_snapshot_test, ti_1)
+{
+    sh_mem_t *p_sh_mem = make_sh_mem();
+    stats_snapshot prev, curr;
+    std::vector<snapshot_socket_delta_t> deltas;
+
+    socket_stats_t &sock = add_socket(p_sh_mem, 0, 5);
+    sock.counters.n_rx_packets = 0xFFFFFFF0U;
+    sock.counters.n_rx_bytes = 1000U;
+    add_socket(p_sh_mem, 1, 6).counters.n_tx_retransmits = 3U;
+    ASSERT_TRUE(prev.take(p_sh_mem));
+
+    sock.counters.n_rx_packets = 0x10U; // Wrapped around
+    sock.counters.n_rx_bytes = 3000U;
+    sock.counters.n_rx_ready_pkt_drop = 2U;
+    // The block of fd 6 is reused by another socket
+    socket_stats_t &reused = add_socket(p_sh_mem, 1, 6);
+    reused.inode = 7U;
+    reused.counters.n_tx_retransmits = 4U;
+    reused.counters.n_tx_sack_retransmits = 1U;
+    // Not offloaded
+    add_socket(p_sh_mem, 2, 8).b_is_offloaded = false;
+    ASSERT_TRUE(curr.take(p_sh_mem));
+    ASSERT_EQ(SKT_NUM, curr.socket_num());
+
+    stats_snapshot_diff(prev, curr, deltas);
+    ASSERT_EQ(2U, deltas.size());
+    EXPECT_EQ(5, deltas[0].fd);
+    EXPECT_EQ(0x20U, deltas[0].rx_packets);
+    EXPECT_EQ(2000U, deltas[0].rx_bytes);
+    EXPECT_EQ(2U, deltas[0].drops);
+    EXPECT_EQ(6, deltas[1].fd);
+    EXPECT_EQ(5U, deltas[1].retrans);
+
+    free(p_sh_mem);
+}
+
+/**
+ * @test stats_snapshot_test.ti_2
+ * @brief
+ *    Top sockets by the sort key and the snapshot formats
+ * @details
+ */
+TEST(stats_snapshot_test, ti_2)
+{
+    std::vector<snapshot_socket_delta_t> deltas(4);
+    std::ostringstream out;
+
+    for (size_t i = 0; i < deltas.size(); ++i) {
+        memset(&deltas[i], 0, sizeof(deltas[i]));
+        deltas[i].fd = static_cast<int>(i);
+        deltas[i].rx_packets = i * 10U;
+        deltas[i].drops = deltas.size() - i;
+        deltas[i].sa_family = AF_INET;
+        deltas[i].bound_port = htons(80);
+    }
+
+    std::vector<snapshot_socket_delta_t> top = deltas;
+    stats_snapshot_top(top, SNAPSHOT_SORT_DROPS, 2U);
+    ASSERT_EQ(2U, top.size());
+    EXPECT_EQ(0, top[0].fd);
+    EXPECT_EQ(1, top[1].fd);
+
+    top = deltas;
+    stats_snapshot_top(top, SNAPSHOT_SORT_RX_PPS, 10U);
+    ASSERT_EQ(4U, top.size());
+    EXPECT_EQ(3, top[0].fd);
+    EXPECT_EQ(0, top[3].fd);
+
+    stats_snapshot_write_csv_header(out);
+    stats_snapshot_write_csv(out, 1U, 2U, {deltas[1]});
+    EXPECT_EQ("Timestamp[ns],Interval[ns],Fd,Inode,Type,Local,Peer,RxPackets,RxBytes,TxPackets,"
+              "TxBytes,Drops,Retransmits\n1,2,1,0,RAW,0.0.0.0:80,0.0.0.0:0,10,0,0,0,3,0\n",
+              out.str());
+
+    char *buf = nullptr;
+    size_t size = 0U;
+    FILE *file = open_memstream(&buf, &size);
+    ASSERT_NE(nullptr, file);
+    EXPECT_TRUE(stats_snapshot_write_bin_header(file, 42));
+    EXPECT_TRUE(stats_snapshot_write_bin(file, 1U, 2U, deltas));
+    fclose(file);
+    ASSERT_EQ(sizeof(snapshot_file_header_t) + sizeof(snapshot_file_interval_t) +
+                  deltas.size() * sizeof(snapshot_socket_delta_t),
+              size);
+    const snapshot_file_header_t *header = reinterpret_cast<snapshot_file_header_t *>(buf);
+    EXPECT_EQ(0, memcmp(header->magic, SNAPSHOT_FILE_MAGIC, sizeof(header->magic)));
+    EXPECT_EQ(42, header->pid);
+    const snapshot_file_interval_t *interval =
+        reinterpret_cast<snapshot_file_interval_t *>(buf + sizeof(*header));
+    EXPECT_EQ(4U, interval->num_sockets);
+    free(buf);
+}
@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include "core/event/timer_wheel.h"
+
+struct test_timer {
+    uint64_t expiry_msec;
+    uint16_t wheel_slot;
+    test_timer *next;
+    test_timer *prev;
+    uint64_t delay;
+    uint64_t fired_at;
+};
+
+typedef timer_wheel<test_timer> timer_wheel_t;
+
+static size_t drain(timer_wheel_t &wheel)
+{
+    size_t num = 0;
+    test_timer *node;
+
+    while ((node = wheel.pop_expired())) {
+        node->fired_at = wheel.now();
+        ++num;
+    }
+    return num;
+}
+
+/**
+ * @test timer_wheel_test.ti_1
+ * @brief
+ *    Timers expire on the exact tick
+ * @details
+ *    The delays are around the boundaries of the levels, the wheel moves one tick at a time.
+ */
+TEST(timer_wheel_test, ti_1)
+{
+    const uint64_t delays[] = {0U, 1U, 2U, 63U, 64U, 65U, 127U, 4095U, 4096U, 4097U, 262143U,
+                               262144U, 300001U};
+    std::vector<test_timer> timers(sizeof(delays) / sizeof(delays[0]));
+    timer_wheel_t wheel;
+
+    // Start off a level boundary
+    wheel.advance(10U);
+    for (size_t i = 0; i < timers.size(); ++i) {
+        timers[i] = test_timer();
+        timers[i].delay = delays[i];
+        timers[i].fired_at = UINT64_MAX;
+        wheel.add(&timers[i], delays[i]);
+    }
+    EXPECT_EQ(timers.size(), wheel.size());
+    EXPECT_EQ(1U, drain(wheel));
+
+    while (!wheel.empty()) {
+        wheel.advance(1U);
+        drain(wheel);
+    }
+    for (const test_timer &timer : timers) {
+        EXPECT_EQ(10U + timer.delay, timer.fired_at);
+    }
+}
+
+/**
+ * @test timer_wheel_test.ti_2
+ * @brief
+ *    next_timeout() never overshoots an expiry
+ * @details
+ *    The wheel sleeps for the returned timeout as the event handler thread does.
+ */
+TEST(timer_wheel_test, ti_2)
+{
+    std::mt19937 gen(7U);
+    std::uniform_int_distribution<uint64_t> dist(1U, 1000000U);
+    std::vector<test_timer> timers(1000U);
+    timer_wheel_t wheel;
+
+    EXPECT_EQ(-1, wheel.next_timeout());
+    for (test_timer &timer : timers) {
+        timer = test_timer();
+        timer.delay = dist(gen);
+        wheel.add(&timer, timer.delay);
+    }
+
+    while (!wheel.empty()) {
+        int64_t timeout = wheel.next_timeout();
+        ASSERT_LT(0, timeout);
+        wheel.advance(timeout);
+        drain(wheel);
+    }
+    for (const test_timer &timer : timers) {
+        EXPECT_EQ(timer.delay, timer.fired_at);
+    }
+    EXPECT_EQ(-1, wheel.next_timeout());
+}
+
+/**
+ * @test timer_wheel_test.ti_3
+ * @brief
+ *    Removed timers don't expire
+ * @details
+ *    Timers are removed from the slots and from the expired list.
+ */
+TEST(timer_wheel_test, ti_3)
+{
+    std::vector<test_timer> timers(200U);
+    timer_wheel_t wheel;
+
+    for (size_t i = 0; i < timers.size(); ++i) {
+        timers[i] = test_timer();
+        timers[i].fired_at = UINT64_MAX;
+        wheel.add(&timers[i], i * 50U);
+    }
+    for (size_t i = 0; i < timers.size(); i += 2) {
+        wheel.remove(&timers[i]);
+    }
+    // Removing a node out of the wheel is a no-op
+    wheel.remove(&timers[0]);
+    EXPECT_EQ(timers.size() / 2, wheel.size());
+
+    size_t visited = 0;
+    wheel.for_each([&visited](test_timer *) { ++visited; });
+    EXPECT_EQ(wheel.size(), visited);
+
+    wheel.advance(200U * 50U);
+    EXPECT_EQ(timers.size() / 2, wheel.expired_num());
+    wheel.remove(&timers[1]);
+    EXPECT_EQ(timers.size() / 2 - 1, drain(wheel));
+    EXPECT_TRUE(wheel.empty());
+    for (size_t i = 0; i < timers.size(); ++i) {
+        EXPECT_EQ((i & 1U) && i != 1U, UINT64_MAX != timers[i].fired_at);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+ * Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include "core/util/zc_notify_queue.h"
+
+/**
+ * @test zc_notify_queue_test.ti_1
+ * @brief
+ *    Completions in order are coalesced into a single range
+ * @details
+ *    A copied completion starts a new range, as its code differs.
+ */
+TEST(zc_notify_queue_test, ti_1)
+{
+    zc_notify_queue queue;
+    zc_notify_range range;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(range));
+
+    for (uint32_t id = 0U; id < 10U; ++id) {
+        queue.complete(id, false);
+    }
+    queue.complete(10U, true);
+    queue.complete(11U, true);
+    queue.complete(12U, false);
+    EXPECT_EQ(3U, queue.size());
+
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(0U, range.lo);
+    EXPECT_EQ(9U, range.hi);
+    EXPECT_FALSE(range.copied);
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(10U, range.lo);
+    EXPECT_EQ(11U, range.hi);
+    EXPECT_TRUE(range.copied);
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(12U, range.lo);
+    EXPECT_EQ(12U, range.hi);
+    EXPECT_FALSE(range.copied);
+    EXPECT_TRUE(queue.empty());
+}
+
+/**
+ * @test zc_notify_queue_test.ti_2
+ * @brief
+ *    Out of order completions aren't merged
+ * @details
+ *    A range which follows a popped one starts again from its id.
+ */
+TEST(zc_notify_queue_test, ti_2)
+{
+    zc_notify_queue queue;
+    zc_notify_range range;
+
+    queue.complete(2U, false);
+    queue.complete(1U, false);
+    queue.complete(3U, false);
+    EXPECT_EQ(3U, queue.size());
+
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(2U, range.lo);
+    EXPECT_EQ(2U, range.hi);
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(3U, range.lo);
+
+    queue.complete(4U, false);
+    queue.complete(5U, false);
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(4U, range.lo);
+    EXPECT_EQ(5U, range.hi);
+}
+
+/**
+ * @test zc_notify_queue_test.ti_3
+ * @brief
+ *    The ids wrap around at 32 bits
+ */
+TEST(zc_notify_queue_test, ti_3)
+{
+    zc_notify_queue queue;
+    zc_notify_range range;
+
+    queue.complete(UINT32_MAX - 1U, false);
+    queue.complete(UINT32_MAX, false);
+    queue.complete(0U, false);
+    queue.complete(1U, false);
+    EXPECT_EQ(1U, queue.size());
+
+    EXPECT_TRUE(queue.pop(range));
+    EXPECT_EQ(UINT32_MAX - 1U, range.lo);
+    EXPECT_EQ(1U, range.hi);
+}
@@ -238,7 +238,6 @@ static int config_def(void)
     daemon_cfg.raw_fd_ip4 = -1;
     daemon_cfg.notify_fd = -1;
     daemon_cfg.notify_dir = XLIO_AGENT_PATH;
-    daemon_cfg.ht = NULL;
 
     return rc;
 }
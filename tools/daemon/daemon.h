@@ -59,6 +59,12 @@
     65599 /**< Default maximum number of sockets                                                   \
                per process (should be prime number) */
 
+#define STORE_SHARD_NUM                                                                            \
+    16 /**< Number of the shards of the process store, a table                                     \
+          reallocation moves the processes of a single shard */
+
+#define STATS_INTERVAL 60 /**< Period of the statistics output (in sec) */
+
 #ifndef HAVE_LINUX_LIMITS_H
 #define NAME_MAX 255 /**< chars in a file name */
 #define PATH_MAX 4096 /**< chars in a path name including null */
@@ -106,6 +112,21 @@
             sys_hexdump((_ptr), (_size));                                                          \
     } while (0)
 
+/**
+ * @struct module_stats
+ * @brief Message processing counters
+ */
+struct module_stats {
+    uint64_t datagrams; /**< Received datagrams */
+    uint64_t msgs; /**< Processed messages */
+    uint64_t msg_init; /**< XLIO_MSG_INIT messages */
+    uint64_t msg_state; /**< XLIO_MSG_STATE messages */
+    uint64_t msg_exit; /**< XLIO_MSG_EXIT messages */
+    uint64_t errors; /**< Datagrams dropped on errors */
+    uint32_t max_batch; /**< Maximum messages in a datagram */
+    uint32_t max_drain; /**< Maximum datagrams read on a single wakeup */
+};
+
 /**
  * @struct module_cfg
  * @brief Configuration parameters in global values
@@ -132,8 +153,9 @@ struct module_cfg {
     int raw_fd_ip6;
     int notify_fd;
     const char *notify_dir;
-    hash_t ht;
+    hash_t ht[STORE_SHARD_NUM]; /**< Process store sharded by pid */
     struct list_head if_list;
+    struct module_stats stats;
 };
 
 extern struct module_cfg daemon_cfg;
@@ -173,6 +195,12 @@ struct store_fid {
     uint8_t state; /**< Current TCP state of the connection */
 };
 
+struct store_pid *store_get(pid_t pid);
+struct store_pid *store_put(struct store_pid *value);
+void store_del(pid_t pid);
+int store_count(void);
+void store_log_stats(void);
+
 void sys_log(int level, const char *format, ...);
 
 ssize_t sys_sendto(int sockfd, const void *buf, size_t len, int flags,
@@ -11,6 +11,10 @@
 #include "hash.h"
 
 #define HASH_KEY_INVALID (hash_key_t)(-1)
+#define HASH_KEY_DELETED (hash_key_t)(-2)
+
+/* Initial number of elements, the table grows up to the size given to hash_create() */
+#define HASH_SIZE_INIT 61
 
 /**
  * @struct hash_element
@@ -28,12 +32,17 @@ struct hash_element {
 struct hash_object {
     struct hash_element *hash_table; /**< hash table */
     struct hash_element *last; /**< last accessed */
-    int size; /**< maximum number of elements */
+    int size; /**< current number of elements in the table */
+    int max_size; /**< maximum number of elements */
     int count; /**< current count of elements */
+    int used; /**< elements and deleted elements */
+    int resizes; /**< number of the table reallocations */
     hash_freefunc_t free; /**< free function */
 };
 
 static struct hash_element *hash_find(hash_t ht, hash_key_t key, int flag);
+static int hash_resize(hash_t ht, int size);
+static int next_prime(int value);
 static int check_prime(int value);
 
 hash_t hash_create(hash_freefunc_t free_func, size_t size)
@@ -47,18 +56,12 @@ hash_t hash_create(hash_freefunc_t free_func, size_t size)
 
     ht = (struct hash_object *)malloc(sizeof(*ht));
     if (ht) {
-        ht->size = size;
-        ht->hash_table = (struct hash_element *)calloc(ht->size, sizeof(*ht->hash_table));
-        if (ht->hash_table) {
-            int i = 0;
-
-            ht->last = NULL;
-            ht->count = 0;
-            ht->free = free_func;
-            for (i = 0; i < ht->size; i++) {
-                ht->hash_table[i].key = HASH_KEY_INVALID;
-            }
-        } else {
+        ht->hash_table = NULL;
+        ht->size = 0;
+        ht->max_size = size;
+        ht->resizes = 0;
+        ht->free = free_func;
+        if (hash_resize(ht, (size < HASH_SIZE_INIT ? (int)size : HASH_SIZE_INIT)) < 0) {
             free(ht);
             ht = NULL;
         }
@@ -101,6 +104,11 @@ int hash_size(hash_t ht)
     return ht->size;
 }
 
+int hash_resizes(hash_t ht)
+{
+    return ht->resizes;
+}
+
 void *hash_get(hash_t ht, hash_key_t key)
 {
     if (ht) {
@@ -131,11 +139,27 @@ void *hash_enum(hash_t ht, size_t index)
 
 void *hash_put(hash_t ht, hash_key_t key, void *value)
 {
-    if (ht && (ht->count < ht->size)) {
+    if (ht) {
         struct hash_element *entry = NULL;
 
         entry = hash_find(ht, key, 0);
         if (NULL == entry) {
+            if (ht->count >= ht->max_size) {
+                return NULL;
+            }
+            /* Keep the load under 3/4 so that the probe sequences stay short,
+             * the deleted elements are dropped by the reallocation as well
+             */
+            if ((ht->used + 1) * 4 > ht->size * 3) {
+                int size = next_prime(ht->count * 2 + 1);
+
+                size = (size < ht->size ? ht->size : size);
+                size = (size > ht->max_size ? ht->max_size : size);
+                if ((size > ht->size || ht->used - ht->count > ht->size / 8) &&
+                    hash_resize(ht, size) < 0) {
+                    return NULL;
+                }
+            }
             entry = hash_find(ht, key, 1);
         }
         if (entry) {
@@ -143,6 +167,9 @@ void *hash_put(hash_t ht, hash_key_t key, void *value)
                 ht->free(entry->value);
             }
             if (entry->key == HASH_KEY_INVALID) {
+                ht->used++;
+            }
+            if (entry->key == HASH_KEY_INVALID || entry->key == HASH_KEY_DELETED) {
                 ht->count++;
             }
             entry->key = key;
@@ -164,11 +191,13 @@ void hash_del(hash_t ht, hash_key_t key)
             if (ht->free && entry->value) {
                 ht->free(entry->value);
             }
-            if (entry->key != HASH_KEY_INVALID) {
-                ht->count--;
-            }
-            entry->key = HASH_KEY_INVALID;
+            ht->count--;
+            /* The element stays in the probe sequences of the others */
+            entry->key = HASH_KEY_DELETED;
             entry->value = NULL;
+            if (ht->last == entry) {
+                ht->last = NULL;
+            }
         }
     }
 }
@@ -187,23 +216,22 @@ static struct hash_element *hash_find(hash_t ht, hash_key_t key, int flag)
     struct hash_element *entry = NULL;
     int attempts = 0;
     int idx = 0;
-    hash_key_t expect_key;
 
-    if (ht->last && ht->last->key == key) {
+    if (!flag && ht->last && ht->last->key == key) {
         return ht->last;
     }
 
-    expect_key = (flag ? HASH_KEY_INVALID : key);
-
     idx = key % ht->size;
 
     do {
         entry = &(ht->hash_table[idx]);
 
-        if (entry->key == expect_key) {
+        if (flag ? (entry->key == HASH_KEY_INVALID || entry->key == HASH_KEY_DELETED)
+                 : (entry->key == key)) {
             break;
         } else {
-            if (attempts >= (ht->size - 1)) {
+            /* The key is never stored after an element which was never used */
+            if (attempts >= (ht->size - 1) || (!flag && entry->key == HASH_KEY_INVALID)) {
                 entry = NULL;
                 break;
             }
@@ -217,6 +245,60 @@ static struct hash_element *hash_find(hash_t ht, hash_key_t key, int flag)
     return entry;
 }
 
+/* hash_resize():
+ *
+ * Reallocate the table and put the elements into it again.
+ * @param ht - point to hash object
+ * @param size - new size of the table, prime number
+ * @return 0 on success or -1 in case there is no memory.
+ */
+static int hash_resize(hash_t ht, int size)
+{
+    struct hash_element *old_table = ht->hash_table;
+    int old_size = ht->size;
+    int i = 0;
+
+    ht->hash_table = (struct hash_element *)calloc(size, sizeof(*ht->hash_table));
+    if (NULL == ht->hash_table) {
+        ht->hash_table = old_table;
+        return -1;
+    }
+    for (i = 0; i < size; i++) {
+        ht->hash_table[i].key = HASH_KEY_INVALID;
+    }
+    ht->size = size;
+    ht->count = 0;
+    ht->used = 0;
+    ht->last = NULL;
+
+    for (i = 0; i < old_size; i++) {
+        if (old_table[i].key != HASH_KEY_INVALID && old_table[i].key != HASH_KEY_DELETED) {
+            struct hash_element *entry = hash_find(ht, old_table[i].key, 1);
+
+            entry->key = old_table[i].key;
+            entry->value = old_table[i].value;
+            ht->count++;
+            ht->used++;
+        }
+    }
+    ht->last = NULL;
+    if (old_table) {
+        ht->resizes++;
+    }
+    free(old_table);
+
+    return 0;
+}
+
+static int next_prime(int value)
+{
+    while (!check_prime(value)) {
+        value++;
+    }
+
+    return value;
+}
+
 static int check_prime(int value)
 {
     int i = 0;
@@ -28,7 +28,8 @@ typedef void (*hash_freefunc_t)(void *);
  * Create a hash object.
  * @param free_func - user defined function for destroy data
  *       inserted into hash
- * @param size - size of hash that should be Prime number
+ * @param size - maximum number of elements that should be Prime number,
+ *       the table starts smaller and grows on demand
  * @return the newly allocated hash table. Must be freed with hash_destory.
  */
 hash_t hash_create(hash_freefunc_t free_func, size_t size);
@@ -51,12 +52,21 @@ int hash_count(hash_t ht);
 
 /* hash_size():
  *
- * Return maximum number of elements in the hash object.
+ * Return current number of elements in the table of the hash object,
+ * the table grows up to the size passed to hash_create().
  * @param ht - point to hash object
- * @return maximum number of elements
+ * @return number of elements in the table
  */
 int hash_size(hash_t ht);
 
+/* hash_resizes():
+ *
+ * Return number of the table reallocations of the hash object.
+ * @param ht - point to hash object
+ * @return number of reallocations
+ */
+int hash_resizes(hash_t ht);
+
 /* hash_get():
  *
  * Return value stored in hash object by found by key.
@@ -68,7 +78,7 @@ void *hash_get(hash_t ht, hash_key_t key);
 
 /* hash_enum():
  *
- * Return value stored in hash object by index.
+ * Return value stored in hash object by index in 0..hash_size()-1.
  * @param ht - point to hash object
  * @param index - index in hash object
  * @return value
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 
@@ -26,9 +27,30 @@ extern int open_notify(void);
 extern void close_notify(void);
 extern int proc_notify(void);
 
+static void log_stats(void)
+{
+    static struct module_stats prev;
+    static time_t t_prev = 0;
+    struct module_stats *stats = &daemon_cfg.stats;
+    time_t t_now = time(NULL);
+    time_t t_delta = (t_prev && t_now > t_prev ? t_now - t_prev : 1);
+
+    log_info("messages: %" PRIu64 " (%" PRIu64 "/s) datagrams: %" PRIu64 " (%" PRIu64
+             "/s) init: %" PRIu64 " state: %" PRIu64 " exit: %" PRIu64 " errors: %" PRIu64
+             " max batch: %u max drain: %u\n",
+             stats->msgs, (stats->msgs - prev.msgs) / t_delta, stats->datagrams,
+             (stats->datagrams - prev.datagrams) / t_delta, stats->msg_init, stats->msg_state,
+             stats->msg_exit, stats->errors, stats->max_batch, stats->max_drain);
+    store_log_stats();
+
+    prev = *stats;
+    t_prev = t_now;
+}
+
 int proc_loop(void)
 {
     int rc = 0;
+    time_t t_stats = time(NULL) + STATS_INTERVAL;
 
     log_debug("setting working directory ...\n");
     if ((mkdir(daemon_cfg.notify_dir, 0777) != 0) && (errno != EEXIST)) {
@@ -68,9 +90,14 @@ int proc_loop(void)
         max_fd = (max_fd < daemon_cfg.notify_fd ? daemon_cfg.notify_fd : max_fd);
 
         /* Use timeout for select() call */
-        tv.tv_sec = 60;
+        tv.tv_sec = STATS_INTERVAL;
         tv.tv_usec = 0;
 
+        if (time(NULL) >= t_stats) {
+            log_stats();
+            t_stats = time(NULL) + STATS_INTERVAL;
+        }
+
         rc = select(max_fd + 1, &readfds, NULL, NULL, &tv);
         if (rc < 0) {
             rc = 0;
@@ -98,6 +125,7 @@ int proc_loop(void)
 
 err:
     log_debug("finishing loop ...\n");
+    log_stats();
 
     close_message();
     close_notify();
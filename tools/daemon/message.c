@@ -19,10 +19,16 @@
 #include "hash.h"
 #include "daemon.h"
 
+/* Maximum number of datagrams read on a single wakeup
+ * so that the file system events are not delayed
+ */
+#define MSG_DRAIN_MAX 256
+
 int open_message(void);
 void close_message(void);
 int proc_message(void);
 
+static int proc_datagram(void);
 static int proc_msg_init(struct xlio_hdr *msg_hdr, size_t size, struct sockaddr_un *peeraddr);
 static int proc_msg_exit(struct xlio_hdr *msg_hdr, size_t size);
 static int proc_msg_state(struct xlio_hdr *msg_hdr, size_t size);
@@ -89,12 +95,35 @@ void close_message(void)
 }
 
 int proc_message(void)
+{
+    int rc = 0;
+    uint32_t num = 0;
+
+    /* Drain the socket, the agents defer their messages while it is full */
+    while (num < MSG_DRAIN_MAX) {
+        rc = proc_datagram();
+        if (rc == -EAGAIN) {
+            rc = 0;
+            break;
+        }
+        num++;
+    }
+    if (num > daemon_cfg.stats.max_drain) {
+        daemon_cfg.stats.max_drain = num;
+    }
+
+    return rc;
+}
+
+static int proc_datagram(void)
 {
     int rc = 0;
     struct sockaddr_un peeraddr;
     socklen_t addrlen = sizeof(peeraddr);
-    char msg_recv[4096];
+    char msg_recv[XLIO_AGENT_MSG_MAX];
     int len = 0;
+    int offset = 0;
+    uint32_t num = 0;
     struct xlio_hdr *msg_hdr = NULL;
 
 again:
@@ -105,11 +134,16 @@ again:
             goto again;
         }
         rc = -errno;
-        log_error("Failed recvfrom() errno %d (%s)\n", errno, strerror(errno));
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            log_error("Failed recvfrom() errno %d (%s)\n", errno, strerror(errno));
+        } else {
+            rc = -EAGAIN;
+        }
         goto err;
     }
+    daemon_cfg.stats.datagrams++;
 
-    /* Parse and process messages */
+    /* Parse and process messages, an agent puts several messages into a datagram */
     while (len > 0) {
         if (len < (int)sizeof(struct xlio_hdr)) {
             rc = -EBADMSG;
@@ -117,19 +151,22 @@ again:
                       (addrlen > 0 ? peeraddr.sun_path : "n/a"), len, errno, strerror(errno));
             goto err;
         }
-        msg_hdr = (struct xlio_hdr *)&msg_recv;
+        msg_hdr = (struct xlio_hdr *)&msg_recv[offset];
         log_debug("getting message ([%d] ver: %d pid: %d)\n", msg_hdr->code, msg_hdr->ver,
                   msg_hdr->pid);
 
         switch (msg_hdr->code) {
         case XLIO_MSG_INIT:
             rc = proc_msg_init(msg_hdr, len, &peeraddr);
+            daemon_cfg.stats.msg_init++;
             break;
         case XLIO_MSG_STATE:
             rc = proc_msg_state(msg_hdr, len);
+            daemon_cfg.stats.msg_state++;
             break;
         case XLIO_MSG_EXIT:
             rc = proc_msg_exit(msg_hdr, len);
+            daemon_cfg.stats.msg_exit++;
             break;
         default:
             rc = -EPROTO;
@@ -137,6 +174,9 @@ again:
             goto err;
         }
         if (0 < rc) {
+            daemon_cfg.stats.msgs++;
+            num++;
+            offset += rc;
             len -= rc;
             rc = 0;
         } else {
@@ -145,6 +185,12 @@ again:
     }
 
 err:
+    if (num > daemon_cfg.stats.max_batch) {
+        daemon_cfg.stats.max_batch = num;
+    }
+    if (rc < 0 && rc != -EAGAIN) {
+        daemon_cfg.stats.errors++;
+    }
     return rc;
 }
 
@@ -191,9 +237,9 @@ static int proc_msg_init(struct xlio_hdr *msg_hdr, size_t size, struct sockaddr_
         return -EFAULT;
     }
 
-    if (hash_put(daemon_cfg.ht, value->pid, value) != value) {
-        log_error("Failed hash_put() count: %d size: %d errno %d (%s)\n", hash_count(daemon_cfg.ht),
-                  hash_size(daemon_cfg.ht), errno, strerror(errno));
+    if (store_put(value) != value) {
+        log_error("Failed store_put() count: %d max: %d errno %d (%s)\n", store_count(),
+                  daemon_cfg.opt.max_pid_num, errno, strerror(errno));
         hash_destroy(value->ht);
         free(value);
         return -EFAULT;
@@ -226,9 +272,9 @@ static int proc_msg_exit(struct xlio_hdr *msg_hdr, size_t size)
         return -EBADMSG;
     }
 
-    pid_value = hash_get(daemon_cfg.ht, data->hdr.pid);
+    pid_value = store_get(data->hdr.pid);
     if (pid_value) {
-        hash_del(daemon_cfg.ht, pid_value->pid);
+        store_del(pid_value->pid);
     }
 
     log_debug("[%d] remove from the storage\n", data->hdr.pid);
@@ -251,7 +297,7 @@ static int proc_msg_state(struct xlio_hdr *msg_hdr, size_t size)
         return -EBADMSG;
     }
 
-    pid_value = hash_get(daemon_cfg.ht, data->hdr.pid);
+    pid_value = store_get(data->hdr.pid);
     if (NULL == pid_value) {
         /* Return success because this case can be valid
          * if the process is terminated using abnormal way
@@ -280,7 +280,7 @@ static int clean_process(pid_t pid)
             struct store_pid *pid_value = NULL;
 
             log_debug("[%d] detect abnormal termination\n", pid);
-            pid_value = hash_get(daemon_cfg.ht, pid);
+            pid_value = store_get(pid);
             if (pid_value) {
                 struct rst_info rst;
                 struct store_fid *fid_value = NULL;
@@ -329,7 +329,7 @@ static int clean_process(pid_t pid)
                     }
                 }
 
-                hash_del(daemon_cfg.ht, pid);
+                store_del(pid);
                 log_debug("[%d] remove from the storage\n", pid);
 
                 /* Set OK */
@@ -799,7 +799,7 @@ static int proc_fanotify(void *buffer, int nbyte)
          * either after work completion or as result of unexpected termination
          */
         if ((data->mask & FAN_CLOSE_WRITE || data->mask & FAN_CLOSE_NOWRITE) &&
-            hash_get(daemon_cfg.ht, data->pid)) {
+            store_get(data->pid)) {
             char buf[PATH_MAX];
             char pathname[PATH_MAX];
 
@@ -909,7 +909,7 @@ static int proc_inotify(void *buffer, int nbyte)
         /* Monitor only events from files */
         if ((data->len > 0) && !(data->mask & IN_ISDIR) &&
             (1 == sscanf(data->name, XLIO_AGENT_BASE_NAME ".%d.pid", &pid)) &&
-            hash_get(daemon_cfg.ht, pid)) {
+            store_get(pid)) {
 
             char buf[PATH_MAX];
             char pathname[PATH_MAX];
@@ -21,16 +21,94 @@ void close_store(void);
 
 static void free_store_pid(void *ptr);
 
+static inline hash_t store_shard(pid_t pid)
+{
+    return daemon_cfg.ht[(uint32_t)pid % STORE_SHARD_NUM];
+}
+
 int open_store(void)
 {
-    daemon_cfg.ht = hash_create(&free_store_pid, daemon_cfg.opt.max_pid_num);
+    int i = 0;
+
+    for (i = 0; i < STORE_SHARD_NUM; i++) {
+        /* Every shard can keep all the processes */
+        daemon_cfg.ht[i] = hash_create(&free_store_pid, daemon_cfg.opt.max_pid_num);
+        if (NULL == daemon_cfg.ht[i]) {
+            return -EFAULT;
+        }
+    }
 
-    return (NULL == daemon_cfg.ht ? -EFAULT : 0);
+    return 0;
 }
 
 void close_store(void)
 {
-    hash_destroy(daemon_cfg.ht);
+    int i = 0;
+
+    for (i = 0; i < STORE_SHARD_NUM; i++) {
+        hash_destroy(daemon_cfg.ht[i]);
+        daemon_cfg.ht[i] = NULL;
+    }
+}
+
+struct store_pid *store_get(pid_t pid)
+{
+    return hash_get(store_shard(pid), pid);
+}
+
+struct store_pid *store_put(struct store_pid *value)
+{
+    if (NULL == store_get(value->pid) && store_count() >= daemon_cfg.opt.max_pid_num) {
+        return NULL;
+    }
+
+    return hash_put(store_shard(value->pid), value->pid, value);
+}
+
+void store_del(pid_t pid)
+{
+    hash_del(store_shard(pid), pid);
+}
+
+int store_count(void)
+{
+    int count = 0;
+    int i = 0;
+
+    for (i = 0; i < STORE_SHARD_NUM; i++) {
+        count += (daemon_cfg.ht[i] ? hash_count(daemon_cfg.ht[i]) : 0);
+    }
+
+    return count;
+}
+
+void store_log_stats(void)
+{
+    int fid_count = 0;
+    int fid_size = 0;
+    int resizes = 0;
+    int i, j;
+
+    for (i = 0; i < STORE_SHARD_NUM; i++) {
+        hash_t ht = daemon_cfg.ht[i];
+
+        if (NULL == ht) {
+            continue;
+        }
+        resizes += hash_resizes(ht);
+        for (j = 0; j < hash_size(ht); j++) {
+            struct store_pid *value = hash_enum(ht, j);
+
+            if (value) {
+                fid_count += hash_count(value->ht);
+                fid_size += hash_size(value->ht);
+                resizes += hash_resizes(value->ht);
+            }
+        }
+    }
+
+    log_info("store: processes: %d sockets: %d (table elements: %d) reallocations: %d\n",
+             store_count(), fid_count, fid_size, resizes);
 }
 
 static void free_store_pid(void *ptr)
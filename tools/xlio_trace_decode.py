@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: NVIDIA CORPORATION & AFFILIATES
+# Copyright (c) 2026 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: GPL-2.0-only or BSD-2-Clause
+#
+"""Converts an XLIO trace ring dump to the Chrome trace event format.
+
+The dump is written to <monitor.stats.shmem_dir>/xliotrace.<pid> by
+'xlio_stats -p <pid> --dump=trace' or at the exit of the process, when
+monitor.stats.trace_ring_events is set. The output opens in ui.perfetto.dev
+and chrome://tracing. The layout follows src/core/util/trace_ring.h.
+
+Usage: xlio_trace_decode.py xliotrace.<pid> [output.json]
+"""
+
+import json
+import struct
+import sys
+
+FILE_MAGIC = b"XLIOTRC1"
+FILE_VERSION = 1
+HEADER = struct.Struct("=8sIIQ")
+RING = struct.Struct("=IIQ")
+EVENT = struct.Struct("=QQIHH")
+
+# Event id: name, arg0 name, arg1 name
+EVENTS = {
+    1: ("cq_poll", "cq", "completions"),
+    2: ("rfs_dispatch", "rfs", "sinks"),
+    3: ("timer", "handler", None),
+    4: ("timer", "handler", None),
+    5: ("lock_busy", "ring", "tx"),
+    6: ("bpool_expand", "pool", "buffers"),
+    7: ("doorbell", "hw_queue", "wqe_counter"),
+}
+TIMER_BEGIN = 3
+TIMER_END = 4
+
+
+def read_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, num_rings, tsc_rate = HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC or version != FILE_VERSION:
+        raise ValueError("%s is not an XLIO trace dump of version %d" % (path, FILE_VERSION))
+
+    offset = HEADER.size
+    rings = []
+    for _ in range(num_rings):
+        tid, num_events, total_events = RING.unpack_from(data, offset)
+        offset += RING.size
+        events = [EVENT.unpack_from(data, offset + i * EVENT.size) for i in range(num_events)]
+        offset += num_events * EVENT.size
+        rings.append((tid, total_events, events))
+    return tsc_rate, rings
+
+
+def to_chrome_trace(tsc_rate, rings, pid):
+    base_tsc = min((events[0][0] for _, _, events in rings if events), default=0)
+    trace = []
+
+    for tid, total_events, events in rings:
+        trace.append({"name": "thread_name", "ph": "M", "pid": pid, "tid": tid,
+                      "args": {"name": "tid %d (%d events dropped)" %
+                               (tid, total_events - len(events))}})
+        for tsc, arg0, arg1, event_id, _ in events:
+            name, arg0_name, arg1_name = EVENTS.get(event_id, ("event_%d" % event_id, "arg0",
+                                                               "arg1"))
+            args = {arg0_name: hex(arg0)}
+            if arg1_name:
+                args[arg1_name] = arg1
+            entry = {"name": name, "pid": pid, "tid": tid,
+                     "ts": (tsc - base_tsc) * 1e6 / tsc_rate, "args": args}
+            if event_id == TIMER_BEGIN:
+                entry["ph"] = "B"
+            elif event_id == TIMER_END:
+                entry["ph"] = "E"
+            else:
+                entry["ph"] = "i"
+                entry["s"] = "t"
+            trace.append(entry)
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+
+    path = argv[1]
+    try:
+        pid = int(path.rsplit(".", 1)[-1])
+    except ValueError:
+        pid = 0
+    tsc_rate, rings = read_dump(path)
+    trace = to_chrome_trace(tsc_rate, rings, pid)
+
+    if len(argv) == 3:
+        with open(argv[2], "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))